@@ -22,6 +22,10 @@ OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 #include <stdlib.h>
 #include <ctype.h>
 
+// include miniz stb-syle, directly in this compilation unit.
+// (supported by miniz)
+#include "../../Quake/miniz.c"
+
 static FILE *out;
 
 typedef struct
@@ -30,11 +34,24 @@ typedef struct
 	int	 filepos, filelen;
 } dpackfile_t;
 
+// central directory record of a zip entry, written after all the entries
+typedef struct
+{
+	char	 name[56];
+	uint16_t method;
+	uint32_t crc, compressed_size, size, local_header_offset;
+} zipentry_t;
+
 static void write_byte (uint8_t value)
 {
 	fwrite (&value, 1, 1, out);
 }
 
+static void write_int16 (uint16_t value)
+{
+	fwrite (&value, 2, 1, out);
+}
+
 static void write_int32 (uint32_t value)
 {
 	fwrite (&value, 4, 1, out);
@@ -50,13 +67,85 @@ static void write_header (int32_t directory_offset, int32_t directory_size)
 	write_int32 (directory_size);
 }
 
+// fields shared by the local and the central directory headers
+static void write_zip_entry_fields (const zipentry_t *entry)
+{
+	write_int16 (20); // version needed to extract, deflate
+	write_int16 (0);  // flags
+	write_int16 (entry->method);
+	write_int16 (0);	// time
+	write_int16 (0x21); // date, 1980-01-01
+	write_int32 (entry->crc);
+	write_int32 (entry->compressed_size);
+	write_int32 (entry->size);
+	write_int16 ((uint16_t)strlen (entry->name));
+	write_int16 (0); // extra field length
+}
+
+// Deflates the entry unless that doesn't make it smaller, the engine inflates it when it's opened
+static void write_zip_entry (zipentry_t *entry, const uint8_t *data, size_t size)
+{
+	size_t	 compressed_size = 0;
+	void	*compressed = size ? tdefl_compress_mem_to_heap (data, size, &compressed_size, TDEFL_MAX_PROBES_MASK) : NULL;
+	uint8_t	 stored = !compressed || compressed_size >= size;
+
+	entry->method = stored ? 0 : MZ_DEFLATED;
+	entry->crc = (uint32_t)mz_crc32 (MZ_CRC32_INIT, data, size);
+	entry->compressed_size = (uint32_t)(stored ? size : compressed_size);
+	entry->size = (uint32_t)size;
+	entry->local_header_offset = (uint32_t)ftell (out);
+
+	write_int32 (MZ_ZIP_LOCAL_DIR_HEADER_SIG);
+	write_zip_entry_fields (entry);
+	fwrite (entry->name, strlen (entry->name), 1, out);
+	fwrite (stored ? data : compressed, entry->compressed_size, 1, out);
+	free (compressed);
+}
+
+static void write_zip_directory (const zipentry_t *entries, int num_entries)
+{
+	uint32_t directory_offset = (uint32_t)ftell (out);
+
+	for (int i = 0; i < num_entries; i++)
+	{
+		write_int32 (MZ_ZIP_CENTRAL_DIR_HEADER_SIG);
+		write_int16 (20); // version made by
+		write_zip_entry_fields (&entries[i]);
+		write_int16 (0); // comment length
+		write_int16 (0); // disk number
+		write_int16 (0); // internal attributes
+		write_int32 (0); // external attributes
+		write_int32 (entries[i].local_header_offset);
+		fwrite (entries[i].name, strlen (entries[i].name), 1, out);
+	}
+
+	uint32_t directory_size = (uint32_t)ftell (out) - directory_offset;
+	write_int32 (MZ_ZIP_END_OF_CENTRAL_DIR_HEADER_SIG);
+	write_int16 (0); // disk number
+	write_int16 (0); // disk with the central directory
+	write_int16 ((uint16_t)num_entries);
+	write_int16 ((uint16_t)num_entries);
+	write_int32 (directory_size);
+	write_int32 (directory_offset);
+	write_int16 (0); // comment length
+}
+
 int main (int argc, char *argv[])
 {
 	FILE *toc_file = NULL;
+	int	  zip = 0;
+
+	// -z writes a zip with every entry deflated on its own instead of a pak
+	if (argc >= 2 && strcmp (argv[1], "-z") == 0)
+	{
+		zip = 1;
+		argv++;
+		argc--;
+	}
 
 	if (argc < 4)
 	{
-		fprintf (stderr, "Usage: mkpak [output.pak] [root dir for files] [toc file] [depfile (optional)]\n");
+		fprintf (stderr, "Usage: mkpak [-z] [output.pak] [root dir for files] [toc file] [depfile (optional)]\n");
 		return 1;
 	}
 
@@ -105,7 +194,11 @@ int main (int argc, char *argv[])
 	int32_t directory_size = num_in_files * sizeof (dpackfile_t);
 	int32_t file_offset = directory_offset + directory_size;
 
-	write_header (directory_offset, directory_size);
+	zipentry_t *zip_entries = NULL;
+	if (zip)
+		zip_entries = calloc (num_in_files ? num_in_files : 1, sizeof (zipentry_t));
+	else
+		write_header (directory_offset, directory_size);
 
 	FILE	*in = NULL;
 	uint8_t *in_buffer = NULL;
@@ -166,6 +259,14 @@ int main (int argc, char *argv[])
 			pack_entry.filelen = (int)in_size;
 			pack_entry.filepos = file_offset;
 
+		if (zip)
+		{
+			memcpy (zip_entries[file_index].name, pack_entry.name, sizeof (pack_entry.name));
+			write_zip_entry (&zip_entries[file_index], in_buffer, in_size);
+			fclose (in);
+			continue;
+		}
+
 		fseek (out, directory_offset + (file_index * sizeof (dpackfile_t)), SEEK_SET);
 		fwrite (&pack_entry, sizeof (pack_entry), 1, out);
 
@@ -177,6 +278,12 @@ int main (int argc, char *argv[])
 
 	} // end while
 
+	if (zip)
+	{
+		write_zip_directory (zip_entries, file_index + 1);
+		free (zip_entries);
+	}
+
 	if (dep_file)
 	{
 		fprintf (dep_file, "\n");
@@ -0,0 +1,560 @@
+/*
+Copyright (C) 2026 vkQuake developers
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+// bench.c -- micro-benchmark harness and the cases that only need public interfaces
+
+#include "quakedef.h"
+#include "gl_heap.h"
+
+#define MAX_BENCH_CASES	  64
+#define BENCH_SAMPLES	  15
+#define BENCH_SAMPLE_TIME 0.01 // seconds per sample
+#define BENCH_MAX_COUNT	  (1 << 28)
+#define BENCH_NAME_LENGTH 64
+#define BENCH_NUM_POINTS  4096
+#define BENCH_NUM_KEYS	  65536
+#define BENCH_HEAP_SLOTS  1024
+#define BENCH_HEAP_SIZES  16384
+
+typedef struct
+{
+	char   name[BENCH_NAME_LENGTH];
+	double ns;	   // median of the samples
+	double min;	   // fastest sample
+	double spread; // interquartile range of the samples, in percent of the median
+} bench_result_t;
+
+static cvar_t bench_baseline = {"bench_baseline", "bench_baseline", CVAR_NONE}; // file in the game dir compared with and written by bench_save
+
+static const bench_case_t *bench_cases[MAX_BENCH_CASES];
+static int				   bench_num_cases;
+static bench_result_t	  *bench_results;
+
+/*
+====================
+Bench_Register
+====================
+*/
+void Bench_Register (const bench_case_t *bench_case)
+{
+	if (bench_num_cases == MAX_BENCH_CASES)
+		Sys_Error ("Bench_Register: too many cases");
+	bench_cases[bench_num_cases++] = bench_case;
+}
+
+/*
+====================
+Bench_Seconds
+====================
+*/
+static double Bench_Seconds (const bench_case_t *bench_case, void *data, int count)
+{
+	const uint64_t start = SDL_GetPerformanceCounter ();
+	bench_case->run (data, count);
+	return (double)(SDL_GetPerformanceCounter () - start) / (double)SDL_GetPerformanceFrequency ();
+}
+
+static int Bench_Compare (const void *a, const void *b)
+{
+	const double da = *(const double *)a;
+	const double db = *(const double *)b;
+	return (da > db) - (da < db);
+}
+
+/*
+====================
+Bench_Measure
+
+Finds an operation count that takes about BENCH_SAMPLE_TIME, then times BENCH_SAMPLES runs of it
+====================
+*/
+static void Bench_Measure (const bench_case_t *bench_case, void *data, bench_result_t *result)
+{
+	double samples[BENCH_SAMPLES];
+	double seconds;
+	int	   count = 1;
+	int	   i;
+
+	// the calibration doubles as warmup
+	while ((seconds = Bench_Seconds (bench_case, data, count)) < BENCH_SAMPLE_TIME / 4 && count < BENCH_MAX_COUNT)
+		count *= 2;
+	count = CLAMP (1, (int)(count * BENCH_SAMPLE_TIME / q_max (seconds, 1e-9)), BENCH_MAX_COUNT);
+
+	for (i = 0; i < BENCH_SAMPLES; i++)
+		samples[i] = Bench_Seconds (bench_case, data, count) * 1e9 / count;
+	qsort (samples, BENCH_SAMPLES, sizeof (double), Bench_Compare);
+
+	result->ns = samples[BENCH_SAMPLES / 2];
+	result->min = samples[0];
+	result->spread = (samples[BENCH_SAMPLES * 3 / 4] - samples[BENCH_SAMPLES / 4]) * 100.0 / q_max (result->ns, 1e-9);
+}
+
+/*
+====================
+Bench_LoadBaseline
+
+Reads back what Bench_Save_f writes, one case per line
+====================
+*/
+static bench_result_t *Bench_LoadBaseline (void)
+{
+	char			name[MAX_OSPATH];
+	bench_result_t *baseline = NULL;
+	bench_result_t	result;
+	char		   *text, *line, *next;
+
+	q_snprintf (name, sizeof (name), "%s/%s", com_gamedir, bench_baseline.string);
+	COM_AddExtension (name, ".json", sizeof (name));
+	text = (char *)COM_LoadMallocFile_TextMode_OSPath (name, NULL);
+	if (!text)
+		return NULL;
+
+	for (line = text; line; line = next)
+	{
+		next = strchr (line, '\n');
+		if (next)
+			*next++ = 0;
+		memset (&result, 0, sizeof (result));
+		if (sscanf (line, " \"%63[^\"]\": {\"ns\": %lf", result.name, &result.ns) == 2)
+			VEC_PUSH (baseline, result);
+	}
+	Mem_Free (text);
+	return baseline;
+}
+
+/*
+====================
+Bench_f
+
+Runs the cases matching the pattern and compares them with the baseline
+====================
+*/
+static void Bench_f (void)
+{
+	const char		*pattern = (Cmd_Argc () > 1) ? Cmd_Argv (1) : "*";
+	bench_result_t	*baseline = Bench_LoadBaseline ();
+	bench_result_t	 result;
+	void			*data;
+	char			 delta[32];
+	int				 i, j;
+
+	VEC_CLEAR (bench_results);
+	Con_Printf ("%-26s %12s %12s %8s %10s\n", "case", "ns/op", "min", "spread", "baseline");
+	for (i = 0; i < bench_num_cases; i++)
+	{
+		const bench_case_t *bench_case = bench_cases[i];
+		if (!wildcmp (pattern, bench_case->name))
+			continue;
+
+		data = NULL;
+		if (bench_case->setup && !bench_case->setup (&data))
+			continue;
+		memset (&result, 0, sizeof (result));
+		q_strlcpy (result.name, bench_case->name, sizeof (result.name));
+		Bench_Measure (bench_case, data, &result);
+		if (bench_case->shutdown)
+			bench_case->shutdown (data);
+		VEC_PUSH (bench_results, result);
+
+		q_strlcpy (delta, "-", sizeof (delta));
+		for (j = 0; j < (int)VEC_SIZE (baseline); j++)
+			if (!strcmp (baseline[j].name, result.name) && baseline[j].ns > 0.0)
+				q_snprintf (delta, sizeof (delta), "%+.1f%%", (result.ns - baseline[j].ns) * 100.0 / baseline[j].ns);
+		Con_Printf ("%-26s %12.2f %12.2f %7.1f%% %10s\n", result.name, result.ns, result.min, result.spread, delta);
+	}
+	VEC_FREE (baseline);
+	if (!VEC_SIZE (bench_results))
+		Con_Printf ("no case matches %s, see bench_list\n", pattern);
+}
+
+/*
+====================
+Bench_Save_f
+
+Writes the results of the last bench run as the baseline
+====================
+*/
+static void Bench_Save_f (void)
+{
+	char  name[MAX_OSPATH];
+	FILE *f;
+	int	  i;
+
+	if (!VEC_SIZE (bench_results))
+	{
+		Con_Printf ("bench_save: run bench first\n");
+		return;
+	}
+
+	q_snprintf (name, sizeof (name), "%s/%s", com_gamedir, bench_baseline.string);
+	COM_AddExtension (name, ".json", sizeof (name));
+	COM_CreatePath (name);
+	f = fopen (name, "w");
+	if (!f)
+	{
+		Con_Printf ("ERROR: couldn't open file %s.\n", name);
+		return;
+	}
+	fprintf (f, "{\n\t\"engine\": \"%s\",\n\t\"cases\": {\n", ENGINE_NAME_AND_VER);
+	for (i = 0; i < (int)VEC_SIZE (bench_results); i++)
+	{
+		const bench_result_t *result = &bench_results[i];
+		fprintf (
+			f, "\t\t\"%s\": {\"ns\": %.3f, \"min\": %.3f, \"spread\": %.2f}%s\n", result->name, result->ns, result->min, result->spread,
+			(i + 1 < (int)VEC_SIZE (bench_results)) ? "," : "");
+	}
+	fprintf (f, "\t}\n}\n");
+	fclose (f);
+	Con_Printf ("Wrote %s.\n", name);
+}
+
+/*
+====================
+Bench_List_f
+====================
+*/
+static void Bench_List_f (void)
+{
+	int i;
+
+	for (i = 0; i < bench_num_cases; i++)
+		Con_SafePrintf ("%s\n", bench_cases[i]->name);
+	Con_Printf ("%i cases\n", bench_num_cases);
+}
+
+//=============================================================================
+
+/*
+====================
+Bench_RandomFloat
+====================
+*/
+static float Bench_RandomFloat (float low, float high)
+{
+	return low + (high - low) * ((float)COM_Rand () / (float)COM_RAND_MAX);
+}
+
+/*
+====================
+Bench_WorldModel
+
+The server's map if one is running, else the one the client is connected to
+====================
+*/
+static qmodel_t *Bench_WorldModel (void)
+{
+	if (sv.active && sv.qcvm.worldmodel)
+		return sv.qcvm.worldmodel;
+	if (cl.worldmodel)
+		return cl.worldmodel;
+	Con_Printf ("bench: no map loaded\n");
+	return NULL;
+}
+
+typedef struct
+{
+	qmodel_t	*model;
+	vec3_t		 starts[BENCH_NUM_POINTS];
+	vec3_t		 ends[BENCH_NUM_POINTS];
+	unsigned int next;
+} bench_world_t;
+
+/*
+====================
+Bench_WorldSetup
+
+Random points inside the empty leafs of the map and segments of up to 1024 units from them
+====================
+*/
+static qboolean Bench_WorldSetup (void **data)
+{
+	qmodel_t	  *model = Bench_WorldModel ();
+	bench_world_t *world;
+	int			   i, j;
+
+	if (!model)
+		return false;
+	world = (bench_world_t *)Mem_Alloc (sizeof (bench_world_t));
+	world->model = model;
+	COM_SeedRand (0);
+	for (i = 0; i < BENCH_NUM_POINTS; i++)
+	{
+		mleaf_t *leaf = &model->leafs[1 + COM_Rand () % q_max (model->numleafs, 1)];
+		for (j = 0; j < 3; j++)
+		{
+			world->starts[i][j] = Bench_RandomFloat (leaf->minmaxs[j], leaf->minmaxs[3 + j]);
+			world->ends[i][j] = world->starts[i][j] + Bench_RandomFloat (-1024.0f, 1024.0f) * ((j == 2) ? 0.25f : 1.0f);
+		}
+	}
+	*data = world;
+	return true;
+}
+
+static void Bench_Free (void *data)
+{
+	Mem_Free (data);
+}
+
+static void Bench_Trace (bench_world_t *world, int hullnum, int count)
+{
+	hull_t *hull = &world->model->hulls[hullnum];
+	trace_t trace;
+	int		i;
+
+	for (i = 0; i < count; i++)
+	{
+		const int point = world->next++ & (BENCH_NUM_POINTS - 1);
+		memset (&trace, 0, sizeof (trace));
+		trace.fraction = 1;
+		trace.allsolid = true;
+		VectorCopy (world->ends[point], trace.endpos);
+		SV_RecursiveHullCheck (hull, world->starts[point], world->ends[point], &trace, CONTENTMASK_ANYSOLID);
+	}
+}
+
+static void Bench_TraceHull0 (void *data, int count)
+{
+	Bench_Trace ((bench_world_t *)data, 0, count);
+}
+
+static void Bench_TraceHull1 (void *data, int count)
+{
+	Bench_Trace ((bench_world_t *)data, 1, count);
+}
+
+static void Bench_TraceHull2 (void *data, int count)
+{
+	Bench_Trace ((bench_world_t *)data, 2, count);
+}
+
+static void Bench_PointInLeaf (void *data, int count)
+{
+	bench_world_t *world = (bench_world_t *)data;
+	int			   i;
+
+	for (i = 0; i < count; i++)
+		Mod_PointInLeaf (world->ends[world->next++ & (BENCH_NUM_POINTS - 1)], world->model);
+}
+
+static void Bench_DecompressVis (void *data, int count)
+{
+	bench_world_t *world = (bench_world_t *)data;
+	qmodel_t	  *model = world->model;
+	int			   i;
+
+	for (i = 0; i < count; i++)
+	{
+		mleaf_t *leaf = &model->leafs[1 + (world->next++ * 7919) % q_max (model->numleafs, 1)];
+		if (leaf->compressed_vis)
+			Mod_DecompressVis (leaf->compressed_vis, model);
+	}
+}
+
+/*
+====================
+Bench_QCSetup
+
+Calls an empty function of the server progs, so this is the cost of entering and leaving the vm
+====================
+*/
+static qboolean Bench_QCSetup (void **data)
+{
+	dfunction_t *func;
+
+	if (!sv.active)
+	{
+		Con_Printf ("bench: no server running\n");
+		return false;
+	}
+	PR_SwitchQCVM (&sv.qcvm);
+	func = ED_FindFunction ("SUB_Null");
+	*data = func ? (void *)(intptr_t)(func - qcvm->functions) : NULL;
+	PR_SwitchQCVM (NULL);
+	if (!func)
+		Con_Printf ("bench: progs have no SUB_Null\n");
+	return func != NULL;
+}
+
+static void Bench_QCCall (void *data, int count)
+{
+	const func_t func = (func_t)(intptr_t)data;
+	int			 i;
+
+	PR_SwitchQCVM (&sv.qcvm);
+	for (i = 0; i < count; i++)
+		PR_ExecuteProgram (func);
+	PR_SwitchQCVM (NULL);
+}
+
+typedef struct
+{
+	hash_map_t	*map;
+	int64_t		 keys[BENCH_NUM_KEYS];
+	unsigned int next;
+} bench_hash_map_t;
+
+/*
+====================
+Bench_HashMapSetup
+
+Half of the random keys are in the map, the other half are used for inserts
+====================
+*/
+static qboolean Bench_HashMapSetup (void **data, qboolean open)
+{
+	bench_hash_map_t *bench = (bench_hash_map_t *)Mem_Alloc (sizeof (bench_hash_map_t));
+	int				  i;
+
+	bench->map = open ? HashMap_CreateOpen (int64_t, int32_t, &HashInt64, NULL) : HashMap_Create (int64_t, int32_t, &HashInt64, NULL);
+	COM_SeedRand (1);
+	for (i = 0; i < BENCH_NUM_KEYS; i++)
+	{
+		bench->keys[i] = ((int64_t)i << 32) | (uint32_t)COM_Rand ();
+		if (i < BENCH_NUM_KEYS / 2)
+			HashMap_Insert (bench->map, &bench->keys[i], &i);
+	}
+	*data = bench;
+	return true;
+}
+
+static qboolean Bench_HashMapChainedSetup (void **data)
+{
+	return Bench_HashMapSetup (data, false);
+}
+
+static qboolean Bench_HashMapOpenSetup (void **data)
+{
+	return Bench_HashMapSetup (data, true);
+}
+
+static void Bench_HashMapShutdown (void *data)
+{
+	HashMap_Destroy (((bench_hash_map_t *)data)->map);
+	Mem_Free (data);
+}
+
+static void Bench_HashMapLookup (void *data, int count)
+{
+	bench_hash_map_t *bench = (bench_hash_map_t *)data;
+	int				  i;
+
+	for (i = 0; i < count; i++)
+		HashMap_Lookup (int32_t, bench->map, &bench->keys[bench->next++ & (BENCH_NUM_KEYS - 1)]);
+}
+
+static void Bench_HashMapInsertErase (void *data, int count)
+{
+	bench_hash_map_t *bench = (bench_hash_map_t *)data;
+	int				  i;
+
+	for (i = 0; i < count; i++)
+	{
+		const int64_t *key = &bench->keys[BENCH_NUM_KEYS / 2 + (bench->next++ & (BENCH_NUM_KEYS / 2 - 1))];
+		HashMap_Insert (bench->map, key, &i);
+		HashMap_Erase (bench->map, key);
+	}
+}
+
+typedef struct
+{
+	glheap_t		   *heap;
+	atomic_uint32_t		num_allocations;
+	glheapallocation_t *allocations[BENCH_HEAP_SLOTS];
+	VkDeviceSize		sizes[BENCH_HEAP_SIZES];
+	unsigned int		next;
+} bench_heap_t;
+
+/*
+====================
+Bench_HeapSetup
+
+Same size distribution as GL_HeapTest_f, a thousand allocations stay alive and get replaced one by one
+====================
+*/
+static qboolean Bench_HeapSetup (void **data)
+{
+	bench_heap_t *bench = (bench_heap_t *)Mem_Alloc (sizeof (bench_heap_t));
+	int			  i;
+
+	Atomic_StoreUInt32 (&bench->num_allocations, 0);
+	bench->heap = GL_HeapCreate (64ull * 1024ull * 1024ull, 4096, 0, VULKAN_MEMORY_TYPE_NONE, false, "Bench Heap");
+	COM_SeedRand (0);
+	for (i = 0; i < BENCH_HEAP_SIZES; i++)
+		bench->sizes[i] = (VkDeviceSize)((64.0 * 1024.0 - 1.0) * pow ((double)COM_Rand () / (double)COM_RAND_MAX, 5.0)) + 1;
+	for (i = 0; i < BENCH_HEAP_SLOTS; i++)
+		bench->allocations[i] = GL_HeapAllocate (bench->heap, bench->sizes[i], 16, &bench->num_allocations);
+	*data = bench;
+	return true;
+}
+
+static void Bench_HeapShutdown (void *data)
+{
+	bench_heap_t *bench = (bench_heap_t *)data;
+	int			  i;
+
+	for (i = 0; i < BENCH_HEAP_SLOTS; i++)
+		GL_HeapFree (bench->heap, bench->allocations[i], &bench->num_allocations);
+	GL_HeapDestroy (bench->heap, &bench->num_allocations);
+	Mem_Free (bench);
+}
+
+static void Bench_HeapChurn (void *data, int count)
+{
+	bench_heap_t *bench = (bench_heap_t *)data;
+	int			  i;
+
+	for (i = 0; i < count; i++)
+	{
+		const int slot = (bench->next * 7919) & (BENCH_HEAP_SLOTS - 1);
+		GL_HeapFree (bench->heap, bench->allocations[slot], &bench->num_allocations);
+		bench->allocations[slot] = GL_HeapAllocate (bench->heap, bench->sizes[bench->next++ & (BENCH_HEAP_SIZES - 1)], 16, &bench->num_allocations);
+	}
+}
+
+static const bench_case_t bench_builtin_cases[] = {
+	{"trace_hull0", Bench_WorldSetup, Bench_TraceHull0, Bench_Free},
+	{"trace_hull1", Bench_WorldSetup, Bench_TraceHull1, Bench_Free},
+	{"trace_hull2", Bench_WorldSetup, Bench_TraceHull2, Bench_Free},
+	{"point_in_leaf", Bench_WorldSetup, Bench_PointInLeaf, Bench_Free},
+	{"decompress_vis", Bench_WorldSetup, Bench_DecompressVis, Bench_Free},
+	{"qc_call", Bench_QCSetup, Bench_QCCall, NULL},
+	{"hashmap_lookup", Bench_HashMapChainedSetup, Bench_HashMapLookup, Bench_HashMapShutdown},
+	{"hashmap_insert_erase", Bench_HashMapChainedSetup, Bench_HashMapInsertErase, Bench_HashMapShutdown},
+	{"hashmap_open_lookup", Bench_HashMapOpenSetup, Bench_HashMapLookup, Bench_HashMapShutdown},
+	{"hashmap_open_insert_erase", Bench_HashMapOpenSetup, Bench_HashMapInsertErase, Bench_HashMapShutdown},
+	{"glheap_churn", Bench_HeapSetup, Bench_HeapChurn, Bench_HeapShutdown},
+};
+
+/*
+====================
+Bench_Init
+====================
+*/
+void Bench_Init (void)
+{
+	int i;
+
+	for (i = 0; i < (int)countof (bench_builtin_cases); i++)
+		Bench_Register (&bench_builtin_cases[i]);
+
+	Cvar_RegisterVariable (&bench_baseline);
+	Cmd_AddCommand ("bench", Bench_f);
+	Cmd_AddCommand ("bench_list", Bench_List_f);
+	Cmd_AddCommand ("bench_save", Bench_Save_f);
+}
@@ -0,0 +1,38 @@
+/*
+Copyright (C) 2026 vkQuake developers
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+// Micro-benchmarks for the bench command. A case times one operation of a hot path, modules
+// register the cases that need their internals from their own init function.
+
+typedef struct
+{
+	const char *name;
+	qboolean (*setup) (void **data); // optional, false skips the case (say why)
+	void (*run) (void *data, int count); // performs the operation count times
+	void (*shutdown) (void *data);		 // optional, releases what setup made
+} bench_case_t;
+
+void Bench_Init (void);
+void Bench_Register (const bench_case_t *bench_case);
+
+#endif /* _BENCH_H_ */
@@ -25,6 +25,7 @@
 #include "quakedef.h"
 #include "snd_codec.h"
 #include "bgmusic.h"
+#include "atomics.h"
 
 #define MUSIC_DIRNAME "music"
 
@@ -72,6 +73,16 @@ static music_handler_t *music_handlers = NULL;
 
 static snd_stream_t *bgmstream = NULL;
 
+// streams are decoded on a thread of its own so codec bursts don't stall the frame,
+// bgm_mutex guards bgmstream against the commands run on the main thread
+#define BGM_THREAD_PERIOD 10 // ms, the raw sample ring holds 8192 samples
+
+static SDL_Mutex	  *bgm_mutex;
+static SDL_Thread	  *bgm_thread;
+static atomic_uint32_t bgm_thread_quit;
+
+static void BGM_UpdateStream (void);
+
 static void BGM_Play_f (void)
 {
 	if (Cmd_Argc () == 2)
@@ -105,8 +116,10 @@ static void BGM_Loop_f (void)
 		else if (q_strcasecmp (Cmd_Argv (1), "toggle") == 0)
 			bgmloop = !bgmloop;
 
+		SDL_LockMutex (bgm_mutex);
 		if (bgmstream)
 			bgmstream->loop = bgmloop;
+		SDL_UnlockMutex (bgm_mutex);
 	}
 
 	if (bgmloop)
@@ -126,10 +139,31 @@ static void BGM_Jump_f (void)
 	{
 		Con_Printf ("music_jump <ordernum>\n");
 	}
-	else if (bgmstream)
+	else
+	{
+		SDL_LockMutex (bgm_mutex);
+		if (bgmstream)
+			S_CodecJumpToOrder (bgmstream, atoi (Cmd_Argv (1)));
+		SDL_UnlockMutex (bgm_mutex);
+	}
+}
+
+/*
+================
+BGM_Thread
+================
+*/
+static int BGM_Thread (void *data)
+{
+	while (!Atomic_LoadUInt32 (&bgm_thread_quit))
 	{
-		S_CodecJumpToOrder (bgmstream, atoi (Cmd_Argv (1)));
+		SDL_LockMutex (bgm_mutex);
+		if (bgmstream)
+			BGM_UpdateStream ();
+		SDL_UnlockMutex (bgm_mutex);
+		SDL_Delay (BGM_THREAD_PERIOD);
 	}
+	return 0;
 }
 
 qboolean BGM_Init (void)
@@ -148,6 +182,15 @@ qboolean BGM_Init (void)
 	if (COM_CheckParm ("-noextmusic") != 0)
 		no_extmusic = true;
 
+	bgm_mutex = SDL_CreateMutex ();
+	if (shm)
+	{
+		Atomic_StoreUInt32 (&bgm_thread_quit, 0);
+		bgm_thread = SDL_CreateThread (BGM_Thread, "BGM_Thread", NULL);
+		if (!bgm_thread)
+			Con_Printf ("Couldn't create music thread, decoding on the main thread: %s\n", SDL_GetError ());
+	}
+
 	bgmloop = true;
 
 	for (i = 0; wanted_handlers[i].type != CODECTYPE_NONE; i++)
@@ -184,6 +227,12 @@ qboolean BGM_Init (void)
 
 void BGM_Shutdown (void)
 {
+	if (bgm_thread)
+	{
+		Atomic_StoreUInt32 (&bgm_thread_quit, 1);
+		SDL_WaitThread (bgm_thread, NULL);
+		bgm_thread = NULL;
+	}
 	BGM_Stop ();
 	/* sever our connections to
 	 * midi_drv and snd_codec */
@@ -229,7 +278,7 @@ static void BGM_Play_noext (const char *filename, unsigned int allowed_types)
 	Con_Printf ("Couldn't handle music file %s\n", filename);
 }
 
-void BGM_Play (const char *filename)
+static void BGM_PlayFile (const char *filename)
 {
 	char			 tmp[MAX_QPATH];
 	const char		*ext;
@@ -284,7 +333,14 @@ void BGM_Play (const char *filename)
 	Con_Printf ("Couldn't handle music file %s\n", filename);
 }
 
-void BGM_PlayCDtrack (byte track, qboolean looping)
+void BGM_Play (const char *filename)
+{
+	SDL_LockMutex (bgm_mutex);
+	BGM_PlayFile (filename);
+	SDL_UnlockMutex (bgm_mutex);
+}
+
+static void BGM_PlayTrack (byte track, qboolean looping)
 {
 	/* instead of searching by the order of music_handlers, do so by
 	 * the order of searchpath priority: the file from the searchpath
@@ -341,8 +397,16 @@ void BGM_PlayCDtrack (byte track, qboolean looping)
 	}
 }
 
+void BGM_PlayCDtrack (byte track, qboolean looping)
+{
+	SDL_LockMutex (bgm_mutex);
+	BGM_PlayTrack (track, looping);
+	SDL_UnlockMutex (bgm_mutex);
+}
+
 void BGM_Stop (void)
 {
+	SDL_LockMutex (bgm_mutex);
 	if (bgmstream)
 	{
 		bgmstream->status = STREAM_NONE;
@@ -350,24 +414,29 @@ void BGM_Stop (void)
 		bgmstream = NULL;
 		s_rawend = 0;
 	}
+	SDL_UnlockMutex (bgm_mutex);
 }
 
 void BGM_Pause (void)
 {
+	SDL_LockMutex (bgm_mutex);
 	if (bgmstream)
 	{
 		if (bgmstream->status == STREAM_PLAY)
 			bgmstream->status = STREAM_PAUSE;
 	}
+	SDL_UnlockMutex (bgm_mutex);
 }
 
 void BGM_Resume (void)
 {
+	SDL_LockMutex (bgm_mutex);
 	if (bgmstream)
 	{
 		if (bgmstream->status == STREAM_PAUSE)
 			bgmstream->status = STREAM_PLAY;
 	}
+	SDL_UnlockMutex (bgm_mutex);
 }
 
 static void BGM_UpdateStream (void)
@@ -377,6 +446,7 @@ static void BGM_UpdateStream (void)
 	int		 bufferSamples;
 	int		 fileSamples;
 	int		 fileBytes;
+	uint64_t start;
 	byte	 raw[16384];
 
 	if (bgmstream->status != STREAM_PLAY)
@@ -408,7 +478,9 @@ static void BGM_UpdateStream (void)
 		}
 
 		/* Read */
+		start = SDL_GetPerformanceCounter ();
 		res = S_CodecReadStream (bgmstream, fileBytes, raw);
+		S_AddMusicDecodeTime (SDL_GetPerformanceCounter () - start);
 		if (res < fileBytes)
 		{
 			fileBytes = res;
@@ -465,6 +537,7 @@ void BGM_Update (void)
 			Cvar_SetQuick (&bgmvolume, "1");
 		old_volume = bgmvolume.value;
 	}
-	if (bgmstream)
+	// without the music thread the stream is decoded here
+	if (bgmstream && !bgm_thread)
 		BGM_UpdateStream ();
 }
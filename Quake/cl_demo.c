@@ -29,9 +29,113 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "bgmusic.h"
 
 static void CL_FinishTimeDemo (void);
+static void CL_BenchmarkRunFinished (int frames, float time);
 
 static char name[MAX_OSPATH];
 
+typedef enum
+{
+	TIMEDEMO_FRAME,	 // wall clock time between frames
+	TIMEDEMO_CPU,	 // host + render + sound
+	TIMEDEMO_HOST,	 // input, server and client message parsing
+	TIMEDEMO_RENDER, // SCR_UpdateScreen, including waiting on the R_RenderView tasks
+	TIMEDEMO_UI,	 // RmlUI CPU time, part of render
+	TIMEDEMO_SOUND,
+	TIMEDEMO_GPU,
+	TIMEDEMO_GPU_TIMERS, // one per gpu_timer_t, part of gpu
+	TIMEDEMO_NUM_PHASES = TIMEDEMO_GPU_TIMERS + GPU_TIMER_NUM,
+} timedemo_phase_t;
+
+static const char *timedemo_phase_names[TIMEDEMO_GPU_TIMERS] = {"frame", "cpu", "host", "render", "ui", "sound", "gpu"};
+
+typedef struct
+{
+	float ms[TIMEDEMO_NUM_PHASES];
+} timedemo_frame_t;
+
+typedef struct
+{
+	float avg;
+	float p50;
+	float p95;
+	float p99;
+	float max;
+} timedemo_stats_t;
+
+static qboolean			 timedemo_report;
+static timedemo_frame_t *timedemo_frames;
+static double			 timedemo_last_frame_time;
+
+// Seek points recorded while a demo plays. Entity updates are relative to the baselines, so only
+// the state that isn't resent every frame has to be kept to resume parsing at a keyframe.
+#define DEMO_KEYFRAME_INTERVAL 10.0f
+
+typedef struct
+{
+	char name[MAX_SCOREBOARDNAME];
+	int	 frags;
+	int	 colors;
+} demo_keyframe_score_t;
+
+typedef struct
+{
+	qfileofs_t			  offset;		// start of the next message
+	qfileofs_t			  prespawn_end; // level the keyframe belongs to
+	float				  time;
+	vec3_t				  mviewangles;
+	int					  viewentity;
+	int					  stats[MAX_CL_STATS];
+	float				  statsf[MAX_CL_STATS];
+	lightstyle_t		  lightstyles[MAX_LIGHTSTYLES];
+	demo_keyframe_score_t scores[MAX_SCOREBOARD];
+	char				  commands[256]; // fog and sky
+} demo_keyframe_t;
+
+static demo_keyframe_t *demo_keyframes;
+static char				demo_keyframes_name[MAX_OSPATH];
+static int				demo_keyframes_length;
+
+// Recorded messages are collected in memory and written out by a background task,
+// so a slow disk or network share doesn't stall client frames
+#define DEMO_FLUSH_SIZE		(64 * 1024)
+#define DEMO_FLUSH_INTERVAL 1.0 // seconds, bounds what a crash can lose
+
+static byte			*demo_write_pending; // not handed to the writer yet
+static byte			*demo_write_buffer;	 // being written by demo_write_task
+static task_handle_t demo_write_task = INVALID_TASK_HANDLE;
+static double		 demo_write_last_flush;
+static qboolean		 demo_write_failed;
+
+#define MAX_BENCHMARK_DEMOS 64
+#define MAX_BENCHMARK_CVARS 32
+
+typedef struct
+{
+	char			  name[MAX_QPATH];
+	qboolean		  failed;
+	float			 *fps;	  // one per timed run
+	timedemo_frame_t *frames; // of all timed runs
+} benchmark_demo_t;
+
+typedef struct
+{
+	cvar_t *var;
+	char   *old_value;
+} benchmark_cvar_t;
+
+static qboolean			benchmark_active;
+static char				benchmark_name[MAX_QPATH];
+static int				benchmark_warmup;
+static int				benchmark_repeat;
+static qboolean			benchmark_vid_restart;
+static int				benchmark_num_demos;
+static benchmark_demo_t benchmark_demos[MAX_BENCHMARK_DEMOS];
+static int				benchmark_num_cvars;
+static benchmark_cvar_t benchmark_cvars[MAX_BENCHMARK_CVARS];
+static int				benchmark_current_demo;
+static int				benchmark_current_run; // warmup runs first
+static qboolean			benchmark_restart_pending;
+
 /*
 ==============================================================================
 
@@ -69,6 +173,72 @@ void CL_StopPlayback (void)
 		CL_FinishTimeDemo ();
 }
 
+/*
+====================
+CL_DemoWriteTask
+====================
+*/
+static void CL_DemoWriteTask (FILE **file)
+{
+	if ((fwrite (demo_write_buffer, VEC_SIZE (demo_write_buffer), 1, *file) != 1) || (fflush (*file) != 0))
+		demo_write_failed = true;
+}
+
+/*
+====================
+CL_JoinDemoWriter
+====================
+*/
+static qboolean CL_JoinDemoWriter (uint32_t timeout)
+{
+	if (demo_write_task == INVALID_TASK_HANDLE)
+		return true;
+	if (!Task_Join (demo_write_task, timeout))
+		return false;
+	demo_write_task = INVALID_TASK_HANDLE;
+	VEC_CLEAR (demo_write_buffer);
+	if (demo_write_failed)
+	{
+		Con_Printf ("ERROR: couldn't write to demo file\n");
+		demo_write_failed = false;
+	}
+	return true;
+}
+
+/*
+====================
+CL_FlushDemoWrites
+
+Hands the pending messages to the writer task unless it is still busy
+====================
+*/
+static void CL_FlushDemoWrites (void)
+{
+	if (!VEC_SIZE (demo_write_pending) || !CL_JoinDemoWriter (0))
+		return;
+
+	byte *swap = demo_write_buffer;
+	demo_write_buffer = demo_write_pending;
+	demo_write_pending = swap;
+	demo_write_last_flush = realtime;
+	demo_write_task = Task_AllocateAssignBackgroundFuncAndSubmit ((task_func_t)CL_DemoWriteTask, &cls.demofile, sizeof (FILE *));
+}
+
+/*
+====================
+CL_FinishDemoWrites
+
+Writes out everything recorded so far, the demo file can be closed or seeked afterwards
+====================
+*/
+static void CL_FinishDemoWrites (void)
+{
+	CL_JoinDemoWriter (TASK_TIMEOUT_INFINITE);
+	if (VEC_SIZE (demo_write_pending) && ((fwrite (demo_write_pending, VEC_SIZE (demo_write_pending), 1, cls.demofile) != 1) || (fflush (cls.demofile) != 0)))
+		Con_Printf ("ERROR: couldn't write to demo file\n");
+	VEC_CLEAR (demo_write_pending);
+}
+
 /*
 ====================
 CL_WriteDemoMessage
@@ -83,14 +253,111 @@ static void CL_WriteDemoMessage (void)
 	float f;
 
 	len = LittleLong (net_message.cursize);
-	fwrite (&len, 4, 1, cls.demofile);
+	Vec_Append ((void **)&demo_write_pending, 1, &len, 4);
 	for (i = 0; i < 3; i++)
 	{
 		f = LittleFloat (cl.viewangles[i]);
-		fwrite (&f, 4, 1, cls.demofile);
+		Vec_Append ((void **)&demo_write_pending, 1, &f, 4);
+	}
+	Vec_Append ((void **)&demo_write_pending, 1, net_message.data, net_message.cursize);
+
+	if ((VEC_SIZE (demo_write_pending) >= DEMO_FLUSH_SIZE) || (realtime - demo_write_last_flush >= DEMO_FLUSH_INTERVAL))
+		CL_FlushDemoWrites ();
+}
+
+/*
+====================
+CL_AddDemoKeyframe
+
+Called before reading a message, adds a keyframe if the index doesn't reach this far yet
+====================
+*/
+static void CL_AddDemoKeyframe (void)
+{
+	if (cl.intermission || (cl.protocol_pext2 & PEXT2_REPLACEMENTDELTAS) || !cls.demo_prespawn_end)
+		return;
+
+	const qfileofs_t offset = Sys_ftell (cls.demofile);
+	const int		 num_keyframes = VEC_SIZE (demo_keyframes);
+	if (num_keyframes > 0)
+	{
+		const demo_keyframe_t *last = &demo_keyframes[num_keyframes - 1];
+		if (offset <= last->offset)
+			return;
+		if ((last->prespawn_end == cls.demo_prespawn_end) && (cl.mtime[0] < last->time + DEMO_KEYFRAME_INTERVAL))
+			return;
+	}
+
+	demo_keyframe_t keyframe;
+	keyframe.offset = offset;
+	keyframe.prespawn_end = cls.demo_prespawn_end;
+	keyframe.time = cl.mtime[0];
+	VectorCopy (cl.mviewangles[0], keyframe.mviewangles);
+	keyframe.viewentity = cl.viewentity;
+	memcpy (keyframe.stats, cl.stats, sizeof (keyframe.stats));
+	memcpy (keyframe.statsf, cl.statsf, sizeof (keyframe.statsf));
+	memcpy (keyframe.lightstyles, cl_lightstyle, sizeof (keyframe.lightstyles));
+	memset (keyframe.scores, 0, sizeof (keyframe.scores));
+	for (int i = 0; i < cl.maxclients; i++)
+	{
+		q_strlcpy (keyframe.scores[i].name, cl.scores[i].name, sizeof (keyframe.scores[i].name));
+		keyframe.scores[i].frags = cl.scores[i].frags;
+		keyframe.scores[i].colors = cl.scores[i].colors;
+	}
+	q_strlcpy (keyframe.commands, Fog_GetFogCommand (true), sizeof (keyframe.commands));
+	const char *sky_cmd = Sky_GetSkyCommand (false);
+	if (sky_cmd)
+		q_strlcat (keyframe.commands, sky_cmd, sizeof (keyframe.commands));
+	VEC_PUSH (demo_keyframes, keyframe);
+}
+
+/*
+====================
+CL_FindDemoKeyframe
+
+Returns the last keyframe of the current level at or before time
+====================
+*/
+static const demo_keyframe_t *CL_FindDemoKeyframe (float time)
+{
+	if (cl.protocol_pext2 & PEXT2_REPLACEMENTDELTAS)
+		return NULL;
+
+	for (int i = VEC_SIZE (demo_keyframes) - 1; i >= 0; i--)
+	{
+		const demo_keyframe_t *keyframe = &demo_keyframes[i];
+		if ((keyframe->prespawn_end == cls.demo_prespawn_end) && (keyframe->time <= time))
+			return keyframe;
+	}
+	return NULL;
+}
+
+/*
+====================
+CL_RestoreDemoKeyframe
+====================
+*/
+static void CL_RestoreDemoKeyframe (const demo_keyframe_t *keyframe)
+{
+	Sys_fseek (cls.demofile, keyframe->offset, SEEK_SET);
+	cl.mtime[0] = cl.time = keyframe->time;
+	VectorCopy (keyframe->mviewangles, cl.mviewangles[0]);
+	cl.viewentity = keyframe->viewentity;
+	memcpy (cl.stats, keyframe->stats, sizeof (cl.stats));
+	memcpy (cl.statsf, keyframe->statsf, sizeof (cl.statsf));
+	cl_stats_generation++;
+	memcpy (cl_lightstyle, keyframe->lightstyles, sizeof (cl_lightstyle));
+	for (int i = 0; i < cl.maxclients; i++)
+	{
+		q_strlcpy (cl.scores[i].name, keyframe->scores[i].name, sizeof (cl.scores[i].name));
+		cl.scores[i].frags = keyframe->scores[i].frags;
+		if (cl.scores[i].colors != keyframe->scores[i].colors)
+		{
+			cl.scores[i].colors = keyframe->scores[i].colors;
+			CL_NewTranslation (i);
+		}
 	}
-	fwrite (net_message.data, net_message.cursize, 1, cls.demofile);
-	fflush (cls.demofile);
+	Cbuf_InsertText (keyframe->commands);
 }
 
 static int CL_GetDemoMessage (void)
@@ -134,6 +401,9 @@ static int CL_GetDemoMessage (void)
 	else if (cls.signon < (SIGNONS - 2))
 		cls.demo_prespawn_end = 0;
 
+	if (cls.signon == SIGNONS)
+		CL_AddDemoKeyframe ();
+
 	// get the next message
 	if (fread (&net_message.cursize, 4, 1, cls.demofile) != 1)
 	{
@@ -206,16 +476,21 @@ void		 CL_Seek_f (void)
 	qboolean relative = offset < 0 || Cmd_Argv (1)[0] == '+';
 	cls.seektime = relative ? cl.time + offset : offset;
 
+	// resume at the closest keyframe when going back, or when it skips a long way forward
+	const qboolean		   rewind = (offset < 0 || (!relative && offset < cl.time)) && cls.demo_prespawn_end;
+	const demo_keyframe_t *keyframe = CL_FindDemoKeyframe (cls.seektime);
+	if (keyframe && !rewind && (keyframe->time < cl.mtime[0] + DEMO_KEYFRAME_INTERVAL))
+		keyframe = NULL;
+
 	// large positive offsets could benefit from demoseeking, but we'd lose prints etc
-	if ((offset < 0 || (!relative && offset < cl.time)) && cls.demo_prespawn_end)
+	if (rewind || keyframe)
 	{
-		Sys_fseek (cls.demofile, cls.demo_prespawn_end, SEEK_SET);
-		cl.mtime[0] = cl.time = 0;
 		cls.demoseeking = true;
 
 		memset (cl_dlights, 0, sizeof (cl_dlights));
 		memset (cl_temp_entities, 0, sizeof (cl_temp_entities));
 		memset (cl_beams, 0, sizeof (cl_beams));
+		cl_num_beam_segments = 0;
 		V_ResetBlend ();
 		Fog_NewMap ();
 		Sky_NewMap ();
@@ -229,11 +504,19 @@ void		 CL_Seek_f (void)
 			cl.intermission = 0;
 			BGM_Stop ();
 		}
-		memset (cl.stats, 0, sizeof (cl.stats));
-		memset (cl.statsf, 0, sizeof (cl.statsf));
-
-		// replay last signon for stats and lightstyles
-		cls.signon = (SIGNONS - 2);
+		if (keyframe)
+			CL_RestoreDemoKeyframe (keyframe);
+		else
+		{
+			Sys_fseek (cls.demofile, cls.demo_prespawn_end, SEEK_SET);
+			cl.mtime[0] = cl.time = 0;
+			memset (cl.stats, 0, sizeof (cl.stats));
+			memset (cl.statsf, 0, sizeof (cl.statsf));
+			cl_stats_generation++;
+
+			// replay last signon for stats and lightstyles
+			cls.signon = (SIGNONS - 2);
+		}
 		S_StopAllSounds (true, true);
 	}
 	else
@@ -300,6 +583,7 @@ void CL_Stop_f (void)
 	CL_WriteDemoMessage ();
 
 	// finish up
+	CL_FinishDemoWrites ();
 	fclose (cls.demofile);
 	cls.demofile = NULL;
 	cls.demorecording = false;
@@ -649,6 +933,7 @@ void CL_Record_f (void)
 		Con_Printf ("ERROR: couldn't create %s\n", name);
 		return;
 	}
+	COM_AddIndexedFile (name);
 
 	cls.forcetrack = track;
 	fprintf (cls.demofile, "%i\n", cls.forcetrack);
@@ -710,7 +995,7 @@ void CL_PlayDemo_f (void)
 
 	Con_Printf ("Playing demo from %s.\n", name);
 
-	COM_FOpenFile (name, &cls.demofile, NULL);
+	const int length = COM_FOpenFile (name, &cls.demofile, NULL);
 	if (!cls.demofile)
 	{
 		Con_Printf ("ERROR: couldn't open %s\n", name);
@@ -718,6 +1003,14 @@ void CL_PlayDemo_f (void)
 		return;
 	}
 
+	// keep the keyframes when the same demo is played again
+	if (strcmp (demo_keyframes_name, name) || (demo_keyframes_length != length))
+	{
+		VEC_CLEAR (demo_keyframes);
+		q_strlcpy (demo_keyframes_name, name, sizeof (demo_keyframes_name));
+		demo_keyframes_length = length;
+	}
+
 	// ZOID, fscanf is evil
 	// O.S.: if a space character e.g. 0x20 (' ') follows '\n',
 	// fscanf skips that byte too and screws up further reads.
@@ -746,6 +1039,149 @@ void CL_PlayDemo_f (void)
 	}
 }
 
+/*
+====================
+CL_TimeDemoFrame
+
+Records the phase times of a frame for timedemo_report
+====================
+*/
+void CL_TimeDemoFrame (double host_time, double render_time, double sound_time)
+{
+	if (!timedemo_report || cls.signon != SIGNONS)
+		return;
+
+	const double now = Sys_DoubleTime ();
+	// the first frame didn't count, same as CL_FinishTimeDemo
+	if ((host_framecount > cls.td_startframe) && (timedemo_last_frame_time != 0.0))
+	{
+		timedemo_frame_t frame;
+		frame.ms[TIMEDEMO_FRAME] = (now - timedemo_last_frame_time) * 1000.0;
+		frame.ms[TIMEDEMO_CPU] = host_time + render_time + sound_time;
+		frame.ms[TIMEDEMO_HOST] = host_time;
+		frame.ms[TIMEDEMO_RENDER] = render_time;
+		frame.ms[TIMEDEMO_UI] = 0.0f;
+#ifdef USE_RMLUI
+		ui_perf_stats_t ui_stats;
+		UI_GetPerfStats (&ui_stats);
+		frame.ms[TIMEDEMO_UI] = ui_stats.total_ms;
+#endif
+		frame.ms[TIMEDEMO_SOUND] = sound_time;
+		frame.ms[TIMEDEMO_GPU] = GL_GetLastFrameGPUTime ();
+		for (int timer = 0; timer < GPU_TIMER_NUM; ++timer)
+			frame.ms[TIMEDEMO_GPU_TIMERS + timer] = GL_GetLastFrameGPUTimer (timer);
+		VEC_PUSH (timedemo_frames, frame);
+	}
+	timedemo_last_frame_time = now;
+}
+
+/*
+====================
+CL_TimeDemoPhaseName
+====================
+*/
+static const char *CL_TimeDemoPhaseName (int phase)
+{
+	if (phase < TIMEDEMO_GPU_TIMERS)
+		return timedemo_phase_names[phase];
+	return va ("gpu_%s", gpu_timer_names[phase - TIMEDEMO_GPU_TIMERS]);
+}
+
+static int CL_TimeDemoCompare (const void *a, const void *b)
+{
+	const float fa = *(const float *)a;
+	const float fb = *(const float *)b;
+	return (fa > fb) - (fa < fb);
+}
+
+/*
+====================
+CL_TimeDemoPercentile
+
+Nearest-rank percentile of a sorted array
+====================
+*/
+static float CL_TimeDemoPercentile (const float *sorted, int count, int percentile)
+{
+	const int rank = (count * percentile + 99) / 100;
+	return sorted[CLAMP (0, rank - 1, count - 1)];
+}
+
+/*
+====================
+CL_TimeDemoStats
+
+Distribution of one phase, sorted needs room for count floats
+====================
+*/
+static void CL_TimeDemoStats (const timedemo_frame_t *frames, int count, int phase, float *sorted, timedemo_stats_t *stats)
+{
+	double sum = 0.0;
+	for (int i = 0; i < count; ++i)
+	{
+		sorted[i] = frames[i].ms[phase];
+		sum += sorted[i];
+	}
+	qsort (sorted, count, sizeof (float), CL_TimeDemoCompare);
+	stats->avg = sum / count;
+	stats->p50 = CL_TimeDemoPercentile (sorted, count, 50);
+	stats->p95 = CL_TimeDemoPercentile (sorted, count, 95);
+	stats->p99 = CL_TimeDemoPercentile (sorted, count, 99);
+	stats->max = sorted[count - 1];
+}
+
+/*
+====================
+CL_TimeDemoReport
+
+Prints frame time percentiles and writes all frames to a CSV file
+====================
+*/
+static void CL_TimeDemoReport (void)
+{
+	const int count = VEC_SIZE (timedemo_frames);
+	if (count == 0)
+	{
+		Con_Printf ("timedemo_report: no frames recorded\n");
+		return;
+	}
+
+	float *sorted = Mem_Alloc (count * sizeof (float));
+	Con_Printf ("%-13s %8s %8s %8s %8s %8s\n", "ms", "avg", "p50", "p95", "p99", "max");
+	for (int phase = 0; phase < TIMEDEMO_NUM_PHASES; ++phase)
+	{
+		timedemo_stats_t stats;
+		CL_TimeDemoStats (timedemo_frames, count, phase, sorted, &stats);
+		Con_Printf ("%-13s %8.2f %8.2f %8.2f %8.2f %8.2f\n", CL_TimeDemoPhaseName (phase), stats.avg, stats.p50, stats.p95, stats.p99, stats.max);
+	}
+	Mem_Free (sorted);
+
+	char base[MAX_OSPATH];
+	char csv_name[MAX_OSPATH];
+	COM_FileBase (name, base, sizeof (base));
+	q_snprintf (csv_name, sizeof (csv_name), "%s/timedemo_%s.csv", com_gamedir, base);
+	COM_CreatePath (csv_name);
+	FILE *f = fopen (csv_name, "w");
+	if (!f)
+	{
+		Con_Printf ("ERROR: couldn't open file %s.\n", csv_name);
+		return;
+	}
+	fprintf (f, "frame");
+	for (int phase = 0; phase < TIMEDEMO_NUM_PHASES; ++phase)
+		fprintf (f, ",%s_ms", CL_TimeDemoPhaseName (phase));
+	fprintf (f, "\n");
+	for (int i = 0; i < count; ++i)
+	{
+		fprintf (f, "%d", i);
+		for (int phase = 0; phase < TIMEDEMO_NUM_PHASES; ++phase)
+			fprintf (f, ",%.3f", timedemo_frames[i].ms[phase]);
+		fprintf (f, "\n");
+	}
+	fclose (f);
+	Con_Printf ("Wrote %d frames to %s.\n", count, csv_name);
+}
+
 /*
 ====================
 CL_FinishTimeDemo
@@ -764,7 +1200,21 @@ static void CL_FinishTimeDemo (void)
 	time = realtime - cls.td_starttime;
 	if (!time)
 		time = 1;
-	Con_Printf ("%i frames %5.1f seconds %5.1f fps\n", frames, time, frames / time);
+	if (cls.td_parseonly)
+		Con_Printf ("%i messages %5.1f seconds %5.1f messages/s, not rendered\n", frames, time, frames / time);
+	else
+		Con_Printf ("%i frames %5.1f seconds %5.1f fps\n", frames, time, frames / time);
+	cls.td_parseonly = false;
+
+	if (timedemo_report)
+	{
+		if (benchmark_active)
+			CL_BenchmarkRunFinished (frames, time);
+		else
+			CL_TimeDemoReport ();
+		timedemo_report = false;
+		VEC_FREE (timedemo_frames);
+	}
 }
 
 /*
@@ -795,4 +1245,350 @@ void CL_TimeDemo_f (void)
 	cls.timedemo = true;
 	cls.td_startframe = host_framecount;
 	cls.td_lastframe = -1; // get a new message this frame
+	cls.td_parseonly = false;
+	timedemo_report = false;
+}
+
+/*
+====================
+CL_TimeDemoReport_f
+
+timedemo_report [demoname]
+====================
+*/
+void CL_TimeDemoReport_f (void)
+{
+	if (cmd_source != src_command)
+		return;
+
+	if (Cmd_Argc () != 2)
+	{
+		Con_Printf ("timedemo_report <demoname> : gets frame time percentiles and writes timedemo_<demoname>.csv\n");
+		return;
+	}
+
+	CL_TimeDemo_f ();
+	if (!cls.timedemo)
+		return;
+
+	timedemo_report = true;
+	VEC_CLEAR (timedemo_frames);
+	timedemo_last_frame_time = 0.0;
+}
+
+/*
+====================
+CL_TimeDemoParse_f
+
+timedemo_parse [demoname]
+====================
+*/
+void CL_TimeDemoParse_f (void)
+{
+	if (cmd_source != src_command)
+		return;
+
+	if (Cmd_Argc () != 2)
+	{
+		Con_Printf ("timedemo_parse <demoname> : gets demo message parsing speed without rendering\n");
+		return;
+	}
+
+	CL_TimeDemo_f ();
+	if (!cls.timedemo)
+		return;
+
+	cls.td_parseonly = true;
+}
+
+/*
+==============================================================================
+
+BENCHMARK
+
+Runs a list of demos back to back with timedemo_report and writes the frame time
+distribution of each demo to benchmark_<listfile>.json. The list file has one
+directive per line:
+
+warmup <count>        untimed runs of each demo, 1 by default
+repeat <count>        timed runs of each demo, 3 by default
+set <cvar> <value>    applied for the whole benchmark, restored at the end
+vid_restart           restart video before the runs of each demo
+demo <name>           adds a demo
+==============================================================================
+*/
+
+/*
+====================
+CL_BenchmarkClear
+====================
+*/
+static void CL_BenchmarkClear (void)
+{
+	for (int i = 0; i < benchmark_num_demos; i++)
+	{
+		VEC_FREE (benchmark_demos[i].fps);
+		VEC_FREE (benchmark_demos[i].frames);
+	}
+	for (int i = 0; i < benchmark_num_cvars; i++)
+	{
+		Cvar_SetQuick (benchmark_cvars[i].var, benchmark_cvars[i].old_value);
+		Mem_Free (benchmark_cvars[i].old_value);
+	}
+	benchmark_num_demos = 0;
+	benchmark_num_cvars = 0;
+	benchmark_active = false;
+}
+
+/*
+====================
+CL_BenchmarkWriteString
+====================
+*/
+static void CL_BenchmarkWriteString (FILE *f, const char *str)
+{
+	fputc ('"', f);
+	for (; *str; str++)
+	{
+		if (*str == '"' || *str == '\\')
+			fputc ('\\', f);
+		if ((unsigned char)*str >= ' ')
+			fputc (*str, f);
+	}
+	fputc ('"', f);
+}
+
+/*
+====================
+CL_BenchmarkWriteReport
+====================
+*/
+static void CL_BenchmarkWriteReport (void)
+{
+	char report_name[MAX_OSPATH];
+	q_snprintf (report_name, sizeof (report_name), "%s/benchmark_%s.json", com_gamedir, benchmark_name);
+	COM_CreatePath (report_name);
+	FILE *f = fopen (report_name, "w");
+	if (!f)
+	{
+		Con_Printf ("ERROR: couldn't open file %s.\n", report_name);
+		return;
+	}
+
+	fprintf (f, "{\n\t\"engine\": ");
+	CL_BenchmarkWriteString (f, ENGINE_NAME_AND_VER);
+	fprintf (f, ",\n\t\"device\": ");
+	CL_BenchmarkWriteString (f, vulkan_globals.device_properties.deviceName);
+	fprintf (f, ",\n\t\"width\": %d,\n\t\"height\": %d,\n\t\"warmup\": %d,\n\t\"repeat\": %d,\n\t\"cvars\": {", vid.width, vid.height, benchmark_warmup, benchmark_repeat);
+	for (int i = 0; i < benchmark_num_cvars; i++)
+	{
+		fprintf (f, "%s\n\t\t", i ? "," : "");
+		CL_BenchmarkWriteString (f, benchmark_cvars[i].var->name);
+		fprintf (f, ": ");
+		CL_BenchmarkWriteString (f, benchmark_cvars[i].var->string);
+	}
+	fprintf (f, "\n\t},\n\t\"demos\": [");
+
+	for (int i = 0; i < benchmark_num_demos; i++)
+	{
+		const benchmark_demo_t *demo = &benchmark_demos[i];
+		const int				count = VEC_SIZE (demo->frames);
+		fprintf (f, "%s\n\t\t{\n\t\t\t\"name\": ", i ? "," : "");
+		CL_BenchmarkWriteString (f, demo->name);
+		if (demo->failed || count == 0)
+		{
+			fprintf (f, ",\n\t\t\t\"error\": \"%s\"\n\t\t}", demo->failed ? "couldn't play demo" : "no frames recorded");
+			continue;
+		}
+
+		fprintf (f, ",\n\t\t\t\"frames\": %d,\n\t\t\t\"fps\": [", count);
+		for (int run = 0; run < (int)VEC_SIZE (demo->fps); run++)
+			fprintf (f, "%s%.2f", run ? ", " : "", demo->fps[run]);
+		fprintf (f, "],\n\t\t\t\"ms\": {");
+
+		float *sorted = Mem_Alloc (count * sizeof (float));
+		for (int phase = 0; phase < TIMEDEMO_NUM_PHASES; ++phase)
+		{
+			timedemo_stats_t stats;
+			CL_TimeDemoStats (demo->frames, count, phase, sorted, &stats);
+			fprintf (
+				f, "%s\n\t\t\t\t\"%s\": {\"avg\": %.3f, \"p50\": %.3f, \"p95\": %.3f, \"p99\": %.3f, \"max\": %.3f}", phase ? "," : "",
+				CL_TimeDemoPhaseName (phase), stats.avg, stats.p50, stats.p95, stats.p99, stats.max);
+		}
+		Mem_Free (sorted);
+		fprintf (f, "\n\t\t\t}\n\t\t}");
+	}
+	fprintf (f, "\n\t]\n}\n");
+	fclose (f);
+	Con_Printf ("Wrote %s.\n", report_name);
+}
+
+/*
+====================
+CL_BenchmarkNextDemo
+====================
+*/
+static void CL_BenchmarkNextDemo (void)
+{
+	benchmark_current_demo++;
+	benchmark_current_run = 0;
+	benchmark_restart_pending = benchmark_vid_restart;
+}
+
+/*
+====================
+CL_BenchmarkRunFinished
+
+Called by CL_FinishTimeDemo with the frames of a run in timedemo_frames
+====================
+*/
+static void CL_BenchmarkRunFinished (int frames, float time)
+{
+	benchmark_demo_t *demo = &benchmark_demos[benchmark_current_demo];
+	if (benchmark_current_run >= benchmark_warmup)
+	{
+		VEC_PUSH (demo->fps, frames / time);
+		Vec_Append ((void **)&demo->frames, sizeof (timedemo_frame_t), timedemo_frames, VEC_SIZE (timedemo_frames));
+	}
+	if (++benchmark_current_run == benchmark_warmup + benchmark_repeat)
+		CL_BenchmarkNextDemo ();
+}
+
+/*
+====================
+CL_BenchmarkFrame
+
+Starts the next run once the previous demo has finished
+====================
+*/
+void CL_BenchmarkFrame (void)
+{
+	if (!benchmark_active || cls.demoplayback)
+		return;
+
+	if (benchmark_current_demo == benchmark_num_demos)
+	{
+		CL_BenchmarkWriteReport ();
+		CL_BenchmarkClear ();
+		return;
+	}
+
+	// the restart happens when the command buffer runs next frame
+	if (benchmark_restart_pending)
+	{
+		benchmark_restart_pending = false;
+		Cbuf_AddText ("vid_restart\n");
+		return;
+	}
+
+	benchmark_demo_t *demo = &benchmark_demos[benchmark_current_demo];
+	Con_Printf (
+		"benchmark: %s %s %d/%d\n", demo->name, (benchmark_current_run < benchmark_warmup) ? "warmup" : "run",
+		(benchmark_current_run < benchmark_warmup) ? benchmark_current_run + 1 : benchmark_current_run - benchmark_warmup + 1,
+		(benchmark_current_run < benchmark_warmup) ? benchmark_warmup : benchmark_repeat);
+	Cmd_ExecuteString (va ("timedemo_report %s", demo->name), src_command);
+	if (!cls.timedemo)
+	{
+		demo->failed = true;
+		CL_BenchmarkNextDemo ();
+	}
+}
+
+/*
+====================
+CL_Benchmark_f
+
+benchmark <listfile>
+====================
+*/
+void CL_Benchmark_f (void)
+{
+	if (cmd_source != src_command)
+		return;
+
+	if (Cmd_Argc () != 2)
+	{
+		Con_Printf ("benchmark <listfile> : runs the demos in listfile and writes benchmark_<listfile>.json\n");
+		return;
+	}
+
+	if (benchmark_active)
+	{
+		Con_Printf ("A benchmark is already running.\n");
+		return;
+	}
+
+	char *list = (char *)COM_LoadFile (Cmd_Argv (1), NULL);
+	if (!list)
+	{
+		Con_Printf ("ERROR: couldn't load %s\n", Cmd_Argv (1));
+		return;
+	}
+	COM_FileBase (Cmd_Argv (1), benchmark_name, sizeof (benchmark_name));
+
+	benchmark_warmup = 1;
+	benchmark_repeat = 3;
+	benchmark_vid_restart = false;
+	const char *data = list;
+	while ((data = COM_Parse (data)) != NULL)
+	{
+		if (!strcmp (com_token, "warmup"))
+		{
+			data = COM_Parse (data);
+			benchmark_warmup = q_max (0, atoi (com_token));
+		}
+		else if (!strcmp (com_token, "repeat"))
+		{
+			data = COM_Parse (data);
+			benchmark_repeat = q_max (1, atoi (com_token));
+		}
+		else if (!strcmp (com_token, "vid_restart"))
+			benchmark_vid_restart = true;
+		else if (!strcmp (com_token, "set"))
+		{
+			data = COM_Parse (data);
+			cvar_t *var = Cvar_FindVar (com_token);
+			data = COM_Parse (data);
+			if (!var)
+				Con_Printf ("benchmark: unknown cvar in %s\n", Cmd_Argv (1));
+			else if (benchmark_num_cvars == MAX_BENCHMARK_CVARS)
+				Con_Printf ("benchmark: more than %d cvars in %s\n", MAX_BENCHMARK_CVARS, Cmd_Argv (1));
+			else
+			{
+				benchmark_cvars[benchmark_num_cvars].var = var;
+				benchmark_cvars[benchmark_num_cvars].old_value = q_strdup (var->string);
+				benchmark_num_cvars++;
+				Cvar_SetQuick (var, com_token);
+			}
+		}
+		else if (!strcmp (com_token, "demo"))
+		{
+			data = COM_Parse (data);
+			if (benchmark_num_demos == MAX_BENCHMARK_DEMOS)
+				Con_Printf ("benchmark: more than %d demos in %s\n", MAX_BENCHMARK_DEMOS, Cmd_Argv (1));
+			else if (com_token[0])
+			{
+				benchmark_demo_t *demo = &benchmark_demos[benchmark_num_demos++];
+				q_strlcpy (demo->name, com_token, sizeof (demo->name));
+				demo->failed = false;
+			}
+		}
+		else
+			Con_Printf ("benchmark: unknown directive \"%s\" in %s\n", com_token, Cmd_Argv (1));
+	}
+	Mem_Free (list);
+
+	if (!benchmark_num_demos)
+	{
+		Con_Printf ("benchmark: no demos in %s\n", Cmd_Argv (1));
+		CL_BenchmarkClear ();
+		return;
+	}
+
+	Con_Printf ("benchmark: %d demos, %d warmup and %d timed runs each\n", benchmark_num_demos, benchmark_warmup, benchmark_repeat);
+	benchmark_active = true;
+	benchmark_current_demo = 0;
+	benchmark_current_run = 0;
+	benchmark_restart_pending = benchmark_vid_restart;
+	cls.demonum = -1; // stop demo loop
 }
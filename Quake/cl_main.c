@@ -56,6 +56,7 @@ cvar_t cl_startdemos = {"cl_startdemos", "1", CVAR_ARCHIVE};
 
 client_static_t cls;
 client_state_t	cl;
+unsigned int	cl_stats_generation; // never reset, see client.h
 // FIXME: put these on hunk?
 lightstyle_t	cl_lightstyle[MAX_LIGHTSTYLES];
 dlight_t		cl_dlights[MAX_DLIGHTS];
@@ -115,10 +116,10 @@ void CL_FreeState (void)
 	Mem_Free (cl.scores);
 	for (i = 0; i < MAX_PARTICLETYPES; ++i)
 		Mem_Free (cl.particle_precache[i].name);
-	for (i = 0; i < cl.num_efragallocs; ++i)
-		Mem_Free (cl.efrag_allocs[i]);
-	Mem_Free (cl.efrag_allocs);
+	Mem_Free (cl.efrags);
+	Mem_Free (cl.efrag_entities);
 	memset (&cl, 0, sizeof (cl));
+	cl_stats_generation++;
 }
 
 /*
@@ -142,6 +143,7 @@ void CL_ClearState (void)
 	memset (cl_lightstyle, 0, sizeof (cl_lightstyle));
 	memset (cl_temp_entities, 0, sizeof (cl_temp_entities));
 	memset (cl_beams, 0, sizeof (cl_beams));
+	cl_num_beam_segments = 0;
 
 	// johnfitz -- cl_entities is now dynamically allocated
 	cl.max_edicts = CLAMP (MIN_EDICTS, (int)max_edicts.value, MAX_EDICTS);
@@ -211,6 +213,7 @@ void CL_Disconnect (void)
 	cls.signon = 0;
 	cls.netcon = NULL;
 	cl.intermission = 0;
+	cl_stats_generation++;
 	cl.worldmodel = NULL;
 	cl.sendprespawn = false;
 	SCR_CenterPrintClear ();
@@ -653,6 +656,37 @@ static void CL_RocketTrail (entity_t *ent, int type)
 	VectorCopy (ent->origin, ent->trailorg);
 }
 
+// interpolated origin and angles of every entity, computed up front by CL_LerpEntities
+typedef struct
+{
+	vec3_t	 origin;
+	vec3_t	 angles;
+	qboolean teleported;
+} entity_lerp_t;
+
+static entity_lerp_t *cl_entitylerps;
+
+#define MIN_ENTITIES_FOR_PARALLEL_LERP 512
+
+/*
+===============
+CL_LerpEntities
+
+Only reads the entity itself, so ranges can run on any worker.
+Attachments read their parent and are resolved later in CL_RelinkEntities.
+===============
+*/
+static void CL_LerpEntities (int begin, int end, void *payload)
+{
+	const float frac = *(float *)payload;
+	for (int i = begin; i < end; ++i)
+	{
+		entity_t *ent = &cl.entities[i];
+		if (ent->model && (ent->msgtime == cl.mtime[0]))
+			cl_entitylerps[i].teleported = CL_LerpEntity (ent, cl_entitylerps[i].origin, cl_entitylerps[i].angles, frac);
+	}
+}
+
 /*
 ===============
 CL_RelinkEntities
@@ -672,6 +706,15 @@ void CL_RelinkEntities (void)
 	// determine partial update time
 	frac = CL_LerpPoint ();
 
+	cl_entitylerps = (entity_lerp_t *)Mem_FrameAlloc (q_max (cl.num_entities, 1) * sizeof (entity_lerp_t));
+	if ((cl.num_entities >= MIN_ENTITIES_FOR_PARALLEL_LERP) && !Tasks_IsWorker ())
+	{
+		task_handle_t task = Task_AllocateAssignRangeFuncAndSubmit (CL_LerpEntities, cl.num_entities, &frac, sizeof (frac));
+		Task_Join (task, TASK_TIMEOUT_INFINITE);
+	}
+	else
+		CL_LerpEntities (0, cl.num_entities, &frac);
+
 	frametime = cl.time - cl.oldtime;
 	if (frametime < 0)
 		frametime = 0;
@@ -738,7 +781,9 @@ void CL_RelinkEntities (void)
 
 		VectorCopy (ent->origin, oldorg);
 
-		if (CL_LerpEntity (ent, ent->origin, ent->angles, frac))
+		VectorCopy (cl_entitylerps[i].origin, ent->origin);
+		VectorCopy (cl_entitylerps[i].angles, ent->angles);
+		if (cl_entitylerps[i].teleported)
 			ent->lerpflags |= LERP_RESETMOVE;
 
 		if (cl.time < cl.oldtime)
@@ -1072,6 +1117,10 @@ void CL_SendCmd (void)
 	if (cls.state != ca_connected)
 		return;
 
+	// host frames can take long at low framerates, don't leave the mouse motion of that time to the next cmd
+	if ((cls.signon == SIGNONS) && !cls.demoplayback && !isDedicated)
+		IN_SampleMouse (&cl.pendingcmd);
+
 	// get basic movement from keyboard
 	CL_BaseMove (&cmd);
 
@@ -1267,6 +1316,9 @@ void CL_Init (void)
 	Cmd_AddCommand ("stop", CL_Stop_f);
 	Cmd_AddCommand ("playdemo", CL_PlayDemo_f);
 	Cmd_AddCommand ("timedemo", CL_TimeDemo_f);
+	Cmd_AddCommand ("timedemo_report", CL_TimeDemoReport_f);
+	Cmd_AddCommand ("timedemo_parse", CL_TimeDemoParse_f);
+	Cmd_AddCommand ("benchmark", CL_Benchmark_f);
 	Cmd_AddCommand ("seek", CL_Seek_f);
 
 	Cmd_AddCommand ("tracepos", CL_Tracepos_f); // johnfitz
@@ -25,6 +25,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "quakedef.h"
 #include "bgmusic.h"
+#include "miniz.h"
 
 const char *svc_strings[128] = {
 	"svc_bad", "svc_nop", "svc_disconnect", "svc_updatestat",
@@ -138,8 +139,9 @@ static int MSG_ReadSize16 (sizebuf_t *sb)
 }
 static unsigned int CLFTE_ReadDelta (unsigned int entnum, entity_state_t *news, const entity_state_t *olds, const entity_state_t *baseline)
 {
-	unsigned int predbits = 0;
-	unsigned int bits;
+	unsigned int   predbits = 0;
+	unsigned int   bits;
+	const qboolean varint = (cl.protocol_pext2 & PEXT2_VARINTDELTAS) != 0;
 
 	bits = MSG_ReadByte ();
 	if (bits & UF_EXTEND1)
@@ -178,19 +180,34 @@ static unsigned int CLFTE_ReadDelta (unsigned int entnum, entity_state_t *news,
 
 	if (bits & UF_FRAME)
 	{
-		if (bits & UF_16BIT)
+		if (varint)
+			news->frame = MSG_ReadUInt64 ();
+		else if (bits & UF_16BIT)
 			news->frame = MSG_ReadShort ();
 		else
 			news->frame = MSG_ReadByte ();
 	}
 
-	if (bits & UF_ORIGINXY)
+	if (varint)
 	{
-		news->origin[0] = MSG_ReadCoord (cl.protocolflags);
-		news->origin[1] = MSG_ReadCoord (cl.protocolflags);
+		if (bits & UF_ORIGINXY)
+		{
+			news->origin[0] = MSG_ReadCoordDelta (baseline->origin[0], cl.protocolflags);
+			news->origin[1] = MSG_ReadCoordDelta (baseline->origin[1], cl.protocolflags);
+		}
+		if (bits & UF_ORIGINZ)
+			news->origin[2] = MSG_ReadCoordDelta (baseline->origin[2], cl.protocolflags);
+	}
+	else
+	{
+		if (bits & UF_ORIGINXY)
+		{
+			news->origin[0] = MSG_ReadCoord (cl.protocolflags);
+			news->origin[1] = MSG_ReadCoord (cl.protocolflags);
+		}
+		if (bits & UF_ORIGINZ)
+			news->origin[2] = MSG_ReadCoord (cl.protocolflags);
 	}
-	if (bits & UF_ORIGINZ)
-		news->origin[2] = MSG_ReadCoord (cl.protocolflags);
 
 	if ((bits & UF_PREDINFO) && !(cl.protocol_pext2 & PEXT2_PREDINFO))
 	{
@@ -214,7 +231,12 @@ static unsigned int CLFTE_ReadDelta (unsigned int entnum, entity_state_t *news,
 			news->angles[1] = MSG_ReadAngle (cl.protocolflags);
 	}
 
-	if ((bits & (UF_EFFECTS | UF_EFFECTS2)) == (UF_EFFECTS | UF_EFFECTS2))
+	if (varint)
+	{
+		if (bits & (UF_EFFECTS | UF_EFFECTS2))
+			news->effects = MSG_ReadUInt64 ();
+	}
+	else if ((bits & (UF_EFFECTS | UF_EFFECTS2)) == (UF_EFFECTS | UF_EFFECTS2))
 		news->effects = MSG_ReadLong ();
 	else if (bits & UF_EFFECTS2)
 		news->effects = (unsigned short)MSG_ReadShort ();
@@ -306,7 +328,9 @@ static unsigned int CLFTE_ReadDelta (unsigned int entnum, entity_state_t *news,
 
 	if (bits & UF_MODEL)
 	{
-		if (bits & UF_16BIT)
+		if (varint)
+			news->modelindex = MSG_ReadUInt64 ();
+		else if (bits & UF_16BIT)
 			news->modelindex = MSG_ReadShort ();
 		else
 			news->modelindex = MSG_ReadByte ();
@@ -956,6 +980,7 @@ static void CL_ParseServerInfo (void)
 	// parse signon message
 	str = MSG_ReadString ();
 	q_strlcpy (cl.levelname, str, sizeof (cl.levelname));
+	cl_stats_generation++;
 
 	// seperate the printfs so the server message can have a color
 	Con_Printf ("\n%s\n", Con_Quakebar (40)); // johnfitz
@@ -1023,6 +1048,14 @@ static void CL_ParseServerInfo (void)
 	// copy the naked name of the map file to the cl structure -- O.S
 	COM_StripExtension (COM_SkipPath (model_precache[1]), cl.mapname, sizeof (cl.mapname));
 
+	// read all files in the background, the loaders below only wait for the one they need
+	for (i = 1; i < nummodels; i++)
+		Mod_PrefetchModel (model_precache[i]);
+	for (i = 1; i < numsounds; i++)
+		S_PrefetchSound (sound_precache[i]);
+	COM_StartPrefetch ();
+
+	SCR_BeginLoadingPhase ("models", nummodels - 1);
 	for (i = 1; i < nummodels; i++)
 	{
 		cl.model_precache[i] = Mod_ForName (model_precache[i], false);
@@ -1030,18 +1063,24 @@ static void CL_ParseServerInfo (void)
 		{
 			Host_Error ("Model %s not found", model_precache[i]);
 		}
+		SCR_LoadingProgress (i);
 	}
+	SCR_BeginLoadingPhase ("sounds", numsounds - 1);
 	S_BeginPrecaching ();
 	for (i = 1; i < numsounds; i++)
 	{
 		cl.sound_precache[i] = S_PrecacheSound (sound_precache[i]);
+		SCR_LoadingProgress (i);
 	}
 	S_EndPrecaching ();
+	COM_EndPrefetch ();
 
 	// local state
 	cl.entities[0].model = cl.worldmodel = cl.model_precache[1];
 
+	SCR_BeginLoadingPhase ("map setup", 0);
 	R_NewMap ();
+	SCR_EndLoadingPhase ();
 
 	// johnfitz -- clear out string; we don't consider identical
 	// messages to be duplicates if the map has changed in between
@@ -1332,7 +1371,19 @@ static void CL_ParseBaseline (entity_t *ent, int version) // johnfitz -- added a
 	ent->baseline.scale = (bits & B_SCALE) ? MSG_ReadByte () : ENTSCALE_DEFAULT;
 }
 
-#define CL_SetStati(stat, val)	 cl.statsf[stat] = (cl.stats[stat] = val)
+/*
+==================
+CL_SetStati
+
+clientdata resends every stat with each message, only bump the generation when one really changed
+==================
+*/
+static void CL_SetStati (int stat, int val)
+{
+	if (cl.stats[stat] != val || cl.statsf[stat] != val)
+		cl_stats_generation++;
+	cl.statsf[stat] = (cl.stats[stat] = val);
+}
 #define CL_SetHudStat(stat, val) CL_SetStati (stat, val)
 
 /*
@@ -1591,6 +1642,68 @@ static void CL_ParsePrecache (void)
 		break;
 	}
 }
+
+/*
+=====================
+CL_ParseSignonChunk
+
+Collects the deflated prespawn data of PEXT2_COMPRESSEDSIGNON servers and parses it once complete.
+The buffers are kept around so a Host_Error halfway through the parse doesn't leak them.
+=====================
+*/
+#define MAX_SIGNON_SIZE (64 * 1024 * 1024)
+static void CL_ParseSignonChunk (void)
+{
+	static byte *deflated;
+	static int	 deflatedmax;
+	static byte *inflated;
+	static int	 inflatedmax;
+	int			 rawsize = MSG_ReadLong ();
+	int			 size = MSG_ReadLong ();
+	int			 ofs = MSG_ReadLong ();
+	int			 len = MSG_ReadLong ();
+	byte		*saved_data;
+	int			 saved_cursize, saved_maxsize, saved_readcount;
+	size_t		 inflatedsize;
+
+	if (msg_badread || len < 0 || len > net_message.cursize - msg_readcount || rawsize <= 0 || rawsize > MAX_SIGNON_SIZE || size <= 0 ||
+		size > MAX_SIGNON_SIZE || ofs < 0 || ofs > size - len)
+		Host_Error ("CL_ParseSignonChunk: bad chunk (%d bytes at %d of %d)", len, ofs, size);
+
+	if (size > deflatedmax)
+	{
+		deflatedmax = size;
+		deflated = (byte *)Mem_Realloc (deflated, deflatedmax);
+	}
+	memcpy (deflated + ofs, net_message.data + msg_readcount, len);
+	msg_readcount += len;
+	if (ofs + len < size)
+		return;
+
+	if (rawsize > inflatedmax)
+	{
+		inflatedmax = rawsize;
+		inflated = (byte *)Mem_Realloc (inflated, inflatedmax);
+	}
+	inflatedsize = tinfl_decompress_mem_to_mem (inflated, rawsize, deflated, size, 0);
+	if (inflatedsize != (size_t)rawsize)
+		Host_Error ("CL_ParseSignonChunk: corrupt signon data");
+
+	// parse it as if it had arrived in one huge message
+	saved_data = net_message.data;
+	saved_cursize = net_message.cursize;
+	saved_maxsize = net_message.maxsize;
+	saved_readcount = msg_readcount;
+	net_message.data = inflated;
+	net_message.cursize = rawsize;
+	net_message.maxsize = inflatedmax;
+	CL_ParseServerMessage ();
+	net_message.data = saved_data;
+	net_message.cursize = saved_cursize;
+	net_message.maxsize = saved_maxsize;
+	msg_readcount = saved_readcount;
+	msg_badread = false;
+}
 #ifdef PSET_SCRIPT
 int			CL_GenerateRandomParticlePrecache (const char *pname);
 // small function for simpler reuse
@@ -1689,6 +1802,8 @@ static void CL_ParseStatNumeric (int stat, int ival, float fval)
 		Con_DWarning ("svc_updatestat: %i is invalid\n", stat);
 		return;
 	}
+	if (cl.stats[stat] != ival || cl.statsf[stat] != fval)
+		cl_stats_generation++;
 	cl.stats[stat] = ival;
 	cl.statsf[stat] = fval;
 	if (stat == STAT_VIEWZOOM)
@@ -1757,6 +1872,7 @@ void CL_ParseServerMessage (void)
 					if (((uint32_t)cl.stats[STAT_ITEMS] & (1u << i)) && !((uint32_t)cl.items & (1u << i)))
 						cl.item_gettime[i] = cl.time;
 				cl.items = cl.stats[STAT_ITEMS];
+				cl_stats_generation++;
 			}
 			return; // end of message
 		}
@@ -1968,11 +2084,13 @@ void CL_ParseServerMessage (void)
 		case svc_killedmonster:
 			cl.stats[STAT_MONSTERS]++;
 			cl.statsf[STAT_MONSTERS] = cl.stats[STAT_MONSTERS];
+			cl_stats_generation++;
 			break;
 
 		case svc_foundsecret:
 			cl.stats[STAT_SECRETS]++;
 			cl.statsf[STAT_SECRETS] = cl.stats[STAT_SECRETS];
+			cl_stats_generation++;
 			break;
 
 		case svc_updatestat:
@@ -1996,6 +2114,7 @@ void CL_ParseServerMessage (void)
 		case svc_intermission:
 			cl.intermission = 1;
 			cl.completed_time = cl.time;
+			cl_stats_generation++;
 			vid.recalc_refdef = true; // go to full screen
 			V_RestoreAngles ();
 			break;
@@ -2003,6 +2122,7 @@ void CL_ParseServerMessage (void)
 		case svc_finale:
 			cl.intermission = 2;
 			cl.completed_time = cl.time;
+			cl_stats_generation++;
 			vid.recalc_refdef = true; // go to full screen
 			// johnfitz -- log centerprints to console
 			str = MSG_ReadString ();
@@ -2015,6 +2135,7 @@ void CL_ParseServerMessage (void)
 		case svc_cutscene:
 			cl.intermission = 3;
 			cl.completed_time = cl.time;
+			cl_stats_generation++;
 			vid.recalc_refdef = true; // go to full screen
 			// johnfitz -- log centerprints to console
 			str = MSG_ReadString ();
@@ -2131,6 +2252,12 @@ void CL_ParseServerMessage (void)
 			CLFTE_ParseEntitiesUpdate ();
 			break;
 
+		case svcvk_signonchunk:
+			if (!(cl.protocol_pext2 & PEXT2_COMPRESSEDSIGNON))
+				Host_Error ("Received svcvk_signonchunk but extension not active");
+			CL_ParseSignonChunk ();
+			break;
+
 		case svcfte_cgamepacket:
 			if (!(cl.protocol_pext1 & PEXT1_CSQC))
 				Host_Error ("Received svcfte_cgamepacket but extension not active");
@@ -23,9 +23,11 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "quakedef.h"
 
-int		 num_temp_entities;
-entity_t cl_temp_entities[MAX_TEMP_ENTITIES];
-beam_t	 cl_beams[MAX_BEAMS];
+int			   num_temp_entities;
+entity_t	   cl_temp_entities[MAX_TEMP_ENTITIES];
+beam_t		   cl_beams[MAX_BEAMS];
+int			   cl_num_beam_segments;
+beam_segment_t cl_beam_segments[MAX_BEAM_SEGMENTS];
 
 static sfx_t *cl_sfx_wizhit;
 static sfx_t *cl_sfx_knighthit;
@@ -341,6 +343,9 @@ entity_t *CL_NewTempEntity (void)
 /*
 =================
 CL_UpdateTEnts
+
+Lightning with an alias model is laid out in cl_beam_segments for R_DrawBeams
+instead of using up a temp entity and a visedict per segment
 =================
 */
 void CL_UpdateTEnts (void)
@@ -354,6 +359,7 @@ void CL_UpdateTEnts (void)
 	float	  forward;
 
 	num_temp_entities = 0;
+	cl_num_beam_segments = 0;
 
 	if (cl.paused)
 		COM_SeedRand ((uint64_t)(cl.time * 1000)); // johnfitz -- freeze beams when paused
@@ -398,14 +404,28 @@ void CL_UpdateTEnts (void)
 		d = VectorNormalize (dist);
 		while (d > 0)
 		{
-			ent = CL_NewTempEntity ();
-			if (!ent)
-				return;
-			VectorCopy (org, ent->origin);
-			ent->model = b->model;
-			ent->angles[0] = pitch;
-			ent->angles[1] = yaw;
-			ent->angles[2] = COM_Rand () % 360;
+			if (b->model->type == mod_alias)
+			{
+				if (cl_num_beam_segments == MAX_BEAM_SEGMENTS)
+					return;
+				beam_segment_t *segment = &cl_beam_segments[cl_num_beam_segments++];
+				VectorCopy (org, segment->origin);
+				segment->model = b->model;
+				segment->angles[0] = pitch;
+				segment->angles[1] = yaw;
+				segment->angles[2] = COM_Rand () % 360;
+			}
+			else
+			{
+				ent = CL_NewTempEntity ();
+				if (!ent)
+					return;
+				VectorCopy (org, ent->origin);
+				ent->model = b->model;
+				ent->angles[0] = pitch;
+				ent->angles[1] = yaw;
+				ent->angles[2] = COM_Rand () % 360;
+			}
 
 			// johnfitz -- use j instead of using i twice, so we don't corrupt memory
 			for (j = 0; j < 3; j++)
@@ -90,6 +90,14 @@ typedef struct
 #endif
 } beam_t;
 
+#define MAX_BEAM_SEGMENTS 4096
+typedef struct
+{
+	struct qmodel_s *model;
+	vec3_t			 origin;
+	vec3_t			 angles;
+} beam_segment_t;
+
 #define MAX_MAPSTRING 2048
 #define MAX_DEMOS	  8
 #define MAX_DEMONAME  16
@@ -137,6 +145,7 @@ typedef struct
 	int		 td_lastframe;	// to meter out one message a frame
 	int		 td_startframe; // host_framecount at start
 	float	 td_starttime;	// realtime at second frame of timedemo
+	qboolean td_parseonly;	// timedemo_parse, the screen isn't updated
 
 	// connection information
 	int				  signon; // 0 to SIGNONS
@@ -232,11 +241,12 @@ typedef struct
 
 	// refresh related state
 	struct qmodel_s *worldmodel; // cl_entitites[0].model
-	struct efrag_s	*free_efrags;
+	struct efrag_s	*efrags;	 // static entity fragments in the order they were added
 	int				 num_efrags;
-	struct efrag_s **efrag_allocs;
-	int				 num_efragallocs;
-	entity_t		 viewent; // the gun model
+	int				 max_efrags;
+	entity_t	   **efrag_entities; // efrags grouped by leaf
+	qboolean		 efrags_dirty;	 // efrag_entities needs R_SortEfrags
+	entity_t		 viewent;		 // the gun model
 
 	entity_t *entities; // spike -- moved into here
 	int		  max_edicts;
@@ -328,17 +338,23 @@ extern cvar_t cl_startdemos;
 
 extern client_state_t cl;
 
+// Bumped whenever the stats, items, intermission or server info change, so the UI can skip
+// decoding them on frames where nothing did. Lives outside cl so CL_ClearState doesn't reset it.
+extern unsigned int cl_stats_generation;
+
 // FIXME, allocate dynamically
-extern lightstyle_t cl_lightstyle[MAX_LIGHTSTYLES];
-extern dlight_t		cl_dlights[MAX_DLIGHTS];
-extern entity_t		cl_temp_entities[MAX_TEMP_ENTITIES];
-extern beam_t		cl_beams[MAX_BEAMS];
-extern entity_t	  **cl_visedicts;
-extern entity_t	  **cl_visedicts_alpha;
-extern int			cl_numvisedicts;
-extern int			cl_numvisedicts_alpha_overwater;
-extern int			cl_numvisedicts_alpha_underwater;
-extern int			cl_maxvisedicts; // extended if we exceeded it the previous frame
+extern lightstyle_t	  cl_lightstyle[MAX_LIGHTSTYLES];
+extern dlight_t		  cl_dlights[MAX_DLIGHTS];
+extern entity_t		  cl_temp_entities[MAX_TEMP_ENTITIES];
+extern beam_t		  cl_beams[MAX_BEAMS];
+extern beam_segment_t cl_beam_segments[MAX_BEAM_SEGMENTS];
+extern int			  cl_num_beam_segments;
+extern entity_t		**cl_visedicts;
+extern entity_t		**cl_visedicts_alpha;
+extern int			  cl_numvisedicts;
+extern int			  cl_numvisedicts_alpha_overwater;
+extern int			  cl_numvisedicts_alpha_underwater;
+extern int			  cl_maxvisedicts; // extended if we exceeded it the previous frame
 
 //=============================================================================
 
@@ -404,6 +420,11 @@ void CL_Stop_f (void);
 void CL_Record_f (void);
 void CL_PlayDemo_f (void);
 void CL_TimeDemo_f (void);
+void CL_TimeDemoReport_f (void);
+void CL_TimeDemoParse_f (void);
+void CL_Benchmark_f (void);
+void CL_BenchmarkFrame (void);
+void CL_TimeDemoFrame (double host_time, double render_time, double sound_time);
 void CL_Resume_Record (qboolean recordsignons);
 
 //
@@ -500,6 +500,16 @@ cmd_source_t cmd_source;
 cmd_function_t *cmd_functions; // possible commands to execute
 // johnfitz
 
+#define CMD_HASH_SIZE 512 // power of two
+
+// case-folded name index, the client/server/console variants of a name share a chain
+static cmd_function_t *cmd_hash[CMD_HASH_SIZE];
+
+static cmd_function_t **Cmd_HashBucket (const char *cmd_name)
+{
+	return &cmd_hash[COM_HashStringNoCase (cmd_name) & (CMD_HASH_SIZE - 1)];
+}
+
 /*
 ============
 Cmd_List_f -- johnfitz
@@ -716,8 +726,9 @@ spike -- added an extra arg for client (also renamed and made a macro)
 */
 cmd_function_t *Cmd_AddCommand2 (const char *cmd_name, xcommand_t function, cmd_source_t srctype)
 {
-	cmd_function_t *cmd;
-	cmd_function_t *cursor, *prev; // johnfitz -- sorted list insert
+	cmd_function_t	*cmd;
+	cmd_function_t	*cursor, *prev; // johnfitz -- sorted list insert
+	cmd_function_t **bucket;
 
 	// fail if the command is a variable name
 	if (Cvar_VariableString (cmd_name)[0])
@@ -727,7 +738,8 @@ cmd_function_t *Cmd_AddCommand2 (const char *cmd_name, xcommand_t function, cmd_
 	}
 
 	// fail if the command already exists
-	for (cmd = cmd_functions; cmd; cmd = cmd->next)
+	bucket = Cmd_HashBucket (cmd_name);
+	for (cmd = *bucket; cmd; cmd = cmd->hash_next)
 	{
 		if (!strcmp (cmd_name, cmd->name) && cmd->srctype == srctype)
 		{
@@ -772,6 +784,10 @@ cmd_function_t *Cmd_AddCommand2 (const char *cmd_name, xcommand_t function, cmd_
 	}
 	// johnfitz
 
+	// newest first, like equal names in the sorted list
+	cmd->hash_next = *bucket;
+	*bucket = cmd;
+
 	if (cmd->dynamic)
 		return cmd;
 	return NULL;
@@ -779,6 +795,14 @@ cmd_function_t *Cmd_AddCommand2 (const char *cmd_name, xcommand_t function, cmd_
 void Cmd_RemoveCommand (cmd_function_t *cmd)
 {
 	cmd_function_t **link;
+	for (link = Cmd_HashBucket (cmd->name); *link; link = &(*link)->hash_next)
+	{
+		if (*link == cmd)
+		{
+			*link = cmd->hash_next;
+			break;
+		}
+	}
 	for (link = &cmd_functions; *link; link = &(*link)->next)
 	{
 		if (*link == cmd)
@@ -800,7 +824,7 @@ qboolean Cmd_Exists (const char *cmd_name)
 {
 	cmd_function_t *cmd;
 
-	for (cmd = cmd_functions; cmd; cmd = cmd->next)
+	for (cmd = *Cmd_HashBucket (cmd_name); cmd; cmd = cmd->hash_next)
 	{
 		if (!strcmp (cmd_name, cmd->name))
 		{
@@ -841,7 +865,6 @@ const char *Cmd_CompleteCommand (const char *partial)
 Cmd_ExecuteString
 
 A complete command line has been parsed, so try to execute it
-FIXME: lookupnoadd the token to speed search?
 ============
 */
 qboolean Cmd_ExecuteString (const char *text, cmd_source_t src)
@@ -857,7 +880,7 @@ qboolean Cmd_ExecuteString (const char *text, cmd_source_t src)
 		return true; // no tokens
 
 	// check functions
-	for (cmd = cmd_functions; cmd; cmd = cmd->next)
+	for (cmd = *Cmd_HashBucket (cmd_argv[0]); cmd; cmd = cmd->hash_next)
 	{
 		if (!q_strcasecmp (cmd_argv[0], cmd->name))
 		{
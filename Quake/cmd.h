@@ -94,6 +94,7 @@ typedef struct cmd_function_s
 	xcommand_t			   function;
 	cmd_source_t		   srctype;
 	qboolean			   dynamic;
+	struct cmd_function_s *hash_next; // chain in the name hash, cmd_functions stays the sorted list
 } cmd_function_t;
 
 void Cmd_Init (void);
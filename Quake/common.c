@@ -27,6 +27,11 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "q_ctype.h"
 #include <errno.h>
+#ifndef _WIN32
+#include <dirent.h>
+#else
+#include <windows.h>
+#endif
 
 // Plug our allocators into miniz:
 #define MZ_MALLOC(x)	 Mem_Alloc (x)
@@ -71,7 +76,6 @@ qboolean standard_quake = true, rogue, hipnotic;
 
 extern const unsigned char vkquake_pak[];
 extern const int		   vkquake_pak_size;
-extern const int		   vkquake_pak_decompressed_size;
 
 /*
 
@@ -921,6 +925,29 @@ void MSG_WriteCoord (sizebuf_t *sb, float f, unsigned int flags)
 		MSG_WriteCoord16 (sb, f);
 }
 
+// vkquake -- PEXT2_VARINTDELTAS coords: wide fixed point coords are quantized and sent as a signed varint relative to the baseline,
+// power of two scales so that the baseline's own quantized value reproduces exactly on the client
+static int MSG_CoordDeltaScale (unsigned int flags)
+{
+	if (flags & PRFL_FLOATCOORD)
+		return 0;
+	else if (flags & PRFL_INT32COORD)
+		return 16;
+	else if (flags & PRFL_24BITCOORD)
+		return 256;
+	else
+		return 0; // 16bit coords are already smaller than a varint for most deltas
+}
+
+void MSG_WriteCoordDelta (sizebuf_t *sb, float f, float base, unsigned int flags)
+{
+	const int scale = MSG_CoordDeltaScale (flags);
+	if (scale)
+		MSG_WriteInt64 (sb, (long long)Q_rint (f * scale) - Q_rint (base * scale));
+	else
+		MSG_WriteCoord (sb, f, flags);
+}
+
 void MSG_WriteAngle (sizebuf_t *sb, float f, unsigned int flags)
 {
 	if (flags & PRFL_FLOATANGLE)
@@ -1044,9 +1071,9 @@ unsigned long long MSG_ReadUInt64 (void)
 		v -= l;
 		b++;
 	}
-	r = v << (b * 8);
+	r = (unsigned long long)v << (b * 8);
 	while (b-- > 0)
-		r |= MSG_ReadByte () << (b * 8);
+		r |= (unsigned long long)MSG_ReadByte () << (b * 8);
 	return r;
 }
 long long MSG_ReadInt64 (void)
@@ -1145,6 +1172,15 @@ float MSG_ReadCoord (unsigned int flags)
 		return MSG_ReadCoord16 ();
 }
 
+float MSG_ReadCoordDelta (float base, unsigned int flags)
+{
+	const int scale = MSG_CoordDeltaScale (flags);
+	if (scale)
+		return (Q_rint (base * scale) + MSG_ReadInt64 ()) / (float)scale;
+	else
+		return MSG_ReadCoord (flags);
+}
+
 float MSG_ReadAngle (unsigned int flags)
 {
 	if (flags & PRFL_FLOATANGLE)
@@ -1775,6 +1811,268 @@ THREAD_LOCAL int file_from_pak; // ZOID: global indicating that file came from a
 searchpath_t *com_searchpaths;
 searchpath_t *com_base_searchpaths;
 
+#define MAX_SCAN_DEPTH 16
+
+typedef struct
+{
+	searchpath_t *search;
+	int			  file;	 // index into search->pack->files or search->files
+	int			  order; // position of search in com_searchpaths
+	int			  next;	 // next entry with the same normalized name, -1 if none
+} fileindex_entry_t;
+
+// Merged index of every file in the search path, rebuilt when the game directories change
+static hash_map_t		 *com_fileindex; // normalized name -> first fileindex_entry_t
+static fileindex_entry_t *com_fileindex_entries;
+static int				  com_fileindex_numentries;
+static int				  com_fileindex_maxentries;
+
+/*
+============
+COM_NormalizePath
+
+Lower case with forward slashes, so names differing only in case share an index chain
+============
+*/
+static void COM_NormalizePath (const char *in, char *out, size_t outsize)
+{
+	size_t i;
+	for (i = 0; in[i] && i < outsize - 1; ++i)
+		out[i] = (in[i] == '\\') ? '/' : q_tolower (in[i]);
+	out[i] = 0;
+}
+
+/*
+============
+COM_AddLooseFile
+============
+*/
+static void COM_AddLooseFile (searchpath_t *search, const char *relname)
+{
+	if (search->numfiles == search->maxfiles)
+	{
+		search->maxfiles = q_max (search->maxfiles * 2, 64);
+		search->files = (char **)Mem_Realloc (search->files, search->maxfiles * sizeof (char *));
+	}
+	search->files[search->numfiles++] = q_strdup (relname);
+}
+
+/*
+============
+COM_ScanDirectory
+
+Recursively adds all files below search->filename/reldir to search->files
+============
+*/
+static void COM_ScanDirectory (searchpath_t *search, const char *reldir, int depth)
+{
+	char path[MAX_OSPATH];
+	char relname[MAX_OSPATH];
+
+#ifdef _WIN32
+	WIN32_FIND_DATA fdat;
+	HANDLE			fhnd;
+
+	q_snprintf (path, sizeof (path), "%s/%s*", search->filename, reldir);
+	fhnd = FindFirstFile (path, &fdat);
+	if (fhnd == INVALID_HANDLE_VALUE)
+		return;
+	do
+	{
+		if (!strcmp (fdat.cFileName, ".") || !strcmp (fdat.cFileName, ".."))
+			continue;
+		if (fdat.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+		{
+			if (depth < MAX_SCAN_DEPTH && q_snprintf (relname, sizeof (relname), "%s%s/", reldir, fdat.cFileName) < (int)sizeof (relname))
+				COM_ScanDirectory (search, relname, depth + 1);
+		}
+		else if (q_snprintf (relname, sizeof (relname), "%s%s", reldir, fdat.cFileName) < (int)sizeof (relname))
+			COM_AddLooseFile (search, relname);
+	} while (FindNextFile (fhnd, &fdat));
+	FindClose (fhnd);
+#else
+	DIR			  *dir_p;
+	struct dirent *dir_t;
+	int			   type;
+
+	q_snprintf (path, sizeof (path), "%s/%s", search->filename, reldir);
+	dir_p = opendir (path);
+	if (dir_p == NULL)
+		return;
+	while ((dir_t = readdir (dir_p)) != NULL)
+	{
+		if (!strcmp (dir_t->d_name, ".") || !strcmp (dir_t->d_name, ".."))
+			continue;
+		if (q_snprintf (relname, sizeof (relname), "%s%s", reldir, dir_t->d_name) >= (int)sizeof (relname) - 1)
+			continue;
+		q_snprintf (path, sizeof (path), "%s/%s", search->filename, relname);
+		type = Sys_FileType (path);
+		if (type & FS_ENT_FILE)
+			COM_AddLooseFile (search, relname);
+		else if ((type & FS_ENT_DIRECTORY) && depth < MAX_SCAN_DEPTH)
+		{
+			q_strlcat (relname, "/", sizeof (relname));
+			COM_ScanDirectory (search, relname, depth + 1);
+		}
+	}
+	closedir (dir_p);
+#endif
+}
+
+/*
+============
+COM_IndexFile
+============
+*/
+static void COM_IndexFile (searchpath_t *search, int file, int order, const char *name)
+{
+	char			   normalized[MAX_OSPATH];
+	char			  *key = normalized;
+	int				  *first, *link;
+	fileindex_entry_t *entry;
+
+	if (com_fileindex_numentries == com_fileindex_maxentries)
+	{
+		com_fileindex_maxentries = q_max (com_fileindex_maxentries * 2, 1024);
+		com_fileindex_entries = (fileindex_entry_t *)Mem_Realloc (com_fileindex_entries, com_fileindex_maxentries * sizeof (fileindex_entry_t));
+	}
+
+	entry = &com_fileindex_entries[com_fileindex_numentries];
+	entry->search = search;
+	entry->file = file;
+	entry->order = order;
+	entry->next = -1;
+
+	COM_NormalizePath (name, normalized, sizeof (normalized));
+	first = HashMap_Lookup (int, com_fileindex, &key);
+	if (!first)
+	{
+		key = q_strdup (normalized);
+		HashMap_Insert (com_fileindex, &key, &com_fileindex_numentries);
+	}
+	else
+	{
+		// keep chains sorted by search order so the first match wins like a path walk
+		for (link = first; *link != -1 && com_fileindex_entries[*link].order <= order; link = &com_fileindex_entries[*link].next)
+			;
+		entry->next = *link;
+		*link = com_fileindex_numentries;
+	}
+	++com_fileindex_numentries;
+}
+
+/*
+============
+COM_BuildFileIndex
+============
+*/
+static void COM_BuildFileIndex (void)
+{
+	searchpath_t *search;
+	int			  i, order, numfiles = 0;
+
+	if (com_fileindex)
+	{
+		for (i = 0; i < (int)HashMap_Size (com_fileindex); ++i)
+			Mem_Free (*HashMap_GetKey (char *, com_fileindex, i));
+		HashMap_Destroy (com_fileindex);
+	}
+	com_fileindex_numentries = 0;
+
+	for (search = com_searchpaths; search; search = search->next)
+		numfiles += search->pack ? search->pack->numfiles : search->numfiles;
+	com_fileindex = HashMap_Create (char *, int, &HashStr, &HashStrCmp);
+	HashMap_Reserve (com_fileindex, numfiles);
+
+	for (search = com_searchpaths, order = 0; search; search = search->next, ++order)
+	{
+		if (search->pack)
+			for (i = 0; i < search->pack->numfiles; ++i)
+				COM_IndexFile (search, i, order, search->pack->files[i].name);
+		else
+			for (i = 0; i < search->numfiles; ++i)
+				COM_IndexFile (search, i, order, search->files[i]);
+	}
+}
+
+/*
+============
+COM_LookupFileIndex
+
+Returns the first entry in search order that matches filename with the
+same rules a path walk would use: exact names in paks, file system rules
+for loose files
+============
+*/
+static const fileindex_entry_t *COM_LookupFileIndex (const char *filename, qboolean loose_only)
+{
+	char	 normalized[MAX_OSPATH];
+	char	*key = normalized;
+	int		*first, index;
+	qboolean skip_loose = !registered.value && (strchr (filename, '/') || strchr (filename, '\\'));
+
+	if (!com_fileindex)
+		return NULL;
+
+	COM_NormalizePath (filename, normalized, sizeof (normalized));
+	first = HashMap_Lookup (int, com_fileindex, &key);
+	if (!first)
+		return NULL;
+
+	for (index = *first; index != -1; index = com_fileindex_entries[index].next)
+	{
+		const fileindex_entry_t *entry = &com_fileindex_entries[index];
+		if (entry->search->pack)
+		{
+			if (!loose_only && !strcmp (entry->search->pack->files[entry->file].name, filename))
+				return entry;
+		}
+		else if (!skip_loose) /* if not a registered version, don't ever go beyond base */
+		{
+#ifdef _WIN32
+			return entry;
+#else
+			if (!strcmp (entry->search->files[entry->file], filename))
+				return entry;
+#endif
+		}
+	}
+	return NULL;
+}
+
+/*
+============
+COM_AddIndexedFile
+
+Makes a file that was just written below one of the game directories
+visible to COM_FindFile without rescanning the directory
+============
+*/
+void COM_AddIndexedFile (const char *path)
+{
+	searchpath_t *search;
+	const char	 *relname;
+	int			  i, order;
+	size_t		  len;
+
+	for (search = com_searchpaths, order = 0; search; search = search->next, ++order)
+	{
+		if (search->pack)
+			continue;
+		len = strlen (search->filename);
+		if (strncmp (path, search->filename, len) != 0 || path[len] != '/')
+			continue;
+		relname = path + len + 1;
+		for (i = 0; i < search->numfiles; ++i)
+			if (!strcmp (search->files[i], relname))
+				return;
+		COM_AddLooseFile (search, relname);
+		if (com_fileindex)
+			COM_IndexFile (search, search->numfiles - 1, order, relname);
+		return;
+	}
+}
+
 /*
 ============
 COM_Path_f
@@ -1822,6 +2120,7 @@ void COM_WriteFile (const char *filename, const void *data, int len)
 	Sys_Printf ("COM_WriteFile: %s\n", name);
 	Sys_FileWrite (handle, data, len);
 	Sys_FileClose (handle);
+	COM_AddIndexedFile (name);
 }
 
 /*
@@ -1854,6 +2153,57 @@ qfileofs_t COM_filelength (FILE *f)
 	return Sys_filelength (f);
 }
 
+static size_t COM_ZipRead (void *opaque, mz_uint64 ofs, void *buf, size_t n)
+{
+	const int handle = (int)(intptr_t)opaque;
+	Sys_FileSeek (handle, (int)ofs);
+	return Sys_FileRead (handle, buf, (int)n);
+}
+
+static size_t COM_ZipWrite (void *opaque, mz_uint64 ofs, const void *buf, size_t n)
+{
+	return fwrite (buf, 1, n, (FILE *)opaque);
+}
+
+/*
+===========
+COM_OpenZipFile
+
+Inflates a deflated zip entry into a memory handle or, for stdio users
+like music and demos, streams it into an anonymous temporary file
+===========
+*/
+static int COM_OpenZipFile (pack_t *pak, const packfile_t *pakfile, int *handle, FILE **file)
+{
+	com_filesize = pakfile->filelen;
+	if (handle)
+	{
+		byte *buf = (byte *)Mem_AllocNonZero (q_max (pakfile->filelen, 1));
+		if (!mz_zip_reader_extract_to_mem ((mz_zip_archive *)pak->zip, pakfile->zip_index, buf, pakfile->filelen, 0))
+		{
+			Con_Printf ("Couldn't inflate %s from %s\n", pakfile->name, pak->filename);
+			Mem_Free (buf);
+			*handle = -1;
+			com_filesize = -1;
+			return com_filesize;
+		}
+		Sys_MemFileOpenReadOwned (buf, pakfile->filelen, handle);
+	}
+	else if (file)
+	{
+		*file = tmpfile ();
+		if (*file && !mz_zip_reader_extract_to_callback ((mz_zip_archive *)pak->zip, pakfile->zip_index, COM_ZipWrite, *file, 0))
+		{
+			Con_Printf ("Couldn't inflate %s from %s\n", pakfile->name, pak->filename);
+			fclose (*file);
+			*file = NULL;
+		}
+		if (*file)
+			rewind (*file);
+	}
+	return com_filesize;
+}
+
 /*
 ===========
 COM_FindFile
@@ -1866,11 +2216,11 @@ can be used for detecting a file's presence.
 */
 static int COM_FindFile (const char *filename, int *handle, FILE **file, unsigned int *path_id)
 {
-	searchpath_t *search;
-	char		  netpath[MAX_OSPATH];
-	pack_t		 *pak;
-	int			  i;
-	qboolean	  is_config = !q_strcasecmp (filename, "config.cfg"), found = false;
+	const fileindex_entry_t *entry;
+	searchpath_t			*search;
+	char					 netpath[MAX_OSPATH];
+	pack_t					*pak;
+	int						 i;
 
 	if (file && handle)
 		Sys_Error ("COM_FindFile: both handle and file set");
@@ -1878,81 +2228,58 @@ static int COM_FindFile (const char *filename, int *handle, FILE **file, unsigne
 	file_from_pak = 0;
 
 	//
-	// search through the path, one element at a time
+	// look the file up in the merged index of the search path
 	//
-	for (search = com_searchpaths; search; search = search->next)
+	entry = COM_LookupFileIndex (filename, false);
+	if (!q_strcasecmp (filename, "config.cfg"))
 	{
-		if (search->pack) /* look through all the pak file elements */
+		const fileindex_entry_t *config = COM_LookupFileIndex (CONFIG_NAME, true);
+		if (config && (!entry || config->order <= entry->order))
+			entry = config;
+	}
+
+	if (entry)
+	{
+		search = entry->search;
+		if (path_id)
+			*path_id = search->path_id;
+		if (search->pack)
 		{
 			pak = search->pack;
-			for (i = 0; i < pak->numfiles; i++)
-			{
-				if (strcmp (pak->files[i].name, filename) != 0)
-					continue;
-				// found it!
-				com_filesize = pak->files[i].filelen;
-				file_from_pak = 1;
-				if (path_id)
-					*path_id = search->path_id;
-				if (handle)
-				{
-					*handle = pak->handle;
-					Sys_FileSeek (pak->handle, pak->files[i].filepos);
-					return com_filesize;
-				}
-				else if (file)
-				{ /* open a new file on the pakfile */
-					*file = fopen (pak->filename, "rb");
-					if (*file)
-						fseek (*file, pak->files[i].filepos, SEEK_SET);
-					return com_filesize;
-				}
-				else /* for COM_FileExists() */
-				{
-					return com_filesize;
-				}
-			}
-		}
-		else /* check a file in the directory tree */
-		{
-			if (!registered.value)
-			{ /* if not a registered version, don't ever go beyond base */
-				if (strchr (filename, '/') || strchr (filename, '\\'))
-					continue;
-			}
-
-			if (is_config)
-			{
-				q_snprintf (netpath, sizeof (netpath), "%s/" CONFIG_NAME, search->filename);
-				if (Sys_FileType (netpath) & FS_ENT_FILE)
-					found = true;
-			}
-
-			if (!found)
-			{
-				q_snprintf (netpath, sizeof (netpath), "%s/%s", search->filename, filename);
-				if (!(Sys_FileType (netpath) & FS_ENT_FILE))
-					continue;
-			}
-
-			if (path_id)
-				*path_id = search->path_id;
+			com_filesize = pak->files[entry->file].filelen;
+			file_from_pak = 1;
+			if (pak->files[entry->file].zip_index >= 0)
+				return COM_OpenZipFile (pak, &pak->files[entry->file], handle, file);
 			if (handle)
 			{
-				com_filesize = Sys_FileOpenRead (netpath, &i);
-				*handle = i;
-				return com_filesize;
+				*handle = pak->handle;
+				Sys_FileSeek (pak->handle, pak->files[entry->file].filepos);
 			}
 			else if (file)
-			{
-				*file = fopen (netpath, "rb");
-				com_filesize = (*file == NULL) ? -1 : COM_filelength (*file);
-				return com_filesize;
-			}
-			else
-			{
-				return 0; /* dummy valid value for COM_FileExists() */
+			{ /* open a new file on the pakfile */
+				*file = fopen (pak->filename, "rb");
+				if (*file)
+					fseek (*file, pak->files[entry->file].filepos, SEEK_SET);
 			}
+			return com_filesize;
+		}
+
+		q_snprintf (netpath, sizeof (netpath), "%s/%s", search->filename, search->files[entry->file]);
+		if (handle)
+		{
+			com_filesize = Sys_FileOpenRead (netpath, &i);
+			*handle = i;
+			return com_filesize;
+		}
+		else if (file)
+		{
+			*file = fopen (netpath, "rb");
+			com_filesize = (*file == NULL) ? -1 : COM_filelength (*file);
+			return com_filesize;
+		}
+		else
+		{
+			return 0; /* dummy valid value for COM_FileExists() */
 		}
 	}
 
@@ -2030,6 +2357,237 @@ void COM_CloseFile (int h)
 	Sys_FileClose (h);
 }
 
+#define PREFETCH_PAGE_SIZE 4096
+
+enum
+{
+	PREFETCH_PENDING,
+	PREFETCH_LOADING,
+	PREFETCH_DONE,
+	PREFETCH_CONSUMED,
+};
+
+typedef struct
+{
+	char			name[MAX_QPATH];
+	atomic_uint32_t state;
+	byte		   *buf; // NULL if the file is missing or is read through a view anyway
+	int				len;
+	unsigned int	path_id;
+	int				from_pak;
+} prefetch_entry_t;
+
+static prefetch_entry_t *com_prefetch;
+static int				 com_numprefetch;
+static int				 com_maxprefetch;
+static hash_map_t		*com_prefetch_map; // name -> index into com_prefetch while a prefetch is running
+static task_handle_t	 com_prefetch_task = INVALID_TASK_HANDLE;
+
+/*
+============
+COM_PrefetchRead
+
+Reads a file without touching the shared pak handles, so it can run on a worker
+============
+*/
+static byte *COM_PrefetchRead (prefetch_entry_t *prefetch)
+{
+	const fileindex_entry_t *entry = COM_LookupFileIndex (prefetch->name, false);
+	char					 netpath[MAX_OSPATH];
+	FILE					*f;
+	byte					*buf;
+
+	if (!entry)
+		return NULL;
+
+	prefetch->path_id = entry->search->path_id;
+	if (entry->search->pack)
+	{
+		const pack_t	 *pak = entry->search->pack;
+		const packfile_t *pakfile = &pak->files[entry->file];
+
+		prefetch->from_pak = 1;
+		prefetch->len = pakfile->filelen;
+		if (pak->memory && pakfile->zip_index < 0)
+		{
+			// loaded through a view later, just fault the pages in while the main thread is busy
+			volatile byte touch = 0;
+			if (pakfile->filepos >= 0 && pakfile->filelen <= pak->memory_size - pakfile->filepos)
+				for (int ofs = 0; ofs < pakfile->filelen; ofs += PREFETCH_PAGE_SIZE)
+					touch += pak->memory[pakfile->filepos + ofs];
+			return NULL;
+		}
+		if (pakfile->zip_index >= 0)
+		{
+			// only memory archives can be inflated concurrently
+			if (!pak->memory)
+				return NULL;
+			buf = (byte *)Mem_AllocNonZero (pakfile->filelen + 1);
+			if (!mz_zip_reader_extract_to_mem ((mz_zip_archive *)pak->zip, pakfile->zip_index, buf, pakfile->filelen, 0))
+			{
+				Mem_Free (buf);
+				return NULL;
+			}
+			buf[pakfile->filelen] = 0;
+			return buf;
+		}
+		f = fopen (pak->filename, "rb");
+		if (f)
+			fseek (f, pakfile->filepos, SEEK_SET);
+	}
+	else
+	{
+		q_snprintf (netpath, sizeof (netpath), "%s/%s", entry->search->filename, entry->search->files[entry->file]);
+		f = fopen (netpath, "rb");
+		if (f)
+			prefetch->len = (int)COM_filelength (f);
+	}
+
+	if (!f)
+		return NULL;
+	buf = (byte *)Mem_AllocNonZero (prefetch->len + 1);
+	if ((int)fread (buf, 1, prefetch->len, f) != prefetch->len)
+	{
+		Mem_Free (buf);
+		buf = NULL;
+	}
+	else
+		buf[prefetch->len] = 0;
+	fclose (f);
+	return buf;
+}
+
+/*
+============
+COM_PrefetchTask
+============
+*/
+static void COM_PrefetchTask (int index, void *unused)
+{
+	prefetch_entry_t *prefetch = &com_prefetch[index];
+	uint32_t		  expected = PREFETCH_PENDING;
+
+	if (!Atomic_CompareExchangeUInt32 (&prefetch->state, &expected, PREFETCH_LOADING))
+		return;
+	prefetch->buf = COM_PrefetchRead (prefetch);
+	Atomic_StoreUInt32 (&prefetch->state, PREFETCH_DONE);
+}
+
+/*
+============
+COM_PrefetchFile
+
+Queues a file for the next COM_StartPrefetch
+============
+*/
+void COM_PrefetchFile (const char *path)
+{
+	if (com_prefetch_map) // left over from an aborted load
+		COM_EndPrefetch ();
+	if (strlen (path) >= MAX_QPATH)
+		return;
+	if (com_numprefetch == com_maxprefetch)
+	{
+		com_maxprefetch = q_max (com_maxprefetch * 2, 256);
+		com_prefetch = (prefetch_entry_t *)Mem_Realloc (com_prefetch, com_maxprefetch * sizeof (prefetch_entry_t));
+	}
+	q_strlcpy (com_prefetch[com_numprefetch].name, path, MAX_QPATH);
+	++com_numprefetch;
+}
+
+/*
+============
+COM_StartPrefetch
+
+Reads all queued files on the task workers. COM_LoadFile then only waits for
+the file it asks for, and loads files no worker picked up yet itself.
+============
+*/
+void COM_StartPrefetch (void)
+{
+	if (com_prefetch_map || !com_numprefetch)
+		return;
+
+	com_prefetch_map = HashMap_Create (char *, int, &HashStr, &HashStrCmp);
+	HashMap_Reserve (com_prefetch_map, com_numprefetch);
+	for (int i = 0; i < com_numprefetch; ++i)
+	{
+		char *key = com_prefetch[i].name;
+		com_prefetch[i].state = PREFETCH_PENDING;
+		com_prefetch[i].buf = NULL;
+		com_prefetch[i].len = 0;
+		com_prefetch[i].from_pak = 0;
+		if (!HashMap_Lookup (int, com_prefetch_map, &key))
+			HashMap_Insert (com_prefetch_map, &key, &i);
+		else
+			com_prefetch[i].state = PREFETCH_CONSUMED;
+	}
+	com_prefetch_task = Task_AllocateAssignBackgroundIndexedFuncAndSubmit (COM_PrefetchTask, com_numprefetch, NULL, 0);
+}
+
+/*
+============
+COM_EndPrefetch
+
+Waits for the workers and frees whatever was prefetched but never loaded
+============
+*/
+void COM_EndPrefetch (void)
+{
+	if (com_prefetch_task != INVALID_TASK_HANDLE)
+	{
+		Task_Join (com_prefetch_task, TASK_TIMEOUT_INFINITE);
+		com_prefetch_task = INVALID_TASK_HANDLE;
+	}
+	if (com_prefetch_map)
+	{
+		HashMap_Destroy (com_prefetch_map);
+		com_prefetch_map = NULL;
+		for (int i = 0; i < com_numprefetch; ++i)
+			Mem_Free (com_prefetch[i].buf);
+	}
+	com_numprefetch = 0;
+}
+
+/*
+============
+COM_TakePrefetchedFile
+============
+*/
+static byte *COM_TakePrefetchedFile (const char *path, unsigned int *path_id)
+{
+	prefetch_entry_t *prefetch;
+	int				 *index;
+	uint32_t		  expected = PREFETCH_PENDING;
+	byte			 *buf;
+
+	if (!com_prefetch_map)
+		return NULL;
+	index = HashMap_Lookup (int, com_prefetch_map, &path);
+	if (!index)
+		return NULL;
+
+	// no worker got to it yet, the caller is faster loading it right away
+	prefetch = &com_prefetch[*index];
+	if (Atomic_CompareExchangeUInt32 (&prefetch->state, &expected, PREFETCH_CONSUMED))
+		return NULL;
+	while (Atomic_LoadUInt32 (&prefetch->state) == PREFETCH_LOADING)
+		SDL_Delay (0);
+	expected = PREFETCH_DONE;
+	if (!Atomic_CompareExchangeUInt32 (&prefetch->state, &expected, PREFETCH_CONSUMED))
+		return NULL;
+
+	buf = prefetch->buf;
+	prefetch->buf = NULL;
+	if (!buf)
+		return NULL;
+	com_filesize = prefetch->len;
+	file_from_pak = prefetch->from_pak;
+	if (path_id)
+		*path_id = prefetch->path_id;
+	return buf;
+}
+
 /*
 ============
 COM_LoadFile
@@ -2044,7 +2602,9 @@ byte *COM_LoadFile (const char *path, unsigned int *path_id)
 	byte *buf;
 	int	  len;
 
-	buf = NULL; // quiet compiler warning
+	buf = COM_TakePrefetchedFile (path, path_id);
+	if (buf)
+		return buf;
 
 	// look for it in the filesystem or pack files
 	len = COM_OpenFile (path, &h, path_id);
@@ -2064,17 +2624,60 @@ byte *COM_LoadFile (const char *path, unsigned int *path_id)
 	return buf;
 }
 
-byte *COM_LoadMallocFile_TextMode_OSPath (const char *path, long *len_out)
+/*
+============
+COM_LoadFileView
+
+Returns a pointer into the pak contents for files stored in mapped or
+embedded paks, skipping the allocation and the read. Falls back to
+COM_LoadFile for everything else.
+============
+*/
+const byte *COM_LoadFileView (const char *path, unsigned int *path_id)
+{
+	const fileindex_entry_t *entry = COM_LookupFileIndex (path, false);
+	const pack_t			*pak;
+	const packfile_t		*pakfile;
+
+	if (!entry || !entry->search->pack || !entry->search->pack->memory)
+		return COM_LoadFile (path, path_id);
+
+	pak = entry->search->pack;
+	pakfile = &pak->files[entry->file];
+	if (pakfile->zip_index >= 0 || pakfile->filepos < 0 || pakfile->filelen < 0 || pakfile->filelen > pak->memory_size - pakfile->filepos)
+		return COM_LoadFile (path, path_id);
+
+	com_filesize = pakfile->filelen;
+	file_from_pak = 1;
+	if (path_id)
+		*path_id = entry->search->path_id;
+	return pak->memory + pakfile->filepos;
+}
+
+/*
+============
+COM_FreeFileView
+============
+*/
+void COM_FreeFileView (const byte *buf)
+{
+	searchpath_t *search;
+
+	if (!buf)
+		return;
+	for (search = com_searchpaths; search; search = search->next)
+		if (search->pack && search->pack->memory && buf >= search->pack->memory && buf < search->pack->memory + search->pack->memory_size)
+			return;
+	Mem_Free (buf);
+}
+
+static byte *COM_LoadMallocFile_OSPathMode (const char *path, const char *mode, long *len_out)
 {
 	FILE *f;
 	byte *data;
 	long  len, actuallen;
 
-	// ericw -- this is used by Host_Loadgame_f. Translate CRLF to LF on load games,
-	// othewise multiline messages have a garbage character at the end of each line.
-	// TODO: could handle in a way that allows loading CRLF savegames on mac/linux
-	// without the junk characters appearing.
-	f = fopen (path, "rt");
+	f = fopen (path, mode);
 	if (f == NULL)
 		return NULL;
 
@@ -2108,6 +2711,20 @@ byte *COM_LoadMallocFile_TextMode_OSPath (const char *path, long *len_out)
 	return data;
 }
 
+byte *COM_LoadMallocFile_TextMode_OSPath (const char *path, long *len_out)
+{
+	// ericw -- this is used by Host_Loadgame_f. Translate CRLF to LF on load games,
+	// othewise multiline messages have a garbage character at the end of each line.
+	// TODO: could handle in a way that allows loading CRLF savegames on mac/linux
+	// without the junk characters appearing.
+	return COM_LoadMallocFile_OSPathMode (path, "rt", len_out);
+}
+
+byte *COM_LoadMallocFile_OSPath (const char *path, long *len_out)
+{
+	return COM_LoadMallocFile_OSPathMode (path, "rb", len_out);
+}
+
 const char *COM_ParseIntNewline (const char *buffer, int *value)
 {
 	int consumed = 0;
@@ -2226,6 +2843,7 @@ static pack_t *COM_LoadPackFile (const char *packfile, int packhandle)
 		q_strlcpy (newfiles[i].name, info[i].name, sizeof (newfiles[i].name));
 		newfiles[i].filepos = LittleLong (info[i].filepos);
 		newfiles[i].filelen = LittleLong (info[i].filelen);
+		newfiles[i].zip_index = -1;
 	}
 
 	pack = (pack_t *)Mem_Alloc (sizeof (pack_t));
@@ -2238,6 +2856,178 @@ static pack_t *COM_LoadPackFile (const char *packfile, int packhandle)
 	return pack;
 }
 
+/*
+=================
+COM_LoadZipFile
+
+Takes an explicit (not game tree related) path to a pk3 or zip file and
+indexes its central directory. Stored entries get a filepos past their
+local header and are read exactly like pak entries, deflated entries are
+inflated when opened.
+=================
+*/
+static pack_t *COM_LoadZipFile (const char *zipfile, int ziphandle, const byte *memory, int zipsize)
+{
+	mz_zip_archive			*zip;
+	mz_zip_archive_file_stat stat;
+	byte					 local_header[MZ_ZIP_LOCAL_DIR_HEADER_SIZE];
+	packfile_t				*newfiles;
+	int						 i, numentries, numzipfiles = 0;
+	qboolean				 valid;
+	pack_t					*pack;
+
+	// mapped archives are read straight from memory, which also makes concurrent extraction safe
+	zip = (mz_zip_archive *)Mem_Alloc (sizeof (mz_zip_archive));
+	if (memory)
+		valid = mz_zip_reader_init_mem (zip, memory, zipsize, 0);
+	else
+	{
+		zip->m_pRead = COM_ZipRead;
+		zip->m_pIO_opaque = (void *)(intptr_t)ziphandle;
+		valid = mz_zip_reader_init (zip, zipsize, 0);
+	}
+	if (!valid)
+	{
+		Sys_Printf ("WARNING: %s is not a valid zip file, ignored\n", zipfile);
+		Mem_Free (zip);
+		Sys_FileClose (ziphandle);
+		return NULL;
+	}
+
+	numentries = (int)mz_zip_reader_get_num_files (zip);
+	newfiles = (packfile_t *)Mem_Alloc (q_max (numentries, 1) * sizeof (packfile_t));
+	for (i = 0; i < numentries; i++)
+	{
+		if (!mz_zip_reader_file_stat (zip, i, &stat) || stat.m_is_directory || !stat.m_is_supported)
+			continue;
+		if (strlen (stat.m_filename) >= MAX_QPATH || stat.m_uncomp_size > INT_MAX || stat.m_local_header_ofs > INT_MAX)
+			continue;
+
+		packfile_t *file = &newfiles[numzipfiles];
+		q_strlcpy (file->name, stat.m_filename, sizeof (file->name));
+		file->filelen = (int)stat.m_uncomp_size;
+		file->filepos = -1;
+		file->zip_index = i;
+		if (stat.m_method == 0)
+		{
+			if (zip->m_pRead (zip->m_pIO_opaque, stat.m_local_header_ofs, local_header, sizeof (local_header)) != sizeof (local_header) ||
+				MZ_READ_LE32 (local_header) != MZ_ZIP_LOCAL_DIR_HEADER_SIG)
+				continue;
+			file->filepos = (int)stat.m_local_header_ofs + sizeof (local_header) + MZ_READ_LE16 (local_header + MZ_ZIP_LDH_FILENAME_LEN_OFS) +
+							MZ_READ_LE16 (local_header + MZ_ZIP_LDH_EXTRA_LEN_OFS);
+			file->zip_index = -1;
+		}
+		++numzipfiles;
+	}
+
+	if (!numzipfiles)
+	{
+		Sys_Printf ("WARNING: %s has no files, ignored\n", zipfile);
+		mz_zip_reader_end (zip);
+		Mem_Free (zip);
+		Mem_Free (newfiles);
+		Sys_FileClose (ziphandle);
+		return NULL;
+	}
+
+	com_modified = true; // not the original file
+
+	pack = (pack_t *)Mem_Alloc (sizeof (pack_t));
+	q_strlcpy (pack->filename, zipfile, sizeof (pack->filename));
+	pack->handle = ziphandle;
+	pack->numfiles = numzipfiles;
+	pack->files = newfiles;
+	pack->zip = zip;
+
+	return pack;
+}
+
+/*
+=================
+COM_OpenArchive
+
+Opens a pak or zip file through a memory handle on its mapping, unless
+mapping is disabled with -nopakmap or fails. Returns the handle or -1.
+=================
+*/
+static int COM_OpenArchive (const char *path, const byte **memory, int *memory_size)
+{
+	int		   handle;
+	qfileofs_t size;
+
+	*memory = !COM_CheckParm ("-nopakmap") ? Sys_FileMap (path, memory_size) : NULL;
+	if (*memory)
+	{
+		Sys_MemFileOpenRead (*memory, *memory_size, &handle);
+		return handle;
+	}
+
+	size = Sys_FileOpenRead (path, &handle);
+	*memory_size = (int)q_min (size, (qfileofs_t)INT_MAX);
+	return handle;
+}
+
+static int COM_CompareArchiveNames (const void *a, const void *b)
+{
+	return q_strcasecmp (*(const char **)a, *(const char **)b);
+}
+
+/*
+=================
+COM_AddZipFiles
+
+Adds the pk3 and zip files at the top of a game directory in alphabetical
+order, so later names override earlier ones and all of them override paks
+=================
+*/
+static void COM_AddZipFiles (searchpath_t *dirpath, unsigned int path_id, const char *dir)
+{
+	const char	**names;
+	const byte	 *memory;
+	char		  zipfile[MAX_OSPATH];
+	int			  i, numnames = 0, ziphandle, zipsize;
+	searchpath_t *search;
+	pack_t		 *pak;
+
+	if (!dirpath->numfiles)
+		return;
+
+	names = (const char **)Mem_Alloc (dirpath->numfiles * sizeof (const char *));
+	for (i = 0; i < dirpath->numfiles; i++)
+	{
+		const char *ext = COM_FileGetExtension (dirpath->files[i]);
+		if (!strchr (dirpath->files[i], '/') && (!q_strcasecmp (ext, "pk3") || !q_strcasecmp (ext, "zip")))
+			names[numnames++] = dirpath->files[i];
+	}
+	qsort (names, numnames, sizeof (const char *), COM_CompareArchiveNames);
+
+	for (i = 0; i < numnames; i++)
+	{
+		q_snprintf (zipfile, sizeof (zipfile), "%s/%s", dirpath->filename, names[i]);
+		ziphandle = COM_OpenArchive (zipfile, &memory, &zipsize);
+		if (ziphandle == -1)
+			continue;
+		pak = COM_LoadZipFile (zipfile, ziphandle, memory, zipsize);
+		if (!pak)
+		{
+			if (memory)
+				Sys_FileUnmap (memory, zipsize);
+			continue;
+		}
+		pak->memory = memory;
+		pak->memory_size = zipsize;
+		pak->mapped = (memory != NULL);
+		search = (searchpath_t *)Mem_Alloc (sizeof (searchpath_t));
+		search->path_id = path_id;
+		search->pack = pak;
+		q_strlcpy (search->dir, dir, sizeof (search->dir));
+		search->next = com_searchpaths;
+		com_searchpaths = search;
+	}
+
+	Mem_Free (names);
+}
+
 const char *COM_GetGameNames (qboolean full)
 {
 	if (full)
@@ -2303,8 +3093,10 @@ static void COM_AddGameDirectory (const char *dir)
 	searchpath_t *search;
 	pack_t		 *pak;
 	char		  pakfile[MAX_OSPATH];
+	searchpath_t *dirpath;
 	qboolean	  been_here = false;
-	static byte	 *vkquake_pak_extracted;
+	const byte	 *memory;
+	int			  memory_size;
 
 	if (*com_gamenames)
 		q_strlcat (com_gamenames, ";", sizeof (com_gamenames));
@@ -2339,16 +3131,24 @@ _add_path:
 	q_strlcpy (search->dir, dir, sizeof (search->dir));
 	search->next = com_searchpaths;
 	com_searchpaths = search;
+	COM_ScanDirectory (search, "", 0);
+	dirpath = search;
 
 	// add any pak files in the format pak0.pak pak1.pak, ...
 	for (i = 0;; i++)
 	{
 		q_snprintf (pakfile, sizeof (pakfile), "%s/pak%i.pak", com_gamedir, i);
-		if (Sys_FileOpenRead (pakfile, &packhandle) == -1)
+		packhandle = COM_OpenArchive (pakfile, &memory, &memory_size);
+		if (packhandle == -1)
 			break;
 		pak = COM_LoadPackFile (pakfile, packhandle);
+		if (!pak && memory)
+			Sys_FileUnmap (memory, memory_size);
 		if (pak)
 		{
+			pak->memory = memory;
+			pak->memory_size = memory_size;
+			pak->mapped = (memory != NULL);
 			search = (searchpath_t *)Mem_Alloc (sizeof (searchpath_t));
 			search->path_id = path_id;
 			search->pack = pak;
@@ -2359,23 +3159,14 @@ _add_path:
 
 		if ((i == 0) && (path_id == 1) && !fitzmode)
 		{
-			size_t vkquake_pak_size_compressed = vkquake_pak_size, vkquake_pak_size_extracted = vkquake_pak_decompressed_size;
-			if (!vkquake_pak_extracted)
-			{
-				tinfl_decompressor inflator;
-				tinfl_init (&inflator);
-				vkquake_pak_extracted = Mem_Alloc (vkquake_pak_size_extracted);
-
-				tinfl_status decomp_status = tinfl_decompress (
-					&inflator, vkquake_pak, &vkquake_pak_size_compressed, vkquake_pak_extracted, vkquake_pak_extracted, &vkquake_pak_size_extracted,
-					TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF);
-
-				if (TINFL_STATUS_DONE != decomp_status)
-					Sys_Error ("Error extracting embedded pack");
-			}
+			// a zip in the executable, its entries are only inflated when they are opened
 			qboolean pak0_modified = com_modified;
-			Sys_MemFileOpenRead (vkquake_pak_extracted, vkquake_pak_size_extracted, &packhandle);
-			pak = COM_LoadPackFile ("vkquake.pak", packhandle);
+			Sys_MemFileOpenRead (vkquake_pak, vkquake_pak_size, &packhandle);
+			pak = COM_LoadZipFile ("vkquake.pak", packhandle, vkquake_pak, vkquake_pak_size);
+			if (!pak)
+				Sys_Error ("Error loading embedded pack");
+			pak->memory = vkquake_pak;
+			pak->memory_size = vkquake_pak_size;
 			search = (searchpath_t *)Mem_Alloc (sizeof (searchpath_t));
 			search->path_id = path_id;
 			search->pack = pak;
@@ -2389,6 +3180,8 @@ _add_path:
 			break;
 	}
 
+	COM_AddZipFiles (dirpath, path_id, dir);
+
 	if (!been_here && host_parms->userdir != host_parms->basedir)
 	{
 		been_here = true;
@@ -2396,6 +3189,8 @@ _add_path:
 		Sys_mkdir (com_gamedir);
 		goto _add_path;
 	}
+
+	COM_BuildFileIndex ();
 }
 
 void COM_ResetGameDirectories (const char *newdirs)
@@ -2403,15 +3198,28 @@ void COM_ResetGameDirectories (const char *newdirs)
 	char		 *newgamedirs = q_strdup (newdirs);
 	char		 *newpath, *path;
 	searchpath_t *search;
+
+	// workers must not read from search paths that are about to be freed
+	COM_EndPrefetch ();
 	// Kill the extra game if it is loaded
 	while (com_searchpaths != com_base_searchpaths)
 	{
 		if (com_searchpaths->pack)
 		{
 			Sys_FileClose (com_searchpaths->pack->handle);
+			if (com_searchpaths->pack->zip)
+			{
+				mz_zip_reader_end ((mz_zip_archive *)com_searchpaths->pack->zip);
+				Mem_Free (com_searchpaths->pack->zip);
+			}
+			if (com_searchpaths->pack->mapped)
+				Sys_FileUnmap (com_searchpaths->pack->memory, com_searchpaths->pack->memory_size);
 			Mem_Free (com_searchpaths->pack->files);
 			Mem_Free (com_searchpaths->pack);
 		}
+		for (int i = 0; i < com_searchpaths->numfiles; ++i)
+			Mem_Free (com_searchpaths->files[i]);
+		Mem_Free (com_searchpaths->files);
 		search = com_searchpaths->next;
 		Mem_Free (com_searchpaths);
 		com_searchpaths = search;
@@ -2423,6 +3231,7 @@ void COM_ResetGameDirectories (const char *newdirs)
 	*com_gamenames = 0;
 	// reset this too
 	q_strlcpy (com_gamedir, va ("%s/%s", (host_parms->userdir != host_parms->basedir) ? host_parms->userdir : com_basedir, GAMENAME), sizeof (com_gamedir));
+	COM_BuildFileIndex ();
 
 	for (newpath = newgamedirs; newpath && *newpath;)
 	{
@@ -2873,8 +3682,9 @@ void COM_Effectinfo_Enumerate (int (*cb) (const char *pname))
 */
 typedef struct
 {
-	char *key;
-	char *value;
+	char	*key;
+	char	*value;
+	unsigned hash; // COM_HashString (key), compared before the keys themselves when probing
 } locentry_t;
 
 typedef struct
@@ -2906,6 +3716,24 @@ unsigned COM_HashString (const char *str)
 	return hash;
 }
 
+/*
+================
+COM_HashStringNoCase
+
+FNV-1a hash of str with ASCII letters folded to lower case
+================
+*/
+unsigned COM_HashStringNoCase (const char *str)
+{
+	unsigned hash = 0x811c9dc5u;
+	while (*str)
+	{
+		hash ^= q_tolower (*str++);
+		hash *= 0x01000193u;
+	}
+	return hash;
+}
+
 static size_t mz_zip_file_read_func (void *opaque, mz_uint64 ofs, void *buf, size_t n)
 {
 #ifdef USE_SDL3
@@ -3195,7 +4023,10 @@ void LOC_LoadFile (const char *file)
 	for (i = 0; i < localization.numentries; i++)
 	{
 		locentry_t *entry = &localization.entries[i];
-		unsigned	pos = COM_HashString (entry->key) % localization.numindices, end = pos;
+		unsigned	pos, end;
+
+		entry->hash = COM_HashString (entry->key);
+		pos = end = entry->hash % localization.numindices;
 
 		for (;;)
 		{
@@ -3248,13 +4079,14 @@ Returns localized string if available, or NULL otherwise
 */
 const char *LOC_GetRawString (const char *key)
 {
-	unsigned pos, end;
+	unsigned hash, pos, end;
 
 	if (!localization.numindices || !key || !*key || *key != '$')
 		return NULL;
 	key++;
 
-	pos = COM_HashString (key) % localization.numindices;
+	hash = COM_HashString (key);
+	pos = hash % localization.numindices;
 	end = pos;
 
 	do
@@ -3265,7 +4097,7 @@ const char *LOC_GetRawString (const char *key)
 			return NULL;
 
 		entry = &localization.entries[idx - 1];
-		if (!strcmp (entry->key, key))
+		if (entry->hash == hash && !strcmp (entry->key, key))
 			return entry->value;
 
 		++pos;
@@ -200,6 +200,7 @@ void MSG_WriteDouble (sizebuf_t *sb, double f);
 void MSG_WriteStringUnterminated (sizebuf_t *sb, const char *s);
 void MSG_WriteString (sizebuf_t *sb, const char *s);
 void MSG_WriteCoord (sizebuf_t *sb, float f, unsigned int flags);
+void MSG_WriteCoordDelta (sizebuf_t *sb, float f, float base, unsigned int flags);
 void MSG_WriteAngle (sizebuf_t *sb, float f, unsigned int flags);
 void MSG_WriteAngle16 (sizebuf_t *sb, float f, unsigned int flags);			  // johnfitz
 void MSG_WriteEntity (sizebuf_t *sb, unsigned int index, unsigned int pext2); // spike
@@ -223,6 +224,7 @@ float			   MSG_ReadDouble (void);
 const char		  *MSG_ReadString (void);
 
 float		 MSG_ReadCoord (unsigned int flags);
+float		 MSG_ReadCoordDelta (float base, unsigned int flags);
 float		 MSG_ReadAngle (unsigned int flags);
 float		 MSG_ReadAngle16 (unsigned int flags); // johnfitz
 byte		*MSG_ReadData (unsigned int length);   // spike
@@ -318,6 +320,7 @@ char *va (const char *format, ...) FUNC_PRINTF (1, 2);
 // does a varargs printf into a temp buffer
 
 unsigned COM_HashString (const char *str);
+unsigned COM_HashStringNoCase (const char *str);
 
 // localization support for 2021 rerelease version:
 void		LOC_Init (void);
@@ -340,6 +343,7 @@ typedef struct
 {
 	char name[MAX_QPATH];
 	int	 filepos, filelen;
+	int	 zip_index; // central directory index of deflated zip entries, -1 if stored at filepos
 } packfile_t;
 
 typedef struct pack_s
@@ -348,6 +352,10 @@ typedef struct pack_s
 	int			handle;
 	int			numfiles;
 	packfile_t *files;
+	const byte *memory; // whole pak when mapped or embedded, NULL if only read through handle
+	int			memory_size;
+	qboolean	mapped;
+	void	   *zip; // mz_zip_archive for pk3 and zip files, NULL for paks
 } pack_t;
 
 typedef struct searchpath_s
@@ -358,6 +366,9 @@ typedef struct searchpath_s
 	char				 filename[MAX_OSPATH];
 	pack_t				*pack;			 // only one of filename / pack will be used
 	char				 dir[MAX_QPATH]; // directory name: "id1", "rogue", etc.
+	char			   **files;			 // loose files below filename, enumerated once
+	int					 numfiles;
+	int					 maxfiles;
 	struct searchpath_s *next;
 } searchpath_t;
 
@@ -380,14 +391,28 @@ int		 COM_OpenFile (const char *filename, int *handle, unsigned int *path_id);
 int		 COM_FOpenFile (const char *filename, FILE **file, unsigned int *path_id);
 qboolean COM_FileExists (const char *filename, unsigned int *path_id);
 void	 COM_CloseFile (int h);
+void	 COM_AddIndexedFile (const char *path);
 
 byte *COM_LoadFile (const char *path, unsigned int *path_id);
 
+// Like COM_LoadFile, but points straight into the pak when it's memory resident.
+// The view is read-only, has no trailing 0 and must be released with COM_FreeFileView.
+const byte *COM_LoadFileView (const char *path, unsigned int *path_id);
+void		COM_FreeFileView (const byte *buf);
+
+// Background reads for a known list of files, e.g. the precache lists of a new map.
+void COM_PrefetchFile (const char *path);
+void COM_StartPrefetch (void);
+void COM_EndPrefetch (void);
+
 // Opens the given path directly, ignoring search paths.
 // Returns NULL on failure, or else a '\0'-terminated malloc'ed buffer.
 // Loads in "t" mode so CRLF to LF translation is performed on Windows.
 byte *COM_LoadMallocFile_TextMode_OSPath (const char *path, long *len_out);
 
+// Same as above, but loads in "b" mode for binary files.
+byte *COM_LoadMallocFile_OSPath (const char *path, long *len_out);
+
 // Attempts to parse an int, followed by a newline.
 // Returns advanced buffer position.
 // Doesn't signal parsing failure, but this is not needed for savegame loading.
@@ -73,6 +73,27 @@ qboolean con_initialized;
 
 SDL_Mutex *con_mutex;
 
+// Task workers don't touch the console buffer, their messages are queued and printed by the main thread once per frame
+static char		 *con_queued; // NUL terminated messages
+static char		 *con_draining;
+static SDL_Mutex *con_queue_mutex;
+
+// Only line con_current is still written to by Con_Print, so the glyph quads of all lines above it are built
+// once and reused until the line scrolls out of the buffer or the buffer is cleared or resized
+#define CON_CACHE_LINES 512 // power of two, more than the visible rows
+
+typedef struct
+{
+	int			   line;	   // absolute line number, slot is line & (CON_CACHE_LINES - 1)
+	int			   generation; // con_generation the quads were built in
+	int			   num_quads;
+	int			   max_quads;
+	basicvertex_t *quads;
+} con_linecache_t;
+
+static con_linecache_t con_linecache[CON_CACHE_LINES];
+static int			   con_generation = 1; // bumped whenever lines already drawn can change
+
 /*
 ================
 Con_Quakebar -- johnfitz -- returns a bar of the desired length, but never wider than the console
@@ -150,6 +171,7 @@ static void Con_Clear_f (void)
 	if (con_text)
 		memset (con_text, ' ', con_buffersize); // johnfitz -- con_buffersize replaces CON_TEXTSIZE
 	con_backscroll = 0;							// johnfitz -- if console is empty, being scrolled up is confusing
+	++con_generation;
 }
 
 /*
@@ -298,6 +320,7 @@ void Con_CheckResize (void)
 
 	con_backscroll = 0;
 	con_current = con_totallines - 1;
+	++con_generation;
 
 	SDL_UnlockMutex (con_mutex);
 }
@@ -312,6 +335,7 @@ void Con_Init (void)
 	int i;
 
 	con_mutex = SDL_CreateMutex ();
+	con_queue_mutex = SDL_CreateMutex ();
 
 	// johnfitz -- user settable console buffer size
 	i = COM_CheckParm ("-consize");
@@ -462,8 +486,17 @@ static void Con_Print (const char *txt)
 
 // borrowed from uhexen2 by S.A. for new procs, LOG_Init, LOG_Close
 
-static char logfilename[MAX_OSPATH]; // current logfile name
-static int	log_fd = -1;			 // log file descriptor
+// the log file is written by its own thread, Con_DebugLog only appends to log_pending
+#define LOG_FLUSH_SIZE		  (16 * 1024)
+#define LOG_FLUSH_INTERVAL_MS 250
+
+static char			  logfilename[MAX_OSPATH]; // current logfile name
+static int			  log_fd = -1;			   // log file descriptor
+static char			 *log_pending;			   // guarded by log_mutex
+static char			 *log_writing;			   // guarded by log_write_mutex
+static SDL_Mutex	 *log_mutex;
+static SDL_Mutex	 *log_write_mutex;
+static SDL_Condition *log_condition;
 
 /*
 ================
@@ -475,28 +508,69 @@ void Con_DebugLog (const char *msg)
 	if (log_fd == -1)
 		return;
 
-	size_t msg_len = strlen (msg);
-	if (write (log_fd, msg, msg_len) != msg_len)
-		return; // Nonsense to supress warning
+	SDL_LockMutex (log_mutex);
+	Vec_Append ((void **)&log_pending, 1, msg, strlen (msg));
+	if (VEC_SIZE (log_pending) >= LOG_FLUSH_SIZE)
+		SDL_BroadcastCondition (log_condition);
+	SDL_UnlockMutex (log_mutex);
 }
 
 /*
 ================
-Con_Printf
+LOG_Flush
 
-Handles cursor positioning, line wrapping, etc
+Writes everything logged so far, can be called from any thread
 ================
 */
-#define MAXPRINTMSG 4096
-void Con_Printf (const char *fmt, ...)
+void LOG_Flush (void)
 {
-	va_list			argptr;
-	char			msg[MAXPRINTMSG];
-	static qboolean inupdate;
+	if (!log_write_mutex)
+		return;
 
-	va_start (argptr, fmt);
-	q_vsnprintf (msg, sizeof (msg), fmt, argptr);
-	va_end (argptr);
+	SDL_LockMutex (log_write_mutex);
+	SDL_LockMutex (log_mutex);
+	char *swap = log_writing;
+	log_writing = log_pending;
+	log_pending = swap;
+	SDL_UnlockMutex (log_mutex);
+
+	const size_t len = VEC_SIZE (log_writing);
+	if (log_fd != -1 && len && write (log_fd, log_writing, len) != len)
+		fputs ("Error: Unable to write log file\n", stderr);
+	VEC_CLEAR (log_writing);
+	SDL_UnlockMutex (log_write_mutex);
+}
+
+/*
+================
+LOG_Thread
+================
+*/
+static int LOG_Thread (void *data)
+{
+	SDL_SetCurrentThreadPriority (SDL_THREAD_PRIORITY_LOW);
+
+	SDL_LockMutex (log_mutex);
+	while (log_fd != -1)
+	{
+		if (VEC_SIZE (log_pending) < LOG_FLUSH_SIZE)
+			SDL_WaitConditionTimeout (log_condition, log_mutex, LOG_FLUSH_INTERVAL_MS);
+		SDL_UnlockMutex (log_mutex);
+		LOG_Flush ();
+		SDL_LockMutex (log_mutex);
+	}
+	SDL_UnlockMutex (log_mutex);
+	return 0;
+}
+
+/*
+================
+Con_PrintMessage
+================
+*/
+static void Con_PrintMessage (const char *msg)
+{
+	static qboolean inupdate;
 
 	if (con_redirect_flush)
 		q_strlcat (con_redirect_buffer, msg, sizeof (con_redirect_buffer));
@@ -521,14 +595,14 @@ void Con_Printf (const char *fmt, ...)
 	if (cls.signon == SIGNONS)
 	{
 		// Profiling lines can self-invalidate the HUD every second, skewing ui_speeds.
-		const qboolean is_ui_profile_line = !strncmp (msg, "ui(avg1s)", 9) || !strncmp (msg, "ui(update avg1s)", 16) || !strncmp (msg, "ui ", 3);
+		const qboolean is_ui_profile_line = !strncmp (msg, "ui(", 3) || !strncmp (msg, "ui ", 3);
 		if (!is_ui_profile_line)
 			UI_NotifyPrint (msg);
 	}
 #endif
 
 	// update the screen if the console is displayed
-	if (cls.signon != SIGNONS && !scr_disabled_for_loading && !Tasks_IsWorker ())
+	if (cls.signon != SIGNONS && !scr_disabled_for_loading && !SCR_IsLoading () && !Tasks_IsWorker ())
 	{
 		// protect against infinite loop if something in SCR_UpdateScreen calls
 		// Con_Printd
@@ -541,6 +615,83 @@ void Con_Printf (const char *fmt, ...)
 	}
 }
 
+/*
+================
+Con_QueuePrint
+================
+*/
+static void Con_QueuePrint (const char *msg)
+{
+	SDL_LockMutex (con_queue_mutex);
+	Vec_Append ((void **)&con_queued, 1, msg, strlen (msg) + 1);
+	SDL_UnlockMutex (con_queue_mutex);
+}
+
+/*
+================
+Con_FlushQueued
+
+Prints the messages of the task workers, called by the main thread
+================
+*/
+void Con_FlushQueued (void)
+{
+	static qboolean draining;
+
+	if (!con_initialized || Tasks_IsWorker () || draining)
+		return;
+
+	SDL_LockMutex (con_queue_mutex);
+	char *swap = con_draining;
+	con_draining = con_queued;
+	con_queued = swap;
+	SDL_UnlockMutex (con_queue_mutex);
+
+	const size_t size = VEC_SIZE (con_draining);
+	if (!size)
+		return;
+
+	// one batch, with the screen update of the printing skipped like Con_SafePrintf does
+	SDL_LockMutex (con_mutex);
+	const int temp = scr_disabled_for_loading;
+	scr_disabled_for_loading = true;
+	draining = true;
+	for (size_t i = 0; i < size; i += strlen (&con_draining[i]) + 1)
+		Con_PrintMessage (&con_draining[i]);
+	draining = false;
+	scr_disabled_for_loading = temp;
+	SDL_UnlockMutex (con_mutex);
+	VEC_CLEAR (con_draining);
+}
+
+/*
+================
+Con_Printf
+
+Handles cursor positioning, line wrapping, etc
+================
+*/
+#define MAXPRINTMSG 4096
+void Con_Printf (const char *fmt, ...)
+{
+	va_list argptr;
+	char	msg[MAXPRINTMSG];
+
+	va_start (argptr, fmt);
+	q_vsnprintf (msg, sizeof (msg), fmt, argptr);
+	va_end (argptr);
+
+	if (con_initialized && Tasks_IsWorker ())
+	{
+		Con_QueuePrint (msg);
+		return;
+	}
+
+	// keep the order of what workers printed before
+	Con_FlushQueued ();
+	Con_PrintMessage (msg);
+}
+
 /*
 ================
 Con_DWarning -- ericw
@@ -646,6 +797,12 @@ void Con_SafePrintf (const char *fmt, ...)
 	q_vsnprintf (msg, sizeof (msg), fmt, argptr);
 	va_end (argptr);
 
+	if (con_initialized && Tasks_IsWorker ())
+	{
+		Con_QueuePrint (msg);
+		return;
+	}
+
 	SDL_LockMutex (con_mutex);
 	temp = scr_disabled_for_loading;
 	scr_disabled_for_loading = true;
@@ -848,7 +1005,8 @@ typedef struct arg_completion_type_s
 
 static const arg_completion_type_t arg_completion_types[] = {{"map ", &extralevels}, {"changelevel ", &extralevels}, {"game ", &modlist},
 															 {"record ", &demolist}, {"playdemo ", &demolist},		 {"timedemo ", &demolist},
-															 {"save ", &savelist},	 {"load ", &savelist},			 {"fastload ", &savelist}};
+															 {"timedemo_report ", &demolist}, {"save ", &savelist},	 {"load ", &savelist},
+															 {"fastload ", &savelist}};
 
 static const int num_arg_completion_types = countof (arg_completion_types);
 
@@ -1089,6 +1247,37 @@ DRAWING
 ==============================================================================
 */
 
+/*
+================
+Con_DrawLine
+================
+*/
+static void Con_DrawLine (cb_context_t *cbx, int line, int y)
+{
+	const char *text = con_text + (line % con_totallines) * con_linewidth;
+
+	if (line >= con_current)
+	{
+		for (int x = 0; x < con_linewidth; x++)
+			Draw_Character (cbx, (x + 1) << 3, y, text[x]);
+		return;
+	}
+
+	con_linecache_t *cache = &con_linecache[line & (CON_CACHE_LINES - 1)];
+	if ((cache->line != line) || (cache->generation != con_generation))
+	{
+		if (cache->max_quads < con_linewidth)
+		{
+			cache->quads = (basicvertex_t *)Mem_Realloc (cache->quads, con_linewidth * 6 * sizeof (basicvertex_t));
+			cache->max_quads = con_linewidth;
+		}
+		cache->num_quads = Draw_StringQuads (8, text, con_linewidth, cache->quads);
+		cache->line = line;
+		cache->generation = con_generation;
+	}
+	Draw_CachedQuads (cbx, y, cache->quads, cache->num_quads);
+}
+
 /*
 ================
 Con_DrawNotify
@@ -1098,9 +1287,8 @@ Draws the last few lines of output transparently over the game top
 */
 void Con_DrawNotify (cb_context_t *cbx)
 {
-	int			i, x, v;
-	const char *text;
-	float		time;
+	int	  i, v;
+	float time;
 
 	GL_SetCanvas (cbx, CANVAS_CONSOLE); // johnfitz
 	v = vid.conheight;					// johnfitz
@@ -1115,17 +1303,16 @@ void Con_DrawNotify (cb_context_t *cbx)
 		time = realtime - time;
 		if (time > con_notifytime.value / (scr_viewsize.value >= 130 ? 4 : 1))
 			continue;
-		text = con_text + (i % con_totallines) * con_linewidth;
-
-		for (x = 0; x < con_linewidth; x++)
-			Draw_Character (cbx, (x + 1) << 3, v, text[x]);
-
+		Con_DrawLine (cbx, i, v);
 		v += 8;
 	}
 
 #ifndef USE_RMLUI
 	if (key_dest == key_message)
 	{
+		int			x;
+		const char *text;
+
 		if (chat_team)
 		{
 			Draw_String (cbx, 8, v, "say_team:");
@@ -1199,9 +1386,8 @@ The typing input line at the bottom should only be drawn if typing is allowed
 */
 void Con_DrawConsole (cb_context_t *cbx, int lines, qboolean drawinput)
 {
-	int			i, x, y, j, sb, rows;
-	const char *text;
-	char		ver[32];
+	int	 i, x, y, j, sb, rows;
+	char ver[32];
 
 	if (lines <= 0)
 		return;
@@ -1223,10 +1409,7 @@ void Con_DrawConsole (cb_context_t *cbx, int lines, qboolean drawinput)
 		j = i - con_backscroll;
 		if (j < 0)
 			j = 0;
-		text = con_text + (j % con_totallines) * con_linewidth;
-
-		for (x = 0; x < con_linewidth; x++)
-			Draw_Character (cbx, (x + 1) << 3, y, text[x]);
+		Con_DrawLine (cbx, j, y);
 	}
 
 	// draw scrollback arrows
@@ -1308,6 +1491,11 @@ void LOG_Init (quakeparms_t *parms)
 		return;
 	}
 
+	log_mutex = SDL_CreateMutex ();
+	log_write_mutex = SDL_CreateMutex ();
+	log_condition = SDL_CreateCondition ();
+	SDL_DetachThread (SDL_CreateThread (LOG_Thread, "LOG_Thread", NULL));
+
 	con_debuglog = true;
 	Con_DebugLog (va ("LOG started on: %s \n", session));
 }
@@ -1316,6 +1504,13 @@ void LOG_Close (void)
 {
 	if (log_fd == -1)
 		return;
+	LOG_Flush ();
+	SDL_LockMutex (log_write_mutex);
+	SDL_LockMutex (log_mutex);
 	close (log_fd);
 	log_fd = -1;
+	con_debuglog = false;
+	SDL_BroadcastCondition (log_condition);
+	SDL_UnlockMutex (log_mutex);
+	SDL_UnlockMutex (log_write_mutex);
 }
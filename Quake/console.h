@@ -44,6 +44,7 @@ void	 Con_Warning (const char *fmt, ...) FUNC_PRINTF (1, 2);	 // johnfitz
 void	 Con_DPrintf (const char *fmt, ...) FUNC_PRINTF (1, 2);
 void	 Con_DPrintf2 (const char *fmt, ...) FUNC_PRINTF (1, 2); // johnfitz
 void	 Con_SafePrintf (const char *fmt, ...) FUNC_PRINTF (1, 2);
+void	 Con_FlushQueued (void);
 void	 Con_DrawNotify (cb_context_t *cbx);
 void	 Con_ClearNotify (void);
 void	 Con_ToggleConsole_f (void);
@@ -61,6 +62,7 @@ void		Con_LogCenterPrint (const char *str);
 //
 void LOG_Init (quakeparms_t *parms);
 void LOG_Close (void);
+void LOG_Flush (void);
 void Con_DebugLog (const char *msg);
 
 #endif /* __CONSOLE_H */
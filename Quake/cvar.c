@@ -23,7 +23,17 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "quakedef.h"
 
+typedef struct cvarlistener_s
+{
+	cvarlistener_t		   func;
+	void				  *userdata;
+	struct cvarlistener_s *next;
+} cvarlistener_node_t;
+
+#define CVAR_HASH_SIZE 512 // power of two
+
 static cvar_t *cvar_vars;
+static cvar_t *cvar_hash[CVAR_HASH_SIZE];
 static char	   cvar_null_string[] = "";
 
 //==============================================================================
@@ -300,7 +310,8 @@ cvar_t *Cvar_FindVar (const char *var_name)
 {
 	cvar_t *var;
 
-	for (var = cvar_vars; var; var = var->next)
+	// buckets are case-folded so they can serve case-insensitive lookups, names still match exactly
+	for (var = cvar_hash[COM_HashStringNoCase (var_name) & (CVAR_HASH_SIZE - 1)]; var; var = var->hash_next)
 	{
 		if (!strcmp (var_name, var->name))
 			return var;
@@ -475,6 +486,11 @@ void Cvar_SetQuick (cvar_t *var, const char *value)
 
 	if (var->callback)
 		var->callback (var);
+	for (cvarlistener_node_t *listener = var->listeners, *next; listener; listener = next)
+	{
+		next = listener->next; // a listener may remove itself
+		listener->func (var, listener->userdata);
+	}
 	if (var->flags & CVAR_AUTOCVAR)
 		PR_AutoCvarChanged (var);
 }
@@ -585,6 +601,7 @@ void Cvar_RegisterVariable (cvar_t *variable)
 	char	 value[512];
 	qboolean set_rom;
 	cvar_t	*cursor, *prev; // johnfitz -- sorted list insert
+	unsigned bucket;
 
 	// first check to see if it has already been defined
 	if (Cvar_FindVar (variable->name))
@@ -620,6 +637,9 @@ void Cvar_RegisterVariable (cvar_t *variable)
 		prev->next = variable;
 	}
 	// johnfitz
+	bucket = COM_HashStringNoCase (variable->name) & (CVAR_HASH_SIZE - 1);
+	variable->hash_next = cvar_hash[bucket];
+	cvar_hash[bucket] = variable;
 	variable->flags |= CVAR_REGISTERED;
 
 	// copy the value off, because future sets will Mem_Free it
@@ -682,6 +702,49 @@ void Cvar_SetCallback (cvar_t *var, cvarcallback_t func)
 		var->flags &= ~CVAR_CALLBACK;
 }
 
+/*
+============
+Cvar_AddListener
+
+Unlike the callback a var can have several listeners, adding the same one twice does nothing
+============
+*/
+void Cvar_AddListener (cvar_t *var, cvarlistener_t func, void *userdata)
+{
+	cvarlistener_node_t *listener;
+
+	for (listener = var->listeners; listener; listener = listener->next)
+		if (listener->func == func && listener->userdata == userdata)
+			return;
+
+	listener = (cvarlistener_node_t *)Mem_Alloc (sizeof (cvarlistener_node_t));
+	listener->func = func;
+	listener->userdata = userdata;
+	listener->next = var->listeners;
+	var->listeners = listener;
+}
+
+/*
+============
+Cvar_RemoveListener
+============
+*/
+void Cvar_RemoveListener (cvar_t *var, cvarlistener_t func, void *userdata)
+{
+	cvarlistener_node_t **link;
+
+	for (link = &var->listeners; *link; link = &(*link)->next)
+	{
+		if ((*link)->func == func && (*link)->userdata == userdata)
+		{
+			cvarlistener_node_t *listener = *link;
+			*link = listener->next;
+			Mem_Free (listener);
+			return;
+		}
+	}
+}
+
 /*
 ============
 Cvar_Command
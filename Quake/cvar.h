@@ -82,6 +82,7 @@ typedef enum
 // clang-format on
 
 typedef void (*cvarcallback_t) (struct cvar_s *);
+typedef void (*cvarlistener_t) (struct cvar_s *, void *userdata);
 
 typedef struct cvar_s
 {
@@ -92,6 +93,9 @@ typedef struct cvar_s
 	const char	  *default_string; // johnfitz -- remember defaults for reset function
 	cvarcallback_t callback;
 	struct cvar_s *next;
+
+	struct cvarlistener_s *listeners; // Cvar_AddListener subscriptions
+	struct cvar_s		  *hash_next; // chain in the name hash, cvar_vars stays the sorted list
 } cvar_t;
 
 void Cvar_RegisterVariable (cvar_t *variable);
@@ -104,6 +108,10 @@ cvar_t *Cvar_Create (const char *name, const char *value);
 void Cvar_SetCallback (cvar_t *var, cvarcallback_t func);
 // set a callback function to the var
 
+void Cvar_AddListener (cvar_t *var, cvarlistener_t func, void *userdata);
+void Cvar_RemoveListener (cvar_t *var, cvarlistener_t func, void *userdata);
+// subscribe to changes of the var, any number of listeners run after its callback
+
 void Cvar_Set (const char *var_name, const char *value);
 // equivelant to "<name> <variable>" typed at the console
 
@@ -453,6 +453,65 @@ void Draw_Init (void)
 //
 //==============================================================================
 
+// Consecutive quads with the same pipeline and texture are collected per command buffer context and recorded
+// as one draw by Draw_Flush. Anything that changes state the pending quads depend on (canvas, scissor) or
+// records its own draws into the same context has to flush first.
+#define MAX_BATCH_QUADS 2048
+
+typedef struct draw_batch_s
+{
+	vulkan_pipeline_t pipeline;
+	gltexture_t		 *texture; // NULL for the basic_notex pipelines
+	int				  num_quads;
+	basicvertex_t	  vertices[MAX_BATCH_QUADS * 6];
+} draw_batch_t;
+
+/*
+================
+Draw_Flush
+================
+*/
+void Draw_Flush (cb_context_t *cbx)
+{
+	draw_batch_t *batch = cbx->draw_batch;
+	if (!batch || (batch->num_quads == 0))
+		return;
+
+	const int	   num_verts = batch->num_quads * 6;
+	VkBuffer	   buffer;
+	VkDeviceSize   buffer_offset;
+	basicvertex_t *vertices = (basicvertex_t *)R_VertexAllocate (num_verts * sizeof (basicvertex_t), &buffer, &buffer_offset);
+	memcpy (vertices, batch->vertices, num_verts * sizeof (basicvertex_t));
+	batch->num_quads = 0;
+
+	vulkan_globals.vk_cmd_bind_vertex_buffers (cbx->cb, 0, 1, &buffer, &buffer_offset);
+	R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, batch->pipeline);
+	if (batch->texture)
+		vulkan_globals.vk_cmd_bind_descriptor_sets (
+			cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.basic_pipeline_layout.handle, 0, 1, &batch->texture->descriptor_set, 0, NULL);
+	vulkan_globals.vk_cmd_draw (cbx->cb, num_verts, 1, 0, 0);
+}
+
+/*
+================
+Draw_AddQuad
+
+Returns room for the 6 vertices of one quad in the batch of cbx
+================
+*/
+basicvertex_t *Draw_AddQuad (cb_context_t *cbx, vulkan_pipeline_t pipeline, gltexture_t *texture)
+{
+	draw_batch_t *batch = cbx->draw_batch;
+	if (!batch)
+		batch = cbx->draw_batch = (draw_batch_t *)Mem_Alloc (sizeof (draw_batch_t));
+	else if ((batch->num_quads == MAX_BATCH_QUADS) || ((batch->num_quads > 0) && ((batch->pipeline.handle != pipeline.handle) || (batch->texture != texture))))
+		Draw_Flush (cbx);
+
+	batch->pipeline = pipeline;
+	batch->texture = texture;
+	return &batch->vertices[6 * batch->num_quads++];
+}
+
 /*
 ================
 Draw_FillCharacterQuad
@@ -526,17 +585,8 @@ void Draw_Character (cb_context_t *cbx, float x, float y, int num)
 	if (num == 32)
 		return; // don't waste verts on spaces
 
-	VkBuffer	   buffer;
-	VkDeviceSize   buffer_offset;
-	basicvertex_t *vertices = (basicvertex_t *)R_VertexAllocate (6 * sizeof (basicvertex_t), &buffer, &buffer_offset);
-
+	basicvertex_t *vertices = Draw_AddQuad (cbx, vulkan_globals.basic_alphatest_pipeline[cbx->render_pass_index], char_texture);
 	Draw_FillCharacterQuad (x, y, (char)num, vertices, rotation);
-
-	vulkan_globals.vk_cmd_bind_vertex_buffers (cbx->cb, 0, 1, &buffer, &buffer_offset);
-	R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.basic_alphatest_pipeline[cbx->render_pass_index]);
-	vulkan_globals.vk_cmd_bind_descriptor_sets (
-		cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.basic_pipeline_layout.handle, 0, 1, &char_texture->descriptor_set, 0, NULL);
-	vulkan_globals.vk_cmd_draw (cbx->cb, 6, 1, 0, 0);
 }
 
 /*
@@ -546,36 +596,58 @@ Draw_String
 */
 void Draw_String (cb_context_t *cbx, float x, float y, const char *str)
 {
-	int			num_verts = 0;
-	int			i;
-	const char *tmp;
-
 	if (y <= -CHARACTER_SIZE)
 		return; // totally off screen
 
-	for (tmp = str; *tmp != 0; ++tmp)
-		if (*tmp != 32)
-			num_verts += 6;
+	for (; *str != 0; ++str)
+	{
+		if (*str != 32) // don't waste verts on spaces
+			Draw_FillCharacterQuad (x, y, *str, Draw_AddQuad (cbx, vulkan_globals.basic_alphatest_pipeline[cbx->render_pass_index], char_texture), 0);
+		x += CHARACTER_SIZE;
+	}
+}
 
-	VkBuffer	   buffer;
-	VkDeviceSize   buffer_offset;
-	basicvertex_t *vertices = (basicvertex_t *)R_VertexAllocate (num_verts * sizeof (basicvertex_t), &buffer, &buffer_offset);
+/*
+================
+Draw_StringQuads
 
-	for (i = 0; *str != 0; ++str)
+Builds the character quads of len characters of str at height 0 without recording them.
+output needs room for 6 vertices per character, returns the number of quads written.
+================
+*/
+int Draw_StringQuads (float x, const char *str, int len, basicvertex_t *output)
+{
+	int num_quads = 0;
+	for (int i = 0; i < len; ++i, x += CHARACTER_SIZE)
 	{
-		if (*str != 32)
+		const int num = str[i] & 255;
+		if (num != 32) // don't waste verts on spaces
+			Draw_FillCharacterQuad (x, 0.0f, (char)num, &output[6 * num_quads++], 0);
+	}
+	return num_quads;
+}
+
+/*
+================
+Draw_CachedQuads
+
+Adds character quads built by Draw_StringQuads, moved down to y
+================
+*/
+void Draw_CachedQuads (cb_context_t *cbx, float y, const basicvertex_t *quads, int num_quads)
+{
+	if (y <= -CHARACTER_SIZE)
+		return; // totally off screen
+
+	for (int i = 0; i < num_quads; ++i, quads += 6)
+	{
+		basicvertex_t *vertices = Draw_AddQuad (cbx, vulkan_globals.basic_alphatest_pipeline[cbx->render_pass_index], char_texture);
+		for (int j = 0; j < 6; ++j)
 		{
-			Draw_FillCharacterQuad (x, y, *str, vertices + i * 6, 0);
-			i++;
+			vertices[j] = quads[j];
+			vertices[j].position[1] += y;
 		}
-		x += CHARACTER_SIZE;
 	}
-
-	vulkan_globals.vk_cmd_bind_vertex_buffers (cbx->cb, 0, 1, &buffer, &buffer_offset);
-	R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.basic_alphatest_pipeline[cbx->render_pass_index]);
-	vulkan_globals.vk_cmd_bind_descriptor_sets (
-		cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.basic_pipeline_layout.handle, 0, 1, &char_texture->descriptor_set, 0, NULL);
-	vulkan_globals.vk_cmd_draw (cbx->cb, num_verts, 1, 0, 0);
 }
 
 /*
@@ -592,10 +664,6 @@ void Draw_Pic (cb_context_t *cbx, float x, float y, qpic_t *pic, float alpha, qb
 		Scrap_Upload ();
 	memcpy (&gl, pic->data, sizeof (glpic_t));
 
-	VkBuffer	   buffer;
-	VkDeviceSize   buffer_offset;
-	basicvertex_t *vertices = (basicvertex_t *)R_VertexAllocate (6 * sizeof (basicvertex_t), &buffer, &buffer_offset);
-
 	basicvertex_t corner_verts[4];
 	memset (&corner_verts, 255, sizeof (corner_verts));
 
@@ -626,21 +694,15 @@ void Draw_Pic (cb_context_t *cbx, float x, float y, qpic_t *pic, float alpha, qb
 	for (i = 0; i < 4; ++i)
 		corner_verts[i].color[3] = alpha * 255.0f;
 
+	const vulkan_pipeline_t pipeline =
+		alpha_blend ? vulkan_globals.basic_blend_pipeline[cbx->render_pass_index] : vulkan_globals.basic_alphatest_pipeline[cbx->render_pass_index];
+	basicvertex_t *vertices = Draw_AddQuad (cbx, pipeline, gl.gltexture);
 	vertices[0] = corner_verts[0];
 	vertices[1] = corner_verts[1];
 	vertices[2] = corner_verts[2];
 	vertices[3] = corner_verts[2];
 	vertices[4] = corner_verts[3];
 	vertices[5] = corner_verts[0];
-
-	vkCmdBindVertexBuffers (cbx->cb, 0, 1, &buffer, &buffer_offset);
-	if (alpha_blend)
-		R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.basic_blend_pipeline[cbx->render_pass_index]);
-	else
-		R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.basic_alphatest_pipeline[cbx->render_pass_index]);
-	vkCmdBindDescriptorSets (
-		cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.basic_pipeline_layout.handle, 0, 1, &gl.gltexture->descriptor_set, 0, NULL);
-	vkCmdDraw (cbx->cb, 6, 1, 0, 0);
 }
 
 void Draw_SubPic (cb_context_t *cbx, float x, float y, float w, float h, qpic_t *pic, float s1, float t1, float s2, float t2, float *rgb, float alpha)
@@ -668,10 +730,6 @@ void Draw_SubPic (cb_context_t *cbx, float x, float y, float w, float h, qpic_t
 	}
 	rgba[3] *= alpha;
 
-	VkBuffer	   buffer;
-	VkDeviceSize   buffer_offset;
-	basicvertex_t *vertices = (basicvertex_t *)R_VertexAllocate (6 * sizeof (basicvertex_t), &buffer, &buffer_offset);
-
 	basicvertex_t corner_verts[4];
 	memset (&corner_verts, 255, sizeof (corner_verts));
 
@@ -707,21 +765,15 @@ void Draw_SubPic (cb_context_t *cbx, float x, float y, float w, float h, qpic_t
 		corner_verts[i].color[3] = rgba[3];
 	}
 
+	const vulkan_pipeline_t pipeline =
+		alpha_blend ? vulkan_globals.basic_blend_pipeline[cbx->render_pass_index] : vulkan_globals.basic_alphatest_pipeline[cbx->render_pass_index];
+	basicvertex_t *vertices = Draw_AddQuad (cbx, pipeline, gl.gltexture);
 	vertices[0] = corner_verts[0];
 	vertices[1] = corner_verts[1];
 	vertices[2] = corner_verts[2];
 	vertices[3] = corner_verts[2];
 	vertices[4] = corner_verts[3];
 	vertices[5] = corner_verts[0];
-
-	vkCmdBindVertexBuffers (cbx->cb, 0, 1, &buffer, &buffer_offset);
-	if (alpha_blend)
-		R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.basic_blend_pipeline[cbx->render_pass_index]);
-	else
-		R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.basic_alphatest_pipeline[cbx->render_pass_index]);
-	vkCmdBindDescriptorSets (
-		cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.basic_pipeline_layout.handle, 0, 1, &gl.gltexture->descriptor_set, 0, NULL);
-	vkCmdDraw (cbx->cb, 6, 1, 0, 0);
 }
 
 /*
@@ -785,10 +837,6 @@ void Draw_TileClear (cb_context_t *cbx, float x, float y, float w, float h)
 	glpic_t gl;
 	memcpy (&gl, draw_backtile->data, sizeof (glpic_t));
 
-	VkBuffer	   buffer;
-	VkDeviceSize   buffer_offset;
-	basicvertex_t *vertices = (basicvertex_t *)R_VertexAllocate (6 * sizeof (basicvertex_t), &buffer, &buffer_offset);
-
 	basicvertex_t corner_verts[4];
 	memset (&corner_verts, 255, sizeof (corner_verts));
 
@@ -816,18 +864,13 @@ void Draw_TileClear (cb_context_t *cbx, float x, float y, float w, float h)
 	corner_verts[3].texcoord[0] = x / 64.0;
 	corner_verts[3].texcoord[1] = (y + h) / 64.0;
 
+	basicvertex_t *vertices = Draw_AddQuad (cbx, vulkan_globals.basic_blend_pipeline[cbx->render_pass_index], gl.gltexture);
 	vertices[0] = corner_verts[0];
 	vertices[1] = corner_verts[1];
 	vertices[2] = corner_verts[2];
 	vertices[3] = corner_verts[2];
 	vertices[4] = corner_verts[3];
 	vertices[5] = corner_verts[0];
-
-	R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.basic_blend_pipeline[cbx->render_pass_index]);
-	vkCmdBindDescriptorSets (
-		cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.basic_pipeline_layout.handle, 0, 1, &gl.gltexture->descriptor_set, 0, NULL);
-	vkCmdBindVertexBuffers (cbx->cb, 0, 1, &buffer, &buffer_offset);
-	vkCmdDraw (cbx->cb, 6, 1, 0, 0);
 }
 
 /*
@@ -842,10 +885,6 @@ void Draw_Fill (cb_context_t *cbx, float x, float y, float w, float h, int c, fl
 	int	  i;
 	byte *pal = (byte *)d_8to24table; // johnfitz -- use d_8to24table instead of host_basepal
 
-	VkBuffer	   buffer;
-	VkDeviceSize   buffer_offset;
-	basicvertex_t *vertices = (basicvertex_t *)R_VertexAllocate (6 * sizeof (basicvertex_t), &buffer, &buffer_offset);
-
 	basicvertex_t corner_verts[4];
 	memset (&corner_verts, 0, sizeof (corner_verts));
 
@@ -869,16 +908,13 @@ void Draw_Fill (cb_context_t *cbx, float x, float y, float w, float h, int c, fl
 		corner_verts[i].color[3] = alpha * 255;
 	}
 
+	basicvertex_t *vertices = Draw_AddQuad (cbx, vulkan_globals.basic_notex_blend_pipeline[cbx->render_pass_index], NULL);
 	vertices[0] = corner_verts[0];
 	vertices[1] = corner_verts[1];
 	vertices[2] = corner_verts[2];
 	vertices[3] = corner_verts[2];
 	vertices[4] = corner_verts[3];
 	vertices[5] = corner_verts[0];
-
-	vkCmdBindVertexBuffers (cbx->cb, 0, 1, &buffer, &buffer_offset);
-	R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.basic_notex_blend_pipeline[cbx->render_pass_index]);
-	vkCmdDraw (cbx->cb, 6, 1, 0, 0);
 }
 
 /*
@@ -892,10 +928,6 @@ void Draw_FadeScreen (cb_context_t *cbx)
 
 	GL_SetCanvas (cbx, CANVAS_DEFAULT);
 
-	VkBuffer	   buffer;
-	VkDeviceSize   buffer_offset;
-	basicvertex_t *vertices = (basicvertex_t *)R_VertexAllocate (6 * sizeof (basicvertex_t), &buffer, &buffer_offset);
-
 	basicvertex_t corner_verts[4];
 	memset (&corner_verts, 0, sizeof (corner_verts));
 
@@ -914,16 +946,13 @@ void Draw_FadeScreen (cb_context_t *cbx)
 	for (i = 0; i < 4; ++i)
 		corner_verts[i].color[3] = 128;
 
+	basicvertex_t *vertices = Draw_AddQuad (cbx, vulkan_globals.basic_notex_blend_pipeline[cbx->render_pass_index], NULL);
 	vertices[0] = corner_verts[0];
 	vertices[1] = corner_verts[1];
 	vertices[2] = corner_verts[2];
 	vertices[3] = corner_verts[2];
 	vertices[4] = corner_verts[3];
 	vertices[5] = corner_verts[0];
-
-	vkCmdBindVertexBuffers (cbx->cb, 0, 1, &buffer, &buffer_offset);
-	R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.basic_notex_blend_pipeline[cbx->render_pass_index]);
-	vkCmdDraw (cbx->cb, 6, 1, 0, 0);
 }
 
 /*
@@ -986,6 +1015,8 @@ void GL_SetCanvas (cb_context_t *cbx, canvastype newcanvas)
 	if (newcanvas == cbx->current_canvas)
 		return;
 
+	Draw_Flush (cbx);
+
 	extern vrect_t scr_vrect;
 	float		   s, u, v;
 	int			   lines;
@@ -330,17 +330,6 @@ void Fog_DisableGFog (cb_context_t *cbx)
 	R_PushConstants (cbx, VK_SHADER_STAGE_ALL_GRAPHICS, 16 * sizeof (float), 4 * sizeof (float), fog_values);
 }
 
-//==============================================================================
-//
-//  VOLUMETRIC FOG
-//
-//==============================================================================
-
-cvar_t r_vfog = {"r_vfog", "1", CVAR_NONE};
-
-void Fog_DrawVFog (void) {}
-void Fog_MarkModels (void) {}
-
 //==============================================================================
 //
 //  INIT
@@ -357,7 +346,6 @@ called whenever a map is loaded
 void Fog_NewMap (void)
 {
 	Fog_ParseWorldspawn (); // for global fog
-	Fog_MarkModels ();		// for volumetric fog
 }
 
 /*
@@ -371,8 +359,6 @@ void Fog_Init (void)
 {
 	Cmd_AddCommand ("fog", Fog_FogCommand_f);
 
-	// Cvar_RegisterVariable (&r_vfog);
-
 	// set up global fog
 	fog_density = DEFAULT_DENSITY;
 	fog_red = DEFAULT_GRAY;
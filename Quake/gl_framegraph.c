@@ -0,0 +1,284 @@
+/*
+Copyright (C) 2026 vkQuake developers
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+// gl_framegraph.c -- barriers derived from declared image uses
+
+#include "quakedef.h"
+
+/*
+Passes declare how they are about to use a frame image with R_UseFrameImage
+instead of writing barriers by hand. The image remembers its layout, the
+writes that weren't made visible yet and the reads since the last write, so
+a barrier is only queued when there is an actual hazard or layout change.
+Queued barriers are merged per command buffer and issued together by
+R_FlushBarriers, with VK_KHR_synchronization2 if available.
+*/
+
+typedef struct
+{
+	VkPipelineStageFlags2KHR stages;
+	VkAccessFlags2KHR		 access;
+	VkImageLayout			 layout;
+	qboolean				 write;
+} resource_use_info_t;
+
+#define WRITE_ACCESS_MASK \
+	(VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT)
+
+// The synchronization2 flags are constants that can't initialize a static table in C, the legacy bits have the same values
+static const resource_use_info_t resource_use_infos[RESOURCE_USE_NUM] = {
+	// RESOURCE_USE_COLOR_ATTACHMENT
+	{VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+	 VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, true},
+	// RESOURCE_USE_DEPTH_ATTACHMENT
+	{VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+	 VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+	 true},
+	// RESOURCE_USE_DEPTH_READ_COMPUTE
+	{VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, false},
+	// RESOURCE_USE_SAMPLED_FRAGMENT
+	{VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, false},
+	// RESOURCE_USE_SAMPLED_COMPUTE
+	{VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, false},
+	// RESOURCE_USE_STORAGE_READ_COMPUTE
+	{VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_GENERAL, false},
+	// RESOURCE_USE_STORAGE_WRITE_COMPUTE
+	{VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL, true},
+	// RESOURCE_USE_TRANSFER_DST
+	{VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, true},
+	// RESOURCE_USE_SHADING_RATE
+	{VK_PIPELINE_STAGE_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR, VK_ACCESS_FRAGMENT_SHADING_RATE_ATTACHMENT_READ_BIT_KHR,
+	 VK_IMAGE_LAYOUT_FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL_KHR, false},
+};
+
+/*
+===============
+R_InitFrameImage
+===============
+*/
+void R_InitFrameImage (frame_image_t *frame_image, VkImage image, VkImageAspectFlags aspect, uint32_t num_levels)
+{
+	memset (frame_image, 0, sizeof (*frame_image));
+	frame_image->image = image;
+	frame_image->aspect = aspect;
+	frame_image->num_levels = num_levels;
+	frame_image->layout = VK_IMAGE_LAYOUT_UNDEFINED;
+}
+
+/*
+===============
+R_QueueImageBarrier
+===============
+*/
+static void R_QueueImageBarrier (cb_context_t *cbx, frame_image_t *frame_image, const resource_use_info_t *info, qboolean discard)
+{
+	// A read in the same layout right after another queued read of this image widens that barrier instead
+	for (int i = 0; i < cbx->num_pending_image_barriers; ++i)
+	{
+		VkImageMemoryBarrier2KHR *pending = &cbx->pending_image_barriers[i];
+		if (pending->image != frame_image->image)
+			continue;
+		if (!info->write && !discard && (pending->newLayout == info->layout) && !(pending->dstAccessMask & ~VK_ACCESS_2_SHADER_READ_BIT_KHR))
+		{
+			pending->dstStageMask |= info->stages;
+			pending->dstAccessMask |= info->access;
+			return;
+		}
+		R_FlushBarriers (cbx);
+		break;
+	}
+	if (cbx->num_pending_image_barriers == MAX_PENDING_IMAGE_BARRIERS)
+		R_FlushBarriers (cbx);
+
+	VkImageMemoryBarrier2KHR *barrier = &cbx->pending_image_barriers[cbx->num_pending_image_barriers++];
+	memset (barrier, 0, sizeof (*barrier));
+	barrier->sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR;
+	barrier->srcStageMask = frame_image->write_stages | frame_image->read_stages;
+	barrier->srcAccessMask = frame_image->write_access;
+	barrier->dstStageMask = info->stages;
+	barrier->dstAccessMask = info->access;
+	barrier->oldLayout = discard ? VK_IMAGE_LAYOUT_UNDEFINED : frame_image->layout;
+	barrier->newLayout = info->layout;
+	barrier->srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier->dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier->image = frame_image->image;
+	barrier->subresourceRange.aspectMask = frame_image->aspect;
+	barrier->subresourceRange.baseMipLevel = 0;
+	barrier->subresourceRange.levelCount = frame_image->num_levels;
+	barrier->subresourceRange.baseArrayLayer = 0;
+	barrier->subresourceRange.layerCount = 1;
+}
+
+/*
+===============
+R_UseFrameImage
+
+Declares that the next commands recorded to cbx use the image as described
+by use. With discard the previous contents are not needed. The barrier, if
+one is needed, is only queued and must be issued with R_FlushBarriers before
+those commands.
+===============
+*/
+void R_UseFrameImage (cb_context_t *cbx, frame_image_t *frame_image, resource_use_t use, qboolean discard)
+{
+	const resource_use_info_t *info = &resource_use_infos[use];
+	const qboolean			   layout_change = frame_image->layout != info->layout;
+
+	if (info->write)
+	{
+		// Write after write or write after read
+		if (layout_change || frame_image->write_stages || frame_image->read_stages)
+			R_QueueImageBarrier (cbx, frame_image, info, discard);
+		frame_image->write_stages = info->stages;
+		frame_image->write_access = info->access & WRITE_ACCESS_MASK;
+		frame_image->read_stages = 0;
+		frame_image->visible_stages = 0;
+	}
+	else
+	{
+		// Read after write, unless an earlier barrier already made the writes visible to these stages
+		if (layout_change || (frame_image->write_stages && (info->stages & ~frame_image->visible_stages)))
+		{
+			R_QueueImageBarrier (cbx, frame_image, info, discard);
+			frame_image->visible_stages = layout_change ? info->stages : (frame_image->visible_stages | info->stages);
+		}
+		frame_image->read_stages |= info->stages;
+	}
+	frame_image->layout = info->layout;
+}
+
+/*
+===============
+R_SetFrameImageUse
+
+Records the state a render pass left one of its attachments in. Its writes
+still need a barrier before anything outside of the render pass reads them.
+===============
+*/
+void R_SetFrameImageUse (frame_image_t *frame_image, resource_use_t use)
+{
+	const resource_use_info_t *info = &resource_use_infos[use];
+	frame_image->layout = info->layout;
+	frame_image->write_stages = info->write ? info->stages : 0;
+	frame_image->write_access = info->write ? (info->access & WRITE_ACCESS_MASK) : 0;
+	frame_image->read_stages = info->write ? 0 : info->stages;
+	frame_image->visible_stages = 0;
+}
+
+/*
+===============
+R_ReturnFrameImage
+
+Moves an attachment back to the layout of use, if passes outside of the
+render pass left it in another one. The render pass doesn't load it and
+synchronizes with its own previous writes, so only the reads since then
+are waited for.
+===============
+*/
+void R_ReturnFrameImage (cb_context_t *cbx, frame_image_t *frame_image, resource_use_t use)
+{
+	const resource_use_info_t *info = &resource_use_infos[use];
+	if (frame_image->layout == info->layout)
+		return;
+	R_UseFrameImage (cbx, frame_image, use, true);
+	frame_image->write_stages = 0;
+	frame_image->write_access = 0;
+}
+
+/*
+===============
+R_QueueMemoryBarrier
+
+For accesses that aren't tracked, e.g. buffers or images that only change
+layout inside render passes. Merged with everything else queued on cbx.
+===============
+*/
+void R_QueueMemoryBarrier (
+	cb_context_t *cbx, VkPipelineStageFlags2KHR src_stages, VkAccessFlags2KHR src_access, VkPipelineStageFlags2KHR dst_stages, VkAccessFlags2KHR dst_access)
+{
+	cbx->pending_memory_barrier.srcStageMask |= src_stages;
+	cbx->pending_memory_barrier.srcAccessMask |= src_access;
+	cbx->pending_memory_barrier.dstStageMask |= dst_stages;
+	cbx->pending_memory_barrier.dstAccessMask |= dst_access;
+}
+
+/*
+===============
+R_FlushBarriers
+
+Issues everything queued on cbx with a single barrier command
+===============
+*/
+void R_FlushBarriers (cb_context_t *cbx)
+{
+	const qboolean memory_barrier = cbx->pending_memory_barrier.dstStageMask != 0;
+	if (!memory_barrier && (cbx->num_pending_image_barriers == 0))
+		return;
+
+	if (vulkan_globals.synchronization_2)
+	{
+		cbx->pending_memory_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2_KHR;
+		cbx->pending_memory_barrier.pNext = NULL;
+
+		ZEROED_STRUCT (VkDependencyInfoKHR, dependency_info);
+		dependency_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR;
+		dependency_info.memoryBarrierCount = memory_barrier ? 1 : 0;
+		dependency_info.pMemoryBarriers = &cbx->pending_memory_barrier;
+		dependency_info.imageMemoryBarrierCount = cbx->num_pending_image_barriers;
+		dependency_info.pImageMemoryBarriers = cbx->pending_image_barriers;
+		vulkan_globals.vk_cmd_pipeline_barrier_2 (cbx->cb, &dependency_info);
+	}
+	else
+	{
+		// The stage and access bits used here have the same values in both versions, the masks are merged into one call
+		VkPipelineStageFlags src_stages = (VkPipelineStageFlags)cbx->pending_memory_barrier.srcStageMask;
+		VkPipelineStageFlags dst_stages = (VkPipelineStageFlags)cbx->pending_memory_barrier.dstStageMask;
+
+		VkMemoryBarrier memory_barrier_1;
+		memory_barrier_1.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		memory_barrier_1.pNext = NULL;
+		memory_barrier_1.srcAccessMask = (VkAccessFlags)cbx->pending_memory_barrier.srcAccessMask;
+		memory_barrier_1.dstAccessMask = (VkAccessFlags)cbx->pending_memory_barrier.dstAccessMask;
+
+		VkImageMemoryBarrier image_barriers[MAX_PENDING_IMAGE_BARRIERS];
+		for (int i = 0; i < cbx->num_pending_image_barriers; ++i)
+		{
+			const VkImageMemoryBarrier2KHR *pending = &cbx->pending_image_barriers[i];
+			image_barriers[i].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			image_barriers[i].pNext = NULL;
+			image_barriers[i].srcAccessMask = (VkAccessFlags)pending->srcAccessMask;
+			image_barriers[i].dstAccessMask = (VkAccessFlags)pending->dstAccessMask;
+			image_barriers[i].oldLayout = pending->oldLayout;
+			image_barriers[i].newLayout = pending->newLayout;
+			image_barriers[i].srcQueueFamilyIndex = pending->srcQueueFamilyIndex;
+			image_barriers[i].dstQueueFamilyIndex = pending->dstQueueFamilyIndex;
+			image_barriers[i].image = pending->image;
+			image_barriers[i].subresourceRange = pending->subresourceRange;
+			src_stages |= (VkPipelineStageFlags)pending->srcStageMask;
+			dst_stages |= (VkPipelineStageFlags)pending->dstStageMask;
+		}
+
+		vulkan_globals.vk_cmd_pipeline_barrier (
+			cbx->cb, src_stages ? src_stages : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, dst_stages, 0, memory_barrier ? 1 : 0, &memory_barrier_1, 0, NULL,
+			cbx->num_pending_image_barriers, image_barriers);
+	}
+
+	memset (&cbx->pending_memory_barrier, 0, sizeof (cbx->pending_memory_barrier));
+	cbx->num_pending_image_barriers = 0;
+}
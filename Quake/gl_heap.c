@@ -34,6 +34,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #define NUM_BLOCK_SIZE_CLASSES 8
 #define MAX_PAGES			   (UINT16_MAX - 1)
 #define INVALID_PAGE_INDEX	   UINT16_MAX
+#define SPARSE_SEGMENT_PERCENT 25 // segments with fewer pages allocated are defrag candidates
 
 typedef uint16_t page_index_t;
 
@@ -77,6 +78,7 @@ typedef struct glheapsegment_s
 	uint64_t				*free_blocks_skip_bitfields[NUM_BLOCK_SIZE_CLASSES];
 	page_index_t			 small_alloc_free_list_heads[NUM_SMALL_ALLOC_SIZES];
 	page_index_t			 num_pages_allocated;
+	qboolean				 pinned; // holds an allocation that can't be relocated, skipped by defrag until something is freed from it
 } glheapsegment_t;
 
 typedef struct glheap_s
@@ -94,6 +96,7 @@ typedef struct glheap_s
 	page_index_t		 num_pages_per_segment;
 	page_index_t		 num_masks_per_segment;
 	glheapsegment_t	   **segments;
+	glheapsegment_t		*defrag_segment; // allocations are moved out of this segment so that it can be released
 	uint64_t			 dedicated_alloc_bytes;
 	glheapstats_t		 stats;
 } glheap_t;
@@ -237,6 +240,60 @@ static glheapsegment_t *GL_CreateHeapSegment (glheap_t *heap, atomic_uint32_t *n
 	return segment;
 }
 
+/*
+===============
+GL_DestroyHeapSegment
+===============
+*/
+static void GL_DestroyHeapSegment (glheapsegment_t *segment, atomic_uint32_t *num_allocations)
+{
+	R_FreeVulkanMemory (&segment->memory, num_allocations);
+	Mem_Free (segment->page_hdrs);
+	Mem_Free (segment->small_alloc_links);
+	Mem_Free (segment->small_alloc_masks);
+	for (int i = 0; i < NUM_BLOCK_SIZE_CLASSES; ++i)
+	{
+		Mem_Free (segment->free_blocks_bitfields[i]);
+		Mem_Free (segment->free_blocks_skip_bitfields[i]);
+	}
+	Mem_Free (segment);
+}
+
+/*
+===============
+GL_HeapReleaseEmptySegment
+
+Releases the device memory of a segment that just became empty. One empty
+segment is kept around so that alternating allocations and frees at a
+segment boundary don't reallocate device memory every time, the defrag
+segment is always released since it was emptied on purpose.
+===============
+*/
+static void GL_HeapReleaseEmptySegment (glheap_t *heap, glheapsegment_t *segment, atomic_uint32_t *num_allocations)
+{
+	int segment_index = -1;
+	int num_empty_segments = 0;
+	for (uint32_t i = 0; i < heap->num_segments; ++i)
+	{
+		if (heap->segments[i] == segment)
+			segment_index = i;
+		if (heap->segments[i]->num_pages_allocated == 0)
+			++num_empty_segments;
+	}
+	assert (segment_index >= 0);
+	if ((segment != heap->defrag_segment) && (num_empty_segments < 2))
+		return;
+
+	TRACE_LOG ("Releasing empty segment %d of %s\n", segment_index, heap->name);
+	if (segment == heap->defrag_segment)
+		heap->defrag_segment = NULL;
+	--heap->stats.num_blocks_free;
+	++heap->stats.num_segments_released;
+	--heap->num_segments;
+	memmove (&heap->segments[segment_index], &heap->segments[segment_index + 1], (heap->num_segments - segment_index) * sizeof (glheapsegment_t *));
+	GL_DestroyHeapSegment (segment, num_allocations);
+}
+
 /*
 ===============
 GL_HeapAllocateBlockFromSegment
@@ -624,18 +681,7 @@ GL_HeapDestroy
 void GL_HeapDestroy (glheap_t *heap, atomic_uint32_t *num_allocations)
 {
 	for (uint32_t mask_page_offset = 0; mask_page_offset < heap->num_segments; ++mask_page_offset)
-	{
-		glheapsegment_t *segment = heap->segments[mask_page_offset];
-		R_FreeVulkanMemory (&segment->memory, num_allocations);
-		Mem_Free (segment->page_hdrs);
-		Mem_Free (segment->small_alloc_links);
-		Mem_Free (segment->small_alloc_masks);
-		for (int mask_page_index = 0; mask_page_index < NUM_BLOCK_SIZE_CLASSES; ++mask_page_index)
-		{
-			Mem_Free (segment->free_blocks_bitfields[mask_page_index]);
-			Mem_Free (segment->free_blocks_skip_bitfields[mask_page_index]);
-		}
-	}
+		GL_DestroyHeapSegment (heap->segments[mask_page_offset], num_allocations);
 	Mem_Free (heap->segments);
 }
 
@@ -686,6 +732,10 @@ glheapallocation_t *GL_HeapAllocate (glheap_t *heap, VkDeviceSize size, VkDevice
 				++heap->num_segments;
 			}
 
+			// Never allocate from the segment that is being emptied
+			if (heap->segments[mask_page_offset] == heap->defrag_segment)
+				continue;
+
 			const qboolean success = GL_HeapAllocateFromSegment (allocation, heap, heap->segments[mask_page_offset], &alloc_info);
 			if (success)
 			{
@@ -718,20 +768,27 @@ glheapallocation_t *GL_HeapAllocate (glheap_t *heap, VkDeviceSize size, VkDevice
 
 /*
 ===============
-GL_HeapFree
+GL_HeapFreeAllocation
+
+Returns the segment if it became empty, releasing it is left to the caller
 ===============
 */
-void GL_HeapFree (glheap_t *heap, glheapallocation_t *allocation, atomic_uint32_t *num_allocations)
+static glheapsegment_t *GL_HeapFreeAllocation (glheap_t *heap, glheapallocation_t *allocation, atomic_uint32_t *num_allocations)
 {
 	TRACE_LOG ("Freeing %" PRIu64 " bytes from segment %p offset %" PRIu64 "\n", allocation->size, allocation->segment, allocation->offset);
 
+	glheapsegment_t *emptied_segment = NULL;
 	--heap->stats.num_allocations;
 	heap->stats.num_bytes_allocated -= allocation->size;
+	if (allocation->alloc_type != ALLOC_TYPE_DEDICATED)
+		allocation->segment->pinned = false;
 
 	if (allocation->alloc_type == ALLOC_TYPE_PAGES)
 	{
 		--heap->stats.num_block_allocations;
 		GL_HeapFreeBlockFromSegment (heap, allocation->segment, heap->page_size_shift, allocation->offset);
+		if (allocation->segment->num_pages_allocated == 0)
+			emptied_segment = allocation->segment;
 	}
 	else if (allocation->alloc_type == ALLOC_TYPE_DEDICATED)
 	{
@@ -744,9 +801,49 @@ void GL_HeapFree (glheap_t *heap, glheapallocation_t *allocation, atomic_uint32_
 	{
 		--heap->stats.num_small_allocations;
 		if (GL_HeapSmallFreeFromBlock (heap, allocation->segment, allocation))
+		{
 			GL_HeapFreeBlockFromSegment (heap, allocation->segment, heap->page_size_shift, allocation->offset);
+			if (allocation->segment->num_pages_allocated == 0)
+				emptied_segment = allocation->segment;
+		}
 	}
 	Mem_Free (allocation);
+	return emptied_segment;
+}
+
+/*
+===============
+GL_HeapFree
+===============
+*/
+void GL_HeapFree (glheap_t *heap, glheapallocation_t *allocation, atomic_uint32_t *num_allocations)
+{
+	glheapsegment_t *emptied_segment = GL_HeapFreeAllocation (heap, allocation, num_allocations);
+	if (emptied_segment)
+		GL_HeapReleaseEmptySegment (heap, emptied_segment, num_allocations);
+}
+
+/*
+===============
+GL_HeapFreeBatch
+
+Frees a number of allocations and only looks for empty segments to release
+once at the end instead of after every free that emptied one
+===============
+*/
+void GL_HeapFreeBatch (glheap_t *heap, glheapallocation_t **allocations, int num, atomic_uint32_t *num_allocations)
+{
+	qboolean emptied_segment = false;
+	for (int i = 0; i < num; ++i)
+		if (GL_HeapFreeAllocation (heap, allocations[i], num_allocations))
+			emptied_segment = true;
+	if (!emptied_segment)
+		return;
+
+	// Releasing a segment moves the ones after it down, walk backwards so none is skipped
+	for (int i = (int)heap->num_segments - 1; i >= 0; --i)
+		if (heap->segments[i]->num_pages_allocated == 0)
+			GL_HeapReleaseEmptySegment (heap, heap->segments[i], num_allocations);
 }
 
 /*
@@ -769,6 +866,82 @@ VkDeviceSize GL_HeapGetAllocationOffset (glheapallocation_t *allocation)
 	return allocation->offset;
 }
 
+/*
+===============
+GL_HeapGetAllocationSize
+===============
+*/
+VkDeviceSize GL_HeapGetAllocationSize (glheapallocation_t *allocation)
+{
+	return allocation->size;
+}
+
+/*
+===============
+GL_HeapUpdateDefrag
+
+Picks the sparsest segment whose allocated pages fit into the free pages
+of the other segments as the defrag segment. New allocations skip it and
+callers relocate the allocations for which GL_HeapShouldRelocate returns
+true, once it is empty GL_HeapFree releases its memory.
+Returns true while a segment is being emptied.
+===============
+*/
+qboolean GL_HeapUpdateDefrag (glheap_t *heap)
+{
+	if (heap->defrag_segment)
+		return true;
+	if (heap->num_segments < 2)
+		return false;
+
+	uint32_t		 num_pages_free = 0;
+	glheapsegment_t *sparsest_segment = NULL;
+	for (uint32_t i = 0; i < heap->num_segments; ++i)
+	{
+		glheapsegment_t *segment = heap->segments[i];
+		num_pages_free += heap->num_pages_per_segment - segment->num_pages_allocated;
+		if (segment->pinned || segment->num_pages_allocated == 0 || segment->num_pages_allocated * 100 >= heap->num_pages_per_segment * SPARSE_SEGMENT_PERCENT)
+			continue;
+		if (!sparsest_segment || segment->num_pages_allocated < sparsest_segment->num_pages_allocated)
+			sparsest_segment = segment;
+	}
+	if (!sparsest_segment)
+		return false;
+
+	// Leave slack for alignment and fragmentation in the destination segments
+	const uint32_t num_pages_free_elsewhere = num_pages_free - (heap->num_pages_per_segment - sparsest_segment->num_pages_allocated);
+	if (sparsest_segment->num_pages_allocated * 2 > num_pages_free_elsewhere)
+		return false;
+
+	TRACE_LOG ("Defragmenting %s, emptying segment with %u pages allocated\n", heap->name, sparsest_segment->num_pages_allocated);
+	heap->defrag_segment = sparsest_segment;
+	return true;
+}
+
+/*
+===============
+GL_HeapShouldRelocate
+===============
+*/
+qboolean GL_HeapShouldRelocate (glheap_t *heap, glheapallocation_t *allocation)
+{
+	return heap->defrag_segment && (allocation->alloc_type != ALLOC_TYPE_DEDICATED) && (allocation->segment == heap->defrag_segment);
+}
+
+/*
+===============
+GL_HeapCancelDefrag
+
+Called when an allocation in the defrag segment can't be moved
+===============
+*/
+void GL_HeapCancelDefrag (glheap_t *heap)
+{
+	if (heap->defrag_segment)
+		heap->defrag_segment->pinned = true;
+	heap->defrag_segment = NULL;
+}
+
 /*
 ===============
 GL_HeapGetStats
@@ -781,12 +954,22 @@ glheapstats_t *GL_HeapGetStats (glheap_t *heap)
 	uint64_t total_allocated_page_bytes = 0;
 	uint32_t small_alloc_pages_bytes = 0;
 	uint64_t small_alloc_bytes = 0;
+	heap->stats.num_segments_sparse = 0;
+	heap->stats.largest_free_block_pages = 0;
 	for (uint32_t mask_page_offset = 0; mask_page_offset < heap->num_segments; ++mask_page_offset)
 	{
 		glheapsegment_t *segment = heap->segments[mask_page_offset];
 		num_total_pages += heap->num_pages_per_segment;
 		heap->stats.num_pages_allocated += segment->num_pages_allocated;
 		total_allocated_page_bytes += segment->num_pages_allocated * heap->page_size;
+		if (segment->num_pages_allocated * 100 < heap->num_pages_per_segment * SPARSE_SEGMENT_PERCENT)
+			++heap->stats.num_segments_sparse;
+		for (uint32_t block_page_index = 0; block_page_index < heap->num_pages_per_segment;
+			 block_page_index += segment->page_hdrs[block_page_index].size_in_pages)
+		{
+			if (GL_HeapIsBlockFree (heap, segment, block_page_index))
+				heap->stats.largest_free_block_pages = q_max (heap->stats.largest_free_block_pages, segment->page_hdrs[block_page_index].size_in_pages);
+		}
 		for (int i = 0; i < NUM_SMALL_ALLOC_SIZES; ++i)
 		{
 			const uint32_t slots_per_page = SMALL_SLOTS_PER_PAGE[i];
@@ -807,6 +990,7 @@ glheapstats_t *GL_HeapGetStats (glheap_t *heap)
 		}
 	}
 	heap->stats.num_segments = heap->num_segments;
+	heap->stats.defragmenting = heap->defrag_segment != NULL;
 	heap->stats.num_pages_free = num_total_pages - heap->stats.num_pages_allocated;
 	heap->stats.num_bytes_free = heap->stats.num_pages_free * heap->page_size;
 	heap->stats.num_bytes_wasted =
@@ -970,6 +1154,45 @@ void GL_HeapTest_f (void)
 		for (int i = 0; i < NUM_ALLOCS_PER_ITERATION; ++i)
 			HEAP_TEST_ASSERT (allocations[i] == NULL, "allocation is not NULL");
 		TestHeapCleanState (test_heap);
+		HEAP_TEST_ASSERT (test_heap->num_segments <= 1, "Empty segments need to be released");
+	}
+	{
+		// Fill several segments, free most allocations and move the rest out of the sparsest segment
+		const VkDeviceSize ALLOC_SIZE = TEST_HEAP_PAGE_SIZE * 4;
+		const int		   NUM_DEFRAG_ALLOCS = (TEST_HEAP_SIZE / ALLOC_SIZE) * 3;
+		for (int i = 0; i < NUM_DEFRAG_ALLOCS; ++i)
+			allocations[i] = GL_HeapAllocate (test_heap, ALLOC_SIZE, 1, &num_allocations);
+		for (int i = 0; i < NUM_DEFRAG_ALLOCS; ++i)
+		{
+			if ((i % 8) != 0)
+			{
+				GL_HeapFree (test_heap, allocations[i], &num_allocations);
+				allocations[i] = NULL;
+			}
+		}
+		TestHeapConsistency (test_heap);
+		const uint32_t num_segments = test_heap->num_segments;
+		HEAP_TEST_ASSERT (GL_HeapUpdateDefrag (test_heap), "Defrag needs to find a sparse segment");
+		for (int i = 0; i < NUM_DEFRAG_ALLOCS; ++i)
+		{
+			if (allocations[i] && GL_HeapShouldRelocate (test_heap, allocations[i]))
+			{
+				glheapallocation_t *relocated = GL_HeapAllocate (test_heap, ALLOC_SIZE, 1, &num_allocations);
+				HEAP_TEST_ASSERT (!GL_HeapShouldRelocate (test_heap, relocated), "Relocated allocation is in the defrag segment");
+				GL_HeapFree (test_heap, allocations[i], &num_allocations);
+				allocations[i] = relocated;
+				TestHeapConsistency (test_heap);
+			}
+		}
+		HEAP_TEST_ASSERT (test_heap->num_segments < num_segments, "Defrag segment needs to be released");
+		HEAP_TEST_ASSERT (!GL_HeapGetStats (test_heap)->defragmenting, "Defrag needs to be finished");
+		for (int i = 0; i < NUM_DEFRAG_ALLOCS; ++i)
+		{
+			if (allocations[i])
+				GL_HeapFree (test_heap, allocations[i], &num_allocations);
+			allocations[i] = NULL;
+		}
+		TestHeapCleanState (test_heap);
 	}
 	TEMP_FREE (allocations);
 	{
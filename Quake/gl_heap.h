@@ -38,6 +38,10 @@ typedef struct glheapstats_s
 	uint64_t num_bytes_allocated;
 	uint64_t num_bytes_free;
 	uint64_t num_bytes_wasted;
+	uint32_t num_segments_sparse;	   // segments below the defrag occupancy threshold
+	uint32_t num_segments_released;	   // empty segments whose memory was given back
+	uint32_t largest_free_block_pages; // compare with num_pages_free to gauge fragmentation
+	qboolean defragmenting;
 } glheapstats_t;
 
 glheap_t *GL_HeapCreate (
@@ -46,9 +50,14 @@ glheap_t *GL_HeapCreate (
 void				GL_HeapDestroy (glheap_t *heap, atomic_uint32_t *num_allocations);
 glheapallocation_t *GL_HeapAllocate (glheap_t *heap, VkDeviceSize size, VkDeviceSize alignment, atomic_uint32_t *num_allocations);
 void				GL_HeapFree (glheap_t *heap, glheapallocation_t *allocation, atomic_uint32_t *num_allocations);
+void				GL_HeapFreeBatch (glheap_t *heap, glheapallocation_t **allocations, int num, atomic_uint32_t *num_allocations);
 VkDeviceMemory		GL_HeapGetAllocationMemory (glheapallocation_t *allocation);
 VkDeviceSize		GL_HeapGetAllocationOffset (glheapallocation_t *allocation);
+VkDeviceSize		GL_HeapGetAllocationSize (glheapallocation_t *allocation);
 glheapstats_t	   *GL_HeapGetStats (glheap_t *heap);
+qboolean			GL_HeapUpdateDefrag (glheap_t *heap);
+qboolean			GL_HeapShouldRelocate (glheap_t *heap, glheapallocation_t *allocation);
+void				GL_HeapCancelDefrag (glheap_t *heap);
 
 #ifdef _DEBUG
 void GL_HeapTest_f (void);
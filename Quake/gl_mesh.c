@@ -59,11 +59,8 @@ typedef struct
 	glheapallocation_t		  *allocation;
 } blas_garbage_t;
 
-static int				current_garbage_index;
-static int				num_garbage_buffers[2];
-static buffer_garbage_t buffer_garbage[MAX_MODELS * 2][2];
-static int				num_garbage_blas[2];
-static blas_garbage_t	blas_garbage[MAX_EDICTS][2];
+static garbage_queue_t buffer_garbage = {NULL, NULL, sizeof (buffer_garbage_t)};
+static garbage_queue_t blas_garbage = {NULL, NULL, sizeof (blas_garbage_t)};
 
 /*
 ================
@@ -73,16 +70,13 @@ AddBufferGarbage
 static void AddBufferGarbage (
 	VkBuffer buffer, VkDescriptorSet descriptor_set, glheapallocation_t *allocation, const VkDescriptorSet desc_set, vulkan_desc_set_layout_t *desc_set_layout)
 {
-	int				  garbage_index;
-	buffer_garbage_t *garbage;
-
-	garbage_index = num_garbage_buffers[current_garbage_index]++;
-	garbage = &buffer_garbage[garbage_index][current_garbage_index];
-	garbage->buffer = buffer;
-	garbage->descriptor_set = descriptor_set;
-	garbage->allocation = allocation;
-	garbage->desc_set = desc_set;
-	garbage->desc_set_layout = desc_set_layout;
+	buffer_garbage_t garbage;
+	garbage.buffer = buffer;
+	garbage.descriptor_set = descriptor_set;
+	garbage.allocation = allocation;
+	garbage.desc_set = desc_set;
+	garbage.desc_set_layout = desc_set_layout;
+	R_PushGarbage (&buffer_garbage, &garbage);
 }
 
 /*
@@ -92,14 +86,11 @@ AddBLASGarbage
 */
 static void AddBLASGarbage (VkAccelerationStructureKHR blas, VkBuffer buffer, glheapallocation_t *allocation)
 {
-	int				garbage_index;
-	blas_garbage_t *garbage;
-
-	garbage_index = num_garbage_blas[current_garbage_index]++;
-	garbage = &blas_garbage[garbage_index][current_garbage_index];
-	garbage->blas = blas;
-	garbage->buffer = buffer;
-	garbage->allocation = allocation;
+	blas_garbage_t garbage;
+	garbage.blas = blas;
+	garbage.buffer = buffer;
+	garbage.allocation = allocation;
+	R_PushGarbage (&blas_garbage, &garbage);
 }
 
 /*
@@ -145,36 +136,37 @@ glheapstats_t *R_GetMeshHeapStats (void)
 /*
 ================
 R_CollectMeshBufferGarbage
+
+Destroys at most R_GarbageBudget buffers and acceleration structures per frame
 ================
 */
 void R_CollectMeshBufferGarbage (void)
 {
-	int				  num;
-	int				  i;
-	buffer_garbage_t *garbage;
+	const int budget = R_GarbageBudget (&buffer_garbage);
+	const int blas_budget = R_GarbageBudget (&blas_garbage);
+	int		  num = 0;
+	TEMP_ALLOC (glheapallocation_t *, allocations, q_max (budget + blas_budget, 1));
 
-	current_garbage_index = (current_garbage_index + 1) % 2;
-	num = num_garbage_buffers[current_garbage_index];
-	for (i = 0; i < num; ++i)
+	buffer_garbage_t *garbage;
+	while ((num < budget) && ((garbage = R_PopGarbage (&buffer_garbage)) != NULL))
 	{
-		garbage = &buffer_garbage[i][current_garbage_index];
 		vkDestroyBuffer (vulkan_globals.device, garbage->buffer, NULL);
-		GL_HeapFree (mesh_buffer_heap, garbage->allocation, &num_vulkan_mesh_allocations);
 		if (garbage->desc_set != VK_NULL_HANDLE)
 			R_FreeDescriptorSet (garbage->desc_set, garbage->desc_set_layout);
+		allocations[num++] = garbage->allocation;
 	}
-	num_garbage_buffers[current_garbage_index] = 0;
 
-	// Process BLAS garbage
-	num = num_garbage_blas[current_garbage_index];
-	for (i = 0; i < num; ++i)
+	blas_garbage_t *blas_g;
+	while ((num < budget + blas_budget) && ((blas_g = R_PopGarbage (&blas_garbage)) != NULL))
 	{
-		blas_garbage_t *blas_g = &blas_garbage[i][current_garbage_index];
 		vulkan_globals.vk_destroy_acceleration_structure (vulkan_globals.device, blas_g->blas, NULL);
 		vkDestroyBuffer (vulkan_globals.device, blas_g->buffer, NULL);
-		GL_HeapFree (mesh_buffer_heap, blas_g->allocation, &num_vulkan_mesh_allocations);
+		Atomic_SubUInt64 (&vulkan_memory_category_sizes[VULKAN_MEMORY_CATEGORY_ACCELERATION_STRUCTURES], GL_HeapGetAllocationSize (blas_g->allocation));
+		allocations[num++] = blas_g->allocation;
 	}
-	num_garbage_blas[current_garbage_index] = 0;
+	GL_HeapFreeBatch (mesh_buffer_heap, allocations, num, &num_vulkan_mesh_allocations);
+
+	TEMP_FREE (allocations);
 }
 
 /*
@@ -209,7 +201,7 @@ void GL_MakeAliasModelDisplayLists (qmodel_t *m, aliashdr_t *paliashdr)
 	// there will always be this number of indexes
 	TEMP_ALLOC_ZEROED (unsigned short, indexes, maxverts_vbo);
 
-	hash_map_t *vertex_to_index_map = HashMap_Create (aliasmesh_t, unsigned short, &AliasMeshHash, NULL);
+	hash_map_t *vertex_to_index_map = HashMap_CreateOpen (aliasmesh_t, unsigned short, &AliasMeshHash, NULL);
 	HashMap_Reserve (vertex_to_index_map, maxverts_vbo);
 
 	ZEROED_STRUCT (aliasmesh_t, mesh);
@@ -315,6 +307,120 @@ void GLMesh_DeleteMeshBuffers (aliashdr_t *mainhdr)
 	}
 }
 
+/*
+================
+GLMesh_GetLODPosition
+
+Position of a vbo vertex in the first pose, only used to cluster vertices
+================
+*/
+static void GLMesh_GetLODPosition (aliashdr_t *hdr, const byte *vertexes, const aliasmesh_t *desc, int v, vec3_t pos)
+{
+	switch (hdr->poseverttype)
+	{
+	case PV_QUAKE1:
+	{
+		const trivertx_t *tv = (const trivertx_t *)vertexes + desc[v].vertindex;
+		pos[0] = tv->v[0];
+		pos[1] = tv->v[1];
+		pos[2] = tv->v[2];
+		break;
+	}
+	case PV_QUAKE3:
+	{
+		const md3XyzNormal_t *tv = (const md3XyzNormal_t *)vertexes + v;
+		pos[0] = tv->xyz[0];
+		pos[1] = tv->xyz[1];
+		pos[2] = tv->xyz[2];
+		break;
+	}
+	case PV_MD5:
+		VectorCopy (((const md5vert_t *)vertexes)[v].xyz, pos);
+		break;
+	default:
+		assert (false);
+	}
+}
+
+/*
+================
+GLMesh_BuildLODs
+
+Copies the full mesh indexes to lodindexes and appends simplified versions built by vertex clustering:
+the vertices of each cell of a grid over the first pose collapse to the first one found and the triangles
+that become degenerate are dropped. All poses keep sharing the vertex buffer. Returns the total index count.
+================
+*/
+static int GLMesh_BuildLODs (aliashdr_t *hdr, const unsigned short *indexes, const byte *vertexes, const aliasmesh_t *desc, unsigned short *lodindexes)
+{
+	static const int lod_grid_sizes[MAX_ALIAS_LODS] = {0, 16, 8};
+
+	memcpy (lodindexes, indexes, hdr->numindexes * sizeof (unsigned short));
+	int totalindexes = hdr->numindexes;
+
+	vec3_t mins = {FLT_MAX, FLT_MAX, FLT_MAX};
+	vec3_t maxs = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+	for (int v = 0; v < hdr->numverts_vbo; ++v)
+	{
+		vec3_t pos;
+		GLMesh_GetLODPosition (hdr, vertexes, desc, v, pos);
+		for (int k = 0; k < 3; ++k)
+		{
+			mins[k] = q_min (mins[k], pos[k]);
+			maxs[k] = q_max (maxs[k], pos[k]);
+		}
+	}
+	const float extent = q_max (maxs[0] - mins[0], q_max (maxs[1] - mins[1], maxs[2] - mins[2]));
+	if (extent <= 0.0f)
+		return totalindexes;
+
+	TEMP_ALLOC (int, cell_vertex, lod_grid_sizes[1] * lod_grid_sizes[1] * lod_grid_sizes[1]);
+	TEMP_ALLOC (unsigned short, remap, hdr->numverts_vbo);
+	for (int lod = 1; lod < MAX_ALIAS_LODS; ++lod)
+	{
+		const int	grid_size = lod_grid_sizes[lod];
+		const float cell_scale = (grid_size - 0.001f) / extent;
+		memset (cell_vertex, 0xff, grid_size * grid_size * grid_size * sizeof (int));
+		for (int v = 0; v < hdr->numverts_vbo; ++v)
+		{
+			vec3_t pos;
+			GLMesh_GetLODPosition (hdr, vertexes, desc, v, pos);
+			int cell = 0;
+			for (int k = 2; k >= 0; --k)
+				cell = cell * grid_size + (int)((pos[k] - mins[k]) * cell_scale);
+			if (cell_vertex[cell] < 0)
+				cell_vertex[cell] = v;
+			remap[v] = cell_vertex[cell];
+		}
+
+		const aliaslod_t *prev = &hdr->lods[hdr->numlods - 1];
+		aliaslod_t		 *cur = &hdr->lods[hdr->numlods];
+		cur->firstindex = totalindexes;
+		cur->numindexes = 0;
+		for (int i = 0; i < hdr->numindexes; i += 3)
+		{
+			const unsigned short a = remap[indexes[i + 0]];
+			const unsigned short b = remap[indexes[i + 1]];
+			const unsigned short c = remap[indexes[i + 2]];
+			if ((a == b) || (b == c) || (c == a))
+				continue;
+			lodindexes[cur->firstindex + cur->numindexes++] = a;
+			lodindexes[cur->firstindex + cur->numindexes++] = b;
+			lodindexes[cur->firstindex + cur->numindexes++] = c;
+		}
+
+		// not worth a level if it barely saves anything
+		if ((cur->numindexes == 0) || (cur->numindexes > prev->numindexes * 3 / 4))
+			break;
+		totalindexes += cur->numindexes;
+		++hdr->numlods;
+	}
+	TEMP_FREE (remap);
+	TEMP_FREE (cell_vertex);
+
+	return totalindexes;
+}
+
 /*
 ================
 GLMesh_UploadBuffers : Upload data for a single aliashdr_t *hdr (not it's nextsurfaces)
@@ -361,6 +467,10 @@ void GLMesh_UploadBuffers (qmodel_t *mod, aliashdr_t *hdr, unsigned short *index
 
 	const size_t totaljointssize = hdr->numframes * hdr->numjoints * sizeof (jointpose_t);
 
+	hdr->numlods = 1;
+	hdr->lods[0].firstindex = 0;
+	hdr->lods[0].numindexes = numindexes;
+
 	if (hdr->poseverttype == PV_QUAKE1 || hdr->poseverttype == PV_QUAKE3)
 	{
 		// reserve room from ST data starting at vbostofs.
@@ -376,7 +486,8 @@ void GLMesh_UploadBuffers (qmodel_t *mod, aliashdr_t *hdr, unsigned short *index
 		return;
 
 	{
-		const size_t totalindexsize = numindexes * sizeof (unsigned short);
+		TEMP_ALLOC (unsigned short, lodindexes, numindexes * MAX_ALIAS_LODS);
+		const size_t totalindexsize = GLMesh_BuildLODs (hdr, indexes, vertexes, desc, lodindexes) * sizeof (unsigned short);
 
 		// Allocate index buffer & upload to GPU
 		ZEROED_STRUCT (VkBufferCreateInfo, buffer_create_info);
@@ -400,7 +511,8 @@ void GLMesh_UploadBuffers (qmodel_t *mod, aliashdr_t *hdr, unsigned short *index
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkBindBufferMemory failed");
 
-		R_StagingUploadBuffer (hdr->index_buffer, totalindexsize, (byte *)indexes);
+		R_StagingUploadBuffer (hdr->index_buffer, totalindexsize, (byte *)lodindexes);
+		TEMP_FREE (lodindexes);
 
 		// Get device address for ray tracing
 		if (vulkan_globals.ray_query)
@@ -703,6 +815,7 @@ void R_AllocateEntityBLAS (entity_t *e)
 	vkGetBufferMemoryRequirements (vulkan_globals.device, e->blas_data->buffer, &memory_requirements);
 
 	e->blas_data->allocation = GL_HeapAllocate (mesh_buffer_heap, memory_requirements.size, memory_requirements.alignment, &num_vulkan_mesh_allocations);
+	Atomic_AddUInt64 (&vulkan_memory_category_sizes[VULKAN_MEMORY_CATEGORY_ACCELERATION_STRUCTURES], GL_HeapGetAllocationSize (e->blas_data->allocation));
 	err = vkBindBufferMemory (
 		vulkan_globals.device, e->blas_data->buffer, GL_HeapGetAllocationMemory (e->blas_data->allocation),
 		GL_HeapGetAllocationOffset (e->blas_data->allocation));
@@ -788,6 +901,32 @@ static VkAccelerationStructureGeometryKHR			   pending_geometries[MAX_PENDING_BL
 static VkAccelerationStructureBuildGeometryInfoKHR	   pending_build_infos[MAX_PENDING_BLAS_BUILDS];
 static VkAccelerationStructureBuildRangeInfoKHR		   pending_range_infos[MAX_PENDING_BLAS_BUILDS];
 static const VkAccelerationStructureBuildRangeInfoKHR *pending_range_info_ptrs[MAX_PENDING_BLAS_BUILDS];
+static mesh_interpolate_params_t					   pending_interpolate_params[MAX_PENDING_BLAS_BUILDS];
+static skinning_params_t							   pending_skinning_params[MAX_PENDING_BLAS_BUILDS];
+
+/*
+================
+R_DispatchPendingMeshParams
+
+Uploads the per-entity params and issues a single dispatch for all of them.
+Workgroup Y selects the entity, X the vertex range. Groups past an entity's
+vertex count exit early.
+================
+*/
+static void R_DispatchPendingMeshParams (
+	cb_context_t *cbx, vulkan_pipeline_t pipeline, const void *params, size_t params_size, int num_params, uint32_t max_verts)
+{
+	if (num_params == 0)
+		return;
+
+	VkDeviceAddress params_address;
+	byte		   *data = R_StorageAllocate (num_params * params_size, NULL, NULL, &params_address);
+	memcpy (data, params, num_params * params_size);
+
+	R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+	R_PushConstants (cbx, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof (params_address), &params_address);
+	vulkan_globals.vk_cmd_dispatch (cbx->cb, (max_verts + 63) / 64, num_params, 1);
+}
 
 /*
 ================
@@ -849,6 +988,10 @@ void R_UpdateAnimatedBLASes (cb_context_t *cbx)
 
 	VkDeviceSize scratch_offset = 0;
 	int			 num_pending = 0;
+	int			 num_interpolate = 0;
+	int			 num_skinning = 0;
+	uint32_t	 max_interpolate_verts = 0;
+	uint32_t	 max_skinning_verts = 0;
 	int			 entity_index = 0;
 	const int	 total_entities = cl.num_entities + cl.num_statics;
 
@@ -877,16 +1020,23 @@ void R_UpdateAnimatedBLASes (cb_context_t *cbx)
 			if (e->blas_data->model != e->model)
 				continue;
 
-			// Get lerp data for vertex interpolation
-			lerpdata_t lerpdata;
-			R_SetupAliasFrame (e, hdr, e->frame, &lerpdata);
+			// Get lerp data for vertex interpolation, reusing this frame's render state for visible entities
+			lerpdata_t					 lerpdata;
+			const entity_render_state_t *state = R_GetEntityRenderState (e);
+			if (state)
+				lerpdata = state->lerpdata;
+			else
+				R_SetupAliasFrame (e, hdr, e->frame, &lerpdata);
 			int	  pose1 = lerpdata.pose1;
 			int	  pose2 = lerpdata.pose2;
 			float blend = lerpdata.blend;
 
 			// Always use refit after first build. We trace few rays and full updates are expensive.
 			qboolean use_update = !e->blas_data->needs_initial_build;
-			e->blas_data->needs_initial_build = false;
+
+			// Nothing to do if the BLAS already holds this exact pose
+			if (use_update && (pose1 == e->blas_data->built_pose1) && (pose2 == e->blas_data->built_pose2) && (blend == e->blas_data->built_blend))
+				continue;
 
 			// Calculate space needed with proper alignments:
 			// - Position buffer needs buffer_alignment (for storage buffer access)
@@ -915,11 +1065,16 @@ void R_UpdateAnimatedBLASes (cb_context_t *cbx)
 			VkDeviceAddress vertex_output_address = vulkan_globals.scratch_buffer_address + vertex_offset;
 			VkDeviceAddress scratch_address = vulkan_globals.scratch_buffer_address + as_scratch_offset;
 
-			// Dispatch compute shader with push constants containing buffer addresses
+			e->blas_data->needs_initial_build = false;
+			e->blas_data->built_pose1 = pose1;
+			e->blas_data->built_pose2 = pose2;
+			e->blas_data->built_blend = blend;
+
+			// Queue compute params, dispatched for the whole batch before the builds
 			if (hdr->poseverttype == PV_MD5)
 			{
 				// MD5 skinning
-				skinning_push_constants_t pc = {
+				pending_skinning_params[num_skinning++] = (skinning_params_t){
 					.input_address = hdr->vertex_buffer_address,
 					.joints_address = hdr->joints_buffer_address,
 					.output_address = vertex_output_address,
@@ -929,13 +1084,12 @@ void R_UpdateAnimatedBLASes (cb_context_t *cbx)
 					.num_verts = hdr->numverts_vbo,
 					.blend_factor = blend,
 				};
-				R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_COMPUTE, vulkan_globals.skinning_pipeline);
-				R_PushConstants (cbx, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof (pc), &pc);
+				max_skinning_verts = q_max (max_skinning_verts, (uint32_t)hdr->numverts_vbo);
 			}
 			else
 			{
 				// MDL/MD3 interpolation
-				mesh_interpolate_push_constants_t pc = {
+				pending_interpolate_params[num_interpolate++] = (mesh_interpolate_params_t){
 					.input_address = hdr->vertex_buffer_address,
 					.output_address = vertex_output_address,
 					.pose1_offset = pose1 * hdr->numverts_vbo,
@@ -945,13 +1099,9 @@ void R_UpdateAnimatedBLASes (cb_context_t *cbx)
 					.blend_factor = blend,
 					.flags = (hdr->poseverttype == PV_QUAKE3) ? 0x4 : 0,
 				};
-				R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_COMPUTE, vulkan_globals.mesh_interpolate_pipeline);
-				R_PushConstants (cbx, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof (pc), &pc);
+				max_interpolate_verts = q_max (max_interpolate_verts, (uint32_t)hdr->numverts_vbo);
 			}
 
-			uint32_t num_groups = (hdr->numverts_vbo + 63) / 64;
-			vulkan_globals.vk_cmd_dispatch (cbx->cb, num_groups, 1, 1);
-
 			// Store build info for later
 			VkAccelerationStructureGeometryKHR *geom = &pending_geometries[num_pending];
 			memset (geom, 0, sizeof (*geom));
@@ -994,12 +1144,22 @@ void R_UpdateAnimatedBLASes (cb_context_t *cbx)
 			scratch_offset += total_needed;
 		}
 
-		// Phase 2: Build - flush pending builds
+		// Phase 2: Build - dispatch the batched compute work, then flush pending builds
 		if (num_pending > 0)
 		{
+			R_DispatchPendingMeshParams (
+				cbx, vulkan_globals.mesh_interpolate_pipeline, pending_interpolate_params, sizeof (mesh_interpolate_params_t), num_interpolate,
+				max_interpolate_verts);
+			R_DispatchPendingMeshParams (
+				cbx, vulkan_globals.skinning_pipeline, pending_skinning_params, sizeof (skinning_params_t), num_skinning, max_skinning_verts);
+
 			qboolean more_entities = (entity_index < total_entities);
 			R_FlushPendingBLASBuilds (cbx, num_pending, more_entities);
 			num_pending = 0;
+			num_interpolate = 0;
+			num_skinning = 0;
+			max_interpolate_verts = 0;
+			max_skinning_verts = 0;
 			scratch_offset = 0;
 		}
 	}
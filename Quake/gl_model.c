@@ -26,6 +26,10 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "quakedef.h"
 
+#if defined(USE_NEON)
+#include <arm_neon.h>
+#endif
+
 static void		 Mod_LoadSpriteModel (qmodel_t *mod, void *buffer);
 static void		 Mod_LoadBrushModel (qmodel_t *mod, const char *loadname, void *buffer);
 static void		 Mod_LoadAliasModel (qmodel_t *mod, void *buffer);
@@ -50,12 +54,42 @@ cvar_t r_allow_replacement_md3models = {"r_allow_replacement_md3models", "1", CV
 
 cvar_t r_enhancedmodels = {"r_enhancedmodels", "1", CVAR_ARCHIVE}; // controlled in Menu with Models: enhanced (1) / classic (0)
 
+// r_bspcache = 1 keep the derived brush model data in <gamedir>/cache so reloading a map skips recomputing it, 0 to always recompute.
+cvar_t r_bspcache = {"r_bspcache", "1", CVAR_ARCHIVE};
+
+// r_spriteatlas = 1 pack the small frames of a sprite into a single texture, 0 to give every frame its own texture.
+cvar_t r_spriteatlas = {"r_spriteatlas", "1", CVAR_ARCHIVE};
+
+// r_md5cache = 1 keep the cooked md5 models in <gamedir>/cache so they load without parsing, 0 to always parse the text files.
+cvar_t r_md5cache = {"r_md5cache", "1", CVAR_ARCHIVE};
+
+// pvs_matrix = 1 keep every decompressed pvs row of maps small enough, 0 to only keep the most recently used rows.
+cvar_t pvs_matrix = {"pvs_matrix", "1", CVAR_NONE};
+
 static byte *mod_novis;
 static int	 mod_novis_capacity;
 
 static byte *mod_decompressed;
 static int	 mod_decompressed_capacity;
 
+#define PVS_CACHE_ROWS		64
+#define PVS_MATRIX_MAX_SIZE (32 * 1024 * 1024)
+
+// decompressed pvs rows of a world model, shared by the server and the client
+typedef struct pvs_cache_s
+{
+	int		  numleafs;
+	int		  rowbytes;
+	int		  rowstride; // rows are 4 byte aligned for the callers that read them as uint32_t
+	qboolean  matrix;
+	byte	 *rows;			// matrix: numleafs + 1 rows, otherwise PVS_CACHE_ROWS rows
+	uint32_t *decompressed; // matrix: bit per leaf whose row is filled
+	int		 *slots;		// lru: row of each leaf or -1
+	int		  slot_leafs[PVS_CACHE_ROWS];
+	uint32_t  slot_used[PVS_CACHE_ROWS];
+	uint32_t  clock;
+} pvs_cache_t;
+
 qmodel_t mod_known[MAX_MODELS];
 int		 mod_numknown;
 
@@ -123,6 +157,10 @@ void Mod_Init (void)
 	Cvar_RegisterVariable (&r_allow_replacement_md5models);
 	Cvar_RegisterVariable (&r_allow_replacement_md3models);
 	Cvar_RegisterVariable (&r_enhancedmodels);
+	Cvar_RegisterVariable (&r_bspcache);
+	Cvar_RegisterVariable (&pvs_matrix);
+	Cvar_RegisterVariable (&r_md5cache);
+	Cvar_RegisterVariable (&r_spriteatlas);
 	Cvar_SetCallback (&r_enhancedmodels, Mod_RefreshSkins_f);
 
 	// johnfitz -- create notexture miptex
@@ -257,35 +295,24 @@ mleaf_t *Mod_PointInLeaf (float *p, qmodel_t *model)
 
 /*
 ===================
-Mod_DecompressVis
+Mod_DecompressVisRow
+
+Decompresses one pvs row of (numleafs + 31) / 8 bytes into out
 ===================
 */
-byte *Mod_DecompressVis (byte *in, qmodel_t *model)
+void Mod_DecompressVisRow (byte *in, qmodel_t *model, byte *out)
 {
-	int	  c;
-	byte *out;
-	byte *outend;
-	int	  row;
+	int			c;
+	byte	   *outend;
+	byte *const outstart = out;
+	const int	row = (model->numleafs + 31) / 8;
 
-	row = (model->numleafs + 31) / 8;
-	if (mod_decompressed == NULL || row > mod_decompressed_capacity)
-	{
-		mod_decompressed_capacity = row;
-		mod_decompressed = (byte *)Mem_Realloc (mod_decompressed, mod_decompressed_capacity);
-		if (!mod_decompressed)
-			Sys_Error ("Mod_DecompressVis: realloc() failed on %d bytes", mod_decompressed_capacity);
-	}
-	out = mod_decompressed;
-	outend = mod_decompressed + row;
+	outend = out + row;
 
 	if (!in)
 	{ // no vis info, so make all visible
-		while (row)
-		{
-			*out++ = 0xff;
-			row--;
-		}
-		return mod_decompressed;
+		memset (out, 0xff, row);
+		return;
 	}
 
 	do
@@ -298,10 +325,9 @@ byte *Mod_DecompressVis (byte *in, qmodel_t *model)
 
 		c = in[1];
 		in += 2;
-		if (c > row - (out - mod_decompressed))
-			c = row -
-				(out -
-				 mod_decompressed); // now that we're dynamically allocating pvs buffers, we have to be more careful to avoid heap overflows with buggy maps.
+		// now that we're dynamically allocating pvs buffers, we have to be more careful to avoid heap overflows with buggy maps.
+		if (c > row - (out - outstart))
+			c = row - (out - outstart);
 		while (c)
 		{
 			if (out == outend)
@@ -311,16 +337,138 @@ byte *Mod_DecompressVis (byte *in, qmodel_t *model)
 					model->viswarn = true;
 					Con_Warning ("Mod_DecompressVis: output overrun on model \"%s\"\n", model->name);
 				}
-				return mod_decompressed;
+				return;
 			}
 			*out++ = 0;
 			c--;
 		}
-	} while (out - mod_decompressed < row);
+	} while (out - outstart < row);
+}
+
+/*
+===================
+Mod_DecompressVis
+===================
+*/
+byte *Mod_DecompressVis (byte *in, qmodel_t *model)
+{
+	int row;
 
+	row = (model->numleafs + 31) / 8;
+	if (mod_decompressed == NULL || row > mod_decompressed_capacity)
+	{
+		mod_decompressed_capacity = row;
+		mod_decompressed = (byte *)Mem_Realloc (mod_decompressed, mod_decompressed_capacity);
+		if (!mod_decompressed)
+			Sys_Error ("Mod_DecompressVis: realloc() failed on %d bytes", mod_decompressed_capacity);
+	}
+
+	Mod_DecompressVisRow (in, model, mod_decompressed);
 	return mod_decompressed;
 }
 
+/*
+===================
+Mod_CreatePVSCache
+
+Maps whose whole pvs fits in PVS_MATRIX_MAX_SIZE keep every row once it has been
+decompressed, bigger ones keep the PVS_CACHE_ROWS most recently used rows
+===================
+*/
+static pvs_cache_t *Mod_CreatePVSCache (qmodel_t *model)
+{
+	pvs_cache_t *cache = (pvs_cache_t *)Mem_Alloc (sizeof (pvs_cache_t));
+	int			 i;
+
+	cache->numleafs = model->numleafs;
+	cache->rowbytes = (model->numleafs + 31) / 8;
+	cache->rowstride = (cache->rowbytes + 3) & ~3;
+	cache->matrix = pvs_matrix.value && ((size_t)cache->rowstride * (cache->numleafs + 1) <= PVS_MATRIX_MAX_SIZE);
+
+	// leafs are 1 based, leaf 0 is the solid leaf
+	if (cache->matrix)
+	{
+		cache->rows = (byte *)Mem_AllocNonZero ((size_t)cache->rowstride * (cache->numleafs + 1));
+		cache->decompressed = (uint32_t *)Mem_Alloc (((cache->numleafs + 32) / 32) * sizeof (uint32_t));
+	}
+	else
+	{
+		cache->rows = (byte *)Mem_AllocNonZero ((size_t)cache->rowstride * PVS_CACHE_ROWS);
+		cache->slots = (int *)Mem_AllocNonZero ((cache->numleafs + 1) * sizeof (int));
+		for (i = 0; i <= cache->numleafs; i++)
+			cache->slots[i] = -1;
+		for (i = 0; i < PVS_CACHE_ROWS; i++)
+			cache->slot_leafs[i] = -1;
+	}
+
+	return cache;
+}
+
+/*
+===================
+Mod_FreePVSCache
+===================
+*/
+static void Mod_FreePVSCache (qmodel_t *model)
+{
+	pvs_cache_t *cache = model->pvs_cache;
+
+	if (!cache)
+		return;
+	Mem_Free (cache->rows);
+	Mem_Free (cache->decompressed);
+	Mem_Free (cache->slots);
+	Mem_Free (cache);
+	model->pvs_cache = NULL;
+}
+
+/*
+===================
+Mod_CachedPVS
+===================
+*/
+static byte *Mod_CachedPVS (mleaf_t *leaf, qmodel_t *model)
+{
+	pvs_cache_t *cache = model->pvs_cache;
+	const int	 leafnum = leaf - model->leafs;
+	int			 slot, i;
+	byte		*row;
+
+	if (!cache || cache->numleafs != model->numleafs)
+	{
+		Mod_FreePVSCache (model);
+		cache = model->pvs_cache = Mod_CreatePVSCache (model);
+	}
+
+	if (cache->matrix)
+	{
+		row = cache->rows + (size_t)cache->rowstride * leafnum;
+		if (!(cache->decompressed[leafnum / 32] & (1u << (leafnum % 32))))
+		{
+			Mod_DecompressVisRow (leaf->compressed_vis, model, row);
+			cache->decompressed[leafnum / 32] |= 1u << (leafnum % 32);
+		}
+		return row;
+	}
+
+	slot = cache->slots[leafnum];
+	if (slot < 0)
+	{
+		// evict the least recently used row
+		slot = 0;
+		for (i = 1; i < PVS_CACHE_ROWS; i++)
+			if (cache->slot_used[i] < cache->slot_used[slot])
+				slot = i;
+		if (cache->slot_leafs[slot] >= 0)
+			cache->slots[cache->slot_leafs[slot]] = -1;
+		cache->slot_leafs[slot] = leafnum;
+		cache->slots[leafnum] = slot;
+		Mod_DecompressVisRow (leaf->compressed_vis, model, cache->rows + (size_t)cache->rowstride * slot);
+	}
+	cache->slot_used[slot] = ++cache->clock;
+	return cache->rows + (size_t)cache->rowstride * slot;
+}
+
 /*
 ===================
 Mod_LeafPVS
@@ -330,7 +478,9 @@ byte *Mod_LeafPVS (mleaf_t *leaf, qmodel_t *model)
 {
 	if (leaf == model->leafs)
 		return Mod_NoVisPVS (model);
-	return Mod_DecompressVis (leaf->compressed_vis, model);
+	if (model->name[0] == '*' || leaf < model->leafs || leaf > model->leafs + model->numleafs)
+		return Mod_DecompressVis (leaf->compressed_vis, model);
+	return Mod_CachedPVS (leaf, model);
 }
 
 /*
@@ -378,6 +528,7 @@ static void Mod_FreeSpriteMemory (msprite_t *psprite)
 		}
 	}
 	psprite->numframes = 0;
+	SAFE_FREE (psprite->atlas);
 }
 
 /*
@@ -422,14 +573,17 @@ static void Mod_FreeModelMemory (qmodel_t *mod)
 		SAFE_FREE (mod->soa_leafbounds);
 		SAFE_FREE (mod->surfvis);
 		SAFE_FREE (mod->soa_surfplanes);
+		SAFE_FREE (mod->soa_surfbounds);
 		SAFE_FREE (mod->textures);
 		mod->numtextures = 0;
 		SAFE_FREE (mod->visdata);
+		Mod_FreePVSCache (mod);
 		SAFE_FREE (mod->lightdata);
 		SAFE_FREE (mod->entities);
 		for (int i = 0; i < PV_SIZE; ++i)
 			SAFE_FREE (mod->extradata[i]);
 		SAFE_FREE (mod->water_surfs);
+		SAFE_FREE (mod->fat_pvs);
 		mod->used_water_surfs = 0;
 		mod->water_surfs_specials = 0;
 	}
@@ -451,9 +605,11 @@ void Mod_ClearAll (void)
 	qmodel_t *mod;
 	GL_DeleteBModelAccelerationStructures ();
 
+	// alias models and sprites don't depend on the map, keep them loaded
+	// for the next one along with their textures and mesh buffers
 	for (i = 0, mod = mod_known; i < mod_numknown; i++, mod++)
 	{
-		if (mod->type != mod_alias)
+		if (mod->type != mod_alias && mod->type != mod_sprite)
 		{
 			mod->needload = true;
 			Mod_FreeModelMemory (mod); // johnfitz
@@ -536,18 +692,28 @@ void Mod_TouchModel (const char *name)
 
 /*
 ==================
-Mod_LoadModel
+Mod_PrefetchModel
+
+Queues the file of a model that still needs loading for COM_StartPrefetch
+==================
+*/
+void Mod_PrefetchModel (const char *name)
+{
+	if (name[0] != '*' && Mod_FindName (name)->needload)
+		COM_PrefetchFile (name);
+}
+
+/*
+==================
+Mod_LoadModelFile
 
 Loads a model into the cache
 ==================
 */
-static qmodel_t *Mod_LoadModel (qmodel_t *mod, qboolean crash)
+static qmodel_t *Mod_LoadModelFile (qmodel_t *mod, qboolean crash)
 {
 	int mod_type;
 
-	if (!mod->needload)
-		return mod;
-
 	InvalidateTraceLineCache ();
 
 	if (mod->type == mod_alias)
@@ -567,8 +733,11 @@ static qmodel_t *Mod_LoadModel (qmodel_t *mod, qboolean crash)
 
 	char md3_name[MAX_QPATH], md5_name[MAX_QPATH];
 
-	// 1. Load the original model buffer:
-	buf = COM_LoadFile (mod->name, &mod->path_id);
+	// 1. Load the original model buffer, binary formats are parsed straight from the pak when it's mapped:
+	if (strcmp (COM_FileGetExtension (mod->name), "md5mesh") != 0)
+		buf = (byte *)COM_LoadFileView (mod->name, &mod->path_id);
+	else
+		buf = COM_LoadFile (mod->name, &mod->path_id);
 
 	if (!buf)
 	{
@@ -691,7 +860,25 @@ static qmodel_t *Mod_LoadModel (qmodel_t *mod, qboolean crash)
 	break;
 	}
 
-	Mem_Free (buf);
+	COM_FreeFileView (buf);
+	return mod;
+}
+
+/*
+==================
+Mod_LoadModel
+
+Attributes everything the load allocates to the model tag
+==================
+*/
+static qmodel_t *Mod_LoadModel (qmodel_t *mod, qboolean crash)
+{
+	if (!mod->needload)
+		return mod;
+
+	const mem_tag_t prev_tag = Mem_SetThreadTag (MEM_TAG_MODEL);
+	mod = Mod_LoadModelFile (mod, crash);
+	Mem_SetThreadTag (prev_tag);
 	return mod;
 }
 
@@ -867,9 +1054,23 @@ Mod_CheckFullbrights -- johnfitz
 */
 qboolean Mod_CheckFullbrights (byte *pixels, int count)
 {
-	int i;
-	for (i = 0; i < count; i++)
-		if (*pixels++ > 223)
+	int i = 0;
+#if defined(USE_SSE2)
+	// saturating subtract leaves a non zero byte for every index above 223
+	const __m128i threshold = _mm_set1_epi8 ((char)223);
+	for (; i + 16 <= count; i += 16)
+	{
+		const __m128i above = _mm_subs_epu8 (_mm_loadu_si128 ((const __m128i *)(pixels + i)), threshold);
+		if (_mm_movemask_epi8 (_mm_cmpeq_epi8 (above, _mm_setzero_si128 ())) != 0xFFFF)
+			return true;
+	}
+#elif defined(USE_NEON)
+	for (; i + 16 <= count; i += 16)
+		if (vmaxvq_u8 (vld1q_u8 (pixels + i)) > 223)
+			return true;
+#endif
+	for (; i < count; i++)
+		if (pixels[i] > 223)
 			return true;
 	return false;
 }
@@ -906,6 +1107,17 @@ qboolean Mod_CheckAnimTextureArrayQ64 (texture_t *anims[], int numTex)
 	return true;
 }
 
+/*
+=================
+Mod_LoadExternalTexture -- prefers pre-compressed ktx2/dds files the device can sample over the decoded formats
+=================
+*/
+static byte *Mod_LoadExternalTexture (const char *name, int *width, int *height, enum srcformat *fmt, unsigned int path_id)
+{
+	byte *data = Image_LoadCompressedImage (name, width, height, fmt, path_id);
+	return data ? data : Image_LoadImage (name, width, height, fmt, path_id);
+}
+
 /*
 =================
 Mod_LoadTextureTask
@@ -983,11 +1195,11 @@ static void Mod_LoadTextureTask (int i, qmodel_t **ppmod)
 		COM_StripExtension (mod->name + 5, mapname, sizeof (mapname));
 		q_snprintf (filename, sizeof (filename), "textures/%s/%s", mapname, tx->name);
 		enum srcformat fmt = SRC_RGBA;
-		data = Image_LoadImage (filename, &fwidth, &fheight, &fmt, mod->path_id);
+		data = Mod_LoadExternalTexture (filename, &fwidth, &fheight, &fmt, mod->path_id);
 		if (!data)
 		{
 			q_snprintf (filename, sizeof (filename), "textures/%s", tx->name);
-			data = Image_LoadImage (filename, &fwidth, &fheight, &fmt, mod->path_id);
+			data = Mod_LoadExternalTexture (filename, &fwidth, &fheight, &fmt, mod->path_id);
 		}
 
 		// now load whatever we found
@@ -995,20 +1207,20 @@ static void Mod_LoadTextureTask (int i, qmodel_t **ppmod)
 		{
 			char filename2[MAX_OSPATH];
 
-			tx->gltexture = TexMgr_LoadImage (mod, filename, fwidth, fheight, fmt, data, filename, 0, TEXPREF_MIPMAP | extraflags);
+			tx->gltexture = TexMgr_LoadImage (mod, filename, fwidth, fheight, fmt, data, filename, 0, TEXPREF_MIPMAP | TEXPREF_STREAM | extraflags);
 			Mem_Free (data);
 
 			// now try to load glow/luma image from the same place
 			q_snprintf (filename2, sizeof (filename2), "%s_glow", filename);
-			data = Image_LoadImage (filename2, &fwidth, &fheight, &fmt, mod->path_id);
+			data = Mod_LoadExternalTexture (filename2, &fwidth, &fheight, &fmt, mod->path_id);
 			if (!data)
 			{
 				q_snprintf (filename2, sizeof (filename2), "%s_luma", filename);
-				data = Image_LoadImage (filename2, &fwidth, &fheight, &fmt, mod->path_id);
+				data = Mod_LoadExternalTexture (filename2, &fwidth, &fheight, &fmt, mod->path_id);
 			}
 
 			if (data)
-				tx->fullbright = TexMgr_LoadImage (mod, filename2, fwidth, fheight, fmt, data, filename2, 0, TEXPREF_MIPMAP | extraflags);
+				tx->fullbright = TexMgr_LoadImage (mod, filename2, fwidth, fheight, fmt, data, filename2, 0, TEXPREF_MIPMAP | TEXPREF_STREAM | extraflags);
 		}
 		else // use the texture from the bsp file
 		{
@@ -1727,6 +1939,173 @@ static void Mod_PolyForUnlitSurface (qmodel_t *mod, msurface_t *fa)
 	}
 }
 
+/*
+==============================================================================
+
+BSP CACHE
+
+Results of the expensive per surface and per leaf passes are stored next to
+the game data, keyed by a hash of the whole bsp file. A stale or truncated
+cache is rejected and rewritten.
+
+==============================================================================
+*/
+
+#define BSPCACHE_MAGIC	 (('C' << 24) + ('P' << 16) + ('S' << 8) + 'B')
+#define BSPCACHE_VERSION 1
+
+typedef struct
+{
+	int		 magic;
+	int		 version;
+	uint64_t hash;
+	int		 numsurfaces;
+	int		 numleafs;
+	int		 contentstransparent; // -1 if Mod_CheckWaterVis results are not stored
+	int		 padding;
+} bspcache_header_t;
+
+typedef struct
+{
+	short texturemins[2];
+	short extents[2];
+} bspcache_surface_t;
+
+typedef struct
+{
+	bspcache_header_t	header;
+	bspcache_surface_t *surfaces;
+} bspcache_t;
+
+/*
+=================
+Mod_HashBuffer
+
+64 bit hash of file contents for the model caches, 8 bytes at a time
+=================
+*/
+static uint64_t Mod_HashBuffer (const byte *data, size_t size)
+{
+	const uint64_t prime = 0x9E3779B97F4A7C15ull;
+	uint64_t	   hash = size * prime;
+	uint64_t	   word;
+	size_t		   i;
+
+	for (i = 0; i + sizeof (word) <= size; i += sizeof (word))
+	{
+		memcpy (&word, data + i, sizeof (word));
+		hash ^= word * prime;
+		hash = ((hash << 31) | (hash >> 33)) * 0xC2B2AE3D27D4EB4Full;
+	}
+	for (word = 0; i < size; i++)
+		word = (word << 8) | data[i];
+	hash ^= word * prime;
+
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDull;
+	hash ^= hash >> 33;
+	return hash;
+}
+
+/*
+=================
+Mod_CachePath
+=================
+*/
+static void Mod_CachePath (qmodel_t *mod, const char *extension, char *path, size_t size)
+{
+	char name[MAX_QPATH];
+
+	COM_StripExtension (mod->name, name, sizeof (name));
+	q_snprintf (path, size, "%s/cache/%s.%s", com_gamedir, name, extension);
+}
+
+/*
+=================
+Mod_ReadBSPCache
+=================
+*/
+static qboolean Mod_ReadBSPCache (qmodel_t *mod, uint64_t hash, bspcache_t *cache)
+{
+	char  path[MAX_OSPATH];
+	FILE *f;
+
+	memset (cache, 0, sizeof (*cache));
+	if (!r_bspcache.value || isDedicated)
+		return false;
+
+	Mod_CachePath (mod, "bspc", path, sizeof (path));
+	f = fopen (path, "rb");
+	if (!f)
+		return false;
+
+	if (fread (&cache->header, sizeof (cache->header), 1, f) != 1 || cache->header.magic != BSPCACHE_MAGIC || cache->header.version != BSPCACHE_VERSION ||
+		cache->header.hash != hash || cache->header.numsurfaces <= 0 || cache->header.numleafs < 0)
+	{
+		fclose (f);
+		return false;
+	}
+
+	cache->surfaces = (bspcache_surface_t *)Mem_AllocNonZero (cache->header.numsurfaces * sizeof (bspcache_surface_t));
+	if (fread (cache->surfaces, sizeof (bspcache_surface_t), cache->header.numsurfaces, f) != (size_t)cache->header.numsurfaces)
+	{
+		Con_DPrintf ("%s is truncated, ignoring it\n", path);
+		Mem_Free (cache->surfaces);
+		cache->surfaces = NULL;
+		fclose (f);
+		return false;
+	}
+
+	fclose (f);
+	return true;
+}
+
+/*
+=================
+Mod_WriteBSPCache
+=================
+*/
+static void Mod_WriteBSPCache (qmodel_t *mod, uint64_t hash, qboolean watervis)
+{
+	char			   path[MAX_OSPATH];
+	FILE			  *f;
+	bspcache_header_t  header;
+	bspcache_surface_t surf;
+	int				   i;
+
+	if (!r_bspcache.value || isDedicated || mod->numsurfaces <= 0)
+		return;
+
+	Mod_CachePath (mod, "bspc", path, sizeof (path));
+	COM_CreatePath (path);
+	f = fopen (path, "wb");
+	if (!f)
+	{
+		Con_DPrintf ("Couldn't write %s\n", path);
+		return;
+	}
+
+	memset (&header, 0, sizeof (header));
+	header.magic = BSPCACHE_MAGIC;
+	header.version = BSPCACHE_VERSION;
+	header.hash = hash;
+	header.numsurfaces = mod->numsurfaces;
+	header.numleafs = mod->numleafs;
+	header.contentstransparent = watervis ? mod->contentstransparent : -1;
+	fwrite (&header, sizeof (header), 1, f);
+
+	for (i = 0; i < mod->numsurfaces; i++)
+	{
+		surf.texturemins[0] = mod->surfaces[i].texturemins[0];
+		surf.texturemins[1] = mod->surfaces[i].texturemins[1];
+		surf.extents[0] = mod->surfaces[i].extents[0];
+		surf.extents[1] = mod->surfaces[i].extents[1];
+		fwrite (&surf, sizeof (surf), 1, f);
+	}
+
+	fclose (f);
+}
+
 /*
 ================
 Mod_CalcSurfaceExtents
@@ -1743,7 +2122,7 @@ static void Mod_CalcSurfaceExtentsTask (int surfnum, qmodel_t **mod_ptr)
 Mod_LoadFaces
 =================
 */
-static void Mod_LoadFaces (qmodel_t *mod, byte *mod_base, lump_t *l, qboolean bsp2)
+static void Mod_LoadFaces (qmodel_t *mod, byte *mod_base, lump_t *l, qboolean bsp2, const bspcache_t *cache)
 {
 	byte	   *ins;
 	byte	   *inl;
@@ -1903,7 +2282,17 @@ static void Mod_LoadFaces (qmodel_t *mod, byte *mod_base, lump_t *l, qboolean bs
 		// johnfitz
 	}
 
-	if (!isDedicated)
+	if (cache->surfaces && cache->header.numsurfaces == count)
+	{
+		for (i = 0; i < count; i++)
+		{
+			mod->surfaces[i].texturemins[0] = cache->surfaces[i].texturemins[0];
+			mod->surfaces[i].texturemins[1] = cache->surfaces[i].texturemins[1];
+			mod->surfaces[i].extents[0] = cache->surfaces[i].extents[0];
+			mod->surfaces[i].extents[1] = cache->surfaces[i].extents[1];
+		}
+	}
+	else if (!isDedicated)
 	{
 		if (!Tasks_IsWorker () && (count > 1))
 		{
@@ -2131,7 +2520,7 @@ static void Mod_ProcessLeafs_S (qmodel_t *mod, byte *in, int filelen)
 			out->compressed_vis = NULL;
 		else
 			out->compressed_vis = (mod->visdata != NULL) ? (mod->visdata + p) : NULL;
-		out->efrags = NULL;
+		out->numefrags = 0;
 
 		for (j = 0; j < 4; j++)
 			out->ambient_sound_level[j] = *(in + offsetof (dsleaf_t, ambient_level[j]));
@@ -2174,7 +2563,7 @@ static void Mod_ProcessLeafs_L1 (qmodel_t *mod, byte *in, int filelen)
 			out->compressed_vis = NULL;
 		else
 			out->compressed_vis = mod->visdata + p;
-		out->efrags = NULL;
+		out->numefrags = 0;
 
 		for (j = 0; j < 4; j++)
 			out->ambient_sound_level[j] = *(in + offsetof (dl1leaf_t, ambient_level[j]));
@@ -2217,7 +2606,7 @@ static void Mod_ProcessLeafs_L2 (qmodel_t *mod, byte *in, int filelen)
 			out->compressed_vis = NULL;
 		else
 			out->compressed_vis = mod->visdata + p;
-		out->efrags = NULL;
+		out->numefrags = 0;
 
 		for (j = 0; j < 4; j++)
 			out->ambient_sound_level[j] = *(in + offsetof (dl2leaf_t, ambient_level[j]));
@@ -2352,9 +2741,11 @@ static void Mod_CheckWaterVis (qmodel_t *mod)
 /*
 =================
 Mod_LoadClipnodes
+
+Returns false if a clipnode references a plane that doesn't exist
 =================
 */
-static void Mod_LoadClipnodes (qmodel_t *mod, byte *mod_base, lump_t *l, qboolean bsp2)
+static qboolean Mod_LoadClipnodes (qmodel_t *mod, byte *mod_base, lump_t *l, qboolean bsp2)
 {
 	byte *ins;
 	byte *inl;
@@ -2423,7 +2814,7 @@ static void Mod_LoadClipnodes (qmodel_t *mod, byte *mod_base, lump_t *l, qboolea
 
 			// johnfitz -- bounds check
 			if (out->planenum < 0 || out->planenum >= mod->numplanes)
-				Host_Error ("Mod_LoadClipnodes: planenum out of bounds");
+				return false;
 			// johnfitz
 
 			out->children[0] = ReadLongUnaligned (inl + offsetof (dlclipnode_t, children[0]));
@@ -2439,7 +2830,7 @@ static void Mod_LoadClipnodes (qmodel_t *mod, byte *mod_base, lump_t *l, qboolea
 
 			// johnfitz -- bounds check
 			if (out->planenum < 0 || out->planenum >= mod->numplanes)
-				Host_Error ("Mod_LoadClipnodes: planenum out of bounds");
+				return false;
 			// johnfitz
 
 			// johnfitz -- support clipnodes > 32k
@@ -2453,6 +2844,36 @@ static void Mod_LoadClipnodes (qmodel_t *mod, byte *mod_base, lump_t *l, qboolea
 			// johnfitz
 		}
 	}
+
+	return true;
+}
+
+/*
+=================
+Mod_MakeHull0Range
+=================
+*/
+static void Mod_MakeHull0Range (int begin, int end, qmodel_t **mod_ptr)
+{
+	qmodel_t	*mod = *mod_ptr;
+	mnode_t		*in, *child;
+	mclipnode_t *out;
+	int			 i, j;
+
+	in = mod->nodes + begin;
+	out = mod->hulls[0].clipnodes + begin;
+	for (i = begin; i < end; i++, out++, in++)
+	{
+		out->planenum = in->plane - mod->planes;
+		for (j = 0; j < 2; j++)
+		{
+			child = in->children[j];
+			if (child->contents < 0)
+				out->children[j] = child->contents;
+			else
+				out->children[j] = child - mod->nodes;
+		}
+	}
 }
 
 /*
@@ -2464,14 +2885,12 @@ Duplicate the drawing hull structure as a clipping hull
 */
 static void Mod_MakeHull0 (qmodel_t *mod)
 {
-	mnode_t		*in, *child;
 	mclipnode_t *out; // johnfitz -- was dclipnode_t
-	int			 i, j, count;
+	int			 count;
 	hull_t		*hull;
 
 	hull = &mod->hulls[0];
 
-	in = mod->nodes;
 	count = mod->numnodes;
 	out = (mclipnode_t *)Mem_Alloc (count * sizeof (*out));
 
@@ -2480,31 +2899,99 @@ static void Mod_MakeHull0 (qmodel_t *mod)
 	hull->lastclipnode = count - 1;
 	hull->planes = mod->planes;
 
-	for (i = 0; i < count; i++, out++, in++)
+	if (!isDedicated && !Tasks_IsWorker () && (count > 1))
 	{
-		out->planenum = in->plane - mod->planes;
-		for (j = 0; j < 2; j++)
-		{
-			child = in->children[j];
-			if (child->contents < 0)
-				out->children[j] = child->contents;
-			else
-				out->children[j] = child - mod->nodes;
-		}
+		task_handle_t task = Task_AllocateAssignRangeFuncAndSubmit ((task_range_func_t)Mod_MakeHull0Range, count, &mod, sizeof (qmodel_t *));
+		Task_Join (task, TASK_TIMEOUT_INFINITE);
 	}
+	else
+		Mod_MakeHull0Range (0, count, &mod);
 }
 
 /*
 =================
-Mod_LoadMarksurfaces
+Mod_SortClipnodes
+
+Lays out the clipnodes of hulls 1 and up depth-first from the headnodes of
+the submodels, with the front child right after its parent, so traces walk
+through memory mostly forward instead of jumping around in file order.
+Hull 0 keeps the node order, its clipnode numbers double as node numbers.
 =================
 */
-static void Mod_LoadMarksurfaces (qmodel_t *mod, byte *mod_base, lump_t *l, int bsp2)
+static void Mod_SortClipnodes (qmodel_t *mod)
 {
-	int	 i, j, count;
-	int *out;
-	if (bsp2)
-	{
+	const int count = mod->numclipnodes;
+	int		  num_sorted = 0;
+	int		  i, j, side;
+
+	if (count <= 1)
+		return;
+
+	TEMP_ALLOC_ZEROED (int, remap, count); // new index + 1, 0 while not placed
+	TEMP_ALLOC (int, stack, 2 * count + 1);
+	mclipnode_t *sorted = (mclipnode_t *)Mem_Alloc (count * sizeof (mclipnode_t));
+
+	for (i = 0; i < mod->numsubmodels; i++)
+	{
+		for (j = 1; j < MAX_MAP_HULLS; j++)
+		{
+			const int root = mod->submodels[i].headnode[j];
+			int		  depth = 0;
+			if (root < 0 || root >= count || remap[root])
+				continue;
+			stack[depth++] = root;
+			while (depth > 0)
+			{
+				const int num = stack[--depth];
+				if (remap[num])
+					continue; // reached through another parent first
+				sorted[num_sorted++] = mod->clipnodes[num];
+				remap[num] = num_sorted;
+				for (side = 1; side >= 0; side--)
+				{
+					const int child = mod->clipnodes[num].children[side];
+					if (child >= 0 && child < count && !remap[child])
+						stack[depth++] = child;
+				}
+			}
+		}
+	}
+	for (i = 0; i < count; i++)
+	{
+		if (!remap[i])
+		{
+			sorted[num_sorted++] = mod->clipnodes[i];
+			remap[i] = num_sorted;
+		}
+	}
+
+	for (i = 0; i < count; i++)
+		for (side = 0; side < 2; side++)
+			if (sorted[i].children[side] >= 0 && sorted[i].children[side] < count)
+				sorted[i].children[side] = remap[sorted[i].children[side]] - 1;
+	for (i = 0; i < mod->numsubmodels; i++)
+		for (j = 1; j < MAX_MAP_HULLS; j++)
+			if (mod->submodels[i].headnode[j] >= 0 && mod->submodels[i].headnode[j] < count)
+				mod->submodels[i].headnode[j] = remap[mod->submodels[i].headnode[j]] - 1;
+
+	// copy back, the hulls point at mod->clipnodes
+	memcpy (mod->clipnodes, sorted, count * sizeof (mclipnode_t));
+	Mem_Free (sorted);
+	TEMP_FREE (stack);
+	TEMP_FREE (remap);
+}
+
+/*
+=================
+Mod_LoadMarksurfaces
+=================
+*/
+static void Mod_LoadMarksurfaces (qmodel_t *mod, byte *mod_base, lump_t *l, int bsp2)
+{
+	int	 i, j, count;
+	int *out;
+	if (bsp2)
+	{
 		byte *in = mod_base + l->fileofs;
 
 		if (l->filelen % sizeof (unsigned int))
@@ -2966,6 +3453,65 @@ static void Mod_SetupSubmodels (qmodel_t *mod)
 	}
 }
 
+typedef struct
+{
+	qmodel_t  *mod;
+	byte	  *mod_base;
+	dheader_t *header;
+	int		   bsp2;
+	qboolean   clipnodes_valid;
+} load_lumps_task_args_t;
+
+/*
+=================
+Mod_Load*Task
+
+Lumps that only depend on the file contents (and the planes for the clipnodes) are
+converted on the workers while the main thread loads textures, lighting and entities
+=================
+*/
+static void Mod_LoadVertexesTask (load_lumps_task_args_t **args_ptr)
+{
+	load_lumps_task_args_t *args = *args_ptr;
+	Mod_LoadVertexes (args->mod, args->mod_base, &args->header->lumps[LUMP_VERTEXES]);
+}
+
+static void Mod_LoadEdgesTask (load_lumps_task_args_t **args_ptr)
+{
+	load_lumps_task_args_t *args = *args_ptr;
+	Mod_LoadEdges (args->mod, args->mod_base, &args->header->lumps[LUMP_EDGES], args->bsp2);
+}
+
+static void Mod_LoadSurfedgesTask (load_lumps_task_args_t **args_ptr)
+{
+	load_lumps_task_args_t *args = *args_ptr;
+	Mod_LoadSurfedges (args->mod, args->mod_base, &args->header->lumps[LUMP_SURFEDGES]);
+}
+
+static void Mod_LoadPlanesTask (load_lumps_task_args_t **args_ptr)
+{
+	load_lumps_task_args_t *args = *args_ptr;
+	Mod_LoadPlanes (args->mod, args->mod_base, &args->header->lumps[LUMP_PLANES]);
+}
+
+static void Mod_LoadClipnodesTask (load_lumps_task_args_t **args_ptr)
+{
+	load_lumps_task_args_t *args = *args_ptr;
+	args->clipnodes_valid = Mod_LoadClipnodes (args->mod, args->mod_base, &args->header->lumps[LUMP_CLIPNODES], args->bsp2);
+}
+
+static void Mod_LoadVisibilityTask (load_lumps_task_args_t **args_ptr)
+{
+	load_lumps_task_args_t *args = *args_ptr;
+	Mod_LoadVisibility (args->mod, args->mod_base, &args->header->lumps[LUMP_VISIBILITY]);
+}
+
+static void Mod_LoadSubmodelsTask (load_lumps_task_args_t **args_ptr)
+{
+	load_lumps_task_args_t *args = *args_ptr;
+	Mod_LoadSubmodels (args->mod, args->mod_base, &args->header->lumps[LUMP_MODELS]);
+}
+
 /*
 =================
 Mod_LoadBrushModel
@@ -2976,6 +3522,9 @@ static void Mod_LoadBrushModel (qmodel_t *mod, const char *loadname, void *buffe
 	int		   i;
 	int		   bsp2;
 	dheader_t *header;
+	uint64_t   hash;
+	bspcache_t cache;
+	qboolean   cached, watervis;
 
 	mod->type = mod_brush;
 
@@ -3007,26 +3556,68 @@ static void Mod_LoadBrushModel (qmodel_t *mod, const char *loadname, void *buffe
 		break;
 	}
 
-	// swap all the lumps
-	byte *mod_base = (byte *)header;
+	// swap all the lumps into a copy, the buffer may be a view into a mapped pak
+	byte	 *mod_base = (byte *)buffer;
+	dheader_t swapped_header;
 
+	memcpy (&swapped_header, buffer, sizeof (dheader_t));
+	header = &swapped_header;
 	for (i = 0; i < (int)sizeof (dheader_t) / 4; i++)
 		((int *)header)[i] = LittleLong (((int *)header)[i]);
 
+	hash = Mod_HashBuffer ((const byte *)buffer, (size_t)com_filesize);
+	cached = Mod_ReadBSPCache (mod, hash, &cache);
+	watervis = !r_novis.value;
+
 	// load into heap
 
-	Mod_LoadVertexes (mod, mod_base, &header->lumps[LUMP_VERTEXES]);
-	Mod_LoadEdges (mod, mod_base, &header->lumps[LUMP_EDGES], bsp2);
-	Mod_LoadSurfedges (mod, mod_base, &header->lumps[LUMP_SURFEDGES]);
+	// the visibility lump is only loaded up front when no external vis file can replace it
+	const qboolean try_external_vis = mod->bspversion == BSPVERSION && external_vis.value && sv.modelname[0] && !q_strcasecmp (loadname, sv.name);
+	load_lumps_task_args_t args = {mod, mod_base, header, bsp2, true};
+	load_lumps_task_args_t *args_ptr = &args;
+	task_handle_t			lump_tasks[7];
+	int						num_lump_tasks = 0;
+
+	if (!isDedicated && !Tasks_IsWorker ())
+	{
+		lump_tasks[num_lump_tasks++] = Task_AllocateAndAssignFunc ((task_func_t)Mod_LoadVertexesTask, &args_ptr, sizeof (args_ptr));
+		lump_tasks[num_lump_tasks++] = Task_AllocateAndAssignFunc ((task_func_t)Mod_LoadEdgesTask, &args_ptr, sizeof (args_ptr));
+		lump_tasks[num_lump_tasks++] = Task_AllocateAndAssignFunc ((task_func_t)Mod_LoadSurfedgesTask, &args_ptr, sizeof (args_ptr));
+		lump_tasks[num_lump_tasks++] = Task_AllocateAndAssignFunc ((task_func_t)Mod_LoadSubmodelsTask, &args_ptr, sizeof (args_ptr));
+		lump_tasks[num_lump_tasks++] = Task_AllocateAndAssignFunc ((task_func_t)Mod_LoadPlanesTask, &args_ptr, sizeof (args_ptr));
+		lump_tasks[num_lump_tasks++] = Task_AllocateAndAssignFunc ((task_func_t)Mod_LoadClipnodesTask, &args_ptr, sizeof (args_ptr));
+		Task_AddDependency (lump_tasks[num_lump_tasks - 2], lump_tasks[num_lump_tasks - 1]);
+		if (!try_external_vis)
+			lump_tasks[num_lump_tasks++] = Task_AllocateAndAssignFunc ((task_func_t)Mod_LoadVisibilityTask, &args_ptr, sizeof (args_ptr));
+		Tasks_Submit (num_lump_tasks, lump_tasks);
+	}
+	else
+	{
+		Mod_LoadVertexes (mod, mod_base, &header->lumps[LUMP_VERTEXES]);
+		Mod_LoadEdges (mod, mod_base, &header->lumps[LUMP_EDGES], bsp2);
+		Mod_LoadSurfedges (mod, mod_base, &header->lumps[LUMP_SURFEDGES]);
+		Mod_LoadSubmodels (mod, mod_base, &header->lumps[LUMP_MODELS]);
+		Mod_LoadPlanes (mod, mod_base, &header->lumps[LUMP_PLANES]);
+		args.clipnodes_valid = Mod_LoadClipnodes (mod, mod_base, &header->lumps[LUMP_CLIPNODES], bsp2);
+		if (!try_external_vis)
+			Mod_LoadVisibility (mod, mod_base, &header->lumps[LUMP_VISIBILITY]);
+	}
+
+	// these read files or upload textures, so they stay on the main thread
 	Mod_LoadEntities (mod, mod_base, &header->lumps[LUMP_ENTITIES]);
 	Mod_LoadTextures (mod, mod_base, &header->lumps[LUMP_TEXTURES]);
 	Mod_LoadLighting (mod, mod_base, &header->lumps[LUMP_LIGHTING]);
-	Mod_LoadPlanes (mod, mod_base, &header->lumps[LUMP_PLANES]);
 	Mod_LoadTexinfo (mod, mod_base, &header->lumps[LUMP_TEXINFO]);
-	Mod_LoadFaces (mod, mod_base, &header->lumps[LUMP_FACES], bsp2);
+
+	for (i = 0; i < num_lump_tasks; i++)
+		Task_Join (lump_tasks[i], TASK_TIMEOUT_INFINITE);
+	if (!args.clipnodes_valid)
+		Host_Error ("Mod_LoadClipnodes: planenum out of bounds");
+
+	Mod_LoadFaces (mod, mod_base, &header->lumps[LUMP_FACES], bsp2, &cache);
 	Mod_LoadMarksurfaces (mod, mod_base, &header->lumps[LUMP_MARKSURFACES], bsp2);
 
-	if (mod->bspversion == BSPVERSION && external_vis.value && sv.modelname[0] && !q_strcasecmp (loadname, sv.name))
+	if (try_external_vis)
 	{
 		FILE *fvis;
 		Con_DPrintf ("trying to open external vis file\n");
@@ -3044,24 +3635,33 @@ static void Mod_LoadBrushModel (qmodel_t *mod, const char *loadname, void *buffe
 			fclose (fvis);
 			if (mod->visdata && mod->leafs && mod->numleafs)
 			{
+				watervis = false;
 				goto visdone;
 			}
 			Con_DPrintf ("External VIS data failed, using standard vis.\n");
 		}
 	}
 
-	Mod_LoadVisibility (mod, mod_base, &header->lumps[LUMP_VISIBILITY]);
+	if (try_external_vis)
+		Mod_LoadVisibility (mod, mod_base, &header->lumps[LUMP_VISIBILITY]);
 	Mod_LoadLeafs (mod, mod_base, &header->lumps[LUMP_LEAFS], bsp2);
 visdone:
 	Mod_LoadNodes (mod, mod_base, &header->lumps[LUMP_NODES], bsp2);
-	Mod_LoadClipnodes (mod, mod_base, &header->lumps[LUMP_CLIPNODES], bsp2);
-	Mod_LoadSubmodels (mod, mod_base, &header->lumps[LUMP_MODELS]);
 
 	Mod_MakeHull0 (mod);
+	Mod_SortClipnodes (mod);
 
 	mod->numframes = 2; // regular and alternate animation
 
-	Mod_CheckWaterVis (mod);
+	if (cached && watervis && cache.header.contentstransparent >= 0 && cache.header.numleafs == mod->numleafs)
+		mod->contentstransparent = cache.header.contentstransparent;
+	else
+		Mod_CheckWaterVis (mod);
+
+	if (!cached || cache.header.numsurfaces != mod->numsurfaces || (watervis && cache.header.contentstransparent < 0))
+		Mod_WriteBSPCache (mod, hash, watervis);
+	Mem_Free (cache.surfaces);
+
 	Mod_SetupSubmodels (mod);
 }
 
@@ -3212,8 +3812,6 @@ static void Mod_FloodFillSkin (byte *skin, int skinwidth, int skinheight)
 	int	 filledcolor = -1;
 	int	 i;
 
-	TEMP_ALLOC (floodfill_t, fifo, FLOODFILL_FIFO_SIZE);
-
 	if (filledcolor == -1)
 	{
 		filledcolor = 0;
@@ -3233,6 +3831,8 @@ static void Mod_FloodFillSkin (byte *skin, int skinwidth, int skinheight)
 		return;
 	}
 
+	TEMP_ALLOC (floodfill_t, fifo, FLOODFILL_FIFO_SIZE);
+
 	fifo[inpt].x = 0, fifo[inpt].y = 0;
 	inpt = (inpt + 1) & FLOODFILL_FIFO_MASK;
 
@@ -3285,7 +3885,28 @@ static gltexture_t *Mod_LoadFullbrightTexture (qmodel_t *mod, aliashdr_t *surf,
 
 		// Normalize pixels for additive blending as in INDEXED: fullbright pixels have alpha > 0 => force alpha = 255 anyway.
 		// otherwhise for transparent pixels (alpha = 0) => force alapha = 255 AND force color = black.
-		for (size_t pixel_index = 0; pixel_index < (size_t)fb_width * (size_t)fb_height; pixel_index++)
+		const size_t num_pixels = (size_t)fb_width * (size_t)fb_height;
+		size_t		 pixel_index = 0;
+#if defined(USE_SSE2)
+		const __m128i alpha_mask = _mm_set1_epi32 ((int)0xFF000000u);
+		for (; pixel_index + 4 <= num_pixels; pixel_index += 4)
+		{
+			__m128i		 *rgba_pixels = (__m128i *)((uint32_t *)fb_data + pixel_index);
+			const __m128i pixels = _mm_loadu_si128 (rgba_pixels);
+			const __m128i transparent = _mm_cmpeq_epi32 (_mm_and_si128 (pixels, alpha_mask), _mm_setzero_si128 ());
+			_mm_storeu_si128 (rgba_pixels, _mm_or_si128 (_mm_andnot_si128 (transparent, pixels), alpha_mask));
+		}
+#elif defined(USE_NEON)
+		const uint32x4_t alpha_mask = vdupq_n_u32 (0xFF000000u);
+		for (; pixel_index + 4 <= num_pixels; pixel_index += 4)
+		{
+			uint32_t		*rgba_pixels = (uint32_t *)fb_data + pixel_index;
+			const uint32x4_t pixels = vld1q_u32 (rgba_pixels);
+			const uint32x4_t opaque = vtstq_u32 (pixels, alpha_mask);
+			vst1q_u32 (rgba_pixels, vorrq_u32 (vandq_u32 (pixels, opaque), alpha_mask));
+		}
+#endif
+		for (; pixel_index < num_pixels; pixel_index++)
 		{
 			uint32_t *rgba_pixel = (uint32_t *)fb_data + pixel_index;
 			byte	 *rgba_component = (byte *)rgba_pixel;
@@ -3874,18 +4495,35 @@ static void Mod_LoadAliasModel (qmodel_t *mod, void *buffer)
 
 //=============================================================================
 
+#define SPRITE_ATLAS_MAX_FRAME 256 // bigger frames keep their own texture
+#define SPRITE_ATLAS_MAX_SIZE  2048
+
+typedef struct
+{
+	mspriteframe_t *frame;
+	byte		   *pixels;
+	int				framenum;
+	int				atlas_x, atlas_y;
+} sprite_upload_t;
+
+typedef struct
+{
+	sprite_upload_t *frames;
+	int				 numframes;
+	int				 maxframes;
+} sprite_uploads_t;
+
 /*
 =================
 Mod_LoadSpriteFrame
 =================
 */
-static void *Mod_LoadSpriteFrame (qmodel_t *mod, byte *mod_base, void *pin, mspriteframe_t **ppframe, int framenum)
+static void *Mod_LoadSpriteFrame (qmodel_t *mod, void *pin, mspriteframe_t **ppframe, int framenum, sprite_uploads_t *uploads)
 {
-	dspriteframe_t *pinframe;
-	mspriteframe_t *pspriteframe;
-	int				width, height, size, origin[2];
-	char			name[64];
-	src_offset_t	offset; // johnfitz
+	dspriteframe_t	*pinframe;
+	mspriteframe_t	*pspriteframe;
+	sprite_upload_t *upload;
+	int				 width, height, size, origin[2];
 
 	pinframe = (dspriteframe_t *)pin;
 
@@ -3909,21 +4547,160 @@ static void *Mod_LoadSpriteFrame (qmodel_t *mod, byte *mod_base, void *pin, mspr
 	pspriteframe->smax = 1;
 	pspriteframe->tmax = 1;
 
-	q_snprintf (name, sizeof (name), "%s:frame%i", mod->name, framenum);
-	offset = (src_offset_t)(pinframe + 1) - (src_offset_t)mod_base; // johnfitz
-	pspriteframe->gltexture = TexMgr_LoadImage (
-		mod, name, width, height, SRC_INDEXED, (byte *)(pinframe + 1), mod->name, offset,
-		TEXPREF_PAD | TEXPREF_ALPHA | TEXPREF_NOPICMIP); // johnfitz -- TexMgr
+	// textures are created once all frames are known, see Mod_UploadSpriteFrames
+	if (uploads->numframes == uploads->maxframes)
+	{
+		uploads->maxframes = q_max (uploads->maxframes * 2, 16);
+		uploads->frames = (sprite_upload_t *)Mem_Realloc (uploads->frames, uploads->maxframes * sizeof (sprite_upload_t));
+	}
+	upload = &uploads->frames[uploads->numframes++];
+	upload->frame = pspriteframe;
+	upload->pixels = (byte *)(pinframe + 1);
+	upload->framenum = framenum;
 
 	return (void *)((byte *)pinframe + sizeof (dspriteframe_t) + size);
 }
 
+/*
+=================
+Mod_UploadSpriteFrame
+=================
+*/
+static void Mod_UploadSpriteFrame (qmodel_t *mod, byte *mod_base, sprite_upload_t *upload)
+{
+	mspriteframe_t *frame = upload->frame;
+	char			name[64];
+	src_offset_t	offset; // johnfitz
+
+	q_snprintf (name, sizeof (name), "%s:frame%i", mod->name, upload->framenum);
+	offset = (src_offset_t)upload->pixels - (src_offset_t)mod_base; // johnfitz
+	frame->gltexture = TexMgr_LoadImage (
+		mod, name, frame->width, frame->height, SRC_INDEXED, upload->pixels, mod->name, offset,
+		TEXPREF_PAD | TEXPREF_ALPHA | TEXPREF_NOPICMIP); // johnfitz -- TexMgr
+}
+
+/*
+=================
+Mod_CompareSpriteUploads
+
+Sorts the atlas candidates by decreasing height for the shelf packer
+=================
+*/
+static int Mod_CompareSpriteUploads (const void *a, const void *b)
+{
+	const sprite_upload_t *upload_a = *(const sprite_upload_t **)a;
+	const sprite_upload_t *upload_b = *(const sprite_upload_t **)b;
+
+	if (upload_a->frame->height != upload_b->frame->height)
+		return upload_b->frame->height - upload_a->frame->height;
+	return upload_a->framenum - upload_b->framenum;
+}
+
+/*
+=================
+Mod_UploadSpriteFrames
+
+With r_spriteatlas, frames up to SPRITE_ATLAS_MAX_FRAME texels are packed into
+one texture per sprite, with a transparent texel between frames so filtering
+doesn't bleed. All frames of an animation then share a descriptor set.
+=================
+*/
+static void Mod_UploadSpriteFrames (qmodel_t *mod, byte *mod_base, msprite_t *psprite, sprite_uploads_t *uploads)
+{
+	sprite_upload_t **candidates;
+	int				  i, y, numcandidates, area, maxwidth, width, height, x, shelf_height;
+	char			  name[64];
+
+	if (isDedicated)
+		return;
+
+	candidates = NULL;
+	numcandidates = 0;
+	if (r_spriteatlas.value && uploads->numframes > 1)
+	{
+		candidates = (sprite_upload_t **)Mem_Alloc (uploads->numframes * sizeof (sprite_upload_t *));
+		for (i = 0; i < uploads->numframes; i++)
+		{
+			mspriteframe_t *frame = uploads->frames[i].frame;
+			if (frame->width > 0 && frame->height > 0 && frame->width <= SPRITE_ATLAS_MAX_FRAME && frame->height <= SPRITE_ATLAS_MAX_FRAME)
+				candidates[numcandidates++] = &uploads->frames[i];
+		}
+	}
+
+	width = height = 0;
+	if (numcandidates > 1)
+	{
+		qsort (candidates, numcandidates, sizeof (sprite_upload_t *), Mod_CompareSpriteUploads);
+
+		area = maxwidth = 0;
+		for (i = 0; i < numcandidates; i++)
+		{
+			area += (candidates[i]->frame->width + 1) * (candidates[i]->frame->height + 1);
+			maxwidth = q_max (maxwidth, candidates[i]->frame->width + 1);
+		}
+		for (width = 64; width < maxwidth || width * width < area; width *= 2)
+			;
+		width = q_min (width, SPRITE_ATLAS_MAX_SIZE);
+
+		x = y = shelf_height = 0;
+		for (i = 0; i < numcandidates; i++)
+		{
+			mspriteframe_t *frame = candidates[i]->frame;
+			if (x + frame->width + 1 > width)
+			{
+				y += shelf_height;
+				x = shelf_height = 0;
+			}
+			candidates[i]->atlas_x = x + 1;
+			candidates[i]->atlas_y = y + 1;
+			x += frame->width + 1;
+			shelf_height = q_max (shelf_height, frame->height + 1);
+		}
+		height = y + shelf_height + 1;
+		if (height > SPRITE_ATLAS_MAX_SIZE)
+			numcandidates = 0;
+	}
+
+	if (numcandidates > 1)
+	{
+		psprite->atlas = (byte *)Mem_AllocNonZero (width * height);
+		memset (psprite->atlas, 255, width * height);
+		for (i = 0; i < numcandidates; i++)
+		{
+			sprite_upload_t *upload = candidates[i];
+			mspriteframe_t	*frame = upload->frame;
+			for (y = 0; y < frame->height; y++)
+				memcpy (psprite->atlas + (upload->atlas_y + y) * width + upload->atlas_x, upload->pixels + y * frame->width, frame->width);
+		}
+
+		q_snprintf (name, sizeof (name), "%s:atlas", mod->name);
+		gltexture_t *atlas =
+			TexMgr_LoadImage (mod, name, width, height, SRC_INDEXED, psprite->atlas, "", (src_offset_t)psprite->atlas, TEXPREF_ALPHA | TEXPREF_NOPICMIP);
+		for (i = 0; i < numcandidates; i++)
+		{
+			sprite_upload_t *upload = candidates[i];
+			mspriteframe_t	*frame = upload->frame;
+			frame->gltexture = atlas;
+			frame->smin = (float)upload->atlas_x / width;
+			frame->tmin = (float)upload->atlas_y / height;
+			frame->smax = (float)(upload->atlas_x + frame->width) / width;
+			frame->tmax = (float)(upload->atlas_y + frame->height) / height;
+		}
+	}
+
+	for (i = 0; i < uploads->numframes; i++)
+		if (!uploads->frames[i].frame->gltexture)
+			Mod_UploadSpriteFrame (mod, mod_base, &uploads->frames[i]);
+
+	Mem_Free (candidates);
+}
+
 /*
 =================
 Mod_LoadSpriteGroup
 =================
 */
-static void *Mod_LoadSpriteGroup (qmodel_t *mod, byte *mod_base, void *pin, mspriteframe_t **ppframe, int framenum, spriteframetype_t type)
+static void *Mod_LoadSpriteGroup (qmodel_t *mod, void *pin, mspriteframe_t **ppframe, int framenum, spriteframetype_t type, sprite_uploads_t *uploads)
 {
 	dspritegroup_t	  *pingroup;
 	mspritegroup_t	  *pspritegroup;
@@ -3964,7 +4741,7 @@ static void *Mod_LoadSpriteGroup (qmodel_t *mod, byte *mod_base, void *pin, mspr
 
 	for (i = 0; i < numframes; i++)
 	{
-		ptemp = Mod_LoadSpriteFrame (mod, mod_base, ptemp, &pspritegroup->frames[i], framenum * 100 + i);
+		ptemp = Mod_LoadSpriteFrame (mod, ptemp, &pspritegroup->frames[i], framenum * 100 + i, uploads);
 	}
 
 	return ptemp;
@@ -4023,6 +4800,7 @@ static void Mod_LoadSpriteModel (qmodel_t *mod, void *buffer)
 
 	pframetype = (dspriteframetype_t *)(pin + 1);
 
+	sprite_uploads_t uploads = {NULL, 0, 0};
 	for (i = 0; i < numframes; i++)
 	{
 		spriteframetype_t frametype;
@@ -4032,14 +4810,17 @@ static void Mod_LoadSpriteModel (qmodel_t *mod, void *buffer)
 
 		if (frametype == SPR_SINGLE)
 		{
-			pframetype = (dspriteframetype_t *)Mod_LoadSpriteFrame (mod, mod_base, pframetype + 1, &psprite->frames[i].frameptr, i);
+			pframetype = (dspriteframetype_t *)Mod_LoadSpriteFrame (mod, pframetype + 1, &psprite->frames[i].frameptr, i, &uploads);
 		}
 		else
 		{
-			pframetype = (dspriteframetype_t *)Mod_LoadSpriteGroup (mod, mod_base, pframetype + 1, &psprite->frames[i].frameptr, i, frametype);
+			pframetype = (dspriteframetype_t *)Mod_LoadSpriteGroup (mod, pframetype + 1, &psprite->frames[i].frameptr, i, frametype, &uploads);
 		}
 	}
 
+	Mod_UploadSpriteFrames (mod, mod_base, psprite, &uploads);
+	Mem_Free (uploads.frames);
+
 	mod->type = mod_sprite;
 }
 
@@ -4363,7 +5144,7 @@ MD5_ComputeNormals
 */
 static void MD5_ComputeNormals (md5vert_t *vert, size_t numverts, unsigned short *indexes, size_t numindexes)
 {
-	hash_map_t *pos_to_normal_map = HashMap_Create (vec3_t, vec3_t, &HashVec3, NULL);
+	hash_map_t *pos_to_normal_map = HashMap_CreateOpen (vec3_t, vec3_t, &HashVec3, NULL);
 	HashMap_Reserve (pos_to_normal_map, numverts);
 
 	for (size_t v = 0; v < numverts; v++)
@@ -4851,6 +5632,286 @@ SKIN_PATTERN_FUNC_DEF (MD5_Skin_Name)
 	q_snprintf (output_name, MAX_QPATH, "%s_%02u_%02u", basename, skin_index, framegroup_index);
 }
 
+#define MD5CACHE_MAGIC	 (('C' << 24) + ('5' << 16) + ('D' << 8) + 'M')
+#define MD5CACHE_VERSION 1
+
+/*
+================
+md5cache_header_t
+
+A cooked md5mesh + md5anim pair: this header, then nummeshes md5cache_mesh_t,
+numjoints * numposes inverted joint poses, numverts baked vertexes and
+numindexes indexes.
+================
+*/
+typedef struct
+{
+	int		 magic;
+	int		 version;
+	uint64_t hash;
+	uint32_t numjoints;
+	uint32_t numposes;
+	uint32_t nummeshes;
+	uint32_t numverts;
+	uint32_t numindexes;
+	uint32_t padding;
+} md5cache_header_t;
+
+typedef struct
+{
+	char	 shader[MAX_QPATH];
+	uint32_t numverts;
+	uint32_t numtris;
+} md5cache_mesh_t;
+
+/*
+================
+md5mesh_s
+================
+*/
+typedef struct md5mesh_s
+{
+	aliashdr_t		*surf;
+	char			 shader[MAX_QPATH];
+	md5vertinfo_t	*vinfo;
+	md5weightinfo_t *weight;
+	size_t			 numweights;
+	md5vert_t		*vertexes;
+	unsigned short	*indexes;
+} md5mesh_t;
+
+typedef struct
+{
+	const char	*fname;
+	jointpose_t *joint_poses;
+	md5mesh_t	*meshes;
+} md5bake_task_args_t;
+
+/*
+================
+MD5_BakeMeshTask
+================
+*/
+static void MD5_BakeMeshTask (int m, md5bake_task_args_t **args_ptr)
+{
+	md5bake_task_args_t *args = *args_ptr;
+	md5mesh_t			*mesh = &args->meshes[m];
+
+	// so make it gpu-friendly.
+	MD5_BakeInfluences (args->fname, args->joint_poses, mesh->vertexes, mesh->vinfo, mesh->weight, mesh->surf->numverts, mesh->numweights);
+	// and now make up the normals that the format lacks. we'll still probably have issues from seams, but then so did qme, so at least its faithful...
+	// :P
+	MD5_ComputeNormals (mesh->vertexes, mesh->surf->numverts, mesh->indexes, mesh->surf->numindexes);
+}
+
+/*
+================
+MD5_SetupSurface
+================
+*/
+static void MD5_SetupSurface (qmodel_t *mod, aliashdr_t *outhdr, size_t hdrsize, int m, size_t nummeshes, size_t numjoints, size_t numposes, const char *shader)
+{
+	// go to the  surf, a.k.a mesh, chaining the next nextsurface
+	aliashdr_t *surf = (aliashdr_t *)((byte *)outhdr + m * hdrsize);
+	if (m + 1 < nummeshes)
+		surf->nextsurface = (aliashdr_t *)((byte *)outhdr + (m + 1) * hdrsize);
+	else
+		surf->nextsurface = NULL;
+
+	surf->poseverttype = PV_MD5;
+	for (size_t j = 0; j < 3; j++)
+	{
+		surf->scale_origin[j] = 0;
+		surf->scale[j] = 1.0;
+	}
+
+	surf->numjoints = numjoints;
+
+	if (numposes)
+	{
+		for (size_t j = 0; j < numposes; j++)
+		{
+			surf->frames[j].firstpose = j;
+			surf->frames[j].numposes = 1;
+			surf->frames[j].interval = 0.1;
+		}
+		surf->numframes = numposes;
+	}
+
+	// MD5 violation: the skin is a single material. adding prefixes/postfixes here is the wrong thing to do.
+	// but we do so anyway, because rerelease compat.
+	surf->numskins = (int)Mod_LoadMDXSkinsByIndex (mod, surf, NULL, m, nummeshes, MAX_SKINS, shader, MD5_Skin_Name);
+
+	if (surf->numskins == 0)
+		Con_Warning ("MD5: %s, no skins found for surf '%s' (%d)\n", mod->name, shader, m);
+
+	// MD5 have only 1 surface pose, meaning 1 vertex-like "pose" (not to ne mixed with md5animctx_t anim poses !)
+	//  because it uses skeletal animation instead of displaying/interpolating different frames/poses of vertices
+	surf->numposes = 1;
+}
+
+/*
+================
+MD5_FinishModel
+================
+*/
+static void MD5_FinishModel (qmodel_t *mod, aliashdr_t *outhdr, size_t total_numverts, md5vert_t *total_vertexes)
+{
+	// the MD5 format does not have its own modelflags, yet we still need to know about trails and rotating etc
+	mod->flags = MD5_HackyModelFlags (mod->name);
+
+	mod->synctype = ST_FRAMETIME; // keep MD5 animations synced to when .frame is changed. framegroups are otherwise not very useful.
+	mod->type = mod_alias;
+	mod->extradata[PV_MD5] = (byte *)outhdr;
+
+	Mod_CalcAliasBounds (mod, outhdr, total_numverts, (byte *)total_vertexes); // johnfitz
+}
+
+/*
+================
+MD5_LoadCache
+
+Loads the cooked model straight from the mapped cache file if its hash matches
+================
+*/
+static qboolean MD5_LoadCache (qmodel_t *mod, uint64_t hash, size_t numposes)
+{
+	char					 path[MAX_OSPATH];
+	int						 size;
+	const byte				*memory;
+	const md5cache_header_t *header;
+	const md5cache_mesh_t	*meshes;
+	jointpose_t				*joints;
+	md5vert_t				*vertexes;
+	unsigned short			*indexes;
+	size_t					 expected, hdrsize;
+	uint32_t				 numverts, numindexes, m;
+
+	if (!r_md5cache.value)
+		return false;
+
+	Mod_CachePath (mod, "md5c", path, sizeof (path));
+	memory = Sys_FileMap (path, &size);
+	if (!memory)
+		return false;
+
+	header = (const md5cache_header_t *)memory;
+	if (size < (int)sizeof (*header) || header->magic != MD5CACHE_MAGIC || header->version != MD5CACHE_VERSION || header->hash != hash ||
+		header->numposes != numposes || header->numjoints == 0 || header->nummeshes == 0 || header->nummeshes > 65536)
+	{
+		Sys_FileUnmap (memory, size);
+		return false;
+	}
+
+	expected = sizeof (*header) + header->nummeshes * sizeof (md5cache_mesh_t) + (size_t)header->numjoints * header->numposes * sizeof (jointpose_t) +
+			   (size_t)header->numverts * sizeof (md5vert_t) + (size_t)header->numindexes * sizeof (unsigned short);
+	meshes = (const md5cache_mesh_t *)(header + 1);
+	numverts = numindexes = 0;
+	if (expected == (size_t)size)
+		for (m = 0; m < header->nummeshes; m++)
+		{
+			numverts += meshes[m].numverts;
+			numindexes += meshes[m].numtris * 3;
+		}
+	if (expected != (size_t)size || numverts != header->numverts || numindexes != header->numindexes)
+	{
+		Con_DPrintf ("%s is corrupt, ignoring it\n", path);
+		Sys_FileUnmap (memory, size);
+		return false;
+	}
+
+	// the mapping is copy on write, so the arrays can be handed out as they are
+	joints = (jointpose_t *)(meshes + header->nummeshes);
+	vertexes = (md5vert_t *)(joints + header->numjoints * header->numposes);
+	indexes = (unsigned short *)(vertexes + header->numverts);
+
+	hdrsize = sizeof (aliashdr_t) - sizeof (((aliashdr_t *)NULL)->frames);
+	hdrsize += sizeof (((aliashdr_t *)NULL)->frames) * numposes;
+	aliashdr_t *outhdr = (aliashdr_t *)Mem_Alloc (hdrsize * header->nummeshes);
+
+	numverts = numindexes = 0;
+	for (m = 0; m < header->nummeshes; m++)
+	{
+		aliashdr_t *surf = (aliashdr_t *)((byte *)outhdr + m * hdrsize);
+		char		shader[MAX_QPATH];
+
+		q_strlcpy (shader, meshes[m].shader, sizeof (shader));
+		MD5_SetupSurface (mod, outhdr, hdrsize, m, header->nummeshes, header->numjoints, numposes, shader);
+		surf->numverts_vbo = surf->numverts = meshes[m].numverts;
+		surf->numtris = meshes[m].numtris;
+		surf->numindexes = surf->numtris * 3;
+
+		for (int i = 0; i < surf->numindexes; i++)
+			if (indexes[numindexes + i] >= surf->numverts)
+				Sys_Error ("%s: vertex index out of bounds", path);
+
+		GLMesh_UploadBuffers (mod, surf, indexes + numindexes, (byte *)(vertexes + numverts), NULL, joints);
+		numverts += surf->numverts;
+		numindexes += surf->numindexes;
+	}
+
+	MD5_FinishModel (mod, outhdr, numverts, vertexes);
+	Sys_FileUnmap (memory, size);
+	return true;
+}
+
+/*
+================
+MD5_WriteCache
+================
+*/
+static void MD5_WriteCache (qmodel_t *mod, uint64_t hash, size_t numjoints, size_t numposes, size_t nummeshes, md5mesh_t *meshes, jointpose_t *joints)
+{
+	char			  path[MAX_OSPATH];
+	FILE			 *f;
+	md5cache_header_t header;
+	md5cache_mesh_t	  cachemesh;
+	size_t			  m;
+
+	if (!r_md5cache.value)
+		return;
+
+	Mod_CachePath (mod, "md5c", path, sizeof (path));
+	COM_CreatePath (path);
+	f = fopen (path, "wb");
+	if (!f)
+	{
+		Con_DPrintf ("Couldn't write %s\n", path);
+		return;
+	}
+
+	memset (&header, 0, sizeof (header));
+	header.magic = MD5CACHE_MAGIC;
+	header.version = MD5CACHE_VERSION;
+	header.hash = hash;
+	header.numjoints = numjoints;
+	header.numposes = numposes;
+	header.nummeshes = nummeshes;
+	for (m = 0; m < nummeshes; m++)
+	{
+		header.numverts += meshes[m].surf->numverts;
+		header.numindexes += meshes[m].surf->numindexes;
+	}
+	fwrite (&header, sizeof (header), 1, f);
+
+	for (m = 0; m < nummeshes; m++)
+	{
+		memset (&cachemesh, 0, sizeof (cachemesh));
+		q_strlcpy (cachemesh.shader, meshes[m].shader, sizeof (cachemesh.shader));
+		cachemesh.numverts = meshes[m].surf->numverts;
+		cachemesh.numtris = meshes[m].surf->numtris;
+		fwrite (&cachemesh, sizeof (cachemesh), 1, f);
+	}
+	if (numjoints && numposes)
+		fwrite (joints, sizeof (jointpose_t), numjoints * numposes, f);
+	for (m = 0; m < nummeshes; m++)
+		fwrite (meshes[m].vertexes, sizeof (md5vert_t), meshes[m].surf->numverts, f);
+	for (m = 0; m < nummeshes; m++)
+		fwrite (meshes[m].indexes, sizeof (unsigned short), meshes[m].surf->numindexes, f);
+
+	fclose (f);
+}
+
 static void Mod_LoadMD5MeshModel (qmodel_t *mod, const void *buffer)
 {
 	const char *fname = mod->name;
@@ -4859,9 +5920,21 @@ static void Mod_LoadMD5MeshModel (qmodel_t *mod, const void *buffer)
 	size_t		hdrsize;
 	size_t		numjoints;
 	size_t		nummeshes;
+	uint64_t	hash;
 
 	md5animctx_t anim = {NULL};
 
+	// the md5anim is part of the cache key, so it is opened before the mesh is parsed
+	MD5Anim_Begin (&anim, fname);
+	hash = Mod_HashBuffer ((const byte *)buffer, strlen ((const char *)buffer));
+	if (anim.animfile)
+		hash = hash * 31 + Mod_HashBuffer ((const byte *)anim.animfile, strlen ((const char *)anim.animfile));
+	if (MD5_LoadCache (mod, hash, anim.numposes))
+	{
+		Mem_Free (anim.animfile);
+		return;
+	}
+
 	buffer = COM_Parse (buffer);
 
 	MD5EXPECT ("MD5Version");
@@ -4880,7 +5953,6 @@ static void Mod_LoadMD5MeshModel (qmodel_t *mod, const void *buffer)
 
 	if (strcmp (com_token, "joints"))
 		Sys_Error ("Mod_LoadMD5MeshModel(%s): Expected \"%s\"", fname, "joints");
-	MD5Anim_Begin (&anim, fname);
 	buffer = COM_Parse (buffer);
 
 	hdrsize = sizeof (*outhdr) - sizeof (outhdr->frames);
@@ -4950,64 +6022,28 @@ static void Mod_LoadMD5MeshModel (qmodel_t *mod, const void *buffer)
 	}
 	Mem_Free (anim.posedata);
 
-	// 3. each mesh has its own aliashdr_t : load vertices, triangles, textures...etc. and upload to GPU each surface:
-
-	// total_numverts and total_vertexes accumulate all vertices of the ssurface,
-	// just to be able to Mod_CalcAliasBounds at the end.
-	size_t	   total_numverts = 0;
-	md5vert_t *total_vertexes = NULL;
+	// 3. each mesh has its own aliashdr_t : load vertices, triangles, textures...etc.
+	md5mesh_t *meshes = (md5mesh_t *)Mem_Alloc (nummeshes * sizeof (md5mesh_t));
 
 	for (int m = 0; m < nummeshes; m++)
 	{
+		md5mesh_t *mesh = &meshes[m];
+
 		MD5EXPECT ("mesh");
 		MD5EXPECT ("{");
 
-		// go to the  surf, a.k.a mesh, chaining the next nextsurface
-		surf = (aliashdr_t *)((byte *)outhdr + m * hdrsize);
-		if (m + 1 < nummeshes)
-			surf->nextsurface = (aliashdr_t *)((byte *)outhdr + (m + 1) * hdrsize);
-		else
-			surf->nextsurface = NULL;
-
-		surf->poseverttype = PV_MD5;
-		for (size_t j = 0; j < 3; j++)
-		{
-			surf->scale_origin[j] = 0;
-			surf->scale[j] = 1.0;
-		}
-
-		surf->numjoints = numjoints;
-
-		if (anim.numposes)
-		{
-			for (size_t j = 0; j < anim.numposes; j++)
-			{
-				surf->frames[j].firstpose = j;
-				surf->frames[j].numposes = 1;
-				surf->frames[j].interval = 0.1;
-			}
-			surf->numframes = anim.numposes;
-		}
-
 		//"shader" is the texture of the surf
 		MD5EXPECT ("shader");
-		// MD5 violation: the skin is a single material. adding prefixes/postfixes here is the wrong thing to do.
-		// but we do so anyway, because rerelease compat.
-		surf->numskins = (int)Mod_LoadMDXSkinsByIndex (mod, surf, NULL, m, nummeshes, MAX_SKINS, (const char *)com_token, MD5_Skin_Name);
-
-		if (surf->numskins == 0)
-			Con_Warning ("MD5: %s, no skins found for surf '%s' (%d)\n", fname, (const char *)com_token, m);
-
-		// MD5 have only 1 surface pose, meaning 1 vertex-like "pose" (not to ne mixed with md5animctx_t anim poses !)
-		//  because it uses skeletal animation instead of displaying/interpolating different frames/poses of vertices
-		surf->numposes = 1;
+		q_strlcpy (mesh->shader, com_token, sizeof (mesh->shader));
+		MD5_SetupSurface (mod, outhdr, hdrsize, m, nummeshes, numjoints, anim.numposes, mesh->shader);
+		surf = mesh->surf = (aliashdr_t *)((byte *)outhdr + m * hdrsize);
 
 		buffer = COM_Parse (buffer);
 		MD5EXPECT ("numverts");
 		surf->numverts_vbo = surf->numverts = MD5UINT ();
 
-		md5vertinfo_t *vinfo = (md5vertinfo_t *)Mem_Alloc (sizeof (*vinfo) * surf->numverts);
-		md5vert_t	  *poutvertexes = (md5vert_t *)Mem_Alloc (sizeof (*poutvertexes) * surf->numverts);
+		md5vertinfo_t *vinfo = mesh->vinfo = (md5vertinfo_t *)Mem_Alloc (sizeof (*vinfo) * surf->numverts);
+		md5vert_t	  *poutvertexes = mesh->vertexes = (md5vert_t *)Mem_Alloc (sizeof (*poutvertexes) * surf->numverts);
 
 		while (MD5CHECK ("vert"))
 		{
@@ -5025,7 +6061,7 @@ static void Mod_LoadMD5MeshModel (qmodel_t *mod, const void *buffer)
 		MD5EXPECT ("numtris");
 		surf->numtris = MD5UINT ();
 		surf->numindexes = surf->numtris * 3;
-		unsigned short *poutindexes = (unsigned short *)Mem_Alloc (sizeof (unsigned short) * (surf->numindexes));
+		unsigned short *poutindexes = mesh->indexes = (unsigned short *)Mem_Alloc (sizeof (unsigned short) * (surf->numindexes));
 
 		while (MD5CHECK ("tri"))
 		{
@@ -5044,8 +6080,8 @@ static void Mod_LoadMD5MeshModel (qmodel_t *mod, const void *buffer)
 
 		// md5 is a gpu-unfriendly interchange format. :(
 		MD5EXPECT ("numweights");
-		size_t			 numweights = MD5UINT ();
-		md5weightinfo_t *weight = (md5weightinfo_t *)Mem_Alloc (sizeof (*weight) * numweights);
+		size_t			 numweights = mesh->numweights = MD5UINT ();
+		md5weightinfo_t *weight = mesh->weight = (md5weightinfo_t *)Mem_Alloc (sizeof (*weight) * numweights);
 
 		while (MD5CHECK ("weight"))
 		{
@@ -5065,37 +6101,52 @@ static void Mod_LoadMD5MeshModel (qmodel_t *mod, const void *buffer)
 		}
 
 		MD5EXPECT ("}");
+	} // end foreach mesh
 
-		// so make it gpu-friendly.
-		MD5_BakeInfluences (fname, joint_poses, poutvertexes, vinfo, weight, surf->numverts, numweights);
-		// and now make up the normals that the format lacks. we'll still probably have issues from seams, but then so did qme, so at least its faithful...
-		// :P
-		MD5_ComputeNormals (poutvertexes, surf->numverts, poutindexes, surf->numindexes);
+	// 4. bake the influences and normals of all meshes in parallel
+	md5bake_task_args_t	 bake_args = {fname, joint_poses, meshes};
+	md5bake_task_args_t *bake_args_ptr = &bake_args;
+	if (!Tasks_IsWorker () && (nummeshes > 1))
+	{
+		task_handle_t task = Task_AllocateAssignIndexedFuncAndSubmit ((task_indexed_func_t)MD5_BakeMeshTask, nummeshes, &bake_args_ptr, sizeof (bake_args_ptr));
+		Task_Join (task, TASK_TIMEOUT_INFINITE);
+	}
+	else
+	{
+		for (int m = 0; m < nummeshes; m++)
+			MD5_BakeMeshTask (m, &bake_args_ptr);
+	}
 
-		Mem_Free (weight);
-		Mem_Free (vinfo);
+	MD5_WriteCache (mod, hash, numjoints, anim.numposes, nummeshes, meshes, inverted_joints);
 
-		// Upload to GPU that surface/mesh m:
-		GLMesh_UploadBuffers (mod, surf, poutindexes, (byte *)poutvertexes, NULL, inverted_joints);
+	// 5. upload to GPU each surface:
 
-		// concat surface vertices to total_vertexes
-		total_vertexes = (md5vert_t *)Mem_Realloc (total_vertexes, sizeof (*poutvertexes) * (total_numverts + surf->numverts));
-		memcpy ((void *)(total_vertexes + total_numverts), (const void *)poutvertexes, sizeof (*poutvertexes) * surf->numverts);
-		total_numverts += surf->numverts;
+	// total_numverts and total_vertexes accumulate all vertices of the ssurface,
+	// just to be able to Mod_CalcAliasBounds at the end.
+	size_t	   total_numverts = 0;
+	md5vert_t *total_vertexes = NULL;
 
-		Mem_Free (poutvertexes);
-		Mem_Free (poutindexes);
+	for (int m = 0; m < nummeshes; m++)
+	{
+		md5mesh_t *mesh = &meshes[m];
+		surf = mesh->surf;
 
-	} // end foreach mesh
+		// Upload to GPU that surface/mesh m:
+		GLMesh_UploadBuffers (mod, surf, mesh->indexes, (byte *)mesh->vertexes, NULL, inverted_joints);
 
-	// the MD5 format does not have its own modelflags, yet we still need to know about trails and rotating etc
-	mod->flags = MD5_HackyModelFlags (mod->name);
+		// concat surface vertices to total_vertexes
+		total_vertexes = (md5vert_t *)Mem_Realloc (total_vertexes, sizeof (md5vert_t) * (total_numverts + surf->numverts));
+		memcpy ((void *)(total_vertexes + total_numverts), (const void *)mesh->vertexes, sizeof (md5vert_t) * surf->numverts);
+		total_numverts += surf->numverts;
 
-	mod->synctype = ST_FRAMETIME; // keep MD5 animations synced to when .frame is changed. framegroups are otherwise not very useful.
-	mod->type = mod_alias;
-	mod->extradata[PV_MD5] = (byte *)outhdr;
+		Mem_Free (mesh->weight);
+		Mem_Free (mesh->vinfo);
+		Mem_Free (mesh->vertexes);
+		Mem_Free (mesh->indexes);
+	}
+	Mem_Free (meshes);
 
-	Mod_CalcAliasBounds (mod, outhdr, total_numverts, (byte *)total_vertexes); // johnfitz
+	MD5_FinishModel (mod, outhdr, total_numverts, total_vertexes);
 
 	Mem_Free (total_vertexes);
 
@@ -204,7 +204,8 @@ typedef struct mleaf_s
 	byte	 ambient_sound_level[NUM_AMBIENTS];
 	byte	*compressed_vis;
 	int		*firstmarksurface;
-	efrag_t *efrags;
+	int		 firstefrag; // index into cl.efrag_entities, see R_SortEfrags
+	int		 numefrags;
 } mleaf_t;
 
 // johnfitz -- for clipnodes>32k
@@ -242,6 +243,7 @@ typedef struct mspriteframe_s
 {
 	int					width, height;
 	float				up, down, left, right;
+	float				smin, tmin; // frame rect inside the sprite atlas, 0 for frames with their own texture
 	float				smax, tmax; // johnfitz -- image might be padded
 	struct gltexture_s *gltexture;
 } mspriteframe_t;
@@ -265,6 +267,7 @@ typedef struct
 	int				   maxwidth;
 	int				   maxheight;
 	int				   numframes;
+	byte			  *atlas; // indexed pixels of the frame atlas, kept for TexMgr_ReloadImage
 	mspriteframedesc_t frames[1];
 } msprite_t;
 
@@ -332,6 +335,15 @@ typedef enum
 
 #define MAX_FRAMEGROUPS 4
 
+// Full mesh plus simplified ones for distant entities, see GLMesh_BuildLODs
+#define MAX_ALIAS_LODS 3
+
+typedef struct
+{
+	int firstindex;
+	int numindexes;
+} aliaslod_t;
+
 typedef struct aliashdr_s
 {
 	int					ident;
@@ -364,7 +376,9 @@ typedef struct aliashdr_s
 	VkBuffer			index_buffer;
 	glheapallocation_t *index_allocation;
 	VkDeviceAddress		index_buffer_address;
-	int					vbostofs; // offset in vbo of hdr->numverts_vbo meshst_t
+	int					numlods;
+	aliaslod_t			lods[MAX_ALIAS_LODS]; // index ranges in index_buffer, lods[0] is the full mesh
+	int					vbostofs;			  // offset in vbo of hdr->numverts_vbo meshst_t
 	VkBuffer			joints_buffer;
 	glheapallocation_t *joints_allocation;
 	VkDeviceAddress		joints_buffer_address;
@@ -647,15 +661,17 @@ typedef struct qmodel_s
 	soa_aabb_t	*soa_leafbounds;
 	byte		*surfvis;
 	soa_plane_t *soa_surfplanes;
+	soa_aabb_t	*soa_surfbounds;
 
 	hull_t hulls[MAX_MAP_HULLS];
 
 	int			numtextures;
 	texture_t **textures;
 
-	byte *visdata;
-	byte *lightdata;
-	char *entities;
+	byte			   *visdata;
+	struct pvs_cache_s *pvs_cache; // decompressed rows, created on the first Mod_LeafPVS
+	byte			   *lightdata;
+	char			   *entities;
 
 	qboolean viswarn;	 // for Mod_DecompressVis()
 	qboolean bogus_tree; // BSP node tree doesn't visit nummodelsurfaces surfaces
@@ -670,6 +686,8 @@ typedef struct qmodel_s
 	int	 used_water_surfs;
 	int	 water_surfs_specials; // which surfaces are in water_surfs (SURF_DRAWWATER, SURF_DRAWLAVA, SURF_DRAWSLIME, SURF_DRAWTELE) to track transparency changes
 
+	byte *fat_pvs; // worldmodel only: fat pvs row of each leaf, built by SV_BuildFatPVS
+
 	//
 	// additional model data
 	//
@@ -690,10 +708,12 @@ qmodel_t *Mod_ForName (const char *name, qboolean crash);
 void	 *Mod_Extradata_CheckSkin (qmodel_t *mod, int skinnum);
 void	 *Mod_Extradata (qmodel_t *mod);
 void	  Mod_TouchModel (const char *name);
+void	  Mod_PrefetchModel (const char *name);
 void	  Mod_RefreshSkins_f (cvar_t *var);
 
 mleaf_t *Mod_PointInLeaf (float *p, qmodel_t *model);
 byte	*Mod_LeafPVS (mleaf_t *leaf, qmodel_t *model);
+void	 Mod_DecompressVisRow (byte *in, qmodel_t *model, byte *out);
 byte	*Mod_NoVisPVS (qmodel_t *model);
 
 void Mod_SetExtraFlags (qmodel_t *mod);
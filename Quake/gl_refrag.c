@@ -35,9 +35,12 @@ mnode_t *r_pefragtopnode;
 ericw -- GLQuake only uses efrags for static entities, and they're never
 removed, so I trimmed out unused functionality and fields in efrag_t.
 
-Now, efrags are just a linked list for each leaf of the static
-entities that touch that leaf. The efrags are hunk-allocated so there is no
-fixed limit.
+Now, efrags are just the (leaf, entity) pairs of the static entities that
+touch each leaf, appended to one growing array so there is no fixed limit.
+R_SortEfrags turns them into cl.efrag_entities, grouped by leaf, which the
+leafs index with firstefrag/numefrags. Static entities only show up while
+parsing the signon or from CSQC, so the sort runs once before the next
+frame is drawn instead of on every add.
 
 This is inspired by MH's tutorial, and code from RMQEngine.
 http://forums.insideqc.com/viewtopic.php?t=1930
@@ -50,41 +53,20 @@ static entity_t *r_addent;
 
 #define EXTRA_EFRAGS 128
 
-// based on RMQEngine
+/*
+===================
+R_GetEfrag
+===================
+*/
 static efrag_t *R_GetEfrag (void)
 {
-	// we could just Hunk_Alloc a single efrag_t and return it, but since
-	// the struct is so small (2 pointers) allocate groups of them
-	// to avoid wasting too much space on the hunk allocation headers.
-
-	if (cl.free_efrags)
+	if (cl.num_efrags == cl.max_efrags)
 	{
-		efrag_t *ef = cl.free_efrags;
-		cl.free_efrags = ef->leafnext;
-		ef->leafnext = NULL;
-
-		cl.num_efrags++;
-
-		return ef;
-	}
-	else
-	{
-		int i;
-
-		cl.free_efrags = (efrag_t *)Mem_Alloc (EXTRA_EFRAGS * sizeof (efrag_t));
-
-		// Track allocations so we don't leak
-		cl.efrag_allocs = (efrag_t **)Mem_Realloc (cl.efrag_allocs, sizeof (efrag_t **) * (cl.num_efragallocs + 1));
-		cl.efrag_allocs[cl.num_efragallocs++] = cl.free_efrags;
-
-		for (i = 0; i < EXTRA_EFRAGS - 1; i++)
-			cl.free_efrags[i].leafnext = &cl.free_efrags[i + 1];
-
-		cl.free_efrags[i].leafnext = NULL;
-
-		// call recursively to get a newly allocated free efrag
-		return R_GetEfrag ();
+		cl.max_efrags = q_max (EXTRA_EFRAGS, cl.max_efrags * 2);
+		cl.efrags = (efrag_t *)Mem_Realloc (cl.efrags, cl.max_efrags * sizeof (efrag_t));
 	}
+	cl.efrags_dirty = true;
+	return &cl.efrags[cl.num_efrags++];
 }
 
 /*
@@ -96,8 +78,7 @@ void R_SplitEntityOnNode (mnode_t *node)
 {
 	efrag_t	 *ef;
 	mplane_t *splitplane;
-	mleaf_t	 *leaf;
-	int		  sides;
+	int		  sides, leafnum;
 
 	if (node->contents == CONTENTS_SOLID)
 	{
@@ -111,16 +92,14 @@ void R_SplitEntityOnNode (mnode_t *node)
 		if (!r_pefragtopnode)
 			r_pefragtopnode = node;
 
-		leaf = (mleaf_t *)node;
+		leafnum = (mleaf_t *)node - cl.worldmodel->leafs;
+		if (leafnum > cl.worldmodel->numleafs)
+			return; // not a visleaf, never drawn
 
-		// grab an efrag off the free list
 		ef = R_GetEfrag ();
+		ef->leafnum = leafnum;
 		ef->entity = r_addent;
 
-		// set the leaf links
-		ef->leafnext = leaf->efrags;
-		leaf->efrags = ef;
-
 		return;
 	}
 
@@ -200,19 +179,58 @@ void R_AddEfrags (entity_t *ent)
 	R_CheckEfrags (); // johnfitz
 }
 
+/*
+================
+R_SortEfrags
+
+Groups the efrags by leaf if static entities were added since the last call
+================
+*/
+void R_SortEfrags (void)
+{
+	int		 i, first;
+	mleaf_t *leafs, *leaf;
+
+	if (!cl.efrags_dirty || !cl.worldmodel)
+		return;
+	cl.efrags_dirty = false;
+
+	leafs = cl.worldmodel->leafs;
+	for (i = 0; i <= cl.worldmodel->numleafs; i++)
+		leafs[i].numefrags = 0;
+	for (i = 0; i < cl.num_efrags; i++)
+		leafs[cl.efrags[i].leafnum].numefrags++;
+
+	first = 0;
+	for (i = 0; i <= cl.worldmodel->numleafs; i++)
+	{
+		leafs[i].firstefrag = first;
+		first += leafs[i].numefrags;
+		leafs[i].numefrags = 0;
+	}
+
+	cl.efrag_entities = (entity_t **)Mem_Realloc (cl.efrag_entities, cl.max_efrags * sizeof (entity_t *));
+	for (i = 0; i < cl.num_efrags; i++)
+	{
+		leaf = &leafs[cl.efrags[i].leafnum];
+		cl.efrag_entities[leaf->firstefrag + leaf->numefrags++] = cl.efrags[i].entity;
+	}
+}
+
 /*
 ================
 R_StoreEfrags -- johnfitz -- pointless switch statement removed.
 ================
 */
-void R_StoreEfrags (efrag_t **ppefrag)
+void R_StoreEfrags (mleaf_t *leaf)
 {
-	entity_t *pent;
-	efrag_t	 *pefrag;
+	entity_t  *pent;
+	entity_t **efrags = &cl.efrag_entities[leaf->firstefrag];
+	int		   i;
 
-	while ((pefrag = *ppefrag) != NULL)
+	for (i = 0; i < leaf->numefrags; i++)
 	{
-		pent = pefrag->entity;
+		pent = efrags[i];
 		if ((pent->visframe != r_framecount) && (cl_numvisedicts < cl_maxvisedicts))
 		{
 #ifdef PSET_SCRIPT
@@ -261,6 +279,5 @@ void R_StoreEfrags (efrag_t **ppefrag)
 				R_UpdateEntityMoveState (pent);
 			}
 		}
-		ppefrag = &pefrag->leafnext;
 	}
 }
@@ -28,6 +28,8 @@ int r_dlightframecount;
 extern cvar_t r_flatlightstyles; // johnfitz
 extern cvar_t r_lerplightstyles;
 extern cvar_t r_gpulightmapupdate;
+extern cvar_t r_clustereddlights;
+extern cvar_t gl_farclip;
 
 /*
 ==================
@@ -177,6 +179,216 @@ void R_PushDlights (void)
 /*
 =============================================================================
 
+CLUSTERED DYNAMIC LIGHTS
+
+The view frustum is split into DLIGHT_CLUSTERS_X * DLIGHT_CLUSTERS_Y tiles and DLIGHT_CLUSTERS_Z
+exponential depth slices. dlight_clusters.comp bins the dlights into per-froxel bit masks each frame
+and the world fragment shaders add the lights of their froxel on top of the static lightmap, so
+dlights no longer force lightmap blocks to be recomputed.
+
+=============================================================================
+*/
+
+// Keep in sync with Shaders/dlight_clusters.inc
+#define DLIGHT_CLUSTERS_X	 16
+#define DLIGHT_CLUSTERS_Y	 8
+#define DLIGHT_CLUSTERS_Z	 24
+#define DLIGHT_CLUSTER_COUNT (DLIGHT_CLUSTERS_X * DLIGHT_CLUSTERS_Y * DLIGHT_CLUSTERS_Z)
+#define DLIGHT_CLUSTER_MASKS ((MAX_DLIGHTS + 31) / 32)
+#define DLIGHT_CLUSTER_NEAR	 8.0f
+
+typedef struct dlight_cluster_light_s
+{
+	vec3_t origin;
+	float  radius;
+	vec3_t color;
+	float  minlight;
+} dlight_cluster_light_t;
+
+typedef struct dlight_clusters_ubo_s
+{
+	float				   viewport[4];
+	float				   ndc_to_view[2];
+	float				   cluster_near;
+	float				   log_scale;
+	uint32_t			   num_dlights;
+	uint32_t			   padding[3];
+	dlight_cluster_light_t dlights[MAX_DLIGHTS];
+} dlight_clusters_ubo_t;
+COMPILE_TIME_ASSERT (dlight_clusters_ubo_t, sizeof (dlight_clusters_ubo_t) == 48 + MAX_DLIGHTS * 32);
+
+static VkBuffer		   dlight_clusters_ubo;
+static VkBuffer		   dlight_clusters_masks;
+static vulkan_memory_t dlight_clusters_ubo_memory;
+static vulkan_memory_t dlight_clusters_masks_memory;
+static byte			  *dlight_clusters_ubo_mapped;
+static size_t		   dlight_clusters_ubo_stride;
+static VkDescriptorSet dlight_clusters_desc_sets[2];
+static int			   dlight_clusters_index;
+static int			   dlight_clusters_num_dlights; // binned this frame, 0 when the lightmaps still blend the dlights
+
+/*
+=============
+R_InitDlightClusters
+=============
+*/
+void R_InitDlightClusters (void)
+{
+	// Both copies live in one buffer, so each has to start at a valid uniform buffer offset
+	dlight_clusters_ubo_stride = q_align (sizeof (dlight_clusters_ubo_t), 256);
+	const size_t masks_size = DLIGHT_CLUSTER_COUNT * DLIGHT_CLUSTER_MASKS * sizeof (uint32_t);
+
+	ZEROED_STRUCT_ARRAY (buffer_create_info_t, ubo_create_info, 1);
+	ubo_create_info[0].buffer = &dlight_clusters_ubo;
+	ubo_create_info[0].size = dlight_clusters_ubo_stride * 2;
+	ubo_create_info[0].usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+	ubo_create_info[0].mapped = (void **)&dlight_clusters_ubo_mapped;
+	ubo_create_info[0].name = "Dlight clusters";
+	R_CreateBuffers (
+		1, ubo_create_info, &dlight_clusters_ubo_memory, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, VK_MEMORY_PROPERTY_HOST_CACHED_BIT,
+		&num_vulkan_misc_allocations, "Dlight clusters");
+	R_CreateBuffer (
+		&dlight_clusters_masks, &dlight_clusters_masks_memory, masks_size * 2, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0,
+		&num_vulkan_misc_allocations, NULL, "Dlight cluster masks");
+
+	for (int i = 0; i < 2; ++i)
+	{
+		memset (dlight_clusters_ubo_mapped + (i * dlight_clusters_ubo_stride), 0, sizeof (dlight_clusters_ubo_t));
+		dlight_clusters_desc_sets[i] = R_AllocateDescriptorSet (&vulkan_globals.dlight_cluster_set_layout);
+
+		ZEROED_STRUCT (VkDescriptorBufferInfo, ubo_info);
+		ubo_info.buffer = dlight_clusters_ubo;
+		ubo_info.offset = i * dlight_clusters_ubo_stride;
+		ubo_info.range = sizeof (dlight_clusters_ubo_t);
+
+		ZEROED_STRUCT (VkDescriptorBufferInfo, masks_info);
+		masks_info.buffer = dlight_clusters_masks;
+		masks_info.offset = i * masks_size;
+		masks_info.range = masks_size;
+
+		ZEROED_STRUCT_ARRAY (VkWriteDescriptorSet, writes, 2);
+		writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writes[0].dstBinding = 0;
+		writes[0].dstArrayElement = 0;
+		writes[0].descriptorCount = 1;
+		writes[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		writes[0].dstSet = dlight_clusters_desc_sets[i];
+		writes[0].pBufferInfo = &ubo_info;
+		writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writes[1].dstBinding = 1;
+		writes[1].dstArrayElement = 0;
+		writes[1].descriptorCount = 1;
+		writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		writes[1].dstSet = dlight_clusters_desc_sets[i];
+		writes[1].pBufferInfo = &masks_info;
+		vkUpdateDescriptorSets (vulkan_globals.device, countof (writes), writes, 0, NULL);
+	}
+	vulkan_globals.dlight_cluster_desc_set = dlight_clusters_desc_sets[0];
+}
+
+/*
+=============
+R_ClusteredDlights
+=============
+*/
+qboolean R_ClusteredDlights (void)
+{
+	return r_clustereddlights.value && r_gpulightmapupdate.value;
+}
+
+/*
+=============
+R_SetupDlightClusters
+
+Fills this frame's cluster parameters and view space dlights, must run after R_SetupMatrices
+=============
+*/
+void R_SetupDlightClusters (void)
+{
+	dlight_clusters_index = (dlight_clusters_index + 1) % 2;
+	vulkan_globals.dlight_cluster_desc_set = dlight_clusters_desc_sets[dlight_clusters_index];
+
+	dlight_clusters_ubo_t *ubo = (dlight_clusters_ubo_t *)(dlight_clusters_ubo_mapped + (dlight_clusters_index * dlight_clusters_ubo_stride));
+	const float			  *view = vulkan_globals.view_matrix;
+	const float			  *projection = vulkan_globals.projection_matrix;
+	const float			   far_depth = q_max (gl_farclip.value, DLIGHT_CLUSTER_NEAR * 2.0f);
+
+	memcpy (ubo->viewport, vulkan_globals.viewport, sizeof (ubo->viewport));
+	ubo->ndc_to_view[0] = 1.0f / projection[0 * 4 + 0];
+	ubo->ndc_to_view[1] = 1.0f / projection[1 * 4 + 1];
+	ubo->cluster_near = DLIGHT_CLUSTER_NEAR;
+	ubo->log_scale = DLIGHT_CLUSTERS_Z / logf (far_depth / DLIGHT_CLUSTER_NEAR);
+
+	int num_dlights = 0;
+	if (R_ClusteredDlights () && r_dynamic.value)
+	{
+		for (int i = 0; i < MAX_DLIGHTS; ++i)
+		{
+			const dlight_t *dl = &cl_dlights[i];
+			if (dl->die < cl.time || dl->radius == 0.0f || (dl->radius < dl->minlight))
+				continue;
+
+			// The view matrix looks down -z, the clusters use the positive depth
+			vec3_t origin;
+			for (int j = 0; j < 3; ++j)
+				origin[j] = view[0 * 4 + j] * dl->origin[0] + view[1 * 4 + j] * dl->origin[1] + view[2 * 4 + j] * dl->origin[2] + view[3 * 4 + j];
+			origin[2] = -origin[2];
+			if (origin[2] < -dl->radius)
+				continue;
+
+			dlight_cluster_light_t *light = &ubo->dlights[num_dlights++];
+			VectorCopy (origin, light->origin);
+			light->radius = dl->radius;
+			VectorCopy (dl->color, light->color);
+			light->minlight = dl->minlight;
+		}
+	}
+	ubo->num_dlights = num_dlights;
+	dlight_clusters_num_dlights = num_dlights;
+}
+
+/*
+=============
+R_BinDlightClusters
+=============
+*/
+void R_BinDlightClusters (cb_context_t *cbx)
+{
+	if (dlight_clusters_num_dlights == 0)
+		return;
+
+	R_BeginDebugUtilsLabel (cbx, "Bin Dlights");
+
+	{
+		// The previous frame's world may still read the masks of this copy
+		ZEROED_STRUCT (VkMemoryBarrier, memory_barrier);
+		memory_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		memory_barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		memory_barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		vulkan_globals.vk_cmd_pipeline_barrier (
+			cbx->cb, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memory_barrier, 0, NULL, 0, NULL);
+	}
+
+	R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_COMPUTE, vulkan_globals.dlight_clusters_pipeline);
+	vulkan_globals.vk_cmd_bind_descriptor_sets (
+		cbx->cb, VK_PIPELINE_BIND_POINT_COMPUTE, vulkan_globals.dlight_clusters_pipeline.layout.handle, 0, 1, &vulkan_globals.dlight_cluster_desc_set, 0, NULL);
+	vkCmdDispatch (cbx->cb, (DLIGHT_CLUSTER_COUNT + 63) / 64, 1, 1);
+
+	{
+		ZEROED_STRUCT (VkMemoryBarrier, memory_barrier);
+		memory_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		memory_barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		memory_barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		vulkan_globals.vk_cmd_pipeline_barrier (
+			cbx->cb, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 1, &memory_barrier, 0, NULL, 0, NULL);
+	}
+
+	R_EndDebugUtilsLabel (cbx);
+}
+
+/*
+=============================================================================
+
 LIGHT SAMPLING
 
 =============================================================================
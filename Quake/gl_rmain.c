@@ -31,10 +31,14 @@ extern int UI_IsMainMenuStartupPending (void);
 int r_visframecount; // bumped when going to a new PVS
 int r_framecount;	 // used for dlight push checking
 
+static entity_render_state_t *entity_render_states;
+static int					  max_entity_render_states;
+
 mplane_t frustum[4];
 
 qboolean render_warp;
 int		 render_scale;
+float	 dynamic_render_scale = 1.0f;
 
 // johnfitz -- rendering statistics
 atomic_uint32_t rs_brushpolys, rs_aliaspolys, rs_skypolys, rs_particles, rs_fogpolys;
@@ -98,7 +102,6 @@ cvar_t r_nolerp_list = {
 	"v_xfist.mdl,progs/h2stuff/newfire.mdl",
 	CVAR_NONE};
 
-extern cvar_t r_vfog;
 // johnfitz
 
 cvar_t gl_zfix = {"gl_zfix", "1", CVAR_ARCHIVE}; // QuakeSpasm z-fighting fix
@@ -113,19 +116,23 @@ float map_fallbackalpha;
 qboolean r_drawworld_cheatsafe, r_fullbright_cheatsafe, r_lightmap_cheatsafe; // johnfitz
 
 cvar_t r_scale = {"r_scale", "1", CVAR_ARCHIVE};
+cvar_t r_dynamicres = {"r_dynamicres", "0", CVAR_ARCHIVE}; // target GPU frames per second, 0 disables dynamic resolution
+cvar_t r_dynamicres_min = {"r_dynamicres_min", "0.5", CVAR_ARCHIVE};
 
 cvar_t r_gpulightmapupdate = {"r_gpulightmapupdate", "1", CVAR_NONE};
+cvar_t r_clustereddlights = {"r_clustereddlights", "1", CVAR_ARCHIVE}; // shade dlights per pixel instead of blending them into the lightmaps
 cvar_t r_rtshadows = {"r_rtshadows", "1", CVAR_ARCHIVE};
 
 cvar_t r_tasks = {"r_tasks", "1", CVAR_NONE};
+cvar_t r_aliasinstancing = {"r_aliasinstancing", "1", CVAR_ARCHIVE};
+cvar_t r_aliaslod = {"r_aliaslod", "1", CVAR_ARCHIVE}; // scales the screen sizes simplified alias meshes are used at, 0 disables them
+cvar_t r_bindless = {"r_bindless", "1", CVAR_ARCHIVE};
 
 cvar_t			r_indirect = {"r_indirect", "1", CVAR_NONE};
 extern qboolean indirect_ready;
 
 extern SDL_Mutex *draw_qcvm_mutex;
 
-static atomic_uint32_t next_visedict;
-
 /*
 =================
 R_CullBox -- johnfitz -- replaced with new function from lordhavoc
@@ -153,13 +160,12 @@ qboolean R_CullBox (vec3_t emins, vec3_t emaxs)
 }
 /*
 ===============
-R_CullModelForEntity -- johnfitz -- uses correct bounds based on rotation
+R_EntityBounds -- johnfitz -- uses correct bounds based on rotation
 ===============
 */
-qboolean R_CullModelForEntity (entity_t *e)
+static void R_EntityBounds (entity_t *e, vec3_t mins, vec3_t maxs)
 {
-	vec3_t mins, maxs;
-	vec_t  scalefactor, *minbounds, *maxbounds;
+	vec_t scalefactor, *minbounds, *maxbounds;
 
 	if (e->angles[0] || e->angles[2]) // pitch or roll
 	{
@@ -188,7 +194,17 @@ qboolean R_CullModelForEntity (entity_t *e)
 		VectorAdd (e->origin, minbounds, mins);
 		VectorAdd (e->origin, maxbounds, maxs);
 	}
+}
 
+/*
+===============
+R_CullModelForEntity
+===============
+*/
+qboolean R_CullModelForEntity (entity_t *e)
+{
+	vec3_t mins, maxs;
+	R_EntityBounds (e, mins, maxs);
 	return R_CullBox (mins, maxs);
 }
 
@@ -325,6 +341,16 @@ R_SetupMatrices
 */
 static void R_SetupMatrices ()
 {
+	// The depth pyramid used for occlusion culling is built from the previous view
+	memcpy (vulkan_globals.prev_view_projection_matrix, vulkan_globals.view_projection_matrix, 16 * sizeof (float));
+	memcpy (vulkan_globals.prev_viewport, vulkan_globals.viewport, 4 * sizeof (float));
+
+	// Viewport in framebuffer pixels, matches R_SetViewport
+	vulkan_globals.viewport[0] = r_refdef.vrect.x * dynamic_render_scale;
+	vulkan_globals.viewport[1] = (vid.height - glheight + r_refdef.vrect.y) * dynamic_render_scale;
+	vulkan_globals.viewport[2] = r_refdef.vrect.width * dynamic_render_scale;
+	vulkan_globals.viewport[3] = r_refdef.vrect.height * dynamic_render_scale;
+
 	// Projection matrix
 	GL_FrustumMatrix (vulkan_globals.projection_matrix, DEG2RAD (r_fovx), DEG2RAD (r_fovy));
 
@@ -349,6 +375,63 @@ static void R_SetupMatrices ()
 	MatrixMultiply (vulkan_globals.view_projection_matrix, vulkan_globals.view_matrix);
 }
 
+/*
+=============
+R_SetViewport
+
+The 3D view is shrunk towards the top left corner of the framebuffer by the dynamic resolution scale,
+GL_ScreenEffects upscales it back to the full size
+=============
+*/
+static void R_SetViewport (cb_context_t *cbx, float min_depth, float max_depth)
+{
+	const float width = r_refdef.vrect.width * dynamic_render_scale;
+	const float height = r_refdef.vrect.height * dynamic_render_scale;
+	const float y = (vid.height - glheight + r_refdef.vrect.y) * dynamic_render_scale;
+	GL_Viewport (cbx, r_refdef.vrect.x * dynamic_render_scale, vid.height - y - height, width, height, min_depth, max_depth);
+}
+
+/*
+=============
+R_UpdateDynamicResolution
+
+Adjusts the 3D render scale to hold the GPU frame time requested by r_dynamicres. The timestamps lag
+behind by the frames in flight, so the scale is left alone for a few frames after each change.
+=============
+*/
+static void R_UpdateDynamicResolution (void)
+{
+	static int settle_frames;
+
+	const double gpu_time = GL_GetLastFrameGPUTime ();
+	if (r_dynamicres.value <= 0.0f || render_scale >= 2 || gpu_time <= 0.0)
+	{
+		dynamic_render_scale = 1.0f;
+		return;
+	}
+
+	const float min_scale = CLAMP (0.25f, r_dynamicres_min.value, 1.0f);
+	if (settle_frames > 0)
+		--settle_frames;
+	else
+	{
+		// GPU time scales roughly with the pixel count, i.e. with the square of the scale
+		const double budget = 1000.0 / r_dynamicres.value;
+		float		 new_scale = dynamic_render_scale;
+		if (gpu_time > budget * 0.95)
+			new_scale = dynamic_render_scale * q_max (0.85f, (float)sqrt (budget * 0.9 / gpu_time));
+		else if (gpu_time < budget * 0.75)
+			new_scale = dynamic_render_scale * q_min (1.05f, (float)sqrt (budget * 0.85 / gpu_time));
+		new_scale = CLAMP (min_scale, new_scale, 1.0f);
+		if (fabsf (new_scale - dynamic_render_scale) >= 0.01f)
+		{
+			dynamic_render_scale = new_scale;
+			settle_frames = vulkan_globals.num_frames_in_flight + 1;
+		}
+	}
+	dynamic_render_scale = CLAMP (min_scale, dynamic_render_scale, 1.0f);
+}
+
 /*
 =============
 R_SetupContext
@@ -356,7 +439,7 @@ R_SetupContext
 */
 static void R_SetupContext (cb_context_t *cbx)
 {
-	GL_Viewport (cbx, r_refdef.vrect.x, glheight - r_refdef.vrect.y - r_refdef.vrect.height, r_refdef.vrect.width, r_refdef.vrect.height, 0.0f, 1.0f);
+	R_SetViewport (cbx, 0.0f, 1.0f);
 	R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.basic_blend_pipeline[cbx->render_pass_index]);
 	R_PushConstants (cbx, VK_SHADER_STAGE_ALL_GRAPHICS, 0, 16 * sizeof (float), vulkan_globals.view_projection_matrix);
 }
@@ -389,6 +472,7 @@ static void R_SetupViewBeforeMark (void *unused)
 	r_fovy = r_refdef.fov_y;
 	render_warp = false;
 	render_scale = (int)r_scale.value;
+	R_UpdateDynamicResolution ();
 
 	if (r_waterwarp.value)
 	{
@@ -410,6 +494,7 @@ static void R_SetupViewBeforeMark (void *unused)
 
 	R_SetFrustum (r_fovx, r_fovy); // johnfitz -- use r_fov* vars
 	R_SetupMatrices ();
+	R_SetupDlightClusters ();
 
 	// johnfitz -- cheat-protect some draw modes
 	r_fullbright_cheatsafe = false;
@@ -430,6 +515,13 @@ static void R_SetupViewBeforeMark (void *unused)
 		r_lightmap_cheatsafe = false;
 	}
 	// johnfitz
+
+	// one render state per visedict plus the view model
+	if (cl_maxvisedicts + 1 > max_entity_render_states)
+	{
+		max_entity_render_states = cl_maxvisedicts + 1;
+		entity_render_states = Mem_Realloc (entity_render_states, sizeof (entity_render_state_t) * max_entity_render_states);
+	}
 }
 
 //==============================================================================
@@ -438,6 +530,130 @@ static void R_SetupViewBeforeMark (void *unused)
 //
 //==============================================================================
 
+/*
+=============
+R_CullEntityRenderStates
+
+Frustum culls the entities of a range of render states, 32 at a time with the leaf culling kernel when SIMD is enabled
+=============
+*/
+static void R_CullEntityRenderStates (int first, int last)
+{
+#if defined(USE_SIMD)
+	if (use_simd)
+	{
+		soa_aabb_t boxes[4];
+		for (int base = first; base < last; base += 32)
+		{
+			const int count = q_min (32, last - base);
+			uint32_t  activelanes = 0;
+			for (int j = 0; j < count; ++j)
+			{
+				entity_t *e = entity_render_states[base + j].entity;
+				if (!e)
+					continue;
+				vec3_t mins, maxs;
+				R_EntityBounds (e, mins, maxs);
+				float *box = boxes[j / 8];
+				for (int k = 0; k < 3; ++k)
+				{
+					box[k * 16 + j % 8] = mins[k];
+					box[k * 16 + 8 + j % 8] = maxs[k];
+				}
+				activelanes |= 1u << j;
+			}
+			const uint32_t visible = R_CullBoxesSIMD (boxes, activelanes);
+			for (int j = 0; j < count; ++j)
+				entity_render_states[base + j].culled = !(visible & (1u << j));
+		}
+		return;
+	}
+#endif
+	for (int i = first; i < last; ++i)
+		if (entity_render_states[i].entity)
+			entity_render_states[i].culled = R_CullModelForEntity (entity_render_states[i].entity);
+}
+
+/*
+=============
+R_SetupEntityRenderStates
+
+Computes lerped transforms for cl_visedicts, the view model and the lightning
+segments, so draw, show tris and TLAS paths don't have to redo them. Runs after
+R_StoreEfrags.
+=============
+*/
+void R_SetupEntityRenderStates (int index, void *use_tasks)
+{
+	const int num_states = cl_numvisedicts + 1;
+	const int first = use_tasks ? (num_states * index / NUM_ENTITY_STATE_TASKS) : 0;
+	const int last = use_tasks ? (num_states * (index + 1) / NUM_ENTITY_STATE_TASKS) : num_states;
+	for (int i = first; i < last; ++i)
+	{
+		entity_t			  *e = (i < cl_numvisedicts) ? cl_visedicts[i] : &cl.viewent;
+		entity_render_state_t *state = &entity_render_states[i];
+
+		e->render_state = i;
+		state->entity = e->model ? e : NULL;
+		if (!e->model)
+			continue;
+
+		// johnfitz -- chasecam
+		if (e == &cl.entities[cl.viewentity])
+			e->angles[0] *= 0.3;
+		// johnfitz
+	}
+
+	R_CullEntityRenderStates (first, last);
+
+	for (int i = first; i < last; ++i)
+	{
+		entity_render_state_t *state = &entity_render_states[i];
+		entity_t			  *e = state->entity;
+		if (!e)
+			continue;
+
+		if (e->model->type == mod_alias)
+		{
+			if (e == &cl.viewent)
+				R_UpdateEntityAnimState (e, (aliashdr_t *)Mod_Extradata (e->model));
+			R_SetupAliasRenderState (e, state);
+			continue;
+		}
+
+		VectorCopy (e->origin, state->lerpdata.origin);
+		VectorCopy (e->angles, state->lerpdata.angles);
+		IdentityMatrix (state->model_matrix);
+		if (e->model->type == mod_brush)
+		{
+			vec3_t e_angles;
+			VectorCopy (e->angles, e_angles);
+			e_angles[0] = -e_angles[0]; // stupid quake bug
+			R_RotateForEntity (state->model_matrix, e->origin, e_angles, e->netstate.scale);
+		}
+	}
+
+	const int num_beams = cl_num_beam_segments;
+	const int first_beam = use_tasks ? (num_beams * index / NUM_ENTITY_STATE_TASKS) : 0;
+	const int last_beam = use_tasks ? (num_beams * (index + 1) / NUM_ENTITY_STATE_TASKS) : num_beams;
+	R_SetupBeamRenderStates (first_beam, last_beam);
+}
+
+/*
+=============
+R_GetEntityRenderState
+
+Returns NULL if the entity wasn't visible this frame
+=============
+*/
+entity_render_state_t *R_GetEntityRenderState (entity_t *e)
+{
+	const int i = e->render_state;
+	if ((i < 0) || (i > cl_numvisedicts) || (i >= max_entity_render_states) || (entity_render_states[i].entity != e))
+		return NULL;
+	return &entity_render_states[i];
+}
+
 /*
 =============
 R_IsEntityTransparent
@@ -455,17 +671,65 @@ static qboolean R_IsEntityTransparent (entity_t *e, qboolean *opaque_with_transp
 	return transparent;
 }
 
+/*
+=============
+R_EntityRecordCost
+
+Rough CPU cost of recording an opaque entity, used to balance the entity command buffers
+=============
+*/
+static int R_EntityRecordCost (entity_t *e)
+{
+	qboolean opaque_with_transparent_water;
+	if (R_IsEntityTransparent (e, &opaque_with_transparent_water) && !opaque_with_transparent_water)
+		return 0;
+	if (e->model->type == mod_brush)
+		return 1 + e->model->nummodelsurfaces / 16;
+	return 1;
+}
+
+/*
+=============
+R_GetEntitySlice
+
+Splits list into num_slices contiguous ranges of similar cost. Every task computes the same split,
+so each entity always lands in the same command buffer and the buffers are executed in list order.
+=============
+*/
+static void R_GetEntitySlice (entity_t **list, int total, int slice, int num_slices, int *first, int *last)
+{
+	int total_cost = 0;
+	for (int i = 0; i < total; ++i)
+		total_cost += R_EntityRecordCost (list[i]);
+
+	*first = total;
+	*last = total;
+	int cost = 0;
+	for (int i = 0; i < total; ++i)
+	{
+		const int entity_slice = (int)((int64_t)cost * num_slices / q_max (total_cost, 1));
+		if (entity_slice > slice)
+		{
+			*last = i;
+			break;
+		}
+		if ((entity_slice == slice) && (*first == total))
+			*first = i;
+		cost += R_EntityRecordCost (list[i]);
+	}
+	*first = q_min (*first, *last);
+}
+
 /*
 =============
 R_DrawEntitiesOnList
 
 alphapass 0 for opaque, 1 for transparent overwater, 2 for transpatent underwater
+slice selects the part of the list recorded into this cbx out of num_slices
 =============
 */
-void R_DrawEntitiesOnList (cb_context_t *cbx, int alphapass, int chain, qboolean use_tasks) // johnfitz -- added parameter
+void R_DrawEntitiesOnList (cb_context_t *cbx, int alphapass, int chain, int slice, int num_slices) // johnfitz -- added parameter
 {
-	int i = -1;
-
 	if (!r_drawentities.value)
 		return;
 
@@ -477,21 +741,29 @@ void R_DrawEntitiesOnList (cb_context_t *cbx, int alphapass, int chain, qboolean
 	const int		 total = !alphapass ? cl_numvisedicts : alphapass == 1 ? cl_numvisedicts_alpha_overwater : cl_numvisedicts_alpha_underwater;
 	entity_t **const list = !alphapass ? cl_visedicts : alphapass == 1 ? cl_visedicts_alpha : cl_visedicts_alpha + cl_numvisedicts_alpha_overwater;
 
+	int first = 0;
+	int last = total;
+	if (num_slices > 1)
+		R_GetEntitySlice (list, total, slice, num_slices, &first, &last);
+
+	// Opaque alias models are collected and drawn instanced once the list is done
+	const qboolean use_instancing = !alphapass && r_aliasinstancing.value;
+	const int	   max_instances = q_min (last - first, MAX_ALIAS_BATCH);
+	alias_instance_t *alias_instances = use_instancing ? (alias_instance_t *)Mem_FrameAlloc (max_instances * sizeof (alias_instance_t)) : NULL;
+	alias_batch_t alias_batch = {alias_instances, 0, max_instances};
+
+	// Sprites use an alpha tested pipeline, so in the opaque pass they can be grouped by frame texture too
+	const int		   max_sprites = !alphapass ? q_min (last - first, MAX_SPRITE_BATCH) : 0;
+	sprite_instance_t *sprite_instances = max_sprites ? (sprite_instance_t *)Mem_FrameAlloc (max_sprites * sizeof (sprite_instance_t)) : NULL;
+	sprite_batch_t	   sprite_batch = {sprite_instances, 0, max_sprites};
+
 	R_BeginDebugUtilsLabel (cbx, alphapass ? "Entities Alpha Pass" : "Entities");
 #ifdef USE_RMLUI
 	const qboolean suppress_viewmodel = UI_IsMainMenuStartupPending ();
 #endif
 	// johnfitz -- sprites are not a special case
-	while (true)
+	for (int i = first; i < last; ++i)
 	{
-		if (use_tasks)
-			i = Atomic_IncrementUInt32 (&next_visedict);
-		else
-			i += 1;
-
-		if (i >= total)
-			break;
-
 		entity_t *currententity = list[i];
 
 		qboolean opaque_with_transparent_water;
@@ -502,11 +774,6 @@ void R_DrawEntitiesOnList (cb_context_t *cbx, int alphapass, int chain, qboolean
 		if (transparent != !!alphapass && !opaque_with_transparent_water)
 			continue;
 
-		// johnfitz -- chasecam
-		if (currententity == &cl.entities[cl.viewentity])
-			currententity->angles[0] *= 0.3;
-		// johnfitz
-
 		// spike -- this would be more efficient elsewhere, but its more correct here.
 		if (currententity->eflags & EFLAGS_EXTERIORMODEL)
 			continue;
@@ -521,7 +788,7 @@ void R_DrawEntitiesOnList (cb_context_t *cbx, int alphapass, int chain, qboolean
 		switch (currententity->model->type)
 		{
 		case mod_alias:
-			R_DrawAliasModel (cbx, currententity, &aliaspolys);
+			R_DrawAliasModel (cbx, currententity, &aliaspolys, alias_batch.instances ? &alias_batch : NULL);
 			++aliaspasses;
 			break;
 		case mod_brush:
@@ -531,10 +798,16 @@ void R_DrawEntitiesOnList (cb_context_t *cbx, int alphapass, int chain, qboolean
 			++brushpasses;
 			break;
 		case mod_sprite:
-			R_DrawSpriteModel (cbx, currententity);
+			R_DrawSpriteModel (cbx, currententity, sprite_batch.instances ? &sprite_batch : NULL);
 			break;
 		}
 	}
+	if (!alphapass && (slice == 0))
+		R_DrawBeams (cbx, &aliaspolys, alias_batch.instances ? &alias_batch : NULL);
+	if (use_instancing)
+		R_DrawAliasBatch (cbx, &alias_batch);
+	if (sprite_batch.instances)
+		R_DrawSpriteBatch (cbx, &sprite_batch);
 	R_EndDebugUtilsLabel (cbx);
 
 	Atomic_AddUInt32 (&rs_brushpolys, brushpolys);
@@ -574,16 +847,14 @@ void R_DrawViewModel (cb_context_t *cbx)
 	R_BeginDebugUtilsLabel (cbx, "View Model");
 
 	// hack the depth range to prevent view model from poking into walls
-	GL_Viewport (cbx, r_refdef.vrect.x, glheight - r_refdef.vrect.y - r_refdef.vrect.height, r_refdef.vrect.width, r_refdef.vrect.height, 0.7f, 1.0f);
+	R_SetViewport (cbx, 0.7f, 1.0f);
 
-	int			aliaspolys = 0;
-	aliashdr_t *paliashdr = (aliashdr_t *)Mod_Extradata (currententity->model);
-	R_UpdateEntityAnimState (currententity, paliashdr);
-	R_DrawAliasModel (cbx, currententity, &aliaspolys);
+	int aliaspolys = 0;
+	R_DrawAliasModel (cbx, currententity, &aliaspolys, NULL);
 	Atomic_AddUInt32 (&rs_aliaspolys, aliaspolys);
 	Atomic_IncrementUInt32 (&rs_aliaspasses);
 
-	GL_Viewport (cbx, r_refdef.vrect.x, glheight - r_refdef.vrect.y - r_refdef.vrect.height, r_refdef.vrect.width, r_refdef.vrect.height, 0.0f, 1.0f);
+	R_SetViewport (cbx, 0.0f, 1.0f);
 
 	R_EndDebugUtilsLabel (cbx);
 }
@@ -793,9 +1064,6 @@ void R_ShowTris (cb_context_t *cbx)
 		{
 			entity_t *currententity = cl_visedicts[i];
 
-			if (currententity == &cl.entities[cl.viewentity]) // chasecam
-				currententity->angles[0] *= 0.3;
-
 			switch (currententity->model->type)
 			{
 			case mod_brush:
@@ -811,6 +1079,7 @@ void R_ShowTris (cb_context_t *cbx)
 				break;
 			}
 		}
+		R_DrawBeams_ShowTris (cbx);
 
 		// viewmodel
 		entity_t *currententity = &cl.viewent;
@@ -891,7 +1160,7 @@ static void R_SortAlphaEntitiesTask (void *unused)
 		unsigned sortkey;
 	} transp_sort;
 	cl_numvisedicts_alpha_overwater = cl_numvisedicts_alpha_underwater = 0;
-	TEMP_ALLOC_COND (transp_sort, edicts, cl_numvisedicts * 2, r_alphasort.value);
+	transp_sort *edicts = r_alphasort.value ? (transp_sort *)Mem_FrameAlloc (cl_numvisedicts * 2 * sizeof (transp_sort)) : NULL;
 	int sort_bins[3][128];
 	if (r_alphasort.value)
 		memset (sort_bins, 0, sizeof (sort_bins));
@@ -954,24 +1223,31 @@ static void R_SortAlphaEntitiesTask (void *unused)
 		return;
 
 	const int highest = cl_numvisedicts_alpha_underwater + cl_numvisedicts_alpha_overwater - 1;
+	if (highest < 0)
+		return;
+
+	// a digit shared by all keys leaves the order unchanged, which is usually the case for the top one
+	// (everything over water and closer than 8192 units), so only scatter on the digits that differ
+	transp_sort *from = edicts;
+	transp_sort *to = edicts + cl_numvisedicts;
 	for (int pass = 0; pass < 3; ++pass)
 	{
-		transp_sort *from = pass % 2 ? edicts + cl_numvisedicts : edicts;
-		transp_sort *to = pass % 2 ? edicts : edicts + cl_numvisedicts;
+		if (sort_bins[pass][(from[0].sortkey >> 7 * pass) % 128] == highest + 1)
+			continue;
 		for (int i = 1; i < 128; ++i)
 			sort_bins[pass][i] += sort_bins[pass][i - 1];
 		for (int i = highest; i >= 0; --i)
 		{
 			int key = (from[i].sortkey >> 7 * pass) % 128;
 			sort_bins[pass][key] -= 1;
-			if (pass < 2)
-				to[sort_bins[pass][key]] = from[i];
-			else
-				cl_visedicts_alpha[highest - sort_bins[pass][key]] = cl_visedicts[from[i].visedict];
+			to[sort_bins[pass][key]] = from[i];
 		}
+		transp_sort *const swap = from;
+		from = to;
+		to = swap;
 	}
-
-	TEMP_FREE (edicts);
+	for (int i = 0; i <= highest; ++i)
+		cl_visedicts_alpha[highest - i] = cl_visedicts[from[i].visedict];
 }
 
 /*
@@ -984,7 +1260,7 @@ static void R_DrawEntitiesTask (int index, void *use_tasks)
 	cb_context_t *cbx = &vulkan_globals.secondary_cb_contexts[SCBX_ENTITIES][index];
 	R_SetupContext (cbx);
 	Fog_EnableGFog (cbx); // johnfitz
-	R_DrawEntitiesOnList (cbx, false, index + chain_model_0, use_tasks ? true : false);
+	R_DrawEntitiesOnList (cbx, false, index + chain_model_0, index, use_tasks ? NUM_ENTITIES_CBX : 1);
 }
 
 /*
@@ -1001,7 +1277,7 @@ static void R_DrawAlphaEntitiesTask (int index, void *use_tasks)
 		cb_context_t *cbx = vulkan_globals.secondary_cb_contexts[i ? SCBX_ALPHA_ENTITIES : SCBX_ALPHA_ENTITIES_ACROSS_WATER];
 		R_SetupContext (cbx);
 		Fog_EnableGFog (cbx);
-		R_DrawEntitiesOnList (cbx, underwater ? 1 + i : 2 - i, i ? chain_alpha_model : chain_alpha_model_across_water, false);
+		R_DrawEntitiesOnList (cbx, underwater ? 1 + i : 2 - i, i ? chain_alpha_model : chain_alpha_model_across_water, 0, 1);
 	}
 }
 
@@ -1054,9 +1330,18 @@ static void R_PrintStats (double time1)
 			"x %i y %i z %i (pitch %i yaw %i roll %i)\n", (int)cl.entities[cl.viewentity].origin[0], (int)cl.entities[cl.viewentity].origin[1],
 			(int)cl.entities[cl.viewentity].origin[2], (int)cl.viewangles[PITCH], (int)cl.viewangles[YAW], (int)cl.viewangles[ROLL]);
 	else if (r_speeds.value == 2)
+	{
 		Con_Printf (
 			"%6.3f ms  %4u/%4u wpoly %4u/%4u epoly %5.3g lmap %4u skypoly\n", (time2 - time1) * 1000.0, rs_brushpolys, rs_brushpasses, rs_aliaspolys,
 			rs_aliaspasses, lms, rs_skypolys);
+		if (GL_GetLastFrameGPUTime () > 0.0)
+		{
+			Con_Printf ("%6.3f ms gpu", GL_GetLastFrameGPUTime ());
+			for (int timer = 0; timer < GPU_TIMER_NUM; ++timer)
+				Con_Printf (" %.2f %s", GL_GetLastFrameGPUTimer (timer), gpu_timer_names[timer]);
+			Con_Printf ("\n");
+		}
+	}
 	else if (r_speeds.value)
 		Con_Printf ("%3i ms  %4i wpoly %4i epoly %5.3g lmap\n", (int)((time2 - time1) * 1000), rs_brushpolys, rs_aliaspolys, lms);
 	// johnfitz
@@ -1137,27 +1422,45 @@ void R_RenderView (qboolean use_tasks, task_handle_t begin_rendering_task, task_
 		Task_AddDependency (begin_rendering_task, draw_water_task);
 		Task_AddDependency (draw_water_task, draw_done_task);
 
+		task_handle_t setup_entity_states_task =
+			Task_AllocateAndAssignIndexedFunc (R_SetupEntityRenderStates, NUM_ENTITY_STATE_TASKS, &use_tasks, sizeof (use_tasks));
+		Task_AddDependency (store_efrags, setup_entity_states_task);
+
 		task_handle_t draw_view_model_task = Task_AllocateAndAssignFunc (R_DrawViewModelTask, NULL, 0);
-		Task_AddDependency (before_mark, draw_view_model_task);
+		Task_AddDependency (setup_entity_states_task, draw_view_model_task);
 		Task_AddDependency (begin_rendering_task, draw_view_model_task);
 		Task_AddDependency (draw_view_model_task, draw_done_task);
 
-		Atomic_StoreUInt32 (&next_visedict, 0u);
 		task_handle_t draw_entities_task = Task_AllocateAndAssignIndexedFunc (R_DrawEntitiesTask, NUM_ENTITIES_CBX, &use_tasks, sizeof (use_tasks));
-		Task_AddDependency (store_efrags, draw_entities_task);
+		Task_AddDependency (setup_entity_states_task, draw_entities_task);
 		Task_AddDependency (begin_rendering_task, draw_entities_task);
 
 		task_handle_t draw_alpha_entities_task = Task_AllocateAndAssignIndexedFunc (R_DrawAlphaEntitiesTask, 2, &use_tasks, sizeof (use_tasks));
 		Task_AddDependency (sort_transparents, draw_alpha_entities_task);
+		Task_AddDependency (setup_entity_states_task, draw_alpha_entities_task);
 		Task_AddDependency (begin_rendering_task, draw_alpha_entities_task);
 
+		task_handle_t update_particles_task = Task_AllocateAndAssignFunc (R_UpdateParticles, NULL, 0);
+		Task_AddDependency (before_mark, update_particles_task);
+		Task_AddDependency (begin_rendering_task, update_particles_task);
+
 		task_handle_t draw_particles_task = Task_AllocateAndAssignFunc (R_DrawParticlesTask, NULL, 0);
-		Task_AddDependency (before_mark, draw_particles_task);
-		Task_AddDependency (begin_rendering_task, draw_particles_task);
+		Task_AddDependency (update_particles_task, draw_particles_task);
 		Task_AddDependency (draw_particles_task, draw_done_task);
 
+#ifdef PSET_SCRIPT
+		task_handle_t update_fte_particles_task = Task_AllocateAndAssignFunc (PScript_UpdateParticles, NULL, 0);
+		Task_AddDependency (before_mark, update_fte_particles_task);
+		Task_AddDependency (begin_rendering_task, update_fte_particles_task);
+
+		task_handle_t simulate_fte_particles_task =
+			Task_AllocateAndAssignIndexedFunc (PScript_SimulateParticles, NUM_FTE_PARTICLE_TASKS, &use_tasks, sizeof (use_tasks));
+		Task_AddDependency (update_fte_particles_task, simulate_fte_particles_task);
+		Task_AddDependency (simulate_fte_particles_task, draw_particles_task);
+#endif
+
 		task_handle_t build_tlas_task = Task_AllocateAndAssignFunc (R_BuildTopLevelAccelerationStructure, NULL, 0);
-		Task_AddDependency (store_efrags, build_tlas_task);
+		Task_AddDependency (setup_entity_states_task, build_tlas_task);
 		Task_AddDependency (begin_rendering_task, build_tlas_task);
 		Task_AddDependency (build_tlas_task, draw_done_task);
 
@@ -1180,10 +1483,14 @@ void R_RenderView (qboolean use_tasks, task_handle_t begin_rendering_task, task_
 #endif
 		}
 
-		task_handle_t tasks[] = {before_mark,		  store_efrags,	   update_warp_textures, draw_world_task,	 sort_transparents,
-								 draw_sky_task,		  draw_water_task, draw_view_model_task, draw_entities_task, draw_alpha_entities_task,
-								 draw_particles_task, build_tlas_task, update_lightmaps_task};
+		task_handle_t tasks[] = {before_mark,			   store_efrags,		  update_warp_textures,		draw_world_task,	  sort_transparents,
+								 draw_sky_task,			   draw_water_task,		  setup_entity_states_task,	draw_view_model_task, draw_entities_task,
+								 draw_alpha_entities_task, update_particles_task, draw_particles_task,		build_tlas_task,	  update_lightmaps_task};
 		Tasks_Submit ((sizeof (tasks) / sizeof (task_handle_t)), tasks);
+#ifdef PSET_SCRIPT
+		Task_Submit (update_fte_particles_task);
+		Task_Submit (simulate_fte_particles_task);
+#endif
 		if (cull_surfaces != chain_surfaces)
 		{
 			Task_Submit (cull_surfaces);
@@ -1198,9 +1505,15 @@ void R_RenderView (qboolean use_tasks, task_handle_t begin_rendering_task, task_
 		R_DrawWorldTask (0, NULL);
 		R_DrawSkyTask (NULL);
 		R_DrawWaterTask (NULL);
+		R_SetupEntityRenderStates (0, NULL);
 		R_DrawEntitiesTask (0, NULL);
 		R_SortAlphaEntitiesTask (NULL);
 		R_DrawAlphaEntitiesTask (0, NULL);
+		R_UpdateParticles (NULL);
+#ifdef PSET_SCRIPT
+		PScript_UpdateParticles (NULL);
+		PScript_SimulateParticles (0, NULL);
+#endif
 		R_DrawParticlesTask (NULL);
 		R_DrawViewModelTask (NULL);
 		if (r_gpulightmapupdate.value)
@@ -25,8 +25,13 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "quakedef.h"
 #include "gl_heap.h"
+#include "cfgfile.h"
 #include <float.h>
 
+#ifdef USE_RMLUI
+#include "ui_manager.h"
+#endif
+
 cvar_t r_lodbias = {"r_lodbias", "1", CVAR_ARCHIVE};
 cvar_t gl_lodbias = {"gl_lodbias", "0", CVAR_ARCHIVE};
 
@@ -54,10 +59,16 @@ extern cvar_t gl_zfix; // QuakeSpasm z-fighting fix
 extern cvar_t r_alphasort;
 
 extern cvar_t r_gpulightmapupdate;
+extern cvar_t r_clustereddlights;
 extern cvar_t r_rtshadows;
 extern cvar_t r_indirect;
 extern cvar_t r_tasks;
+extern cvar_t r_aliasinstancing;
+extern cvar_t r_aliaslod;
+extern cvar_t r_bindless;
 extern cvar_t r_parallelmark;
+extern cvar_t r_gpumark;
+extern cvar_t r_worldviewcache;
 extern cvar_t r_usesops;
 
 extern cvar_t r_drawwater_fast;
@@ -84,21 +95,23 @@ atomic_uint32_t num_vulkan_sampled_images;
 atomic_uint32_t num_acceleration_structures;
 atomic_uint64_t total_device_vulkan_allocation_size;
 atomic_uint64_t total_host_vulkan_allocation_size;
+atomic_uint64_t vulkan_memory_category_sizes[VULKAN_MEMORY_CATEGORY_COUNT];
 
-qboolean use_simd;
+#define MEMORY_BUDGET_PRESSURE_PERCENT 90 // device usage above this share of the budget counts as memory pressure
+#define MEMORY_BUDGET_FALLBACK_PERCENT 80 // share of a heap assumed available without VK_EXT_memory_budget
 
-static SDL_Mutex *vertex_allocate_mutex;
-static SDL_Mutex *index_allocate_mutex;
-static SDL_Mutex *uniform_allocate_mutex;
-static SDL_Mutex *storage_allocate_mutex;
-static SDL_Mutex *garbage_mutex;
+static vulkan_memory_budget_t memory_budget;
+
+qboolean use_simd;
 
 /*
 ================
 Staging
 ================
 */
-#define NUM_STAGING_BUFFERS 2
+// Staging buffers form a ring: a full buffer is submitted and allocation moves on to the oldest one,
+// so uploads only block once the GPU falls behind by NUM_STAGING_BUFFERS - 1 buffers
+#define NUM_STAGING_BUFFERS 4
 
 typedef struct
 {
@@ -122,44 +135,73 @@ static SDL_Condition  *staging_cond;
 Dynamic vertex/index & uniform buffer
 ================
 */
-#define INITIAL_DYNAMIC_VERTEX_BUFFER_SIZE_KB  256
-#define INITIAL_DYNAMIC_INDEX_BUFFER_SIZE_KB   1024
-#define INITIAL_DYNAMIC_UNIFORM_BUFFER_SIZE_KB 256
-#define NUM_DYNAMIC_BUFFERS					   2
-#define GARBAGE_FRAME_COUNT					   3
-#define MAX_UNIFORM_ALLOC					   2048
+#define DYNAMIC_VERTEX_BUFFER_BLOCK_SIZE_KB	 256
+#define DYNAMIC_INDEX_BUFFER_BLOCK_SIZE_KB	 1024
+#define DYNAMIC_UNIFORM_BUFFER_BLOCK_SIZE_KB 256
+#define DYNAMIC_STORAGE_BUFFER_BLOCK_SIZE_KB 1024
+#define DYNAMIC_BUFFER_SPANS_PER_BLOCK		 64 // a thread takes this share of a block at once, so it rarely has to lock
+#define MAX_DYNAMIC_BUFFER_BLOCKS			 64
+#define MAX_DYNAMIC_BUFFER_PEAK_KB			 (256 * 1024)
+#define MAX_UNIFORM_ALLOC					 16384 // guaranteed maxUniformBufferRange
+
+typedef enum
+{
+	DYNBUF_VERTEX,
+	DYNBUF_INDEX,
+	DYNBUF_UNIFORM,
+	DYNBUF_STORAGE,
+	NUM_DYNBUF_TYPES,
+} dynbuffer_type_t;
+
+// Fixed size block with one buffer per frame in flight. Blocks are only ever appended,
+// so allocations made earlier in the frame stay valid when a new one is needed.
+typedef struct
+{
+	vulkan_memory_t memory;
+	uint32_t		size;
+	VkBuffer		buffers[MAX_FRAMES_IN_FLIGHT];
+	unsigned char  *data[MAX_FRAMES_IN_FLIGHT];
+	VkDeviceAddress device_addresses[MAX_FRAMES_IN_FLIGHT];
+	VkDescriptorSet descriptor_sets[MAX_FRAMES_IN_FLIGHT]; // uniform buffers only
+} dynbuffer_block_t;
 
 typedef struct
 {
-	VkBuffer		buffer;
-	uint32_t		current_offset;
-	unsigned char  *data;
-	VkDeviceAddress device_address;
+	const char		  *name;
+	VkBufferUsageFlags usage;
+	qboolean		   get_device_address;
+	uint32_t		   block_size;
+	uint32_t		   min_tail_size;
+	cvar_t			  *peak_cvar;
+	SDL_Mutex		  *mutex;
+	int				   num_blocks;
+	int				   current_block;
+	uint32_t		   current_offset;
+	uint32_t		   peak_size; // most bytes used by a single frame this session
+	dynbuffer_block_t  blocks[MAX_DYNAMIC_BUFFER_BLOCKS];
 } dynbuffer_t;
 
-static uint32_t		   current_dyn_vertex_buffer_size = INITIAL_DYNAMIC_VERTEX_BUFFER_SIZE_KB * 1024;
-static uint32_t		   current_dyn_index_buffer_size = INITIAL_DYNAMIC_INDEX_BUFFER_SIZE_KB * 1024;
-static uint32_t		   current_dyn_uniform_buffer_size = INITIAL_DYNAMIC_UNIFORM_BUFFER_SIZE_KB * 1024;
-static uint32_t		   current_dyn_storage_buffer_size = 0; // Only used for RT so allocate lazily
-static vulkan_memory_t dyn_vertex_buffer_memory;
-static vulkan_memory_t dyn_index_buffer_memory;
-static vulkan_memory_t dyn_uniform_buffer_memory;
-static vulkan_memory_t dyn_storage_buffer_memory;
-extern vulkan_memory_t lights_buffer_memory;
-static dynbuffer_t	   dyn_vertex_buffers[NUM_DYNAMIC_BUFFERS];
-static dynbuffer_t	   dyn_index_buffers[NUM_DYNAMIC_BUFFERS];
-static dynbuffer_t	   dyn_uniform_buffers[NUM_DYNAMIC_BUFFERS];
-static dynbuffer_t	   dyn_storage_buffers[NUM_DYNAMIC_BUFFERS];
-static int			   current_dyn_buffer_index = 0;
-static VkDescriptorSet ubo_descriptor_sets[2];
-
-static int				current_garbage_index = 0;
-static int				num_device_memory_garbage[GARBAGE_FRAME_COUNT];
-static int				num_buffer_garbage[GARBAGE_FRAME_COUNT];
-static int				num_desc_set_garbage[GARBAGE_FRAME_COUNT];
-static vulkan_memory_t *device_memory_garbage[GARBAGE_FRAME_COUNT];
-static VkDescriptorSet *descriptor_set_garbage[GARBAGE_FRAME_COUNT];
-static VkBuffer		   *buffer_garbage[GARBAGE_FRAME_COUNT];
+// Part of the current block reserved for the allocations of one thread
+typedef struct
+{
+	uint32_t frame;
+	int		 block;
+	uint32_t offset;
+	uint32_t end;
+} dynbuffer_span_t;
+
+static cvar_t r_dynamicbuffer_peak_vertex = {"r_dynamicbuffer_peak_vertex", "0", CVAR_ARCHIVE}; // KB, pre-sizes the buffers at startup
+static cvar_t r_dynamicbuffer_peak_index = {"r_dynamicbuffer_peak_index", "0", CVAR_ARCHIVE};
+static cvar_t r_dynamicbuffer_peak_uniform = {"r_dynamicbuffer_peak_uniform", "0", CVAR_ARCHIVE};
+static cvar_t r_dynamicbuffer_peak_storage = {"r_dynamicbuffer_peak_storage", "0", CVAR_ARCHIVE};
+static cvar_t r_gcbudget = {"r_gcbudget", "64", CVAR_ARCHIVE}; // garbage entries destroyed per queue and frame, 0 destroys all
+
+extern vulkan_memory_t					lights_buffer_memory;
+static dynbuffer_t						dyn_buffers[NUM_DYNBUF_TYPES];
+static THREAD_LOCAL dynbuffer_span_t	dyn_buffer_spans[NUM_DYNBUF_TYPES];
+static int								current_dyn_buffer_index = 0;
+static uint32_t							current_dyn_buffer_frame = 1;
+static uint32_t							garbage_frame;
 
 void R_VulkanMemStats_f (void);
 
@@ -535,11 +577,6 @@ void R_InitStagingBuffers (void)
 			Sys_Error ("vkBeginCommandBuffer failed");
 	}
 
-	vertex_allocate_mutex = SDL_CreateMutex ();
-	index_allocate_mutex = SDL_CreateMutex ();
-	uniform_allocate_mutex = SDL_CreateMutex ();
-	storage_allocate_mutex = SDL_CreateMutex ();
-	garbage_mutex = SDL_CreateMutex ();
 	staging_mutex = SDL_CreateMutex ();
 	staging_cond = SDL_CreateCondition ();
 }
@@ -592,12 +629,9 @@ void R_SubmitStagingBuffers (void)
 	while (num_stagings_in_flight > 0)
 		SDL_WaitCondition (staging_cond, staging_mutex);
 
-	int i;
-	for (i = 0; i < NUM_STAGING_BUFFERS; ++i)
-	{
-		if (!staging_buffers[i].submitted && staging_buffers[i].current_offset > 0)
-			R_SubmitStagingBuffer (i);
-	}
+	// Every other buffer of the ring is either in flight or empty
+	if (!staging_buffers[current_staging_buffer].submitted && staging_buffers[current_staging_buffer].current_offset > 0)
+		R_SubmitStagingBuffer (current_staging_buffer);
 
 	SDL_UnlockMutex (staging_mutex);
 }
@@ -743,44 +777,47 @@ void R_StagingUploadBuffer (const VkBuffer buffer, const size_t size, const byte
 
 /*
 ===============
-R_InitDynamicBuffers
+R_CreateDynamicBufferBlock
 ===============
 */
-static void R_InitDynamicBuffers (
-	dynbuffer_t *buffers, vulkan_memory_t *memory, uint32_t *current_size, VkBufferUsageFlags usage_flags, qboolean get_device_address, const char *name)
+static void R_CreateDynamicBufferBlock (dynbuffer_t *dyn_buffer, uint32_t size)
 {
 	int i;
 
-	Sys_Printf ("Reallocating dynamic %ss (%u KB)\n", name, *current_size / 1024);
+	if (dyn_buffer->num_blocks == MAX_DYNAMIC_BUFFER_BLOCKS)
+		Sys_Error ("Increase MAX_DYNAMIC_BUFFER_BLOCKS");
 
-	VkResult err;
+	dynbuffer_block_t *block = &dyn_buffer->blocks[dyn_buffer->num_blocks];
+	block->size = size;
 
-	if (get_device_address)
+	Sys_Printf ("Allocating dynamic %s block %d (%u KB)\n", dyn_buffer->name, dyn_buffer->num_blocks, size / 1024);
+
+	VkResult		   err;
+	VkBufferUsageFlags usage_flags = dyn_buffer->usage;
+	if (dyn_buffer->get_device_address)
 		usage_flags |= VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT_KHR;
 
 	ZEROED_STRUCT (VkBufferCreateInfo, buffer_create_info);
 	buffer_create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-	buffer_create_info.size = *current_size;
+	buffer_create_info.size = size;
 	buffer_create_info.usage = usage_flags;
 
-	for (i = 0; i < NUM_DYNAMIC_BUFFERS; ++i)
+	for (i = 0; i < vulkan_globals.num_frames_in_flight; ++i)
 	{
-		buffers[i].current_offset = 0;
-
-		err = vkCreateBuffer (vulkan_globals.device, &buffer_create_info, NULL, &buffers[i].buffer);
+		err = vkCreateBuffer (vulkan_globals.device, &buffer_create_info, NULL, &block->buffers[i]);
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkCreateBuffer failed");
 
-		GL_SetObjectName ((uint64_t)buffers[i].buffer, VK_OBJECT_TYPE_BUFFER, name);
+		GL_SetObjectName ((uint64_t)block->buffers[i], VK_OBJECT_TYPE_BUFFER, dyn_buffer->name);
 	}
 
 	VkMemoryRequirements memory_requirements;
-	vkGetBufferMemoryRequirements (vulkan_globals.device, buffers[0].buffer, &memory_requirements);
+	vkGetBufferMemoryRequirements (vulkan_globals.device, block->buffers[0], &memory_requirements);
 
 	const size_t aligned_size = q_align (memory_requirements.size, memory_requirements.alignment);
 
 	ZEROED_STRUCT (VkMemoryAllocateFlagsInfo, memory_allocate_flags_info);
-	if (get_device_address)
+	if (dyn_buffer->get_device_address)
 	{
 		memory_allocate_flags_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO_KHR;
 		memory_allocate_flags_info.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
@@ -788,118 +825,92 @@ static void R_InitDynamicBuffers (
 
 	ZEROED_STRUCT (VkMemoryAllocateInfo, memory_allocate_info);
 	memory_allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-	memory_allocate_info.pNext = get_device_address ? &memory_allocate_flags_info : NULL;
-	memory_allocate_info.allocationSize = NUM_DYNAMIC_BUFFERS * aligned_size;
+	memory_allocate_info.pNext = dyn_buffer->get_device_address ? &memory_allocate_flags_info : NULL;
+	memory_allocate_info.allocationSize = vulkan_globals.num_frames_in_flight * aligned_size;
 	memory_allocate_info.memoryTypeIndex =
 		GL_MemoryTypeFromProperties (memory_requirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
 
-	R_AllocateVulkanMemory (memory, &memory_allocate_info, VULKAN_MEMORY_TYPE_HOST, &num_vulkan_dynbuf_allocations);
-	GL_SetObjectName ((uint64_t)memory->handle, VK_OBJECT_TYPE_DEVICE_MEMORY, name);
+	R_AllocateVulkanMemory (&block->memory, &memory_allocate_info, VULKAN_MEMORY_TYPE_HOST, &num_vulkan_dynbuf_allocations);
+	GL_SetObjectName ((uint64_t)block->memory.handle, VK_OBJECT_TYPE_DEVICE_MEMORY, dyn_buffer->name);
 
-	for (i = 0; i < NUM_DYNAMIC_BUFFERS; ++i)
+	for (i = 0; i < vulkan_globals.num_frames_in_flight; ++i)
 	{
-		err = vkBindBufferMemory (vulkan_globals.device, buffers[i].buffer, memory->handle, i * aligned_size);
+		err = vkBindBufferMemory (vulkan_globals.device, block->buffers[i], block->memory.handle, i * aligned_size);
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkBindBufferMemory failed");
 	}
 
 	void *data;
-	err = vkMapMemory (vulkan_globals.device, memory->handle, 0, NUM_DYNAMIC_BUFFERS * aligned_size, 0, &data);
+	err = vkMapMemory (vulkan_globals.device, block->memory.handle, 0, vulkan_globals.num_frames_in_flight * aligned_size, 0, &data);
 	if (err != VK_SUCCESS)
 		Sys_Error ("vkMapMemory failed");
 
-	for (i = 0; i < NUM_DYNAMIC_BUFFERS; ++i)
+	for (i = 0; i < vulkan_globals.num_frames_in_flight; ++i)
 	{
-		buffers[i].data = (unsigned char *)data + (i * aligned_size);
+		block->data[i] = (unsigned char *)data + (i * aligned_size);
 
-		if (get_device_address)
+		if (dyn_buffer->get_device_address)
 		{
 			VkBufferDeviceAddressInfoKHR buffer_device_address_info;
 			memset (&buffer_device_address_info, 0, sizeof (buffer_device_address_info));
 			buffer_device_address_info.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO_KHR;
-			buffer_device_address_info.buffer = buffers[i].buffer;
-			VkDeviceAddress device_address = vulkan_globals.vk_get_buffer_device_address (vulkan_globals.device, &buffer_device_address_info);
-			buffers[i].device_address = device_address;
+			buffer_device_address_info.buffer = block->buffers[i];
+			block->device_addresses[i] = vulkan_globals.vk_get_buffer_device_address (vulkan_globals.device, &buffer_device_address_info);
 		}
 	}
-}
 
-/*
-===============
-R_InitDynamicVertexBuffers
-===============
-*/
-static void R_InitDynamicVertexBuffers (void)
-{
-	R_InitDynamicBuffers (
-		dyn_vertex_buffers, &dyn_vertex_buffer_memory, &current_dyn_vertex_buffer_size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, false, "vertex buffer");
-}
-
-/*
-===============
-R_InitDynamicIndexBuffers
-===============
-*/
-static void R_InitDynamicIndexBuffers (void)
-{
-	R_InitDynamicBuffers (dyn_index_buffers, &dyn_index_buffer_memory, &current_dyn_index_buffer_size, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, false, "index buffer");
-}
-
-/*
-===============
-R_InitDynamicUniformBuffers
-===============
-*/
-static void R_InitDynamicUniformBuffers (void)
-{
-	R_InitDynamicBuffers (
-		dyn_uniform_buffers, &dyn_uniform_buffer_memory, &current_dyn_uniform_buffer_size, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, false, "uniform buffer");
-
-	ZEROED_STRUCT (VkDescriptorSetAllocateInfo, descriptor_set_allocate_info);
-	descriptor_set_allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-	descriptor_set_allocate_info.descriptorPool = vulkan_globals.descriptor_pool;
-	descriptor_set_allocate_info.descriptorSetCount = 1;
-	descriptor_set_allocate_info.pSetLayouts = &vulkan_globals.ubo_set_layout.handle;
-
-	ubo_descriptor_sets[0] = R_AllocateDescriptorSet (&vulkan_globals.ubo_set_layout);
-	ubo_descriptor_sets[1] = R_AllocateDescriptorSet (&vulkan_globals.ubo_set_layout);
-
-	ZEROED_STRUCT (VkDescriptorBufferInfo, buffer_info);
-	buffer_info.offset = 0;
-	buffer_info.range = MAX_UNIFORM_ALLOC;
-
-	ZEROED_STRUCT (VkWriteDescriptorSet, ubo_write);
-	ubo_write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-	ubo_write.dstBinding = 0;
-	ubo_write.dstArrayElement = 0;
-	ubo_write.descriptorCount = 1;
-	ubo_write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
-	ubo_write.pBufferInfo = &buffer_info;
-
-	for (int i = 0; i < NUM_DYNAMIC_BUFFERS; ++i)
+	if (dyn_buffer == &dyn_buffers[DYNBUF_UNIFORM])
 	{
-		buffer_info.buffer = dyn_uniform_buffers[i].buffer;
-		ubo_write.dstSet = ubo_descriptor_sets[i];
-		vkUpdateDescriptorSets (vulkan_globals.device, 1, &ubo_write, 0, NULL);
+		ZEROED_STRUCT (VkDescriptorBufferInfo, buffer_info);
+		buffer_info.offset = 0;
+		buffer_info.range = MAX_UNIFORM_ALLOC;
+
+		ZEROED_STRUCT (VkWriteDescriptorSet, ubo_write);
+		ubo_write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		ubo_write.dstBinding = 0;
+		ubo_write.dstArrayElement = 0;
+		ubo_write.descriptorCount = 1;
+		ubo_write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+		ubo_write.pBufferInfo = &buffer_info;
+
+		for (i = 0; i < vulkan_globals.num_frames_in_flight; ++i)
+		{
+			block->descriptor_sets[i] = R_AllocateDescriptorSet (&vulkan_globals.ubo_set_layout);
+			buffer_info.buffer = block->buffers[i];
+			ubo_write.dstSet = block->descriptor_sets[i];
+			vkUpdateDescriptorSets (vulkan_globals.device, 1, &ubo_write, 0, NULL);
+		}
 	}
+
+	dyn_buffer->num_blocks++;
 }
 
 /*
 ===============
-R_InitDynamicStorageBuffers
+R_InitDynamicBuffers
+
+The first block is sized to the peak of the last session so the first busy scene doesn't
+have to allocate. Blocks are created with the frame slot buffers at once, storage
+buffers are only used for RT and are allocated lazily unless a peak was recorded.
 ===============
 */
-static void R_InitDynamicStorageBuffers (void)
+static void R_InitDynamicBuffers (
+	dynbuffer_type_t type, const char *name, VkBufferUsageFlags usage_flags, qboolean get_device_address, uint32_t block_size_kb, uint32_t min_tail_size,
+	cvar_t *peak_cvar, qboolean lazy)
 {
-	VkBufferUsageFlags usage_flags = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
-	qboolean		   get_device_address = false;
-	if (vulkan_globals.ray_query)
-	{
-		usage_flags |= VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR;
-		get_device_address = true;
-	}
-
-	R_InitDynamicBuffers (dyn_storage_buffers, &dyn_storage_buffer_memory, &current_dyn_storage_buffer_size, usage_flags, get_device_address, "storage buffer");
+	dynbuffer_t *dyn_buffer = &dyn_buffers[type];
+	dyn_buffer->name = name;
+	dyn_buffer->usage = usage_flags;
+	dyn_buffer->get_device_address = get_device_address;
+	dyn_buffer->block_size = block_size_kb * 1024;
+	dyn_buffer->min_tail_size = min_tail_size;
+	dyn_buffer->peak_cvar = peak_cvar;
+	dyn_buffer->mutex = SDL_CreateMutex ();
+
+	// ignore implausible peaks read from the config
+	const uint32_t peak_kb = (uint32_t)CLAMP (0, (int)peak_cvar->value, MAX_DYNAMIC_BUFFER_PEAK_KB);
+	if (!lazy || peak_kb)
+		R_CreateDynamicBufferBlock (dyn_buffer, q_max (dyn_buffer->block_size, (uint32_t)q_align (peak_kb * 1024 + min_tail_size, dyn_buffer->block_size)));
 }
 
 /*
@@ -934,6 +945,7 @@ static void R_InitFanIndexBuffer ()
 
 	Atomic_IncrementUInt32 (&num_vulkan_dynbuf_allocations);
 	Atomic_AddUInt64 (&total_device_vulkan_allocation_size, memory_requirements.size);
+	Atomic_AddUInt64 (&vulkan_memory_category_sizes[VULKAN_MEMORY_CATEGORY_DYNAMIC], memory_requirements.size);
 	err = vkAllocateMemory (vulkan_globals.device, &memory_allocate_info, NULL, &memory);
 	if (err != VK_SUCCESS)
 		Sys_Error ("vkAllocateMemory failed");
@@ -974,167 +986,260 @@ R_SwapDynamicBuffers
 */
 void R_SwapDynamicBuffers (void)
 {
-	current_dyn_buffer_index = (current_dyn_buffer_index + 1) % NUM_DYNAMIC_BUFFERS;
-	dyn_vertex_buffers[current_dyn_buffer_index].current_offset = 0;
-	dyn_index_buffers[current_dyn_buffer_index].current_offset = 0;
-	dyn_uniform_buffers[current_dyn_buffer_index].current_offset = 0;
-	dyn_storage_buffers[current_dyn_buffer_index].current_offset = 0;
+	for (int i = 0; i < NUM_DYNBUF_TYPES; ++i)
+	{
+		dynbuffer_t *dyn_buffer = &dyn_buffers[i];
+		uint32_t	 frame_size = dyn_buffer->current_offset;
+		for (int j = 0; j < q_min (dyn_buffer->current_block, dyn_buffer->num_blocks); ++j)
+			frame_size += dyn_buffer->blocks[j].size;
+		dyn_buffer->peak_size = q_max (dyn_buffer->peak_size, frame_size);
+		dyn_buffer->current_block = 0;
+		dyn_buffer->current_offset = 0;
+	}
+	current_dyn_buffer_index = (current_dyn_buffer_index + 1) % vulkan_globals.num_frames_in_flight;
+	current_dyn_buffer_frame++; // invalidates the spans of all threads
 }
 
 /*
 ===============
-R_FlushDynamicBuffers
+R_SetFramesInFlight
+
+Recreates the dynamic buffers with one buffer per frame slot. Expects the device to be
+idle, the first new block is sized to the peak of this session.
 ===============
 */
-void R_FlushDynamicBuffers (void)
+void R_SetFramesInFlight (int frames_in_flight)
 {
-	ZEROED_STRUCT_ARRAY (VkMappedMemoryRange, ranges, 5);
-	int num_ranges = 0;
-	ranges[num_ranges].sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-	ranges[num_ranges].memory = dyn_vertex_buffer_memory.handle;
-	ranges[num_ranges++].size = VK_WHOLE_SIZE;
-	ranges[num_ranges].sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-	ranges[num_ranges].memory = dyn_index_buffer_memory.handle;
-	ranges[num_ranges++].size = VK_WHOLE_SIZE;
-	ranges[num_ranges].sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-	ranges[num_ranges].memory = dyn_uniform_buffer_memory.handle;
-	ranges[num_ranges++].size = VK_WHOLE_SIZE;
-	ranges[num_ranges].sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-	ranges[num_ranges].memory = lights_buffer_memory.handle;
-	ranges[num_ranges++].size = VK_WHOLE_SIZE;
-	if (dyn_storage_buffer_memory.handle != VK_NULL_HANDLE)
+	for (int i = 0; i < NUM_DYNBUF_TYPES; ++i)
 	{
-		ranges[num_ranges].sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-		ranges[num_ranges].memory = dyn_storage_buffer_memory.handle;
-		ranges[num_ranges++].size = VK_WHOLE_SIZE;
+		dynbuffer_t *dyn_buffer = &dyn_buffers[i];
+		for (int j = 0; j < dyn_buffer->num_blocks; ++j)
+		{
+			dynbuffer_block_t *block = &dyn_buffer->blocks[j];
+			for (int k = 0; k < vulkan_globals.num_frames_in_flight; ++k)
+			{
+				if (i == DYNBUF_UNIFORM)
+					R_FreeDescriptorSet (block->descriptor_sets[k], &vulkan_globals.ubo_set_layout);
+				vkDestroyBuffer (vulkan_globals.device, block->buffers[k], NULL);
+			}
+			vkUnmapMemory (vulkan_globals.device, block->memory.handle);
+			R_FreeVulkanMemory (&block->memory, &num_vulkan_dynbuf_allocations);
+			memset (block, 0, sizeof (*block));
+		}
+	}
+
+	vulkan_globals.num_frames_in_flight = frames_in_flight;
+	current_dyn_buffer_index = 0;
+	current_dyn_buffer_frame++;
+
+	for (int i = 0; i < NUM_DYNBUF_TYPES; ++i)
+	{
+		dynbuffer_t *dyn_buffer = &dyn_buffers[i];
+		const int	 num_blocks = dyn_buffer->num_blocks;
+		dyn_buffer->num_blocks = 0;
+		dyn_buffer->current_block = 0;
+		dyn_buffer->current_offset = 0;
+		if (num_blocks)
+			R_CreateDynamicBufferBlock (
+				dyn_buffer, q_max (dyn_buffer->block_size, (uint32_t)q_align (dyn_buffer->peak_size + dyn_buffer->min_tail_size, dyn_buffer->block_size)));
 	}
-	vkFlushMappedMemoryRanges (vulkan_globals.device, num_ranges, ranges);
 }
 
 /*
 ===============
-R_AddDynamicBufferGarbage
+R_AdvanceGarbageFrame
+
+Called once per frame after waiting for the fence of the frame slot
 ===============
 */
-static void R_AddDynamicBufferGarbage (vulkan_memory_t memory, dynbuffer_t *buffers, VkDescriptorSet *descriptor_sets)
+void R_AdvanceGarbageFrame (void)
 {
-	SDL_LockMutex (garbage_mutex);
+	++garbage_frame;
+}
 
-	{
-		int *num_garbage = &num_device_memory_garbage[current_garbage_index];
-		int	 old_num_memory_garbage = *num_garbage;
-		*num_garbage += 1;
-		if (device_memory_garbage[current_garbage_index] == NULL)
-			device_memory_garbage[current_garbage_index] = Mem_Alloc (sizeof (vulkan_memory_t) * (*num_garbage));
-		else
-			device_memory_garbage[current_garbage_index] =
-				Mem_Realloc (device_memory_garbage[current_garbage_index], sizeof (vulkan_memory_t) * (*num_garbage));
-		device_memory_garbage[current_garbage_index][old_num_memory_garbage] = memory;
-	}
+/*
+===============
+R_PushGarbage
 
+Queues an entry that can be destroyed once no frame in flight can use it any more
+===============
+*/
+void R_PushGarbage (garbage_queue_t *queue, const void *entry)
+{
+	if (queue->tail == queue->capacity)
 	{
-		int *num_garbage = &num_buffer_garbage[current_garbage_index];
-		int	 old_num_buffer_garbage = *num_garbage;
-		*num_garbage += NUM_DYNAMIC_BUFFERS;
-		if (buffer_garbage[current_garbage_index] == NULL)
-			buffer_garbage[current_garbage_index] = Mem_Alloc (sizeof (VkBuffer) * (*num_garbage));
+		if (queue->head >= (queue->capacity / 2))
+		{
+			memmove (queue->entries, queue->entries + (size_t)queue->head * queue->entry_size, (size_t)(queue->tail - queue->head) * queue->entry_size);
+			memmove (queue->frames, queue->frames + queue->head, (size_t)(queue->tail - queue->head) * sizeof (uint32_t));
+			queue->tail -= queue->head;
+			queue->head = 0;
+		}
 		else
-			buffer_garbage[current_garbage_index] = Mem_Realloc (buffer_garbage[current_garbage_index], sizeof (VkBuffer) * (*num_garbage));
-		for (int i = 0; i < NUM_DYNAMIC_BUFFERS; ++i)
-			buffer_garbage[current_garbage_index][old_num_buffer_garbage + i] = buffers[i].buffer;
+		{
+			queue->capacity = q_max (queue->capacity * 2, 64);
+			queue->entries = Mem_Realloc (queue->entries, (size_t)queue->capacity * queue->entry_size);
+			queue->frames = Mem_Realloc (queue->frames, (size_t)queue->capacity * sizeof (uint32_t));
+		}
 	}
+	memcpy (queue->entries + (size_t)queue->tail * queue->entry_size, entry, queue->entry_size);
+	queue->frames[queue->tail++] = garbage_frame;
+}
 
-	if (descriptor_sets)
-	{
-		int *num_garbage = &num_desc_set_garbage[current_garbage_index];
-		int	 old_num_desc_set_garbage = *num_garbage;
-		*num_garbage += 2;
-		if (descriptor_set_garbage[current_garbage_index] == NULL)
-			descriptor_set_garbage[current_garbage_index] = Mem_Alloc (sizeof (VkDescriptorSet) * (*num_garbage));
-		else
-			descriptor_set_garbage[current_garbage_index] =
-				Mem_Realloc (descriptor_set_garbage[current_garbage_index], sizeof (VkDescriptorSet) * (*num_garbage));
-		for (int i = 0; i < 2; ++i)
-			descriptor_set_garbage[current_garbage_index][old_num_desc_set_garbage + i] = descriptor_sets[i];
-	}
+/*
+===============
+R_GarbageBudget
 
-	SDL_UnlockMutex (garbage_mutex);
+Number of entries to destroy this frame. A backlog that outgrows r_gcbudget
+is still drained within a few frames.
+===============
+*/
+int R_GarbageBudget (const garbage_queue_t *queue)
+{
+	const int pending = queue->tail - queue->head;
+	if (r_gcbudget.value <= 0.0f)
+		return pending;
+	return q_min (pending, q_max ((int)r_gcbudget.value, pending / 8));
 }
 
 /*
 ===============
-R_CollectDynamicBufferGarbage
+R_PopGarbage
+
+Returns the oldest entry if every frame that could use it has finished, the
+entry stays valid until the next R_PushGarbage on the queue
 ===============
 */
-void R_CollectDynamicBufferGarbage (void)
+void *R_PopGarbage (garbage_queue_t *queue)
 {
-	current_garbage_index = (current_garbage_index + 1) % GARBAGE_FRAME_COUNT;
-	const int collect_garbage_index = (current_garbage_index + 1) % GARBAGE_FRAME_COUNT;
+	if (queue->head == queue->tail)
+		return NULL;
+	if ((garbage_frame - queue->frames[queue->head]) < (uint32_t)vulkan_globals.num_frames_in_flight)
+		return NULL;
+
+	void *entry = queue->entries + (size_t)queue->head * queue->entry_size;
+	if (++queue->head == queue->tail)
+		queue->head = queue->tail = 0;
+	return entry;
+}
+
+/*
+===============
+R_SyncDynamicBufferCvars
 
-	if (num_desc_set_garbage[collect_garbage_index] > 0)
+Stores the peak usage of this session so the next one can pre-size the buffers
+===============
+*/
+void R_SyncDynamicBufferCvars (void)
+{
+	for (int i = 0; i < NUM_DYNBUF_TYPES; ++i)
 	{
-		for (int i = 0; i < num_desc_set_garbage[collect_garbage_index]; ++i)
-			R_FreeDescriptorSet (descriptor_set_garbage[collect_garbage_index][i], &vulkan_globals.ubo_set_layout);
-		Mem_Free (descriptor_set_garbage[collect_garbage_index]);
-		descriptor_set_garbage[collect_garbage_index] = NULL;
-		num_desc_set_garbage[collect_garbage_index] = 0;
+		dynbuffer_t	  *dyn_buffer = &dyn_buffers[i];
+		const uint32_t peak_kb = (dyn_buffer->peak_size + 1023) / 1024;
+		if (dyn_buffer->peak_cvar && (peak_kb > (uint32_t)q_max (dyn_buffer->peak_cvar->value, 0.0f)))
+			Cvar_SetValueQuick (dyn_buffer->peak_cvar, peak_kb);
 	}
+}
 
-	if (num_buffer_garbage[collect_garbage_index] > 0)
+/*
+===============
+R_FlushDynamicBuffers
+===============
+*/
+void R_FlushDynamicBuffers (void)
+{
+	ZEROED_STRUCT_ARRAY (VkMappedMemoryRange, ranges, (NUM_DYNBUF_TYPES * MAX_DYNAMIC_BUFFER_BLOCKS) + 1);
+	int num_ranges = 0;
+	for (int i = 0; i < NUM_DYNBUF_TYPES; ++i)
 	{
-		for (int i = 0; i < num_buffer_garbage[collect_garbage_index]; ++i)
-			vkDestroyBuffer (vulkan_globals.device, buffer_garbage[collect_garbage_index][i], NULL);
-		Mem_Free (buffer_garbage[collect_garbage_index]);
-		buffer_garbage[collect_garbage_index] = NULL;
-		num_buffer_garbage[collect_garbage_index] = 0;
+		for (int j = 0; j < dyn_buffers[i].num_blocks; ++j)
+		{
+			ranges[num_ranges].sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+			ranges[num_ranges].memory = dyn_buffers[i].blocks[j].memory.handle;
+			ranges[num_ranges++].size = VK_WHOLE_SIZE;
+		}
 	}
+	ranges[num_ranges].sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+	ranges[num_ranges].memory = lights_buffer_memory.handle;
+	ranges[num_ranges++].size = VK_WHOLE_SIZE;
+	vkFlushMappedMemoryRanges (vulkan_globals.device, num_ranges, ranges);
+}
+
+/*
+===============
+R_DynBufferAllocateSpan
 
-	if (num_device_memory_garbage[collect_garbage_index] > 0)
+Reserves a new span for the calling thread in the current block, moving on to the next
+block or appending one when the current block is full
+===============
+*/
+static void R_DynBufferAllocateSpan (dynbuffer_t *dyn_buffer, uint32_t size, uint32_t alignment, dynbuffer_span_t *span)
+{
+	SDL_LockMutex (dyn_buffer->mutex);
+
+	const uint32_t span_size = q_max (size, dyn_buffer->block_size / DYNAMIC_BUFFER_SPANS_PER_BLOCK);
+	for (;;)
 	{
-		for (int i = 0; i < num_device_memory_garbage[collect_garbage_index]; ++i)
-			R_FreeVulkanMemory (&device_memory_garbage[collect_garbage_index][i], &num_vulkan_dynbuf_allocations);
-		Mem_Free (device_memory_garbage[collect_garbage_index]);
-		device_memory_garbage[collect_garbage_index] = NULL;
-		num_device_memory_garbage[collect_garbage_index] = 0;
+		if (dyn_buffer->current_block >= dyn_buffer->num_blocks)
+		{
+			R_CreateDynamicBufferBlock (dyn_buffer, q_max (dyn_buffer->block_size, (uint32_t)Q_nextPow2 (size + dyn_buffer->min_tail_size)));
+			continue;
+		}
+
+		const dynbuffer_block_t *block = &dyn_buffer->blocks[dyn_buffer->current_block];
+		const uint32_t			 start = q_align (dyn_buffer->current_offset, alignment);
+		const uint32_t			 limit = block->size - dyn_buffer->min_tail_size;
+		if ((start + size) <= limit)
+		{
+			span->frame = current_dyn_buffer_frame;
+			span->block = dyn_buffer->current_block;
+			span->offset = start;
+			span->end = q_min (start + span_size, limit);
+			dyn_buffer->current_offset = span->end;
+			break;
+		}
+
+		if ((dyn_buffer->current_block + 1) == dyn_buffer->num_blocks)
+			R_CreateDynamicBufferBlock (dyn_buffer, q_max (dyn_buffer->block_size, (uint32_t)Q_nextPow2 (size + dyn_buffer->min_tail_size)));
+		dyn_buffer->current_block++;
+		dyn_buffer->current_offset = 0;
 	}
+
+	SDL_UnlockMutex (dyn_buffer->mutex);
 }
 
 /*
 ===============
 R_DynBufferAllocate
+
+Allocations come from the span of the calling thread and only lock when it is used up
 ===============
 */
-byte *R_DynBufferAllocate (
-	int size, int alignment, int min_tail_size, VkBuffer *buffer, VkDeviceSize *buffer_offset, VkDeviceAddress *device_address, SDL_Mutex **mutex,
-	dynbuffer_t *dyn_buffers, vulkan_memory_t *memory, uint32_t *current_size, VkDescriptorSet *descriptor_set, VkDescriptorSet *descriptor_sets,
-	void (*init_func) (void))
+static byte *R_DynBufferAllocate (
+	dynbuffer_type_t type, int size, int alignment, VkBuffer *buffer, VkDeviceSize *buffer_offset, VkDeviceAddress *device_address,
+	VkDescriptorSet *descriptor_set)
 {
-	SDL_LockMutex (*mutex);
-	dynbuffer_t *dyn_buffer = &dyn_buffers[current_dyn_buffer_index];
-	const int	 aligned_size = q_align (size, alignment);
+	dynbuffer_t		 *dyn_buffer = &dyn_buffers[type];
+	dynbuffer_span_t *span = &dyn_buffer_spans[type];
+	const uint32_t	  aligned_size = q_align (size, alignment);
 
-	if ((dyn_buffer->current_offset + q_max (size, min_tail_size)) > *current_size)
-	{
-		R_AddDynamicBufferGarbage (*memory, dyn_buffers, descriptor_sets);
-		*current_size = q_max (*current_size * 2, (uint32_t)Q_nextPow2 (size));
-		init_func ();
-	}
+	if ((span->frame != current_dyn_buffer_frame) || ((q_align (span->offset, alignment) + aligned_size) > span->end))
+		R_DynBufferAllocateSpan (dyn_buffer, aligned_size, alignment, span);
+
+	const dynbuffer_block_t *block = &dyn_buffer->blocks[span->block];
+	const uint32_t			 offset = q_align (span->offset, alignment);
+	span->offset = offset + aligned_size;
 
 	if (buffer)
-		*buffer = dyn_buffer->buffer;
+		*buffer = block->buffers[current_dyn_buffer_index];
 	if (buffer_offset)
-		*buffer_offset = dyn_buffer->current_offset;
+		*buffer_offset = offset;
 	if (device_address)
-		*device_address = dyn_buffer->device_address + dyn_buffer->current_offset;
-
-	unsigned char *data = dyn_buffer->data + dyn_buffer->current_offset;
-	dyn_buffer->current_offset += aligned_size;
-
+		*device_address = block->device_addresses[current_dyn_buffer_index] + offset;
 	if (descriptor_set)
-		*descriptor_set = descriptor_sets[current_dyn_buffer_index];
+		*descriptor_set = block->descriptor_sets[current_dyn_buffer_index];
 
-	SDL_UnlockMutex (*mutex);
-	return data;
+	return block->data[current_dyn_buffer_index] + offset;
 }
 
 /*
@@ -1145,9 +1250,7 @@ Vertex buffers need to be aligned by the maximum format component size, i.e. siz
 */
 byte *R_VertexAllocate (int size, VkBuffer *buffer, VkDeviceSize *buffer_offset)
 {
-	return R_DynBufferAllocate (
-		size, sizeof (float), 0, buffer, buffer_offset, NULL, &vertex_allocate_mutex, dyn_vertex_buffers, &dyn_vertex_buffer_memory,
-		&current_dyn_vertex_buffer_size, NULL, NULL, &R_InitDynamicVertexBuffers);
+	return R_DynBufferAllocate (DYNBUF_VERTEX, size, sizeof (float), buffer, buffer_offset, NULL, NULL);
 }
 
 /*
@@ -1159,9 +1262,7 @@ index buffers and alignment must match index size
 */
 byte *R_IndexAllocate (int size, VkBuffer *buffer, VkDeviceSize *buffer_offset)
 {
-	return R_DynBufferAllocate (
-		size, sizeof (uint32_t), 0, buffer, buffer_offset, NULL, &index_allocate_mutex, dyn_index_buffers, &dyn_index_buffer_memory,
-		&current_dyn_index_buffer_size, NULL, NULL, &R_InitDynamicIndexBuffers);
+	return R_DynBufferAllocate (DYNBUF_INDEX, size, sizeof (uint32_t), buffer, buffer_offset, NULL, NULL);
 }
 
 /*
@@ -1172,8 +1273,7 @@ R_StorageAllocate
 byte *R_StorageAllocate (int size, VkBuffer *buffer, VkDeviceSize *buffer_offset, VkDeviceAddress *device_address)
 {
 	return R_DynBufferAllocate (
-		size, vulkan_globals.device_properties.limits.minStorageBufferOffsetAlignment, 0, buffer, buffer_offset, device_address, &storage_allocate_mutex,
-		dyn_storage_buffers, &dyn_storage_buffer_memory, &current_dyn_storage_buffer_size, NULL, NULL, &R_InitDynamicStorageBuffers);
+		DYNBUF_STORAGE, size, vulkan_globals.device_properties.limits.minStorageBufferOffsetAlignment, buffer, buffer_offset, device_address, NULL);
 }
 
 /*
@@ -1189,9 +1289,7 @@ byte *R_UniformAllocate (int size, VkBuffer *buffer, uint32_t *buffer_offset, Vk
 	VkDeviceSize device_size_offset = 0;
 
 	byte *data = R_DynBufferAllocate (
-		size, vulkan_globals.device_properties.limits.minUniformBufferOffsetAlignment, MAX_UNIFORM_ALLOC, buffer, &device_size_offset, NULL,
-		&uniform_allocate_mutex, dyn_uniform_buffers, &dyn_uniform_buffer_memory, &current_dyn_uniform_buffer_size, descriptor_set, ubo_descriptor_sets,
-		&R_InitDynamicUniformBuffers);
+		DYNBUF_UNIFORM, size, vulkan_globals.device_properties.limits.minUniformBufferOffsetAlignment, buffer, &device_size_offset, NULL, descriptor_set);
 
 	*buffer_offset = device_size_offset;
 	return data;
@@ -1204,9 +1302,33 @@ R_InitGPUBuffers
 */
 void R_InitGPUBuffers (void)
 {
-	R_InitDynamicVertexBuffers ();
-	R_InitDynamicIndexBuffers ();
-	R_InitDynamicUniformBuffers ();
+	Cvar_RegisterVariable (&r_dynamicbuffer_peak_vertex);
+	Cvar_RegisterVariable (&r_dynamicbuffer_peak_index);
+	Cvar_RegisterVariable (&r_dynamicbuffer_peak_uniform);
+	Cvar_RegisterVariable (&r_dynamicbuffer_peak_storage);
+	Cvar_RegisterVariable (&r_gcbudget);
+	if (CFG_OpenConfig ("config.cfg") == 0)
+	{
+		const char *early_read[] = {
+			"r_dynamicbuffer_peak_vertex", "r_dynamicbuffer_peak_index", "r_dynamicbuffer_peak_uniform", "r_dynamicbuffer_peak_storage"};
+		CFG_ReadCvars (early_read, countof (early_read));
+		CFG_CloseConfig ();
+	}
+
+	VkBufferUsageFlags storage_usage_flags = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+	if (vulkan_globals.ray_query)
+		storage_usage_flags |= VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR;
+
+	R_InitDynamicBuffers (
+		DYNBUF_VERTEX, "vertex buffer", VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, false, DYNAMIC_VERTEX_BUFFER_BLOCK_SIZE_KB, 0, &r_dynamicbuffer_peak_vertex, false);
+	R_InitDynamicBuffers (
+		DYNBUF_INDEX, "index buffer", VK_BUFFER_USAGE_INDEX_BUFFER_BIT, false, DYNAMIC_INDEX_BUFFER_BLOCK_SIZE_KB, 0, &r_dynamicbuffer_peak_index, false);
+	R_InitDynamicBuffers (
+		DYNBUF_UNIFORM, "uniform buffer", VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, false, DYNAMIC_UNIFORM_BUFFER_BLOCK_SIZE_KB, MAX_UNIFORM_ALLOC,
+		&r_dynamicbuffer_peak_uniform, false);
+	R_InitDynamicBuffers (
+		DYNBUF_STORAGE, "storage buffer", storage_usage_flags, vulkan_globals.ray_query, DYNAMIC_STORAGE_BUFFER_BLOCK_SIZE_KB, 0,
+		&r_dynamicbuffer_peak_storage, true);
 	R_InitFanIndexBuffer ();
 
 	// Initialize scratch buffer for animated AS building
@@ -1325,7 +1447,7 @@ void R_CreateDescriptorSetLayouts ()
 		screen_effects_layout_bindings[1].binding = 1;
 		screen_effects_layout_bindings[1].descriptorCount = 1;
 		screen_effects_layout_bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-		screen_effects_layout_bindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		screen_effects_layout_bindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
 		screen_effects_layout_bindings[2].binding = 2;
 		screen_effects_layout_bindings[2].descriptorCount = 1;
 		screen_effects_layout_bindings[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
@@ -1333,17 +1455,17 @@ void R_CreateDescriptorSetLayouts ()
 		screen_effects_layout_bindings[3].binding = 3;
 		screen_effects_layout_bindings[3].descriptorCount = 1;
 		screen_effects_layout_bindings[3].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
-		screen_effects_layout_bindings[3].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		screen_effects_layout_bindings[3].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
 		screen_effects_layout_bindings[4].binding = 4;
 		screen_effects_layout_bindings[4].descriptorCount = 1;
-		screen_effects_layout_bindings[4].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		screen_effects_layout_bindings[4].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		screen_effects_layout_bindings[4].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		screen_effects_layout_bindings[4].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
 
 		descriptor_set_layout_create_info.bindingCount = countof (screen_effects_layout_bindings);
 		descriptor_set_layout_create_info.pBindings = screen_effects_layout_bindings;
 
 		memset (&vulkan_globals.screen_effects_set_layout, 0, sizeof (vulkan_globals.screen_effects_set_layout));
-		vulkan_globals.screen_effects_set_layout.num_combined_image_samplers = 2;
+		vulkan_globals.screen_effects_set_layout.num_combined_image_samplers = 3;
 		vulkan_globals.screen_effects_set_layout.num_storage_images = 1;
 
 		err = vkCreateDescriptorSetLayout (vulkan_globals.device, &descriptor_set_layout_create_info, NULL, &vulkan_globals.screen_effects_set_layout.handle);
@@ -1445,7 +1567,7 @@ void R_CreateDescriptorSetLayouts ()
 	}
 
 	{
-		ZEROED_STRUCT_ARRAY (VkDescriptorSetLayoutBinding, indirect_compute_layout_bindings, 4);
+		ZEROED_STRUCT_ARRAY (VkDescriptorSetLayoutBinding, indirect_compute_layout_bindings, 7);
 		indirect_compute_layout_bindings[0].binding = 0;
 		indirect_compute_layout_bindings[0].descriptorCount = 1;
 		indirect_compute_layout_bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
@@ -1462,12 +1584,24 @@ void R_CreateDescriptorSetLayouts ()
 		indirect_compute_layout_bindings[3].descriptorCount = 1;
 		indirect_compute_layout_bindings[3].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
 		indirect_compute_layout_bindings[3].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		indirect_compute_layout_bindings[4].binding = 4;
+		indirect_compute_layout_bindings[4].descriptorCount = 1;
+		indirect_compute_layout_bindings[4].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		indirect_compute_layout_bindings[4].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		indirect_compute_layout_bindings[5].binding = 5;
+		indirect_compute_layout_bindings[5].descriptorCount = 1;
+		indirect_compute_layout_bindings[5].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		indirect_compute_layout_bindings[5].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		indirect_compute_layout_bindings[6].binding = 6;
+		indirect_compute_layout_bindings[6].descriptorCount = 1;
+		indirect_compute_layout_bindings[6].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		indirect_compute_layout_bindings[6].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
 
 		descriptor_set_layout_create_info.bindingCount = countof (indirect_compute_layout_bindings);
 		descriptor_set_layout_create_info.pBindings = indirect_compute_layout_bindings;
 
 		memset (&vulkan_globals.indirect_compute_set_layout, 0, sizeof (vulkan_globals.indirect_compute_set_layout));
-		vulkan_globals.indirect_compute_set_layout.num_storage_buffers = 4;
+		vulkan_globals.indirect_compute_set_layout.num_storage_buffers = 7;
 
 		err = vkCreateDescriptorSetLayout (vulkan_globals.device, &descriptor_set_layout_create_info, NULL, &vulkan_globals.indirect_compute_set_layout.handle);
 		if (err != VK_SUCCESS)
@@ -1475,6 +1609,85 @@ void R_CreateDescriptorSetLayouts ()
 		GL_SetObjectName ((uint64_t)vulkan_globals.indirect_compute_set_layout.handle, VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, "indirect compute");
 	}
 
+	{
+		ZEROED_STRUCT_ARRAY (VkDescriptorSetLayoutBinding, particle_compute_layout_bindings, 4);
+		for (int i = 0; i < 4; ++i)
+		{
+			particle_compute_layout_bindings[i].binding = i;
+			particle_compute_layout_bindings[i].descriptorCount = 1;
+			particle_compute_layout_bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			particle_compute_layout_bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		}
+
+		descriptor_set_layout_create_info.bindingCount = countof (particle_compute_layout_bindings);
+		descriptor_set_layout_create_info.pBindings = particle_compute_layout_bindings;
+
+		memset (&vulkan_globals.particle_compute_set_layout, 0, sizeof (vulkan_globals.particle_compute_set_layout));
+		vulkan_globals.particle_compute_set_layout.num_storage_buffers = 4;
+
+		err = vkCreateDescriptorSetLayout (vulkan_globals.device, &descriptor_set_layout_create_info, NULL, &vulkan_globals.particle_compute_set_layout.handle);
+		if (err != VK_SUCCESS)
+			Sys_Error ("vkCreateDescriptorSetLayout failed");
+		GL_SetObjectName ((uint64_t)vulkan_globals.particle_compute_set_layout.handle, VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, "particle compute");
+	}
+
+	{
+		// Dlights and their per-froxel masks, written by dlight_clusters.comp and read by the world fragment shaders
+		ZEROED_STRUCT_ARRAY (VkDescriptorSetLayoutBinding, dlight_cluster_layout_bindings, 2);
+		dlight_cluster_layout_bindings[0].binding = 0;
+		dlight_cluster_layout_bindings[0].descriptorCount = 1;
+		dlight_cluster_layout_bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		dlight_cluster_layout_bindings[0].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+		dlight_cluster_layout_bindings[1].binding = 1;
+		dlight_cluster_layout_bindings[1].descriptorCount = 1;
+		dlight_cluster_layout_bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		dlight_cluster_layout_bindings[1].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+
+		descriptor_set_layout_create_info.bindingCount = countof (dlight_cluster_layout_bindings);
+		descriptor_set_layout_create_info.pBindings = dlight_cluster_layout_bindings;
+
+		memset (&vulkan_globals.dlight_cluster_set_layout, 0, sizeof (vulkan_globals.dlight_cluster_set_layout));
+		vulkan_globals.dlight_cluster_set_layout.num_ubos = 1;
+		vulkan_globals.dlight_cluster_set_layout.num_storage_buffers = 1;
+
+		err = vkCreateDescriptorSetLayout (vulkan_globals.device, &descriptor_set_layout_create_info, NULL, &vulkan_globals.dlight_cluster_set_layout.handle);
+		if (err != VK_SUCCESS)
+			Sys_Error ("vkCreateDescriptorSetLayout failed");
+		GL_SetObjectName ((uint64_t)vulkan_globals.dlight_cluster_set_layout.handle, VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, "dlight clusters");
+	}
+
+	if (vulkan_globals.bindless)
+	{
+		// One slot per gltexture_t, written by TexMgr_SetFilterModes while frames using other slots are in flight
+		ZEROED_STRUCT (VkDescriptorSetLayoutBinding, bindless_layout_binding);
+		bindless_layout_binding.binding = 0;
+		bindless_layout_binding.descriptorCount = MAX_GLTEXTURES;
+		bindless_layout_binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		bindless_layout_binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+		const VkDescriptorBindingFlagsEXT binding_flags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT |
+														  VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT;
+		ZEROED_STRUCT (VkDescriptorSetLayoutBindingFlagsCreateInfoEXT, binding_flags_create_info);
+		binding_flags_create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+		binding_flags_create_info.bindingCount = 1;
+		binding_flags_create_info.pBindingFlags = &binding_flags;
+
+		descriptor_set_layout_create_info.pNext = &binding_flags_create_info;
+		descriptor_set_layout_create_info.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+		descriptor_set_layout_create_info.bindingCount = 1;
+		descriptor_set_layout_create_info.pBindings = &bindless_layout_binding;
+
+		memset (&vulkan_globals.bindless_set_layout, 0, sizeof (vulkan_globals.bindless_set_layout));
+
+		err = vkCreateDescriptorSetLayout (vulkan_globals.device, &descriptor_set_layout_create_info, NULL, &vulkan_globals.bindless_set_layout.handle);
+		if (err != VK_SUCCESS)
+			Sys_Error ("vkCreateDescriptorSetLayout failed");
+		GL_SetObjectName ((uint64_t)vulkan_globals.bindless_set_layout.handle, VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, "bindless textures");
+
+		descriptor_set_layout_create_info.pNext = NULL;
+		descriptor_set_layout_create_info.flags = 0;
+	}
+
 #if defined(_DEBUG)
 	if (vulkan_globals.ray_query)
 	{
@@ -1542,6 +1755,34 @@ void R_CreateDescriptorPool ()
 	descriptor_pool_create_info.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
 
 	vkCreateDescriptorPool (vulkan_globals.device, &descriptor_pool_create_info, NULL, &vulkan_globals.descriptor_pool);
+
+	if (vulkan_globals.bindless)
+	{
+		// Update-after-bind sets need their own pool
+		ZEROED_STRUCT (VkDescriptorPoolSize, bindless_pool_size);
+		bindless_pool_size.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		bindless_pool_size.descriptorCount = MAX_GLTEXTURES;
+
+		descriptor_pool_create_info.maxSets = 1;
+		descriptor_pool_create_info.poolSizeCount = 1;
+		descriptor_pool_create_info.pPoolSizes = &bindless_pool_size;
+		descriptor_pool_create_info.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+
+		VkResult err = vkCreateDescriptorPool (vulkan_globals.device, &descriptor_pool_create_info, NULL, &vulkan_globals.bindless_descriptor_pool);
+		if (err != VK_SUCCESS)
+			Sys_Error ("vkCreateDescriptorPool failed");
+
+		ZEROED_STRUCT (VkDescriptorSetAllocateInfo, descriptor_set_allocate_info);
+		descriptor_set_allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		descriptor_set_allocate_info.descriptorPool = vulkan_globals.bindless_descriptor_pool;
+		descriptor_set_allocate_info.descriptorSetCount = 1;
+		descriptor_set_allocate_info.pSetLayouts = &vulkan_globals.bindless_set_layout.handle;
+
+		err = vkAllocateDescriptorSets (vulkan_globals.device, &descriptor_set_allocate_info, &vulkan_globals.bindless_desc_set);
+		if (err != VK_SUCCESS)
+			Sys_Error ("vkAllocateDescriptorSets failed");
+		GL_SetObjectName ((uint64_t)vulkan_globals.bindless_desc_set, VK_OBJECT_TYPE_DESCRIPTOR_SET, "bindless textures");
+	}
 }
 
 /*
@@ -1580,8 +1821,9 @@ void R_CreatePipelineLayouts ()
 
 	{
 		// World
-		VkDescriptorSetLayout world_descriptor_set_layouts[3] = {
-			vulkan_globals.single_texture_set_layout.handle, vulkan_globals.single_texture_set_layout.handle, vulkan_globals.single_texture_set_layout.handle};
+		VkDescriptorSetLayout world_descriptor_set_layouts[4] = {
+			vulkan_globals.single_texture_set_layout.handle, vulkan_globals.single_texture_set_layout.handle, vulkan_globals.single_texture_set_layout.handle,
+			vulkan_globals.dlight_cluster_set_layout.handle};
 
 		ZEROED_STRUCT (VkPushConstantRange, push_constant_range);
 		push_constant_range.offset = 0;
@@ -1590,7 +1832,7 @@ void R_CreatePipelineLayouts ()
 
 		ZEROED_STRUCT (VkPipelineLayoutCreateInfo, pipeline_layout_create_info);
 		pipeline_layout_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-		pipeline_layout_create_info.setLayoutCount = 3;
+		pipeline_layout_create_info.setLayoutCount = 4;
 		pipeline_layout_create_info.pSetLayouts = world_descriptor_set_layouts;
 		pipeline_layout_create_info.pushConstantRangeCount = 1;
 		pipeline_layout_create_info.pPushConstantRanges = &push_constant_range;
@@ -1600,6 +1842,23 @@ void R_CreatePipelineLayouts ()
 			Sys_Error ("vkCreatePipelineLayout failed");
 		GL_SetObjectName ((uint64_t)vulkan_globals.world_pipeline_layout.handle, VK_OBJECT_TYPE_PIPELINE_LAYOUT, "world_pipeline_layout");
 		vulkan_globals.world_pipeline_layout.push_constant_range = push_constant_range;
+		vulkan_globals.world_pipeline_layout.dlight_cluster_set = 3;
+
+		if (vulkan_globals.bindless)
+		{
+			// Diffuse and fullbright come from the bindless array, push constants stay identical to world
+			VkDescriptorSetLayout world_bindless_descriptor_set_layouts[3] = {
+				vulkan_globals.bindless_set_layout.handle, vulkan_globals.single_texture_set_layout.handle, vulkan_globals.dlight_cluster_set_layout.handle};
+			pipeline_layout_create_info.setLayoutCount = 3;
+			pipeline_layout_create_info.pSetLayouts = world_bindless_descriptor_set_layouts;
+
+			err = vkCreatePipelineLayout (vulkan_globals.device, &pipeline_layout_create_info, NULL, &vulkan_globals.world_bindless_pipeline_layout.handle);
+			if (err != VK_SUCCESS)
+				Sys_Error ("vkCreatePipelineLayout failed");
+			GL_SetObjectName ((uint64_t)vulkan_globals.world_bindless_pipeline_layout.handle, VK_OBJECT_TYPE_PIPELINE_LAYOUT, "world_bindless_pipeline_layout");
+			vulkan_globals.world_bindless_pipeline_layout.push_constant_range = push_constant_range;
+			vulkan_globals.world_bindless_pipeline_layout.dlight_cluster_set = 2;
+		}
 	}
 
 	{
@@ -1712,6 +1971,34 @@ void R_CreatePipelineLayouts ()
 		vulkan_globals.postprocess_pipeline.layout.push_constant_range = push_constant_range;
 	}
 
+	{
+		// Fused postprocess: set 2 = screen effects (blue noise and palette), push constants followed by the screen effect ones
+		VkDescriptorSetLayout postprocess_fused_descriptor_set_layouts[3] = {
+			vulkan_globals.single_texture_set_layout.handle,
+			vulkan_globals.single_texture_set_layout.handle,
+			vulkan_globals.screen_effects_set_layout.handle,
+		};
+
+		ZEROED_STRUCT (VkPushConstantRange, push_constant_range);
+		push_constant_range.offset = 0;
+		push_constant_range.size = 10 * sizeof (float) + 3 * sizeof (uint32_t) + 9 * sizeof (float);
+		push_constant_range.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+		ZEROED_STRUCT (VkPipelineLayoutCreateInfo, pipeline_layout_create_info);
+		pipeline_layout_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipeline_layout_create_info.setLayoutCount = 3;
+		pipeline_layout_create_info.pSetLayouts = postprocess_fused_descriptor_set_layouts;
+		pipeline_layout_create_info.pushConstantRangeCount = 1;
+		pipeline_layout_create_info.pPushConstantRanges = &push_constant_range;
+
+		err = vkCreatePipelineLayout (vulkan_globals.device, &pipeline_layout_create_info, NULL, &vulkan_globals.postprocess_fused_pipeline.layout.handle);
+		if (err != VK_SUCCESS)
+			Sys_Error ("vkCreatePipelineLayout failed");
+		GL_SetObjectName (
+			(uint64_t)vulkan_globals.postprocess_fused_pipeline.layout.handle, VK_OBJECT_TYPE_PIPELINE_LAYOUT, "postprocess_fused_pipeline_layout");
+		vulkan_globals.postprocess_fused_pipeline.layout.push_constant_range = push_constant_range;
+	}
+
 	{
 		// Screen effects
 		VkDescriptorSetLayout screen_effects_descriptor_set_layouts[1] = {
@@ -1720,7 +2007,7 @@ void R_CreatePipelineLayouts ()
 
 		ZEROED_STRUCT (VkPushConstantRange, push_constant_range);
 		push_constant_range.offset = 0;
-		push_constant_range.size = 3 * sizeof (uint32_t) + 8 * sizeof (float);
+		push_constant_range.size = 3 * sizeof (uint32_t) + 9 * sizeof (float);
 		push_constant_range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
 
 		ZEROED_STRUCT (VkPipelineLayoutCreateInfo, pipeline_layout_create_info);
@@ -1765,6 +2052,41 @@ void R_CreatePipelineLayouts ()
 			Sys_Error ("vkCreatePipelineLayout failed");
 		GL_SetObjectName ((uint64_t)vulkan_globals.cs_tex_warp_pipeline.layout.handle, VK_OBJECT_TYPE_PIPELINE_LAYOUT, "cs_tex_warp_pipeline_layout");
 		vulkan_globals.cs_tex_warp_pipeline.layout.push_constant_range = push_constant_range;
+
+		// Depth pyramid downsampling uses the same sampled input/storage output sets
+		push_constant_range.size = 1 * sizeof (uint32_t);
+		err = vkCreatePipelineLayout (vulkan_globals.device, &pipeline_layout_create_info, NULL, &vulkan_globals.depth_pyramid_pipeline.layout.handle);
+		if (err != VK_SUCCESS)
+			Sys_Error ("vkCreatePipelineLayout failed");
+		GL_SetObjectName ((uint64_t)vulkan_globals.depth_pyramid_pipeline.layout.handle, VK_OBJECT_TYPE_PIPELINE_LAYOUT, "depth_pyramid_pipeline_layout");
+		vulkan_globals.depth_pyramid_pipeline.layout.push_constant_range = push_constant_range;
+	}
+
+	{
+		// Shading rate image: scene color, depth, shading rate output
+		VkDescriptorSetLayout shading_rate_descriptor_set_layouts[3] = {
+			vulkan_globals.single_texture_set_layout.handle,
+			vulkan_globals.single_texture_set_layout.handle,
+			vulkan_globals.single_texture_cs_write_set_layout.handle,
+		};
+
+		ZEROED_STRUCT (VkPushConstantRange, push_constant_range);
+		push_constant_range.offset = 0;
+		push_constant_range.size = 5 * sizeof (uint32_t) + 3 * sizeof (float);
+		push_constant_range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+		ZEROED_STRUCT (VkPipelineLayoutCreateInfo, pipeline_layout_create_info);
+		pipeline_layout_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipeline_layout_create_info.setLayoutCount = 3;
+		pipeline_layout_create_info.pSetLayouts = shading_rate_descriptor_set_layouts;
+		pipeline_layout_create_info.pushConstantRangeCount = 1;
+		pipeline_layout_create_info.pPushConstantRanges = &push_constant_range;
+
+		err = vkCreatePipelineLayout (vulkan_globals.device, &pipeline_layout_create_info, NULL, &vulkan_globals.shading_rate_pipeline.layout.handle);
+		if (err != VK_SUCCESS)
+			Sys_Error ("vkCreatePipelineLayout failed");
+		GL_SetObjectName ((uint64_t)vulkan_globals.shading_rate_pipeline.layout.handle, VK_OBJECT_TYPE_PIPELINE_LAYOUT, "shading_rate_pipeline_layout");
+		vulkan_globals.shading_rate_pipeline.layout.push_constant_range = push_constant_range;
 	}
 
 	{
@@ -1776,102 +2098,193 @@ void R_CreatePipelineLayouts ()
 		pipeline_layout_create_info.setLayoutCount = 0;
 		pipeline_layout_create_info.pushConstantRangeCount = 0;
 
-		err = vkCreatePipelineLayout (vulkan_globals.device, &pipeline_layout_create_info, NULL, &vulkan_globals.showtris_pipeline.layout.handle);
+		err = vkCreatePipelineLayout (vulkan_globals.device, &pipeline_layout_create_info, NULL, &vulkan_globals.showtris_pipeline.layout.handle);
+		if (err != VK_SUCCESS)
+			Sys_Error ("vkCreatePipelineLayout failed");
+		GL_SetObjectName ((uint64_t)vulkan_globals.showtris_pipeline.layout.handle, VK_OBJECT_TYPE_PIPELINE_LAYOUT, "showtris_pipeline_layout");
+		vulkan_globals.showtris_pipeline.layout.push_constant_range = push_constant_range;
+	}
+
+	{
+		// Update lightmaps
+		VkDescriptorSetLayout update_lightmap_descriptor_set_layouts[1] = {
+			vulkan_globals.lightmap_compute_set_layout.handle,
+		};
+
+		ZEROED_STRUCT (VkPushConstantRange, push_constant_range);
+		push_constant_range.offset = 0;
+		push_constant_range.size = 10 * sizeof (uint32_t);
+		push_constant_range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+		ZEROED_STRUCT (VkPipelineLayoutCreateInfo, pipeline_layout_create_info);
+		pipeline_layout_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipeline_layout_create_info.setLayoutCount = 1;
+		pipeline_layout_create_info.pSetLayouts = update_lightmap_descriptor_set_layouts;
+		pipeline_layout_create_info.pushConstantRangeCount = 1;
+		pipeline_layout_create_info.pPushConstantRanges = &push_constant_range;
+
+		err = vkCreatePipelineLayout (vulkan_globals.device, &pipeline_layout_create_info, NULL, &vulkan_globals.update_lightmap_pipeline.layout.handle);
+		if (err != VK_SUCCESS)
+			Sys_Error ("vkCreatePipelineLayout failed");
+		GL_SetObjectName ((uint64_t)vulkan_globals.update_lightmap_pipeline.layout.handle, VK_OBJECT_TYPE_PIPELINE_LAYOUT, "update_lightmap_pipeline_layout");
+		vulkan_globals.update_lightmap_pipeline.layout.push_constant_range = push_constant_range;
+	}
+
+	if (vulkan_globals.ray_query)
+	{
+		// Update lightmaps RT
+		VkDescriptorSetLayout update_lightmap_rt_descriptor_set_layouts[1] = {
+			vulkan_globals.lightmap_compute_rt_set_layout.handle,
+		};
+
+		ZEROED_STRUCT (VkPushConstantRange, push_constant_range);
+		push_constant_range.offset = 0;
+		push_constant_range.size = 10 * sizeof (uint32_t);
+		push_constant_range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+		ZEROED_STRUCT (VkPipelineLayoutCreateInfo, pipeline_layout_create_info);
+		pipeline_layout_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipeline_layout_create_info.setLayoutCount = 1;
+		pipeline_layout_create_info.pSetLayouts = update_lightmap_rt_descriptor_set_layouts;
+		pipeline_layout_create_info.pushConstantRangeCount = 1;
+		pipeline_layout_create_info.pPushConstantRanges = &push_constant_range;
+
+		err = vkCreatePipelineLayout (vulkan_globals.device, &pipeline_layout_create_info, NULL, &vulkan_globals.update_lightmap_rt_pipeline.layout.handle);
+		if (err != VK_SUCCESS)
+			Sys_Error ("vkCreatePipelineLayout failed");
+		GL_SetObjectName (
+			(uint64_t)vulkan_globals.update_lightmap_rt_pipeline.layout.handle, VK_OBJECT_TYPE_PIPELINE_LAYOUT, "update_lightmap_rt_pipeline_layout");
+		vulkan_globals.update_lightmap_rt_pipeline.layout.push_constant_range = push_constant_range;
+	}
+
+	{
+		// Indirect draw
+		VkDescriptorSetLayout indirect_draw_descriptor_set_layouts[1] = {
+			vulkan_globals.indirect_compute_set_layout.handle,
+		};
+
+		ZEROED_STRUCT (VkPushConstantRange, push_constant_range);
+		push_constant_range.offset = 0;
+		push_constant_range.size = 6 * sizeof (uint32_t);
+		push_constant_range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+		ZEROED_STRUCT (VkPipelineLayoutCreateInfo, pipeline_layout_create_info);
+		pipeline_layout_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipeline_layout_create_info.setLayoutCount = 1;
+		pipeline_layout_create_info.pSetLayouts = indirect_draw_descriptor_set_layouts;
+		pipeline_layout_create_info.pushConstantRangeCount = 1;
+		pipeline_layout_create_info.pPushConstantRanges = &push_constant_range;
+
+		err = vkCreatePipelineLayout (vulkan_globals.device, &pipeline_layout_create_info, NULL, &vulkan_globals.indirect_draw_pipeline.layout.handle);
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkCreatePipelineLayout failed");
-		GL_SetObjectName ((uint64_t)vulkan_globals.showtris_pipeline.layout.handle, VK_OBJECT_TYPE_PIPELINE_LAYOUT, "showtris_pipeline_layout");
-		vulkan_globals.showtris_pipeline.layout.push_constant_range = push_constant_range;
+		GL_SetObjectName ((uint64_t)vulkan_globals.indirect_draw_pipeline.layout.handle, VK_OBJECT_TYPE_PIPELINE_LAYOUT, "indirect_draw_pipeline_layout");
+		vulkan_globals.indirect_draw_pipeline.layout.push_constant_range = push_constant_range;
+
+		err = vkCreatePipelineLayout (vulkan_globals.device, &pipeline_layout_create_info, NULL, &vulkan_globals.indirect_clear_pipeline.layout.handle);
+		if (err != VK_SUCCESS)
+			Sys_Error ("vkCreatePipelineLayout failed");
+		GL_SetObjectName ((uint64_t)vulkan_globals.indirect_clear_pipeline.layout.handle, VK_OBJECT_TYPE_PIPELINE_LAYOUT, "indirect_clear_pipeline_layout");
+		vulkan_globals.indirect_clear_pipeline.layout.push_constant_range = push_constant_range;
 	}
 
 	{
-		// Update lightmaps
-		VkDescriptorSetLayout update_lightmap_descriptor_set_layouts[1] = {
-			vulkan_globals.lightmap_compute_set_layout.handle,
+		// Indirect draw with depth pyramid occlusion culling
+		VkDescriptorSetLayout indirect_occlusion_descriptor_set_layouts[2] = {
+			vulkan_globals.indirect_compute_set_layout.handle,
+			vulkan_globals.single_texture_set_layout.handle,
 		};
 
 		ZEROED_STRUCT (VkPushConstantRange, push_constant_range);
 		push_constant_range.offset = 0;
-		push_constant_range.size = 7 * sizeof (uint32_t);
+		push_constant_range.size = 112; // sizeof(indirect_occlusion_push_constants_t)
 		push_constant_range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
 
 		ZEROED_STRUCT (VkPipelineLayoutCreateInfo, pipeline_layout_create_info);
 		pipeline_layout_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-		pipeline_layout_create_info.setLayoutCount = 1;
-		pipeline_layout_create_info.pSetLayouts = update_lightmap_descriptor_set_layouts;
+		pipeline_layout_create_info.setLayoutCount = 2;
+		pipeline_layout_create_info.pSetLayouts = indirect_occlusion_descriptor_set_layouts;
 		pipeline_layout_create_info.pushConstantRangeCount = 1;
 		pipeline_layout_create_info.pPushConstantRanges = &push_constant_range;
 
-		err = vkCreatePipelineLayout (vulkan_globals.device, &pipeline_layout_create_info, NULL, &vulkan_globals.update_lightmap_pipeline.layout.handle);
+		err = vkCreatePipelineLayout (vulkan_globals.device, &pipeline_layout_create_info, NULL, &vulkan_globals.indirect_occlusion_pipeline.layout.handle);
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkCreatePipelineLayout failed");
-		GL_SetObjectName ((uint64_t)vulkan_globals.update_lightmap_pipeline.layout.handle, VK_OBJECT_TYPE_PIPELINE_LAYOUT, "update_lightmap_pipeline_layout");
-		vulkan_globals.update_lightmap_pipeline.layout.push_constant_range = push_constant_range;
+		GL_SetObjectName (
+			(uint64_t)vulkan_globals.indirect_occlusion_pipeline.layout.handle, VK_OBJECT_TYPE_PIPELINE_LAYOUT, "indirect_occlusion_pipeline_layout");
+		vulkan_globals.indirect_occlusion_pipeline.layout.push_constant_range = push_constant_range;
 	}
 
-	if (vulkan_globals.ray_query)
 	{
-		// Update lightmaps RT
-		VkDescriptorSetLayout update_lightmap_rt_descriptor_set_layouts[1] = {
-			vulkan_globals.lightmap_compute_rt_set_layout.handle,
+		// PVS leaf marking
+		VkDescriptorSetLayout mark_leafs_descriptor_set_layouts[1] = {
+			vulkan_globals.indirect_compute_set_layout.handle,
 		};
 
 		ZEROED_STRUCT (VkPushConstantRange, push_constant_range);
 		push_constant_range.offset = 0;
-		push_constant_range.size = 7 * sizeof (uint32_t);
+		push_constant_range.size = 84; // sizeof(mark_leafs_push_constants_t)
 		push_constant_range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
 
 		ZEROED_STRUCT (VkPipelineLayoutCreateInfo, pipeline_layout_create_info);
 		pipeline_layout_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
 		pipeline_layout_create_info.setLayoutCount = 1;
-		pipeline_layout_create_info.pSetLayouts = update_lightmap_rt_descriptor_set_layouts;
+		pipeline_layout_create_info.pSetLayouts = mark_leafs_descriptor_set_layouts;
 		pipeline_layout_create_info.pushConstantRangeCount = 1;
 		pipeline_layout_create_info.pPushConstantRanges = &push_constant_range;
 
-		err = vkCreatePipelineLayout (vulkan_globals.device, &pipeline_layout_create_info, NULL, &vulkan_globals.update_lightmap_rt_pipeline.layout.handle);
+		err = vkCreatePipelineLayout (vulkan_globals.device, &pipeline_layout_create_info, NULL, &vulkan_globals.mark_leafs_pipeline.layout.handle);
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkCreatePipelineLayout failed");
-		GL_SetObjectName (
-			(uint64_t)vulkan_globals.update_lightmap_rt_pipeline.layout.handle, VK_OBJECT_TYPE_PIPELINE_LAYOUT, "update_lightmap_rt_pipeline_layout");
-		vulkan_globals.update_lightmap_rt_pipeline.layout.push_constant_range = push_constant_range;
+		GL_SetObjectName ((uint64_t)vulkan_globals.mark_leafs_pipeline.layout.handle, VK_OBJECT_TYPE_PIPELINE_LAYOUT, "mark_leafs_pipeline_layout");
+		vulkan_globals.mark_leafs_pipeline.layout.push_constant_range = push_constant_range;
 	}
 
 	{
-		// Indirect draw
-		VkDescriptorSetLayout indirect_draw_descriptor_set_layouts[1] = {
-			vulkan_globals.indirect_compute_set_layout.handle,
+		// GPU particle simulation
+		VkDescriptorSetLayout update_particles_descriptor_set_layouts[1] = {
+			vulkan_globals.particle_compute_set_layout.handle,
 		};
 
 		ZEROED_STRUCT (VkPushConstantRange, push_constant_range);
 		push_constant_range.offset = 0;
-		push_constant_range.size = 6 * sizeof (uint32_t);
+		push_constant_range.size = 68; // sizeof(update_particles_push_constants_t)
 		push_constant_range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
 
 		ZEROED_STRUCT (VkPipelineLayoutCreateInfo, pipeline_layout_create_info);
 		pipeline_layout_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
 		pipeline_layout_create_info.setLayoutCount = 1;
-		pipeline_layout_create_info.pSetLayouts = indirect_draw_descriptor_set_layouts;
+		pipeline_layout_create_info.pSetLayouts = update_particles_descriptor_set_layouts;
 		pipeline_layout_create_info.pushConstantRangeCount = 1;
 		pipeline_layout_create_info.pPushConstantRanges = &push_constant_range;
 
-		err = vkCreatePipelineLayout (vulkan_globals.device, &pipeline_layout_create_info, NULL, &vulkan_globals.indirect_draw_pipeline.layout.handle);
+		err = vkCreatePipelineLayout (vulkan_globals.device, &pipeline_layout_create_info, NULL, &vulkan_globals.update_particles_pipeline.layout.handle);
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkCreatePipelineLayout failed");
-		GL_SetObjectName ((uint64_t)vulkan_globals.indirect_draw_pipeline.layout.handle, VK_OBJECT_TYPE_PIPELINE_LAYOUT, "indirect_draw_pipeline_layout");
-		vulkan_globals.indirect_draw_pipeline.layout.push_constant_range = push_constant_range;
+		GL_SetObjectName (
+			(uint64_t)vulkan_globals.update_particles_pipeline.layout.handle, VK_OBJECT_TYPE_PIPELINE_LAYOUT, "update_particles_pipeline_layout");
+		vulkan_globals.update_particles_pipeline.layout.push_constant_range = push_constant_range;
+	}
 
-		err = vkCreatePipelineLayout (vulkan_globals.device, &pipeline_layout_create_info, NULL, &vulkan_globals.indirect_clear_pipeline.layout.handle);
+	{
+		// Dlight froxel binning
+		ZEROED_STRUCT (VkPipelineLayoutCreateInfo, pipeline_layout_create_info);
+		pipeline_layout_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipeline_layout_create_info.setLayoutCount = 1;
+		pipeline_layout_create_info.pSetLayouts = &vulkan_globals.dlight_cluster_set_layout.handle;
+
+		err = vkCreatePipelineLayout (vulkan_globals.device, &pipeline_layout_create_info, NULL, &vulkan_globals.dlight_clusters_pipeline.layout.handle);
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkCreatePipelineLayout failed");
-		GL_SetObjectName ((uint64_t)vulkan_globals.indirect_clear_pipeline.layout.handle, VK_OBJECT_TYPE_PIPELINE_LAYOUT, "indirect_clear_pipeline_layout");
-		vulkan_globals.indirect_clear_pipeline.layout.push_constant_range = push_constant_range;
+		GL_SetObjectName ((uint64_t)vulkan_globals.dlight_clusters_pipeline.layout.handle, VK_OBJECT_TYPE_PIPELINE_LAYOUT, "dlight_clusters_pipeline_layout");
 	}
 
 	if (vulkan_globals.ray_query)
 	{
-		// Mesh interpolate pipeline (MDL/MD3) - uses buffer device addresses via push constants
+		// Mesh interpolate pipeline (MDL/MD3) - push constants hold the device address of the per-entity params
 		ZEROED_STRUCT (VkPushConstantRange, push_constant_range);
 		push_constant_range.offset = 0;
-		push_constant_range.size = 40; // sizeof(mesh_interpolate_push_constants_t)
+		push_constant_range.size = sizeof (VkDeviceAddress);
 		push_constant_range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
 
 		ZEROED_STRUCT (VkPipelineLayoutCreateInfo, pipeline_layout_create_info);
@@ -1887,8 +2300,7 @@ void R_CreatePipelineLayouts ()
 		GL_SetObjectName ((uint64_t)vulkan_globals.mesh_interpolate_pipeline.layout.handle, VK_OBJECT_TYPE_PIPELINE_LAYOUT, "mesh_interpolate_pipeline_layout");
 		vulkan_globals.mesh_interpolate_pipeline.layout.push_constant_range = push_constant_range;
 
-		// Skinning pipeline (MD5) - uses buffer device addresses via push constants
-		push_constant_range.size = q_max (sizeof (skinning_push_constants_t), sizeof (mesh_interpolate_push_constants_t));
+		// Skinning pipeline (MD5) - same layout as mesh interpolate
 
 		err = vkCreatePipelineLayout (vulkan_globals.device, &pipeline_layout_create_info, NULL, &vulkan_globals.skinning_pipeline.layout.handle);
 		if (err != VK_SUCCESS)
@@ -2109,19 +2521,20 @@ static VkShaderModule R_CreateShaderModule (const byte *code, const int size, co
 
 typedef struct pipeline_create_infos_s
 {
-	VkPipelineShaderStageCreateInfo		   shader_stages[2];
-	VkPipelineDynamicStateCreateInfo	   dynamic_state;
-	VkDynamicState						   dynamic_states[3];
-	VkPipelineVertexInputStateCreateInfo   vertex_input_state;
-	VkPipelineInputAssemblyStateCreateInfo input_assembly_state;
-	VkPipelineViewportStateCreateInfo	   viewport_state;
-	VkPipelineRasterizationStateCreateInfo rasterization_state;
-	VkPipelineMultisampleStateCreateInfo   multisample_state;
-	VkPipelineDepthStencilStateCreateInfo  depth_stencil_state;
-	VkPipelineColorBlendStateCreateInfo	   color_blend_state;
-	VkPipelineColorBlendAttachmentState	   blend_attachment_state;
-	VkGraphicsPipelineCreateInfo		   graphics_pipeline;
-	VkComputePipelineCreateInfo			   compute_pipeline;
+	VkPipelineShaderStageCreateInfo					shader_stages[2];
+	VkPipelineDynamicStateCreateInfo				dynamic_state;
+	VkDynamicState									dynamic_states[3];
+	VkPipelineVertexInputStateCreateInfo			vertex_input_state;
+	VkPipelineInputAssemblyStateCreateInfo			input_assembly_state;
+	VkPipelineViewportStateCreateInfo				viewport_state;
+	VkPipelineRasterizationStateCreateInfo			rasterization_state;
+	VkPipelineMultisampleStateCreateInfo			multisample_state;
+	VkPipelineDepthStencilStateCreateInfo			depth_stencil_state;
+	VkPipelineColorBlendStateCreateInfo				color_blend_state;
+	VkPipelineColorBlendAttachmentState				blend_attachment_state;
+	VkPipelineFragmentShadingRateStateCreateInfoKHR	shading_rate_state;
+	VkGraphicsPipelineCreateInfo					graphics_pipeline;
+	VkComputePipelineCreateInfo						compute_pipeline;
 } pipeline_create_infos_t;
 
 static VkVertexInputAttributeDescription basic_vertex_input_attribute_descriptions[3];
@@ -2154,13 +2567,13 @@ static VkVertexInputBindingDescription	 md5_vertex_binding_description;
 
 DECLARE_SHADER_MODULE (basic_vert);
 DECLARE_SHADER_MODULE (basic_frag);
-DECLARE_SHADER_MODULE (basic_alphatest_frag);
 DECLARE_SHADER_MODULE (basic_notex_frag);
 DECLARE_SHADER_MODULE (world_vert);
 DECLARE_SHADER_MODULE (world_frag);
+DECLARE_SHADER_MODULE (world_bindless_frag);
 DECLARE_SHADER_MODULE (alias_vert);
+DECLARE_SHADER_MODULE (alias_instanced_vert);
 DECLARE_SHADER_MODULE (alias_frag);
-DECLARE_SHADER_MODULE (alias_alphatest_frag);
 DECLARE_SHADER_MODULE (md5_vert);
 DECLARE_SHADER_MODULE (sky_layer_vert);
 DECLARE_SHADER_MODULE (sky_layer_frag);
@@ -2169,6 +2582,7 @@ DECLARE_SHADER_MODULE (sky_cube_vert);
 DECLARE_SHADER_MODULE (sky_cube_frag);
 DECLARE_SHADER_MODULE (postprocess_vert);
 DECLARE_SHADER_MODULE (postprocess_frag);
+DECLARE_SHADER_MODULE (postprocess_fused_frag);
 DECLARE_SHADER_MODULE (screen_effects_8bit_comp);
 DECLARE_SHADER_MODULE (screen_effects_8bit_scale_comp);
 DECLARE_SHADER_MODULE (screen_effects_8bit_scale_sops_comp);
@@ -2176,18 +2590,29 @@ DECLARE_SHADER_MODULE (screen_effects_10bit_comp);
 DECLARE_SHADER_MODULE (screen_effects_10bit_scale_comp);
 DECLARE_SHADER_MODULE (screen_effects_10bit_scale_sops_comp);
 DECLARE_SHADER_MODULE (cs_tex_warp_comp);
+DECLARE_SHADER_MODULE (depth_pyramid_comp);
+DECLARE_SHADER_MODULE (shading_rate_comp);
 DECLARE_SHADER_MODULE (indirect_comp);
 DECLARE_SHADER_MODULE (indirect_clear_comp);
+DECLARE_SHADER_MODULE (indirect_occlusion_comp);
+DECLARE_SHADER_MODULE (mark_leafs_comp);
+DECLARE_SHADER_MODULE (update_particles_comp);
 DECLARE_SHADER_MODULE (showtris_vert);
 DECLARE_SHADER_MODULE (showtris_frag);
 DECLARE_SHADER_MODULE (update_lightmap_8bit_comp);
 DECLARE_SHADER_MODULE (update_lightmap_8bit_rt_comp);
 DECLARE_SHADER_MODULE (update_lightmap_10bit_comp);
 DECLARE_SHADER_MODULE (update_lightmap_10bit_rt_comp);
+DECLARE_SHADER_MODULE (dlight_clusters_comp);
 DECLARE_SHADER_MODULE (ray_debug_comp);
 DECLARE_SHADER_MODULE (mesh_interpolate_comp);
 DECLARE_SHADER_MODULE (skinning_comp);
 
+// basic.frag and alias.frag discard below 0.666 alpha when constant 0 is set
+static const uint32_t				  alpha_test_spec_data = VK_TRUE;
+static const VkSpecializationMapEntry alpha_test_spec_entry = {0, 0, sizeof (uint32_t)};
+static const VkSpecializationInfo	  alpha_test_specialization_info = {1, &alpha_test_spec_entry, sizeof (uint32_t), &alpha_test_spec_data};
+
 /*
 ===============
 R_InitVertexAttributes
@@ -2385,6 +2810,17 @@ static void R_InitDefaultStates (pipeline_create_infos_t *infos)
 	infos->graphics_pipeline.pDynamicState = &infos->dynamic_state;
 	infos->graphics_pipeline.layout = vulkan_globals.basic_pipeline_layout.handle;
 	infos->graphics_pipeline.renderPass = vulkan_globals.secondary_cb_contexts[SCBX_WORLD][0].render_pass;
+
+	// Let the shading rate attachment of the main render pass pick the rate, render passes without one shade at 1x1
+	if (vulkan_globals.shading_rate)
+	{
+		infos->shading_rate_state.sType = VK_STRUCTURE_TYPE_PIPELINE_FRAGMENT_SHADING_RATE_STATE_CREATE_INFO_KHR;
+		infos->shading_rate_state.fragmentSize.width = 1;
+		infos->shading_rate_state.fragmentSize.height = 1;
+		infos->shading_rate_state.combinerOps[0] = VK_FRAGMENT_SHADING_RATE_COMBINER_OP_KEEP_KHR;
+		infos->shading_rate_state.combinerOps[1] = VK_FRAGMENT_SHADING_RATE_COMBINER_OP_REPLACE_KHR;
+		infos->graphics_pipeline.pNext = &infos->shading_rate_state;
+	}
 }
 
 /*
@@ -2402,7 +2838,8 @@ static void R_CreateBasicPipelines ()
 	VkRenderPass main_render_pass = vulkan_globals.secondary_cb_contexts[SCBX_WORLD][0].render_pass;
 	VkRenderPass ui_render_pass = vulkan_globals.secondary_cb_contexts[SCBX_GUI]->render_pass;
 
-	infos.shader_stages[1].module = basic_alphatest_frag_module;
+	infos.shader_stages[1].module = basic_frag_module;
+	infos.shader_stages[1].pSpecializationInfo = &alpha_test_specialization_info;
 	for (render_pass = 0; render_pass < 2; ++render_pass)
 	{
 		infos.graphics_pipeline.renderPass = (render_pass == 0) ? main_render_pass : ui_render_pass;
@@ -2410,7 +2847,8 @@ static void R_CreateBasicPipelines ()
 
 		assert (vulkan_globals.basic_alphatest_pipeline[render_pass].handle == VK_NULL_HANDLE);
 		err = vkCreateGraphicsPipelines (
-			vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.basic_alphatest_pipeline[render_pass].handle);
+			vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL,
+			&vulkan_globals.basic_alphatest_pipeline[render_pass].handle);
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkCreateGraphicsPipelines failed");
 		vulkan_globals.basic_alphatest_pipeline[render_pass].layout = vulkan_globals.basic_pipeline_layout;
@@ -2418,6 +2856,7 @@ static void R_CreateBasicPipelines ()
 	}
 
 	infos.shader_stages[1].module = basic_notex_frag_module;
+	infos.shader_stages[1].pSpecializationInfo = NULL;
 	infos.blend_attachment_state.blendEnable = VK_TRUE;
 
 	for (render_pass = 0; render_pass < 2; ++render_pass)
@@ -2427,7 +2866,8 @@ static void R_CreateBasicPipelines ()
 
 		assert (vulkan_globals.basic_notex_blend_pipeline[render_pass].handle == VK_NULL_HANDLE);
 		err = vkCreateGraphicsPipelines (
-			vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.basic_notex_blend_pipeline[render_pass].handle);
+			vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL,
+			&vulkan_globals.basic_notex_blend_pipeline[render_pass].handle);
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkCreateGraphicsPipelines failed");
 		vulkan_globals.basic_notex_blend_pipeline[render_pass].layout = vulkan_globals.basic_pipeline_layout;
@@ -2447,7 +2887,7 @@ static void R_CreateBasicPipelines ()
 
 		assert (vulkan_globals.basic_blend_pipeline[render_pass].handle == VK_NULL_HANDLE);
 		err = vkCreateGraphicsPipelines (
-			vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.basic_blend_pipeline[render_pass].handle);
+			vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.basic_blend_pipeline[render_pass].handle);
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkCreateGraphicsPipelines failed");
 		vulkan_globals.basic_blend_pipeline[render_pass].layout = vulkan_globals.basic_pipeline_layout;
@@ -2480,7 +2920,8 @@ static void R_CreateWarpPipelines ()
 	infos.graphics_pipeline.renderPass = vulkan_globals.warp_render_pass;
 
 	assert (vulkan_globals.raster_tex_warp_pipeline.handle == VK_NULL_HANDLE);
-	err = vkCreateGraphicsPipelines (vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.raster_tex_warp_pipeline.handle);
+	err = vkCreateGraphicsPipelines (
+		vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.raster_tex_warp_pipeline.handle);
 	if (err != VK_SUCCESS)
 		Sys_Error ("vkCreateGraphicsPipelines failed (raster_tex_warp_pipeline)");
 	vulkan_globals.raster_tex_warp_pipeline.layout = vulkan_globals.basic_pipeline_layout;
@@ -2498,7 +2939,8 @@ static void R_CreateWarpPipelines ()
 	infos.compute_pipeline.layout = vulkan_globals.cs_tex_warp_pipeline.layout.handle;
 
 	assert (vulkan_globals.cs_tex_warp_pipeline.handle == VK_NULL_HANDLE);
-	err = vkCreateComputePipelines (vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.compute_pipeline, NULL, &vulkan_globals.cs_tex_warp_pipeline.handle);
+	err = vkCreateComputePipelines (
+		vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.compute_pipeline, NULL, &vulkan_globals.cs_tex_warp_pipeline.handle);
 	if (err != VK_SUCCESS)
 		Sys_Error ("vkCreateComputePipelines failed (cs_tex_warp_pipeline)");
 	GL_SetObjectName ((uint64_t)vulkan_globals.cs_tex_warp_pipeline.handle, VK_OBJECT_TYPE_PIPELINE, "cs_tex_warp");
@@ -2523,11 +2965,30 @@ static void R_CreateParticlesPipelines ()
 	infos.blend_attachment_state.blendEnable = VK_TRUE;
 
 	assert (vulkan_globals.particle_pipeline.handle == VK_NULL_HANDLE);
-	err = vkCreateGraphicsPipelines (vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.particle_pipeline.handle);
+	err = vkCreateGraphicsPipelines (
+		vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.particle_pipeline.handle);
 	if (err != VK_SUCCESS)
 		Sys_Error ("vkCreateGraphicsPipelines failed");
 	vulkan_globals.particle_pipeline.layout = vulkan_globals.basic_pipeline_layout;
 	GL_SetObjectName ((uint64_t)vulkan_globals.particle_pipeline.handle, VK_OBJECT_TYPE_PIPELINE, "particles");
+
+	ZEROED_STRUCT (VkPipelineShaderStageCreateInfo, compute_shader_stage);
+	compute_shader_stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	compute_shader_stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+	compute_shader_stage.module = update_particles_comp_module;
+	compute_shader_stage.pName = "main";
+
+	memset (&infos.compute_pipeline, 0, sizeof (infos.compute_pipeline));
+	infos.compute_pipeline.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+	infos.compute_pipeline.stage = compute_shader_stage;
+	infos.compute_pipeline.layout = vulkan_globals.update_particles_pipeline.layout.handle;
+
+	assert (vulkan_globals.update_particles_pipeline.handle == VK_NULL_HANDLE);
+	err = vkCreateComputePipelines (
+		vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.compute_pipeline, NULL, &vulkan_globals.update_particles_pipeline.handle);
+	if (err != VK_SUCCESS)
+		Sys_Error ("vkCreateComputePipelines failed (update_particles_pipeline)");
+	GL_SetObjectName ((uint64_t)vulkan_globals.update_particles_pipeline.handle, VK_OBJECT_TYPE_PIPELINE, "update_particles");
 }
 
 /*
@@ -2557,7 +3018,8 @@ static void R_CreateRayDebugPipelines ()
 	infos.compute_pipeline.layout = vulkan_globals.ray_debug_pipeline.layout.handle;
 
 	assert (vulkan_globals.ray_debug_pipeline.handle == VK_NULL_HANDLE);
-	err = vkCreateComputePipelines (vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.compute_pipeline, NULL, &vulkan_globals.ray_debug_pipeline.handle);
+	err = vkCreateComputePipelines (
+		vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.compute_pipeline, NULL, &vulkan_globals.ray_debug_pipeline.handle);
 	if (err != VK_SUCCESS)
 		Sys_Error ("vkCreateComputePipelines failed (ray_debug_pipeline)");
 	GL_SetObjectName ((uint64_t)vulkan_globals.ray_debug_pipeline.handle, VK_OBJECT_TYPE_PIPELINE, "ray_debug_pipeline");
@@ -2590,7 +3052,8 @@ static void R_CreateAnimComputePipelines ()
 	infos.compute_pipeline.layout = vulkan_globals.mesh_interpolate_pipeline.layout.handle;
 
 	assert (vulkan_globals.mesh_interpolate_pipeline.handle == VK_NULL_HANDLE);
-	err = vkCreateComputePipelines (vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.compute_pipeline, NULL, &vulkan_globals.mesh_interpolate_pipeline.handle);
+	err = vkCreateComputePipelines (
+		vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.compute_pipeline, NULL, &vulkan_globals.mesh_interpolate_pipeline.handle);
 	if (err != VK_SUCCESS)
 		Sys_Error ("vkCreateComputePipelines failed (mesh_interpolate_pipeline)");
 	GL_SetObjectName ((uint64_t)vulkan_globals.mesh_interpolate_pipeline.handle, VK_OBJECT_TYPE_PIPELINE, "mesh_interpolate_pipeline");
@@ -2600,7 +3063,8 @@ static void R_CreateAnimComputePipelines ()
 	infos.compute_pipeline.layout = vulkan_globals.skinning_pipeline.layout.handle;
 
 	assert (vulkan_globals.skinning_pipeline.handle == VK_NULL_HANDLE);
-	err = vkCreateComputePipelines (vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.compute_pipeline, NULL, &vulkan_globals.skinning_pipeline.handle);
+	err = vkCreateComputePipelines (
+		vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.compute_pipeline, NULL, &vulkan_globals.skinning_pipeline.handle);
 	if (err != VK_SUCCESS)
 		Sys_Error ("vkCreateComputePipelines failed (skinning_pipeline)");
 	GL_SetObjectName ((uint64_t)vulkan_globals.skinning_pipeline.handle, VK_OBJECT_TYPE_PIPELINE, "skinning_pipeline");
@@ -2680,7 +3144,7 @@ static void R_CreateFTEParticlesPipelines ()
 
 		assert (vulkan_globals.fte_particle_pipelines[i].handle == VK_NULL_HANDLE);
 		err = vkCreateGraphicsPipelines (
-			vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.fte_particle_pipelines[i].handle);
+			vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.fte_particle_pipelines[i].handle);
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkCreateGraphicsPipelines failed (fte_particle_pipelines[%d]", i);
 		vulkan_globals.fte_particle_pipelines[i].layout = vulkan_globals.basic_pipeline_layout;
@@ -2693,7 +3157,7 @@ static void R_CreateFTEParticlesPipelines ()
 
 			assert (vulkan_globals.fte_particle_pipelines[i + 8].handle == VK_NULL_HANDLE);
 			err = vkCreateGraphicsPipelines (
-				vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.fte_particle_pipelines[i + 8].handle);
+				vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.fte_particle_pipelines[i + 8].handle);
 			if (err != VK_SUCCESS)
 				Sys_Error ("vkCreateGraphicsPipelines failed (vulkan_globals.fte_particle_pipelines[%d])", i + 8);
 			vulkan_globals.fte_particle_pipelines[i + 8].layout = vulkan_globals.basic_pipeline_layout;
@@ -2715,7 +3179,8 @@ static void R_CreateSpritesPipelines ()
 	R_InitDefaultStates (&infos);
 
 	infos.shader_stages[0].module = basic_vert_module;
-	infos.shader_stages[1].module = basic_alphatest_frag_module;
+	infos.shader_stages[1].module = basic_frag_module;
+	infos.shader_stages[1].pSpecializationInfo = &alpha_test_specialization_info;
 	infos.blend_attachment_state.blendEnable = VK_FALSE;
 	infos.depth_stencil_state.depthTestEnable = VK_TRUE;
 	infos.depth_stencil_state.depthWriteEnable = VK_TRUE;
@@ -2723,7 +3188,8 @@ static void R_CreateSpritesPipelines ()
 	infos.dynamic_states[infos.dynamic_state.dynamicStateCount++] = VK_DYNAMIC_STATE_DEPTH_BIAS;
 
 	assert (vulkan_globals.sprite_pipeline.handle == VK_NULL_HANDLE);
-	err = vkCreateGraphicsPipelines (vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.sprite_pipeline.handle);
+	err = vkCreateGraphicsPipelines (
+		vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.sprite_pipeline.handle);
 	if (err != VK_SUCCESS)
 		Sys_Error ("vkCreateGraphicsPipelines failed (sprite_pipeline)");
 	vulkan_globals.sprite_pipeline.layout = vulkan_globals.basic_pipeline_layout;
@@ -2773,7 +3239,7 @@ static void R_CreateSkyPipelines ()
 
 		assert (vulkan_globals.sky_stencil_pipeline[i].handle == VK_NULL_HANDLE);
 		err = vkCreateGraphicsPipelines (
-			vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.sky_stencil_pipeline[i].handle);
+			vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.sky_stencil_pipeline[i].handle);
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkCreateGraphicsPipelines failed (sky_stencil_pipeline)");
 		vulkan_globals.sky_stencil_pipeline[i].layout = vulkan_globals.sky_pipeline_layout[0];
@@ -2787,7 +3253,8 @@ static void R_CreateSkyPipelines ()
 
 		assert (vulkan_globals.sky_color_pipeline[i].handle == VK_NULL_HANDLE);
 		err =
-			vkCreateGraphicsPipelines (vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.sky_color_pipeline[i].handle);
+			vkCreateGraphicsPipelines (
+				vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.sky_color_pipeline[i].handle);
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkCreateGraphicsPipelines failed (sky_color_pipeline)");
 		vulkan_globals.sky_color_pipeline[i].layout = vulkan_globals.sky_pipeline_layout[0];
@@ -2796,7 +3263,8 @@ static void R_CreateSkyPipelines ()
 		infos.shader_stages[0].module = sky_cube_vert_module;
 		infos.shader_stages[1].module = sky_cube_frag_module;
 		assert (vulkan_globals.sky_cube_pipeline[i].handle == VK_NULL_HANDLE);
-		err = vkCreateGraphicsPipelines (vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.sky_cube_pipeline[i].handle);
+		err = vkCreateGraphicsPipelines (
+			vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.sky_cube_pipeline[i].handle);
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkCreateGraphicsPipelines failed (sky_cube_pipeline)");
 		GL_SetObjectName ((uint64_t)vulkan_globals.sky_cube_pipeline[i].handle, VK_OBJECT_TYPE_PIPELINE, i ? "sky_cube_indirect" : "sky_cube");
@@ -2807,7 +3275,8 @@ static void R_CreateSkyPipelines ()
 		infos.graphics_pipeline.layout = vulkan_globals.sky_pipeline_layout[1].handle;
 		assert (vulkan_globals.sky_layer_pipeline[i].handle == VK_NULL_HANDLE);
 		err =
-			vkCreateGraphicsPipelines (vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.sky_layer_pipeline[i].handle);
+			vkCreateGraphicsPipelines (
+				vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.sky_layer_pipeline[i].handle);
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkCreateGraphicsPipelines failed (sky_layer_pipeline)");
 		GL_SetObjectName ((uint64_t)vulkan_globals.sky_layer_pipeline[i].handle, VK_OBJECT_TYPE_PIPELINE, i ? "sky_layer_indirect" : "sky_layer");
@@ -2831,7 +3300,8 @@ static void R_CreateSkyPipelines ()
 		infos.graphics_pipeline.layout = vulkan_globals.sky_pipeline_layout[0].handle;
 
 		assert (vulkan_globals.sky_box_pipeline.handle == VK_NULL_HANDLE);
-		err = vkCreateGraphicsPipelines (vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.sky_box_pipeline.handle);
+		err = vkCreateGraphicsPipelines (
+			vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.sky_box_pipeline.handle);
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkCreateGraphicsPipelines failed (sky_box_pipeline)");
 		GL_SetObjectName ((uint64_t)vulkan_globals.sky_box_pipeline.handle, VK_OBJECT_TYPE_PIPELINE, "sky_box");
@@ -2881,7 +3351,8 @@ static void R_CreateShowTrisPipelines ()
 		infos.graphics_pipeline.layout = vulkan_globals.basic_pipeline_layout.handle;
 
 		assert (vulkan_globals.showtris_pipeline.handle == VK_NULL_HANDLE);
-		err = vkCreateGraphicsPipelines (vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.showtris_pipeline.handle);
+		err = vkCreateGraphicsPipelines (
+			vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.showtris_pipeline.handle);
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkCreateGraphicsPipelines failed (showtris_pipeline)");
 		vulkan_globals.showtris_pipeline.layout = vulkan_globals.basic_pipeline_layout;
@@ -2894,7 +3365,7 @@ static void R_CreateShowTrisPipelines ()
 
 		assert (vulkan_globals.showtris_depth_test_pipeline.handle == VK_NULL_HANDLE);
 		err = vkCreateGraphicsPipelines (
-			vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.showtris_depth_test_pipeline.handle);
+			vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.showtris_depth_test_pipeline.handle);
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkCreateGraphicsPipelines failed (showtris_depth_test_pipeline)");
 		vulkan_globals.showtris_depth_test_pipeline.layout = vulkan_globals.basic_pipeline_layout;
@@ -2905,7 +3376,8 @@ static void R_CreateShowTrisPipelines ()
 		infos.rasterization_state.depthBiasEnable = VK_FALSE;
 		infos.input_assembly_state.topology = VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
 		assert (vulkan_globals.showbboxes_pipeline.handle == VK_NULL_HANDLE);
-		err = vkCreateGraphicsPipelines (vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.showbboxes_pipeline.handle);
+		err = vkCreateGraphicsPipelines (
+			vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.showbboxes_pipeline.handle);
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkCreateGraphicsPipelines failed (showtris_depth_test)");
 		vulkan_globals.showbboxes_pipeline.layout = vulkan_globals.basic_pipeline_layout;
@@ -2920,7 +3392,7 @@ static void R_CreateShowTrisPipelines ()
 
 		assert (vulkan_globals.showtris_indirect_pipeline.handle == VK_NULL_HANDLE);
 		err = vkCreateGraphicsPipelines (
-			vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.showtris_indirect_pipeline.handle);
+			vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.showtris_indirect_pipeline.handle);
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkCreateGraphicsPipelines failed (showtris_indirect_pipeline)");
 		vulkan_globals.showtris_indirect_pipeline.layout = vulkan_globals.basic_pipeline_layout;
@@ -2931,7 +3403,8 @@ static void R_CreateShowTrisPipelines ()
 
 		assert (vulkan_globals.showtris_indirect_depth_test_pipeline.handle == VK_NULL_HANDLE);
 		err = vkCreateGraphicsPipelines (
-			vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.showtris_indirect_depth_test_pipeline.handle);
+			vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL,
+			&vulkan_globals.showtris_indirect_depth_test_pipeline.handle);
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkCreateGraphicsPipelines failed (showtris_indirect_depth_test_pipeline)");
 		vulkan_globals.showtris_indirect_depth_test_pipeline.layout = vulkan_globals.basic_pipeline_layout;
@@ -3030,12 +3503,35 @@ static void R_CreateWorldPipelines ()
 
 					assert (vulkan_globals.world_pipelines[pipeline_index].handle == VK_NULL_HANDLE);
 					err = vkCreateGraphicsPipelines (
-						vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.world_pipelines[pipeline_index].handle);
+						vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL,
+						&vulkan_globals.world_pipelines[pipeline_index].handle);
 					if (err != VK_SUCCESS)
 						Sys_Error ("vkCreateGraphicsPipelines failed (world_pipelines[%d])", pipeline_index);
 					GL_SetObjectName (
 						(uint64_t)vulkan_globals.world_pipelines[pipeline_index].handle, VK_OBJECT_TYPE_PIPELINE, va ("world %d", pipeline_index));
 					vulkan_globals.world_pipelines[pipeline_index].layout = vulkan_globals.world_pipeline_layout;
+
+					if (vulkan_globals.bindless)
+					{
+						infos.graphics_pipeline.layout = vulkan_globals.world_bindless_pipeline_layout.handle;
+						infos.shader_stages[1].module = world_bindless_frag_module;
+						if (pipeline_index > 0)
+							infos.graphics_pipeline.basePipelineHandle = vulkan_globals.world_bindless_pipelines[0].handle;
+
+						assert (vulkan_globals.world_bindless_pipelines[pipeline_index].handle == VK_NULL_HANDLE);
+						err = vkCreateGraphicsPipelines (
+							vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL,
+							&vulkan_globals.world_bindless_pipelines[pipeline_index].handle);
+						if (err != VK_SUCCESS)
+							Sys_Error ("vkCreateGraphicsPipelines failed (world_bindless_pipelines[%d])", pipeline_index);
+						GL_SetObjectName (
+							(uint64_t)vulkan_globals.world_bindless_pipelines[pipeline_index].handle, VK_OBJECT_TYPE_PIPELINE,
+							va ("world bindless %d", pipeline_index));
+						vulkan_globals.world_bindless_pipelines[pipeline_index].layout = vulkan_globals.world_bindless_pipeline_layout;
+
+						infos.graphics_pipeline.layout = vulkan_globals.world_pipeline_layout.handle;
+						infos.shader_stages[1].module = world_frag_module;
+					}
 				}
 			}
 		}
@@ -3070,35 +3566,66 @@ static void R_CreateAliasPipelines ()
 	infos.graphics_pipeline.layout = vulkan_globals.alias_pipelines[0].layout.handle;
 
 	assert (vulkan_globals.alias_pipelines[0].handle == VK_NULL_HANDLE);
-	err = vkCreateGraphicsPipelines (vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.alias_pipelines[0].handle);
+	err = vkCreateGraphicsPipelines (
+		vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.alias_pipelines[0].handle);
 	if (err != VK_SUCCESS)
 		Sys_Error ("vkCreateGraphicsPipelines failed (alias_pipeline)");
 	GL_SetObjectName ((uint64_t)vulkan_globals.alias_pipelines[0].handle, VK_OBJECT_TYPE_PIPELINE, "alias");
 
-	infos.shader_stages[1].module = alias_alphatest_frag_module;
+	infos.shader_stages[1].module = alias_frag_module;
+	infos.shader_stages[1].pSpecializationInfo = &alpha_test_specialization_info;
 
 	assert (vulkan_globals.alias_pipelines[1].handle == VK_NULL_HANDLE);
-	err = vkCreateGraphicsPipelines (vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.alias_pipelines[1].handle);
+	err = vkCreateGraphicsPipelines (
+		vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.alias_pipelines[1].handle);
 	if (err != VK_SUCCESS)
 		Sys_Error ("vkCreateGraphicsPipelines failed (alias_alphatest_pipeline)");
 	GL_SetObjectName ((uint64_t)vulkan_globals.alias_pipelines[1].handle, VK_OBJECT_TYPE_PIPELINE, "alias_alphatest");
 	vulkan_globals.alias_pipelines[1].layout = vulkan_globals.alias_pipelines[0].layout;
 
+	infos.shader_stages[0].module = alias_instanced_vert_module;
+	infos.shader_stages[1].module = alias_frag_module;
+	infos.shader_stages[1].pSpecializationInfo = NULL;
+
+	assert (vulkan_globals.alias_instanced_pipelines[0].handle == VK_NULL_HANDLE);
+	err = vkCreateGraphicsPipelines (
+		vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.alias_instanced_pipelines[0].handle);
+	if (err != VK_SUCCESS)
+		Sys_Error ("vkCreateGraphicsPipelines failed (alias_instanced_pipeline)");
+	GL_SetObjectName ((uint64_t)vulkan_globals.alias_instanced_pipelines[0].handle, VK_OBJECT_TYPE_PIPELINE, "alias_instanced");
+	vulkan_globals.alias_instanced_pipelines[0].layout = vulkan_globals.alias_pipelines[0].layout;
+
+	infos.shader_stages[1].module = alias_frag_module;
+	infos.shader_stages[1].pSpecializationInfo = &alpha_test_specialization_info;
+
+	assert (vulkan_globals.alias_instanced_pipelines[1].handle == VK_NULL_HANDLE);
+	err = vkCreateGraphicsPipelines (
+		vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.alias_instanced_pipelines[1].handle);
+	if (err != VK_SUCCESS)
+		Sys_Error ("vkCreateGraphicsPipelines failed (alias_instanced_alphatest_pipeline)");
+	GL_SetObjectName ((uint64_t)vulkan_globals.alias_instanced_pipelines[1].handle, VK_OBJECT_TYPE_PIPELINE, "alias_instanced_alphatest");
+	vulkan_globals.alias_instanced_pipelines[1].layout = vulkan_globals.alias_pipelines[0].layout;
+
+	infos.shader_stages[0].module = alias_vert_module;
 	infos.depth_stencil_state.depthWriteEnable = VK_FALSE;
 	infos.blend_attachment_state.blendEnable = VK_TRUE;
 	infos.shader_stages[1].module = alias_frag_module;
+	infos.shader_stages[1].pSpecializationInfo = NULL;
 
 	assert (vulkan_globals.alias_pipelines[2].handle == VK_NULL_HANDLE);
-	err = vkCreateGraphicsPipelines (vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.alias_pipelines[2].handle);
+	err = vkCreateGraphicsPipelines (
+		vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.alias_pipelines[2].handle);
 	if (err != VK_SUCCESS)
 		Sys_Error ("vkCreateGraphicsPipelines failed (alias_blend_pipeline)");
 	GL_SetObjectName ((uint64_t)vulkan_globals.alias_pipelines[2].handle, VK_OBJECT_TYPE_PIPELINE, "alias_blend");
 	vulkan_globals.alias_pipelines[2].layout = vulkan_globals.alias_pipelines[0].layout;
 
-	infos.shader_stages[1].module = alias_alphatest_frag_module;
+	infos.shader_stages[1].module = alias_frag_module;
+	infos.shader_stages[1].pSpecializationInfo = &alpha_test_specialization_info;
 
 	assert (vulkan_globals.alias_pipelines[3].handle == VK_NULL_HANDLE);
-	err = vkCreateGraphicsPipelines (vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.alias_pipelines[3].handle);
+	err = vkCreateGraphicsPipelines (
+		vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.alias_pipelines[3].handle);
 	if (err != VK_SUCCESS)
 		Sys_Error ("vkCreateGraphicsPipelines failed");
 	GL_SetObjectName ((uint64_t)vulkan_globals.alias_pipelines[3].handle, VK_OBJECT_TYPE_PIPELINE, "alias_alphatest_blend");
@@ -3115,11 +3642,13 @@ static void R_CreateAliasPipelines ()
 
 		infos.shader_stages[0].module = alias_vert_module;
 		infos.shader_stages[1].module = showtris_frag_module;
+		infos.shader_stages[1].pSpecializationInfo = NULL;
 
 		infos.graphics_pipeline.layout = vulkan_globals.alias_pipelines[0].layout.handle;
 
 		assert (vulkan_globals.alias_pipelines[4].handle == VK_NULL_HANDLE);
-		err = vkCreateGraphicsPipelines (vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.alias_pipelines[4].handle);
+		err = vkCreateGraphicsPipelines (
+			vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.alias_pipelines[4].handle);
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkCreateGraphicsPipelines failed");
 		GL_SetObjectName ((uint64_t)vulkan_globals.alias_pipelines[4].handle, VK_OBJECT_TYPE_PIPELINE, "alias_showtris");
@@ -3131,7 +3660,8 @@ static void R_CreateAliasPipelines ()
 		infos.rasterization_state.depthBiasSlopeFactor = 0.0f;
 
 		assert (vulkan_globals.alias_pipelines[5].handle == VK_NULL_HANDLE);
-		err = vkCreateGraphicsPipelines (vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.alias_pipelines[5].handle);
+		err = vkCreateGraphicsPipelines (
+			vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.alias_pipelines[5].handle);
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkCreateGraphicsPipelines failed");
 		GL_SetObjectName ((uint64_t)vulkan_globals.alias_pipelines[5].handle, VK_OBJECT_TYPE_PIPELINE, "alias_showtris_depth_test");
@@ -3167,15 +3697,18 @@ static void R_CreateMD5Pipelines ()
 	infos.graphics_pipeline.layout = vulkan_globals.md5_pipelines[0].layout.handle;
 
 	assert (vulkan_globals.md5_pipelines[0].handle == VK_NULL_HANDLE);
-	err = vkCreateGraphicsPipelines (vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.md5_pipelines[0].handle);
+	err = vkCreateGraphicsPipelines (
+		vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.md5_pipelines[0].handle);
 	if (err != VK_SUCCESS)
 		Sys_Error ("vkCreateGraphicsPipelines failed (md5_pipeline)");
 	GL_SetObjectName ((uint64_t)vulkan_globals.md5_pipelines[0].handle, VK_OBJECT_TYPE_PIPELINE, "md5");
 
-	infos.shader_stages[1].module = alias_alphatest_frag_module;
+	infos.shader_stages[1].module = alias_frag_module;
+	infos.shader_stages[1].pSpecializationInfo = &alpha_test_specialization_info;
 
 	assert (vulkan_globals.md5_pipelines[1].handle == VK_NULL_HANDLE);
-	err = vkCreateGraphicsPipelines (vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.md5_pipelines[1].handle);
+	err = vkCreateGraphicsPipelines (
+		vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.md5_pipelines[1].handle);
 	if (err != VK_SUCCESS)
 		Sys_Error ("vkCreateGraphicsPipelines failed (md5_alphatest_pipeline)");
 	GL_SetObjectName ((uint64_t)vulkan_globals.md5_pipelines[1].handle, VK_OBJECT_TYPE_PIPELINE, "md5_alphatest");
@@ -3184,18 +3717,22 @@ static void R_CreateMD5Pipelines ()
 	infos.depth_stencil_state.depthWriteEnable = VK_FALSE;
 	infos.blend_attachment_state.blendEnable = VK_TRUE;
 	infos.shader_stages[1].module = alias_frag_module;
+	infos.shader_stages[1].pSpecializationInfo = NULL;
 
 	assert (vulkan_globals.md5_pipelines[2].handle == VK_NULL_HANDLE);
-	err = vkCreateGraphicsPipelines (vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.md5_pipelines[2].handle);
+	err = vkCreateGraphicsPipelines (
+		vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.md5_pipelines[2].handle);
 	if (err != VK_SUCCESS)
 		Sys_Error ("vkCreateGraphicsPipelines failed (md5_blend_pipeline)");
 	GL_SetObjectName ((uint64_t)vulkan_globals.md5_pipelines[2].handle, VK_OBJECT_TYPE_PIPELINE, "md5_blend");
 	vulkan_globals.md5_pipelines[2].layout = vulkan_globals.md5_pipelines[0].layout;
 
-	infos.shader_stages[1].module = alias_alphatest_frag_module;
+	infos.shader_stages[1].module = alias_frag_module;
+	infos.shader_stages[1].pSpecializationInfo = &alpha_test_specialization_info;
 
 	assert (vulkan_globals.md5_pipelines[3].handle == VK_NULL_HANDLE);
-	err = vkCreateGraphicsPipelines (vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.md5_pipelines[3].handle);
+	err = vkCreateGraphicsPipelines (
+		vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.md5_pipelines[3].handle);
 	if (err != VK_SUCCESS)
 		Sys_Error ("vkCreateGraphicsPipelines failed");
 	GL_SetObjectName ((uint64_t)vulkan_globals.md5_pipelines[3].handle, VK_OBJECT_TYPE_PIPELINE, "md5_alphatest_blend");
@@ -3212,11 +3749,13 @@ static void R_CreateMD5Pipelines ()
 
 		infos.shader_stages[0].module = md5_vert_module;
 		infos.shader_stages[1].module = showtris_frag_module;
+		infos.shader_stages[1].pSpecializationInfo = NULL;
 
 		infos.graphics_pipeline.layout = vulkan_globals.md5_pipelines[0].layout.handle;
 
 		assert (vulkan_globals.md5_pipelines[4].handle == VK_NULL_HANDLE);
-		err = vkCreateGraphicsPipelines (vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.md5_pipelines[4].handle);
+		err = vkCreateGraphicsPipelines (
+			vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.md5_pipelines[4].handle);
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkCreateGraphicsPipelines failed");
 		GL_SetObjectName ((uint64_t)vulkan_globals.md5_pipelines[4].handle, VK_OBJECT_TYPE_PIPELINE, "md5_showtris");
@@ -3228,7 +3767,8 @@ static void R_CreateMD5Pipelines ()
 		infos.rasterization_state.depthBiasSlopeFactor = 0.0f;
 
 		assert (vulkan_globals.md5_pipelines[5].handle == VK_NULL_HANDLE);
-		err = vkCreateGraphicsPipelines (vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.md5_pipelines[5].handle);
+		err = vkCreateGraphicsPipelines (
+			vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.md5_pipelines[5].handle);
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkCreateGraphicsPipelines failed");
 		GL_SetObjectName ((uint64_t)vulkan_globals.md5_pipelines[5].handle, VK_OBJECT_TYPE_PIPELINE, "md5_showtris_depth_test");
@@ -3268,10 +3808,21 @@ static void R_CreatePostprocessPipelines ()
 	infos.graphics_pipeline.subpass = 0;
 
 	assert (vulkan_globals.postprocess_pipeline.handle == VK_NULL_HANDLE);
-	err = vkCreateGraphicsPipelines (vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.postprocess_pipeline.handle);
+	err = vkCreateGraphicsPipelines (
+		vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.postprocess_pipeline.handle);
 	if (err != VK_SUCCESS)
 		Sys_Error ("vkCreateGraphicsPipelines failed (postprocess_pipeline)");
 	GL_SetObjectName ((uint64_t)vulkan_globals.postprocess_pipeline.handle, VK_OBJECT_TYPE_PIPELINE, "postprocess");
+
+	infos.shader_stages[1].module = postprocess_fused_frag_module;
+	infos.graphics_pipeline.layout = vulkan_globals.postprocess_fused_pipeline.layout.handle;
+
+	assert (vulkan_globals.postprocess_fused_pipeline.handle == VK_NULL_HANDLE);
+	err = vkCreateGraphicsPipelines (
+		vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.graphics_pipeline, NULL, &vulkan_globals.postprocess_fused_pipeline.handle);
+	if (err != VK_SUCCESS)
+		Sys_Error ("vkCreateGraphicsPipelines failed (postprocess_fused_pipeline)");
+	GL_SetObjectName ((uint64_t)vulkan_globals.postprocess_fused_pipeline.handle, VK_OBJECT_TYPE_PIPELINE, "postprocess_fused");
 }
 
 /*
@@ -3298,7 +3849,8 @@ static void R_CreateScreenEffectsPipelines ()
 	infos.compute_pipeline.layout = vulkan_globals.screen_effects_pipeline.layout.handle;
 
 	assert (vulkan_globals.screen_effects_pipeline.handle == VK_NULL_HANDLE);
-	err = vkCreateComputePipelines (vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.compute_pipeline, NULL, &vulkan_globals.screen_effects_pipeline.handle);
+	err = vkCreateComputePipelines (
+		vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.compute_pipeline, NULL, &vulkan_globals.screen_effects_pipeline.handle);
 	if (err != VK_SUCCESS)
 		Sys_Error ("vkCreateComputePipelines failed (screen_effects_pipeline)");
 	GL_SetObjectName ((uint64_t)vulkan_globals.screen_effects_pipeline.handle, VK_OBJECT_TYPE_PIPELINE, "screen_effects");
@@ -3308,7 +3860,7 @@ static void R_CreateScreenEffectsPipelines ()
 	infos.compute_pipeline.stage = compute_shader_stage;
 	assert (vulkan_globals.screen_effects_scale_pipeline.handle == VK_NULL_HANDLE);
 	err = vkCreateComputePipelines (
-		vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.compute_pipeline, NULL, &vulkan_globals.screen_effects_scale_pipeline.handle);
+		vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.compute_pipeline, NULL, &vulkan_globals.screen_effects_scale_pipeline.handle);
 	if (err != VK_SUCCESS)
 		Sys_Error ("vkCreateComputePipelines failed (screen_effects_scale_pipeline)");
 	GL_SetObjectName ((uint64_t)vulkan_globals.screen_effects_scale_pipeline.handle, VK_OBJECT_TYPE_PIPELINE, "screen_effects_scale");
@@ -3322,7 +3874,7 @@ static void R_CreateScreenEffectsPipelines ()
 		infos.compute_pipeline.stage = compute_shader_stage;
 		assert (vulkan_globals.screen_effects_scale_sops_pipeline.handle == VK_NULL_HANDLE);
 		err = vkCreateComputePipelines (
-			vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.compute_pipeline, NULL, &vulkan_globals.screen_effects_scale_sops_pipeline.handle);
+			vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.compute_pipeline, NULL, &vulkan_globals.screen_effects_scale_sops_pipeline.handle);
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkCreateComputePipelines failed (screen_effects_scale_sops_pipeline)");
 		GL_SetObjectName ((uint64_t)vulkan_globals.screen_effects_scale_sops_pipeline.handle, VK_OBJECT_TYPE_PIPELINE, "screen_effects_scale_sops");
@@ -3366,7 +3918,8 @@ static void R_CreateUpdateLightmapPipelines ()
 	infos.compute_pipeline.layout = vulkan_globals.update_lightmap_pipeline.layout.handle;
 
 	assert (vulkan_globals.update_lightmap_pipeline.handle == VK_NULL_HANDLE);
-	err = vkCreateComputePipelines (vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.compute_pipeline, NULL, &vulkan_globals.update_lightmap_pipeline.handle);
+	err = vkCreateComputePipelines (
+		vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.compute_pipeline, NULL, &vulkan_globals.update_lightmap_pipeline.handle);
 	if (err != VK_SUCCESS)
 		Sys_Error ("vkCreateComputePipelines failed (update_lightmap_pipeline)");
 	GL_SetObjectName ((uint64_t)vulkan_globals.update_lightmap_pipeline.handle, VK_OBJECT_TYPE_PIPELINE, "update_lightmap");
@@ -3379,11 +3932,23 @@ static void R_CreateUpdateLightmapPipelines ()
 		infos.compute_pipeline.layout = vulkan_globals.update_lightmap_rt_pipeline.layout.handle;
 		assert (vulkan_globals.update_lightmap_rt_pipeline.handle == VK_NULL_HANDLE);
 		err = vkCreateComputePipelines (
-			vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.compute_pipeline, NULL, &vulkan_globals.update_lightmap_rt_pipeline.handle);
+			vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.compute_pipeline, NULL, &vulkan_globals.update_lightmap_rt_pipeline.handle);
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkCreateComputePipelines failed (update_lightmap_rt_pipeline)");
 		GL_SetObjectName ((uint64_t)vulkan_globals.update_lightmap_rt_pipeline.handle, VK_OBJECT_TYPE_PIPELINE, "update_lightmap_rt");
 	}
+
+	compute_shader_stage.module = dlight_clusters_comp_module;
+	compute_shader_stage.pSpecializationInfo = NULL;
+	infos.compute_pipeline.stage = compute_shader_stage;
+	infos.compute_pipeline.layout = vulkan_globals.dlight_clusters_pipeline.layout.handle;
+
+	assert (vulkan_globals.dlight_clusters_pipeline.handle == VK_NULL_HANDLE);
+	err = vkCreateComputePipelines (
+		vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.compute_pipeline, NULL, &vulkan_globals.dlight_clusters_pipeline.handle);
+	if (err != VK_SUCCESS)
+		Sys_Error ("vkCreateComputePipelines failed (dlight_clusters_pipeline)");
+	GL_SetObjectName ((uint64_t)vulkan_globals.dlight_clusters_pipeline.handle, VK_OBJECT_TYPE_PIPELINE, "dlight_clusters");
 }
 
 /*
@@ -3409,7 +3974,8 @@ static void R_CreateIndirectComputePipelines ()
 	infos.compute_pipeline.layout = vulkan_globals.indirect_draw_pipeline.layout.handle;
 
 	assert (vulkan_globals.indirect_draw_pipeline.handle == VK_NULL_HANDLE);
-	err = vkCreateComputePipelines (vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.compute_pipeline, NULL, &vulkan_globals.indirect_draw_pipeline.handle);
+	err = vkCreateComputePipelines (
+		vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.compute_pipeline, NULL, &vulkan_globals.indirect_draw_pipeline.handle);
 	if (err != VK_SUCCESS)
 		Sys_Error ("vkCreateComputePipelines failed (indirect_draw_pipeline)");
 	GL_SetObjectName ((uint64_t)vulkan_globals.indirect_draw_pipeline.handle, VK_OBJECT_TYPE_PIPELINE, "indirect_draw");
@@ -3418,10 +3984,58 @@ static void R_CreateIndirectComputePipelines ()
 	infos.compute_pipeline.stage = compute_shader_stage;
 
 	assert (vulkan_globals.indirect_clear_pipeline.handle == VK_NULL_HANDLE);
-	err = vkCreateComputePipelines (vulkan_globals.device, VK_NULL_HANDLE, 1, &infos.compute_pipeline, NULL, &vulkan_globals.indirect_clear_pipeline.handle);
+	err = vkCreateComputePipelines (
+		vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.compute_pipeline, NULL, &vulkan_globals.indirect_clear_pipeline.handle);
 	if (err != VK_SUCCESS)
 		Sys_Error ("vkCreateComputePipelines failed (indirect_clear_pipeline)");
 	GL_SetObjectName ((uint64_t)vulkan_globals.indirect_clear_pipeline.handle, VK_OBJECT_TYPE_PIPELINE, "indirect_clear");
+
+	compute_shader_stage.module = indirect_occlusion_comp_module;
+	infos.compute_pipeline.stage = compute_shader_stage;
+	infos.compute_pipeline.layout = vulkan_globals.indirect_occlusion_pipeline.layout.handle;
+
+	assert (vulkan_globals.indirect_occlusion_pipeline.handle == VK_NULL_HANDLE);
+	err = vkCreateComputePipelines (
+		vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.compute_pipeline, NULL, &vulkan_globals.indirect_occlusion_pipeline.handle);
+	if (err != VK_SUCCESS)
+		Sys_Error ("vkCreateComputePipelines failed (indirect_occlusion_pipeline)");
+	GL_SetObjectName ((uint64_t)vulkan_globals.indirect_occlusion_pipeline.handle, VK_OBJECT_TYPE_PIPELINE, "indirect_occlusion");
+
+	compute_shader_stage.module = mark_leafs_comp_module;
+	infos.compute_pipeline.stage = compute_shader_stage;
+	infos.compute_pipeline.layout = vulkan_globals.mark_leafs_pipeline.layout.handle;
+
+	assert (vulkan_globals.mark_leafs_pipeline.handle == VK_NULL_HANDLE);
+	err = vkCreateComputePipelines (
+		vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.compute_pipeline, NULL, &vulkan_globals.mark_leafs_pipeline.handle);
+	if (err != VK_SUCCESS)
+		Sys_Error ("vkCreateComputePipelines failed (mark_leafs_pipeline)");
+	GL_SetObjectName ((uint64_t)vulkan_globals.mark_leafs_pipeline.handle, VK_OBJECT_TYPE_PIPELINE, "mark_leafs");
+
+	compute_shader_stage.module = depth_pyramid_comp_module;
+	infos.compute_pipeline.stage = compute_shader_stage;
+	infos.compute_pipeline.layout = vulkan_globals.depth_pyramid_pipeline.layout.handle;
+
+	assert (vulkan_globals.depth_pyramid_pipeline.handle == VK_NULL_HANDLE);
+	err = vkCreateComputePipelines (
+		vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.compute_pipeline, NULL, &vulkan_globals.depth_pyramid_pipeline.handle);
+	if (err != VK_SUCCESS)
+		Sys_Error ("vkCreateComputePipelines failed (depth_pyramid_pipeline)");
+	GL_SetObjectName ((uint64_t)vulkan_globals.depth_pyramid_pipeline.handle, VK_OBJECT_TYPE_PIPELINE, "depth_pyramid");
+
+	if (vulkan_globals.shading_rate)
+	{
+		compute_shader_stage.module = shading_rate_comp_module;
+		infos.compute_pipeline.stage = compute_shader_stage;
+		infos.compute_pipeline.layout = vulkan_globals.shading_rate_pipeline.layout.handle;
+
+		assert (vulkan_globals.shading_rate_pipeline.handle == VK_NULL_HANDLE);
+		err = vkCreateComputePipelines (
+			vulkan_globals.device, vulkan_globals.pipeline_cache, 1, &infos.compute_pipeline, NULL, &vulkan_globals.shading_rate_pipeline.handle);
+		if (err != VK_SUCCESS)
+			Sys_Error ("vkCreateComputePipelines failed (shading_rate_pipeline)");
+		GL_SetObjectName ((uint64_t)vulkan_globals.shading_rate_pipeline.handle, VK_OBJECT_TYPE_PIPELINE, "shading_rate");
+	}
 }
 
 /*
@@ -3433,13 +4047,13 @@ static void R_CreateShaderModules ()
 {
 	CREATE_SHADER_MODULE (basic_vert);
 	CREATE_SHADER_MODULE (basic_frag);
-	CREATE_SHADER_MODULE (basic_alphatest_frag);
 	CREATE_SHADER_MODULE (basic_notex_frag);
 	CREATE_SHADER_MODULE (world_vert);
 	CREATE_SHADER_MODULE (world_frag);
+	CREATE_SHADER_MODULE_COND (world_bindless_frag, vulkan_globals.bindless);
 	CREATE_SHADER_MODULE (alias_vert);
+	CREATE_SHADER_MODULE (alias_instanced_vert);
 	CREATE_SHADER_MODULE (alias_frag);
-	CREATE_SHADER_MODULE (alias_alphatest_frag);
 	CREATE_SHADER_MODULE (md5_vert);
 	CREATE_SHADER_MODULE (sky_layer_vert);
 	CREATE_SHADER_MODULE (sky_layer_frag);
@@ -3448,6 +4062,7 @@ static void R_CreateShaderModules ()
 	CREATE_SHADER_MODULE (sky_cube_frag);
 	CREATE_SHADER_MODULE (postprocess_vert);
 	CREATE_SHADER_MODULE (postprocess_frag);
+	CREATE_SHADER_MODULE (postprocess_fused_frag);
 	CREATE_SHADER_MODULE (screen_effects_8bit_comp);
 	CREATE_SHADER_MODULE (screen_effects_8bit_scale_comp);
 	CREATE_SHADER_MODULE_COND (screen_effects_8bit_scale_sops_comp, vulkan_globals.screen_effects_sops);
@@ -3455,14 +4070,20 @@ static void R_CreateShaderModules ()
 	CREATE_SHADER_MODULE (screen_effects_10bit_scale_comp);
 	CREATE_SHADER_MODULE_COND (screen_effects_10bit_scale_sops_comp, vulkan_globals.screen_effects_sops);
 	CREATE_SHADER_MODULE (cs_tex_warp_comp);
+	CREATE_SHADER_MODULE (depth_pyramid_comp);
+	CREATE_SHADER_MODULE_COND (shading_rate_comp, vulkan_globals.shading_rate);
 	CREATE_SHADER_MODULE (indirect_comp);
 	CREATE_SHADER_MODULE (indirect_clear_comp);
+	CREATE_SHADER_MODULE (indirect_occlusion_comp);
+	CREATE_SHADER_MODULE (mark_leafs_comp);
+	CREATE_SHADER_MODULE (update_particles_comp);
 	CREATE_SHADER_MODULE (showtris_vert);
 	CREATE_SHADER_MODULE (showtris_frag);
 	CREATE_SHADER_MODULE (update_lightmap_8bit_comp);
 	CREATE_SHADER_MODULE (update_lightmap_10bit_comp);
 	CREATE_SHADER_MODULE_COND (update_lightmap_8bit_rt_comp, vulkan_globals.ray_query);
 	CREATE_SHADER_MODULE_COND (update_lightmap_10bit_rt_comp, vulkan_globals.ray_query);
+	CREATE_SHADER_MODULE (dlight_clusters_comp);
 #ifdef _DEBUG
 	CREATE_SHADER_MODULE_COND (ray_debug_comp, vulkan_globals.ray_query);
 #endif
@@ -3479,13 +4100,13 @@ static void R_DestroyShaderModules ()
 {
 	DESTROY_SHADER_MODULE (basic_vert);
 	DESTROY_SHADER_MODULE (basic_frag);
-	DESTROY_SHADER_MODULE (basic_alphatest_frag);
 	DESTROY_SHADER_MODULE (basic_notex_frag);
 	DESTROY_SHADER_MODULE (world_vert);
 	DESTROY_SHADER_MODULE (world_frag);
+	DESTROY_SHADER_MODULE (world_bindless_frag);
 	DESTROY_SHADER_MODULE (alias_vert);
+	DESTROY_SHADER_MODULE (alias_instanced_vert);
 	DESTROY_SHADER_MODULE (alias_frag);
-	DESTROY_SHADER_MODULE (alias_alphatest_frag);
 	DESTROY_SHADER_MODULE (md5_vert);
 	DESTROY_SHADER_MODULE (sky_layer_vert);
 	DESTROY_SHADER_MODULE (sky_layer_frag);
@@ -3494,6 +4115,7 @@ static void R_DestroyShaderModules ()
 	DESTROY_SHADER_MODULE (sky_cube_frag);
 	DESTROY_SHADER_MODULE (postprocess_vert);
 	DESTROY_SHADER_MODULE (postprocess_frag);
+	DESTROY_SHADER_MODULE (postprocess_fused_frag);
 	DESTROY_SHADER_MODULE (screen_effects_8bit_comp);
 	DESTROY_SHADER_MODULE (screen_effects_8bit_scale_comp);
 	DESTROY_SHADER_MODULE (screen_effects_8bit_scale_sops_comp);
@@ -3501,19 +4123,193 @@ static void R_DestroyShaderModules ()
 	DESTROY_SHADER_MODULE (screen_effects_10bit_scale_comp);
 	DESTROY_SHADER_MODULE (screen_effects_10bit_scale_sops_comp);
 	DESTROY_SHADER_MODULE (cs_tex_warp_comp);
+	DESTROY_SHADER_MODULE (depth_pyramid_comp);
+	DESTROY_SHADER_MODULE (shading_rate_comp);
 	DESTROY_SHADER_MODULE (indirect_comp);
 	DESTROY_SHADER_MODULE (indirect_clear_comp);
+	DESTROY_SHADER_MODULE (indirect_occlusion_comp);
+	DESTROY_SHADER_MODULE (mark_leafs_comp);
+	DESTROY_SHADER_MODULE (update_particles_comp);
 	DESTROY_SHADER_MODULE (showtris_vert);
 	DESTROY_SHADER_MODULE (showtris_frag);
 	DESTROY_SHADER_MODULE (update_lightmap_8bit_comp);
 	DESTROY_SHADER_MODULE (update_lightmap_8bit_rt_comp);
 	DESTROY_SHADER_MODULE (update_lightmap_10bit_comp);
 	DESTROY_SHADER_MODULE (update_lightmap_10bit_rt_comp);
+	DESTROY_SHADER_MODULE (dlight_clusters_comp);
 	DESTROY_SHADER_MODULE (ray_debug_comp);
 	DESTROY_SHADER_MODULE (mesh_interpolate_comp);
 	DESTROY_SHADER_MODULE (skinning_comp);
 }
 
+#define PIPELINE_CACHE_MAGIC	 0x43504B56 // "VKPC"
+#define PIPELINE_CACHE_VERSION 1
+
+typedef struct
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t vendor_id;
+	uint32_t device_id;
+	uint32_t driver_version;
+	uint8_t	 uuid[VK_UUID_SIZE];
+	uint32_t data_size;
+} pipeline_cache_header_t;
+
+static size_t pipeline_cache_saved_size;
+
+/*
+===============
+R_GetPipelineCachePath
+===============
+*/
+static void R_GetPipelineCachePath (char *path, size_t path_size)
+{
+	const VkPhysicalDeviceProperties *props = &vulkan_globals.device_properties;
+	const char						 *file_name = va ("pipelines_%04x_%04x.cache", props->vendorID, props->deviceID);
+	if (multiuser)
+	{
+		char *pref_path = SDL_GetPrefPath ("", "vkQuake");
+		q_snprintf (path, path_size, "%s%s", pref_path, file_name);
+		SDL_free (pref_path);
+	}
+	else
+		q_snprintf (path, path_size, "%s/%s", host_parms->userdir, file_name);
+}
+
+/*
+===============
+R_InitPipelineCache
+
+Creates the pipeline cache, seeded with the data of a previous run if it was
+written by the same device and driver version.
+===============
+*/
+static void R_InitPipelineCache (void)
+{
+	const VkPhysicalDeviceProperties *props = &vulkan_globals.device_properties;
+	char							  path[MAX_OSPATH];
+	void							 *initial_data = NULL;
+	pipeline_cache_header_t			  header;
+
+	R_GetPipelineCachePath (path, sizeof (path));
+	FILE *f = COM_CheckParm ("-nopipelinecache") ? NULL : fopen (path, "rb");
+	if (f)
+	{
+		if ((fread (&header, sizeof (header), 1, f) == 1) && (header.magic == PIPELINE_CACHE_MAGIC) && (header.version == PIPELINE_CACHE_VERSION) &&
+			(header.vendor_id == props->vendorID) && (header.device_id == props->deviceID) && (header.driver_version == props->driverVersion) &&
+			!memcmp (header.uuid, props->pipelineCacheUUID, VK_UUID_SIZE) && (header.data_size > 0))
+		{
+			initial_data = Mem_Alloc (header.data_size);
+			if (fread (initial_data, header.data_size, 1, f) != 1)
+			{
+				Mem_Free (initial_data);
+				initial_data = NULL;
+			}
+		}
+		fclose (f);
+	}
+
+	ZEROED_STRUCT (VkPipelineCacheCreateInfo, cache_create_info);
+	cache_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	cache_create_info.initialDataSize = initial_data ? header.data_size : 0;
+	cache_create_info.pInitialData = initial_data;
+
+	VkResult err = vkCreatePipelineCache (vulkan_globals.device, &cache_create_info, NULL, &vulkan_globals.pipeline_cache);
+	if ((err != VK_SUCCESS) && initial_data)
+	{
+		// Driver rejected the data, start over with an empty cache
+		cache_create_info.initialDataSize = 0;
+		cache_create_info.pInitialData = NULL;
+		Mem_Free (initial_data);
+		initial_data = NULL;
+		err = vkCreatePipelineCache (vulkan_globals.device, &cache_create_info, NULL, &vulkan_globals.pipeline_cache);
+	}
+	if (err != VK_SUCCESS)
+		Sys_Error ("vkCreatePipelineCache failed");
+
+	pipeline_cache_saved_size = initial_data ? header.data_size : 0;
+	Sys_Printf ("Pipeline cache: %s (%u bytes)\n", initial_data ? "loaded" : "empty", (unsigned int)pipeline_cache_saved_size);
+	Mem_Free (initial_data);
+}
+
+/*
+===============
+R_SavePipelineCache
+===============
+*/
+static void R_SavePipelineCache (void)
+{
+	const VkPhysicalDeviceProperties *props = &vulkan_globals.device_properties;
+	size_t							  data_size = 0;
+
+	if (COM_CheckParm ("-nopipelinecache"))
+		return;
+	if ((vkGetPipelineCacheData (vulkan_globals.device, vulkan_globals.pipeline_cache, &data_size, NULL) != VK_SUCCESS) || (data_size == 0) ||
+		(data_size == pipeline_cache_saved_size))
+		return;
+
+	void *data = Mem_Alloc (data_size);
+	if (vkGetPipelineCacheData (vulkan_globals.device, vulkan_globals.pipeline_cache, &data_size, data) != VK_SUCCESS)
+	{
+		Mem_Free (data);
+		return;
+	}
+
+	pipeline_cache_header_t header;
+	memset (&header, 0, sizeof (header));
+	header.magic = PIPELINE_CACHE_MAGIC;
+	header.version = PIPELINE_CACHE_VERSION;
+	header.vendor_id = props->vendorID;
+	header.device_id = props->deviceID;
+	header.driver_version = props->driverVersion;
+	memcpy (header.uuid, props->pipelineCacheUUID, VK_UUID_SIZE);
+	header.data_size = (uint32_t)data_size;
+
+	char path[MAX_OSPATH];
+	R_GetPipelineCachePath (path, sizeof (path));
+	FILE *f = fopen (path, "wb");
+	if (f)
+	{
+		if ((fwrite (&header, sizeof (header), 1, f) == 1) && (fwrite (data, data_size, 1, f) == 1))
+			pipeline_cache_saved_size = data_size;
+		fclose (f);
+	}
+	else
+		Con_DPrintf ("Couldn't write pipeline cache %s\n", path);
+	Mem_Free (data);
+}
+
+// Heaviest groups (most permutations) first so they start compiling early
+static void (*const pipeline_groups[]) (void) = {
+	R_CreateWorldPipelines,
+	R_CreateAliasPipelines,
+	R_CreateMD5Pipelines,
+	R_CreateFTEParticlesPipelines,
+	R_CreateScreenEffectsPipelines,
+	R_CreateSkyPipelines,
+	R_CreateShowTrisPipelines,
+	R_CreateUpdateLightmapPipelines,
+	R_CreateIndirectComputePipelines,
+	R_CreateBasicPipelines,
+	R_CreateWarpPipelines,
+	R_CreateParticlesPipelines,
+	R_CreateSpritesPipelines,
+	R_CreatePostprocessPipelines,
+	R_CreateRayDebugPipelines,
+	R_CreateAnimComputePipelines,
+};
+
+/*
+===============
+R_CreatePipelineGroupTask
+===============
+*/
+static void R_CreatePipelineGroupTask (int index, void *unused)
+{
+	pipeline_groups[index] ();
+}
+
 /*
 ===============
 R_CreatePipelines
@@ -3523,27 +4319,19 @@ void R_CreatePipelines ()
 {
 	Sys_Printf ("Creating pipelines\n");
 
+	if (vulkan_globals.pipeline_cache == VK_NULL_HANDLE)
+		R_InitPipelineCache ();
+
 	R_CreateShaderModules ();
 	R_InitVertexAttributes ();
 
-	R_CreateBasicPipelines ();
-	R_CreateWarpPipelines ();
-	R_CreateParticlesPipelines ();
-	R_CreateFTEParticlesPipelines ();
-	R_CreateSpritesPipelines ();
-	R_CreateSkyPipelines ();
-	R_CreateShowTrisPipelines ();
-	R_CreateWorldPipelines ();
-	R_CreateAliasPipelines ();
-	R_CreateMD5Pipelines ();
-	R_CreatePostprocessPipelines ();
-	R_CreateScreenEffectsPipelines ();
-	R_CreateUpdateLightmapPipelines ();
-	R_CreateIndirectComputePipelines ();
-	R_CreateRayDebugPipelines ();
-	R_CreateAnimComputePipelines ();
+	// Every group only writes its own pipelines, so they can be created concurrently
+	task_handle_t create_task = Task_AllocateAssignIndexedFuncAndSubmit (R_CreatePipelineGroupTask, countof (pipeline_groups), NULL, 0);
+	Task_Join (create_task, TASK_TIMEOUT_INFINITE);
 
 	R_DestroyShaderModules ();
+
+	R_SavePipelineCache ();
 }
 
 /*
@@ -3567,11 +4355,18 @@ void R_DestroyPipelines (void)
 	{
 		vkDestroyPipeline (vulkan_globals.device, vulkan_globals.world_pipelines[i].handle, NULL);
 		vulkan_globals.world_pipelines[i].handle = VK_NULL_HANDLE;
+		if (vulkan_globals.world_bindless_pipelines[i].handle != VK_NULL_HANDLE)
+		{
+			vkDestroyPipeline (vulkan_globals.device, vulkan_globals.world_bindless_pipelines[i].handle, NULL);
+			vulkan_globals.world_bindless_pipelines[i].handle = VK_NULL_HANDLE;
+		}
 	}
 	vkDestroyPipeline (vulkan_globals.device, vulkan_globals.raster_tex_warp_pipeline.handle, NULL);
 	vulkan_globals.raster_tex_warp_pipeline.handle = VK_NULL_HANDLE;
 	vkDestroyPipeline (vulkan_globals.device, vulkan_globals.particle_pipeline.handle, NULL);
 	vulkan_globals.particle_pipeline.handle = VK_NULL_HANDLE;
+	vkDestroyPipeline (vulkan_globals.device, vulkan_globals.update_particles_pipeline.handle, NULL);
+	vulkan_globals.update_particles_pipeline.handle = VK_NULL_HANDLE;
 #ifdef PSET_SCRIPT
 	for (i = 0; i < 8; ++i)
 	{
@@ -3613,8 +4408,15 @@ void R_DestroyPipelines (void)
 			vulkan_globals.md5_pipelines[i].handle = VK_NULL_HANDLE;
 		}
 	}
+	for (i = 0; i < 2; ++i)
+	{
+		vkDestroyPipeline (vulkan_globals.device, vulkan_globals.alias_instanced_pipelines[i].handle, NULL);
+		vulkan_globals.alias_instanced_pipelines[i].handle = VK_NULL_HANDLE;
+	}
 	vkDestroyPipeline (vulkan_globals.device, vulkan_globals.postprocess_pipeline.handle, NULL);
 	vulkan_globals.postprocess_pipeline.handle = VK_NULL_HANDLE;
+	vkDestroyPipeline (vulkan_globals.device, vulkan_globals.postprocess_fused_pipeline.handle, NULL);
+	vulkan_globals.postprocess_fused_pipeline.handle = VK_NULL_HANDLE;
 	vkDestroyPipeline (vulkan_globals.device, vulkan_globals.screen_effects_pipeline.handle, NULL);
 	vulkan_globals.screen_effects_pipeline.handle = VK_NULL_HANDLE;
 	vkDestroyPipeline (vulkan_globals.device, vulkan_globals.screen_effects_scale_pipeline.handle, NULL);
@@ -3641,6 +4443,8 @@ void R_DestroyPipelines (void)
 	}
 	vkDestroyPipeline (vulkan_globals.device, vulkan_globals.update_lightmap_pipeline.handle, NULL);
 	vulkan_globals.update_lightmap_pipeline.handle = VK_NULL_HANDLE;
+	vkDestroyPipeline (vulkan_globals.device, vulkan_globals.dlight_clusters_pipeline.handle, NULL);
+	vulkan_globals.dlight_clusters_pipeline.handle = VK_NULL_HANDLE;
 	if (vulkan_globals.update_lightmap_rt_pipeline.handle != VK_NULL_HANDLE)
 	{
 		vkDestroyPipeline (vulkan_globals.device, vulkan_globals.update_lightmap_rt_pipeline.handle, NULL);
@@ -3665,6 +4469,14 @@ void R_DestroyPipelines (void)
 	vulkan_globals.indirect_draw_pipeline.handle = VK_NULL_HANDLE;
 	vkDestroyPipeline (vulkan_globals.device, vulkan_globals.indirect_clear_pipeline.handle, NULL);
 	vulkan_globals.indirect_clear_pipeline.handle = VK_NULL_HANDLE;
+	vkDestroyPipeline (vulkan_globals.device, vulkan_globals.indirect_occlusion_pipeline.handle, NULL);
+	vulkan_globals.indirect_occlusion_pipeline.handle = VK_NULL_HANDLE;
+	vkDestroyPipeline (vulkan_globals.device, vulkan_globals.mark_leafs_pipeline.handle, NULL);
+	vulkan_globals.mark_leafs_pipeline.handle = VK_NULL_HANDLE;
+	vkDestroyPipeline (vulkan_globals.device, vulkan_globals.depth_pyramid_pipeline.handle, NULL);
+	vulkan_globals.depth_pyramid_pipeline.handle = VK_NULL_HANDLE;
+	vkDestroyPipeline (vulkan_globals.device, vulkan_globals.shading_rate_pipeline.handle, NULL);
+	vulkan_globals.shading_rate_pipeline.handle = VK_NULL_HANDLE;
 }
 
 /*
@@ -3739,6 +4551,8 @@ void R_Init (void)
 	Cvar_RegisterVariable (&r_telealpha);
 	Cvar_RegisterVariable (&r_slimealpha);
 	Cvar_RegisterVariable (&r_scale);
+	Cvar_RegisterVariable (&r_dynamicres);
+	Cvar_RegisterVariable (&r_dynamicres_min);
 	Cvar_RegisterVariable (&r_lodbias);
 	Cvar_RegisterVariable (&gl_lodbias);
 	Cvar_SetCallback (&r_scale, R_ScaleChanged_f);
@@ -3749,11 +4563,17 @@ void R_Init (void)
 	Cvar_SetCallback (&r_slimealpha, R_SetSlimealpha_f);
 
 	Cvar_RegisterVariable (&r_gpulightmapupdate);
+	Cvar_RegisterVariable (&r_clustereddlights);
 	Cvar_RegisterVariable (&r_rtshadows);
 	Cvar_SetCallback (&r_rtshadows, R_SetRTShadows_f);
 	Cvar_RegisterVariable (&r_indirect);
 	Cvar_RegisterVariable (&r_tasks);
+	Cvar_RegisterVariable (&r_aliasinstancing);
+	Cvar_RegisterVariable (&r_aliaslod);
+	Cvar_RegisterVariable (&r_bindless);
 	Cvar_RegisterVariable (&r_parallelmark);
+	Cvar_RegisterVariable (&r_gpumark);
+	Cvar_RegisterVariable (&r_worldviewcache);
 	Cvar_RegisterVariable (&r_usesops);
 
 	Cvar_RegisterVariable (&r_drawwater_fast);
@@ -3765,6 +4585,7 @@ void R_Init (void)
 	Fog_Init (); // johnfitz
 
 	R_AllocateLightmapComputeBuffers ();
+	R_InitDlightClusters ();
 
 	staging_mutex = SDL_CreateMutex ();
 }
@@ -3969,11 +4790,11 @@ void R_NewMap (void)
 		d_lightstylevalue[i] = 264; // normal light value
 
 	// clear out efrags in case the level hasn't been reloaded
-	// FIXME: is this one short?
-	for (i = 0; i < cl.worldmodel->numleafs; i++)
-		cl.worldmodel->leafs[i].efrags = NULL;
+	for (i = 0; i <= cl.worldmodel->numleafs; i++)
+		cl.worldmodel->leafs[i].numefrags = 0;
 
 	r_viewleaf = NULL;
+	R_ClearWorldViewCache ();
 	R_ClearParticles ();
 #ifdef PSET_SCRIPT
 	PScript_ClearParticles (true);
@@ -4034,6 +4855,26 @@ void R_TimeRefresh_f (void)
 	Con_Printf ("%f seconds (%f fps)\n", time, 128 / time);
 }
 
+/*
+====================
+R_VulkanMemoryCategory
+
+Maps the allocation counter passed by the owner of the memory to its category
+====================
+*/
+static vulkan_memory_category_t R_VulkanMemoryCategory (atomic_uint32_t *num_allocations)
+{
+	if (num_allocations == &num_vulkan_tex_allocations)
+		return VULKAN_MEMORY_CATEGORY_TEXTURES;
+	if (num_allocations == &num_vulkan_bmodel_allocations)
+		return VULKAN_MEMORY_CATEGORY_BMODEL;
+	if (num_allocations == &num_vulkan_mesh_allocations)
+		return VULKAN_MEMORY_CATEGORY_MESH;
+	if (num_allocations == &num_vulkan_dynbuf_allocations)
+		return VULKAN_MEMORY_CATEGORY_DYNAMIC;
+	return VULKAN_MEMORY_CATEGORY_MISC;
+}
+
 /*
 ====================
 R_AllocateVulkanMemory
@@ -4055,6 +4896,8 @@ void R_AllocateVulkanMemory (vulkan_memory_t *memory, VkMemoryAllocateInfo *memo
 		Atomic_AddUInt64 (&total_device_vulkan_allocation_size, memory->size);
 	else if (memory->type == VULKAN_MEMORY_TYPE_HOST)
 		Atomic_AddUInt64 (&total_host_vulkan_allocation_size, memory->size);
+	if (memory->type != VULKAN_MEMORY_TYPE_NONE)
+		Atomic_AddUInt64 (&vulkan_memory_category_sizes[R_VulkanMemoryCategory (num_allocations)], memory->size);
 }
 
 /*
@@ -4073,12 +4916,80 @@ void R_FreeVulkanMemory (vulkan_memory_t *memory, atomic_uint32_t *num_allocatio
 		vkFreeMemory (vulkan_globals.device, memory->handle, NULL);
 		if (num_allocations)
 			Atomic_DecrementUInt32 (num_allocations);
+		Atomic_SubUInt64 (&vulkan_memory_category_sizes[R_VulkanMemoryCategory (num_allocations)], memory->size);
 	}
 	memory->handle = VK_NULL_HANDLE;
 	memory->size = 0;
 	memory->type = VULKAN_MEMORY_TYPE_NONE;
 }
 
+/*
+====================
+R_UpdateMemoryBudget
+
+Sums usage and budget of the device local and host heaps. Called once per frame on the main thread,
+without VK_EXT_memory_budget the usage is estimated from our own allocations.
+====================
+*/
+void R_UpdateMemoryBudget (void)
+{
+	VkDeviceSize heap_usage[VK_MAX_MEMORY_HEAPS];
+	VkDeviceSize heap_budget[VK_MAX_MEMORY_HEAPS];
+
+#ifdef USE_RMLUI
+	Atomic_StoreUInt64 (&vulkan_memory_category_sizes[VULKAN_MEMORY_CATEGORY_UI], UI_GetVulkanMemoryUsage ());
+#endif
+
+	ZEROED_STRUCT (vulkan_memory_budget_t, budget);
+	budget.from_driver = GL_QueryMemoryBudget (heap_usage, heap_budget);
+	for (uint32_t i = 0; i < vulkan_globals.memory_properties.memoryHeapCount; i++)
+	{
+		const VkMemoryHeap *heap = &vulkan_globals.memory_properties.memoryHeaps[i];
+		const qboolean		device_local = (heap->flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+		if (!budget.from_driver)
+			heap_budget[i] = heap->size * MEMORY_BUDGET_FALLBACK_PERCENT / 100;
+		if (device_local)
+		{
+			budget.device_usage += budget.from_driver ? heap_usage[i] : 0;
+			budget.device_budget += heap_budget[i];
+		}
+		else
+		{
+			budget.host_usage += budget.from_driver ? heap_usage[i] : 0;
+			budget.host_budget += heap_budget[i];
+		}
+	}
+	if (!budget.from_driver)
+	{
+		budget.device_usage = Atomic_LoadUInt64 (&total_device_vulkan_allocation_size) +
+							  Atomic_LoadUInt64 (&vulkan_memory_category_sizes[VULKAN_MEMORY_CATEGORY_UI]);
+		budget.host_usage = Atomic_LoadUInt64 (&total_host_vulkan_allocation_size);
+	}
+	memory_budget = budget;
+}
+
+/*
+====================
+R_GetMemoryBudget
+====================
+*/
+const vulkan_memory_budget_t *R_GetMemoryBudget (void)
+{
+	return &memory_budget;
+}
+
+/*
+====================
+R_MemoryBudgetExceeded
+
+True while device memory usage is close enough to the budget that optional allocations should be given back
+====================
+*/
+qboolean R_MemoryBudgetExceeded (void)
+{
+	return memory_budget.device_budget && (memory_budget.device_usage > (memory_budget.device_budget * MEMORY_BUDGET_PRESSURE_PERCENT / 100));
+}
+
 /*
 ====================
 R_CreateBuffer
@@ -4099,6 +5010,7 @@ void R_CreateBuffer (
 	buffer_create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
 	buffer_create_info.size = size;
 	buffer_create_info.usage = usage;
+	SHARE_WITH_ASYNC_COMPUTE (buffer_create_info);
 	err = vkCreateBuffer (vulkan_globals.device, &buffer_create_info, NULL, buffer);
 	if (err != VK_SUCCESS)
 		Sys_Error ("vkCreateBuffer failed");
@@ -4186,6 +5098,7 @@ size_t R_CreateBuffers (
 		buffer_create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
 		buffer_create_info.size = create_infos[i].size;
 		buffer_create_info.usage = create_infos[i].usage;
+		SHARE_WITH_ASYNC_COMPUTE (buffer_create_info);
 		err = vkCreateBuffer (vulkan_globals.device, &buffer_create_info, NULL, create_infos[i].buffer);
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkCreateBuffer failed");
@@ -4310,10 +5223,15 @@ static void R_PrintHeapStats (const char *name, glheapstats_t *stats)
 		"  pages free: %" SDL_PRIu32 "\n"
 		"  bytes allocated: %" SDL_PRIu64 "\n"
 		"  bytes free: %" SDL_PRIu64 "\n"
-		"  bytes wasted: %" SDL_PRIu64 " (%.3g%%)\n",
+		"  bytes wasted: %" SDL_PRIu64 " (%.3g%%)\n"
+		"  largest free block: %" SDL_PRIu32 " pages (%.3g%% of free pages)\n"
+		"  sparse segments: %" SDL_PRIu32 "%s\n"
+		"  segments released: %" SDL_PRIu32 "\n",
 		name, stats->num_segments, stats->num_allocations, stats->num_small_allocations, stats->num_block_allocations, stats->num_dedicated_allocations,
 		stats->num_blocks_used, stats->num_blocks_free, stats->num_pages_allocated, stats->num_pages_free, stats->num_bytes_allocated, stats->num_bytes_free,
-		stats->num_bytes_wasted, ((double)stats->num_bytes_wasted / (double)stats->num_bytes_allocated) * 100.0f);
+		stats->num_bytes_wasted, ((double)stats->num_bytes_wasted / (double)stats->num_bytes_allocated) * 100.0f, stats->largest_free_block_pages,
+		stats->num_pages_free ? ((double)stats->largest_free_block_pages / (double)stats->num_pages_free) * 100.0f : 100.0f, stats->num_segments_sparse,
+		stats->defragmenting ? " (defragmenting)" : "", stats->num_segments_released);
 }
 
 /*
@@ -4338,9 +5256,22 @@ void R_VulkanMemStats_f (void)
 	Con_Printf (" Misc:   %" SDL_PRIu32 "\n", num_misc_allocations);
 	Con_Printf (" DynBuf: %" SDL_PRIu32 "\n", num_dynbuf_allocations);
 
+	Con_Printf ("Dynamic buffers:\n");
+	for (int i = 0; i < NUM_DYNBUF_TYPES; ++i)
+		Con_Printf (" %s: %d blocks, peak %u KB\n", dyn_buffers[i].name, dyn_buffers[i].num_blocks, (dyn_buffers[i].peak_size + 1023) / 1024);
+
 	Con_Printf ("Heaps:\n");
 	R_PrintHeapStats ("Tex", TexMgr_GetHeapStats ());
 	R_PrintHeapStats ("Mesh", R_GetMeshHeapStats ());
+#ifdef USE_RMLUI
+	ui_pool_stats_t ui_pools[2];
+	UI_GetPoolStats (&ui_pools[0], &ui_pools[1]);
+	for (int i = 0; i < 2; ++i)
+		Con_Printf (
+			" UI %s: %u chunks, %u allocations, %llu / %llu KB used, %u free blocks, largest %llu KB\n", (i == 0) ? "geometry" : "images",
+			ui_pools[i].num_chunks, ui_pools[i].num_allocations, ui_pools[i].used_bytes / 1024, ui_pools[i].capacity / 1024, ui_pools[i].num_free_blocks,
+			ui_pools[i].largest_free_block / 1024);
+#endif
 
 	Con_Printf ("Descriptors:\n");
 	Con_Printf (" Combined image samplers: %" SDL_PRIu32 "\n", Atomic_LoadUInt32 (&num_vulkan_combined_image_samplers));
@@ -4353,4 +5284,19 @@ void R_VulkanMemStats_f (void)
 	Con_Printf (" Acceleration structures: %" SDL_PRIu32 "\n", Atomic_LoadUInt32 (&num_acceleration_structures));
 	Con_Printf ("Device %" SDL_PRIu64 " MiB total\n", Atomic_LoadUInt64 (&total_device_vulkan_allocation_size) / 1024 / 1024);
 	Con_Printf ("Host %" SDL_PRIu64 " MiB total\n", Atomic_LoadUInt64 (&total_host_vulkan_allocation_size) / 1024 / 1024);
+
+	static const char *category_names[VULKAN_MEMORY_CATEGORY_COUNT] = {
+		" Textures:", "  Lightmaps:", " BModel:", " Mesh:", "  Acceleration structures:", " Dynamic buffers:", " Misc:", " UI:",
+	};
+	Con_Printf ("Memory by category:\n");
+	for (int i = 0; i < VULKAN_MEMORY_CATEGORY_COUNT; i++)
+		Con_Printf ("%s %" SDL_PRIu64 " KiB\n", category_names[i], Atomic_LoadUInt64 (&vulkan_memory_category_sizes[i]) / 1024);
+
+	R_UpdateMemoryBudget ();
+	const vulkan_memory_budget_t *budget = R_GetMemoryBudget ();
+	Con_Printf ("Budget%s:\n", budget->from_driver ? "" : " (estimated, no VK_EXT_memory_budget)");
+	Con_Printf (
+		" Device %" SDL_PRIu64 " / %" SDL_PRIu64 " MiB%s\n", (uint64_t)budget->device_usage / 1024 / 1024, (uint64_t)budget->device_budget / 1024 / 1024,
+		R_MemoryBudgetExceeded () ? " (over budget)" : "");
+	Con_Printf (" Host %" SDL_PRIu64 " / %" SDL_PRIu64 " MiB\n", (uint64_t)budget->host_usage / 1024 / 1024, (uint64_t)budget->host_budget / 1024 / 1024);
 }
@@ -103,6 +103,8 @@ cvar_t scr_fontscale = {"scr_fontscale", "1", CVAR_ARCHIVE};
 cvar_t scr_dpiscale = {"scr_dpiscale", "1", CVAR_ROM};
 #ifdef USE_RMLUI
 cvar_t ui_speeds = {"ui_speeds", "0", CVAR_NONE};
+cvar_t ui_speeds_spike = {"ui_speeds_spike", "0", CVAR_NONE}; // ms, dump the breakdown of UI frames slower than this
+cvar_t ui_retain = {"ui_retain", "1", CVAR_ARCHIVE}; // replay unchanged frames of documents with a "retain" body attribute
 #endif
 
 cvar_t scr_viewsize = {"viewsize", "100", CVAR_ARCHIVE};
@@ -117,6 +119,7 @@ cvar_t scr_centertime = {"scr_centertime", "2", CVAR_NONE};
 cvar_t scr_showturtle = {"showturtle", "0", CVAR_NONE};
 cvar_t scr_showpause = {"showpause", "1", CVAR_NONE};
 cvar_t scr_printspeed = {"scr_printspeed", "8", CVAR_NONE};
+cvar_t scr_loadtimes = {"scr_loadtimes", "0", CVAR_NONE}; // print how long each phase of loading a map took
 
 cvar_t cl_gun_fovscale = {"cl_gun_fovscale", "1", CVAR_ARCHIVE}; // Qrack
 
@@ -150,7 +153,40 @@ qboolean	   in_update_screen;
 extern jmp_buf screen_error;
 SDL_Mutex	  *draw_qcvm_mutex;
 
+static qboolean	     pipeline_frame;								// SCR_UpdateScreenPipelined is submitting
+static task_handle_t pipeline_draw_done_task = INVALID_TASK_HANDLE; // drawing the main thread hasn't waited for yet
+
+#define MAX_LOADING_PHASES	   8
+#define LOADING_FRAME_INTERVAL 0.05 // seconds between the frames presented while a map loads
+
+typedef struct
+{
+	const char *name;
+	double		seconds;
+} loading_phase_t;
+
+// Map loading, timed phase by phase and shown by SCR_LoadingProgress
+static struct
+{
+	const char	   *phase; // NULL outside of a phase
+	double			phase_start;
+	int				done;
+	int				total; // 0 when the phase doesn't know how much it has to do
+	double			last_frame;
+	loading_phase_t phases[MAX_LOADING_PHASES];
+	int				num_phases;
+} scr_loading;
+static qboolean scr_loading_frame; // SCR_UpdateScreen draws the loading screen and no world
+
+#ifdef USE_RMLUI
+// read by the draw tasks instead of the UI, which only the RmlUI task touches while they run
+static qboolean scr_ui_startup_pending;
+static float	scr_ui_blackout_alpha;
+#endif
+
 void SCR_ScreenShot_f (void);
+void SCR_CaptureStart_f (void);
+void SCR_CaptureStop_f (void);
 
 /*
 ===============================================================================
@@ -639,12 +675,15 @@ void SCR_Init (void)
 	Cvar_RegisterVariable (&scr_showpause);
 	Cvar_RegisterVariable (&scr_centertime);
 	Cvar_RegisterVariable (&scr_printspeed);
+	Cvar_RegisterVariable (&scr_loadtimes);
 	Cvar_RegisterVariable (&scr_style);
 	Cvar_RegisterVariable (&scr_uiscale);
 	Cvar_RegisterVariable (&scr_fontscale);
 	Cvar_RegisterVariable (&scr_dpiscale);
 #ifdef USE_RMLUI
 	Cvar_RegisterVariable (&ui_speeds);
+	Cvar_RegisterVariable (&ui_speeds_spike);
+	Cvar_RegisterVariable (&ui_retain);
 #endif
 	Cvar_RegisterVariable (&cl_gun_fovscale);
 
@@ -668,6 +707,8 @@ void SCR_Init (void)
 	}
 
 	Cmd_AddCommand ("screenshot", SCR_ScreenShot_f);
+	Cmd_AddCommand ("capture_start", SCR_CaptureStart_f);
+	Cmd_AddCommand ("capture_stop", SCR_CaptureStop_f);
 	Cmd_AddCommand ("sizeup", SCR_SizeUp_f);
 	Cmd_AddCommand ("sizedown", SCR_SizeDown_f);
 
@@ -716,9 +757,13 @@ static void SCR_DrawFPS (cb_context_t *cbx)
 
 	if (scr_showfps.value && scr_viewsize.value < 130)
 	{
-		char st[16];
-		int	 x, y;
-		q_snprintf (st, sizeof (st), "%4.0f fps", lastfps);
+		char		 st[32];
+		int			 x, y;
+		const double latency = GL_GetInputLatency ();
+		if (latency > 0.0)
+			q_snprintf (st, sizeof (st), "%4.1f ms %4.0f fps", latency, lastfps);
+		else
+			q_snprintf (st, sizeof (st), "%4.0f fps", lastfps);
 		x = 320 - (strlen (st) << 3);
 		y = 200 - CHARACTER_SIZE;
 		GL_SetCanvas (cbx, CANVAS_BOTTOMRIGHT);
@@ -784,6 +829,16 @@ static void SCR_DrawClock (cb_context_t *cbx)
 	}
 }
 
+/*
+==============
+SCR_MemoryCategoryMB
+==============
+*/
+static int SCR_MemoryCategoryMB (vulkan_memory_category_t category)
+{
+	return (int)(Atomic_LoadUInt64 (&vulkan_memory_category_sizes[category]) / 1024 / 1024);
+}
+
 /*
 ==============
 SCR_DrawDevStats
@@ -792,15 +847,52 @@ SCR_DrawDevStats
 static void SCR_DrawDevStats (cb_context_t *cbx)
 {
 	char str[40];
-	int	 y = 25 - 9; // 9=number of lines to print
-	int	 x = 0;		 // margin
+	int	 y = 25 - 9 - 12; // 9+12=number of lines to print
+	int	 x = 0;			  // margin
 
 	if (!devstats.value)
 		return;
 
 	GL_SetCanvas (cbx, CANVAS_BOTTOMLEFT);
 
-	Draw_Fill (cbx, x, y * CHARACTER_SIZE, 19 * CHARACTER_SIZE, 9 * CHARACTER_SIZE, 0, 0.5); // dark rectangle
+	Draw_Fill (cbx, x, y * CHARACTER_SIZE, 19 * CHARACTER_SIZE, (9 + 12) * CHARACTER_SIZE, 0, 0.5); // dark rectangle
+
+	const vulkan_memory_budget_t *budget = R_GetMemoryBudget ();
+	q_snprintf (str, sizeof (str), "memory MB|Used %s", budget->from_driver ? "Budg" : "Est.");
+	Draw_String (cbx, x, (y++) * CHARACTER_SIZE - x, str);
+
+	q_snprintf (str, sizeof (str), "---------+---------");
+	Draw_String (cbx, x, (y++) * CHARACTER_SIZE - x, str);
+
+	q_snprintf (str, sizeof (str), "Device   |%4i %4i", (int)(budget->device_usage / 1024 / 1024), (int)(budget->device_budget / 1024 / 1024));
+	Draw_String (cbx, x, (y++) * CHARACTER_SIZE - x, str);
+
+	q_snprintf (str, sizeof (str), "Host     |%4i %4i", (int)(budget->host_usage / 1024 / 1024), (int)(budget->host_budget / 1024 / 1024));
+	Draw_String (cbx, x, (y++) * CHARACTER_SIZE - x, str);
+
+	q_snprintf (str, sizeof (str), "Textures |%4i", SCR_MemoryCategoryMB (VULKAN_MEMORY_CATEGORY_TEXTURES));
+	Draw_String (cbx, x, (y++) * CHARACTER_SIZE - x, str);
+
+	q_snprintf (str, sizeof (str), " Lightmap|%4i", SCR_MemoryCategoryMB (VULKAN_MEMORY_CATEGORY_LIGHTMAPS));
+	Draw_String (cbx, x, (y++) * CHARACTER_SIZE - x, str);
+
+	q_snprintf (str, sizeof (str), "BModels  |%4i", SCR_MemoryCategoryMB (VULKAN_MEMORY_CATEGORY_BMODEL));
+	Draw_String (cbx, x, (y++) * CHARACTER_SIZE - x, str);
+
+	q_snprintf (str, sizeof (str), "Meshes   |%4i", SCR_MemoryCategoryMB (VULKAN_MEMORY_CATEGORY_MESH));
+	Draw_String (cbx, x, (y++) * CHARACTER_SIZE - x, str);
+
+	q_snprintf (str, sizeof (str), " Accel   |%4i", SCR_MemoryCategoryMB (VULKAN_MEMORY_CATEGORY_ACCELERATION_STRUCTURES));
+	Draw_String (cbx, x, (y++) * CHARACTER_SIZE - x, str);
+
+	q_snprintf (str, sizeof (str), "Dynamic  |%4i", SCR_MemoryCategoryMB (VULKAN_MEMORY_CATEGORY_DYNAMIC));
+	Draw_String (cbx, x, (y++) * CHARACTER_SIZE - x, str);
+
+	q_snprintf (str, sizeof (str), "Misc     |%4i", SCR_MemoryCategoryMB (VULKAN_MEMORY_CATEGORY_MISC));
+	Draw_String (cbx, x, (y++) * CHARACTER_SIZE - x, str);
+
+	q_snprintf (str, sizeof (str), "UI       |%4i", SCR_MemoryCategoryMB (VULKAN_MEMORY_CATEGORY_UI));
+	Draw_String (cbx, x, (y++) * CHARACTER_SIZE - x, str);
 
 	q_snprintf (str, sizeof (str), "devstats |Curr Peak");
 	Draw_String (cbx, x, (y++) * CHARACTER_SIZE - x, str);
@@ -830,6 +922,52 @@ static void SCR_DrawDevStats (cb_context_t *cbx)
 	Draw_String (cbx, x, (y++) * CHARACTER_SIZE - x, str);
 }
 
+/*
+==============
+SCR_DrawSoundSpeeds
+==============
+*/
+static void SCR_DrawSoundSpeeds (cb_context_t *cbx)
+{
+	char str[40];
+	int	 y = 0;
+	int	 x = 320 - 20 * CHARACTER_SIZE;
+
+	if (!snd_speeds.value)
+		return;
+
+	GL_SetCanvas (cbx, CANVAS_TOPRIGHT);
+
+	Draw_Fill (cbx, x, y, 20 * CHARACTER_SIZE, 9 * CHARACTER_SIZE, 0, 0.5); // dark rectangle
+
+	q_snprintf (str, sizeof (str), "snd_speeds| Avg Peak");
+	Draw_String (cbx, x, (y++) * CHARACTER_SIZE, str);
+
+	q_snprintf (str, sizeof (str), "----------+---------");
+	Draw_String (cbx, x, (y++) * CHARACTER_SIZE, str);
+
+	q_snprintf (str, sizeof (str), "Mix ms    |%4.2f %4.2f", snd_stats.mix_ms, snd_stats.mix_peak_ms);
+	Draw_String (cbx, x, (y++) * CHARACTER_SIZE, str);
+
+	q_snprintf (str, sizeof (str), "Filter ms |%4.2f", snd_stats.filter_ms);
+	Draw_String (cbx, x, (y++) * CHARACTER_SIZE, str);
+
+	q_snprintf (str, sizeof (str), "Music ms/s|%4.1f", snd_stats.music_ms);
+	Draw_String (cbx, x, (y++) * CHARACTER_SIZE, str);
+
+	q_snprintf (str, sizeof (str), "Updates/s |%4i", snd_stats.updates);
+	Draw_String (cbx, x, (y++) * CHARACTER_SIZE, str);
+
+	q_snprintf (str, sizeof (str), "Voices    |%4i %4i", snd_stats.voices, snd_stats.virtual_voices);
+	Draw_String (cbx, x, (y++) * CHARACTER_SIZE, str);
+
+	q_snprintf (str, sizeof (str), "Underruns |%4i", snd_stats.underruns);
+	Draw_String (cbx, x, (y++) * CHARACTER_SIZE, str);
+
+	q_snprintf (str, sizeof (str), "Latency ms|%4.0f", snd_stats.latency_ms);
+	Draw_String (cbx, x, (y++) * CHARACTER_SIZE, str);
+}
+
 /*
 ==============
 SCR_DrawTurtle
@@ -914,6 +1052,19 @@ static void SCR_DrawLoading (cb_context_t *cbx)
 
 	pic = Draw_CachePic ("gfx/loading.lmp");
 	Draw_Pic (cbx, (320 - pic->width) / 2, (240 - 48 - pic->height) / 2, pic, 1.0f, false); // johnfitz -- stretched menus
+
+	if (!scr_loading_frame || !scr_loading.phase)
+		return;
+
+	// the phase and how far it got below the plaque
+	const int y = (240 - 48 + pic->height) / 2 + CHARACTER_SIZE;
+	if (scr_loading.total > 0)
+	{
+		const int width = 20 * CHARACTER_SIZE;
+		Draw_Fill (cbx, (320 - width) / 2, y, width, 4, 0, 1.0f);
+		Draw_Fill (cbx, (320 - width) / 2, y, width * CLAMP (0, scr_loading.done, scr_loading.total) / scr_loading.total, 4, 15, 1.0f);
+	}
+	Draw_String (cbx, (320 - (int)strlen (scr_loading.phase) * CHARACTER_SIZE) / 2, y + CHARACTER_SIZE, scr_loading.phase);
 }
 
 /*
@@ -1060,6 +1211,114 @@ void SCR_EndLoadingPlaque (void)
 {
 	scr_disabled_for_loading = false;
 	Con_ClearNotify ();
+
+	SCR_EndLoadingPhase ();
+	if (scr_loadtimes.value && scr_loading.num_phases)
+	{
+		double total = 0.0;
+		Con_Printf ("load:");
+		for (int i = 0; i < scr_loading.num_phases; i++)
+		{
+			Con_Printf (" %s %.0f ms", scr_loading.phases[i].name, scr_loading.phases[i].seconds * 1000.0);
+			total += scr_loading.phases[i].seconds;
+		}
+		Con_Printf (", %.0f ms total\n", total * 1000.0);
+	}
+	scr_loading.num_phases = 0;
+}
+
+/*
+===============
+SCR_BeginLoadingPhase
+
+Starts timing a step of loading a map, ending the one before. total is
+how many items SCR_LoadingProgress is going to count up to, 0 if unknown.
+The name is shown on the loading screen and must outlive the phase.
+================
+*/
+void SCR_BeginLoadingPhase (const char *name, int total)
+{
+	SCR_EndLoadingPhase ();
+	scr_loading.phase = name;
+	scr_loading.phase_start = Sys_DoubleTime ();
+	scr_loading.done = 0;
+	scr_loading.total = total;
+	SCR_LoadingProgress (0);
+}
+
+/*
+===============
+SCR_EndLoadingPhase
+
+Phases with the same name add up, they are printed by SCR_EndLoadingPlaque
+================
+*/
+void SCR_EndLoadingPhase (void)
+{
+	int i;
+
+	if (!scr_loading.phase)
+		return;
+
+	for (i = 0; i < scr_loading.num_phases; i++)
+	{
+		if (!strcmp (scr_loading.phases[i].name, scr_loading.phase))
+			break;
+	}
+	if (i < MAX_LOADING_PHASES)
+	{
+		if (i == scr_loading.num_phases)
+		{
+			scr_loading.phases[i].name = scr_loading.phase;
+			scr_loading.phases[i].seconds = 0.0;
+			scr_loading.num_phases++;
+		}
+		scr_loading.phases[i].seconds += Sys_DoubleTime () - scr_loading.phase_start;
+	}
+	scr_loading.phase = NULL;
+}
+
+/*
+===============
+SCR_IsLoading
+================
+*/
+qboolean SCR_IsLoading (void)
+{
+	return scr_loading.phase != NULL;
+}
+
+/*
+===============
+SCR_LoadingProgress
+
+Called between the items of a loading phase. At most every LOADING_FRAME_INTERVAL
+it answers the window system and presents a frame of the loading screen, the
+file reads started by COM_StartPrefetch keep going on the workers meanwhile.
+Only 2D is drawn, the models of the client's last map may already be freed.
+================
+*/
+void SCR_LoadingProgress (int done)
+{
+	scr_loading.done = done;
+
+	if (!scr_loading.phase || cls.state == ca_dedicated || !scr_initialized || Tasks_IsWorker ())
+		return;
+	const double time = Sys_DoubleTime ();
+	if (time - scr_loading.last_frame < LOADING_FRAME_INTERVAL)
+		return;
+	scr_loading.last_frame = time;
+
+	IN_PumpWindowEvents ();
+
+	const qboolean disabled_for_loading = scr_disabled_for_loading;
+	scr_disabled_for_loading = false;
+	scr_loading_frame = true;
+	scr_drawloading = true;
+	SCR_UpdateScreen (false);
+	scr_drawloading = false;
+	scr_loading_frame = false;
+	scr_disabled_for_loading = disabled_for_loading;
 }
 
 //=============================================================================
@@ -1193,8 +1452,8 @@ static void SCR_DrawGUI (void *unused)
 {
 	cb_context_t *cbx = vulkan_globals.secondary_cb_contexts[SCBX_GUI];
 #ifdef USE_RMLUI
-	const qboolean suppress_native_overlay = UI_IsMainMenuStartupPending ();
-	const float	   startup_blackout_alpha = suppress_native_overlay ? (float)UI_StartupBlackoutAlpha () : 0.0f;
+	const qboolean suppress_native_overlay = scr_ui_startup_pending;
+	const float	   startup_blackout_alpha = scr_ui_blackout_alpha;
 #endif
 
 	GL_SetCanvas (cbx, CANVAS_DEFAULT);
@@ -1229,6 +1488,11 @@ static void SCR_DrawGUI (void *unused)
 		Draw_FadeScreen (cbx);
 		SCR_DrawNotifyString (cbx);
 	}
+	else if (scr_loading_frame) // in the middle of loading a map
+	{
+		Draw_ConsoleBackground (cbx);
+		SCR_DrawLoading (cbx);
+	}
 	else if (scr_drawloading) // loading
 	{
 		SCR_DrawLoading (cbx);
@@ -1236,17 +1500,13 @@ static void SCR_DrawGUI (void *unused)
 	}
 	else if (cl.intermission == 1 && key_dest == key_game) // end of level
 	{
-#ifdef USE_RMLUI
-		UI_SyncGameState (cl.stats, MAX_CL_STATS, cl.items, cl.intermission, cl.gametype, cl.maxclients, cl.levelname, cl.mapname, cl.time);
-#else
+#ifndef USE_RMLUI // drawn by RmlUI, see SCR_SyncUI
 		Sbar_IntermissionOverlay (cbx);
 #endif
 	}
 	else if (cl.intermission == 2 && key_dest == key_game) // end of episode
 	{
-#ifdef USE_RMLUI
-		UI_SyncGameState (cl.stats, MAX_CL_STATS, cl.items, cl.intermission, cl.gametype, cl.maxclients, cl.levelname, cl.mapname, cl.time);
-#else
+#ifndef USE_RMLUI // drawn by RmlUI, see SCR_SyncUI
 		Sbar_FinaleOverlay (cbx);
 		SCR_CheckDrawCenterString (cbx);
 #endif
@@ -1271,6 +1531,7 @@ static void SCR_DrawGUI (void *unused)
 			SCR_DrawDevStats (cbx); // johnfitz
 			SCR_DrawFPS (cbx);		// johnfitz
 			SCR_DrawClock (cbx);	// johnfitz
+			SCR_DrawSoundSpeeds (cbx);
 			SCR_DrawConsole (cbx);
 			M_Draw (cbx);
 		}
@@ -1279,9 +1540,58 @@ static void SCR_DrawGUI (void *unused)
 	if (use_mutex)
 		SDL_UnlockMutex (draw_qcvm_mutex);
 
+	Draw_Flush (cbx);
+
+	R_EndDebugUtilsLabel (cbx);
+}
+
 #ifdef USE_RMLUI
-	/* Render RmlUI overlay on top of Quake GUI */
+/*
+==================
+SCR_SyncUI
+
+Feeds the game state to the RmlUI documents wherever SCR_DrawGUI would have
+drawn the status bar or intermission, and the progress to the loading screen
+==================
+*/
+static void SCR_SyncUI (void)
+{
+	if (scr_loading_frame)
+	{
+		UI_ShowLoading ((scr_loading.total > 0) ? CLAMP (0, scr_loading.done * 100 / scr_loading.total, 100) : -1, scr_loading.phase);
+		return;
+	}
+	UI_HideLoading ();
+
+	if (scr_drawdialog)
+	{
+		if (!con_forcedup)
+			Sbar_SyncUI ();
+	}
+	else if (scr_drawloading)
+		Sbar_SyncUI ();
+	else if ((cl.intermission == 1 || cl.intermission == 2) && key_dest == key_game)
+		UI_SyncGameState (
+			cl.stats, MAX_CL_STATS, cl.items, cl.intermission, cl.gametype, cl.maxclients, cl.levelname, cl.mapname, cl.time, cl_stats_generation);
+	else if (!scr_ui_startup_pending)
+		Sbar_SyncUI ();
+}
+
+/*
+==================
+SCR_DrawUI
+
+Updates RmlUI and records it into its own secondary command buffer, which is
+executed on top of the GUI. Nothing else touches the UI documents while the
+draw tasks run, so it runs alongside the world and GUI tasks.
+==================
+*/
+static void SCR_DrawUI (void *unused)
+{
+	cb_context_t *cbx = vulkan_globals.secondary_cb_contexts[SCBX_RMLUI];
+
 	R_BeginDebugUtilsLabel (cbx, "RmlUI");
+	SCR_SyncUI ();
 	UI_BeginFrame (cbx->cb, vid.width, vid.height);
 	UI_Update (host_frametime);
 	UI_Render ();
@@ -1300,6 +1610,11 @@ static void SCR_DrawGUI (void *unused)
 			static double	   sum_update_dp = 0.0;
 			static double	   sum_update_model = 0.0;
 			static double	   sum_update_lua = 0.0;
+			static double	   sum_update_lua_gc = 0.0;
+			static double	   sum_update_documents = 0.0;
+			static double	   sum_upload_bytes = 0.0;
+			static double	   sum_model_dirty_vars = 0.0;
+			static int		   max_upload_bytes = 0;
 			static double	   sum_update_hud_logic = 0.0;
 			static double	   sum_update_notify = 0.0;
 			static double	   sum_update_context = 0.0;
@@ -1316,6 +1631,8 @@ static void SCR_DrawGUI (void *unused)
 			static double	   worst_update_dp = 0.0;
 			static double	   worst_update_model = 0.0;
 			static double	   worst_update_lua = 0.0;
+			static double	   worst_update_lua_gc = 0.0;
+			static int		   window_gc_cycles = -1;
 			static double	   worst_update_hud_logic = 0.0;
 			static double	   worst_update_notify = 0.0;
 			static double	   worst_update_context = 0.0;
@@ -1337,6 +1654,16 @@ static void SCR_DrawGUI (void *unused)
 			sum_update_dp += stats.update_dp_ms;
 			sum_update_model += stats.update_model_ms;
 			sum_update_lua += stats.update_lua_ms;
+			sum_update_lua_gc += stats.update_lua_gc_ms;
+			sum_update_documents += stats.update_documents_ms;
+			sum_upload_bytes += stats.upload_bytes;
+			sum_model_dirty_vars += stats.model_dirty_vars;
+			if (stats.upload_bytes > max_upload_bytes)
+				max_upload_bytes = stats.upload_bytes;
+			if (stats.update_lua_gc_ms > worst_update_lua_gc)
+				worst_update_lua_gc = stats.update_lua_gc_ms;
+			if (window_gc_cycles < 0)
+				window_gc_cycles = stats.lua_gc_cycles;
 			sum_update_hud_logic += stats.update_hud_logic_ms;
 			sum_update_notify += stats.update_notify_ms;
 			sum_update_context += stats.update_context_ms;
@@ -1417,6 +1744,23 @@ static void SCR_DrawGUI (void *unused)
 						"ui(update avg1s) dp %.2f model %.2f lua %.2f hud %.2f notify %.2f context %.2f post %.2f\n", sum_update_dp * inv,
 						sum_update_model * inv, sum_update_lua * inv, sum_update_hud_logic * inv, sum_update_notify * inv, sum_update_context * inv,
 						sum_update_post * inv);
+					Con_Printf (
+						"ui(lua avg1s) gc step %.3f/%.3f ms heap %d KB cycles %d\n", sum_update_lua_gc * inv, worst_update_lua_gc, stats.lua_memory_kb,
+						stats.lua_gc_cycles - window_gc_cycles);
+					Con_Printf (
+						"ui(frame avg1s) upload %.1f/%.1f KB model dirty %.1f\n", sum_upload_bytes * inv / 1024.0, max_upload_bytes / 1024.0,
+						sum_model_dirty_vars * inv);
+				}
+
+				if (ui_speeds.value >= 4)
+				{
+					ui_document_perf_t docs[16];
+					const int		   num_docs = UI_GetDocumentPerfStats (docs, countof (docs));
+					int				   i;
+
+					Con_Printf ("ui(docs avg1s) style+layout %.2f ms in %d documents\n", sum_update_documents * inv, num_docs);
+					for (i = 0; i < num_docs; i++)
+						Con_Printf ("ui(docs avg1s)   %s %.2f/%.2f\n", docs[i].path, docs[i].avg_ms, docs[i].worst_ms);
 				}
 
 				window_start = realtime;
@@ -1426,6 +1770,13 @@ static void SCR_DrawGUI (void *unused)
 				sum_update_dp = 0.0;
 				sum_update_model = 0.0;
 				sum_update_lua = 0.0;
+				sum_update_lua_gc = 0.0;
+				sum_update_documents = 0.0;
+				sum_upload_bytes = 0.0;
+				sum_model_dirty_vars = 0.0;
+				max_upload_bytes = 0;
+				worst_update_lua_gc = 0.0;
+				window_gc_cycles = stats.lua_gc_cycles;
 				sum_update_hud_logic = 0.0;
 				sum_update_notify = 0.0;
 				sum_update_context = 0.0;
@@ -1460,11 +1811,9 @@ static void SCR_DrawGUI (void *unused)
 				stats.render_ms, stats.end_ms, stats.gpu_ms, stats.draw_calls, stats.triangles);
 		}
 	}
-	R_EndDebugUtilsLabel (cbx);
-#endif
-
 	R_EndDebugUtilsLabel (cbx);
 }
+#endif
 
 /*
 ==================
@@ -1510,6 +1859,9 @@ void SCR_UpdateScreen (qboolean use_tasks)
 	if (Tasks_IsWorker ())
 		return; // not safe
 
+	if (SCR_RenderingInFlight ())
+		return; // only the server runs until the host joins the last pipelined frame
+
 	in_update_screen = true;
 	use_tasks = use_tasks && (Tasks_NumWorkers () > 1) && r_tasks.value && r_gpulightmapupdate.value;
 
@@ -1535,13 +1887,20 @@ void SCR_UpdateScreen (qboolean use_tasks)
 	// tasks are created. This prevents race conditions between UI state changes
 	// and rendering on worker threads.
 	UI_ProcessPending ();
-	suppress_startup_world = UI_IsMainMenuStartupPending ();
+	scr_ui_startup_pending = UI_IsMainMenuStartupPending ();
+	scr_ui_blackout_alpha = scr_ui_startup_pending ? (float)UI_StartupBlackoutAlpha () : 0.0f;
+	suppress_startup_world = scr_ui_startup_pending;
 	if (suppress_startup_world)
 		use_tasks = false; /* Keep startup blackout path simple and deterministic. */
 #endif
 
 	// decide on the height of the console
-	con_forcedup = !cl.worldmodel || cls.signon != SIGNONS;
+	con_forcedup = !cl.worldmodel || cls.signon != SIGNONS || scr_loading_frame;
+
+	// must happen before any rendering task reads texture descriptor sets
+	R_UpdateMemoryBudget ();
+	TexMgr_StreamTextures ();
+	TexMgr_Defragment ();
 
 	task_handle_t begin_rendering_task = INVALID_TASK_HANDLE;
 	if (!GL_BeginRendering (use_tasks, &begin_rendering_task, &glwidth, &glheight))
@@ -1569,11 +1928,22 @@ void SCR_UpdateScreen (qboolean use_tasks)
 		Task_AddDependency (draw_gui_task, draw_done_task);
 		Task_AddDependency (draw_done_task, end_rendering_task);
 
+#ifdef USE_RMLUI
+		task_handle_t draw_ui_task = Task_AllocateAndAssignFunc (SCR_DrawUI, NULL, 0);
+		Task_AddDependency (begin_rendering_task, draw_ui_task);
+		Task_AddDependency (setup_frame_task, draw_ui_task);
+		Task_AddDependency (draw_ui_task, draw_done_task);
+		Tasks_Submit (1, &draw_ui_task);
+#endif
+
 		task_handle_t tasks[] = {begin_rendering_task, setup_frame_task, draw_done_task, draw_gui_task, end_rendering_task};
 		Tasks_Submit (sizeof (tasks) / sizeof (task_handle_t), tasks);
 
-		while (!Task_Join (draw_done_task, 10))
-			S_ExtraUpdate ();
+		if (pipeline_frame)
+			pipeline_draw_done_task = draw_done_task;
+		else
+			while (!Task_Join (draw_done_task, 10))
+				S_ExtraUpdate ();
 		prev_end_rendering_task = end_rendering_task;
 	}
 	else
@@ -1581,14 +1951,61 @@ void SCR_UpdateScreen (qboolean use_tasks)
 		GL_SynchronizeEndRenderingTask ();
 		SCR_SetupFrame (NULL);
 #ifdef USE_RMLUI
-		if (!(suppress_startup_world && UI_StartupBlackoutAlpha () >= 1.0))
+		if (!(suppress_startup_world && scr_ui_blackout_alpha >= 1.0f))
 #endif
 			V_RenderView (use_tasks, INVALID_TASK_HANDLE, INVALID_TASK_HANDLE, INVALID_TASK_HANDLE);
 		S_ExtraUpdate ();
 		SCR_DrawGUI (NULL);
+#ifdef USE_RMLUI
+		SCR_DrawUI (NULL);
+#endif
 		SCR_DrawDone (NULL);
 		GL_EndRendering (false, true);
 	}
 
 	in_update_screen = false;
 }
+
+/*
+==================
+SCR_UpdateScreenPipelined
+
+Same as SCR_UpdateScreen (true), but returns as soon as the draw tasks are
+submitted. The caller can then do work that doesn't touch anything the
+renderer reads, and must call SCR_SynchronizeRendering before changing client
+state again.
+==================
+*/
+void SCR_UpdateScreenPipelined (void)
+{
+	pipeline_frame = true;
+	SCR_UpdateScreen (true);
+	pipeline_frame = false;
+}
+
+/*
+==================
+SCR_RenderingInFlight
+==================
+*/
+qboolean SCR_RenderingInFlight (void)
+{
+	return pipeline_draw_done_task != INVALID_TASK_HANDLE;
+}
+
+/*
+==================
+SCR_SynchronizeRendering
+
+Waits for the draw tasks of the last pipelined SCR_UpdateScreen
+==================
+*/
+void SCR_SynchronizeRendering (void)
+{
+	if (pipeline_draw_done_task == INVALID_TASK_HANDLE || Tasks_IsWorker ())
+		return;
+
+	while (!Task_Join (pipeline_draw_done_task, 10))
+		S_ExtraUpdate ();
+	pipeline_draw_done_task = INVALID_TASK_HANDLE;
+}
@@ -30,10 +30,11 @@ void  Fog_GetColor (float *c);
 
 extern atomic_uint32_t rs_skypolys; // for r_speeds readout
 static float		   skyflatcolor[3];
-static float		   skymins[2][6], skymaxs[2][6];
 
 static gltexture_t *solidskytexture, *alphaskytexture;
 
+extern VkBuffer bmodel_vertex_buffer;
+
 extern cvar_t gl_farclip;
 cvar_t		  r_fastsky = {"r_fastsky", "0", CVAR_NONE};
 cvar_t		  r_sky_quality = {"r_sky_quality", "12", CVAR_NONE};
@@ -43,15 +44,11 @@ cvar_t		  r_skywind = {"r_skywind", "1", CVAR_ARCHIVE};
 
 static const int skytexorder[6] = {0, 2, 1, 3, 4, 5}; // for skybox
 
-static const vec3_t skyclip[6] = {{1, 1, 0}, {1, -1, 0}, {0, -1, 1}, {0, 1, 1}, {1, 0, 1}, {-1, 0, 1}};
-
 static const int st_to_vec[6][3] = {
 	{3, -1, 2}, {-3, 1, 2}, {1, 3, 2}, {-1, -3, 2}, {-2, -1, 3}, // straight up
 	{2, -1, -3}													 // straight down
 };
 
-static const int vec_to_st[6][3] = {{-2, 3, 1}, {2, 3, -1}, {1, 3, 2}, {-1, 3, -2}, {-2, -1, 3}, {-2, 1, -3}};
-
 static float skyfog; // ericw
 
 #define SKYWIND_CFG "wind.cfg"
@@ -59,8 +56,6 @@ static float skyfog; // ericw
 static SDL_Mutex *load_skytexture_mutex;
 static int		  max_skytexture_index = -1;
 
-qboolean need_bounds;
-
 typedef struct
 {
 	float position[3];
@@ -328,6 +323,7 @@ static void Skywind_Save_f (void)
 		Con_Printf ("Couldn't write '%s'.\n", relname);
 		return;
 	}
+	COM_AddIndexedFile (path);
 
 	fprintf (
 		f,
@@ -478,11 +474,21 @@ void Sky_LoadSkyBox (const char *name)
 		return;
 	}
 
-	// load textures
+	// load textures, the faces are decoded in parallel
+	image_load_t images[6];
 	for (i = 0; i < 6; i++)
 	{
 		q_snprintf (filename[i], sizeof (filename[i]), "gfx/env/%s%s", name, suf[i]);
-		if ((data[i] = Image_LoadImage (filename[i], &width[i], &height[i], &fmt[i], (cl.worldmodel ? cl.worldmodel->path_id : 0))))
+		images[i] = (image_load_t){.name = filename[i], .min_path_id = (cl.worldmodel ? cl.worldmodel->path_id : 0)};
+	}
+	Image_LoadImages (6, images);
+	for (i = 0; i < 6; i++)
+	{
+		data[i] = images[i].data;
+		width[i] = images[i].width;
+		height[i] = images[i].height;
+		fmt[i] = images[i].fmt;
+		if (data[i])
 			nonefound = false;
 		if (!data[i] || (width[i] != height[i]) || (width[i] != width[0]) || (fmt[i] != SRC_RGBA))
 			cubemap = false;
@@ -710,238 +716,41 @@ void Sky_Init (void)
 //
 //==============================================================================
 
-/*
-=================
-Sky_ProjectPoly
-
-update sky bounds
-=================
-*/
-void Sky_ProjectPoly (int nump, vec3_t vecs)
-{
-	int	   i, j;
-	vec3_t v, av;
-	float  s, t, dv;
-	int	   axis;
-	float *vp;
-
-	// decide which face it maps to
-	VectorCopy (vec3_origin, v);
-	for (i = 0, vp = vecs; i < nump; i++, vp += 3)
-	{
-		VectorAdd (vp, v, v);
-	}
-	av[0] = fabs (v[0]);
-	av[1] = fabs (v[1]);
-	av[2] = fabs (v[2]);
-	if (av[0] > av[1] && av[0] > av[2])
-	{
-		if (v[0] < 0)
-			axis = 1;
-		else
-			axis = 0;
-	}
-	else if (av[1] > av[2] && av[1] > av[0])
-	{
-		if (v[1] < 0)
-			axis = 3;
-		else
-			axis = 2;
-	}
-	else
-	{
-		if (v[2] < 0)
-			axis = 5;
-		else
-			axis = 4;
-	}
-
-	// project new texture coords
-	for (i = 0; i < nump; i++, vecs += 3)
-	{
-		j = vec_to_st[axis][2];
-		if (j > 0)
-			dv = vecs[j - 1];
-		else
-			dv = -vecs[-j - 1];
-
-		j = vec_to_st[axis][0];
-		if (j < 0)
-			s = -vecs[-j - 1] / dv;
-		else
-			s = vecs[j - 1] / dv;
-		j = vec_to_st[axis][1];
-		if (j < 0)
-			t = -vecs[-j - 1] / dv;
-		else
-			t = vecs[j - 1] / dv;
-
-		if (s < skymins[0][axis])
-			skymins[0][axis] = s;
-		if (t < skymins[1][axis])
-			skymins[1][axis] = t;
-		if (s > skymaxs[0][axis])
-			skymaxs[0][axis] = s;
-		if (t > skymaxs[1][axis])
-			skymaxs[1][axis] = t;
-	}
-}
-
-/*
-=================
-Sky_ClipPoly
-=================
-*/
-static void Sky_ClipPoly (int nump, vec3_t vecs, int stage)
-{
-	float	*v;
-	qboolean front, back;
-	float	 d, e;
-	int		 newc[2];
-
-	int i, j = 0;
-
-	const size_t MAX_CLIP_VERTS = nump + 2;
-
-	if (stage == 6) // fully clipped
-	{
-		Sky_ProjectPoly (nump, vecs);
-		return;
-	}
-
-	front = back = false;
-
-	TEMP_ALLOC (int, sides, MAX_CLIP_VERTS);
-	TEMP_ALLOC (float, dists, MAX_CLIP_VERTS);
-
-	for (i = 0, v = vecs; i < nump; i++, v += 3)
-	{
-		d = DotProduct (v, skyclip[stage]);
-
-		if (d > ON_EPSILON)
-		{
-			front = true;
-			sides[i] = SIDE_FRONT;
-		}
-		else if (d < ON_EPSILON)
-		{
-			back = true;
-			sides[i] = SIDE_BACK;
-		}
-		else
-			sides[i] = SIDE_ON;
-		dists[i] = d;
-	}
-
-	if (!front || !back)
-	{
-		// not clipped
-		Sky_ClipPoly (nump, vecs, stage + 1);
-
-		TEMP_FREE (dists);
-		TEMP_FREE (sides);
-		return;
-	}
-
-	// clip it
-	sides[i] = sides[0];
-	dists[i] = dists[0];
-	VectorCopy (vecs, (vecs + (i * 3)));
-	newc[0] = newc[1] = 0;
-
-	// 2-dim vec3_t	 newv[2][MAX_CLIP_VERTS]; as 2 arrays
-	TEMP_ALLOC (vec3_t, newv_0, MAX_CLIP_VERTS);
-	TEMP_ALLOC (vec3_t, newv_1, MAX_CLIP_VERTS);
-
-	for (i = 0, v = vecs; i < nump; i++, v += 3)
-	{
-		switch (sides[i])
-		{
-		case SIDE_FRONT:
-			VectorCopy (v, newv_0[newc[0]]);
-			newc[0]++;
-			break;
-		case SIDE_BACK:
-			VectorCopy (v, newv_1[newc[1]]);
-			newc[1]++;
-			break;
-		case SIDE_ON:
-			VectorCopy (v, newv_0[newc[0]]);
-			newc[0]++;
-			VectorCopy (v, newv_1[newc[1]]);
-			newc[1]++;
-			break;
-		}
-
-		if (sides[i] == SIDE_ON || sides[i + 1] == SIDE_ON || sides[i + 1] == sides[i])
-			continue;
-
-		d = dists[i] / (dists[i] - dists[i + 1]);
-		for (j = 0; j < 3; j++)
-		{
-			e = v[j] + d * (v[j + 3] - v[j]);
-			newv_0[newc[0]][j] = e;
-			newv_1[newc[1]][j] = e;
-		}
-		newc[0]++;
-		newc[1]++;
-	}
-
-	// continue
-	Sky_ClipPoly (newc[0], newv_0[0], stage + 1);
-	Sky_ClipPoly (newc[1], newv_1[0], stage + 1);
-
-	TEMP_FREE (dists);
-	TEMP_FREE (sides);
-	TEMP_FREE (newv_0);
-	TEMP_FREE (newv_1);
-}
-
 /*
 ================
-Sky_ProcessPoly
+Sky_FlushBatch
 ================
 */
-void Sky_ProcessPoly (cb_context_t *cbx, glpoly_t *p, float color[3])
+static void Sky_FlushBatch (cb_context_t *cbx)
 {
-	float *poly_vert;
-
-	// draw it
-	DrawGLPoly (cbx, p, color, 1.0f);
-
-	// update sky bounds
-	if (need_bounds)
-	{
-		const size_t MAX_CLIP_VERTS = p->numverts + 2;
-		const int	 num_verts = p->numverts;
-
-		TEMP_ALLOC (vec3_t, verts, MAX_CLIP_VERTS);
-
-		for (int i = 0; i < num_verts; i++)
-		{
-			poly_vert = &p->verts[0][0] + (i * VERTEXSIZE);
-			VectorSubtract (poly_vert, r_origin, verts[i]);
-		}
-		Sky_ClipPoly (num_verts, verts[0], 0);
+	if (cbx->num_vbo_indices == 0)
+		return;
 
-		TEMP_FREE (verts);
-	}
+	R_DrawBatchIndices (cbx, 0);
+	cbx->num_vbo_indices = 0;
 }
 
 /*
 ================
 Sky_ProcessTextureChains -- handles sky polys in world model
+
+World sky surfaces are already in the bmodel vertex buffer, so they are batched
+into as few draws as possible with the same pipelines as the indirect path.
 ================
 */
-void Sky_ProcessTextureChains (cb_context_t *cbx, float color[3], int *skypolys)
+static void Sky_ProcessTextureChains (cb_context_t *cbx, int *skypolys)
 {
-	int			i;
+	int			i, j;
 	msurface_t *s;
 	texture_t  *t;
 
 	if (!r_drawworld_cheatsafe)
 		return;
 
+	VkDeviceSize offset = 0;
+	vkCmdBindVertexBuffers (cbx->cb, 0, 1, &bmodel_vertex_buffer, &offset);
+	cbx->num_vbo_indices = 0;
+
 	for (i = 0; i < cl.worldmodel->numtextures; i++)
 	{
 		t = cl.worldmodel->textures[i];
@@ -951,10 +760,23 @@ void Sky_ProcessTextureChains (cb_context_t *cbx, float color[3], int *skypolys)
 
 		for (s = t->texturechains[chain_world]; s; s = s->texturechains[chain_world])
 		{
-			Sky_ProcessPoly (cbx, s->polys, color);
+			const int num_surf_indices = 3 * (s->numedges - 2);
+			if (cbx->num_vbo_indices + num_surf_indices > MAX_BATCH_SIZE)
+				Sky_FlushBatch (cbx);
+
+			uint32_t *dest = &cbx->vbo_indices[cbx->num_vbo_indices];
+			for (j = 2; j < s->numedges; j++)
+			{
+				*dest++ = s->vbo_firstvert;
+				*dest++ = s->vbo_firstvert + j - 1;
+				*dest++ = s->vbo_firstvert + j;
+			}
+			cbx->num_vbo_indices += num_surf_indices;
 			++(*skypolys);
 		}
 	}
+
+	Sky_FlushBatch (cbx);
 }
 
 /*
@@ -964,7 +786,7 @@ Sky_DrawSkySurface
 */
 static void Sky_DrawSkySurface (cb_context_t *cbx, float color[3], entity_t *e, msurface_t *s, qboolean rotated, vec3_t forward, vec3_t right, vec3_t up)
 {
-	// copy the polygon and translate manually, since Sky_ProcessPoly needs it to be in world space
+	// copy the polygon and translate manually, since the sky shaders need it to be in world space
 	TEMP_ALLOC (glpoly_t, p, s->polys->numverts);
 	p->numverts = s->polys->numverts;
 	for (int k = 0; k < p->numverts; k++)
@@ -982,7 +804,7 @@ static void Sky_DrawSkySurface (cb_context_t *cbx, float color[3], entity_t *e,
 			VectorAdd (s_poly_vert, e->origin, poly_vert);
 		}
 	}
-	Sky_ProcessPoly (cbx, p, color);
+	DrawGLPoly (cbx, p, color, 1.0f);
 	TEMP_FREE (p);
 }
 
@@ -1110,7 +932,7 @@ void Sky_EmitSkyBoxVertex (basicvertex_t *vertex, float s, float t, int axis)
 ==============
 Sky_DrawSkyBox
 
-FIXME: eliminate cracks by adding an extra vert on tjuncs
+Draws the entire box, only the pixels that had stencil written by the sky surfaces are filled
 ==============
 */
 void Sky_DrawSkyBox (cb_context_t *cbx, int *skypolys)
@@ -1119,34 +941,18 @@ void Sky_DrawSkyBox (cb_context_t *cbx, int *skypolys)
 
 	for (i = 0; i < 6; i++)
 	{
-		if (indirect) // Don't have bounds for the world polys. This type of sky (malformed cube) is very rare, so just draw the entire box (will
-					  // be stencil-culled). Also note tjunctions avoidance below: this only culled entire cube faces in the first place.
-		{
-			skymins[0][i] = skymins[1][i] = -1;
-			skymaxs[0][i] = skymaxs[1][i] = 1;
-		}
-
-		if (skymins[0][i] >= skymaxs[0][i] || skymins[1][i] >= skymaxs[1][i])
-			continue;
-
 		vkCmdBindDescriptorSets (
-			cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.sky_stencil_pipeline[indirect].layout.handle, 0, 1,
-			&skybox.textures[skytexorder[i]]->descriptor_set, 0, NULL);
+			cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.sky_box_pipeline.layout.handle, 0, 1, &skybox.textures[skytexorder[i]]->descriptor_set,
+			0, NULL);
 
 		VkBuffer	   buffer;
 		VkDeviceSize   buffer_offset;
 		basicvertex_t *vertices = (basicvertex_t *)R_VertexAllocate (4 * sizeof (basicvertex_t), &buffer, &buffer_offset);
 
-#if 1 // FIXME: this is to avoid tjunctions until i can do it the right way
-		skymins[0][i] = -1;
-		skymins[1][i] = -1;
-		skymaxs[0][i] = 1;
-		skymaxs[1][i] = 1;
-#endif
-		Sky_EmitSkyBoxVertex (vertices + 0, skymins[0][i], skymins[1][i], i);
-		Sky_EmitSkyBoxVertex (vertices + 1, skymins[0][i], skymaxs[1][i], i);
-		Sky_EmitSkyBoxVertex (vertices + 2, skymaxs[0][i], skymaxs[1][i], i);
-		Sky_EmitSkyBoxVertex (vertices + 3, skymaxs[0][i], skymins[1][i], i);
+		Sky_EmitSkyBoxVertex (vertices + 0, -1.0f, -1.0f, i);
+		Sky_EmitSkyBoxVertex (vertices + 1, -1.0f, 1.0f, i);
+		Sky_EmitSkyBoxVertex (vertices + 2, 1.0f, 1.0f, i);
+		Sky_EmitSkyBoxVertex (vertices + 3, 1.0f, -1.0f, i);
 
 		vkCmdBindVertexBuffers (cbx->cb, 0, 1, &buffer, &buffer_offset);
 		vkCmdDrawIndexed (cbx->cb, 6, 1, 0, 0, 0);
@@ -1206,24 +1012,12 @@ called once per frame after opaques before transparents, handles world + entitie
 */
 void Sky_DrawSky (cb_context_t *cbx)
 {
-	int i;
-
 	if (r_lightmap_cheatsafe)
 		return;
 
 	R_BeginDebugUtilsLabel (cbx, "Sky");
 
 	const qboolean flat_color = r_fastsky.value || (Fog_GetDensity () > 0 && skyfog >= 1);
-	need_bounds = Sky_NeedStencil ();
-
-	//
-	// reset sky bounds
-	//
-	for (i = 0; i < 6; i++)
-	{
-		skymins[0][i] = skymins[1][i] = FLT_MAX;
-		skymaxs[0][i] = skymaxs[1][i] = -FLT_MAX;
-	}
 
 	float fog_density = (Fog_GetDensity () > 0) ? skyfog : 0.0f;
 
@@ -1244,16 +1038,15 @@ void Sky_DrawSky (cb_context_t *cbx)
 	// Sky_DrawSkyBox then only fills the parts that had stencil written
 	if (flat_color)
 	{
-		if (indirect)
-			constant_values[19] = 1.0f;
-		R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.sky_color_pipeline[indirect]);
+		constant_values[19] = 1.0f; // world vertices have no color, so output the constant color
+		R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.sky_color_pipeline[1]);
 		R_PushConstants (cbx, VK_SHADER_STAGE_ALL_GRAPHICS, 0, 20 * sizeof (float), constant_values);
 	}
 	else if (skybox.cubemap)
 	{
-		R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.sky_cube_pipeline[indirect]);
+		R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.sky_cube_pipeline[1]);
 		vkCmdBindDescriptorSets (
-			cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.sky_cube_pipeline[indirect].layout.handle, 0, 1, &skybox.cubemap->descriptor_set, 0, NULL);
+			cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.sky_cube_pipeline[1].layout.handle, 0, 1, &skybox.cubemap->descriptor_set, 0, NULL);
 		memcpy (&constant_values[20], r_refdef.vieworg, sizeof (r_refdef.vieworg));
 
 		Skywind_UpdateParams (&constant_values[23], &constant_values[24]);
@@ -1267,10 +1060,10 @@ void Sky_DrawSky (cb_context_t *cbx)
 			R_EndDebugUtilsLabel (cbx);
 			return;
 		}
-		R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.sky_layer_pipeline[indirect]);
+		R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.sky_layer_pipeline[1]);
 		VkDescriptorSet descriptor_sets[2] = {solidskytexture->descriptor_set, alphaskytexture->descriptor_set};
 		vkCmdBindDescriptorSets (
-			cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.sky_layer_pipeline[indirect].layout.handle, 0, 2, descriptor_sets, 0, NULL);
+			cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.sky_layer_pipeline[1].layout.handle, 0, 2, descriptor_sets, 0, NULL);
 		memcpy (&constant_values[20], r_refdef.vieworg, sizeof (r_refdef.vieworg));
 		constant_values[23] = cl.time - (int)cl.time / 16 * 16;
 		constant_values[24] = r_skyalpha.value;
@@ -1278,37 +1071,39 @@ void Sky_DrawSky (cb_context_t *cbx)
 	}
 	else
 	{
-		R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.sky_stencil_pipeline[indirect]);
+		R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.sky_stencil_pipeline[1]);
 		R_PushConstants (cbx, VK_SHADER_STAGE_ALL_GRAPHICS, 0, 20 * sizeof (float), constant_values);
 	}
-	vkCmdBindIndexBuffer (cbx->cb, vulkan_globals.fan_index_buffer, 0, VK_INDEX_TYPE_UINT16);
 
 	//
-	// process world and bmodels: draw flat-shaded sky surfs, and update skybounds
+	// process world and bmodels: the world sky surfaces come straight from the bmodel vertex buffer, either
+	// with the indirect draws or as batched index lists
 	//
 	int skypolys = 0;
 	if (indirect)
-	{
 		R_DrawIndirectBrushes (cbx, false, false, true, -1);
+	else
+		Sky_ProcessTextureChains (cbx, &skypolys);
 
-		// Entities cannot use the indirect pipelines
-		vkCmdBindIndexBuffer (cbx->cb, vulkan_globals.fan_index_buffer, 0, VK_INDEX_TYPE_UINT16);
-		if (flat_color)
-			R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.sky_color_pipeline[0]);
-		else if (skybox.cubemap)
-			R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.sky_cube_pipeline[0]);
-		else if (!skybox.name[0])
-			R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.sky_layer_pipeline[0]);
-		else
-			R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.sky_stencil_pipeline[0]);
+	// Entities cannot use the world vertex buffer pipelines
+	vkCmdBindIndexBuffer (cbx->cb, vulkan_globals.fan_index_buffer, 0, VK_INDEX_TYPE_UINT16);
+	if (flat_color)
+	{
+		constant_values[19] = fog_density;
+		R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.sky_color_pipeline[0]);
+		R_PushConstants (cbx, VK_SHADER_STAGE_ALL_GRAPHICS, 0, 20 * sizeof (float), constant_values);
 	}
+	else if (skybox.cubemap)
+		R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.sky_cube_pipeline[0]);
+	else if (!skybox.name[0])
+		R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.sky_layer_pipeline[0]);
 	else
-		Sky_ProcessTextureChains (cbx, color, &skypolys);
+		R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.sky_stencil_pipeline[0]);
 
 	Sky_ProcessEntities (cbx, color);
 
 	//
-	// render slow sky: non-cubemap skybox
+	// render slow sky: non-cubemap skybox, resolved once for all stencil-marked pixels
 	//
 	if (!flat_color && !skybox.cubemap && skybox.name[0])
 	{
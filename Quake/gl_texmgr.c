@@ -51,13 +51,17 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 static cvar_t gl_max_size = {"gl_max_size", "0", CVAR_NONE};
 static cvar_t gl_picmip = {"gl_picmip", "0", CVAR_NONE};
+static cvar_t gl_texturestreaming = {"gl_texturestreaming", "0", CVAR_ARCHIVE};
+static cvar_t gl_texturestreaming_budget = {"gl_texturestreaming_budget", "1024", CVAR_ARCHIVE}; // MB of full size streamed textures
+static cvar_t gl_texturedefrag = {"gl_texturedefrag", "1", CVAR_ARCHIVE};
 
 extern cvar_t vid_filter;
 extern cvar_t vid_anisotropic;
 
 #define MAX_MIPS 16
 static int			numgltextures;
-static gltexture_t *active_gltextures, *free_gltextures;
+static gltexture_t *active_gltextures, *free_gltextures, *free_gltextures_tail;
+static gltexture_t *gltexture_pool; // index into this is the bindless descriptor slot
 gltexture_t		   *notexture, *nulltexture, *whitetexture, *greytexture, *greylightmap, *bluenoisetexture;
 
 unsigned int d_8to24table[256];
@@ -74,6 +78,38 @@ unsigned int d_8to24table_conchars[256];
 static glheap_t	 *texmgr_heap;
 static SDL_Mutex *texmgr_mutex;
 
+// (owner, name) index for TexMgr_FindTexture, each shard of buckets has its own lock so loaders on different workers rarely contend
+#define TEXTURE_HASH_SIZE	8192
+#define TEXTURE_HASH_SHARDS 32
+static gltexture_t *texture_hash[TEXTURE_HASH_SIZE];
+static SDL_Mutex   *texture_hash_mutexes[TEXTURE_HASH_SHARDS];
+
+// Streaming
+#define STREAM_BASE_SIZE	256 // max dimension of streamed textures that are not resident at full size
+#define STREAM_MAX_REQUESTS 4	// reloads decoded in parallel
+#define STREAM_EVICT_FRAMES 300 // frames a texture must go undrawn before it can be evicted
+
+// Defragmentation
+#define DEFRAG_MAX_BYTES_PER_FRAME (8 * 1024 * 1024) // texture bytes copied out of a sparse segment per frame
+
+typedef struct
+{
+	qboolean	   active;
+	task_handle_t  task;
+	gltexture_t	  *glt; // NULL if the texture was freed while decoding
+	qboolean	   full;
+	char		   source_file[MAX_QPATH];
+	unsigned int   path_id;
+	byte		  *data;
+	int			   width;
+	int			   height;
+	enum srcformat format;
+} stream_request_t;
+
+static stream_request_t stream_requests[STREAM_MAX_REQUESTS];
+
+static void TexMgr_CancelStream (gltexture_t *glt);
+
 static byte bluenoise_data[4096] = {
 	0x27, 0x62, 0x08, 0x4C, 0xDE, 0xBA, 0x05, 0xEF, 0x2A, 0xA1, 0xF7, 0x4A, 0x5F, 0x29, 0xE8, 0x34, 0xA9, 0xCB, 0x40, 0x60, 0xD5, 0x87, 0x70, 0xD0, 0x61, 0x8A,
 	0xDF, 0xB2, 0xD8, 0xFA, 0x07, 0x74, 0x31, 0x56, 0x1A, 0x4B, 0xAA, 0x36, 0xD4, 0x16, 0x95, 0x2F, 0x68, 0x8E, 0x77, 0x25, 0x49, 0xE3, 0x12, 0x6C, 0x9F, 0xD7,
@@ -275,6 +311,23 @@ static void TexMgr_SetFilterModes (gltexture_t *glt)
 	texture_write.pImageInfo = &image_info;
 
 	vkUpdateDescriptorSets (vulkan_globals.device, 1, &texture_write, 0, NULL);
+
+	if (vulkan_globals.bindless)
+	{
+		texture_write.dstSet = vulkan_globals.bindless_desc_set;
+		texture_write.dstArrayElement = TexMgr_BindlessIndex (glt);
+		vkUpdateDescriptorSets (vulkan_globals.device, 1, &texture_write, 0, NULL);
+	}
+}
+
+/*
+===============
+TexMgr_BindlessIndex
+===============
+*/
+uint32_t TexMgr_BindlessIndex (gltexture_t *glt)
+{
+	return (uint32_t)(glt - gltexture_pool);
 }
 
 /*
@@ -330,25 +383,84 @@ static void TexMgr_Imagelist_f (void)
 
 /*
 ================
-TexMgr_FindTexture
+TexMgr_HashKey
 ================
 */
-gltexture_t *TexMgr_FindTexture (qmodel_t *owner, const char *name)
+static unsigned int TexMgr_HashKey (qmodel_t *owner, const char *name)
 {
-	SDL_LockMutex (texmgr_mutex);
-	gltexture_t *glt = NULL;
+	return COM_HashString (name) ^ ((unsigned int)((uintptr_t)owner >> 4) * 2654435761u);
+}
+
+/*
+================
+TexMgr_HashTexture
+
+Adds a texture to the (owner, name) index once both are set
+================
+*/
+static void TexMgr_HashTexture (gltexture_t *glt)
+{
+	SDL_Mutex *mutex;
+
+	glt->hash = TexMgr_HashKey (glt->owner, glt->name);
+	mutex = texture_hash_mutexes[glt->hash % TEXTURE_HASH_SHARDS];
+	SDL_LockMutex (mutex);
+	glt->hash_next = texture_hash[glt->hash % TEXTURE_HASH_SIZE];
+	texture_hash[glt->hash % TEXTURE_HASH_SIZE] = glt;
+	glt->hashed = true;
+	SDL_UnlockMutex (mutex);
+}
+
+/*
+================
+TexMgr_UnhashTexture
+================
+*/
+static void TexMgr_UnhashTexture (gltexture_t *glt)
+{
+	SDL_Mutex	 *mutex;
+	gltexture_t **link;
 
-	if (name)
+	if (!glt->hashed)
+		return;
+	mutex = texture_hash_mutexes[glt->hash % TEXTURE_HASH_SHARDS];
+	SDL_LockMutex (mutex);
+	for (link = &texture_hash[glt->hash % TEXTURE_HASH_SIZE]; *link; link = &(*link)->hash_next)
 	{
-		for (glt = active_gltextures; glt; glt = glt->next)
+		if (*link == glt)
 		{
-			if (glt->owner == owner && !strcmp (glt->name, name))
-				goto unlock_mutex;
+			*link = glt->hash_next;
+			break;
 		}
 	}
+	glt->hash_next = NULL;
+	glt->hashed = false;
+	SDL_UnlockMutex (mutex);
+}
 
-unlock_mutex:
-	SDL_UnlockMutex (texmgr_mutex);
+/*
+================
+TexMgr_FindTexture
+================
+*/
+gltexture_t *TexMgr_FindTexture (qmodel_t *owner, const char *name)
+{
+	gltexture_t *glt;
+	unsigned int hash;
+	SDL_Mutex	*mutex;
+
+	if (!name)
+		return NULL;
+
+	hash = TexMgr_HashKey (owner, name);
+	mutex = texture_hash_mutexes[hash % TEXTURE_HASH_SHARDS];
+	SDL_LockMutex (mutex);
+	for (glt = texture_hash[hash % TEXTURE_HASH_SIZE]; glt; glt = glt->hash_next)
+	{
+		if (glt->hash == hash && glt->owner == owner && !strcmp (glt->name, name))
+			break;
+	}
+	SDL_UnlockMutex (mutex);
 	return glt;
 }
 
@@ -364,7 +476,12 @@ gltexture_t *TexMgr_NewTexture (void)
 
 	glt = free_gltextures;
 	free_gltextures = glt->next;
+	if (!free_gltextures)
+		free_gltextures_tail = NULL;
+	glt->prev = NULL;
 	glt->next = active_gltextures;
+	if (active_gltextures)
+		active_gltextures->prev = glt;
 	active_gltextures = glt;
 
 	numgltextures++;
@@ -374,6 +491,26 @@ gltexture_t *TexMgr_NewTexture (void)
 
 static void GL_DeleteTexture (gltexture_t *texture);
 
+/*
+================
+TexMgr_RecycleTexture
+
+Freed textures go to the back of the free list so their bindless slot
+is not rewritten while frames in flight may still sample it
+================
+*/
+static void TexMgr_RecycleTexture (gltexture_t *glt)
+{
+	TexMgr_UnhashTexture (glt);
+	glt->prev = NULL;
+	glt->next = NULL;
+	if (free_gltextures_tail)
+		free_gltextures_tail->next = glt;
+	else
+		free_gltextures = glt;
+	free_gltextures_tail = glt;
+}
+
 /*
 ================
 TexMgr_FreeTexture
@@ -382,7 +519,6 @@ TexMgr_FreeTexture
 void TexMgr_FreeTexture (gltexture_t *kill)
 {
 	SDL_LockMutex (texmgr_mutex);
-	gltexture_t *glt;
 
 	if (kill == NULL)
 	{
@@ -390,32 +526,25 @@ void TexMgr_FreeTexture (gltexture_t *kill)
 		goto unlock_mutex;
 	}
 
-	if (active_gltextures == kill)
+	// the active list is doubly linked, only its head has no prev
+	if (kill->prev == NULL && active_gltextures != kill)
 	{
-		active_gltextures = kill->next;
-		kill->next = free_gltextures;
-		free_gltextures = kill;
-
-		GL_DeleteTexture (kill);
-		numgltextures--;
+		Con_Printf ("TexMgr_FreeTexture: not found\n");
 		goto unlock_mutex;
 	}
 
-	for (glt = active_gltextures; glt; glt = glt->next)
-	{
-		if (glt->next == kill)
-		{
-			glt->next = kill->next;
-			kill->next = free_gltextures;
-			free_gltextures = kill;
+	TexMgr_CancelStream (kill);
 
-			GL_DeleteTexture (kill);
-			numgltextures--;
-			goto unlock_mutex;
-		}
-	}
+	if (kill->prev)
+		kill->prev->next = kill->next;
+	else
+		active_gltextures = kill->next;
+	if (kill->next)
+		kill->next->prev = kill->prev;
+	TexMgr_RecycleTexture (kill);
 
-	Con_Printf ("TexMgr_FreeTexture: not found\n");
+	GL_DeleteTexture (kill);
+	numgltextures--;
 unlock_mutex:
 	SDL_UnlockMutex (texmgr_mutex);
 }
@@ -598,6 +727,8 @@ void TexMgr_LoadPalette (void)
 	// conchars palette, 0 and 255 are transparent
 	memcpy (d_8to24table_conchars, d_8to24table, 256 * 4);
 	((byte *)&d_8to24table_conchars[0])[3] = 0;
+
+	R_UpdatePaletteLUT ();
 }
 
 /*
@@ -702,13 +833,17 @@ void TexMgr_Init (void)
 	extern texture_t *r_notexture_mip, *r_notexture_mip2;
 
 	texmgr_mutex = SDL_CreateMutex ();
+	for (i = 0; i < TEXTURE_HASH_SHARDS; i++)
+		texture_hash_mutexes[i] = SDL_CreateMutex ();
 
 	// init texture list
-	free_gltextures = (gltexture_t *)Mem_Alloc (MAX_GLTEXTURES * sizeof (gltexture_t));
+	gltexture_pool = (gltexture_t *)Mem_Alloc (MAX_GLTEXTURES * sizeof (gltexture_t));
+	free_gltextures = gltexture_pool;
 	active_gltextures = NULL;
 	for (i = 0; i < MAX_GLTEXTURES - 1; i++)
 		free_gltextures[i].next = &free_gltextures[i + 1];
 	free_gltextures[i].next = NULL;
+	free_gltextures_tail = &free_gltextures[i];
 	numgltextures = 0;
 
 	// palette
@@ -716,6 +851,9 @@ void TexMgr_Init (void)
 
 	Cvar_RegisterVariable (&gl_max_size);
 	Cvar_RegisterVariable (&gl_picmip);
+	Cvar_RegisterVariable (&gl_texturestreaming);
+	Cvar_RegisterVariable (&gl_texturestreaming_budget);
+	Cvar_RegisterVariable (&gl_texturedefrag);
 	Cmd_AddCommand ("imagelist", &TexMgr_Imagelist_f);
 
 	// load notexture images
@@ -876,49 +1014,79 @@ static void TexMgr_AlphaEdgeFix (byte *data, int width, int height)
 	}
 }
 
+// Palette expansion gathers 8 entries at a time with AVX2, which is compiled per function and only used if the CPU supports it.
+// SSE2 and NEON have no gather and tables of 256 words don't fit their byte shuffles, those keep the scalar loop.
+#if defined(USE_SSE2)
+#include <immintrin.h>
+#if defined(__GNUC__)
+#define TARGET_AVX2 __attribute__ ((target ("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+
 /*
 ================
-TexMgr_8to32
+TexMgr_HasAVX2
 ================
 */
-static void TexMgr_8to32 (byte *in, unsigned *out, int pixels, unsigned int *usepal)
+static qboolean TexMgr_HasAVX2 (void)
 {
-	for (int i = 0; i < pixels; i++)
-		*out++ = usepal[*in++];
+	static int has_avx2 = -1;
+	if (has_avx2 < 0)
+		has_avx2 = SDL_HasAVX2 () ? 1 : 0;
+	return has_avx2;
 }
 
 /*
 ================
-TexMgr_DeriveNumMips
+TexMgr_8to32AVX2
+
+Returns the number of pixels converted, the caller converts the rest
 ================
 */
-static int TexMgr_DeriveNumMips (int width, int height)
+static TARGET_AVX2 int TexMgr_8to32AVX2 (const byte *in, unsigned *out, int pixels, const unsigned int *usepal)
 {
-	int num_mips = 0;
-	while (width >= 1 && height >= 1)
+	int i;
+	for (i = 0; i + 8 <= pixels; i += 8)
 	{
-		width /= 2;
-		height /= 2;
-		num_mips += 1;
+		const __m256i indices = _mm256_cvtepu8_epi32 (_mm_loadl_epi64 ((const __m128i *)(in + i)));
+		_mm256_storeu_si256 ((__m256i *)(out + i), _mm256_i32gather_epi32 ((const int *)usepal, indices, 4));
 	}
-	return num_mips;
+	return i;
+}
+#endif
+
+/*
+================
+TexMgr_8to32
+================
+*/
+static void TexMgr_8to32 (byte *in, unsigned *out, int pixels, unsigned int *usepal)
+{
+	int i = 0;
+#if defined(USE_SSE2)
+	if (use_simd && TexMgr_HasAVX2 ())
+		i = TexMgr_8to32AVX2 (in, out, pixels, usepal);
+#endif
+	for (; i < pixels; i++)
+		out[i] = usepal[in[i]];
 }
 
 /*
 ================
-TexMgr_DeriveStagingSize
+TexMgr_DeriveNumMips
 ================
 */
-static int TexMgr_DeriveStagingSize (int width, int height)
+static int TexMgr_DeriveNumMips (int width, int height)
 {
-	int size = 0;
+	int num_mips = 0;
 	while (width >= 1 && height >= 1)
 	{
-		size += width * height * 4;
 		width /= 2;
 		height /= 2;
+		num_mips += 1;
 	}
-	return size;
+	return num_mips;
 }
 
 /*
@@ -938,6 +1106,112 @@ static void TexMgr_PreMultiply32 (byte *in, size_t width, size_t height)
 	}
 }
 
+/*
+================
+TexMgr_CopyToStaging32
+
+Copies 32bit data to staging memory in one pass, premultiplying the colors
+on the way. Returns true if detect_alpha is set and any pixel isn't opaque.
+Writes whole pixels, staging memory may be write combined.
+================
+*/
+static qboolean TexMgr_CopyToStaging32 (byte *dest, const byte *src, size_t pixels, qboolean premultiply, qboolean detect_alpha)
+{
+	if (!premultiply && !detect_alpha)
+	{
+		memcpy (dest, src, pixels * 4);
+		return false;
+	}
+
+	uint32_t	   *out = (uint32_t *)dest;
+	const uint32_t *in = (const uint32_t *)src;
+	uint32_t		all_bits = 0xFFFFFFFFu;
+	if (premultiply)
+	{
+		for (size_t i = 0; i < pixels; ++i)
+		{
+			const byte *p = (const byte *)&in[i];
+			const int	a = p[3];
+			byte		q[4] = {(byte)((p[0] * a) >> 8), (byte)((p[1] * a) >> 8), (byte)((p[2] * a) >> 8), (byte)a};
+			memcpy (&out[i], q, 4);
+			all_bits &= in[i];
+		}
+	}
+	else
+	{
+		for (size_t i = 0; i < pixels; ++i)
+		{
+			out[i] = in[i];
+			all_bits &= in[i];
+		}
+	}
+
+	const byte *all = (const byte *)&all_bits;
+	return detect_alpha && (all[3] != 255);
+}
+
+/*
+================
+TexMgr_GenerateMipmaps -- builds the mip chain from mip 0 with linear blits
+
+mip 0 must be in TRANSFER_DST_OPTIMAL, all mips end up in SHADER_READ_ONLY_OPTIMAL
+================
+*/
+static void TexMgr_GenerateMipmaps (VkCommandBuffer command_buffer, gltexture_t *glt, int num_mips)
+{
+	ZEROED_STRUCT (VkImageMemoryBarrier, image_memory_barrier);
+	image_memory_barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	image_memory_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	image_memory_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	image_memory_barrier.image = glt->image;
+	image_memory_barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	image_memory_barrier.subresourceRange.levelCount = 1;
+	image_memory_barrier.subresourceRange.baseArrayLayer = 0;
+	image_memory_barrier.subresourceRange.layerCount = 1;
+
+	for (int i = 1; i < num_mips; i++)
+	{
+		image_memory_barrier.subresourceRange.baseMipLevel = i - 1;
+		image_memory_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		image_memory_barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		image_memory_barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		image_memory_barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		vkCmdPipelineBarrier (command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, NULL, 0, NULL, 1, &image_memory_barrier);
+
+		ZEROED_STRUCT (VkImageBlit, blit);
+		blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		blit.srcSubresource.mipLevel = i - 1;
+		blit.srcSubresource.layerCount = 1;
+		blit.srcOffsets[1].x = q_max (glt->width >> (i - 1), 1);
+		blit.srcOffsets[1].y = q_max (glt->height >> (i - 1), 1);
+		blit.srcOffsets[1].z = 1;
+		blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		blit.dstSubresource.mipLevel = i;
+		blit.dstSubresource.layerCount = 1;
+		blit.dstOffsets[1].x = q_max (glt->width >> i, 1);
+		blit.dstOffsets[1].y = q_max (glt->height >> i, 1);
+		blit.dstOffsets[1].z = 1;
+		vkCmdBlitImage (
+			command_buffer, glt->image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, glt->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+	}
+
+	// all but the last mip were blit sources
+	VkImageMemoryBarrier final_barriers[2] = {image_memory_barrier, image_memory_barrier};
+	final_barriers[0].subresourceRange.baseMipLevel = 0;
+	final_barriers[0].subresourceRange.levelCount = num_mips - 1;
+	final_barriers[0].srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+	final_barriers[0].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	final_barriers[0].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	final_barriers[0].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	final_barriers[1].subresourceRange.baseMipLevel = num_mips - 1;
+	final_barriers[1].subresourceRange.levelCount = 1;
+	final_barriers[1].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	final_barriers[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	final_barriers[1].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	final_barriers[1].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	vkCmdPipelineBarrier (command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, NULL, 0, NULL, 2, final_barriers);
+}
+
 /*
 ================
 TexMgr_LoadImage32 -- handles 32bit source data
@@ -947,10 +1221,6 @@ static void TexMgr_LoadImage32 (gltexture_t *glt, unsigned *data)
 {
 	GL_DeleteTexture (glt);
 
-	// do this before any rescaling
-	if (glt->flags & TEXPREF_PREMULTIPLY)
-		TexMgr_PreMultiply32 ((byte *)data, glt->width, glt->height);
-
 	// mipmap down
 	int picmip = (glt->flags & TEXPREF_NOPICMIP) ? 0 : q_max ((int)gl_picmip.value, 0);
 	int mipwidth = q_max (glt->width >> picmip, 1);
@@ -960,6 +1230,8 @@ static void TexMgr_LoadImage32 (gltexture_t *glt, unsigned *data)
 	int maxsize = (int)(is_cube ? vulkan_globals.device_properties.limits.maxImageDimensionCube : vulkan_globals.device_properties.limits.maxImageDimension2D);
 	if (!(glt->flags & TEXPREF_NOPICMIP) && gl_max_size.value)
 		maxsize = q_min (q_max ((int)gl_max_size.value, 1), maxsize);
+	if ((glt->flags & TEXPREF_STREAM) && !glt->stream_full)
+		maxsize = q_min (STREAM_BASE_SIZE, maxsize);
 	if ((mipwidth > maxsize) || (mipheight > maxsize))
 	{
 		if (mipwidth >= mipheight)
@@ -973,8 +1245,16 @@ static void TexMgr_LoadImage32 (gltexture_t *glt, unsigned *data)
 			mipheight = maxsize;
 		}
 	}
+
+	// Full size images are premultiplied and checked for alpha while they are copied to the staging memory,
+	// rescaled ones need it done before rescaling
+	const qboolean downsample = ((int)glt->width != mipwidth || (int)glt->height != mipheight) && (mipwidth >= 1) && (mipheight >= 1);
+	const qboolean detect_alpha = data && glt->source_format == SRC_RGBA && !(glt->flags & TEXPREF_ALPHAPIXELS);
+	if (downsample && (glt->flags & TEXPREF_PREMULTIPLY))
+		TexMgr_PreMultiply32 ((byte *)data, glt->width, glt->height);
+
 	// has alpha detection :
-	if (data && glt->source_format == SRC_RGBA && !(glt->flags & TEXPREF_ALPHAPIXELS))
+	if (downsample && detect_alpha)
 	{
 		int	  num_pixels = glt->width * glt->height;
 		byte *pixel_data = (byte *)data;
@@ -991,7 +1271,7 @@ static void TexMgr_LoadImage32 (gltexture_t *glt, unsigned *data)
 	}
 	// downsizing according to gl_picmip / gl_max_size: (debug only)
 	// don't attempt to downsize below 1x1
-	if (((int)glt->width != mipwidth || (int)glt->height != mipheight) && (mipwidth >= 1) && (mipheight >= 1))
+	if (downsample)
 	{
 		if (is_cube)
 			for (int i = 0; i < 6; i++)
@@ -1022,6 +1302,10 @@ static void TexMgr_LoadImage32 (gltexture_t *glt, unsigned *data)
 
 	const VkFormat format = surface_indices ? VK_FORMAT_R32_UINT : ten_bit ? VK_FORMAT_A2B10G10R10_UNORM_PACK32 : VK_FORMAT_R8G8B8A8_UNORM;
 
+	// only mip 0 is uploaded, the rest of the chain is blitted from it.
+	// R8G8B8A8_UNORM is required to support linear blits.
+	const qboolean generate_mips = (glt->flags & TEXPREF_MIPMAP) && !is_cube && (format == VK_FORMAT_R8G8B8A8_UNORM) && (num_mips > 1);
+
 	ZEROED_STRUCT (VkImageCreateInfo, image_create_info);
 	image_create_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 	image_create_info.imageType = VK_IMAGE_TYPE_2D;
@@ -1040,9 +1324,11 @@ static void TexMgr_LoadImage32 (gltexture_t *glt, unsigned *data)
 	else if (lightmap)
 		image_create_info.usage = (VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT);
 	else
-		image_create_info.usage = (VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT);
+		image_create_info.usage = (VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT);
 
 	image_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	if (glt->flags & TEXPREF_ASYNCCOMPUTE)
+		SHARE_WITH_ASYNC_COMPUTE (image_create_info);
 	image_create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 	if (is_cube)
 		image_create_info.flags |= VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
@@ -1051,6 +1337,8 @@ static void TexMgr_LoadImage32 (gltexture_t *glt, unsigned *data)
 	if (err != VK_SUCCESS)
 		Sys_Error ("vkCreateImage failed");
 	GL_SetObjectName ((uint64_t)glt->image, VK_OBJECT_TYPE_IMAGE, va ("%s image", glt->name));
+	glt->image_format = image_create_info.format;
+	glt->num_mips = image_create_info.mipLevels;
 
 	VkMemoryRequirements memory_requirements;
 	vkGetImageMemoryRequirements (vulkan_globals.device, glt->image, &memory_requirements);
@@ -1059,6 +1347,8 @@ static void TexMgr_LoadImage32 (gltexture_t *glt, unsigned *data)
 	err = vkBindImageMemory (vulkan_globals.device, glt->image, GL_HeapGetAllocationMemory (glt->allocation), GL_HeapGetAllocationOffset (glt->allocation));
 	if (err != VK_SUCCESS)
 		Sys_Error ("vkBindImageMemory failed");
+	if (lightmap)
+		Atomic_AddUInt64 (&vulkan_memory_category_sizes[VULKAN_MEMORY_CATEGORY_LIGHTMAPS], GL_HeapGetAllocationSize (glt->allocation));
 
 	ZEROED_STRUCT (VkImageViewCreateInfo, image_view_create_info);
 	image_view_create_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -1153,7 +1443,7 @@ static void TexMgr_LoadImage32 (gltexture_t *glt, unsigned *data)
 	// Upload
 	ZEROED_STRUCT_ARRAY (VkBufferImageCopy, regions, MAX_MIPS);
 
-	int staging_size = (glt->flags & TEXPREF_MIPMAP) ? TexMgr_DeriveStagingSize (mipwidth, mipheight) : (mipwidth * mipheight * 4);
+	int staging_size = mipwidth * mipheight * 4;
 	if (is_cube)
 		staging_size *= 6;
 
@@ -1162,32 +1452,7 @@ static void TexMgr_LoadImage32 (gltexture_t *glt, unsigned *data)
 	int				staging_offset;
 	unsigned char  *staging_memory = R_StagingAllocate (staging_size, 4, &command_buffer, &staging_buffer, &staging_offset);
 
-	int num_regions = 0;
-
-	if (glt->flags & TEXPREF_MIPMAP)
-	{
-		int mip_offset = 0;
-		mipwidth = glt->width;
-		mipheight = glt->height;
-
-		while (mipwidth >= 1 && mipheight >= 1)
-		{
-			regions[num_regions].bufferOffset = staging_offset + mip_offset;
-			regions[num_regions].imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-			regions[num_regions].imageSubresource.layerCount = 1;
-			regions[num_regions].imageSubresource.mipLevel = num_regions;
-			regions[num_regions].imageExtent.width = mipwidth;
-			regions[num_regions].imageExtent.height = mipheight;
-			regions[num_regions].imageExtent.depth = 1;
-
-			mip_offset += mipwidth * mipheight * 4;
-			num_regions += 1;
-
-			mipwidth /= 2;
-			mipheight /= 2;
-		}
-	}
-	else if (is_cube)
+	if (is_cube)
 	{
 		for (int i = 0; i < 6; i++)
 		{
@@ -1229,36 +1494,22 @@ static void TexMgr_LoadImage32 (gltexture_t *glt, unsigned *data)
 	image_memory_barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
 	vkCmdPipelineBarrier (command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, NULL, 0, NULL, 1, &image_memory_barrier);
 
-	vkCmdCopyBufferToImage (command_buffer, staging_buffer, glt->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, num_mips * (is_cube ? 6 : 1), regions);
+	vkCmdCopyBufferToImage (command_buffer, staging_buffer, glt->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, is_cube ? 6 : 1, regions);
 
-	image_memory_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-	image_memory_barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-	image_memory_barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-	image_memory_barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-	vkCmdPipelineBarrier (command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, NULL, 0, NULL, 1, &image_memory_barrier);
-
-	R_StagingBeginCopy ();
-	if (glt->flags & TEXPREF_MIPMAP)
+	if (generate_mips)
+		TexMgr_GenerateMipmaps (command_buffer, glt, num_mips);
+	else
 	{
-		int mip_offset = 0;
-		mipwidth = glt->width;
-		mipheight = glt->height;
-
-		while (mipwidth >= 1 && mipheight >= 1)
-		{
-			memcpy (staging_memory + mip_offset, data, mipwidth * mipheight * 4);
-
-			mip_offset += mipwidth * mipheight * 4;
-			num_regions += 1;
-
-			if (mipwidth > 1 && mipheight > 1)
-				TexMgr_Downsample (data, mipwidth, mipheight, mipwidth / 2, mipheight / 2);
-
-			mipwidth /= 2;
-			mipheight /= 2;
-		}
+		image_memory_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		image_memory_barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		image_memory_barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		image_memory_barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		vkCmdPipelineBarrier (
+			command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, NULL, 0, NULL, 1, &image_memory_barrier);
 	}
-	else if (is_cube)
+
+	R_StagingBeginCopy ();
+	if (is_cube)
 	{
 		const int reorder[] = {3, 1, 4, 5, 0, 2};
 		staging_size /= 6;
@@ -1268,7 +1519,11 @@ static void TexMgr_LoadImage32 (gltexture_t *glt, unsigned *data)
 	else
 	{
 		if (!ten_bit)
-			memcpy (staging_memory, data, staging_size);
+		{
+			const qboolean premultiply = !downsample && (glt->flags & TEXPREF_PREMULTIPLY);
+			if (TexMgr_CopyToStaging32 (staging_memory, (const byte *)data, mipwidth * mipheight, premultiply, !downsample && detect_alpha))
+				glt->flags |= TEXPREF_ALPHA | TEXPREF_ALPHAPIXELS;
+		}
 		else
 			for (byte *p = (byte *)data; p < (byte *)data + staging_size; p += 4, staging_memory += 4)
 				*(unsigned *)staging_memory = p[0] | p[1] << 10 | p[2] << 20;
@@ -1276,6 +1531,147 @@ static void TexMgr_LoadImage32 (gltexture_t *glt, unsigned *data)
 	R_StagingEndCopy ();
 }
 
+COMPILE_TIME_ASSERT (compressed_mips, MAX_COMPRESSED_MIPS <= MAX_MIPS);
+
+/*
+================
+TexMgr_LoadCompressed -- handles pre-compressed mip chains, copied to the image as is
+================
+*/
+static void TexMgr_LoadCompressed (gltexture_t *glt, compressed_image_t *image)
+{
+	GL_DeleteTexture (glt);
+
+	// gl_picmip / gl_max_size drop whole mips since the blocks can't be resampled
+	int picmip = (glt->flags & TEXPREF_NOPICMIP) ? 0 : q_max ((int)gl_picmip.value, 0);
+	int maxsize = (int)vulkan_globals.device_properties.limits.maxImageDimension2D;
+	if (!(glt->flags & TEXPREF_NOPICMIP) && gl_max_size.value)
+		maxsize = q_min (q_max ((int)gl_max_size.value, 1), maxsize);
+	int first_mip = 0;
+	while ((first_mip + 1) < (int)image->num_mips &&
+		   (first_mip < picmip || q_max ((int)glt->width >> first_mip, 1) > maxsize || q_max ((int)glt->height >> first_mip, 1) > maxsize))
+		first_mip += 1;
+	glt->width = q_max (glt->width >> first_mip, 1);
+	glt->height = q_max (glt->height >> first_mip, 1);
+	const int num_mips = (glt->flags & TEXPREF_MIPMAP) ? (int)image->num_mips - first_mip : 1;
+
+	SDL_LockMutex (texmgr_mutex);
+
+	VkResult err;
+
+	ZEROED_STRUCT (VkImageCreateInfo, image_create_info);
+	image_create_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	image_create_info.imageType = VK_IMAGE_TYPE_2D;
+	image_create_info.format = image->format;
+	image_create_info.extent.width = glt->width;
+	image_create_info.extent.height = glt->height;
+	image_create_info.extent.depth = 1;
+	image_create_info.mipLevels = num_mips;
+	image_create_info.arrayLayers = 1;
+	image_create_info.samples = VK_SAMPLE_COUNT_1_BIT;
+	image_create_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+	image_create_info.usage = (VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT);
+	image_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	image_create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+	err = vkCreateImage (vulkan_globals.device, &image_create_info, NULL, &glt->image);
+	if (err != VK_SUCCESS)
+		Sys_Error ("vkCreateImage failed");
+	GL_SetObjectName ((uint64_t)glt->image, VK_OBJECT_TYPE_IMAGE, va ("%s image", glt->name));
+	glt->image_format = image_create_info.format;
+	glt->num_mips = image_create_info.mipLevels;
+
+	VkMemoryRequirements memory_requirements;
+	vkGetImageMemoryRequirements (vulkan_globals.device, glt->image, &memory_requirements);
+
+	glt->allocation = GL_HeapAllocate (texmgr_heap, memory_requirements.size, memory_requirements.alignment, &num_vulkan_tex_allocations);
+	err = vkBindImageMemory (vulkan_globals.device, glt->image, GL_HeapGetAllocationMemory (glt->allocation), GL_HeapGetAllocationOffset (glt->allocation));
+	if (err != VK_SUCCESS)
+		Sys_Error ("vkBindImageMemory failed");
+
+	ZEROED_STRUCT (VkImageViewCreateInfo, image_view_create_info);
+	image_view_create_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	image_view_create_info.image = glt->image;
+	image_view_create_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+	image_view_create_info.format = image->format;
+	image_view_create_info.components.r = VK_COMPONENT_SWIZZLE_R;
+	image_view_create_info.components.g = VK_COMPONENT_SWIZZLE_G;
+	image_view_create_info.components.b = VK_COMPONENT_SWIZZLE_B;
+	image_view_create_info.components.a = VK_COMPONENT_SWIZZLE_A;
+	image_view_create_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	image_view_create_info.subresourceRange.baseMipLevel = 0;
+	image_view_create_info.subresourceRange.levelCount = num_mips;
+	image_view_create_info.subresourceRange.baseArrayLayer = 0;
+	image_view_create_info.subresourceRange.layerCount = 1;
+
+	err = vkCreateImageView (vulkan_globals.device, &image_view_create_info, NULL, &glt->image_view);
+	if (err != VK_SUCCESS)
+		Sys_Error ("vkCreateImageView failed");
+	GL_SetObjectName ((uint64_t)glt->image_view, VK_OBJECT_TYPE_IMAGE_VIEW, va ("%s image view", glt->name));
+
+	// Allocate and update descriptor for this texture
+	glt->descriptor_set = R_AllocateDescriptorSet (&vulkan_globals.single_texture_set_layout);
+	GL_SetObjectName ((uint64_t)glt->descriptor_set, VK_OBJECT_TYPE_DESCRIPTOR_SET, va ("%s desc set", glt->name));
+
+	TexMgr_SetFilterModes (glt);
+
+	glt->target_image_view = VK_NULL_HANDLE;
+	glt->storage_descriptor_set = VK_NULL_HANDLE;
+	glt->frame_buffer = VK_NULL_HANDLE;
+
+	SDL_UnlockMutex (texmgr_mutex);
+
+	// Upload, mip offsets stay multiples of the block size so the staging alignment carries over
+	ZEROED_STRUCT_ARRAY (VkBufferImageCopy, regions, MAX_MIPS);
+
+	const uint32_t	base_offset = image->mip_offsets[first_mip];
+	const uint32_t	staging_size = image->mip_offsets[first_mip + num_mips - 1] + image->mip_sizes[first_mip + num_mips - 1] - base_offset;
+	VkBuffer		staging_buffer;
+	VkCommandBuffer command_buffer;
+	int				staging_offset;
+	unsigned char  *staging_memory = R_StagingAllocate (staging_size, 16, &command_buffer, &staging_buffer, &staging_offset);
+
+	for (int i = 0; i < num_mips; i++)
+	{
+		regions[i].bufferOffset = staging_offset + image->mip_offsets[first_mip + i] - base_offset;
+		regions[i].imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		regions[i].imageSubresource.layerCount = 1;
+		regions[i].imageSubresource.mipLevel = i;
+		regions[i].imageExtent.width = q_max (glt->width >> i, 1);
+		regions[i].imageExtent.height = q_max (glt->height >> i, 1);
+		regions[i].imageExtent.depth = 1;
+	}
+
+	ZEROED_STRUCT (VkImageMemoryBarrier, image_memory_barrier);
+	image_memory_barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	image_memory_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	image_memory_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	image_memory_barrier.image = glt->image;
+	image_memory_barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	image_memory_barrier.subresourceRange.baseMipLevel = 0;
+	image_memory_barrier.subresourceRange.levelCount = num_mips;
+	image_memory_barrier.subresourceRange.baseArrayLayer = 0;
+	image_memory_barrier.subresourceRange.layerCount = 1;
+
+	image_memory_barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	image_memory_barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	image_memory_barrier.srcAccessMask = 0;
+	image_memory_barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	vkCmdPipelineBarrier (command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, NULL, 0, NULL, 1, &image_memory_barrier);
+
+	vkCmdCopyBufferToImage (command_buffer, staging_buffer, glt->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, num_mips, regions);
+
+	image_memory_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	image_memory_barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	image_memory_barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	image_memory_barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	vkCmdPipelineBarrier (command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, NULL, 0, NULL, 1, &image_memory_barrier);
+
+	R_StagingBeginCopy ();
+	memcpy (staging_memory, image->data + base_offset, staging_size);
+	R_StagingEndCopy ();
+}
+
 /*
 ================
 TexMgr_LoadImage8 -- handles 8bit source data, then passes it to LoadImage32
@@ -1408,6 +1804,9 @@ gltexture_t *TexMgr_LoadImage (
 		case SRC_RGBA:
 			crc = CRC_Block (data, width * height * 4);
 			break;
+		case SRC_COMPRESSED:
+			crc = CRC_Block (data, sizeof (compressed_image_t) + ((compressed_image_t *)data)->size);
+			break;
 		default: /* not reachable but avoids compiler warnings */
 			crc = 0;
 		}
@@ -1419,6 +1818,10 @@ gltexture_t *TexMgr_LoadImage (
 	else
 		glt = TexMgr_NewTexture ();
 
+	// pre-compressed mip chains can't be resampled or decoded at a reduced size
+	if (format == SRC_COMPRESSED)
+		flags &= ~(TEXPREF_STREAM | TEXPREF_PREMULTIPLY);
+
 	// copy data
 	glt->owner = owner;
 	q_strlcpy (glt->name, name, sizeof (glt->name));
@@ -1434,6 +1837,11 @@ gltexture_t *TexMgr_LoadImage (
 	glt->source_width = width;
 	glt->source_height = height;
 	glt->source_crc = crc;
+	if (!glt->hashed)
+		TexMgr_HashTexture (glt);
+	TexMgr_CancelStream (glt);
+	glt->stream_full = !gl_texturestreaming.value;
+	glt->visframe = 0;
 
 	// upload it
 	switch (glt->source_format)
@@ -1452,6 +1860,9 @@ gltexture_t *TexMgr_LoadImage (
 	case SRC_INDEXED_PALETTE:
 		TexMgr_LoadImage8Valve (glt, data);
 		break;
+	case SRC_COMPRESSED:
+		TexMgr_LoadCompressed (glt, (compressed_image_t *)data);
+		break;
 	}
 
 	return glt;
@@ -1497,15 +1908,19 @@ void TexMgr_ReloadImage (gltexture_t *glt, int shirt, int pants)
 		{
 			size *= LIGHTMAP_BYTES;
 		}
-		allocated = data = (byte *)Mem_Alloc (size);
+		allocated = data = (byte *)Mem_AllocTagged (size, MEM_TAG_TEXTURE);
 		if (fread (data, 1, size, f) != size)
 			goto invalid;
 		fclose (f);
 	}
 	else if (glt->source_file[0] && !glt->source_offset)
 	{
-		allocated = data =
-			Image_LoadImage (glt->source_file, (int *)&glt->source_width, (int *)&glt->source_height, &glt->source_format, glt->path_id); // simple file
+		if (glt->source_format == SRC_COMPRESSED)
+			allocated = data = Image_LoadCompressedImage (
+				glt->source_file, (int *)&glt->source_width, (int *)&glt->source_height, &glt->source_format, glt->path_id);
+		if (!data)
+			allocated = data = Image_LoadImage (
+				glt->source_file, (int *)&glt->source_width, (int *)&glt->source_height, &glt->source_format, glt->path_id); // simple file
 	}
 	else if (!glt->source_file[0] && glt->source_offset)
 	{
@@ -1567,7 +1982,7 @@ void TexMgr_ReloadImage (gltexture_t *glt, int shirt, int pants)
 
 		// translate texture
 		size = glt->width * glt->height;
-		dst = translated = (byte *)Mem_Alloc (size);
+		dst = translated = (byte *)Mem_AllocTagged (size, MEM_TAG_TEXTURE);
 		src = data;
 
 		for (i = 0; i < size; i++)
@@ -1594,6 +2009,9 @@ void TexMgr_ReloadImage (gltexture_t *glt, int shirt, int pants)
 	case SRC_INDEXED_PALETTE:
 		TexMgr_LoadImage8Valve (glt, data);
 		break;
+	case SRC_COMPRESSED:
+		TexMgr_LoadCompressed (glt, (compressed_image_t *)data);
+		break;
 	}
 
 	Mem_Free (translated);
@@ -1614,6 +2032,326 @@ void TexMgr_ReloadNobrightImages (void)
 			TexMgr_ReloadImage (glt, -1, -1);
 }
 
+/*
+================================================================================
+
+	TEXTURE STREAMING
+
+================================================================================
+*/
+
+/*
+================
+TexMgr_StreamSize -- estimated size of a mipmapped texture
+================
+*/
+static size_t TexMgr_StreamSize (unsigned int width, unsigned int height)
+{
+	return (size_t)width * height * 4 * 4 / 3;
+}
+
+/*
+================
+TexMgr_CancelStream -- forgets a pending reload, its decoded data is dropped when it completes
+================
+*/
+static void TexMgr_CancelStream (gltexture_t *glt)
+{
+	if (!glt->stream_pending)
+		return;
+	for (int i = 0; i < STREAM_MAX_REQUESTS; ++i)
+		if (stream_requests[i].active && stream_requests[i].glt == glt)
+			stream_requests[i].glt = NULL;
+	glt->stream_pending = false;
+}
+
+/*
+================
+TexMgr_StreamLoadTask
+================
+*/
+static void TexMgr_StreamLoadTask (stream_request_t **request_ptr)
+{
+	stream_request_t *request = *request_ptr;
+	request->data = Image_LoadImage (request->source_file, &request->width, &request->height, &request->format, request->path_id);
+}
+
+/*
+================
+TexMgr_StreamRequest -- starts decoding the source image of a texture on a worker
+================
+*/
+static qboolean TexMgr_StreamRequest (gltexture_t *glt, qboolean full)
+{
+	for (int i = 0; i < STREAM_MAX_REQUESTS; ++i)
+	{
+		stream_request_t *request = &stream_requests[i];
+		if (request->active)
+			continue;
+
+		request->active = true;
+		request->glt = glt;
+		request->full = full;
+		q_strlcpy (request->source_file, glt->source_file, sizeof (request->source_file));
+		request->path_id = glt->path_id;
+		request->data = NULL;
+		glt->stream_pending = true;
+		request->task = Task_AllocateAssignBackgroundFuncAndSubmit ((task_func_t)TexMgr_StreamLoadTask, &request, sizeof (stream_request_t *));
+		return true;
+	}
+	return false;
+}
+
+/*
+================
+TexMgr_StreamTextures
+
+Uploads finished reloads, then requests full size reloads of drawn TEXPREF_STREAM textures
+and evicts the least recently drawn ones back to STREAM_BASE_SIZE while over budget.
+Device memory pressure reported by R_MemoryBudgetExceeded also evicts and holds back reloads.
+Called on the main thread before the frame's rendering tasks are created.
+================
+*/
+void TexMgr_StreamTextures (void)
+{
+	SDL_LockMutex (texmgr_mutex);
+
+	for (int i = 0; i < STREAM_MAX_REQUESTS; ++i)
+	{
+		stream_request_t *request = &stream_requests[i];
+		if (!request->active || !Task_Join (request->task, 0))
+			continue;
+
+		gltexture_t *glt = request->glt;
+		if (glt)
+		{
+			glt->stream_pending = false;
+			if (request->data && (request->format == SRC_RGBA) && (request->width == (int)glt->source_width) &&
+				(request->height == (int)glt->source_height))
+			{
+				glt->width = glt->source_width;
+				glt->height = glt->source_height;
+				glt->stream_full = request->full;
+				TexMgr_LoadImage32 (glt, (unsigned *)request->data);
+			}
+			else
+				glt->flags &= ~TEXPREF_STREAM; // source changed or vanished, keep what is resident
+		}
+		Mem_Free (request->data);
+		request->active = false;
+	}
+
+	const qboolean streaming = gl_texturestreaming.value != 0.0f;
+	const qboolean pressure = streaming && R_MemoryBudgetExceeded ();
+	const size_t   budget = (size_t)q_max (gl_texturestreaming_budget.value, 0.0f) * 1024 * 1024;
+	size_t		   resident = 0;
+	gltexture_t	  *evict = NULL;
+	for (gltexture_t *glt = active_gltextures; glt; glt = glt->next)
+	{
+		if (!(glt->flags & TEXPREF_STREAM) || !glt->stream_full)
+			continue;
+		resident += TexMgr_StreamSize (glt->width, glt->height);
+		if (!glt->stream_pending && ((r_framecount - glt->visframe) > STREAM_EVICT_FRAMES) && (!evict || (glt->visframe < evict->visframe)))
+			evict = glt;
+	}
+
+	if (streaming && ((budget && (resident > budget)) || pressure) && evict)
+		TexMgr_StreamRequest (evict, false);
+
+	// with streaming turned off every reduced texture is brought back to full size
+	for (gltexture_t *glt = active_gltextures; glt; glt = glt->next)
+	{
+		if (!(glt->flags & TEXPREF_STREAM) || glt->stream_full || glt->stream_pending)
+			continue;
+		if (streaming && (pressure || ((r_framecount - glt->visframe) > 1)))
+			continue;
+		const size_t size = TexMgr_StreamSize (glt->source_width, glt->source_height);
+		if (streaming && budget && ((resident + size) > budget))
+			continue;
+		if (!TexMgr_StreamRequest (glt, true))
+			break;
+		resident += size;
+	}
+
+	SDL_UnlockMutex (texmgr_mutex);
+}
+
+/*
+================================================================================
+
+	HEAP DEFRAGMENTATION
+
+================================================================================
+*/
+
+/*
+================
+TexMgr_CanRelocate -- textures whose image or views are referenced outside of their descriptor set stay put
+================
+*/
+static qboolean TexMgr_CanRelocate (gltexture_t *glt)
+{
+	return !(glt->flags & TEXPREF_WARPIMAGE) && (glt->source_format != SRC_LIGHTMAP) && (glt->source_format != SRC_SURF_INDICES) &&
+		   (glt != bluenoisetexture);
+}
+
+/*
+================
+TexMgr_RelocateTexture -- copies the texture into a new image outside of the defrag segment, returns the bytes moved
+================
+*/
+static VkDeviceSize TexMgr_RelocateTexture (gltexture_t *glt)
+{
+	const qboolean is_cube = glt->source_format == SRC_RGBA_CUBEMAP;
+	const uint32_t num_layers = is_cube ? 6 : 1;
+	gltexture_t	   old_texture = *glt;
+	VkResult	   err;
+
+	ZEROED_STRUCT (VkImageCreateInfo, image_create_info);
+	image_create_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	image_create_info.imageType = VK_IMAGE_TYPE_2D;
+	image_create_info.format = glt->image_format;
+	image_create_info.extent.width = glt->width;
+	image_create_info.extent.height = glt->height;
+	image_create_info.extent.depth = 1;
+	image_create_info.mipLevels = glt->num_mips;
+	image_create_info.arrayLayers = num_layers;
+	image_create_info.samples = VK_SAMPLE_COUNT_1_BIT;
+	image_create_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+	image_create_info.usage = (VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT);
+	image_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	image_create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	if (is_cube)
+		image_create_info.flags |= VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
+
+	err = vkCreateImage (vulkan_globals.device, &image_create_info, NULL, &glt->image);
+	if (err != VK_SUCCESS)
+		Sys_Error ("vkCreateImage failed");
+	GL_SetObjectName ((uint64_t)glt->image, VK_OBJECT_TYPE_IMAGE, va ("%s image", glt->name));
+
+	VkMemoryRequirements memory_requirements;
+	vkGetImageMemoryRequirements (vulkan_globals.device, glt->image, &memory_requirements);
+
+	glt->allocation = GL_HeapAllocate (texmgr_heap, memory_requirements.size, memory_requirements.alignment, &num_vulkan_tex_allocations);
+	err = vkBindImageMemory (vulkan_globals.device, glt->image, GL_HeapGetAllocationMemory (glt->allocation), GL_HeapGetAllocationOffset (glt->allocation));
+	if (err != VK_SUCCESS)
+		Sys_Error ("vkBindImageMemory failed");
+
+	ZEROED_STRUCT (VkImageViewCreateInfo, image_view_create_info);
+	image_view_create_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	image_view_create_info.image = glt->image;
+	image_view_create_info.viewType = is_cube ? VK_IMAGE_VIEW_TYPE_CUBE : VK_IMAGE_VIEW_TYPE_2D;
+	image_view_create_info.format = glt->image_format;
+	image_view_create_info.components.r = VK_COMPONENT_SWIZZLE_R;
+	image_view_create_info.components.g = VK_COMPONENT_SWIZZLE_G;
+	image_view_create_info.components.b = VK_COMPONENT_SWIZZLE_B;
+	image_view_create_info.components.a = VK_COMPONENT_SWIZZLE_A;
+	image_view_create_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	image_view_create_info.subresourceRange.baseMipLevel = 0;
+	image_view_create_info.subresourceRange.levelCount = glt->num_mips;
+	image_view_create_info.subresourceRange.baseArrayLayer = 0;
+	image_view_create_info.subresourceRange.layerCount = num_layers;
+
+	err = vkCreateImageView (vulkan_globals.device, &image_view_create_info, NULL, &glt->image_view);
+	if (err != VK_SUCCESS)
+		Sys_Error ("vkCreateImageView failed");
+	GL_SetObjectName ((uint64_t)glt->image_view, VK_OBJECT_TYPE_IMAGE_VIEW, va ("%s image view", glt->name));
+
+	// The old descriptor set may still be bound by frames in flight, so the new image gets its own
+	glt->descriptor_set = R_AllocateDescriptorSet (&vulkan_globals.single_texture_set_layout);
+	GL_SetObjectName ((uint64_t)glt->descriptor_set, VK_OBJECT_TYPE_DESCRIPTOR_SET, va ("%s desc set", glt->name));
+	TexMgr_SetFilterModes (glt);
+
+	// Copy on the staging command buffer, it's submitted ahead of this frame's rendering
+	VkCommandBuffer command_buffer;
+	R_StagingAllocate (0, 1, &command_buffer, NULL, NULL);
+
+	ZEROED_STRUCT_ARRAY (VkImageMemoryBarrier, image_memory_barriers, 2);
+	for (int i = 0; i < 2; ++i)
+	{
+		image_memory_barriers[i].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		image_memory_barriers[i].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		image_memory_barriers[i].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		image_memory_barriers[i].subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		image_memory_barriers[i].subresourceRange.levelCount = glt->num_mips;
+		image_memory_barriers[i].subresourceRange.layerCount = num_layers;
+	}
+	image_memory_barriers[0].image = old_texture.image;
+	image_memory_barriers[0].oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	image_memory_barriers[0].newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	image_memory_barriers[0].srcAccessMask = 0;
+	image_memory_barriers[0].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+	image_memory_barriers[1].image = glt->image;
+	image_memory_barriers[1].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	image_memory_barriers[1].newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	image_memory_barriers[1].srcAccessMask = 0;
+	image_memory_barriers[1].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	// Earlier frames on this queue may still be sampling the old image
+	vkCmdPipelineBarrier (command_buffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, NULL, 0, NULL, 2, image_memory_barriers);
+
+	ZEROED_STRUCT_ARRAY (VkImageCopy, regions, MAX_MIPS);
+	for (int i = 0; i < glt->num_mips; ++i)
+	{
+		regions[i].srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		regions[i].srcSubresource.mipLevel = i;
+		regions[i].srcSubresource.layerCount = num_layers;
+		regions[i].dstSubresource = regions[i].srcSubresource;
+		regions[i].extent.width = q_max (glt->width >> i, 1);
+		regions[i].extent.height = q_max (glt->height >> i, 1);
+		regions[i].extent.depth = 1;
+	}
+	vkCmdCopyImage (
+		command_buffer, old_texture.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, glt->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, glt->num_mips, regions);
+
+	image_memory_barriers[1].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	image_memory_barriers[1].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	image_memory_barriers[1].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	image_memory_barriers[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	vkCmdPipelineBarrier (
+		command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, NULL, 0, NULL, 1,
+		&image_memory_barriers[1]);
+
+	R_StagingBeginCopy ();
+	R_StagingEndCopy ();
+
+	// Deferred until the GPU is done with it, the segment is released with the last allocation
+	GL_DeleteTexture (&old_texture);
+	return memory_requirements.size;
+}
+
+/*
+================
+TexMgr_Defragment -- moves textures out of a sparsely used heap segment so that its device memory can be released
+================
+*/
+void TexMgr_Defragment (void)
+{
+	if (!gl_texturedefrag.value || !texmgr_heap)
+		return;
+
+	SDL_LockMutex (texmgr_mutex);
+	if (GL_HeapUpdateDefrag (texmgr_heap))
+	{
+		gltexture_t *glt;
+		for (glt = active_gltextures; glt; glt = glt->next)
+		{
+			if (glt->allocation && GL_HeapShouldRelocate (texmgr_heap, glt->allocation) && !TexMgr_CanRelocate (glt))
+			{
+				GL_HeapCancelDefrag (texmgr_heap);
+				break;
+			}
+		}
+
+		VkDeviceSize budget = (VkDeviceSize)DEFRAG_MAX_BYTES_PER_FRAME;
+		for (glt = active_gltextures; glt && (budget > 0); glt = glt->next)
+		{
+			if (glt->allocation && GL_HeapShouldRelocate (texmgr_heap, glt->allocation))
+				budget -= q_min (budget, TexMgr_RelocateTexture (glt));
+		}
+	}
+	SDL_UnlockMutex (texmgr_mutex);
+}
+
 /*
 ================================================================================
 
@@ -1633,28 +2371,27 @@ typedef struct
 	glheapallocation_t *allocation;
 } texture_garbage_t;
 
-static int				 current_garbage_index;
-static int				 num_garbage_textures[2];
-static texture_garbage_t texture_garbage[MAX_GLTEXTURES][2];
+static garbage_queue_t texture_garbage = {NULL, NULL, sizeof (texture_garbage_t)};
 
 /*
 ================
 TexMgr_CollectGarbage
+
+Destroys at most R_GarbageBudget textures per frame so deleting many
+textures at once doesn't make a single frame slow
 ================
 */
 void TexMgr_CollectGarbage (void)
 {
 	SDL_LockMutex (texmgr_mutex);
 
-	int				   num;
-	int				   i;
-	texture_garbage_t *garbage;
+	const int budget = R_GarbageBudget (&texture_garbage);
+	int		  num = 0;
+	TEMP_ALLOC (glheapallocation_t *, allocations, q_max (budget, 1));
 
-	current_garbage_index = (current_garbage_index + 1) % 2;
-	num = num_garbage_textures[current_garbage_index];
-	for (i = 0; i < num; ++i)
+	texture_garbage_t *garbage;
+	while ((num < budget) && ((garbage = R_PopGarbage (&texture_garbage)) != NULL))
 	{
-		garbage = &texture_garbage[i][current_garbage_index];
 		if (garbage->frame_buffer != VK_NULL_HANDLE)
 			vkDestroyFramebuffer (vulkan_globals.device, garbage->frame_buffer, NULL);
 		if (garbage->target_image_view)
@@ -1663,12 +2400,12 @@ void TexMgr_CollectGarbage (void)
 		vkDestroyImage (vulkan_globals.device, garbage->image, NULL);
 		R_FreeDescriptorSet (garbage->descriptor_set, &vulkan_globals.single_texture_set_layout);
 		if (garbage->storage_descriptor_set)
-			R_FreeDescriptorSet (garbage->descriptor_set, &vulkan_globals.single_texture_cs_write_set_layout);
-
-		GL_HeapFree (texmgr_heap, garbage->allocation, &num_vulkan_tex_allocations);
+			R_FreeDescriptorSet (garbage->storage_descriptor_set, &vulkan_globals.single_texture_cs_write_set_layout);
+		allocations[num++] = garbage->allocation;
 	}
-	num_garbage_textures[current_garbage_index] = 0;
+	GL_HeapFreeBatch (texmgr_heap, allocations, num, &num_vulkan_tex_allocations);
 
+	TEMP_FREE (allocations);
 	SDL_UnlockMutex (texmgr_mutex);
 }
 
@@ -1681,23 +2418,24 @@ static void GL_DeleteTexture (gltexture_t *texture)
 {
 	SDL_LockMutex (texmgr_mutex);
 
-	int				   garbage_index;
-	texture_garbage_t *garbage;
+	texture_garbage_t garbage;
 
 	if (texture->image_view == VK_NULL_HANDLE)
 		goto mutex_unlock;
 
+	if (texture->source_format == SRC_LIGHTMAP)
+		Atomic_SubUInt64 (&vulkan_memory_category_sizes[VULKAN_MEMORY_CATEGORY_LIGHTMAPS], GL_HeapGetAllocationSize (texture->allocation));
+
 	if (in_update_screen)
 	{
-		garbage_index = num_garbage_textures[current_garbage_index]++;
-		garbage = &texture_garbage[garbage_index][current_garbage_index];
-		garbage->image = texture->image;
-		garbage->target_image_view = texture->target_image_view;
-		garbage->image_view = texture->image_view;
-		garbage->frame_buffer = texture->frame_buffer;
-		garbage->descriptor_set = texture->descriptor_set;
-		garbage->storage_descriptor_set = texture->storage_descriptor_set;
-		garbage->allocation = texture->allocation;
+		garbage.image = texture->image;
+		garbage.target_image_view = texture->target_image_view;
+		garbage.image_view = texture->image_view;
+		garbage.frame_buffer = texture->frame_buffer;
+		garbage.descriptor_set = texture->descriptor_set;
+		garbage.storage_descriptor_set = texture->storage_descriptor_set;
+		garbage.allocation = texture->allocation;
+		R_PushGarbage (&texture_garbage, &garbage);
 	}
 	else
 	{
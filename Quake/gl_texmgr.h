@@ -46,6 +46,8 @@ typedef enum
 	TEXPREF_WARPIMAGE       = 0x0800,   // resize this texture when warpimagesize changes
 	TEXPREF_PREMULTIPLY     = 0x1000,   // rgb = rgb*a; a=a;
 	TEXPREF_ALPHAPIXELS     = 0x2000,   // has demonstratable alpha pixels, mostly used for md3/md5
+	TEXPREF_STREAM          = 0x4000,   // external image, loaded at reduced size until drawn when gl_texturestreaming is on
+	TEXPREF_ASYNCCOMPUTE    = 0x8000,   // also accessed by the async compute queue
 } textureflags_t;
 // clang-format on
 
@@ -57,6 +59,7 @@ enum srcformat
 	SRC_SURF_INDICES,
 	SRC_RGBA_CUBEMAP,
 	SRC_INDEXED_PALETTE,
+	SRC_COMPRESSED, // compressed_image_t from Image_LoadCompressedImage
 };
 
 typedef struct glheapallocation_s glheapallocation_t;
@@ -65,6 +68,10 @@ typedef struct gltexture_s
 {
 	// managed by texture manager
 	struct gltexture_s *next;
+	struct gltexture_s *prev;
+	struct gltexture_s *hash_next; // next texture in the same (owner, name) bucket
+	unsigned int		hash;
+	qboolean			hashed;
 	qmodel_t		   *owner;
 	// managed by image loading
 	char				name[64];
@@ -83,12 +90,18 @@ typedef struct gltexture_s
 	signed char			pants;					// 0-13 pants color, or -1 if never colormapped
 	// used for rendering
 	VkImage				image;
+	VkFormat			image_format;
+	int					num_mips;
 	VkImageView			image_view;
 	VkImageView			target_image_view;
 	glheapallocation_t *allocation;
 	VkDescriptorSet		descriptor_set;
 	VkFramebuffer		frame_buffer;
 	VkDescriptorSet		storage_descriptor_set;
+	// texture streaming (TEXPREF_STREAM)
+	qboolean stream_full;	 // resident at full size
+	qboolean stream_pending; // a reload is being decoded
+	int		 visframe;		 // r_framecount of the last frame the texture was drawn in
 } gltexture_t;
 
 extern gltexture_t *notexture;
@@ -115,6 +128,8 @@ void		 TexMgr_NewGame (void);
 void		 TexMgr_Init (void);
 void		 TexMgr_DeleteTextureObjects (void);
 void		 TexMgr_CollectGarbage (void);
+void		 TexMgr_StreamTextures (void);
+void		 TexMgr_Defragment (void);
 void		 TexMgr_LoadPalette (void);
 
 // IMAGE LOADING
@@ -124,7 +139,8 @@ gltexture_t *TexMgr_LoadImage (
 void TexMgr_ReloadImage (gltexture_t *glt, int shirt, int pants);
 void TexMgr_ReloadNobrightImages (void);
 
-void TexMgr_UpdateTextureDescriptorSets (void);
+void	 TexMgr_UpdateTextureDescriptorSets (void);
+uint32_t TexMgr_BindlessIndex (gltexture_t *glt);
 
 typedef struct glheapstats_s glheapstats_t;
 glheapstats_t				*TexMgr_GetHeapStats (void);
@@ -98,6 +98,8 @@ static void GL_InitInstance (void);
 static void GL_InitDevice (void);
 static void GL_CreateFrameBuffers (void);
 static void GL_DestroyRenderResources (void);
+static void GL_EncodeScreenshots (int cb_index);
+static void GL_FinishScreenshots (void);
 
 viddef_t		vid; // global video state
 modestate_t		modestate = MS_UNINIT;
@@ -113,6 +115,8 @@ static cvar_t vid_width = {"vid_width", "1280", CVAR_ARCHIVE};		  // QuakeSpasm,
 static cvar_t vid_height = {"vid_height", "720", CVAR_ARCHIVE};		  // QuakeSpasm, was 480
 static cvar_t vid_refreshrate = {"vid_refreshrate", "60", CVAR_ARCHIVE};
 static cvar_t vid_vsync = {"vid_vsync", "0", CVAR_ARCHIVE};
+static cvar_t vid_lowlatency = {"vid_lowlatency", "0", CVAR_ARCHIVE};
+static cvar_t vid_framesinflight = {"vid_framesinflight", "2", CVAR_ARCHIVE}; // 2 for lower latency, 3 keeps a GPU bound system busier
 static cvar_t vid_desktopfullscreen = {"vid_desktopfullscreen", "0", CVAR_ARCHIVE}; // QuakeSpasm
 static cvar_t vid_borderless = {"vid_borderless", "0", CVAR_ARCHIVE};				// QuakeSpasm
 cvar_t		  vid_palettize = {"vid_palettize", "0", CVAR_ARCHIVE};
@@ -128,6 +132,10 @@ cvar_t		  r_ui_echo = {"r_ui_echo", "0", CVAR_NONE};
 cvar_t		  r_ui_echo_scale = {"r_ui_echo_scale", "1", CVAR_NONE};
 cvar_t		  r_ui_additive = {"r_ui_additive", "0", CVAR_NONE};
 cvar_t		  r_usesops = {"r_usesops", "1", CVAR_ARCHIVE}; // johnfitz
+static cvar_t r_occlusioncull = {"r_occlusioncull", "0", CVAR_ARCHIVE};
+static cvar_t r_asynccompute = {"r_asynccompute", "1", CVAR_ARCHIVE};
+static cvar_t r_fusedpostprocess = {"r_fusedpostprocess", "1", CVAR_ARCHIVE};
+static cvar_t r_vrs = {"r_vrs", "0", CVAR_ARCHIVE};
 #if defined(_DEBUG)
 static cvar_t r_raydebug = {"r_raydebug", "0", 0};
 #endif
@@ -144,12 +152,23 @@ static uint32_t			current_cb_index;
 static VkCommandPool	primary_command_pools[PCBX_NUM];
 static VkCommandPool   *secondary_command_pools[SCBX_NUM];
 static VkCommandPool	transient_command_pool;
-static VkCommandBuffer	primary_command_buffers[PCBX_NUM][DOUBLE_BUFFERED];
-static VkCommandBuffer *secondary_command_buffers[SCBX_NUM][DOUBLE_BUFFERED];
-static VkFence			command_buffer_fences[DOUBLE_BUFFERED];
-static qboolean			frame_submitted[DOUBLE_BUFFERED];
+static VkCommandBuffer	primary_command_buffers[PCBX_NUM][MAX_FRAMES_IN_FLIGHT];
+static VkCommandBuffer *secondary_command_buffers[SCBX_NUM][MAX_FRAMES_IN_FLIGHT];
+static VkFence			command_buffer_fences[MAX_FRAMES_IN_FLIGHT];
+static VkCommandPool	async_compute_command_pool;
+static VkCommandBuffer	async_compute_command_buffers[MAX_FRAMES_IN_FLIGHT];
+// Compute -> graphics handoff of the lightmaps updated this frame
+static VkSemaphore		async_compute_done_semaphores[MAX_FRAMES_IN_FLIGHT];
+// Graphics -> compute: the previous frame is done sampling the lightmaps the next compute submit overwrites
+static VkSemaphore		async_compute_release_semaphores[MAX_FRAMES_IN_FLIGHT];
+static VkSemaphore		pending_async_compute_release; // signaled by the last graphics submit, not yet waited on
+static qboolean			frame_submitted[MAX_FRAMES_IN_FLIGHT];
+#define GPU_QUERIES_PER_FRAME (2 + GPU_TIMER_NUM * 2)
+static VkQueryPool		frame_timestamp_query_pool; // GPU_QUERIES_PER_FRAME per frame, see GL_BeginGPUTimer
+static double			last_frame_gpu_time;
+static double			last_frame_gpu_timers[GPU_TIMER_NUM];
 static VkFramebuffer	main_framebuffers[NUM_COLOR_BUFFERS];
-static VkSemaphore		image_aquired_semaphores[DOUBLE_BUFFERED];
+static VkSemaphore		image_aquired_semaphores[MAX_FRAMES_IN_FLIGHT];
 // Per-swapchain-image "render finished" semaphores, following Khronos guidance
 // (swapchain_semaphore_reuse.html). Indexed by swapchain image index, not
 // frame-in-flight index, to prevent semaphore reuse hazards when the
@@ -164,6 +183,8 @@ static VkImageView		swapchain_images_views[MAX_SWAP_CHAIN_IMAGES];
 static VkImage			depth_buffer;
 static vulkan_memory_t	depth_buffer_memory;
 static VkImageView		depth_buffer_view;
+static frame_image_t	depth_buffer_frame_image;
+static VkImageView		depth_buffer_sample_view;
 static vulkan_memory_t	color_buffers_memory[NUM_COLOR_BUFFERS];
 static VkImageView		color_buffers_view[NUM_COLOR_BUFFERS];
 static VkImage			msaa_color_buffer;
@@ -173,7 +194,30 @@ static VkDescriptorSet	postprocess_descriptor_set;
 static VkDescriptorSet	postprocess_ui_descriptor_set;
 static VkBuffer			palette_colors_buffer;
 static VkBufferView		palette_buffer_view;
-static VkBuffer			palette_octree_buffer;
+static VkImage			palette_lut;
+static VkImageView		palette_lut_view;
+static unsigned int		palette_lut_colors[256]; // d_8to24table the LUT was built for
+
+#define MAX_DEPTH_PYRAMID_LEVELS 16
+static VkImage			depth_pyramid;
+static vulkan_memory_t	depth_pyramid_memory;
+static VkImageView		depth_pyramid_view;
+static VkImageView		depth_pyramid_level_views[MAX_DEPTH_PYRAMID_LEVELS];
+static VkDescriptorSet	depth_pyramid_input_desc_sets[MAX_DEPTH_PYRAMID_LEVELS];
+static VkDescriptorSet	depth_pyramid_output_desc_sets[MAX_DEPTH_PYRAMID_LEVELS];
+static VkSampler		depth_pyramid_sampler;
+static int				depth_pyramid_width;
+static int				depth_pyramid_height;
+static int				num_depth_pyramid_levels;
+static frame_image_t	depth_pyramid_frame_image;
+
+static VkImage			shading_rate_image;
+static vulkan_memory_t	shading_rate_image_memory;
+static VkImageView		shading_rate_image_view;
+static VkDescriptorSet	shading_rate_desc_sets[3]; // scene color, depth, shading rate output
+static int				shading_rate_width;
+static int				shading_rate_height;
+static frame_image_t	shading_rate_frame_image;
 
 static PFN_vkGetInstanceProcAddr					  fpGetInstanceProcAddr;
 static PFN_vkGetDeviceProcAddr						  fpGetDeviceProcAddr;
@@ -190,6 +234,8 @@ static PFN_vkQueuePresentKHR						  fpQueuePresentKHR;
 static PFN_vkEnumerateInstanceVersion				  fpEnumerateInstanceVersion;
 static PFN_vkGetPhysicalDeviceFeatures2				  fpGetPhysicalDeviceFeatures2;
 static PFN_vkGetPhysicalDeviceProperties2			  fpGetPhysicalDeviceProperties2;
+static PFN_vkGetPhysicalDeviceMemoryProperties2		  fpGetPhysicalDeviceMemoryProperties2;
+static PFN_vkWaitForPresentKHR						  fpWaitForPresentKHR;
 #if defined(VK_EXT_full_screen_exclusive)
 static PFN_vkAcquireFullScreenExclusiveModeEXT fpAcquireFullScreenExclusiveModeEXT;
 static PFN_vkReleaseFullScreenExclusiveModeEXT fpReleaseFullScreenExclusiveModeEXT;
@@ -214,13 +260,67 @@ VkBool32 VKAPI_PTR DebugMessageCallback (
 static uint32_t current_swapchain_buffer;
 
 // Screenshots
-qboolean	take_screenshot = false;
-static char screenshot_ext[4];
-char		screenshot_imagename[MAX_OSPATH]; // johnfitz -- was [80]
-int			screenshot_quality;
+// Frames are copied into host visible buffers by the frame's command buffer. The buffer is only read once the fence
+// of that command buffer was waited on by a later frame, and then encoded by a task, so nothing waits for the GPU.
+#define NUM_SCREENSHOT_SLOTS 8
+
+typedef enum
+{
+	SCREENSHOT_SLOT_FREE,
+	SCREENSHOT_SLOT_RESERVED, // picked by GL_EndRendering, the copy is recorded by its task
+	SCREENSHOT_SLOT_COPYING,  // waiting for the fence of command buffer cb_index
+	SCREENSHOT_SLOT_ENCODING,
+} screenshot_slot_state_t;
+
+typedef struct
+{
+	atomic_uint32_t state;
+	uint32_t		sequence;
+	VkBuffer		buffer;
+	vulkan_memory_t memory;
+	byte		   *data; // persistently mapped
+	size_t			size;
+	int				width;
+	int				height;
+	int				cb_index;
+	qboolean		bgra;
+	qboolean		quiet;
+	int				quality;
+	char			ext[4];
+	char			name[MAX_OSPATH];
+	task_handle_t	task;
+} screenshot_slot_t;
+
+static screenshot_slot_t screenshot_slots[NUM_SCREENSHOT_SLOTS];
+static uint32_t			 screenshot_sequence;
+static qboolean			 take_screenshot = false;
+static char				 screenshot_ext[4];
+static char				 screenshot_imagename[MAX_OSPATH]; // johnfitz -- was [80]
+static int				 screenshot_quality;
+
+// Video capture, writes a numbered image per frame while the game advances by a fixed time step
+static int	capture_fps;
+static int	capture_frame;
+static char capture_dir[MAX_QPATH];
+static char capture_ext[4];
+static int	capture_quality;
 
 task_handle_t prev_end_rendering_task = INVALID_TASK_HANDLE;
 
+// vid_lowlatency, frames are tagged with present ids so the main thread can wait for them to reach the screen
+#define NUM_LATENCY_FRAMES 8
+
+static uint64_t latency_present_id;		   // last id handed to a frame, main thread
+static uint64_t latency_presented_id;	   // last id passed to vkQueuePresentKHR, end rendering task
+static uint64_t latency_waited_present_id; // last id waited for
+static double	latency_input_time;		   // when the current frame sampled input
+static double	latency_input_times[NUM_LATENCY_FRAMES];
+static double	latency_submit_times[NUM_LATENCY_FRAMES];
+static double	latency_last_vblank;
+static double	latency_refresh_period;	  // seconds between presents
+static double	latency_cpu_time;		  // seconds from sampling input to submitting the frame
+static double	latency_input_to_present; // seconds, 0 when not measured
+
 #define GET_INSTANCE_PROC_ADDR(entrypoint)                                                              \
 	{                                                                                                   \
 		fp##entrypoint = (PFN_vk##entrypoint)fpGetInstanceProcAddr (vulkan_instance, "vk" #entrypoint); \
@@ -718,6 +818,26 @@ static void VID_FSAAChanged_f (cvar_t *var)
 	VID_Restart (false);
 }
 
+/*
+===================
+VID_OcclusionCullChanged_f
+===================
+*/
+static void VID_OcclusionCullChanged_f (cvar_t *var)
+{
+	VID_Restart (false);
+}
+
+/*
+===================
+VID_ShadingRateChanged_f
+===================
+*/
+static void VID_ShadingRateChanged_f (cvar_t *var)
+{
+	VID_Restart (false);
+}
+
 /*
 ================
 VID_Test -- johnfitz -- like vid_restart, but asks for confirmation after switching modes
@@ -929,6 +1049,7 @@ static void GL_InitInstance (void)
 	{
 		GET_INSTANCE_PROC_ADDR (GetPhysicalDeviceProperties2);
 		GET_INSTANCE_PROC_ADDR (GetPhysicalDeviceFeatures2);
+		GET_INSTANCE_PROC_ADDR (GetPhysicalDeviceMemoryProperties2);
 	}
 
 	if (vulkan_globals.get_surface_capabilities_2)
@@ -1072,6 +1193,7 @@ static void GL_InitDevice (void)
 	int		 device_index = 0;
 
 	qboolean subgroup_size_control = false;
+	qboolean present_id = false;
 
 	uint32_t physical_device_count;
 	err = vkEnumeratePhysicalDevices (vulkan_instance, &physical_device_count, NULL);
@@ -1112,6 +1234,10 @@ static void GL_InitDevice (void)
 	vulkan_globals.ray_query = false;
 	vulkan_globals.synchronization_2 = false;
 	vulkan_globals.dynamic_rendering = false;
+	vulkan_globals.memory_budget = false;
+	vulkan_globals.bindless = false;
+	vulkan_globals.fragment_shading_rate = false;
+	qboolean create_renderpass_2 = false;
 
 	vkGetPhysicalDeviceMemoryProperties (vulkan_physical_device, &vulkan_globals.memory_properties);
 	vkGetPhysicalDeviceProperties (vulkan_physical_device, &vulkan_globals.device_properties);
@@ -1145,6 +1271,18 @@ static void GL_InitDevice (void)
 				vulkan_globals.synchronization_2 = true;
 			if (strcmp (VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME, device_extensions[i].extensionName) == 0)
 				vulkan_globals.dynamic_rendering = true;
+			if (vulkan_globals.get_physical_device_properties_2 && strcmp (VK_EXT_MEMORY_BUDGET_EXTENSION_NAME, device_extensions[i].extensionName) == 0)
+				vulkan_globals.memory_budget = true;
+			if (strcmp (VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME, device_extensions[i].extensionName) == 0)
+				vulkan_globals.bindless = true;
+			if (strcmp (VK_KHR_PRESENT_ID_EXTENSION_NAME, device_extensions[i].extensionName) == 0)
+				present_id = true;
+			if (strcmp (VK_KHR_PRESENT_WAIT_EXTENSION_NAME, device_extensions[i].extensionName) == 0)
+				vulkan_globals.present_wait = true;
+			if (strcmp (VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME, device_extensions[i].extensionName) == 0)
+				create_renderpass_2 = true;
+			if (strcmp (VK_KHR_FRAGMENT_SHADING_RATE_EXTENSION_NAME, device_extensions[i].extensionName) == 0)
+				vulkan_globals.fragment_shading_rate = true;
 		}
 
 		Mem_Free (device_extensions);
@@ -1207,6 +1345,19 @@ static void GL_InitDevice (void)
 		}
 	}
 
+	// A compute family without graphics usually maps to dedicated async compute hardware queues
+	qboolean found_compute_queue = false;
+	for (i = 0; i < vulkan_queue_count; ++i)
+	{
+		const VkQueueFlags queue_flags = queue_family_properties[i].queueFlags;
+		if (((queue_flags & VK_QUEUE_COMPUTE_BIT) != 0) && ((queue_flags & VK_QUEUE_GRAPHICS_BIT) == 0) && (queue_family_properties[i].queueCount > 0))
+		{
+			found_compute_queue = true;
+			vulkan_globals.compute_queue_family_index = i;
+			break;
+		}
+	}
+
 	gfx_timestamp_valid_bits = 0;
 	if (found_graphics_queue)
 		gfx_timestamp_valid_bits = queue_family_properties[vulkan_globals.gfx_queue_family_index].timestampValidBits;
@@ -1218,11 +1369,15 @@ static void GL_InitDevice (void)
 		Sys_Error ("Couldn't find graphics queue");
 
 	float queue_priorities[] = {0.0};
-	ZEROED_STRUCT (VkDeviceQueueCreateInfo, queue_create_info);
-	queue_create_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-	queue_create_info.queueFamilyIndex = vulkan_globals.gfx_queue_family_index;
-	queue_create_info.queueCount = 1;
-	queue_create_info.pQueuePriorities = queue_priorities;
+	ZEROED_STRUCT_ARRAY (VkDeviceQueueCreateInfo, queue_create_infos, 2);
+	queue_create_infos[0].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+	queue_create_infos[0].queueFamilyIndex = vulkan_globals.gfx_queue_family_index;
+	queue_create_infos[0].queueCount = 1;
+	queue_create_infos[0].pQueuePriorities = queue_priorities;
+	queue_create_infos[1].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+	queue_create_infos[1].queueFamilyIndex = vulkan_globals.compute_queue_family_index;
+	queue_create_infos[1].queueCount = 1;
+	queue_create_infos[1].pQueuePriorities = queue_priorities;
 
 	ZEROED_STRUCT (VkPhysicalDeviceSubgroupProperties, physical_device_subgroup_properties);
 	ZEROED_STRUCT (VkPhysicalDeviceSubgroupSizeControlPropertiesEXT, physical_device_subgroup_size_control_properties);
@@ -1232,6 +1387,14 @@ static void GL_InitDevice (void)
 	ZEROED_STRUCT (VkPhysicalDeviceRayQueryFeaturesKHR, ray_query_features);
 	ZEROED_STRUCT (VkPhysicalDeviceSynchronization2FeaturesKHR, synchronization_2_features);
 	ZEROED_STRUCT (VkPhysicalDeviceDynamicRenderingFeaturesKHR, dynamic_rendering_features);
+	ZEROED_STRUCT (VkPhysicalDeviceDescriptorIndexingFeaturesEXT, descriptor_indexing_features);
+	ZEROED_STRUCT (VkPhysicalDeviceDescriptorIndexingPropertiesEXT, descriptor_indexing_properties);
+	ZEROED_STRUCT (VkPhysicalDeviceDescriptorIndexingFeaturesEXT, enabled_descriptor_indexing_features);
+	ZEROED_STRUCT (VkPhysicalDevicePresentIdFeaturesKHR, present_id_features);
+	ZEROED_STRUCT (VkPhysicalDevicePresentWaitFeaturesKHR, present_wait_features);
+	ZEROED_STRUCT (VkPhysicalDeviceFragmentShadingRatePropertiesKHR, fragment_shading_rate_properties);
+	ZEROED_STRUCT (VkPhysicalDeviceFragmentShadingRateFeaturesKHR, fragment_shading_rate_features);
+	ZEROED_STRUCT (VkPhysicalDeviceFragmentShadingRateFeaturesKHR, enabled_fragment_shading_rate_features);
 	memset (&vulkan_globals.physical_device_acceleration_structure_properties, 0, sizeof (vulkan_globals.physical_device_acceleration_structure_properties));
 	if (vulkan_globals.vulkan_1_1_available)
 	{
@@ -1251,6 +1414,16 @@ static void GL_InitDevice (void)
 			vulkan_globals.physical_device_acceleration_structure_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_PROPERTIES_KHR;
 			CHAIN_PNEXT (device_properties_next, vulkan_globals.physical_device_acceleration_structure_properties);
 		}
+		if (vulkan_globals.bindless)
+		{
+			descriptor_indexing_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+			CHAIN_PNEXT (device_properties_next, descriptor_indexing_properties);
+		}
+		if (vulkan_globals.fragment_shading_rate)
+		{
+			fragment_shading_rate_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_PROPERTIES_KHR;
+			CHAIN_PNEXT (device_properties_next, fragment_shading_rate_properties);
+		}
 
 		fpGetPhysicalDeviceProperties2 (vulkan_physical_device, &physical_device_properties_2);
 
@@ -1258,6 +1431,12 @@ static void GL_InitDevice (void)
 		physical_device_features_2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
 		void **device_features_next = &physical_device_features_2.pNext;
 
+		if (vulkan_globals.bindless)
+		{
+			descriptor_indexing_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+			CHAIN_PNEXT (device_features_next, descriptor_indexing_features);
+		}
+
 		if (subgroup_size_control)
 		{
 			subgroup_size_control_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_SIZE_CONTROL_FEATURES_EXT;
@@ -1282,6 +1461,18 @@ static void GL_InitDevice (void)
 			dynamic_rendering_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
 			CHAIN_PNEXT (device_features_next, dynamic_rendering_features);
 		}
+		if (present_id && vulkan_globals.present_wait)
+		{
+			present_id_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+			CHAIN_PNEXT (device_features_next, present_id_features);
+			present_wait_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+			CHAIN_PNEXT (device_features_next, present_wait_features);
+		}
+		if (vulkan_globals.fragment_shading_rate)
+		{
+			fragment_shading_rate_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_FEATURES_KHR;
+			CHAIN_PNEXT (device_features_next, fragment_shading_rate_features);
+		}
 
 		fpGetPhysicalDeviceFeatures2 (vulkan_physical_device, &physical_device_features_2);
 		vulkan_globals.device_features = physical_device_features_2.features;
@@ -1315,6 +1506,40 @@ static void GL_InitDevice (void)
 	vulkan_globals.dynamic_rendering = vulkan_globals.dynamic_rendering && dynamic_rendering_features.dynamicRendering;
 	if (vulkan_globals.dynamic_rendering)
 		Con_Printf ("Using VK_KHR_dynamic_rendering\n");
+	if (vulkan_globals.memory_budget)
+		Con_Printf ("Using VK_EXT_memory_budget\n");
+
+	vulkan_globals.present_wait = vulkan_globals.present_wait && present_id_features.presentId && present_wait_features.presentWait;
+	if (vulkan_globals.present_wait)
+		Con_Printf ("Using VK_KHR_present_wait\n");
+
+	// Every gltexture_t gets a slot in one update-after-bind sampler array
+	vulkan_globals.bindless =
+		vulkan_globals.vulkan_1_1_available && vulkan_globals.bindless && descriptor_indexing_features.runtimeDescriptorArray &&
+		descriptor_indexing_features.descriptorBindingPartiallyBound && descriptor_indexing_features.descriptorBindingSampledImageUpdateAfterBind &&
+		descriptor_indexing_features.descriptorBindingUpdateUnusedWhilePending &&
+		(descriptor_indexing_properties.maxDescriptorSetUpdateAfterBindSampledImages >= MAX_GLTEXTURES) &&
+		(descriptor_indexing_properties.maxPerStageDescriptorUpdateAfterBindSampledImages >= MAX_GLTEXTURES) &&
+		(descriptor_indexing_properties.maxDescriptorSetUpdateAfterBindSamplers >= MAX_GLTEXTURES) &&
+		(descriptor_indexing_properties.maxPerStageDescriptorUpdateAfterBindSamplers >= MAX_GLTEXTURES);
+	if (vulkan_globals.bindless)
+		Con_Printf ("Using bindless textures\n");
+
+	// The shading rate image is written with r8ui image stores and covered by 8x8 workgroups, one per texel
+	VkFormatProperties shading_rate_format_properties;
+	vkGetPhysicalDeviceFormatProperties (vulkan_physical_device, VK_FORMAT_R8_UINT, &shading_rate_format_properties);
+	const VkExtent2D min_texel_size = fragment_shading_rate_properties.minFragmentShadingRateAttachmentTexelSize;
+	const VkExtent2D max_texel_size = fragment_shading_rate_properties.maxFragmentShadingRateAttachmentTexelSize;
+	vulkan_globals.shading_rate_texel_size = q_max (16, q_max (min_texel_size.width, min_texel_size.height));
+	vulkan_globals.fragment_shading_rate =
+		vulkan_globals.vulkan_1_1_available && vulkan_globals.fragment_shading_rate && create_renderpass_2 &&
+		fragment_shading_rate_features.attachmentFragmentShadingRate && vulkan_globals.device_features.shaderStorageImageExtendedFormats &&
+		((shading_rate_format_properties.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT) != 0) &&
+		((shading_rate_format_properties.optimalTilingFeatures & VK_FORMAT_FEATURE_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR) != 0) &&
+		(vulkan_globals.shading_rate_texel_size <= 32) && (vulkan_globals.shading_rate_texel_size <= max_texel_size.width) &&
+		(vulkan_globals.shading_rate_texel_size <= max_texel_size.height);
+	if (vulkan_globals.fragment_shading_rate)
+		Con_Printf ("Using VK_KHR_fragment_shading_rate\n");
 
 	const char *device_extensions[32] = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
 	uint32_t	numEnabledExtensions = 1;
@@ -1344,6 +1569,20 @@ static void GL_InitDevice (void)
 		device_extensions[numEnabledExtensions++] = VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME;
 	if (vulkan_globals.dynamic_rendering)
 		device_extensions[numEnabledExtensions++] = VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME;
+	if (vulkan_globals.memory_budget)
+		device_extensions[numEnabledExtensions++] = VK_EXT_MEMORY_BUDGET_EXTENSION_NAME;
+	if (vulkan_globals.bindless && !vulkan_globals.ray_query)
+		device_extensions[numEnabledExtensions++] = VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME;
+	if (vulkan_globals.present_wait)
+	{
+		device_extensions[numEnabledExtensions++] = VK_KHR_PRESENT_ID_EXTENSION_NAME;
+		device_extensions[numEnabledExtensions++] = VK_KHR_PRESENT_WAIT_EXTENSION_NAME;
+	}
+	if (vulkan_globals.fragment_shading_rate)
+	{
+		device_extensions[numEnabledExtensions++] = VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME;
+		device_extensions[numEnabledExtensions++] = VK_KHR_FRAGMENT_SHADING_RATE_EXTENSION_NAME;
+	}
 
 	const VkBool32 extended_format_support = vulkan_globals.device_features.shaderStorageImageExtendedFormats;
 	const VkBool32 sampler_anisotropic = vulkan_globals.device_features.samplerAnisotropy;
@@ -1354,9 +1593,13 @@ static void GL_InitDevice (void)
 	device_features.sampleRateShading = vulkan_globals.device_features.sampleRateShading;
 	device_features.fillModeNonSolid = vulkan_globals.device_features.fillModeNonSolid;
 	device_features.multiDrawIndirect = vulkan_globals.device_features.multiDrawIndirect;
+	device_features.textureCompressionBC = vulkan_globals.device_features.textureCompressionBC;
+	device_features.textureCompressionASTC_LDR = vulkan_globals.device_features.textureCompressionASTC_LDR;
 
 	vulkan_globals.non_solid_fill = (device_features.fillModeNonSolid == VK_TRUE) ? true : false;
 	vulkan_globals.multi_draw_indirect = (device_features.multiDrawIndirect == VK_TRUE) ? true : false;
+	vulkan_globals.texture_compression_bc = (device_features.textureCompressionBC == VK_TRUE) ? true : false;
+	vulkan_globals.texture_compression_astc = (device_features.textureCompressionASTC_LDR == VK_TRUE) ? true : false;
 
 	ZEROED_STRUCT (VkDeviceCreateInfo, device_create_info);
 	device_create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -1373,8 +1616,30 @@ static void GL_InitDevice (void)
 		CHAIN_PNEXT (device_create_info_next, synchronization_2_features);
 	if (vulkan_globals.dynamic_rendering)
 		CHAIN_PNEXT (device_create_info_next, dynamic_rendering_features);
-	device_create_info.queueCreateInfoCount = 1;
-	device_create_info.pQueueCreateInfos = &queue_create_info;
+	if (vulkan_globals.present_wait)
+	{
+		CHAIN_PNEXT (device_create_info_next, present_id_features);
+		CHAIN_PNEXT (device_create_info_next, present_wait_features);
+	}
+	if (vulkan_globals.bindless)
+	{
+		// Only enable what the bindless texture set needs
+		enabled_descriptor_indexing_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+		enabled_descriptor_indexing_features.runtimeDescriptorArray = VK_TRUE;
+		enabled_descriptor_indexing_features.descriptorBindingPartiallyBound = VK_TRUE;
+		enabled_descriptor_indexing_features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+		enabled_descriptor_indexing_features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+		CHAIN_PNEXT (device_create_info_next, enabled_descriptor_indexing_features);
+	}
+	if (vulkan_globals.fragment_shading_rate)
+	{
+		// Only the attachment rate is used, pipelines keep the default 1x1 rate
+		enabled_fragment_shading_rate_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_FEATURES_KHR;
+		enabled_fragment_shading_rate_features.attachmentFragmentShadingRate = VK_TRUE;
+		CHAIN_PNEXT (device_create_info_next, enabled_fragment_shading_rate_features);
+	}
+	device_create_info.queueCreateInfoCount = found_compute_queue ? 2 : 1;
+	device_create_info.pQueueCreateInfos = queue_create_infos;
 	device_create_info.enabledExtensionCount = numEnabledExtensions;
 	device_create_info.ppEnabledExtensionNames = device_extensions;
 	device_create_info.pEnabledFeatures = &device_features;
@@ -1393,6 +1658,9 @@ static void GL_InitDevice (void)
 	for (i = 0; i < numEnabledExtensions; ++i)
 		Con_Printf (" %s\n", device_extensions[i]);
 
+	if (vulkan_globals.present_wait)
+		GET_DEVICE_PROC_ADDR (WaitForPresentKHR);
+
 #if defined(VK_EXT_full_screen_exclusive)
 	if (vulkan_globals.full_screen_exclusive)
 	{
@@ -1408,6 +1676,8 @@ static void GL_InitDevice (void)
 		GET_GLOBAL_DEVICE_PROC_ADDR (vk_destroy_acceleration_structure, vkDestroyAccelerationStructureKHR);
 		GET_GLOBAL_DEVICE_PROC_ADDR (vk_cmd_build_acceleration_structures, vkCmdBuildAccelerationStructuresKHR);
 		GET_GLOBAL_DEVICE_PROC_ADDR (vk_get_acceleration_structure_device_address, vkGetAccelerationStructureDeviceAddressKHR);
+		GET_GLOBAL_DEVICE_PROC_ADDR (vk_cmd_write_acceleration_structures_properties, vkCmdWriteAccelerationStructuresPropertiesKHR);
+		GET_GLOBAL_DEVICE_PROC_ADDR (vk_cmd_copy_acceleration_structure, vkCmdCopyAccelerationStructureKHR);
 	}
 	if (vulkan_globals.synchronization_2)
 	{
@@ -1418,6 +1688,8 @@ static void GL_InitDevice (void)
 		GET_GLOBAL_DEVICE_PROC_ADDR (vk_cmd_begin_rendering, vkCmdBeginRenderingKHR);
 		GET_GLOBAL_DEVICE_PROC_ADDR (vk_cmd_end_rendering, vkCmdEndRenderingKHR);
 	}
+	if (vulkan_globals.fragment_shading_rate)
+		GET_GLOBAL_DEVICE_PROC_ADDR (vk_create_render_pass_2, vkCreateRenderPass2KHR);
 #ifdef _DEBUG
 	if (vulkan_globals.debug_utils)
 	{
@@ -1428,6 +1700,14 @@ static void GL_InitDevice (void)
 #endif
 
 	vkGetDeviceQueue (vulkan_globals.device, vulkan_globals.gfx_queue_family_index, 0, &vulkan_globals.queue);
+	vulkan_globals.compute_queue = VK_NULL_HANDLE;
+	if (found_compute_queue)
+	{
+		vkGetDeviceQueue (vulkan_globals.device, vulkan_globals.compute_queue_family_index, 0, &vulkan_globals.compute_queue);
+		vulkan_globals.queue_family_indices[0] = vulkan_globals.gfx_queue_family_index;
+		vulkan_globals.queue_family_indices[1] = vulkan_globals.compute_queue_family_index;
+		Con_Printf ("Using async compute queue family %u\n", vulkan_globals.compute_queue_family_index);
+	}
 
 	VkFormatProperties format_properties;
 
@@ -1519,22 +1799,55 @@ static void GL_InitCommandBuffers (void)
 		ZEROED_STRUCT (VkCommandBufferAllocateInfo, command_buffer_allocate_info);
 		command_buffer_allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
 		command_buffer_allocate_info.commandPool = primary_command_pools[pcbx_index];
-		command_buffer_allocate_info.commandBufferCount = DOUBLE_BUFFERED;
+		command_buffer_allocate_info.commandBufferCount = MAX_FRAMES_IN_FLIGHT;
 
 		err = vkAllocateCommandBuffers (vulkan_globals.device, &command_buffer_allocate_info, primary_command_buffers[pcbx_index]);
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkAllocateCommandBuffers failed");
-		for (int i = 0; i < DOUBLE_BUFFERED; ++i)
+		for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
 			GL_SetObjectName (
 				(uint64_t)(uintptr_t)primary_command_buffers[pcbx_index][i], VK_OBJECT_TYPE_COMMAND_BUFFER, va ("PCBX index: %d cb_index: %d", pcbx_index, i));
 	}
 
+	if (vulkan_globals.compute_queue != VK_NULL_HANDLE)
+	{
+		ZEROED_STRUCT (VkCommandPoolCreateInfo, compute_command_pool_create_info);
+		compute_command_pool_create_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		compute_command_pool_create_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+		compute_command_pool_create_info.queueFamilyIndex = vulkan_globals.compute_queue_family_index;
+		err = vkCreateCommandPool (vulkan_globals.device, &compute_command_pool_create_info, NULL, &async_compute_command_pool);
+		if (err != VK_SUCCESS)
+			Sys_Error ("vkCreateCommandPool failed");
+
+		ZEROED_STRUCT (VkCommandBufferAllocateInfo, command_buffer_allocate_info);
+		command_buffer_allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		command_buffer_allocate_info.commandPool = async_compute_command_pool;
+		command_buffer_allocate_info.commandBufferCount = MAX_FRAMES_IN_FLIGHT;
+
+		err = vkAllocateCommandBuffers (vulkan_globals.device, &command_buffer_allocate_info, async_compute_command_buffers);
+		if (err != VK_SUCCESS)
+			Sys_Error ("vkAllocateCommandBuffers failed");
+
+		ZEROED_STRUCT (VkSemaphoreCreateInfo, semaphore_create_info);
+		semaphore_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+		for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+		{
+			GL_SetObjectName ((uint64_t)(uintptr_t)async_compute_command_buffers[i], VK_OBJECT_TYPE_COMMAND_BUFFER, va ("Async compute cb_index: %d", i));
+			err = vkCreateSemaphore (vulkan_globals.device, &semaphore_create_info, NULL, &async_compute_done_semaphores[i]);
+			if (err != VK_SUCCESS)
+				Sys_Error ("vkCreateSemaphore failed");
+			err = vkCreateSemaphore (vulkan_globals.device, &semaphore_create_info, NULL, &async_compute_release_semaphores[i]);
+			if (err != VK_SUCCESS)
+				Sys_Error ("vkCreateSemaphore failed");
+		}
+	}
+
 	for (int scbx_index = 0; scbx_index < SCBX_NUM; ++scbx_index)
 	{
 		const int multiplicity = SECONDARY_CB_MULTIPLICITY[scbx_index];
 		vulkan_globals.secondary_cb_contexts[scbx_index] = Mem_Alloc (multiplicity * sizeof (cb_context_t));
 		secondary_command_pools[scbx_index] = Mem_Alloc (multiplicity * sizeof (VkCommandPool));
-		for (int i = 0; i < DOUBLE_BUFFERED; ++i)
+		for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
 			secondary_command_buffers[scbx_index][i] = Mem_Alloc (multiplicity * sizeof (VkCommandBuffer));
 		for (int i = 0; i < multiplicity; ++i)
 		{
@@ -1545,14 +1858,14 @@ static void GL_InitCommandBuffers (void)
 			ZEROED_STRUCT (VkCommandBufferAllocateInfo, command_buffer_allocate_info);
 			command_buffer_allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
 			command_buffer_allocate_info.commandPool = secondary_command_pools[scbx_index][i];
-			command_buffer_allocate_info.commandBufferCount = DOUBLE_BUFFERED;
+			command_buffer_allocate_info.commandBufferCount = MAX_FRAMES_IN_FLIGHT;
 			command_buffer_allocate_info.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
 
-			VkCommandBuffer command_buffers[DOUBLE_BUFFERED];
+			VkCommandBuffer command_buffers[MAX_FRAMES_IN_FLIGHT];
 			err = vkAllocateCommandBuffers (vulkan_globals.device, &command_buffer_allocate_info, command_buffers);
 			if (err != VK_SUCCESS)
 				Sys_Error ("vkAllocateCommandBuffers failed");
-			for (int j = 0; j < DOUBLE_BUFFERED; ++j)
+			for (int j = 0; j < MAX_FRAMES_IN_FLIGHT; ++j)
 			{
 				secondary_command_buffers[scbx_index][j][i] = command_buffers[j];
 				GL_SetObjectName (
@@ -1564,15 +1877,142 @@ static void GL_InitCommandBuffers (void)
 	ZEROED_STRUCT (VkFenceCreateInfo, fence_create_info);
 	fence_create_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
 
-	for (int i = 0; i < DOUBLE_BUFFERED; ++i)
+	for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
 	{
 		err = vkCreateFence (vulkan_globals.device, &fence_create_info, NULL, &command_buffer_fences[i]);
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkCreateFence failed");
 	}
+
+	frame_timestamp_query_pool = VK_NULL_HANDLE;
+	if ((gfx_timestamp_valid_bits > 0) && (vulkan_globals.device_properties.limits.timestampPeriod > 0.0f))
+	{
+		ZEROED_STRUCT (VkQueryPoolCreateInfo, query_pool_create_info);
+		query_pool_create_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		query_pool_create_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		query_pool_create_info.queryCount = GPU_QUERIES_PER_FRAME * MAX_FRAMES_IN_FLIGHT;
+		err = vkCreateQueryPool (vulkan_globals.device, &query_pool_create_info, NULL, &frame_timestamp_query_pool);
+		if (err != VK_SUCCESS)
+		{
+			Con_Warning ("vkCreateQueryPool failed, GPU frame times unavailable\n");
+			frame_timestamp_query_pool = VK_NULL_HANDLE;
+		}
+	}
 	// Note: draw_complete_semaphores are now created per-swapchain-image in GL_CreateSwapChain
 }
 
+/*
+====================
+GL_CreateMainRenderPass
+
+With r_vrs the main render pass gets the shading rate image as an extra
+attachment, which needs the VK_KHR_create_renderpass2 structures
+====================
+*/
+static VkResult GL_CreateMainRenderPass (const VkRenderPassCreateInfo *create_info, VkRenderPass *render_pass)
+{
+	if (!vulkan_globals.shading_rate)
+		return vkCreateRenderPass (vulkan_globals.device, create_info, NULL, render_pass);
+
+	assert (create_info->subpassCount == 1);
+	const VkSubpassDescription *subpass = create_info->pSubpasses;
+	const uint32_t				shading_rate_attachment = create_info->attachmentCount;
+
+	ZEROED_STRUCT_ARRAY (VkAttachmentDescription2KHR, attachment_descriptions, 4);
+	assert (create_info->attachmentCount < countof (attachment_descriptions));
+	for (uint32_t i = 0; i < create_info->attachmentCount; ++i)
+	{
+		const VkAttachmentDescription *desc = &create_info->pAttachments[i];
+		attachment_descriptions[i].sType = VK_STRUCTURE_TYPE_ATTACHMENT_DESCRIPTION_2_KHR;
+		attachment_descriptions[i].flags = desc->flags;
+		attachment_descriptions[i].format = desc->format;
+		attachment_descriptions[i].samples = desc->samples;
+		attachment_descriptions[i].loadOp = desc->loadOp;
+		attachment_descriptions[i].storeOp = desc->storeOp;
+		attachment_descriptions[i].stencilLoadOp = desc->stencilLoadOp;
+		attachment_descriptions[i].stencilStoreOp = desc->stencilStoreOp;
+		attachment_descriptions[i].initialLayout = desc->initialLayout;
+		attachment_descriptions[i].finalLayout = desc->finalLayout;
+	}
+
+	// Written by GL_BuildShadingRateImage at the end of the previous frame
+	attachment_descriptions[shading_rate_attachment].sType = VK_STRUCTURE_TYPE_ATTACHMENT_DESCRIPTION_2_KHR;
+	attachment_descriptions[shading_rate_attachment].format = VK_FORMAT_R8_UINT;
+	attachment_descriptions[shading_rate_attachment].samples = VK_SAMPLE_COUNT_1_BIT;
+	attachment_descriptions[shading_rate_attachment].loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+	attachment_descriptions[shading_rate_attachment].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+	attachment_descriptions[shading_rate_attachment].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	attachment_descriptions[shading_rate_attachment].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	attachment_descriptions[shading_rate_attachment].initialLayout = VK_IMAGE_LAYOUT_FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL_KHR;
+	attachment_descriptions[shading_rate_attachment].finalLayout = VK_IMAGE_LAYOUT_FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL_KHR;
+
+	assert (subpass->colorAttachmentCount == 1);
+	ZEROED_STRUCT (VkAttachmentReference2KHR, color_reference);
+	color_reference.sType = VK_STRUCTURE_TYPE_ATTACHMENT_REFERENCE_2_KHR;
+	color_reference.attachment = subpass->pColorAttachments[0].attachment;
+	color_reference.layout = subpass->pColorAttachments[0].layout;
+
+	ZEROED_STRUCT (VkAttachmentReference2KHR, depth_reference);
+	depth_reference.sType = VK_STRUCTURE_TYPE_ATTACHMENT_REFERENCE_2_KHR;
+	depth_reference.attachment = subpass->pDepthStencilAttachment->attachment;
+	depth_reference.layout = subpass->pDepthStencilAttachment->layout;
+
+	ZEROED_STRUCT (VkAttachmentReference2KHR, resolve_reference);
+	if (subpass->pResolveAttachments)
+	{
+		resolve_reference.sType = VK_STRUCTURE_TYPE_ATTACHMENT_REFERENCE_2_KHR;
+		resolve_reference.attachment = subpass->pResolveAttachments[0].attachment;
+		resolve_reference.layout = subpass->pResolveAttachments[0].layout;
+	}
+
+	ZEROED_STRUCT (VkAttachmentReference2KHR, shading_rate_reference);
+	shading_rate_reference.sType = VK_STRUCTURE_TYPE_ATTACHMENT_REFERENCE_2_KHR;
+	shading_rate_reference.attachment = shading_rate_attachment;
+	shading_rate_reference.layout = VK_IMAGE_LAYOUT_FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL_KHR;
+
+	ZEROED_STRUCT (VkFragmentShadingRateAttachmentInfoKHR, shading_rate_attachment_info);
+	shading_rate_attachment_info.sType = VK_STRUCTURE_TYPE_FRAGMENT_SHADING_RATE_ATTACHMENT_INFO_KHR;
+	shading_rate_attachment_info.pFragmentShadingRateAttachment = &shading_rate_reference;
+	shading_rate_attachment_info.shadingRateAttachmentTexelSize.width = vulkan_globals.shading_rate_texel_size;
+	shading_rate_attachment_info.shadingRateAttachmentTexelSize.height = vulkan_globals.shading_rate_texel_size;
+
+	ZEROED_STRUCT (VkSubpassDescription2KHR, subpass_description);
+	subpass_description.sType = VK_STRUCTURE_TYPE_SUBPASS_DESCRIPTION_2_KHR;
+	subpass_description.pNext = &shading_rate_attachment_info;
+	subpass_description.pipelineBindPoint = subpass->pipelineBindPoint;
+	subpass_description.colorAttachmentCount = 1;
+	subpass_description.pColorAttachments = &color_reference;
+	subpass_description.pDepthStencilAttachment = &depth_reference;
+	if (subpass->pResolveAttachments)
+		subpass_description.pResolveAttachments = &resolve_reference;
+
+	ZEROED_STRUCT_ARRAY (VkSubpassDependency2KHR, subpass_dependencies, 1);
+	assert (create_info->dependencyCount <= countof (subpass_dependencies));
+	for (uint32_t i = 0; i < create_info->dependencyCount; ++i)
+	{
+		const VkSubpassDependency *dependency = &create_info->pDependencies[i];
+		subpass_dependencies[i].sType = VK_STRUCTURE_TYPE_SUBPASS_DEPENDENCY_2_KHR;
+		subpass_dependencies[i].srcSubpass = dependency->srcSubpass;
+		subpass_dependencies[i].dstSubpass = dependency->dstSubpass;
+		subpass_dependencies[i].srcStageMask = dependency->srcStageMask;
+		subpass_dependencies[i].dstStageMask = dependency->dstStageMask;
+		subpass_dependencies[i].srcAccessMask = dependency->srcAccessMask;
+		subpass_dependencies[i].dstAccessMask = dependency->dstAccessMask;
+		subpass_dependencies[i].dependencyFlags = dependency->dependencyFlags;
+	}
+
+	ZEROED_STRUCT (VkRenderPassCreateInfo2KHR, render_pass_create_info);
+	render_pass_create_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO_2_KHR;
+	render_pass_create_info.attachmentCount = create_info->attachmentCount + 1;
+	render_pass_create_info.pAttachments = attachment_descriptions;
+	render_pass_create_info.subpassCount = 1;
+	render_pass_create_info.pSubpasses = &subpass_description;
+	render_pass_create_info.dependencyCount = create_info->dependencyCount;
+	render_pass_create_info.pDependencies = subpass_dependencies;
+
+	return vulkan_globals.vk_create_render_pass_2 (vulkan_globals.device, &render_pass_create_info, NULL, render_pass);
+}
+
 /*
 ====================
 GL_CreateRenderPasses
@@ -1602,7 +2042,8 @@ static void GL_CreateRenderPasses ()
 		attachment_descriptions[1].samples = vulkan_globals.sample_count;
 		attachment_descriptions[1].format = vulkan_globals.depth_format;
 		attachment_descriptions[1].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-		attachment_descriptions[1].storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		attachment_descriptions[1].storeOp =
+			(vulkan_globals.occlusion_culling || vulkan_globals.shading_rate) ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
 		attachment_descriptions[1].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
 		attachment_descriptions[1].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 
@@ -1661,13 +2102,13 @@ static void GL_CreateRenderPasses ()
 				assert (vulkan_globals.secondary_cb_contexts[scbx_index][i].render_pass == VK_NULL_HANDLE);
 		}
 
-		err = vkCreateRenderPass (vulkan_globals.device, &render_pass_create_info, NULL, &vulkan_globals.main_render_pass[0]);
+		err = GL_CreateMainRenderPass (&render_pass_create_info, &vulkan_globals.main_render_pass[0]);
 		if (err != VK_SUCCESS)
 			Sys_Error ("Couldn't create Vulkan render pass");
 		GL_SetObjectName ((uint64_t)vulkan_globals.main_render_pass[0], VK_OBJECT_TYPE_RENDER_PASS, "main");
 
 		attachment_descriptions[1].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-		err = vkCreateRenderPass (vulkan_globals.device, &render_pass_create_info, NULL, &vulkan_globals.main_render_pass[1]);
+		err = GL_CreateMainRenderPass (&render_pass_create_info, &vulkan_globals.main_render_pass[1]);
 		if (err != VK_SUCCESS)
 			Sys_Error ("Couldn't create Vulkan render pass");
 		GL_SetObjectName ((uint64_t)vulkan_globals.main_render_pass[1], VK_OBJECT_TYPE_RENDER_PASS, "main_no_stencil");
@@ -1723,6 +2164,11 @@ static void GL_CreateRenderPasses ()
 		gui_cbx->render_pass = render_pass;
 		gui_cbx->render_pass_index = 1;
 		gui_cbx->subpass = 0;
+
+		cb_context_t *rmlui_cbx = vulkan_globals.secondary_cb_contexts[SCBX_RMLUI];
+		rmlui_cbx->render_pass = render_pass;
+		rmlui_cbx->render_pass_index = 1;
+		rmlui_cbx->subpass = 0;
 	}
 
 	{
@@ -1846,6 +2292,18 @@ static void GL_CreateDepthBuffer (void)
 
 	VkResult err;
 
+	// The occlusion culling depth pyramid is built from the single sampled depth buffer
+	VkFormatProperties format_properties;
+	vkGetPhysicalDeviceFormatProperties (vulkan_physical_device, vulkan_globals.depth_format, &format_properties);
+	vulkan_globals.occlusion_culling = (r_occlusioncull.value != 0.0f) && (vulkan_globals.sample_count == VK_SAMPLE_COUNT_1_BIT) &&
+									   ((format_properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != 0);
+	vulkan_globals.depth_pyramid_valid = false;
+
+	// So is the shading rate image, which also reads the depth buffer for fog
+	vulkan_globals.shading_rate = (r_vrs.value != 0.0f) && vulkan_globals.fragment_shading_rate && (vulkan_globals.sample_count == VK_SAMPLE_COUNT_1_BIT) &&
+								  ((format_properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != 0);
+	const qboolean sample_depth = vulkan_globals.occlusion_culling || vulkan_globals.shading_rate;
+
 	ZEROED_STRUCT (VkImageCreateInfo, image_create_info);
 	image_create_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 	image_create_info.pNext = NULL;
@@ -1859,6 +2317,8 @@ static void GL_CreateDepthBuffer (void)
 	image_create_info.samples = vulkan_globals.sample_count;
 	image_create_info.tiling = VK_IMAGE_TILING_OPTIMAL;
 	image_create_info.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+	if (sample_depth)
+		image_create_info.usage |= VK_IMAGE_USAGE_SAMPLED_BIT;
 
 	assert (depth_buffer == VK_NULL_HANDLE);
 	err = vkCreateImage (vulkan_globals.device, &image_create_info, NULL, &depth_buffer);
@@ -1866,6 +2326,7 @@ static void GL_CreateDepthBuffer (void)
 		Sys_Error ("vkCreateImage failed");
 
 	GL_SetObjectName ((uint64_t)depth_buffer, VK_OBJECT_TYPE_IMAGE, "Depth Buffer");
+	R_InitFrameImage (&depth_buffer_frame_image, depth_buffer, VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT, 1);
 
 	VkMemoryRequirements memory_requirements;
 	vkGetImageMemoryRequirements (vulkan_globals.device, depth_buffer, &memory_requirements);
@@ -1908,6 +2369,348 @@ static void GL_CreateDepthBuffer (void)
 		Sys_Error ("vkCreateImageView failed");
 
 	GL_SetObjectName ((uint64_t)depth_buffer_view, VK_OBJECT_TYPE_IMAGE_VIEW, "Depth Buffer View");
+
+	if (sample_depth)
+	{
+		assert (depth_buffer_sample_view == VK_NULL_HANDLE);
+		err = vkCreateImageView (vulkan_globals.device, &image_view_create_info, NULL, &depth_buffer_sample_view);
+		if (err != VK_SUCCESS)
+			Sys_Error ("vkCreateImageView failed");
+
+		GL_SetObjectName ((uint64_t)depth_buffer_sample_view, VK_OBJECT_TYPE_IMAGE_VIEW, "Depth Buffer Sample View");
+	}
+}
+
+/*
+===============
+GL_CreateDepthPyramid
+===============
+*/
+static void GL_CreateDepthPyramid (void)
+{
+	if (!vulkan_globals.occlusion_culling)
+		return;
+
+	Sys_Printf ("Creating depth pyramid\n");
+
+	VkResult err;
+
+	// Every texel of the first level covers 2x2 depth buffer pixels, down to 1x1
+	depth_pyramid_width = (vid.width + 1) / 2;
+	depth_pyramid_height = (vid.height + 1) / 2;
+	num_depth_pyramid_levels = 1;
+	while ((num_depth_pyramid_levels < MAX_DEPTH_PYRAMID_LEVELS) &&
+		   (((depth_pyramid_width >> num_depth_pyramid_levels) > 0) || ((depth_pyramid_height >> num_depth_pyramid_levels) > 0)))
+		++num_depth_pyramid_levels;
+
+	ZEROED_STRUCT (VkImageCreateInfo, image_create_info);
+	image_create_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	image_create_info.imageType = VK_IMAGE_TYPE_2D;
+	image_create_info.format = VK_FORMAT_R32_SFLOAT;
+	image_create_info.extent.width = depth_pyramid_width;
+	image_create_info.extent.height = depth_pyramid_height;
+	image_create_info.extent.depth = 1;
+	image_create_info.mipLevels = num_depth_pyramid_levels;
+	image_create_info.arrayLayers = 1;
+	image_create_info.samples = VK_SAMPLE_COUNT_1_BIT;
+	image_create_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+	image_create_info.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT;
+
+	assert (depth_pyramid == VK_NULL_HANDLE);
+	err = vkCreateImage (vulkan_globals.device, &image_create_info, NULL, &depth_pyramid);
+	if (err != VK_SUCCESS)
+		Sys_Error ("vkCreateImage failed");
+
+	GL_SetObjectName ((uint64_t)depth_pyramid, VK_OBJECT_TYPE_IMAGE, "Depth Pyramid");
+	R_InitFrameImage (&depth_pyramid_frame_image, depth_pyramid, VK_IMAGE_ASPECT_COLOR_BIT, num_depth_pyramid_levels);
+
+	VkMemoryRequirements memory_requirements;
+	vkGetImageMemoryRequirements (vulkan_globals.device, depth_pyramid, &memory_requirements);
+
+	ZEROED_STRUCT (VkMemoryAllocateInfo, memory_allocate_info);
+	memory_allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	memory_allocate_info.allocationSize = memory_requirements.size;
+	memory_allocate_info.memoryTypeIndex = GL_MemoryTypeFromProperties (memory_requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0);
+
+	assert (depth_pyramid_memory.handle == VK_NULL_HANDLE);
+	R_AllocateVulkanMemory (&depth_pyramid_memory, &memory_allocate_info, VULKAN_MEMORY_TYPE_DEVICE, &num_vulkan_misc_allocations);
+	GL_SetObjectName ((uint64_t)depth_pyramid_memory.handle, VK_OBJECT_TYPE_DEVICE_MEMORY, "Depth Pyramid");
+
+	err = vkBindImageMemory (vulkan_globals.device, depth_pyramid, depth_pyramid_memory.handle, 0);
+	if (err != VK_SUCCESS)
+		Sys_Error ("vkBindImageMemory failed");
+
+	ZEROED_STRUCT (VkImageViewCreateInfo, image_view_create_info);
+	image_view_create_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	image_view_create_info.format = VK_FORMAT_R32_SFLOAT;
+	image_view_create_info.image = depth_pyramid;
+	image_view_create_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	image_view_create_info.subresourceRange.baseMipLevel = 0;
+	image_view_create_info.subresourceRange.levelCount = num_depth_pyramid_levels;
+	image_view_create_info.subresourceRange.baseArrayLayer = 0;
+	image_view_create_info.subresourceRange.layerCount = 1;
+	image_view_create_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+
+	assert (depth_pyramid_view == VK_NULL_HANDLE);
+	err = vkCreateImageView (vulkan_globals.device, &image_view_create_info, NULL, &depth_pyramid_view);
+	if (err != VK_SUCCESS)
+		Sys_Error ("vkCreateImageView failed");
+	GL_SetObjectName ((uint64_t)depth_pyramid_view, VK_OBJECT_TYPE_IMAGE_VIEW, "Depth Pyramid View");
+
+	for (int i = 0; i < num_depth_pyramid_levels; ++i)
+	{
+		image_view_create_info.subresourceRange.baseMipLevel = i;
+		image_view_create_info.subresourceRange.levelCount = 1;
+
+		assert (depth_pyramid_level_views[i] == VK_NULL_HANDLE);
+		err = vkCreateImageView (vulkan_globals.device, &image_view_create_info, NULL, &depth_pyramid_level_views[i]);
+		if (err != VK_SUCCESS)
+			Sys_Error ("vkCreateImageView failed");
+		GL_SetObjectName ((uint64_t)depth_pyramid_level_views[i], VK_OBJECT_TYPE_IMAGE_VIEW, va ("Depth Pyramid Level View %d", i));
+	}
+
+	if (depth_pyramid_sampler == VK_NULL_HANDLE)
+	{
+		ZEROED_STRUCT (VkSamplerCreateInfo, sampler_create_info);
+		sampler_create_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+		sampler_create_info.magFilter = VK_FILTER_NEAREST;
+		sampler_create_info.minFilter = VK_FILTER_NEAREST;
+		sampler_create_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+		sampler_create_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		sampler_create_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		sampler_create_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		sampler_create_info.maxLod = VK_LOD_CLAMP_NONE;
+
+		err = vkCreateSampler (vulkan_globals.device, &sampler_create_info, NULL, &depth_pyramid_sampler);
+		if (err != VK_SUCCESS)
+			Sys_Error ("vkCreateSampler failed");
+		GL_SetObjectName ((uint64_t)depth_pyramid_sampler, VK_OBJECT_TYPE_SAMPLER, "depth_pyramid");
+	}
+
+	// Level N is downsampled from level N - 1, the first level from the depth buffer
+	for (int i = 0; i < num_depth_pyramid_levels; ++i)
+	{
+		depth_pyramid_input_desc_sets[i] = R_AllocateDescriptorSet (&vulkan_globals.single_texture_set_layout);
+		depth_pyramid_output_desc_sets[i] = R_AllocateDescriptorSet (&vulkan_globals.single_texture_cs_write_set_layout);
+
+		ZEROED_STRUCT (VkDescriptorImageInfo, input_image_info);
+		input_image_info.imageView = (i == 0) ? depth_buffer_sample_view : depth_pyramid_level_views[i - 1];
+		input_image_info.imageLayout = (i == 0) ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_GENERAL;
+		input_image_info.sampler = depth_pyramid_sampler;
+
+		ZEROED_STRUCT (VkDescriptorImageInfo, output_image_info);
+		output_image_info.imageView = depth_pyramid_level_views[i];
+		output_image_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+		ZEROED_STRUCT_ARRAY (VkWriteDescriptorSet, pyramid_writes, 2);
+		pyramid_writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		pyramid_writes[0].dstBinding = 0;
+		pyramid_writes[0].dstArrayElement = 0;
+		pyramid_writes[0].descriptorCount = 1;
+		pyramid_writes[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		pyramid_writes[0].dstSet = depth_pyramid_input_desc_sets[i];
+		pyramid_writes[0].pImageInfo = &input_image_info;
+
+		pyramid_writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		pyramid_writes[1].dstBinding = 0;
+		pyramid_writes[1].dstArrayElement = 0;
+		pyramid_writes[1].descriptorCount = 1;
+		pyramid_writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+		pyramid_writes[1].dstSet = depth_pyramid_output_desc_sets[i];
+		pyramid_writes[1].pImageInfo = &output_image_info;
+
+		vkUpdateDescriptorSets (vulkan_globals.device, countof (pyramid_writes), pyramid_writes, 0, NULL);
+	}
+
+	vulkan_globals.depth_pyramid_desc_set = R_AllocateDescriptorSet (&vulkan_globals.single_texture_set_layout);
+
+	ZEROED_STRUCT (VkDescriptorImageInfo, pyramid_image_info);
+	pyramid_image_info.imageView = depth_pyramid_view;
+	pyramid_image_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+	pyramid_image_info.sampler = depth_pyramid_sampler;
+
+	ZEROED_STRUCT (VkWriteDescriptorSet, pyramid_write);
+	pyramid_write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	pyramid_write.dstBinding = 0;
+	pyramid_write.dstArrayElement = 0;
+	pyramid_write.descriptorCount = 1;
+	pyramid_write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	pyramid_write.dstSet = vulkan_globals.depth_pyramid_desc_set;
+	pyramid_write.pImageInfo = &pyramid_image_info;
+
+	vkUpdateDescriptorSets (vulkan_globals.device, 1, &pyramid_write, 0, NULL);
+}
+
+/*
+===============
+GL_DestroyDepthPyramid
+===============
+*/
+static void GL_DestroyDepthPyramid (void)
+{
+	if (depth_pyramid == VK_NULL_HANDLE)
+		return;
+
+	R_FreeDescriptorSet (vulkan_globals.depth_pyramid_desc_set, &vulkan_globals.single_texture_set_layout);
+	vulkan_globals.depth_pyramid_desc_set = VK_NULL_HANDLE;
+
+	for (int i = 0; i < num_depth_pyramid_levels; ++i)
+	{
+		R_FreeDescriptorSet (depth_pyramid_input_desc_sets[i], &vulkan_globals.single_texture_set_layout);
+		R_FreeDescriptorSet (depth_pyramid_output_desc_sets[i], &vulkan_globals.single_texture_cs_write_set_layout);
+		depth_pyramid_input_desc_sets[i] = VK_NULL_HANDLE;
+		depth_pyramid_output_desc_sets[i] = VK_NULL_HANDLE;
+
+		vkDestroyImageView (vulkan_globals.device, depth_pyramid_level_views[i], NULL);
+		depth_pyramid_level_views[i] = VK_NULL_HANDLE;
+	}
+
+	vkDestroyImageView (vulkan_globals.device, depth_pyramid_view, NULL);
+	vkDestroyImage (vulkan_globals.device, depth_pyramid, NULL);
+	R_FreeVulkanMemory (&depth_pyramid_memory, &num_vulkan_misc_allocations);
+
+	depth_pyramid_view = VK_NULL_HANDLE;
+	depth_pyramid = VK_NULL_HANDLE;
+	num_depth_pyramid_levels = 0;
+}
+
+/*
+===============
+GL_CreateShadingRateImage
+===============
+*/
+static void GL_CreateShadingRateImage (void)
+{
+	if (!vulkan_globals.shading_rate)
+		return;
+
+	Sys_Printf ("Creating shading rate image\n");
+
+	VkResult err;
+
+	const int texel_size = vulkan_globals.shading_rate_texel_size;
+	shading_rate_width = (vid.width + texel_size - 1) / texel_size;
+	shading_rate_height = (vid.height + texel_size - 1) / texel_size;
+
+	ZEROED_STRUCT (VkImageCreateInfo, image_create_info);
+	image_create_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	image_create_info.imageType = VK_IMAGE_TYPE_2D;
+	image_create_info.format = VK_FORMAT_R8_UINT;
+	image_create_info.extent.width = shading_rate_width;
+	image_create_info.extent.height = shading_rate_height;
+	image_create_info.extent.depth = 1;
+	image_create_info.mipLevels = 1;
+	image_create_info.arrayLayers = 1;
+	image_create_info.samples = VK_SAMPLE_COUNT_1_BIT;
+	image_create_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+	image_create_info.usage =
+		VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+	assert (shading_rate_image == VK_NULL_HANDLE);
+	err = vkCreateImage (vulkan_globals.device, &image_create_info, NULL, &shading_rate_image);
+	if (err != VK_SUCCESS)
+		Sys_Error ("vkCreateImage failed");
+
+	GL_SetObjectName ((uint64_t)shading_rate_image, VK_OBJECT_TYPE_IMAGE, "Shading Rate Image");
+	R_InitFrameImage (&shading_rate_frame_image, shading_rate_image, VK_IMAGE_ASPECT_COLOR_BIT, 1);
+
+	VkMemoryRequirements memory_requirements;
+	vkGetImageMemoryRequirements (vulkan_globals.device, shading_rate_image, &memory_requirements);
+
+	ZEROED_STRUCT (VkMemoryAllocateInfo, memory_allocate_info);
+	memory_allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	memory_allocate_info.allocationSize = memory_requirements.size;
+	memory_allocate_info.memoryTypeIndex = GL_MemoryTypeFromProperties (memory_requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0);
+
+	assert (shading_rate_image_memory.handle == VK_NULL_HANDLE);
+	R_AllocateVulkanMemory (&shading_rate_image_memory, &memory_allocate_info, VULKAN_MEMORY_TYPE_DEVICE, &num_vulkan_misc_allocations);
+	GL_SetObjectName ((uint64_t)shading_rate_image_memory.handle, VK_OBJECT_TYPE_DEVICE_MEMORY, "Shading Rate Image");
+
+	err = vkBindImageMemory (vulkan_globals.device, shading_rate_image, shading_rate_image_memory.handle, 0);
+	if (err != VK_SUCCESS)
+		Sys_Error ("vkBindImageMemory failed");
+
+	ZEROED_STRUCT (VkImageViewCreateInfo, image_view_create_info);
+	image_view_create_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	image_view_create_info.format = VK_FORMAT_R8_UINT;
+	image_view_create_info.image = shading_rate_image;
+	image_view_create_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	image_view_create_info.subresourceRange.baseMipLevel = 0;
+	image_view_create_info.subresourceRange.levelCount = 1;
+	image_view_create_info.subresourceRange.baseArrayLayer = 0;
+	image_view_create_info.subresourceRange.layerCount = 1;
+	image_view_create_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+
+	assert (shading_rate_image_view == VK_NULL_HANDLE);
+	err = vkCreateImageView (vulkan_globals.device, &image_view_create_info, NULL, &shading_rate_image_view);
+	if (err != VK_SUCCESS)
+		Sys_Error ("vkCreateImageView failed");
+	GL_SetObjectName ((uint64_t)shading_rate_image_view, VK_OBJECT_TYPE_IMAGE_VIEW, "Shading Rate Image View");
+
+	// Scene color and depth of the finished frame in, rates out, see GL_BuildShadingRateImage
+	shading_rate_desc_sets[0] = R_AllocateDescriptorSet (&vulkan_globals.single_texture_set_layout);
+	shading_rate_desc_sets[1] = R_AllocateDescriptorSet (&vulkan_globals.single_texture_set_layout);
+	shading_rate_desc_sets[2] = R_AllocateDescriptorSet (&vulkan_globals.single_texture_cs_write_set_layout);
+
+	ZEROED_STRUCT (VkDescriptorImageInfo, color_image_info);
+	color_image_info.imageView = color_buffers_view[0];
+	color_image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	color_image_info.sampler = vulkan_globals.point_sampler;
+
+	ZEROED_STRUCT (VkDescriptorImageInfo, depth_image_info);
+	depth_image_info.imageView = depth_buffer_sample_view;
+	depth_image_info.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+	depth_image_info.sampler = vulkan_globals.point_sampler;
+
+	ZEROED_STRUCT (VkDescriptorImageInfo, output_image_info);
+	output_image_info.imageView = shading_rate_image_view;
+	output_image_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+	ZEROED_STRUCT_ARRAY (VkWriteDescriptorSet, shading_rate_writes, 3);
+	shading_rate_writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	shading_rate_writes[0].dstBinding = 0;
+	shading_rate_writes[0].dstArrayElement = 0;
+	shading_rate_writes[0].descriptorCount = 1;
+	shading_rate_writes[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	shading_rate_writes[0].dstSet = shading_rate_desc_sets[0];
+	shading_rate_writes[0].pImageInfo = &color_image_info;
+
+	shading_rate_writes[1] = shading_rate_writes[0];
+	shading_rate_writes[1].dstSet = shading_rate_desc_sets[1];
+	shading_rate_writes[1].pImageInfo = &depth_image_info;
+
+	shading_rate_writes[2].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	shading_rate_writes[2].dstBinding = 0;
+	shading_rate_writes[2].dstArrayElement = 0;
+	shading_rate_writes[2].descriptorCount = 1;
+	shading_rate_writes[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+	shading_rate_writes[2].dstSet = shading_rate_desc_sets[2];
+	shading_rate_writes[2].pImageInfo = &output_image_info;
+
+	vkUpdateDescriptorSets (vulkan_globals.device, countof (shading_rate_writes), shading_rate_writes, 0, NULL);
+}
+
+/*
+===============
+GL_DestroyShadingRateImage
+===============
+*/
+static void GL_DestroyShadingRateImage (void)
+{
+	if (shading_rate_image == VK_NULL_HANDLE)
+		return;
+
+	R_FreeDescriptorSet (shading_rate_desc_sets[0], &vulkan_globals.single_texture_set_layout);
+	R_FreeDescriptorSet (shading_rate_desc_sets[1], &vulkan_globals.single_texture_set_layout);
+	R_FreeDescriptorSet (shading_rate_desc_sets[2], &vulkan_globals.single_texture_cs_write_set_layout);
+	memset (shading_rate_desc_sets, 0, sizeof (shading_rate_desc_sets));
+
+	vkDestroyImageView (vulkan_globals.device, shading_rate_image_view, NULL);
+	vkDestroyImage (vulkan_globals.device, shading_rate_image, NULL);
+	R_FreeVulkanMemory (&shading_rate_image_memory, &num_vulkan_misc_allocations);
+
+	shading_rate_image_view = VK_NULL_HANDLE;
+	shading_rate_image = VK_NULL_HANDLE;
 }
 
 /*
@@ -2154,10 +2957,10 @@ void GL_UpdateDescriptorSets (void)
 	output_image_info.imageView = color_buffers_view[0];
 	output_image_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
 
-	ZEROED_STRUCT (VkDescriptorBufferInfo, palette_octree_info);
-	palette_octree_info.buffer = palette_octree_buffer;
-	palette_octree_info.offset = 0;
-	palette_octree_info.range = VK_WHOLE_SIZE;
+	ZEROED_STRUCT (VkDescriptorImageInfo, palette_lut_info);
+	palette_lut_info.imageView = palette_lut_view;
+	palette_lut_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	palette_lut_info.sampler = vulkan_globals.point_sampler;
 
 	ZEROED_STRUCT (VkDescriptorImageInfo, blue_noise_image_info);
 	blue_noise_image_info.imageView = bluenoisetexture->image_view;
@@ -2201,9 +3004,9 @@ void GL_UpdateDescriptorSets (void)
 	screen_effects_writes[4].dstBinding = 4;
 	screen_effects_writes[4].dstArrayElement = 0;
 	screen_effects_writes[4].descriptorCount = 1;
-	screen_effects_writes[4].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	screen_effects_writes[4].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
 	screen_effects_writes[4].dstSet = vulkan_globals.screen_effects_desc_set;
-	screen_effects_writes[4].pBufferInfo = &palette_octree_info;
+	screen_effects_writes[4].pImageInfo = &palette_lut_info;
 
 	vkUpdateDescriptorSets (vulkan_globals.device, countof (screen_effects_writes), screen_effects_writes, 0, NULL);
 
@@ -2433,6 +3236,10 @@ static qboolean GL_CreateSwapChain (void)
 	vulkan_globals.swap_chain_format = swap_chain_format;
 	Mem_Free (surface_formats);
 
+	// present ids of the old swap chain can't be waited for on the new one
+	latency_waited_present_id = latency_presented_id;
+	latency_last_vblank = 0.0;
+
 	assert (vulkan_swapchain == VK_NULL_HANDLE);
 	err = fpCreateSwapchainKHR (vulkan_globals.device, &swapchain_create_info, NULL, &vulkan_swapchain);
 	if (err != VK_SUCCESS)
@@ -2493,7 +3300,7 @@ static qboolean GL_CreateSwapChain (void)
 		GL_SetObjectName ((uint64_t)swapchain_images_views[i], VK_OBJECT_TYPE_IMAGE_VIEW, "Swap Chain View");
 	}
 
-	for (i = 0; i < DOUBLE_BUFFERED; ++i)
+	for (i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
 	{
 		assert (image_aquired_semaphores[i] == VK_NULL_HANDLE);
 		err = vkCreateSemaphore (vulkan_globals.device, &semaphore_create_info, NULL, &image_aquired_semaphores[i]);
@@ -2541,7 +3348,9 @@ static void GL_CreateFrameBuffers (void)
 		framebuffer_create_info.height = vid.height;
 		framebuffer_create_info.layers = 1;
 
-		VkImageView attachments[3] = {color_buffers_view[i], depth_buffer_view, msaa_color_buffer_view};
+		VkImageView attachments[4] = {color_buffers_view[i], depth_buffer_view, msaa_color_buffer_view};
+		if (vulkan_globals.shading_rate)
+			attachments[framebuffer_create_info.attachmentCount++] = shading_rate_image_view;
 		framebuffer_create_info.pAttachments = attachments;
 
 		assert (main_framebuffers[i] == VK_NULL_HANDLE);
@@ -2609,6 +3418,8 @@ static void GL_CreateRenderResources (void)
 
 	GL_CreateColorBuffer ();
 	GL_CreateDepthBuffer ();
+	GL_CreateDepthPyramid ();
+	GL_CreateShadingRateImage ();
 	GL_CreateRenderPasses ();
 	GL_CreateFrameBuffers ();
 	R_CreatePipelines ();
@@ -2665,6 +3476,10 @@ static void GL_CreateRenderResources (void)
 		rmlui_config.cmd_push_constants = vulkan_globals.vk_cmd_push_constants;
 		rmlui_config.cmd_set_scissor = vkCmdSetScissor;
 		rmlui_config.cmd_set_viewport = vkCmdSetViewport;
+		rmlui_config.pipeline_cache = vulkan_globals.pipeline_cache;
+		rmlui_config.staging_allocate = R_StagingAllocate;
+		rmlui_config.staging_begin_copy = R_StagingBeginCopy;
+		rmlui_config.staging_end_copy = R_StagingEndCopy;
 		UI_InitializeVulkan (&rmlui_config);
 		UI_SetPixelRatio (VID_GetPixelRatio ());
 	}
@@ -2681,6 +3496,7 @@ static void GL_DestroyRenderResources (void)
 	render_resources_created = false;
 
 	GL_WaitForDeviceIdle ();
+	GL_FinishScreenshots ();
 
 	R_DestroyPipelines ();
 
@@ -2712,11 +3528,17 @@ static void GL_DestroyRenderResources (void)
 		vulkan_globals.color_buffers[i] = VK_NULL_HANDLE;
 	}
 
+	GL_DestroyDepthPyramid ();
+	GL_DestroyShadingRateImage ();
+
 	vkDestroyImageView (vulkan_globals.device, depth_buffer_view, NULL);
+	if (depth_buffer_sample_view != VK_NULL_HANDLE)
+		vkDestroyImageView (vulkan_globals.device, depth_buffer_sample_view, NULL);
 	vkDestroyImage (vulkan_globals.device, depth_buffer, NULL);
 	R_FreeVulkanMemory (&depth_buffer_memory, &num_vulkan_misc_allocations);
 
 	depth_buffer_view = VK_NULL_HANDLE;
+	depth_buffer_sample_view = VK_NULL_HANDLE;
 	depth_buffer = VK_NULL_HANDLE;
 
 	for (int i = 0; i < NUM_COLOR_BUFFERS; ++i)
@@ -2742,7 +3564,7 @@ static void GL_DestroyRenderResources (void)
 		swapchain_images[i] = VK_NULL_HANDLE;
 	}
 
-	for (int i = 0; i < DOUBLE_BUFFERED; ++i)
+	for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
 	{
 		vkDestroySemaphore (vulkan_globals.device, image_aquired_semaphores[i], NULL);
 		image_aquired_semaphores[i] = VK_NULL_HANDLE;
@@ -2762,6 +3584,8 @@ static void GL_DestroyRenderResources (void)
 		vkDestroyRenderPass (vulkan_globals.device, vulkan_globals.secondary_cb_contexts[SCBX_GUI][0].render_pass, NULL);
 		for (int i = 0; i < SECONDARY_CB_MULTIPLICITY[SCBX_GUI]; ++i)
 			vulkan_globals.secondary_cb_contexts[SCBX_GUI][i].render_pass = VK_NULL_HANDLE;
+		for (int i = 0; i < SECONDARY_CB_MULTIPLICITY[SCBX_RMLUI]; ++i)
+			vulkan_globals.secondary_cb_contexts[SCBX_RMLUI][i].render_pass = VK_NULL_HANDLE;
 	}
 
 	vkDestroyRenderPass (vulkan_globals.device, vulkan_globals.postprocess_render_pass, NULL);
@@ -2783,6 +3607,36 @@ static void GL_DestroyRenderResources (void)
 	}
 }
 
+const char *const gpu_timer_names[GPU_TIMER_NUM] = {
+	"accel", "lightmap", "warp",	  "partupd",   "world",	   "entities", "sky", "alphaw",
+	"water", "alpha",	 "particle", "viewmodel", "depthpyr", "screenfx", "ui",  "postfx",
+};
+
+/*
+=================
+GL_BeginGPUTimer
+
+Queries 0 and 1 of a frame span all primary command buffers, the ones after them hold a begin/end pair per gpu_timer_t.
+All of them are written every frame, so the pool read after the fence never reports VK_NOT_READY.
+=================
+*/
+static void GL_BeginGPUTimer (VkCommandBuffer cb, int cb_index, gpu_timer_t timer)
+{
+	if (frame_timestamp_query_pool != VK_NULL_HANDLE)
+		vkCmdWriteTimestamp (cb, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame_timestamp_query_pool, cb_index * GPU_QUERIES_PER_FRAME + 2 + timer * 2);
+}
+
+/*
+=================
+GL_EndGPUTimer
+=================
+*/
+static void GL_EndGPUTimer (VkCommandBuffer cb, int cb_index, gpu_timer_t timer)
+{
+	if (frame_timestamp_query_pool != VK_NULL_HANDLE)
+		vkCmdWriteTimestamp (cb, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame_timestamp_query_pool, cb_index * GPU_QUERIES_PER_FRAME + 3 + timer * 2);
+}
+
 /*
 =================
 GL_BeginRenderingTask
@@ -2803,7 +3657,28 @@ void GL_BeginRenderingTask (void *unused)
 	if (err != VK_SUCCESS)
 		Sys_Error ("vkResetFences failed");
 
-	R_CollectDynamicBufferGarbage ();
+	// Screenshots copied by the frame that last used this slot are in host memory now
+	if (frame_submitted[current_cb_index])
+		GL_EncodeScreenshots (current_cb_index);
+
+	// The fence guarantees the timestamps of the frame that last used this slot are available
+	if (frame_submitted[current_cb_index] && (frame_timestamp_query_pool != VK_NULL_HANDLE))
+	{
+		uint64_t timestamps[GPU_QUERIES_PER_FRAME];
+		err = vkGetQueryPoolResults (
+			vulkan_globals.device, frame_timestamp_query_pool, current_cb_index * GPU_QUERIES_PER_FRAME, GPU_QUERIES_PER_FRAME, sizeof (timestamps),
+			timestamps, sizeof (uint64_t), VK_QUERY_RESULT_64_BIT);
+		if (err == VK_SUCCESS)
+		{
+			const uint64_t mask = (gfx_timestamp_valid_bits >= 64) ? UINT64_MAX : ((1ull << gfx_timestamp_valid_bits) - 1);
+			const double   period = vulkan_globals.device_properties.limits.timestampPeriod / 1e6;
+			last_frame_gpu_time = (double)((timestamps[1] - timestamps[0]) & mask) * period;
+			for (int i = 0; i < GPU_TIMER_NUM; ++i)
+				last_frame_gpu_timers[i] = (double)((timestamps[3 + i * 2] - timestamps[2 + i * 2]) & mask) * period;
+		}
+	}
+
+	R_AdvanceGarbageFrame ();
 	R_CollectMeshBufferGarbage ();
 	TexMgr_CollectGarbage ();
 #ifdef USE_RMLUI
@@ -2825,9 +3700,36 @@ void GL_BeginRenderingTask (void *unused)
 		if (err != VK_SUCCESS)
 			Sys_Error ("vkBeginCommandBuffer failed");
 
+		if ((pcbx_index == 0) && (frame_timestamp_query_pool != VK_NULL_HANDLE))
+		{
+			vkCmdResetQueryPool (cbx->cb, frame_timestamp_query_pool, current_cb_index * GPU_QUERIES_PER_FRAME, GPU_QUERIES_PER_FRAME);
+			vkCmdWriteTimestamp (cbx->cb, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame_timestamp_query_pool, current_cb_index * GPU_QUERIES_PER_FRAME);
+		}
+		if (pcbx_index < PCBX_RENDER_PASSES)
+			GL_BeginGPUTimer (cbx->cb, current_cb_index, (gpu_timer_t)pcbx_index);
+
 		R_BeginDebugUtilsLabel (cbx, "Primary CB");
 	}
 
+	vulkan_globals.async_compute = (vulkan_globals.compute_queue != VK_NULL_HANDLE) && (r_asynccompute.value != 0.0f);
+	if (vulkan_globals.async_compute)
+	{
+		cb_context_t *cbx = &vulkan_globals.async_compute_cb_context;
+		cbx->cb = async_compute_command_buffers[current_cb_index];
+		cbx->current_canvas = CANVAS_INVALID;
+		memset (&cbx->current_pipeline, 0, sizeof (cbx->current_pipeline));
+
+		ZEROED_STRUCT (VkCommandBufferBeginInfo, command_buffer_begin_info);
+		command_buffer_begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		command_buffer_begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+		err = vkBeginCommandBuffer (cbx->cb, &command_buffer_begin_info);
+		if (err != VK_SUCCESS)
+			Sys_Error ("vkBeginCommandBuffer failed");
+
+		R_BeginDebugUtilsLabel (cbx, "Async Compute CB");
+	}
+
 	for (int scbx_index = 0; scbx_index < SCBX_NUM; ++scbx_index)
 	{
 		for (int i = 0; i < SECONDARY_CB_MULTIPLICITY[scbx_index]; ++i)
@@ -2849,7 +3751,7 @@ void GL_BeginRenderingTask (void *unused)
 			inheritance_info.subpass = cbx->subpass;
 
 			ZEROED_STRUCT (VkCommandBufferInheritanceRenderingInfoKHR, inheritance_rendering_info);
-			if (vulkan_globals.dynamic_rendering && scbx_index == SCBX_GUI)
+			if (vulkan_globals.dynamic_rendering && (scbx_index == SCBX_GUI || scbx_index == SCBX_RMLUI))
 			{
 				inheritance_rendering_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO_KHR;
 				inheritance_rendering_info.colorAttachmentCount = 1;
@@ -2868,6 +3770,9 @@ void GL_BeginRenderingTask (void *unused)
 			if (err != VK_SUCCESS)
 				Sys_Error ("vkBeginCommandBuffer failed");
 
+			if ((scbx_index <= SCBX_VIEW_MODEL) && (i == 0))
+				GL_BeginGPUTimer (cbx->cb, current_cb_index, GPU_TIMER_WORLD + scbx_index);
+
 			R_BeginDebugUtilsLabel (cbx, va ("CBX %d", scbx_index));
 
 			VkRect2D render_area;
@@ -2897,6 +3802,58 @@ void GL_BeginRenderingTask (void *unused)
 	R_SwapDynamicBuffers ();
 }
 
+/*
+=================
+GL_GetLastFrameGPUTimer
+
+GPU time in milliseconds of one pass of the most recently completed frame, 0 if timestamps are unsupported
+=================
+*/
+double GL_GetLastFrameGPUTimer (gpu_timer_t timer)
+{
+	return last_frame_gpu_timers[timer];
+}
+
+/*
+=================
+GL_GetLastFrameGPUTime
+
+GPU time in milliseconds of the most recently completed frame, 0 if timestamps are unsupported
+=================
+*/
+double GL_GetLastFrameGPUTime (void)
+{
+	return last_frame_gpu_time;
+}
+
+/*
+=================
+GL_QueryMemoryBudget
+
+Fills usage and budget in bytes of every memory heap, false if VK_EXT_memory_budget is unsupported
+=================
+*/
+qboolean GL_QueryMemoryBudget (VkDeviceSize *heap_usage, VkDeviceSize *heap_budget)
+{
+	if (!vulkan_globals.memory_budget)
+		return false;
+
+	ZEROED_STRUCT (VkPhysicalDeviceMemoryBudgetPropertiesEXT, memory_budget_properties);
+	memory_budget_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+	ZEROED_STRUCT (VkPhysicalDeviceMemoryProperties2, memory_properties_2);
+	memory_properties_2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+	memory_properties_2.pNext = &memory_budget_properties;
+	fpGetPhysicalDeviceMemoryProperties2 (vulkan_physical_device, &memory_properties_2);
+
+	for (uint32_t i = 0; i < VK_MAX_MEMORY_HEAPS; i++)
+	{
+		heap_usage[i] = memory_budget_properties.heapUsage[i];
+		heap_budget[i] = memory_budget_properties.heapBudget[i];
+	}
+	return true;
+}
+
 /*
 =================
 GL_SynchronizeEndRenderingTask
@@ -2915,6 +3872,94 @@ void GL_SynchronizeEndRenderingTask (void)
 	}
 }
 
+/*
+=================
+GL_WaitForLowLatencyFrame
+
+Called before input is sampled when vid_lowlatency is set. Waits until the last frame is on screen, then
+sleeps for the part of the refresh period the next frame isn't expected to need, so it finishes just
+before the following vblank instead of queueing behind the frames already presented.
+=================
+*/
+void GL_WaitForLowLatencyFrame (void)
+{
+	if (!vulkan_globals.present_wait || !vid_lowlatency.value)
+	{
+		latency_input_to_present = 0.0;
+		return;
+	}
+
+	GL_SynchronizeEndRenderingTask ();
+	const uint64_t present_id = latency_presented_id;
+	if ((present_id > latency_waited_present_id) && (vulkan_swapchain != VK_NULL_HANDLE))
+	{
+		latency_waited_present_id = present_id;
+		const VkResult err = fpWaitForPresentKHR (vulkan_globals.device, vulkan_swapchain, present_id, 100 * 1000 * 1000);
+		const double   now = Sys_DoubleTime ();
+		if (err == VK_SUCCESS)
+		{
+			const int	 index = present_id % NUM_LATENCY_FRAMES;
+			const double latency = now - latency_input_times[index];
+			latency_input_to_present = (latency_input_to_present > 0.0) ? (latency_input_to_present * 0.9 + latency * 0.1) : latency;
+			const double cpu_time = q_max (0.0, latency_submit_times[index] - latency_input_times[index]);
+			latency_cpu_time = latency_cpu_time * 0.9 + cpu_time * 0.1;
+
+			// a missed vblank shows up as a longer interval, only track intervals close to the current estimate
+			const double interval = now - latency_last_vblank;
+			if ((latency_last_vblank > 0.0) && (interval < 0.1))
+			{
+				if ((latency_refresh_period == 0.0) || (interval < latency_refresh_period * 0.5))
+					latency_refresh_period = interval;
+				else if (interval < latency_refresh_period * 1.5)
+					latency_refresh_period = latency_refresh_period * 0.95 + interval * 0.05;
+			}
+			latency_last_vblank = now;
+
+			// keep a margin for variance in the CPU and GPU time of the next frame
+			const double frame_time = latency_cpu_time + GL_GetLastFrameGPUTime () / 1000.0;
+			const double wake_time = now + latency_refresh_period - (frame_time * 1.2) - 0.001;
+			double		 time;
+			while ((time = Sys_DoubleTime ()) < wake_time)
+			{
+				if ((wake_time - time) > (2.0f / 1000.0f))
+					SDL_Delay (1);
+			}
+		}
+	}
+
+	latency_input_time = Sys_DoubleTime ();
+}
+
+/*
+=================
+GL_GetInputLatency
+
+Input to present latency in milliseconds averaged over the last frames, 0 if vid_lowlatency isn't active
+=================
+*/
+double GL_GetInputLatency (void)
+{
+	return latency_input_to_present * 1000.0;
+}
+
+/*
+=================
+GL_SetFramesInFlight
+
+Command buffers, fences and semaphores exist for MAX_FRAMES_IN_FLIGHT slots, only
+the dynamic buffers are recreated. Waits for the device so no slot is in use.
+=================
+*/
+static void GL_SetFramesInFlight (int frames_in_flight)
+{
+	GL_WaitForDeviceIdle ();
+	GL_EncodeScreenshots (-1);
+	memset (frame_submitted, 0, sizeof (frame_submitted));
+	current_cb_index = 0;
+	R_SetFramesInFlight (frames_in_flight);
+	Con_DPrintf ("%d frames in flight\n", frames_in_flight);
+}
+
 /*
 =================
 GL_BeginRendering
@@ -2931,6 +3976,10 @@ qboolean GL_BeginRendering (qboolean use_tasks, task_handle_t *begin_rendering_t
 		vid.restart_next_frame = false;
 	}
 
+	const int frames_in_flight = CLAMP (2, (int)vid_framesinflight.value, MAX_FRAMES_IN_FLIGHT);
+	if (frames_in_flight != vulkan_globals.num_frames_in_flight)
+		GL_SetFramesInFlight (frames_in_flight);
+
 	if (!render_resources_created)
 	{
 		GL_CreateRenderResources ();
@@ -3021,8 +4070,15 @@ typedef struct screen_effect_constants_s
 	float	 poly_blend_g;
 	float	 poly_blend_b;
 	float	 poly_blend_a;
+	float	 render_scale;
 } screen_effect_constants_t;
 
+typedef struct postprocess_constants_s
+{
+	float					  postprocess[10];
+	screen_effect_constants_t screen_effects; // postprocess_fused only
+} postprocess_constants_t;
+
 typedef struct ray_debug_constants_s
 {
 	float screen_size_rcp_x;
@@ -3044,20 +4100,26 @@ typedef struct ray_debug_constants_s
 
 typedef struct end_rendering_parms_s
 {
-	uint32_t vid_width	   : 20;
-	qboolean swapchain	   : 1;
-	qboolean render_warp   : 1;
-	qboolean vid_palettize : 1;
-	qboolean menu		   : 1;
-	qboolean ray_debug	   : 1;
-	uint32_t render_scale  : 4;
-	uint32_t vid_height	   : 20;
-	float	 time;
-	uint8_t	 v_blend[4];
-	vec3_t	 origin;
-	vec3_t	 forward;
-	vec3_t	 right;
-	vec3_t	 down;
+	uint32_t		   vid_width	 : 20;
+	qboolean		   swapchain	 : 1;
+	qboolean		   render_warp	 : 1;
+	qboolean		   vid_palettize : 1;
+	qboolean		   menu			 : 1;
+	qboolean		   ray_debug	 : 1;
+	uint32_t		   render_scale	 : 4;
+	uint32_t		   vid_height	 : 20;
+	float			   time;
+	float			   dynamic_scale;
+	uint8_t			   v_blend[4];
+	vec3_t			   origin;
+	vec3_t			   forward;
+	vec3_t			   right;
+	vec3_t			   down;
+	float			   fog_density; // as used by the world shaders
+	float			   depth_a;		// view distance = depth_b / (depth + depth_a), from the projection matrix
+	float			   depth_b;
+	screenshot_slot_t *screenshot;
+	uint64_t		   present_id; // vid_lowlatency, 0 if unused
 } end_rendering_parms_t;
 
 #define SCREEN_EFFECT_FLAG_SCALE_MASK 0x3
@@ -3068,6 +4130,41 @@ typedef struct end_rendering_parms_s
 #define SCREEN_EFFECT_FLAG_PALETTIZE  0x8
 #define SCREEN_EFFECT_FLAG_MENU		  0x10
 
+/*
+===============
+GL_ScreenEffectConstants
+===============
+*/
+static void GL_ScreenEffectConstants (const end_rendering_parms_t *parms, screen_effect_constants_t *constants)
+{
+	uint32_t screen_effect_flags = 0;
+	if (parms->render_warp)
+		screen_effect_flags |= SCREEN_EFFECT_FLAG_WATER_WARP;
+	if (parms->render_scale >= 8)
+		screen_effect_flags |= SCREEN_EFFECT_FLAG_SCALE_8X;
+	else if (parms->render_scale >= 4)
+		screen_effect_flags |= SCREEN_EFFECT_FLAG_SCALE_4X;
+	else if (parms->render_scale >= 2)
+		screen_effect_flags |= SCREEN_EFFECT_FLAG_SCALE_2X;
+	if (parms->vid_palettize)
+		screen_effect_flags |= SCREEN_EFFECT_FLAG_PALETTIZE;
+	if (parms->menu)
+		screen_effect_flags |= SCREEN_EFFECT_FLAG_MENU;
+
+	constants->clamp_size_x = parms->vid_width - 1;
+	constants->clamp_size_y = parms->vid_height - 1;
+	constants->screen_size_rcp_x = 1.0f / (float)parms->vid_width;
+	constants->screen_size_rcp_y = 1.0f / (float)parms->vid_height;
+	constants->aspect_ratio = (float)parms->vid_width / (float)parms->vid_height;
+	constants->time = parms->time;
+	constants->flags = screen_effect_flags;
+	constants->poly_blend_r = (float)parms->v_blend[0] / 255.0f;
+	constants->poly_blend_g = (float)parms->v_blend[1] / 255.0f;
+	constants->poly_blend_b = (float)parms->v_blend[2] / 255.0f;
+	constants->poly_blend_a = (float)parms->v_blend[3] / 255.0f;
+	constants->render_scale = parms->dynamic_scale;
+}
+
 /*
 ===============
 GL_ScreenEffects
@@ -3141,33 +4238,8 @@ static void GL_ScreenEffects (cb_context_t *cbx, qboolean enabled, end_rendering
 		{
 			vkCmdBindDescriptorSets (cbx->cb, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->layout.handle, 0, 1, &vulkan_globals.screen_effects_desc_set, 0, NULL);
 
-			uint32_t screen_effect_flags = 0;
-			if (parms->render_warp)
-				screen_effect_flags |= SCREEN_EFFECT_FLAG_WATER_WARP;
-			if (parms->render_scale >= 8)
-				screen_effect_flags |= SCREEN_EFFECT_FLAG_SCALE_8X;
-			else if (parms->render_scale >= 4)
-				screen_effect_flags |= SCREEN_EFFECT_FLAG_SCALE_4X;
-			else if (parms->render_scale >= 2)
-				screen_effect_flags |= SCREEN_EFFECT_FLAG_SCALE_2X;
-			if (parms->vid_palettize)
-				screen_effect_flags |= SCREEN_EFFECT_FLAG_PALETTIZE;
-			if (parms->menu)
-				screen_effect_flags |= SCREEN_EFFECT_FLAG_MENU;
-
-			const screen_effect_constants_t push_constants = {
-				parms->vid_width - 1,
-				parms->vid_height - 1,
-				1.0f / (float)parms->vid_width,
-				1.0f / (float)parms->vid_height,
-				(float)parms->vid_width / (float)parms->vid_height,
-				parms->time,
-				screen_effect_flags,
-				(float)parms->v_blend[0] / 255.0f,
-				(float)parms->v_blend[1] / 255.0f,
-				(float)parms->v_blend[2] / 255.0f,
-				(float)parms->v_blend[3] / 255.0f,
-			};
+			screen_effect_constants_t push_constants;
+			GL_ScreenEffectConstants (parms, &push_constants);
 			R_PushConstants (cbx, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof (push_constants), &push_constants);
 		}
 #if defined(_DEBUG)
@@ -3231,11 +4303,91 @@ static void GL_ScreenEffects (cb_context_t *cbx, qboolean enabled, end_rendering
 	}
 }
 
-void ScheduleScreenshotCopy (VkCommandBuffer command_buffer, VkBuffer *buffer, vulkan_memory_t *memory)
+/*
+=================
+GL_ReserveScreenshotSlot
+
+Picks the slot the frame ending next is copied to, waiting for the oldest encode if all of them are busy
+=================
+*/
+static screenshot_slot_t *GL_ReserveScreenshotSlot (void)
 {
-	R_CreateBuffer (
-		buffer, memory, glwidth * glheight * 4, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, VK_MEMORY_PROPERTY_HOST_CACHED_BIT, NULL,
-		NULL, "Screenshot");
+	screenshot_slot_t *oldest = NULL;
+	for (int i = 0; i < NUM_SCREENSHOT_SLOTS; ++i)
+	{
+		screenshot_slot_t *slot = &screenshot_slots[i];
+		if ((Atomic_LoadUInt32 (&slot->state) == SCREENSHOT_SLOT_ENCODING) && Task_Join (slot->task, 0))
+			Atomic_StoreUInt32 (&slot->state, SCREENSHOT_SLOT_FREE);
+	}
+
+	for (int i = 0; i < NUM_SCREENSHOT_SLOTS; ++i)
+	{
+		screenshot_slot_t *slot = &screenshot_slots[i];
+		const uint32_t	   state = Atomic_LoadUInt32 (&slot->state);
+		if (state == SCREENSHOT_SLOT_FREE)
+		{
+			oldest = slot;
+			break;
+		}
+		if ((state == SCREENSHOT_SLOT_ENCODING) && (!oldest || (int32_t)(slot->sequence - oldest->sequence) < 0))
+			oldest = slot;
+	}
+	if (!oldest)
+		return NULL;
+
+	if (Atomic_LoadUInt32 (&oldest->state) == SCREENSHOT_SLOT_ENCODING)
+	{
+		Task_Join (oldest->task, TASK_TIMEOUT_INFINITE);
+		Atomic_StoreUInt32 (&oldest->state, SCREENSHOT_SLOT_FREE);
+	}
+
+	oldest->sequence = screenshot_sequence++;
+	if (capture_fps)
+	{
+		q_snprintf (oldest->name, sizeof (oldest->name), "%s/%06i.%s", capture_dir, capture_frame++, capture_ext);
+		memcpy (oldest->ext, capture_ext, sizeof (oldest->ext));
+		oldest->quality = capture_quality;
+		oldest->quiet = true;
+	}
+	else
+	{
+		q_strlcpy (oldest->name, screenshot_imagename, sizeof (oldest->name));
+		memcpy (oldest->ext, screenshot_ext, sizeof (oldest->ext));
+		oldest->quality = screenshot_quality;
+		oldest->quiet = false;
+	}
+	Atomic_StoreUInt32 (&oldest->state, SCREENSHOT_SLOT_RESERVED);
+	return oldest;
+}
+
+/*
+=================
+ScheduleScreenshotCopy
+=================
+*/
+static void ScheduleScreenshotCopy (VkCommandBuffer command_buffer, screenshot_slot_t *slot, int cb_index)
+{
+	const size_t size = (size_t)glwidth * glheight * 4;
+	if (slot->size != size)
+	{
+		if (slot->buffer != VK_NULL_HANDLE)
+		{
+			vkUnmapMemory (vulkan_globals.device, slot->memory.handle);
+			R_FreeBuffer (slot->buffer, &slot->memory, NULL);
+		}
+		R_CreateBuffer (
+			&slot->buffer, &slot->memory, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, VK_MEMORY_PROPERTY_HOST_CACHED_BIT,
+			NULL, NULL, "Screenshot");
+		void *data;
+		if (vkMapMemory (vulkan_globals.device, slot->memory.handle, 0, size, 0, &data) != VK_SUCCESS)
+			Sys_Error ("vkMapMemory failed");
+		slot->data = (byte *)data;
+		slot->size = size;
+	}
+	slot->width = glwidth;
+	slot->height = glheight;
+	slot->bgra = (vulkan_globals.swap_chain_format == VK_FORMAT_B8G8R8A8_UNORM) || (vulkan_globals.swap_chain_format == VK_FORMAT_B8G8R8A8_SRGB);
+	slot->cb_index = cb_index;
 
 	{
 		ZEROED_STRUCT (VkImageMemoryBarrier, image_barrier);
@@ -3246,7 +4398,7 @@ void ScheduleScreenshotCopy (VkCommandBuffer command_buffer, VkBuffer *buffer, v
 		image_barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
 		image_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 		image_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		image_barrier.image = swapchain_images[current_cb_index];
+		image_barrier.image = swapchain_images[current_swapchain_buffer];
 		image_barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
 		image_barrier.subresourceRange.baseMipLevel = 0;
 		image_barrier.subresourceRange.levelCount = 1;
@@ -3267,7 +4419,7 @@ void ScheduleScreenshotCopy (VkCommandBuffer command_buffer, VkBuffer *buffer, v
 	image_copy.imageExtent.height = glheight;
 	image_copy.imageExtent.depth = 1;
 
-	vkCmdCopyImageToBuffer (command_buffer, swapchain_images[current_cb_index], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, *buffer, 1, &image_copy);
+	vkCmdCopyImageToBuffer (command_buffer, swapchain_images[current_swapchain_buffer], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, slot->buffer, 1, &image_copy);
 
 	{
 		ZEROED_STRUCT (VkImageMemoryBarrier, image_barrier);
@@ -3278,7 +4430,7 @@ void ScheduleScreenshotCopy (VkCommandBuffer command_buffer, VkBuffer *buffer, v
 		image_barrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
 		image_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 		image_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		image_barrier.image = swapchain_images[current_cb_index];
+		image_barrier.image = swapchain_images[current_swapchain_buffer];
 		image_barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
 		image_barrier.subresourceRange.baseMipLevel = 0;
 		image_barrier.subresourceRange.levelCount = 1;
@@ -3287,28 +4439,37 @@ void ScheduleScreenshotCopy (VkCommandBuffer command_buffer, VkBuffer *buffer, v
 
 		vkCmdPipelineBarrier (command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, NULL, 0, NULL, 1, &image_barrier);
 	}
-}
 
-void WriteScreenshot (VkBuffer buffer, vulkan_memory_t memory)
-{
+	{
+		// make the host read visible once the fence of this command buffer is signaled
+		ZEROED_STRUCT (VkBufferMemoryBarrier, buffer_barrier);
+		buffer_barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		buffer_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		buffer_barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+		buffer_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		buffer_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		buffer_barrier.buffer = slot->buffer;
+		buffer_barrier.size = VK_WHOLE_SIZE;
 
-	vkDeviceWaitIdle (vulkan_globals.device);
-	vulkan_globals.device_idle = true;
+		vkCmdPipelineBarrier (command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, NULL, 1, &buffer_barrier, 0, NULL);
+	}
 
-	void *buffer_ptr;
-	vkMapMemory (vulkan_globals.device, memory.handle, 0, glwidth * glheight * 4, 0, &buffer_ptr);
+	Atomic_StoreUInt32 (&slot->state, SCREENSHOT_SLOT_COPYING);
+}
 
-	ZEROED_STRUCT (VkMappedMemoryRange, range);
-	range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-	range.memory = memory.handle;
-	range.size = VK_WHOLE_SIZE;
-	vkInvalidateMappedMemoryRanges (vulkan_globals.device, 1, &range);
+/*
+=================
+GL_EncodeScreenshotTask
+=================
+*/
+static void GL_EncodeScreenshotTask (screenshot_slot_t **slot_ptr)
+{
+	screenshot_slot_t *slot = *slot_ptr;
+	byte			  *data = slot->data;
 
-	qboolean bgra = (vulkan_globals.swap_chain_format == VK_FORMAT_B8G8R8A8_UNORM) || (vulkan_globals.swap_chain_format == VK_FORMAT_B8G8R8A8_SRGB);
-	if (bgra)
+	if (slot->bgra)
 	{
-		byte	 *data = (byte *)buffer_ptr;
-		const int size = glwidth * glheight * 4;
+		const int size = slot->width * slot->height * 4;
 		for (int i = 0; i < size; i += 4)
 		{
 			const byte temp = data[i];
@@ -3318,21 +4479,236 @@ void WriteScreenshot (VkBuffer buffer, vulkan_memory_t memory)
 	}
 
 	qboolean ok;
-	if (!q_strncasecmp (screenshot_ext, "png", sizeof (screenshot_ext)))
-		ok = Image_WritePNG (screenshot_imagename, buffer_ptr, glwidth, glheight, 32, true);
-	else if (!q_strncasecmp (screenshot_ext, "tga", sizeof (screenshot_ext)))
-		ok = Image_WriteTGA (screenshot_imagename, buffer_ptr, glwidth, glheight, 32, true);
-	else if (!q_strncasecmp (screenshot_ext, "jpg", sizeof (screenshot_ext)))
-		ok = Image_WriteJPG (screenshot_imagename, buffer_ptr, glwidth, glheight, 32, screenshot_quality, true);
+	if (!q_strncasecmp (slot->ext, "png", sizeof (slot->ext)))
+		ok = Image_WritePNG (slot->name, data, slot->width, slot->height, 32, true);
+	else if (!q_strncasecmp (slot->ext, "tga", sizeof (slot->ext)))
+		ok = Image_WriteTGA (slot->name, data, slot->width, slot->height, 32, true);
+	else if (!q_strncasecmp (slot->ext, "jpg", sizeof (slot->ext)))
+		ok = Image_WriteJPG (slot->name, data, slot->width, slot->height, 32, slot->quality, true);
 	else
 		ok = false;
 
-	if (ok)
-		Con_Printf ("Wrote %s\n", screenshot_imagename);
-	else
-		Con_Printf ("SCR_ScreenShot_f: Couldn't create %s\n", screenshot_imagename);
+	if (!ok)
+		Con_Printf ("SCR_ScreenShot_f: Couldn't create %s\n", slot->name);
+	else if (!slot->quiet)
+		Con_Printf ("Wrote %s\n", slot->name);
+}
+
+/*
+=================
+GL_EncodeScreenshots
+
+Hands the copies recorded in command buffer cb_index (-1 for all) to encode tasks. Its fence must have been waited on.
+=================
+*/
+static void GL_EncodeScreenshots (int cb_index)
+{
+	for (int i = 0; i < NUM_SCREENSHOT_SLOTS; ++i)
+	{
+		screenshot_slot_t *slot = &screenshot_slots[i];
+		if ((Atomic_LoadUInt32 (&slot->state) != SCREENSHOT_SLOT_COPYING) || ((cb_index >= 0) && (slot->cb_index != cb_index)))
+			continue;
+
+		ZEROED_STRUCT (VkMappedMemoryRange, range);
+		range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+		range.memory = slot->memory.handle;
+		range.size = VK_WHOLE_SIZE;
+		vkInvalidateMappedMemoryRanges (vulkan_globals.device, 1, &range);
+
+		slot->task = Task_AllocateAssignBackgroundFuncAndSubmit ((task_func_t)GL_EncodeScreenshotTask, &slot, sizeof (screenshot_slot_t *));
+		Atomic_StoreUInt32 (&slot->state, SCREENSHOT_SLOT_ENCODING);
+	}
+}
+
+/*
+=================
+GL_WaitForScreenshotEncodes
+=================
+*/
+static void GL_WaitForScreenshotEncodes (void)
+{
+	for (int i = 0; i < NUM_SCREENSHOT_SLOTS; ++i)
+	{
+		screenshot_slot_t *slot = &screenshot_slots[i];
+		if (Atomic_LoadUInt32 (&slot->state) == SCREENSHOT_SLOT_ENCODING)
+		{
+			Task_Join (slot->task, TASK_TIMEOUT_INFINITE);
+			Atomic_StoreUInt32 (&slot->state, SCREENSHOT_SLOT_FREE);
+		}
+	}
+}
+
+/*
+=================
+GL_FinishScreenshots
 
-	R_FreeBuffer (buffer, &memory, NULL);
+Writes all pending screenshots, the device must be idle
+=================
+*/
+static void GL_FinishScreenshots (void)
+{
+	GL_EncodeScreenshots (-1);
+	GL_WaitForScreenshotEncodes ();
+}
+
+/*
+=================
+GL_FreeScreenshotBuffers
+
+Frees the readback buffers of the slots that aren't in use
+=================
+*/
+static void GL_FreeScreenshotBuffers (void)
+{
+	for (int i = 0; i < NUM_SCREENSHOT_SLOTS; ++i)
+	{
+		screenshot_slot_t *slot = &screenshot_slots[i];
+		if ((Atomic_LoadUInt32 (&slot->state) != SCREENSHOT_SLOT_FREE) || (slot->buffer == VK_NULL_HANDLE))
+			continue;
+		vkUnmapMemory (vulkan_globals.device, slot->memory.handle);
+		R_FreeBuffer (slot->buffer, &slot->memory, NULL);
+		slot->buffer = VK_NULL_HANDLE;
+		slot->data = NULL;
+		slot->size = 0;
+	}
+}
+
+/*
+=================
+GL_BuildDepthPyramid
+
+Downsamples the depth buffer into a min (farthest, reversed Z) pyramid that
+the next frame's indirect compute culls world surfaces against
+=================
+*/
+static void GL_BuildDepthPyramid (cb_context_t *cbx)
+{
+	if (!vulkan_globals.occlusion_culling)
+		return;
+
+	R_BeginDebugUtilsLabel (cbx, "Depth Pyramid");
+
+	// Every level is fully rewritten, so the previous contents can be discarded
+	R_UseFrameImage (cbx, &depth_buffer_frame_image, RESOURCE_USE_DEPTH_READ_COMPUTE, false);
+	R_UseFrameImage (cbx, &depth_pyramid_frame_image, RESOURCE_USE_STORAGE_WRITE_COMPUTE, true);
+
+	R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_COMPUTE, vulkan_globals.depth_pyramid_pipeline);
+
+	for (int i = 0; i < num_depth_pyramid_levels; ++i)
+	{
+		const uint32_t first_level = (i == 0) ? 1 : 0;
+		const int	   level_width = q_max (1, depth_pyramid_width >> i);
+		const int	   level_height = q_max (1, depth_pyramid_height >> i);
+
+		// Every level after the first reads the previous one
+		if (i > 0)
+			R_UseFrameImage (cbx, &depth_pyramid_frame_image, RESOURCE_USE_STORAGE_WRITE_COMPUTE, false);
+		R_FlushBarriers (cbx);
+
+		VkDescriptorSet sets[2] = {depth_pyramid_input_desc_sets[i], depth_pyramid_output_desc_sets[i]};
+		vkCmdBindDescriptorSets (cbx->cb, VK_PIPELINE_BIND_POINT_COMPUTE, vulkan_globals.depth_pyramid_pipeline.layout.handle, 0, 2, sets, 0, NULL);
+		R_PushConstants (cbx, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof (uint32_t), &first_level);
+		vkCmdDispatch (cbx->cb, (level_width + 7) / 8, (level_height + 7) / 8, 1);
+	}
+
+	// Read by the next frame's indirect compute. The depth buffer goes back to the attachment layout before the next main render pass.
+	R_UseFrameImage (cbx, &depth_pyramid_frame_image, RESOURCE_USE_STORAGE_READ_COMPUTE, false);
+	R_FlushBarriers (cbx);
+
+	vulkan_globals.depth_pyramid_valid = true;
+
+	R_EndDebugUtilsLabel (cbx);
+}
+
+// keep in sync with shading_rate.comp, log2 of the fragment width in bits 2-3 and of the height in bits 0-1
+#define SHADING_RATE_1X1 0
+#define SHADING_RATE_2X2 5
+#define SHADING_RATE_4X4 10
+
+typedef struct
+{
+	uint32_t width;
+	uint32_t height;
+	uint32_t texel_size;
+	uint32_t min_rate;
+	uint32_t max_rate;
+	float	 fog_density;
+	float	 depth_a;
+	float	 depth_b;
+} shading_rate_constants_t;
+
+/*
+=================
+GL_ClearShadingRateImage
+
+A new shading rate image starts out at 1x1 until the first frame wrote it
+=================
+*/
+static void GL_ClearShadingRateImage (cb_context_t *cbx)
+{
+	if (!vulkan_globals.shading_rate || (shading_rate_frame_image.layout != VK_IMAGE_LAYOUT_UNDEFINED))
+		return;
+
+	R_UseFrameImage (cbx, &shading_rate_frame_image, RESOURCE_USE_TRANSFER_DST, true);
+	R_FlushBarriers (cbx);
+
+	VkClearColorValue clear_value;
+	memset (&clear_value, 0, sizeof (clear_value));
+	ZEROED_STRUCT (VkImageSubresourceRange, subresource_range);
+	subresource_range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	subresource_range.levelCount = 1;
+	subresource_range.layerCount = 1;
+	vkCmdClearColorImage (cbx->cb, shading_rate_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &clear_value, 1, &subresource_range);
+}
+
+/*
+=================
+GL_BuildShadingRateImage
+
+Picks a shading rate for every texel of the shading rate image from the
+luminance and depth of the finished frame, the next frame's main render
+pass shades with it. Expects the scene in color buffer 0 in shader read
+layout.
+=================
+*/
+static void GL_BuildShadingRateImage (cb_context_t *cbx, const end_rendering_parms_t *parms)
+{
+	if (!vulkan_globals.shading_rate)
+		return;
+
+	R_BeginDebugUtilsLabel (cbx, "Shading Rate Image");
+
+	// Scene color was written as an attachment or by the screen effects compute shader, and moved to shader read layout for the fragment shader
+	R_QueueMemoryBarrier (
+		cbx, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+		VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+		VK_ACCESS_2_SHADER_READ_BIT_KHR);
+	R_UseFrameImage (cbx, &depth_buffer_frame_image, RESOURCE_USE_DEPTH_READ_COMPUTE, false);
+	// Every texel is rewritten, so the rates of the last frame can be discarded
+	R_UseFrameImage (cbx, &shading_rate_frame_image, RESOURCE_USE_STORAGE_WRITE_COMPUTE, true);
+	R_FlushBarriers (cbx);
+
+	// Coarse everywhere while the view is warped or mostly covered by a color shift
+	const qboolean blurred = parms->render_warp || parms->menu || (parms->v_blend[3] >= 128);
+
+	shading_rate_constants_t constants;
+	constants.width = parms->vid_width;
+	constants.height = parms->vid_height;
+	constants.texel_size = vulkan_globals.shading_rate_texel_size;
+	constants.min_rate = blurred ? SHADING_RATE_2X2 : SHADING_RATE_1X1;
+	constants.max_rate = (r_vrs.value >= 2.0f) ? SHADING_RATE_4X4 : SHADING_RATE_2X2;
+	constants.fog_density = parms->fog_density;
+	constants.depth_a = parms->depth_a;
+	constants.depth_b = parms->depth_b;
+
+	R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_COMPUTE, vulkan_globals.shading_rate_pipeline);
+	vkCmdBindDescriptorSets (
+		cbx->cb, VK_PIPELINE_BIND_POINT_COMPUTE, vulkan_globals.shading_rate_pipeline.layout.handle, 0, countof (shading_rate_desc_sets),
+		shading_rate_desc_sets, 0, NULL);
+	R_PushConstants (cbx, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof (constants), &constants);
+	vkCmdDispatch (cbx->cb, shading_rate_width, shading_rate_height, 1);
+
+	R_EndDebugUtilsLabel (cbx);
 }
 
 /*
@@ -3348,6 +4724,13 @@ static void GL_EndRenderingTask (end_rendering_parms_t *parms)
 	VkResult err;
 	int		 cb_index = current_cb_index;
 
+	qboolean screen_effects = parms->render_warp || (parms->render_scale >= 2) || (parms->dynamic_scale < 1.0f) || parms->vid_palettize ||
+							  (gl_polyblend.value && parms->v_blend[3]) || parms->menu || parms->ray_debug;
+	// The fused path applies the screen effects while compositing, so the scene is read once instead of going through a compute pass first
+	const qboolean fused_screen_effects = screen_effects && r_fusedpostprocess.value && !parms->ray_debug;
+	if (fused_screen_effects)
+		screen_effects = false;
+
 	qboolean swapchain_acquired = parms->swapchain && GL_AcquireNextSwapChainImage ();
 	if (swapchain_acquired == true)
 	{
@@ -3355,18 +4738,37 @@ static void GL_EndRenderingTask (end_rendering_parms_t *parms)
 
 		// Render post process
 		GL_Viewport (cbx, 0, 0, vid.width, vid.height, 0.0f, 1.0f);
-		float postprocess_values[10] = {
-			vid_gamma.value,	   q_min (2.0f, q_max (1.0f, vid_contrast.value)),
-			r_ui_warp.value,	   r_ui_chromatic.value * (1080.0f / (float)vid.height),
-			v_hud_offset_x,		   v_hud_offset_y,
-			scr_sbaralpha.value,   r_ui_echo.value,
-			r_ui_echo_scale.value, r_ui_additive.value,
+		postprocess_constants_t push_constants = {
+			{
+				vid_gamma.value,
+				q_min (2.0f, q_max (1.0f, vid_contrast.value)),
+				r_ui_warp.value,
+				r_ui_chromatic.value * (1080.0f / (float)vid.height),
+				v_hud_offset_x,
+				v_hud_offset_y,
+				scr_sbaralpha.value,
+				r_ui_echo.value,
+				r_ui_echo_scale.value,
+				r_ui_additive.value,
+			},
 		};
 
-		R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.postprocess_pipeline);
-		VkDescriptorSet pp_sets[2] = {postprocess_descriptor_set, postprocess_ui_descriptor_set};
-		vkCmdBindDescriptorSets (cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.postprocess_pipeline.layout.handle, 0, 2, pp_sets, 0, NULL);
-		R_PushConstants (cbx, VK_SHADER_STAGE_FRAGMENT_BIT, 0, 10 * sizeof (float), postprocess_values);
+		if (fused_screen_effects)
+		{
+			GL_ScreenEffectConstants (parms, &push_constants.screen_effects);
+			R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.postprocess_fused_pipeline);
+			VkDescriptorSet pp_sets[3] = {postprocess_descriptor_set, postprocess_ui_descriptor_set, vulkan_globals.screen_effects_desc_set};
+			vkCmdBindDescriptorSets (
+				cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.postprocess_fused_pipeline.layout.handle, 0, 3, pp_sets, 0, NULL);
+			R_PushConstants (cbx, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof (push_constants), &push_constants);
+		}
+		else
+		{
+			R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.postprocess_pipeline);
+			VkDescriptorSet pp_sets[2] = {postprocess_descriptor_set, postprocess_ui_descriptor_set};
+			vkCmdBindDescriptorSets (cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.postprocess_pipeline.layout.handle, 0, 2, pp_sets, 0, NULL);
+			R_PushConstants (cbx, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof (push_constants.postprocess), push_constants.postprocess);
+		}
 		vkCmdDraw (cbx->cb, 3, 1, 0, 0);
 	}
 
@@ -3375,7 +4777,10 @@ static void GL_EndRenderingTask (end_rendering_parms_t *parms)
 		for (int i = 0; i < SECONDARY_CB_MULTIPLICITY[scbx_index]; ++i)
 		{
 			cb_context_t *cbx = &vulkan_globals.secondary_cb_contexts[scbx_index][i];
+			Draw_Flush (cbx);
 			R_EndDebugUtilsLabel (cbx);
+			if ((scbx_index <= SCBX_VIEW_MODEL) && (i == SECONDARY_CB_MULTIPLICITY[scbx_index] - 1))
+				GL_EndGPUTimer (cbx->cb, cb_index, GPU_TIMER_WORLD + scbx_index);
 			err = vkEndCommandBuffer (cbx->cb);
 			if (err != VK_SUCCESS)
 				Sys_Error ("vkEndCommandBuffer failed");
@@ -3399,8 +4804,16 @@ static void GL_EndRenderingTask (end_rendering_parms_t *parms)
 	clear_values[1] = depth_clear_value;
 	clear_values[2] = vulkan_globals.color_clear_value;
 
-	const qboolean screen_effects = parms->render_warp || (parms->render_scale >= 2) || parms->vid_palettize || (gl_polyblend.value && parms->v_blend[3]) ||
-									parms->menu || parms->ray_debug;
+	{
+		// Passes at the end of the last frame left the depth buffer and the shading rate image in other layouts
+		cb_context_t *cbx = &vulkan_globals.primary_cb_contexts[PCBX_RENDER_PASSES];
+		R_ReturnFrameImage (cbx, &depth_buffer_frame_image, RESOURCE_USE_DEPTH_ATTACHMENT);
+		GL_ClearShadingRateImage (cbx);
+		if (vulkan_globals.shading_rate)
+			R_UseFrameImage (cbx, &shading_rate_frame_image, RESOURCE_USE_SHADING_RATE, false);
+		R_FlushBarriers (cbx);
+	}
+
 	{
 		const qboolean resolve = (vulkan_globals.sample_count != VK_SAMPLE_COUNT_1_BIT);
 		ZEROED_STRUCT (VkRenderPassBeginInfo, render_pass_begin_info);
@@ -3417,11 +4830,19 @@ static void GL_EndRenderingTask (end_rendering_parms_t *parms)
 				vkCmdExecuteCommands (render_passes_cb, 1, &vulkan_globals.secondary_cb_contexts[scbx_index][i].cb);
 
 		vkCmdEndRenderPass (render_passes_cb);
+		R_SetFrameImageUse (&depth_buffer_frame_image, RESOURCE_USE_DEPTH_ATTACHMENT);
 	}
 
+	GL_BeginGPUTimer (render_passes_cb, cb_index, GPU_TIMER_DEPTH_PYRAMID);
+	GL_BuildDepthPyramid (&vulkan_globals.primary_cb_contexts[PCBX_RENDER_PASSES]);
+	GL_EndGPUTimer (render_passes_cb, cb_index, GPU_TIMER_DEPTH_PYRAMID);
+
+	GL_BeginGPUTimer (render_passes_cb, cb_index, GPU_TIMER_SCREEN_EFFECTS);
 	GL_ScreenEffects (&vulkan_globals.primary_cb_contexts[PCBX_RENDER_PASSES], screen_effects, parms);
+	GL_EndGPUTimer (render_passes_cb, cb_index, GPU_TIMER_SCREEN_EFFECTS);
 
 	{
+		GL_BeginGPUTimer (render_passes_cb, cb_index, GPU_TIMER_UI);
 #ifdef USE_RMLUI
 		UI_WriteBeginTimestamp (render_passes_cb);
 #endif
@@ -3469,6 +4890,7 @@ static void GL_EndRenderingTask (end_rendering_parms_t *parms)
 
 			vulkan_globals.vk_cmd_begin_rendering (render_passes_cb, &rendering_info);
 			vkCmdExecuteCommands (render_passes_cb, 1, &vulkan_globals.secondary_cb_contexts[SCBX_GUI]->cb);
+			vkCmdExecuteCommands (render_passes_cb, 1, &vulkan_globals.secondary_cb_contexts[SCBX_RMLUI]->cb);
 			vulkan_globals.vk_cmd_end_rendering (render_passes_cb);
 
 			// Transition to SHADER_READ_ONLY for post-process sampling
@@ -3508,11 +4930,13 @@ static void GL_EndRenderingTask (end_rendering_parms_t *parms)
 			ui_rp_begin_info.pClearValues = &ui_clear_value;
 			vkCmdBeginRenderPass (render_passes_cb, &ui_rp_begin_info, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
 			vkCmdExecuteCommands (render_passes_cb, 1, &vulkan_globals.secondary_cb_contexts[SCBX_GUI]->cb);
+			vkCmdExecuteCommands (render_passes_cb, 1, &vulkan_globals.secondary_cb_contexts[SCBX_RMLUI]->cb);
 			vkCmdEndRenderPass (render_passes_cb);
 		}
 #ifdef USE_RMLUI
 		UI_WriteEndTimestamp (render_passes_cb);
 #endif
+		GL_EndGPUTimer (render_passes_cb, cb_index, GPU_TIMER_UI);
 	}
 
 	{
@@ -3536,6 +4960,8 @@ static void GL_EndRenderingTask (end_rendering_parms_t *parms)
 			render_passes_cb, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, NULL, 0, NULL, 1, &game_barrier);
 	}
 
+	GL_BuildShadingRateImage (&vulkan_globals.primary_cb_contexts[PCBX_RENDER_PASSES], parms);
+
 	{
 		// Post-Process Render Pass (samples color_buffers[0] + color_buffers[1], outputs to swapchain)
 		ZEROED_STRUCT (VkRenderPassBeginInfo, pp_rp_begin_info);
@@ -3544,16 +4970,19 @@ static void GL_EndRenderingTask (end_rendering_parms_t *parms)
 		pp_rp_begin_info.framebuffer = postprocess_framebuffers[current_swapchain_buffer];
 		pp_rp_begin_info.renderArea = render_area;
 		pp_rp_begin_info.clearValueCount = 0;
+		GL_BeginGPUTimer (render_passes_cb, cb_index, GPU_TIMER_POST_PROCESS);
 		vkCmdBeginRenderPass (render_passes_cb, &pp_rp_begin_info, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
 		vkCmdExecuteCommands (render_passes_cb, 1, &vulkan_globals.secondary_cb_contexts[SCBX_POST_PROCESS]->cb);
 		vkCmdEndRenderPass (render_passes_cb);
+		GL_EndGPUTimer (render_passes_cb, cb_index, GPU_TIMER_POST_PROCESS);
 	}
 
-	VkBuffer screenshot_buffer = VK_NULL_HANDLE;
-	ZEROED_STRUCT (vulkan_memory_t, screenshot_memory);
-	if (take_screenshot)
+	if (parms->screenshot)
 	{
-		ScheduleScreenshotCopy (render_passes_cb, &screenshot_buffer, &screenshot_memory);
+		if (swapchain_acquired)
+			ScheduleScreenshotCopy (render_passes_cb, parms->screenshot, cb_index);
+		else
+			Atomic_StoreUInt32 (&parms->screenshot->state, SCREENSHOT_SLOT_FREE);
 	}
 
 	{
@@ -3562,25 +4991,81 @@ static void GL_EndRenderingTask (end_rendering_parms_t *parms)
 		{
 			submit_cbs[pcbx_index] = vulkan_globals.primary_cb_contexts[pcbx_index].cb;
 			R_EndDebugUtilsLabel (&vulkan_globals.primary_cb_contexts[pcbx_index]);
+			if (pcbx_index < PCBX_RENDER_PASSES)
+				GL_EndGPUTimer (submit_cbs[pcbx_index], cb_index, (gpu_timer_t)pcbx_index);
+			if ((pcbx_index == PCBX_NUM - 1) && (frame_timestamp_query_pool != VK_NULL_HANDLE))
+				vkCmdWriteTimestamp (
+					submit_cbs[pcbx_index], VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame_timestamp_query_pool, cb_index * GPU_QUERIES_PER_FRAME + 1);
 			err = vkEndCommandBuffer (submit_cbs[pcbx_index]);
 			if (err != VK_SUCCESS)
 				Sys_Error ("vkEndCommandBuffer failed");
 		}
 
+		VkSemaphore			 wait_semaphores[2];
+		VkPipelineStageFlags wait_dst_stage_masks[2];
+		VkSemaphore			 signal_semaphores[2];
+		uint32_t			 num_wait_semaphores = 0;
+		uint32_t			 num_signal_semaphores = 0;
+
+		// Lightmap updates of this frame run on the compute queue. They wait for the previous frame to be done sampling
+		// the lightmaps, which lets them overlap with its post-processing and UI and with the start of this frame.
+		if (vulkan_globals.async_compute || (pending_async_compute_release != VK_NULL_HANDLE))
+		{
+			VkCommandBuffer compute_cb = vulkan_globals.async_compute_cb_context.cb;
+			if (vulkan_globals.async_compute)
+			{
+				R_EndDebugUtilsLabel (&vulkan_globals.async_compute_cb_context);
+				err = vkEndCommandBuffer (compute_cb);
+				if (err != VK_SUCCESS)
+					Sys_Error ("vkEndCommandBuffer failed");
+			}
+
+			// Still submitted without command buffers when async compute was just turned off to unsignal the pending semaphore
+			const VkPipelineStageFlags compute_wait_dst_stage_mask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+			ZEROED_STRUCT (VkSubmitInfo, compute_submit_info);
+			compute_submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			compute_submit_info.commandBufferCount = vulkan_globals.async_compute ? 1 : 0;
+			compute_submit_info.pCommandBuffers = &compute_cb;
+			compute_submit_info.waitSemaphoreCount = (pending_async_compute_release != VK_NULL_HANDLE) ? 1 : 0;
+			compute_submit_info.pWaitSemaphores = &pending_async_compute_release;
+			compute_submit_info.pWaitDstStageMask = &compute_wait_dst_stage_mask;
+			compute_submit_info.signalSemaphoreCount = vulkan_globals.async_compute ? 1 : 0;
+			compute_submit_info.pSignalSemaphores = &async_compute_done_semaphores[cb_index];
+			err = vkQueueSubmit (vulkan_globals.compute_queue, 1, &compute_submit_info, VK_NULL_HANDLE);
+			if (err != VK_SUCCESS)
+				Sys_Error ("vkQueueSubmit failed");
+			pending_async_compute_release = VK_NULL_HANDLE;
+
+			if (vulkan_globals.async_compute)
+			{
+				// Lightmaps are only sampled by fragment shaders
+				wait_semaphores[num_wait_semaphores] = async_compute_done_semaphores[cb_index];
+				wait_dst_stage_masks[num_wait_semaphores++] = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+				signal_semaphores[num_signal_semaphores++] = async_compute_release_semaphores[cb_index];
+				pending_async_compute_release = async_compute_release_semaphores[cb_index];
+			}
+		}
+
+		if (swapchain_acquired)
+		{
+			// Wait at COLOR_ATTACHMENT_OUTPUT: world and UI render to off-screen color
+			// buffers (not the swapchain image), so they can proceed in parallel with
+			// image acquisition. Only the post-process pass writes to the swapchain
+			// image as a color attachment, making this the precise first-use stage.
+			wait_semaphores[num_wait_semaphores] = image_aquired_semaphores[cb_index];
+			wait_dst_stage_masks[num_wait_semaphores++] = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+			signal_semaphores[num_signal_semaphores++] = draw_complete_semaphores[current_swapchain_buffer];
+		}
+
 		ZEROED_STRUCT (VkSubmitInfo, submit_info);
 		submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 		submit_info.commandBufferCount = PCBX_NUM;
 		submit_info.pCommandBuffers = submit_cbs;
-		submit_info.waitSemaphoreCount = swapchain_acquired ? 1 : 0;
-		submit_info.pWaitSemaphores = &image_aquired_semaphores[cb_index];
-		submit_info.signalSemaphoreCount = swapchain_acquired ? 1 : 0;
-		submit_info.pSignalSemaphores = &draw_complete_semaphores[current_swapchain_buffer];
-		// Wait at COLOR_ATTACHMENT_OUTPUT: world and UI render to off-screen color
-		// buffers (not the swapchain image), so they can proceed in parallel with
-		// image acquisition. Only the post-process pass writes to the swapchain
-		// image as a color attachment, making this the precise first-use stage.
-		VkPipelineStageFlags wait_dst_stage_mask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-		submit_info.pWaitDstStageMask = &wait_dst_stage_mask;
+		submit_info.waitSemaphoreCount = num_wait_semaphores;
+		submit_info.pWaitSemaphores = wait_semaphores;
+		submit_info.pWaitDstStageMask = wait_dst_stage_masks;
+		submit_info.signalSemaphoreCount = num_signal_semaphores;
+		submit_info.pSignalSemaphores = signal_semaphores;
 
 		err = vkQueueSubmit (vulkan_globals.queue, 1, &submit_info, command_buffer_fences[cb_index]);
 		if (err != VK_SUCCESS)
@@ -3589,11 +5074,8 @@ static void GL_EndRenderingTask (end_rendering_parms_t *parms)
 
 	vulkan_globals.device_idle = false;
 
-	if (take_screenshot && (screenshot_buffer != VK_NULL_HANDLE))
-	{
-		WriteScreenshot (screenshot_buffer, screenshot_memory);
-	}
-	take_screenshot = false;
+	if (parms->present_id)
+		latency_submit_times[parms->present_id % NUM_LATENCY_FRAMES] = Sys_DoubleTime ();
 
 	if (swapchain_acquired == true)
 	{
@@ -3603,7 +5085,17 @@ static void GL_EndRenderingTask (end_rendering_parms_t *parms)
 		present_info.pSwapchains = &vulkan_swapchain, present_info.pImageIndices = &current_swapchain_buffer;
 		present_info.waitSemaphoreCount = 1;
 		present_info.pWaitSemaphores = &draw_complete_semaphores[current_swapchain_buffer];
+		ZEROED_STRUCT (VkPresentIdKHR, present_id_info);
+		if (parms->present_id)
+		{
+			present_id_info.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+			present_id_info.swapchainCount = 1;
+			present_id_info.pPresentIds = &parms->present_id;
+			present_info.pNext = &present_id_info;
+		}
 		err = fpQueuePresentKHR (vulkan_globals.queue, &present_info);
+		if (parms->present_id && (err == VK_SUCCESS || err == VK_SUBOPTIMAL_KHR))
+			latency_presented_id = parms->present_id;
 #if defined(VK_EXT_full_screen_exclusive)
 		if ((err == VK_ERROR_OUT_OF_DATE_KHR) || (err == VK_ERROR_SURFACE_LOST_KHR) || (err == VK_SUBOPTIMAL_KHR) ||
 			(err == VK_ERROR_FULL_SCREEN_EXCLUSIVE_MODE_LOST_EXT))
@@ -3625,7 +5117,7 @@ static void GL_EndRenderingTask (end_rendering_parms_t *parms)
 	}
 
 	frame_submitted[cb_index] = true;
-	current_cb_index = (current_cb_index + 1) % DOUBLE_BUFFERED;
+	current_cb_index = (current_cb_index + 1) % vulkan_globals.num_frames_in_flight;
 }
 
 /*
@@ -3647,6 +5139,7 @@ task_handle_t GL_EndRendering (qboolean use_tasks, qboolean swapchain)
 		.vid_width = vid.width,
 		.vid_height = vid.height,
 		.time = fmod (cl.time, 2.0 * M_PI),
+		.dynamic_scale = dynamic_render_scale,
 		.v_blend[0] = v_blend[0],
 		.v_blend[1] = v_blend[1],
 		.v_blend[2] = v_blend[2],
@@ -3675,7 +5168,20 @@ task_handle_t GL_EndRendering (qboolean use_tasks, qboolean swapchain)
 				-vulkan_globals.view_matrix[5],
 				-vulkan_globals.view_matrix[9],
 			},
+		.fog_density = Fog_GetDensity () / 64.0f,
+		.depth_a = vulkan_globals.projection_matrix[2 * 4 + 2],
+		.depth_b = vulkan_globals.projection_matrix[3 * 4 + 2],
 	};
+	if (swapchain && (take_screenshot || capture_fps))
+	{
+		parms.screenshot = GL_ReserveScreenshotSlot ();
+		take_screenshot = false;
+	}
+	if (swapchain && vulkan_globals.present_wait && vid_lowlatency.value)
+	{
+		parms.present_id = ++latency_present_id;
+		latency_input_times[parms.present_id % NUM_LATENCY_FRAMES] = latency_input_time;
+	}
 	task_handle_t end_rendering_task = INVALID_TASK_HANDLE;
 	if (use_tasks)
 		end_rendering_task = Task_AllocateAndAssignFunc ((task_func_t)GL_EndRenderingTask, &parms, sizeof (parms));
@@ -3711,6 +5217,7 @@ void VID_Shutdown (void)
 {
 	if (vid_initialized)
 	{
+		GL_WaitForScreenshotEncodes ();
 		SDL_QuitSubSystem (SDL_INIT_VIDEO);
 		draw_context = NULL;
 		PL_VID_Shutdown ();
@@ -3843,66 +5350,150 @@ static void VID_InitModelist (void)
 
 /*
 =================
-R_CreatePaletteOctreeBuffers
+R_CreatePaletteLUT
 =================
 */
-static void R_CreatePaletteOctreeBuffers (uint32_t *colors, int num_colors, palette_octree_node_t *nodes, int num_nodes)
+static void R_CreatePaletteLUT (void)
 {
-	const int colors_size = num_colors * sizeof (uint32_t);
-	const int nodes_size = num_nodes * sizeof (palette_octree_node_t);
+	VkResult err;
 
-	buffer_create_info_t buffer_create_infos[2] = {
-		{&palette_colors_buffer, colors_size, 0, VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, NULL, NULL, "Palette colors"},
-		{&palette_octree_buffer, nodes_size, 0, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, NULL, NULL, "Palette octree"},
-	};
+	buffer_create_info_t buffer_create_info = {
+		&palette_colors_buffer, 256 * sizeof (uint32_t), 0, VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, NULL, NULL,
+		"Palette colors"};
 
 	vulkan_memory_t memory;
-	R_CreateBuffers (
-		countof (buffer_create_infos), buffer_create_infos, &memory, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, &num_vulkan_misc_allocations, "Palette");
-
-	{
-		VkBuffer		staging_buffer;
-		VkCommandBuffer command_buffer;
-		int				staging_offset;
-		uint32_t	   *staging_memory = (uint32_t *)R_StagingAllocate (colors_size, 1, &command_buffer, &staging_buffer, &staging_offset);
-
-		VkBufferCopy region;
-		region.srcOffset = staging_offset;
-		region.dstOffset = 0;
-		region.size = colors_size;
-		vkCmdCopyBuffer (command_buffer, staging_buffer, palette_colors_buffer, 1, &region);
-
-		R_StagingBeginCopy ();
-		memcpy (staging_memory, colors, colors_size);
-		R_StagingEndCopy ();
-
-		ZEROED_STRUCT (VkBufferViewCreateInfo, buffer_view_create_info);
-		buffer_view_create_info.sType = VK_STRUCTURE_TYPE_BUFFER_VIEW_CREATE_INFO;
-		buffer_view_create_info.buffer = palette_colors_buffer;
-		buffer_view_create_info.format = VK_FORMAT_R8G8B8A8_UNORM;
-		buffer_view_create_info.range = VK_WHOLE_SIZE;
-		VkResult err = vkCreateBufferView (vulkan_globals.device, &buffer_view_create_info, NULL, &palette_buffer_view);
-		if (err != VK_SUCCESS)
-			Sys_Error ("vkCreateBufferView failed");
-		GL_SetObjectName ((uint64_t)palette_buffer_view, VK_OBJECT_TYPE_BUFFER_VIEW, "Palette colors");
-	}
+	R_CreateBuffers (1, &buffer_create_info, &memory, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, &num_vulkan_misc_allocations, "Palette");
+
+	ZEROED_STRUCT (VkBufferViewCreateInfo, buffer_view_create_info);
+	buffer_view_create_info.sType = VK_STRUCTURE_TYPE_BUFFER_VIEW_CREATE_INFO;
+	buffer_view_create_info.buffer = palette_colors_buffer;
+	buffer_view_create_info.format = VK_FORMAT_R8G8B8A8_UNORM;
+	buffer_view_create_info.range = VK_WHOLE_SIZE;
+	err = vkCreateBufferView (vulkan_globals.device, &buffer_view_create_info, NULL, &palette_buffer_view);
+	if (err != VK_SUCCESS)
+		Sys_Error ("vkCreateBufferView failed");
+	GL_SetObjectName ((uint64_t)palette_buffer_view, VK_OBJECT_TYPE_BUFFER_VIEW, "Palette colors");
 
-	{
-		VkBuffer		staging_buffer;
-		VkCommandBuffer command_buffer;
-		int				staging_offset;
-		uint32_t	   *staging_memory = (uint32_t *)R_StagingAllocate (nodes_size, 1, &command_buffer, &staging_buffer, &staging_offset);
+	ZEROED_STRUCT (VkImageCreateInfo, image_create_info);
+	image_create_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	image_create_info.imageType = VK_IMAGE_TYPE_3D;
+	image_create_info.format = VK_FORMAT_R8G8_UINT;
+	image_create_info.extent.width = PALETTE_LUT_SIZE;
+	image_create_info.extent.height = PALETTE_LUT_SIZE;
+	image_create_info.extent.depth = PALETTE_LUT_SIZE;
+	image_create_info.mipLevels = 1;
+	image_create_info.arrayLayers = 1;
+	image_create_info.samples = VK_SAMPLE_COUNT_1_BIT;
+	image_create_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+	image_create_info.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
 
-		VkBufferCopy region;
-		region.srcOffset = staging_offset;
-		region.dstOffset = 0;
-		region.size = nodes_size;
-		vkCmdCopyBuffer (command_buffer, staging_buffer, palette_octree_buffer, 1, &region);
+	err = vkCreateImage (vulkan_globals.device, &image_create_info, NULL, &palette_lut);
+	if (err != VK_SUCCESS)
+		Sys_Error ("vkCreateImage failed");
+	GL_SetObjectName ((uint64_t)palette_lut, VK_OBJECT_TYPE_IMAGE, "Palette LUT");
 
-		R_StagingBeginCopy ();
-		memcpy (staging_memory, nodes, nodes_size);
-		R_StagingEndCopy ();
-	}
+	VkMemoryRequirements memory_requirements;
+	vkGetImageMemoryRequirements (vulkan_globals.device, palette_lut, &memory_requirements);
+
+	ZEROED_STRUCT (VkMemoryAllocateInfo, memory_allocate_info);
+	memory_allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	memory_allocate_info.allocationSize = memory_requirements.size;
+	memory_allocate_info.memoryTypeIndex = GL_MemoryTypeFromProperties (memory_requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0);
+
+	vulkan_memory_t lut_memory;
+	R_AllocateVulkanMemory (&lut_memory, &memory_allocate_info, VULKAN_MEMORY_TYPE_DEVICE, &num_vulkan_misc_allocations);
+	GL_SetObjectName ((uint64_t)lut_memory.handle, VK_OBJECT_TYPE_DEVICE_MEMORY, "Palette LUT");
+
+	err = vkBindImageMemory (vulkan_globals.device, palette_lut, lut_memory.handle, 0);
+	if (err != VK_SUCCESS)
+		Sys_Error ("vkBindImageMemory failed");
+
+	ZEROED_STRUCT (VkImageViewCreateInfo, image_view_create_info);
+	image_view_create_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	image_view_create_info.format = VK_FORMAT_R8G8_UINT;
+	image_view_create_info.image = palette_lut;
+	image_view_create_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	image_view_create_info.subresourceRange.baseMipLevel = 0;
+	image_view_create_info.subresourceRange.levelCount = 1;
+	image_view_create_info.subresourceRange.baseArrayLayer = 0;
+	image_view_create_info.subresourceRange.layerCount = 1;
+	image_view_create_info.viewType = VK_IMAGE_VIEW_TYPE_3D;
+
+	err = vkCreateImageView (vulkan_globals.device, &image_view_create_info, NULL, &palette_lut_view);
+	if (err != VK_SUCCESS)
+		Sys_Error ("vkCreateImageView failed");
+	GL_SetObjectName ((uint64_t)palette_lut_view, VK_OBJECT_TYPE_IMAGE_VIEW, "Palette LUT");
+}
+
+/*
+=================
+R_UpdatePaletteLUT
+
+Rebuilds the 8-bit color LUT when the game palette has changed
+=================
+*/
+void R_UpdatePaletteLUT (void)
+{
+	if (palette_lut == VK_NULL_HANDLE || !memcmp (palette_lut_colors, d_8to24table, sizeof (palette_lut_colors)))
+		return;
+	memcpy (palette_lut_colors, d_8to24table, sizeof (palette_lut_colors));
+
+	// Built before taking staging memory, the build runs on the workers and they may upload too
+	const int lut_size = PALETTE_LUT_SIZE * PALETTE_LUT_SIZE * PALETTE_LUT_SIZE * 2;
+	byte	 *lut = (byte *)Mem_Alloc (lut_size);
+	Palette_BuildLUT (lut);
+
+	VkBuffer		staging_buffer;
+	VkCommandBuffer command_buffer;
+	int				staging_offset;
+	byte		   *staging_memory = R_StagingAllocate (lut_size + sizeof (palette_lut_colors), 4, &command_buffer, &staging_buffer, &staging_offset);
+
+	// Frames still in flight may be reading the old contents
+	ZEROED_STRUCT (VkImageMemoryBarrier, image_memory_barrier);
+	image_memory_barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	image_memory_barrier.srcAccessMask = 0;
+	image_memory_barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	image_memory_barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	image_memory_barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	image_memory_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	image_memory_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	image_memory_barrier.image = palette_lut;
+	image_memory_barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	image_memory_barrier.subresourceRange.baseMipLevel = 0;
+	image_memory_barrier.subresourceRange.levelCount = 1;
+	image_memory_barrier.subresourceRange.baseArrayLayer = 0;
+	image_memory_barrier.subresourceRange.layerCount = 1;
+	vkCmdPipelineBarrier (command_buffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, NULL, 0, NULL, 1, &image_memory_barrier);
+
+	ZEROED_STRUCT (VkBufferImageCopy, region);
+	region.bufferOffset = staging_offset;
+	region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	region.imageSubresource.layerCount = 1;
+	region.imageExtent.width = PALETTE_LUT_SIZE;
+	region.imageExtent.height = PALETTE_LUT_SIZE;
+	region.imageExtent.depth = PALETTE_LUT_SIZE;
+	vkCmdCopyBufferToImage (command_buffer, staging_buffer, palette_lut, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+	VkBufferCopy colors_region;
+	colors_region.srcOffset = staging_offset + lut_size;
+	colors_region.dstOffset = 0;
+	colors_region.size = sizeof (palette_lut_colors);
+	vkCmdCopyBuffer (command_buffer, staging_buffer, palette_colors_buffer, 1, &colors_region);
+
+	image_memory_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	image_memory_barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	image_memory_barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	image_memory_barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	vkCmdPipelineBarrier (
+		command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, NULL, 0, NULL, 1,
+		&image_memory_barrier);
+
+	R_StagingBeginCopy ();
+	memcpy (staging_memory, lut, lut_size);
+	memcpy (staging_memory + lut_size, palette_lut_colors, sizeof (palette_lut_colors));
+	R_StagingEndCopy ();
+
+	Mem_Free (lut);
 }
 
 /*
@@ -3952,7 +5543,7 @@ void VID_Init (void)
 	int			display_width, display_height, display_refreshrate;
 	qboolean	fullscreen;
 	const char *read_vars[] = {"vid_fullscreen",		"vid_width",	"vid_height", "vid_refreshrate", "vid_vsync",
-							   "vid_desktopfullscreen", "vid_fsaamode", "vid_fsaa",	  "vid_borderless"};
+							   "vid_desktopfullscreen",	"vid_fsaamode",	"vid_fsaa",	  "vid_borderless",	 "vid_framesinflight"};
 #define num_readvars countof (read_vars)
 
 	Cvar_RegisterVariable (&vid_fullscreen);  // johnfitz
@@ -3960,6 +5551,8 @@ void VID_Init (void)
 	Cvar_RegisterVariable (&vid_height);	  // johnfitz
 	Cvar_RegisterVariable (&vid_refreshrate); // johnfitz
 	Cvar_RegisterVariable (&vid_vsync);		  // johnfitz
+	Cvar_RegisterVariable (&vid_lowlatency);
+	Cvar_RegisterVariable (&vid_framesinflight);
 	Cvar_RegisterVariable (&vid_filter);
 	Cvar_RegisterVariable (&vid_anisotropic);
 	Cvar_RegisterVariable (&vid_fsaamode);
@@ -3967,6 +5560,10 @@ void VID_Init (void)
 	Cvar_RegisterVariable (&vid_desktopfullscreen); // QuakeSpasm
 	Cvar_RegisterVariable (&vid_borderless);		// QuakeSpasm
 	Cvar_RegisterVariable (&vid_palettize);
+	Cvar_RegisterVariable (&r_occlusioncull);
+	Cvar_RegisterVariable (&r_asynccompute);
+	Cvar_RegisterVariable (&r_fusedpostprocess);
+	Cvar_RegisterVariable (&r_vrs);
 #if defined(_DEBUG)
 	Cvar_RegisterVariable (&r_raydebug);
 #endif
@@ -3981,6 +5578,8 @@ void VID_Init (void)
 	Cvar_SetCallback (&vid_vsync, VID_Changed_f);
 	Cvar_SetCallback (&vid_desktopfullscreen, VID_Changed_f);
 	Cvar_SetCallback (&vid_borderless, VID_Changed_f);
+	Cvar_SetCallback (&r_occlusioncull, VID_OcclusionCullChanged_f);
+	Cvar_SetCallback (&r_vrs, VID_ShadingRateChanged_f);
 
 	Cmd_AddCommand ("vid_unlock", VID_Unlock);	   // johnfitz
 	Cmd_AddCommand ("vid_restart", VID_Restart_f); // johnfitz
@@ -3994,10 +5593,6 @@ void VID_Init (void)
 	Cmd_AddCommand ("vid_nextfullscreen", VID_NextFullScreen_f);
 	Cmd_AddCommand ("vid_nextvsync", VID_NextVSync_f);
 
-#ifdef _DEBUG
-	Cmd_AddCommand ("create_palette_octree", CreatePaletteOctree_f);
-#endif
-
 	putenv (vid_center); /* SDL_putenv is problematic in versions <= 1.2.9 */
 
 #ifdef USE_SDL3
@@ -4113,6 +5708,7 @@ void VID_Init (void)
 	SDL_Vulkan_LoadLibrary (NULL);
 	GL_InitInstance ();
 	GL_InitDevice ();
+	vulkan_globals.num_frames_in_flight = CLAMP (2, (int)vid_framesinflight.value, MAX_FRAMES_IN_FLIGHT);
 	GL_InitCommandBuffers ();
 	vulkan_globals.staging_buffer_size = INITIAL_STAGING_BUFFER_SIZE_KB * 1024;
 	R_InitStagingBuffers ();
@@ -4123,7 +5719,7 @@ void VID_Init (void)
 	TexMgr_InitHeap ();
 	R_InitSamplers ();
 	R_CreatePipelineLayouts ();
-	R_CreatePaletteOctreeBuffers (palette_octree_colors, NUM_PALETTE_OCTREE_COLORS, palette_octree_nodes, NUM_PALETTE_OCTREE_NODES);
+	R_CreatePaletteLUT ();
 	// GL_CreateRenderResources ();
 	// Note: RmlUI Vulkan init moved to GL_CreateRenderResources() after render passes exist
 
@@ -4803,6 +6399,12 @@ void SCR_ScreenShot_f (void)
 		}
 	}
 
+	if (capture_fps)
+	{
+		Con_Printf ("SCR_ScreenShot_f: Can't take screenshots while capturing\n");
+		return;
+	}
+
 	// read quality as the 3rd param (only used for JPG)
 	screenshot_quality = 90;
 	if (Cmd_Argc () >= 3)
@@ -4856,6 +6458,104 @@ void SCR_ScreenShot_f (void)
 	take_screenshot = true;
 }
 
+static void SCR_CaptureStart_Usage (void)
+{
+	Con_Printf ("usage: capture_start <fps> <format> <quality>\n");
+	Con_Printf ("   fps must be 1-1000, default 30\n");
+	Con_Printf ("   format must be \"png\" or \"tga\" or \"jpg\", default tga\n");
+	Con_Printf ("   quality must be 1-100\n");
+}
+
+/*
+==================
+SCR_CaptureStart_f
+
+Writes every frame to a new directory while the game advances by a fixed time step of 1/fps,
+so demos can be rendered to video at a steady rate regardless of how long encoding takes
+==================
+*/
+void SCR_CaptureStart_f (void)
+{
+	int fps = 30;
+
+	if (capture_fps)
+	{
+		Con_Printf ("Already capturing to %s\n", capture_dir);
+		return;
+	}
+
+	if ((vulkan_globals.swap_chain_format != VK_FORMAT_B8G8R8A8_UNORM) && (vulkan_globals.swap_chain_format != VK_FORMAT_B8G8R8A8_SRGB) &&
+		(vulkan_globals.swap_chain_format != VK_FORMAT_R8G8B8A8_UNORM) && (vulkan_globals.swap_chain_format != VK_FORMAT_R8G8B8A8_SRGB))
+	{
+		Con_Printf ("SCR_CaptureStart_f: Unsupported surface format\n");
+		return;
+	}
+
+	if (Cmd_Argc () >= 2)
+		fps = atoi (Cmd_Argv (1));
+	memcpy (capture_ext, "tga", sizeof (capture_ext));
+	if (Cmd_Argc () >= 3)
+	{
+		const char *requested_ext = Cmd_Argv (2);
+		if (q_strcasecmp ("png", requested_ext) && q_strcasecmp ("tga", requested_ext) && q_strcasecmp ("jpg", requested_ext))
+		{
+			SCR_CaptureStart_Usage ();
+			return;
+		}
+		memcpy (capture_ext, requested_ext, sizeof (capture_ext));
+	}
+	capture_quality = (Cmd_Argc () >= 4) ? atoi (Cmd_Argv (3)) : 90;
+	if (fps < 1 || fps > 1000 || capture_quality < 1 || capture_quality > 100)
+	{
+		SCR_CaptureStart_Usage ();
+		return;
+	}
+
+	time_t now;
+	time (&now);
+	struct tm *lt = localtime (&now);
+	q_snprintf (
+		capture_dir, sizeof (capture_dir), "capture-%04d%02d%02d-%02d%02d%02d", lt->tm_year + 1900, lt->tm_mon + 1, lt->tm_mday, lt->tm_hour, lt->tm_min,
+		lt->tm_sec);
+	Sys_mkdir (com_gamedir);
+	Sys_mkdir (va ("%s/%s", com_gamedir, capture_dir));
+
+	capture_frame = 0;
+	capture_fps = fps;
+	Con_Printf ("Capturing at %i fps to %s\n", capture_fps, capture_dir);
+}
+
+/*
+==================
+SCR_CaptureStop_f
+==================
+*/
+void SCR_CaptureStop_f (void)
+{
+	if (!capture_fps)
+	{
+		Con_Printf ("Not capturing\n");
+		return;
+	}
+
+	capture_fps = 0;
+	GL_WaitForScreenshotEncodes ();
+	GL_FreeScreenshotBuffers ();
+	Con_Printf ("Captured %i frames to %s\n", capture_frame, capture_dir);
+}
+
+/*
+==================
+SCR_CaptureFrameTime
+
+Returns the fixed frame time while capturing, 0 otherwise
+==================
+*/
+float SCR_CaptureFrameTime (void)
+{
+	return capture_fps ? (1.0f / capture_fps) : 0.0f;
+}
+
 void VID_FocusGained (void)
 {
 	has_focus = true;
@@ -117,19 +117,52 @@ static void R_RasterWarpTexture (cb_context_t *cbx, texture_t *tx, float warptes
 R_ComputeWarpTexture
 =============
 */
-static void R_ComputeWarpTexture (cb_context_t *cbx, texture_t *tx, float warptess)
+static void R_ComputeWarpTexture (cb_context_t *cbx, texture_t *tx)
 {
-	// render warp
-	const float time = cl.time;
-	R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_COMPUTE, vulkan_globals.cs_tex_warp_pipeline);
+	// render warp, pipeline and time are bound once by R_UpdateWarpTextures
 	VkDescriptorSet sets[2] = {tx->gltexture->descriptor_set, tx->warpimage->storage_descriptor_set};
 	if (r_lightmap_cheatsafe)
 		sets[0] = whitetexture->descriptor_set;
 	vkCmdBindDescriptorSets (cbx->cb, VK_PIPELINE_BIND_POINT_COMPUTE, vulkan_globals.cs_tex_warp_pipeline.layout.handle, 0, 2, sets, 0, NULL);
-	R_PushConstants (cbx, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof (float), &time);
 	vkCmdDispatch (cbx->cb, WARPIMAGESIZE / 8, WARPIMAGESIZE / 8, 1);
 }
 
+/*
+=============
+R_MarkEntityWarpTextures
+
+Flags the warp textures of brush entities that are in view this frame.
+Entity chains are only built while drawing, which runs in parallel with
+R_UpdateWarpTextures, so they can't be used to decide what to update.
+=============
+*/
+static void R_MarkEntityWarpTextures (void)
+{
+	int i, j;
+
+	if (!r_drawentities.value)
+		return;
+
+	for (i = 0; i < cl_numvisedicts; i++)
+	{
+		entity_t *e = cl_visedicts[i];
+
+		if (e->model->type != mod_brush)
+			continue;
+		if (!(e->model->used_specials & SURF_DRAWTURB))
+			continue;
+		if (e->alpha == ENTALPHA_ZERO)
+			continue;
+		if (R_CullModelForEntity (e))
+			continue;
+
+		msurface_t *s = &e->model->surfaces[e->model->firstmodelsurface];
+		for (j = 0; j < e->model->nummodelsurfaces; j++, s++)
+			if (s->flags & SURF_DRAWTURB && s->texinfo->texture->warpimage)
+				Atomic_StoreUInt32_Relaxed (&s->texinfo->texture->update_warp, true);
+	}
+}
+
 /*
 =============
 R_UpdateWarpTextures -- johnfitz -- each frame, update warping textures
@@ -154,6 +187,8 @@ void R_UpdateWarpTextures (void *unused)
 
 	warptess = 128.0 / CLAMP (3.0, floor (r_waterquality.value), 64.0);
 
+	R_MarkEntityWarpTextures ();
+
 	int num_warp_textures = 0;
 
 	// Count warp texture & prepare barrier from undefined to GENERAL if using compute warp
@@ -175,6 +210,7 @@ void R_UpdateWarpTextures (void *unused)
 
 			if (!Atomic_LoadUInt32 (&tx->update_warp))
 				continue;
+			Atomic_StoreUInt32 (&tx->update_warp, false);
 
 			if (r_waterwarpcompute.value)
 			{
@@ -200,18 +236,32 @@ void R_UpdateWarpTextures (void *unused)
 		}
 	}
 
+	if (num_warp_textures == 0)
+	{
+		R_EndDebugUtilsLabel (cbx);
+		return;
+	}
+
 	// Transfer mips from UNDEFINED to GENERAL layout
 	if (r_waterwarpcompute.value)
 		vkCmdPipelineBarrier (
 			cbx->cb, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, NULL, 0, NULL, num_warp_textures, warp_image_barriers);
 
+	// Pipeline and time are shared by all warp textures
+	if (r_waterwarpcompute.value)
+	{
+		const float time = cl.time;
+		R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_COMPUTE, vulkan_globals.cs_tex_warp_pipeline);
+		R_PushConstants (cbx, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof (float), &time);
+	}
+
 	// Render warp to top mips
 	for (i = 0; i < num_warp_textures; ++i)
 	{
 		tx = warp_textures[i];
 
 		if (r_waterwarpcompute.value)
-			R_ComputeWarpTexture (cbx, tx, warptess);
+			R_ComputeWarpTexture (cbx, tx);
 		else
 			R_RasterWarpTexture (cbx, tx, warptess);
 
@@ -303,8 +353,6 @@ void R_UpdateWarpTextures (void *unused)
 		image_barrier->subresourceRange.levelCount = WARPIMAGEMIPS;
 		image_barrier->subresourceRange.baseArrayLayer = 0;
 		image_barrier->subresourceRange.layerCount = 1;
-
-		Atomic_StoreUInt32 (&tx->update_warp, false);
 	}
 
 	vkCmdPipelineBarrier (
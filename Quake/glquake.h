@@ -33,7 +33,12 @@ qboolean	  GL_BeginRendering (qboolean use_tasks, task_handle_t *begin_rendering
 qboolean	  GL_AcquireNextSwapChainImage (void);
 task_handle_t GL_EndRendering (qboolean use_tasks, qboolean use_swapchain);
 void		  GL_SynchronizeEndRenderingTask (void);
+double		  GL_GetLastFrameGPUTime (void);
+void		  GL_WaitForLowLatencyFrame (void);
+double		  GL_GetInputLatency (void);
 void		  GL_UpdateDescriptorSets (void);
+qboolean	  GL_QueryMemoryBudget (VkDeviceSize *heap_usage, VkDeviceSize *heap_budget);
+void		  R_UpdatePaletteLUT (void);
 
 extern int glwidth, glheight;
 
@@ -57,7 +62,7 @@ extern int glwidth, glheight;
 #define MIN_NB_DESCRIPTORS_PER_TYPE 32
 
 #define NUM_COLOR_BUFFERS			   2
-#define INITIAL_STAGING_BUFFER_SIZE_KB 16384
+#define INITIAL_STAGING_BUFFER_SIZE_KB 8192 // per staging buffer
 
 #define FAN_INDEX_BUFFER_SIZE  126
 #define SCRATCH_BUFFER_SIZE_MB 16
@@ -98,8 +103,11 @@ typedef struct particle_s
 
 #define P_INVALID -1
 #ifdef PSET_SCRIPT
+#define NUM_FTE_PARTICLE_TASKS 16
 void PScript_InitParticles (void);
 void PScript_Shutdown (void);
+void PScript_UpdateParticles (void *unused);
+void PScript_SimulateParticles (int index, void *use_tasks);
 void PScript_DrawParticles (cb_context_t *cbx);
 void PScript_DrawParticles_ShowTris (cb_context_t *cbx);
 struct trailstate_s;
@@ -139,6 +147,7 @@ typedef struct vulkan_pipeline_layout_s
 {
 	VkPipelineLayout	handle;
 	VkPushConstantRange push_constant_range;
+	uint32_t			dlight_cluster_set; // 0 if the layout doesn't read the dlight clusters
 } vulkan_pipeline_layout_t;
 
 typedef struct vulkan_pipeline_s
@@ -186,6 +195,7 @@ typedef enum
 	PCBX_BUILD_ACCELERATION_STRUCTURES,
 	PCBX_UPDATE_LIGHTMAPS,
 	PCBX_UPDATE_WARP,
+	PCBX_UPDATE_PARTICLES,
 	PCBX_RENDER_PASSES,
 	PCBX_NUM,
 } primary_cb_contexts_t;
@@ -203,10 +213,37 @@ typedef enum
 	SCBX_VIEW_MODEL,
 	// UI render Pass:
 	SCBX_GUI,
+	SCBX_RMLUI, // recorded by its own task, executed on top of SCBX_GUI
 	SCBX_POST_PROCESS,
 	SCBX_NUM,
 } secondary_cb_contexts_t;
 
+// GPU time of the passes, the first ones match primary_cb_contexts_t and
+// the main render pass ones match secondary_cb_contexts_t
+typedef enum
+{
+	GPU_TIMER_ACCELERATION_STRUCTURES,
+	GPU_TIMER_LIGHTMAPS,
+	GPU_TIMER_WARP,
+	GPU_TIMER_PARTICLE_UPDATE,
+	GPU_TIMER_WORLD,
+	GPU_TIMER_ENTITIES,
+	GPU_TIMER_SKY,
+	GPU_TIMER_ALPHA_ENTITIES_ACROSS_WATER,
+	GPU_TIMER_WATER,
+	GPU_TIMER_ALPHA_ENTITIES,
+	GPU_TIMER_PARTICLES,
+	GPU_TIMER_VIEW_MODEL,
+	GPU_TIMER_DEPTH_PYRAMID,
+	GPU_TIMER_SCREEN_EFFECTS,
+	GPU_TIMER_UI,
+	GPU_TIMER_POST_PROCESS,
+	GPU_TIMER_NUM,
+} gpu_timer_t;
+
+extern const char *const gpu_timer_names[GPU_TIMER_NUM];
+double					 GL_GetLastFrameGPUTimer (gpu_timer_t timer);
+
 static const int SECONDARY_CB_MULTIPLICITY[SCBX_NUM] = {
 	NUM_WORLD_CBX,	  // SCBX_WORLD,
 	NUM_ENTITIES_CBX, // SCBX_ENTITIES,
@@ -217,29 +254,43 @@ static const int SECONDARY_CB_MULTIPLICITY[SCBX_NUM] = {
 	1,				  // SCBX_PARTICLES,
 	1,				  // SCBX_VIEW_MODEL,
 	1,				  // SCBX_GUI,
+	1,				  // SCBX_RMLUI,
 	1,				  // SCBX_POST_PROCESS,
 };
 
+#define MAX_PENDING_IMAGE_BARRIERS 8
+
 typedef struct cb_context_s
 {
-	VkCommandBuffer	  cb;
-	canvastype		  current_canvas;
-	VkRenderPass	  render_pass;
-	int				  render_pass_index;
-	int				  subpass;
-	vulkan_pipeline_t current_pipeline;
-	uint32_t		  vbo_indices[MAX_BATCH_SIZE];
-	unsigned int	  num_vbo_indices;
+	VkCommandBuffer			 cb;
+	canvastype				 current_canvas;
+	VkRenderPass			 render_pass;
+	int						 render_pass_index;
+	int						 subpass;
+	vulkan_pipeline_t		 current_pipeline;
+	uint32_t				 vbo_indices[MAX_BATCH_SIZE];
+	unsigned int			 num_vbo_indices;
+	qboolean				 bindless_batch;
+	uint32_t				 bindless_textures;	// diffuse | fullbright << 16, passed as firstInstance
+	struct draw_batch_s		*draw_batch;		// 2D quads not recorded yet, see Draw_Flush
+	// queued by R_UseFrameImage and R_QueueMemoryBarrier, see R_FlushBarriers
+	VkImageMemoryBarrier2KHR pending_image_barriers[MAX_PENDING_IMAGE_BARRIERS];
+	int						 num_pending_image_barriers;
+	VkMemoryBarrier2KHR		 pending_memory_barrier;
 } cb_context_t;
 
 typedef struct
 {
 	VkDevice						 device;
 	qboolean						 device_idle;
+	int								 num_frames_in_flight; // vid_framesinflight, slots of command buffers and other per-frame resources
 	qboolean						 validation;
 	qboolean						 debug_utils;
 	VkQueue							 queue;
+	VkQueue							 compute_queue; // VK_NULL_HANDLE if there is no dedicated compute queue family
 	cb_context_t					 primary_cb_contexts[PCBX_NUM];
+	cb_context_t					 async_compute_cb_context;
+	qboolean						 async_compute; // lightmap updates are submitted on compute_queue this frame
 	cb_context_t					*secondary_cb_contexts[SCBX_NUM];
 	VkClearValue					 color_clear_value;
 	VkFormat						 swap_chain_format;
@@ -250,13 +301,20 @@ typedef struct
 	VkPhysicalDeviceFeatures		 device_features;
 	VkPhysicalDeviceMemoryProperties memory_properties;
 	uint32_t						 gfx_queue_family_index;
+	uint32_t						 compute_queue_family_index;
+	uint32_t						 queue_family_indices[2]; // gfx + compute, for VK_SHARING_MODE_CONCURRENT resources
 	VkFormat						 color_format;
 	VkFormat						 depth_format;
 	VkSampleCountFlagBits			 sample_count;
 	qboolean						 supersampling;
 	qboolean						 non_solid_fill;
 	qboolean						 multi_draw_indirect;
+	qboolean						 texture_compression_bc;
+	qboolean						 texture_compression_astc;
 	qboolean						 screen_effects_sops;
+	qboolean						 occlusion_culling;
+	qboolean						 shading_rate;			  // r_vrs, shading rate attachment in the main render pass
+	uint32_t						 shading_rate_texel_size; // pixels covered by one shading rate texel in each direction
 
 	// Instance extensions
 	qboolean get_surface_capabilities_2;
@@ -269,6 +327,10 @@ typedef struct
 	qboolean ray_query;
 	qboolean synchronization_2;
 	qboolean dynamic_rendering;
+	qboolean bindless;
+	qboolean memory_budget;
+	qboolean present_wait;
+	qboolean fragment_shading_rate;
 
 	// Buffers
 	VkImage color_buffers[NUM_COLOR_BUFFERS];
@@ -285,14 +347,18 @@ typedef struct
 	VkRenderPass postprocess_render_pass;
 
 	// Pipelines
+	VkPipelineCache			 pipeline_cache;
 	vulkan_pipeline_t		 basic_alphatest_pipeline[2];
 	vulkan_pipeline_t		 basic_blend_pipeline[2];
 	vulkan_pipeline_t		 basic_notex_blend_pipeline[2];
 	vulkan_pipeline_layout_t basic_pipeline_layout;
 	vulkan_pipeline_t		 world_pipelines[WORLD_PIPELINE_COUNT];
 	vulkan_pipeline_layout_t world_pipeline_layout;
+	vulkan_pipeline_t		 world_bindless_pipelines[WORLD_PIPELINE_COUNT];
+	vulkan_pipeline_layout_t world_bindless_pipeline_layout;
 	vulkan_pipeline_t		 raster_tex_warp_pipeline;
 	vulkan_pipeline_t		 particle_pipeline;
+	vulkan_pipeline_t		 update_particles_pipeline;
 	vulkan_pipeline_t		 sprite_pipeline;
 	vulkan_pipeline_layout_t sky_pipeline_layout[2]; // one texture (cubemap-like), two textures (animated layers)
 	vulkan_pipeline_t		 sky_stencil_pipeline[2];
@@ -302,7 +368,9 @@ typedef struct
 	vulkan_pipeline_t		 sky_layer_pipeline[2];
 	vulkan_pipeline_t		 alias_pipelines[MODEL_PIPELINE_COUNT];
 	vulkan_pipeline_t		 md5_pipelines[MODEL_PIPELINE_COUNT];
+	vulkan_pipeline_t		 alias_instanced_pipelines[2];
 	vulkan_pipeline_t		 postprocess_pipeline;
+	vulkan_pipeline_t		 postprocess_fused_pipeline;
 	vulkan_pipeline_t		 screen_effects_pipeline;
 	vulkan_pipeline_t		 screen_effects_scale_pipeline;
 	vulkan_pipeline_t		 screen_effects_scale_sops_pipeline;
@@ -314,8 +382,13 @@ typedef struct
 	vulkan_pipeline_t		 showbboxes_pipeline;
 	vulkan_pipeline_t		 update_lightmap_pipeline;
 	vulkan_pipeline_t		 update_lightmap_rt_pipeline;
+	vulkan_pipeline_t		 dlight_clusters_pipeline;
 	vulkan_pipeline_t		 indirect_draw_pipeline;
 	vulkan_pipeline_t		 indirect_clear_pipeline;
+	vulkan_pipeline_t		 indirect_occlusion_pipeline;
+	vulkan_pipeline_t		 mark_leafs_pipeline;
+	vulkan_pipeline_t		 depth_pyramid_pipeline;
+	vulkan_pipeline_t		 shading_rate_pipeline;
 	vulkan_pipeline_t		 ray_debug_pipeline;
 	vulkan_pipeline_t		 mesh_interpolate_pipeline;
 	vulkan_pipeline_t		 skinning_pipeline;
@@ -334,10 +407,17 @@ typedef struct
 	vulkan_desc_set_layout_t lightmap_compute_set_layout;
 	VkDescriptorSet			 indirect_compute_desc_set;
 	vulkan_desc_set_layout_t indirect_compute_set_layout;
+	vulkan_desc_set_layout_t particle_compute_set_layout;
+	vulkan_desc_set_layout_t dlight_cluster_set_layout;
+	VkDescriptorSet			 dlight_cluster_desc_set; // this frame's, bound along with every pipeline that reads it
+	VkDescriptorSet			 depth_pyramid_desc_set;
 	vulkan_desc_set_layout_t lightmap_compute_rt_set_layout;
 	VkDescriptorSet			 ray_debug_desc_set;
 	vulkan_desc_set_layout_t ray_debug_set_layout;
 	vulkan_desc_set_layout_t joints_buffer_set_layout;
+	VkDescriptorPool		 bindless_descriptor_pool;
+	VkDescriptorSet			 bindless_desc_set;
+	vulkan_desc_set_layout_t bindless_set_layout;
 
 	// Scratch buffer for animated AS building (vertex positions + AS build scratch)
 	VkBuffer		scratch_buffer;
@@ -358,6 +438,12 @@ typedef struct
 	float projection_matrix[16];
 	float view_matrix[16];
 	float view_projection_matrix[16];
+	float viewport[4];
+
+	// View the depth pyramid was rendered with
+	qboolean depth_pyramid_valid;
+	float	 prev_view_projection_matrix[16];
+	float	 prev_viewport[4];
 
 	// Dispatch table
 	PFN_vkCmdBindPipeline			vk_cmd_bind_pipeline;
@@ -380,11 +466,16 @@ typedef struct
 	PFN_vkCmdBeginRenderingKHR vk_cmd_begin_rendering;
 	PFN_vkCmdEndRenderingKHR   vk_cmd_end_rendering;
 
+	// VK_KHR_create_renderpass2, for the shading rate attachment
+	PFN_vkCreateRenderPass2KHR vk_create_render_pass_2;
+
 	PFN_vkGetAccelerationStructureBuildSizesKHR		   vk_get_acceleration_structure_build_sizes;
 	PFN_vkCreateAccelerationStructureKHR			   vk_create_acceleration_structure;
 	PFN_vkDestroyAccelerationStructureKHR			   vk_destroy_acceleration_structure;
 	PFN_vkCmdBuildAccelerationStructuresKHR			   vk_cmd_build_acceleration_structures;
 	PFN_vkGetAccelerationStructureDeviceAddressKHR	   vk_get_acceleration_structure_device_address;
+	PFN_vkCmdWriteAccelerationStructuresPropertiesKHR  vk_cmd_write_acceleration_structures_properties;
+	PFN_vkCmdCopyAccelerationStructureKHR			   vk_cmd_copy_acceleration_structure;
 	VkPhysicalDeviceAccelerationStructurePropertiesKHR physical_device_acceleration_structure_properties;
 
 #ifdef _DEBUG
@@ -405,6 +496,7 @@ extern qboolean render_warp;
 extern qboolean in_update_screen;
 extern qboolean use_simd;
 extern int		render_scale;
+extern float	dynamic_render_scale;
 
 //
 // view origin
@@ -436,6 +528,8 @@ extern cvar_t r_slimealpha;
 extern cvar_t r_dynamic;
 extern cvar_t r_novis;
 extern cvar_t r_scale;
+extern cvar_t r_dynamicres;
+extern cvar_t r_dynamicres_min;
 
 extern cvar_t gl_polyblend;
 extern cvar_t gl_nocolors;
@@ -451,6 +545,31 @@ extern atomic_uint32_t rs_dynamiclightmaps, rs_brushpasses, rs_aliaspasses;
 extern atomic_uint64_t total_device_vulkan_allocation_size;
 extern atomic_uint64_t total_host_vulkan_allocation_size;
 
+// Bytes of Vulkan memory per owner. Lightmaps are part of the texture memory and
+// acceleration structures part of the bmodel and mesh memory.
+typedef enum
+{
+	VULKAN_MEMORY_CATEGORY_TEXTURES,
+	VULKAN_MEMORY_CATEGORY_LIGHTMAPS,
+	VULKAN_MEMORY_CATEGORY_BMODEL,
+	VULKAN_MEMORY_CATEGORY_MESH,
+	VULKAN_MEMORY_CATEGORY_ACCELERATION_STRUCTURES,
+	VULKAN_MEMORY_CATEGORY_DYNAMIC,
+	VULKAN_MEMORY_CATEGORY_MISC,
+	VULKAN_MEMORY_CATEGORY_UI,
+	VULKAN_MEMORY_CATEGORY_COUNT,
+} vulkan_memory_category_t;
+extern atomic_uint64_t vulkan_memory_category_sizes[VULKAN_MEMORY_CATEGORY_COUNT];
+
+typedef struct vulkan_memory_budget_s
+{
+	qboolean	 from_driver; // VK_EXT_memory_budget, otherwise estimated from our own allocations
+	VkDeviceSize device_usage;
+	VkDeviceSize device_budget;
+	VkDeviceSize host_usage;
+	VkDeviceSize host_budget;
+} vulkan_memory_budget_t;
+
 // johnfitz -- track developer statistics that vary every frame
 extern cvar_t devstats;
 typedef struct
@@ -483,6 +602,10 @@ typedef struct
 	byte  color[4];
 } basicvertex_t;
 
+basicvertex_t *Draw_AddQuad (cb_context_t *cbx, vulkan_pipeline_t pipeline, gltexture_t *texture);
+int			   Draw_StringQuads (float x, const char *str, int len, basicvertex_t *output);
+void		   Draw_CachedQuads (cb_context_t *cbx, float y, const basicvertex_t *quads, int num_quads);
+
 // johnfitz -- moved here from r_brush.c
 extern int gl_lightmap_format;
 
@@ -524,8 +647,7 @@ struct lightmap_s
 
 	lm_compute_workgroup_bounds_t global_bounds[LMBLOCK_HEIGHT / LM_CULL_BLOCK_H][LMBLOCK_WIDTH / LM_CULL_BLOCK_W];
 	byte						  active_dlights[LMBLOCK_HEIGHT / LM_CULL_BLOCK_H][LMBLOCK_WIDTH / LM_CULL_BLOCK_W];
-	byte						  num_used_lightstyles[LMBLOCK_HEIGHT / LM_CULL_BLOCK_H][LMBLOCK_WIDTH / LM_CULL_BLOCK_W];
-	byte						  used_lightstyles[LMBLOCK_HEIGHT / LM_CULL_BLOCK_H][LMBLOCK_WIDTH / LM_CULL_BLOCK_W][MAX_LIGHTSTYLES];
+	uint64_t					  used_lightstyles[LMBLOCK_HEIGHT / LM_CULL_BLOCK_H][LMBLOCK_WIDTH / LM_CULL_BLOCK_W]; // bit per lightstyle
 	int							  cached_light[MAX_LIGHTSTYLES];
 	int							  cached_framecount;
 
@@ -566,14 +688,19 @@ void R_BuildTopLevelAccelerationStructure (void *unused);
 void R_UpdateAnimatedBLASes (cb_context_t *cbx);
 void R_UpdateLightmapsAndIndirect (void *unused);
 void R_MarkSurfaces (qboolean use_tasks, task_handle_t before_mark, task_handle_t *store_efrags, task_handle_t *cull_surfaces, task_handle_t *chain_surfaces);
+void R_ClearWorldViewCache (void);
 qboolean R_CullBox (vec3_t emins, vec3_t emaxs);
-void	 R_StoreEfrags (efrag_t **ppefrag);
+void	 R_StoreEfrags (mleaf_t *leaf);
 qboolean R_CullModelForEntity (entity_t *e);
+#if defined(USE_SIMD)
+uint32_t R_CullBoxesSIMD (soa_aabb_t *boxes, uint32_t activelanes);
+#endif
 void	 R_RotateForEntity (float matrix[16], vec3_t origin, vec3_t angles, unsigned char scale);
 void	 R_MarkLights (dlight_t *light, int num, mnode_t *node);
 
 void R_InitParticles (void);
 void R_DrawParticles (cb_context_t *cbx);
+void R_UpdateParticles (void *unused);
 void CL_RunParticles (void);
 void R_ClearParticles (void);
 
@@ -581,7 +708,9 @@ void R_TranslatePlayerSkin (int playernum);
 void R_TranslateNewPlayerSkin (int playernum); // johnfitz -- this handles cases when the actual texture changes
 void R_UpdateWarpTextures (void *unused);
 
-void R_MarkDeps (int combined_deps, int worker_index);
+qboolean R_MarkDeps (int combined_deps, int worker_index);
+qboolean R_CollectDeps (int combined_deps, uint32_t *lightmap_styles, atomic_uint32_t **update_warp, int *num_update_warp);
+void	 R_UploadLeafVisibility (const byte *vis);
 
 qboolean R_IndirectBrush (entity_t *e);
 
@@ -598,17 +727,77 @@ typedef struct
 } lerpdata_t;
 // johnfitz
 
+// Per-frame entity transform, computed once for every visible entity and the view model before drawing
+#define NUM_ENTITY_STATE_TASKS 8
+typedef struct
+{
+	entity_t  *entity;
+	qboolean   culled;			 // outside the frustum, set before the alias render state
+	int		   lod;				 // index into aliashdr_t lods, clamped per surface
+	lerpdata_t lerpdata;		 // poses are only set for alias models
+	float	   model_matrix[16]; // includes scale_origin/scale for alias models
+	vec3_t	   shadevector;		 // set for alias models that weren't culled
+	vec3_t	   lightcolor;		 // set for alias models that weren't culled
+} entity_render_state_t;
+
+// Opaque alias model surfaces collected by R_DrawAliasModel and drawn instanced by R_DrawAliasBatch
+#define MAX_ALIAS_BATCH 512
+typedef struct
+{
+	aliashdr_t	*hdr;
+	gltexture_t *tx;
+	gltexture_t *fb;
+	short		 pose1;
+	short		 pose2;
+	qboolean	 alphatest;
+	int			 lod;
+	float		 blend;
+	float		 model_matrix[16];
+	vec3_t		 shadevector;
+	vec3_t		 lightcolor;
+} alias_instance_t;
+
+typedef struct
+{
+	alias_instance_t *instances;
+	int				  num_instances;
+	int				  max_instances;
+} alias_batch_t;
+
+#define MAX_SPRITE_BATCH 1024
+typedef struct
+{
+	entity_t	   *e;
+	mspriteframe_t *frame;
+	qboolean		oriented; // drawn with decal depth bias
+} sprite_instance_t;
+
+typedef struct
+{
+	sprite_instance_t *instances;
+	int				   num_instances;
+	int				   max_instances;
+} sprite_batch_t;
+
 void R_UpdateEntityAnimState (entity_t *e, aliashdr_t *paliashdr);
 void R_UpdateEntityMoveState (entity_t *e);
 void R_GetEntityLerpedTransform (entity_t *e, vec3_t out_origin, vec3_t out_angles);
 void R_SetupAliasFrame (entity_t *e, aliashdr_t *paliashdr, int frame, lerpdata_t *lerpdata);
-void R_DrawAliasModel (cb_context_t *cbx, entity_t *e, int *aliaspolys);
+void R_SetupAliasRenderState (entity_t *e, entity_render_state_t *state);
+void R_SetupEntityRenderStates (int index, void *use_tasks);
+entity_render_state_t *R_GetEntityRenderState (entity_t *e);
+void R_DrawAliasModel (cb_context_t *cbx, entity_t *e, int *aliaspolys, alias_batch_t *batch);
+void R_DrawAliasBatch (cb_context_t *cbx, alias_batch_t *batch);
+void R_SetupBeamRenderStates (int first, int last);
+void R_DrawBeams (cb_context_t *cbx, int *aliaspolys, alias_batch_t *batch);
 void R_DrawBrushModel (cb_context_t *cbx, entity_t *e, int chain, int *brushpolys, qboolean sort, qboolean water_opaque_only, qboolean water_transparent_only);
-void R_DrawSpriteModel (cb_context_t *cbx, entity_t *e);
+void R_DrawSpriteModel (cb_context_t *cbx, entity_t *e, sprite_batch_t *batch);
+void R_DrawSpriteBatch (cb_context_t *cbx, sprite_batch_t *batch);
 void R_DrawIndirectBrushes (cb_context_t *cbx, qboolean draw_water, qboolean transparent_water, qboolean draw_sky, int index);
 void R_DrawIndirectBrushes_ShowTris (cb_context_t *cbx);
 
 void R_DrawTextureChains_Water (cb_context_t *cbx, qmodel_t *model, entity_t *ent, texchain_t chain, qboolean opaque_only, qboolean transparent_only);
+void R_DrawBatchIndices (cb_context_t *cbx, uint32_t first_instance);
 
 void GL_BuildLightmaps (void);
 void GL_SetupIndirectDraws (void);
@@ -634,6 +823,7 @@ void R_UploadLightmaps (void);
 void R_DrawWorld_ShowTris (cb_context_t *cbx);
 void R_DrawBrushModel_ShowTris (cb_context_t *cbx, entity_t *e);
 void R_DrawAliasModel_ShowTris (cb_context_t *cbx, entity_t *e);
+void R_DrawBeams_ShowTris (cb_context_t *cbx);
 void R_DrawParticles_ShowTris (cb_context_t *cbx);
 void R_DrawSpriteModel_ShowTris (cb_context_t *cbx, entity_t *e);
 
@@ -679,6 +869,9 @@ static inline void R_BindPipeline (cb_context_t *cbx, VkPipelineBindPoint bind_p
 	if (cbx->current_pipeline.handle != pipeline.handle)
 	{
 		vulkan_globals.vk_cmd_bind_pipeline (cbx->cb, bind_point, pipeline.handle);
+		if (pipeline.layout.dlight_cluster_set)
+			vulkan_globals.vk_cmd_bind_descriptor_sets (
+				cbx->cb, bind_point, pipeline.layout.handle, pipeline.layout.dlight_cluster_set, 1, &vulkan_globals.dlight_cluster_desc_set, 0, NULL);
 		if ((pipeline.layout.push_constant_range.size > 0) &&
 			((cbx->current_pipeline.layout.push_constant_range.stageFlags != pipeline.layout.push_constant_range.stageFlags) ||
 			 (cbx->current_pipeline.layout.push_constant_range.size != pipeline.layout.push_constant_range.size)))
@@ -712,9 +905,57 @@ static inline void R_EndDebugUtilsLabel (cb_context_t *cbx)
 #endif
 }
 
+typedef enum
+{
+	RESOURCE_USE_COLOR_ATTACHMENT,
+	RESOURCE_USE_DEPTH_ATTACHMENT,
+	RESOURCE_USE_DEPTH_READ_COMPUTE,
+	RESOURCE_USE_SAMPLED_FRAGMENT,
+	RESOURCE_USE_SAMPLED_COMPUTE,
+	RESOURCE_USE_STORAGE_READ_COMPUTE,
+	RESOURCE_USE_STORAGE_WRITE_COMPUTE,
+	RESOURCE_USE_TRANSFER_DST,
+	RESOURCE_USE_SHADING_RATE,
+	RESOURCE_USE_NUM,
+} resource_use_t;
+
+// An image whose barriers are derived from the uses declared by the passes, see gl_framegraph.c
+typedef struct
+{
+	VkImage					 image;
+	VkImageAspectFlags		 aspect;
+	uint32_t				 num_levels;
+	VkImageLayout			 layout;
+	VkPipelineStageFlags2KHR write_stages;	 // last write, until a later write replaces it
+	VkAccessFlags2KHR		 write_access;
+	VkPipelineStageFlags2KHR read_stages;	 // reads since the last write
+	VkPipelineStageFlags2KHR visible_stages; // reads that already waited for the last write
+} frame_image_t;
+
+void R_InitFrameImage (frame_image_t *frame_image, VkImage image, VkImageAspectFlags aspect, uint32_t num_levels);
+void R_UseFrameImage (cb_context_t *cbx, frame_image_t *frame_image, resource_use_t use, qboolean discard);
+void R_SetFrameImageUse (frame_image_t *frame_image, resource_use_t use);
+void R_ReturnFrameImage (cb_context_t *cbx, frame_image_t *frame_image, resource_use_t use);
+void R_QueueMemoryBarrier (
+	cb_context_t *cbx, VkPipelineStageFlags2KHR src_stages, VkAccessFlags2KHR src_access, VkPipelineStageFlags2KHR dst_stages, VkAccessFlags2KHR dst_access);
+void R_FlushBarriers (cb_context_t *cbx);
+
 void R_AllocateVulkanMemory (vulkan_memory_t *memory, VkMemoryAllocateInfo *memory_allocate_info, vulkan_memory_type_t type, atomic_uint32_t *num_allocations);
 void R_FreeVulkanMemory (vulkan_memory_t *memory, atomic_uint32_t *num_allocations);
 
+void						  R_UpdateMemoryBudget (void);
+const vulkan_memory_budget_t *R_GetMemoryBudget (void);
+qboolean					  R_MemoryBudgetExceeded (void);
+
+// Resources accessed by both the graphics and the async compute queue are shared concurrently instead of transferring ownership every frame
+#define SHARE_WITH_ASYNC_COMPUTE(create_info)                                  \
+	if (vulkan_globals.compute_queue != VK_NULL_HANDLE)                        \
+	{                                                                          \
+		create_info.sharingMode = VK_SHARING_MODE_CONCURRENT;                  \
+		create_info.queueFamilyIndexCount = 2;                                 \
+		create_info.pQueueFamilyIndices = vulkan_globals.queue_family_indices; \
+	}
+
 void R_CreateBuffer (
 	VkBuffer *buffer, vulkan_memory_t *memory, const size_t size, VkBufferUsageFlags usage, const VkFlags mem_requirements_mask,
 	const VkFlags mem_preferred_mask, atomic_uint32_t *num_allocations, VkDeviceAddress *device_address, const char *name);
@@ -735,6 +976,17 @@ size_t R_CreateBuffers (
 	atomic_uint32_t *num_allocations, const char *memory_name);
 void R_FreeBuffers (const int num_buffers, VkBuffer *buffers, vulkan_memory_t *memory, atomic_uint32_t *num_allocations);
 
+// Entries are destroyed once no frame in flight can use them any more, a bounded number per frame
+typedef struct garbage_queue_s
+{
+	byte	 *entries;
+	uint32_t *frames; // garbage frame each entry was pushed in
+	int		  entry_size;
+	int		  head;
+	int		  tail;
+	int		  capacity;
+} garbage_queue_t;
+
 VkDescriptorSet R_AllocateDescriptorSet (vulkan_desc_set_layout_t *layout);
 void			R_FreeDescriptorSet (VkDescriptorSet desc_set, vulkan_desc_set_layout_t *layout);
 
@@ -749,9 +1001,14 @@ void		   R_InitGPUBuffers (void);
 void		   R_InitMeshHeap (void);
 glheapstats_t *R_GetMeshHeapStats (void);
 void		   R_SwapDynamicBuffers (void);
+void		   R_SetFramesInFlight (int frames_in_flight);
 void		   R_FlushDynamicBuffers (void);
-void		   R_CollectDynamicBufferGarbage (void);
+void		   R_SyncDynamicBufferCvars (void);
 void		   R_CollectMeshBufferGarbage (void);
+void		   R_AdvanceGarbageFrame (void);
+void		   R_PushGarbage (garbage_queue_t *queue, const void *entry);
+int			   R_GarbageBudget (const garbage_queue_t *queue);
+void		  *R_PopGarbage (garbage_queue_t *queue);
 byte		  *R_VertexAllocate (int size, VkBuffer *buffer, VkDeviceSize *buffer_offset);
 byte		  *R_IndexAllocate (int size, VkBuffer *buffer, VkDeviceSize *buffer_offset);
 byte		  *R_UniformAllocate (int size, VkBuffer *buffer, uint32_t *buffer_offset, VkDescriptorSet *descriptor_set);
@@ -759,6 +1016,11 @@ byte		  *R_StorageAllocate (int size, VkBuffer *buffer, VkDeviceSize *buffer_off
 
 void R_AllocateLightmapComputeBuffers ();
 
+void	 R_InitDlightClusters (void);
+qboolean R_ClusteredDlights (void);
+void	 R_SetupDlightClusters (void);
+void	 R_BinDlightClusters (cb_context_t *cbx);
+
 void GL_SetObjectName (uint64_t object, VkObjectType object_type, const char *name);
 
 #endif /* GLQUAKE_H */
@@ -22,6 +22,9 @@ typedef struct hash_map_s hash_map_t;
 
 hash_map_t *HashMap_CreateImpl (
 	const uint32_t key_size, const uint32_t value_size, uint32_t (*hasher) (const void *const), qboolean (*comp) (const void *const, const void *const));
+// Swiss table variant with SIMD probed control bytes, faster for small fixed size keys. Same interface otherwise.
+hash_map_t *HashMap_CreateOpenImpl (
+	const uint32_t key_size, const uint32_t value_size, uint32_t (*hasher) (const void *const), qboolean (*comp) (const void *const, const void *const));
 void	 HashMap_Destroy (hash_map_t *map);
 void	 HashMap_Reserve (hash_map_t *map, int capacity);
 qboolean HashMap_InsertImpl (hash_map_t *map, const uint32_t key_size, const uint32_t value_size, const void *const key, const void *const value);
@@ -31,12 +34,13 @@ uint32_t HashMap_Size (hash_map_t *map);
 void	*HashMap_GetKeyImpl (hash_map_t *map, uint32_t index);
 void	*HashMap_GetValueImpl (hash_map_t *map, uint32_t index);
 
-#define HashMap_Create(key_type, value_type, hasher, comp) HashMap_CreateImpl (sizeof (key_type), sizeof (value_type), hasher, comp)
-#define HashMap_Insert(map, key, value)					   HashMap_InsertImpl (map, sizeof (*key), sizeof (*value), key, value)
-#define HashMap_Erase(map, key)							   HashMap_EraseImpl (map, sizeof (*key), key)
-#define HashMap_Lookup(type, map, key)					   ((type *)HashMap_LookupImpl (map, sizeof (*key), key))
-#define HashMap_GetKey(type, map, index)				   ((type *)HashMap_GetKeyImpl (map, index))
-#define HashMap_GetValue(type, map, index)				   ((type *)HashMap_GetValueImpl (map, index))
+#define HashMap_Create(key_type, value_type, hasher, comp)	   HashMap_CreateImpl (sizeof (key_type), sizeof (value_type), hasher, comp)
+#define HashMap_CreateOpen(key_type, value_type, hasher, comp) HashMap_CreateOpenImpl (sizeof (key_type), sizeof (value_type), hasher, comp)
+#define HashMap_Insert(map, key, value)						   HashMap_InsertImpl (map, sizeof (*key), sizeof (*value), key, value)
+#define HashMap_Erase(map, key)								   HashMap_EraseImpl (map, sizeof (*key), key)
+#define HashMap_Lookup(type, map, key)						   ((type *)HashMap_LookupImpl (map, sizeof (*key), key))
+#define HashMap_GetKey(type, map, index)					   ((type *)HashMap_GetKeyImpl (map, index))
+#define HashMap_GetValue(type, map, index)					   ((type *)HashMap_GetValueImpl (map, index))
 
 // Murmur3 fmix32
 static inline uint32_t HashInt32 (const void *const val)
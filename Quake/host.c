@@ -35,6 +35,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 /* Read-only indicator that RmlUI is compiled in */
 cvar_t ui_use_rmlui = {"ui_use_rmlui", "1", CVAR_ARCHIVE};
+/* Reload UI documents and stylesheets as their files are saved */
+cvar_t ui_autoreload = {"ui_autoreload", "0", CVAR_NONE};
 
 #define UI_STARTUP_SETTLE_SECS 0.8 /* total time startup suppression is active */
 #define UI_STARTUP_FADE_SECS   0.3 /* tail fade-out duration within settle window */
@@ -354,11 +356,19 @@ cvar_t host_maxfps = {"host_maxfps", "200", CVAR_ARCHIVE};	// johnfitz
 
 cvar_t host_phys_max_ticrate = {"host_phys_max_ticrate", "0", CVAR_NONE}; // vso = [0 = disabled; MAX_PHYSICS_FREQ]
 
+cvar_t host_pipeline = {"host_pipeline", "0", CVAR_ARCHIVE}; // run the server while the previous frame is being drawn
+
+extern SDL_Mutex *draw_qcvm_mutex;
+
+static qboolean host_frame_pending;		// the previous frame's draw tasks and tail haven't run yet
+static qboolean host_server_overlapped; // draw_qcvm_mutex is held while the server overlaps drawing
+
 cvar_t host_timescale = {"host_timescale", "0", CVAR_NONE}; // johnfitz
 cvar_t max_edicts = {"max_edicts", "32000", CVAR_NONE};		// vso -- changed from 8192 to 32000 = MAX_EDICTS, because there is no performance impact to do so
 cvar_t cl_nocsqc = {"cl_nocsqc", "0", CVAR_NONE};			// spike -- blocks the loading of any csqc modules
 
 cvar_t sys_ticrate = {"sys_ticrate", "0.025", CVAR_NONE}; // dedicated server
+cvar_t sys_packetwake = {"sys_packetwake", "0", CVAR_NONE}; // dedicated server: run a frame as soon as a packet arrives
 cvar_t serverprofile = {"serverprofile", "0", CVAR_NONE};
 
 cvar_t fraglimit = {"fraglimit", "0", CVAR_NOTIFY | CVAR_SERVERINFO};
@@ -374,6 +384,7 @@ cvar_t pausable = {"pausable", "1", CVAR_NONE};
 
 cvar_t autoload = {"autoload", "1", CVAR_ARCHIVE};
 cvar_t autofastload = {"autofastload", "0", CVAR_ARCHIVE};
+cvar_t savebinary = {"savebinary", "1", CVAR_ARCHIVE};
 
 cvar_t developer = {"developer", "0", CVAR_NONE};
 
@@ -459,6 +470,28 @@ static void Phys_Ticrate_f (cvar_t *var)
 	}
 }
 
+/*
+================
+Host_SynchronizeRendering
+
+Waits for a pipelined frame's draw tasks. The frame's tail still runs at the
+start of the next host frame.
+================
+*/
+static void Host_SynchronizeRendering (void)
+{
+	if (Tasks_IsWorker ())
+		return;
+
+	// the draw tasks may be waiting for the QCVM
+	if (host_server_overlapped)
+	{
+		host_server_overlapped = false;
+		SDL_UnlockMutex (draw_qcvm_mutex);
+	}
+	SCR_SynchronizeRendering ();
+}
+
 /*
 ================
 Host_EndGame
@@ -475,6 +508,7 @@ void Host_EndGame (const char *message, ...)
 	Con_DPrintf ("Host_EndGame: %s\n", string);
 
 	PR_SwitchQCVM (NULL);
+	Host_SynchronizeRendering ();
 
 	if (sv.active)
 		Host_ShutdownServer (false);
@@ -509,6 +543,7 @@ void Host_Error (const char *error, ...)
 	inerror = true;
 
 	PR_SwitchQCVM (NULL);
+	Host_SynchronizeRendering ();
 
 	SCR_EndLoadingPlaque (); // reenable screen updates
 
@@ -614,6 +649,8 @@ void Host_InitLocal (void)
 	Cmd_AddCommand ("version", Host_Version_f);
 
 	Host_InitCommands ();
+	Tasks_InitCommands ();
+	Mem_InitCommands ();
 
 	Cvar_RegisterVariable (&pr_engine);
 	Cvar_RegisterVariable (&host_framerate);
@@ -623,6 +660,7 @@ void Host_InitLocal (void)
 	Cvar_RegisterVariable (&host_phys_max_ticrate); // vso
 	Cvar_SetCallback (&host_phys_max_ticrate, Phys_Ticrate_f);
 	Cvar_RegisterVariable (&host_timescale); // johnfitz
+	Cvar_RegisterVariable (&host_pipeline);
 
 	Cvar_RegisterVariable (&cl_nocsqc);	 // spike
 	Cvar_RegisterVariable (&max_edicts); // johnfitz
@@ -630,6 +668,7 @@ void Host_InitLocal (void)
 	Cvar_RegisterVariable (&devstats); // johnfitz
 
 	Cvar_RegisterVariable (&sys_ticrate);
+	Cvar_RegisterVariable (&sys_packetwake);
 	Cvar_RegisterVariable (&serverprofile);
 
 	Cvar_RegisterVariable (&fraglimit);
@@ -654,6 +693,7 @@ void Host_InitLocal (void)
 
 	Cvar_RegisterVariable (&autoload);
 	Cvar_RegisterVariable (&autofastload);
+	Cvar_RegisterVariable (&savebinary);
 
 	Cvar_RegisterVariable (&temp1);
 
@@ -682,7 +722,11 @@ void Host_WriteConfiguration (void)
 			SDL_free (pref_path);
 		}
 		else
+		{
 			f = fopen (va ("%s/" CONFIG_NAME, com_gamedir), "w");
+			if (f)
+				COM_AddIndexedFile (va ("%s/" CONFIG_NAME, com_gamedir));
+		}
 		if (!f)
 		{
 			Con_Printf ("Couldn't write " CONFIG_NAME ".\n");
@@ -690,6 +734,7 @@ void Host_WriteConfiguration (void)
 		}
 
 		// VID_SyncCvars (); //johnfitz -- write actual current mode to config file, in case cvars were messed with
+		R_SyncDynamicBufferCvars ();
 
 		Key_WriteBindings (f);
 		Cvar_WriteVariables (f);
@@ -785,6 +830,8 @@ void SV_DropClient (qboolean crash)
 	int		  i;
 	client_t *client;
 
+	SV_RecordDrop (host_client - svs.clients);
+
 	if (!crash)
 	{
 		// send any final messages (don't check for errors)
@@ -858,6 +905,8 @@ void Host_ShutdownServer (qboolean crash)
 	byte	  message[4];
 	double	  start;
 
+	SV_ReplayShutdown ();
+
 	if (!sv.active)
 		return;
 
@@ -935,10 +984,12 @@ void Host_ClearMemory (void)
 	}
 
 	Con_DPrintf ("Clearing memory\n");
+	SV_FinishWorldTraces (); // the workers read the world hulls
+	SV_FreeSignonBlobs ();
 	Mod_ClearAll ();
 	Sky_ClearAll ();
 	if (!isDedicated)
-		S_ClearAll ();
+		S_ClearMap ();
 	cls.signon = 0;
 	PR_ClearProgs (&sv.qcvm);
 	Mem_Free (sv.static_entities); // spike -- this is dynamic too, now
@@ -967,11 +1018,12 @@ qboolean Host_FilterTime (float time)
 	float maxfps; // johnfitz
 	float min_frame_time;
 	float delta_since_last_frame;
+	float capture_frame_time = SCR_CaptureFrameTime ();
 
 	realtime += time;
 	delta_since_last_frame = realtime - oldrealtime;
 
-	if (host_maxfps.value)
+	if (host_maxfps.value && !capture_frame_time)
 	{
 		// johnfitz -- max fps cvar
 		maxfps = CLAMP (10.0, host_maxfps.value, 1000.0);
@@ -990,7 +1042,9 @@ qboolean Host_FilterTime (float time)
 	host_frametime = delta_since_last_frame;
 	oldrealtime = realtime;
 
-	if (cls.demoplayback && cls.demospeed != 1.f && cls.demospeed > 0.f)
+	if (capture_frame_time) // every captured frame advances the game by the same amount
+		host_frametime = capture_frame_time;
+	else if (cls.demoplayback && cls.demospeed != 1.f && cls.demospeed > 0.f)
 		host_frametime *= cls.demospeed;
 	// johnfitz -- host_timescale is more intuitive than host_framerate
 	else if (host_timescale.value > 0)
@@ -1037,6 +1091,8 @@ void Host_ServerFrame (void)
 	int		 i, active; // johnfitz
 	edict_t *ent;		// johnfitz
 
+	SV_RecordFrame ();
+
 	// run the world state
 	pr_global_struct->frametime = host_frametime;
 
@@ -1044,15 +1100,23 @@ void Host_ServerFrame (void)
 	SV_ClearDatagram ();
 
 	// check for new clients
+	SV_SpeedsBegin (SVSPEEDS_NET);
 	SV_CheckForNewClients ();
+	SV_SpeedsEnd ();
 
 	// read client messages
+	SV_SpeedsBegin (SVSPEEDS_CLIENTS);
 	SV_RunClients ();
+	SV_SpeedsEnd ();
 
 	// move things around and think
 	// always pause in single player if in console or menus
 	if (!sv.paused && (svs.maxclients > 1 || key_dest == key_game))
+	{
+		SV_SpeedsBegin (SVSPEEDS_PHYSICS);
 		SV_Physics ();
+		SV_SpeedsEnd ();
+	}
 
 	// johnfitz -- devstats
 	if (cls.signon == SIGNONS)
@@ -1072,6 +1136,8 @@ void Host_ServerFrame (void)
 
 	// send all messages to the clients
 	SV_SendClientMessages ();
+
+	SV_SpeedsFrame ();
 }
 
 static void CL_LoadCSProgs (void)
@@ -1093,10 +1159,9 @@ static void CL_LoadCSProgs (void)
 			(PR_LoadProgs ("csprogs.dat", false, PROGHEADER_CRC, pr_csqcbuiltins, pr_csqcnumbuiltins) && qcvm->extfuncs.CSQC_DrawHud) ||
 			(PR_LoadProgs ("progs.dat", false, PROGHEADER_CRC, pr_csqcbuiltins, pr_csqcnumbuiltins) && qcvm->extfuncs.CSQC_DrawHud))
 		{
-			qcvm->max_edicts = CLAMP (MIN_EDICTS, (int)max_edicts.value, MAX_EDICTS);
-			qcvm->edicts = (edict_t *)Mem_Alloc (qcvm->max_edicts * qcvm->edict_size);
+			ED_AllocEdicts (CLAMP (MIN_EDICTS, (int)max_edicts.value, MAX_EDICTS));
 			qcvm->num_edicts = qcvm->reserved_edicts = 1;
-			memset (qcvm->edicts, 0, qcvm->num_edicts * qcvm->edict_size);
+			ED_CommitEdicts (qcvm->num_edicts);
 
 			if (!qcvm->extfuncs.CSQC_DrawHud)
 			{ // no simplecsqc entry points... abort entirely!
@@ -1144,11 +1209,113 @@ static void CL_LoadCSProgs (void)
 	}
 }
 
+/*
+==================
+Host_RunNetFrames
+
+Runs the server+networking (client->server->client), at a different rate from everything else.
+Returns false if no net frame was due.
+==================
+*/
+static qboolean Host_RunNetFrames (double *accumtime, qboolean send_cmd)
+{
+	qboolean ran = false;
+
+	while ((host_netinterval == 0) || (*accumtime >= host_netinterval))
+	{
+		double realframetime = host_frametime;
+		if (host_netinterval && isDedicated == 0)
+		{
+			if (sv.active)
+			{
+				if (listening)
+				{
+					host_frametime = q_min (*accumtime, 0.017);
+				}
+				else
+				{
+					host_frametime = q_max (*accumtime, host_netinterval);
+				}
+			}
+			else
+			{
+				host_frametime = *accumtime;
+			}
+
+			*accumtime -= host_frametime;
+			if (host_timescale.value > 0)
+				host_frametime *= host_timescale.value;
+			else if (host_framerate.value)
+				host_frametime = host_framerate.value;
+		}
+
+		if (send_cmd)
+			CL_SendCmd ();
+		if (sv.active)
+		{
+			PR_SwitchQCVM (&sv.qcvm);
+			Host_ServerFrame ();
+			PR_SwitchQCVM (NULL);
+		}
+		host_frametime = realframetime;
+		Cbuf_Waited ();
+		ran = true;
+
+		if (host_netinterval == 0 || isDedicated)
+			break;
+	}
+
+	return ran;
+}
+
+/*
+==================
+Host_EndFrame
+
+Everything that has to wait for the frame's draw tasks
+==================
+*/
+static void Host_EndFrame (void)
+{
+	Host_SynchronizeRendering ();
+
+	CL_RunParticles (); // johnfitz -- seperated from rendering
+
+	// update audio
+	BGM_Update (); // adds music raw samples and/or advances midi driver
+	if (cls.signon == SIGNONS)
+	{
+		S_Update (r_origin, vpn, vright, vup);
+		CL_DecayLights ();
+	}
+	else if (!isDedicated)
+		S_Update (vec3_origin, vec3_origin, vec3_origin, vec3_origin);
+
+	CDAudio_Update ();
+
+	Host_SavegameUpdate (false);
+	M_PollScans ();
+	Con_FlushQueued ();
+
+	Tasks_TraceFrame ();
+
+	host_framecount++;
+	Mem_FrameReset ();
+	host_frame_pending = false;
+}
+
 /*
 ==================
 Host_Frame
 
 Runs all active servers
+
+With host_pipeline, the draw tasks of a frame keep running while the next
+frame runs the server, which only the r_showbboxes and CSQC HUD tasks look at
+under draw_qcvm_mutex. Everything else the renderer reads (entities, dlights,
+particles, refdef, console, menus) is only changed after they are joined, so
+it needs no snapshot. The server then sees this frame's usercmd one frame
+later than it would otherwise.
 ==================
 */
 void _Host_Frame (double time)
@@ -1158,9 +1325,13 @@ void _Host_Frame (double time)
 	static double time2 = 0;
 	static double time3 = 0;
 	double		  pass1, pass2, pass3;
+	qboolean	  server_ran = false;
 
 	if (setjmp (host_abortserver))
+	{
+		Mem_SetThreadTag (MEM_TAG_MISC); // a Host_Error may have skipped a loader's restore
 		return; // something bad happened, or the server disconnected
+	}
 
 	// keep the random time dependent
 	COM_Rand ();
@@ -1170,11 +1341,23 @@ void _Host_Frame (double time)
 	if (!Host_FilterTime (time))
 		return; // don't run too fast, or packets will flood out
 
-	if (host_speeds.value)
+	if (host_speeds.value || cls.timedemo)
 		time3 = Sys_DoubleTime ();
 
+	if (host_frame_pending)
+	{
+		// run the server while the last frame is drawn
+		SDL_LockMutex (draw_qcvm_mutex);
+		host_server_overlapped = true;
+		server_ran = Host_RunNetFrames (&accumtime, false);
+		Host_EndFrame ();
+	}
+
 	if (!isDedicated)
 	{
+		// vid_lowlatency sleeps here so input is sampled as late as possible
+		GL_WaitForLowLatencyFrame ();
+
 		// get new key events
 		Key_UpdateForDest ();
 		IN_UpdateInputMode ();
@@ -1190,6 +1373,9 @@ void _Host_Frame (double time)
 	// process console commands
 	Cbuf_Execute ();
 
+	if (!isDedicated)
+		CL_BenchmarkFrame ();
+
 	NET_Poll ();
 
 	if (cl.sendprespawn)
@@ -1205,48 +1391,10 @@ void _Host_Frame (double time)
 	CL_AccumulateCmd ();
 	M_UpdateMouse ();
 
-	// Run the server+networking (client->server->client), at a different rate from everyt
-	while ((host_netinterval == 0) || (accumtime >= host_netinterval))
-	{
-		double realframetime = host_frametime;
-		if (host_netinterval && isDedicated == 0)
-		{
-			if (sv.active)
-			{
-				if (listening)
-				{
-					host_frametime = q_min (accumtime, 0.017);
-				}
-				else
-				{
-					host_frametime = q_max (accumtime, host_netinterval);
-				}
-			}
-			else
-			{
-				host_frametime = accumtime;
-			}
-
-			accumtime -= host_frametime;
-			if (host_timescale.value > 0)
-				host_frametime *= host_timescale.value;
-			else if (host_framerate.value)
-				host_frametime = host_framerate.value;
-		}
-
+	if (server_ran)
 		CL_SendCmd ();
-		if (sv.active)
-		{
-			PR_SwitchQCVM (&sv.qcvm);
-			Host_ServerFrame ();
-			PR_SwitchQCVM (NULL);
-		}
-		host_frametime = realframetime;
-		Cbuf_Waited ();
-
-		if (host_netinterval == 0 || isDedicated)
-			break;
-	}
+	else
+		Host_RunNetFrames (&accumtime, true);
 
 	if (cl.qcvm.progs)
 	{
@@ -1265,38 +1413,36 @@ void _Host_Frame (double time)
 #endif
 
 	// update video
-	if (host_speeds.value)
+	if (host_speeds.value || cls.timedemo)
 		time1 = Sys_DoubleTime ();
 
-	SCR_UpdateScreen (true);
-
-	CL_RunParticles (); // johnfitz -- seperated from rendering
-
-	if (host_speeds.value)
-		time2 = Sys_DoubleTime ();
-
-	// update audio
-	BGM_Update (); // adds music raw samples and/or advances midi driver
-	if (cls.signon == SIGNONS)
+	if (!cls.td_parseonly)
 	{
-		S_Update (r_origin, vpn, vright, vup);
-		CL_DecayLights ();
+		if (host_pipeline.value && !isDedicated)
+			SCR_UpdateScreenPipelined ();
+		else
+			SCR_UpdateScreen (true);
 	}
-	else if (!isDedicated)
-		S_Update (vec3_origin, vec3_origin, vec3_origin, vec3_origin);
 
-	CDAudio_Update ();
+	if (host_speeds.value || cls.timedemo)
+		time2 = Sys_DoubleTime ();
+
+	// the tail of a pipelined frame runs at the start of the next one
+	host_frame_pending = SCR_RenderingInFlight ();
+	if (!host_frame_pending)
+		Host_EndFrame ();
 
-	if (host_speeds.value)
+	if (host_speeds.value || cls.timedemo)
 	{
 		pass1 = (time1 - time3) * 1000;
 		time3 = Sys_DoubleTime ();
 		pass2 = (time2 - time1) * 1000;
 		pass3 = (time3 - time2) * 1000;
-		Con_Printf ("%5.2f tot %5.2f server %5.2f gfx %5.2f snd\n", pass1 + pass2 + pass3, pass1, pass2, pass3);
+		if (host_speeds.value)
+			Con_Printf ("%5.2f tot %5.2f server %5.2f gfx %5.2f snd\n", pass1 + pass2 + pass3, pass1, pass2, pass3);
+		if (cls.timedemo)
+			CL_TimeDemoFrame (pass1, pass2, pass3);
 	}
-
-	host_framecount++;
 }
 
 void Host_Frame (double time)
@@ -1349,6 +1495,22 @@ static void Tests_Init ()
 #endif
 }
 
+/*
+====================
+Host_InitFileListTask
+
+The map, mod, demo and save lists only scan the search paths and each fills
+its own list, so they are built on the workers while the video, UI and sound
+devices start up.
+====================
+*/
+static void (*const filelist_inits[]) (void) = {ExtraMaps_Init, Modlist_Init, DemoList_Init, SaveList_Init};
+
+static void Host_InitFileListTask (int index, void *unused)
+{
+	filelist_inits[index] ();
+}
+
 /*
 ====================
 Host_Init
@@ -1356,6 +1518,8 @@ Host_Init
 */
 void Host_Init (void)
 {
+	task_handle_t filelist_task = INVALID_TASK_HANDLE;
+
 	com_argc = host_parms->argc;
 	com_argv = host_parms->argv;
 
@@ -1378,6 +1542,7 @@ void Host_Init (void)
 	Mod_Init ();
 	NET_Init ();
 	SV_Init ();
+	Bench_Init ();
 
 	Con_Printf ("Exe: " __TIME__ " " __DATE__ "\n");
 
@@ -1390,10 +1555,8 @@ void Host_Init (void)
 		V_Init ();
 		Chase_Init ();
 		M_Init ();
-		ExtraMaps_Init (); // johnfitz
-		Modlist_Init ();   // johnfitz
-		DemoList_Init ();  // ericw
-		SaveList_Init ();
+		// johnfitz -- extramaps and modlist, ericw -- demolist
+		filelist_task = Task_AllocateAssignIndexedFuncAndSubmit (Host_InitFileListTask, countof (filelist_inits), NULL, 0);
 #ifdef USE_RMLUI
 		/* Initialize RmlUI core BEFORE VID_Init so the render interface exists
 		 * when UI_InitializeVulkan is called from GL_InitDevice */
@@ -1401,6 +1564,7 @@ void Host_Init (void)
 		/* Register cvars and console commands for RmlUI */
 		Cvar_SetCallback (&ui_use_rmlui, UI_UseRmluiChanged_f);
 		Cvar_RegisterVariable (&ui_use_rmlui);
+		Cvar_RegisterVariable (&ui_autoreload);
 		Cmd_AddCommand ("ui_toggle", UI_Toggle_f);
 		Cmd_AddCommand ("ui_show", UI_Show_f);
 		Cmd_AddCommand ("ui_show_when_ready", UI_ShowWhenReady_f);
@@ -1431,6 +1595,7 @@ void Host_Init (void)
 		Sbar_Init ();
 		CL_Init ();
 		Tests_Init ();
+		Task_Join (filelist_task, TASK_TIMEOUT_INFINITE);
 	}
 
 #ifdef PSET_SCRIPT
@@ -1481,7 +1646,9 @@ void Host_Shutdown (void)
 
 	// keep Con_Printf from trying to update the screen
 	scr_disabled_for_loading = true;
+	Host_SynchronizeRendering ();
 
+	Host_SavegameUpdate (true);
 	Host_WriteConfiguration ();
 
 	NET_Shutdown ();
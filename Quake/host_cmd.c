@@ -23,6 +23,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "quakedef.h"
 #include "q_ctype.h"
+#include "miniz.h"
 #ifdef USE_RMLUI
 #include "ui_manager.h"
 #endif
@@ -37,6 +38,7 @@ extern cvar_t pausable;
 extern cvar_t nomonsters;
 extern cvar_t autoload;
 extern cvar_t autofastload;
+extern cvar_t savebinary;
 
 int current_skill;
 
@@ -246,30 +248,76 @@ static void Host_Maps_f (void)
 
 filelist_item_t *modlist;
 
-static void Modlist_Add (const char *name)
+typedef struct
 {
+	char	*name;
+	time_t	 mtime;
+	qboolean ismod;
+} modcache_t;
+
+// a mod directory is only probed again once its mtime changed
+static modcache_t	   *modcache;
+static int				nummodcache, maxmodcache;
+static filelist_item_t *modlist_pending;
+static task_handle_t	modlist_task = INVALID_TASK_HANDLE;
+
+#ifdef USE_RMLUI
+static void M_PushModsToUI (void);
+#endif
+
+static void Modlist_Add (const char *name, filelist_item_t **list)
+{
+	struct stat mod_info;
 	struct stat maps_info;
 	struct stat ui_info;
+	modcache_t *cache;
+	int			i;
 	if ((strlen (name) == 3) && (q_tolower (name[0]) == 'i') && (q_tolower (name[1]) == 'd') && (name[2] == '1'))
 		return;
 	if (COM_ModForbiddenChars (name))
 		return;
+	char mod_path[MAX_OSPATH];
+	q_snprintf (mod_path, sizeof (mod_path), "%s/%s", com_basedir, name);
+	if (stat (mod_path, &mod_info) != 0)
+		return;
+	for (i = 0; i < nummodcache; i++)
+		if (!strcmp (modcache[i].name, name))
+			break;
+	if (i < nummodcache && modcache[i].mtime == mod_info.st_mtime)
+	{
+		if (modcache[i].ismod)
+			FileList_Add (name, list);
+		return;
+	}
+	if (i == nummodcache)
+	{
+		if (nummodcache == maxmodcache)
+		{
+			maxmodcache = q_max (16, maxmodcache * 2);
+			modcache = Mem_Realloc (modcache, sizeof (modcache_t) * maxmodcache);
+		}
+		modcache[nummodcache++].name = q_strdup (name);
+	}
+	cache = &modcache[i];
+	cache->mtime = mod_info.st_mtime;
+
 	char pak_path[MAX_OSPATH];
 	char progs_path[MAX_OSPATH];
 	char csprogs_path[MAX_OSPATH];
 	char maps_path[MAX_OSPATH];
 	char ui_path[MAX_OSPATH];
-	q_snprintf (pak_path, sizeof (pak_path), "%s/%s/pak0.pak", com_basedir, name);
-	q_snprintf (progs_path, sizeof (progs_path), "%s/%s/progs.dat", com_basedir, name);
-	q_snprintf (csprogs_path, sizeof (csprogs_path), "%s/%s/csprogs.dat", com_basedir, name);
-	q_snprintf (maps_path, sizeof (maps_path), "%s/%s/maps", com_basedir, name);
-	q_snprintf (ui_path, sizeof (ui_path), "%s/%s/ui", com_basedir, name);
+	q_snprintf (pak_path, sizeof (pak_path), "%s/pak0.pak", mod_path);
+	q_snprintf (progs_path, sizeof (progs_path), "%s/progs.dat", mod_path);
+	q_snprintf (csprogs_path, sizeof (csprogs_path), "%s/csprogs.dat", mod_path);
+	q_snprintf (maps_path, sizeof (maps_path), "%s/maps", mod_path);
+	q_snprintf (ui_path, sizeof (ui_path), "%s/ui", mod_path);
 	FILE *pak_file = fopen (pak_path, "rb");
 	FILE *progs_file = fopen (progs_path, "rb");
 	FILE *csprogs_file = fopen (csprogs_path, "rb");
-	if (pak_file || progs_file || csprogs_file || (stat (maps_path, &maps_info) == 0 && maps_info.st_mode & S_IFDIR) ||
-		(stat (ui_path, &ui_info) == 0 && ui_info.st_mode & S_IFDIR))
-		FileList_Add (name, &modlist);
+	cache->ismod = pak_file || progs_file || csprogs_file || (stat (maps_path, &maps_info) == 0 && maps_info.st_mode & S_IFDIR) ||
+				   (stat (ui_path, &ui_info) == 0 && ui_info.st_mode & S_IFDIR);
+	if (cache->ismod)
+		FileList_Add (name, list);
 	if (pak_file)
 		fclose (pak_file);
 	if (progs_file)
@@ -279,7 +327,7 @@ static void Modlist_Add (const char *name)
 }
 
 #ifdef _WIN32
-void Modlist_Init (void)
+static void Modlist_Scan (filelist_item_t **list)
 {
 	WIN32_FIND_DATA fdat;
 	HANDLE			fhnd;
@@ -299,14 +347,14 @@ void Modlist_Init (void)
 		attribs = GetFileAttributes (mod_string);
 		if (attribs != INVALID_FILE_ATTRIBUTES && (attribs & FILE_ATTRIBUTE_DIRECTORY))
 		{
-			Modlist_Add (fdat.cFileName);
+			Modlist_Add (fdat.cFileName, list);
 		}
 	} while (FindNextFile (fhnd, &fdat));
 
 	FindClose (fhnd);
 }
 #else
-void Modlist_Init (void)
+static void Modlist_Scan (filelist_item_t **list)
 {
 	DIR			  *dir_p, *mod_dir_p;
 	struct dirent *dir_t;
@@ -327,7 +375,7 @@ void Modlist_Init (void)
 		mod_dir_p = opendir (mod_string);
 		if (mod_dir_p == NULL)
 			continue;
-		Modlist_Add (dir_t->d_name);
+		Modlist_Add (dir_t->d_name, list);
 		closedir (mod_dir_p);
 	}
 
@@ -335,6 +383,53 @@ void Modlist_Init (void)
 }
 #endif
 
+void Modlist_Init (void)
+{
+	Modlist_Scan (&modlist);
+}
+
+static void Modlist_RefreshTask (void *unused)
+{
+	Modlist_Scan (&modlist_pending);
+}
+
+/*
+==================
+Modlist_Refresh
+
+Rescans the mod directories on a worker, modlist keeps its current
+entries until Modlist_PollRefresh swaps in the new list.
+==================
+*/
+void Modlist_Refresh (void)
+{
+	if (modlist_task != INVALID_TASK_HANDLE)
+		return;
+	modlist_task = Task_AllocateAssignBackgroundFuncAndSubmit (Modlist_RefreshTask, NULL, 0);
+}
+
+/*
+==================
+Modlist_PollRefresh
+
+Returns true if a finished rescan replaced modlist
+==================
+*/
+qboolean Modlist_PollRefresh (void)
+{
+	if (modlist_task == INVALID_TASK_HANDLE || !Task_Join (modlist_task, 0))
+		return false;
+	modlist_task = INVALID_TASK_HANDLE;
+
+	FileList_Clear (&modlist);
+	modlist = modlist_pending;
+	modlist_pending = NULL;
+#ifdef USE_RMLUI
+	M_PushModsToUI ();
+#endif
+	return true;
+}
+
 //==============================================================================
 // ericw -- demo list management
 //==============================================================================
@@ -403,12 +498,12 @@ static void Host_Mods_f (void)
 #ifdef USE_RMLUI
 /*
 ================
-M_SyncModsToUI
+M_PushModsToUI
 
 Pushes current mod directory list to RmlUI for the mods menu.
 ================
 */
-void M_SyncModsToUI (void)
+static void M_PushModsToUI (void)
 {
 	enum
 	{
@@ -419,8 +514,6 @@ void M_SyncModsToUI (void)
 	filelist_item_t *mod;
 	int				 count = 0;
 
-	Modlist_Init ();
-
 	// Always include the base game as the first entry so the user
 	// can switch back from a mod.
 	q_strlcpy (names[0], GAMENAME, sizeof (names[0]));
@@ -442,6 +535,20 @@ void M_SyncModsToUI (void)
 
 	UI_SyncMods (mods, count);
 }
+
+/*
+================
+M_SyncModsToUI
+
+Pushes the current mod list to RmlUI and starts a rescan, the menu is
+updated again once it completes.
+================
+*/
+void M_SyncModsToUI (void)
+{
+	M_PushModsToUI ();
+	Modlist_Refresh ();
+}
 #endif
 
 //==============================================================================
@@ -1084,7 +1191,110 @@ LOAD / SAVE GAME
 ===============================================================================
 */
 
-#define SAVEGAME_VERSION 5
+#define SAVEGAME_VERSION		5
+#define SAVEGAME_VERSION_BINARY 6
+
+/*
+Binary savegames keep the version and comment lines of the text format so the
+menus can still scan them, followed by the uncompressed and compressed sizes
+of a deflated payload:
+
+	string table	size in bytes, then '\0'-terminated strings referenced by index
+	header			spawn parms, skill, map name, time and light styles
+	globals			count, then name, type and value of each DEF_SAVEGLOBAL
+	field table		count, then name and type of each saved field def
+	edicts			count, then per edict the free flag, alpha, the number of
+					non-zero fields and their field table index and value
+	extended info	the same lines the text format keeps in a trailing comment
+
+Strings, functions and fields are stored by name and entities by number, all
+other values as raw words. The snapshot is taken on the main thread, the
+compression and the write happen in a task.
+*/
+
+typedef struct
+{
+	byte  *data;
+	size_t size;
+	size_t capacity;
+} savebuf_t;
+
+typedef struct
+{
+	char		name[MAX_OSPATH];
+	char		comment[SAVEGAME_COMMENT_LENGTH + 1];
+	savebuf_t	strings;
+	savebuf_t	body;
+	hash_map_t *string_map;
+	qboolean	success;
+} savegame_writer_t;
+
+static savegame_writer_t *savegame_writer;
+static task_handle_t	  savegame_task = INVALID_TASK_HANDLE;
+
+static void *SaveBuf_Reserve (savebuf_t *buf, size_t size)
+{
+	if (buf->size + size > buf->capacity)
+	{
+		buf->capacity = buf->capacity ? buf->capacity : 65536;
+		while (buf->size + size > buf->capacity)
+			buf->capacity *= 2;
+		buf->data = (byte *)Mem_Realloc (buf->data, buf->capacity);
+	}
+	void *ptr = buf->data + buf->size;
+	buf->size += size;
+	return ptr;
+}
+
+static void SaveBuf_Write (savebuf_t *buf, const void *data, size_t size)
+{
+	memcpy (SaveBuf_Reserve (buf, size), data, size);
+}
+
+static void SaveBuf_WriteByte (savebuf_t *buf, int c)
+{
+	*(byte *)SaveBuf_Reserve (buf, 1) = c;
+}
+
+static void SaveBuf_WriteLong (savebuf_t *buf, int l)
+{
+	l = LittleLong (l);
+	SaveBuf_Write (buf, &l, 4);
+}
+
+static void SaveBuf_WriteFloat (savebuf_t *buf, float f)
+{
+	f = LittleFloat (f);
+	SaveBuf_Write (buf, &f, 4);
+}
+
+static void SaveBuf_PatchLong (savebuf_t *buf, size_t pos, int l)
+{
+	l = LittleLong (l);
+	memcpy (buf->data + pos, &l, 4);
+}
+
+static void SaveBuf_Printf (savebuf_t *buf, const char *fmt, ...) FUNC_PRINTF (2, 3);
+static void SaveBuf_Printf (savebuf_t *buf, const char *fmt, ...)
+{
+	va_list argptr;
+	char	line[1024];
+	int		len;
+
+	va_start (argptr, fmt);
+	len = q_vsnprintf (line, sizeof (line), fmt, argptr);
+	va_end (argptr);
+
+	if (len > 0)
+		SaveBuf_Write (buf, line, q_min ((size_t)len, sizeof (line) - 1));
+}
+
+static void SaveBuf_Free (savebuf_t *buf)
+{
+	Mem_Free (buf->data);
+	buf->data = NULL;
+	buf->size = buf->capacity = 0;
+}
 
 /*
 ===============
@@ -1125,86 +1335,75 @@ static void Host_SavegameComment (char text[SAVEGAME_COMMENT_LENGTH + 1])
 
 /*
 ===============
-Host_Savegame_f
+Host_SavegameExtInfo
+
+Writes extra info (lightstyles, precaches, etc) in a way that's supposed to be compatible with DP.
+sidenote - this provides extended lightstyles and support for late precaches
+it does NOT protect against spawnfunc precache changes - we would need to include makestatics here too (and optionally baselines, or just recalculate
+those).
 ===============
 */
-static void Host_Savegame_f (void)
+static void Host_SavegameExtInfo (savebuf_t *buf)
 {
-	char  name[MAX_OSPATH];
-	FILE *f;
-	int	  i;
-	char  comment[SAVEGAME_COMMENT_LENGTH + 1];
-
-	if (cmd_source != src_command)
-		return;
+	int i;
 
-	if (!sv.active)
+	SaveBuf_Printf (buf, "// QuakeSpasm extended savegame\n");
+	for (i = MAX_LIGHTSTYLES; i < MAX_LIGHTSTYLES; i++)
 	{
-		Con_Printf ("Not playing a local game.\n");
-		return;
+		if (sv.lightstyles[i])
+			SaveBuf_Printf (buf, "sv.lightstyles %i \"%s\"\n", i, sv.lightstyles[i]);
 	}
-
-	if (sv.nomonsters)
+	for (i = 1; i < MAX_MODELS; i++)
 	{
-		Con_Printf ("Can't save when using \"nomonsters\".\n");
-		return;
+		if (sv.model_precache[i])
+			SaveBuf_Printf (buf, "sv.model_precache %i \"%s\"\n", i, sv.model_precache[i]);
 	}
-
-	if (cl.intermission)
+	for (i = 1; i < MAX_SOUNDS; i++)
 	{
-		Con_Printf ("Can't save in intermission.\n");
-		return;
+		if (sv.sound_precache[i])
+			SaveBuf_Printf (buf, "sv.sound_precache %i \"%s\"\n", i, sv.sound_precache[i]);
 	}
-
-	if (svs.maxclients != 1)
+	for (i = 1; i < MAX_PARTICLETYPES; i++)
 	{
-		Con_Printf ("Can't save multiplayer games.\n");
-		return;
+		if (sv.particle_precache[i])
+			SaveBuf_Printf (buf, "sv.particle_precache %i \"%s\"\n", i, sv.particle_precache[i]);
 	}
 
-	if (Cmd_Argc () != 2)
+	SaveBuf_Printf (buf, "sv.serverflags %i\n", svs.serverflags);
+	for (i = NUM_BASIC_SPAWN_PARMS; i < NUM_TOTAL_SPAWN_PARMS; i++)
 	{
-		Con_Printf ("save <savename> : save a game\n");
-		return;
+		if (svs.clients->spawn_parms[i])
+			SaveBuf_Printf (buf, "spawnparm %i \"%f\"\n", i + 1, svs.clients->spawn_parms[i]);
 	}
 
-	if (strstr (Cmd_Argv (1), ".."))
-	{
-		Con_Printf ("Relative pathnames are not allowed.\n");
-		return;
-	}
+	const char *fog_cmd = Fog_GetFogCommand (true);
+	if (fog_cmd)
+		SaveBuf_Printf (buf, "%s", &fog_cmd[1]);
 
-	for (i = 0; i < svs.maxclients; i++)
-	{
-		if (svs.clients[i].active && (svs.clients[i].edict->v.health <= 0))
-		{
-			Con_Printf ("Can't savegame with a dead player\n");
-			return;
-		}
-	}
+	const char *sky_cmd = Sky_GetSkyCommand (true);
+	if (sky_cmd)
+		SaveBuf_Printf (buf, "%s", &sky_cmd[1]);
+}
 
-	if (multiuser)
-	{
-		char *save_path = SDL_GetPrefPath ("vkQuake", COM_GetGameNames (true));
-		q_snprintf (name, sizeof (name), "%s%s", save_path, Cmd_Argv (1));
-		SDL_free (save_path);
-	}
-	else
-		q_snprintf (name, sizeof (name), "%s/%s", com_gamedir, Cmd_Argv (1));
-	COM_AddExtension (name, ".sav", sizeof (name));
+/*
+===============
+Host_SavegameText
+===============
+*/
+static qboolean Host_SavegameText (const char *name, const char *comment)
+{
+	FILE	 *f;
+	int		  i;
+	savebuf_t ext = {NULL, 0, 0};
 
-	Con_Printf ("Saving game to %s...\n", name);
 	f = fopen (name, "w");
 	if (!f)
 	{
 		Con_Printf ("ERROR: couldn't open.\n");
-		return;
+		return false;
 	}
 
-	PR_SwitchQCVM (&sv.qcvm);
-
 	fprintf (f, "%i\n", SAVEGAME_VERSION);
-	Host_SavegameComment (comment);
 	fprintf (f, "%s\n", comment);
 	for (i = 0; i < NUM_BASIC_SPAWN_PARMS; i++)
 		fprintf (f, "%f\n", svs.clients->spawn_parms[i]);
@@ -1227,101 +1426,400 @@ static void Host_Savegame_f (void)
 		ED_Write (f, EDICT_NUM (i));
 	}
 
-	// add extra info (lightstyles, precaches, etc) in a way that's supposed to be compatible with DP.
-	// sidenote - this provides extended lightstyles and support for late precaches
-	// it does NOT protect against spawnfunc precache changes - we would need to include makestatics here too (and optionally baselines, or just recalculate
-	// those).
+	// the extended info goes in a comment so other engines skip it
+	Host_SavegameExtInfo (&ext);
 	fprintf (f, "/*\n");
-	fprintf (f, "// QuakeSpasm extended savegame\n");
-	for (i = MAX_LIGHTSTYLES; i < MAX_LIGHTSTYLES; i++)
-	{
-		if (sv.lightstyles[i])
-			fprintf (f, "sv.lightstyles %i \"%s\"\n", i, sv.lightstyles[i]);
-	}
-	for (i = 1; i < MAX_MODELS; i++)
-	{
-		if (sv.model_precache[i])
-			fprintf (f, "sv.model_precache %i \"%s\"\n", i, sv.model_precache[i]);
-	}
-	for (i = 1; i < MAX_SOUNDS; i++)
-	{
-		if (sv.sound_precache[i])
-			fprintf (f, "sv.sound_precache %i \"%s\"\n", i, sv.sound_precache[i]);
-	}
-	for (i = 1; i < MAX_PARTICLETYPES; i++)
-	{
-		if (sv.particle_precache[i])
-			fprintf (f, "sv.particle_precache %i \"%s\"\n", i, sv.particle_precache[i]);
-	}
-
-	fprintf (f, "sv.serverflags %i\n", svs.serverflags);
-	for (i = NUM_BASIC_SPAWN_PARMS; i < NUM_TOTAL_SPAWN_PARMS; i++)
-	{
-		if (svs.clients->spawn_parms[i])
-			fprintf (f, "spawnparm %i \"%f\"\n", i + 1, svs.clients->spawn_parms[i]);
-	}
-
-	const char *fog_cmd = Fog_GetFogCommand (true);
-	if (fog_cmd)
-		fprintf (f, "%s", &fog_cmd[1]);
-
-	const char *sky_cmd = Sky_GetSkyCommand (true);
-	if (sky_cmd)
-		fprintf (f, "%s", &sky_cmd[1]);
-
+	fwrite (ext.data, 1, ext.size, f);
 	fprintf (f, "*/\n");
+	SaveBuf_Free (&ext);
 
 	fclose (f);
 
 	Con_Printf ("done.\n");
-
-	// Take the occasion to rebuild the free list
-	// since saving is a long operation anyway
-	ED_RebuildFreeList (false);
-
-	PR_SwitchQCVM (NULL);
 	SaveList_Rebuild ();
 
-	if (strlen (Cmd_Argv (1)) < sizeof (sv.lastsave) - 1)
-		strcpy (sv.lastsave, Cmd_Argv (1));
+	return true;
 }
 
-static void Send_Spawn_Info (client_t *c, qboolean loadgame)
+/*
+===============
+Host_SavegameString
+
+Returns the string table index of s, adding it if needed
+===============
+*/
+static uint32_t Host_SavegameString (savegame_writer_t *writer, const char *s)
 {
-	int		  i;
-	client_t *client;
-	edict_t	 *ent;
+	uint32_t *index = HashMap_Lookup (uint32_t, writer->string_map, &s);
+	if (index)
+		return *index;
+
+	const uint32_t new_index = HashMap_Size (writer->string_map);
+	HashMap_Insert (writer->string_map, &s, &new_index);
+	SaveBuf_Write (&writer->strings, s, strlen (s) + 1);
+	return new_index;
+}
 
-	// send all current names, colors, and frag counts
-	SZ_Clear (&c->message);
+/*
+===============
+Host_SavegameValueWords
+===============
+*/
+static int Host_SavegameValueWords (int type)
+{
+	switch (type)
+	{
+	case ev_vector:
+		return 3;
+	case ev_ext_sint64:
+	case ev_ext_uint64:
+	case ev_ext_double:
+		return 2;
+	default:
+		return 1;
+	}
+}
 
-	// send time of update
-	MSG_WriteByte (&c->message, svc_time);
-	MSG_WriteFloat (&c->message, qcvm->time);
-	if (c->protocol_pext2 & PEXT2_PREDINFO)
-		MSG_WriteShort (&c->message, (c->lastmovemessage & 0xffff));
+/*
+===============
+Host_SavegameWriteValue
+===============
+*/
+static void Host_SavegameWriteValue (savegame_writer_t *writer, int type, const eval_t *val)
+{
+	ddef_t *def;
+	int		i;
 
-	for (i = 0, client = svs.clients; i < svs.maxclients; i++, client++)
+	switch (type)
 	{
-		if (!client->knowntoqc)
-			continue;
-
-		MSG_WriteByte (&c->message, svc_updatename);
-		MSG_WriteByte (&c->message, i);
-		MSG_WriteString (&c->message, client->name);
-		MSG_WriteByte (&c->message, svc_updatecolors);
-		MSG_WriteByte (&c->message, i);
-		MSG_WriteByte (&c->message, client->colors);
-
-		MSG_WriteByte (&c->message, svc_updatefrags);
-		MSG_WriteByte (&c->message, i);
-		MSG_WriteShort (&c->message, client->old_frags);
+	case ev_string:
+		SaveBuf_WriteLong (&writer->body, Host_SavegameString (writer, PR_GetString (val->string)));
+		break;
+	case ev_entity:
+		SaveBuf_WriteLong (&writer->body, NUM_FOR_EDICT (PROG_TO_EDICT (val->edict)));
+		break;
+	case ev_function:
+		SaveBuf_WriteLong (&writer->body, Host_SavegameString (writer, PR_GetString (qcvm->functions[val->function].s_name)));
+		break;
+	case ev_field:
+		def = ED_FieldAtOfs (val->_int);
+		SaveBuf_WriteLong (&writer->body, Host_SavegameString (writer, def ? PR_GetString (def->s_name) : ""));
+		break;
+	default:
+		for (i = 0; i < Host_SavegameValueWords (type); i++)
+			SaveBuf_WriteLong (&writer->body, ((const int *)val)[i]);
+		break;
 	}
+}
 
-	// send all current light styles
-	for (i = 0; i < MAX_LIGHTSTYLES; i++)
-	{
-		MSG_WriteByte (&c->message, svc_lightstyle);
+/*
+===============
+Host_SavegameWriteTask
+===============
+*/
+static void Host_SavegameWriteTask (savegame_writer_t **writer_ptr)
+{
+	savegame_writer_t *writer = *writer_ptr;
+	const size_t	   rawsize = 4 + writer->strings.size + writer->body.size;
+	const size_t	   maxsize = rawsize + rawsize / 8 + 1024; // deflate only expands incompressible data by a few bytes per block
+	byte			  *raw = (byte *)Mem_AllocNonZero (rawsize);
+	byte			  *compressed = (byte *)Mem_AllocNonZero (maxsize);
+	const int		   strings_size = LittleLong ((int)writer->strings.size);
+	FILE			  *f;
+	size_t			   size;
+
+	memcpy (raw, &strings_size, 4);
+	memcpy (raw + 4, writer->strings.data, writer->strings.size);
+	memcpy (raw + 4 + writer->strings.size, writer->body.data, writer->body.size);
+
+	size = tdefl_compress_mem_to_mem (compressed, maxsize, raw, rawsize, TDEFL_DEFAULT_MAX_PROBES);
+	f = size ? fopen (writer->name, "wb") : NULL;
+	if (f)
+	{
+		const int sizes[2] = {LittleLong ((int)rawsize), LittleLong ((int)size)};
+		fprintf (f, "%i\n%s\n", SAVEGAME_VERSION_BINARY, writer->comment);
+		fwrite (sizes, 1, sizeof (sizes), f);
+		fwrite (compressed, 1, size, f);
+		writer->success = !ferror (f);
+		fclose (f);
+	}
+
+	Mem_Free (compressed);
+	Mem_Free (raw);
+}
+
+/*
+===============
+Host_SavegameUpdate
+
+Reports and releases a finished binary save, blocking until it is written if wait is set
+===============
+*/
+void Host_SavegameUpdate (qboolean wait)
+{
+	if (!savegame_writer || !Task_Join (savegame_task, wait ? TASK_TIMEOUT_INFINITE : 0))
+		return;
+
+	if (savegame_writer->success)
+		Con_Printf ("done.\n");
+	else
+		Con_Printf ("ERROR: couldn't write %s.\n", savegame_writer->name);
+
+	SaveBuf_Free (&savegame_writer->strings);
+	SaveBuf_Free (&savegame_writer->body);
+	Mem_Free (savegame_writer);
+	savegame_writer = NULL;
+	savegame_task = INVALID_TASK_HANDLE;
+
+	SaveList_Rebuild ();
+}
+
+/*
+===============
+Host_SavegameBinary
+===============
+*/
+static void Host_SavegameBinary (const char *name, const char *comment)
+{
+	savegame_writer_t *writer;
+	savebuf_t		  *body;
+	ddef_t			  *def;
+	edict_t			  *ed;
+	const char		  *fieldname;
+	int				  *fields;
+	int				  *v;
+	int				   i, j, type, count, num_fields;
+	size_t			   count_pos;
+
+	writer = (savegame_writer_t *)Mem_Alloc (sizeof (savegame_writer_t));
+	q_strlcpy (writer->name, name, sizeof (writer->name));
+	q_strlcpy (writer->comment, comment, sizeof (writer->comment));
+	writer->string_map = HashMap_Create (const char *, uint32_t, &HashStr, &HashStrCmp);
+	body = &writer->body;
+
+	for (i = 0; i < NUM_BASIC_SPAWN_PARMS; i++)
+		SaveBuf_WriteFloat (body, svs.clients->spawn_parms[i]);
+	SaveBuf_WriteLong (body, current_skill);
+	SaveBuf_WriteLong (body, Host_SavegameString (writer, sv.name));
+	SaveBuf_WriteFloat (body, qcvm->time);
+	for (i = 0; i < MAX_LIGHTSTYLES; i++)
+		SaveBuf_WriteLong (body, Host_SavegameString (writer, sv.lightstyles[i] ? sv.lightstyles[i] : "m"));
+
+	// the same globals ED_WriteGlobals saves
+	count_pos = body->size;
+	SaveBuf_WriteLong (body, 0);
+	for (i = 0, count = 0; i < qcvm->progs->numglobaldefs; i++)
+	{
+		def = &qcvm->globaldefs[i];
+		if (!(def->type & DEF_SAVEGLOBAL))
+			continue;
+		type = def->type & ~DEF_SAVEGLOBAL;
+
+		if (type != ev_string && type != ev_float && type != ev_ext_double && type != ev_ext_integer && type != ev_ext_uint32 && type != ev_ext_sint64 &&
+			type != ev_ext_uint64 && type != ev_entity)
+			continue;
+
+		SaveBuf_WriteLong (body, Host_SavegameString (writer, PR_GetString (def->s_name)));
+		SaveBuf_WriteByte (body, type);
+		Host_SavegameWriteValue (writer, type, (eval_t *)&qcvm->globals[def->ofs]);
+		count++;
+	}
+	SaveBuf_PatchLong (body, count_pos, count);
+
+	// the same fields ED_Write saves
+	fields = (int *)Mem_FrameAlloc (qcvm->progs->numfielddefs * sizeof (int));
+	for (i = 1, num_fields = 0; i < qcvm->progs->numfielddefs; i++)
+	{
+		def = &qcvm->fielddefs[i];
+		if ((def->type & DEF_SAVEGLOBAL) || def->type >= NUM_TYPE_SIZES)
+			continue;
+
+		fieldname = PR_GetString (def->s_name);
+		j = strlen (fieldname);
+		if (j > 1 && fieldname[j - 2] == '_')
+			continue; // skip _x, _y, _z vars
+
+		fields[num_fields++] = i;
+	}
+	SaveBuf_WriteLong (body, num_fields);
+	for (i = 0; i < num_fields; i++)
+	{
+		def = &qcvm->fielddefs[fields[i]];
+		SaveBuf_WriteLong (body, Host_SavegameString (writer, PR_GetString (def->s_name)));
+		SaveBuf_WriteByte (body, def->type);
+	}
+
+	SaveBuf_WriteLong (body, qcvm->num_edicts);
+	for (i = 0; i < qcvm->num_edicts; i++)
+	{
+		ed = EDICT_NUM (i);
+		SaveBuf_WriteByte (body, ed->free);
+		if (ed->free)
+			continue;
+		SaveBuf_WriteByte (body, ed->alpha);
+
+		count_pos = body->size;
+		SaveBuf_WriteLong (body, 0);
+		for (j = 0, count = 0; j < num_fields; j++)
+		{
+			def = &qcvm->fielddefs[fields[j]];
+			v = (int *)((char *)&ed->v + def->ofs * 4);
+
+			// if the value is still all 0, skip the field
+			if (def->type != ev_vector && !v[0])
+				continue;
+			if (def->type == ev_vector && !v[0] && !v[1] && !v[2])
+				continue;
+
+			SaveBuf_WriteLong (body, j);
+			Host_SavegameWriteValue (writer, def->type, (eval_t *)v);
+			count++;
+		}
+		SaveBuf_PatchLong (body, count_pos, count);
+	}
+
+	Host_SavegameExtInfo (body);
+	SaveBuf_WriteByte (body, 0);
+
+	// every string is copied to the table, nothing of the server state is referenced past this point
+	HashMap_Destroy (writer->string_map);
+	writer->string_map = NULL;
+
+	savegame_writer = writer;
+	savegame_task = Task_AllocateAssignBackgroundFuncAndSubmit ((task_func_t)Host_SavegameWriteTask, &writer, sizeof (savegame_writer_t *));
+}
+
+/*
+===============
+Host_Savegame_f
+===============
+*/
+static void Host_Savegame_f (void)
+{
+	char	 name[MAX_OSPATH];
+	int		 i;
+	char	 comment[SAVEGAME_COMMENT_LENGTH + 1];
+	qboolean saved;
+
+	if (cmd_source != src_command)
+		return;
+
+	if (!sv.active)
+	{
+		Con_Printf ("Not playing a local game.\n");
+		return;
+	}
+
+	if (sv.nomonsters)
+	{
+		Con_Printf ("Can't save when using \"nomonsters\".\n");
+		return;
+	}
+
+	if (cl.intermission)
+	{
+		Con_Printf ("Can't save in intermission.\n");
+		return;
+	}
+
+	if (svs.maxclients != 1)
+	{
+		Con_Printf ("Can't save multiplayer games.\n");
+		return;
+	}
+
+	if (Cmd_Argc () != 2)
+	{
+		Con_Printf ("save <savename> : save a game\n");
+		return;
+	}
+
+	if (strstr (Cmd_Argv (1), ".."))
+	{
+		Con_Printf ("Relative pathnames are not allowed.\n");
+		return;
+	}
+
+	for (i = 0; i < svs.maxclients; i++)
+	{
+		if (svs.clients[i].active && (svs.clients[i].edict->v.health <= 0))
+		{
+			Con_Printf ("Can't savegame with a dead player\n");
+			return;
+		}
+	}
+
+	if (multiuser)
+	{
+		char *save_path = SDL_GetPrefPath ("vkQuake", COM_GetGameNames (true));
+		q_snprintf (name, sizeof (name), "%s%s", save_path, Cmd_Argv (1));
+		SDL_free (save_path);
+	}
+	else
+		q_snprintf (name, sizeof (name), "%s/%s", com_gamedir, Cmd_Argv (1));
+	COM_AddExtension (name, ".sav", sizeof (name));
+
+	// the previous save may still be writing the same file
+	Host_SavegameUpdate (true);
+
+	Con_Printf ("Saving game to %s...\n", name);
+
+	PR_SwitchQCVM (&sv.qcvm);
+
+	Host_SavegameComment (comment);
+	if (savebinary.value)
+	{
+		Host_SavegameBinary (name, comment);
+		saved = true;
+	}
+	else
+		saved = Host_SavegameText (name, comment);
+
+	PR_SwitchQCVM (NULL);
+
+	if (!saved)
+		return;
+
+	if (strlen (Cmd_Argv (1)) < sizeof (sv.lastsave) - 1)
+		strcpy (sv.lastsave, Cmd_Argv (1));
+}
+
+static void Send_Spawn_Info (client_t *c, qboolean loadgame)
+{
+	int		  i;
+	client_t *client;
+	edict_t	 *ent;
+
+	// send all current names, colors, and frag counts
+	SZ_Clear (&c->message);
+
+	// send time of update
+	MSG_WriteByte (&c->message, svc_time);
+	MSG_WriteFloat (&c->message, qcvm->time);
+	if (c->protocol_pext2 & PEXT2_PREDINFO)
+		MSG_WriteShort (&c->message, (c->lastmovemessage & 0xffff));
+
+	for (i = 0, client = svs.clients; i < svs.maxclients; i++, client++)
+	{
+		if (!client->knowntoqc)
+			continue;
+
+		MSG_WriteByte (&c->message, svc_updatename);
+		MSG_WriteByte (&c->message, i);
+		MSG_WriteString (&c->message, client->name);
+		MSG_WriteByte (&c->message, svc_updatecolors);
+		MSG_WriteByte (&c->message, i);
+		MSG_WriteByte (&c->message, client->colors);
+
+		MSG_WriteByte (&c->message, svc_updatefrags);
+		MSG_WriteByte (&c->message, i);
+		MSG_WriteShort (&c->message, client->old_frags);
+	}
+
+	// send all current light styles
+	for (i = 0; i < MAX_LIGHTSTYLES; i++)
+	{
+		MSG_WriteByte (&c->message, svc_lightstyle);
 		MSG_WriteByte (&c->message, (char)i);
 		MSG_WriteString (&c->message, sv.lightstyles[i]);
 	}
@@ -1364,6 +1862,441 @@ static void Send_Spawn_Info (client_t *c, qboolean loadgame)
 		SV_WriteClientdataToMessage (c, &c->message);
 }
 
+typedef struct
+{
+	byte		*payload;
+	size_t		 size;
+	size_t		 pos;
+	const char **strings;
+	int			*functions; // function number of each string, -1 until looked up
+	uint32_t	 num_strings;
+} savegame_reader_t;
+
+static savegame_reader_t loadgame_reader;
+
+static const byte *SaveReader_Read (savegame_reader_t *reader, size_t size)
+{
+	if (size > reader->size - reader->pos)
+		Host_Error ("Savegame is truncated");
+	const byte *ptr = reader->payload + reader->pos;
+	reader->pos += size;
+	return ptr;
+}
+
+static int SaveReader_ReadByte (savegame_reader_t *reader)
+{
+	return *SaveReader_Read (reader, 1);
+}
+
+static int SaveReader_ReadLong (savegame_reader_t *reader)
+{
+	int l;
+	memcpy (&l, SaveReader_Read (reader, 4), 4);
+	return LittleLong (l);
+}
+
+static float SaveReader_ReadFloat (savegame_reader_t *reader)
+{
+	float f;
+	memcpy (&f, SaveReader_Read (reader, 4), 4);
+	return LittleFloat (f);
+}
+
+static uint32_t SaveReader_ReadStringIndex (savegame_reader_t *reader)
+{
+	const uint32_t index = (uint32_t)SaveReader_ReadLong (reader);
+	if (index >= reader->num_strings)
+		Host_Error ("Savegame has a bad string index");
+	return index;
+}
+
+static const char *SaveReader_ReadString (savegame_reader_t *reader)
+{
+	return reader->strings[SaveReader_ReadStringIndex (reader)];
+}
+
+static void SaveReader_Free (savegame_reader_t *reader)
+{
+	Mem_Free (reader->payload);
+	memset (reader, 0, sizeof (*reader));
+}
+
+/*
+===============
+Host_LoadgameDecompress
+
+Inflates the payload following the comment line of a binary savegame and indexes its string table
+===============
+*/
+static void Host_LoadgameDecompress (savegame_reader_t *reader, const char *data, const char *end)
+{
+	const char *strings;
+	int			sizes[2];
+	uint32_t	strings_size, i;
+
+	data = strchr (data, '\n'); // skip the comment
+	if (!data || end - (data + 1) < (ptrdiff_t)sizeof (sizes))
+		Host_Error ("Savegame is truncated");
+	memcpy (sizes, data + 1, sizeof (sizes));
+	data += 1 + sizeof (sizes);
+	reader->size = (uint32_t)LittleLong (sizes[0]);
+	if ((uint32_t)LittleLong (sizes[1]) > (size_t)(end - data))
+		Host_Error ("Savegame is truncated");
+
+	reader->payload = (byte *)Mem_AllocNonZero (reader->size);
+	if (tinfl_decompress_mem_to_mem (reader->payload, reader->size, data, (uint32_t)LittleLong (sizes[1]), 0) != reader->size)
+		Host_Error ("Savegame is corrupt");
+
+	strings_size = (uint32_t)SaveReader_ReadLong (reader);
+	strings = (const char *)SaveReader_Read (reader, strings_size);
+	if (strings_size && strings[strings_size - 1])
+		Host_Error ("Savegame is corrupt");
+	for (i = 0; i < strings_size; i++)
+		reader->num_strings += !strings[i];
+
+	reader->strings = (const char **)Mem_FrameAlloc (reader->num_strings * sizeof (const char *));
+	reader->functions = (int *)Mem_FrameAlloc (reader->num_strings * sizeof (int));
+	for (i = 0; i < reader->num_strings; i++)
+	{
+		reader->strings[i] = strings;
+		reader->functions[i] = -1;
+		strings += strlen (strings) + 1;
+	}
+}
+
+/*
+===============
+Host_LoadgameReadValue
+===============
+*/
+static void Host_LoadgameReadValue (savegame_reader_t *reader, int type, eval_t *val)
+{
+	ddef_t		*def;
+	dfunction_t *func;
+	uint32_t	 index;
+	int			 i;
+
+	switch (type)
+	{
+	case ev_string:
+		val->string = ED_NewString (SaveReader_ReadString (reader));
+		break;
+	case ev_entity:
+		i = SaveReader_ReadLong (reader);
+		if (i < 0 || i >= qcvm->max_edicts)
+			Host_Error ("Savegame references edict %i", i);
+		val->edict = EDICT_TO_PROG (EDICT_NUM (i));
+		break;
+	case ev_function:
+		index = SaveReader_ReadStringIndex (reader);
+		if (reader->functions[index] < 0)
+		{
+			func = ED_FindFunction (reader->strings[index]);
+			if (!func)
+				Host_Error ("Can't find function %s", reader->strings[index]);
+			reader->functions[index] = func - qcvm->functions;
+		}
+		val->function = reader->functions[index];
+		break;
+	case ev_field:
+		def = ED_FindField (SaveReader_ReadString (reader));
+		val->_int = def ? def->ofs : 0;
+		break;
+	default:
+		for (i = 0; i < Host_SavegameValueWords (type); i++)
+			((int *)val)[i] = SaveReader_ReadLong (reader);
+		break;
+	}
+}
+
+/*
+===============
+Host_LoadgameExtInfo
+
+Parses the extended info lines written by Host_SavegameExtInfo
+===============
+*/
+static void Host_LoadgameExtInfo (const char *ext, float *spawn_parms, qboolean fastload)
+{
+	char *end;
+
+	while ((end = strchr (ext, '\n')))
+	{
+		*end = 0;
+		ext = COM_Parse (ext);
+		if (!strcmp (com_token, "sv.lightstyles"))
+		{
+			int idx;
+			ext = COM_Parse (ext);
+			idx = atoi (com_token);
+			ext = COM_Parse (ext);
+			if (idx >= 0 && idx < MAX_LIGHTSTYLES)
+			{
+				if (*com_token)
+					sv.lightstyles[idx] = (const char *)q_strdup (com_token);
+				else
+					sv.lightstyles[idx] = NULL;
+			}
+		}
+		else if (!strcmp (com_token, "sv.model_precache"))
+		{
+			int idx;
+			ext = COM_Parse (ext);
+			idx = atoi (com_token);
+			ext = COM_Parse (ext);
+			if (idx >= 1 && idx < MAX_MODELS)
+			{
+				sv.model_precache[idx] = (const char *)q_strdup (com_token);
+				sv.models[idx] = Mod_ForName (sv.model_precache[idx], idx == 1);
+				// if (idx == 1)
+				//	sv.worldmodel = sv.models[idx];
+			}
+		}
+		else if (!strcmp (com_token, "sv.sound_precache"))
+		{
+			int idx;
+			ext = COM_Parse (ext);
+			idx = atoi (com_token);
+			ext = COM_Parse (ext);
+			if (idx >= 1 && idx < MAX_MODELS)
+				sv.sound_precache[idx] = (const char *)q_strdup (com_token);
+		}
+		else if (!strcmp (com_token, "sv.particle_precache"))
+		{
+			int idx;
+			ext = COM_Parse (ext);
+			idx = atoi (com_token);
+			ext = COM_Parse (ext);
+			if (idx >= 1 && idx < MAX_PARTICLETYPES)
+			{
+				Mem_Free (sv.particle_precache[idx]);
+				sv.particle_precache[idx] = (const char *)q_strdup (com_token);
+			}
+		}
+		else if (!strcmp (com_token, "sv.serverflags") || !strcmp (com_token, "svs.serverflags"))
+		{
+			int fl;
+			ext = COM_Parse (ext);
+			fl = atoi (com_token);
+			svs.serverflags = fl;
+		}
+		else if (!strcmp (com_token, "spawnparm"))
+		{
+			int idx;
+			ext = COM_Parse (ext);
+			idx = atoi (com_token);
+			ext = COM_Parse (ext);
+			if (idx >= 1 && idx <= NUM_TOTAL_SPAWN_PARMS)
+				spawn_parms[idx - 1] = atof (com_token);
+		}
+		else if (!strcmp (com_token, "fog") && fastload)
+		{
+			float d, r, g, b;
+			ext = COM_Parse (ext);
+			d = atof (com_token);
+			ext = COM_Parse (ext);
+			r = atof (com_token);
+			ext = COM_Parse (ext);
+			g = atof (com_token);
+			ext = COM_Parse (ext);
+			b = atof (com_token);
+			Fog_Update (d, r, g, b, 0.0f);
+		}
+		else if (!strcmp (com_token, "sky") && fastload)
+		{
+			ext = COM_Parse (ext);
+			Sky_LoadSkyBox (com_token);
+		}
+		else if (!strcmp (com_token, "skyfog") && fastload)
+		{
+			ext = COM_Parse (ext);
+			Sky_SetSkyfog (atof (com_token));
+		}
+		*end = '\n';
+		ext = end + 1;
+	}
+}
+
+/*
+===============
+Host_LoadgamePrepareEdict
+
+Clears an edict before its saved fields are read
+===============
+*/
+static void Host_LoadgamePrepareEdict (edict_t *ent, int entnum)
+{
+	if (entnum < qcvm->num_edicts)
+	{
+		// Maintain the free-list conststency
+		if (ent->free)
+			ED_RemoveFromFreeList (ent);
+
+		ent->free = false;
+		memset (&ent->v, 0, qcvm->progs->entityfields * 4);
+	}
+	else
+	{
+		ED_CommitEdicts (entnum + 1);
+		memset (ent, 0, qcvm->edict_size);
+		ent->baseline = nullentitystate;
+	}
+}
+
+/*
+===============
+Host_LoadgameText
+
+Loads the light styles, globals and edicts of a text savegame, returns the number of edicts
+===============
+*/
+static int Host_LoadgameText (const char *data, float *spawn_parms, qboolean fastload)
+{
+	int		 i;
+	edict_t *ent;
+	int		 entnum;
+
+	// load the light styles
+	for (i = 0; i < MAX_LIGHTSTYLES; i++)
+	{
+		data = COM_ParseStringNewline (data);
+		sv.lightstyles[i] = (const char *)q_strdup (com_token);
+	}
+
+	if (fastload) // can be done for normal loads too, but keep the previous behavior
+		PR_ClearEdictStrings ();
+
+	// load the edicts out of the savegame file
+	entnum = -1; // -1 is the globals
+	while (*data)
+	{
+		while (*data == ' ' || *data == '\r' || *data == '\n')
+			data++;
+		if (data[0] == '/' && data[1] == '*' && (data[2] == '\r' || data[2] == '\n'))
+		{ // looks like an extended saved game
+			Host_LoadgameExtInfo (data + 2, spawn_parms, fastload);
+		}
+
+		data = COM_Parse (data);
+		if (!com_token[0])
+			break; // end of file
+		if (strcmp (com_token, "{"))
+		{
+			Host_Error ("First token isn't a brace");
+		}
+
+		if (entnum == -1)
+		{ // parse the global vars
+			data = ED_ParseGlobals (data);
+		}
+		else
+		{ // parse an edict
+			ent = EDICT_NUM (entnum);
+			Host_LoadgamePrepareEdict (ent, entnum);
+			data = ED_ParseEdict (data, ent);
+
+			// link it into the bsp tree
+			if (!ent->free)
+				SV_LinkEdict (ent, false);
+		}
+
+		entnum++;
+	}
+
+	return entnum;
+}
+
+/*
+===============
+Host_LoadgameBinary
+
+Binary counterpart of Host_LoadgameText, reads everything after the header
+===============
+*/
+static int Host_LoadgameBinary (savegame_reader_t *reader, float *spawn_parms, qboolean fastload)
+{
+	ddef_t	   *def;
+	ddef_t	  **fields;
+	int		   *field_types;
+	edict_t	   *ent;
+	const char *name;
+	int			i, j, type, count, num_fields, num_edicts;
+
+	for (i = 0; i < MAX_LIGHTSTYLES; i++)
+		sv.lightstyles[i] = (const char *)q_strdup (SaveReader_ReadString (reader));
+
+	if (fastload) // can be done for normal loads too, but keep the previous behavior
+		PR_ClearEdictStrings ();
+
+	count = SaveReader_ReadLong (reader);
+	for (i = 0; i < count; i++)
+	{
+		name = SaveReader_ReadString (reader);
+		type = SaveReader_ReadByte (reader);
+		def = ED_FindGlobal (name);
+		if (!def || (def->type & ~DEF_SAVEGLOBAL) != type)
+		{
+			Con_Printf ("'%s' is not a global\n", name);
+			SaveReader_Read (reader, Host_SavegameValueWords (type) * 4);
+			continue;
+		}
+		Host_LoadgameReadValue (reader, type, (eval_t *)&qcvm->globals[def->ofs]);
+	}
+
+	// resolve the saved field table against the current progs once
+	num_fields = SaveReader_ReadLong (reader);
+	if (num_fields < 0)
+		Host_Error ("Savegame is corrupt");
+	fields = (ddef_t **)Mem_FrameAlloc (num_fields * sizeof (ddef_t *));
+	field_types = (int *)Mem_FrameAlloc (num_fields * sizeof (int));
+	for (i = 0; i < num_fields; i++)
+	{
+		name = SaveReader_ReadString (reader);
+		field_types[i] = SaveReader_ReadByte (reader);
+		fields[i] = ED_FindField (name);
+		if (fields[i] && fields[i]->type != field_types[i])
+			fields[i] = NULL;
+		if (!fields[i])
+			Con_DPrintf ("\"%s\" is not a field\n", name);
+	}
+
+	num_edicts = SaveReader_ReadLong (reader);
+	if (num_edicts < 0 || num_edicts > qcvm->max_edicts)
+		Host_Error ("Savegame has %i edicts, max is %i", num_edicts, qcvm->max_edicts);
+	for (i = 0; i < num_edicts; i++)
+	{
+		ent = EDICT_NUM (i);
+		Host_LoadgamePrepareEdict (ent, i);
+		if (SaveReader_ReadByte (reader))
+		{
+			ED_Free (ent);
+			continue;
+		}
+		ent->alpha = SaveReader_ReadByte (reader);
+
+		count = SaveReader_ReadLong (reader);
+		for (j = 0; j < count; j++)
+		{
+			const uint32_t field = (uint32_t)SaveReader_ReadLong (reader);
+			if (field >= (uint32_t)num_fields)
+				Host_Error ("Savegame is corrupt");
+			if (fields[field])
+				Host_LoadgameReadValue (reader, field_types[field], (eval_t *)((int *)&ent->v + fields[field]->ofs));
+			else
+				SaveReader_Read (reader, Host_SavegameValueWords (field_types[field]) * 4);
+		}
+
+		// link it into the bsp tree
+		SV_LinkEdict (ent, false);
+	}
+
+	if (reader->pos == reader->size || reader->payload[reader->size - 1])
+		Host_Error ("Savegame is truncated");
+	Host_LoadgameExtInfo ((const char *)reader->payload + reader->pos, spawn_parms, fastload);
+
+	return num_edicts;
+}
+
 /*
 ===============
 Host_Loadgame_f
@@ -1377,8 +2310,8 @@ static void Host_Loadgame_f (void)
 	char		mapname[MAX_QPATH];
 	float		time, tfloat;
 	const char *data;
+	long		len;
 	int			i;
-	edict_t	   *ent;
 	int			entnum;
 	int			version;
 	float		spawn_parms[NUM_TOTAL_SPAWN_PARMS];
@@ -1407,8 +2340,14 @@ static void Host_Loadgame_f (void)
 		Cvar_SetValueQuick (&nomonsters, 0.f);
 	}
 
+	// the save being loaded may still be written
+	Host_SavegameUpdate (true);
+
 	cls.demonum = -1; // stop demo loop in case this fails
 
+	// release the payload of a binary savegame that failed to load with a Host_Error
+	SaveReader_Free (&loadgame_reader);
+
 	char	*save_path = multiuser ? SDL_GetPrefPath ("vkQuake", COM_GetGameNames (true)) : NULL;
 	qboolean loadable = false;
 	for (int j = (multiuser ? 0 : 1); j < 2; ++j)
@@ -1423,7 +2362,13 @@ static void Host_Loadgame_f (void)
 		if (start != NULL)
 			Mem_Free (start);
 
-		start = (char *)COM_LoadMallocFile_TextMode_OSPath (name, NULL);
+		start = (char *)COM_LoadMallocFile_OSPath (name, &len);
+		if (start && atoi (start) != SAVEGAME_VERSION_BINARY)
+		{
+			// text savegames are loaded in text mode for the CRLF translation
+			Mem_Free (start);
+			start = (char *)COM_LoadMallocFile_TextMode_OSPath (name, &len);
+		}
 		if (start)
 		{
 			loadable = true;
@@ -1447,27 +2392,38 @@ static void Host_Loadgame_f (void)
 
 	data = start;
 	data = COM_ParseIntNewline (data, &version);
-	if (version != SAVEGAME_VERSION)
+	if (version != SAVEGAME_VERSION && version != SAVEGAME_VERSION_BINARY)
 	{
 		Mem_Free (start);
 		start = NULL;
 		Host_Error ("Savegame is version %i, not %i", version, SAVEGAME_VERSION);
 		return;
 	}
-	data = COM_ParseStringNewline (data);
-	for (i = 0; i < NUM_BASIC_SPAWN_PARMS; i++)
-		data = COM_ParseFloatNewline (data, &spawn_parms[i]);
-	for (; i < NUM_TOTAL_SPAWN_PARMS; i++)
+	if (version == SAVEGAME_VERSION_BINARY)
+	{
+		Host_LoadgameDecompress (&loadgame_reader, data, start + len);
+		for (i = 0; i < NUM_BASIC_SPAWN_PARMS; i++)
+			spawn_parms[i] = SaveReader_ReadFloat (&loadgame_reader);
+		tfloat = SaveReader_ReadLong (&loadgame_reader);
+		q_strlcpy (mapname, SaveReader_ReadString (&loadgame_reader), sizeof (mapname));
+		time = SaveReader_ReadFloat (&loadgame_reader);
+	}
+	else
+	{
+		data = COM_ParseStringNewline (data);
+		for (i = 0; i < NUM_BASIC_SPAWN_PARMS; i++)
+			data = COM_ParseFloatNewline (data, &spawn_parms[i]);
+		// this silliness is so we can load 1.06 save files, which have float skill values
+		data = COM_ParseFloatNewline (data, &tfloat);
+		data = COM_ParseStringNewline (data);
+		q_strlcpy (mapname, com_token, sizeof (mapname));
+		data = COM_ParseFloatNewline (data, &time);
+	}
+	for (i = NUM_BASIC_SPAWN_PARMS; i < NUM_TOTAL_SPAWN_PARMS; i++)
 		spawn_parms[i] = 0;
-	// this silliness is so we can load 1.06 save files, which have float skill values
-	data = COM_ParseFloatNewline (data, &tfloat);
 	current_skill = (int)(tfloat + 0.1);
 	Cvar_SetValue ("skill", (float)current_skill);
 
-	data = COM_ParseStringNewline (data);
-	q_strlcpy (mapname, com_token, sizeof (mapname));
-	data = COM_ParseFloatNewline (data, &time);
-
 	if (fastload && (!sv.active || cls.signon != SIGNONS || svs.maxclients != 1))
 	{
 		Con_Printf ("Can't fastload (first load, or is a client multiplayer game)\n");
@@ -1500,6 +2456,7 @@ static void Host_Loadgame_f (void)
 		PR_SwitchQCVM (NULL);
 		Mem_Free (start);
 		start = NULL;
+		SaveReader_Free (&loadgame_reader);
 		SCR_EndLoadingPlaque ();
 		Con_Printf ("Couldn't load map\n");
 		return;
@@ -1515,162 +2472,10 @@ static void Host_Loadgame_f (void)
 	if (was_recording)
 		CL_Resume_Record (fastload);
 
-	// load the light styles
-	for (i = 0; i < MAX_LIGHTSTYLES; i++)
-	{
-		data = COM_ParseStringNewline (data);
-		sv.lightstyles[i] = (const char *)q_strdup (com_token);
-	}
-
-	if (fastload) // can be done for normal loads too, but keep the previous behavior
-		PR_ClearEdictStrings ();
-
-	// load the edicts out of the savegame file
-	entnum = -1; // -1 is the globals
-	while (*data)
-	{
-		while (*data == ' ' || *data == '\r' || *data == '\n')
-			data++;
-		if (data[0] == '/' && data[1] == '*' && (data[2] == '\r' || data[2] == '\n'))
-		{ // looks like an extended saved game
-			char	   *end;
-			const char *ext;
-			ext = data + 2;
-			while ((end = strchr (ext, '\n')))
-			{
-				*end = 0;
-				ext = COM_Parse (ext);
-				if (!strcmp (com_token, "sv.lightstyles"))
-				{
-					int idx;
-					ext = COM_Parse (ext);
-					idx = atoi (com_token);
-					ext = COM_Parse (ext);
-					if (idx >= 0 && idx < MAX_LIGHTSTYLES)
-					{
-						if (*com_token)
-							sv.lightstyles[idx] = (const char *)q_strdup (com_token);
-						else
-							sv.lightstyles[idx] = NULL;
-					}
-				}
-				else if (!strcmp (com_token, "sv.model_precache"))
-				{
-					int idx;
-					ext = COM_Parse (ext);
-					idx = atoi (com_token);
-					ext = COM_Parse (ext);
-					if (idx >= 1 && idx < MAX_MODELS)
-					{
-						sv.model_precache[idx] = (const char *)q_strdup (com_token);
-						sv.models[idx] = Mod_ForName (sv.model_precache[idx], idx == 1);
-						// if (idx == 1)
-						//	sv.worldmodel = sv.models[idx];
-					}
-				}
-				else if (!strcmp (com_token, "sv.sound_precache"))
-				{
-					int idx;
-					ext = COM_Parse (ext);
-					idx = atoi (com_token);
-					ext = COM_Parse (ext);
-					if (idx >= 1 && idx < MAX_MODELS)
-						sv.sound_precache[idx] = (const char *)q_strdup (com_token);
-				}
-				else if (!strcmp (com_token, "sv.particle_precache"))
-				{
-					int idx;
-					ext = COM_Parse (ext);
-					idx = atoi (com_token);
-					ext = COM_Parse (ext);
-					if (idx >= 1 && idx < MAX_PARTICLETYPES)
-					{
-						Mem_Free (sv.particle_precache[idx]);
-						sv.particle_precache[idx] = (const char *)q_strdup (com_token);
-					}
-				}
-				else if (!strcmp (com_token, "sv.serverflags") || !strcmp (com_token, "svs.serverflags"))
-				{
-					int fl;
-					ext = COM_Parse (ext);
-					fl = atoi (com_token);
-					svs.serverflags = fl;
-				}
-				else if (!strcmp (com_token, "spawnparm"))
-				{
-					int idx;
-					ext = COM_Parse (ext);
-					idx = atoi (com_token);
-					ext = COM_Parse (ext);
-					if (idx >= 1 && idx <= NUM_TOTAL_SPAWN_PARMS)
-						spawn_parms[idx - 1] = atof (com_token);
-				}
-				else if (!strcmp (com_token, "fog") && fastload)
-				{
-					float d, r, g, b;
-					ext = COM_Parse (ext);
-					d = atof (com_token);
-					ext = COM_Parse (ext);
-					r = atof (com_token);
-					ext = COM_Parse (ext);
-					g = atof (com_token);
-					ext = COM_Parse (ext);
-					b = atof (com_token);
-					Fog_Update (d, r, g, b, 0.0f);
-				}
-				else if (!strcmp (com_token, "sky") && fastload)
-				{
-					ext = COM_Parse (ext);
-					Sky_LoadSkyBox (com_token);
-				}
-				else if (!strcmp (com_token, "skyfog") && fastload)
-				{
-					ext = COM_Parse (ext);
-					Sky_SetSkyfog (atof (com_token));
-				}
-				*end = '\n';
-				ext = end + 1;
-			}
-		}
-
-		data = COM_Parse (data);
-		if (!com_token[0])
-			break; // end of file
-		if (strcmp (com_token, "{"))
-		{
-			Host_Error ("First token isn't a brace");
-		}
-
-		if (entnum == -1)
-		{ // parse the global vars
-			data = ED_ParseGlobals (data);
-		}
-		else
-		{ // parse an edict
-			ent = EDICT_NUM (entnum);
-			if (entnum < qcvm->num_edicts)
-			{
-				// Maintain the free-list conststency
-				if (ent->free)
-					ED_RemoveFromFreeList (ent);
-
-				ent->free = false;
-				memset (&ent->v, 0, qcvm->progs->entityfields * 4);
-			}
-			else
-			{
-				memset (ent, 0, qcvm->edict_size);
-				ent->baseline = nullentitystate;
-			}
-			data = ED_ParseEdict (data, ent);
-
-			// link it into the bsp tree
-			if (!ent->free)
-				SV_LinkEdict (ent, false);
-		}
-
-		entnum++;
-	}
+	if (version == SAVEGAME_VERSION_BINARY)
+		entnum = Host_LoadgameBinary (&loadgame_reader, spawn_parms, fastload);
+	else
+		entnum = Host_LoadgameText (data, spawn_parms, fastload);
 
 	qcvm->time = time;
 	for (i = entnum; i < qcvm->num_edicts; i++)
@@ -1684,6 +2489,7 @@ static void Host_Loadgame_f (void)
 		memset (cl_dlights, 0, sizeof (cl_dlights));
 		memset (cl_temp_entities, 0, sizeof (cl_temp_entities));
 		memset (cl_beams, 0, sizeof (cl_beams));
+		cl_num_beam_segments = 0;
 		V_ResetBlend ();
 		Fog_ResetFade ();
 		R_ClearParticles ();
@@ -1699,10 +2505,11 @@ static void Host_Loadgame_f (void)
 
 	qcvm->num_edicts = entnum;
 
-	ED_RebuildFreeList (true);
+	ED_RebuildFreeList ();
 
 	Mem_Free (start);
 	start = NULL;
+	SaveReader_Free (&loadgame_reader);
 
 	for (i = 0; i < NUM_TOTAL_SPAWN_PARMS; i++)
 		svs.clients->spawn_parms[i] = spawn_parms[i];
@@ -2058,6 +2865,8 @@ static void Host_PreSpawn_f (void)
 	// will start splurging out prespawn data
 	host_client->sendsignon = 2;
 	host_client->signonidx = 0;
+	host_client->signonblob = NULL;
+	host_client->signonblobofs = 0;
 }
 
 /*
@@ -216,6 +216,357 @@ byte *Image_LoadImage (const char *name, int *width, int *height, enum srcformat
 	return NULL;
 }
 
+/*
+============
+Image_LoadImageTask
+============
+*/
+static void Image_LoadImageTask (int i, image_load_t **images)
+{
+	image_load_t *image = &(*images)[i];
+	image->data = Image_LoadImage (image->name, &image->width, &image->height, &image->fmt, image->min_path_id);
+}
+
+/*
+============
+Image_LoadImages
+reads and decodes a batch of images on the task workers, the caller
+then consumes the results in order, e.g. to pass them to TexMgr_LoadImage.
+data is NULL for the images that weren't found.
+============
+*/
+void Image_LoadImages (int count, image_load_t *images)
+{
+	if (!Tasks_IsWorker () && (count > 1))
+	{
+		task_handle_t task = Task_AllocateAssignIndexedFuncAndSubmit ((task_indexed_func_t)Image_LoadImageTask, count, &images, sizeof (images));
+		Task_Join (task, TASK_TIMEOUT_INFINITE);
+	}
+	else
+	{
+		for (int i = 0; i < count; i++)
+			Image_LoadImageTask (i, &images);
+	}
+}
+
+//==============================================================================
+//
+//  DDS / KTX2
+//
+//==============================================================================
+
+#define DDS_HEADER_SIZE		  128 /* magic + DDS_HEADER */
+#define DDS_DX10_HEADER_SIZE  20
+#define DDSD_MIPMAPCOUNT	  0x20000
+#define DDPF_FOURCC			  0x4
+#define DDSCAPS2_CUBEMAP	  0x200
+#define DDSCAPS2_VOLUME		  0x200000
+#define KTX2_HEADER_SIZE	  80 /* identifier + header + index */
+#define KTX2_LEVEL_INDEX_SIZE 24
+
+#define FOURCC(a, b, c, d) ((uint32_t)(a) | ((uint32_t)(b) << 8) | ((uint32_t)(c) << 16) | ((uint32_t)(d) << 24))
+
+static const byte ktx2_identifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+static inline uint32_t Image_ReadU32 (const byte *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint64_t Image_ReadU64 (const byte *p)
+{
+	return (uint64_t)Image_ReadU32 (p) | ((uint64_t)Image_ReadU32 (p + 4) << 32);
+}
+
+/*
+============
+Image_DDSFormat -- maps a DXT fourcc or DXGI format to a Vulkan format
+============
+*/
+static VkFormat Image_DDSFormat (uint32_t fourcc, uint32_t dxgi_format)
+{
+	switch (fourcc)
+	{
+	case FOURCC ('D', 'X', 'T', '1'):
+		return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+	case FOURCC ('D', 'X', 'T', '2'):
+	case FOURCC ('D', 'X', 'T', '3'):
+		return VK_FORMAT_BC2_UNORM_BLOCK;
+	case FOURCC ('D', 'X', 'T', '4'):
+	case FOURCC ('D', 'X', 'T', '5'):
+		return VK_FORMAT_BC3_UNORM_BLOCK;
+	case FOURCC ('A', 'T', 'I', '1'):
+	case FOURCC ('B', 'C', '4', 'U'):
+		return VK_FORMAT_BC4_UNORM_BLOCK;
+	case FOURCC ('B', 'C', '4', 'S'):
+		return VK_FORMAT_BC4_SNORM_BLOCK;
+	case FOURCC ('A', 'T', 'I', '2'):
+	case FOURCC ('B', 'C', '5', 'U'):
+		return VK_FORMAT_BC5_UNORM_BLOCK;
+	case FOURCC ('B', 'C', '5', 'S'):
+		return VK_FORMAT_BC5_SNORM_BLOCK;
+	case FOURCC ('D', 'X', '1', '0'):
+		break;
+	default:
+		return VK_FORMAT_UNDEFINED;
+	}
+
+	// DXGI_FORMAT, sRGB variants are loaded as UNORM like every other texture
+	switch (dxgi_format)
+	{
+	case 71: // DXGI_FORMAT_BC1_UNORM
+	case 72: // DXGI_FORMAT_BC1_UNORM_SRGB
+		return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+	case 74: // DXGI_FORMAT_BC2_UNORM
+	case 75: // DXGI_FORMAT_BC2_UNORM_SRGB
+		return VK_FORMAT_BC2_UNORM_BLOCK;
+	case 77: // DXGI_FORMAT_BC3_UNORM
+	case 78: // DXGI_FORMAT_BC3_UNORM_SRGB
+		return VK_FORMAT_BC3_UNORM_BLOCK;
+	case 80: // DXGI_FORMAT_BC4_UNORM
+		return VK_FORMAT_BC4_UNORM_BLOCK;
+	case 81: // DXGI_FORMAT_BC4_SNORM
+		return VK_FORMAT_BC4_SNORM_BLOCK;
+	case 83: // DXGI_FORMAT_BC5_UNORM
+		return VK_FORMAT_BC5_UNORM_BLOCK;
+	case 84: // DXGI_FORMAT_BC5_SNORM
+		return VK_FORMAT_BC5_SNORM_BLOCK;
+	case 95: // DXGI_FORMAT_BC6H_UF16
+		return VK_FORMAT_BC6H_UFLOAT_BLOCK;
+	case 96: // DXGI_FORMAT_BC6H_SF16
+		return VK_FORMAT_BC6H_SFLOAT_BLOCK;
+	case 98: // DXGI_FORMAT_BC7_UNORM
+	case 99: // DXGI_FORMAT_BC7_UNORM_SRGB
+		return VK_FORMAT_BC7_UNORM_BLOCK;
+	default:
+		return VK_FORMAT_UNDEFINED;
+	}
+}
+
+/*
+============
+Image_CompressedBlockSize -- block dimensions and bytes of a supported format
+
+returns false if the format isn't block compressed or the device can't sample it
+============
+*/
+static qboolean Image_CompressedBlockSize (VkFormat *format, int *block_width, int *block_height, int *block_bytes)
+{
+	// clang-format off
+	static const byte astc_blocks[][2] = {
+		{4, 4}, {5, 4}, {5, 5}, {6, 5}, {6, 6}, {8, 5}, {8, 6}, {8, 8}, {10, 5}, {10, 6}, {10, 8}, {10, 10}, {12, 10}, {12, 12},
+	};
+	// clang-format on
+
+	if (*format >= VK_FORMAT_BC1_RGB_UNORM_BLOCK && *format <= VK_FORMAT_BC7_SRGB_BLOCK)
+	{
+		if (!vulkan_globals.texture_compression_bc)
+			return false;
+		switch (*format)
+		{
+		case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+		case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+		case VK_FORMAT_BC2_SRGB_BLOCK:
+		case VK_FORMAT_BC3_SRGB_BLOCK:
+		case VK_FORMAT_BC7_SRGB_BLOCK:
+			*format = (VkFormat)(*format - 1);
+			break;
+		default:
+			break;
+		}
+		const qboolean half_block = *format <= VK_FORMAT_BC1_RGBA_SRGB_BLOCK || *format == VK_FORMAT_BC4_UNORM_BLOCK || *format == VK_FORMAT_BC4_SNORM_BLOCK;
+		*block_width = 4;
+		*block_height = 4;
+		*block_bytes = half_block ? 8 : 16;
+		return true;
+	}
+	if (*format >= VK_FORMAT_ASTC_4x4_UNORM_BLOCK && *format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK)
+	{
+		if (!vulkan_globals.texture_compression_astc)
+			return false;
+		// UNORM and SRGB alternate, UNORM first
+		const int index = *format - VK_FORMAT_ASTC_4x4_UNORM_BLOCK;
+		*format = (VkFormat)(VK_FORMAT_ASTC_4x4_UNORM_BLOCK + (index & ~1));
+		*block_width = astc_blocks[index / 2][0];
+		*block_height = astc_blocks[index / 2][1];
+		*block_bytes = 16;
+		return true;
+	}
+	return false;
+}
+
+/*
+============
+Image_AllocCompressed -- sets up the mip table of a compressed image and allocates it
+============
+*/
+static compressed_image_t *Image_AllocCompressed (VkFormat format, int width, int height, int num_mips)
+{
+	int block_width, block_height, block_bytes;
+	if (width <= 0 || height <= 0 || num_mips <= 0 || !Image_CompressedBlockSize (&format, &block_width, &block_height, &block_bytes))
+		return NULL;
+
+	compressed_image_t header;
+	memset (&header, 0, sizeof (header));
+	header.format = format;
+	for (int i = 0; i < num_mips && i < MAX_COMPRESSED_MIPS; i++)
+	{
+		const int mip_width = q_max (width >> i, 1);
+		const int mip_height = q_max (height >> i, 1);
+		const uint64_t mip_size = (uint64_t)((mip_width + block_width - 1) / block_width) * ((mip_height + block_height - 1) / block_height) * block_bytes;
+		if (header.size + mip_size > INT_MAX)
+			return NULL;
+		header.mip_offsets[i] = header.size;
+		header.mip_sizes[i] = (uint32_t)mip_size;
+		header.size += (uint32_t)mip_size;
+		header.num_mips += 1;
+		if (mip_width == 1 && mip_height == 1)
+			break;
+	}
+
+	compressed_image_t *image = (compressed_image_t *)Mem_Alloc (sizeof (compressed_image_t) + header.size);
+	memcpy (image, &header, sizeof (header));
+	return image;
+}
+
+/*
+============
+Image_LoadDDS -- block compressed 2D textures only, mips are stored largest first
+============
+*/
+static byte *Image_LoadDDS (const byte *file, size_t file_size, int *width, int *height)
+{
+	if (file_size < DDS_HEADER_SIZE || Image_ReadU32 (file) != FOURCC ('D', 'D', 'S', ' ') || Image_ReadU32 (file + 4) != 124)
+		return NULL;
+
+	const uint32_t flags = Image_ReadU32 (file + 8);
+	const uint32_t pixel_format_flags = Image_ReadU32 (file + 80);
+	const uint32_t fourcc = Image_ReadU32 (file + 84);
+	const uint32_t caps2 = Image_ReadU32 (file + 112);
+	if (!(pixel_format_flags & DDPF_FOURCC) || (caps2 & (DDSCAPS2_CUBEMAP | DDSCAPS2_VOLUME)))
+		return NULL;
+
+	size_t	 data_offset = DDS_HEADER_SIZE;
+	uint32_t dxgi_format = 0;
+	if (fourcc == FOURCC ('D', 'X', '1', '0'))
+	{
+		if (file_size < DDS_HEADER_SIZE + DDS_DX10_HEADER_SIZE)
+			return NULL;
+		const byte *dx10 = file + DDS_HEADER_SIZE;
+		// D3D10_RESOURCE_DIMENSION_TEXTURE2D, no cube flag, single layer
+		if (Image_ReadU32 (dx10 + 4) != 3 || (Image_ReadU32 (dx10 + 8) & 0x4) || Image_ReadU32 (dx10 + 12) > 1)
+			return NULL;
+		dxgi_format = Image_ReadU32 (dx10);
+		data_offset += DDS_DX10_HEADER_SIZE;
+	}
+
+	const int num_mips = (flags & DDSD_MIPMAPCOUNT) ? q_max ((int)Image_ReadU32 (file + 28), 1) : 1;
+	*height = (int)Image_ReadU32 (file + 12);
+	*width = (int)Image_ReadU32 (file + 16);
+
+	compressed_image_t *image = Image_AllocCompressed (Image_DDSFormat (fourcc, dxgi_format), *width, *height, num_mips);
+	if (!image)
+		return NULL;
+	if (data_offset + image->size > file_size)
+	{
+		Mem_Free (image);
+		return NULL;
+	}
+	memcpy (image->data, file + data_offset, image->size);
+	return (byte *)image;
+}
+
+/*
+============
+Image_LoadKTX2 -- block compressed 2D textures without supercompression only
+============
+*/
+static byte *Image_LoadKTX2 (const byte *file, size_t file_size, int *width, int *height)
+{
+	if (file_size < KTX2_HEADER_SIZE || memcmp (file, ktx2_identifier, sizeof (ktx2_identifier)))
+		return NULL;
+
+	const VkFormat format = (VkFormat)Image_ReadU32 (file + 12);
+	*width = (int)Image_ReadU32 (file + 20);
+	*height = (int)Image_ReadU32 (file + 24);
+	const uint32_t depth = Image_ReadU32 (file + 28);
+	const uint32_t layers = Image_ReadU32 (file + 32);
+	const uint32_t faces = Image_ReadU32 (file + 36);
+	const uint32_t levels = Image_ReadU32 (file + 40);
+	const uint32_t supercompression = Image_ReadU32 (file + 44);
+	if (depth > 0 || layers > 1 || faces != 1 || supercompression != 0)
+		return NULL;
+	if (file_size < KTX2_HEADER_SIZE + (size_t)q_max (levels, 1) * KTX2_LEVEL_INDEX_SIZE)
+		return NULL;
+
+	compressed_image_t *image = Image_AllocCompressed (format, *width, *height, (int)q_max (levels, 1));
+	if (!image)
+		return NULL;
+	for (uint32_t i = 0; i < image->num_mips; i++)
+	{
+		const byte	  *level = file + KTX2_HEADER_SIZE + i * KTX2_LEVEL_INDEX_SIZE;
+		const uint64_t offset = Image_ReadU64 (level);
+		const uint64_t length = Image_ReadU64 (level + 8);
+		if (length != image->mip_sizes[i] || offset > file_size || length > file_size - offset)
+		{
+			Mem_Free (image);
+			return NULL;
+		}
+		memcpy (image->data + image->mip_offsets[i], file + offset, length);
+	}
+	return (byte *)image;
+}
+
+/*
+============
+Image_LoadCompressedImage
+like Image_LoadImage, but for pre-compressed textures that are uploaded
+without decoding. returns a Mem_Alloc allocated compressed_image_t with
+*fmt = SRC_COMPRESSED, or NULL if not found or if the device can't sample
+the format, in which case the caller should fall back to Image_LoadImage.
+Search order:  ktx2 dds
+============
+*/
+byte *Image_LoadCompressedImage (const char *name, int *width, int *height, enum srcformat *fmt, unsigned int min_path_id)
+{
+	static const char *const compressed_formats[] = {"ktx2", "dds", NULL};
+
+	if (!vulkan_globals.texture_compression_bc && !vulkan_globals.texture_compression_astc)
+		return NULL;
+
+	for (int i = 0; compressed_formats[i]; i++)
+	{
+		FILE		*f;
+		unsigned int opened_file_path_id = 0;
+		q_snprintf (loadfilename, sizeof (loadfilename), "%s.%s", name, compressed_formats[i]);
+		const int file_size = COM_FOpenFile (loadfilename, &f, &opened_file_path_id);
+		if (!f)
+			continue;
+		if (opened_file_path_id < min_path_id)
+		{
+			Con_DPrintf ("Image_LoadCompressedImage: ignored %s from a gamedir with lower priority\n", loadfilename);
+			fclose (f);
+			continue;
+		}
+
+		byte *file = (byte *)Mem_Alloc (q_max (file_size, 1));
+		byte *data = NULL;
+		if (fread (file, 1, file_size, f) == (size_t)file_size)
+			data = (i == 0) ? Image_LoadKTX2 (file, file_size, width, height) : Image_LoadDDS (file, file_size, width, height);
+		fclose (f);
+		Mem_Free (file);
+
+		if (data)
+		{
+			*fmt = SRC_COMPRESSED;
+			return data;
+		}
+		Con_DWarning ("couldn't load %s (unsupported or corrupt)\n", loadfilename);
+	}
+
+	return NULL;
+}
+
 //==============================================================================
 //
 //  TGA
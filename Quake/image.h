@@ -26,7 +26,33 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 // image.h -- image reading / writing
 enum srcformat;
 
+#define MAX_COMPRESSED_MIPS 16
+
+// SRC_COMPRESSED data: a block compressed mip chain, largest mip first
+typedef struct compressed_image_s
+{
+	VkFormat format;
+	uint32_t num_mips;
+	uint32_t mip_offsets[MAX_COMPRESSED_MIPS]; // relative to data
+	uint32_t mip_sizes[MAX_COMPRESSED_MIPS];
+	uint32_t size; // of data
+	byte	 data[];
+} compressed_image_t;
+
+// Image_LoadImages request, outputs are as returned by Image_LoadImage
+typedef struct image_load_s
+{
+	const char	  *name;
+	unsigned int   min_path_id;
+	byte		  *data;
+	int			   width;
+	int			   height;
+	enum srcformat fmt;
+} image_load_t;
+
 byte *Image_LoadImage (const char *name, int *width, int *height, enum srcformat *fmt, unsigned int min_path_id);
+void  Image_LoadImages (int count, image_load_t *images);
+byte *Image_LoadCompressedImage (const char *name, int *width, int *height, enum srcformat *fmt, unsigned int min_path_id);
 
 qboolean Image_WriteTGA (const char *name, byte *data, int width, int height, int bpp, qboolean upsidedown);
 qboolean Image_WritePNG (const char *name, byte *data, int width, int height, int bpp, qboolean upsidedown);
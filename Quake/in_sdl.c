@@ -620,6 +620,21 @@ void IN_MouseMove (usercmd_t *cmd)
 	}
 }
 
+/*
+================
+IN_SampleMouse
+
+Adds the mouse motion that arrived since the frame's events were processed,
+so a move command includes all input up to the moment it is sent
+================
+*/
+void IN_SampleMouse (usercmd_t *cmd)
+{
+	IN_PumpMouseMotion ();
+	if (total_dx || total_dy)
+		IN_MouseMove (cmd);
+}
+
 void IN_Move (usercmd_t *cmd)
 {
 	// We only want the latest joystick movements
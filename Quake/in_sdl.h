@@ -2,6 +2,7 @@ void IN_StartupJoystick (void);
 void IN_ShutdownJoystick (void);
 void IN_BeginIgnoringMouseEvents (void);
 void IN_EndIgnoringMouseEvents (void);
+void IN_PumpMouseMotion (void);
 
 #ifdef USE_SDL3
 extern SDL_Gamepad *joy_active_controller;
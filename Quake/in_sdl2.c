@@ -389,6 +389,52 @@ static int SDLCALL IN_SDL_FilterMouseEvents (void *userdata, SDL_Event *event)
 	return IN_FilterMouseEvents (event);
 }
 
+/*
+================
+IN_PumpMouseMotion
+
+Takes only the mouse motion out of the event queue, everything else is
+left for IN_SendKeyEvents
+================
+*/
+void IN_PumpMouseMotion (void)
+{
+	SDL_Event events[64];
+	int		  num_events;
+
+#ifdef USE_RMLUI
+	if (UI_WantsInput ())
+		return;
+#endif
+
+	SDL_PumpEvents ();
+	while ((num_events = SDL_PeepEvents (events, countof (events), SDL_GETEVENT, SDL_MOUSEMOTION, SDL_MOUSEMOTION)) > 0)
+	{
+		for (int i = 0; i < num_events; ++i)
+		{
+#ifdef USE_RMLUI
+			UI_MouseMove (events[i].motion.x, events[i].motion.y, events[i].motion.xrel, events[i].motion.yrel);
+#endif
+			IN_MouseMotion (events[i].motion.xrel, events[i].motion.yrel);
+		}
+	}
+}
+
+/*
+================
+IN_PumpWindowEvents
+
+Answers the window system while a map loads, so the window isn't reported
+as not responding. Mouse motion is dropped, it would only turn the view
+once the map is in.
+================
+*/
+void IN_PumpWindowEvents (void)
+{
+	SDL_PumpEvents ();
+	SDL_FlushEvent (SDL_MOUSEMOTION);
+}
+
 void IN_BeginIgnoringMouseEvents (void)
 {
 	SDL_EventFilter currentFilter = NULL;
@@ -37,12 +37,18 @@ void IN_MouseMotion (int dx, int dy);
 void IN_SendKeyEvents (void);
 // used as a callback for Sys_SendKeyEvents() by some drivers
 
+void IN_PumpWindowEvents (void);
+// keeps the window responsive while the main thread is busy, input stays queued for IN_SendKeyEvents
+
 void IN_UpdateInputMode (void);
 // do stuff if input mode (text/non-text) changes matter to the keyboard driver
 
 void IN_Move (usercmd_t *cmd);
 // add additional movement on top of the keyboard move cmd
 
+void IN_SampleMouse (usercmd_t *cmd);
+// add the mouse movement that arrived since the last IN_Move, right before a cmd is sent
+
 void IN_ClearStates (void);
 // restores all button and position states to defaults
 
@@ -112,19 +112,36 @@ int main (int argc, char *argv[])
 	oldtime = Sys_DoubleTime ();
 	if (isDedicated)
 	{
+		double deadline = oldtime;
 		while (1)
 		{
+			// tics are scheduled on absolute deadlines so sleep overshoot doesn't add up,
+			// a server that fell more than a tic behind starts over instead of catching up
+			deadline += sys_ticrate.value;
 			newtime = Sys_DoubleTime ();
-			time = newtime - oldtime;
-
-			while (time < sys_ticrate.value)
+			if (newtime > deadline + sys_ticrate.value)
+				deadline = newtime;
+			while (newtime < deadline)
 			{
-				SDL_Delay (1);
+				const double earliest = host_maxfps.value ? oldtime + 1.0 / CLAMP (10.0, host_maxfps.value, 1000.0) : oldtime;
+				if (sys_packetwake.value && newtime >= earliest)
+				{
+					if (NET_Sleep (deadline - newtime))
+					{
+						newtime = deadline = Sys_DoubleTime ();
+						break;
+					}
+				}
+				else
+				{
+					// sleep through most of the wait in one go, then finish in 1ms steps
+					const double until = sys_packetwake.value ? q_min (earliest, deadline) : deadline;
+					SDL_Delay (until - newtime > 0.002 ? (Uint32)((until - newtime - 0.001) * 1000.0) : 1);
+				}
 				newtime = Sys_DoubleTime ();
-				time = newtime - oldtime;
 			}
 
-			Host_Frame (time);
+			Host_Frame (newtime - oldtime);
 			oldtime = newtime;
 		}
 	}
@@ -62,6 +62,96 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 size_t THREAD_LOCAL thread_stack_alloc_size = 0;
 size_t				max_thread_stack_alloc_size = 0;
 
+// every block carries its size and tag so Mem_Free can account it, 16 bytes keep the alignment of the allocator
+typedef struct
+{
+	uint64_t size;
+	uint32_t tag;
+	uint32_t padding;
+} mem_header_t;
+
+COMPILE_TIME_ASSERT (mem_header_t, sizeof (mem_header_t) == 16);
+
+typedef struct
+{
+	atomic_uint64_t live;
+	atomic_uint64_t peak;
+	atomic_uint64_t allocs;
+	atomic_uint64_t allocated; // bytes, for the allocation rate
+} mem_tag_stats_t;
+
+static mem_tag_stats_t		 mem_tag_stats[MEM_NUM_TAGS];
+static THREAD_LOCAL mem_tag_t thread_mem_tag = MEM_TAG_MISC;
+
+#define FRAME_ARENA_BLOCK_SIZE (256 * 1024)
+#define FRAME_ARENA_ALIGNMENT  16
+#define NUM_FRAME_ARENAS	   (TASKS_MAX_WORKERS + 1) // main thread + task workers
+
+typedef struct frame_block_s
+{
+	struct frame_block_s *next;
+	size_t				  size;
+} frame_block_t;
+
+#define FRAME_BLOCK_HEADER_SIZE ((sizeof (frame_block_t) + FRAME_ARENA_ALIGNMENT - 1) & ~(size_t)(FRAME_ARENA_ALIGNMENT - 1))
+
+typedef struct
+{
+	frame_block_t *first;
+	frame_block_t *current;
+	size_t		   used; // bytes used in current
+	uint32_t	   epoch;
+} frame_arena_t;
+
+// two generations per thread so allocations of the previous frame survive one more frame
+static frame_arena_t   frame_arenas[NUM_FRAME_ARENAS][2];
+static atomic_uint32_t frame_epoch;
+
+/*
+====================
+Mem_InitAllocator
+
+Startup options of mimalloc, set before the engine allocates in earnest:
+-heapsize <kb>: reserves an arena of that size up front, later arenas grow by the same size
+-largepages: backs the arenas with 2/4 MiB OS pages, implies -eagercommit
+-eagercommit: commits arenas as a whole when they are reserved instead of page by page
+-purgedelay <ms>: how long freed memory is kept before it goes back to the OS, -1 keeps it
+====================
+*/
+static void Mem_InitAllocator (void)
+{
+#if defined(USE_MI_MALLOC)
+	const qboolean large_pages = COM_CheckParm ("-largepages") != 0;
+	const qboolean eager_commit = large_pages || COM_CheckParm ("-eagercommit") != 0;
+	int			   i;
+
+	if (large_pages)
+		mi_option_enable (mi_option_allow_large_os_pages);
+	if (eager_commit)
+	{
+		mi_option_enable (mi_option_eager_commit);
+		mi_option_set (mi_option_eager_commit_delay, 0);
+		mi_option_set (mi_option_arena_eager_commit, 1);
+	}
+
+	i = COM_CheckParm ("-purgedelay");
+	if (i && i < com_argc - 1)
+		mi_option_set (mi_option_purge_delay, atoi (com_argv[i + 1]));
+
+	i = COM_CheckParm ("-heapsize");
+	if (i && i < com_argc - 1)
+	{
+		const long heap_kb = atol (com_argv[i + 1]);
+		if (heap_kb > 0)
+		{
+			mi_option_set (mi_option_arena_reserve, heap_kb);
+			if (mi_reserve_os_memory ((size_t)heap_kb * 1024, eager_commit, large_pages) != 0)
+				Sys_Printf ("Couldn't reserve a %ld KiB heap\n", heap_kb);
+		}
+	}
+#endif
+}
+
 /*
 ====================
 Mem_Init
@@ -69,6 +159,8 @@ Mem_Init
 */
 void Mem_Init ()
 {
+	Mem_InitAllocator ();
+
 #ifdef _WIN32
 	max_thread_stack_alloc_size = MAX_STACK_ALLOC_SIZE;
 #else /* unix: */
@@ -85,20 +177,127 @@ void Mem_Init ()
 
 /*
 ====================
-Mem_Alloc : initialize memory to zero by default.
+Mem_RawAlloc / Mem_RawRealloc / Mem_RawFree
 ====================
 */
-void *Mem_Alloc (const size_t size)
+static inline void *Mem_RawAlloc (const size_t size, const qboolean zeroed)
+{
+#if defined(USE_MI_MALLOC)
+	return zeroed ? mi_calloc (1, size) : mi_malloc (size);
+#elif defined(USE_SDL_MALLOC)
+	return zeroed ? SDL_calloc (1, size) : SDL_malloc (size);
+#elif defined(USE_CRT_MALLOC)
+	return zeroed ? calloc (1, size) : malloc (size);
+#endif
+}
+
+static inline void *Mem_RawRealloc (void *ptr, const size_t size)
+{
+#if defined(USE_MI_MALLOC)
+	return mi_realloc (ptr, size);
+#elif defined(USE_SDL_MALLOC)
+	return SDL_realloc (ptr, size);
+#elif defined(USE_CRT_MALLOC)
+	return realloc (ptr, size);
+#endif
+}
+
+static inline void Mem_RawFree (void *ptr)
 {
 #if defined(USE_MI_MALLOC)
-	return mi_calloc (1, size);
+	mi_free (ptr);
 #elif defined(USE_SDL_MALLOC)
-	return SDL_calloc (1, size);
+	SDL_free (ptr);
 #elif defined(USE_CRT_MALLOC)
-	return calloc (1, size);
+	free (ptr);
 #endif
 }
 
+/*
+====================
+Mem_Account
+====================
+*/
+static void Mem_Account (const mem_tag_t tag, const int64_t delta)
+{
+	mem_tag_stats_t *stats = &mem_tag_stats[tag];
+	if (delta > 0)
+	{
+		const uint64_t live = Atomic_AddUInt64 (&stats->live, (uint64_t)delta) + (uint64_t)delta;
+		uint64_t	   peak = Atomic_LoadUInt64 (&stats->peak);
+		while (live > peak && !Atomic_CompareExchangeUInt64 (&stats->peak, &peak, live))
+			;
+		Atomic_IncrementUInt64 (&stats->allocs);
+		Atomic_AddUInt64 (&stats->allocated, (uint64_t)delta);
+	}
+	else if (delta < 0)
+		Atomic_SubUInt64 (&stats->live, (uint64_t)-delta);
+}
+
+/*
+====================
+Mem_AllocTagged : initialize memory to zero by default.
+====================
+*/
+void *Mem_AllocTagged (const size_t size, const mem_tag_t tag)
+{
+	mem_header_t *header = (mem_header_t *)Mem_RawAlloc (sizeof (mem_header_t) + size, true);
+	if (!header)
+		return NULL;
+	header->size = size;
+	header->tag = tag;
+	Mem_Account (tag, (int64_t)size);
+	return header + 1;
+}
+
+/*
+====================
+Mem_AllocNonZeroTagged
+====================
+*/
+void *Mem_AllocNonZeroTagged (const size_t size, const mem_tag_t tag)
+{
+	mem_header_t *header = (mem_header_t *)Mem_RawAlloc (sizeof (mem_header_t) + size, false);
+	if (!header)
+		return NULL;
+	header->size = size;
+	header->tag = tag;
+	Mem_Account (tag, (int64_t)size);
+	return header + 1;
+}
+
+/*
+====================
+Mem_ReallocTagged
+
+The tag only applies when ptr is NULL, a reallocated block keeps its own
+====================
+*/
+void *Mem_ReallocTagged (void *ptr, const size_t size, const mem_tag_t tag)
+{
+	if (!ptr)
+		return Mem_AllocNonZeroTagged (size, tag);
+
+	mem_header_t  *header = (mem_header_t *)ptr - 1;
+	const uint64_t old_size = header->size;
+	header = (mem_header_t *)Mem_RawRealloc (header, sizeof (mem_header_t) + size);
+	if (!header)
+		return NULL;
+	header->size = size;
+	Mem_Account ((mem_tag_t)header->tag, (int64_t)size - (int64_t)old_size);
+	return header + 1;
+}
+
+/*
+====================
+Mem_Alloc : initialize memory to zero by default.
+====================
+*/
+void *Mem_Alloc (const size_t size)
+{
+	return Mem_AllocTagged (size, thread_mem_tag);
+}
+
 /*
 ====================
 Mem_AllocNonZero
@@ -106,13 +305,7 @@ Mem_AllocNonZero
 */
 void *Mem_AllocNonZero (const size_t size)
 {
-#if defined(USE_MI_MALLOC)
-	return mi_malloc (size);
-#elif defined(USE_SDL_MALLOC)
-	return SDL_malloc (size);
-#elif defined(USE_CRT_MALLOC)
-	return malloc (size);
-#endif
+	return Mem_AllocNonZeroTagged (size, thread_mem_tag);
 }
 
 /*
@@ -122,13 +315,7 @@ Mem_Realloc
 */
 void *Mem_Realloc (void *ptr, const size_t size)
 {
-#if defined(USE_MI_MALLOC)
-	return mi_realloc (ptr, size);
-#elif defined(USE_SDL_MALLOC)
-	return SDL_realloc (ptr, size);
-#elif defined(USE_CRT_MALLOC)
-	return realloc (ptr, size);
-#endif
+	return Mem_ReallocTagged (ptr, size, thread_mem_tag);
 }
 
 /*
@@ -138,11 +325,200 @@ Mem_Free
 */
 void Mem_Free (const void *ptr)
 {
+	if (!ptr)
+		return;
+	mem_header_t *header = (mem_header_t *)ptr - 1;
+	Mem_Account ((mem_tag_t)header->tag, -(int64_t)header->size);
+	Mem_RawFree (header);
+}
+
+/*
+====================
+Mem_AccountPages
+
+Memory the caller maps itself still shows up in mem_stats
+====================
+*/
+void Mem_AccountPages (const mem_tag_t tag, const int64_t delta)
+{
+	Mem_Account (tag, delta);
+}
+
+/*
+====================
+Mem_SetThreadTag
+
+Attributes the untagged allocations of the calling thread, loaders set it around their work
+====================
+*/
+mem_tag_t Mem_SetThreadTag (const mem_tag_t tag)
+{
+	const mem_tag_t prev = thread_mem_tag;
+	thread_mem_tag = tag;
+	return prev;
+}
+
+#if defined(USE_MI_MALLOC)
+/*
+====================
+Mem_PrintMimallocStats
+====================
+*/
+static void Mem_PrintMimallocStats (const char *msg, void *arg)
+{
+	Con_SafePrintf ("%s", msg);
+}
+#endif
+
+/*
+====================
+Mem_Stats_f
+
+Live and peak bytes per tag, the allocation rate is measured since the previous call
+====================
+*/
+static void Mem_Stats_f (void)
+{
+	static const char *tag_names[MEM_NUM_TAGS] = {"misc", "model", "texture", "sound", "progs", "ui", "net", "temp"};
+	static uint64_t	   last_allocs[MEM_NUM_TAGS];
+	static uint64_t	   last_allocated[MEM_NUM_TAGS];
+	static double	   last_time;
+	const double	   now = Sys_DoubleTime ();
+	const double	   elapsed = last_time > 0.0 ? (now - last_time) : 0.0;
+	uint64_t		   total_live = 0;
+
+	if (Cmd_Argc () > 1 && !q_strcasecmp (Cmd_Argv (1), "mimalloc"))
+	{
 #if defined(USE_MI_MALLOC)
-	mi_free ((void *)ptr);
-#elif defined(USE_SDL_MALLOC)
-	SDL_free ((void *)ptr);
-#elif defined(USE_CRT_MALLOC)
-	free ((void *)ptr);
+		mi_stats_print_out (Mem_PrintMimallocStats, NULL);
+#else
+		Con_Printf ("mem_stats: not built with mimalloc\n");
 #endif
+		return;
+	}
+
+	Con_Printf ("tag          live KB    peak KB      allocs/s       KB/s\n");
+	for (int i = 0; i < MEM_NUM_TAGS; ++i)
+	{
+		mem_tag_stats_t *stats = &mem_tag_stats[i];
+		const uint64_t	 live = Atomic_LoadUInt64 (&stats->live);
+		const uint64_t	 allocs = Atomic_LoadUInt64 (&stats->allocs);
+		const uint64_t	 allocated = Atomic_LoadUInt64 (&stats->allocated);
+		const double	 alloc_rate = elapsed > 0.0 ? (allocs - last_allocs[i]) / elapsed : 0.0;
+		const double	 byte_rate = elapsed > 0.0 ? (allocated - last_allocated[i]) / elapsed : 0.0;
+		Con_Printf (
+			"%-8s %10.1f %10.1f %13.1f %10.1f\n", tag_names[i], live / 1024.0, Atomic_LoadUInt64 (&stats->peak) / 1024.0, alloc_rate, byte_rate / 1024.0);
+		last_allocs[i] = allocs;
+		last_allocated[i] = allocated;
+		total_live += live;
+	}
+	Con_Printf ("total    %10.1f KB live\n", total_live / 1024.0);
+	if (elapsed == 0.0)
+		Con_Printf ("run mem_stats again for allocation rates\n");
+	last_time = now;
+}
+
+/*
+====================
+Mem_InitCommands
+====================
+*/
+void Mem_InitCommands (void)
+{
+	Cmd_AddCommand ("mem_stats", Mem_Stats_f);
+}
+
+/*
+====================
+Mem_GetFrameArena
+
+Returns the calling thread's arena for the current frame, rewound if it was last used
+two frames ago. Only the owning thread ever touches an arena.
+====================
+*/
+static frame_arena_t *Mem_GetFrameArena (void)
+{
+	const uint32_t epoch = Atomic_LoadUInt32 (&frame_epoch);
+	const int	   slot = Tasks_IsWorker () ? (Tasks_GetWorkerIndex () + 1) : 0;
+	frame_arena_t *arena = &frame_arenas[slot][epoch & 1];
+	if (arena->epoch != epoch)
+	{
+		arena->epoch = epoch;
+		arena->current = arena->first;
+		arena->used = 0;
+	}
+	return arena;
+}
+
+/*
+====================
+Mem_FrameAlloc
+====================
+*/
+void *Mem_FrameAlloc (const size_t size)
+{
+	frame_arena_t *arena = Mem_GetFrameArena ();
+	const size_t   aligned_size = (size + FRAME_ARENA_ALIGNMENT - 1) & ~(size_t)(FRAME_ARENA_ALIGNMENT - 1);
+
+	if (!arena->current || (arena->used + aligned_size) > arena->current->size)
+	{
+		// reuse the following blocks kept from earlier frames before allocating a new one
+		frame_block_t **link = arena->current ? &arena->current->next : &arena->first;
+		while (*link && (*link)->size < aligned_size)
+			link = &(*link)->next;
+		if (!*link)
+		{
+			const size_t   block_size = q_max ((size_t)FRAME_ARENA_BLOCK_SIZE, aligned_size);
+			frame_block_t *block = (frame_block_t *)Mem_AllocNonZeroTagged (FRAME_BLOCK_HEADER_SIZE + block_size, MEM_TAG_TEMP);
+			block->next = NULL;
+			block->size = block_size;
+			*link = block;
+		}
+		arena->current = *link;
+		arena->used = 0;
+	}
+
+	void *ptr = (byte *)arena->current + FRAME_BLOCK_HEADER_SIZE + arena->used;
+	arena->used += aligned_size;
+	return ptr;
+}
+
+/*
+====================
+Mem_FrameMark
+====================
+*/
+mem_frame_mark_t Mem_FrameMark (void)
+{
+	frame_arena_t   *arena = Mem_GetFrameArena ();
+	mem_frame_mark_t mark = {arena->current, arena->used, arena->epoch};
+	return mark;
+}
+
+/*
+====================
+Mem_FrameRelease
+
+Rewinds the calling thread's arena to a mark taken earlier in the same frame
+====================
+*/
+void Mem_FrameRelease (const mem_frame_mark_t mark)
+{
+	frame_arena_t *arena = Mem_GetFrameArena ();
+	if (arena->epoch != mark.epoch)
+		return; // the frame ended in between, the arena was already rewound
+	arena->current = (frame_block_t *)mark.block;
+	arena->used = mark.used;
+}
+
+/*
+====================
+Mem_FrameReset
+
+Called by the main thread at the end of each host frame
+====================
+*/
+void Mem_FrameReset (void)
+{
+	Atomic_IncrementUInt32 (&frame_epoch);
 }
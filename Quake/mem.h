@@ -26,11 +26,51 @@
 // Mem_Alloc will always return zero initialized memory
 // A lot of old code was assuming this and overhead is negligible
 
-void  Mem_Init ();
-void *Mem_Alloc (const size_t size);
-void *Mem_AllocNonZero (const size_t size);
-void *Mem_Realloc (void *ptr, const size_t size);
-void  Mem_Free (const void *ptr);
+// Every allocation is accounted to a tag for mem_stats. The untagged functions use the
+// calling thread's current tag (MEM_TAG_MISC unless a loader set one with Mem_SetThreadTag),
+// the *Tagged variants name it explicitly. Mem_Realloc keeps the tag of the block.
+typedef enum
+{
+	MEM_TAG_MISC,
+	MEM_TAG_MODEL,
+	MEM_TAG_TEXTURE, // CPU side copies, the images themselves live in gl_heap
+	MEM_TAG_SOUND,
+	MEM_TAG_PROGS,
+	MEM_TAG_UI,
+	MEM_TAG_NET,
+	MEM_TAG_TEMP,
+	MEM_NUM_TAGS
+} mem_tag_t;
+
+void	  Mem_Init ();
+void	  Mem_InitCommands (void);
+void	 *Mem_Alloc (const size_t size);
+void	 *Mem_AllocNonZero (const size_t size);
+void	 *Mem_Realloc (void *ptr, const size_t size);
+void	  Mem_Free (const void *ptr);
+void	 *Mem_AllocTagged (const size_t size, const mem_tag_t tag);
+void	 *Mem_AllocNonZeroTagged (const size_t size, const mem_tag_t tag);
+void	 *Mem_ReallocTagged (void *ptr, const size_t size, const mem_tag_t tag);
+mem_tag_t Mem_SetThreadTag (const mem_tag_t tag); // returns the previous tag
+void	  Mem_AccountPages (const mem_tag_t tag, const int64_t delta); // for memory mapped with the Sys_Mem functions
+
+// Frame arena: linear allocations that need no free. Memory from Mem_FrameAlloc is NOT zeroed
+// and stays valid until the end of the host frame after the one it was allocated in, so render
+// tasks still running into the next frame can use it. The main thread and every task worker
+// allocate from their own sub-arena without locking. Mem_FrameMark/Mem_FrameRelease rewind
+// the calling thread's arena for scratch that dies within a function.
+
+typedef struct
+{
+	void	*block;
+	size_t	 used;
+	uint32_t epoch;
+} mem_frame_mark_t;
+
+void			*Mem_FrameAlloc (const size_t size);
+mem_frame_mark_t Mem_FrameMark (void);
+void			 Mem_FrameRelease (const mem_frame_mark_t mark);
+void			 Mem_FrameReset (void);
 
 // clang-format off
 
@@ -53,9 +93,9 @@ extern size_t			   max_thread_stack_alloc_size;
 		if ((thread_stack_alloc_size + temp_alloc_##var##_size) > max_thread_stack_alloc_size) \
 		{                                                                                      \
 			if (zeroed)                                                                        \
-				var = (type *)Mem_Alloc (temp_alloc_##var##_size);                             \
+				var = (type *)Mem_AllocTagged (temp_alloc_##var##_size, MEM_TAG_TEMP);         \
 			else                                                                               \
-				var = (type *)Mem_AllocNonZero (temp_alloc_##var##_size);                      \
+				var = (type *)Mem_AllocNonZeroTagged (temp_alloc_##var##_size, MEM_TAG_TEMP);  \
 			temp_alloc_##var##_on_heap = true;                                                 \
 		}                                                                                      \
 		else                                                                                   \
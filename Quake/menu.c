@@ -22,6 +22,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "quakedef.h"
 #include "bgmusic.h"
+#include <sys/stat.h>
 
 #ifdef USE_RMLUI
 #include "ui_manager.h"
@@ -850,65 +851,121 @@ int load_cursor; // 0 < load_cursor < MAX_SAVEGAMES
 char m_filenames[MAX_SAVEGAMES][SAVEGAME_COMMENT_LENGTH + 1];
 int	 loadable[MAX_SAVEGAMES];
 
-static void M_ScanSaves (void)
+typedef struct
+{
+	char	 path[MAX_OSPATH];
+	time_t	 mtime;
+	off_t	 size;
+	qboolean loadable;
+	char	 comment[SAVEGAME_COMMENT_LENGTH + 1];
+} savemeta_t;
+
+// save headers are only re-read when the path, mtime or size of the file changed
+static savemeta_t	 savemeta[2][MAX_SAVEGAMES]; // user pref path, gamedir
+static char			 savescan_dirs[2][MAX_OSPATH];
+static char			 savescan_filenames[MAX_SAVEGAMES][SAVEGAME_COMMENT_LENGTH + 1];
+static int			 savescan_loadable[MAX_SAVEGAMES];
+static task_handle_t savescan_task = INVALID_TASK_HANDLE;
+static qboolean		 savescan_again;
+
+static void M_ReadSaveComment (savemeta_t *meta)
 {
-	int	  i, j, k;
-	char  name[MAX_OSPATH];
 	FILE *f;
-	int	  version;
-	char *save_path = multiuser ? SDL_GetPrefPath ("vkQuake", COM_GetGameNames (true)) : NULL;
+	int	  version, k;
+	char  comment[80];
 
-	for (i = 0; i < MAX_SAVEGAMES; i++)
+	meta->loadable = false;
+	f = fopen (meta->path, "r");
+	if (!f)
+		return;
+	if (fscanf (f, "%i\n", &version) == 1 && fscanf (f, "%79s\n", comment) == 1)
 	{
-		strcpy (m_filenames[i], "--- UNUSED SLOT ---");
-		loadable[i] = false;
-		for (j = (multiuser ? 0 : 1); j < 2; ++j)
+		q_strlcpy (meta->comment, comment, sizeof (meta->comment));
+
+		// change _ back to space
+		for (k = 0; k < SAVEGAME_COMMENT_LENGTH; k++)
 		{
-			if (j == 0)
-				q_snprintf (name, sizeof (name), "%ss%i.sav", save_path, i);
-			else
-				q_snprintf (name, sizeof (name), "%s/s%i.sav", com_gamedir, i);
-			f = fopen (name, "r");
-			if (!f)
-				continue;
-			if (fscanf (f, "%i\n", &version) != 1)
-				continue;
-			if (fscanf (f, "%79s\n", name) != 1)
-				continue;
-			q_strlcpy (m_filenames[i], name, SAVEGAME_COMMENT_LENGTH + 1);
-
-			// change _ back to space
-			for (k = 0; k < SAVEGAME_COMMENT_LENGTH; k++)
-			{
-				if (m_filenames[i][k] == '_')
-					m_filenames[i][k] = ' ';
-			}
-			loadable[i] = true;
-			fclose (f);
-			break;
+			if (meta->comment[k] == '_')
+				meta->comment[k] = ' ';
 		}
+		meta->loadable = true;
 	}
+	fclose (f);
+}
+
+static void M_ScanSaveSlotTask (int i, void *unused)
+{
+	int			j;
+	char		name[MAX_OSPATH];
+	struct stat info;
+	savemeta_t *meta;
 
+	strcpy (savescan_filenames[i], "--- UNUSED SLOT ---");
+	savescan_loadable[i] = false;
+	for (j = (multiuser ? 0 : 1); j < 2; ++j)
+	{
+		meta = &savemeta[j][i];
+		q_snprintf (name, sizeof (name), "%ss%i.sav", savescan_dirs[j], i);
+		if (stat (name, &info) != 0)
+		{
+			meta->path[0] = 0;
+			continue;
+		}
+		if (strcmp (meta->path, name) || meta->mtime != info.st_mtime || meta->size != info.st_size)
+		{
+			q_strlcpy (meta->path, name, sizeof (meta->path));
+			meta->mtime = info.st_mtime;
+			meta->size = info.st_size;
+			M_ReadSaveComment (meta);
+		}
+		if (!meta->loadable)
+			continue;
+		q_strlcpy (savescan_filenames[i], meta->comment, SAVEGAME_COMMENT_LENGTH + 1);
+		savescan_loadable[i] = true;
+		break;
+	}
+}
+
+/*
+================
+M_ScanSaves
+
+Refreshes the save slots on the workers, the menus keep showing the
+previous results until M_PollScans picks up the new ones.
+================
+*/
+static void M_ScanSaves (void)
+{
+	char *save_path;
+
+	if (savescan_task != INVALID_TASK_HANDLE)
+	{
+		savescan_again = true;
+		return;
+	}
+
+	save_path = multiuser ? SDL_GetPrefPath ("vkQuake", COM_GetGameNames (true)) : NULL;
+	q_strlcpy (savescan_dirs[0], save_path ? save_path : "", sizeof (savescan_dirs[0]));
+	q_snprintf (savescan_dirs[1], sizeof (savescan_dirs[1]), "%s/", com_gamedir);
 	SDL_free (save_path);
+
+	savescan_task = Task_AllocateAssignBackgroundIndexedFuncAndSubmit (M_ScanSaveSlotTask, MAX_SAVEGAMES, NULL, 0);
 }
 
 #ifdef USE_RMLUI
 /*
 ================
-M_SyncSavesToUI
+M_PushSavesToUI
 
-Scans save files and pushes slot data to RmlUI.
-Called before opening load_game or save_game menus.
+Pushes the current slot data to RmlUI.
 ================
 */
-void M_SyncSavesToUI (void)
+static void M_PushSavesToUI (void)
 {
 	int			   i;
 	ui_save_slot_t slots[MAX_SAVEGAMES];
 	char		   ids[MAX_SAVEGAMES][4]; /* "s0".."s19" */
 
-	M_ScanSaves ();
-
 	for (i = 0; i < MAX_SAVEGAMES; i++)
 	{
 		q_snprintf (ids[i], sizeof (ids[i]), "s%d", i);
@@ -919,8 +976,47 @@ void M_SyncSavesToUI (void)
 	}
 	UI_SyncSaveSlots (slots, MAX_SAVEGAMES);
 }
+
+/*
+================
+M_SyncSavesToUI
+
+Pushes the cached slot data to RmlUI and starts a rescan, the menu is
+updated again once it completes.
+Called before opening load_game or save_game menus.
+================
+*/
+void M_SyncSavesToUI (void)
+{
+	M_PushSavesToUI ();
+	M_ScanSaves ();
+}
 #endif
 
+/*
+================
+M_PollSaveScan
+================
+*/
+static void M_PollSaveScan (void)
+{
+	if (savescan_task == INVALID_TASK_HANDLE || !Task_Join (savescan_task, 0))
+		return;
+	savescan_task = INVALID_TASK_HANDLE;
+
+	memcpy (m_filenames, savescan_filenames, sizeof (m_filenames));
+	memcpy (loadable, savescan_loadable, sizeof (loadable));
+#ifdef USE_RMLUI
+	M_PushSavesToUI ();
+#endif
+
+	if (savescan_again)
+	{
+		savescan_again = false;
+		M_ScanSaves ();
+	}
+}
+
 static void M_Menu_Load_f (void)
 {
 	M_MenuChanged ();
@@ -2628,6 +2724,15 @@ static int first_mod = 0;
 static int mods_cursor = 0;
 static int mod_loaded_from_menu = 0;
 
+static void M_CountMods (void)
+{
+	num_mods = 0;
+	for (filelist_item_t *item = modlist; item; item = item->next)
+		++num_mods;
+	mods_cursor = q_max (0, q_min (mods_cursor, num_mods - 1));
+	first_mod = q_max (0, q_min (first_mod, num_mods - MAX_MODS_ON_SCREEN));
+}
+
 static void M_Menu_Mods_f (void)
 {
 	M_MenuChanged ();
@@ -2635,11 +2740,10 @@ static void M_Menu_Mods_f (void)
 	key_dest = key_menu;
 	m_state = m_mods;
 	m_entersound = true;
-	num_mods = 0;
-	for (filelist_item_t *item = modlist; item; item = item->next)
-		++num_mods;
 	first_mod = 0;
 	mods_cursor = 0;
+	M_CountMods ();
+	Modlist_Refresh ();
 }
 
 static void M_Mods_Draw (cb_context_t *cbx)
@@ -3645,6 +3749,23 @@ void M_Init (void)
 	Cmd_AddCommand ("help", M_Menu_Help_f);
 	Cmd_AddCommand ("menu_quit", M_Menu_Quit_f);
 	Cmd_AddCommand ("menu_credits", M_Menu_Credits_f); // needed by the 2021 re-release
+
+	// read the save headers ahead of the first menu open
+	M_ScanSaves ();
+}
+
+/*
+================
+M_PollScans
+
+Picks up save slot and mod list rescans that finished on the workers
+================
+*/
+void M_PollScans (void)
+{
+	M_PollSaveScan ();
+	if (Modlist_PollRefresh ())
+		M_CountMods ();
 }
 
 void M_NewGame (void)
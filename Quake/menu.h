@@ -77,6 +77,7 @@ void M_RestoreDemoLoop (void);
 void M_Print (cb_context_t *cbx, int cx, int cy, const char *str);
 
 void M_Draw (cb_context_t *cbx);
+void M_PollScans (void);
 
 void M_DrawPic (cb_context_t *cbx, int x, int y, qpic_t *pic);
 void M_DrawTransPic (cb_context_t *cbx, int x, int y, qpic_t *pic);
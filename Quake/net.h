@@ -56,6 +56,9 @@ struct qsocket_s *NET_CheckNewConnections (void);
 struct qsocket_s *NET_Connect (const char *host);
 // called by client to connect to a host.  Returns -1 if not able to
 
+struct qsocket_s *NET_NewReplaySocket (qboolean local, int proquake_angle_hack);
+// a driverless connection that discards whatever the server sends, used by sv_replay
+
 double		NET_QSocketGetTime (const struct qsocket_s *sock);
 const char *NET_QSocketGetTrueAddressString (const struct qsocket_s *sock);
 const char *NET_QSocketGetMaskedAddressString (const struct qsocket_s *sock);
@@ -71,6 +74,11 @@ qboolean NET_CanSendMessage (struct qsocket_s *sock);
 struct qsocket_s *NET_GetServerMessage (void);
 // returns data in net_message, qsocket says which client its from
 
+double NET_PacketAge (void);
+// how long the message returned by NET_GetServerMessage waited after it arrived
+void NET_SetPacketAge (double age);
+// for a message parsed after more were read, what NET_PacketAge returned for it
+
 int NET_ListAddresses (qhostaddr_t *addresses, int maxaddresses);
 // gets a list of public addresses.
 
@@ -88,6 +96,15 @@ int NET_SendUnreliableMessage (struct qsocket_s *sock, sizebuf_t *data);
 // returns 1 if the message was sent properly
 // returns -1 if the connection died
 
+void NET_BeginSendBatch (void);
+void NET_EndSendBatch (void);
+// datagrams written between these calls may be queued by the lan drivers and
+// sent together, the messages are in flight after NET_EndSendBatch returns
+
+qboolean NET_Sleep (double timeout);
+// waits until a listening socket has a packet to read or the timeout expires,
+// returns true if it was woken up by a packet
+
 int NET_SendToAll (sizebuf_t *data, double blocktime);
 // This is a reliable *blocking* send to all attached clients.
 
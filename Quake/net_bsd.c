@@ -62,7 +62,10 @@ net_landriver_t net_landrivers[] = {
 	 UDP4_GetAddrFromName,
 	 UDP_AddrCompare,
 	 UDP_GetSocketPort,
-	 UDP_SetSocketPort},
+	 UDP_SetSocketPort,
+	 UDP_BeginSendBatch,
+	 UDP_EndSendBatch,
+	 UDP_PendingReads},
 	{"UDP6",
 	 false,
 	 0,
@@ -84,6 +87,9 @@ net_landriver_t net_landrivers[] = {
 	 UDP6_GetAddrFromName,
 	 UDP_AddrCompare,
 	 UDP_GetSocketPort,
-	 UDP_SetSocketPort}};
+	 UDP_SetSocketPort,
+	 UDP_BeginSendBatch,
+	 UDP_EndSendBatch,
+	 UDP_PendingReads}};
 
 const int net_numlandrivers = (sizeof (net_landrivers) / sizeof (net_landrivers[0]));
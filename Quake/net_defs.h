@@ -149,6 +149,7 @@ typedef struct qsocket_s
 	double			  lastSendTime;
 
 	qboolean isvirtual; // qsocket is emulated by the network layer (closing will not close any system sockets).
+	qboolean replay;	// sv_replay connection: no driver, outgoing messages are discarded.
 	qboolean disconnected;
 	qboolean canSend;
 	qboolean sendNext;
@@ -167,6 +168,7 @@ typedef struct qsocket_s
 	unsigned int receiveSequence;
 	unsigned int unreliableReceiveSequence;
 	int			 receiveMessageLength;
+	int			 receiveMessageOffset; // loopback only: start of the next unread message
 	byte		 receiveMessage[NET_MAXMESSAGE * NET_LOOPBACKBUFFERS + NET_LOOPBACKHEADERSIZE];
 
 	struct qsockaddr addr;
@@ -206,6 +208,9 @@ typedef struct
 	int (*AddrCompare) (struct qsockaddr *addr1, struct qsockaddr *addr2);
 	int (*GetSocketPort) (struct qsockaddr *addr);
 	int (*SetSocketPort) (struct qsockaddr *addr, int port);
+	void (*BeginSendBatch) (void);					  // optional, may be NULL
+	void (*EndSendBatch) (void);					  // optional, may be NULL
+	qboolean (*PendingReads) (sys_socket_t socketid); // optional, may be NULL
 
 	sys_socket_t listeningSock;
 } net_landriver_t;
@@ -251,6 +256,8 @@ qsocket_t *NET_NewQSocket (void);
 void	   NET_FreeQSocket (qsocket_t *);
 double	   SetNetTime (void);
 
+extern double net_packettime;
+
 #define HOSTCACHESIZE 128 // fixme: make dynamic.
 
 typedef struct
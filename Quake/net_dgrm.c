@@ -88,6 +88,139 @@ static char *StrAddr (struct qsockaddr *addr)
 	return buf;
 }
 
+/*
+the server's virtual qsockets share the listening socket, so incoming packets
+are matched to them by address. keep them in a hash map instead of walking
+net_activeSockets for every packet.
+*/
+typedef struct
+{
+	int			   landriver;
+	unsigned short family;
+	unsigned short port;
+	uint32_t	   scope_id;
+	byte		   addr[16];
+} addrkey_t;
+
+static hash_map_t *virtualsockets;
+
+/*
+=================
+Datagram_HashAddrKey
+=================
+*/
+static uint32_t Datagram_HashAddrKey (const void *const val)
+{
+	const uint32_t *words = (const uint32_t *)val;
+	uint32_t		hash = 0;
+	size_t			i;
+
+	for (i = 0; i < sizeof (addrkey_t) / sizeof (uint32_t); i++)
+		hash = HashCombine (words[i], hash);
+	return HashInt32 (&hash);
+}
+
+/*
+=================
+Datagram_MakeAddrKey
+
+Returns false for address families the map doesn't know, those are matched with AddrCompare.
+=================
+*/
+static qboolean Datagram_MakeAddrKey (int landriver, struct qsockaddr *addr, addrkey_t *key)
+{
+	memset (key, 0, sizeof (*key));
+	key->landriver = landriver;
+	key->family = addr->qsa_family;
+	if (addr->qsa_family == AF_INET)
+	{
+		key->port = ((struct sockaddr_in *)addr)->sin_port;
+		memcpy (key->addr, &((struct sockaddr_in *)addr)->sin_addr, sizeof (struct in_addr));
+		return true;
+	}
+#ifdef IPPROTO_IPV6
+	if (addr->qsa_family == AF_INET6)
+	{
+		key->port = ((struct sockaddr_in6 *)addr)->sin6_port;
+		key->scope_id = ((struct sockaddr_in6 *)addr)->sin6_scope_id;
+		memcpy (key->addr, &((struct sockaddr_in6 *)addr)->sin6_addr, sizeof (struct in6_addr));
+		return true;
+	}
+#endif
+	return false;
+}
+
+/*
+=================
+Datagram_LinkVirtualSocket
+
+The newest connection from an address wins, just like the list walk found it first.
+=================
+*/
+static void Datagram_LinkVirtualSocket (qsocket_t *sock)
+{
+	addrkey_t key;
+
+	if (!Datagram_MakeAddrKey (sock->landriver, &sock->addr, &key))
+		return;
+	if (!virtualsockets)
+		virtualsockets = HashMap_CreateOpen (addrkey_t, qsocket_t *, &Datagram_HashAddrKey, NULL);
+	HashMap_Insert (virtualsockets, &key, &sock);
+}
+
+/*
+=================
+Datagram_UnlinkVirtualSocket
+=================
+*/
+static void Datagram_UnlinkVirtualSocket (qsocket_t *sock)
+{
+	addrkey_t	key;
+	qsocket_t **found;
+
+	if (!virtualsockets || !Datagram_MakeAddrKey (sock->landriver, &sock->addr, &key))
+		return;
+	found = HashMap_Lookup (qsocket_t *, virtualsockets, &key);
+	if (found && *found == sock)
+		HashMap_Erase (virtualsockets, &key);
+}
+
+/*
+=================
+Datagram_FindVirtualSocket
+
+Returns the connected virtual qsocket of the current lan driver for this address, if any.
+=================
+*/
+static qsocket_t *Datagram_FindVirtualSocket (struct qsockaddr *addr)
+{
+	addrkey_t	key;
+	qsocket_t  *s;
+	qsocket_t **found;
+
+	if (Datagram_MakeAddrKey (net_landriverlevel, addr, &key))
+	{
+		found = virtualsockets ? HashMap_Lookup (qsocket_t *, virtualsockets, &key) : NULL;
+		s = found ? *found : NULL;
+		if (s && (s->driver != net_driverlevel || s->disconnected || !s->isvirtual))
+			s = NULL;
+		return s;
+	}
+
+	for (s = net_activeSockets; s; s = s->next)
+	{
+		if (s->driver != net_driverlevel)
+			continue;
+		if (s->disconnected)
+			continue;
+		if (!s->isvirtual)
+			continue;
+		if (dfunc.AddrCompare (addr, &s->addr) == 0)
+			return s;
+	}
+	return NULL;
+}
+
 #ifdef BAN_TEST
 
 static struct in_addr banAddr;
@@ -458,23 +591,12 @@ qsocket_t *Datagram_GetAnyMessage (void)
 			}
 
 			// figure out which qsocket it was for
-			for (s = net_activeSockets; s; s = s->next)
+			s = Datagram_FindVirtualSocket (&addr);
+			// okay, looks like this is us. try to process it, and if there's new data
+			if (s && Datagram_ProcessPacket (length, s))
 			{
-				if (s->driver != net_driverlevel)
-					continue;
-				if (s->disconnected)
-					continue;
-				if (!s->isvirtual)
-					continue;
-				if (dfunc.AddrCompare (&addr, &s->addr) == 0)
-				{
-					// okay, looks like this is us. try to process it, and if there's new data
-					if (Datagram_ProcessPacket (length, s))
-					{
-						s->lastMessageTime = net_time;
-						return s; // the server needs to parse that packet.
-					}
-				}
+				s->lastMessageTime = net_time;
+				return s; // the server needs to parse that packet.
 			}
 			// stray packet... ignore it and just try the next
 		}
@@ -1073,6 +1195,7 @@ void Datagram_Close (qsocket_t *sock)
 {
 	if (sock->isvirtual)
 	{
+		Datagram_UnlinkVirtualSocket (sock);
 		sock->isvirtual = false;
 		sock->socket = INVALID_SOCKET;
 	}
@@ -1106,6 +1229,11 @@ void Datagram_Listen (qboolean state)
 			}
 		}
 	}
+	if (virtualsockets)
+	{
+		HashMap_Destroy (virtualsockets);
+		virtualsockets = NULL;
+	}
 	if (state && !islistening)
 	{
 		if (isDedicated)
@@ -1142,7 +1270,6 @@ static void _Datagram_ServerControlPacket (sys_socket_t acceptsock, struct qsock
 	qsocket_t		*s;
 	int				 command;
 	int				 control;
-	int				 ret;
 	int				 plnum;
 	int				 mod; //, mod_ver, mod_flags, mod_passwd;	//proquake extensions
 
@@ -1456,61 +1583,54 @@ static void _Datagram_ServerControlPacket (sys_socket_t acceptsock, struct qsock
 #endif
 
 	// see if this guy is already connected
-	for (s = net_activeSockets; s; s = s->next)
+	s = Datagram_FindVirtualSocket (clientaddr);
+	if (s)
 	{
-		if (s->driver != net_driverlevel)
-			continue;
-		if (s->disconnected)
-			continue;
-		ret = dfunc.AddrCompare (clientaddr, &s->addr);
-		if (ret == 0)
-		{
-			int i;
+		int i;
 
-			// is this a duplicate connection reqeust?
-			if (ret == 0 && net_time - s->connecttime < 2.0)
+		// is this a duplicate connection reqeust?
+		if (net_time - s->connecttime < 2.0)
+		{
+			// yes, so send a duplicate reply
+			SZ_Clear (&net_message);
+			// save space for the header, filled in later
+			MSG_WriteLong (&net_message, 0);
+			MSG_WriteByte (&net_message, CCREP_ACCEPT);
+			dfunc.GetSocketAddr (s->socket, &newaddr);
+			MSG_WriteLong (&net_message, dfunc.GetSocketPort (&newaddr));
+			if (s->proquake_angle_hack)
 			{
-				// yes, so send a duplicate reply
-				SZ_Clear (&net_message);
-				// save space for the header, filled in later
-				MSG_WriteLong (&net_message, 0);
-				MSG_WriteByte (&net_message, CCREP_ACCEPT);
-				dfunc.GetSocketAddr (s->socket, &newaddr);
-				MSG_WriteLong (&net_message, dfunc.GetSocketPort (&newaddr));
-				if (s->proquake_angle_hack)
-				{
-					MSG_WriteByte (&net_message, 1);  // proquake
-					MSG_WriteByte (&net_message, 30); // ver 30 should be safe. 34 screws with our single-server-socket stuff.
-					MSG_WriteByte (&net_message, 0);  // no flags
-				}
-				*((int *)net_message.data) = BigLong (NETFLAG_CTL | (net_message.cursize & NETFLAG_LENGTH_MASK));
-				dfunc.Write (acceptsock, net_message.data, net_message.cursize, clientaddr);
-				SZ_Clear (&net_message);
-				return;
+				MSG_WriteByte (&net_message, 1);  // proquake
+				MSG_WriteByte (&net_message, 30); // ver 30 should be safe. 34 screws with our single-server-socket stuff.
+				MSG_WriteByte (&net_message, 0);  // no flags
 			}
-			// it's somebody coming back in from a crash/disconnect
-			// so close the old qsocket and let their retry get them back in
-			//			NET_Close(s);
-			//			return;
-
-			// FIXME: ideally we would just switch the connection over and restart it with a serverinfo packet.
-			// warning: there might be packets in-flight which might mess up unreliable sequences.
-			// so we attempt to ignore the request, and let the user restart.
-			// FIXME: if this is an issue, it should be possible to reuse the previous connection's outgoing unreliable sequence. reliables should be less of an
-			// issue as stray ones will be ignored anyway.
-			// FIXME: needs challenges, so that other clients can't determine ip's and spoof a reconnect.
-			for (i = 0; i < svs.maxclients; i++)
+			*((int *)net_message.data) = BigLong (NETFLAG_CTL | (net_message.cursize & NETFLAG_LENGTH_MASK));
+			dfunc.Write (acceptsock, net_message.data, net_message.cursize, clientaddr);
+			SZ_Clear (&net_message);
+			return;
+		}
+		// it's somebody coming back in from a crash/disconnect
+		// so close the old qsocket and let their retry get them back in
+		//			NET_Close(s);
+		//			return;
+
+		// FIXME: ideally we would just switch the connection over and restart it with a serverinfo packet.
+		// warning: there might be packets in-flight which might mess up unreliable sequences.
+		// so we attempt to ignore the request, and let the user restart.
+		// FIXME: if this is an issue, it should be possible to reuse the previous connection's outgoing unreliable sequence. reliables should be less of an
+		// issue as stray ones will be ignored anyway.
+		// FIXME: needs challenges, so that other clients can't determine ip's and spoof a reconnect.
+		for (i = 0; i < svs.maxclients; i++)
+		{
+			if (svs.clients[i].netconnection == s)
 			{
-				if (svs.clients[i].netconnection == s)
-				{
-					NET_Close (s); // close early, to avoid svc_disconnects confusing things.
-					host_client = &svs.clients[i];
-					SV_DropClient (false);
-					break;
-				}
+				NET_Close (s); // close early, to avoid svc_disconnects confusing things.
+				host_client = &svs.clients[i];
+				SV_DropClient (false);
+				break;
 			}
-			return;
 		}
+		return;
 	}
 
 	// find a free player slot
@@ -1542,6 +1662,7 @@ static void _Datagram_ServerControlPacket (sys_socket_t acceptsock, struct qsock
 	sock->socket = acceptsock;
 	sock->landriver = net_landriverlevel;
 	sock->addr = *clientaddr;
+	Datagram_LinkVirtualSocket (sock);
 	strcpy (sock->trueaddress, dfunc.AddrToString (clientaddr, false));
 	strcpy (sock->maskedaddress, dfunc.AddrToString (clientaddr, true));
 
@@ -1654,7 +1775,7 @@ static void _Datagram_AddPossibleHost (struct qsockaddr *addr, qboolean master)
 	if (hostlist_count == hostlist_max)
 	{
 		hostlist_max = hostlist_count + 16;
-		hostlist = Mem_Realloc (hostlist, sizeof (*hostlist) * hostlist_max);
+		hostlist = Mem_ReallocTagged (hostlist, sizeof (*hostlist) * hostlist_max, MEM_TAG_NET);
 	}
 	hostlist[hostlist_count].addr = *addr;
 	hostlist[hostlist_count].requery = true;
@@ -77,6 +77,7 @@ qsocket_t *Loop_Connect (const char *host)
 		strcpy (loop_client->maskedaddress, "localhost");
 	}
 	loop_client->receiveMessageLength = 0;
+	loop_client->receiveMessageOffset = 0;
 	loop_client->sendMessageLength = 0;
 	loop_client->canSend = true;
 
@@ -91,6 +92,7 @@ qsocket_t *Loop_Connect (const char *host)
 		strcpy (loop_server->maskedaddress, "LOCAL");
 	}
 	loop_server->receiveMessageLength = 0;
+	loop_server->receiveMessageOffset = 0;
 	loop_server->sendMessageLength = 0;
 	loop_server->canSend = true;
 
@@ -110,9 +112,11 @@ qsocket_t *Loop_CheckNewConnections (void)
 	localconnectpending = false;
 	loop_server->sendMessageLength = 0;
 	loop_server->receiveMessageLength = 0;
+	loop_server->receiveMessageOffset = 0;
 	loop_server->canSend = true;
 	loop_client->sendMessageLength = 0;
 	loop_client->receiveMessageLength = 0;
+	loop_client->receiveMessageOffset = 0;
 	loop_client->canSend = true;
 	return loop_server;
 }
@@ -122,36 +126,46 @@ static int IntAlign (int value)
 	return (value + (sizeof (int) - 1)) & (~(sizeof (int) - 1));
 }
 
+// reads only advance receiveMessageOffset, the unread messages are moved back to the start when a sender runs out of room
+static void Loop_CompactMessages (qsocket_t *sock)
+{
+	if (sock->receiveMessageOffset == 0)
+		return;
+	sock->receiveMessageLength -= sock->receiveMessageOffset;
+	memmove (sock->receiveMessage, &sock->receiveMessage[sock->receiveMessageOffset], sock->receiveMessageLength);
+	sock->receiveMessageOffset = 0;
+}
+
 int Loop_GetMessage (qsocket_t *sock)
 {
-	int ret;
-	int length;
+	int	  ret;
+	int	  length;
+	byte *message;
 
 	if (sock->receiveMessageLength == 0)
 		return 0;
 
-	ret = sock->receiveMessage[0];
-	length = sock->receiveMessage[1] + (sock->receiveMessage[2] << 8);
+	message = &sock->receiveMessage[sock->receiveMessageOffset];
+	ret = message[0];
+	length = message[1] + (message[2] << 8);
 	// alignment byte skipped here
 	SZ_Clear (&net_message);
 	if (ret == 2)
 	{ // unreliables have sequences that we (now) care about so that clients can ack them.
-		sock->unreliableReceiveSequence =
-			sock->receiveMessage[4] | (sock->receiveMessage[5] << 8) | (sock->receiveMessage[6] << 16) | (sock->receiveMessage[7] << 24);
+		sock->unreliableReceiveSequence = message[4] | (message[5] << 8) | (message[6] << 16) | (message[7] << 24);
 		sock->unreliableReceiveSequence++;
-		SZ_Write (&net_message, &sock->receiveMessage[8], length);
+		SZ_Write (&net_message, &message[8], length);
 		length = IntAlign (length + 8);
 	}
 	else
 	{ // reliable
-		SZ_Write (&net_message, &sock->receiveMessage[4], length);
+		SZ_Write (&net_message, &message[4], length);
 		length = IntAlign (length + 4);
 	}
 
-	sock->receiveMessageLength -= length;
-
-	if (sock->receiveMessageLength)
-		memmove (sock->receiveMessage, &sock->receiveMessage[length], sock->receiveMessageLength);
+	sock->receiveMessageOffset += length;
+	if (sock->receiveMessageOffset == sock->receiveMessageLength)
+		sock->receiveMessageLength = sock->receiveMessageOffset = 0;
 
 	if (sock->driverdata && ret == 1)
 		((qsocket_t *)sock->driverdata)->canSend = true;
@@ -179,6 +193,8 @@ int Loop_SendMessage (qsocket_t *sock, sizebuf_t *data)
 
 	bufferLength = &((qsocket_t *)sock->driverdata)->receiveMessageLength;
 
+	if ((*bufferLength + data->cursize + NET_LOOPBACKHEADERSIZE) > NET_MAXMESSAGE * NET_LOOPBACKBUFFERS + NET_LOOPBACKHEADERSIZE)
+		Loop_CompactMessages ((qsocket_t *)sock->driverdata);
 	if ((*bufferLength + data->cursize + NET_LOOPBACKHEADERSIZE) > NET_MAXMESSAGE * NET_LOOPBACKBUFFERS + NET_LOOPBACKHEADERSIZE)
 		Sys_Error ("Loop_SendMessage: overflow");
 
@@ -214,6 +230,8 @@ int Loop_SendUnreliableMessage (qsocket_t *sock, sizebuf_t *data)
 	bufferLength = &((qsocket_t *)sock->driverdata)->receiveMessageLength;
 
 	// always leave one buffer for reliable messages
+	if ((*bufferLength + data->cursize + NET_LOOPBACKHEADERSIZE) > NET_MAXMESSAGE * (NET_LOOPBACKBUFFERS - 1))
+		Loop_CompactMessages ((qsocket_t *)sock->driverdata);
 	if ((*bufferLength + data->cursize + NET_LOOPBACKHEADERSIZE) > NET_MAXMESSAGE * (NET_LOOPBACKBUFFERS - 1))
 		return 0;
 
@@ -257,6 +275,7 @@ void Loop_Close (qsocket_t *sock)
 	if (sock->driverdata)
 		((qsocket_t *)sock->driverdata)->driverdata = NULL;
 	sock->receiveMessageLength = 0;
+	sock->receiveMessageOffset = 0;
 	sock->sendMessageLength = 0;
 	sock->canSend = true;
 	if (sock == loop_client)
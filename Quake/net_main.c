@@ -65,6 +65,7 @@ int unreliableMessagesReceived = 0;
 cvar_t net_messagetimeout = {"net_messagetimeout", "300", CVAR_NONE};
 cvar_t net_connecttimeout = {"net_connecttimeout", "10", CVAR_NONE}; // this might be a little brief, but we don't have a way to protect against smurf attacks.
 cvar_t hostname = {"hostname", "UNNAMED", CVAR_SERVERINFO};
+cvar_t net_iothread = {"net_iothread", "0", CVAR_ARCHIVE}; // read the accept and client sockets on a dedicated thread, if the lan driver can
 
 // these two macros are to make the code more readable
 #define sfunc net_drivers[sock->driver]
@@ -73,6 +74,7 @@ cvar_t hostname = {"hostname", "UNNAMED", CVAR_SERVERINFO};
 int net_driverlevel;
 
 double net_time;
+double net_packettime; // arrival time of the last packet read, in net_time units
 
 double SetNetTime (void)
 {
@@ -107,6 +109,7 @@ qsocket_t *NET_NewQSocket (void)
 	net_activeSockets = sock;
 
 	sock->isvirtual = false;
+	sock->replay = false;
 	sock->disconnected = false;
 	sock->connecttime = net_time;
 	strcpy (sock->trueaddress, "UNSET ADDRESS");
@@ -158,6 +161,32 @@ void NET_FreeQSocket (qsocket_t *sock)
 	sock->disconnected = true;
 }
 
+/*
+===================
+NET_NewReplaySocket
+
+A connection without a driver for sv_replay. The server's messages to it are counted and
+dropped, the client's messages are handed to the server by the replay itself.
+===================
+*/
+qsocket_t *NET_NewReplaySocket (qboolean local, int proquake_angle_hack)
+{
+	qsocket_t *sock = NET_NewQSocket ();
+
+	if (!sock)
+		return NULL;
+
+	sock->isvirtual = true;
+	sock->replay = true;
+	sock->driver = 0;
+	sock->max_datagram = NET_MAXMESSAGE;
+	sock->pending_max_datagram = NET_MAXMESSAGE;
+	sock->proquake_angle_hack = proquake_angle_hack;
+	q_strlcpy (sock->trueaddress, local ? "LOCAL" : "replay", sizeof (sock->trueaddress));
+	q_strlcpy (sock->maskedaddress, local ? "LOCAL" : "replay", sizeof (sock->maskedaddress));
+	return sock;
+}
+
 int NET_QSocketGetSequenceIn (const qsocket_t *s)
 { // returns the last unreliable sequence that was received
 	return s->unreliableReceiveSequence - 1;
@@ -546,7 +575,8 @@ void NET_Close (qsocket_t *sock)
 	SetNetTime ();
 
 	// call the driver_Close function
-	sfunc.Close (sock);
+	if (!sock->replay)
+		sfunc.Close (sock);
 
 	NET_FreeQSocket (sock);
 }
@@ -577,6 +607,9 @@ int NET_GetMessage (qsocket_t *sock)
 
 	SetNetTime ();
 
+	if (sock->replay)
+		return 0;
+
 	ret = sfunc.QGetMessage (sock);
 
 	// see if this connection has timed out
@@ -616,6 +649,9 @@ returns the qsocket that the message was meant to be for.
 qsocket_t *NET_GetServerMessage (void)
 {
 	qsocket_t *s;
+
+	SetNetTime ();
+	net_packettime = net_time;
 	for (net_driverlevel = 0; net_driverlevel < net_numdrivers; net_driverlevel++)
 	{
 		if (!net_drivers[net_driverlevel].initialized)
@@ -627,6 +663,32 @@ qsocket_t *NET_GetServerMessage (void)
 	return NULL;
 }
 
+/*
+=================
+NET_PacketAge
+
+Seconds the last message returned by NET_GetServerMessage waited between its arrival and now.
+Only non zero when the packets are timestamped by a network io thread.
+=================
+*/
+double NET_PacketAge (void)
+{
+	return q_max (net_time - net_packettime, 0.0);
+}
+
+/*
+=================
+NET_SetPacketAge
+
+Makes NET_PacketAge return the age a message had when it was read, the server
+parses them after draining the network with sv_batchmessages
+=================
+*/
+void NET_SetPacketAge (double age)
+{
+	net_packettime = net_time - age;
+}
+
 /*
 Spike: This function is for the menus+status command
 Just queries each driver's public addresses (which often requires system-specific calls)
@@ -669,6 +731,11 @@ int NET_SendMessage (qsocket_t *sock, sizebuf_t *data)
 	}
 
 	SetNetTime ();
+	if (sock->replay)
+	{
+		sock->sendSequence++;
+		return 1;
+	}
 	r = sfunc.QSendMessage (sock, data);
 	if (r == 1 && !IS_LOOP_DRIVER (sock->driver))
 		messagesSent++;
@@ -690,6 +757,11 @@ int NET_SendUnreliableMessage (qsocket_t *sock, sizebuf_t *data)
 	}
 
 	SetNetTime ();
+	if (sock->replay)
+	{
+		sock->unreliableSendSequence++;
+		return 1;
+	}
 	r = sfunc.SendUnreliableMessage (sock, data);
 	if (r == 1 && !IS_LOOP_DRIVER (sock->driver))
 		unreliableMessagesSent++;
@@ -715,9 +787,81 @@ qboolean NET_CanSendMessage (qsocket_t *sock)
 
 	SetNetTime ();
 
+	if (sock->replay)
+		return true;
+
 	return sfunc.CanSendMessage (sock);
 }
 
+/*
+==================
+NET_BeginSendBatch
+
+Lets the lan drivers queue outgoing datagrams until NET_EndSendBatch,
+so they can be handed to the OS with as few syscalls as possible.
+==================
+*/
+void NET_BeginSendBatch (void)
+{
+	int i;
+
+	for (i = 0; i < net_numlandrivers; i++)
+		if (net_landrivers[i].initialized && net_landrivers[i].BeginSendBatch)
+			net_landrivers[i].BeginSendBatch ();
+}
+
+/*
+==================
+NET_EndSendBatch
+
+Sends everything queued since NET_BeginSendBatch.
+==================
+*/
+void NET_EndSendBatch (void)
+{
+	int i;
+
+	for (i = 0; i < net_numlandrivers; i++)
+		if (net_landrivers[i].initialized && net_landrivers[i].EndSendBatch)
+			net_landrivers[i].EndSendBatch ();
+}
+
+/*
+==================
+NET_Sleep
+==================
+*/
+qboolean NET_Sleep (double timeout)
+{
+	fd_set		   readfds;
+	struct timeval tv;
+	sys_socket_t   maxsock = 0;
+	qboolean	   any = false;
+	int			   i;
+
+	FD_ZERO (&readfds);
+	for (i = 0; i < net_numlandrivers; i++)
+	{
+		sys_socket_t sock = net_landrivers[i].listeningSock;
+		if (!net_landrivers[i].initialized || sock == INVALID_SOCKET)
+			continue;
+		if (net_landrivers[i].PendingReads && net_landrivers[i].PendingReads (sock))
+			return true;
+		FD_SET (sock, &readfds);
+		maxsock = q_max (maxsock, sock);
+		any = true;
+	}
+
+	if (!any)
+	{
+		SDL_Delay ((Uint32)(timeout * 1000.0));
+		return false;
+	}
+	tv.tv_sec = (long)timeout;
+	tv.tv_usec = (long)((timeout - tv.tv_sec) * 1000000.0);
+	return selectsocket ((int)maxsock + 1, &readfds, NULL, NULL, &tv) > 0;
+}
+
 int NET_SendToAll (sizebuf_t *data, double blocktime)
 {
 	double	 start;
@@ -832,7 +976,7 @@ void NET_Init (void)
 
 	for (i = 0; i < net_numsockets; i++)
 	{
-		s = (qsocket_t *)Mem_Alloc (sizeof (qsocket_t));
+		s = (qsocket_t *)Mem_AllocTagged (sizeof (qsocket_t), MEM_TAG_NET);
 		s->next = net_freeSockets;
 		net_freeSockets = s;
 		s->disconnected = true;
@@ -844,6 +988,7 @@ void NET_Init (void)
 	Cvar_RegisterVariable (&net_messagetimeout);
 	Cvar_RegisterVariable (&net_connecttimeout);
 	Cvar_RegisterVariable (&hostname);
+	Cvar_RegisterVariable (&net_iothread);
 
 	Cmd_AddCommand ("slist", NET_Slist_f);
 	Cmd_AddCommand ("listen", NET_Listen_f);
@@ -40,6 +40,246 @@ static struct in6_addr myAddrv6;
 
 #include "net_udp.h"
 
+// recvmmsg/sendmmsg are only declared by glibc with _GNU_SOURCE
+#if defined(__linux__) && defined(_GNU_SOURCE)
+#define UDP_BATCHED_IO
+#define UDP_RECV_BATCH	16
+#define UDP_RECV_RINGS	4
+#define UDP_SEND_BATCH	64
+
+typedef struct
+{
+	sys_socket_t	 socket;
+	int				 head;
+	int				 count;
+	byte			*data;
+	struct mmsghdr	 msgs[UDP_RECV_BATCH];
+	struct iovec	 iovs[UDP_RECV_BATCH];
+	struct qsockaddr addrs[UDP_RECV_BATCH];
+} udprecvring_t;
+
+typedef struct
+{
+	struct qsockaddr addr;
+	socklen_t		 addrsize;
+	int				 offset;
+	int				 len;
+} udpsend_t;
+
+static udprecvring_t udp_recvrings[UDP_RECV_RINGS];
+
+static qboolean		udp_sendbatch;
+static sys_socket_t udp_sendsocket = INVALID_SOCKET;
+static udpsend_t	udp_sends[UDP_SEND_BATCH];
+static int			udp_numsends;
+static byte		   *udp_senddata;
+static int			udp_senddatasize;
+static int			udp_maxsenddatasize;
+
+static void UDP_FlushSends (void);
+
+/*
+the optional io thread blocks on an accept socket and timestamps the packets on arrival,
+so the host frame only has to pop them from a single producer single consumer queue
+*/
+#include <poll.h>
+#include "atomics.h"
+
+#define UDP_IOQUEUE_SIZE 64	// must be a power of two
+#define UDP_IOTHREADS	 4	// both accept sockets plus a client connection
+
+typedef struct
+{
+	double			 time;
+	int				 len;
+	struct qsockaddr addr;
+	byte			*data;
+} udppacket_t;
+
+typedef struct
+{
+	sys_socket_t	socket;
+	SDL_Thread	   *thread;
+	atomic_uint32_t quit;
+	atomic_uint32_t error;
+	atomic_uint32_t head; // only written by the io thread
+	atomic_uint32_t tail; // only written by the main thread
+	byte		   *data;
+	udppacket_t		packets[UDP_IOQUEUE_SIZE];
+} udpiothread_t;
+
+static udpiothread_t *udp_iothreads[UDP_IOTHREADS];
+#endif
+
+extern cvar_t net_iothread;
+
+//=============================================================================
+
+#ifdef UDP_BATCHED_IO
+/*
+====================
+UDP_FindIOThread
+====================
+*/
+static udpiothread_t *UDP_FindIOThread (sys_socket_t socketid)
+{
+	int i;
+
+	for (i = 0; i < UDP_IOTHREADS; i++)
+		if (udp_iothreads[i] && udp_iothreads[i]->socket == socketid)
+			return udp_iothreads[i];
+	return NULL;
+}
+
+/*
+====================
+UDP_IOThread
+====================
+*/
+static int UDP_IOThread (void *data)
+{
+	udpiothread_t *io = (udpiothread_t *)data;
+	struct mmsghdr msgs[UDP_RECV_BATCH];
+	struct iovec   iovs[UDP_RECV_BATCH];
+	struct pollfd  pfd;
+	uint32_t	   head, tail;
+	int			   i, count, ret;
+	double		   time;
+
+	pfd.fd = io->socket;
+	pfd.events = POLLIN;
+	while (!Atomic_LoadUInt32 (&io->quit))
+	{
+		head = Atomic_LoadUInt32 (&io->head);
+		tail = Atomic_LoadUInt32 (&io->tail);
+		count = q_min (UDP_IOQUEUE_SIZE - (int)(head - tail), UDP_RECV_BATCH);
+		if (!count)
+		{
+			// the host frame is behind, leave the packets in the socket buffer meanwhile
+			SDL_Delay (1);
+			continue;
+		}
+
+		// the timeout only bounds how long UDP_StopIOThread waits
+		pfd.revents = 0;
+		if (poll (&pfd, 1, 100) <= 0)
+			continue;
+
+		for (i = 0; i < count; i++)
+		{
+			udppacket_t *packet = &io->packets[(head + i) & (UDP_IOQUEUE_SIZE - 1)];
+			iovs[i].iov_base = packet->data;
+			iovs[i].iov_len = NET_DATAGRAMSIZE;
+			memset (&msgs[i], 0, sizeof (msgs[i]));
+			msgs[i].msg_hdr.msg_iov = &iovs[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+			msgs[i].msg_hdr.msg_name = &packet->addr;
+			msgs[i].msg_hdr.msg_namelen = sizeof (struct qsockaddr);
+		}
+		ret = recvmmsg (io->socket, msgs, count, MSG_DONTWAIT, NULL);
+		if (ret == SOCKET_ERROR)
+		{
+			int err = SOCKETERRNO;
+			if (err != NET_EWOULDBLOCK && err != NET_ECONNREFUSED && err != EINTR)
+			{
+				// Con_SafePrintf isn't thread safe, UDP_Read reports this
+				Atomic_StoreUInt32 (&io->error, err);
+				SDL_Delay (1);
+			}
+			continue;
+		}
+
+		time = Sys_DoubleTime ();
+		for (i = 0; i < ret; i++)
+		{
+			udppacket_t *packet = &io->packets[(head + i) & (UDP_IOQUEUE_SIZE - 1)];
+			packet->time = time;
+			packet->len = msgs[i].msg_len;
+		}
+		Atomic_StoreUInt32 (&io->head, head + ret);
+	}
+	return 0;
+}
+#endif
+
+/*
+====================
+UDP_StartIOThread
+
+Moves the reads of an accept or client socket to a dedicated thread if net_iothread is set.
+====================
+*/
+static void UDP_StartIOThread (sys_socket_t socketid)
+{
+#ifdef UDP_BATCHED_IO
+	udpiothread_t *io;
+	int			   i, slot;
+
+	if (!net_iothread.value || UDP_FindIOThread (socketid))
+		return;
+	for (slot = 0; slot < UDP_IOTHREADS; slot++)
+		if (!udp_iothreads[slot])
+			break;
+	if (slot == UDP_IOTHREADS)
+		return;
+
+	io = (udpiothread_t *)Mem_AllocTagged (sizeof (udpiothread_t), MEM_TAG_NET);
+	io->socket = socketid;
+	io->data = (byte *)Mem_AllocTagged (UDP_IOQUEUE_SIZE * NET_DATAGRAMSIZE, MEM_TAG_NET);
+	for (i = 0; i < UDP_IOQUEUE_SIZE; i++)
+		io->packets[i].data = io->data + i * NET_DATAGRAMSIZE;
+	io->thread = SDL_CreateThread (UDP_IOThread, "UDP_IOThread", io);
+	if (!io->thread)
+	{
+		Con_SafePrintf ("UDP_StartIOThread: %s\n", SDL_GetError ());
+		Mem_Free (io->data);
+		Mem_Free (io);
+		return;
+	}
+	udp_iothreads[slot] = io;
+#endif
+}
+
+/*
+====================
+UDP_StopIOThread
+====================
+*/
+static void UDP_StopIOThread (sys_socket_t socketid)
+{
+#ifdef UDP_BATCHED_IO
+	int i;
+
+	for (i = 0; i < UDP_IOTHREADS; i++)
+	{
+		udpiothread_t *io = udp_iothreads[i];
+		if (!io || io->socket != socketid)
+			continue;
+		Atomic_StoreUInt32 (&io->quit, 1);
+		SDL_WaitThread (io->thread, NULL);
+		Mem_Free (io->data);
+		Mem_Free (io);
+		udp_iothreads[i] = NULL;
+	}
+#endif
+}
+
+/*
+====================
+UDP_ThreadedReads
+
+Returns true if an io thread reads this socket, nothing else may read it then.
+====================
+*/
+static qboolean UDP_ThreadedReads (sys_socket_t socketid)
+{
+#ifdef UDP_BATCHED_IO
+	return UDP_FindIOThread (socketid) != NULL;
+#else
+	return false;
+#endif
+}
+
 //=============================================================================
 
 sys_socket_t UDP4_Init (void)
@@ -138,6 +378,7 @@ sys_socket_t UDP4_Listen (qboolean state)
 		{
 			if ((net_acceptsocket4 = UDP4_OpenSocket (net_hostport)) == INVALID_SOCKET)
 				Sys_Error ("UDP4_Listen: Unable to open accept socket");
+			UDP_StartIOThread (net_acceptsocket4);
 		}
 	}
 	else
@@ -189,6 +430,21 @@ ErrorReturn:
 
 int UDP_CloseSocket (sys_socket_t socketid)
 {
+#ifdef UDP_BATCHED_IO
+	int i;
+
+	UDP_StopIOThread (socketid);
+	if (socketid == udp_sendsocket)
+		UDP_FlushSends ();
+	for (i = 0; i < UDP_RECV_RINGS; i++)
+	{
+		if (udp_recvrings[i].data && udp_recvrings[i].socket == socketid)
+		{
+			Mem_Free (udp_recvrings[i].data);
+			memset (&udp_recvrings[i], 0, sizeof (udp_recvrings[i]));
+		}
+	}
+#endif
 	if (socketid == net_broadcastsocket4)
 		net_broadcastsocket4 = INVALID_SOCKET;
 	return closesocket (socketid);
@@ -253,6 +509,8 @@ static int PartialIPAddress (const char *in, struct qsockaddr *hostaddr)
 
 int UDP_Connect (sys_socket_t socketid, struct qsockaddr *addr)
 {
+	// the client gets its packets off the socket while the main thread renders
+	UDP_StartIOThread (socketid);
 	return 0;
 }
 
@@ -267,6 +525,10 @@ sys_socket_t UDP4_CheckNewConnections (void)
 
 	if (net_acceptsocket4 == INVALID_SOCKET)
 		return INVALID_SOCKET;
+	if (UDP_PendingReads (net_acceptsocket4))
+		return net_acceptsocket4;
+	if (UDP_ThreadedReads (net_acceptsocket4))
+		return INVALID_SOCKET; // don't race the io thread for the packets below
 
 	if (ioctl (net_acceptsocket4, FIONREAD, &available) == -1)
 	{
@@ -282,11 +544,138 @@ sys_socket_t UDP4_CheckNewConnections (void)
 
 //=============================================================================
 
+#ifdef UDP_BATCHED_IO
+/*
+====================
+UDP_FindRecvRing
+
+Returns the receive ring of a socket, allocating one on first use.
+Returns NULL when all rings are taken, the caller falls back to recvfrom then.
+====================
+*/
+static udprecvring_t *UDP_FindRecvRing (sys_socket_t socketid, qboolean create)
+{
+	udprecvring_t *ring;
+	int			   i, j;
+
+	for (i = 0; i < UDP_RECV_RINGS; i++)
+		if (udp_recvrings[i].data && udp_recvrings[i].socket == socketid)
+			return &udp_recvrings[i];
+	if (!create)
+		return NULL;
+	for (i = 0; i < UDP_RECV_RINGS; i++)
+	{
+		ring = &udp_recvrings[i];
+		if (ring->data)
+			continue;
+		ring->socket = socketid;
+		ring->data = (byte *)Mem_AllocTagged (UDP_RECV_BATCH * NET_DATAGRAMSIZE, MEM_TAG_NET);
+		for (j = 0; j < UDP_RECV_BATCH; j++)
+		{
+			ring->iovs[j].iov_base = ring->data + j * NET_DATAGRAMSIZE;
+			ring->iovs[j].iov_len = NET_DATAGRAMSIZE;
+			ring->msgs[j].msg_hdr.msg_iov = &ring->iovs[j];
+			ring->msgs[j].msg_hdr.msg_iovlen = 1;
+			ring->msgs[j].msg_hdr.msg_name = &ring->addrs[j];
+		}
+		return ring;
+	}
+	return NULL;
+}
+#endif
+
+/*
+====================
+UDP_PendingReads
+
+Returns true if packets of this socket were already drained into its receive ring.
+====================
+*/
+qboolean UDP_PendingReads (sys_socket_t socketid)
+{
+#ifdef UDP_BATCHED_IO
+	udpiothread_t *io = UDP_FindIOThread (socketid);
+	udprecvring_t *ring;
+
+	if (io)
+		return Atomic_LoadUInt32 (&io->head) != Atomic_LoadUInt32 (&io->tail);
+	ring = UDP_FindRecvRing (socketid, false);
+	return ring && ring->count > 0;
+#else
+	return false;
+#endif
+}
+
+//=============================================================================
+
 int UDP_Read (sys_socket_t socketid, byte *buf, int len, struct qsockaddr *addr)
 {
 	socklen_t addrlen = sizeof (struct qsockaddr);
 	int		  ret;
 
+	net_packettime = net_time;
+
+#ifdef UDP_BATCHED_IO
+	udpiothread_t *io = UDP_FindIOThread (socketid);
+	if (io)
+	{
+		uint32_t	 tail = Atomic_LoadUInt32 (&io->tail);
+		udppacket_t *packet;
+		int			 err = Atomic_LoadUInt32 (&io->error);
+
+		if (err)
+		{
+			Atomic_StoreUInt32 (&io->error, 0);
+			Con_SafePrintf ("UDP_Read, recvmmsg: %s\n", socketerror (err));
+		}
+		if (tail == Atomic_LoadUInt32 (&io->head))
+			return 0;
+
+		packet = &io->packets[tail & (UDP_IOQUEUE_SIZE - 1)];
+		ret = q_min (packet->len, len);
+		memcpy (buf, packet->data, ret);
+		memcpy (addr, &packet->addr, sizeof (struct qsockaddr));
+		net_packettime = packet->time;
+		Atomic_StoreUInt32 (&io->tail, tail + 1);
+		return ret;
+	}
+
+	udprecvring_t *ring = UDP_FindRecvRing (socketid, true);
+	if (ring)
+	{
+		struct mmsghdr *msg;
+		int				i;
+
+		if (!ring->count)
+		{
+			// drain everything that is queued on the socket with a single syscall
+			for (i = 0; i < UDP_RECV_BATCH; i++)
+				ring->msgs[i].msg_hdr.msg_namelen = sizeof (struct qsockaddr);
+			ret = recvmmsg (socketid, ring->msgs, UDP_RECV_BATCH, MSG_DONTWAIT, NULL);
+			if (ret == SOCKET_ERROR)
+			{
+				int err = SOCKETERRNO;
+				if (err == NET_EWOULDBLOCK || err == NET_ECONNREFUSED)
+					return 0;
+				Con_SafePrintf ("UDP_Read, recvmmsg: %s\n", socketerror (err));
+				return ret;
+			}
+			ring->head = 0;
+			ring->count = ret;
+			if (!ring->count)
+				return 0;
+		}
+
+		msg = &ring->msgs[ring->head];
+		ret = q_min ((int)msg->msg_len, len);
+		memcpy (buf, msg->msg_hdr.msg_iov->iov_base, ret);
+		memcpy (addr, msg->msg_hdr.msg_name, sizeof (struct qsockaddr));
+		ring->head++;
+		ring->count--;
+		return ret;
+	}
+#endif
+
 	ret = recvfrom (socketid, buf, len, 0, (struct sockaddr *)addr, &addrlen);
 	if (ret == SOCKET_ERROR)
 	{
@@ -339,6 +728,84 @@ int UDP4_Broadcast (sys_socket_t socketid, byte *buf, int len)
 
 //=============================================================================
 
+#ifdef UDP_BATCHED_IO
+/*
+====================
+UDP_FlushSends
+
+Sends all queued datagrams with sendmmsg. Messages that fail are reported and skipped,
+just like UDP_Write does for sendto.
+====================
+*/
+static void UDP_FlushSends (void)
+{
+	struct mmsghdr msgs[UDP_SEND_BATCH];
+	struct iovec   iovs[UDP_SEND_BATCH];
+	int			   i, first, ret;
+
+	for (i = 0; i < udp_numsends; i++)
+	{
+		iovs[i].iov_base = udp_senddata + udp_sends[i].offset;
+		iovs[i].iov_len = udp_sends[i].len;
+		memset (&msgs[i], 0, sizeof (msgs[i]));
+		msgs[i].msg_hdr.msg_iov = &iovs[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+		msgs[i].msg_hdr.msg_name = &udp_sends[i].addr;
+		msgs[i].msg_hdr.msg_namelen = udp_sends[i].addrsize;
+	}
+
+	for (first = 0; first < udp_numsends;)
+	{
+		ret = sendmmsg (udp_sendsocket, msgs + first, udp_numsends - first, 0);
+		if (ret == SOCKET_ERROR)
+		{
+			int err = SOCKETERRNO;
+			if (err == NET_EWOULDBLOCK)
+				break;
+			if (err == ENETUNREACH)
+				Con_SafePrintf ("UDP_Write: %s (%s)\n", socketerror (err), UDP_AddrToString (&udp_sends[first].addr, false));
+			else
+				Con_SafePrintf ("UDP_Write, sendmmsg: %s\n", socketerror (err));
+			ret = 1; // skip the failing message
+		}
+		first += ret;
+	}
+
+	udp_sendsocket = INVALID_SOCKET;
+	udp_numsends = 0;
+	udp_senddatasize = 0;
+}
+#endif
+
+/*
+====================
+UDP_BeginSendBatch
+
+Queues all following UDP_Write calls until UDP_EndSendBatch. Packets are still sent in order.
+====================
+*/
+void UDP_BeginSendBatch (void)
+{
+#ifdef UDP_BATCHED_IO
+	udp_sendbatch = true;
+#endif
+}
+
+/*
+====================
+UDP_EndSendBatch
+====================
+*/
+void UDP_EndSendBatch (void)
+{
+#ifdef UDP_BATCHED_IO
+	UDP_FlushSends ();
+	udp_sendbatch = false;
+#endif
+}
+
+//=============================================================================
+
 int UDP_Write (sys_socket_t socketid, byte *buf, int len, struct qsockaddr *addr)
 {
 	int					  ret;
@@ -354,6 +821,31 @@ int UDP_Write (sys_socket_t socketid, byte *buf, int len, struct qsockaddr *addr
 		return -1; // some kind of error. a few systems get pissy if the size doesn't exactly match the address family
 	}
 
+#ifdef UDP_BATCHED_IO
+	if (udp_sendbatch)
+	{
+		udpsend_t *send;
+
+		// sendmmsg takes a single socket
+		if (udp_numsends == UDP_SEND_BATCH || (udp_numsends && socketid != udp_sendsocket))
+			UDP_FlushSends ();
+		if (udp_senddatasize + len > udp_maxsenddatasize)
+		{
+			udp_maxsenddatasize = q_max (udp_maxsenddatasize * 2, udp_senddatasize + len);
+			udp_senddata = (byte *)Mem_ReallocTagged (udp_senddata, udp_maxsenddatasize, MEM_TAG_NET);
+		}
+		send = &udp_sends[udp_numsends++];
+		memcpy (&send->addr, addr, addrsize);
+		send->addrsize = addrsize;
+		send->offset = udp_senddatasize;
+		send->len = len;
+		memcpy (udp_senddata + udp_senddatasize, buf, len);
+		udp_senddatasize += len;
+		udp_sendsocket = socketid;
+		return len;
+	}
+#endif
+
 	ret = sendto (socketid, buf, len, 0, (struct sockaddr *)addr, addrsize);
 	if (!hdr->qsa_family)
 		Con_SafePrintf ("UDP_Write: family was cleared\n");
@@ -613,6 +1105,7 @@ sys_socket_t UDP6_Listen (qboolean state)
 		{
 			if ((net_acceptsocket6 = UDP6_OpenSocket (net_hostport)) == INVALID_SOCKET)
 				Sys_Error ("UDP6_Listen: Unable to open accept socket");
+			UDP_StartIOThread (net_acceptsocket6);
 		}
 	}
 	else
@@ -684,6 +1177,10 @@ sys_socket_t UDP6_CheckNewConnections (void)
 
 	if (net_acceptsocket6 == INVALID_SOCKET)
 		return INVALID_SOCKET;
+	if (UDP_PendingReads (net_acceptsocket6))
+		return net_acceptsocket6;
+	if (UDP_ThreadedReads (net_acceptsocket6))
+		return INVALID_SOCKET; // don't race the io thread for the packets below
 
 	if (ioctl (net_acceptsocket6, FIONREAD, &available) == -1)
 	{
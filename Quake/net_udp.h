@@ -29,8 +29,11 @@ sys_socket_t UDP4_OpenSocket (int port);
 int			 UDP_CloseSocket (sys_socket_t socketid);
 int			 UDP_Connect (sys_socket_t socketid, struct qsockaddr *addr);
 sys_socket_t UDP4_CheckNewConnections (void);
+qboolean	 UDP_PendingReads (sys_socket_t socketid);
 int			 UDP_Read (sys_socket_t socketid, byte *buf, int len, struct qsockaddr *addr);
 int			 UDP_Write (sys_socket_t socketid, byte *buf, int len, struct qsockaddr *addr);
+void		 UDP_BeginSendBatch (void);
+void		 UDP_EndSendBatch (void);
 int			 UDP4_Broadcast (sys_socket_t socketid, byte *buf, int len);
 const char	*UDP_AddrToString (struct qsockaddr *addr, qboolean masked);
 int			 UDP4_StringToAddr (const char *string, struct qsockaddr *addr);
@@ -51,6 +54,8 @@ int			 UDP_Connect (sys_socket_t socketid, struct qsockaddr *addr);
 sys_socket_t UDP6_CheckNewConnections (void);
 int			 UDP_Read (sys_socket_t socketid, byte *buf, int len, struct qsockaddr *addr);
 int			 UDP_Write (sys_socket_t socketid, byte *buf, int len, struct qsockaddr *addr);
+void		 UDP_BeginSendBatch (void);
+void		 UDP_EndSendBatch (void);
 int			 UDP6_Broadcast (sys_socket_t socketid, byte *buf, int len);
 const char	*UDP_AddrToString (struct qsockaddr *addr, qboolean masked);
 int			 UDP6_StringToAddr (const char *string, struct qsockaddr *addr);
@@ -22,21 +22,11 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #ifndef _PALETTE_H
 #define _PALETTE_H
 
-#define NUM_PALETTE_OCTREE_NODES  184
-#define NUM_PALETTE_OCTREE_COLORS 5844
+// 8-bit color emulation looks colors up in a PALETTE_LUT_SIZE^3 grid over RGB instead of searching
+// the palette per pixel, keep in sync with screen_effects_common.inc
+#define PALETTE_LUT_SIZE 64
 
-typedef struct palette_octree_node_s
-{
-	uint32_t child_offsets[8];
-} palette_octree_node_t;
-
-COMPILE_TIME_ASSERT ("palette_octree_node_t", sizeof (palette_octree_node_t) == 32);
-
-extern palette_octree_node_t palette_octree_nodes[NUM_PALETTE_OCTREE_NODES];
-extern uint32_t				 palette_octree_colors[NUM_PALETTE_OCTREE_COLORS];
-
-#ifdef _DEBUG
-void CreatePaletteOctree_f (void);
-#endif
+// Fills 2 bytes per cell, red fastest: the indexes of the nearest and second nearest color of d_8to24table
+void Palette_BuildLUT (byte *lut);
 
 #endif /* _PALETTE_H */
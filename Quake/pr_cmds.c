@@ -956,23 +956,44 @@ Returns a chain of entities that have origins within a spherical area
 findradius (origin, radius)
 =================
 */
+cvar_t		sv_gameplayfix_findradiusareanodes = {"sv_gameplayfix_findradiusareanodes", "0"};
 static void PF_findradius (void)
 {
 	edict_t *ent, *chain;
 	float	 rad;
 	float	*org;
-	int		 i;
+	int		 i, count;
+	vec3_t	 mins, maxs;
 
 	chain = (edict_t *)qcvm->edicts;
 
 	org = G_VECTOR (OFS_PARM0);
 	rad = G_FLOAT (OFS_PARM1);
+
+	// only linked edicts can be found through the areanodes, so this misses the ones that
+	// were made solid or moved without a setorigin/setsize since their last link
+	const qboolean areanodes = sv_gameplayfix_findradiusareanodes.value && qcvm == &sv.qcvm && isfinite (rad);
+	const mem_frame_mark_t mark = Mem_FrameMark ();
+	edict_t			   **list = areanodes ? (edict_t **)Mem_FrameAlloc (qcvm->num_edicts * sizeof (edict_t *)) : NULL;
+	if (areanodes)
+	{
+		for (i = 0; i < 3; i++)
+		{
+			mins[i] = org[i] - fabsf (rad) - 1.0f;
+			maxs[i] = org[i] + fabsf (rad) + 1.0f;
+		}
+		count = SV_AreaEdicts (mins, maxs, list, qcvm->num_edicts);
+	}
+	else
+		count = qcvm->num_edicts - 1;
+
 	rad *= rad;
 
-	ent = NEXT_EDICT (qcvm->edicts);
-	for (i = 1; i < qcvm->num_edicts; i++, ent = NEXT_EDICT (ent))
+	ent = qcvm->edicts;
+	for (i = 0; i < count; i++)
 	{
 		float d, lensq;
+		ent = areanodes ? list[i] : NEXT_EDICT (ent);
 		if (ent->free)
 			continue;
 		if (ent->v.solid == SOLID_NOT)
@@ -995,6 +1016,7 @@ static void PF_findradius (void)
 		chain = ent;
 	}
 
+	Mem_FrameRelease (mark);
 	RETURN_EDICT (chain);
 }
 
@@ -1074,6 +1096,12 @@ static void PF_Find (void)
 		ed = EDICT_NUM (e);
 		if (ed->free)
 			continue;
+		// the same string number is the same string
+		if (E_INT (ed, f) == G_INT (OFS_PARM2))
+		{
+			RETURN_EDICT (ed);
+			return;
+		}
 		t = E_STRING (ed, f);
 		if (!t)
 			continue;
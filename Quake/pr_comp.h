@@ -148,7 +148,9 @@ typedef enum opcode_t
 	OP_OR,
 
 	OP_BITAND,
-	OP_BITOR
+	OP_BITOR,
+
+	OP_NUMOPS // not an opcode, number of opcodes
 } opcode_t;
 
 typedef struct statement_s
@@ -34,8 +34,6 @@ const int type_size[NUM_TYPE_SIZES] = {
 	1  // sizeof(void *) / 4		// ev_pointer
 };
 
-static ddef_t *ED_FieldAtOfs (int ofs);
-
 cvar_t nomonsters = {"nomonsters", "0", CVAR_NONE};
 cvar_t gamecfg = {"gamecfg", "0", CVAR_NONE};
 cvar_t scratch1 = {"scratch1", "0", CVAR_NONE};
@@ -48,6 +46,98 @@ cvar_t saved2 = {"saved2", "0", CVAR_ARCHIVE};
 cvar_t saved3 = {"saved3", "0", CVAR_ARCHIVE};
 cvar_t saved4 = {"saved4", "0", CVAR_ARCHIVE};
 
+extern cvar_t pr_checkcode;
+
+static int	PR_AllocEdictString (int size, char **ptr);
+static void PR_FreeStringBlocks (void);
+
+/*
+=================
+ED_StorageSize
+
+The edict storage grows in steps of EDICT_COMMIT_SIZE, a multiple of the page size
+=================
+*/
+#define EDICT_COMMIT_SIZE (64 * 1024)
+static size_t ED_StorageSize (int num, size_t element_size)
+{
+	return ((size_t)num * element_size + EDICT_COMMIT_SIZE - 1) & ~(size_t)(EDICT_COMMIT_SIZE - 1);
+}
+
+/*
+=================
+ED_AllocEdicts
+
+Only reserves address space for max_edicts, ED_CommitEdicts backs it with memory as
+num_edicts grows. The storage never moves, so edict pointers stay valid.
+=================
+*/
+void ED_AllocEdicts (int max_edicts)
+{
+	qcvm->max_edicts = max_edicts;
+	qcvm->committed_edicts = 0;
+	qcvm->edicts = (edict_t *)Sys_MemReserve (ED_StorageSize (max_edicts, qcvm->edict_size));
+	qcvm->edictleafs = (edictleafs_t *)Sys_MemReserve (ED_StorageSize (max_edicts, sizeof (edictleafs_t)));
+	if (!qcvm->edicts || !qcvm->edictleafs)
+		Sys_Error ("ED_AllocEdicts: couldn't reserve %i edicts", max_edicts);
+}
+
+/*
+=================
+ED_CommitStorage
+=================
+*/
+static void ED_CommitStorage (byte *storage, size_t element_size, int old_num, int num)
+{
+	const size_t old_size = ED_StorageSize (old_num, element_size);
+	const size_t size = ED_StorageSize (num, element_size);
+
+	if (size == old_size)
+		return;
+	if (!Sys_MemCommit (storage + old_size, size - old_size))
+		Sys_Error ("ED_CommitEdicts: out of memory for %i edicts", num);
+	Mem_AccountPages (MEM_TAG_PROGS, (int64_t)(size - old_size));
+}
+
+/*
+=================
+ED_CommitEdicts
+
+Makes the edicts below num usable, newly committed ones read as zero
+=================
+*/
+void ED_CommitEdicts (int num)
+{
+	if (num <= qcvm->committed_edicts)
+		return;
+
+	assert (num <= qcvm->max_edicts);
+	ED_CommitStorage ((byte *)qcvm->edicts, qcvm->edict_size, qcvm->committed_edicts, num);
+	ED_CommitStorage ((byte *)qcvm->edictleafs, sizeof (edictleafs_t), qcvm->committed_edicts, num);
+	qcvm->committed_edicts = num;
+}
+
+/*
+=================
+ED_FreeEdicts
+
+Releases the whole reservation, a new map commits its edicts from scratch
+=================
+*/
+static void ED_FreeEdicts (void)
+{
+	if (!qcvm->edicts)
+		return;
+
+	Mem_AccountPages (MEM_TAG_PROGS, -(int64_t)ED_StorageSize (qcvm->committed_edicts, qcvm->edict_size));
+	Mem_AccountPages (MEM_TAG_PROGS, -(int64_t)ED_StorageSize (qcvm->committed_edicts, sizeof (edictleafs_t)));
+	Sys_MemRelease ((byte *)qcvm->edicts, ED_StorageSize (qcvm->max_edicts, qcvm->edict_size));
+	Sys_MemRelease ((byte *)qcvm->edictleafs, ED_StorageSize (qcvm->max_edicts, sizeof (edictleafs_t)));
+	qcvm->edicts = NULL;
+	qcvm->edictleafs = NULL;
+	qcvm->committed_edicts = 0;
+}
+
 /*
 =================
 ED_Alloc
@@ -62,7 +152,7 @@ angles and bad trails.
 edict_t *ED_Alloc (void)
 {
 	// get head of FIFO, if not empty
-	edict_t *e = (qcvm->free_list.size > 0) ? qcvm->free_list.circular_buffer[qcvm->free_list.head_index] : NULL;
+	edict_t *e = (qcvm->free_list.size > 0) ? EDICT_FROM_FREELINK (qcvm->free_list.edicts.next) : NULL;
 
 	if (e && ((e->freetime < MAX_EDICT_FREETIME_ALWAYS_REUSE) || (qcvm->time - e->freetime) > MIN_EDICT_AGE_FOR_REUSE))
 	{
@@ -71,19 +161,17 @@ edict_t *ED_Alloc (void)
 		e->free = false;
 
 		// pop HEAD
-		qcvm->free_list.head_index = (qcvm->free_list.head_index + 1) % MAX_EDICTS;
+		RemoveLink (&e->freelink);
 		qcvm->free_list.size -= 1;
 
-		// no real need, but easier for debugging...
-		if (qcvm->free_list.size == 0)
-			qcvm->free_list.head_index = 0;
-
 		return e;
 	}
 
 	if (qcvm->num_edicts == qcvm->max_edicts) // johnfitz -- use sv.max_edicts instead of MAX_EDICTS
 		Host_Error ("ED_Alloc: no free edicts (max_edicts is %i)", qcvm->max_edicts);
 
+	ED_CommitEdicts (qcvm->num_edicts + 1);
+	qcvm->edictleafs[qcvm->num_edicts].num_leafs = 0;
 	e = EDICT_NUM (qcvm->num_edicts++);
 
 	// vso - 'new' free edicts are not necessarily clean after a load/fastload
@@ -106,8 +194,9 @@ ED_AddToFreeList
 */
 static void ED_AddToFreeList (edict_t *ed)
 {
-	size_t add_index = (qcvm->free_list.head_index + qcvm->free_list.size) % MAX_EDICTS;
-	qcvm->free_list.circular_buffer[add_index] = ed;
+	if (!qcvm->free_list.edicts.next)
+		ClearLink (&qcvm->free_list.edicts);
+	InsertLinkBefore (&ed->freelink, &qcvm->free_list.edicts);
 	qcvm->free_list.size += 1;
 }
 
@@ -157,70 +246,32 @@ void ED_RemoveFromFreeList (edict_t *ed)
 {
 	if (ed->free)
 	{
-		// find the index where ed is...
-		for (size_t i = 0; i < qcvm->free_list.size; i++)
-		{
-			const size_t found_index = (qcvm->free_list.head_index + i) % MAX_EDICTS;
-
-			if (qcvm->free_list.circular_buffer[found_index] == ed)
-			{
-				// overwrite found_index with head data, advance head.
-				qcvm->free_list.circular_buffer[found_index] = qcvm->free_list.circular_buffer[qcvm->free_list.head_index];
-				qcvm->free_list.head_index = (qcvm->free_list.head_index + 1) % MAX_EDICTS;
-				qcvm->free_list.size -= 1;
-				break;
-			}
-		}
+		RemoveLink (&ed->freelink);
+		qcvm->free_list.size -= 1;
 	}
 }
 
-static int ED_freetime_compare_func (const void *first, const void *second)
-{
-	int firstInt = *(const int *)first;
-	int secondInt = *(const int *)second;
-	return (int)copysign (1.0, EDICT_NUM (firstInt)->freetime - EDICT_NUM (secondInt)->freetime);
-}
-
 /*
 =================
 ED_RebuildFreeList
-Rebuild the entire free list, ordering the free edicts
-by the smallest freetime to maximize chance of reuse in ED_Alloc
+Rebuild the entire free list from the free edicts below num_edicts,
+all of them being made reusable right away
 =================
 */
-void ED_RebuildFreeList (bool force_free_reuse)
+void ED_RebuildFreeList (void)
 {
-	int *free_edicts_table = (int *)Mem_Alloc (qcvm->num_edicts * sizeof (int));
-
-	int nb_free_edicts = 0;
+	ClearLink (&qcvm->free_list.edicts);
+	qcvm->free_list.size = 0;
 
-	// 1. Enumerate free edict numebers aand put it in free_edicts_table
 	for (int i = 0; i < qcvm->num_edicts; i++)
 	{
-		if (EDICT_NUM (i)->free)
+		edict_t *ed = EDICT_NUM (i);
+		if (ed->free)
 		{
-			if (force_free_reuse)
-				EDICT_NUM (i)->freetime = 0.0f;
-
-			free_edicts_table[nb_free_edicts++] = i;
+			ed->freetime = 0.0f;
+			ED_AddToFreeList (ed);
 		}
 	}
-
-	if (!force_free_reuse)
-	{
-		// 2.2 Sort free_edicts_table by their corrsponding edict freetime
-		qsort (free_edicts_table, nb_free_edicts, sizeof (int), ED_freetime_compare_func);
-	}
-
-	// 3. Reset freelist and insert by free_edicts_table order
-	memset (&(qcvm->free_list), 0x0, sizeof (freelist_t));
-
-	for (int j = 0; j < nb_free_edicts; j++)
-	{
-		ED_AddToFreeList (EDICT_NUM (free_edicts_table[j]));
-	}
-
-	Mem_Free (free_edicts_table);
 }
 
 //===========================================================================
@@ -249,7 +300,7 @@ static ddef_t *ED_GlobalAtOfs (int ofs)
 ED_FieldAtOfs
 ============
 */
-static ddef_t *ED_FieldAtOfs (int ofs)
+ddef_t *ED_FieldAtOfs (int ofs)
 {
 	ddef_t *def;
 	int		i;
@@ -906,16 +957,12 @@ void ED_PrintEdicts (void)
 
 	Con_Printf ("\nFree-list:\n");
 
-	size_t current_index = qcvm->free_list.head_index;
-
-	for (size_t j = 0; j < qcvm->free_list.size; j++)
+	for (link_t *l = qcvm->free_list.edicts.next; l && l != &qcvm->free_list.edicts; l = l->next)
 	{
-		edict_t *e = qcvm->free_list.circular_buffer[current_index];
+		edict_t *e = EDICT_FROM_FREELINK (l);
 
 		ED_Print (e);
 		free_list_count++;
-
-		current_index = (current_index + 1) % MAX_EDICTS;
 	}
 
 	assert (free_list_count == free_edicts_count);
@@ -1113,14 +1160,15 @@ const char *ED_ParseGlobals (const char *data)
 ED_NewString
 =============
 */
-static string_t ED_NewString (const char *string)
+string_t ED_NewString (const char *string)
 {
 	char	*new_p;
 	int		 i, l;
 	string_t num;
 
 	l = strlen (string) + 1;
-	num = PR_AllocString (l, &new_p);
+	// field names merged at load time must survive PR_ClearEdictStrings
+	num = qcvm->progsstrings ? PR_AllocEdictString (l, &new_p) : PR_AllocString (l, &new_p);
 
 	for (i = 0; i < l; i++)
 	{
@@ -1168,7 +1216,7 @@ static void ED_RezoneString (string_t *ref, const char *str)
 		int old_size = (qcvm->knownzonesize + 7) >> 3;
 		qcvm->knownzonesize = (id + 32) & ~7;
 		int new_size = (qcvm->knownzonesize + 7) >> 3;
-		qcvm->knownzone = Mem_Realloc (qcvm->knownzone, new_size);
+		qcvm->knownzone = Mem_ReallocTagged (qcvm->knownzone, new_size, MEM_TAG_PROGS);
 		memset (qcvm->knownzone + old_size, 0, new_size - old_size);
 	}
 	qcvm->knownzone[id >> 3] |= 1u << (id & 7);
@@ -1432,12 +1480,15 @@ void ED_LoadFromFile (const char *data)
 	edict_t		*ent = NULL;
 	int			 inhibit = 0;
 	int			 usingspawnfunc = 0;
+	const char	*start = data;
 
 	pr_global_struct->time = qcvm->time;
 
 	// parse ents
 	while (1)
 	{
+		SCR_LoadingProgress ((int)(data - start));
+
 		// parse the opening brace
 		data = COM_Parse (data);
 		if (!data)
@@ -1548,14 +1599,19 @@ void PR_ClearProgs (qcvm_t *vm)
 	if (qcvm->knownstrings)
 	{
 		for (int i = 0; i < qcvm->numknownstrings; ++i)
-			if (qcvm->knownstringsowned[i])
+			if (qcvm->knownstringskind[i] == KNOWNSTRING_OWNED)
 				Mem_Free (qcvm->knownstrings[i]);
 		Mem_Free ((void *)qcvm->knownstrings);
-		Mem_Free (qcvm->knownstringsowned);
+		Mem_Free (qcvm->knownstringskind);
+		Mem_Free (qcvm->freeknownstrings);
+		HashMap_Destroy (qcvm->knownstringsmap);
 	}
-	Mem_Free (qcvm->edicts); // ericw -- sv.edicts switched to use malloc()
+	PR_FreeStringBlocks ();
+	ED_FreeEdicts ();
 	if (qcvm->fielddefs != (ddef_t *)((byte *)qcvm->progs + qcvm->progs->ofs_fielddefs))
 		Mem_Free (qcvm->fielddefs);
+	Mem_Free (qcvm->code);
+	PR_FreeProfiler (qcvm);
 	Mem_Free (qcvm->progs); // spike -- pr_progs switched to use malloc (so menuqc doesn't end up stuck on the early hunk nor wiped on every map change)
 	HashMap_Destroy (qcvm->function_map);
 	HashMap_Destroy (qcvm->fielddefs_map);
@@ -1724,10 +1780,10 @@ static void PR_PatchRereleaseBuiltins (void)
 
 /*
 ===============
-PR_LoadProgs
+PR_LoadProgsFile
 ===============
 */
-qboolean PR_LoadProgs (const char *filename, qboolean fatal, unsigned int needcrc, const builtin_t *builtins, size_t numbuiltins)
+static qboolean PR_LoadProgsFile (const char *filename, qboolean fatal, unsigned int needcrc, const builtin_t *builtins, size_t numbuiltins)
 {
 	int i;
 
@@ -1898,11 +1954,25 @@ qboolean PR_LoadProgs (const char *filename, qboolean fatal, unsigned int needcr
 	PR_EnableExtensions (qcvm->globaldefs);
 	PR_PatchRereleaseBuiltins ();
 	PR_FindSupportedEffects ();
+	PR_TranslateStatements ();
 
 	qcvm->progsstrings = qcvm->numknownstrings;
 	return true;
 }
 
+/*
+===============
+PR_LoadProgs
+===============
+*/
+qboolean PR_LoadProgs (const char *filename, qboolean fatal, unsigned int needcrc, const builtin_t *builtins, size_t numbuiltins)
+{
+	const mem_tag_t prev_tag = Mem_SetThreadTag (MEM_TAG_PROGS);
+	const qboolean	result = PR_LoadProgsFile (filename, fatal, needcrc, builtins, numbuiltins);
+	Mem_SetThreadTag (prev_tag);
+	return result;
+}
+
 /*
 ===============
 ED_Nomonsters_f
@@ -1925,6 +1995,8 @@ void PR_Init (void)
 	Cmd_AddCommand ("edicts", ED_PrintEdicts);
 	Cmd_AddCommand ("edictcount", ED_Count);
 	Cmd_AddCommand ("profile", PR_Profile_f);
+	Cmd_AddCommand ("profile_start", PR_ProfileStart_f);
+	Cmd_AddCommand ("profile_stop", PR_ProfileStop_f);
 	Cmd_AddCommand ("pr_dumpplatform", PR_DumpPlatform_f);
 	Cvar_RegisterVariable (&nomonsters);
 	Cvar_SetCallback (&nomonsters, ED_Nomonsters_f);
@@ -1938,6 +2010,7 @@ void PR_Init (void)
 	Cvar_RegisterVariable (&saved2);
 	Cvar_RegisterVariable (&saved3);
 	Cvar_RegisterVariable (&saved4);
+	Cvar_RegisterVariable (&pr_checkcode);
 
 	PR_InitExtensions ();
 }
@@ -1969,8 +2042,43 @@ static void PR_AllocStringSlots (void)
 {
 	qcvm->maxknownstrings += PR_STRING_ALLOCSLOTS;
 	Con_DPrintf2 ("PR_AllocStringSlots: realloc'ing for %d slots\n", qcvm->maxknownstrings);
-	qcvm->knownstrings = (const char **)Mem_Realloc ((void *)qcvm->knownstrings, qcvm->maxknownstrings * sizeof (char *));
-	qcvm->knownstringsowned = (qboolean *)Mem_Realloc ((void *)qcvm->knownstringsowned, qcvm->maxknownstrings * sizeof (qboolean));
+	qcvm->knownstrings = (const char **)Mem_ReallocTagged ((void *)qcvm->knownstrings, qcvm->maxknownstrings * sizeof (char *), MEM_TAG_PROGS);
+	qcvm->knownstringskind = (byte *)Mem_ReallocTagged (qcvm->knownstringskind, qcvm->maxknownstrings, MEM_TAG_PROGS);
+	// a slot can only be on the free list once, so it never needs more entries than there are slots
+	qcvm->freeknownstrings = (int *)Mem_ReallocTagged ((void *)qcvm->freeknownstrings, qcvm->maxknownstrings * sizeof (int), MEM_TAG_PROGS);
+	if (!qcvm->knownstringsmap)
+		qcvm->knownstringsmap = HashMap_Create (const char *, int, &HashPtr, NULL);
+}
+
+/*
+============
+PR_FindStringSlot
+
+Pops a free slot or appends a new one, O(1) either way
+============
+*/
+static int PR_FindStringSlot (void)
+{
+	if (qcvm->numfreeknownstrings > 0)
+		return qcvm->freeknownstrings[--qcvm->numfreeknownstrings];
+	if (qcvm->numknownstrings >= qcvm->maxknownstrings)
+		PR_AllocStringSlots ();
+	return qcvm->numknownstrings++;
+}
+
+/*
+============
+PR_ReleaseStringSlot
+============
+*/
+static void PR_ReleaseStringSlot (int num)
+{
+	HashMap_Erase (qcvm->knownstringsmap, &qcvm->knownstrings[num]);
+	if (qcvm->knownstringskind[num] == KNOWNSTRING_OWNED)
+		SAFE_FREE (qcvm->knownstrings[num]);
+	else
+		qcvm->knownstrings[num] = NULL;
+	qcvm->knownstringskind[num] = KNOWNSTRING_ENGINE;
 }
 
 const char *PR_GetString (int num)
@@ -1999,15 +2107,10 @@ void PR_ClearEngineString (int num)
 	if (num < 0 && num >= -qcvm->numknownstrings)
 	{
 		num = -1 - num;
-		if (qcvm->knownstringsowned[num])
-		{
-			SAFE_FREE (qcvm->knownstrings[num]);
-			qcvm->knownstringsowned[num] = false;
-		}
-		else
-			qcvm->knownstrings[num] = NULL;
-		if (qcvm->freeknownstrings > num)
-			qcvm->freeknownstrings = num;
+		if (!qcvm->knownstrings[num])
+			return;
+		PR_ReleaseStringSlot (num);
+		qcvm->freeknownstrings[qcvm->numfreeknownstrings++] = num;
 	}
 }
 
@@ -2024,31 +2127,19 @@ int PR_SetEngineString (const char *s)
 	if (s >= qcvm->strings && s <= qcvm->strings + qcvm->stringssize - 2)
 		return (int)(s - qcvm->strings);
 #endif
-	for (i = 0; i < qcvm->numknownstrings; i++)
+	// temp strings cycle through a fixed set of buffers, so in steady state this always hits
+	if (qcvm->knownstringsmap)
 	{
-		if (qcvm->knownstrings[i] == s)
-			return -1 - i;
+		int *slot = HashMap_Lookup (int, qcvm->knownstringsmap, &s);
+		if (slot)
+			return -1 - *slot;
 	}
 	// new unknown engine string
 	// Con_DPrintf ("PR_SetEngineString: new engine string %p\n", s);
-	for (i = qcvm->freeknownstrings;; i++)
-	{
-		if (i < qcvm->numknownstrings)
-		{
-			if (qcvm->knownstrings[i])
-				continue;
-		}
-		else
-		{
-			if (i >= qcvm->maxknownstrings)
-				PR_AllocStringSlots ();
-			qcvm->numknownstrings++;
-		}
-		break;
-	}
-	qcvm->freeknownstrings = i + 1;
+	i = PR_FindStringSlot ();
 	qcvm->knownstrings[i] = s;
-	qcvm->knownstringsowned[i] = false;
+	qcvm->knownstringskind[i] = KNOWNSTRING_ENGINE;
+	HashMap_Insert (qcvm->knownstringsmap, &s, &i);
 	return -1 - i;
 }
 
@@ -2059,40 +2150,79 @@ int PR_AllocString (int size, char **ptr)
 	if (!size)
 		return 0;
 
-	for (i = qcvm->freeknownstrings;; i++)
+	i = PR_FindStringSlot ();
+	qcvm->knownstrings[i] = (char *)Mem_AllocTagged (size, MEM_TAG_PROGS);
+	qcvm->knownstringskind[i] = KNOWNSTRING_OWNED;
+	HashMap_Insert (qcvm->knownstringsmap, &qcvm->knownstrings[i], &i);
+	if (ptr)
+		*ptr = (char *)qcvm->knownstrings[i];
+	return -1 - i;
+}
+
+/*
+============
+PR_AllocEdictString
+
+Strings parsed into edicts live until the next PR_ClearEdictStrings, so
+they are packed into large blocks instead of being allocated one by one
+============
+*/
+#define PR_STRING_BLOCKSIZE (64 * 1024)
+
+struct stringblock_s
+{
+	stringblock_t *next;
+	size_t		   used;
+	char		   data[PR_STRING_BLOCKSIZE];
+};
+
+static int PR_AllocEdictString (int size, char **ptr)
+{
+	stringblock_t *block = qcvm->stringblocks;
+	int			   i;
+
+	if (size > PR_STRING_BLOCKSIZE)
+		return PR_AllocString (size, ptr);
+
+	if (!block || block->used + size > PR_STRING_BLOCKSIZE)
 	{
-		if (i < qcvm->numknownstrings)
-		{
-			if (qcvm->knownstrings[i])
-				continue;
-		}
-		else
-		{
-			if (i >= qcvm->maxknownstrings)
-				PR_AllocStringSlots ();
-			qcvm->numknownstrings++;
-		}
-		break;
+		block = (stringblock_t *)Mem_AllocNonZeroTagged (sizeof (stringblock_t), MEM_TAG_PROGS);
+		block->next = qcvm->stringblocks;
+		block->used = 0;
+		qcvm->stringblocks = block;
 	}
-	qcvm->freeknownstrings = i + 1;
-	qcvm->knownstrings[i] = (char *)Mem_Alloc (size);
-	qcvm->knownstringsowned[i] = true;
+
+	i = PR_FindStringSlot ();
+	qcvm->knownstrings[i] = block->data + block->used;
+	qcvm->knownstringskind[i] = KNOWNSTRING_ARENA;
+	HashMap_Insert (qcvm->knownstringsmap, &qcvm->knownstrings[i], &i);
+	block->used += size;
 	if (ptr)
 		*ptr = (char *)qcvm->knownstrings[i];
 	return -1 - i;
 }
 
+static void PR_FreeStringBlocks (void)
+{
+	while (qcvm->stringblocks)
+	{
+		stringblock_t *next = qcvm->stringblocks->next;
+		Mem_Free (qcvm->stringblocks);
+		qcvm->stringblocks = next;
+	}
+}
+
 void PR_ClearEdictStrings ()
 {
-	for (int i = qcvm->progsstrings; i < qcvm->numknownstrings; ++i)
-		if (qcvm->knownstringsowned[i])
+	// arena strings can reuse slots freed below progsstrings, so check every slot for those
+	for (int i = 0; i < qcvm->numknownstrings; ++i)
+		if (qcvm->knownstringskind[i] == KNOWNSTRING_ARENA || (i >= qcvm->progsstrings && qcvm->knownstringskind[i] == KNOWNSTRING_OWNED))
 		{
-			SAFE_FREE (qcvm->knownstrings[i]);
-			qcvm->knownstringsowned[i] = false;
-		}
-
+			PR_ReleaseStringSlot (i);
 #ifndef _DEBUG
-	// do not reuse slots in debug builds to help catch stale references
-	qcvm->freeknownstrings = qcvm->progsstrings;
+			// do not reuse slots in debug builds to help catch stale references
+			qcvm->freeknownstrings[qcvm->numfreeknownstrings++] = i;
 #endif
+		}
+	PR_FreeStringBlocks ();
 }
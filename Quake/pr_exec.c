@@ -21,6 +21,28 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "quakedef.h"
 
+cvar_t pr_checkcode = {"pr_checkcode", "0", CVAR_NONE}; // run the progs statements unfused and check them against their translation
+
+// superinstructions made by PR_TranslateStatements, numbered after the progs opcodes
+enum
+{
+	OP_ADDRESS_STOREP = OP_NUMOPS, // OP_ADDRESS followed by a scalar OP_STOREP through the address
+	OP_ADDRESS_STOREP_V,		   // OP_ADDRESS followed by OP_STOREP_V through the address
+	OP_LOAD_IF,					   // scalar OP_LOAD followed by OP_IF on the loaded value
+	OP_LOAD_IFNOT,				   // scalar OP_LOAD followed by OP_IFNOT on the loaded value
+	OP_LOAD_V_STORE_V,			   // OP_LOAD_V followed by OP_STORE_V of the loaded vector
+	OP_NUMSUPEROPS				   // also stands in for every bad opcode
+};
+
+// a statement with its operands resolved, there is one per dstatement_t so that statement numbers stay the same
+struct prstatement_s
+{
+	unsigned short op;		// opcode_t or one of the superinstructions above
+	short		   branch;	// relative jump of OP_IF, OP_IFNOT and OP_GOTO
+	eval_t		  *a, *b, *c;
+	const void	  *handler; // label in PR_ExecuteProgram that runs op, with PR_COMPUTED_GOTO
+};
+
 static const char *const pr_opnames[] = {"DONE",
 
 										 "MUL_F",	 "MUL_V",	 "MUL_FV",	 "MUL_VF",
@@ -71,7 +93,7 @@ const char *PR_GlobalStringNoContents (int ofs);
 PR_PrintStatement
 =================
 */
-static void PR_PrintStatement (dstatement_t *s)
+static void PR_PrintStatement (const dstatement_t *s)
 {
 	int i;
 
@@ -180,6 +202,293 @@ void PR_Profile_f (void)
 	PR_SwitchQCVM (NULL);
 }
 
+/*
+==============================================================================
+
+TIME PROFILER
+
+==============================================================================
+*/
+
+typedef struct prprofnode_s
+{
+	int	   function;			   // into qcvm->functions, builtins have a dfunction_t too
+	int	   parent, child, sibling; // call tree, node 0 is the root
+	double self;
+} prprofnode_t;
+
+typedef struct
+{
+	int	   node;
+	double start;
+	double children; // time spent in the calls made from this frame
+} prprofframe_t;
+
+struct prprofiler_s
+{
+	double		 *self;		 // per function
+	double		 *inclusive; // per function, recursive calls are only counted once
+	int			 *calls;
+	int			 *active; // frames of each function on the stack
+	prprofnode_t *nodes;
+	int			  numnodes, maxnodes;
+	// builtins that call back into QC take a frame that qcvm->depth doesn't count
+	prprofframe_t stack[MAX_STACK_DEPTH * 2];
+	int			  depth;
+	int			  overflow; // frames that didn't fit on the stack
+	double		  start;
+};
+
+/*
+============
+PR_ProfileEnter
+============
+*/
+static void PR_ProfileEnter (prprofiler_t *prof, int fnum)
+{
+	prprofframe_t *frame;
+	prprofnode_t  *node;
+	int			   parent, i;
+
+	if (prof->depth == countof (prof->stack))
+	{
+		prof->overflow++;
+		return;
+	}
+
+	parent = prof->depth ? prof->stack[prof->depth - 1].node : 0;
+	for (i = prof->nodes[parent].child; i; i = prof->nodes[i].sibling)
+		if (prof->nodes[i].function == fnum)
+			break;
+	if (!i)
+	{
+		if (prof->numnodes == prof->maxnodes)
+		{
+			prof->maxnodes *= 2;
+			prof->nodes = (prprofnode_t *)Mem_Realloc (prof->nodes, prof->maxnodes * sizeof (prprofnode_t));
+		}
+		i = prof->numnodes++;
+		node = &prof->nodes[i];
+		node->function = fnum;
+		node->parent = parent;
+		node->child = 0;
+		node->sibling = prof->nodes[parent].child;
+		node->self = 0.0;
+		prof->nodes[parent].child = i;
+	}
+
+	prof->calls[fnum]++;
+	prof->active[fnum]++;
+	frame = &prof->stack[prof->depth++];
+	frame->node = i;
+	frame->children = 0.0;
+	frame->start = Sys_DoubleTime ();
+}
+
+/*
+============
+PR_ProfileLeave
+============
+*/
+static void PR_ProfileLeave (prprofiler_t *prof)
+{
+	prprofframe_t *frame;
+	double		   total, self;
+	int			   fnum;
+
+	if (prof->overflow)
+	{
+		prof->overflow--;
+		return;
+	}
+	if (!prof->depth)
+		return; // started in the middle of a call
+
+	frame = &prof->stack[--prof->depth];
+	total = Sys_DoubleTime () - frame->start;
+	self = total - frame->children;
+	fnum = prof->nodes[frame->node].function;
+	prof->nodes[frame->node].self += self;
+	prof->self[fnum] += self;
+	if (--prof->active[fnum] == 0)
+		prof->inclusive[fnum] += total;
+	if (prof->depth)
+		prof->stack[prof->depth - 1].children += total;
+}
+
+/*
+============
+PR_ProfileResetStack
+
+Drops the frames that a PR_RunError left behind
+============
+*/
+static void PR_ProfileResetStack (prprofiler_t *prof)
+{
+	while (prof->depth)
+		prof->active[prof->nodes[prof->stack[--prof->depth].node].function]--;
+	prof->overflow = 0;
+}
+
+/*
+============
+PR_FreeProfiler
+============
+*/
+void PR_FreeProfiler (qcvm_t *vm)
+{
+	prprofiler_t *prof = vm->profiler;
+
+	if (!prof)
+		return;
+	Mem_Free (prof->self);
+	Mem_Free (prof->inclusive);
+	Mem_Free (prof->calls);
+	Mem_Free (prof->active);
+	Mem_Free (prof->nodes);
+	Mem_Free (prof);
+	vm->profiler = NULL;
+}
+
+/*
+============
+PR_ProfileStart_f
+
+Times every function and builtin the server progs run, until profile_stop
+============
+*/
+void PR_ProfileStart_f (void)
+{
+	prprofiler_t *prof;
+	const int	  numfunctions = sv.qcvm.progs ? sv.qcvm.progs->numfunctions : 0;
+
+	if (!sv.active)
+	{
+		Con_Printf ("no server running\n");
+		return;
+	}
+
+	PR_FreeProfiler (&sv.qcvm);
+	prof = (prprofiler_t *)Mem_Alloc (sizeof (prprofiler_t));
+	prof->self = (double *)Mem_Alloc (numfunctions * sizeof (double));
+	prof->inclusive = (double *)Mem_Alloc (numfunctions * sizeof (double));
+	prof->calls = (int *)Mem_Alloc (numfunctions * sizeof (int));
+	prof->active = (int *)Mem_Alloc (numfunctions * sizeof (int));
+	prof->maxnodes = 1024;
+	prof->nodes = (prprofnode_t *)Mem_Alloc (prof->maxnodes * sizeof (prprofnode_t));
+	prof->numnodes = 1;
+	prof->start = Sys_DoubleTime ();
+	sv.qcvm.profiler = prof;
+	Con_Printf ("QC profiling started\n");
+}
+
+static const double *pr_sortkeys;
+
+static int PR_CompareProfileEntries (const void *a, const void *b)
+{
+	const double da = pr_sortkeys[*(const int *)a];
+	const double db = pr_sortkeys[*(const int *)b];
+	return (da < db) - (da > db);
+}
+
+/*
+============
+PR_PrintProfile
+
+Prints the functions or the builtins that took the most time of their own
+============
+*/
+static void PR_PrintProfile (prprofiler_t *prof, qboolean builtins)
+{
+	int *order = (int *)Mem_Alloc (qcvm->progs->numfunctions * sizeof (int));
+	int	 i, count = 0;
+
+	for (i = 0; i < qcvm->progs->numfunctions; i++)
+		if (prof->calls[i] && (qcvm->functions[i].first_statement < 0) == builtins)
+			order[count++] = i;
+	pr_sortkeys = prof->self;
+	qsort (order, count, sizeof (int), PR_CompareProfileEntries);
+
+	Con_Printf ("%s:\n  self ms   incl ms    calls\n", builtins ? "builtins" : "functions");
+	for (i = 0; i < q_min (count, 10); i++)
+	{
+		const int fnum = order[i];
+		Con_Printf (
+			"%9.2f %9.2f %8i %s\n", prof->self[fnum] * 1000.0, prof->inclusive[fnum] * 1000.0, prof->calls[fnum],
+			PR_GetString (qcvm->functions[fnum].s_name));
+	}
+	Mem_Free (order);
+}
+
+/*
+============
+PR_WriteFoldedStacks
+
+Writes a node and its children in the folded format of flamegraph.pl, in microseconds
+============
+*/
+static void PR_WriteFoldedStacks (FILE *f, prprofiler_t *prof, int node, char *path, size_t len, size_t size)
+{
+	const prprofnode_t *n = &prof->nodes[node];
+	int					i;
+
+	if (node)
+	{
+		len += q_snprintf (path + len, size - len, "%s%s", len ? ";" : "", PR_GetString (qcvm->functions[n->function].s_name));
+		len = q_min (len, size - 1);
+		if ((long long)(n->self * 1e6) > 0)
+			fprintf (f, "%s %lld\n", path, (long long)(n->self * 1e6));
+	}
+	for (i = n->child; i; i = prof->nodes[i].sibling)
+		PR_WriteFoldedStacks (f, prof, i, path, len, size);
+}
+
+/*
+============
+PR_ProfileStop_f
+
+profile_stop [file]: prints what took the most time and writes the stacks to file for flamegraph.pl
+============
+*/
+void PR_ProfileStop_f (void)
+{
+	prprofiler_t *prof = sv.qcvm.profiler;
+	char		  name[MAX_OSPATH];
+	char		 *path;
+	FILE		 *f;
+
+	if (!prof)
+	{
+		Con_Printf ("QC profiling isn't running\n");
+		return;
+	}
+
+	PR_SwitchQCVM (&sv.qcvm);
+	Con_Printf ("QC profile of %.1f seconds\n", Sys_DoubleTime () - prof->start);
+	PR_PrintProfile (prof, false);
+	PR_PrintProfile (prof, true);
+
+	if (Cmd_Argc () >= 2)
+	{
+		q_snprintf (name, sizeof (name), "%s/%s", com_gamedir, Cmd_Argv (1));
+		COM_CreatePath (name);
+		f = fopen (name, "w");
+		if (f)
+		{
+			path = (char *)Mem_Alloc (65536);
+			PR_WriteFoldedStacks (f, prof, 0, path, 0, 65536);
+			Mem_Free (path);
+			fclose (f);
+			Con_Printf ("Wrote %s\n", name);
+		}
+		else
+			Con_Printf ("ERROR: couldn't open file %s.\n", name);
+	}
+
+	PR_FreeProfiler (qcvm);
+	PR_SwitchQCVM (NULL);
+}
+
 /*
 ============
 PR_RunError
@@ -259,6 +568,8 @@ static int PR_EnterFunction (dfunction_t *f)
 	}
 
 	qcvm->xfunction = f;
+	if (qcvm->profiler)
+		PR_ProfileEnter (qcvm->profiler, f - qcvm->functions);
 	return f->first_statement - 1; // offset the s++
 }
 
@@ -283,12 +594,110 @@ static int PR_LeaveFunction (void)
 	for (i = 0; i < c; i++)
 		((int *)qcvm->globals)[qcvm->xfunction->parm_start + i] = qcvm->localstack[qcvm->localstack_used + i];
 
+	if (qcvm->profiler)
+		PR_ProfileLeave (qcvm->profiler);
+
 	// up stack
 	qcvm->depth--;
 	qcvm->xfunction = qcvm->stack[qcvm->depth].f;
 	return qcvm->stack[qcvm->depth].s;
 }
 
+/*
+====================
+PR_TranslateStatements
+
+Resolves the operands of the statements into pointers to the globals and fuses common
+statement pairs into superinstructions. The second statement of a pair keeps its own
+instruction, so branches can still land on it.
+====================
+*/
+void PR_TranslateStatements (void)
+{
+	const int numstatements = qcvm->progs->numstatements;
+	int		  i;
+
+	qcvm->code = (prstatement_t *)Mem_Alloc (numstatements * sizeof (prstatement_t));
+	for (i = 0; i < numstatements; i++)
+	{
+		const dstatement_t *s = &qcvm->statements[i];
+		prstatement_t	   *code = &qcvm->code[i];
+
+		code->op = (s->op < OP_NUMOPS) ? s->op : OP_NUMSUPEROPS;
+		code->a = (eval_t *)&qcvm->globals[(unsigned short)s->a];
+		code->b = (eval_t *)&qcvm->globals[(unsigned short)s->b];
+		code->c = (eval_t *)&qcvm->globals[(unsigned short)s->c];
+		if (s->op == OP_IF || s->op == OP_IFNOT)
+			code->branch = s->b;
+		else if (s->op == OP_GOTO)
+			code->branch = s->a;
+	}
+
+	for (i = 0; i + 1 < numstatements; i++)
+	{
+		const dstatement_t *s = &qcvm->statements[i];
+		const dstatement_t *next = s + 1;
+		prstatement_t	   *code = &qcvm->code[i];
+
+		switch (s->op)
+		{
+		case OP_ADDRESS:
+			if (next->b != s->c)
+				break;
+			if (next->op == OP_STOREP_V)
+				code->op = OP_ADDRESS_STOREP_V;
+			else if (next->op >= OP_STOREP_F && next->op <= OP_STOREP_FNC)
+				code->op = OP_ADDRESS_STOREP;
+			break;
+		case OP_LOAD_F:
+		case OP_LOAD_S:
+		case OP_LOAD_ENT:
+		case OP_LOAD_FLD:
+		case OP_LOAD_FNC:
+			if (next->a != s->c)
+				break;
+			if (next->op == OP_IF)
+				code->op = OP_LOAD_IF;
+			else if (next->op == OP_IFNOT)
+				code->op = OP_LOAD_IFNOT;
+			break;
+		case OP_LOAD_V:
+			if (next->op == OP_STORE_V && next->a == s->c)
+				code->op = OP_LOAD_V_STORE_V;
+			break;
+		}
+	}
+}
+
+/*
+====================
+PR_CheckStatement
+
+Traces and checks a statement before it runs unfused, returns the opcode to run it with
+====================
+*/
+static int PR_CheckStatement (const prstatement_t *st, qboolean checkcode)
+{
+	const dstatement_t *s = qcvm->statements + (st - qcvm->code);
+	qboolean			branch;
+
+	if (qcvm->trace)
+		PR_PrintStatement (s);
+
+	if (checkcode)
+	{
+		branch = (s->op == OP_IF || s->op == OP_IFNOT) ? (st->branch == s->b) : (s->op != OP_GOTO || st->branch == s->a);
+		if (!branch || st->a != (eval_t *)&qcvm->globals[(unsigned short)s->a] || st->b != (eval_t *)&qcvm->globals[(unsigned short)s->b] ||
+			st->c != (eval_t *)&qcvm->globals[(unsigned short)s->c])
+		{
+			qcvm->xstatement = s - qcvm->statements;
+			PR_RunError ("statement does not match its translation");
+		}
+	}
+
+	return (s->op < OP_NUMOPS) ? s->op : OP_NUMSUPEROPS;
+}
+
 /*
 ====================
 PR_ExecuteProgram
@@ -296,18 +705,49 @@ PR_ExecuteProgram
 The interpretation main loop
 ====================
 */
-#define OPA ((eval_t *)&qcvm->globals[(unsigned short)st->a])
-#define OPB ((eval_t *)&qcvm->globals[(unsigned short)st->b])
-#define OPC ((eval_t *)&qcvm->globals[(unsigned short)st->c])
+#define OPA (st->a)
+#define OPB (st->b)
+#define OPC (st->c)
+
+#define PR_RUNAWAY_LIMIT 0x1000000 // spike -- was decimal 100000, 0x10000000 in QSS
+
+// GCC and Clang jump straight from each opcode to the label of the next one, which every
+// statement keeps in its handler, so every opcode gets its own indirect branch instead of
+// sharing the switch's.
+#if defined(__GNUC__) && !defined(NO_COMPUTED_GOTO)
+#define PR_COMPUTED_GOTO
+#endif
+
+#ifdef PR_COMPUTED_GOTO
+#define OPCODE(op) op_##op
+#define NEXT                              \
+	do                                    \
+	{                                     \
+		st++;                             \
+		if (++profile > PR_RUNAWAY_LIMIT) \
+			goto runaway;                 \
+		if (checked)                      \
+			goto checked_statement;       \
+		goto *st->handler;                \
+	} while (0)
+// builtins can turn tracing on or off
+#define UPDATE_DISPATCH() checked = qcvm->trace || checkcode
+#else
+#define OPCODE(op) case op
+#define NEXT	   break
+#define UPDATE_DISPATCH()
+#endif
 
 void PR_ExecuteProgram (func_t fnum)
 {
-	eval_t		 *ptr;
-	dstatement_t *st;
-	dfunction_t	 *f, *newf;
-	int			  profile, startprofile;
-	edict_t		 *ed;
-	int			  exitdepth;
+	eval_t		  *ptr;
+	prstatement_t *st;
+	dfunction_t	  *f, *newf;
+	int			   profile, startprofile;
+	edict_t		  *ed;
+	int			   exitdepth;
+	const qboolean checkcode = pr_checkcode.value != 0;
+	qboolean	   speeds;
 
 	if (!fnum || fnum >= (func_t)qcvm->progs->numfunctions)
 	{
@@ -324,193 +764,289 @@ void PR_ExecuteProgram (func_t fnum)
 
 	// make a stack frame
 	exitdepth = qcvm->depth;
+	if (qcvm->profiler && !exitdepth)
+		PR_ProfileResetStack (qcvm->profiler);
+	speeds = sv_speeds_active && !exitdepth && qcvm == &sv.qcvm;
+	if (speeds)
+		SV_SpeedsBegin (SVSPEEDS_QC);
 
-	st = &qcvm->statements[PR_EnterFunction (f)];
+	st = &qcvm->code[PR_EnterFunction (f)];
 	startprofile = profile = 0;
 
+#ifdef PR_COMPUTED_GOTO
+	static const void *const ops[OP_NUMSUPEROPS + 1] = {
+		[0 ... OP_NUMSUPEROPS] = &&op_bad,
+		[OP_ADD_F] = &&op_OP_ADD_F,
+		[OP_ADD_V] = &&op_OP_ADD_V,
+		[OP_SUB_F] = &&op_OP_SUB_F,
+		[OP_SUB_V] = &&op_OP_SUB_V,
+		[OP_MUL_F] = &&op_OP_MUL_F,
+		[OP_MUL_V] = &&op_OP_MUL_V,
+		[OP_MUL_FV] = &&op_OP_MUL_FV,
+		[OP_MUL_VF] = &&op_OP_MUL_VF,
+		[OP_DIV_F] = &&op_OP_DIV_F,
+		[OP_BITAND] = &&op_OP_BITAND,
+		[OP_BITOR] = &&op_OP_BITOR,
+		[OP_GE] = &&op_OP_GE,
+		[OP_LE] = &&op_OP_LE,
+		[OP_GT] = &&op_OP_GT,
+		[OP_LT] = &&op_OP_LT,
+		[OP_AND] = &&op_OP_AND,
+		[OP_OR] = &&op_OP_OR,
+		[OP_NOT_F] = &&op_OP_NOT_F,
+		[OP_NOT_V] = &&op_OP_NOT_V,
+		[OP_NOT_S] = &&op_OP_NOT_S,
+		[OP_NOT_FNC] = &&op_OP_NOT_FNC,
+		[OP_NOT_ENT] = &&op_OP_NOT_ENT,
+		[OP_EQ_F] = &&op_OP_EQ_F,
+		[OP_EQ_V] = &&op_OP_EQ_V,
+		[OP_EQ_S] = &&op_OP_EQ_S,
+		[OP_EQ_E] = &&op_OP_EQ_E,
+		[OP_EQ_FNC] = &&op_OP_EQ_FNC,
+		[OP_NE_F] = &&op_OP_NE_F,
+		[OP_NE_V] = &&op_OP_NE_V,
+		[OP_NE_S] = &&op_OP_NE_S,
+		[OP_NE_E] = &&op_OP_NE_E,
+		[OP_NE_FNC] = &&op_OP_NE_FNC,
+		[OP_STORE_F] = &&op_OP_STORE_F,
+		[OP_STORE_ENT] = &&op_OP_STORE_ENT,
+		[OP_STORE_FLD] = &&op_OP_STORE_FLD,
+		[OP_STORE_S] = &&op_OP_STORE_S,
+		[OP_STORE_FNC] = &&op_OP_STORE_FNC,
+		[OP_STORE_V] = &&op_OP_STORE_V,
+		[OP_STOREP_F] = &&op_OP_STOREP_F,
+		[OP_STOREP_ENT] = &&op_OP_STOREP_ENT,
+		[OP_STOREP_FLD] = &&op_OP_STOREP_FLD,
+		[OP_STOREP_S] = &&op_OP_STOREP_S,
+		[OP_STOREP_FNC] = &&op_OP_STOREP_FNC,
+		[OP_STOREP_V] = &&op_OP_STOREP_V,
+		[OP_ADDRESS] = &&op_OP_ADDRESS,
+		[OP_LOAD_F] = &&op_OP_LOAD_F,
+		[OP_LOAD_FLD] = &&op_OP_LOAD_FLD,
+		[OP_LOAD_ENT] = &&op_OP_LOAD_ENT,
+		[OP_LOAD_S] = &&op_OP_LOAD_S,
+		[OP_LOAD_FNC] = &&op_OP_LOAD_FNC,
+		[OP_LOAD_V] = &&op_OP_LOAD_V,
+		[OP_IFNOT] = &&op_OP_IFNOT,
+		[OP_IF] = &&op_OP_IF,
+		[OP_GOTO] = &&op_OP_GOTO,
+		[OP_CALL0] = &&op_OP_CALL0,
+		[OP_CALL1] = &&op_OP_CALL1,
+		[OP_CALL2] = &&op_OP_CALL2,
+		[OP_CALL3] = &&op_OP_CALL3,
+		[OP_CALL4] = &&op_OP_CALL4,
+		[OP_CALL5] = &&op_OP_CALL5,
+		[OP_CALL6] = &&op_OP_CALL6,
+		[OP_CALL7] = &&op_OP_CALL7,
+		[OP_CALL8] = &&op_OP_CALL8,
+		[OP_DONE] = &&op_OP_DONE,
+		[OP_RETURN] = &&op_OP_RETURN,
+		[OP_STATE] = &&op_OP_STATE,
+		[OP_ADDRESS_STOREP] = &&op_OP_ADDRESS_STOREP,
+		[OP_ADDRESS_STOREP_V] = &&op_OP_ADDRESS_STOREP_V,
+		[OP_LOAD_IF] = &&op_OP_LOAD_IF,
+		[OP_LOAD_IFNOT] = &&op_OP_LOAD_IFNOT,
+		[OP_LOAD_V_STORE_V] = &&op_OP_LOAD_V_STORE_V,
+	};
+	// with tracing or pr_checkcode on, every statement goes through checked_statement first
+	qboolean checked;
+
+	if (!qcvm->code->handler)
+	{
+		for (int i = 0; i < qcvm->progs->numstatements; i++)
+			qcvm->code[i].handler = ops[qcvm->code[i].op];
+	}
+	UPDATE_DISPATCH ();
+	NEXT;
+
+checked_statement:
+	goto *ops[PR_CheckStatement (st, checkcode)];
+
+runaway:
+	qcvm->xstatement = st - qcvm->code;
+	PR_RunError ("runaway loop error");
+#else
 	while (1)
 	{
 		st++; /* next statement */
 
-		if (++profile > 0x1000000) // spike -- was decimal 100000, 0x10000000 in QSS
+		if (++profile > PR_RUNAWAY_LIMIT)
 		{
-			qcvm->xstatement = st - qcvm->statements;
+			qcvm->xstatement = st - qcvm->code;
 			PR_RunError ("runaway loop error");
 		}
 
-		if (qcvm->trace)
-			PR_PrintStatement (st);
-
-		switch (st->op)
+		switch ((qcvm->trace || checkcode) ? PR_CheckStatement (st, checkcode) : st->op)
 		{
-		case OP_ADD_F:
+#endif
+		OPCODE (OP_ADD_F):
 			OPC->_float = OPA->_float + OPB->_float;
-			break;
-		case OP_ADD_V:
+			NEXT;
+		OPCODE (OP_ADD_V):
 			OPC->vector[0] = OPA->vector[0] + OPB->vector[0];
 			OPC->vector[1] = OPA->vector[1] + OPB->vector[1];
 			OPC->vector[2] = OPA->vector[2] + OPB->vector[2];
-			break;
+			NEXT;
 
-		case OP_SUB_F:
+		OPCODE (OP_SUB_F):
 			OPC->_float = OPA->_float - OPB->_float;
-			break;
-		case OP_SUB_V:
+			NEXT;
+		OPCODE (OP_SUB_V):
 			OPC->vector[0] = OPA->vector[0] - OPB->vector[0];
 			OPC->vector[1] = OPA->vector[1] - OPB->vector[1];
 			OPC->vector[2] = OPA->vector[2] - OPB->vector[2];
-			break;
+			NEXT;
 
-		case OP_MUL_F:
+		OPCODE (OP_MUL_F):
 			OPC->_float = OPA->_float * OPB->_float;
-			break;
-		case OP_MUL_V:
+			NEXT;
+		OPCODE (OP_MUL_V):
 			OPC->_float = OPA->vector[0] * OPB->vector[0] + OPA->vector[1] * OPB->vector[1] + OPA->vector[2] * OPB->vector[2];
-			break;
-		case OP_MUL_FV:
+			NEXT;
+		OPCODE (OP_MUL_FV):
 			OPC->vector[0] = OPA->_float * OPB->vector[0];
 			OPC->vector[1] = OPA->_float * OPB->vector[1];
 			OPC->vector[2] = OPA->_float * OPB->vector[2];
-			break;
-		case OP_MUL_VF:
+			NEXT;
+		OPCODE (OP_MUL_VF):
 			OPC->vector[0] = OPB->_float * OPA->vector[0];
 			OPC->vector[1] = OPB->_float * OPA->vector[1];
 			OPC->vector[2] = OPB->_float * OPA->vector[2];
-			break;
+			NEXT;
 
-		case OP_DIV_F:
+		OPCODE (OP_DIV_F):
 			OPC->_float = OPA->_float / OPB->_float;
-			break;
+			NEXT;
 
-		case OP_BITAND:
+		OPCODE (OP_BITAND):
 			OPC->_float = (int)OPA->_float & (int)OPB->_float;
-			break;
+			NEXT;
 
-		case OP_BITOR:
+		OPCODE (OP_BITOR):
 			OPC->_float = (int)OPA->_float | (int)OPB->_float;
-			break;
+			NEXT;
 
-		case OP_GE:
+		OPCODE (OP_GE):
 			OPC->_float = OPA->_float >= OPB->_float;
-			break;
-		case OP_LE:
+			NEXT;
+		OPCODE (OP_LE):
 			OPC->_float = OPA->_float <= OPB->_float;
-			break;
-		case OP_GT:
+			NEXT;
+		OPCODE (OP_GT):
 			OPC->_float = OPA->_float > OPB->_float;
-			break;
-		case OP_LT:
+			NEXT;
+		OPCODE (OP_LT):
 			OPC->_float = OPA->_float < OPB->_float;
-			break;
-		case OP_AND:
+			NEXT;
+		OPCODE (OP_AND):
 			OPC->_float = OPA->_float && OPB->_float;
-			break;
-		case OP_OR:
+			NEXT;
+		OPCODE (OP_OR):
 			OPC->_float = OPA->_float || OPB->_float;
-			break;
+			NEXT;
 
-		case OP_NOT_F:
+		OPCODE (OP_NOT_F):
 			OPC->_float = !OPA->_float;
-			break;
-		case OP_NOT_V:
+			NEXT;
+		OPCODE (OP_NOT_V):
 			OPC->_float = !OPA->vector[0] && !OPA->vector[1] && !OPA->vector[2];
-			break;
-		case OP_NOT_S:
+			NEXT;
+		OPCODE (OP_NOT_S):
 			OPC->_float = !OPA->string || !*PR_GetString (OPA->string);
-			break;
-		case OP_NOT_FNC:
+			NEXT;
+		OPCODE (OP_NOT_FNC):
 			OPC->_float = !OPA->function;
-			break;
-		case OP_NOT_ENT:
+			NEXT;
+		OPCODE (OP_NOT_ENT):
 			OPC->_float = (PROG_TO_EDICT (OPA->edict) == qcvm->edicts);
-			break;
+			NEXT;
 
-		case OP_EQ_F:
+		OPCODE (OP_EQ_F):
 			OPC->_float = OPA->_float == OPB->_float;
-			break;
-		case OP_EQ_V:
+			NEXT;
+		OPCODE (OP_EQ_V):
 			OPC->_float = (OPA->vector[0] == OPB->vector[0]) && (OPA->vector[1] == OPB->vector[1]) && (OPA->vector[2] == OPB->vector[2]);
-			break;
-		case OP_EQ_S:
+			NEXT;
+		OPCODE (OP_EQ_S):
 			OPC->_float = !strcmp (PR_GetString (OPA->string), PR_GetString (OPB->string));
-			break;
-		case OP_EQ_E:
+			NEXT;
+		OPCODE (OP_EQ_E):
 			OPC->_float = OPA->_int == OPB->_int;
-			break;
-		case OP_EQ_FNC:
+			NEXT;
+		OPCODE (OP_EQ_FNC):
 			OPC->_float = OPA->function == OPB->function;
-			break;
+			NEXT;
 
-		case OP_NE_F:
+		OPCODE (OP_NE_F):
 			OPC->_float = OPA->_float != OPB->_float;
-			break;
-		case OP_NE_V:
+			NEXT;
+		OPCODE (OP_NE_V):
 			OPC->_float = (OPA->vector[0] != OPB->vector[0]) || (OPA->vector[1] != OPB->vector[1]) || (OPA->vector[2] != OPB->vector[2]);
-			break;
-		case OP_NE_S:
+			NEXT;
+		OPCODE (OP_NE_S):
 			OPC->_float = strcmp (PR_GetString (OPA->string), PR_GetString (OPB->string));
-			break;
-		case OP_NE_E:
+			NEXT;
+		OPCODE (OP_NE_E):
 			OPC->_float = OPA->_int != OPB->_int;
-			break;
-		case OP_NE_FNC:
+			NEXT;
+		OPCODE (OP_NE_FNC):
 			OPC->_float = OPA->function != OPB->function;
-			break;
+			NEXT;
 
-		case OP_STORE_F:
-		case OP_STORE_ENT:
-		case OP_STORE_FLD: // integers
-		case OP_STORE_S:
-		case OP_STORE_FNC: // pointers
+		OPCODE (OP_STORE_F):
+		OPCODE (OP_STORE_ENT):
+		OPCODE (OP_STORE_FLD): // integers
+		OPCODE (OP_STORE_S):
+		OPCODE (OP_STORE_FNC): // pointers
 			OPB->_int = OPA->_int;
-			break;
-		case OP_STORE_V:
+			NEXT;
+		OPCODE (OP_STORE_V):
 			OPB->vector[0] = OPA->vector[0];
 			OPB->vector[1] = OPA->vector[1];
 			OPB->vector[2] = OPA->vector[2];
-			break;
+			NEXT;
 
-		case OP_STOREP_F:
-		case OP_STOREP_ENT:
-		case OP_STOREP_FLD: // integers
-		case OP_STOREP_S:
-		case OP_STOREP_FNC: // pointers
+		OPCODE (OP_STOREP_F):
+		OPCODE (OP_STOREP_ENT):
+		OPCODE (OP_STOREP_FLD): // integers
+		OPCODE (OP_STOREP_S):
+		OPCODE (OP_STOREP_FNC): // pointers
 			ptr = (eval_t *)((byte *)qcvm->edicts + OPB->_int);
 			ptr->_int = OPA->_int;
-			break;
-		case OP_STOREP_V:
+			NEXT;
+		OPCODE (OP_STOREP_V):
 			ptr = (eval_t *)((byte *)qcvm->edicts + OPB->_int);
 			ptr->vector[0] = OPA->vector[0];
 			ptr->vector[1] = OPA->vector[1];
 			ptr->vector[2] = OPA->vector[2];
-			break;
+			NEXT;
 
-		case OP_ADDRESS:
+		OPCODE (OP_ADDRESS):
 			ed = PROG_TO_EDICT (OPA->edict);
 #ifdef PARANOID
 			NUM_FOR_EDICT (ed); // Make sure it's in range
 #endif
 			if (ed == (edict_t *)qcvm->edicts && sv.state == ss_active)
 			{
-				qcvm->xstatement = st - qcvm->statements;
+				qcvm->xstatement = st - qcvm->code;
 				PR_RunError ("assignment to world entity");
 			}
 			OPC->_int = (byte *)((int *)&ed->v + OPB->_int) - (byte *)qcvm->edicts;
-			break;
+			NEXT;
 
-		case OP_LOAD_F:
-		case OP_LOAD_FLD:
-		case OP_LOAD_ENT:
-		case OP_LOAD_S:
-		case OP_LOAD_FNC:
+		OPCODE (OP_LOAD_F):
+		OPCODE (OP_LOAD_FLD):
+		OPCODE (OP_LOAD_ENT):
+		OPCODE (OP_LOAD_S):
+		OPCODE (OP_LOAD_FNC):
 			ed = PROG_TO_EDICT (OPA->edict);
 #ifdef PARANOID
 			NUM_FOR_EDICT (ed); // Make sure it's in range
 #endif
 			OPC->_int = ((eval_t *)((int *)&ed->v + OPB->_int))->_int;
-			break;
+			NEXT;
 
-		case OP_LOAD_V:
+		OPCODE (OP_LOAD_V):
 			ed = PROG_TO_EDICT (OPA->edict);
 #ifdef PARANOID
 			NUM_FOR_EDICT (ed); // Make sure it's in range
@@ -519,34 +1055,34 @@ void PR_ExecuteProgram (func_t fnum)
 			OPC->vector[0] = ptr->vector[0];
 			OPC->vector[1] = ptr->vector[1];
 			OPC->vector[2] = ptr->vector[2];
-			break;
+			NEXT;
 
-		case OP_IFNOT:
+		OPCODE (OP_IFNOT):
 			if (!OPA->_int)
-				st += st->b - 1; /* -1 to offset the st++ */
-			break;
+				st += st->branch - 1; /* -1 to offset the st++ */
+			NEXT;
 
-		case OP_IF:
+		OPCODE (OP_IF):
 			if (OPA->_int)
-				st += st->b - 1; /* -1 to offset the st++ */
-			break;
-
-		case OP_GOTO:
-			st += st->a - 1; /* -1 to offset the st++ */
-			break;
-
-		case OP_CALL0:
-		case OP_CALL1:
-		case OP_CALL2:
-		case OP_CALL3:
-		case OP_CALL4:
-		case OP_CALL5:
-		case OP_CALL6:
-		case OP_CALL7:
-		case OP_CALL8:
+				st += st->branch - 1; /* -1 to offset the st++ */
+			NEXT;
+
+		OPCODE (OP_GOTO):
+			st += st->branch - 1; /* -1 to offset the st++ */
+			NEXT;
+
+		OPCODE (OP_CALL0):
+		OPCODE (OP_CALL1):
+		OPCODE (OP_CALL2):
+		OPCODE (OP_CALL3):
+		OPCODE (OP_CALL4):
+		OPCODE (OP_CALL5):
+		OPCODE (OP_CALL6):
+		OPCODE (OP_CALL7):
+		OPCODE (OP_CALL8):
 			qcvm->xfunction->profile += profile - startprofile;
 			startprofile = profile;
-			qcvm->xstatement = st - qcvm->statements;
+			qcvm->xstatement = st - qcvm->code;
 			qcvm->argc = st->op - OP_CALL0;
 			if (!OPA->function)
 				PR_RunError ("NULL function");
@@ -556,41 +1092,117 @@ void PR_ExecuteProgram (func_t fnum)
 				int i = -newf->first_statement;
 				if (i >= qcvm->numbuiltins)
 					i = 0; // just invoke the fixme builtin.
-				qcvm->builtins[i]();
-				break;
+				if (qcvm->profiler)
+				{
+					PR_ProfileEnter (qcvm->profiler, newf - qcvm->functions);
+					qcvm->builtins[i]();
+					if (qcvm->profiler)
+						PR_ProfileLeave (qcvm->profiler);
+				}
+				else
+					qcvm->builtins[i]();
+				UPDATE_DISPATCH ();
+				NEXT;
 			}
 			// Normal function
-			st = &qcvm->statements[PR_EnterFunction (newf)];
-			break;
+			st = &qcvm->code[PR_EnterFunction (newf)];
+			NEXT;
 
-		case OP_DONE:
-		case OP_RETURN:
+		OPCODE (OP_DONE):
+		OPCODE (OP_RETURN):
 			qcvm->xfunction->profile += profile - startprofile;
 			startprofile = profile;
-			qcvm->xstatement = st - qcvm->statements;
-			qcvm->globals[OFS_RETURN] = qcvm->globals[(unsigned short)st->a];
-			qcvm->globals[OFS_RETURN + 1] = qcvm->globals[(unsigned short)st->a + 1];
-			qcvm->globals[OFS_RETURN + 2] = qcvm->globals[(unsigned short)st->a + 2];
-			st = &qcvm->statements[PR_LeaveFunction ()];
+			qcvm->xstatement = st - qcvm->code;
+			qcvm->globals[OFS_RETURN] = OPA->vector[0];
+			qcvm->globals[OFS_RETURN + 1] = OPA->vector[1];
+			qcvm->globals[OFS_RETURN + 2] = OPA->vector[2];
+			st = &qcvm->code[PR_LeaveFunction ()];
 			if (qcvm->depth == exitdepth)
 			{ // Done
+				if (speeds)
+					SV_SpeedsEnd ();
 				return;
 			}
-			break;
+			NEXT;
 
-		case OP_STATE:
+		OPCODE (OP_STATE):
 			ed = PROG_TO_EDICT (pr_global_struct->self);
 			ed->v.nextthink = pr_global_struct->time + 0.1;
 			ed->v.frame = OPA->_float;
 			ed->v.think = OPB->function;
-			break;
+			NEXT;
 
+		// superinstructions, each one runs its own statement and then the next one, through st[1]'s operands
+		OPCODE (OP_ADDRESS_STOREP):
+		OPCODE (OP_ADDRESS_STOREP_V):
+			ed = PROG_TO_EDICT (OPA->edict);
+#ifdef PARANOID
+			NUM_FOR_EDICT (ed); // Make sure it's in range
+#endif
+			if (ed == (edict_t *)qcvm->edicts && sv.state == ss_active)
+			{
+				qcvm->xstatement = st - qcvm->code;
+				PR_RunError ("assignment to world entity");
+			}
+			ptr = (eval_t *)((int *)&ed->v + OPB->_int);
+			OPC->_int = (byte *)ptr - (byte *)qcvm->edicts;
+			if (st->op == OP_ADDRESS_STOREP_V)
+			{
+				ptr->vector[0] = st[1].a->vector[0];
+				ptr->vector[1] = st[1].a->vector[1];
+				ptr->vector[2] = st[1].a->vector[2];
+			}
+			else
+				ptr->_int = st[1].a->_int;
+			st++;
+			profile++;
+			NEXT;
+
+		OPCODE (OP_LOAD_IF):
+		OPCODE (OP_LOAD_IFNOT):
+			ed = PROG_TO_EDICT (OPA->edict);
+#ifdef PARANOID
+			NUM_FOR_EDICT (ed); // Make sure it's in range
+#endif
+			OPC->_int = ((eval_t *)((int *)&ed->v + OPB->_int))->_int;
+			if ((OPC->_int != 0) == (st->op == OP_LOAD_IF))
+				st += st[1].branch; // branch relative to the OP_IF, -1 to offset the st++
+			else
+				st++;
+			profile++;
+			NEXT;
+
+		OPCODE (OP_LOAD_V_STORE_V):
+			ed = PROG_TO_EDICT (OPA->edict);
+#ifdef PARANOID
+			NUM_FOR_EDICT (ed); // Make sure it's in range
+#endif
+			ptr = (eval_t *)((int *)&ed->v + OPB->_int);
+			OPC->vector[0] = ptr->vector[0];
+			OPC->vector[1] = ptr->vector[1];
+			OPC->vector[2] = ptr->vector[2];
+			st[1].b->vector[0] = OPC->vector[0];
+			st[1].b->vector[1] = OPC->vector[1];
+			st[1].b->vector[2] = OPC->vector[2];
+			st++;
+			profile++;
+			NEXT;
+
+#ifdef PR_COMPUTED_GOTO
+		op_bad:
+#else
 		default:
-			qcvm->xstatement = st - qcvm->statements;
-			PR_RunError ("Bad opcode %i", st->op);
+#endif
+			qcvm->xstatement = st - qcvm->code;
+			PR_RunError ("Bad opcode %i", qcvm->statements[st - qcvm->code].op);
+#ifndef PR_COMPUTED_GOTO
 		}
 	} /* end of while(1) loop */
+#endif
 }
+#undef NEXT
+#undef OPCODE
+#undef UPDATE_DISPATCH
 #undef OPA
 #undef OPB
 #undef OPC
@@ -3036,6 +3036,7 @@ struct strbuf
 	char	   **strings;
 	unsigned int used;
 	unsigned int allocated;
+	unsigned int firsthole; // every string below this index is set
 };
 
 #define BUFSTRBASE	  1
@@ -3059,6 +3060,7 @@ static void PF_buf_shutdown (void)
 		strbuflist[bufno].strings = NULL;
 		strbuflist[bufno].used = 0;
 		strbuflist[bufno].allocated = 0;
+		strbuflist[bufno].firsthole = 0;
 	}
 }
 
@@ -3087,6 +3089,7 @@ static void PF_buf_create (void)
 			strbuflist[i].owningvm = qcvm;
 			strbuflist[i].used = 0;
 			strbuflist[i].allocated = 0;
+			strbuflist[i].firsthole = 0;
 			strbuflist[i].strings = NULL;
 			G_FLOAT (OFS_RETURN) = i + BUFSTRBASE;
 			return;
@@ -3115,6 +3118,7 @@ static void PF_buf_del (void)
 	strbuflist[bufno].strings = NULL;
 	strbuflist[bufno].used = 0;
 	strbuflist[bufno].allocated = 0;
+	strbuflist[bufno].firsthole = 0;
 
 	strbuflist[bufno].owningvm = NULL;
 }
@@ -3156,6 +3160,7 @@ static void PF_buf_copy (void)
 
 	// copy new data over.
 	strbuflist[bufto].used = strbuflist[bufto].allocated = strbuflist[buffrom].used;
+	strbuflist[bufto].firsthole = strbuflist[buffrom].firsthole;
 	strbuflist[bufto].strings = Mem_Alloc (strbuflist[buffrom].used * sizeof (char *));
 	for (i = 0; i < strbuflist[buffrom].used; i++)
 		strbuflist[bufto].strings[i] = strbuflist[buffrom].strings[i] ? q_strdup (strbuflist[buffrom].strings[i]) : NULL;
@@ -3197,6 +3202,7 @@ static void PF_buf_sort (void)
 		strings[d++] = strings[s++];
 	}
 	strbuflist[bufno].used = d;
+	strbuflist[bufno].firsthole = d;
 
 	// no nulls now, sort it.
 	PF_buf_sort_sortprefixlen = sortprefixlen; // eww, a global. burn in hell.
@@ -3298,33 +3304,43 @@ static void PF_bufstr_get (void)
 	else
 		G_INT (OFS_RETURN) = 0;
 }
+static void PF_bufstr_store (unsigned int bufno, unsigned int index, const char *string)
+{
+	struct strbuf *buf = &strbuflist[bufno];
+	size_t		   len = strlen (string) + 1;
+
+	// expand it if needed
+	if (index >= buf->allocated)
+	{
+		unsigned int oldcount = buf->allocated;
+		buf->allocated = (index + 256);
+		buf->strings = Mem_Realloc (buf->strings, buf->allocated * sizeof (char *));
+		memset (buf->strings + oldcount, 0, (buf->allocated - oldcount) * sizeof (char *));
+	}
+
+	// mods tend to write the same value back every frame, don't churn the allocator for that
+	if (buf->strings[index] && !strcmp (buf->strings[index], string))
+		return;
+	buf->strings[index] = Mem_Realloc (buf->strings[index], len);
+	memcpy (buf->strings[index], string, len);
+
+	if (index >= buf->used)
+		buf->used = index + 1;
+}
+
 // #447 void(float bufhandle, float string_index, string str) bufstr_set (DP_QC_STRINGBUFFERS)
 static void PF_bufstr_set (void)
 {
 	unsigned int bufno = G_FLOAT (OFS_PARM0) - BUFSTRBASE;
 	unsigned int index = G_FLOAT (OFS_PARM1);
 	const char	*string = G_STRING (OFS_PARM2);
-	unsigned int oldcount;
 
 	if ((unsigned int)bufno >= NUMSTRINGBUFS)
 		return;
 	if (!strbuflist[bufno].owningvm)
 		return;
 
-	if (index >= strbuflist[bufno].allocated)
-	{
-		oldcount = strbuflist[bufno].allocated;
-		strbuflist[bufno].allocated = (index + 256);
-		strbuflist[bufno].strings = Mem_Realloc (strbuflist[bufno].strings, strbuflist[bufno].allocated * sizeof (char *));
-		memset (strbuflist[bufno].strings + oldcount, 0, (strbuflist[bufno].allocated - oldcount) * sizeof (char *));
-	}
-	if (strbuflist[bufno].strings[index])
-		Mem_Free (strbuflist[bufno].strings[index]);
-	strbuflist[bufno].strings[index] = Mem_Alloc (strlen (string) + 1);
-	strcpy (strbuflist[bufno].strings[index], string);
-
-	if (index >= strbuflist[bufno].used)
-		strbuflist[bufno].used = index + 1;
+	PF_bufstr_store (bufno, index, string);
 }
 
 static int PF_bufstr_add_internal (unsigned int bufno, const char *string, int appendonend)
@@ -3337,31 +3353,14 @@ static int PF_bufstr_add_internal (unsigned int bufno, const char *string, int a
 	}
 	else
 	{
-		// find a hole
-		for (index = 0; index < strbuflist[bufno].used; index++)
+		// find a hole, nothing below firsthole can be one
+		for (index = strbuflist[bufno].firsthole; index < strbuflist[bufno].used; index++)
 			if (!strbuflist[bufno].strings[index])
 				break;
+		strbuflist[bufno].firsthole = index + 1;
 	}
 
-	// expand it if needed
-	if (index >= strbuflist[bufno].allocated)
-	{
-		unsigned int oldcount;
-		oldcount = strbuflist[bufno].allocated;
-		strbuflist[bufno].allocated = (index + 256);
-		strbuflist[bufno].strings = Mem_Realloc (strbuflist[bufno].strings, strbuflist[bufno].allocated * sizeof (char *));
-		memset (strbuflist[bufno].strings + oldcount, 0, (strbuflist[bufno].allocated - oldcount) * sizeof (char *));
-	}
-
-	// add in the new string.
-	if (strbuflist[bufno].strings[index])
-		Mem_Free (strbuflist[bufno].strings[index]);
-	strbuflist[bufno].strings[index] = Mem_Alloc (strlen (string) + 1);
-	strcpy (strbuflist[bufno].strings[index], string);
-
-	if (index >= strbuflist[bufno].used)
-		strbuflist[bufno].used = index + 1;
-
+	PF_bufstr_store (bufno, index, string);
 	return index;
 }
 
@@ -3396,6 +3395,8 @@ static void PF_bufstr_free (void)
 	if (strbuflist[bufno].strings[index])
 		Mem_Free (strbuflist[bufno].strings[index]);
 	strbuflist[bufno].strings[index] = NULL;
+	if (index < strbuflist[bufno].firsthole)
+		strbuflist[bufno].firsthole = index;
 }
 
 static void PF_buf_cvarlist (void)
@@ -3419,7 +3420,8 @@ static void PF_buf_cvarlist (void)
 			Mem_Free (strbuflist[bufno].strings[i]);
 	if (strbuflist[bufno].strings)
 		Mem_Free (strbuflist[bufno].strings);
-	strbuflist[bufno].used = strbuflist[bufno].allocated = 0;
+	strbuflist[bufno].used = strbuflist[bufno].allocated = strbuflist[bufno].firsthole = 0;
+	strbuflist[bufno].strings = NULL;
 
 	for (var = Cvar_FindVarAfter ("", CVAR_NONE); var; var = var->next)
 	{
@@ -3431,6 +3433,7 @@ static void PF_buf_cvarlist (void)
 		PF_bufstr_add_internal (bufno, var->name, true);
 	}
 
+	PF_buf_sort_sortprefixlen = 0x7fffffff;
 	qsort (strbuflist[bufno].strings, strbuflist[bufno].used, sizeof (char *), PF_buf_sort_ascending);
 }
 
@@ -3455,7 +3458,11 @@ static void PF_copyentity (void)
 }
 static void PF_edict_for_num (void)
 {
-	G_INT (OFS_RETURN) = EDICT_TO_PROG (EDICT_NUM (G_FLOAT (OFS_PARM0)));
+	int		 num = G_FLOAT (OFS_PARM0);
+	edict_t *ed = EDICT_NUM (num);
+	// the qc may read fields of edicts that were never spawned
+	ED_CommitEdicts (num + 1);
+	G_INT (OFS_RETURN) = EDICT_TO_PROG (ed);
 }
 static void PF_num_for_edict (void)
 {
@@ -4468,16 +4475,25 @@ static struct
 	char		 name[MAX_QPATH];
 	unsigned int flags;
 	qpic_t		*pic;
-}			 *qcpics;
-static size_t numqcpics;
-static size_t maxqcpics;
-void		  PR_ReloadPics (qboolean purge)
+}				  *qcpics;
+static size_t	   numqcpics;
+static size_t	   maxqcpics;
+static hash_map_t *qcpics_map; // name -> index into qcpics
+void			   PR_ReloadPics (qboolean purge)
 {
 	numqcpics = 0;
 
 	Mem_Free (qcpics);
 	qcpics = NULL;
 	maxqcpics = 0;
+
+	if (qcpics_map)
+	{
+		for (uint32_t i = 0; i < HashMap_Size (qcpics_map); ++i)
+			Mem_Free (*HashMap_GetKey (char *, qcpics_map, i));
+		HashMap_Destroy (qcpics_map);
+		qcpics_map = NULL;
+	}
 }
 #define PICFLAG_AUTO   0		 // value used when no flags known
 #define PICFLAG_WAD	   (1u << 0) // name matches that of a wad lump
@@ -4487,16 +4503,15 @@ void		  PR_ReloadPics (qboolean purge)
 #define PICFLAG_NOLOAD (1u << 31)
 static qpic_t *DrawQC_CachePic (const char *picname, unsigned int flags)
 { // okay, so this is silly. we've ended up with 3 different cache levels. qcpics, pics, and images.
-	size_t		 i;
+	size_t		 i = numqcpics;
 	unsigned int texflags;
-	for (i = 0; i < numqcpics; i++)
-	{ // binary search? something more sane?
-		if (!strcmp (picname, qcpics[i].name))
-		{
-			if (qcpics[i].pic)
-				return qcpics[i].pic;
-			break;
-		}
+	// csqc huds look pics up by name for every draw call, so don't strcmp the whole list
+	size_t *index = qcpics_map ? HashMap_Lookup (size_t, qcpics_map, &picname) : NULL;
+	if (index)
+	{
+		i = *index;
+		if (qcpics[i].pic)
+			return qcpics[i].pic;
 	}
 
 	if (strlen (picname) >= MAX_QPATH)
@@ -4535,7 +4550,13 @@ static qpic_t *DrawQC_CachePic (const char *picname, unsigned int flags)
 		qcpics[i].pic = Draw_TryCachePic (picname, texflags);
 
 	if (i == numqcpics)
+	{
+		char *name = q_strdup (picname);
+		if (!qcpics_map)
+			qcpics_map = HashMap_Create (char *, size_t, &HashStr, &HashStrCmp);
+		HashMap_Insert (qcpics_map, &name, &i);
 		numqcpics++;
+	}
 
 	return qcpics[i].pic;
 }
@@ -4549,10 +4570,6 @@ static void			DrawQC_CharacterQuad (cb_context_t *cbx, float x, float y, int num
 	qboolean alpha_blend = alpha < 1.0f;
 	size = 0.0624; // avoid rounding errors...
 
-	VkBuffer	   buffer;
-	VkDeviceSize   buffer_offset;
-	basicvertex_t *vertices = (basicvertex_t *)R_VertexAllocate (6 * sizeof (basicvertex_t), &buffer, &buffer_offset);
-
 	basicvertex_t corner_verts[4];
 	memset (&corner_verts, 255, sizeof (corner_verts));
 
@@ -4588,21 +4605,15 @@ static void			DrawQC_CharacterQuad (cb_context_t *cbx, float x, float y, int num
 		corner_verts[i].color[3] = alpha * 255.0f;
 	}
 
+	const vulkan_pipeline_t pipeline =
+		alpha_blend ? vulkan_globals.basic_blend_pipeline[cbx->render_pass_index] : vulkan_globals.basic_alphatest_pipeline[cbx->render_pass_index];
+	basicvertex_t *vertices = Draw_AddQuad (cbx, pipeline, char_texture);
 	vertices[0] = corner_verts[0];
 	vertices[1] = corner_verts[1];
 	vertices[2] = corner_verts[2];
 	vertices[3] = corner_verts[2];
 	vertices[4] = corner_verts[3];
 	vertices[5] = corner_verts[0];
-
-	vulkan_globals.vk_cmd_bind_vertex_buffers (cbx->cb, 0, 1, &buffer, &buffer_offset);
-	if (alpha_blend)
-		R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.basic_blend_pipeline[cbx->render_pass_index]);
-	else
-		R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.basic_alphatest_pipeline[cbx->render_pass_index]);
-	vulkan_globals.vk_cmd_bind_descriptor_sets (
-		cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.basic_pipeline_layout.handle, 0, 1, &char_texture->descriptor_set, 0, NULL);
-	vulkan_globals.vk_cmd_draw (cbx->cb, 6, 1, 0, 0);
 }
 static void PF_cl_drawcharacter (void)
 {
@@ -4701,6 +4712,7 @@ static void PF_cl_drawsetclip (void)
 	render_area.offset.y = y;
 	render_area.extent.width = w;
 	render_area.extent.height = h;
+	Draw_Flush (vulkan_globals.secondary_cb_contexts[SCBX_GUI]);
 	vkCmdSetScissor (vulkan_globals.secondary_cb_contexts[SCBX_GUI][0].cb, 0, 1, &render_area);
 }
 static void PF_cl_drawresetclip (void)
@@ -4710,6 +4722,7 @@ static void PF_cl_drawresetclip (void)
 	render_area.offset.y = 0;
 	render_area.extent.width = vid.width;
 	render_area.extent.height = vid.height;
+	Draw_Flush (vulkan_globals.secondary_cb_contexts[SCBX_GUI]);
 	vkCmdSetScissor (vulkan_globals.secondary_cb_contexts[SCBX_GUI][0].cb, 0, 1, &render_area);
 }
 
@@ -4776,10 +4789,6 @@ static void PF_cl_drawfill (void)
 	float *rgb = G_VECTOR (OFS_PARM2);
 	float  alpha = G_FLOAT (OFS_PARM3);
 
-	VkBuffer	   buffer;
-	VkDeviceSize   buffer_offset;
-	basicvertex_t *vertices = (basicvertex_t *)R_VertexAllocate (6 * sizeof (basicvertex_t), &buffer, &buffer_offset);
-
 	basicvertex_t corner_verts[4];
 	memset (&corner_verts, 255, sizeof (corner_verts));
 
@@ -4807,19 +4816,14 @@ static void PF_cl_drawfill (void)
 		corner_verts[i].color[3] = alpha * 255.0f;
 	}
 
+	cb_context_t  *cbx = vulkan_globals.secondary_cb_contexts[SCBX_GUI];
+	basicvertex_t *vertices = Draw_AddQuad (cbx, vulkan_globals.basic_notex_blend_pipeline[cbx->render_pass_index], NULL);
 	vertices[0] = corner_verts[0];
 	vertices[1] = corner_verts[1];
 	vertices[2] = corner_verts[2];
 	vertices[3] = corner_verts[2];
 	vertices[4] = corner_verts[3];
 	vertices[5] = corner_verts[0];
-
-	cb_context_t *cbx = vulkan_globals.secondary_cb_contexts[SCBX_GUI];
-	vulkan_globals.vk_cmd_bind_vertex_buffers (cbx->cb, 0, 1, &buffer, &buffer_offset);
-	R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.basic_notex_blend_pipeline[cbx->render_pass_index]);
-	vulkan_globals.vk_cmd_bind_descriptor_sets (
-		cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.basic_pipeline_layout.handle, 0, 1, &char_texture->descriptor_set, 0, NULL);
-	vulkan_globals.vk_cmd_draw (cbx->cb, 6, 1, 0, 0);
 }
 
 void PF_cl_playerkey_internal (int player, const char *key, qboolean retfloat)
@@ -4976,13 +4980,14 @@ static void PF_checkpvs (void)
 	float	*org = G_VECTOR (OFS_PARM0);
 	edict_t *ed = G_EDICT (OFS_PARM1);
 
-	mleaf_t		*leaf = Mod_PointInLeaf (org, qcvm->worldmodel);
-	byte		*pvs = Mod_LeafPVS (leaf, qcvm->worldmodel); // johnfitz -- worldmodel as a parameter
-	unsigned int i;
+	mleaf_t			   *leaf = Mod_PointInLeaf (org, qcvm->worldmodel);
+	byte			   *pvs = Mod_LeafPVS (leaf, qcvm->worldmodel); // johnfitz -- worldmodel as a parameter
+	const edictleafs_t *leafs = EDICT_LEAFS (ed);
+	unsigned int		i;
 
-	for (i = 0; i < ed->num_leafs; i++)
+	for (i = 0; i < leafs->num_leafs; i++)
 	{
-		if (pvs[ed->leafnums[i] >> 3] & (1 << (ed->leafnums[i] & 7)))
+		if (pvs[leafs->leafnums[i] >> 3] & (1 << (leafs->leafnums[i] & 7)))
 		{
 			G_FLOAT (OFS_RETURN) = true;
 			return;
@@ -41,12 +41,22 @@ typedef union eval_s
 } eval_t;
 
 #define MAX_ENT_LEAFS 32
-typedef struct edict_s
+// kept in qcvm->edictleafs by edict number rather than in the edict, so the network code can
+// test every edict against a pvs without touching the edicts themselves
+typedef struct edictleafs_s
 {
-	link_t area; /* linked to a division node or leaf */
-
 	unsigned int num_leafs;
 	int			 leafnums[MAX_ENT_LEAFS];
+} edictleafs_t;
+
+typedef struct edict_s
+{
+	link_t	 area;		  /* linked to a division node or leaf */
+	link_t	*arealist;	  /* trigger or solid list of the areanode area is linked into */
+	vec3_t	 leafmins;	  /* absmin and absmax the edictleafs were last found for */
+	vec3_t	 leafmaxs;
+	qboolean leafs_valid; /* edictleafs holds the leafs of leafmins/leafmaxs */
+	qboolean leafs_model; /* the leafs were found with a modelindex */
 
 	entity_state_t baseline;
 	unsigned char  alpha;		 /* johnfitz -- hack to support alpha since it's not part of entvars_t */
@@ -58,23 +68,29 @@ typedef struct edict_s
 
 	float	 freetime; /* sv.time when the object was freed */
 	qboolean free;
+	link_t	 freelink; /* linked in the free-list while free */
 
 	entvars_t v; /* C exported fields from progs */
 
 	/* other fields from progs come immediately after */
 } edict_t;
 
-#define EDICT_FROM_AREA(l) STRUCT_FROM_LINK (l, edict_t, area)
+#define EDICT_FROM_AREA(l)	   STRUCT_FROM_LINK (l, edict_t, area)
+#define EDICT_FROM_FREELINK(l) STRUCT_FROM_LINK (l, edict_t, freelink)
+#define EDICT_LEAFS(e)		   (&qcvm->edictleafs[NUM_FOR_EDICT (e)])
 
 //============================================================================
 
 typedef void (*builtin_t) (void);
 
-typedef struct qcvm_s qcvm_t;
+typedef struct qcvm_s		 qcvm_t;
+typedef struct prstatement_s prstatement_t;
+typedef struct prprofiler_s	 prprofiler_t;
 
 void PR_Init (void);
 
 void	 PR_ExecuteProgram (func_t fnum);
+void	 PR_TranslateStatements (void);
 void	 PR_ClearProgs (qcvm_t *vm);
 qboolean PR_LoadProgs (const char *filename, qboolean fatal, unsigned int needcrc, const builtin_t *builtins, size_t numbuiltins);
 
@@ -98,6 +114,8 @@ const char	*PR_UglyValueString (int type, eval_t *val);
 ddef_t		*ED_FindField (const char *name);
 ddef_t		*ED_FindGlobal (const char *name);
 dfunction_t *ED_FindFunction (const char *fn_name);
+ddef_t		*ED_FieldAtOfs (int ofs);
+string_t	 ED_NewString (const char *string);
 
 const char *PR_GetString (int num);
 int			PR_SetEngineString (const char *s);
@@ -106,11 +124,16 @@ void		PR_ClearEdictStrings ();
 void		PR_ClearEngineString (int num);
 
 void PR_Profile_f (void);
+void PR_ProfileStart_f (void);
+void PR_ProfileStop_f (void);
+void PR_FreeProfiler (qcvm_t *vm);
 
+void	 ED_AllocEdicts (int max_edicts);
+void	 ED_CommitEdicts (int num);
 edict_t *ED_Alloc (void);
 void	 ED_Free (edict_t *ed);
 void	 ED_RemoveFromFreeList (edict_t *ed);
-void	 ED_RebuildFreeList (bool force_free_reuse);
+void	 ED_RebuildFreeList (void);
 
 void		ED_Print (edict_t *ed);
 void		ED_Write (FILE *f, edict_t *ed);
@@ -323,23 +346,34 @@ typedef struct areanode_s
 
 typedef struct hash_map_s hash_map_t;
 
-// the free-list of edicts, as a FIFO made of a circular buffer.
+// who owns the memory a known string slot points at
+typedef enum
+{
+	KNOWNSTRING_ENGINE, // not owned by the vm
+	KNOWNSTRING_OWNED,	// allocated for this slot alone, freed with it
+	KNOWNSTRING_ARENA,	// packed into the edict string arena, freed with all edict strings
+} knownstring_kind_t;
+
+typedef struct stringblock_s stringblock_t;
+
+// the free-list of edicts, as a FIFO linked through the edicts.
+// edicts are appended as they are freed, so it stays sorted by freetime.
 typedef struct freelist_s
 {
-	size_t	 size;		 // current nb of edicts
-	size_t	 head_index; // index of the first valid element (head of FIFO)
-	edict_t *circular_buffer[MAX_EDICTS];
+	size_t size;   // current nb of edicts
+	link_t edicts; // next is the head of the FIFO, prev its tail. zeroed with the qcvm, set up on first use
 } freelist_t;
 
 struct qcvm_s
 {
-	dprograms_t	 *progs;
-	dfunction_t	 *functions;
-	hash_map_t	 *function_map;
-	dstatement_t *statements;
-	float		 *globals;	 /* same as pr_global_struct */
-	ddef_t		 *fielddefs; // yay reflection.
-	hash_map_t	 *fielddefs_map;
+	dprograms_t	  *progs;
+	dfunction_t	  *functions;
+	hash_map_t	  *function_map;
+	dstatement_t  *statements;
+	prstatement_t *code;	  // statements as run by PR_ExecuteProgram
+	float		  *globals;	  /* same as pr_global_struct */
+	ddef_t		  *fielddefs; // yay reflection.
+	hash_map_t	  *fielddefs_map;
 
 	int edict_size; /* in bytes */
 
@@ -348,9 +382,10 @@ struct qcvm_s
 
 	int argc;
 
-	qboolean	 trace;
-	dfunction_t *xfunction;
-	int			 xstatement;
+	qboolean	  trace;
+	dfunction_t	 *xfunction;
+	int			  xstatement;
+	prprofiler_t *profiler; // time profiler, while profile_start is running
 
 	unsigned short progscrc;  // crc16 of the entire file
 	unsigned int   progshash; // folded file md4
@@ -364,16 +399,19 @@ struct qcvm_s
 	char		*strings;
 	int			 stringssize;
 	const char **knownstrings;
-	qboolean	*knownstringsowned;
+	byte		*knownstringskind; // knownstring_kind_t
 	int			 maxknownstrings;
 	int			 numknownstrings;
 	int			 progsstrings; // allocated by PR_MergeEngineFieldDefs (), not tied to edicts
-	int			 freeknownstrings;
+	int			*freeknownstrings;
+	int			 numfreeknownstrings;
+	hash_map_t	*knownstringsmap; // string pointer -> slot
 	ddef_t		*globaldefs;
 	hash_map_t	*globaldefs_map;
 
 	unsigned char *knownzone;
 	size_t		   knownzonesize;
+	stringblock_t *stringblocks; // edict string arena, newest block first
 
 	// originally defined in pr_exec, but moved into the switchable qcvm struct
 #define MAX_STACK_DEPTH 1024 /*was 64*/ /* was 32 */
@@ -390,7 +428,9 @@ struct qcvm_s
 	int				 num_edicts;
 	int				 reserved_edicts;
 	int				 max_edicts;
-	edict_t			*edicts; // can NOT be array indexed, because edict_t is variable sized, but can be used to reference the world ent
+	int				 committed_edicts; // edicts and edictleafs are only backed by memory below this, see ED_CommitEdicts
+	edict_t			*edicts;		   // can NOT be array indexed, because edict_t is variable sized, but can be used to reference the world ent
+	edictleafs_t	*edictleafs;	   // max_edicts of them
 	freelist_t		 free_list;
 	struct qmodel_s *worldmodel;
 	struct qmodel_s *(*GetModel) (int modelindex); // returns the model for the given index, or null.
@@ -48,12 +48,15 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #define PEXT1_SUPPORTED_SERVER	(PEXT1_CSQC) // pext1 flags that we accept from clients.
 #define PEXT1_ACCEPTED_CLIENT	(PEXT1_SUPPORTED_CLIENT)
 // PROTOCOL_FTE_PEXT2 flags
-#define PEXT2_PRYDONCURSOR		0x00000001								   // a mouse cursor exposed to ssqc
-#define PEXT2_VOICECHAT			0x00000002								   //+voip or cl_voip_send 1; requires opus dll, and others to also have that same dll.
-#define PEXT2_REPLACEMENTDELTAS 0x00000008								   // more compact entity deltas (can also be split across multiple packets)
-#define PEXT2_PREDINFO			0x00000020								   // provides input acks and reworks stats such that clc_clientdata becomes redundant.
-#define PEXT2_SUPPORTED_CLIENT	(PEXT2_REPLACEMENTDELTAS | PEXT2_PREDINFO) // pext2 flags that we understand+support
-#define PEXT2_SUPPORTED_SERVER	(PEXT2_REPLACEMENTDELTAS | PEXT2_PREDINFO)
+#define PEXT2_PRYDONCURSOR		0x00000001 // a mouse cursor exposed to ssqc
+#define PEXT2_VOICECHAT			0x00000002 //+voip or cl_voip_send 1; requires opus dll, and others to also have that same dll.
+#define PEXT2_REPLACEMENTDELTAS 0x00000008 // more compact entity deltas (can also be split across multiple packets)
+#define PEXT2_PREDINFO			0x00000020 // provides input acks and reworks stats such that clc_clientdata becomes redundant.
+#define PEXT2_VARINTDELTAS		0x20000000 // vkquake: replacement deltas send frame/model/effects and wide origins as varints, origins relative to the baseline
+#define PEXT2_COMPRESSEDSIGNON	0x40000000 // vkquake: prespawn data arrives as one deflated stream in svcvk_signonchunk messages
+// pext2 flags that we understand+support
+#define PEXT2_SUPPORTED_CLIENT	(PEXT2_REPLACEMENTDELTAS | PEXT2_PREDINFO | PEXT2_VARINTDELTAS | PEXT2_COMPRESSEDSIGNON)
+#define PEXT2_SUPPORTED_SERVER	(PEXT2_REPLACEMENTDELTAS | PEXT2_PREDINFO | PEXT2_VARINTDELTAS | PEXT2_COMPRESSEDSIGNON)
 #define PEXT2_ACCEPTED_CLIENT	(PEXT2_SUPPORTED_CLIENT | PEXT2_PRYDONCURSOR | PEXT2_VOICECHAT) // pext2 flags that we can parse, but don't want to advertise
 
 // if the high bit of the servercmd is set, the low bits are fast update flags:
@@ -333,6 +336,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #define svcfte_updateentities	86
 // spike -- end
 
+#define svcvk_signonchunk 100 // [long] inflated size [long] deflated size [long] offset [long] length [bytes], PEXT2_COMPRESSEDSIGNON only
+
 //
 // client to server
 //
@@ -47,6 +47,7 @@ typedef struct sfx_s
 {
 	char		name[MAX_QPATH];
 	sfxcache_t *cache;
+	uint32_t	lastused; /* S_LoadSound stamp for S_TrimSoundCache	*/
 } sfx_t;
 
 typedef struct
@@ -59,6 +60,7 @@ typedef struct
 	int			   signed8; /* device opened for S8 format? (e.g. Amiga AHI) */
 	int			   speed;
 	unsigned char *buffer;
+	int			   ondemand; /* the driver mixes from its callback with S_PaintOnDemand */
 } dma_t;
 
 /* !!! if this is changed, it must be changed in asm_i386.h too !!! */
@@ -99,13 +101,16 @@ void S_StopAllSounds (qboolean clear, qboolean keep_statics);
 void S_ClearBuffer (void);
 void S_Update (vec3_t origin, vec3_t forward, vec3_t right, vec3_t up);
 void S_ExtraUpdate (void);
+void S_PaintOnDemand (int frames);
 void S_ClearAll (void);
+void S_ClearMap (void);
 
 void S_BlockSound (void);
 void S_UnblockSound (void);
 
 sfx_t *S_PrecacheSound (const char *sample);
 void   S_TouchSound (const char *sample);
+void   S_PrefetchSound (const char *sample);
 void   S_ClearPrecache (void);
 void   S_BeginPrecaching (void);
 void   S_EndPrecaching (void);
@@ -164,6 +169,28 @@ extern int soundtime;
 extern int paintedtime;
 extern int s_rawend;
 
+/* snd_speeds statistics, published about once a second by the mixer */
+typedef struct
+{
+	int	   updates;		   /* mixer updates in the last period		*/
+	double mix_ms;		   /* average paint time per update, filters included */
+	double mix_peak_ms;	   /* longest paint in the last period		*/
+	double filter_ms;	   /* average lowpass and underwater filter time	*/
+	double music_ms;	   /* music decoding time in the last period	*/
+	int	   voices;		   /* channels that were mixed			*/
+	int	   virtual_voices; /* channels that were only advanced		*/
+	int	   underruns;	   /* times the device caught up with the mix	*/
+	double latency_ms;	   /* mixed audio ahead of the device when the last sound started */
+	double mixahead_ms;	   /* how far ahead of the device the mixer paints	*/
+} snd_stats_t;
+
+extern snd_stats_t snd_stats;
+extern uint64_t	   snd_filterticks;
+extern cvar_t	   snd_speeds;
+extern cvar_t	   snd_lowlatency;
+
+void S_AddMusicDecodeTime (uint64_t ticks);
+
 extern vec3_t listener_origin;
 extern vec3_t listener_forward;
 extern vec3_t listener_right;
@@ -182,6 +209,9 @@ extern cvar_t bgmvolume;
 
 void		S_LocalSound (const char *name);
 sfxcache_t *S_LoadSound (sfx_t *s);
+void		S_PrecacheSoundLater (sfx_t *s);
+void		S_FinishPrecaching (void);
+void		S_TrimSoundCache (const sfx_t *keep);
 
 wavinfo_t GetWavinfo (const char *name, byte *wav, int wavlength);
 
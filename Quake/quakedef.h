@@ -62,7 +62,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #define SDL_TryWaitSemaphore(sem) (SDL_SemTryWait (sem) == 0)
 #define SDL_WaitSemaphore		  SDL_SemWait
 
-#define SDL_GetNumLogicalCPUCores SDL_GetCPUCount
+#define SDL_GetNumLogicalCPUCores	 SDL_GetCPUCount
+#define SDL_SetCurrentThreadPriority SDL_SetThreadPriority
 #endif
 
 #define Q_UNUSED(x) (x = x) // for pesky compiler / lint warnings
@@ -173,7 +174,7 @@ typedef enum
 #define WARPIMAGESIZE 512
 #define WARPIMAGEMIPS 5
 
-#define DOUBLE_BUFFERED 2
+#define MAX_FRAMES_IN_FLIGHT 3 // see vid_framesinflight
 
 typedef struct
 {
@@ -320,8 +321,8 @@ static inline int FindLastBitNonZero64 (const uint64_t mask)
 #include "gl_model.h"
 #include "world.h"
 
-#include "image.h"	   //johnfitz
 #include "gl_texmgr.h" //johnfitz
+#include "image.h"	   //johnfitz
 #include "input.h"
 #include "keys.h"
 #include "menu.h"
@@ -332,6 +333,7 @@ static inline int FindLastBitNonZero64 (const uint64_t mask)
 #include "tasks.h"
 #include "atomics.h"
 #include "hash_map.h"
+#include "bench.h"
 
 //=============================================================================
 
@@ -347,6 +349,8 @@ extern qboolean noclip_anglehack;
 extern quakeparms_t *host_parms;
 
 extern cvar_t sys_ticrate;
+extern cvar_t sys_packetwake;
+extern cvar_t host_maxfps;
 extern cvar_t sys_nostdout;
 extern cvar_t developer;
 extern cvar_t max_edicts; // johnfitz
@@ -383,11 +387,14 @@ void			   Host_ClientCommands (const char *fmt, ...) FUNC_PRINTF (1, 2);
 void			   Host_ShutdownServer (qboolean crash);
 void			   Host_WriteConfiguration (void);
 void			   Host_Resetdemos (void);
-
-void ExtraMaps_Init (void);
-void Modlist_Init (void);
-void DemoList_Init (void);
-void SaveList_Init (void);
+void			   Host_SavegameUpdate (qboolean wait);
+
+void	 ExtraMaps_Init (void);
+void	 Modlist_Init (void);
+void	 Modlist_Refresh (void);
+qboolean Modlist_PollRefresh (void);
+void	 DemoList_Init (void);
+void	 SaveList_Init (void);
 
 void ExtraMaps_NewGame (void);
 void DemoList_Rebuild (void);
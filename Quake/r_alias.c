@@ -27,6 +27,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 extern cvar_t r_drawflat, gl_fullbrights, r_lerpmodels, r_lerpmove, r_showtris; // johnfitz
 extern cvar_t r_lerpturn;
+extern cvar_t r_aliasinstancing;
+extern cvar_t r_aliaslod;
 extern cvar_t cl_gun_fovscale;
 
 // up to 16 color translated skins
@@ -62,6 +64,16 @@ typedef struct
 	uint32_t joints_offsets[2];
 } md5ubo_t;
 
+// Array element of the instanced UBO in alias.inc, padded to the std140 array stride
+#define MAX_ALIAS_INSTANCES 146
+typedef struct
+{
+	aliasubo_t ubo;
+	uint32_t   padding[3];
+} aliasinstanceubo_t;
+COMPILE_TIME_ASSERT (aliasinstanceubo_t, sizeof (aliasinstanceubo_t) == 112);
+COMPILE_TIME_ASSERT (max_alias_instances, MAX_ALIAS_INSTANCES * sizeof (aliasinstanceubo_t) <= 16384);
+
 /*
 =============
 GLARB_GetXYZOffset
@@ -76,6 +88,19 @@ static VkDeviceSize GLARB_GetXYZOffset (entity_t *e, aliashdr_t *hdr, int pose)
 	return hdr->numverts_vbo * pose * sizeof (meshxyz_t) + xyzoffs;
 }
 
+/*
+=============
+R_AliasLODForEntity
+
+e is NULL for models that aren't entities, they always use the full mesh
+=============
+*/
+static const aliaslod_t *R_AliasLODForEntity (entity_t *e, aliashdr_t *hdr)
+{
+	const entity_render_state_t *state = e ? R_GetEntityRenderState (e) : NULL;
+	return &hdr->lods[state ? q_min (state->lod, hdr->numlods - 1) : 0];
+}
+
 /*
 =============
 GL_DrawAliasFrame -- ericw
@@ -113,7 +138,7 @@ static void GL_DrawAliasFrame (
 		//  blendEnable = VK_FALSE;
 		//
 		//  has_alpha = none, alphatest = 1 ? => 1
-		//  alias_alphatest_frag_module ON
+		//  use_alpha_test specialization ON
 		//  depthWriteEnable = VK_TRUE;
 		//  blendEnable = VK_FALSE;
 		//
@@ -122,7 +147,7 @@ static void GL_DrawAliasFrame (
 		//  blendEnable = VK_FALSE => VK_TRUE;
 		//
 		//  has_alpha = yes, alphatest = 1 ?  => 3
-		//  alias_alphatest_frag_module ON
+		//  use_alpha_test specialization ON
 		//  depthWriteEnable = VK_FALSE;
 		//  blendEnable = VK_TRUE;
 		pipeline_index = ((has_alpha ? 2 : 0) + (alphatest ? 1 : 0));
@@ -161,6 +186,8 @@ static void GL_DrawAliasFrame (
 
 	R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
 
+	const aliaslod_t *lod = R_AliasLODForEntity (e, paliashdr);
+
 	float blend;
 
 	if (lerpdata.pose1 != lerpdata.pose2)
@@ -202,7 +229,7 @@ static void GL_DrawAliasFrame (
 		vulkan_globals.vk_cmd_bind_vertex_buffers (cbx->cb, 0, 3, vertex_buffers, vertex_offsets);
 		vulkan_globals.vk_cmd_bind_index_buffer (cbx->cb, paliashdr->index_buffer, 0, VK_INDEX_TYPE_UINT16);
 
-		vulkan_globals.vk_cmd_draw_indexed (cbx->cb, paliashdr->numindexes, 1, 0, 0, 0);
+		vulkan_globals.vk_cmd_draw_indexed (cbx->cb, lod->numindexes, 1, lod->firstindex, 0, 0);
 		break;
 	}
 	case PV_MD5:
@@ -233,7 +260,7 @@ static void GL_DrawAliasFrame (
 		vulkan_globals.vk_cmd_bind_index_buffer (cbx->cb, paliashdr->index_buffer, 0, VK_INDEX_TYPE_UINT16);
 
 		//
-		vulkan_globals.vk_cmd_draw_indexed (cbx->cb, paliashdr->numindexes, 1, 0, 0, 0);
+		vulkan_globals.vk_cmd_draw_indexed (cbx->cb, lod->numindexes, 1, lod->firstindex, 0, 0);
 		break;
 	}
 	default:
@@ -241,6 +268,130 @@ static void GL_DrawAliasFrame (
 	}
 }
 
+/*
+=================
+R_AddAliasInstance
+
+Instead of drawing an opaque surface, records it so it's drawn by R_DrawAliasBatch with its peers
+=================
+*/
+static void R_AddAliasInstance (
+	cb_context_t *cbx, alias_batch_t *batch, aliashdr_t *hdr, int lod, lerpdata_t lerpdata, gltexture_t *tx, gltexture_t *fb, float model_matrix[16],
+	qboolean alphatest, vec3_t shadevector, vec3_t lightcolor)
+{
+	if (batch->num_instances == batch->max_instances)
+		R_DrawAliasBatch (cbx, batch);
+
+	alias_instance_t *instance = &batch->instances[batch->num_instances++];
+	instance->hdr = hdr;
+	instance->tx = tx;
+	instance->fb = fb;
+	instance->pose1 = lerpdata.pose1;
+	instance->pose2 = lerpdata.pose2;
+	instance->alphatest = alphatest;
+	instance->lod = lod;
+	instance->blend = (lerpdata.pose1 != lerpdata.pose2) ? lerpdata.blend : 0.0f;
+	memcpy (instance->model_matrix, model_matrix, 16 * sizeof (float));
+	VectorCopy (shadevector, instance->shadevector);
+	VectorCopy (lightcolor, instance->lightcolor);
+}
+
+/*
+=================
+R_CompareAliasInstances
+=================
+*/
+static int R_CompareAliasInstances (const void *a, const void *b)
+{
+	const alias_instance_t *lhs = (const alias_instance_t *)a;
+	const alias_instance_t *rhs = (const alias_instance_t *)b;
+	if (lhs->hdr != rhs->hdr)
+		return ((uintptr_t)lhs->hdr < (uintptr_t)rhs->hdr) ? -1 : 1;
+	if (lhs->tx != rhs->tx)
+		return ((uintptr_t)lhs->tx < (uintptr_t)rhs->tx) ? -1 : 1;
+	if (lhs->fb != rhs->fb)
+		return ((uintptr_t)lhs->fb < (uintptr_t)rhs->fb) ? -1 : 1;
+	if (lhs->pose1 != rhs->pose1)
+		return lhs->pose1 - rhs->pose1;
+	if (lhs->pose2 != rhs->pose2)
+		return lhs->pose2 - rhs->pose2;
+	if (lhs->lod != rhs->lod)
+		return lhs->lod - rhs->lod;
+	return lhs->alphatest - rhs->alphatest;
+}
+
+/*
+=================
+R_DrawAliasBatch
+
+Sorts the recorded surfaces and issues one instanced draw per surface, skin and pose pair
+=================
+*/
+void R_DrawAliasBatch (cb_context_t *cbx, alias_batch_t *batch)
+{
+	if (batch->num_instances == 0)
+		return;
+
+	qsort (batch->instances, batch->num_instances, sizeof (alias_instance_t), R_CompareAliasInstances);
+
+	uint32_t base_flags = 0;
+	if (r_fullbright_cheatsafe || (r_lightmap_cheatsafe && r_fullbright.value))
+		base_flags |= 0x2;
+
+	for (int first = 0; first < batch->num_instances;)
+	{
+		const alias_instance_t *group = &batch->instances[first];
+		int						count = 1;
+		while ((first + count) < batch->num_instances && (count < MAX_ALIAS_INSTANCES) &&
+			   (R_CompareAliasInstances (group, &batch->instances[first + count]) == 0))
+			++count;
+
+		aliashdr_t	*hdr = group->hdr;
+		gltexture_t *tx = group->tx;
+		gltexture_t *fb = group->fb;
+		uint32_t	 flags = base_flags | ((fb != NULL) ? 0x1 : 0x0);
+		if (hdr->poseverttype == PV_QUAKE3)
+			flags |= 0x4;
+
+		const vulkan_pipeline_t pipeline = vulkan_globals.alias_instanced_pipelines[group->alphatest ? 1 : 0];
+		R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+
+		VkBuffer			uniform_buffer;
+		uint32_t			uniform_offset;
+		VkDescriptorSet		ubo_set;
+		aliasinstanceubo_t *ubos =
+			(aliasinstanceubo_t *)R_UniformAllocate (count * sizeof (aliasinstanceubo_t), &uniform_buffer, &uniform_offset, &ubo_set);
+		for (int i = 0; i < count; ++i)
+		{
+			const alias_instance_t *instance = &group[i];
+			aliasubo_t			   *ubo = &ubos[i].ubo;
+			memcpy (ubo->model_matrix, instance->model_matrix, 16 * sizeof (float));
+			memcpy (ubo->shade_vector, instance->shadevector, 3 * sizeof (float));
+			ubo->blend_factor = instance->blend;
+			memcpy (ubo->light_color, instance->lightcolor, 3 * sizeof (float));
+			ubo->entalpha = 1.0f;
+			ubo->flags = flags;
+		}
+
+		VkDescriptorSet descriptor_sets[3] = {tx->descriptor_set, (fb != NULL) ? fb->descriptor_set : tx->descriptor_set, ubo_set};
+		vulkan_globals.vk_cmd_bind_descriptor_sets (
+			cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.layout.handle, 0, 3, descriptor_sets, 1, &uniform_offset);
+
+		VkBuffer	 vertex_buffers[3] = {hdr->vertex_buffer, hdr->vertex_buffer, hdr->vertex_buffer};
+		VkDeviceSize vertex_offsets[3] = {
+			(unsigned)hdr->vbostofs, GLARB_GetXYZOffset (NULL, hdr, group->pose1), GLARB_GetXYZOffset (NULL, hdr, group->pose2)};
+		vulkan_globals.vk_cmd_bind_vertex_buffers (cbx->cb, 0, 3, vertex_buffers, vertex_offsets);
+		vulkan_globals.vk_cmd_bind_index_buffer (cbx->cb, hdr->index_buffer, 0, VK_INDEX_TYPE_UINT16);
+
+		const aliaslod_t *lod = &hdr->lods[group->lod];
+		vulkan_globals.vk_cmd_draw_indexed (cbx->cb, lod->numindexes, count, lod->firstindex, 0, 0);
+
+		first += count;
+	}
+
+	batch->num_instances = 0;
+}
+
 /*
 =================
 R_UpdateEntityAnimState
@@ -449,10 +600,12 @@ void R_GetEntityLerpedTransform (entity_t *e, vec3_t out_origin, vec3_t out_angl
 
 /*
 =================
-R_SetupAliasLighting -- johnfitz -- broken out from R_DrawAliasModel and rewritten
+R_SetupAliasLightingAt
+
+Lighting of an alias model at origin, minlight is the lowest sum of the color channels
 =================
 */
-static void R_SetupAliasLighting (entity_t *e, vec3_t *shadevector, vec3_t *lightcolor)
+static void R_SetupAliasLightingAt (vec3_t origin, float yaw, qmodel_t *model, lightcache_t *cache, float minlight, vec3_t *shadevector, vec3_t *lightcolor)
 {
 	vec3_t dist;
 	float  add;
@@ -463,43 +616,27 @@ static void R_SetupAliasLighting (entity_t *e, vec3_t *shadevector, vec3_t *ligh
 	// if the initial trace is completely black, try again from above
 	// this helps with models whose origin is slightly below ground level
 	// (e.g. some of the candles in the DOTM start map)
-	if (!R_LightPoint (e->origin, 0.f, &e->lightcache, lightcolor))
-		R_LightPoint (e->origin, e->model->maxs[2] * 0.5f, &e->lightcache, lightcolor);
+	if (!R_LightPoint (origin, 0.f, cache, lightcolor))
+		R_LightPoint (origin, model->maxs[2] * 0.5f, cache, lightcolor);
 
 	// add dlights
 	for (i = 0; i < MAX_DLIGHTS; i++)
 	{
 		if (cl_dlights[i].die >= cl.time)
 		{
-			VectorSubtract (e->origin, cl_dlights[i].origin, dist);
+			VectorSubtract (origin, cl_dlights[i].origin, dist);
 			add = cl_dlights[i].radius - VectorLength (dist);
 			if (add > 0)
 				VectorMA (*lightcolor, add, cl_dlights[i].color, *lightcolor);
 		}
 	}
 
-	// minimum light value on gun (24)
-	if (e == &cl.viewent)
+	add = minlight - ((*lightcolor)[0] + (*lightcolor)[1] + (*lightcolor)[2]);
+	if (add > 0.0f)
 	{
-		add = 72.0f - ((*lightcolor)[0] + (*lightcolor)[1] + (*lightcolor)[2]);
-		if (add > 0.0f)
-		{
-			(*lightcolor)[0] += add / 3.0f;
-			(*lightcolor)[1] += add / 3.0f;
-			(*lightcolor)[2] += add / 3.0f;
-		}
-	}
-
-	// minimum light value on players (8)
-	if (e > cl.entities && e <= cl.entities + cl.maxclients)
-	{
-		add = 24.0f - ((*lightcolor)[0] + (*lightcolor)[1] + (*lightcolor)[2]);
-		if (add > 0.0f)
-		{
-			(*lightcolor)[0] += add / 3.0f;
-			(*lightcolor)[1] += add / 3.0f;
-			(*lightcolor)[2] += add / 3.0f;
-		}
+		(*lightcolor)[0] += add / 3.0f;
+		(*lightcolor)[1] += add / 3.0f;
+		(*lightcolor)[2] += add / 3.0f;
 	}
 
 	// clamp lighting so it doesn't overbright as much (96)
@@ -507,7 +644,7 @@ static void R_SetupAliasLighting (entity_t *e, vec3_t *shadevector, vec3_t *ligh
 	if (add < 1.0f)
 		VectorScale ((*lightcolor), add, (*lightcolor));
 
-	quantizedangle = ((int)(e->angles[1] * (SHADEDOT_QUANT / 360.0))) & (SHADEDOT_QUANT - 1);
+	quantizedangle = ((int)(yaw * (SHADEDOT_QUANT / 360.0))) & (SHADEDOT_QUANT - 1);
 
 	// ericw -- shadevector is passed to the shader to compute shadedots inside the
 	// shader, see GLAlias_CreateShaders()
@@ -523,38 +660,84 @@ static void R_SetupAliasLighting (entity_t *e, vec3_t *shadevector, vec3_t *ligh
 
 /*
 =================
-R_DrawAliasModel -- johnfitz -- almost completely rewritten
+R_SetupAliasLighting -- johnfitz -- broken out from R_DrawAliasModel and rewritten
 =================
 */
-void R_DrawAliasModel (cb_context_t *cbx, entity_t *e, int *aliaspolys)
+static void R_SetupAliasLighting (entity_t *e, vec3_t *shadevector, vec3_t *lightcolor)
 {
-	aliashdr_t	*paliashdr;
-	int			 anim, skinnum = e->skinnum;
-	gltexture_t *tx, *fb;
-	lerpdata_t	 lerpdata;
+	float minlight = 0.0f;
+	if (e == &cl.viewent)
+		minlight = 72.0f; // minimum light value on gun (24)
+	else if (e > cl.entities && e <= cl.entities + cl.maxclients)
+		minlight = 24.0f; // minimum light value on players (8)
 
-	//
-	// setup pose/lerp data -- do it first so we don't miss updates due to culling
-	//
-	paliashdr = (aliashdr_t *)Mod_Extradata_CheckSkin (e->model, skinnum);
+	R_SetupAliasLightingAt (e->origin, e->angles[1], e->model, &e->lightcache, minlight, shadevector, lightcolor);
+}
 
-	qboolean alphatest = !!(e->model->flags & MF_HOLEY);
+/*
+=================
+R_SetupAliasModelMatrix
+=================
+*/
+static void R_SetupAliasModelMatrix (float model_matrix[16], aliashdr_t *paliashdr, vec3_t origin, vec3_t angles, unsigned char scale, float fovscale)
+{
+	IdentityMatrix (model_matrix);
+	R_RotateForEntity (model_matrix, origin, angles, scale);
 
-	R_SetupAliasFrame (e, paliashdr, e->frame, &lerpdata);
-	R_GetEntityLerpedTransform (e, lerpdata.origin, lerpdata.angles);
+	float translation_matrix[16];
+	TranslationMatrix (translation_matrix, paliashdr->scale_origin[0], paliashdr->scale_origin[1] * fovscale, paliashdr->scale_origin[2] * fovscale);
+	MatrixMultiply (model_matrix, translation_matrix);
 
-	//
-	// cull it
-	//
-	if (R_CullModelForEntity (e))
-		return;
+	float scale_matrix[16];
+	ScaleMatrix (scale_matrix, paliashdr->scale[0], paliashdr->scale[1] * fovscale, paliashdr->scale[2] * fovscale);
+	MatrixMultiply (model_matrix, scale_matrix);
+}
 
-	//
-	// transform it
-	//
-	float model_matrix[16];
-	IdentityMatrix (model_matrix);
-	R_RotateForEntity (model_matrix, lerpdata.origin, lerpdata.angles, e->netstate.scale);
+/*
+=================
+R_AliasLODLevel
+
+Picks a level from the projected height of the model bounds, the thresholds are in pixels
+=================
+*/
+static int R_AliasLODLevel (entity_t *e, vec3_t origin)
+{
+	if (r_aliaslod.value <= 0.0f)
+		return 0;
+
+	vec3_t extents;
+	for (int i = 0; i < 3; ++i)
+		extents[i] = q_max (fabsf (e->model->mins[i]), fabsf (e->model->maxs[i]));
+	const float radius = VectorLength (extents) * ENTSCALE_DECODE (e->netstate.scale);
+
+	vec3_t delta;
+	VectorSubtract (origin, r_refdef.vieworg, delta);
+	const float dist = VectorLength (delta);
+	if (dist <= radius)
+		return 0;
+
+	const float pixels = radius * r_refdef.vrect.height / (dist * tanf (DEG2RAD (r_refdef.fov_y) * 0.5f));
+	if (pixels < 16.0f * r_aliaslod.value)
+		return 2;
+	if (pixels < 48.0f * r_aliaslod.value)
+		return 1;
+	return 0;
+}
+
+/*
+=================
+R_SetupAliasRenderState
+
+Computes pose/lerp data, the full model matrix and the lighting of an alias entity.
+Entity animation and movement state must already be updated for this frame.
+=================
+*/
+void R_SetupAliasRenderState (entity_t *e, entity_render_state_t *state)
+{
+	aliashdr_t *paliashdr = (aliashdr_t *)Mod_Extradata_CheckSkin (e->model, e->skinnum);
+
+	R_SetupAliasFrame (e, paliashdr, e->frame, &state->lerpdata);
+	R_GetEntityLerpedTransform (e, state->lerpdata.origin, state->lerpdata.angles);
 
 	float fovscale = 1.0f;
 	if (e == &cl.viewent && r_refdef.basefov > 90.f && cl_gun_fovscale.value)
@@ -563,30 +746,28 @@ void R_DrawAliasModel (cb_context_t *cbx, entity_t *e, int *aliaspolys)
 		fovscale = 1.f + (fovscale - 1.f) * cl_gun_fovscale.value;
 	}
 
-	float translation_matrix[16];
-	TranslationMatrix (translation_matrix, paliashdr->scale_origin[0], paliashdr->scale_origin[1] * fovscale, paliashdr->scale_origin[2] * fovscale);
-	MatrixMultiply (model_matrix, translation_matrix);
+	R_SetupAliasModelMatrix (state->model_matrix, paliashdr, state->lerpdata.origin, state->lerpdata.angles, e->netstate.scale, fovscale);
+	state->lod = (e == &cl.viewent) ? 0 : R_AliasLODLevel (e, state->lerpdata.origin);
 
-	float scale_matrix[16];
-	ScaleMatrix (scale_matrix, paliashdr->scale[0], paliashdr->scale[1] * fovscale, paliashdr->scale[2] * fovscale);
-	MatrixMultiply (model_matrix, scale_matrix);
+	// The light point traces run here in the parallel render state tasks instead of serially while recording the
+	// entity command buffers. Culled entities skip them, R_DrawAliasModel would throw the result away.
+	if (!state->culled)
+		R_SetupAliasLighting (e, &state->shadevector, &state->lightcolor);
+}
 
-	//
-	// set up for alpha blending
-	//
-	float entalpha;
-	if (r_lightmap_cheatsafe)
-		entalpha = 1;
-	else
-		entalpha = ENTALPHA_DECODE (e->alpha);
-	if (entalpha == 0)
-		return;
+/*
+=================
+R_DrawAliasSurfaces
 
-	//
-	// set up lighting
-	//
-	vec3_t shadevector, lightcolor;
-	R_SetupAliasLighting (e, &shadevector, &lightcolor);
+Draws each surface of the alias model, e is NULL for models that aren't entities
+=================
+*/
+static void R_DrawAliasSurfaces (
+	cb_context_t *cbx, entity_t *e, qmodel_t *model, aliashdr_t *paliashdr, int skinnum, lerpdata_t lerpdata, float model_matrix[16], float entalpha,
+	qboolean alphatest, vec3_t shadevector, vec3_t lightcolor, int *aliaspolys, alias_batch_t *batch)
+{
+	int			 anim;
+	gltexture_t *tx, *fb;
 
 	// Draw each surface of the model independently:
 	for (aliashdr_t *hdr = paliashdr; hdr != NULL; hdr = hdr->nextsurface)
@@ -597,14 +778,14 @@ void R_DrawAliasModel (cb_context_t *cbx, entity_t *e, int *aliaspolys)
 		anim = (int)(cl.time * 10) & 3;
 		if ((skinnum >= hdr->numskins) || (skinnum < 0))
 		{
-			Con_DPrintf ("R_DrawAliasModel: no such skin # %d for '%s'\n", skinnum, e->model->name);
+			Con_DPrintf ("R_DrawAliasModel: no such skin # %d for '%s'\n", skinnum, model->name);
 			// ericw -- display skin 0 for winquake compatibility
 			skinnum = 0;
 		}
 		tx = hdr->gltextures[skinnum][anim];
 		fb = hdr->fbtextures[skinnum][anim];
 
-		if (e->colormap != vid.colormap && !gl_nocolors.value)
+		if (e && e->colormap != vid.colormap && !gl_nocolors.value)
 			if ((uintptr_t)e >= (uintptr_t)&cl.entities[1] && (uintptr_t)e <= (uintptr_t)&cl.entities[cl.maxclients] && playertextures[e - cl.entities - 1])
 				tx = playertextures[e - cl.entities - 1];
 
@@ -639,13 +820,64 @@ void R_DrawAliasModel (cb_context_t *cbx, entity_t *e, int *aliaspolys)
 		//
 		// draw it
 		//
-		GL_DrawAliasFrame (cbx, e, hdr, lerpdata, tx, fb, model_matrix, entalpha, alphatest, shadevector, lightcolor, false);
+		const aliaslod_t *lod = R_AliasLODForEntity (e, hdr);
+		if (batch && (entalpha >= 1.0f) && !(tx->flags & TEXPREF_ALPHAPIXELS) && (hdr->poseverttype != PV_MD5))
+			R_AddAliasInstance (cbx, batch, hdr, (int)(lod - hdr->lods), lerpdata, tx, fb, model_matrix, alphatest, shadevector, lightcolor);
+		else
+			GL_DrawAliasFrame (cbx, e, hdr, lerpdata, tx, fb, model_matrix, entalpha, alphatest, shadevector, lightcolor, false);
 
 		// update polycounts
-		*aliaspolys += hdr->numtris;
+		*aliaspolys += lod->numindexes / 3;
 	} // e for each surface
 }
 
+/*
+=================
+R_DrawAliasModel -- johnfitz -- almost completely rewritten
+=================
+*/
+void R_DrawAliasModel (cb_context_t *cbx, entity_t *e, int *aliaspolys, alias_batch_t *batch)
+{
+	aliashdr_t *paliashdr;
+
+	//
+	// pose/lerp data and transform were set up by R_SetupEntityRenderStates
+	//
+	paliashdr = (aliashdr_t *)Mod_Extradata_CheckSkin (e->model, e->skinnum);
+
+	qboolean alphatest = !!(e->model->flags & MF_HOLEY);
+
+	entity_render_state_t *state = R_GetEntityRenderState (e);
+	lerpdata_t			   lerpdata = state->lerpdata;
+	float				  *model_matrix = state->model_matrix;
+
+	//
+	// cull it
+	//
+	if (state->culled)
+		return;
+
+	//
+	// set up for alpha blending
+	//
+	float entalpha;
+	if (r_lightmap_cheatsafe)
+		entalpha = 1;
+	else
+		entalpha = ENTALPHA_DECODE (e->alpha);
+	if (entalpha == 0)
+		return;
+
+	//
+	// lighting was set up by R_SetupEntityRenderStates
+	//
+	vec3_t shadevector, lightcolor;
+	VectorCopy (state->shadevector, shadevector);
+	VectorCopy (state->lightcolor, lightcolor);
+
+	R_DrawAliasSurfaces (cbx, e, e->model, paliashdr, e->skinnum, lerpdata, model_matrix, entalpha, alphatest, shadevector, lightcolor, aliaspolys, batch);
+}
+
 // johnfitz -- values for shadow matrix
 #define SHADOW_SKEW_X -0.7 // skew along x axis. -0.7 to mimic glquake shadows
 #define SHADOW_SKEW_Y 0	   // skew along y axis. 0 to mimic glquake shadows
@@ -661,49 +893,122 @@ R_DrawAliasModel_ShowTris -- johnfitz
 void R_DrawAliasModel_ShowTris (cb_context_t *cbx, entity_t *e)
 {
 	aliashdr_t *paliashdr;
-	lerpdata_t	lerpdata;
 
-	//
-	// setup pose/lerp data -- do it first so we don't miss updates due to culling
-	//
 	paliashdr = (aliashdr_t *)Mod_Extradata_CheckSkin (e->model, e->skinnum);
 
-	R_SetupAliasFrame (e, paliashdr, e->frame, &lerpdata);
-	R_GetEntityLerpedTransform (e, lerpdata.origin, lerpdata.angles);
+	entity_render_state_t *state = R_GetEntityRenderState (e);
+	lerpdata_t			   lerpdata = state->lerpdata;
+	float				  *model_matrix = state->model_matrix;
 
 	//
 	// cull it
 	//
-	if (R_CullModelForEntity (e))
+	if (state->culled)
 		return;
 
-	//
-	// transform it
-	//
-	float model_matrix[16];
-	IdentityMatrix (model_matrix);
-	R_RotateForEntity (model_matrix, lerpdata.origin, lerpdata.angles, e->netstate.scale);
-
-	float fovscale = 1.0f;
-	if (e == &cl.viewent && r_refdef.basefov > 90.f)
+	vec3_t shadevector = {0.0f, 0.0f, 0.0f};
+	vec3_t lightcolor = {0.0f, 0.0f, 0.0f};
+	// Draw each surface of the model independently:
+	for (aliashdr_t *hdr = paliashdr; hdr != NULL; hdr = hdr->nextsurface)
 	{
-		fovscale = tan (r_refdef.basefov * (0.5f * M_PI / 180.f));
-		fovscale = 1.f + (fovscale - 1.f) * cl_gun_fovscale.value;
+		GL_DrawAliasFrame (cbx, e, hdr, lerpdata, nulltexture, nulltexture, model_matrix, 0.0f, false, shadevector, lightcolor, r_showtris.value);
 	}
+}
 
-	float translation_matrix[16];
-	TranslationMatrix (translation_matrix, paliashdr->scale_origin[0], paliashdr->scale_origin[1] * fovscale, paliashdr->scale_origin[2] * fovscale);
-	MatrixMultiply (model_matrix, translation_matrix);
+//==============================================================================
+//
+// LIGHTNING BEAMS
+//
+//==============================================================================
 
-	float scale_matrix[16];
-	ScaleMatrix (scale_matrix, paliashdr->scale[0], paliashdr->scale[1] * fovscale, paliashdr->scale[2] * fovscale);
-	MatrixMultiply (model_matrix, scale_matrix);
+// Lightning segments laid out by CL_UpdateTEnts are drawn like alias entities without being entities,
+// so they don't take up visedicts. Transform and light point are set up in the render state tasks too.
+typedef struct
+{
+	qboolean   culled;
+	lerpdata_t lerpdata;
+	float	   model_matrix[16];
+	vec3_t	   shadevector;
+	vec3_t	   lightcolor;
+} beam_render_state_t;
 
+static beam_render_state_t beam_render_states[MAX_BEAM_SEGMENTS];
+
+/*
+=================
+R_SetupBeamRenderStates
+=================
+*/
+void R_SetupBeamRenderStates (int first, int last)
+{
+	for (int i = first; i < last; ++i)
+	{
+		beam_segment_t		*segment = &cl_beam_segments[i];
+		beam_render_state_t *state = &beam_render_states[i];
+		qmodel_t			*model = segment->model;
+
+		vec3_t mins, maxs;
+		VectorAdd (segment->origin, model->rmins, mins);
+		VectorAdd (segment->origin, model->rmaxs, maxs);
+		state->culled = R_CullBox (mins, maxs);
+		if (state->culled)
+			continue;
+
+		aliashdr_t *paliashdr = (aliashdr_t *)Mod_Extradata_CheckSkin (model, 0);
+		state->lerpdata.pose1 = (paliashdr->poseverttype == PV_MD5) ? 0 : paliashdr->frames[0].firstpose;
+		state->lerpdata.pose2 = state->lerpdata.pose1;
+		state->lerpdata.blend = 0.0f;
+		VectorCopy (segment->origin, state->lerpdata.origin);
+		VectorCopy (segment->angles, state->lerpdata.angles);
+		R_SetupAliasModelMatrix (state->model_matrix, paliashdr, segment->origin, segment->angles, ENTSCALE_DEFAULT, 1.0f);
+
+		lightcache_t lightcache;
+		memset (&lightcache, 0, sizeof (lightcache));
+		R_SetupAliasLightingAt (segment->origin, segment->angles[1], model, &lightcache, 0.0f, &state->shadevector, &state->lightcolor);
+	}
+}
+
+/*
+=================
+R_DrawBeams
+=================
+*/
+void R_DrawBeams (cb_context_t *cbx, int *aliaspolys, alias_batch_t *batch)
+{
+	for (int i = 0; i < cl_num_beam_segments; ++i)
+	{
+		beam_render_state_t *state = &beam_render_states[i];
+		if (state->culled)
+			continue;
+
+		qmodel_t   *model = cl_beam_segments[i].model;
+		aliashdr_t *paliashdr = (aliashdr_t *)Mod_Extradata_CheckSkin (model, 0);
+		vec3_t		shadevector, lightcolor;
+		VectorCopy (state->shadevector, shadevector);
+		VectorCopy (state->lightcolor, lightcolor);
+		R_DrawAliasSurfaces (
+			cbx, NULL, model, paliashdr, 0, state->lerpdata, state->model_matrix, 1.0f, !!(model->flags & MF_HOLEY), shadevector, lightcolor, aliaspolys, batch);
+	}
+}
+
+/*
+=================
+R_DrawBeams_ShowTris
+=================
+*/
+void R_DrawBeams_ShowTris (cb_context_t *cbx)
+{
 	vec3_t shadevector = {0.0f, 0.0f, 0.0f};
 	vec3_t lightcolor = {0.0f, 0.0f, 0.0f};
-	// Draw each surface of the model independently:
-	for (aliashdr_t *hdr = paliashdr; hdr != NULL; hdr = hdr->nextsurface)
+	for (int i = 0; i < cl_num_beam_segments; ++i)
 	{
-		GL_DrawAliasFrame (cbx, e, hdr, lerpdata, nulltexture, nulltexture, model_matrix, 0.0f, false, shadevector, lightcolor, r_showtris.value);
+		beam_render_state_t *state = &beam_render_states[i];
+		if (state->culled)
+			continue;
+
+		aliashdr_t *paliashdr = (aliashdr_t *)Mod_Extradata_CheckSkin (cl_beam_segments[i].model, 0);
+		for (aliashdr_t *hdr = paliashdr; hdr != NULL; hdr = hdr->nextsurface)
+			GL_DrawAliasFrame (
+				cbx, NULL, hdr, state->lerpdata, nulltexture, nulltexture, state->model_matrix, 0.0f, false, shadevector, lightcolor, r_showtris.value);
 	}
 }
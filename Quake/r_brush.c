@@ -25,7 +25,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "quakedef.h"
 
-extern cvar_t gl_fullbrights, r_drawflat, r_gpulightmapupdate, r_rtshadows;
+extern cvar_t gl_fullbrights, r_drawflat, r_gpulightmapupdate, r_rtshadows, r_bindless;
 
 int gl_lightmap_format;
 
@@ -104,9 +104,18 @@ static VkDeviceAddress	   bmodel_indices_device_address;
 static VkBuffer			   bmodel_scratch_buffer;
 static VkDeviceAddress	   bmodel_scratch_address;
 static vulkan_memory_t	   bmodel_as_device_memory;
+static vulkan_memory_t	   bmodel_blas_memory;
+static int				   bmodel_blas_count;
+static int				   bmodel_tlas_num_instances = -1;
+static uint64_t			   bmodel_tlas_instances_hash;
+static int				   bmodel_tlas_num_refits;
+
+// Refitting keeps the TLAS topology of the last full build, rebuild periodically so trace performance does not degrade
+#define MAX_TLAS_REFITS 32
 
 extern cvar_t r_showtris;
 extern cvar_t r_simd;
+extern cvar_t r_oldskyleaf;
 typedef struct lm_compute_surface_data_s
 {
 	uint32_t packed_lightstyles;
@@ -119,6 +128,46 @@ typedef struct lm_compute_surface_data_s
 } lm_compute_surface_data_t;
 COMPILE_TIME_ASSERT (lm_compute_surface_data_t, sizeof (lm_compute_surface_data_t) == 64);
 
+typedef struct indirect_surface_bounds_s
+{
+	vec3_t mins;
+	vec3_t maxs;
+} indirect_surface_bounds_t;
+COMPILE_TIME_ASSERT (indirect_surface_bounds_t, sizeof (indirect_surface_bounds_t) == 24);
+
+typedef struct indirect_occlusion_push_constants_s
+{
+	uint32_t num_draws;
+	uint32_t first_draw;
+	uint32_t visibility_offset;
+	vec3_t	 vieworg;
+	float	 viewport_scale[2];
+	float	 viewport_bias[2];
+	uint32_t padding[2];
+	float	 view_projection_matrix[16];
+} indirect_occlusion_push_constants_t;
+COMPILE_TIME_ASSERT (indirect_occlusion_push_constants_t, sizeof (indirect_occlusion_push_constants_t) == 112);
+
+typedef struct indirect_leaf_s
+{
+	vec3_t	 mins;
+	uint32_t firstmarksurface;
+	vec3_t	 maxs;
+	uint32_t packed_nummarksurfaces; // bit 31 is set for sky leafs
+} indirect_leaf_t;
+COMPILE_TIME_ASSERT (indirect_leaf_t, sizeof (indirect_leaf_t) == 32);
+
+typedef struct mark_leafs_push_constants_s
+{
+	uint32_t num_leafs;
+	uint32_t first_leaf;
+	uint32_t visibility_offset;
+	uint32_t leaf_visibility_offset;
+	vec4_t	 frustum[4];
+	uint32_t mark_sky_leafs;
+} mark_leafs_push_constants_t;
+COMPILE_TIME_ASSERT (mark_leafs_push_constants_t, sizeof (mark_leafs_push_constants_t) == 84);
+
 typedef struct lm_compute_light_s
 {
 	vec3_t origin;
@@ -136,13 +185,22 @@ static vulkan_memory_t	   workgroup_bounds_buffer_memory;
 static vulkan_memory_t	   indirect_buffer_memory;
 static vulkan_memory_t	   indirect_index_buffer_memory;
 static vulkan_memory_t	   dyn_visibility_buffer_memory;
+static vulkan_memory_t	   surface_bounds_buffer_memory;
+static vulkan_memory_t	   leaf_data_buffer_memory;
+static vulkan_memory_t	   marksurfaces_buffer_memory;
 static VkBuffer			   surface_data_buffer;
+static VkBuffer			   surface_bounds_buffer;
+static VkBuffer			   leaf_data_buffer;
+static VkBuffer			   marksurfaces_buffer;
 static int				   num_surfaces;
 static VkBuffer			   indirect_buffer;
 static VkBuffer			   indirect_index_buffer;
 static VkBuffer			   dyn_visibility_buffer;
 static uint32_t			   dyn_visibility_offset; // for double-buffering
 static unsigned char	  *dyn_visibility_view;
+static uint32_t			   leaf_visibility_words;	 // PVS row position after the surface bits, in words
+static uint32_t			   texture_indices_words;	 // bindless texture indices of the indirect draws after the PVS row, in words
+static qboolean			   leaf_visibility_uploaded;
 static VkBuffer			   lightstyles_scales_buffer;
 static VkBuffer			   lights_buffer;
 static float			  *lightstyles_scales_buffer_mapped;
@@ -273,9 +331,11 @@ static void R_CalcDeps (qmodel_t *model, mleaf_t *leaf)
 /*
 ================
 R_MarkDeps
+
+Returns true if any of the surfaces uses a warp texture
 ================
 */
-void R_MarkDeps (int combined_deps, int worker_index)
+qboolean R_MarkDeps (int combined_deps, int worker_index)
 {
 	combined_brush_deps *deps = &brush_deps_data[combined_deps];
 	int					 water_count = deps->water_count;
@@ -285,6 +345,35 @@ void R_MarkDeps (int combined_deps, int worker_index)
 		Atomic_StoreUInt32_Relaxed ((++deps)->update_warp, true);
 	for (i = 0, ++deps; i < lm_count; ++i, ++deps)
 		lightmaps[deps->lightmap_num].modified[worker_index] |= deps->lightmap_styles;
+	return water_count != 0;
+}
+
+/*
+================
+R_CollectDeps
+
+Like R_MarkDeps, but accumulates into lightmap_styles (one entry per lightmap)
+and update_warp instead of marking them for this frame
+================
+*/
+qboolean R_CollectDeps (int combined_deps, uint32_t *lightmap_styles, atomic_uint32_t **update_warp, int *num_update_warp)
+{
+	combined_brush_deps *deps = &brush_deps_data[combined_deps];
+	int					 water_count = deps->water_count;
+	int					 lm_count = deps->lm_count;
+	int					 i, j;
+	for (i = 0; i < water_count; ++i)
+	{
+		atomic_uint32_t *flag = (++deps)->update_warp;
+		for (j = 0; j < *num_update_warp; ++j)
+			if (update_warp[j] == flag)
+				break;
+		if (j == *num_update_warp)
+			update_warp[(*num_update_warp)++] = flag;
+	}
+	for (i = 0, ++deps; i < lm_count; ++i, ++deps)
+		lightmap_styles[deps->lightmap_num] |= deps->lightmap_styles;
+	return water_count != 0;
 }
 
 /*
@@ -447,7 +536,7 @@ void R_DrawBrushModel (cb_context_t *cbx, entity_t *e, int chain, int *brushpoly
 	qmodel_t   *clmodel;
 	vec3_t		modelorg;
 
-	if (R_CullModelForEntity (e))
+	if (R_GetEntityRenderState (e)->culled)
 		return;
 
 	clmodel = e->model;
@@ -502,16 +591,9 @@ void R_DrawBrushModel (cb_context_t *cbx, entity_t *e, int chain, int *brushpoly
 		}
 	}
 
-	vec3_t e_angles;
-	VectorCopy (e->angles, e_angles);
-	e_angles[0] = -e_angles[0]; // stupid quake bug
-	float model_matrix[16];
-	IdentityMatrix (model_matrix);
-	R_RotateForEntity (model_matrix, e->origin, e_angles, e->netstate.scale);
-
 	float mvp[16];
 	memcpy (mvp, vulkan_globals.view_projection_matrix, 16 * sizeof (float));
-	MatrixMultiply (mvp, model_matrix);
+	MatrixMultiply (mvp, R_GetEntityRenderState (e)->model_matrix);
 
 	R_PushConstants (cbx, VK_SHADER_STAGE_ALL_GRAPHICS, 0, 16 * sizeof (float), mvp);
 	R_ClearTextureChains (clmodel, chain);
@@ -570,7 +652,7 @@ void R_DrawBrushModel_ShowTris (cb_context_t *cbx, entity_t *e)
 	const float alpha = 1.0f;
 	vec3_t		modelorg;
 
-	if (R_CullModelForEntity (e) || R_IndirectBrush (e))
+	if (R_GetEntityRenderState (e)->culled || R_IndirectBrush (e))
 		return;
 
 	clmodel = e->model;
@@ -590,15 +672,9 @@ void R_DrawBrushModel_ShowTris (cb_context_t *cbx, entity_t *e)
 
 	psurf = &clmodel->surfaces[clmodel->firstmodelsurface];
 
-	e->angles[0] = -e->angles[0]; // stupid quake bug
-	float model_matrix[16];
-	IdentityMatrix (model_matrix);
-	R_RotateForEntity (model_matrix, e->origin, e->angles, e->netstate.scale);
-	e->angles[0] = -e->angles[0]; // stupid quake bug
-
 	float mvp[16];
 	memcpy (mvp, vulkan_globals.view_projection_matrix, 16 * sizeof (float));
-	MatrixMultiply (mvp, model_matrix);
+	MatrixMultiply (mvp, R_GetEntityRenderState (e)->model_matrix);
 
 	if (r_showtris.value == 1)
 		R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.showtris_pipeline);
@@ -622,6 +698,31 @@ void R_DrawBrushModel_ShowTris (cb_context_t *cbx, entity_t *e)
 	R_PushConstants (cbx, VK_SHADER_STAGE_ALL_GRAPHICS, 0, 16 * sizeof (float), vulkan_globals.view_projection_matrix);
 }
 
+/*
+=============
+R_IndirectMultiDraw
+
+Texture indices come from the bindless set, so draws that only differ by texture can share one multi-draw call
+=============
+*/
+static qboolean R_IndirectMultiDraw (void)
+{
+	return vulkan_globals.bindless && r_bindless.value && vulkan_globals.multi_draw_indirect;
+}
+
+/*
+=============
+R_FlushIndirectDraws
+=============
+*/
+static void R_FlushIndirectDraws (cb_context_t *cbx, int *run_start, int *run_count)
+{
+	if (*run_count > 0)
+		vulkan_globals.vk_cmd_draw_indexed_indirect (
+			cbx->cb, indirect_buffer, *run_start * sizeof (VkDrawIndexedIndirectCommand), *run_count, sizeof (VkDrawIndexedIndirectCommand));
+	*run_count = 0;
+}
+
 /*
 =============
 R_DrawIndirectBrushes
@@ -637,7 +738,14 @@ void R_DrawIndirectBrushes (cb_context_t *cbx, qboolean draw_water, qboolean tra
 	vulkan_globals.vk_cmd_bind_vertex_buffers (cbx->cb, 0, 1, &bmodel_vertex_buffer, &offset);
 	vulkan_globals.vk_cmd_bind_index_buffer (cbx->cb, indirect_index_buffer, 0, VK_INDEX_TYPE_UINT32);
 
-	if (!draw_sky)
+	// Consecutive draws with the same state are merged, sky has no per-draw state and bindless draws get their textures from firstInstance
+	const qboolean bindless = !draw_sky && R_IndirectMultiDraw ();
+	const qboolean merge_draws = vulkan_globals.multi_draw_indirect && (draw_sky || bindless);
+	const int	   max_merged_draws = q_min (vulkan_globals.device_properties.limits.maxDrawIndirectCount, INT_MAX);
+	if (bindless)
+		vulkan_globals.vk_cmd_bind_descriptor_sets (
+			cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.world_bindless_pipeline_layout.handle, 0, 1, &vulkan_globals.bindless_desc_set, 0, NULL);
+	else if (!draw_sky)
 	{
 		vulkan_globals.vk_cmd_bind_descriptor_sets (
 			cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.world_pipeline_layout.handle, 2, 1, &nulltexture->descriptor_set, 0, NULL);
@@ -651,6 +759,8 @@ void R_DrawIndirectBrushes (cb_context_t *cbx, qboolean draw_water, qboolean tra
 	gltexture_t *lasttexture = NULL;
 	float		 last_alpha = FLT_MAX;
 	float		 last_constant_factor = FLT_MAX;
+	int			 run_start = 0;
+	int			 run_count = 0;
 
 	int part_size = (used_indirect_draws + NUM_WORLD_CBX - 1) / NUM_WORLD_CBX;
 	int start = index < 0 ? 0 : part_size * index;
@@ -669,13 +779,6 @@ void R_DrawIndirectBrushes (cb_context_t *cbx, qboolean draw_water, qboolean tra
 		if (draw_sky != (!q_strncasecmp (texture->name, "sky", 3))) // SURF_DRAWSKY is in surfaces only, but it's derived from the texture name
 			continue;
 
-		if (!draw_sky && !r_lightmap_cheatsafe && lasttexture != gl_texture)
-		{
-			vulkan_globals.vk_cmd_bind_descriptor_sets (
-				cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.world_pipeline_layout.handle, 0, 1, &gl_texture->descriptor_set, 0, NULL);
-			lasttexture = gl_texture;
-		}
-
 		float alpha = 1.0f;
 		if (draw_water)
 		{
@@ -699,37 +802,24 @@ void R_DrawIndirectBrushes (cb_context_t *cbx, qboolean draw_water, qboolean tra
 
 			if ((alpha < 1.0f) != transparent_water)
 				continue;
-
-			if (alpha != last_alpha)
-			{
-				R_PushConstants (cbx, VK_SHADER_STAGE_ALL_GRAPHICS, 20 * sizeof (float), 1 * sizeof (float), &alpha);
-				last_alpha = alpha;
-			}
 		}
 
 		qboolean	 fullbright_enabled = false;
-		gltexture_t *fullbright;
+		gltexture_t *fullbright = NULL;
 		if (!draw_sky && gl_fullbrights.value && (fullbright = R_TextureAnimation (t, 0)->fullbright) && !r_lightmap_cheatsafe)
-		{
 			fullbright_enabled = true;
-			if (lastfullbright != fullbright)
-			{
-				vulkan_globals.vk_cmd_bind_descriptor_sets (
-					cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.world_pipeline_layout.handle, 2, 1, &fullbright->descriptor_set, 0, NULL);
-				lastfullbright = fullbright;
-			}
-		}
 
+		int			 pipeline_index = 0;
+		float		 constant_factor = 0.0f, slope_factor = 0.0f;
+		gltexture_t *lightmap_texture = NULL;
 		if (!draw_sky)
 		{
 			const qboolean alpha_test = texture->name[0] == '{'; // SURF_DRAWFENCE is in surfaces only, but it's derived from the texture name
 			const qboolean alpha_blend = alpha < 1.0f;
-			int			   pipeline_index =
+			pipeline_index =
 				(fullbright_enabled ? 1 : 0) + (alpha_test ? 2 : 0) + (alpha_blend ? 4 : 0) + (vid_filter.value != 0 && vid_palettize.value != 0 ? 8 : 0);
-			R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.world_pipelines[pipeline_index]);
 
 			qboolean use_zbias = INDIRECT_ZBIAS && gl_zfix.value && indirect_draws[i].is_bmodel;
-			float	 constant_factor = 0.0f, slope_factor = 0.0f;
 			if (use_zbias)
 			{
 				if (vulkan_globals.depth_format == VK_FORMAT_D32_SFLOAT_S8_UINT || vulkan_globals.depth_format == VK_FORMAT_D32_SFLOAT)
@@ -743,24 +833,73 @@ void R_DrawIndirectBrushes (cb_context_t *cbx, qboolean draw_water, qboolean tra
 					slope_factor = -0.25f;
 				}
 			}
+
+			const int lm_idx = indirect_draws[i].lightmap_idx;
+			lightmap_texture = (r_fullbright_cheatsafe || lm_idx < 0) ? greylightmap : lightmaps[lm_idx].texture;
+		}
+
+		if (bindless)
+		{
+			gl_texture->visframe = r_framecount;
+			if (fullbright_enabled)
+				fullbright->visframe = r_framecount;
+		}
+
+		vulkan_pipeline_t pipeline = bindless ? vulkan_globals.world_bindless_pipelines[pipeline_index] : vulkan_globals.world_pipelines[pipeline_index];
+		const qboolean	  state_changed =
+			(draw_water && alpha != last_alpha) ||
+			(!draw_sky && (cbx->current_pipeline.handle != pipeline.handle || last_constant_factor != constant_factor || lastlightmap != lightmap_texture)) ||
+			(!draw_sky && !bindless && ((!r_lightmap_cheatsafe && lasttexture != gl_texture) || (fullbright_enabled && lastfullbright != fullbright)));
+		if (state_changed || i != run_start + run_count || run_count == max_merged_draws)
+			R_FlushIndirectDraws (cbx, &run_start, &run_count);
+
+		if (!draw_sky && !bindless && !r_lightmap_cheatsafe && lasttexture != gl_texture)
+		{
+			gl_texture->visframe = r_framecount;
+			vulkan_globals.vk_cmd_bind_descriptor_sets (
+				cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.world_pipeline_layout.handle, 0, 1, &gl_texture->descriptor_set, 0, NULL);
+			lasttexture = gl_texture;
+		}
+
+		if (draw_water && alpha != last_alpha)
+		{
+			R_PushConstants (cbx, VK_SHADER_STAGE_ALL_GRAPHICS, 20 * sizeof (float), 1 * sizeof (float), &alpha);
+			last_alpha = alpha;
+		}
+
+		if (!bindless && fullbright_enabled && lastfullbright != fullbright)
+		{
+			fullbright->visframe = r_framecount;
+			vulkan_globals.vk_cmd_bind_descriptor_sets (
+				cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.world_pipeline_layout.handle, 2, 1, &fullbright->descriptor_set, 0, NULL);
+			lastfullbright = fullbright;
+		}
+
+		if (!draw_sky)
+		{
+			R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+
 			if (last_constant_factor != constant_factor)
 			{
 				vkCmdSetDepthBias (cbx->cb, constant_factor, 0.0f, slope_factor);
 				last_constant_factor = constant_factor;
 			}
 
-			const int	 lm_idx = indirect_draws[i].lightmap_idx;
-			gltexture_t *lightmap_texture = (r_fullbright_cheatsafe || lm_idx < 0) ? greylightmap : lightmaps[lm_idx].texture;
 			if (lastlightmap != lightmap_texture)
 			{
 				vulkan_globals.vk_cmd_bind_descriptor_sets (
-					cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.world_pipeline_layout.handle, 1, 1, &lightmap_texture->descriptor_set, 0, NULL);
+					cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.layout.handle, 1, 1, &lightmap_texture->descriptor_set, 0, NULL);
 				lastlightmap = lightmap_texture;
 			}
 		}
 
-		vulkan_globals.vk_cmd_draw_indexed_indirect (cbx->cb, indirect_buffer, i * sizeof (VkDrawIndexedIndirectCommand), 1, 0);
+		if (run_count == 0)
+			run_start = i;
+		++run_count;
+		if (!merge_draws)
+			R_FlushIndirectDraws (cbx, &run_start, &run_count);
 	}
+	R_FlushIndirectDraws (cbx, &run_start, &run_count);
 
 	R_EndDebugUtilsLabel (cbx);
 }
@@ -970,8 +1109,8 @@ static void R_FillLightstyleTextures (msurface_t *surf, byte **lightstyles, int
 		{
 			for (int s = 0; s < smax; s += CLAMP (1, smax - s - 1, 8))
 				for (int t = 0; t < tmax; t += CLAMP (1, tmax - t - 1, 8))
-					lightmaps[surf->lightmaptexturenum]
-						.used_lightstyles[(surf->light_t + t) / LM_CULL_BLOCK_H][(surf->light_s + s) / LM_CULL_BLOCK_W][surf->styles[maps]] = true;
+					lightmaps[surf->lightmaptexturenum].used_lightstyles[(surf->light_t + t) / LM_CULL_BLOCK_H][(surf->light_s + s) / LM_CULL_BLOCK_W] |=
+						1ull << surf->styles[maps];
 			if (maps % 4 != 3)
 			{
 				byte *outptr = lightstyles[maps / 4 * 3 + maps % 4];
@@ -1100,6 +1239,83 @@ static void UpdateIndirectStructs (msurface_t *surf, qboolean is_bmodel)
 	indirect_draws[i].max_indices = 3 * (surf->numedges - 2);
 }
 
+/*
+================
+IndirectDrawCategory
+
+SURF_DRAWSKY and SURF_DRAWTURB are in surfaces only, but they're derived from the texture name
+================
+*/
+static int IndirectDrawCategory (const texture_t *t)
+{
+	if (!q_strncasecmp (t->name, "sky", 3))
+		return 2;
+	if (t->name[0] == '*' || t->name[0] == '!')
+		return 1;
+	return 0;
+}
+
+/*
+================
+CompareIndirectDraws
+================
+*/
+static int CompareIndirectDraws (const void *a, const void *b)
+{
+	const int			  index_a = *(const int *)a;
+	const int			  index_b = *(const int *)b;
+	const indirectdraw_t *draw_a = &indirect_draws[index_a];
+	const indirectdraw_t *draw_b = &indirect_draws[index_b];
+	int					  diff;
+
+	if ((diff = IndirectDrawCategory (draw_a->texture) - IndirectDrawCategory (draw_b->texture)) != 0)
+		return diff;
+	if ((diff = draw_a->is_bmodel - draw_b->is_bmodel) != 0)
+		return diff;
+	if ((diff = draw_a->lightmap_idx - draw_b->lightmap_idx) != 0)
+		return diff;
+	if ((diff = (draw_a->texture->name[0] == '{') - (draw_b->texture->name[0] == '{')) != 0)
+		return diff;
+	if ((diff = (draw_a->texture->fullbright != NULL) - (draw_b->texture->fullbright != NULL)) != 0)
+		return diff;
+	return index_a - index_b;
+}
+
+/*
+================
+SortIndirectDraws
+
+Orders the draws so that the ones sharing pipeline state and lightmap are adjacent and can be
+merged into one multi-draw call when texture indices come from the bindless set
+================
+*/
+static void SortIndirectDraws (lm_compute_surface_data_t *surface_data, uint32_t num_surface_data)
+{
+	TEMP_ALLOC (int, order, used_indirect_draws);
+	TEMP_ALLOC (int, remap, used_indirect_draws);
+	TEMP_ALLOC (indirectdraw_t, sorted_draws, used_indirect_draws);
+
+	for (int i = 0; i < used_indirect_draws; ++i)
+		order[i] = i;
+	qsort (order, used_indirect_draws, sizeof (int), CompareIndirectDraws);
+	for (int i = 0; i < used_indirect_draws; ++i)
+	{
+		remap[order[i]] = i;
+		sorted_draws[i] = indirect_draws[order[i]];
+	}
+	memcpy (indirect_draws, sorted_draws, used_indirect_draws * sizeof (indirectdraw_t));
+
+	for (uint32_t i = 0; i < num_surface_data; ++i)
+	{
+		const uint32_t packed = surface_data[i].packed_tex_edgecount;
+		surface_data[i].packed_tex_edgecount = (packed & ~0x7FFFu) | remap[packed & 0x7FFF];
+	}
+
+	TEMP_FREE (sorted_draws);
+	TEMP_FREE (remap);
+	TEMP_FREE (order);
+}
+
 /*
 ================
 PrepareIndirectDraws
@@ -1298,6 +1514,63 @@ static lm_compute_surface_data_t *GL_AllocateSurfaceDataBuffer ()
 	return staging_mem;
 }
 
+/*
+==================
+GL_UploadSurfaceBounds
+==================
+*/
+static void GL_UploadSurfaceBounds (const indirect_surface_bounds_t *surface_bounds)
+{
+	size_t buffer_size = num_surfaces * sizeof (indirect_surface_bounds_t);
+
+	R_FreeBuffer (surface_bounds_buffer, &surface_bounds_buffer_memory, &num_vulkan_bmodel_allocations);
+
+	Sys_Printf ("Allocating surface bounds (%u KB)\n", (int)buffer_size / 1024);
+	R_CreateBuffer (
+		&surface_bounds_buffer, &surface_bounds_buffer_memory, buffer_size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, &num_vulkan_bmodel_allocations, NULL, "Surface bounds");
+
+	R_StagingUploadBuffer (surface_bounds_buffer, buffer_size, (const byte *)surface_bounds);
+}
+
+/*
+==================
+GL_UploadLeafData
+
+Leaf bounds and marksurfaces of the world for R_IndirectComputeDispatch to do the PVS marking on the GPU
+==================
+*/
+static void GL_UploadLeafData (void)
+{
+	const int numleafs = cl.worldmodel->numleafs;
+	size_t	  leafs_size = q_max (numleafs, 1) * sizeof (indirect_leaf_t);
+	size_t	  marksurfaces_size = q_max (cl.worldmodel->nummarksurfaces, 1) * sizeof (int);
+
+	R_FreeBuffer (leaf_data_buffer, &leaf_data_buffer_memory, &num_vulkan_bmodel_allocations);
+	R_FreeBuffer (marksurfaces_buffer, &marksurfaces_buffer_memory, &num_vulkan_bmodel_allocations);
+
+	Sys_Printf ("Allocating leaf data (%u KB)\n", (int)(leafs_size + marksurfaces_size) / 1024);
+	R_CreateBuffer (
+		&leaf_data_buffer, &leaf_data_buffer_memory, leafs_size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, &num_vulkan_bmodel_allocations, NULL, "Leaf data");
+	R_CreateBuffer (
+		&marksurfaces_buffer, &marksurfaces_buffer_memory, marksurfaces_size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, &num_vulkan_bmodel_allocations, NULL, "Marksurfaces");
+
+	indirect_leaf_t *leafs = (indirect_leaf_t *)Mem_Alloc (leafs_size);
+	for (int i = 0; i < numleafs; ++i)
+	{
+		mleaf_t *leaf = &cl.worldmodel->leafs[i + 1]; // worldmodel->leafs is 1-based
+		VectorCopy (leaf->minmaxs, leafs[i].mins);
+		VectorCopy (leaf->minmaxs + 3, leafs[i].maxs);
+		leafs[i].firstmarksurface = leaf->nummarksurfaces ? (uint32_t)(leaf->firstmarksurface - cl.worldmodel->marksurfaces) : 0;
+		leafs[i].packed_nummarksurfaces = leaf->nummarksurfaces | (leaf->contents == CONTENTS_SKY ? 0x80000000u : 0);
+	}
+	R_StagingUploadBuffer (leaf_data_buffer, numleafs * sizeof (indirect_leaf_t), (const byte *)leafs);
+	R_StagingUploadBuffer (marksurfaces_buffer, cl.worldmodel->nummarksurfaces * sizeof (int), (const byte *)cl.worldmodel->marksurfaces);
+	Mem_Free (leafs);
+}
+
 /*
 ==================
 GL_AllocateIndirectBuffer
@@ -1440,6 +1713,44 @@ static void R_UploadVisibility (byte *data, uint32_t size)
 	vkFlushMappedMemoryRanges (vulkan_globals.device, 1, &range);
 }
 
+/*
+===============
+R_UploadIndirectTextureIndices
+
+Stores the bindless diffuse | fullbright << 16 indices of every indirect draw after the PVS row,
+indirect_clear.comp copies them to firstInstance
+===============
+*/
+static void R_UploadIndirectTextureIndices (void)
+{
+	uint32_t *dest = (uint32_t *)(dyn_visibility_view + current_compute_buffer_index * dyn_visibility_offset) + texture_indices_words;
+	for (int i = 0; i < used_indirect_draws; i++)
+	{
+		texture_t	*texture = R_TextureAnimation (indirect_draws[i].texture, 0);
+		gltexture_t *gl_texture = IndirectDrawCategory (texture) == 1 ? texture->warpimage : texture->gltexture;
+		gltexture_t *fullbright = (gl_fullbrights.value && texture->fullbright && !r_lightmap_cheatsafe) ? texture->fullbright : nulltexture;
+		if (r_lightmap_cheatsafe)
+			gl_texture = greytexture;
+		else if (!gl_texture)
+			gl_texture = nulltexture;
+		dest[i] = TexMgr_BindlessIndex (gl_texture) | (TexMgr_BindlessIndex (fullbright) << 16);
+	}
+}
+
+/*
+===============
+R_UploadLeafVisibility
+
+Stores the PVS row next to the surface bits, the next R_IndirectComputeDispatch marks the leaf surfaces on the GPU
+===============
+*/
+void R_UploadLeafVisibility (const byte *vis)
+{
+	unsigned char *dest = dyn_visibility_view + current_compute_buffer_index * dyn_visibility_offset + leaf_visibility_words * 4;
+	memcpy (dest, vis, (cl.worldmodel->numleafs + 31) / 32 * 4);
+	leaf_visibility_uploaded = true;
+}
+
 /*
 ===============
 GL_SortSurfaces
@@ -1548,6 +1859,35 @@ static void GL_SortSurfaces (void)
 	TEMP_FREE (surfs);
 }
 
+/*
+==================
+GL_SurfaceBounds
+==================
+*/
+static void GL_SurfaceBounds (msurface_t *fa, indirect_surface_bounds_t *bounds)
+{
+	for (int i = 0; i < 3; ++i)
+	{
+		bounds->mins[i] = FLT_MAX;
+		bounds->maxs[i] = -FLT_MAX;
+	}
+
+	// same vertices as BuildSurfaceDisplayList, but also valid for SURF_DRAWTILED surfaces
+	for (int i = 0; i < fa->numedges; ++i)
+	{
+		const int	   lindex = currentmodel->surfedges[fa->firstedge + i];
+		const medge_t *r_pedge = &currentmodel->edges[abs (lindex)];
+		const float	  *vec = r_pcurrentvertbase[r_pedge->v[(lindex > 0) ? 0 : 1]].position;
+		for (int j = 0; j < 3; ++j)
+		{
+			if (vec[j] < bounds->mins[j])
+				bounds->mins[j] = vec[j];
+			if (vec[j] > bounds->maxs[j])
+				bounds->maxs[j] = vec[j];
+		}
+	}
+}
+
 /*
 ==================
 GL_BuildLightmaps -- called at level load time
@@ -1561,6 +1901,7 @@ void GL_BuildLightmaps (void)
 	int						   i, j;
 	uint32_t				   surface_index = 0;
 	lm_compute_surface_data_t *surface_data;
+	indirect_surface_bounds_t *surface_bounds;
 	msurface_t				  *surf;
 
 	GL_WaitForDeviceIdle ();
@@ -1606,6 +1947,7 @@ void GL_BuildLightmaps (void)
 	GL_SortSurfaces ();
 
 	surface_data = GL_AllocateSurfaceDataBuffer ();
+	surface_bounds = (indirect_surface_bounds_t *)Mem_Alloc (num_surfaces * sizeof (indirect_surface_bounds_t));
 
 	R_StagingBeginCopy ();
 	unsigned int varray_index = 0;
@@ -1651,11 +1993,19 @@ void GL_BuildLightmaps (void)
 			surf_data->vecs[0][3] -= surf->texturemins[0];
 			surf_data->vecs[1][3] -= surf->texturemins[1];
 
+			GL_SurfaceBounds (surf, &surface_bounds[surface_index]);
+
 			surface_index += 1;
 		}
 	}
 
+	if (indirect_ready)
+		SortIndirectDraws (surface_data, surface_index);
+
 	R_StagingEndCopy ();
+
+	GL_UploadSurfaceBounds (surface_bounds);
+	Mem_Free (surface_bounds);
 }
 
 /*
@@ -1679,7 +2029,12 @@ void GL_SetupIndirectDraws ()
 	R_StagingEndCopy ();
 
 	R_InitIndirectIndexBuffer ((initial_indirect_buffer[used_indirect_draws - 1].firstIndex + indirect_draws[used_indirect_draws - 1].max_indices) * 4);
-	R_InitVisibilityBuffers ((cl.worldmodel->numsurfaces + 31) / 8);
+	leaf_visibility_words = ((cl.worldmodel->numsurfaces + 31) / 8 + 3) / 4;
+	leaf_visibility_uploaded = false;
+	texture_indices_words = leaf_visibility_words + (cl.worldmodel->numleafs + 31) / 32;
+	R_InitVisibilityBuffers ((texture_indices_words + used_indirect_draws) * 4);
+	GL_UploadLeafData ();
+	vulkan_globals.depth_pyramid_valid = false; // still holds the previous map
 
 	if (vulkan_globals.indirect_compute_desc_set != VK_NULL_HANDLE)
 		R_FreeDescriptorSet (vulkan_globals.indirect_compute_desc_set, &vulkan_globals.indirect_compute_set_layout);
@@ -1705,7 +2060,22 @@ void GL_SetupIndirectDraws ()
 	index_buffer_info.offset = 0;
 	index_buffer_info.range = VK_WHOLE_SIZE;
 
-	ZEROED_STRUCT_ARRAY (VkWriteDescriptorSet, indirect_d, 4);
+	ZEROED_STRUCT (VkDescriptorBufferInfo, bounds_buffer_info);
+	bounds_buffer_info.buffer = surface_bounds_buffer;
+	bounds_buffer_info.offset = 0;
+	bounds_buffer_info.range = num_surfaces * sizeof (indirect_surface_bounds_t);
+
+	ZEROED_STRUCT (VkDescriptorBufferInfo, leafs_buffer_info);
+	leafs_buffer_info.buffer = leaf_data_buffer;
+	leafs_buffer_info.offset = 0;
+	leafs_buffer_info.range = VK_WHOLE_SIZE;
+
+	ZEROED_STRUCT (VkDescriptorBufferInfo, marksurfaces_buffer_info);
+	marksurfaces_buffer_info.buffer = marksurfaces_buffer;
+	marksurfaces_buffer_info.offset = 0;
+	marksurfaces_buffer_info.range = VK_WHOLE_SIZE;
+
+	ZEROED_STRUCT_ARRAY (VkWriteDescriptorSet, indirect_d, 7);
 
 	indirect_d[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
 	indirect_d[0].dstBinding = 0;
@@ -1739,6 +2109,30 @@ void GL_SetupIndirectDraws ()
 	indirect_d[3].dstSet = vulkan_globals.indirect_compute_desc_set;
 	indirect_d[3].pBufferInfo = &index_buffer_info;
 
+	indirect_d[4].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	indirect_d[4].dstBinding = 4;
+	indirect_d[4].dstArrayElement = 0;
+	indirect_d[4].descriptorCount = 1;
+	indirect_d[4].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	indirect_d[4].dstSet = vulkan_globals.indirect_compute_desc_set;
+	indirect_d[4].pBufferInfo = &bounds_buffer_info;
+
+	indirect_d[5].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	indirect_d[5].dstBinding = 5;
+	indirect_d[5].dstArrayElement = 0;
+	indirect_d[5].descriptorCount = 1;
+	indirect_d[5].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	indirect_d[5].dstSet = vulkan_globals.indirect_compute_desc_set;
+	indirect_d[5].pBufferInfo = &leafs_buffer_info;
+
+	indirect_d[6].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	indirect_d[6].dstBinding = 6;
+	indirect_d[6].dstArrayElement = 0;
+	indirect_d[6].descriptorCount = 1;
+	indirect_d[6].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	indirect_d[6].dstSet = vulkan_globals.indirect_compute_desc_set;
+	indirect_d[6].pBufferInfo = &marksurfaces_buffer_info;
+
 	vkUpdateDescriptorSets (vulkan_globals.device, countof (indirect_d), indirect_d, 0, NULL);
 
 	for (int i = 0; i < cl.worldmodel->numleafs; i++)
@@ -1928,7 +2322,8 @@ void GL_SetupLightmapCompute (void)
 		q_snprintf (name, sizeof (name), "lightmap_%07i", i);
 
 		lm->texture = TexMgr_LoadImage (
-			cl.worldmodel, name, LMBLOCK_WIDTH, LMBLOCK_HEIGHT, SRC_LIGHTMAP, lm->data, "", (src_offset_t)lm->data, TEXPREF_LINEAR | TEXPREF_NOPICMIP);
+			cl.worldmodel, name, LMBLOCK_WIDTH, LMBLOCK_HEIGHT, SRC_LIGHTMAP, lm->data, "", (src_offset_t)lm->data,
+			TEXPREF_LINEAR | TEXPREF_NOPICMIP | TEXPREF_ASYNCCOMPUTE);
 		for (int j = 0; j < MAXLIGHTMAPS * 3 / 4; ++j)
 		{
 			q_snprintf (name, sizeof (name), "lightstyle%d_%07i", j, i);
@@ -1944,7 +2339,8 @@ void GL_SetupLightmapCompute (void)
 					for (int row = 1; row < size_h; row++)
 						memmove (lm->lightstyle_data[j] + size_w * row * 4, lm->lightstyle_data[j] + LMBLOCK_WIDTH * row * 4, size_w * 4);
 				lm->lightstyle_textures[j] = TexMgr_LoadImage (
-					cl.worldmodel, name, size_w, size_h, SRC_RGBA, lm->lightstyle_data[j], "", (src_offset_t)lm->data, TEXPREF_NEAREST | TEXPREF_NOPICMIP);
+					cl.worldmodel, name, size_w, size_h, SRC_RGBA, lm->lightstyle_data[j], "", (src_offset_t)lm->data,
+					TEXPREF_NEAREST | TEXPREF_NOPICMIP | TEXPREF_ASYNCCOMPUTE);
 			}
 			SAFE_FREE (lm->lightstyle_data[j]);
 		}
@@ -1959,14 +2355,8 @@ void GL_SetupLightmapCompute (void)
 		q_snprintf (name, sizeof (name), "surfindices_%07i", i);
 		lm->surface_indices_texture = TexMgr_LoadImage (
 			cl.worldmodel, name, *size_w, *size_h, SRC_SURF_INDICES, (byte *)lm->surface_indices, "", (src_offset_t)lm->surface_indices,
-			TEXPREF_NEAREST | TEXPREF_NOPICMIP);
+			TEXPREF_NEAREST | TEXPREF_NOPICMIP | TEXPREF_ASYNCCOMPUTE);
 		SAFE_FREE (lm->surface_indices);
-
-		for (int y = 0; y < LMBLOCK_HEIGHT / LM_CULL_BLOCK_H; y++)
-			for (int x = 0; x < LMBLOCK_WIDTH / LM_CULL_BLOCK_W; x++)
-				for (int l = 0; l < MAX_LIGHTSTYLES; l++)
-					if (lightmaps[i].used_lightstyles[y][x][l])
-						lightmaps[i].used_lightstyles[y][x][lightmaps[i].num_used_lightstyles[y][x]++] = l;
 	}
 
 	for (int i = 0; i < lightmap_count; i++)
@@ -2029,11 +2419,9 @@ void GL_DeleteBModelAccelerationStructures (void)
 		return;
 
 	GL_WaitForDeviceIdle ();
-	TEMP_ALLOC (VkBuffer, buffers, 3 + MAX_MODELS);
-	int num_buffers = 0;
-	buffers[num_buffers++] = bmodel_scratch_buffer;
-	buffers[num_buffers++] = bmodel_indices_buffer;
-	buffers[num_buffers++] = bmodel_tlas_buffer;
+	VkBuffer buffers[3] = {bmodel_scratch_buffer, bmodel_indices_buffer, bmodel_tlas_buffer};
+	TEMP_ALLOC (VkBuffer, blas_buffers, MAX_MODELS);
+	int num_blas_buffers = 0;
 	for (int i = 0; i < MAX_MODELS; ++i)
 	{
 		qmodel_t *m = cl.model_precache[i];
@@ -2042,7 +2430,7 @@ void GL_DeleteBModelAccelerationStructures (void)
 		if (m->blas != VK_NULL_HANDLE)
 		{
 			vulkan_globals.vk_destroy_acceleration_structure (vulkan_globals.device, cl.model_precache[i]->blas, NULL);
-			buffers[num_buffers++] = m->buffer;
+			blas_buffers[num_blas_buffers++] = m->buffer;
 			m->blas = VK_NULL_HANDLE;
 			m->buffer = VK_NULL_HANDLE;
 			m->address = 0;
@@ -2050,15 +2438,20 @@ void GL_DeleteBModelAccelerationStructures (void)
 		assert (m->buffer == VK_NULL_HANDLE);
 		assert (m->address == 0);
 	}
-	R_FreeBuffers (num_buffers, buffers, &bmodel_as_device_memory, &num_vulkan_bmodel_allocations);
+	Atomic_SubUInt64 (&vulkan_memory_category_sizes[VULKAN_MEMORY_CATEGORY_ACCELERATION_STRUCTURES], bmodel_as_device_memory.size + bmodel_blas_memory.size);
+	vulkan_globals.vk_destroy_acceleration_structure (vulkan_globals.device, bmodel_tlas, NULL);
+	R_FreeBuffers (countof (buffers), buffers, &bmodel_as_device_memory, &num_vulkan_bmodel_allocations);
+	R_FreeBuffers (num_blas_buffers, blas_buffers, &bmodel_blas_memory, &num_vulkan_bmodel_allocations);
 	bmodel_tlas = VK_NULL_HANDLE;
 	bmodel_tlas_buffer = VK_NULL_HANDLE;
 	bmodel_tlas_size = 0;
+	bmodel_tlas_num_instances = -1;
+	bmodel_blas_count = 0;
 	bmodel_indices_buffer = VK_NULL_HANDLE;
 	bmodel_indices_device_address = 0;
 	bmodel_scratch_buffer = VK_NULL_HANDLE;
 	bmodel_scratch_address = 0;
-	TEMP_FREE (buffers);
+	TEMP_FREE (blas_buffers);
 }
 
 /*
@@ -2118,6 +2511,102 @@ void GL_BuildBModelVertexBuffer (void)
 	TEMP_FREE (varray);
 }
 
+/*
+==================
+R_CompactBModelBLASes
+
+Copies the freshly built BLASes into buffers of their compacted size and frees the originals
+==================
+*/
+static void R_CompactBModelBLASes (const int num_blas, qmodel_t **blas_models, VkQueryPool compacted_size_query_pool)
+{
+	VkResult err;
+
+	// The query results are only available once the build has finished
+	GL_WaitForDeviceIdle ();
+
+	TEMP_ALLOC (VkDeviceSize, compacted_sizes, num_blas);
+	err = vkGetQueryPoolResults (
+		vulkan_globals.device, compacted_size_query_pool, 0, num_blas, num_blas * sizeof (VkDeviceSize), compacted_sizes, sizeof (VkDeviceSize),
+		VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+	if (err != VK_SUCCESS)
+	{
+		Con_Warning ("vkGetQueryPoolResults failed, BLASes not compacted\n");
+		TEMP_FREE (compacted_sizes);
+		return;
+	}
+
+	TEMP_ALLOC (VkAccelerationStructureKHR, old_blases, num_blas);
+	TEMP_ALLOC (VkBuffer, old_buffers, num_blas);
+	TEMP_ALLOC_ZEROED (buffer_create_info_t, buffer_create_infos, num_blas);
+	for (int i = 0; i < num_blas; ++i)
+	{
+		old_blases[i] = blas_models[i]->blas;
+		old_buffers[i] = blas_models[i]->buffer;
+
+		buffer_create_info_t *create_info = &buffer_create_infos[i];
+		create_info->buffer = &blas_models[i]->buffer;
+		create_info->size = compacted_sizes[i];
+		create_info->usage = VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR;
+		create_info->address = &blas_models[i]->address;
+		create_info->name = "BModel BLAS";
+	}
+
+	vulkan_memory_t old_memory = bmodel_blas_memory;
+	R_CreateBuffers (num_blas, buffer_create_infos, &bmodel_blas_memory, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, &num_vulkan_bmodel_allocations, "BModel BLAS");
+
+	VkCommandBuffer command_buffer;
+	R_StagingAllocate (0, 1, &command_buffer, NULL, NULL);
+
+	for (int i = 0; i < num_blas; ++i)
+	{
+		ZEROED_STRUCT (VkAccelerationStructureCreateInfoKHR, acceleration_structure_create_info);
+		acceleration_structure_create_info.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR;
+		acceleration_structure_create_info.buffer = blas_models[i]->buffer;
+		acceleration_structure_create_info.size = compacted_sizes[i];
+		acceleration_structure_create_info.type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR;
+		err = vulkan_globals.vk_create_acceleration_structure (vulkan_globals.device, &acceleration_structure_create_info, NULL, &blas_models[i]->blas);
+		if (err != VK_SUCCESS)
+			Sys_Error ("vkCreateAccelerationStructure failed");
+
+		ZEROED_STRUCT (VkCopyAccelerationStructureInfoKHR, copy_info);
+		copy_info.sType = VK_STRUCTURE_TYPE_COPY_ACCELERATION_STRUCTURE_INFO_KHR;
+		copy_info.src = old_blases[i];
+		copy_info.dst = blas_models[i]->blas;
+		copy_info.mode = VK_COPY_ACCELERATION_STRUCTURE_MODE_COMPACT_KHR;
+		vulkan_globals.vk_cmd_copy_acceleration_structure (command_buffer, &copy_info);
+	}
+
+	{
+		ZEROED_STRUCT (VkMemoryBarrier, memory_barrier);
+		memory_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		memory_barrier.srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+		memory_barrier.dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR;
+		vulkan_globals.vk_cmd_pipeline_barrier (
+			command_buffer, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1, &memory_barrier, 0, NULL, 0,
+			NULL);
+	}
+
+	R_StagingBeginCopy ();
+	R_StagingEndCopy ();
+
+	// The originals have to stay alive until the copies have executed
+	GL_WaitForDeviceIdle ();
+	const size_t old_size = old_memory.size;
+	for (int i = 0; i < num_blas; ++i)
+		vulkan_globals.vk_destroy_acceleration_structure (vulkan_globals.device, old_blases[i], NULL);
+	R_FreeBuffers (num_blas, old_buffers, &old_memory, &num_vulkan_bmodel_allocations);
+
+	Sys_Printf ("Compacted BLAS data (%u KB -> %u KB)\n", (int)(old_size / 1024ull), (int)(bmodel_blas_memory.size / 1024ull));
+	Atomic_AddUInt64 (&vulkan_memory_category_sizes[VULKAN_MEMORY_CATEGORY_ACCELERATION_STRUCTURES], bmodel_blas_memory.size);
+	Atomic_SubUInt64 (&vulkan_memory_category_sizes[VULKAN_MEMORY_CATEGORY_ACCELERATION_STRUCTURES], old_size);
+
+	TEMP_FREE (compacted_sizes);
+	TEMP_FREE (old_blases);
+	TEMP_FREE (old_buffers);
+	TEMP_FREE (buffer_create_infos);
+}
+
 /*
 ==================
 GL_BuildBModelAccelerationStructures
@@ -2174,7 +2663,7 @@ void GL_BuildBModelAccelerationStructures (void)
 		VkAccelerationStructureBuildGeometryInfoKHR *blas_geometry_info = &blas_geometry_infos[num_blas];
 		blas_geometry_info->sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
 		blas_geometry_info->type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR;
-		blas_geometry_info->flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR;
+		blas_geometry_info->flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR | VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_COMPACTION_BIT_KHR;
 		blas_geometry_info->mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
 		blas_geometry_info->geometryCount = 1;
 		blas_geometry_info->pGeometries = blas_geometry;
@@ -2211,7 +2700,7 @@ void GL_BuildBModelAccelerationStructures (void)
 
 		tlas_geometry_info.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
 		tlas_geometry_info.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
-		tlas_geometry_info.flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR;
+		tlas_geometry_info.flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR | VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR;
 		tlas_geometry_info.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
 		tlas_geometry_info.geometryCount = 1;
 		tlas_geometry_info.pGeometries = &tlas_geometry;
@@ -2221,6 +2710,7 @@ void GL_BuildBModelAccelerationStructures (void)
 			vulkan_globals.device, VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR, &tlas_geometry_info, &num_instances, &tlas_build_sizes_info);
 
 		scratch_buffer_size = q_max (scratch_buffer_size, tlas_build_sizes_info.buildScratchSize);
+		scratch_buffer_size = q_max (scratch_buffer_size, tlas_build_sizes_info.updateScratchSize);
 		bmodel_tlas_size = tlas_build_sizes_info.accelerationStructureSize;
 	}
 
@@ -2244,6 +2734,9 @@ void GL_BuildBModelAccelerationStructures (void)
 	buffer_create_infos[2].alignment = vulkan_globals.physical_device_acceleration_structure_properties.minAccelerationStructureScratchOffsetAlignment;
 	buffer_create_infos[2].name = "BModel AS build scratch";
 
+	const size_t total_as_device_size = R_CreateBuffers (
+		3, buffer_create_infos, &bmodel_as_device_memory, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, &num_vulkan_bmodel_allocations, "BModel AS");
+
 	for (int i = 0; i < num_blas; ++i)
 	{
 		buffer_create_info_t *create_info = &buffer_create_infos[3 + i];
@@ -2254,10 +2747,12 @@ void GL_BuildBModelAccelerationStructures (void)
 		create_info->name = "BModel BLAS";
 	}
 
-	const size_t total_as_device_size = R_CreateBuffers (
-		3 + num_blas, buffer_create_infos, &bmodel_as_device_memory, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, &num_vulkan_bmodel_allocations, "BModel AS");
+	const size_t total_blas_device_size = R_CreateBuffers (
+		num_blas, &buffer_create_infos[3], &bmodel_blas_memory, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, &num_vulkan_bmodel_allocations, "BModel BLAS");
+	bmodel_blas_count = num_blas;
 
-	Sys_Printf ("Allocating acceleration structure data (%u KB)\n", (int)(total_as_device_size / 1024ull));
+	Sys_Printf ("Allocating acceleration structure data (%u KB)\n", (int)((total_as_device_size + total_blas_device_size) / 1024ull));
+	Atomic_AddUInt64 (&vulkan_memory_category_sizes[VULKAN_MEMORY_CATEGORY_ACCELERATION_STRUCTURES], bmodel_as_device_memory.size + bmodel_blas_memory.size);
 
 	{
 		ZEROED_STRUCT (VkAccelerationStructureCreateInfoKHR, acceleration_structure_create_info);
@@ -2270,6 +2765,20 @@ void GL_BuildBModelAccelerationStructures (void)
 			Sys_Error ("vkCreateAccelerationStructure failed");
 	}
 
+	VkQueryPool compacted_size_query_pool;
+	{
+		ZEROED_STRUCT (VkQueryPoolCreateInfo, query_pool_create_info);
+		query_pool_create_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		query_pool_create_info.queryType = VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR;
+		query_pool_create_info.queryCount = num_blas;
+		err = vkCreateQueryPool (vulkan_globals.device, &query_pool_create_info, NULL, &compacted_size_query_pool);
+		if (err != VK_SUCCESS)
+		{
+			Con_Warning ("vkCreateQueryPool failed, BLAS compaction unavailable\n");
+			compacted_size_query_pool = VK_NULL_HANDLE;
+		}
+	}
+
 	VkBuffer		staging_buffer;
 	VkCommandBuffer command_buffer;
 	int				staging_offset;
@@ -2343,12 +2852,16 @@ void GL_BuildBModelAccelerationStructures (void)
 			&memory_barrier, 0, NULL, 0, NULL);
 	}
 
-	TEMP_FREE (blas_num_tris);
-	TEMP_FREE (blas_geometries);
-	TEMP_FREE (blas_geometry_infos);
-	TEMP_FREE (blas_sizes_infos);
-	TEMP_FREE (blas_models);
-	TEMP_FREE (buffer_create_infos);
+	if (compacted_size_query_pool != VK_NULL_HANDLE)
+	{
+		TEMP_ALLOC (VkAccelerationStructureKHR, blases, num_blas);
+		for (int i = 0; i < num_blas; ++i)
+			blases[i] = blas_models[i]->blas;
+		vkCmdResetQueryPool (command_buffer, compacted_size_query_pool, 0, num_blas);
+		vulkan_globals.vk_cmd_write_acceleration_structures_properties (
+			command_buffer, num_blas, blases, VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR, compacted_size_query_pool, 0);
+		TEMP_FREE (blases);
+	}
 
 	uint32_t *indices = (uint32_t *)staging_memory;
 	uint32_t  current_index = 0;
@@ -2377,6 +2890,19 @@ void GL_BuildBModelAccelerationStructures (void)
 		}
 	}
 	R_StagingEndCopy ();
+
+	if (compacted_size_query_pool != VK_NULL_HANDLE)
+	{
+		R_CompactBModelBLASes (num_blas, blas_models, compacted_size_query_pool);
+		vkDestroyQueryPool (vulkan_globals.device, compacted_size_query_pool, NULL);
+	}
+
+	TEMP_FREE (blas_num_tris);
+	TEMP_FREE (blas_geometries);
+	TEMP_FREE (blas_geometry_infos);
+	TEMP_FREE (blas_sizes_infos);
+	TEMP_FREE (blas_models);
+	TEMP_FREE (buffer_create_infos);
 }
 
 /*
@@ -2416,6 +2942,7 @@ void R_BuildTopLevelAccelerationStructure (void *unused)
 	VkAccelerationStructureInstanceKHR *instances = (VkAccelerationStructureInstanceKHR *)R_StorageAllocate (
 		num_instances * sizeof (VkAccelerationStructureInstanceKHR), NULL, NULL, &instances_device_address);
 
+	uint64_t instances_hash = 0;
 	num_instances = 0;
 	for (int i = 0; i < cl.num_entities + cl.num_statics; ++i)
 	{
@@ -2442,8 +2969,14 @@ void R_BuildTopLevelAccelerationStructure (void *unused)
 			continue;
 		}
 
-		vec3_t lerped_origin, lerped_angles;
-		if (is_alias)
+		vec3_t				   lerped_origin, lerped_angles;
+		entity_render_state_t *state = is_alias ? R_GetEntityRenderState (e) : NULL;
+		if (state)
+		{
+			VectorCopy (state->lerpdata.origin, lerped_origin);
+			VectorCopy (state->lerpdata.angles, lerped_angles);
+		}
+		else if (is_alias)
 			R_GetEntityLerpedTransform (e, lerped_origin, lerped_angles);
 		else
 		{
@@ -2491,10 +3024,18 @@ void R_BuildTopLevelAccelerationStructure (void *unused)
 		instance->instanceShaderBindingTableRecordOffset = 0;
 		instance->flags = VK_GEOMETRY_INSTANCE_FORCE_OPAQUE_BIT_KHR | VK_GEOMETRY_INSTANCE_TRIANGLE_FACING_CULL_DISABLE_BIT_KHR;
 		instance->accelerationStructureReference = address;
+		instances_hash = (instances_hash ^ address) * 0x100000001B3ull;
 
 		++num_instances;
 	}
 
+	// Only the transforms changed since the last build if the same BLASes are instanced in the same order
+	const qboolean refit = (num_instances == bmodel_tlas_num_instances) && (instances_hash == bmodel_tlas_instances_hash) &&
+						   (bmodel_tlas_num_refits < MAX_TLAS_REFITS);
+	bmodel_tlas_num_refits = refit ? (bmodel_tlas_num_refits + 1) : 0;
+	bmodel_tlas_num_instances = num_instances;
+	bmodel_tlas_instances_hash = instances_hash;
+
 	ZEROED_STRUCT (VkAccelerationStructureGeometryKHR, tlas_geometry);
 	tlas_geometry.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
 	tlas_geometry.geometryType = VK_GEOMETRY_TYPE_INSTANCES_KHR;
@@ -2504,10 +3045,11 @@ void R_BuildTopLevelAccelerationStructure (void *unused)
 	ZEROED_STRUCT (VkAccelerationStructureBuildGeometryInfoKHR, tlas_geometry_info);
 	tlas_geometry_info.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
 	tlas_geometry_info.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
-	tlas_geometry_info.flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR;
-	tlas_geometry_info.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
+	tlas_geometry_info.flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR | VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR;
+	tlas_geometry_info.mode = refit ? VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR : VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
 	tlas_geometry_info.geometryCount = 1;
 	tlas_geometry_info.pGeometries = &tlas_geometry;
+	tlas_geometry_info.srcAccelerationStructure = refit ? bmodel_tlas : VK_NULL_HANDLE;
 	tlas_geometry_info.dstAccelerationStructure = bmodel_tlas;
 	tlas_geometry_info.scratchData.deviceAddress = bmodel_scratch_address;
 
@@ -2572,6 +3114,7 @@ void GL_PrepareSIMDAndParallelData (void)
 
 	cl.worldmodel->soa_leafbounds = Mem_Alloc (6 * sizeof (float) * ((cl.worldmodel->numleafs + 31) & ~7));
 	cl.worldmodel->soa_surfplanes = Mem_Alloc (4 * sizeof (float) * ((cl.worldmodel->numsurfaces + 31) & ~7));
+	cl.worldmodel->soa_surfbounds = Mem_Alloc (6 * sizeof (float) * ((cl.worldmodel->numsurfaces + 31) & ~7));
 
 	for (i = 0; i < cl.worldmodel->numleafs; ++i)
 	{
@@ -2583,6 +3126,21 @@ void GL_PrepareSIMDAndParallelData (void)
 	{
 		msurface_t *surf = &cl.worldmodel->surfaces[i];
 		SoA_FillPlaneLane (cl.worldmodel->soa_surfplanes, i, surf->plane, surf->flags & SURF_PLANEBACK);
+
+		vec3_t mins = {FLT_MAX, FLT_MAX, FLT_MAX};
+		vec3_t maxs = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+		for (int j = 0; j < surf->numedges; ++j)
+		{
+			const int	   lindex = cl.worldmodel->surfedges[surf->firstedge + j];
+			const medge_t *edge = &cl.worldmodel->edges[abs (lindex)];
+			const float	  *vec = cl.worldmodel->vertexes[edge->v[(lindex > 0) ? 0 : 1]].position;
+			for (int k = 0; k < 3; ++k)
+			{
+				mins[k] = q_min (mins[k], vec[k]);
+				maxs[k] = q_max (maxs[k], vec[k]);
+			}
+		}
+		SoA_FillBoxLane (cl.worldmodel->soa_surfbounds, i, mins, maxs);
 	}
 #endif // def USE_SIMD
 }
@@ -2950,16 +3508,32 @@ static void R_UploadLightmap (int lmap, gltexture_t *lightmap_tex)
 	lm->rectchange.w = 0;
 }
 
+/*
+=============
+R_FoldLightstyles
+
+Folds a lightstyle bitmask the same way as surface styles_bitmap: styles 16..63 share bits 16..31
+=============
+*/
+COMPILE_TIME_ASSERT (lightstyle_mask, MAX_LIGHTSTYLES <= 64);
+static uint32_t R_FoldLightstyles (uint64_t lightstyles)
+{
+	const uint32_t high = (uint32_t)(lightstyles >> 16);
+	return (uint32_t)(lightstyles & 0xFFFF) | (((high | (high >> 16) | (uint32_t)(lightstyles >> 48)) & 0xFFFF) << 16);
+}
+
 /*
 =============
 R_FlushUpdateLightmaps
+
+Region types: 1 dlights only, 2 unconditional, 3 only texels of surfaces using a changed lightstyle
 =============
 */
 #define UPDATE_LIGHTMAP_BATCH_SIZE 64
 void R_FlushUpdateLightmaps (
 	cb_context_t *cbx, int num_batch_lightmaps, VkImageMemoryBarrier *pre_barriers, VkImageMemoryBarrier *post_barriers, int *lightmap_indexes,
-	byte lightmap_regions[UPDATE_LIGHTMAP_BATCH_SIZE][LMBLOCK_HEIGHT / LM_CULL_BLOCK_H][LMBLOCK_WIDTH / LM_CULL_BLOCK_W], int current_dlights,
-	int cached_dlights)
+	byte lightmap_regions[UPDATE_LIGHTMAP_BATCH_SIZE][LMBLOCK_HEIGHT / LM_CULL_BLOCK_H][LMBLOCK_WIDTH / LM_CULL_BLOCK_W], uint64_t *changed_lightstyles,
+	int current_dlights, int cached_dlights)
 {
 	vulkan_pipeline_t *pipeline =
 		(r_rtshadows.value && (bmodel_tlas != VK_NULL_HANDLE)) ? &vulkan_globals.update_lightmap_rt_pipeline : &vulkan_globals.update_lightmap_pipeline;
@@ -3004,17 +3578,28 @@ void R_FlushUpdateLightmaps (
 						h += 1;
 					}
 					uint32_t shadow_samples = (r_rtshadows.value > 0) ? (1 << ((int)r_rtshadows.value + 1)) : 0;
-					uint32_t push_constants[7] = {current_dlights, LMBLOCK_WIDTH,  x * LM_CULL_BLOCK_W / 8, y * LM_CULL_BLOCK_H / 8,
-												  type == 1,	   cached_dlights, shadow_samples};
-					R_PushConstants (cbx, VK_SHADER_STAGE_COMPUTE_BIT, 0, 7 * sizeof (uint32_t), push_constants);
+					uint32_t push_constants[10] = {
+						current_dlights,
+						LMBLOCK_WIDTH,
+						x * LM_CULL_BLOCK_W / 8,
+						y * LM_CULL_BLOCK_H / 8,
+						type == 1,
+						cached_dlights,
+						shadow_samples,
+						type == 3,
+						(uint32_t)changed_lightstyles[j],
+						(uint32_t)(changed_lightstyles[j] >> 32)};
+					R_PushConstants (cbx, VK_SHADER_STAGE_COMPUTE_BIT, 0, 10 * sizeof (uint32_t), push_constants);
 					w = q_min (lightmaps[lightmap_indexes[j]].lightstyle_rectused[0].w / 8 - x * LM_CULL_BLOCK_W / 8, w * LM_CULL_BLOCK_W / 8);
 					h = q_min (lightmaps[lightmap_indexes[j]].lightstyle_rectused[0].h / 8 - y * LM_CULL_BLOCK_H / 8, h * LM_CULL_BLOCK_H / 8);
 					vkCmdDispatch (cbx->cb, w, h, 1);
 				}
 	}
 
-	vkCmdPipelineBarrier (
-		cbx->cb, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, NULL, 0, NULL, num_batch_lightmaps, post_barriers);
+	// The async compute queue has no fragment stage, the semaphore handoff makes the writes visible to the graphics queue
+	const VkPipelineStageFlags post_dst_stage =
+		(cbx == &vulkan_globals.async_compute_cb_context) ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT : VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+	vkCmdPipelineBarrier (cbx->cb, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, post_dst_stage, 0, 0, NULL, 0, NULL, num_batch_lightmaps, post_barriers);
 }
 
 /*
@@ -3029,14 +3614,54 @@ static void R_IndirectComputeDispatch (cb_context_t *cbx)
 
 	R_BeginDebugUtilsLabel (cbx, "Indirect Compute");
 
+	const qboolean multi_draw = R_IndirectMultiDraw ();
+	if (multi_draw)
+		R_UploadIndirectTextureIndices ();
 	R_UploadVisibility (cl.worldmodel->surfvis, (cl.worldmodel->numsurfaces + 31) / 8);
 
+	uint32_t offset = current_compute_buffer_index * dyn_visibility_offset / 4;
+
 	R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_COMPUTE, vulkan_globals.indirect_clear_pipeline);
 	VkDescriptorSet sets[1] = {vulkan_globals.indirect_compute_desc_set};
 	vkCmdBindDescriptorSets (cbx->cb, VK_PIPELINE_BIND_POINT_COMPUTE, vulkan_globals.indirect_clear_pipeline.layout.handle, 0, 1, sets, 0, NULL);
-	R_PushConstants (cbx, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof (uint32_t), &used_indirect_draws);
+	const uint32_t clear_push_constants[3] = {used_indirect_draws, offset + texture_indices_words, multi_draw};
+	R_PushConstants (cbx, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof (clear_push_constants), clear_push_constants);
 
 	vkCmdDispatch (cbx->cb, (used_indirect_draws + 63) / 64, 1, 1);
+	if (leaf_visibility_uploaded)
+	{
+		// Adds the surfaces of PVS leafs inside the frustum to the bits already set by bmodels and water leafs on the CPU
+		R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_COMPUTE, vulkan_globals.mark_leafs_pipeline);
+		vkCmdBindDescriptorSets (cbx->cb, VK_PIPELINE_BIND_POINT_COMPUTE, vulkan_globals.mark_leafs_pipeline.layout.handle, 0, 1, sets, 0, NULL);
+
+		mark_leafs_push_constants_t push_constants;
+		push_constants.num_leafs = cl.worldmodel->numleafs;
+		push_constants.first_leaf = 0;
+		push_constants.visibility_offset = offset;
+		push_constants.leaf_visibility_offset = offset + leaf_visibility_words;
+		for (int i = 0; i < 4; ++i)
+		{
+			VectorCopy (frustum[i].normal, push_constants.frustum[i]);
+			push_constants.frustum[i][3] = frustum[i].dist;
+		}
+		push_constants.mark_sky_leafs = r_oldskyleaf.value != 0.0f;
+		R_PushConstants (cbx, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof (push_constants), &push_constants);
+
+		const uint32_t num_workgroups = (cl.worldmodel->numleafs + 63) / 64;
+		const uint32_t max_dispatch = vulkan_globals.device_properties.limits.maxComputeWorkGroupCount[0];
+		uint32_t	   start_workgroup = 0;
+		while (true)
+		{
+			vkCmdDispatch (cbx->cb, q_min (max_dispatch, num_workgroups - start_workgroup), 1, 1);
+			start_workgroup += max_dispatch;
+			if (start_workgroup >= num_workgroups)
+				break;
+			const uint32_t start_offset = start_workgroup * 64;
+			R_PushConstants (cbx, VK_SHADER_STAGE_COMPUTE_BIT, 4, sizeof (uint32_t), &start_offset);
+		}
+
+		leaf_visibility_uploaded = false;
+	}
 
 	VkMemoryBarrier memory_barrier;
 	memory_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
@@ -3045,14 +3670,38 @@ static void R_IndirectComputeDispatch (cb_context_t *cbx)
 	memory_barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
 	vkCmdPipelineBarrier (cbx->cb, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memory_barrier, 0, NULL, 0, NULL);
 
-	R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_COMPUTE, vulkan_globals.indirect_draw_pipeline);
-	char push_constants[6 * 4];
-	memcpy (push_constants, &cl.model_precache[1]->numsurfaces, sizeof (int));
-	memset (push_constants + 4, 0, sizeof (uint32_t));
-	uint32_t offset = current_compute_buffer_index * dyn_visibility_offset / 4;
-	memcpy (push_constants + 8, &offset, sizeof (uint32_t));
-	memcpy (push_constants + 12, r_refdef.vieworg, sizeof (vec3_t));
-	R_PushConstants (cbx, VK_SHADER_STAGE_COMPUTE_BIT, 0, 6 * 4, push_constants);
+	if (vulkan_globals.occlusion_culling && vulkan_globals.depth_pyramid_valid)
+	{
+		R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_COMPUTE, vulkan_globals.indirect_occlusion_pipeline);
+		VkDescriptorSet occlusion_sets[2] = {vulkan_globals.indirect_compute_desc_set, vulkan_globals.depth_pyramid_desc_set};
+		vkCmdBindDescriptorSets (
+			cbx->cb, VK_PIPELINE_BIND_POINT_COMPUTE, vulkan_globals.indirect_occlusion_pipeline.layout.handle, 0, 2, occlusion_sets, 0, NULL);
+
+		// Maps NDC to pixels of the framebuffer the depth pyramid was built from
+		indirect_occlusion_push_constants_t push_constants;
+		memset (&push_constants, 0, sizeof (push_constants));
+		push_constants.num_draws = cl.model_precache[1]->numsurfaces;
+		push_constants.first_draw = 0;
+		push_constants.visibility_offset = offset;
+		VectorCopy (r_refdef.vieworg, push_constants.vieworg);
+		push_constants.viewport_scale[0] = vulkan_globals.prev_viewport[2] * 0.5f;
+		push_constants.viewport_scale[1] = vulkan_globals.prev_viewport[3] * 0.5f;
+		push_constants.viewport_bias[0] = vulkan_globals.prev_viewport[0] + vulkan_globals.prev_viewport[2] * 0.5f;
+		push_constants.viewport_bias[1] = vulkan_globals.prev_viewport[1] + vulkan_globals.prev_viewport[3] * 0.5f;
+		memcpy (push_constants.view_projection_matrix, vulkan_globals.prev_view_projection_matrix, 16 * sizeof (float));
+		R_PushConstants (cbx, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof (push_constants), &push_constants);
+	}
+	else
+	{
+		R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_COMPUTE, vulkan_globals.indirect_draw_pipeline);
+		vkCmdBindDescriptorSets (cbx->cb, VK_PIPELINE_BIND_POINT_COMPUTE, vulkan_globals.indirect_draw_pipeline.layout.handle, 0, 1, sets, 0, NULL);
+		char push_constants[6 * 4];
+		memcpy (push_constants, &cl.model_precache[1]->numsurfaces, sizeof (int));
+		memset (push_constants + 4, 0, sizeof (uint32_t));
+		memcpy (push_constants + 8, &offset, sizeof (uint32_t));
+		memcpy (push_constants + 12, r_refdef.vieworg, sizeof (vec3_t));
+		R_PushConstants (cbx, VK_SHADER_STAGE_COMPUTE_BIT, 0, 6 * 4, push_constants);
+	}
 	const uint32_t num_workgroups = (cl.worldmodel->numsurfaces + 63) / 64;
 	const uint32_t max_dispatch = vulkan_globals.device_properties.limits.maxComputeWorkGroupCount[0];
 	uint32_t	   start_workgroup = 0;
@@ -3085,7 +3734,11 @@ R_UpdateLightmapsAndIndirect
 void R_UpdateLightmapsAndIndirect (void *unused)
 {
 	cb_context_t *cbx = &vulkan_globals.primary_cb_contexts[PCBX_UPDATE_LIGHTMAPS];
-	R_BeginDebugUtilsLabel (cbx, "Update Lightmaps");
+
+	// Ray traced shadows need the TLAS built earlier in this frame's graphics submit, so they stay on the graphics queue
+	const qboolean rt = r_rtshadows.value && (bmodel_tlas != VK_NULL_HANDLE);
+	cb_context_t  *lm_cbx = (vulkan_globals.async_compute && !rt) ? &vulkan_globals.async_compute_cb_context : cbx;
+	R_BeginDebugUtilsLabel (lm_cbx, "Update Lightmaps");
 
 	for (int i = 0; i < MAX_LIGHTSTYLES; ++i)
 	{
@@ -3100,13 +3753,16 @@ void R_UpdateLightmapsAndIndirect (void *unused)
 		lights_buffer_mapped + (current_compute_buffer_index * MAX_DLIGHTS * 2) + MAX_DLIGHTS, cached_dlights,
 		sizeof (lm_compute_light_t) * num_cached_dlights);
 
+	// Clustered dlights are added per pixel by the world shaders, the lightmaps only follow the lightstyles
+	const qboolean blend_dlights = r_dynamic.value && !R_ClusteredDlights ();
+
 	int	  num_used_dlights = 0;
 	int	  used_dlights[MAX_DLIGHTS];
 	float squared_radius[MAX_DLIGHTS];
 	for (int i = 0; i < MAX_DLIGHTS; ++i)
 	{
 		lm_compute_light_t *light = &cached_dlights[num_used_dlights];
-		if (!r_dynamic.value || cl_dlights[i].die < cl.time || cl_dlights[i].radius == 0.0f || (cl_dlights[i].radius < cl_dlights[i].minlight))
+		if (!blend_dlights || cl_dlights[i].die < cl.time || cl_dlights[i].radius == 0.0f || (cl_dlights[i].radius < cl_dlights[i].minlight))
 			continue;
 		VectorCopy (cl_dlights[i].origin, light->origin);
 		light->radius = cl_dlights[i].radius;
@@ -3122,6 +3778,7 @@ void R_UpdateLightmapsAndIndirect (void *unused)
 	VkImageMemoryBarrier pre_lm_image_barriers[UPDATE_LIGHTMAP_BATCH_SIZE];
 	VkImageMemoryBarrier post_lm_image_barriers[UPDATE_LIGHTMAP_BATCH_SIZE];
 	int					 lightmap_indexes[UPDATE_LIGHTMAP_BATCH_SIZE];
+	uint64_t			 lightmap_changed_lightstyles[UPDATE_LIGHTMAP_BATCH_SIZE];
 	byte				 lightmap_regions[UPDATE_LIGHTMAP_BATCH_SIZE][LMBLOCK_HEIGHT / LM_CULL_BLOCK_H][LMBLOCK_WIDTH / LM_CULL_BLOCK_W];
 
 	for (int lightmap_index = 0; lightmap_index < lightmap_count; ++lightmap_index)
@@ -3138,8 +3795,13 @@ void R_UpdateLightmapsAndIndirect (void *unused)
 		if (modified == 0)
 			continue;
 
+		uint64_t changed_lightstyles = 0;
+		for (int i = 0; i < MAX_LIGHTSTYLES; i++)
+			if (lm->cached_light[i] != d_lightstylevalue[i])
+				changed_lightstyles |= 1ull << i;
+
 		qboolean any_needs_dlight_update = false;
-		uint32_t used_lightstyles = 0;
+		uint64_t used_lightstyles = 0;
 		int		 num_blocks = 0;
 		for (int y = 0; y < LMBLOCK_HEIGHT / LM_CULL_BLOCK_H; y++)
 			for (int x = 0; x < LMBLOCK_WIDTH / LM_CULL_BLOCK_W; x++)
@@ -3183,23 +3845,20 @@ void R_UpdateLightmapsAndIndirect (void *unused)
 						regions[y][x] = 2;
 					num_blocks += 1;
 				}
-				if (regions[y][x] != 2)
-					for (int i = 0; i < lm->num_used_lightstyles[y][x]; i++)
+				const uint64_t block_lightstyles = lm->used_lightstyles[y][x] & changed_lightstyles;
+				if (block_lightstyles != 0 && regions[y][x] != 2)
+				{
+					if (regions[y][x] == 0)
 					{
-						int l = lm->used_lightstyles[y][x][i];
-						if (lm->cached_light[l] != d_lightstylevalue[l])
-						{
-							if (regions[y][x] == 0)
-								num_blocks += 1;
-							regions[y][x] = 2;
-							if (!any_needs_dlight_update)
-								used_lightstyles |= 1 << (l < 16 ? l : l % 16 + 16);
-							else
-								break;
-						}
+						regions[y][x] = 3;
+						num_blocks += 1;
 					}
+					else
+						regions[y][x] = 2;
+				}
+				used_lightstyles |= block_lightstyles;
 			}
-		if (!any_needs_dlight_update && !(used_lightstyles & modified))
+		if (!any_needs_dlight_update && !(R_FoldLightstyles (used_lightstyles) & modified))
 			continue;
 		else
 		{
@@ -3211,6 +3870,7 @@ void R_UpdateLightmapsAndIndirect (void *unused)
 
 		int batch_index = num_batch_lightmaps++;
 		lightmap_indexes[batch_index] = lightmap_index;
+		lightmap_changed_lightstyles[batch_index] = changed_lightstyles;
 		memcpy (lightmap_regions[batch_index], regions, sizeof (regions));
 
 		VkImageMemoryBarrier *pre_barrier = &pre_lm_image_barriers[batch_index];
@@ -3248,22 +3908,24 @@ void R_UpdateLightmapsAndIndirect (void *unused)
 		if (num_batch_lightmaps == UPDATE_LIGHTMAP_BATCH_SIZE)
 		{
 			R_FlushUpdateLightmaps (
-				cbx, num_batch_lightmaps, pre_lm_image_barriers, post_lm_image_barriers, lightmap_indexes, lightmap_regions, num_used_dlights,
-				num_cached_dlights);
+				lm_cbx, num_batch_lightmaps, pre_lm_image_barriers, post_lm_image_barriers, lightmap_indexes, lightmap_regions, lightmap_changed_lightstyles,
+				num_used_dlights, num_cached_dlights);
 			num_batch_lightmaps = 0;
 		}
 	}
 
 	if (num_batch_lightmaps > 0)
 		R_FlushUpdateLightmaps (
-			cbx, num_batch_lightmaps, pre_lm_image_barriers, post_lm_image_barriers, lightmap_indexes, lightmap_regions, num_used_dlights, num_cached_dlights);
+			lm_cbx, num_batch_lightmaps, pre_lm_image_barriers, post_lm_image_barriers, lightmap_indexes, lightmap_regions, lightmap_changed_lightstyles,
+			num_used_dlights, num_cached_dlights);
 
 	num_cached_dlights = num_used_dlights;
 
 	Atomic_AddUInt32 (&rs_dynamiclightmaps, num_lightmaps);
 
-	R_EndDebugUtilsLabel (cbx);
+	R_EndDebugUtilsLabel (lm_cbx);
 
+	R_BinDlightClusters (cbx);
 	R_IndirectComputeDispatch (cbx);
 
 	current_compute_buffer_index = (current_compute_buffer_index + 1) % 2;
@@ -46,11 +46,57 @@ static float texturescalefactor; // johnfitz -- compensate for apparent size of
 
 cvar_t		  r_particles = {"r_particles", "1", CVAR_ARCHIVE};			// johnfitz
 static cvar_t r_quadparticles = {"r_quadparticles", "1", CVAR_ARCHIVE}; // johnfitz
+static cvar_t r_gpuparticles = {"r_gpuparticles", "1", CVAR_ARCHIVE};
 
 extern cvar_t r_showtris;
 
 static VkBuffer particle_index_buffer;
 
+// GPU particles: emitters only record spawns, update_particles.comp simulates and writes the vertices
+typedef struct gpu_particle_s
+{
+	vec3_t	 org;
+	float	 die;
+	vec3_t	 vel;
+	float	 ramp;
+	uint32_t color_type; // palette index in bits 0-7, ptype_t in bits 8-15
+} gpu_particle_t;
+COMPILE_TIME_ASSERT (gpu_particle_t, sizeof (gpu_particle_t) == 36);
+
+typedef struct
+{
+	float	 up[4];
+	float	 right[4];
+	float	 forward[4];
+	float	 time;
+	float	 frametime;
+	float	 grav;
+	uint32_t num_particles;
+	uint32_t quads;
+} update_particles_push_constants_t;
+COMPILE_TIME_ASSERT (update_particles_push_constants_t, sizeof (update_particles_push_constants_t) == 68);
+
+// VkDrawIndexedIndirectCommand for quads followed by VkDrawIndirectCommand for triangles
+#define GPU_PARTICLE_INDIRECT_SIZE		  (sizeof (VkDrawIndexedIndirectCommand) + sizeof (VkDrawIndirectCommand))
+#define GPU_PARTICLE_MAX_UPDATE_PARTICLES (65536 / sizeof (gpu_particle_t)) // vkCmdUpdateBuffer limit
+
+static vulkan_memory_t gpu_particle_memory;
+static VkBuffer		   gpu_particle_buffer;
+static VkBuffer		   gpu_particle_vertex_buffer;
+static VkBuffer		   gpu_particle_indirect_buffer;
+static VkBuffer		   gpu_particle_palette_buffer;
+static VkDescriptorSet gpu_particle_desc_set;
+
+static particle_t	  *gpu_particle_spawns;
+static gpu_particle_t *gpu_particle_upload;
+static int			   num_gpu_particle_spawns;
+static int			   gpu_particle_head;	  // next slot in the ring of GPU particles
+static float		   gpu_particle_max_die;  // no GPU particle is alive past this time
+static double		   gpu_particle_time;	  // cl.time of the last simulation step
+static qboolean		   gpu_particle_clear;	  // kill all GPU particles before the next step
+static qboolean		   gpu_particle_palette;  // palette has been uploaded
+static qboolean		   gpu_particles_visible; // R_UpdateParticles wrote vertices this frame
+
 /*
 ===============
 R_ParticleTextureLookup -- johnfitz -- generate nice antialiased 32x32 circle for particles
@@ -186,6 +232,7 @@ void R_InitParticleIndexBuffer (void)
 	Atomic_IncrementUInt32 (&num_vulkan_dynbuf_allocations);
 	VkDeviceMemory particle_index_buffer_memory;
 	Atomic_AddUInt64 (&total_device_vulkan_allocation_size, memory_requirements.size);
+	Atomic_AddUInt64 (&vulkan_memory_category_sizes[VULKAN_MEMORY_CATEGORY_DYNAMIC], memory_requirements.size);
 	err = vkAllocateMemory (vulkan_globals.device, &memory_allocate_info, NULL, &particle_index_buffer_memory);
 	if (err != VK_SUCCESS)
 		Sys_Error ("vkAllocateMemory failed");
@@ -220,6 +267,104 @@ void R_InitParticleIndexBuffer (void)
 	R_StagingEndCopy ();
 }
 
+/*
+===============
+R_InitGPUParticles
+===============
+*/
+static void R_InitGPUParticles (void)
+{
+	ZEROED_STRUCT_ARRAY (buffer_create_info_t, buffer_create_infos, 4);
+	buffer_create_infos[0].buffer = &gpu_particle_buffer;
+	buffer_create_infos[0].size = r_numparticles * sizeof (gpu_particle_t);
+	buffer_create_infos[0].usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+	buffer_create_infos[0].name = "GPU particles";
+	buffer_create_infos[1].buffer = &gpu_particle_vertex_buffer;
+	buffer_create_infos[1].size = r_numparticles * 4 * sizeof (basicvertex_t);
+	buffer_create_infos[1].usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+	buffer_create_infos[1].name = "GPU particle vertices";
+	buffer_create_infos[2].buffer = &gpu_particle_indirect_buffer;
+	buffer_create_infos[2].size = GPU_PARTICLE_INDIRECT_SIZE;
+	buffer_create_infos[2].usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+	buffer_create_infos[2].name = "GPU particle indirect";
+	buffer_create_infos[3].buffer = &gpu_particle_palette_buffer;
+	buffer_create_infos[3].size = sizeof (d_8to24table);
+	buffer_create_infos[3].usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+	buffer_create_infos[3].name = "GPU particle palette";
+	R_CreateBuffers (
+		countof (buffer_create_infos), buffer_create_infos, &gpu_particle_memory, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, &num_vulkan_dynbuf_allocations,
+		"GPU particles");
+
+	gpu_particle_desc_set = R_AllocateDescriptorSet (&vulkan_globals.particle_compute_set_layout);
+
+	ZEROED_STRUCT_ARRAY (VkDescriptorBufferInfo, buffer_infos, 4);
+	ZEROED_STRUCT_ARRAY (VkWriteDescriptorSet, writes, 4);
+	for (int i = 0; i < 4; ++i)
+	{
+		buffer_infos[i].buffer = *buffer_create_infos[i].buffer;
+		buffer_infos[i].offset = 0;
+		buffer_infos[i].range = VK_WHOLE_SIZE;
+
+		writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writes[i].dstBinding = i;
+		writes[i].dstArrayElement = 0;
+		writes[i].descriptorCount = 1;
+		writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		writes[i].dstSet = gpu_particle_desc_set;
+		writes[i].pBufferInfo = &buffer_infos[i];
+	}
+	vkUpdateDescriptorSets (vulkan_globals.device, countof (writes), writes, 0, NULL);
+
+	gpu_particle_spawns = (particle_t *)Mem_Alloc (r_numparticles * sizeof (particle_t));
+	gpu_particle_upload = (gpu_particle_t *)Mem_Alloc (r_numparticles * sizeof (gpu_particle_t));
+	gpu_particle_clear = true;
+}
+
+/*
+===============
+R_SetGPUParticles_f
+===============
+*/
+static void R_SetGPUParticles_f (cvar_t *var)
+{
+	R_ClearParticles ();
+}
+
+/*
+===============
+R_AllocParticle
+
+Takes a particle from the free list, or with r_gpuparticles records a spawn for the next R_UpdateParticles
+===============
+*/
+static particle_t *R_AllocParticle (void)
+{
+	particle_t *p;
+
+	if (r_gpuparticles.value)
+	{
+		if (num_gpu_particle_spawns >= r_numparticles)
+			return NULL;
+		p = &gpu_particle_spawns[num_gpu_particle_spawns++];
+		memset (p, 0, sizeof (*p));
+		return p;
+	}
+
+	if (!free_particles)
+		return NULL;
+	p = free_particles;
+	free_particles = p->next;
+	p->next = active_particles;
+	active_particles = p;
+	return p;
+}
+
+static qboolean R_BenchParticlesSetup (void **data);
+static void		R_BenchParticles (void *data, int count);
+static void		R_BenchParticlesShutdown (void *data);
+
+static const bench_case_t r_bench_particles = {"particles_16k", R_BenchParticlesSetup, R_BenchParticles, R_BenchParticlesShutdown};
+
 /*
 ===============
 R_InitParticles
@@ -247,9 +392,14 @@ void R_InitParticles (void)
 	Cvar_RegisterVariable (&r_particles); // johnfitz
 	Cvar_SetCallback (&r_particles, R_SetParticleTexture_f);
 	Cvar_RegisterVariable (&r_quadparticles); // johnfitz
+	Cvar_RegisterVariable (&r_gpuparticles);
+	Cvar_SetCallback (&r_gpuparticles, R_SetGPUParticles_f);
 
 	R_InitParticleTextures (); // johnfitz
 	R_InitParticleIndexBuffer ();
+	R_InitGPUParticles ();
+
+	Bench_Register (&r_bench_particles);
 }
 
 /*
@@ -305,12 +455,8 @@ void R_EntityParticles (entity_t *ent)
 		forward[1] = cp * sy;
 		forward[2] = -sp;
 
-		if (!free_particles)
+		if (!(p = R_AllocParticle ()))
 			return;
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
 
 		p->die = cl.time + 0.01;
 		p->color = 0x6f;
@@ -337,6 +483,13 @@ void R_ClearParticles (void)
 	for (i = 0; i < r_numparticles; i++)
 		particles[i].next = &particles[i + 1];
 	particles[r_numparticles - 1].next = NULL;
+
+	num_gpu_particle_spawns = 0;
+	gpu_particle_head = 0;
+	gpu_particle_max_die = 0.0f;
+	gpu_particle_time = cl.time;
+	gpu_particle_clear = true;
+	gpu_particle_palette = false; // may have changed with the game dir
 }
 
 /*
@@ -375,15 +528,11 @@ void R_ReadPointFile_f (void)
 			break;
 		c++;
 
-		if (!free_particles)
+		if (!(p = R_AllocParticle ()))
 		{
 			Con_Printf ("Not enough free particles\n");
 			break;
 		}
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
 
 		p->die = 99999;
 		p->color = (-c) & 15;
@@ -435,12 +584,8 @@ void R_ParticleExplosion (vec3_t org)
 
 	for (i = 0; i < 1024; i++)
 	{
-		if (!free_particles)
+		if (!(p = R_AllocParticle ()))
 			return;
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
 
 		p->die = cl.time + 5;
 		p->color = ramp1[0];
@@ -479,12 +624,8 @@ void R_ParticleExplosion2 (vec3_t org, int colorStart, int colorLength)
 
 	for (i = 0; i < 512; i++)
 	{
-		if (!free_particles)
+		if (!(p = R_AllocParticle ()))
 			return;
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
 
 		p->die = cl.time + 0.3;
 		p->color = colorStart + (colorMod % colorLength);
@@ -511,12 +652,8 @@ void R_BlobExplosion (vec3_t org)
 
 	for (i = 0; i < 1024; i++)
 	{
-		if (!free_particles)
+		if (!(p = R_AllocParticle ()))
 			return;
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
 
 		p->die = cl.time + 1 + (COM_Rand () & 8) * 0.05;
 
@@ -555,12 +692,8 @@ void R_RunParticleEffect (vec3_t org, vec3_t dir, int color, int count)
 
 	for (i = 0; i < count; i++)
 	{
-		if (!free_particles)
+		if (!(p = R_AllocParticle ()))
 			return;
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
 
 		if (count == 1024)
 		{ // rocket explosion
@@ -616,12 +749,8 @@ void R_LavaSplash (vec3_t org)
 		for (j = -16; j < 16; j++)
 			for (k = 0; k < 1; k++)
 			{
-				if (!free_particles)
+				if (!(p = R_AllocParticle ()))
 					return;
-				p = free_particles;
-				free_particles = p->next;
-				p->next = active_particles;
-				active_particles = p;
 
 				p->die = cl.time + 2 + (COM_Rand () & 31) * 0.02;
 				p->color = 224 + (COM_Rand () & 7);
@@ -657,12 +786,8 @@ void R_TeleportSplash (vec3_t org)
 		for (j = -16; j < 16; j += 4)
 			for (k = -24; k < 32; k += 4)
 			{
-				if (!free_particles)
+				if (!(p = R_AllocParticle ()))
 					return;
-				p = free_particles;
-				free_particles = p->next;
-				p->next = active_particles;
-				active_particles = p;
 
 				p->die = cl.time + 0.2 + (COM_Rand () & 7) * 0.02;
 				p->color = 7 + (COM_Rand () & 7);
@@ -712,12 +837,8 @@ void R_RocketTrail (vec3_t start, vec3_t end, int type)
 	{
 		len -= dec;
 
-		if (!free_particles)
+		if (!(p = R_AllocParticle ()))
 			return;
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
 
 		VectorCopy (vec3_origin, p->vel);
 		p->die = cl.time + 2;
@@ -794,17 +915,18 @@ void R_RocketTrail (vec3_t start, vec3_t end, int type)
 
 /*
 ===============
-CL_RunParticles -- johnfitz -- all the particle behavior, separated from R_DrawParticles
+R_SimulateParticles
+
+Moves the particles of a list by frametime and returns the ones that died at time to the free list
 ===============
 */
-void CL_RunParticles (void)
+static void R_SimulateParticles (particle_t **active, particle_t **free, double time, float frametime)
 {
 	particle_t	 *p, *kill;
 	int			  i;
-	float		  time1, time2, time3, dvel, frametime, grav;
+	float		  time1, time2, time3, dvel, grav;
 	extern cvar_t sv_gravity;
 
-	frametime = q_max (0.0, cl.time - cl.oldtime);
 	time3 = frametime * 15;
 	time2 = frametime * 10;
 	time1 = frametime * 5;
@@ -813,27 +935,27 @@ void CL_RunParticles (void)
 
 	for (;;)
 	{
-		kill = active_particles;
-		if (kill && kill->die < cl.time)
+		kill = *active;
+		if (kill && kill->die < time)
 		{
-			active_particles = kill->next;
-			kill->next = free_particles;
-			free_particles = kill;
+			*active = kill->next;
+			kill->next = *free;
+			*free = kill;
 			continue;
 		}
 		break;
 	}
 
-	for (p = active_particles; p; p = p->next)
+	for (p = *active; p; p = p->next)
 	{
 		for (;;)
 		{
 			kill = p->next;
-			if (kill && kill->die < cl.time)
+			if (kill && kill->die < time)
 			{
 				p->next = kill->next;
-				kill->next = free_particles;
-				free_particles = kill;
+				kill->next = *free;
+				*free = kill;
 				continue;
 			}
 			break;
@@ -898,6 +1020,221 @@ void CL_RunParticles (void)
 	}
 }
 
+/*
+===============
+CL_RunParticles -- johnfitz -- all the particle behavior, separated from R_DrawParticles
+===============
+*/
+void CL_RunParticles (void)
+{
+	if (r_gpuparticles.value)
+		return; // R_UpdateParticles simulates on the GPU
+
+	R_SimulateParticles (&active_particles, &free_particles, cl.time, q_max (0.0, cl.time - cl.oldtime));
+}
+
+#define BENCH_NUM_PARTICLES	 16384
+#define BENCH_PARTICLE_STEPS 16 // the ramps of the shortest lived types end after ~40 steps
+
+typedef struct
+{
+	particle_t	initial[BENCH_NUM_PARTICLES];
+	particle_t	particles[BENCH_NUM_PARTICLES];
+	particle_t *active;
+	particle_t *free;
+	int			steps;
+} bench_particles_t;
+
+/*
+===============
+R_BenchParticlesSetup
+
+A list with every particle type in equal parts that outlives the benchmark, reset every few steps
+===============
+*/
+static qboolean R_BenchParticlesSetup (void **data)
+{
+	bench_particles_t *bench = (bench_particles_t *)Mem_Alloc (sizeof (bench_particles_t));
+	int				   i, j;
+
+	COM_SeedRand (0);
+	for (i = 0; i < BENCH_NUM_PARTICLES; i++)
+	{
+		particle_t *p = &bench->initial[i];
+		p->type = (ptype_t)(i % (pt_blob2 + 1));
+		p->die = FLT_MAX;
+		p->color = COM_Rand () & 0xFF;
+		for (j = 0; j < 3; j++)
+		{
+			p->org[j] = (COM_Rand () % 512) - 256;
+			p->vel[j] = (COM_Rand () % 512) - 256;
+		}
+	}
+	bench->steps = BENCH_PARTICLE_STEPS;
+	*data = bench;
+	return true;
+}
+
+static void R_BenchParticlesShutdown (void *data)
+{
+	Mem_Free (data);
+}
+
+static void R_BenchParticles (void *data, int count)
+{
+	bench_particles_t *bench = (bench_particles_t *)data;
+	int				   i;
+
+	for (i = 0; i < count; i++)
+	{
+		if (bench->steps++ == BENCH_PARTICLE_STEPS)
+		{
+			memcpy (bench->particles, bench->initial, sizeof (bench->particles));
+			for (int j = 0; j < BENCH_NUM_PARTICLES - 1; j++)
+				bench->particles[j].next = &bench->particles[j + 1];
+			bench->particles[BENCH_NUM_PARTICLES - 1].next = NULL;
+			bench->active = bench->particles;
+			bench->free = NULL;
+			bench->steps = 1;
+		}
+		R_SimulateParticles (&bench->active, &bench->free, 0.0, 1.0f / 72.0f);
+	}
+}
+
+/*
+===============
+R_UploadParticleSpawns
+
+Copies the spawns of this frame to the ring of GPU particles, overwriting the oldest ones once it is full
+===============
+*/
+static void R_UploadParticleSpawns (cb_context_t *cbx)
+{
+	for (int i = 0; i < num_gpu_particle_spawns; ++i)
+	{
+		const particle_t *p = &gpu_particle_spawns[i];
+		gpu_particle_t	 *dst = &gpu_particle_upload[i];
+		VectorCopy (p->org, dst->org);
+		VectorCopy (p->vel, dst->vel);
+		dst->die = p->die;
+		dst->ramp = p->ramp;
+		dst->color_type = ((uint32_t)p->color & 0xFF) | ((uint32_t)p->type << 8);
+		gpu_particle_max_die = q_max (gpu_particle_max_die, p->die);
+	}
+
+	int uploaded = 0;
+	while (uploaded < num_gpu_particle_spawns)
+	{
+		const int count = q_min (q_min (num_gpu_particle_spawns - uploaded, r_numparticles - gpu_particle_head), (int)GPU_PARTICLE_MAX_UPDATE_PARTICLES);
+		vkCmdUpdateBuffer (
+			cbx->cb, gpu_particle_buffer, gpu_particle_head * sizeof (gpu_particle_t), count * sizeof (gpu_particle_t), &gpu_particle_upload[uploaded]);
+		uploaded += count;
+		gpu_particle_head = (gpu_particle_head + count) % r_numparticles;
+	}
+
+	num_gpu_particle_spawns = 0;
+}
+
+/*
+===============
+R_UpdateParticles
+
+Simulates the GPU particles and writes their vertices and indirect draw for R_DrawParticles
+===============
+*/
+void R_UpdateParticles (void *unused)
+{
+	gpu_particles_visible = false;
+	if (!r_gpuparticles.value)
+		return;
+
+	const float frametime = q_max (0.0, cl.time - gpu_particle_time);
+	gpu_particle_time = cl.time;
+	if (!gpu_particle_clear && (num_gpu_particle_spawns == 0) && (cl.time > gpu_particle_max_die))
+		return; // nothing alive
+
+	cb_context_t *cbx = &vulkan_globals.primary_cb_contexts[PCBX_UPDATE_PARTICLES];
+	R_BeginDebugUtilsLabel (cbx, "Update Particles");
+
+	{
+		// The previous frame may still be simulating or drawing
+		ZEROED_STRUCT (VkMemoryBarrier, memory_barrier);
+		memory_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		memory_barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		memory_barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+		vulkan_globals.vk_cmd_pipeline_barrier (
+			cbx->cb, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+			VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memory_barrier, 0, NULL, 0, NULL);
+	}
+
+	if (gpu_particle_clear)
+	{
+		vkCmdFillBuffer (cbx->cb, gpu_particle_buffer, 0, VK_WHOLE_SIZE, 0);
+
+		ZEROED_STRUCT (VkMemoryBarrier, memory_barrier);
+		memory_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		memory_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		memory_barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		vulkan_globals.vk_cmd_pipeline_barrier (
+			cbx->cb, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &memory_barrier, 0, NULL, 0, NULL);
+		gpu_particle_clear = false;
+	}
+
+	if (!gpu_particle_palette)
+	{
+		vkCmdUpdateBuffer (cbx->cb, gpu_particle_palette_buffer, 0, sizeof (d_8to24table), d_8to24table);
+		gpu_particle_palette = true;
+	}
+
+	R_UploadParticleSpawns (cbx);
+
+	{
+		const uint32_t indirect[GPU_PARTICLE_INDIRECT_SIZE / sizeof (uint32_t)] = {0, 1, 0, 0, 0, 0, 1, 0, 0};
+		vkCmdUpdateBuffer (cbx->cb, gpu_particle_indirect_buffer, 0, sizeof (indirect), indirect);
+
+		ZEROED_STRUCT (VkMemoryBarrier, memory_barrier);
+		memory_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		memory_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		memory_barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+		vulkan_globals.vk_cmd_pipeline_barrier (
+			cbx->cb, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memory_barrier, 0, NULL, 0, NULL);
+	}
+
+	extern cvar_t sv_gravity;
+	ZEROED_STRUCT (update_particles_push_constants_t, push_constants);
+	const float up_right_scale = r_quadparticles.value ? 0.75f : 1.5f;
+	VectorScale (vup, up_right_scale, push_constants.up);
+	VectorScale (vright, up_right_scale, push_constants.right);
+	VectorCopy (vpn, push_constants.forward);
+	push_constants.up[3] = r_quadparticles.value ? 0.5f : 1.0f;
+	push_constants.right[3] = texturescalefactor;
+	push_constants.forward[3] = DotProduct (r_origin, vpn);
+	push_constants.time = cl.time;
+	push_constants.frametime = frametime;
+	push_constants.grav = frametime * sv_gravity.value * 0.05f;
+	push_constants.num_particles = r_numparticles;
+	push_constants.quads = r_quadparticles.value ? 1 : 0;
+
+	R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_COMPUTE, vulkan_globals.update_particles_pipeline);
+	vkCmdBindDescriptorSets (
+		cbx->cb, VK_PIPELINE_BIND_POINT_COMPUTE, vulkan_globals.update_particles_pipeline.layout.handle, 0, 1, &gpu_particle_desc_set, 0, NULL);
+	R_PushConstants (cbx, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof (push_constants), &push_constants);
+	vkCmdDispatch (cbx->cb, (r_numparticles + 63) / 64, 1, 1);
+
+	{
+		ZEROED_STRUCT (VkMemoryBarrier, memory_barrier);
+		memory_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		memory_barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		memory_barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+		vulkan_globals.vk_cmd_pipeline_barrier (
+			cbx->cb, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0, 1, &memory_barrier,
+			0, NULL, 0, NULL);
+	}
+
+	R_EndDebugUtilsLabel (cbx);
+	gpu_particles_visible = true;
+}
+
 /*
 ===============
 R_DrawParticlesFaces
@@ -913,6 +1250,22 @@ static void R_DrawParticlesFaces (cb_context_t *cbx)
 	if (!r_particles.value)
 		return;
 
+	if (r_gpuparticles.value)
+	{
+		if (!gpu_particles_visible)
+			return;
+		const VkDeviceSize vertex_buffer_offset = 0;
+		vulkan_globals.vk_cmd_bind_vertex_buffers (cbx->cb, 0, 1, &gpu_particle_vertex_buffer, &vertex_buffer_offset);
+		if (r_quadparticles.value)
+		{
+			vulkan_globals.vk_cmd_bind_index_buffer (cbx->cb, particle_index_buffer, 0, VK_INDEX_TYPE_UINT16);
+			vulkan_globals.vk_cmd_draw_indexed_indirect (cbx->cb, gpu_particle_indirect_buffer, 0, 1, sizeof (VkDrawIndexedIndirectCommand));
+		}
+		else
+			vkCmdDrawIndirect (cbx->cb, gpu_particle_indirect_buffer, sizeof (VkDrawIndexedIndirectCommand), 1, sizeof (VkDrawIndirectCommand));
+		return;
+	}
+
 	if (!active_particles)
 		return;
 
@@ -461,6 +461,25 @@ static particle_t *particles; // contains the initial list of alloced particles.
 static int		   r_numparticles;
 static int		   r_particlerecycle;
 
+// Live particles of types without emitters, clipping or beams are simulated by PScript_SimulateParticles
+typedef struct
+{
+	part_type_t *type;
+	unsigned int first_particle; // index into simulated_particles
+	unsigned int num_particles;
+	unsigned int first_vert;
+	unsigned int first_idx;
+	unsigned int base_vert; // firstvert of the scenetris the indices are relative to
+} particle_batch_t;
+
+static particle_t	   **simulated_particles;
+static unsigned int		 num_simulated_particles;
+static particle_batch_t *particle_batches;
+static unsigned int		 num_particle_batches;
+static unsigned int		 max_particle_batches;
+static float			 simulated_frametime;
+static float			 simulated_particletime;
+
 static beamseg_t *free_beams;
 static beamseg_t *beams;
 static int		  r_numbeams;
@@ -3212,6 +3231,10 @@ void PScript_Shutdown (void)
 
 	Mem_Free (particles);
 	particles = NULL;
+	Mem_Free (simulated_particles);
+	simulated_particles = NULL;
+	num_simulated_particles = 0;
+	num_particle_batches = 0;
 	Mem_Free (beams);
 	beams = NULL;
 	Mem_Free (decals);
@@ -3255,6 +3278,7 @@ qboolean PScript_Startup (void)
 		r_numtrailstates = MAX_TRAILSTATES;
 
 		particles = (particle_t *)Mem_Alloc (r_numparticles * sizeof (particle_t));
+		simulated_particles = (particle_t **)Mem_Alloc (r_numparticles * sizeof (particle_t *));
 
 		beams = (beamseg_t *)Mem_Alloc (r_numbeams * sizeof (beamseg_t));
 
@@ -5962,13 +5986,10 @@ static void R_AddUnclippedDecal (scenetris_t *t, particle_t *p, plooks_t *type)
 	t->numidx += 6;
 }
 
-static void R_AddTexturedParticle (scenetris_t *t, particle_t *p, plooks_t *type)
+static void R_WriteTexturedParticle (basicvertex_t *verts, particle_t *p, plooks_t *type)
 {
 	float scale, x, y;
 
-	if (cl_numstrisvert + 4 > cl_maxstrisvert[current_buffer_index])
-		ReallocateVertexBuffer ();
-
 	if (type->scalefactor == 1)
 		scale = p->scale * 0.25;
 	else
@@ -5991,59 +6012,73 @@ static void R_AddTexturedParticle (scenetris_t *t, particle_t *p, plooks_t *type
 		rgba[1] = p->rgba[1] * a;
 		rgba[2] = p->rgba[2] * a;
 		rgba[3] = (type->premul == 2) ? 0 : a;
-		Vector4ToColor (rgba, cl_curstrisvert[cl_numstrisvert + 0].color);
-		Vector4ToColor (rgba, cl_curstrisvert[cl_numstrisvert + 1].color);
-		Vector4ToColor (rgba, cl_curstrisvert[cl_numstrisvert + 2].color);
-		Vector4ToColor (rgba, cl_curstrisvert[cl_numstrisvert + 3].color);
+		Vector4ToColor (rgba, verts[0].color);
+		Vector4ToColor (rgba, verts[1].color);
+		Vector4ToColor (rgba, verts[2].color);
+		Vector4ToColor (rgba, verts[3].color);
 	}
 	else
 	{
-		Vector4ToColor (p->rgba, cl_curstrisvert[cl_numstrisvert + 0].color);
-		Vector4ToColor (p->rgba, cl_curstrisvert[cl_numstrisvert + 1].color);
-		Vector4ToColor (p->rgba, cl_curstrisvert[cl_numstrisvert + 2].color);
-		Vector4ToColor (p->rgba, cl_curstrisvert[cl_numstrisvert + 3].color);
+		Vector4ToColor (p->rgba, verts[0].color);
+		Vector4ToColor (p->rgba, verts[1].color);
+		Vector4ToColor (p->rgba, verts[2].color);
+		Vector4ToColor (p->rgba, verts[3].color);
 	}
 
-	Vector2Set (cl_curstrisvert[cl_numstrisvert + 0].texcoord, p->s1, p->t1);
-	Vector2Set (cl_curstrisvert[cl_numstrisvert + 1].texcoord, p->s1, p->t2);
-	Vector2Set (cl_curstrisvert[cl_numstrisvert + 2].texcoord, p->s2, p->t2);
-	Vector2Set (cl_curstrisvert[cl_numstrisvert + 3].texcoord, p->s2, p->t1);
+	Vector2Set (verts[0].texcoord, p->s1, p->t1);
+	Vector2Set (verts[1].texcoord, p->s1, p->t2);
+	Vector2Set (verts[2].texcoord, p->s2, p->t2);
+	Vector2Set (verts[3].texcoord, p->s2, p->t1);
 
 	if (p->angle)
 	{
 		x = sin (p->angle) * scale;
 		y = cos (p->angle) * scale;
 
-		cl_curstrisvert[cl_numstrisvert + 0].position[0] = p->org[0] - x * pright[0] - y * pup[0];
-		cl_curstrisvert[cl_numstrisvert + 0].position[1] = p->org[1] - x * pright[1] - y * pup[1];
-		cl_curstrisvert[cl_numstrisvert + 0].position[2] = p->org[2] - x * pright[2] - y * pup[2];
-		cl_curstrisvert[cl_numstrisvert + 1].position[0] = p->org[0] - y * pright[0] + x * pup[0];
-		cl_curstrisvert[cl_numstrisvert + 1].position[1] = p->org[1] - y * pright[1] + x * pup[1];
-		cl_curstrisvert[cl_numstrisvert + 1].position[2] = p->org[2] - y * pright[2] + x * pup[2];
-		cl_curstrisvert[cl_numstrisvert + 2].position[0] = p->org[0] + x * pright[0] + y * pup[0];
-		cl_curstrisvert[cl_numstrisvert + 2].position[1] = p->org[1] + x * pright[1] + y * pup[1];
-		cl_curstrisvert[cl_numstrisvert + 2].position[2] = p->org[2] + x * pright[2] + y * pup[2];
-		cl_curstrisvert[cl_numstrisvert + 3].position[0] = p->org[0] + y * pright[0] - x * pup[0];
-		cl_curstrisvert[cl_numstrisvert + 3].position[1] = p->org[1] + y * pright[1] - x * pup[1];
-		cl_curstrisvert[cl_numstrisvert + 3].position[2] = p->org[2] + y * pright[2] - x * pup[2];
+		verts[0].position[0] = p->org[0] - x * pright[0] - y * pup[0];
+		verts[0].position[1] = p->org[1] - x * pright[1] - y * pup[1];
+		verts[0].position[2] = p->org[2] - x * pright[2] - y * pup[2];
+		verts[1].position[0] = p->org[0] - y * pright[0] + x * pup[0];
+		verts[1].position[1] = p->org[1] - y * pright[1] + x * pup[1];
+		verts[1].position[2] = p->org[2] - y * pright[2] + x * pup[2];
+		verts[2].position[0] = p->org[0] + x * pright[0] + y * pup[0];
+		verts[2].position[1] = p->org[1] + x * pright[1] + y * pup[1];
+		verts[2].position[2] = p->org[2] + x * pright[2] + y * pup[2];
+		verts[3].position[0] = p->org[0] + y * pright[0] - x * pup[0];
+		verts[3].position[1] = p->org[1] + y * pright[1] - x * pup[1];
+		verts[3].position[2] = p->org[2] + y * pright[2] - x * pup[2];
 	}
 	else
 	{
-		VectorMA (p->org, -scale, pup, cl_curstrisvert[cl_numstrisvert + 0].position);
-		VectorMA (p->org, -scale, pright, cl_curstrisvert[cl_numstrisvert + 1].position);
-		VectorMA (p->org, scale, pup, cl_curstrisvert[cl_numstrisvert + 2].position);
-		VectorMA (p->org, scale, pright, cl_curstrisvert[cl_numstrisvert + 3].position);
+		VectorMA (p->org, -scale, pup, verts[0].position);
+		VectorMA (p->org, -scale, pright, verts[1].position);
+		VectorMA (p->org, scale, pup, verts[2].position);
+		VectorMA (p->org, scale, pright, verts[3].position);
 	}
+}
+
+static void R_WriteQuadIndices (unsigned short *indices, unsigned int first)
+{
+	indices[0] = first + 0;
+	indices[1] = first + 1;
+	indices[2] = first + 2;
+	indices[3] = first + 0;
+	indices[4] = first + 2;
+	indices[5] = first + 3;
+}
+
+static void R_AddTexturedParticle (scenetris_t *t, particle_t *p, plooks_t *type)
+{
+	if (cl_numstrisvert + 4 > cl_maxstrisvert[current_buffer_index])
+		ReallocateVertexBuffer ();
+
+	R_WriteTexturedParticle (&cl_curstrisvert[cl_numstrisvert], p, type);
 
 	if (cl_numstrisidx + 6 > cl_maxstrisidx[current_buffer_index])
 		ReallocateIndexBuffer ();
 
-	cl_curstrisidx[cl_numstrisidx++] = (cl_numstrisvert - t->firstvert) + 0;
-	cl_curstrisidx[cl_numstrisidx++] = (cl_numstrisvert - t->firstvert) + 1;
-	cl_curstrisidx[cl_numstrisidx++] = (cl_numstrisvert - t->firstvert) + 2;
-	cl_curstrisidx[cl_numstrisidx++] = (cl_numstrisvert - t->firstvert) + 0;
-	cl_curstrisidx[cl_numstrisidx++] = (cl_numstrisvert - t->firstvert) + 2;
-	cl_curstrisidx[cl_numstrisidx++] = (cl_numstrisvert - t->firstvert) + 3;
+	R_WriteQuadIndices (&cl_curstrisidx[cl_numstrisidx], cl_numstrisvert - t->firstvert);
+	cl_numstrisidx += 6;
 
 	cl_numstrisvert += 4;
 
@@ -6051,7 +6086,314 @@ static void R_AddTexturedParticle (scenetris_t *t, particle_t *p, plooks_t *type
 	t->numidx += 6;
 }
 
-static void PScript_DrawParticleTypes (cb_context_t *cbx, float pframetime)
+/*
+===============
+P_RunParticleRamp
+
+Applies the colour, alpha and scale ramps of a particle type
+===============
+*/
+static void P_RunParticleRamp (part_type_t *type, particle_t *p, float pframetime, float ptime)
+{
+	ramp_t *ramp;
+	int		rampind;
+
+	switch (type->rampmode)
+	{
+	case RAMP_NEAREST:
+		rampind = (int)(type->rampindexes * (type->die - (p->die - ptime)) / type->die);
+		if (rampind >= type->rampindexes)
+			rampind = type->rampindexes - 1;
+		ramp = type->ramp + rampind;
+		VectorCopy (ramp->rgb, p->rgba);
+		p->rgba[3] = ramp->alpha;
+		p->scale = ramp->scale;
+		break;
+	case RAMP_LERP:
+	{
+		float frac = (type->rampindexes * (type->die - (p->die - ptime)) / type->die);
+		int	  s1, s2;
+		s1 = frac;
+		s2 = s1 + 1;
+		if (s1 > type->rampindexes - 1)
+			s1 = type->rampindexes - 1;
+		if (s2 > type->rampindexes - 1)
+			s2 = type->rampindexes - 1;
+		frac -= s1;
+		VectorInterpolate (type->ramp[s1].rgb, frac, type->ramp[s2].rgb, p->rgba);
+		FloatInterpolate (type->ramp[s1].alpha, frac, type->ramp[s2].alpha, p->rgba[3]);
+		FloatInterpolate (type->ramp[s1].scale, frac, type->ramp[s2].scale, p->scale);
+	}
+	break;
+	case RAMP_DELTA: // particle ramps
+		rampind = (int)(type->rampindexes * (type->die - (p->die - ptime)) / type->die);
+		if (rampind >= type->rampindexes)
+			rampind = type->rampindexes - 1;
+		ramp = type->ramp + rampind;
+		VectorMA (p->rgba, pframetime, ramp->rgb, p->rgba);
+		p->rgba[3] -= pframetime * ramp->alpha;
+		p->scale += pframetime * ramp->scale;
+		break;
+	case RAMP_NONE: // particle changes acording to it's preset properties.
+		if (ptime < (p->die - type->die + type->rgbchangetime))
+		{
+			p->rgba[0] += pframetime * type->rgbchange[0];
+			p->rgba[1] += pframetime * type->rgbchange[1];
+			p->rgba[2] += pframetime * type->rgbchange[2];
+		}
+		p->rgba[3] += pframetime * type->alphachange;
+		p->scale += pframetime * type->scaledelta;
+	}
+}
+
+/*
+===============
+P_CanSimulateInParallel
+===============
+*/
+static qboolean P_CanSimulateInParallel (part_type_t *type, qboolean doflurry)
+{
+	if (type->looks.type != PT_NORMAL || type->emit >= 0 || type->beams)
+		return false;
+	if (type->cliptype >= 0 && r_bouncysparks.value)
+		return false;
+	return !(type->flurry && doflurry && (type->flags & PT_VELOCITY));
+}
+
+/*
+===============
+P_NewSceneTris
+
+Starts a new mesh with the same looks as the last one because its indices would overflow
+===============
+*/
+static scenetris_t *P_NewSceneTris (void)
+{
+	scenetris_t *scenetri;
+
+	if (cl_numstris == cl_maxstris)
+	{
+		cl_maxstris += 8;
+		cl_stris = Mem_Realloc (cl_stris, sizeof (*cl_stris) * cl_maxstris);
+	}
+	scenetri = &cl_stris[cl_numstris++];
+	scenetri->texture = scenetri[-1].texture;
+	scenetri->blendmode = scenetri[-1].blendmode;
+	scenetri->beflags = scenetri[-1].beflags;
+	scenetri->firstidx = cl_numstrisidx;
+	scenetri->firstvert = cl_numstrisvert;
+	scenetri->numvert = 0;
+	scenetri->numidx = 0;
+	return scenetri;
+}
+
+/*
+===============
+P_BatchParticles
+
+Kills dead particles of a type and reserves vertices and indices for the live ones.
+Their update and vertices are deferred to PScript_SimulateParticles.
+===============
+*/
+static void P_BatchParticles (part_type_t *type, scenetris_t **scenetri, particle_t **kill_list, particle_t **kill_first)
+{
+	particle_t	*p, *kill;
+	unsigned int first_particle = num_simulated_particles;
+
+	for (p = type->particles; p; p = p->next)
+	{
+		for (;;)
+		{
+			kill = p->next;
+			if (kill && kill->die < particletime)
+			{
+				if (type->emittime < 0)
+					PScript_DelinkTrailstate (&kill->state.trailstate);
+				p->next = kill->next;
+				kill->next = *kill_list;
+				*kill_list = kill;
+				if (!*kill_first)
+					*kill_first = kill;
+				continue;
+			}
+			break;
+		}
+		simulated_particles[num_simulated_particles++] = p;
+	}
+
+	unsigned int remaining = num_simulated_particles - first_particle;
+	while (remaining > 0)
+	{
+		if (cl_numstrisvert - (*scenetri)->firstvert >= MAX_INDICES - 6)
+			*scenetri = P_NewSceneTris ();
+
+		// Same limit as the per particle check: a quad may start on any vertex below MAX_INDICES - 6
+		const unsigned int space = (MAX_INDICES - 6 - (cl_numstrisvert - (*scenetri)->firstvert) + 3) / 4;
+		const unsigned int count = q_min (remaining, space);
+		while (cl_numstrisvert + count * 4 > cl_maxstrisvert[current_buffer_index])
+			ReallocateVertexBuffer ();
+		while (cl_numstrisidx + count * 6 > cl_maxstrisidx[current_buffer_index])
+			ReallocateIndexBuffer ();
+
+		if (num_particle_batches == max_particle_batches)
+		{
+			max_particle_batches = q_max (max_particle_batches * 2, 64);
+			particle_batches = Mem_Realloc (particle_batches, sizeof (*particle_batches) * max_particle_batches);
+		}
+		particle_batch_t *batch = &particle_batches[num_particle_batches++];
+		batch->type = type;
+		batch->first_particle = first_particle;
+		batch->num_particles = count;
+		batch->first_vert = cl_numstrisvert;
+		batch->first_idx = cl_numstrisidx;
+		batch->base_vert = (*scenetri)->firstvert;
+
+		cl_numstrisvert += count * 4;
+		cl_numstrisidx += count * 6;
+		(*scenetri)->numvert += count * 4;
+		(*scenetri)->numidx += count * 6;
+		first_particle += count;
+		remaining -= count;
+	}
+}
+
+/*
+===============
+P_MoveParticles
+
+Integrates velocity, gravity and friction. Particles are transposed to SoA lanes so four of them move at once.
+===============
+*/
+static void P_MoveParticles (part_type_t *type, particle_t **parts, unsigned int count, float pframetime)
+{
+	const float	 grav = type->gravity * pframetime;
+	vec3_t		 friction = {1.0f, 1.0f, 1.0f};
+	unsigned int i = 0;
+
+	if (type->flags & PT_FRICTION)
+	{
+		friction[0] = 1 - type->friction[0] * pframetime;
+		friction[1] = 1 - type->friction[1] * pframetime;
+		friction[2] = 1 - type->friction[2] * pframetime;
+	}
+
+#if defined(USE_SIMD)
+	float lanes[6][4];
+	for (; i + 4 <= count; i += 4)
+	{
+		for (int lane = 0; lane < 4; ++lane)
+		{
+			const particle_t *p = parts[i + lane];
+			for (int j = 0; j < 3; ++j)
+			{
+				lanes[j][lane] = p->org[j];
+				lanes[j + 3][lane] = p->vel[j];
+			}
+		}
+#if defined(USE_SSE2)
+		const __m128 frametime4 = _mm_set1_ps (pframetime);
+		for (int j = 0; j < 3; ++j)
+		{
+			__m128 org = _mm_loadu_ps (lanes[j]);
+			__m128 vel = _mm_loadu_ps (lanes[j + 3]);
+			org = _mm_add_ps (org, _mm_mul_ps (vel, frametime4));
+			if (j == 2)
+				vel = _mm_sub_ps (vel, _mm_set1_ps (grav));
+			vel = _mm_mul_ps (vel, _mm_set1_ps (friction[j]));
+			_mm_storeu_ps (lanes[j], org);
+			_mm_storeu_ps (lanes[j + 3], vel);
+		}
+#elif defined(USE_NEON)
+		for (int j = 0; j < 3; ++j)
+		{
+			float32x4_t org = vld1q_f32 (lanes[j]);
+			float32x4_t vel = vld1q_f32 (lanes[j + 3]);
+			org = vaddq_f32 (org, vmulq_n_f32 (vel, pframetime));
+			if (j == 2)
+				vel = vsubq_f32 (vel, vdupq_n_f32 (grav));
+			vel = vmulq_n_f32 (vel, friction[j]);
+			vst1q_f32 (lanes[j], org);
+			vst1q_f32 (lanes[j + 3], vel);
+		}
+#endif
+		for (int lane = 0; lane < 4; ++lane)
+		{
+			particle_t *p = parts[i + lane];
+			for (int j = 0; j < 3; ++j)
+			{
+				p->org[j] = lanes[j][lane];
+				p->vel[j] = lanes[j + 3][lane];
+			}
+		}
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		particle_t *p = parts[i];
+		p->org[0] += p->vel[0] * pframetime;
+		p->org[1] += p->vel[1] * pframetime;
+		p->org[2] += p->vel[2] * pframetime;
+		p->vel[2] -= grav;
+		p->vel[0] *= friction[0];
+		p->vel[1] *= friction[1];
+		p->vel[2] *= friction[2];
+	}
+}
+
+/*
+===============
+P_SimulateParticleBatch
+===============
+*/
+static void P_SimulateParticleBatch (const particle_batch_t *batch, unsigned int begin, unsigned int end)
+{
+	part_type_t *type = batch->type;
+	particle_t **parts = simulated_particles + batch->first_particle;
+	const float	 pframetime = simulated_frametime;
+
+	if (type->flags & PT_VELOCITY)
+		P_MoveParticles (type, parts + begin, end - begin, pframetime); // no flurry, see P_CanSimulateInParallel
+
+	for (unsigned int i = begin; i < end; ++i)
+	{
+		particle_t *p = parts[i];
+		p->angle += p->rotationspeed * pframetime;
+		P_RunParticleRamp (type, p, pframetime, simulated_particletime);
+		R_WriteTexturedParticle (&cl_curstrisvert[batch->first_vert + i * 4], p, type->slooks);
+		R_WriteQuadIndices (&cl_curstrisidx[batch->first_idx + i * 6], batch->first_vert - batch->base_vert + i * 4);
+	}
+}
+
+/*
+===============
+PScript_SimulateParticles
+
+Updates and writes the vertices of one slice of the particles batched by PScript_UpdateParticles
+===============
+*/
+void PScript_SimulateParticles (int index, void *use_tasks)
+{
+	const unsigned int num_slices = use_tasks ? NUM_FTE_PARTICLE_TASKS : 1;
+	const unsigned int begin = ((uint64_t)num_simulated_particles * index) / num_slices;
+	const unsigned int end = ((uint64_t)num_simulated_particles * (index + 1)) / num_slices;
+
+	for (unsigned int i = 0; i < num_particle_batches; ++i)
+	{
+		const particle_batch_t *batch = &particle_batches[i];
+		const unsigned int		batch_begin = q_max (begin, batch->first_particle);
+		const unsigned int		batch_end = q_min (end, batch->first_particle + batch->num_particles);
+		if (batch_begin < batch_end)
+			P_SimulateParticleBatch (batch, batch_begin - batch->first_particle, batch_end - batch->first_particle);
+	}
+}
+
+/*
+===============
+PScript_RunParticleTypes
+===============
+*/
+static void PScript_RunParticleTypes (float pframetime)
 {
 	void (*bdraw) (scenetris_t *t, beamseg_t *p, plooks_t *type);
 	void (*tdraw) (scenetris_t *t, particle_t *p, plooks_t *type);
@@ -6076,7 +6418,7 @@ static void PScript_DrawParticleTypes (cb_context_t *cbx, float pframetime)
 	static float flurrytime;
 	qboolean	 doflurry;
 	int			 batchflags;
-	unsigned int i, o;
+	unsigned int i;
 
 	if (r_plooksdirty)
 	{
@@ -6435,7 +6777,14 @@ static void PScript_DrawParticleTypes (cb_context_t *cbx, float pframetime)
 		friction[1] = 1 - type->friction[1] * pframetime;
 		friction[2] = 1 - type->friction[2] * pframetime;
 
-		for (p = type->particles; p; p = p->next)
+		p = type->particles;
+		if (scenetri && tdraw && P_CanSimulateInParallel (type, doflurry))
+		{
+			P_BatchParticles (type, &scenetri, &kill_list, &kill_first);
+			p = NULL;
+		}
+
+		for (; p; p = p->next)
 		{
 			if (type->emittime < 0)
 			{
@@ -6495,52 +6844,7 @@ static void PScript_DrawParticleTypes (cb_context_t *cbx, float pframetime)
 
 			p->angle += p->rotationspeed * pframetime;
 
-			switch (type->rampmode)
-			{
-			case RAMP_NEAREST:
-				rampind = (int)(type->rampindexes * (type->die - (p->die - particletime)) / type->die);
-				if (rampind >= type->rampindexes)
-					rampind = type->rampindexes - 1;
-				ramp = type->ramp + rampind;
-				VectorCopy (ramp->rgb, p->rgba);
-				p->rgba[3] = ramp->alpha;
-				p->scale = ramp->scale;
-				break;
-			case RAMP_LERP:
-			{
-				float frac = (type->rampindexes * (type->die - (p->die - particletime)) / type->die);
-				int	  s1, s2;
-				s1 = frac;
-				s2 = s1 + 1;
-				if (s1 > type->rampindexes - 1)
-					s1 = type->rampindexes - 1;
-				if (s2 > type->rampindexes - 1)
-					s2 = type->rampindexes - 1;
-				frac -= s1;
-				VectorInterpolate (type->ramp[s1].rgb, frac, type->ramp[s2].rgb, p->rgba);
-				FloatInterpolate (type->ramp[s1].alpha, frac, type->ramp[s2].alpha, p->rgba[3]);
-				FloatInterpolate (type->ramp[s1].scale, frac, type->ramp[s2].scale, p->scale);
-			}
-			break;
-			case RAMP_DELTA: // particle ramps
-				rampind = (int)(type->rampindexes * (type->die - (p->die - particletime)) / type->die);
-				if (rampind >= type->rampindexes)
-					rampind = type->rampindexes - 1;
-				ramp = type->ramp + rampind;
-				VectorMA (p->rgba, pframetime, ramp->rgb, p->rgba);
-				p->rgba[3] -= pframetime * ramp->alpha;
-				p->scale += pframetime * ramp->scale;
-				break;
-			case RAMP_NONE: // particle changes acording to it's preset properties.
-				if (particletime < (p->die - type->die + type->rgbchangetime))
-				{
-					p->rgba[0] += pframetime * type->rgbchange[0];
-					p->rgba[1] += pframetime * type->rgbchange[1];
-					p->rgba[2] += pframetime * type->rgbchange[2];
-				}
-				p->rgba[3] += pframetime * type->alphachange;
-				p->scale += pframetime * type->scaledelta;
-			}
+			P_RunParticleRamp (type, p, pframetime, particletime);
 
 			if (type->emit >= 0)
 			{
@@ -6772,50 +7076,20 @@ static void PScript_DrawParticleTypes (cb_context_t *cbx, float pframetime)
 		free_particles = kill_list;
 	}
 
+	simulated_frametime = pframetime;
+	simulated_particletime = particletime;
 	particletime += pframetime;
-
-	if (!cl_numstris)
-		return;
-
-	R_BeginDebugUtilsLabel (cbx, "FTE Particles");
-	Fog_DisableGFog (cbx);
-
-	for (o = 0; o < 3; o++)
-	{
-		static int blend_modes_order[] = {1, 1, 2, 2, 0, 0, 0, 2};
-		for (i = 0; i < cl_numstris; i++)
-		{
-			scenetris_t *tris = &cl_stris[i];
-			const int	 blend_mode = tris->blendmode;
-			if (blend_modes_order[blend_mode] != o)
-				continue;
-			const qboolean draw_lines = ((tris->beflags & BEF_LINES) != 0);
-			if (!vulkan_globals.non_solid_fill && draw_lines)
-				continue; // Can't draw lines
-			if (tris->numidx == 0)
-				continue;
-
-			const vulkan_pipeline_t pipeline = vulkan_globals.fte_particle_pipelines[blend_mode + (draw_lines ? 8 : 0)];
-			R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
-			gltexture_t *tex = (tris->beflags & BEF_LINES) ? whitetexture : tris->texture;
-
-			const int		   num_indices = tris->numidx;
-			const VkDeviceSize vertex_buffer_offset = 0;
-			vulkan_globals.vk_cmd_bind_index_buffer (cbx->cb, index_buffers[current_buffer_index], 0, VK_INDEX_TYPE_UINT16);
-			vulkan_globals.vk_cmd_bind_vertex_buffers (cbx->cb, 0, 1, &vertex_buffers[current_buffer_index], &vertex_buffer_offset);
-			vulkan_globals.vk_cmd_bind_descriptor_sets (cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.layout.handle, 0, 1, &tex->descriptor_set, 0, NULL);
-			vulkan_globals.vk_cmd_draw_indexed (cbx->cb, num_indices, 1, tris->firstidx, tris->firstvert, 0);
-		}
-	}
-	R_EndDebugUtilsLabel (cbx);
 }
 
 /*
 ===============
-PScript_DrawParticles
+PScript_UpdateParticles
+
+Runs emitters, collisions and everything else about particles that has to be serial, the
+remaining particle updates and vertices are left to PScript_SimulateParticles.
 ===============
 */
-void PScript_DrawParticles (cb_context_t *cbx)
+void PScript_UpdateParticles (void *unused)
 {
 	int			 i;
 	entity_t	*ent;
@@ -6836,6 +7110,8 @@ void PScript_DrawParticles (cb_context_t *cbx)
 	cl_numstrisidx = 0;
 	cl_curstrisvert = cl_strisvert[current_buffer_index];
 	cl_curstrisidx = cl_strisidx[current_buffer_index];
+	num_simulated_particles = 0;
+	num_particle_batches = 0;
 
 	if (!r_particles.value)
 		return;
@@ -6856,7 +7132,52 @@ void PScript_DrawParticles (cb_context_t *cbx)
 		}
 	}
 
-	PScript_DrawParticleTypes (cbx, pframetime);
+	PScript_RunParticleTypes (pframetime);
+}
+
+/*
+===============
+PScript_DrawParticles
+===============
+*/
+void PScript_DrawParticles (cb_context_t *cbx)
+{
+	unsigned int i, o;
+
+	if (!cl_numstris)
+		return;
+
+	R_BeginDebugUtilsLabel (cbx, "FTE Particles");
+	Fog_DisableGFog (cbx);
+
+	for (o = 0; o < 3; o++)
+	{
+		static int blend_modes_order[] = {1, 1, 2, 2, 0, 0, 0, 2};
+		for (i = 0; i < cl_numstris; i++)
+		{
+			scenetris_t *tris = &cl_stris[i];
+			const int	 blend_mode = tris->blendmode;
+			if (blend_modes_order[blend_mode] != o)
+				continue;
+			const qboolean draw_lines = ((tris->beflags & BEF_LINES) != 0);
+			if (!vulkan_globals.non_solid_fill && draw_lines)
+				continue; // Can't draw lines
+			if (tris->numidx == 0)
+				continue;
+
+			const vulkan_pipeline_t pipeline = vulkan_globals.fte_particle_pipelines[blend_mode + (draw_lines ? 8 : 0)];
+			R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+			gltexture_t *tex = (tris->beflags & BEF_LINES) ? whitetexture : tris->texture;
+
+			const int		   num_indices = tris->numidx;
+			const VkDeviceSize vertex_buffer_offset = 0;
+			vulkan_globals.vk_cmd_bind_index_buffer (cbx->cb, index_buffers[current_buffer_index], 0, VK_INDEX_TYPE_UINT16);
+			vulkan_globals.vk_cmd_bind_vertex_buffers (cbx->cb, 0, 1, &vertex_buffers[current_buffer_index], &vertex_buffer_offset);
+			vulkan_globals.vk_cmd_bind_descriptor_sets (cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.layout.handle, 0, 1, &tex->descriptor_set, 0, NULL);
+			vulkan_globals.vk_cmd_draw_indexed (cbx->cb, num_indices, 1, tris->firstidx, tris->firstvert, 0);
+		}
+	}
+	R_EndDebugUtilsLabel (cbx);
 }
 
 /*
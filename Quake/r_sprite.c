@@ -102,6 +102,8 @@ static void R_CreateSpriteVertices (entity_t *e, mspriteframe_t *frame, basicver
 	float	  *s_up, *s_right;
 	float	   angle, sr, cr;
 	float	   scale = ENTSCALE_DECODE (e->netstate.scale);
+	float	  *origin = R_GetEntityRenderState (e)->lerpdata.origin;
+	float	  *angles = R_GetEntityRenderState (e)->lerpdata.angles;
 
 	psprite = (msprite_t *)Mod_Extradata (e->model);
 
@@ -117,7 +119,7 @@ static void R_CreateSpriteVertices (entity_t *e, mspriteframe_t *frame, basicver
 		s_right = v_right;
 		break;
 	case SPR_FACING_UPRIGHT: // faces camera origin, up is towards the heavens
-		VectorSubtract (e->origin, r_origin, v_forward);
+		VectorSubtract (origin, r_origin, v_forward);
 		v_forward[2] = 0;
 		VectorNormalizeFast (v_forward);
 		v_right[0] = v_forward[1];
@@ -134,12 +136,12 @@ static void R_CreateSpriteVertices (entity_t *e, mspriteframe_t *frame, basicver
 		s_right = vright;
 		break;
 	case SPR_ORIENTED: // pitch yaw roll are independent of camera
-		AngleVectors (e->angles, v_forward, v_right, v_up);
+		AngleVectors (angles, v_forward, v_right, v_up);
 		s_up = v_up;
 		s_right = v_right;
 		break;
 	case SPR_VP_PARALLEL_ORIENTED: // faces view plane, but obeys roll value
-		angle = e->angles[ROLL] * M_PI_DIV_180;
+		angle = angles[ROLL] * M_PI_DIV_180;
 		sr = sin (angle);
 		cr = cos (angle);
 		v_right[0] = vright[0] * cr + vup[0] * sr;
@@ -157,31 +159,31 @@ static void R_CreateSpriteVertices (entity_t *e, mspriteframe_t *frame, basicver
 
 	memset (vertices, 255, 4 * sizeof (basicvertex_t));
 
-	VectorMA (e->origin, frame->down * scale, s_up, point);
+	VectorMA (origin, frame->down * scale, s_up, point);
 	VectorMA (point, frame->left * scale, s_right, point);
 	vertices[0].position[0] = point[0];
 	vertices[0].position[1] = point[1];
 	vertices[0].position[2] = point[2];
-	vertices[0].texcoord[0] = 0.0f;
+	vertices[0].texcoord[0] = frame->smin;
 	vertices[0].texcoord[1] = frame->tmax;
 
-	VectorMA (e->origin, frame->up * scale, s_up, point);
+	VectorMA (origin, frame->up * scale, s_up, point);
 	VectorMA (point, frame->left * scale, s_right, point);
 	vertices[1].position[0] = point[0];
 	vertices[1].position[1] = point[1];
 	vertices[1].position[2] = point[2];
-	vertices[1].texcoord[0] = 0.0f;
-	vertices[1].texcoord[1] = 0.0f;
+	vertices[1].texcoord[0] = frame->smin;
+	vertices[1].texcoord[1] = frame->tmin;
 
-	VectorMA (e->origin, frame->up * scale, s_up, point);
+	VectorMA (origin, frame->up * scale, s_up, point);
 	VectorMA (point, frame->right * scale, s_right, point);
 	vertices[2].position[0] = point[0];
 	vertices[2].position[1] = point[1];
 	vertices[2].position[2] = point[2];
 	vertices[2].texcoord[0] = frame->smax;
-	vertices[2].texcoord[1] = 0.0f;
+	vertices[2].texcoord[1] = frame->tmin;
 
-	VectorMA (e->origin, frame->down * scale, s_up, point);
+	VectorMA (origin, frame->down * scale, s_up, point);
 	VectorMA (point, frame->right * scale, s_right, point);
 	vertices[3].position[0] = point[0];
 	vertices[3].position[1] = point[1];
@@ -190,19 +192,105 @@ static void R_CreateSpriteVertices (entity_t *e, mspriteframe_t *frame, basicver
 	vertices[3].texcoord[1] = frame->tmax;
 }
 
+/*
+=================
+R_CompareSpriteInstances
+=================
+*/
+static int R_CompareSpriteInstances (const void *a, const void *b)
+{
+	const sprite_instance_t *lhs = (const sprite_instance_t *)a;
+	const sprite_instance_t *rhs = (const sprite_instance_t *)b;
+	if (lhs->frame->gltexture != rhs->frame->gltexture)
+		return ((uintptr_t)lhs->frame->gltexture < (uintptr_t)rhs->frame->gltexture) ? -1 : 1;
+	return lhs->oriented - rhs->oriented;
+}
+
+/*
+=================
+R_DrawSpriteBatch
+
+Builds the quads of all recorded sprites into one vertex allocation and issues one draw per frame texture
+=================
+*/
+void R_DrawSpriteBatch (cb_context_t *cbx, sprite_batch_t *batch)
+{
+	if (batch->num_instances == 0)
+		return;
+
+	qsort (batch->instances, batch->num_instances, sizeof (sprite_instance_t), R_CompareSpriteInstances);
+
+	VkBuffer	   buffer;
+	VkDeviceSize   buffer_offset;
+	basicvertex_t *vertices = (basicvertex_t *)R_VertexAllocate (batch->num_instances * 6 * sizeof (basicvertex_t), &buffer, &buffer_offset);
+	for (int i = 0; i < batch->num_instances; ++i)
+	{
+		basicvertex_t corners[4];
+		memset (corners, 0, sizeof (corners)); // unknown sprite types stay degenerate
+		R_CreateSpriteVertices (batch->instances[i].e, batch->instances[i].frame, corners);
+
+		basicvertex_t *quad = &vertices[i * 6];
+		quad[0] = corners[0];
+		quad[1] = corners[1];
+		quad[2] = corners[2];
+		quad[3] = corners[0];
+		quad[4] = corners[2];
+		quad[5] = corners[3];
+	}
+
+	vkCmdBindVertexBuffers (cbx->cb, 0, 1, &buffer, &buffer_offset);
+	R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.sprite_pipeline);
+
+	for (int first = 0; first < batch->num_instances;)
+	{
+		const sprite_instance_t *group = &batch->instances[first];
+		int						 count = 1;
+		while ((first + count) < batch->num_instances && (R_CompareSpriteInstances (group, &batch->instances[first + count]) == 0))
+			++count;
+
+		if (group->oriented)
+			vkCmdSetDepthBias (cbx->cb, OFFSET_DECAL, 0.0f, 1.0f);
+		else
+			vkCmdSetDepthBias (cbx->cb, OFFSET_NONE, 0.0f, 0.0f);
+
+		vkCmdBindDescriptorSets (
+			cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.basic_pipeline_layout.handle, 0, 1, &group->frame->gltexture->descriptor_set, 0, NULL);
+		vkCmdDraw (cbx->cb, count * 6, 1, first * 6, 0);
+
+		first += count;
+	}
+
+	batch->num_instances = 0;
+}
+
 /*
 =================
 R_DrawSpriteModel -- johnfitz -- rewritten: now supports all orientations
+
+With a batch the sprite is only recorded and drawn by R_DrawSpriteBatch with its peers
 =================
 */
-void R_DrawSpriteModel (cb_context_t *cbx, entity_t *e)
+void R_DrawSpriteModel (cb_context_t *cbx, entity_t *e, sprite_batch_t *batch)
 {
-	VkBuffer		buffer;
-	VkDeviceSize	buffer_offset;
-	basicvertex_t  *vertices = (basicvertex_t *)R_VertexAllocate (4 * sizeof (basicvertex_t), &buffer, &buffer_offset);
-	msprite_t	   *psprite;
+	msprite_t	   *psprite = (msprite_t *)Mod_Extradata (e->model);
 	mspriteframe_t *frame = R_GetSpriteFrame (e);
 
+	if (batch)
+	{
+		if (batch->num_instances == batch->max_instances)
+			R_DrawSpriteBatch (cbx, batch);
+
+		sprite_instance_t *instance = &batch->instances[batch->num_instances++];
+		instance->e = e;
+		instance->frame = frame;
+		instance->oriented = psprite->type == SPR_ORIENTED;
+		return;
+	}
+
+	VkBuffer	   buffer;
+	VkDeviceSize   buffer_offset;
+	basicvertex_t *vertices = (basicvertex_t *)R_VertexAllocate (4 * sizeof (basicvertex_t), &buffer, &buffer_offset);
+
 	R_CreateSpriteVertices (e, frame, vertices);
 
 	vkCmdBindVertexBuffers (cbx->cb, 0, 1, &buffer, &buffer_offset);
@@ -210,7 +298,6 @@ void R_DrawSpriteModel (cb_context_t *cbx, entity_t *e)
 
 	R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.sprite_pipeline);
 
-	psprite = (msprite_t *)Mod_Extradata (e->model);
 	if (psprite->type == SPR_ORIENTED)
 		vkCmdSetDepthBias (cbx->cb, OFFSET_DECAL, 0.0f, 1.0f);
 	else
@@ -35,8 +35,11 @@ extern cvar_t gl_zfix;
 extern cvar_t r_gpulightmapupdate;
 extern cvar_t vid_filter;
 extern cvar_t vid_palettize;
+extern cvar_t r_bindless;
 
 cvar_t r_parallelmark = {"r_parallelmark", "1", CVAR_NONE};
+cvar_t r_gpumark = {"r_gpumark", "0", CVAR_ARCHIVE}; // expand PVS leafs to surfaces in a compute shader (indirect only)
+cvar_t r_worldviewcache = {"r_worldviewcache", "1", CVAR_NONE}; // reuse the world marks while the view doesn't change
 
 // vso - in some cases, R_DrawTextureChains_Water oprimization
 // make some surfaces not rendered. Since this optimization does not seem
@@ -46,6 +49,18 @@ cvar_t r_drawwater_fast = {"r_drawwater_fast", "0", CVAR_ARCHIVE};
 byte *SV_FatPVS (vec3_t org, qmodel_t *worldmodel);
 
 extern VkBuffer bmodel_vertex_buffer;
+
+// AVX2 and AVX-512 culling is compiled per function and only used if the CPU supports it
+#if defined(USE_SSE2)
+#include <immintrin.h>
+#if defined(__GNUC__)
+#define TARGET_AVX2	  __attribute__ ((target ("avx2")))
+#define TARGET_AVX512 __attribute__ ((target ("avx512f")))
+#else
+#define TARGET_AVX2
+#define TARGET_AVX512
+#endif
+#endif
 static int		world_texstart[NUM_WORLD_CBX];
 static int		world_texend[NUM_WORLD_CBX];
 
@@ -65,6 +80,7 @@ typedef struct
 	__m128 vieworg_px;
 	__m128 vieworg_py;
 	__m128 vieworg_pz;
+	int	   simd_lanes; // 4 (SSE2), 8 (AVX2) or 16 (AVX-512)
 #elif defined(USE_NEON)
 	float32x4_t frustum_px[4];
 	float32x4_t frustum_py[4];
@@ -78,10 +94,47 @@ typedef struct
 	int frustum_ofsy[4];
 	int frustum_ofsz[4];
 #endif
-	byte *vis;
+	byte	*vis;
+	qboolean use_tasks;
+	qboolean gpu_mark; // only water leafs have their surfaces marked on the CPU
+	qboolean cached;   // the marks were restored from world_view_cache, the mark tasks have nothing to do
 } mark_surfaces_state_t;
 mark_surfaces_state_t mark_surfaces_state;
 
+/*
+===============
+world_view_cache_t
+
+Everything the world marks leave behind for one view. Kept once the view
+is unchanged for two frames (paused games, intermission, spectator cams)
+and replayed instead of marking until it moves again.
+===============
+*/
+typedef struct
+{
+	qmodel_t *model;
+	mleaf_t	 *viewleaf;
+	float	  origin[3];
+	float	  frustum[4][4];
+	int		  lightmap_count;
+	int		  flags;
+} world_view_key_t;
+
+typedef struct
+{
+	world_view_key_t  key;
+	qboolean		  valid;
+	uint32_t		 *surfvis;		   // surface bits of the world, before bmodels add theirs
+	uint32_t		 *leafvis;		   // PVS row, uploaded again for r_gpumark
+	int				 *leafs;		   // leafs inside the frustum, their efrags are stored every frame
+	int				  num_leafs;
+	uint32_t		 *lightmap_styles; // per lightmap, OR-ed into its modified bits
+	atomic_uint32_t **update_warp;
+	int				  num_update_warp;
+	uint32_t		  brushpolys;
+} world_view_cache_t;
+static world_view_cache_t world_view_cache;
+
 //==============================================================================
 //
 // SETUP CHAINS
@@ -194,6 +247,168 @@ void R_SetupWorldCBXTexRanges (qboolean use_tasks)
 }
 
 #if defined(USE_SSE2)
+/*
+===============
+R_SIMDLanes
+
+Widest culling path supported by the CPU
+===============
+*/
+static int R_SIMDLanes (void)
+{
+	static int lanes = 0;
+	if (lanes == 0)
+		lanes = SDL_HasAVX512F () ? 16 : SDL_HasAVX2 () ? 8 : 4;
+	return lanes;
+}
+
+/*
+===============
+R_Load16
+
+Combines lanes from two 8 wide SoA blocks
+===============
+*/
+static FORCE_INLINE TARGET_AVX512 __m512 R_Load16 (const float *lo, const float *hi)
+{
+	const __m512d v = _mm512_castps_pd (_mm512_castps256_ps512 (_mm256_loadu_ps (lo)));
+	return _mm512_castpd_ps (_mm512_insertf64x4 (v, _mm256_castps_pd (_mm256_loadu_ps (hi)), 1));
+}
+
+/*
+===============
+R_BackFaceCullAVX2
+
+Performs backface culling for 32 planes, 8 per iteration
+===============
+*/
+static TARGET_AVX2 uint32_t R_BackFaceCullAVX2 (soa_plane_t *planes)
+{
+	__m256 px = _mm256_broadcastss_ps (mark_surfaces_state.vieworg_px);
+	__m256 py = _mm256_broadcastss_ps (mark_surfaces_state.vieworg_py);
+	__m256 pz = _mm256_broadcastss_ps (mark_surfaces_state.vieworg_pz);
+
+	uint32_t activelanes = 0;
+	for (int plane_index = 0; plane_index < 4; ++plane_index)
+	{
+		soa_plane_t *plane = planes + plane_index;
+
+		__m256 v = _mm256_mul_ps (_mm256_loadu_ps ((*plane) + 0), px);
+		v = _mm256_add_ps (v, _mm256_mul_ps (_mm256_loadu_ps ((*plane) + 8), py));
+		v = _mm256_add_ps (v, _mm256_mul_ps (_mm256_loadu_ps ((*plane) + 16), pz));
+
+		__m256 pd = _mm256_loadu_ps ((*plane) + 24);
+
+		activelanes |= (uint32_t)_mm256_movemask_ps (_mm256_cmp_ps (pd, v, _CMP_LT_OQ)) << (plane_index * 8);
+	}
+	return activelanes;
+}
+
+/*
+===============
+R_BackFaceCullAVX512
+
+Performs backface culling for 32 planes, 16 per iteration
+===============
+*/
+static TARGET_AVX512 uint32_t R_BackFaceCullAVX512 (soa_plane_t *planes)
+{
+	__m512 px = _mm512_broadcastss_ps (mark_surfaces_state.vieworg_px);
+	__m512 py = _mm512_broadcastss_ps (mark_surfaces_state.vieworg_py);
+	__m512 pz = _mm512_broadcastss_ps (mark_surfaces_state.vieworg_pz);
+
+	uint32_t activelanes = 0;
+	for (int plane_index = 0; plane_index < 4; plane_index += 2)
+	{
+		const float *lo = planes[plane_index];
+		const float *hi = planes[plane_index + 1];
+
+		__m512 v = _mm512_mul_ps (R_Load16 (lo + 0, hi + 0), px);
+		v = _mm512_add_ps (v, _mm512_mul_ps (R_Load16 (lo + 8, hi + 8), py));
+		v = _mm512_add_ps (v, _mm512_mul_ps (R_Load16 (lo + 16, hi + 16), pz));
+
+		__m512 pd = R_Load16 (lo + 24, hi + 24);
+
+		activelanes |= (uint32_t)_mm512_cmp_ps_mask (pd, v, _CMP_LT_OQ) << (plane_index * 8);
+	}
+	return activelanes;
+}
+
+/*
+===============
+R_CullBoxAVX2
+
+Performs frustum culling for 32 bounding boxes, 8 per iteration
+===============
+*/
+static TARGET_AVX2 uint32_t R_CullBoxAVX2 (soa_aabb_t *boxes, uint32_t activelanes)
+{
+	for (int frustum_index = 0; frustum_index < 4; ++frustum_index)
+	{
+		if (activelanes == 0)
+			break;
+
+		int	   ofsx = mark_surfaces_state.frustum_ofsx[frustum_index];
+		int	   ofsy = mark_surfaces_state.frustum_ofsy[frustum_index];
+		int	   ofsz = mark_surfaces_state.frustum_ofsz[frustum_index];
+		__m256 px = _mm256_broadcastss_ps (mark_surfaces_state.frustum_px[frustum_index]);
+		__m256 py = _mm256_broadcastss_ps (mark_surfaces_state.frustum_py[frustum_index]);
+		__m256 pz = _mm256_broadcastss_ps (mark_surfaces_state.frustum_pz[frustum_index]);
+		__m256 pd = _mm256_broadcastss_ps (mark_surfaces_state.frustum_pd[frustum_index]);
+
+		uint32_t frustum_lanes = 0;
+		for (int boxes_index = 0; boxes_index < 4; ++boxes_index)
+		{
+			soa_aabb_t *box = boxes + boxes_index;
+			__m256		v = _mm256_mul_ps (_mm256_loadu_ps ((*box) + ofsx), px);
+			v = _mm256_add_ps (v, _mm256_mul_ps (_mm256_loadu_ps ((*box) + ofsy), py));
+			v = _mm256_add_ps (v, _mm256_mul_ps (_mm256_loadu_ps ((*box) + ofsz), pz));
+			frustum_lanes |= (uint32_t)_mm256_movemask_ps (_mm256_cmp_ps (pd, v, _CMP_LT_OQ)) << (boxes_index * 8);
+		}
+		activelanes &= frustum_lanes;
+	}
+
+	return activelanes;
+}
+
+/*
+===============
+R_CullBoxAVX512
+
+Performs frustum culling for 32 bounding boxes, 16 per iteration
+===============
+*/
+static TARGET_AVX512 uint32_t R_CullBoxAVX512 (soa_aabb_t *boxes, uint32_t activelanes)
+{
+	for (int frustum_index = 0; frustum_index < 4; ++frustum_index)
+	{
+		if (activelanes == 0)
+			break;
+
+		int	   ofsx = mark_surfaces_state.frustum_ofsx[frustum_index];
+		int	   ofsy = mark_surfaces_state.frustum_ofsy[frustum_index];
+		int	   ofsz = mark_surfaces_state.frustum_ofsz[frustum_index];
+		__m512 px = _mm512_broadcastss_ps (mark_surfaces_state.frustum_px[frustum_index]);
+		__m512 py = _mm512_broadcastss_ps (mark_surfaces_state.frustum_py[frustum_index]);
+		__m512 pz = _mm512_broadcastss_ps (mark_surfaces_state.frustum_pz[frustum_index]);
+		__m512 pd = _mm512_broadcastss_ps (mark_surfaces_state.frustum_pd[frustum_index]);
+
+		uint32_t frustum_lanes = 0;
+		for (int boxes_index = 0; boxes_index < 4; boxes_index += 2)
+		{
+			const float *lo = boxes[boxes_index];
+			const float *hi = boxes[boxes_index + 1];
+			__m512		 v = _mm512_mul_ps (R_Load16 (lo + ofsx, hi + ofsx), px);
+			v = _mm512_add_ps (v, _mm512_mul_ps (R_Load16 (lo + ofsy, hi + ofsy), py));
+			v = _mm512_add_ps (v, _mm512_mul_ps (R_Load16 (lo + ofsz, hi + ofsz), pz));
+			frustum_lanes |= (uint32_t)_mm512_cmp_ps_mask (pd, v, _CMP_LT_OQ) << (boxes_index * 8);
+		}
+		activelanes &= frustum_lanes;
+	}
+
+	return activelanes;
+}
+
 /*
 ===============
 R_BackFaceCullSIMD
@@ -203,6 +418,11 @@ Performs backface culling for 32 planes
 */
 static FORCE_INLINE uint32_t R_BackFaceCullSIMD (soa_plane_t *planes)
 {
+	if (mark_surfaces_state.simd_lanes == 16)
+		return R_BackFaceCullAVX512 (planes);
+	if (mark_surfaces_state.simd_lanes == 8)
+		return R_BackFaceCullAVX2 (planes);
+
 	__m128 px = mark_surfaces_state.vieworg_px;
 	__m128 py = mark_surfaces_state.vieworg_py;
 	__m128 pz = mark_surfaces_state.vieworg_pz;
@@ -239,6 +459,11 @@ Performs frustum culling for 32 bounding boxes
 */
 static FORCE_INLINE uint32_t R_CullBoxSIMD (soa_aabb_t *boxes, uint32_t activelanes)
 {
+	if (mark_surfaces_state.simd_lanes == 16)
+		return R_CullBoxAVX512 (boxes, activelanes);
+	if (mark_surfaces_state.simd_lanes == 8)
+		return R_CullBoxAVX2 (boxes, activelanes);
+
 	for (int frustum_index = 0; frustum_index < 4; ++frustum_index)
 	{
 		if (activelanes == 0)
@@ -354,6 +579,19 @@ static FORCE_INLINE uint32_t R_CullBoxSIMD (soa_aabb_t *boxes, uint32_t activela
 #endif
 
 #if defined(USE_SIMD)
+/*
+===============
+R_CullBoxesSIMD
+
+Frustum culls 32 bounding boxes set up like the leaf bounds, returns the active lanes that are visible.
+Only valid after R_MarkSurfaces has set up the frustum for this frame.
+===============
+*/
+uint32_t R_CullBoxesSIMD (soa_aabb_t *boxes, uint32_t activelanes)
+{
+	return R_CullBoxSIMD (boxes, activelanes);
+}
+
 /*
 ===============
 R_MarkVisSurfacesSIMD
@@ -369,7 +607,11 @@ void R_MarkVisSurfacesSIMD (qboolean *use_tasks)
 	uint32_t	*surfvis = (uint32_t *)cl.worldmodel->surfvis;
 	soa_aabb_t	*leafbounds = cl.worldmodel->soa_leafbounds;
 
-	int current_combined_dep_index = INT_MAX;
+	int		 current_combined_dep_index = INT_MAX;
+	qboolean current_has_water = false;
+
+	if (mark_surfaces_state.cached)
+		return;
 
 	// iterate through leaves, marking surfaces
 	for (i = 0; i < numleafs; i += 32)
@@ -387,24 +629,27 @@ void R_MarkVisSurfacesSIMD (qboolean *use_tasks)
 			mleaf_t *leaf = &cl.worldmodel->leafs[1 + i + j];
 			if (r_drawworld_cheatsafe && (leaf->contents != CONTENTS_SKY || r_oldskyleaf.value))
 			{
-				unsigned int nummarksurfaces = leaf->nummarksurfaces;
-				int			*marksurfaces = leaf->firstmarksurface;
-				for (k = 0; k < nummarksurfaces; ++k)
+				if (indirect && current_combined_dep_index != leaf->combined_deps)
 				{
-					unsigned int index = marksurfaces[k];
-					surfvis[index / 32] |= 1u << (index % 32);
+					current_has_water = R_MarkDeps (leaf->combined_deps, 0);
+					current_combined_dep_index = leaf->combined_deps;
 				}
 
-				if (indirect && current_combined_dep_index != leaf->combined_deps)
+				if (!mark_surfaces_state.gpu_mark || current_has_water)
 				{
-					R_MarkDeps (leaf->combined_deps, 0);
-					current_combined_dep_index = leaf->combined_deps;
+					unsigned int nummarksurfaces = leaf->nummarksurfaces;
+					int			*marksurfaces = leaf->firstmarksurface;
+					for (k = 0; k < nummarksurfaces; ++k)
+					{
+						unsigned int index = marksurfaces[k];
+						surfvis[index / 32] |= 1u << (index % 32);
+					}
 				}
 			}
 
 			// add static models
-			if (leaf->efrags)
-				R_StoreEfrags (&leaf->efrags);
+			if (leaf->numefrags)
+				R_StoreEfrags (leaf);
 		}
 	}
 
@@ -419,6 +664,7 @@ void R_MarkVisSurfacesSIMD (qboolean *use_tasks)
 			continue;
 
 		mask &= R_BackFaceCullSIMD (&cl.worldmodel->soa_surfplanes[i / 8]);
+		mask = R_CullBoxSIMD (&cl.worldmodel->soa_surfbounds[i / 8], mask);
 		while (mask != 0)
 		{
 			const int j = FindFirstBitNonZero (mask);
@@ -464,6 +710,7 @@ void R_MarkLeafsSIMD (int index, void *unused)
 	unsigned int current_surfvis_index_written = 0;
 	uint32_t	 current_surfvis_written = 0;
 	int			 current_combined_dep_index = INT_MAX;
+	qboolean	 current_has_water = false;
 
 	while (mask_iter != 0)
 	{
@@ -473,30 +720,33 @@ void R_MarkLeafsSIMD (int index, void *unused)
 
 		if (r_drawworld_cheatsafe && (leaf->contents != CONTENTS_SKY || r_oldskyleaf.value))
 		{
-			unsigned int nummarksurfaces = leaf->nummarksurfaces;
-			int			*marksurfaces = leaf->firstmarksurface;
+			if (indirect && current_combined_dep_index != leaf->combined_deps)
+			{
+				current_has_water = R_MarkDeps (leaf->combined_deps, Tasks_GetWorkerIndex ());
+				current_combined_dep_index = leaf->combined_deps;
+			}
 
-			for (j = 0; j < nummarksurfaces; ++j)
+			if (!mark_surfaces_state.gpu_mark || current_has_water)
 			{
-				const unsigned int surf_index = marksurfaces[j];
+				unsigned int nummarksurfaces = leaf->nummarksurfaces;
+				int			*marksurfaces = leaf->firstmarksurface;
 
-				if (surf_index / 32 != current_surfvis_index_written)
+				for (j = 0; j < nummarksurfaces; ++j)
 				{
-					Atomic_OrUInt32_Relaxed (&surfvis[current_surfvis_index_written], current_surfvis_written);
-					current_surfvis_index_written = surf_index / 32;
-					current_surfvis_written = 0;
-				}
-				current_surfvis_written |= 1u << (surf_index % 32);
-			}
+					const unsigned int surf_index = marksurfaces[j];
 
-			if (indirect && current_combined_dep_index != leaf->combined_deps)
-			{
-				R_MarkDeps (leaf->combined_deps, Tasks_GetWorkerIndex ());
-				current_combined_dep_index = leaf->combined_deps;
+					if (surf_index / 32 != current_surfvis_index_written)
+					{
+						Atomic_OrUInt32_Relaxed (&surfvis[current_surfvis_index_written], current_surfvis_written);
+						current_surfvis_index_written = surf_index / 32;
+						current_surfvis_written = 0;
+					}
+					current_surfvis_written |= 1u << (surf_index % 32);
+				}
 			}
 		}
 		const uint32_t bit_mask = ~(1u << i);
-		if (!leaf->efrags)
+		if (!leaf->numefrags)
 		{
 			*mask &= bit_mask;
 		}
@@ -521,6 +771,8 @@ void R_BackfaceCullSurfacesSIMD (int index, void *unused)
 		return;
 
 	*mask &= R_BackFaceCullSIMD (&cl.worldmodel->soa_surfplanes[index * 4]);
+	// the leaf test only culls whole leafs, large ones keep many surfaces that are outside the view
+	*mask = R_CullBoxSIMD (&cl.worldmodel->soa_surfbounds[index * 4], *mask);
 
 	const int worker_index = Tasks_GetWorkerIndex ();
 	uint32_t  mask_iter = *mask;
@@ -550,6 +802,8 @@ void R_StoreLeafEFrags (void *unused)
 	unsigned int i;
 	unsigned int numleafs = cl.worldmodel->numleafs;
 	uint32_t	*vis = (uint32_t *)mark_surfaces_state.vis;
+	if (mark_surfaces_state.cached)
+		return;
 	for (i = 0; i < numleafs; i += 32)
 	{
 		uint32_t mask = vis[i / 32];
@@ -558,7 +812,7 @@ void R_StoreLeafEFrags (void *unused)
 			const int j = FindFirstBitNonZero (mask);
 			mask &= ~(1u << j);
 			mleaf_t *leaf = &cl.worldmodel->leafs[1 + i + j];
-			R_StoreEfrags (&leaf->efrags);
+			R_StoreEfrags (leaf);
 		}
 	}
 }
@@ -575,6 +829,8 @@ void R_ChainVisSurfaces (qboolean *use_tasks)
 	unsigned int numsurfaces = cl.worldmodel->numsurfaces;
 	uint32_t	*surfvis = (uint32_t *)cl.worldmodel->surfvis;
 	uint32_t	 brushpolys = 0;
+	if (mark_surfaces_state.cached)
+		return;
 	for (i = 0; i < numsurfaces; i += 32)
 	{
 		uint32_t mask = surfvis[i / 32];
@@ -672,6 +928,7 @@ void R_MarkLeafsParallel (int index, void *unused)
 	unsigned int current_surfvis_index_written = 0;
 	uint32_t	 current_surfvis_written = 0;
 	int			 current_combined_dep_index = INT_MAX;
+	qboolean	 current_has_water = false;
 
 	while (mask_iter != 0)
 	{
@@ -684,30 +941,33 @@ void R_MarkLeafsParallel (int index, void *unused)
 			*mask &= bit_mask;
 			continue;
 		}
-		if (!leaf->efrags)
+		if (!leaf->numefrags)
 			*mask &= bit_mask;
 		if (r_drawworld_cheatsafe && (leaf->contents != CONTENTS_SKY || r_oldskyleaf.value))
 		{
-			unsigned int nummarksurfaces = leaf->nummarksurfaces;
-			int			*marksurfaces = leaf->firstmarksurface;
+			if (indirect && current_combined_dep_index != leaf->combined_deps)
+			{
+				current_has_water = R_MarkDeps (leaf->combined_deps, Tasks_GetWorkerIndex ());
+				current_combined_dep_index = leaf->combined_deps;
+			}
 
-			for (unsigned int j = 0; j < nummarksurfaces; ++j)
+			if (!mark_surfaces_state.gpu_mark || current_has_water)
 			{
-				unsigned int surf_index = marksurfaces[j];
+				unsigned int nummarksurfaces = leaf->nummarksurfaces;
+				int			*marksurfaces = leaf->firstmarksurface;
 
-				if (surf_index / 32 != current_surfvis_index_written)
+				for (unsigned int j = 0; j < nummarksurfaces; ++j)
 				{
-					Atomic_OrUInt32_Relaxed (&surfvis[current_surfvis_index_written], current_surfvis_written);
-					current_surfvis_index_written = surf_index / 32;
-					current_surfvis_written = 0;
-				}
-				current_surfvis_written |= 1u << (surf_index % 32);
-			}
+					unsigned int surf_index = marksurfaces[j];
 
-			if (indirect && current_combined_dep_index != leaf->combined_deps)
-			{
-				R_MarkDeps (leaf->combined_deps, Tasks_GetWorkerIndex ());
-				current_combined_dep_index = leaf->combined_deps;
+					if (surf_index / 32 != current_surfvis_index_written)
+					{
+						Atomic_OrUInt32_Relaxed (&surfvis[current_surfvis_index_written], current_surfvis_written);
+						current_surfvis_index_written = surf_index / 32;
+						current_surfvis_written = 0;
+					}
+					current_surfvis_written |= 1u << (surf_index % 32);
+				}
 			}
 		}
 	}
@@ -764,7 +1024,11 @@ void R_MarkVisSurfaces (qboolean *use_tasks)
 	uint32_t   *vis = (uint32_t *)mark_surfaces_state.vis;
 	uint32_t   *surfvis = (uint32_t *)cl.worldmodel->surfvis;
 
-	int current_combined_dep_index = INT_MAX;
+	int		 current_combined_dep_index = INT_MAX;
+	qboolean current_has_water = false;
+
+	if (mark_surfaces_state.cached)
+		return;
 
 	leaf = &cl.worldmodel->leafs[1];
 	for (i = 0; i < cl.worldmodel->numleafs; i++, leaf++)
@@ -778,12 +1042,14 @@ void R_MarkVisSurfaces (qboolean *use_tasks)
 			{
 				if (indirect && current_combined_dep_index != leaf->combined_deps)
 				{
-					R_MarkDeps (leaf->combined_deps, 0);
+					current_has_water = R_MarkDeps (leaf->combined_deps, 0);
 					current_combined_dep_index = leaf->combined_deps;
 				}
 
 				for (j = 0; j < leaf->nummarksurfaces; j++)
 				{
+					if (mark_surfaces_state.gpu_mark && !current_has_water)
+						break;
 					if (indirect)
 					{
 						unsigned int surf_index = leaf->firstmarksurface[j];
@@ -810,8 +1076,8 @@ void R_MarkVisSurfaces (qboolean *use_tasks)
 			}
 
 			// add static models
-			if (leaf->efrags)
-				R_StoreEfrags (&leaf->efrags);
+			if (leaf->numefrags)
+				R_StoreEfrags (leaf);
 		}
 	}
 
@@ -822,6 +1088,173 @@ void R_MarkVisSurfaces (qboolean *use_tasks)
 	R_SetupWorldCBXTexRanges (*use_tasks);
 }
 
+/*
+===============
+R_ClearWorldViewCache
+===============
+*/
+void R_ClearWorldViewCache (void)
+{
+	memset (&world_view_cache.key, 0, sizeof (world_view_cache.key));
+	world_view_cache.valid = false;
+}
+
+/*
+===============
+R_GetWorldViewKey
+
+Everything the world marks depend on, expects r_viewleaf, frustum and the vis row of this frame
+===============
+*/
+static void R_GetWorldViewKey (world_view_key_t *key)
+{
+	memset (key, 0, sizeof (*key)); // padding is compared as well
+	key->model = cl.worldmodel;
+	key->viewleaf = r_viewleaf;
+	VectorCopy (r_origin, key->origin);
+	for (int i = 0; i < 4; ++i)
+	{
+		VectorCopy (frustum[i].normal, key->frustum[i]);
+		key->frustum[i][3] = frustum[i].dist;
+	}
+	key->lightmap_count = lightmap_count;
+	key->flags = (r_novis.value ? 1 : 0) | (r_oldskyleaf.value ? 2 : 0) | (r_drawworld_cheatsafe ? 4 : 0) | (indirect ? 8 : 0) |
+				 (mark_surfaces_state.gpu_mark ? 16 : 0) | (mark_surfaces_state.use_tasks ? 32 : 0);
+}
+
+/*
+===============
+R_RecordWorldViewCache
+
+Marks the world on this thread and keeps the result. Same outcome as the
+other mark paths, surfaces are only backface culled.
+===============
+*/
+static void R_RecordWorldViewCache (void)
+{
+	world_view_cache_t *cache = &world_view_cache;
+	const int			numleafs = cl.worldmodel->numleafs;
+	const int			numsurfaces = cl.worldmodel->numsurfaces;
+	const size_t		surfvis_size = (numsurfaces + 31) / 32 * sizeof (uint32_t);
+	const size_t		leafvis_size = (numleafs + 31) / 32 * sizeof (uint32_t);
+	uint32_t		   *vis = (uint32_t *)mark_surfaces_state.vis;
+	uint32_t		   *surfvis = (uint32_t *)cl.worldmodel->surfvis;
+
+	cache->surfvis = Mem_Realloc (cache->surfvis, surfvis_size);
+	cache->leafvis = Mem_Realloc (cache->leafvis, leafvis_size);
+	cache->leafs = Mem_Realloc (cache->leafs, numleafs * sizeof (int));
+	cache->lightmap_styles = Mem_Realloc (cache->lightmap_styles, q_max (lightmap_count, 1) * sizeof (uint32_t));
+	cache->update_warp = Mem_Realloc (cache->update_warp, q_max (cl.worldmodel->numtextures, 1) * sizeof (atomic_uint32_t *));
+	memset (cache->lightmap_styles, 0, lightmap_count * sizeof (uint32_t));
+	memcpy (cache->leafvis, vis, leafvis_size);
+	cache->num_leafs = 0;
+	cache->num_update_warp = 0;
+	cache->brushpolys = 0;
+
+	R_ClearTextureChains (cl.worldmodel, chain_world);
+	memset (surfvis, 0, surfvis_size);
+
+	int		 current_combined_dep_index = INT_MAX;
+	qboolean current_has_water = false;
+	mleaf_t *leaf = &cl.worldmodel->leafs[1];
+	for (int i = 0; i < numleafs; i++, leaf++)
+	{
+		if (!(vis[i / 32] & (1u << (i % 32))) || R_CullBox (leaf->minmaxs, leaf->minmaxs + 3))
+			continue;
+
+		cache->leafs[cache->num_leafs++] = 1 + i;
+		if (!r_drawworld_cheatsafe || (leaf->contents == CONTENTS_SKY && !r_oldskyleaf.value))
+			continue;
+
+		if (indirect && current_combined_dep_index != leaf->combined_deps)
+		{
+			current_has_water = R_CollectDeps (leaf->combined_deps, cache->lightmap_styles, cache->update_warp, &cache->num_update_warp);
+			current_combined_dep_index = leaf->combined_deps;
+		}
+		if (mark_surfaces_state.gpu_mark && !current_has_water)
+			continue;
+
+		for (int j = 0; j < leaf->nummarksurfaces; j++)
+		{
+			const unsigned int surf_index = leaf->firstmarksurface[j];
+			surfvis[surf_index / 32] |= 1u << (surf_index % 32);
+		}
+	}
+
+	if (!indirect)
+	{
+		for (int i = 0; i < numsurfaces; i += 32)
+		{
+			uint32_t mask = surfvis[i / 32];
+			while (mask != 0)
+			{
+				const int j = FindFirstBitNonZero (mask);
+				mask &= ~(1u << j);
+
+				msurface_t *surf = &cl.worldmodel->surfaces[i + j];
+				if (R_BackFaceCull (surf))
+				{
+					surfvis[i / 32] &= ~(1u << j);
+					continue;
+				}
+
+				++cache->brushpolys;
+				R_ChainSurface (surf, chain_world);
+				if (surf->lightmaptexturenum >= 0)
+					cache->lightmap_styles[surf->lightmaptexturenum] |= surf->styles_bitmap;
+				if (surf->texinfo->texture->warpimage)
+				{
+					atomic_uint32_t *flag = &surf->texinfo->texture->update_warp;
+					int				 k;
+					for (k = 0; k < cache->num_update_warp; ++k)
+						if (cache->update_warp[k] == flag)
+							break;
+					if (k == cache->num_update_warp)
+						cache->update_warp[cache->num_update_warp++] = flag;
+				}
+			}
+		}
+		R_SetupWorldCBXTexRanges (mark_surfaces_state.use_tasks);
+	}
+
+	memcpy (cache->surfvis, surfvis, surfvis_size);
+	cache->valid = true;
+}
+
+/*
+===============
+R_ReplayWorldViewCache
+
+Puts back what marking the cached view left behind. The texture chains
+of the CPU path are still intact from the frame that recorded it.
+===============
+*/
+static void R_ReplayWorldViewCache (void)
+{
+	world_view_cache_t *cache = &world_view_cache;
+
+	memcpy (cl.worldmodel->surfvis, cache->surfvis, (cl.worldmodel->numsurfaces + 31) / 32 * sizeof (uint32_t));
+	if (indirect)
+		R_ClearTextureChains (cl.worldmodel, chain_world); // transparent water is chained while drawing
+	if (mark_surfaces_state.gpu_mark)
+		R_UploadLeafVisibility ((const byte *)cache->leafvis);
+
+	const int worker_index = Tasks_GetWorkerIndex ();
+	for (int i = 0; i < lightmap_count; ++i)
+		lightmaps[i].modified[worker_index] |= cache->lightmap_styles[i];
+	for (int i = 0; i < cache->num_update_warp; ++i)
+		Atomic_StoreUInt32_Relaxed (cache->update_warp[i], true);
+
+	for (int i = 0; i < cache->num_leafs; ++i)
+	{
+		mleaf_t *leaf = &cl.worldmodel->leafs[cache->leafs[i]];
+		if (leaf->numefrags)
+			R_StoreEfrags (leaf);
+	}
+
+	Atomic_AddUInt32 (&rs_brushpolys, cache->brushpolys);
+}
+
 /*
 ===============
 R_MarkSurfacesPrepare
@@ -852,8 +1285,32 @@ static void R_MarkSurfacesPrepare (void *unused)
 	if ((numleafs % 32) != 0)
 		vis[numleafs / 32] &= (1u << (numleafs % 32)) - 1;
 
+	mark_surfaces_state.gpu_mark = indirect && r_gpumark.value && r_drawworld_cheatsafe;
+
 	r_visframecount++;
 
+	// dynamic lightmaps on the CPU are rebuilt per marked surface, they can't be replayed
+	mark_surfaces_state.cached = false;
+	if (r_worldviewcache.value && r_gpulightmapupdate.value)
+	{
+		world_view_key_t key;
+		R_GetWorldViewKey (&key);
+		const qboolean same_view = !memcmp (&key, &world_view_cache.key, sizeof (key));
+		if (same_view && !world_view_cache.valid)
+			R_RecordWorldViewCache ();
+		if (same_view)
+		{
+			R_ReplayWorldViewCache ();
+			mark_surfaces_state.cached = true;
+			return;
+		}
+		world_view_cache.key = key;
+	}
+	world_view_cache.valid = false;
+
+	if (mark_surfaces_state.gpu_mark)
+		R_UploadLeafVisibility (mark_surfaces_state.vis);
+
 	// set all chains to null
 	for (i = 0; i < cl.worldmodel->numtextures; i++)
 		if (cl.worldmodel->textures[i])
@@ -884,6 +1341,7 @@ static void R_MarkSurfacesPrepare (void *unused)
 		mark_surfaces_state.vieworg_px = _mm_shuffle_ps (pos, pos, _MM_SHUFFLE (0, 0, 0, 0));
 		mark_surfaces_state.vieworg_py = _mm_shuffle_ps (pos, pos, _MM_SHUFFLE (1, 1, 1, 1));
 		mark_surfaces_state.vieworg_pz = _mm_shuffle_ps (pos, pos, _MM_SHUFFLE (2, 2, 2, 2));
+		mark_surfaces_state.simd_lanes = R_SIMDLanes ();
 #elif defined(USE_NEON)
 		for (int frustum_index = 0; frustum_index < 4; ++frustum_index)
 		{
@@ -910,6 +1368,60 @@ static void R_MarkSurfacesPrepare (void *unused)
 	}
 }
 
+#if defined(USE_SIMD)
+/*
+===============
+R_MarkLeafsSIMDRange
+===============
+*/
+static void R_MarkLeafsSIMDRange (int begin, int end, void *unused)
+{
+	if (mark_surfaces_state.cached)
+		return;
+	for (int i = begin; i < end; ++i)
+		R_MarkLeafsSIMD (i, unused);
+}
+
+/*
+===============
+R_BackfaceCullSurfacesSIMDRange
+===============
+*/
+static void R_BackfaceCullSurfacesSIMDRange (int begin, int end, void *unused)
+{
+	if (mark_surfaces_state.cached)
+		return;
+	for (int i = begin; i < end; ++i)
+		R_BackfaceCullSurfacesSIMD (i, unused);
+}
+#endif
+
+/*
+===============
+R_MarkLeafsParallelRange
+===============
+*/
+static void R_MarkLeafsParallelRange (int begin, int end, void *unused)
+{
+	if (mark_surfaces_state.cached)
+		return;
+	for (int i = begin; i < end; ++i)
+		R_MarkLeafsParallel (i, unused);
+}
+
+/*
+===============
+R_BackfaceCullSurfacesParallelRange
+===============
+*/
+static void R_BackfaceCullSurfacesParallelRange (int begin, int end, void *unused)
+{
+	if (mark_surfaces_state.cached)
+		return;
+	for (int i = begin; i < end; ++i)
+		R_BackfaceCullSurfacesParallel (i, unused);
+}
+
 /*
 ===============
 R_MarkSurfaces -- johnfitz -- mark surfaces based on PVS and rebuild texture chains
@@ -917,6 +1429,9 @@ R_MarkSurfaces -- johnfitz -- mark surfaces based on PVS and rebuild texture cha
 */
 void R_MarkSurfaces (qboolean use_tasks, task_handle_t before_mark, task_handle_t *store_efrags, task_handle_t *cull_surfaces, task_handle_t *chain_surfaces)
 {
+	R_SortEfrags ();
+	mark_surfaces_state.use_tasks = use_tasks;
+
 	if (use_tasks)
 	{
 		task_handle_t prepare_mark = Task_AllocateAndAssignFunc (R_MarkSurfacesPrepare, NULL, 0);
@@ -928,10 +1443,10 @@ void R_MarkSurfaces (qboolean use_tasks, task_handle_t before_mark, task_handle_
 			task_handle_t mark_surfaces;
 #if defined(USE_SIMD)
 			if (use_simd)
-				mark_surfaces = Task_AllocateAndAssignIndexedFunc (R_MarkLeafsSIMD, (numleafs + 31) / 32, NULL, 0);
+				mark_surfaces = Task_AllocateAndAssignRangeFunc (R_MarkLeafsSIMDRange, (numleafs + 31) / 32, NULL, 0);
 			else
 #endif
-				mark_surfaces = Task_AllocateAndAssignIndexedFunc (R_MarkLeafsParallel, (numleafs + 31) / 32, NULL, 0);
+				mark_surfaces = Task_AllocateAndAssignRangeFunc (R_MarkLeafsParallelRange, (numleafs + 31) / 32, NULL, 0);
 			Task_AddDependency (prepare_mark, mark_surfaces);
 			Task_Submit (mark_surfaces);
 
@@ -943,10 +1458,10 @@ void R_MarkSurfaces (qboolean use_tasks, task_handle_t before_mark, task_handle_
 				unsigned int numsurfaces = cl.worldmodel->numsurfaces;
 #if defined(USE_SIMD)
 				if (use_simd)
-					*cull_surfaces = Task_AllocateAndAssignIndexedFunc (R_BackfaceCullSurfacesSIMD, (numsurfaces + 31) / 32, NULL, 0);
+					*cull_surfaces = Task_AllocateAndAssignRangeFunc (R_BackfaceCullSurfacesSIMDRange, (numsurfaces + 31) / 32, NULL, 0);
 				else
 #endif
-					*cull_surfaces = Task_AllocateAndAssignIndexedFunc (R_BackfaceCullSurfacesParallel, (numsurfaces + 31) / 32, NULL, 0);
+					*cull_surfaces = Task_AllocateAndAssignRangeFunc (R_BackfaceCullSurfacesParallelRange, (numsurfaces + 31) / 32, NULL, 0);
 				Task_AddDependency (mark_surfaces, *cull_surfaces);
 
 				*chain_surfaces = Task_AllocateAndAssignFunc ((task_func_t)R_ChainVisSurfaces, &use_tasks, sizeof (qboolean));
@@ -1028,6 +1543,48 @@ static void R_ClearBatch (cb_context_t *cbx)
 	cbx->num_vbo_indices = 0;
 }
 
+/*
+================
+R_DrawBatchIndices
+
+Draws the indices batched in cbx->vbo_indices from the bmodel vertex buffer.
+Batches usually come from a few nearby surfaces, so their vertices fit in a
+16 bit range: rebase the indices to the lowest vertex and let vertexOffset
+add it back, which halves the index upload.
+================
+*/
+void R_DrawBatchIndices (cb_context_t *cbx, uint32_t first_instance)
+{
+	const unsigned int num_indices = cbx->num_vbo_indices;
+	uint32_t		   min_index = UINT32_MAX;
+	uint32_t		   max_index = 0;
+	unsigned int	   i;
+	VkBuffer		   buffer;
+	VkDeviceSize	   buffer_offset;
+
+	for (i = 0; i < num_indices; ++i)
+	{
+		min_index = q_min (min_index, cbx->vbo_indices[i]);
+		max_index = q_max (max_index, cbx->vbo_indices[i]);
+	}
+
+	if (max_index - min_index <= UINT16_MAX)
+	{
+		uint16_t *indices = (uint16_t *)R_IndexAllocate (num_indices * sizeof (uint16_t), &buffer, &buffer_offset);
+		for (i = 0; i < num_indices; ++i)
+			indices[i] = (uint16_t)(cbx->vbo_indices[i] - min_index);
+		vulkan_globals.vk_cmd_bind_index_buffer (cbx->cb, buffer, buffer_offset, VK_INDEX_TYPE_UINT16);
+		vulkan_globals.vk_cmd_draw_indexed (cbx->cb, num_indices, 1, 0, (int32_t)min_index, first_instance);
+	}
+	else
+	{
+		byte *indices = R_IndexAllocate (num_indices * sizeof (uint32_t), &buffer, &buffer_offset);
+		memcpy (indices, cbx->vbo_indices, num_indices * sizeof (uint32_t));
+		vulkan_globals.vk_cmd_bind_index_buffer (cbx->cb, buffer, buffer_offset, VK_INDEX_TYPE_UINT32);
+		vulkan_globals.vk_cmd_draw_indexed (cbx->cb, num_indices, 1, 0, 0, first_instance);
+	}
+}
+
 /*
 ================
 R_FlushBatch
@@ -1043,7 +1600,9 @@ static void R_FlushBatch (
 	{
 		int pipeline_index =
 			(fullbright_enabled ? 1 : 0) + (alpha_test ? 2 : 0) + (alpha_blend ? 4 : 0) + (vid_filter.value != 0 && vid_palettize.value != 0 ? 8 : 0);
-		R_BindPipeline (cbx, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.world_pipelines[pipeline_index]);
+		R_BindPipeline (
+			cbx, VK_PIPELINE_BIND_POINT_GRAPHICS,
+			cbx->bindless_batch ? vulkan_globals.world_bindless_pipelines[pipeline_index] : vulkan_globals.world_pipelines[pipeline_index]);
 
 		float constant_factor = 0.0f, slope_factor = 0.0f;
 		if (use_zbias)
@@ -1063,18 +1622,13 @@ static void R_FlushBatch (
 
 		if (!r_fullbright_cheatsafe)
 			vulkan_globals.vk_cmd_bind_descriptor_sets (
-				cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.world_pipeline_layout.handle, 1, 1, &lightmap_texture->descriptor_set, 0, NULL);
+				cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, cbx->current_pipeline.layout.handle, 1, 1, &lightmap_texture->descriptor_set, 0, NULL);
 		else
 			vulkan_globals.vk_cmd_bind_descriptor_sets (
-				cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.world_pipeline_layout.handle, 1, 1, &greylightmap->descriptor_set, 0, NULL);
+				cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, cbx->current_pipeline.layout.handle, 1, 1, &greylightmap->descriptor_set, 0, NULL);
 
-		VkBuffer	 buffer;
-		VkDeviceSize buffer_offset;
-		byte		*indices = R_IndexAllocate (cbx->num_vbo_indices * sizeof (uint32_t), &buffer, &buffer_offset);
-		memcpy (indices, cbx->vbo_indices, cbx->num_vbo_indices * sizeof (uint32_t));
-
-		vulkan_globals.vk_cmd_bind_index_buffer (cbx->cb, buffer, buffer_offset, VK_INDEX_TYPE_UINT32);
-		vulkan_globals.vk_cmd_draw_indexed (cbx->cb, cbx->num_vbo_indices, 1, 0, 0, 0);
+		// Bindless batches pass their texture indices to world_bindless.frag through gl_InstanceIndex
+		R_DrawBatchIndices (cbx, cbx->bindless_batch ? cbx->bindless_textures : 0);
 
 		R_ClearBatch (cbx);
 		++(*brushpasses);
@@ -1203,9 +1757,6 @@ void R_DrawTextureChains_Water (cb_context_t *cbx, qmodel_t *model, entity_t *en
 			vulkan_globals.vk_cmd_bind_descriptor_sets (
 				cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.world_pipeline_layout.handle, 0, 1, &gl_texture->descriptor_set, 0, NULL);
 
-		if (model != cl.worldmodel)
-			Atomic_StoreUInt32 (&t->update_warp, true); // FIXME: races against UpdateWarpTextures task, bmodel-only warps may end up updating at half frequency
-
 		for (s = t->texturechains[chain]; s; s = s->texturechains[chain])
 		{
 			if (s->lightmaptexturenum != lastlightmap)
@@ -1248,11 +1799,18 @@ void R_DrawTextureChains_Multitexture (cb_context_t *cbx, qmodel_t *model, entit
 	VkDeviceSize offset = 0;
 	vulkan_globals.vk_cmd_bind_vertex_buffers (cbx->cb, 0, 1, &bmodel_vertex_buffer, &offset);
 
-	vulkan_globals.vk_cmd_bind_descriptor_sets (
-		cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.world_pipeline_layout.handle, 2, 1, &nulltexture->descriptor_set, 0, NULL);
-	if (r_lightmap_cheatsafe)
+	cbx->bindless_batch = vulkan_globals.bindless && r_bindless.value;
+	if (cbx->bindless_batch)
 		vulkan_globals.vk_cmd_bind_descriptor_sets (
-			cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.world_pipeline_layout.handle, 0, 1, &greytexture->descriptor_set, 0, NULL);
+			cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.world_bindless_pipeline_layout.handle, 0, 1, &vulkan_globals.bindless_desc_set, 0, NULL);
+	else
+	{
+		vulkan_globals.vk_cmd_bind_descriptor_sets (
+			cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.world_pipeline_layout.handle, 2, 1, &nulltexture->descriptor_set, 0, NULL);
+		if (r_lightmap_cheatsafe)
+			vulkan_globals.vk_cmd_bind_descriptor_sets (
+				cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.world_pipeline_layout.handle, 0, 1, &greytexture->descriptor_set, 0, NULL);
+	}
 
 	if (alpha_blend)
 	{
@@ -1270,8 +1828,10 @@ void R_DrawTextureChains_Multitexture (cb_context_t *cbx, qmodel_t *model, entit
 		if (gl_fullbrights.value && (fullbright = R_TextureAnimation (t, ent_frame)->fullbright) && !r_lightmap_cheatsafe)
 		{
 			fullbright_enabled = true;
-			vulkan_globals.vk_cmd_bind_descriptor_sets (
-				cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.world_pipeline_layout.handle, 2, 1, &fullbright->descriptor_set, 0, NULL);
+			fullbright->visframe = r_framecount;
+			if (!cbx->bindless_batch)
+				vulkan_globals.vk_cmd_bind_descriptor_sets (
+					cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.world_pipeline_layout.handle, 2, 1, &fullbright->descriptor_set, 0, NULL);
 		}
 		else
 			fullbright_enabled = false;
@@ -1284,7 +1844,14 @@ void R_DrawTextureChains_Multitexture (cb_context_t *cbx, qmodel_t *model, entit
 
 		texture_t	*texture = R_TextureAnimation (t, ent_frame);
 		gltexture_t *gl_texture = texture->gltexture;
-		if (!r_lightmap_cheatsafe)
+		gl_texture->visframe = r_framecount;
+		if (cbx->bindless_batch)
+		{
+			const uint32_t diffuse_index = TexMgr_BindlessIndex (r_lightmap_cheatsafe ? greytexture : gl_texture);
+			const uint32_t fullbright_index = TexMgr_BindlessIndex (fullbright_enabled ? fullbright : nulltexture);
+			cbx->bindless_textures = diffuse_index | (fullbright_index << 16);
+		}
+		else if (!r_lightmap_cheatsafe)
 			vulkan_globals.vk_cmd_bind_descriptor_sets (
 				cbx->cb, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan_globals.world_pipeline_layout.handle, 0, 1, &gl_texture->descriptor_set, 0, NULL);
 
@@ -1303,6 +1870,7 @@ void R_DrawTextureChains_Multitexture (cb_context_t *cbx, qmodel_t *model, entit
 		R_FlushBatch (cbx, fullbright_enabled, alpha_test, alpha_blend, use_zbias, lightmap_texture, &brushpasses);
 	}
 
+	cbx->bindless_batch = false;
 	Atomic_AddUInt32 (&rs_brushpasses, brushpasses);
 }
 
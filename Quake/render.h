@@ -36,7 +36,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 typedef struct efrag_s
 {
-	struct efrag_s	*leafnext;
+	int				 leafnum;
 	struct entity_s *entity;
 } efrag_t;
 
@@ -67,6 +67,9 @@ typedef struct entity_blas_s
 	VkDeviceSize			   update_scratch_size;
 	struct qmodel_s			  *model;
 	qboolean				   needs_initial_build;
+	int						   built_pose1; // lerp state the BLAS was last built/updated with
+	int						   built_pose2;
+	float					   built_blend;
 } entity_blas_t;
 
 typedef struct entity_s
@@ -129,6 +132,8 @@ typedef struct entity_s
 	int	   contentscache;
 	vec3_t contentscache_origin;
 
+	int render_state; // index into the per-frame entity render states, see R_GetEntityRenderState
+
 	// Per-entity BLAS for animated models
 	struct entity_blas_s *blas_data; // NULL when no BLAS allocated
 } entity_t;
@@ -175,7 +180,7 @@ typedef struct
 	uint32_t		num_verts;
 	float			blend_factor;
 	uint32_t		flags;
-} mesh_interpolate_push_constants_t;
+} mesh_interpolate_params_t;
 
 typedef struct
 {
@@ -187,7 +192,7 @@ typedef struct
 	uint32_t		output_offset;
 	uint32_t		num_verts;
 	float			blend_factor;
-} skinning_push_constants_t;
+} skinning_params_t;
 
 //
 // refresh
@@ -208,6 +213,7 @@ void R_ViewChanged (vrect_t *pvrect, int lineadj, float aspect);
 
 void R_CheckEfrags (void); // johnfitz
 void R_AddEfrags (entity_t *ent);
+void R_SortEfrags (void);
 
 void R_NewMap (void);
 
@@ -1274,56 +1274,76 @@ static void Sbar_DrawModern (cb_context_t *cbx)
 	}
 }
 
+#ifdef USE_RMLUI
 /*
 ===============
-Sbar_Draw
+Sbar_SyncUI
+
+Passes the state Sbar_Draw would show to the RmlUI HUD. Called by the RmlUI
+task instead of Sbar_Draw, so only that task touches the UI documents.
 ===============
 */
-void Sbar_Draw (cb_context_t *cbx)
+void Sbar_SyncUI (void)
 {
-	float w; // johnfitz
-
 	if (scr_con_current == vid.height)
 		return; // console is full screen
 
-#ifdef USE_RMLUI
 	// If we're in-game (world loaded, fully signed on, not a demo), show RmlUI HUD
-	if (cl.worldmodel && cls.signon == SIGNONS && !cls.demoplayback)
+	if (!cl.worldmodel || cls.signon != SIGNONS || cls.demoplayback)
+		return;
+
+	if (!rmlui_hud_shown)
 	{
-		if (!rmlui_hud_shown)
+		UI_ShowHUD (NULL);
+		rmlui_hud_shown = true;
+	}
+	// Sync game state to RmlUI data model
+	UI_SyncGameState (
+		cl.stats, MAX_CL_STATS, cl.items, cl.intermission, cl.gametype, cl.maxclients, cl.levelname, cl.mapname, cl.time, cl_stats_generation);
+
+	// Sync scoreboard player data in deathmatch or when scoreboard visible
+	if (cl.gametype == GAME_DEATHMATCH || sb_showscores)
+	{
+		int				 i;
+		ui_player_info_t sb_players[MAX_SCOREBOARD];
+		int				 sb_count = 0;
+
+		Sbar_SortFrags ();
+		for (i = 0; i < scoreboardlines && i < MAX_SCOREBOARD; i++)
 		{
-			UI_ShowHUD (NULL);
-			rmlui_hud_shown = true;
+			int			  k = fragsort[i];
+			scoreboard_t *s = &cl.scores[k];
+			if (!s->name[0])
+				continue;
+			sb_players[sb_count].name = s->name;
+			sb_players[sb_count].frags = s->frags;
+			sb_players[sb_count].colors = s->colors;
+			sb_players[sb_count].ping = s->ping;
+			sb_players[sb_count].is_local = (k == cl.viewentity - 1) ? 1 : 0;
+			sb_players[sb_count].slot = k;
+			sb_count++;
 		}
-		// Sync game state to RmlUI data model
-		UI_SyncGameState (cl.stats, MAX_CL_STATS, cl.items, cl.intermission, cl.gametype, cl.maxclients, cl.levelname, cl.mapname, cl.time);
+		UI_SyncScoreboard (sb_players, sb_count);
+	}
+}
+#endif
 
-		// Sync scoreboard player data in deathmatch or when scoreboard visible
-		if (cl.gametype == GAME_DEATHMATCH || sb_showscores)
-		{
-			int				 i;
-			ui_player_info_t sb_players[MAX_SCOREBOARD];
-			int				 sb_count = 0;
+/*
+===============
+Sbar_Draw
+===============
+*/
+void Sbar_Draw (cb_context_t *cbx)
+{
+	float w; // johnfitz
 
-			Sbar_SortFrags ();
-			for (i = 0; i < scoreboardlines && i < MAX_SCOREBOARD; i++)
-			{
-				int			  k = fragsort[i];
-				scoreboard_t *s = &cl.scores[k];
-				if (!s->name[0])
-					continue;
-				sb_players[sb_count].name = s->name;
-				sb_players[sb_count].frags = s->frags;
-				sb_players[sb_count].colors = s->colors;
-				sb_players[sb_count].ping = s->ping;
-				sb_players[sb_count].is_local = (k == cl.viewentity - 1) ? 1 : 0;
-				sb_count++;
-			}
-			UI_SyncScoreboard (sb_players, sb_count);
-		}
+	if (scr_con_current == vid.height)
+		return; // console is full screen
 
+#ifdef USE_RMLUI
+	// in game the RmlUI HUD replaces the status bar, see Sbar_SyncUI
+	if (cl.worldmodel && cls.signon == SIGNONS && !cls.demoplayback)
 		return;
-	}
 #endif
 
 	if ((scr_style.value < 1.0f) && cl.qcvm.extfuncs.CSQC_DrawHud && !qcvm)
@@ -32,16 +32,28 @@ void SCR_UpdateScreen (qboolean use_tasks);
 void SCR_UpdateZoom (void);
 void SCR_UpdateFovLerp (void);
 
+void	 SCR_UpdateScreenPipelined (void);
+qboolean SCR_RenderingInFlight (void);
+void	 SCR_SynchronizeRendering (void);
+
 void SCR_CenterPrintClear (void);
 void SCR_CenterPrint (const char *str);
 
 void SCR_BeginLoadingPlaque (void);
 void SCR_EndLoadingPlaque (void);
 
+// timing and progress of loading a map, see SCR_LoadingProgress
+void	 SCR_BeginLoadingPhase (const char *name, int total);
+void	 SCR_EndLoadingPhase (void);
+void	 SCR_LoadingProgress (int done);
+qboolean SCR_IsLoading (void);
+
 int SCR_ModalMessage (const char *text, float timeout); // johnfitz -- added timeout
 
 void SCR_UpdateRelativeScale ();
 
+float SCR_CaptureFrameTime (void);
+
 extern float scr_con_current;
 extern float scr_conlines; // lines of console to display
 
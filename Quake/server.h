@@ -130,9 +130,11 @@ typedef struct client_s
 		PRESPAWN_AMBIENTS,
 		PRESPAWN_SIGNONMSG,
 	} sendsignon; // only valid before spawned
-	int			 signonidx;
-	unsigned int signon_sounds; //
-	unsigned int signon_models; //
+	int					 signonidx;
+	unsigned int		 signon_sounds;	//
+	unsigned int		 signon_models;	//
+	struct signonblob_s *signonblob;	// shared deflated prespawn data (PEXT2_COMPRESSEDSIGNON)
+	int					 signonblobofs;	// how much of it was sent already
 
 	double last_message; // reliable messages must be sent
 						 // periodically
@@ -181,9 +183,20 @@ typedef struct client_s
 	}			 *previousentities;
 	size_t		  numpreviousentities;
 	size_t		  maxpreviousentities;
-	unsigned int  snapshotresume;
-	unsigned int *pendingentities_bits; // UF_ flags for each entity
-	size_t		  numpendingentities;	// realloc if too small
+
+	struct entity_num_state_s *snapshotentities; // the next snapshot is built here, then swapped with previousentities
+	size_t					   numsnapshotentities;
+	size_t					   maxsnapshotentities;
+	byte					  *snapshotpvs; // copy of the fat pvs the snapshot is built from
+	int						   snapshotpvssize;
+
+	unsigned int  snapshotresume;			// index into snapshotorder
+	unsigned int *snapshotorder;			// entities with pending bits, in the order they get written this frame
+	unsigned int  numsnapshotorder;
+	unsigned int  snapshotbytes;			// entity update bytes written this frame, for sv_snapshotbudget
+	unsigned int *pendingentities_bits;		// UF_ flags for each entity
+	float		 *pendingentities_senttime; // time each entity was last written, for prioritising under sv_snapshotbudget
+	size_t		  numpendingentities;		// realloc if too small
 #define SENDFLAG_PRESENT 0x80000000u	// tracks that we previously sent one of these ents (resulting in a remove if the ent gets remove()d).
 #define SENDFLAG_REMOVE	 0x40000000u	// for packetloss to signal that we need to resend a remove.
 #define SENDFLAG_USABLE	 0x00ffffffu	// SendFlags bits that the qc is actually able to use (don't get confused if the mod uses SendFlags=-1).
@@ -339,6 +352,36 @@ void SVFTE_DestroyFrames (client_t *client);
 void SV_BuildEntityState (edict_t *ent, entity_state_t *state);
 void SV_SendClientMessages (void);
 void SV_ClearDatagram (void);
+void SV_FreeSignonBlobs (void);
+
+typedef enum
+{
+	SVSPEEDS_NET,
+	SVSPEEDS_CLIENTS,
+	SVSPEEDS_QC,
+	SVSPEEDS_PHYSICS,
+	SVSPEEDS_SNAPSHOTS,
+	SVSPEEDS_SEND,
+	NUM_SVSPEEDS
+} svspeeds_phase_t;
+
+extern qboolean sv_speeds_active;
+
+void SV_Speeds_Init (void);
+void SV_SpeedsBegin (svspeeds_phase_t phase);
+void SV_SpeedsEnd (void);
+void SV_SpeedsFrame (void);
+
+extern qboolean sv_replaying;
+
+void SV_Replay_Init (void);
+void SV_ReplaySpawn (const char *mapname);
+void SV_ReplayEvents (void);
+void SV_ReplayShutdown (void);
+void SV_RecordFrame (void);
+void SV_RecordConnect (int clientnum);
+void SV_RecordMessage (int clientnum);
+void SV_RecordDrop (int clientnum);
 
 int SV_ModelIndex (const char *name);
 
@@ -363,7 +406,8 @@ void SV_MoveToGoal (void);
 
 void SV_ConnectClient (int clientnum); // called from the netcode to add new clients. also called from pr_ext to spawn new botclients.
 void SV_CheckForNewClients (void);
-void SV_RunClients (void);
+void	 SV_RunClients (void);
+qboolean SV_ReadClientMessage (void);
 void SV_SaveSpawnparms ();
 void SV_SpawnServer (const char *server);
 
@@ -27,6 +27,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "quakedef.h"
 #include "snd_codec.h"
 #include "bgmusic.h"
+#include "atomics.h"
 
 static void S_Play (void);
 static void S_PlayVol (void);
@@ -102,6 +103,43 @@ static cvar_t ambient_fade = {"ambient_fade", "100", CVAR_NONE};
 static cvar_t snd_noextraupdate = {"snd_noextraupdate", "0", CVAR_NONE};
 static cvar_t snd_show = {"snd_show", "0", CVAR_NONE};
 static cvar_t _snd_mixahead = {"_snd_mixahead", "0.1", CVAR_ARCHIVE};
+static cvar_t snd_mixthread = {"snd_mixthread", "1", CVAR_ARCHIVE};	  // mix on a thread of its own instead of in the host frame
+static cvar_t snd_maxvoices = {"snd_maxvoices", "64", CVAR_ARCHIVE};  // only the loudest channels are mixed, 0 mixes all of them
+static cvar_t snd_cullvolume = {"snd_cullvolume", "8", CVAR_NONE};	  // channels quieter than this are not mixed, 8 is silent for 8 bit sounds
+static cvar_t snd_cachesize = {"snd_cachesize", "128", CVAR_ARCHIVE}; // MB of sound data kept loaded, 0 keeps everything
+
+cvar_t snd_speeds = {"snd_speeds", "0", CVAR_NONE};			   // show the mixer statistics on screen
+cvar_t snd_lowlatency = {"snd_lowlatency", "0", CVAR_ARCHIVE}; // adapt the mixahead to underruns, mix in the device callback where supported
+
+snd_stats_t snd_stats;
+uint64_t	snd_filterticks;
+
+static uint64_t		   stats_period_start;
+static uint64_t		   stats_mixticks;
+static uint64_t		   stats_mixpeakticks;
+static uint64_t		   stats_lastmusicticks;
+static int			   stats_updates;
+static atomic_uint64_t stats_musicticks;
+
+// the mixer thread keeps the dma buffer topped up independently of the frame rate, so it can run with less latency
+#define SND_MIXTHREAD_PERIOD   5 // ms
+#define SND_MIXTHREAD_MIXAHEAD 0.05
+#define SND_LOWLATENCY_START   0.01 // snd_lowlatency mixahead before the first underrun
+
+static float	lowlatency_mixahead;
+static float	lowlatency_floor;
+static uint64_t lowlatency_lastchange;
+
+static SDL_Thread	  *mix_thread;
+static atomic_uint32_t mix_thread_quit;
+
+// static sounds that can be heard from somewhere in a leaf, rebuilt when the statics or the world change
+#define STATIC_LEAF_EPSILON 16 // leaf bounds are rounded to integers in the bsp
+static int		*static_leaf_first;
+static int		*static_leaf_channels;
+static qmodel_t *static_leaf_world;
+static qboolean	 static_leafs_dirty = true;
+static mleaf_t	*listener_leaf;
 
 static void S_SoundInfo_f (void)
 {
@@ -117,6 +155,64 @@ static void S_SoundInfo_f (void)
 	Con_Printf ("%5d submission_chunk\n", shm->submission_chunk);
 	Con_Printf ("%5d total_channels\n", total_channels);
 	Con_Printf ("%p dma buffer\n", shm->buffer);
+	Con_Printf ("%5d updates in the last second\n", snd_stats.updates);
+	Con_Printf ("%5.2f ms mix average, %.2f ms peak\n", snd_stats.mix_ms, snd_stats.mix_peak_ms);
+	Con_Printf ("%5.2f ms filter average\n", snd_stats.filter_ms);
+	Con_Printf ("%5.2f ms music decoding in the last second\n", snd_stats.music_ms);
+	Con_Printf ("%5d voices mixed, %d virtual\n", snd_stats.voices, snd_stats.virtual_voices);
+	Con_Printf ("%5d underruns\n", snd_stats.underruns);
+	Con_Printf ("%5.1f ms queued when the last sound started\n", snd_stats.latency_ms);
+	if (shm->ondemand)
+		Con_Printf ("mixing on demand in the device callback\n");
+	else
+		Con_Printf ("%5.1f ms mixahead\n", snd_stats.mixahead_ms);
+}
+
+/*
+================
+S_AddMusicDecodeTime
+
+Called from the music thread
+================
+*/
+void S_AddMusicDecodeTime (uint64_t ticks)
+{
+	Atomic_AddUInt64 (&stats_musicticks, ticks);
+}
+
+/*
+================
+S_UpdateStats
+
+Called after every mix with snd_mutex held
+================
+*/
+static void S_UpdateStats (uint64_t mixticks)
+{
+	const uint64_t now = SDL_GetPerformanceCounter ();
+	const uint64_t frequency = SDL_GetPerformanceFrequency ();
+	const double   ms_per_tick = 1000.0 / (double)frequency;
+	uint64_t	   musicticks;
+
+	stats_mixticks += mixticks;
+	stats_mixpeakticks = q_max (stats_mixpeakticks, mixticks);
+	++stats_updates;
+	if (now - stats_period_start < frequency)
+		return;
+
+	musicticks = Atomic_LoadUInt64 (&stats_musicticks);
+	snd_stats.updates = stats_updates;
+	snd_stats.mix_ms = (double)stats_mixticks * ms_per_tick / stats_updates;
+	snd_stats.mix_peak_ms = (double)stats_mixpeakticks * ms_per_tick;
+	snd_stats.filter_ms = (double)snd_filterticks * ms_per_tick / stats_updates;
+	snd_stats.music_ms = (double)(musicticks - stats_lastmusicticks) * ms_per_tick;
+
+	stats_period_start = now;
+	stats_mixticks = 0;
+	stats_mixpeakticks = 0;
+	stats_lastmusicticks = musicticks;
+	stats_updates = 0;
+	snd_filterticks = 0;
 }
 
 static void SND_Callback_sfxvolume (cvar_t *var)
@@ -133,6 +229,58 @@ static void SND_Callback_snd_filterquality (cvar_t *var)
 	}
 }
 
+/*
+================
+S_MixThread
+================
+*/
+static int S_MixThread (void *data)
+{
+	while (!Atomic_LoadUInt32 (&mix_thread_quit))
+	{
+		S_Update_ ();
+		SDL_Delay (SND_MIXTHREAD_PERIOD);
+	}
+	return 0;
+}
+
+/*
+================
+S_StartMixThread
+================
+*/
+static void S_StartMixThread (void)
+{
+	if (mix_thread || !sound_started || !snd_mixthread.value || shm->ondemand)
+		return;
+	Atomic_StoreUInt32 (&mix_thread_quit, 0);
+	mix_thread = SDL_CreateThread (S_MixThread, "S_MixThread", NULL);
+	if (!mix_thread)
+		Con_Printf ("Couldn't create sound mixer thread: %s\n", SDL_GetError ());
+}
+
+/*
+================
+S_StopMixThread
+================
+*/
+static void S_StopMixThread (void)
+{
+	if (!mix_thread)
+		return;
+	Atomic_StoreUInt32 (&mix_thread_quit, 1);
+	SDL_WaitThread (mix_thread, NULL);
+	mix_thread = NULL;
+}
+
+static void SND_Callback_snd_mixthread (cvar_t *var)
+{
+	if (var->value)
+		S_StartMixThread ();
+	else
+		S_StopMixThread ();
+}
+
 /*
 ================
 S_Startup
@@ -155,6 +303,88 @@ void S_Startup (void)
 	}
 }
 
+#define BENCH_NUM_CHANNELS 32
+
+typedef struct
+{
+	channel_t channels[MAX_CHANNELS];
+	int		  total_channels;
+	int		  paintedtime;
+} bench_paint_t;
+
+/*
+================
+S_BenchPaintSetup
+
+Mixes the ambient loops on 32 channels with the mixer locked out, the channels
+and paint position are put back afterwards
+================
+*/
+static qboolean S_BenchPaintSetup (void **data)
+{
+	bench_paint_t *bench;
+	sfxcache_t	  *sc;
+	int			   i;
+
+	SDL_LockMutex (snd_mutex);
+	if (!sound_started || !shm || !ambient_sfx[AMBIENT_WATER] || !ambient_sfx[AMBIENT_SKY])
+	{
+		SDL_UnlockMutex (snd_mutex);
+		Con_Printf ("bench: sound is not running\n");
+		return false;
+	}
+
+	SNDDMA_LockBuffer ();
+	bench = (bench_paint_t *)Mem_Alloc (sizeof (bench_paint_t));
+	memcpy (bench->channels, snd_channels, sizeof (snd_channels));
+	bench->total_channels = total_channels;
+	bench->paintedtime = paintedtime;
+
+	memset (snd_channels, 0, sizeof (snd_channels));
+	for (i = 0; i < BENCH_NUM_CHANNELS; i++)
+	{
+		channel_t *ch = &snd_channels[NUM_AMBIENTS + i];
+
+		ch->sfx = ambient_sfx[i & 1];
+		sc = S_LoadSound (ch->sfx);
+		if (!sc || sc->length <= 0)
+			continue;
+		ch->pos = (i * 997) % sc->length;
+		ch->end = paintedtime + sc->length - ch->pos;
+		ch->leftvol = 64 + (i * 37) % 192;
+		ch->rightvol = 255 - (i * 53) % 192;
+		ch->master_vol = 255;
+	}
+	total_channels = NUM_AMBIENTS + BENCH_NUM_CHANNELS;
+
+	*data = bench;
+	return true;
+}
+
+static void S_BenchPaintShutdown (void *data)
+{
+	bench_paint_t *bench = (bench_paint_t *)data;
+
+	memcpy (snd_channels, bench->channels, sizeof (snd_channels));
+	total_channels = bench->total_channels;
+	paintedtime = bench->paintedtime;
+	Mem_Free (bench);
+
+	SNDDMA_Submit ();
+	SDL_UnlockMutex (snd_mutex);
+	S_ClearBuffer ();
+}
+
+static void S_BenchPaint (void *data, int count)
+{
+	int i;
+
+	for (i = 0; i < count; i++)
+		S_PaintChannels (paintedtime + 512);
+}
+
+static const bench_case_t s_bench_paint = {"paint_channels_32", S_BenchPaintSetup, S_BenchPaint, S_BenchPaintShutdown};
+
 /*
 ================
 S_Init
@@ -187,6 +417,13 @@ void S_Init (void)
 	Cvar_RegisterVariable (&snd_filterquality);
 	Cvar_RegisterVariable (&snd_waterfx);
 	Cvar_RegisterVariable (&snd_pauselooping);
+	Cvar_RegisterVariable (&snd_mixthread);
+	Cvar_RegisterVariable (&snd_maxvoices);
+	Cvar_RegisterVariable (&snd_cullvolume);
+	Cvar_RegisterVariable (&snd_cachesize);
+	Cvar_RegisterVariable (&snd_speeds);
+	Cvar_RegisterVariable (&snd_lowlatency);
+	Bench_Register (&s_bench_paint);
 
 	if (safemode || COM_CheckParm ("-nosound"))
 		return;
@@ -213,6 +450,7 @@ void S_Init (void)
 
 	Cvar_SetCallback (&sfxvolume, SND_Callback_sfxvolume);
 	Cvar_SetCallback (&snd_filterquality, &SND_Callback_snd_filterquality);
+	Cvar_SetCallback (&snd_mixthread, SND_Callback_snd_mixthread);
 
 	SND_InitScaletable ();
 	num_sfx = 0;
@@ -233,6 +471,7 @@ void S_Init (void)
 	S_CodecInit ();
 
 	S_StopAllSounds (true, false);
+	S_StartMixThread ();
 }
 
 // =======================================================================
@@ -243,6 +482,7 @@ void S_Shutdown (void)
 	if (!sound_started)
 		return;
 
+	S_StopMixThread ();
 	sound_started = 0;
 	snd_blocked = 0;
 
@@ -260,6 +500,9 @@ static void S_FlushOldestSounds (void)
 {
 	assert (num_sfx == countof (known_sfx));
 
+	// the deferred loads point into known_sfx
+	S_FinishPrecaching ();
+
 	for (int i = 0; i < MAX_SOUNDS; ++i)
 	{
 		SAFE_FREE (known_sfx[i].cache);
@@ -270,6 +513,68 @@ static void S_FlushOldestSounds (void)
 
 	num_sfx = MAX_SOUNDS;
 }
+/*
+==================
+S_CompareSoundUse
+
+Least recently used first
+==================
+*/
+static int S_CompareSoundUse (const void *a, const void *b)
+{
+	const sfx_t *sfx_a = *(const sfx_t **)a;
+	const sfx_t *sfx_b = *(const sfx_t **)b;
+	return (sfx_a->lastused > sfx_b->lastused) - (sfx_a->lastused < sfx_b->lastused);
+}
+
+/*
+==================
+S_TrimSoundCache
+
+Once the loaded sounds exceed snd_cachesize, frees the least recently used
+ones that aren't on a channel. S_LoadSound loads them again when they are
+needed. Must be called with snd_mutex held.
+==================
+*/
+void S_TrimSoundCache (const sfx_t *keep)
+{
+	static sfx_t *loaded[countof (known_sfx)];
+	size_t		  budget, total;
+	int			  numloaded;
+	int			  i, j;
+	sfx_t		 *sfx;
+
+	if (snd_cachesize.value <= 0)
+		return;
+
+	budget = (size_t)(snd_cachesize.value * 1024 * 1024);
+	total = 0;
+	numloaded = 0;
+	for (sfx = known_sfx, i = 0; i < num_sfx; i++, sfx++)
+	{
+		if (!sfx->cache)
+			continue;
+		total += sizeof (sfxcache_t) + sfx->cache->length * sfx->cache->width * (sfx->cache->stereo + 1);
+		if (sfx != keep)
+			loaded[numloaded++] = sfx;
+	}
+	if (total <= budget)
+		return;
+
+	qsort (loaded, numloaded, sizeof (sfx_t *), S_CompareSoundUse);
+	for (i = 0; i < numloaded && total > budget; i++)
+	{
+		sfx = loaded[i];
+		for (j = 0; j < total_channels; j++)
+			if (snd_channels[j].sfx == sfx)
+				break;
+		if (j < total_channels)
+			continue;
+		total -= sizeof (sfxcache_t) + sfx->cache->length * sfx->cache->width * (sfx->cache->stereo + 1);
+		SAFE_FREE (sfx->cache);
+	}
+}
+
 /*
 ==================
 S_FindName
@@ -325,6 +630,23 @@ void S_TouchSound (const char *name)
 	S_FindName (name);
 }
 
+/*
+==================
+S_PrefetchSound
+
+Queues the file of a sound S_PrecacheSound would load for COM_StartPrefetch
+==================
+*/
+void S_PrefetchSound (const char *name)
+{
+	char namebuffer[256];
+
+	if (!sound_started || nosound.value || !precache.value || S_FindName (name)->cache)
+		return;
+	q_snprintf (namebuffer, sizeof (namebuffer), "sound/%s", name);
+	COM_PrefetchFile (namebuffer);
+}
+
 /*
 ==================
 S_PrecacheSound
@@ -342,7 +664,7 @@ sfx_t *S_PrecacheSound (const char *name)
 
 	// cache it in
 	if (precache.value)
-		S_LoadSound (sfx);
+		S_PrecacheSoundLater (sfx);
 
 	return sfx;
 }
@@ -490,6 +812,9 @@ void S_StartSound (int entnum, int entchannel, sfx_t *sfx, vec3_t origin, float
 	target_chan->pos = 0.0;
 	target_chan->end = paintedtime + sc->length;
 
+	// the channel is mixed from paintedtime on, which the device reaches after what is already queued
+	snd_stats.latency_ms = (paintedtime - soundtime) * 1000.0 / shm->speed;
+
 	// if an identical sound has also been started this frame, offset the pos
 	// a bit to keep it from just making the first one louder
 	check = &snd_channels[NUM_AMBIENTS];
@@ -553,6 +878,7 @@ void S_StopAllSounds (qboolean clear, qboolean keep_statics)
 
 	if (!keep_statics)
 		total_channels = MAX_DYNAMIC_CHANNELS + NUM_AMBIENTS; // no statics
+	static_leafs_dirty = true;
 
 	for (i = 0; i < MAX_CHANNELS; i++)
 	{
@@ -630,6 +956,7 @@ void S_StaticSound (sfx_t *sfx, vec3_t origin, int vol, float attenuation)
 
 	ss = &snd_channels[total_channels];
 	total_channels++;
+	static_leafs_dirty = true;
 
 	sc = S_LoadSound (sfx);
 	if (!sc)
@@ -686,6 +1013,7 @@ static void S_UpdateAmbientSounds (void)
 	static float vol, levels[NUM_AMBIENTS]; // Spike: fixing ambient levels not changing at high enough framerates due to integer precison.
 
 	SDL_LockMutex (snd_mutex);
+	listener_leaf = NULL;
 
 	// no ambients when disconnected
 	if (cls.state != ca_connected || cls.signon != SIGNONS)
@@ -698,6 +1026,7 @@ static void S_UpdateAmbientSounds (void)
 		goto unlock_mutex;
 
 	l = Mod_PointInLeaf (listener_origin, cl.worldmodel);
+	listener_leaf = l;
 	S_SetUnderwaterIntensity (l ? S_UnderwaterIntensityForContents (l->contents) : 0.f);
 	if (!l || !ambient_level.value)
 	{
@@ -753,6 +1082,7 @@ void S_RawSamples (int samples, int rate, int width, int channels, byte *data, f
 	float scale;
 	int	  intVolume;
 
+	SDL_LockMutex (snd_mutex);
 	if (s_rawend < paintedtime)
 		s_rawend = paintedtime;
 
@@ -819,6 +1149,169 @@ void S_RawSamples (int samples, int rate, int width, int channels, byte *data, f
 			s_rawsamples[dst].right = (((byte *)data)[src] - 128) * intVolume;
 		}
 	}
+	SDL_UnlockMutex (snd_mutex);
+}
+
+/*
+============
+SND_CompareVoices
+
+Loudest first
+============
+*/
+static int SND_CompareVoices (const void *a, const void *b)
+{
+	const channel_t *ch_a = *(const channel_t **)a;
+	const channel_t *ch_b = *(const channel_t **)b;
+	return q_max (ch_b->leftvol, ch_b->rightvol) - q_max (ch_a->leftvol, ch_a->rightvol);
+}
+
+/*
+============
+SND_CullVoices
+
+Silences channels that are too quiet to hear or beyond the snd_maxvoices
+loudest ones. They stay allocated and the mixer keeps advancing them, so
+they resume in the right place once they are audible again.
+============
+*/
+static void SND_CullVoices (void)
+{
+	static channel_t *voices[MAX_CHANNELS];
+	int				  numvoices, numchannels, maxvoices;
+	int				  i;
+	channel_t		 *ch;
+
+	numvoices = 0;
+	numchannels = 0;
+	ch = snd_channels + NUM_AMBIENTS;
+	for (i = NUM_AMBIENTS; i < total_channels; i++, ch++)
+	{
+		if (!ch->sfx)
+			continue;
+		++numchannels;
+		if (!ch->leftvol && !ch->rightvol)
+			continue;
+		if (ch->leftvol < snd_cullvolume.value && ch->rightvol < snd_cullvolume.value)
+		{
+			ch->leftvol = ch->rightvol = 0;
+			continue;
+		}
+		voices[numvoices++] = ch;
+	}
+
+	maxvoices = (int)snd_maxvoices.value;
+	if (maxvoices > 0 && numvoices > maxvoices)
+	{
+		qsort (voices, numvoices, sizeof (channel_t *), SND_CompareVoices);
+		for (i = maxvoices; i < numvoices; i++)
+			voices[i]->leftvol = voices[i]->rightvol = 0;
+		numvoices = maxvoices;
+	}
+
+	snd_stats.voices = numvoices;
+	snd_stats.virtual_voices = numchannels - numvoices;
+}
+
+/*
+============
+S_BuildStaticLeafs
+
+Lists for every leaf of the world the static sounds whose attenuation reaches into it, so S_Update
+doesn't have to spatialize the ones that are silent anyway. A sound is audible closer than 1 / dist_mult.
+============
+*/
+static void S_BuildStaticLeafs (void)
+{
+	qmodel_t	  *world = cl.worldmodel;
+	const mleaf_t *leaf;
+	channel_t	  *ch;
+	vec_t		   d, dist;
+	int			   i, j, k, pass, count;
+
+	SAFE_FREE (static_leaf_first);
+	SAFE_FREE (static_leaf_channels);
+	static_leaf_world = world;
+	if (!world || world->needload)
+		return;
+	static_leafs_dirty = false;
+	if (total_channels <= MAX_DYNAMIC_CHANNELS + NUM_AMBIENTS)
+		return;
+
+	// count first, then fill in
+	static_leaf_first = (int *)Mem_AllocTagged ((world->numleafs + 2) * sizeof (int), MEM_TAG_SOUND);
+	for (pass = 0; pass < 2; pass++)
+	{
+		count = 0;
+		for (i = 0, leaf = world->leafs; i <= world->numleafs; i++, leaf++)
+		{
+			static_leaf_first[i] = count;
+			for (j = MAX_DYNAMIC_CHANNELS + NUM_AMBIENTS, ch = snd_channels + j; j < total_channels; j++, ch++)
+			{
+				if (!ch->sfx)
+					continue;
+				if (ch->dist_mult > 0)
+				{
+					dist = 0;
+					for (k = 0; k < 3; k++)
+					{
+						d = q_max (leaf->minmaxs[k] - STATIC_LEAF_EPSILON - ch->origin[k], ch->origin[k] - leaf->minmaxs[3 + k] - STATIC_LEAF_EPSILON);
+						if (d > 0)
+							dist += d * d;
+					}
+					if (dist * ch->dist_mult * ch->dist_mult >= 1)
+						continue;
+				}
+				if (pass)
+					static_leaf_channels[count] = j;
+				count++;
+			}
+		}
+		static_leaf_first[world->numleafs + 1] = count;
+		if (!pass)
+			static_leaf_channels = (int *)Mem_AllocTagged (q_max (count, 1) * sizeof (int), MEM_TAG_SOUND);
+	}
+}
+
+/*
+============
+SND_UpdateStatic
+============
+*/
+static void SND_UpdateStatic (channel_t *ch, channel_t **combine)
+{
+	channel_t *other;
+
+	if (!ch->sfx)
+		return;
+	SND_Spatialize (ch); // respatialize channel
+	if (!ch->leftvol && !ch->rightvol)
+		return;
+
+	// try to combine static sounds with a previous channel of the same
+	// sound effect so we don't mix five torches every frame
+
+	// see if it can just use the last one
+	if (*combine && (*combine)->sfx == ch->sfx)
+	{
+		(*combine)->leftvol += ch->leftvol;
+		(*combine)->rightvol += ch->rightvol;
+		ch->leftvol = ch->rightvol = 0;
+		return;
+	}
+	// search for one
+	for (other = snd_channels + MAX_DYNAMIC_CHANNELS + NUM_AMBIENTS; other < ch; other++)
+	{
+		if (other->sfx == ch->sfx)
+			break;
+	}
+	*combine = other;
+	if (other != ch)
+	{
+		other->leftvol += ch->leftvol;
+		other->rightvol += ch->rightvol;
+		ch->leftvol = ch->rightvol = 0;
+	}
 }
 
 /*
@@ -830,7 +1323,7 @@ Called once each time through the main loop
 */
 void S_Update (vec3_t origin, vec3_t forward, vec3_t right, vec3_t up)
 {
-	int		   i, j;
+	int		   i, leaf;
 	int		   total;
 	channel_t *ch;
 	channel_t *combine;
@@ -847,56 +1340,34 @@ void S_Update (vec3_t origin, vec3_t forward, vec3_t right, vec3_t up)
 	// update general area ambient sound sources
 	S_UpdateAmbientSounds ();
 
-	combine = NULL;
-
-	// update spatialization for static and dynamic sounds
+	// update spatialization for dynamic sounds
 	ch = snd_channels + NUM_AMBIENTS;
-	for (i = NUM_AMBIENTS; i < total_channels; i++, ch++)
+	for (i = NUM_AMBIENTS; i < q_min (total_channels, MAX_DYNAMIC_CHANNELS + NUM_AMBIENTS); i++, ch++)
 	{
-		if (!ch->sfx)
-			continue;
-		SND_Spatialize (ch); // respatialize channel
-		if (!ch->leftvol && !ch->rightvol)
-			continue;
-
-		// try to combine static sounds with a previous channel of the same
-		// sound effect so we don't mix five torches every frame
-
-		if (i >= MAX_DYNAMIC_CHANNELS + NUM_AMBIENTS)
-		{
-			// see if it can just use the last one
-			if (combine && combine->sfx == ch->sfx)
-			{
-				combine->leftvol += ch->leftvol;
-				combine->rightvol += ch->rightvol;
-				ch->leftvol = ch->rightvol = 0;
-				continue;
-			}
-			// search for one
-			combine = snd_channels + MAX_DYNAMIC_CHANNELS + NUM_AMBIENTS;
-			for (j = MAX_DYNAMIC_CHANNELS + NUM_AMBIENTS; j < i; j++, combine++)
-			{
-				if (combine->sfx == ch->sfx)
-					break;
-			}
+		if (ch->sfx)
+			SND_Spatialize (ch); // respatialize channel
+	}
 
-			if (j == total_channels)
-			{
-				combine = NULL;
-			}
-			else
-			{
-				if (combine != ch)
-				{
-					combine->leftvol += ch->leftvol;
-					combine->rightvol += ch->rightvol;
-					ch->leftvol = ch->rightvol = 0;
-				}
-				continue;
-			}
-		}
+	// static sounds, only the ones that can be heard from the listener's leaf unless it is unknown
+	if (static_leafs_dirty || static_leaf_world != cl.worldmodel)
+		S_BuildStaticLeafs ();
+	combine = NULL;
+	if (static_leaf_first && listener_leaf && static_leaf_world == cl.worldmodel)
+	{
+		for (i = MAX_DYNAMIC_CHANNELS + NUM_AMBIENTS; i < total_channels; i++)
+			snd_channels[i].leftvol = snd_channels[i].rightvol = 0;
+		leaf = listener_leaf - cl.worldmodel->leafs;
+		for (i = static_leaf_first[leaf]; i < static_leaf_first[leaf + 1]; i++)
+			SND_UpdateStatic (&snd_channels[static_leaf_channels[i]], &combine);
+	}
+	else
+	{
+		for (i = MAX_DYNAMIC_CHANNELS + NUM_AMBIENTS; i < total_channels; i++)
+			SND_UpdateStatic (&snd_channels[i], &combine);
 	}
 
+	SND_CullVoices ();
+
 	//
 	// debugging output
 	//
@@ -919,8 +1390,9 @@ void S_Update (vec3_t origin, vec3_t forward, vec3_t right, vec3_t up)
 	// add raw data from streamed samples
 	//	BGM_Update();	// moved to the main loop just before S_Update ()
 
-	// mix some sound
-	S_Update_ ();
+	// mix some sound, unless the mixer thread does
+	if (!mix_thread)
+		S_Update_ ();
 
 unlock_mutex:
 	SDL_UnlockMutex (snd_mutex);
@@ -955,9 +1427,53 @@ static void GetSoundtime (void)
 	soundtime = buffers * fullsamples + samplepos / shm->channels;
 }
 
+/*
+============
+S_GetMixahead
+
+With snd_lowlatency the mixer thread starts with little audio queued and
+grows it on every underrun. Without underruns it shrinks back about 5% a
+second, but never below what underran before, so it settles instead of
+crackling periodically.
+============
+*/
+static float S_GetMixahead (qboolean underrun)
+{
+	const uint64_t now = SDL_GetPerformanceCounter ();
+	const float	   maxahead = _snd_mixahead.value;
+
+	if (!mix_thread)
+		return maxahead;
+	if (!snd_lowlatency.value)
+	{
+		lowlatency_mixahead = 0.0f;
+		return q_min (maxahead, SND_MIXTHREAD_MIXAHEAD);
+	}
+
+	if (!lowlatency_mixahead)
+	{
+		lowlatency_mixahead = lowlatency_floor = SND_LOWLATENCY_START;
+		lowlatency_lastchange = now;
+	}
+	if (underrun)
+	{
+		lowlatency_floor = q_max (lowlatency_floor, lowlatency_mixahead * 1.25f);
+		lowlatency_mixahead *= 1.5f;
+		lowlatency_lastchange = now;
+	}
+	else if (now - lowlatency_lastchange >= SDL_GetPerformanceFrequency ())
+	{
+		lowlatency_mixahead = q_max (lowlatency_floor, lowlatency_mixahead * 0.95f);
+		lowlatency_lastchange = now;
+	}
+	lowlatency_floor = q_min (lowlatency_floor, maxahead);
+	lowlatency_mixahead = q_min (lowlatency_mixahead, maxahead);
+	return lowlatency_mixahead;
+}
+
 void S_ExtraUpdate (void)
 {
-	if (snd_noextraupdate.value)
+	if (snd_noextraupdate.value || mix_thread)
 		return; // don't pollute timings
 	S_Update_ ();
 }
@@ -966,8 +1482,12 @@ static void S_Update_ (void)
 {
 	unsigned int endtime;
 	int			 samps;
+	uint64_t	 start;
+	qboolean	 underrun = false;
+	float		 mixahead;
 
-	if (!snd_initialized)
+	// the driver calls S_PaintOnDemand itself
+	if (!snd_initialized || (shm && shm->ondemand))
 		return;
 
 	SDL_LockMutex (snd_mutex);
@@ -987,14 +1507,20 @@ static void S_Update_ (void)
 	{
 		//	Con_Printf ("S_Update_ : overflow\n");
 		paintedtime = soundtime;
+		++snd_stats.underruns;
+		underrun = true;
 	}
 
 	// mix ahead of current position
-	endtime = soundtime + (unsigned int)(_snd_mixahead.value * shm->speed);
+	mixahead = S_GetMixahead (underrun);
+	snd_stats.mixahead_ms = mixahead * 1000.0;
+	endtime = soundtime + (unsigned int)(mixahead * shm->speed);
 	samps = shm->samples >> (shm->channels - 1);
 	endtime = q_min (endtime, (unsigned int)(soundtime + samps));
 
+	start = SDL_GetPerformanceCounter ();
 	S_PaintChannels (endtime);
+	S_UpdateStats (SDL_GetPerformanceCounter () - start);
 
 	SNDDMA_Submit ();
 
@@ -1002,8 +1528,45 @@ unlock_mutex:
 	SDL_UnlockMutex (snd_mutex);
 }
 
+/*
+==================
+S_PaintOnDemand
+
+Called from the audio callback of drivers that set shm->ondemand, mixes
+exactly the frames the device is about to take out of the dma buffer
+==================
+*/
+void S_PaintOnDemand (int frames)
+{
+	uint64_t start;
+	int		 samps;
+
+	SDL_LockMutex (snd_mutex);
+	if (sound_started && snd_blocked <= 0 && shm && shm->buffer)
+	{
+		GetSoundtime ();
+		if (paintedtime < soundtime)
+		{
+			paintedtime = soundtime;
+			++snd_stats.underruns;
+		}
+		snd_stats.mixahead_ms = 0.0;
+
+		samps = shm->samples >> (shm->channels - 1);
+		start = SDL_GetPerformanceCounter ();
+		S_PaintChannels (soundtime + q_min (frames, samps));
+		S_UpdateStats (SDL_GetPerformanceCounter () - start);
+	}
+	SDL_UnlockMutex (snd_mutex);
+}
+
+// The driver calls below are made without snd_mutex held: on demand drivers
+// hold their device lock while the callback waits for snd_mutex.
+
 void S_BlockSound (void)
 {
+	qboolean block = false;
+
 	SDL_LockMutex (snd_mutex);
 	/* FIXME: do we really need the blocking at the
 	 * driver level?
@@ -1012,14 +1575,18 @@ void S_BlockSound (void)
 	{
 		snd_blocked = 1;
 		S_ClearBuffer ();
-		if (shm)
-			SNDDMA_BlockSound ();
+		block = (shm != NULL);
 	}
 	SDL_UnlockMutex (snd_mutex);
+
+	if (block)
+		SNDDMA_BlockSound ();
 }
 
 void S_UnblockSound (void)
 {
+	qboolean unblock = false;
+
 	SDL_LockMutex (snd_mutex);
 
 	if (!sound_started || !snd_blocked)
@@ -1027,12 +1594,15 @@ void S_UnblockSound (void)
 	if (snd_blocked == 1) /* --snd_blocked == 0 */
 	{
 		snd_blocked = 0;
-		SNDDMA_UnblockSound ();
 		S_ClearBuffer ();
+		unblock = true;
 	}
 
 unlock_mutex:
 	SDL_UnlockMutex (snd_mutex);
+
+	if (unblock)
+		SNDDMA_UnblockSound ();
 }
 
 /*
@@ -1052,6 +1622,22 @@ void S_ClearAll (void)
 	SDL_UnlockMutex (snd_mutex);
 }
 
+/*
+===============================================================================
+S_ClearMap
+
+Sounds are looked up by name and the game directory can't change without
+S_ClearAll, so the previous map's sounds stay loaded for the next one. Only
+what exceeds snd_cachesize is freed, least recently used first.
+===============================================================================
+*/
+void S_ClearMap (void)
+{
+	SDL_LockMutex (snd_mutex);
+	S_TrimSoundCache (NULL);
+	SDL_UnlockMutex (snd_mutex);
+}
+
 /*
 ===============================================================================
 
@@ -1152,7 +1738,3 @@ unlock_mutex:
 }
 
 void S_ClearPrecache (void) {}
-
-void S_BeginPrecaching (void) {}
-
-void S_EndPrecaching (void) {}
@@ -22,25 +22,118 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "quakedef.h"
 
+#if defined(USE_NEON)
+#include <arm_neon.h>
+#endif
+
 extern SDL_Mutex *snd_mutex;
 
+#define SND_RESAMPLE_TAPS	16 // multiple of 4
+#define SND_RESAMPLE_PHASES 128
+
+typedef struct
+{
+	sfx_t	   *sfx;
+	sfxcache_t *sc;
+	const byte *file;
+	const byte *samples;
+	int			inrate;
+	int			inwidth;
+} sfxload_t;
+
+static uint32_t	  sfx_usecount;
+static qboolean	  sfx_precaching;
+static sfxload_t *sfx_loads;
+static int		  num_sfx_loads;
+static int		  max_sfx_loads;
+
+/*
+================
+S_MakeResampleKernel
+
+Blackman windowed sinc with a row of taps for each fractional source position.
+When decimating the cutoff drops to the output Nyquist frequency.
+================
+*/
+static void S_MakeResampleKernel (float *kernel, float stepscale)
+{
+	const double cutoff = q_min (1.0, 1.0 / stepscale);
+	int			 phase, j;
+
+	for (phase = 0; phase < SND_RESAMPLE_PHASES; phase++)
+	{
+		float *taps = kernel + phase * SND_RESAMPLE_TAPS;
+		double sum = 0.0;
+
+		for (j = 0; j < SND_RESAMPLE_TAPS; j++)
+		{
+			const double t = j - SND_RESAMPLE_TAPS / 2 + 1 - (double)phase / SND_RESAMPLE_PHASES;
+			const double u = (t + SND_RESAMPLE_TAPS / 2) / SND_RESAMPLE_TAPS;
+			const double x = M_PI * cutoff * t;
+			const double sinc = (x == 0.0) ? 1.0 : sin (x) / x;
+			taps[j] = sinc * (0.42 - 0.5 * cos (2 * M_PI * u) + 0.08 * cos (4 * M_PI * u));
+			sum += taps[j];
+		}
+
+		// normalize each phase so there is no ripple on DC
+		for (j = 0; j < SND_RESAMPLE_TAPS; j++)
+			taps[j] /= sum;
+	}
+}
+
+/*
+================
+S_ResampleDot
+================
+*/
+static FORCE_INLINE float S_ResampleDot (const float *taps, const float *src)
+{
+	int	  i;
+	float val[4];
+#if defined(USE_SSE2)
+	__m128 sum = _mm_setzero_ps ();
+
+	for (i = 0; i < SND_RESAMPLE_TAPS; i += 4)
+		sum = _mm_add_ps (sum, _mm_mul_ps (_mm_loadu_ps (taps + i), _mm_loadu_ps (src + i)));
+	_mm_storeu_ps (val, sum);
+#elif defined(USE_NEON)
+	float32x4_t sum = vdupq_n_f32 (0.0f);
+
+	for (i = 0; i < SND_RESAMPLE_TAPS; i += 4)
+		sum = vaddq_f32 (sum, vmulq_f32 (vld1q_f32 (taps + i), vld1q_f32 (src + i)));
+	vst1q_f32 (val, sum);
+#else
+	val[0] = val[1] = val[2] = val[3] = 0.0f;
+	for (i = 0; i < SND_RESAMPLE_TAPS; i += 4)
+	{
+		val[0] += taps[i] * src[i];
+		val[1] += taps[i + 1] * src[i + 1];
+		val[2] += taps[i + 2] * src[i + 2];
+		val[3] += taps[i + 3] * src[i + 3];
+	}
+#endif
+	return val[0] + val[1] + val[2] + val[3];
+}
+
 /*
 ================
 ResampleSfx
+
+Only reads the source data and writes sc, so it can run on a task worker
 ================
 */
-static void ResampleSfx (sfx_t *sfx, int inrate, int inwidth, byte *data)
+static void ResampleSfx (sfxcache_t *sc, int inrate, int inwidth, const byte *data)
 {
 	int	  outcount;
+	int	  inlength;
 	int	  srcsample;
 	float stepscale;
 	int	  i;
 	int	  sample, fracstep;
 
-	sfxcache_t *sc = sfx->cache;
-
 	stepscale = (float)inrate / shm->speed; // this is usually 0.5, 1, or 2
 
+	inlength = sc->length;
 	outcount = sc->length / stepscale;
 	sc->length = outcount;
 	if (sc->loopstart != -1)
@@ -61,6 +154,45 @@ static void ResampleSfx (sfx_t *sfx, int inrate, int inwidth, byte *data)
 		for (i = 0; i < outcount; i++)
 			((signed char *)sc->data)[i] = (int)((unsigned char)(data[i]) - 128);
 	}
+	else if (stepscale != 1)
+	{
+		// windowed sinc interpolation, the source is converted to float with
+		// SND_RESAMPLE_TAPS / 2 samples of silence on either side
+		int64_t samplefrac = 0;
+		int64_t fracstep64 = (int64_t)(stepscale * 65536);
+		int		phase;
+		float	val;
+
+		TEMP_ALLOC (float, kernel, SND_RESAMPLE_TAPS * SND_RESAMPLE_PHASES);
+		TEMP_ALLOC_ZEROED (float, src, inlength + SND_RESAMPLE_TAPS);
+
+		S_MakeResampleKernel (kernel, stepscale);
+		for (i = 0; i < inlength; i++)
+		{
+			if (inwidth == 2)
+				src[SND_RESAMPLE_TAPS / 2 + i] = LittleShort (((short *)data)[i]);
+			else
+				src[SND_RESAMPLE_TAPS / 2 + i] = ((int)data[i] - 128) * 256;
+		}
+
+		for (i = 0; i < outcount; i++)
+		{
+			srcsample = (int)(samplefrac >> 16);
+			phase = (int)(((samplefrac & 0xFFFF) * SND_RESAMPLE_PHASES) >> 16);
+			samplefrac += fracstep64;
+
+			// the taps cover srcsample - SND_RESAMPLE_TAPS / 2 + 1 to srcsample + SND_RESAMPLE_TAPS / 2
+			val = S_ResampleDot (kernel + phase * SND_RESAMPLE_TAPS, src + srcsample + 1);
+			sample = Q_rint (CLAMP (-32768.f, val, 32767.f));
+			if (sc->width == 2)
+				((short *)sc->data)[i] = sample;
+			else
+				((signed char *)sc->data)[i] = sample >> 8;
+		}
+
+		TEMP_FREE (src);
+		TEMP_FREE (kernel);
+	}
 	else
 	{
 		// general case
@@ -87,26 +219,20 @@ static void ResampleSfx (sfx_t *sfx, int inrate, int inwidth, byte *data)
 
 /*
 ==============
-S_LoadSound
+S_OpenSound
+
+Reads the file and parses its header, must be called with snd_mutex held.
+Returns a cache that still has to be filled by ResampleSfx.
 ==============
 */
-sfxcache_t *S_LoadSound (sfx_t *s)
+static sfxcache_t *S_OpenSound (sfx_t *s, sfxload_t *load)
 {
 	char		namebuffer[256];
-	byte	   *data = NULL;
+	const byte *data;
 	wavinfo_t	info;
 	int			len;
 	float		stepscale;
-	sfxcache_t *sc = NULL;
-
-	SDL_LockMutex (snd_mutex);
-
-	// see if still in memory
-	if (s->cache)
-	{
-		sc = s->cache;
-		goto unlock_mutex;
-	}
+	sfxcache_t *sc;
 
 	//	Con_Printf ("S_LoadSound: %x\n", (int)stackbuf);
 
@@ -116,25 +242,25 @@ sfxcache_t *S_LoadSound (sfx_t *s)
 
 	//	Con_Printf ("loading %s\n",namebuffer);
 
-	data = COM_LoadFile (namebuffer, NULL);
+	data = COM_LoadFileView (namebuffer, NULL);
 
 	if (!data)
 	{
 		Con_Printf ("Couldn't load %s\n", namebuffer);
-		goto unlock_mutex;
+		return NULL;
 	}
 
-	info = GetWavinfo (s->name, data, com_filesize);
+	info = GetWavinfo (s->name, (byte *)data, com_filesize);
 	if (info.channels != 1)
 	{
 		Con_Printf ("%s is a stereo sample\n", s->name);
-		goto unlock_mutex;
+		goto fail;
 	}
 
 	if (info.width != 1 && info.width != 2)
 	{
 		Con_Printf ("%s is not 8 or 16 bit\n", s->name);
-		goto unlock_mutex;
+		goto fail;
 	}
 
 	stepscale = (float)info.rate / shm->speed;
@@ -145,27 +271,171 @@ sfxcache_t *S_LoadSound (sfx_t *s)
 	if (info.samples == 0 || len == 0)
 	{
 		Con_Printf ("%s has zero samples\n", s->name);
-		goto unlock_mutex;
+		goto fail;
 	}
 
-	sc = (sfxcache_t *)Mem_Alloc (len + sizeof (sfxcache_t));
+	sc = (sfxcache_t *)Mem_AllocTagged (len + sizeof (sfxcache_t), MEM_TAG_SOUND);
 	if (!sc)
-		goto unlock_mutex;
+		goto fail;
 	sc->length = info.samples;
 	sc->loopstart = info.loopstart;
 	sc->speed = info.rate;
 	sc->width = info.width;
 	sc->stereo = info.channels;
 
-	s->cache = sc;
-	ResampleSfx (s, sc->speed, sc->width, data + info.dataofs);
+	load->sfx = s;
+	load->sc = sc;
+	load->file = data;
+	load->samples = data + info.dataofs;
+	load->inrate = sc->speed;
+	load->inwidth = sc->width;
+	return sc;
+
+fail:
+	COM_FreeFileView (data);
+	return NULL;
+}
+
+/*
+==============
+S_LoadSound
+==============
+*/
+sfxcache_t *S_LoadSound (sfx_t *s)
+{
+	sfxload_t	load;
+	sfxcache_t *sc;
+
+	SDL_LockMutex (snd_mutex);
+
+	// see if still in memory
+	sc = s->cache;
+	if (!sc)
+	{
+		sc = S_OpenSound (s, &load);
+		if (sc)
+		{
+			ResampleSfx (sc, load.inrate, load.inwidth, load.samples);
+			COM_FreeFileView (load.file);
+			s->cache = sc;
+			S_TrimSoundCache (s);
+		}
+	}
+	s->lastused = ++sfx_usecount;
 
-unlock_mutex:
-	Mem_Free (data);
 	SDL_UnlockMutex (snd_mutex);
 	return sc;
 }
 
+/*
+==============
+S_ResampleTask
+==============
+*/
+static void S_ResampleTask (int index, void *unused)
+{
+	const sfxload_t *load = &sfx_loads[index];
+	ResampleSfx (load->sc, load->inrate, load->inwidth, load->samples);
+}
+
+/*
+==============
+S_FinishPrecaching
+
+Loads everything S_PrecacheSoundLater queued. The files are read and parsed
+here, the resampling runs on the task workers.
+==============
+*/
+void S_FinishPrecaching (void)
+{
+	sfxload_t	 *load;
+	task_handle_t task;
+	int			  i, count;
+
+	if (!num_sfx_loads)
+		return;
+
+	// the queue holds sfx_t pointers, S_OpenSound turns them into loads in place
+	SDL_LockMutex (snd_mutex);
+	count = 0;
+	for (i = 0; i < num_sfx_loads; i++)
+	{
+		sfx_t *s = sfx_loads[i].sfx;
+		if (!s->cache && S_OpenSound (s, &sfx_loads[count]))
+			count++;
+	}
+	SDL_UnlockMutex (snd_mutex);
+	num_sfx_loads = 0;
+	if (!count)
+		return;
+
+	task = Task_AllocateAssignIndexedFuncAndSubmit (S_ResampleTask, count, NULL, 0);
+	Task_Join (task, TASK_TIMEOUT_INFINITE);
+
+	SDL_LockMutex (snd_mutex);
+	for (i = 0, load = sfx_loads; i < count; i++, load++)
+	{
+		COM_FreeFileView (load->file);
+		load->sfx->cache = load->sc;
+		load->sfx->lastused = ++sfx_usecount;
+	}
+	S_TrimSoundCache (NULL);
+	SDL_UnlockMutex (snd_mutex);
+}
+
+/*
+==============
+S_PrecacheSoundLater
+
+Between S_BeginPrecaching and S_EndPrecaching loading is deferred so the
+whole precache list can be processed in parallel
+==============
+*/
+void S_PrecacheSoundLater (sfx_t *s)
+{
+	int i;
+
+	if (!sfx_precaching)
+	{
+		S_LoadSound (s);
+		return;
+	}
+	if (s->cache)
+		return;
+	for (i = 0; i < num_sfx_loads; i++)
+		if (sfx_loads[i].sfx == s)
+			return;
+	if (num_sfx_loads == max_sfx_loads)
+	{
+		max_sfx_loads = q_max (max_sfx_loads * 2, 256);
+		sfx_loads = (sfxload_t *)Mem_ReallocTagged (sfx_loads, max_sfx_loads * sizeof (sfxload_t), MEM_TAG_SOUND);
+	}
+	sfx_loads[num_sfx_loads++].sfx = s;
+}
+
+/*
+==============
+S_BeginPrecaching
+==============
+*/
+void S_BeginPrecaching (void)
+{
+	// anything left over from an aborted load is loaded on demand instead
+	num_sfx_loads = 0;
+	sfx_precaching = true;
+}
+
+/*
+==============
+S_EndPrecaching
+==============
+*/
+void S_EndPrecaching (void)
+{
+	S_FinishPrecaching ();
+	sfx_precaching = false;
+}
+
 /*
 ===============================================================================
 
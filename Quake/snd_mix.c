@@ -31,12 +31,281 @@ static short				*snd_out;
 
 static int snd_vol;
 
+// The paint kernels accumulate 8 stereo samples per iteration, the callers paint the rest.
+// AVX2 is compiled per function and only used if the CPU supports it
+#if defined(USE_SSE2)
+#include <immintrin.h>
+#if defined(__GNUC__)
+#define TARGET_AVX2 __attribute__ ((target ("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+
+/*
+==============
+SND_HasAVX2
+==============
+*/
+static qboolean SND_HasAVX2 (void)
+{
+	static int has_avx2 = -1;
+	if (has_avx2 < 0)
+		has_avx2 = SDL_HasAVX2 () ? 1 : 0;
+	return has_avx2;
+}
+
+/*
+==============
+SND_MulLo32
+
+SSE2 has no 32 bit multiply, build it from the even and odd 32x32->64 bit lanes
+==============
+*/
+static FORCE_INLINE __m128i SND_MulLo32 (__m128i a, __m128i b)
+{
+	const __m128i even = _mm_mul_epu32 (a, b);
+	const __m128i odd = _mm_mul_epu32 (_mm_srli_epi64 (a, 32), _mm_srli_epi64 (b, 32));
+	return _mm_unpacklo_epi32 (_mm_shuffle_epi32 (even, _MM_SHUFFLE (0, 0, 2, 0)), _mm_shuffle_epi32 (odd, _MM_SHUFFLE (0, 0, 2, 0)));
+}
+
+/*
+==============
+SND_Accumulate4SSE2
+
+Adds 4 mono samples scaled by the (left, right, left, right) volumes to 4 stereo pairs
+==============
+*/
+static FORCE_INLINE void SND_Accumulate4SSE2 (int *out, __m128i samples, __m128i vols)
+{
+	const __m128i lo = _mm_unpacklo_epi32 (samples, samples);
+	const __m128i hi = _mm_unpackhi_epi32 (samples, samples);
+	_mm_storeu_si128 ((__m128i *)out, _mm_add_epi32 (_mm_loadu_si128 ((__m128i *)out), SND_MulLo32 (lo, vols)));
+	_mm_storeu_si128 ((__m128i *)(out + 4), _mm_add_epi32 (_mm_loadu_si128 ((__m128i *)(out + 4)), SND_MulLo32 (hi, vols)));
+}
+
+/*
+==============
+SND_Accumulate8AVX2
+==============
+*/
+static FORCE_INLINE TARGET_AVX2 void SND_Accumulate8AVX2 (int *out, __m256i samples, __m256i vols)
+{
+	const __m256i lo = _mm256_permutevar8x32_epi32 (samples, _mm256_setr_epi32 (0, 0, 1, 1, 2, 2, 3, 3));
+	const __m256i hi = _mm256_permutevar8x32_epi32 (samples, _mm256_setr_epi32 (4, 4, 5, 5, 6, 6, 7, 7));
+	_mm256_storeu_si256 ((__m256i *)out, _mm256_add_epi32 (_mm256_loadu_si256 ((__m256i *)out), _mm256_mullo_epi32 (lo, vols)));
+	_mm256_storeu_si256 ((__m256i *)(out + 8), _mm256_add_epi32 (_mm256_loadu_si256 ((__m256i *)(out + 8)), _mm256_mullo_epi32 (hi, vols)));
+}
+
+/*
+==============
+SND_Paint8AVX2
+==============
+*/
+static TARGET_AVX2 int SND_Paint8AVX2 (int *out, const signed char *sfx, int count, int leftvol, int rightvol)
+{
+	const __m256i vols = _mm256_setr_epi32 (leftvol, rightvol, leftvol, rightvol, leftvol, rightvol, leftvol, rightvol);
+	int			  i;
+
+	for (i = 0; i + 8 <= count; i += 8)
+		SND_Accumulate8AVX2 (out + i * 2, _mm256_cvtepi8_epi32 (_mm_loadl_epi64 ((const __m128i *)(sfx + i))), vols);
+	return i;
+}
+
+/*
+==============
+SND_Paint16AVX2
+==============
+*/
+static TARGET_AVX2 int SND_Paint16AVX2 (int *out, const short *sfx, int count, int leftvol, int rightvol)
+{
+	const __m256i vols = _mm256_setr_epi32 (leftvol, rightvol, leftvol, rightvol, leftvol, rightvol, leftvol, rightvol);
+	int			  i;
+
+	for (i = 0; i + 8 <= count; i += 8)
+		SND_Accumulate8AVX2 (out + i * 2, _mm256_cvtepi16_epi32 (_mm_loadu_si128 ((const __m128i *)(sfx + i))), vols);
+	return i;
+}
+
+/*
+==============
+SND_Paint8SIMD
+
+Same results as the snd_scaletable lookups, the table entries are just sample * volume
+==============
+*/
+static int SND_Paint8SIMD (int *out, const signed char *sfx, int count, int leftvol, int rightvol)
+{
+	const __m128i vols = _mm_setr_epi32 (leftvol, rightvol, leftvol, rightvol);
+	int			  i;
+
+	if (SND_HasAVX2 ())
+		return SND_Paint8AVX2 (out, sfx, count, leftvol, rightvol);
+	for (i = 0; i + 8 <= count; i += 8)
+	{
+		const __m128i bytes = _mm_loadl_epi64 ((const __m128i *)(sfx + i));
+		const __m128i words = _mm_unpacklo_epi8 (bytes, bytes);
+		SND_Accumulate4SSE2 (out + i * 2, _mm_srai_epi32 (_mm_unpacklo_epi16 (words, words), 24), vols);
+		SND_Accumulate4SSE2 (out + i * 2 + 8, _mm_srai_epi32 (_mm_unpackhi_epi16 (words, words), 24), vols);
+	}
+	return i;
+}
+
+/*
+==============
+SND_Paint16SIMD
+==============
+*/
+static int SND_Paint16SIMD (int *out, const short *sfx, int count, int leftvol, int rightvol)
+{
+	const __m128i vols = _mm_setr_epi32 (leftvol, rightvol, leftvol, rightvol);
+	int			  i;
+
+	if (SND_HasAVX2 ())
+		return SND_Paint16AVX2 (out, sfx, count, leftvol, rightvol);
+	for (i = 0; i + 8 <= count; i += 8)
+	{
+		const __m128i words = _mm_loadu_si128 ((const __m128i *)(sfx + i));
+		SND_Accumulate4SSE2 (out + i * 2, _mm_srai_epi32 (_mm_unpacklo_epi16 (words, words), 16), vols);
+		SND_Accumulate4SSE2 (out + i * 2 + 8, _mm_srai_epi32 (_mm_unpackhi_epi16 (words, words), 16), vols);
+	}
+	return i;
+}
+
+/*
+==============
+SND_ClipHalf4
+
+CLAMP (-32768 * 256, x, 32767 * 256) / 2, rounding toward zero like the C division
+==============
+*/
+static FORCE_INLINE __m128i SND_ClipHalf4 (__m128i x)
+{
+	const __m128i lo = _mm_set1_epi32 (-32768 * 256);
+	const __m128i hi = _mm_set1_epi32 (32767 * 256);
+	__m128i		  mask = _mm_cmpgt_epi32 (x, hi);
+	x = _mm_or_si128 (_mm_and_si128 (mask, hi), _mm_andnot_si128 (mask, x));
+	mask = _mm_cmplt_epi32 (x, lo);
+	x = _mm_or_si128 (_mm_and_si128 (mask, lo), _mm_andnot_si128 (mask, x));
+	return _mm_srai_epi32 (_mm_add_epi32 (x, _mm_srli_epi32 (x, 31)), 1);
+}
+
+/*
+==============
+SND_ToShort8
+
+x / 256 clamped to a short for 8 values
+==============
+*/
+static FORCE_INLINE __m128i SND_ToShort8 (const int *p)
+{
+	__m128i a = _mm_loadu_si128 ((const __m128i *)p);
+	__m128i b = _mm_loadu_si128 ((const __m128i *)(p + 4));
+	a = _mm_srai_epi32 (_mm_add_epi32 (a, _mm_srli_epi32 (_mm_srai_epi32 (a, 31), 24)), 8);
+	b = _mm_srai_epi32 (_mm_add_epi32 (b, _mm_srli_epi32 (_mm_srai_epi32 (b, 31), 24)), 8);
+	return _mm_packs_epi32 (a, b);
+}
+#elif defined(USE_NEON)
+#include <arm_neon.h>
+
+/*
+==============
+SND_Accumulate4NEON
+
+Adds 4 mono samples scaled by the (left, right, left, right) volumes to 4 stereo pairs
+==============
+*/
+static FORCE_INLINE void SND_Accumulate4NEON (int *out, int32x4_t samples, int32x4_t vols)
+{
+	const int32x4x2_t pairs = vzipq_s32 (samples, samples);
+	vst1q_s32 (out, vmlaq_s32 (vld1q_s32 (out), pairs.val[0], vols));
+	vst1q_s32 (out + 4, vmlaq_s32 (vld1q_s32 (out + 4), pairs.val[1], vols));
+}
+
+/*
+==============
+SND_Paint8SIMD
+
+Same results as the snd_scaletable lookups, the table entries are just sample * volume
+==============
+*/
+static int SND_Paint8SIMD (int *out, const signed char *sfx, int count, int leftvol, int rightvol)
+{
+	const int32_t	vols_array[4] = {leftvol, rightvol, leftvol, rightvol};
+	const int32x4_t vols = vld1q_s32 (vols_array);
+	int				i;
+
+	for (i = 0; i + 8 <= count; i += 8)
+	{
+		const int16x8_t words = vmovl_s8 (vld1_s8 (sfx + i));
+		SND_Accumulate4NEON (out + i * 2, vmovl_s16 (vget_low_s16 (words)), vols);
+		SND_Accumulate4NEON (out + i * 2 + 8, vmovl_s16 (vget_high_s16 (words)), vols);
+	}
+	return i;
+}
+
+/*
+==============
+SND_Paint16SIMD
+==============
+*/
+static int SND_Paint16SIMD (int *out, const short *sfx, int count, int leftvol, int rightvol)
+{
+	const int32_t	vols_array[4] = {leftvol, rightvol, leftvol, rightvol};
+	const int32x4_t vols = vld1q_s32 (vols_array);
+	int				i;
+
+	for (i = 0; i + 8 <= count; i += 8)
+	{
+		const int16x8_t words = vld1q_s16 (sfx + i);
+		SND_Accumulate4NEON (out + i * 2, vmovl_s16 (vget_low_s16 (words)), vols);
+		SND_Accumulate4NEON (out + i * 2 + 8, vmovl_s16 (vget_high_s16 (words)), vols);
+	}
+	return i;
+}
+
+/*
+==============
+SND_ClipHalf4
+
+CLAMP (-32768 * 256, x, 32767 * 256) / 2, rounding toward zero like the C division
+==============
+*/
+static FORCE_INLINE int32x4_t SND_ClipHalf4 (int32x4_t x)
+{
+	x = vminq_s32 (vmaxq_s32 (x, vdupq_n_s32 (-32768 * 256)), vdupq_n_s32 (32767 * 256));
+	return vshrq_n_s32 (vaddq_s32 (x, vreinterpretq_s32_u32 (vshrq_n_u32 (vreinterpretq_u32_s32 (x), 31))), 1);
+}
+
+/*
+==============
+SND_ToShort8
+
+x / 256 clamped to a short for 8 values
+==============
+*/
+static FORCE_INLINE int16x8_t SND_ToShort8 (const int *p)
+{
+	int32x4_t a = vld1q_s32 (p);
+	int32x4_t b = vld1q_s32 (p + 4);
+	a = vaddq_s32 (a, vreinterpretq_s32_u32 (vshrq_n_u32 (vreinterpretq_u32_s32 (vshrq_n_s32 (a, 31)), 24)));
+	b = vaddq_s32 (b, vreinterpretq_s32_u32 (vshrq_n_u32 (vreinterpretq_u32_s32 (vshrq_n_s32 (b, 31)), 24)));
+	return vcombine_s16 (vqshrn_n_s32 (a, 8), vqshrn_n_s32 (b, 8));
+}
+#endif
+
 static void Snd_WriteLinearBlastStereo16 (void)
 {
-	int i;
+	int i = 0;
 	int val;
 
-	for (i = 0; i < snd_linear_count; i += 2)
+#if defined(USE_SSE2)
+	for (; i + 8 <= snd_linear_count; i += 8)
+		_mm_storeu_si128 ((__m128i *)(snd_out + i), SND_ToShort8 (snd_p + i));
+#elif defined(USE_NEON)
+	for (; i + 8 <= snd_linear_count; i += 8)
+		vst1q_s16 (snd_out + i, SND_ToShort8 (snd_p + i));
+#endif
+	for (; i < snd_linear_count; i += 2)
 	{
 		val = snd_p[i] / 256;
 		if (val > SHRT_MAX)
@@ -196,7 +465,7 @@ static void S_MakeBlackmanWindowKernel (float *kernel, int M, float f_c)
 typedef struct
 {
 	float *memory;	   // kernelsize floats
-	float *kernel;	   // kernelsize floats
+	float *kernel;	   // kernelsize floats, stored as 4 phases of kernelsize/4 taps
 	int	   kernelsize; // M+1, rounded up to be a multiple of 16
 	int	   M;		   // M value used to make kernel, even
 	int	   parity;	   // 0-3
@@ -205,6 +474,8 @@ typedef struct
 
 static void S_UpdateFilter (filter_t *filter, int M, float f_c)
 {
+	int i;
+
 	if (filter->f_c != f_c || filter->M != M)
 	{
 		if (filter->memory != NULL)
@@ -221,8 +492,52 @@ static void S_UpdateFilter (filter_t *filter, int M, float f_c)
 		filter->memory = (float *)Mem_Alloc (filter->kernelsize * sizeof (float));
 		filter->kernel = (float *)Mem_Alloc (filter->kernelsize * sizeof (float));
 
-		S_MakeBlackmanWindowKernel (filter->kernel, M, f_c);
+		// S_ApplyFilter only uses every 4th tap, so each phase is made contiguous
+		TEMP_ALLOC_ZEROED (float, kernel, filter->kernelsize);
+		S_MakeBlackmanWindowKernel (kernel, M, f_c);
+		for (i = 0; i < filter->kernelsize; i++)
+			filter->kernel[(i % 4) * (filter->kernelsize / 4) + i / 4] = kernel[i];
+		TEMP_FREE (kernel);
+	}
+}
+
+/*
+==============
+S_FilterDot
+
+Dot product of one kernel phase with the decimated input, n is a multiple of 4.
+The 4 partial sums are accumulated in the same order in every path
+==============
+*/
+static FORCE_INLINE float S_FilterDot (const float *kernel, const float *input, int n)
+{
+	int i;
+#if defined(USE_SSE2)
+	__m128 sum = _mm_setzero_ps ();
+	float  val[4];
+
+	for (i = 0; i < n; i += 4)
+		sum = _mm_add_ps (sum, _mm_mul_ps (_mm_loadu_ps (kernel + i), _mm_loadu_ps (input + i)));
+	_mm_storeu_ps (val, sum);
+#elif defined(USE_NEON)
+	float32x4_t sum = vdupq_n_f32 (0.0f);
+	float		val[4];
+
+	for (i = 0; i < n; i += 4)
+		sum = vaddq_f32 (sum, vmulq_f32 (vld1q_f32 (kernel + i), vld1q_f32 (input + i)));
+	vst1q_f32 (val, sum);
+#else
+	float val[4] = {0, 0, 0, 0};
+
+	for (i = 0; i < n; i += 4)
+	{
+		val[0] += kernel[i] * input[i];
+		val[1] += kernel[i + 1] * input[i + 1];
+		val[2] += kernel[i + 2] * input[i + 2];
+		val[3] += kernel[i + 3] * input[i + 3];
 	}
+#endif
+	return val[0] + val[1] + val[2] + val[3];
 }
 
 /*
@@ -235,16 +550,21 @@ As an optimization, it decimates the audio to 11025Hz (setting every sample
 position that's not a multiple of 4 to 0), then convoluting with the filter
 kernel is 4x faster, because we can skip 3/4 of the input samples that are
 known to be 0 and skip 3/4 of the filter kernel.
+
+The samples that are kept are gathered into a dense array, so together with
+the per phase kernel layout each output is a contiguous dot product.
 ==============
 */
 static void S_ApplyFilter (filter_t *filter, int *data, int stride, int count)
 {
-	int			 i, j;
+	int			 i;
 	const int	 kernelsize = filter->kernelsize;
+	const int	 taps = kernelsize / 4;
 	const float *kernel = filter->kernel;
-	int			 parity;
+	int			 parity, phase, offset;
 
 	TEMP_ALLOC (float, input, filter->kernelsize + count);
+	TEMP_ALLOC (float, decimated, (filter->kernelsize + count) / 4 + 1);
 
 	// set up the input buffer
 	// memory holds the previous filter->kernelsize samples of input.
@@ -258,31 +578,28 @@ static void S_ApplyFilter (filter_t *filter, int *data, int stride, int count)
 	// copy out the last filter->kernelsize samples to 'memory' for next time
 	memcpy (filter->memory, input + count, filter->kernelsize * sizeof (float));
 
-	// apply the filter
+	// every input sample that is used has the same position modulo 4
 	parity = filter->parity;
+	offset = (4 - parity) % 4;
+	for (i = 0; offset + i * 4 < kernelsize + count; i++)
+		decimated[i] = input[offset + i * 4];
 
+	// apply the filter
 	for (i = 0; i < count; i++)
 	{
-		const float *input_plus_i = input + i;
-		float		 val[4] = {0, 0, 0, 0};
-
-		for (j = (4 - parity) % 4; j < kernelsize; j += 16)
-		{
-			val[0] += kernel[j] * input_plus_i[j];
-			val[1] += kernel[j + 4] * input_plus_i[j + 4];
-			val[2] += kernel[j + 8] * input_plus_i[j + 8];
-			val[3] += kernel[j + 12] * input_plus_i[j + 12];
-		}
+		// taps phase, phase + 4, ... of the kernel are applied to input[i + phase], input[i + phase + 4], ...
+		phase = (4 - parity) % 4;
 
 		// 4.0 factor is to increase volume by 12 dB; this is to make up the
 		// volume drop caused by the zero-filling this filter does.
-		data[i * stride] = (val[0] + val[1] + val[2] + val[3]) * (32768.0 * 256.0 * 4.0);
+		data[i * stride] = S_FilterDot (kernel + phase * taps, decimated + (i + phase - offset) / 4, taps) * (32768.0 * 256.0 * 4.0);
 
 		parity = (parity + 1) % 4;
 	}
 
 	filter->parity = parity;
 
+	TEMP_FREE (decimated);
 	TEMP_FREE (input);
 }
 
@@ -404,6 +721,7 @@ void S_PaintChannels (int endtime)
 	int			end, ltime, count;
 	channel_t  *ch;
 	sfxcache_t *sc;
+	uint64_t	filterstart;
 	qboolean	pause_loops = snd_pauselooping.value && (cl.paused || (sv.active && svs.maxclients == 1 && key_dest != key_game));
 
 	snd_vol = sfxvolume.value * 256;
@@ -424,8 +742,6 @@ void S_PaintChannels (int endtime)
 		{
 			if (!ch->sfx)
 				continue;
-			if (!ch->leftvol && !ch->rightvol)
-				continue;
 			sc = S_LoadSound (ch->sfx);
 			if (!sc)
 				continue;
@@ -441,7 +757,13 @@ void S_PaintChannels (int endtime)
 				else
 					count = end - ltime;
 
-				if (count > 0)
+				if (count > 0 && !ch->leftvol && !ch->rightvol)
+				{
+					// silent or culled by SND_CullVoices, only keep its position
+					ch->pos += count;
+					ltime += count;
+				}
+				else if (count > 0)
 				{
 					// the last param to SND_PaintChannelFrom is the index
 					// to start painting to in the paintbuffer, usually 0.
@@ -473,13 +795,22 @@ void S_PaintChannels (int endtime)
 		// clip each sample to 0dB, then reduce by 6dB (to leave some headroom for
 		// the lowpass filter and the music). the lowpass will smooth out the
 		// clipping
-		for (i = 0; i < end - paintedtime; i++)
+		i = 0;
+#if defined(USE_SSE2)
+		for (; i + 2 <= end - paintedtime; i += 2)
+			_mm_storeu_si128 ((__m128i *)&paintbuffer[i], SND_ClipHalf4 (_mm_loadu_si128 ((__m128i *)&paintbuffer[i])));
+#elif defined(USE_NEON)
+		for (; i + 2 <= end - paintedtime; i += 2)
+			vst1q_s32 ((int *)&paintbuffer[i], SND_ClipHalf4 (vld1q_s32 ((int *)&paintbuffer[i])));
+#endif
+		for (; i < end - paintedtime; i++)
 		{
 			paintbuffer[i].left = CLAMP (-32768 * 256, paintbuffer[i].left, 32767 * 256) / 2;
 			paintbuffer[i].right = CLAMP (-32768 * 256, paintbuffer[i].right, 32767 * 256) / 2;
 		}
 
 		// apply a lowpass filter
+		filterstart = SDL_GetPerformanceCounter ();
 		if (sndspeed.value == 11025 && shm->speed == 44100)
 		{
 			static filter_t memory_l, memory_r;
@@ -488,6 +819,7 @@ void S_PaintChannels (int endtime)
 		}
 
 		S_UnderwaterFilter (end - paintedtime);
+		snd_filterticks += SDL_GetPerformanceCounter () - filterstart;
 
 		// paint in the music
 		if (s_rawend >= paintedtime)
@@ -543,7 +875,7 @@ static void SND_PaintChannelFrom8 (channel_t *ch, sfxcache_t *sc, int count, int
 	int			   data;
 	int			  *lscale, *rscale;
 	unsigned char *sfx;
-	int			   i;
+	int			   i = 0;
 
 	if (ch->leftvol > 255)
 		ch->leftvol = 255;
@@ -554,7 +886,10 @@ static void SND_PaintChannelFrom8 (channel_t *ch, sfxcache_t *sc, int count, int
 	rscale = snd_scaletable[ch->rightvol >> 3];
 	sfx = (unsigned char *)sc->data + ch->pos;
 
-	for (i = 0; i < count; i++)
+#if defined(USE_SIMD)
+	i = SND_Paint8SIMD ((int *)&paintbuffer[paintbufferstart], (const signed char *)sfx, count, lscale[1], rscale[1]);
+#endif
+	for (; i < count; i++)
 	{
 		data = sfx[i];
 		paintbuffer[paintbufferstart + i].left += lscale[data];
@@ -570,7 +905,7 @@ static void SND_PaintChannelFrom16 (channel_t *ch, sfxcache_t *sc, int count, in
 	int			  left, right;
 	int			  leftvol, rightvol;
 	signed short *sfx;
-	int			  i;
+	int			  i = 0;
 
 	leftvol = ch->leftvol * snd_vol;
 	rightvol = ch->rightvol * snd_vol;
@@ -578,7 +913,10 @@ static void SND_PaintChannelFrom16 (channel_t *ch, sfxcache_t *sc, int count, in
 	rightvol /= 256;
 	sfx = (signed short *)sc->data + ch->pos;
 
-	for (i = 0; i < count; i++)
+#if defined(USE_SIMD)
+	i = SND_Paint16SIMD ((int *)&paintbuffer[paintbufferstart], sfx, count, leftvol, rightvol);
+#endif
+	for (; i < count; i++)
 	{
 		data = sfx[i];
 		// this was causing integer overflow as observed in quakespasm
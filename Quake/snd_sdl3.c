@@ -35,6 +35,9 @@ static void SDLCALL paint_audio (void *userdata, SDL_AudioStream *stream, int ad
 	if (!shm || additional_amount <= 0)
 		return;
 
+	if (shm->ondemand)
+		S_PaintOnDemand (additional_amount / (shm->samplebits / 8) / shm->channels);
+
 	pos = (shm->samplepos * (shm->samplebits / 8));
 	if (pos >= buffersize)
 		shm->samplepos = pos = 0;
@@ -81,6 +84,17 @@ qboolean SNDDMA_Init (dma_t *dma)
 	spec.format = (loadas8bit.value) ? SDL_AUDIO_U8 : SDL_AUDIO_S16;
 	spec.channels = 2;
 
+	/* snd_lowlatency asks for about 5 ms device buffers and mixes on demand
+	 * in the callback, so nothing is queued in the DMA buffer */
+	if (snd_lowlatency.value)
+	{
+		char frames[16];
+		q_snprintf (frames, sizeof (frames), "%d", (int)q_max (spec.freq / 200, 64));
+		SDL_SetHint (SDL_HINT_AUDIO_DEVICE_SAMPLE_FRAMES, frames);
+	}
+	else
+		SDL_ResetHint (SDL_HINT_AUDIO_DEVICE_SAMPLE_FRAMES);
+
 	/* Open the audio device with callback */
 	audio_stream = SDL_OpenAudioDeviceStream (SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &spec, paint_audio, NULL);
 	if (!audio_stream)
@@ -100,6 +114,7 @@ qboolean SNDDMA_Init (dma_t *dma)
 	shm->signed8 = (spec.format == SDL_AUDIO_S8);
 	shm->speed = spec.freq;
 	shm->channels = spec.channels;
+	shm->ondemand = (snd_lowlatency.value != 0);
 
 	/* Calculate buffer size - aim for ~100ms of audio */
 	int num_samples = (spec.channels * spec.freq) / 10;
@@ -159,14 +174,16 @@ void SNDDMA_Shutdown (void)
 
 void SNDDMA_LockBuffer (void)
 {
-	if (audio_stream)
+	/* on demand the buffer is only touched under snd_mutex, locking the
+	 * stream too would invert the lock order of the callback */
+	if (audio_stream && !shm->ondemand)
 		SDL_LockAudioStream (audio_stream);
 }
 
 void SNDDMA_Submit (void)
 {
 	/* In callback model, unlock is all we need to do */
-	if (audio_stream)
+	if (audio_stream && !shm->ondemand)
 		SDL_UnlockAudioStream (audio_stream);
 }
 
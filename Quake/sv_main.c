@@ -23,6 +23,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 // sv_main.c -- server main program
 
 #include "quakedef.h"
+#include "miniz.h"
 
 server_t		sv;
 server_static_t svs;
@@ -36,8 +37,11 @@ unsigned int sv_protocol_pext2 = PEXT2_SUPPORTED_SERVER; // spike
 
 static cvar_t sv_netsort = {"sv_netsort", "1", CVAR_NONE};
 static cvar_t sv_smoothplatformlerps = {"sv_smoothplatformlerps", "1", CVAR_NONE};
+static cvar_t sv_parallelsnapshots = {"sv_parallelsnapshots", "1", CVAR_NONE};
+static cvar_t sv_snapshotbudget = {"sv_snapshotbudget", "0", CVAR_NONE}; // bytes of entity updates per client per frame, 0 to send everything
 
 extern cvar_t nomonsters;
+extern cvar_t sv_areanodes_balanced;
 
 /*
 =============
@@ -248,9 +252,11 @@ static unsigned int MSGFTE_DeltaCalcBits (entity_state_t *from, entity_state_t *
 	return bits;
 }
 
-static void MSGFTE_WriteEntityUpdate (unsigned int bits, entity_state_t *state, sizebuf_t *msg, unsigned int pext2, unsigned int protocolflags)
+static void MSGFTE_WriteEntityUpdate (
+	unsigned int bits, entity_state_t *state, const entity_state_t *baseline, sizebuf_t *msg, unsigned int pext2, unsigned int protocolflags)
 {
-	unsigned int predbits = 0;
+	unsigned int   predbits = 0;
+	const qboolean varint = (pext2 & PEXT2_VARINTDELTAS) != 0;
 	if (bits & UF_MOVETYPE)
 	{
 		bits &= ~UF_MOVETYPE;
@@ -287,13 +293,23 @@ static void MSGFTE_WriteEntityUpdate (unsigned int bits, entity_state_t *state,
 	bits &= ~UF_BONEDATA;
 
 	/*check if we need more precision for some things*/
-	if ((bits & UF_MODEL) && state->modelindex > 255)
-		bits |= UF_16BIT;
-	if ((bits & UF_FRAME) && state->frame > 255)
-		bits |= UF_16BIT;
+	if (varint)
+		bits &= ~UF_16BIT; /*frame and model are varints, skin always fits a byte*/
+	else
+	{
+		if ((bits & UF_MODEL) && state->modelindex > 255)
+			bits |= UF_16BIT;
+		if ((bits & UF_FRAME) && state->frame > 255)
+			bits |= UF_16BIT;
+	}
 
 	/*convert effects bits to higher lengths if needed*/
-	if (bits & UF_EFFECTS)
+	if (varint)
+	{
+		if (bits & (UF_EFFECTS | UF_EFFECTS2))
+			bits = (bits & ~UF_EFFECTS2) | UF_EFFECTS;
+	}
+	else if (bits & UF_EFFECTS)
 	{
 		if (state->effects & 0xffff0000) /*both*/
 			bits |= UF_EFFECTS | UF_EFFECTS2;
@@ -317,18 +333,33 @@ static void MSGFTE_WriteEntityUpdate (unsigned int bits, entity_state_t *state,
 
 	if (bits & UF_FRAME)
 	{
-		if (bits & UF_16BIT)
+		if (varint)
+			MSG_WriteUInt64 (msg, state->frame);
+		else if (bits & UF_16BIT)
 			MSG_WriteShort (msg, state->frame);
 		else
 			MSG_WriteByte (msg, state->frame);
 	}
-	if (bits & UF_ORIGINXY)
+	if (varint)
 	{
-		MSG_WriteCoord (msg, state->origin[0], protocolflags);
-		MSG_WriteCoord (msg, state->origin[1], protocolflags);
+		if (bits & UF_ORIGINXY)
+		{
+			MSG_WriteCoordDelta (msg, state->origin[0], baseline->origin[0], protocolflags);
+			MSG_WriteCoordDelta (msg, state->origin[1], baseline->origin[1], protocolflags);
+		}
+		if (bits & UF_ORIGINZ)
+			MSG_WriteCoordDelta (msg, state->origin[2], baseline->origin[2], protocolflags);
+	}
+	else
+	{
+		if (bits & UF_ORIGINXY)
+		{
+			MSG_WriteCoord (msg, state->origin[0], protocolflags);
+			MSG_WriteCoord (msg, state->origin[1], protocolflags);
+		}
+		if (bits & UF_ORIGINZ)
+			MSG_WriteCoord (msg, state->origin[2], protocolflags);
 	}
-	if (bits & UF_ORIGINZ)
-		MSG_WriteCoord (msg, state->origin[2], protocolflags);
 
 	if ((bits & UF_PREDINFO) && !(pext2 & PEXT2_PREDINFO))
 	{ /*if we have pred info, (always) use more precise angles*/
@@ -351,7 +382,12 @@ static void MSGFTE_WriteEntityUpdate (unsigned int bits, entity_state_t *state,
 			MSG_WriteAngle (msg, state->angles[1], protocolflags);
 	}
 
-	if ((bits & (UF_EFFECTS | UF_EFFECTS2)) == (UF_EFFECTS | UF_EFFECTS2))
+	if (varint)
+	{
+		if (bits & UF_EFFECTS)
+			MSG_WriteUInt64 (msg, state->effects);
+	}
+	else if ((bits & (UF_EFFECTS | UF_EFFECTS2)) == (UF_EFFECTS | UF_EFFECTS2))
 		MSG_WriteLong (msg, state->effects);
 	else if (bits & UF_EFFECTS2)
 		MSG_WriteShort (msg, state->effects);
@@ -377,7 +413,9 @@ static void MSGFTE_WriteEntityUpdate (unsigned int bits, entity_state_t *state,
 
 	if (bits & UF_MODEL)
 	{
-		if (bits & UF_16BIT)
+		if (varint)
+			MSG_WriteUInt64 (msg, state->modelindex);
+		else if (bits & UF_16BIT)
 			MSG_WriteShort (msg, state->modelindex);
 		else
 			MSG_WriteByte (msg, state->modelindex);
@@ -429,10 +467,6 @@ static void MSGFTE_WriteEntityUpdate (unsigned int bits, entity_state_t *state,
 #endif
 }
 
-static struct entity_num_state_s *snapshot_entstate;
-static size_t					  snapshot_numents;
-static size_t					  snapshot_maxents;
-
 void SVFTE_DestroyFrames (client_t *client)
 {
 	int i;
@@ -448,10 +482,18 @@ void SVFTE_DestroyFrames (client_t *client)
 	client->previousentities = NULL;
 	client->numpreviousentities = 0;
 	client->maxpreviousentities = 0;
+	Mem_Free (client->snapshotentities);
+	client->snapshotentities = NULL;
+	client->numsnapshotentities = 0;
+	client->maxsnapshotentities = 0;
+	Mem_Free (client->snapshotpvs);
+	client->snapshotpvs = NULL;
+	client->snapshotpvssize = 0;
 
 	if (client->pendingentities_bits)
 		Mem_Free (client->pendingentities_bits);
 	client->pendingentities_bits = NULL;
+	SAFE_FREE (client->pendingentities_senttime);
 	client->numpendingentities = 0;
 
 	while (client->numframes > 0)
@@ -490,6 +532,7 @@ static void SVFTE_SetupFrames (client_t *client)
 
 	client->numpendingentities = qcvm->num_edicts;
 	client->pendingentities_bits = Mem_Alloc (client->numpendingentities * sizeof (*client->pendingentities_bits));
+	client->pendingentities_senttime = Mem_Alloc (client->numpendingentities * sizeof (*client->pendingentities_senttime));
 
 	client->pendingentities_bits[0] = UF_REMOVE;
 }
@@ -537,7 +580,7 @@ void SVFTE_Ack (client_t *client, int sequence)
 	if (frame->sequence >= 0)
 	{
 		frame->sequence = -1;
-		host_client->ping_times[host_client->num_pings % NUM_PING_TIMES] = qcvm->time - frame->timestamp;
+		host_client->ping_times[host_client->num_pings % NUM_PING_TIMES] = qcvm->time - frame->timestamp - NET_PacketAge ();
 		host_client->num_pings++;
 	}
 }
@@ -648,6 +691,8 @@ static void SVFTE_CalcEntityDeltas (client_t *client)
 		int newmax = qcvm->num_edicts + 64;
 		client->pendingentities_bits = Mem_Realloc (client->pendingentities_bits, sizeof (*client->pendingentities_bits) * newmax);
 		memset (client->pendingentities_bits + client->numpendingentities, 0, sizeof (*client->pendingentities_bits) * (newmax - client->numpendingentities));
+		client->pendingentities_senttime = Mem_Realloc (client->pendingentities_senttime, sizeof (float) * newmax);
+		memset (client->pendingentities_senttime + client->numpendingentities, 0, sizeof (float) * (newmax - client->numpendingentities));
 		client->numpendingentities = newmax;
 	}
 
@@ -658,8 +703,8 @@ static void SVFTE_CalcEntityDeltas (client_t *client)
 		client->pendingentities_bits[0] = UF_REMOVE;
 	}
 
-	news = snapshot_entstate;
-	newstop = news + snapshot_numents;
+	news = client->snapshotentities;
+	newstop = news + client->numsnapshotentities;
 	olds = client->previousentities;
 	oldstop = (olds != NULL) ? (olds + client->numpreviousentities) : NULL;
 
@@ -699,19 +744,114 @@ static void SVFTE_CalcEntityDeltas (client_t *client)
 	olds = client->previousentities;
 	oldstop = (olds != NULL) ? (olds + client->maxpreviousentities) : NULL;
 
-	client->previousentities = snapshot_entstate;
-	client->numpreviousentities = snapshot_numents;
-	client->maxpreviousentities = snapshot_maxents;
+	client->previousentities = client->snapshotentities;
+	client->numpreviousentities = client->numsnapshotentities;
+	client->maxpreviousentities = client->maxsnapshotentities;
+
+	client->snapshotentities = olds;
+	client->numsnapshotentities = 0;
+	client->maxsnapshotentities = (olds != NULL) ? (oldstop - olds) : 0;
+}
+typedef struct
+{
+	unsigned int num;
+	float		 priority;
+} entity_priority_t;
+
+static int SVFTE_ComparePriority (const void *a, const void *b)
+{
+	const float pa = ((const entity_priority_t *)a)->priority;
+	const float pb = ((const entity_priority_t *)b)->priority;
+	return (pa < pb) - (pa > pb);
+}
+
+/*
+=============
+SVFTE_EntityPriority
+
+Players, nearby entities, entities in front of the view and entities that
+have waited longest for an update go first
+=============
+*/
+static float SVFTE_EntityPriority (client_t *client, unsigned int entnum, const vec3_t vieworg, const vec3_t forward)
+{
+	const unsigned int entbits = client->pendingentities_bits[entnum];
+	if (entnum == 0)
+		return FLT_MAX; // a full reset has to come before everything it resets
+	if (entbits & UF_REMOVE)
+		return FLT_MAX / 2; // tiny, and must not linger
+
+	edict_t	   *ent = EDICT_NUM (entnum);
+	const float importance = (entnum <= (unsigned int)svs.maxclients) ? 4.0f : 1.0f;
+	const float age = qcvm->time - client->pendingentities_senttime[entnum];
+	vec3_t		delta;
+	for (int i = 0; i < 3; ++i)
+		delta[i] = (ent->v.absmin[i] + ent->v.absmax[i]) * 0.5f - vieworg[i];
+	const float dist = VectorLength (delta);
+	const float facing = (dist > 0.0f) ? (DotProduct (delta, forward) / dist) : 1.0f;
+	return importance * (1.5f + facing) * (age + 0.05f) / (1.0f + dist / 256.0f);
+}
+
+/*
+=============
+SVFTE_OrderPendingEntities
+
+Collects the entities with pending updates. Without a budget everything is
+written this frame anyway, so they stay in ascending order.
+=============
+*/
+static void SVFTE_OrderPendingEntities (client_t *client)
+{
+	const unsigned int budget = q_max (sv_snapshotbudget.value, 0.0f);
+	unsigned int	   entnum, i;
+
+	client->snapshotorder = (unsigned int *)Mem_FrameAlloc (q_max (client->numpendingentities, 1) * sizeof (unsigned int));
+	client->numsnapshotorder = 0;
+	client->snapshotbytes = 0;
+	for (entnum = 0; entnum < client->numpendingentities; entnum++)
+		if (client->pendingentities_bits[entnum] & ~UF_RESET2)
+			client->snapshotorder[client->numsnapshotorder++] = entnum;
+
+	if (!budget || (client->numsnapshotorder < 2))
+		return;
+
+	vec3_t vieworg, forward, right, up;
+	VectorAdd (client->edict->v.origin, client->edict->v.view_ofs, vieworg);
+	AngleVectors (client->edict->v.v_angle, forward, right, up);
 
-	snapshot_entstate = olds;
-	snapshot_numents = 0;
-	snapshot_maxents = (olds != NULL) ? (oldstop - olds) : 0;
+	entity_priority_t *priorities = (entity_priority_t *)Mem_FrameAlloc (client->numsnapshotorder * sizeof (entity_priority_t));
+	for (i = 0; i < client->numsnapshotorder; i++)
+	{
+		priorities[i].num = client->snapshotorder[i];
+		priorities[i].priority = SVFTE_EntityPriority (client, client->snapshotorder[i], vieworg, forward);
+	}
+	qsort (priorities, client->numsnapshotorder, sizeof (entity_priority_t), SVFTE_ComparePriority);
+	for (i = 0; i < client->numsnapshotorder; i++)
+		client->snapshotorder[i] = priorities[i].num;
 }
+
+static struct entity_num_state_s *SVFTE_FindPreviousState (client_t *client, unsigned int entnum)
+{
+	size_t lo = 0, hi = client->numpreviousentities;
+	while (lo < hi)
+	{
+		const size_t mid = (lo + hi) / 2;
+		if (client->previousentities[mid].num < entnum)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (lo < client->numpreviousentities && client->previousentities[lo].num == entnum)
+		return &client->previousentities[lo];
+	return NULL;
+}
+
 static void SVFTE_WriteEntitiesToClient (client_t *client, sizebuf_t *msg, size_t overflowsize)
 {
-	struct entity_num_state_s *state, *stateend;
+	struct entity_num_state_s *state;
 	unsigned int			   entbits, logbits, netbits;
-	size_t					   entnum;
+	unsigned int			   entnum, i;
+	const unsigned int		   budget = q_max (sv_snapshotbudget.value, 0.0f);
 	int						   sequence = NET_QSocketGetSequenceOut (client->netconnection);
 	size_t					   origmaxsize = msg->maxsize;
 	size_t					   rollbacksize; // I'm too lazy to figure out sizes (especially if someone updates this for bone states or whatever)
@@ -721,8 +861,8 @@ static void SVFTE_WriteEntitiesToClient (client_t *client, sizebuf_t *msg, size_
 
 	msg->maxsize = overflowsize;
 
-	state = client->previousentities;
-	stateend = state + client->numpreviousentities;
+	if (client->snapshotresume == 0)
+		SVFTE_OrderPendingEntities (client);
 
 	MSG_WriteByte (msg, svcfte_updateentities);
 
@@ -730,11 +870,18 @@ static void SVFTE_WriteEntitiesToClient (client_t *client, sizebuf_t *msg, size_
 	if (client->protocol_pext2 & PEXT2_PREDINFO)
 		MSG_WriteShort (msg, (client->lastmovemessage & 0xffff));
 	MSG_WriteFloat (msg, frame->timestamp); // should be the time the last physics frame was run.
-	for (entnum = client->snapshotresume; entnum < client->numpendingentities; entnum++)
+	for (i = client->snapshotresume; i < client->numsnapshotorder; i++)
 	{
+		entnum = client->snapshotorder[i];
 		entbits = client->pendingentities_bits[entnum];
 		if (!(entbits & ~UF_RESET2))
 			continue; // nothing to send (if reset2 is still set, then leave it pending until there's more data
+		if (budget && (client->snapshotbytes >= budget))
+		{
+			// out of budget, the rest stay pending and gain priority as they age
+			i = client->numsnapshotorder;
+			break;
+		}
 
 		rollbacksize = msg->cursize;
 		client->pendingentities_bits[entnum] = 0;
@@ -752,9 +899,8 @@ static void SVFTE_WriteEntitiesToClient (client_t *client, sizebuf_t *msg, size_
 		}
 		else
 		{
-			while (state < stateend && state->num < entnum)
-				state++;
-			if (state < stateend && state->num == entnum)
+			state = SVFTE_FindPreviousState (client, entnum);
+			if (state)
 			{
 				if (entbits & UF_RESET2)
 				{
@@ -783,7 +929,7 @@ static void SVFTE_WriteEntitiesToClient (client_t *client, sizebuf_t *msg, size_
 				else
 					MSG_WriteShort (msg, entnum);
 				//				SV_EmitDeltaEntIndex(msg, j, false, true);
-				MSGFTE_WriteEntityUpdate (netbits, &state->state, msg, client->protocol_pext2, sv.protocolflags);
+				MSGFTE_WriteEntityUpdate (netbits, &state->state, &EDICT_NUM (entnum)->baseline, msg, client->protocol_pext2, sv.protocolflags);
 			}
 		}
 
@@ -802,12 +948,14 @@ static void SVFTE_WriteEntitiesToClient (client_t *client, sizebuf_t *msg, size_
 		frame->ents[frame->numents].ebits = logbits;
 		frame->ents[frame->numents].csqcbits = 0;
 		frame->numents++;
+		client->pendingentities_senttime[entnum] = qcvm->time;
+		client->snapshotbytes += msg->cursize - rollbacksize;
 	}
 	msg->maxsize = origmaxsize;
 	MSG_WriteShort (msg, 0); // eom
 
 	// remember how far we got, so we can keep things flushed, instead of only updating the first N entities.
-	client->snapshotresume = entnum;
+	client->snapshotresume = i;
 
 	if (msg->cursize > 1024 && dev_peakstats.packetsize <= 1024)
 		Con_DWarning ("%i byte packet exceeds standard limit of 1024.\n", msg->cursize);
@@ -873,26 +1021,57 @@ void SV_BuildEntityState (edict_t *ent, entity_state_t *state)
 #endif
 }
 
-byte	   *SV_FatPVS (vec3_t org, qmodel_t *worldmodel);
-static void SVFTE_BuildSnapshotForClient (client_t *client)
+/*
+=============
+SV_HasModelName
+
+Same as PR_GetString (ent->v.model)[0], but treats a bad string as empty rather than raising
+a Host_Error, as snapshots can be built on the task workers
+=============
+*/
+static qboolean SV_HasModelName (edict_t *ent)
+{
+	const int num = ent->v.model;
+	if (num >= 0 && num < qcvm->stringssize)
+		return qcvm->strings[num] != 0;
+	else if (num < 0 && num >= -qcvm->numknownstrings)
+		return qcvm->knownstrings[-1 - num] && qcvm->knownstrings[-1 - num][0];
+	return qcvm->strings[0] != 0;
+}
+
+// states of all the edicts for the current frame, shared by the client snapshots when there are several of them
+static entity_state_t *frame_entstates;
+static int			   frame_maxentstates;
+
+/*
+=============
+SV_BuildFrameEntityStates
+=============
+*/
+static void SV_BuildFrameEntityStates (int begin, int end, void *unused)
+{
+	int		 i;
+	edict_t *ent;
+
+	for (i = begin, ent = EDICT_NUM (begin); i < end; i++, ent = NEXT_EDICT (ent))
+		if (!ent->free)
+			SV_BuildEntityState (ent, &frame_entstates[i]);
+}
+
+static void SVFTE_BuildSnapshotForClient (client_t *client, const byte *pvs, const entity_state_t *entstates)
 {
 	unsigned int  e, i;
-	byte		 *pvs;
-	vec3_t		  org;
-	edict_t		 *ent, *parent;
+	edict_t		 *ent;
+	edictleafs_t *leafs;
 	unsigned int  maxentities = client->limit_entities;
 	edict_t		 *clent = client->edict;
 	eval_t		 *val;
 	unsigned char eflags;
 	int			  proged = EDICT_TO_PROG (clent);
 
-	struct entity_num_state_s *ents = snapshot_entstate;
+	struct entity_num_state_s *ents = client->snapshotentities;
 	size_t					   numents = 0;
-	size_t					   maxents = snapshot_maxents;
-
-	// find the client's PVS
-	VectorAdd (clent->v.origin, clent->v.view_ofs, org);
-	pvs = SV_FatPVS (org, qcvm->worldmodel);
+	size_t					   maxents = client->maxsnapshotentities;
 
 	if (maxentities > (unsigned int)qcvm->num_edicts)
 		maxentities = (unsigned int)qcvm->num_edicts;
@@ -904,21 +1083,15 @@ static void SVFTE_BuildSnapshotForClient (client_t *client)
 		eflags = 0;
 		if (ent != clent) // clent is ALLWAYS sent
 		{
-			// ignore ents without visible models
-			if ((!ent->v.modelindex || !PR_GetString (ent->v.model)[0]))
-			{
-			invisible:
-				continue;
-			}
-
+			// the pvs test only reads qcvm->edictleafs, so it goes first and the culled edicts are never touched.
 			// attached entities should use the pvs of the parent rather than the child (because the child will typically be bugging out around '0 0 0', so
 			// won't be useful)
-			parent = ent;
-			if (parent->num_leafs)
+			leafs = &qcvm->edictleafs[e];
+			if (leafs->num_leafs)
 			{
 				// ignore if not touching a PV leaf
-				for (i = 0; i < parent->num_leafs; i++)
-					if (pvs[parent->leafnums[i] >> 3] & (1 << (parent->leafnums[i] & 7)))
+				for (i = 0; i < leafs->num_leafs; i++)
+					if (pvs[leafs->leafnums[i] >> 3] & (1 << (leafs->leafnums[i] & 7)))
 						break;
 
 				// ericw -- added ent->num_leafs < MAX_ENT_LEAFS condition.
@@ -927,9 +1100,16 @@ static void SVFTE_BuildSnapshotForClient (client_t *client)
 				// for us to say whether it's in the PVS, so don't try to vis cull it.
 				// this commonly happens with rotators, because they often have huge bboxes
 				// spanning the entire map, or really tall lifts, etc.
-				if (i == parent->num_leafs && parent->num_leafs < MAX_ENT_LEAFS)
+				if (i == leafs->num_leafs && leafs->num_leafs < MAX_ENT_LEAFS)
 					goto invisible; // not visible
 			}
+
+			// ignore ents without visible models
+			if (!ent->v.modelindex || !SV_HasModelName (ent))
+			{
+			invisible:
+				continue;
+			}
 		}
 
 		val = GetEdictFieldValue (ent, qcvm->extfields.nodrawtoclient);
@@ -947,7 +1127,10 @@ static void SVFTE_BuildSnapshotForClient (client_t *client)
 		}
 
 		ents[numents].num = e;
-		SV_BuildEntityState (ent, &ents[numents].state);
+		if (entstates)
+			ents[numents].state = entstates[e];
+		else
+			SV_BuildEntityState (ent, &ents[numents].state);
 		if ((unsigned int)ents[numents].state.modelindex >= client->limit_models)
 			ents[numents].state.modelindex = 0;
 		if (ent == clent) // add velocity, but we only care for the local player (should add prediction for other entities some time too).
@@ -967,9 +1150,9 @@ static void SVFTE_BuildSnapshotForClient (client_t *client)
 		numents++;
 	}
 
-	snapshot_entstate = ents;
-	snapshot_numents = numents;
-	snapshot_maxents = maxents;
+	client->snapshotentities = ents;
+	client->numsnapshotentities = numents;
+	client->maxsnapshotentities = maxents;
 }
 
 void MSG_WriteStaticOrBaseLine (sizebuf_t *buf, int idx, entity_state_t *state, unsigned int protocol_pext2, unsigned int protocol, unsigned int protocolflags)
@@ -984,7 +1167,7 @@ void MSG_WriteStaticOrBaseLine (sizebuf_t *buf, int idx, entity_state_t *state,
 		}
 		else
 			MSG_WriteByte (buf, svcfte_spawnstatic2);
-		MSGFTE_WriteEntityUpdate (MSGFTE_DeltaCalcBits (&nullentitystate, state), state, buf, protocol_pext2, protocolflags);
+		MSGFTE_WriteEntityUpdate (MSGFTE_DeltaCalcBits (&nullentitystate, state), state, &nullentitystate, buf, protocol_pext2, protocolflags);
 	}
 	else
 	{
@@ -1126,6 +1309,91 @@ static void SV_Protocol_f (void)
 	}
 }
 
+#define BENCH_NUM_ENTITIES 1024
+
+typedef struct
+{
+	entity_state_t from[BENCH_NUM_ENTITIES];
+	entity_state_t to[BENCH_NUM_ENTITIES];
+	sizebuf_t	   msg;
+	byte		   msgbuf[NET_MAXMESSAGE];
+	unsigned int   next;
+} bench_entity_updates_t;
+
+/*
+===============
+SV_BenchEntityUpdatesSetup
+
+Random entities and the changes a typical frame makes to them: everything moves a bit,
+some turn or animate and every eighth one is a player with prediction info
+===============
+*/
+static qboolean SV_BenchEntityUpdatesSetup (void **data)
+{
+	bench_entity_updates_t *bench = (bench_entity_updates_t *)Mem_Alloc (sizeof (bench_entity_updates_t));
+	int						i, j;
+
+	COM_SeedRand (0);
+	for (i = 0; i < BENCH_NUM_ENTITIES; i++)
+	{
+		entity_state_t *from = &bench->from[i];
+		entity_state_t *to = &bench->to[i];
+
+		*from = nullentitystate;
+		for (j = 0; j < 3; j++)
+		{
+			from->origin[j] = (COM_Rand () % 8192) - 4096;
+			from->angles[j] = (j == 1) ? (COM_Rand () % 360) : 0;
+		}
+		from->modelindex = 1 + COM_Rand () % 200;
+		from->frame = COM_Rand () % 64;
+		if ((i & 7) == 0)
+		{
+			from->pmovetype = MOVETYPE_WALK;
+			from->velocity[0] = (COM_Rand () % 640) - 320;
+			from->velocity[1] = (COM_Rand () % 640) - 320;
+		}
+
+		*to = *from;
+		for (j = 0; j < 3; j++)
+			to->origin[j] += (COM_Rand () % 33) - 16;
+		if (COM_Rand () & 1)
+			to->angles[1] += 10;
+		if ((COM_Rand () & 3) == 0)
+			to->frame++;
+		if ((i & 7) == 0)
+			to->velocity[2] = (COM_Rand () % 540) - 270;
+	}
+
+	bench->msg.data = bench->msgbuf;
+	bench->msg.maxsize = sizeof (bench->msgbuf);
+	*data = bench;
+	return true;
+}
+
+static void SV_BenchEntityUpdatesShutdown (void *data)
+{
+	Mem_Free (data);
+}
+
+static void SV_BenchEntityUpdates (void *data, int count)
+{
+	const unsigned int		pext2 = PEXT2_REPLACEMENTDELTAS | PEXT2_PREDINFO | PEXT2_VARINTDELTAS;
+	bench_entity_updates_t *bench = (bench_entity_updates_t *)data;
+	int						i;
+
+	for (i = 0; i < count; i++)
+	{
+		const int	 ent = bench->next++ & (BENCH_NUM_ENTITIES - 1);
+		unsigned int bits = MSGFTE_DeltaCalcBits (&bench->from[ent], &bench->to[ent]) & ~UF_UNUSED2;
+		if (bench->msg.cursize > bench->msg.maxsize - 256)
+			SZ_Clear (&bench->msg);
+		MSGFTE_WriteEntityUpdate (bits, &bench->to[ent], &bench->from[ent], &bench->msg, pext2, PRFL_FLOATCOORD | PRFL_SHORTANGLE);
+	}
+}
+
+static const bench_case_t sv_bench_entity_updates = {"entity_update_fte", SV_BenchEntityUpdatesSetup, SV_BenchEntityUpdates, SV_BenchEntityUpdatesShutdown};
+
 /*
 ===============
 SV_Init
@@ -1142,7 +1410,9 @@ void SV_Init (void)
 	extern cvar_t sv_gameplayfix_spawnbeforethinks;
 	extern cvar_t sv_gameplayfix_bouncedownslopes;
 	extern cvar_t sv_gameplayfix_elevators;
+	extern cvar_t sv_gameplayfix_findradiusareanodes;
 	extern cvar_t sv_fastpushmove;
+	extern cvar_t sv_prefetchtraces;
 	extern cvar_t sv_friction;
 	extern cvar_t sv_edgefriction;
 	extern cvar_t sv_stopspeed;
@@ -1151,6 +1421,7 @@ void SV_Init (void)
 	extern cvar_t sv_idealpitchscale;
 	extern cvar_t sv_aim;
 	extern cvar_t sv_altnoclip; // johnfitz
+	extern cvar_t sv_batchmessages;
 
 	// FTE optimized world geometry checks
 	extern cvar_t sv_fte_recursivehullckeck;
@@ -1173,18 +1444,29 @@ void SV_Init (void)
 	Cvar_RegisterVariable (&sv_gameplayfix_spawnbeforethinks);
 	Cvar_RegisterVariable (&sv_gameplayfix_bouncedownslopes);
 	Cvar_RegisterVariable (&sv_gameplayfix_elevators);
+	Cvar_RegisterVariable (&sv_gameplayfix_findradiusareanodes);
 	Cvar_RegisterVariable (&sv_fastpushmove);
+	Cvar_RegisterVariable (&sv_prefetchtraces);
 	Cvar_RegisterVariable (&pr_checkextension);
 	Cvar_RegisterVariable (&sv_altnoclip); // johnfitz
+	Cvar_RegisterVariable (&sv_batchmessages);
 	Cvar_RegisterVariable (&sv_netsort);
 	Cvar_RegisterVariable (&sv_smoothplatformlerps);
+	Cvar_RegisterVariable (&sv_parallelsnapshots);
+	Cvar_RegisterVariable (&sv_snapshotbudget);
 
 	Cvar_RegisterVariable (&sv_fte_recursivehullckeck);
 	Cvar_RegisterVariable (&sv_fte_createareanode);
+	Cvar_RegisterVariable (&sv_areanodes_balanced);
 
 	Cmd_AddCommand ("pext", SV_Pext_f);
+	Cmd_AddCommand ("sv_areastats", SV_AreaStats_f);
 	Cmd_AddCommand ("sv_protocol", &SV_Protocol_f); // johnfitz
 
+	SV_Speeds_Init ();
+	SV_Replay_Init ();
+	Bench_Register (&sv_bench_entity_updates);
+
 	for (i = 0; i < MAX_MODELS; i++)
 		q_snprintf (localmodels[i], 8, "*%i", i);
 
@@ -1452,7 +1734,7 @@ void SV_SendServerinfo (client_t *client)
 	client->protocol_pext2 &= sv_protocol_pext2;
 
 	if (!(client->protocol_pext2 & PEXT2_REPLACEMENTDELTAS))
-		client->protocol_pext2 &= ~PEXT2_PREDINFO; // stats can't be deltaed if there's no deltas, so just pretend its not supported on its own.
+		client->protocol_pext2 &= ~(PEXT2_PREDINFO | PEXT2_VARINTDELTAS); // both only make sense with replacement deltas, so pretend they're not supported
 
 	// now we know their protocol, pick some real defaults that match the limits of the engine that most defines that protocol's limits.
 	switch (client->protocol_pext2 ? PROTOCOL_FTE_PEXT2 : sv.protocol)
@@ -1646,6 +1928,8 @@ void SV_Pext_f (void)
 			Con_Printf ("  Replacement Entity Deltas\n");
 		if (cl.protocol_pext2 & PEXT2_PREDINFO)
 			Con_Printf ("  Replacement Stats ('predinfo')\n");
+		if (cl.protocol_pext2 & PEXT2_VARINTDELTAS)
+			Con_Printf ("  Varint Entity Deltas\n");
 		if (cl.protocol == PROTOCOL_NETQUAKE)
 			Con_Printf ("  vanilla(15)\n");
 		else if (cl.protocol == PROTOCOL_FITZQUAKE)
@@ -1753,6 +2037,9 @@ void SV_CheckForNewClients (void)
 	struct qsocket_s *ret;
 	int				  i;
 
+	if (sv_replaying)
+		return; // connects come from the recording
+
 	//
 	// check for new connections
 	//
@@ -1772,6 +2059,7 @@ void SV_CheckForNewClients (void)
 			Sys_Error ("Host_CheckForNewClients: no free clients");
 
 		svs.clients[i].netconnection = ret;
+		SV_RecordConnect (i);
 		SV_ConnectClient (i);
 	}
 }
@@ -1806,6 +2094,8 @@ crosses a waterline.
 =============================================================================
 */
 
+#define FAT_PVS_MAX_SIZE (32 * 1024 * 1024)
+
 static int		fatbytes;
 static byte	   *fatpvs;
 static int		fatpvs_capacity;
@@ -1847,6 +2137,108 @@ void SV_AddToFatPVS (vec3_t org, mnode_t *node, qmodel_t *worldmodel) // johnfit
 	}
 }
 
+/*
+=============
+SV_AddBoxToFatPVS
+
+Same walk as SV_AddToFatPVS, but for every point of a box
+=============
+*/
+static void SV_AddBoxToFatPVS (const float *mins, const float *maxs, mnode_t *node, qmodel_t *worldmodel, byte *row, int rowbytes, byte *scratch, qboolean *any)
+{
+	int		  i;
+	mplane_t *plane;
+	float	  dmin, dmax;
+
+	while (1)
+	{
+		if (node->contents < 0)
+		{
+			if (node->contents != CONTENTS_SOLID)
+			{
+				*any = true;
+				Mod_DecompressVisRow (((mleaf_t *)node)->compressed_vis, worldmodel, scratch);
+				for (i = 0; i < rowbytes - 3; i += 4)
+					*(uint32_t *)&row[i] |= *(uint32_t *)&scratch[i];
+			}
+			return;
+		}
+
+		plane = node->plane;
+		dmin = dmax = -plane->dist;
+		for (i = 0; i < 3; i++)
+		{
+			if (plane->normal[i] >= 0.0f)
+			{
+				dmin += plane->normal[i] * mins[i];
+				dmax += plane->normal[i] * maxs[i];
+			}
+			else
+			{
+				dmin += plane->normal[i] * maxs[i];
+				dmax += plane->normal[i] * mins[i];
+			}
+		}
+
+		if (dmin > 8)
+			node = node->children[0];
+		else if (dmax < -8)
+			node = node->children[1];
+		else
+		{ // go down both
+			SV_AddBoxToFatPVS (mins, maxs, node->children[0], worldmodel, row, rowbytes, scratch, any);
+			node = node->children[1];
+		}
+	}
+}
+
+/*
+=============
+SV_BuildFatPVSTask
+=============
+*/
+static void SV_BuildFatPVSTask (int i, qmodel_t **worldmodel_ptr)
+{
+	qmodel_t	*worldmodel = *worldmodel_ptr;
+	mleaf_t		*leaf = worldmodel->leafs + i + 1;
+	const int	 rowbytes = (worldmodel->numleafs + 31) / 8;
+	const size_t stride = (rowbytes + 3) & ~3;
+	byte		*row = worldmodel->fat_pvs + stride * (i + 1);
+	qboolean	 any = false;
+
+	TEMP_ALLOC (byte, scratch, rowbytes);
+	memset (row, 0, rowbytes);
+	SV_AddBoxToFatPVS (leaf->minmaxs, leaf->minmaxs + 3, worldmodel->nodes, worldmodel, row, rowbytes, scratch, &any);
+	if (!any)
+		memset (row, 0xff, rowbytes);
+	TEMP_FREE (scratch);
+}
+
+/*
+=============
+SV_BuildFatPVS
+
+Precomputes a fat pvs row for each leaf of the world from the leaf bounds. Any point
+inside a leaf sees a subset of its row, so SV_FatPVS becomes a leaf lookup. Maps too
+big for the table keep walking the tree for every call.
+=============
+*/
+static void SV_BuildFatPVS (qmodel_t *worldmodel)
+{
+	const int	 rowbytes = (worldmodel->numleafs + 31) / 8;
+	const size_t stride = (rowbytes + 3) & ~3;
+	const size_t size = stride * (worldmodel->numleafs + 1);
+
+	if (worldmodel->fat_pvs || worldmodel->numleafs <= 0 || size > FAT_PVS_MAX_SIZE)
+		return;
+
+	worldmodel->fat_pvs = (byte *)Mem_AllocNonZero (size);
+	memset (worldmodel->fat_pvs, 0xff, stride);
+	task_handle_t task =
+		Task_AllocateAssignIndexedFuncAndSubmit ((task_indexed_func_t)SV_BuildFatPVSTask, worldmodel->numleafs, &worldmodel, sizeof (qmodel_t *));
+	Task_Join (task, TASK_TIMEOUT_INFINITE);
+}
+
 /*
 =============
 SV_FatPVS
@@ -1858,6 +2250,13 @@ given point.
 byte *SV_FatPVS (vec3_t org, qmodel_t *worldmodel) // johnfitz -- added worldmodel as a parameter
 {
 	fatbytes = (worldmodel->numleafs + 31) / 8;
+	if (worldmodel->fat_pvs)
+	{
+		mleaf_t *leaf = Mod_PointInLeaf (org, worldmodel);
+		if (leaf != worldmodel->leafs)
+			return worldmodel->fat_pvs + (size_t)((fatbytes + 3) & ~3) * (leaf - worldmodel->leafs);
+	}
+
 	if (fatpvs == NULL || fatbytes > fatpvs_capacity)
 	{
 		fatpvs_capacity = fatbytes;
@@ -1883,15 +2282,16 @@ PVS test encapsulated in a nice function
 */
 qboolean SV_VisibleToClient (edict_t *client, edict_t *test, qmodel_t *worldmodel)
 {
-	byte		*pvs;
-	vec3_t		 org;
-	unsigned int i;
+	byte			   *pvs;
+	vec3_t				org;
+	unsigned int		i;
+	const edictleafs_t *leafs = EDICT_LEAFS (test);
 
 	VectorAdd (client->v.origin, client->v.view_ofs, org);
 	pvs = SV_FatPVS (org, worldmodel);
 
-	for (i = 0; i < test->num_leafs; i++)
-		if (pvs[test->leafnums[i] >> 3] & (1 << (test->leafnums[i] & 7)))
+	for (i = 0; i < leafs->num_leafs; i++)
+		if (pvs[leafs->leafnums[i] >> 3] & (1 << (leafs->leafnums[i] & 7)))
 			return true;
 
 	return false;
@@ -1912,18 +2312,19 @@ SV_WriteEntitiesToClient
 */
 void SV_WriteEntitiesToClient (client_t *client, sizebuf_t *msg, size_t overflowsize)
 {
-	edict_t		*clent = client->edict;
-	unsigned int e, i, maxedict = qcvm->num_edicts, j, numents;
-	int			 bits;
-	byte		*pvs;
-	vec3_t		 org, forward, right, up;
-	float		 miss, dist, size;
-	edict_t		*ent;
-	eval_t		*val;
-	size_t		 rollbacksize, origmaxsize = msg->maxsize;
-	qboolean	 sort = sv_netsort.value > 1;
-	float		 scale;
-	const char	*model;
+	edict_t		 *clent = client->edict;
+	unsigned int  e, i, maxedict = qcvm->num_edicts, j, numents;
+	int			  bits;
+	byte		 *pvs;
+	vec3_t		  org, forward, right, up;
+	float		  miss, dist, size;
+	edict_t		 *ent;
+	edictleafs_t *leafs;
+	eval_t		 *val;
+	size_t		  rollbacksize, origmaxsize = msg->maxsize;
+	qboolean	  sort = sv_netsort.value > 1;
+	float		  scale;
+	const char	 *model;
 
 	// with sv_netsort = 1, sort only if (any client) overflowed in the last 10 seconds
 	if (sv_netsort.value == 1 && dev_overflows.packetsize + 10 > realtime)
@@ -1961,17 +2362,10 @@ void SV_WriteEntitiesToClient (client_t *client, sizebuf_t *msg, size_t overflow
 	{
 		if (ent != clent) // clent already added before the loop
 		{
-			// ignore ents without visible models
-			if (!ent->v.modelindex || !(model = PR_GetString (ent->v.model))[0])
-				continue;
-
-			// johnfitz -- don't send model>255 entities if protocol is 15
-			if ((unsigned int)ent->v.modelindex >= client->limit_models)
-				continue;
-
-			// ignore if not touching a PV leaf
-			for (i = 0; i < ent->num_leafs; i++)
-				if (pvs[ent->leafnums[i] >> 3] & (1 << (ent->leafnums[i] & 7)))
+			// ignore if not touching a PV leaf, tested first because it only reads qcvm->edictleafs
+			leafs = &qcvm->edictleafs[e];
+			for (i = 0; i < leafs->num_leafs; i++)
+				if (pvs[leafs->leafnums[i] >> 3] & (1 << (leafs->leafnums[i] & 7)))
 					break;
 
 			// ericw -- added ent->num_leafs < MAX_ENT_LEAFS condition.
@@ -1980,9 +2374,17 @@ void SV_WriteEntitiesToClient (client_t *client, sizebuf_t *msg, size_t overflow
 			// for us to say whether it's in the PVS, so don't try to vis cull it.
 			// this commonly happens with rotators, because they often have huge bboxes
 			// spanning the entire map, or really tall lifts, etc.
-			if (i == ent->num_leafs && ent->num_leafs < MAX_ENT_LEAFS)
+			if (i == leafs->num_leafs && leafs->num_leafs < MAX_ENT_LEAFS)
 				continue; // not visible
 
+			// ignore ents without visible models
+			if (!ent->v.modelindex || !(model = PR_GetString (ent->v.model))[0])
+				continue;
+
+			// johnfitz -- don't send model>255 entities if protocol is 15
+			if ((unsigned int)ent->v.modelindex >= client->limit_models)
+				continue;
+
 			if (sort)
 			{
 				// compute ent bbox size and distance from org to the closest point in ent's bbox
@@ -2465,15 +2867,61 @@ void SV_WriteClientdataToMessage (client_t *client, sizebuf_t *msg)
 										 // johnfitz
 }
 
-void SV_PresendClientDatagram (client_t *client)
+/*
+=======================
+SV_PresendClientPVS
+
+Returns true if the client gets a snapshot this frame, after keeping a copy of its fat pvs for
+SV_PresendClientDatagram. Mod_LeafPVS caches rows, so this part stays on the main thread.
+=======================
+*/
+static qboolean SV_PresendClientPVS (client_t *client)
 {
+	vec3_t org;
+	byte  *pvs;
+	int	   pvssize;
+
+	if (!client->active)
+		return false;
 	if (!client->netconnection)
-		return; // botclient
+		return false; // botclient
 	if (!client->spawned)
-		return; // not ready yet.
+		return false; // not ready yet.
 	if (!(client->protocol_pext2 & PEXT2_REPLACEMENTDELTAS))
-		return; // brute force networking.
-	SVFTE_BuildSnapshotForClient (client);
+		return false; // brute force networking.
+
+	// find the client's PVS
+	VectorAdd (client->edict->v.origin, client->edict->v.view_ofs, org);
+	pvs = SV_FatPVS (org, qcvm->worldmodel);
+	pvssize = (qcvm->worldmodel->numleafs + 31) / 8;
+	if (client->snapshotpvssize < pvssize)
+	{
+		client->snapshotpvssize = pvssize;
+		client->snapshotpvs = (byte *)Mem_Realloc (client->snapshotpvs, pvssize);
+	}
+	memcpy (client->snapshotpvs, pvs, pvssize);
+	return true;
+}
+
+/*
+=======================
+SV_PresendClientDatagram
+
+Generates the snapshot of a client and the deltas to send. Only reads the edicts and writes to
+its own client, so the clients can be done in parallel.
+=======================
+*/
+typedef struct
+{
+	const int			 *clients;	 // in svs.clients
+	const entity_state_t *entstates; // shared edict states, or NULL to build them per client
+} presendargs_t;
+
+static void SV_PresendClientDatagram (int index, presendargs_t *args)
+{
+	client_t *client = &svs.clients[args->clients[index]];
+
+	SVFTE_BuildSnapshotForClient (client, client->snapshotpvs, args->entstates);
 	SVFTE_CalcEntityDeltas (client);
 	client->snapshotresume = 0;
 }
@@ -2541,7 +2989,7 @@ qboolean SV_SendClientDatagram (client_t *client)
 			// this delta protocol doesn't wipe old state just because there's a new packet.
 			// the server isn't required to sync with the client frames either
 			// so we can just spam multiple packets to keep our udp data under the MTU
-			while (client->snapshotresume < client->numpendingentities)
+			while (client->snapshotresume < client->numsnapshotorder)
 			{
 				NET_SendUnreliableMessage (client->netconnection, &msg);
 				SZ_Clear (&msg);
@@ -2816,6 +3264,197 @@ int SV_SendPrespawnBaselines (int idx)
 	return idx;
 }
 
+/*
+==============================================================================
+
+COMPRESSED PRESPAWN
+
+PEXT2_COMPRESSEDSIGNON clients get the output of the prespawn states as one
+deflated blob. Clients with the same protocol limits usually end up with the
+same bytes, so the deflated blobs are cached until the next map.
+
+==============================================================================
+*/
+
+#define MAX_SIGNON_BLOBS 8
+
+typedef struct signonblob_s
+{
+	int	  rawsize;
+	byte *raw;
+	int	  size;
+	byte *data;
+} signonblob_t;
+
+static signonblob_t signon_blobs[MAX_SIGNON_BLOBS];
+static int			num_signon_blobs;
+
+/*
+================
+SV_FreeSignonBlobs
+================
+*/
+void SV_FreeSignonBlobs (void)
+{
+	int i;
+
+	for (i = 0; i < num_signon_blobs; i++)
+	{
+		Mem_Free (signon_blobs[i].raw);
+		Mem_Free (signon_blobs[i].data);
+	}
+	memset (signon_blobs, 0, sizeof (signon_blobs));
+	num_signon_blobs = 0;
+	for (i = 0; svs.clients && i < svs.maxclients; i++)
+		svs.clients[i].signonblob = NULL;
+}
+
+/*
+================
+SV_BuildPrespawnBlob
+
+Runs the PRESPAWN_SOUNDS to PRESPAWN_AMBIENTS states for host_client into one buffer, in the same order
+SV_SendClientMessages would send them. Leaves host_client's signon progress untouched.
+================
+*/
+static byte *SV_BuildPrespawnBlob (int *rawsize)
+{
+	sizebuf_t	 message = host_client->message;
+	unsigned int signon_sounds = host_client->signon_sounds;
+	byte		*raw = NULL;
+	int			 size = 0;
+	int			 maxsize = 0;
+	int			 state = PRESPAWN_SOUNDS;
+	int			 idx = 0;
+	qboolean	 done;
+
+	host_client->message.data = (byte *)Mem_AllocTagged (NET_MAXMESSAGE, MEM_TAG_NET);
+	host_client->message.maxsize = NET_MAXMESSAGE;
+	host_client->message.cursize = 0;
+	host_client->message.overflowed = false;
+	while (state < PRESPAWN_SIGNONMSG)
+	{
+		switch (state)
+		{
+		case PRESPAWN_SOUNDS:
+			done = !SV_SendPrespawnSoundPrecaches ();
+			break;
+		case PRESPAWN_PARTICLES:
+			idx = SV_SendPrespawnParticlePrecaches (idx);
+			done = idx < 0;
+			break;
+		case PRESPAWN_BASELINES:
+			idx = SV_SendPrespawnBaselines (idx);
+			done = idx < 0;
+			break;
+		case PRESPAWN_STATICS:
+			idx = SV_SendPrespawnStatics (idx);
+			done = idx < 0;
+			break;
+		default:
+			idx = SV_SendAmbientSounds (idx);
+			done = idx < 0;
+			break;
+		}
+
+		if (size + host_client->message.cursize > maxsize)
+		{
+			maxsize = q_max (maxsize * 2, size + host_client->message.cursize);
+			raw = (byte *)Mem_Realloc (raw, maxsize);
+		}
+		memcpy (raw + size, host_client->message.data, host_client->message.cursize);
+		size += host_client->message.cursize;
+		SZ_Clear (&host_client->message);
+		if (done)
+		{
+			state++;
+			idx = 0;
+		}
+	}
+
+	Mem_Free (host_client->message.data);
+	host_client->message = message;
+	host_client->signon_sounds = signon_sounds;
+	*rawsize = size;
+	return raw;
+}
+
+/*
+================
+SV_GetPrespawnBlob
+
+Returns NULL if the client has to go through the uncompressed prespawn states instead.
+================
+*/
+static signonblob_t *SV_GetPrespawnBlob (void)
+{
+	signonblob_t *blob;
+	int			  i, rawsize;
+	size_t		  size;
+	byte		 *raw = SV_BuildPrespawnBlob (&rawsize);
+
+	if (!raw)
+		return NULL;
+	for (i = 0; i < num_signon_blobs; i++)
+	{
+		blob = &signon_blobs[i];
+		if (blob->rawsize == rawsize && !memcmp (blob->raw, raw, rawsize))
+		{
+			Mem_Free (raw);
+			return blob;
+		}
+	}
+	if (num_signon_blobs == MAX_SIGNON_BLOBS)
+	{
+		Mem_Free (raw);
+		return NULL;
+	}
+
+	blob = &signon_blobs[num_signon_blobs];
+	blob->data = (byte *)Mem_Alloc (rawsize + rawsize / 8 + 1024); // deflate only expands incompressible data by a few bytes per block
+	size = tdefl_compress_mem_to_mem (blob->data, rawsize + rawsize / 8 + 1024, raw, rawsize, TDEFL_DEFAULT_MAX_PROBES);
+	if (!size)
+	{
+		Mem_Free (blob->data);
+		blob->data = NULL;
+		Mem_Free (raw);
+		return NULL;
+	}
+	blob->raw = raw;
+	blob->rawsize = rawsize;
+	blob->size = (int)size;
+	num_signon_blobs++;
+	Con_DPrintf ("Compressed prespawn data from %d to %d bytes\n", rawsize, blob->size);
+	return blob;
+}
+
+/*
+================
+SV_SendPrespawnBlob
+
+Appends as much of host_client's blob as fits into its reliable message.
+Returns false once everything was written.
+================
+*/
+static qboolean SV_SendPrespawnBlob (void)
+{
+	signonblob_t *blob = host_client->signonblob;
+	int			  len = host_client->message.maxsize - host_client->message.cursize - 32;
+
+	len = q_min (len, blob->size - host_client->signonblobofs);
+	if (len > 0)
+	{
+		MSG_WriteByte (&host_client->message, svcvk_signonchunk);
+		MSG_WriteLong (&host_client->message, blob->rawsize);
+		MSG_WriteLong (&host_client->message, blob->size);
+		MSG_WriteLong (&host_client->message, host_client->signonblobofs);
+		MSG_WriteLong (&host_client->message, len);
+		SZ_Write (&host_client->message, blob->data + host_client->signonblobofs, len);
+		host_client->signonblobofs += len;
+	}
+	return host_client->signonblobofs < blob->size;
+}
+
 /*
 =======================
 SV_SendClientMessages
@@ -2823,20 +3462,54 @@ SV_SendClientMessages
 */
 void SV_SendClientMessages (void)
 {
-	int i;
+	int i, numsnapshots;
 
 	// update frags, names, etc
 	SV_UpdateToReliableMessages ();
 
-	for (i = 0, host_client = svs.clients; i < svs.maxclients; i++, host_client++)
+	SV_SpeedsBegin (SVSPEEDS_SNAPSHOTS);
+
+	// generates client snapshots
+	int *snapshotclients = (int *)Mem_FrameAlloc (svs.maxclients * sizeof (int));
+	numsnapshots = 0;
+	for (i = 0; i < svs.maxclients; i++)
+		if (SV_PresendClientPVS (&svs.clients[i]))
+			snapshotclients[numsnapshots++] = i;
+
+	presendargs_t args = {snapshotclients, NULL};
+	if (numsnapshots > 1)
 	{
-		if (!host_client->active)
-			continue;
+		// build each edict state once rather than once per client that sees it
+		if (frame_maxentstates < qcvm->num_edicts)
+		{
+			frame_maxentstates = qcvm->max_edicts;
+			frame_entstates = (entity_state_t *)Mem_Realloc (frame_entstates, frame_maxentstates * sizeof (entity_state_t));
+		}
+		if (sv_parallelsnapshots.value)
+		{
+			task_handle_t task = Task_AllocateAssignRangeFuncAndSubmit (SV_BuildFrameEntityStates, qcvm->num_edicts, NULL, 0);
+			Task_Join (task, TASK_TIMEOUT_INFINITE);
+		}
+		else
+			SV_BuildFrameEntityStates (0, qcvm->num_edicts, NULL);
+		args.entstates = frame_entstates;
+	}
 
-		SV_PresendClientDatagram (host_client); // generates client snapshots (and updates csqc pending flags)
+	if (sv_parallelsnapshots.value && numsnapshots > 1)
+	{
+		task_handle_t task = Task_AllocateAssignIndexedFuncAndSubmit ((task_indexed_func_t)SV_PresendClientDatagram, numsnapshots, &args, sizeof (args));
+		Task_Join (task, TASK_TIMEOUT_INFINITE);
+	}
+	else
+	{
+		for (i = 0; i < numsnapshots; i++)
+			SV_PresendClientDatagram (i, &args);
 	}
+	SV_SpeedsEnd ();
 
-	// build individual updates
+	// build individual updates, the datagrams are flushed together at the end
+	SV_SpeedsBegin (SVSPEEDS_SEND);
+	NET_BeginSendBatch ();
 	for (i = 0, host_client = svs.clients; i < svs.maxclients; i++, host_client++)
 	{
 		if (!host_client->active)
@@ -2857,7 +3530,21 @@ void SV_SendClientMessages (void)
 					SV_SendNop (host_client);
 				continue; // don't send out non-signon messages
 			}
-			if (host_client->sendsignon == PRESPAWN_MODELS)
+			if (host_client->sendsignon == PRESPAWN_MODELS && (host_client->protocol_pext2 & PEXT2_COMPRESSEDSIGNON))
+			{
+				if (!host_client->signonblob)
+				{
+					host_client->signonblob = SV_GetPrespawnBlob ();
+					host_client->signonblobofs = 0;
+				}
+				if (host_client->signonblob && !SV_SendPrespawnBlob ())
+				{
+					host_client->signonblob = NULL;
+					host_client->signonidx = 0;
+					host_client->sendsignon = PRESPAWN_SIGNONMSG;
+				}
+			}
+			if (host_client->sendsignon == PRESPAWN_MODELS && !host_client->signonblob)
 			{
 				if (!SV_SendPrespawnModelPrecaches ())
 				{
@@ -2952,6 +3639,8 @@ void SV_SendClientMessages (void)
 			}
 		}
 	}
+	NET_EndSendBatch ();
+	SV_SpeedsEnd ();
 
 	// clear muzzle flashes
 	SV_CleanupEnts ();
@@ -3155,6 +3844,9 @@ void SV_SpawnServer (const char *server)
 
 	q_strlcpy (sv.name, server, sizeof (sv.name));
 
+	// seed the random numbers and set up clients for sv_record/sv_replay
+	SV_ReplaySpawn (server);
+
 	sv.protocol = sv_protocol; // johnfitz
 
 	if (sv.protocol == PROTOCOL_RMQ)
@@ -3172,12 +3864,12 @@ void SV_SpawnServer (const char *server)
 
 	PR_SwitchQCVM (vm);
 	// load progs to get entity field count
+	SCR_BeginLoadingPhase ("progs", 0);
 	PR_LoadProgs ("progs.dat", true, PROGHEADER_CRC, pr_ssqcbuiltins, pr_ssqcnumbuiltins);
 
 	// allocate server memory
 	/* Host_ClearMemory() called above already cleared the whole sv structure */
-	qcvm->max_edicts = CLAMP (MIN_EDICTS, (int)max_edicts.value, MAX_EDICTS);  // johnfitz -- max_edicts cvar
-	qcvm->edicts = (edict_t *)Mem_Alloc (qcvm->max_edicts * qcvm->edict_size); // ericw -- sv.edicts switched to use malloc()
+	ED_AllocEdicts (CLAMP (MIN_EDICTS, (int)max_edicts.value, MAX_EDICTS)); // johnfitz -- max_edicts cvar
 
 	sv.datagram.maxsize = sizeof (sv.datagram_buf);
 	sv.datagram.cursize = 0;
@@ -3197,7 +3889,7 @@ void SV_SpawnServer (const char *server)
 
 	// leave slots at start for clients only
 	qcvm->num_edicts = qcvm->reserved_edicts = svs.maxclients + 1;
-	memset (qcvm->edicts, 0, qcvm->num_edicts * qcvm->edict_size); // ericw -- sv.edicts switched to use malloc()
+	ED_CommitEdicts (qcvm->num_edicts);
 	for (i = 0; i < svs.maxclients; i++)
 	{
 		ent = EDICT_NUM (i + 1);
@@ -3212,15 +3904,18 @@ void SV_SpawnServer (const char *server)
 
 	q_strlcpy (sv.name, server, sizeof (sv.name));
 	q_snprintf (sv.modelname, sizeof (sv.modelname), "maps/%s.bsp", server);
+	SCR_BeginLoadingPhase ("world", 0);
 	qcvm->worldmodel = Mod_ForName (sv.modelname, false);
 	if (!qcvm->worldmodel || qcvm->worldmodel->type != mod_brush)
 	{
+		SCR_EndLoadingPhase ();
 		Con_Printf ("Couldn't spawn server %s\n", sv.modelname);
 		sv.active = false;
 		return;
 	}
 	sv.models[1] = qcvm->worldmodel;
 	qcvm->GetModel = SV_ModelForIndex;
+	SV_BuildFatPVS (qcvm->worldmodel);
 
 	//
 	// clear world interaction links
@@ -3232,6 +3927,7 @@ void SV_SpawnServer (const char *server)
 	sv.model_precache[1] = sv.modelname;
 	if (qcvm->worldmodel->numsubmodels > MAX_MODELS)
 	{
+		SCR_EndLoadingPhase ();
 		Con_Printf ("too many inline models %s\n", sv.modelname);
 		sv.active = false;
 		return;
@@ -3263,8 +3959,13 @@ void SV_SpawnServer (const char *server)
 	// serverflags are for cross level information (sigils)
 	pr_global_struct->serverflags = svs.serverflags;
 
+	// spawning the entities precaches their models and sounds
+	SCR_BeginLoadingPhase ("entities", (int)strlen (qcvm->worldmodel->entities));
 	ED_LoadFromFile (qcvm->worldmodel->entities);
 
+	if (sv_areanodes_balanced.value)
+		SV_RebalanceAreaNodes ();
+
 	sv.active = true;
 
 	SV_Precache_Model ("progs/player.mdl"); // Spike -- SV_CreateBaseline depends on this model.
@@ -3292,6 +3993,7 @@ void SV_SpawnServer (const char *server)
 		if (host_client->active)
 			SV_SendServerinfo (host_client);
 	}
+	SCR_EndLoadingPhase ();
 
 	Con_DPrintf ("Server spawned.\n");
 }
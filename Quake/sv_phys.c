@@ -50,6 +50,7 @@ cvar_t sv_freezenonclients = {"sv_freezenonclients", "0", CVAR_NONE};
 cvar_t sv_gameplayfix_spawnbeforethinks = {"sv_gameplayfix_spawnbeforethinks", "0", CVAR_NONE};
 cvar_t sv_gameplayfix_bouncedownslopes = {"sv_gameplayfix_bouncedownslopes", "1", CVAR_NONE}; // fixes grenades making horrible noises on slopes.
 cvar_t sv_fastpushmove = {"sv_fastpushmove", "1", CVAR_ARCHIVE};							  // 0=old SV_PushMove processing; 1= faster SV_PushMove, (default)
+cvar_t sv_prefetchtraces = {"sv_prefetchtraces", "1", CVAR_NONE}; // run the world traces of airborne toss entities on the task workers
 
 #define MOVE_EPSILON 0.01
 
@@ -1240,6 +1241,73 @@ static void SV_Physics_Step (edict_t *ent)
 	SV_CheckWaterTransition (ent);
 }
 
+/*
+=============
+SV_PrefetchTossTraces
+
+Queues the world trace of every airborne toss entity, predicted the way SV_Physics_Toss will make it,
+and hands them to the task workers while the serial loop runs. SV_Move only takes a prefetched trace
+when the move it is asked for is bitwise the predicted one, so thinks, pushers and impacts changing
+an entity before it moves just fall back to a regular trace.
+=============
+*/
+static void SV_PrefetchTossTraces (int entity_cap)
+{
+	int		 i, j;
+	edict_t *ent;
+	vec3_t	 velocity, move, end;
+	eval_t	*val;
+	float	 ent_gravity;
+	int		 gravity_offset;
+
+	SV_FinishWorldTraces (); // left over by an error
+	if (!sv_prefetchtraces.value || qcvm != &sv.qcvm)
+		return;
+
+	gravity_offset = ED_FindFieldOffset ("gravity");
+	for (i = svs.maxclients + 1; i < entity_cap; i++)
+	{
+		ent = EDICT_NUM (i);
+		if (ent->free || ((int)ent->v.flags & FL_ONGROUND))
+			continue;
+		if (ent->v.movetype != MOVETYPE_TOSS && ent->v.movetype != MOVETYPE_GIB && ent->v.movetype != MOVETYPE_BOUNCE && ent->v.movetype != MOVETYPE_FLY &&
+			ent->v.movetype != MOVETYPE_FLYMISSILE)
+			continue;
+
+		// same as SV_CheckVelocity, leaving NaNs to it
+		for (j = 0; j < 3; j++)
+		{
+			if (IS_NAN (ent->v.velocity[j]) || IS_NAN (ent->v.origin[j]))
+				break;
+			velocity[j] = ent->v.velocity[j];
+			if (velocity[j] > sv_maxvelocity.value)
+				velocity[j] = sv_maxvelocity.value;
+			else if (velocity[j] < -sv_maxvelocity.value)
+				velocity[j] = -sv_maxvelocity.value;
+		}
+		if (j < 3)
+			continue;
+
+		// same as SV_AddGravity
+		if (ent->v.movetype != MOVETYPE_FLY && ent->v.movetype != MOVETYPE_FLYMISSILE)
+		{
+			val = GetEdictFieldValue (ent, gravity_offset);
+			if (val && val->_float)
+				ent_gravity = val->_float;
+			else
+				ent_gravity = 1.0;
+			velocity[2] -= ent_gravity * sv_gravity.value * host_frametime;
+		}
+
+		// same as SV_PushEntity
+		VectorScale (velocity, host_frametime, move);
+		VectorAdd (ent->v.origin, move, end);
+		SV_QueueWorldTrace (ent, end);
+	}
+
+	SV_SubmitWorldTraces ();
+}
+
 //============================================================================
 
 /*
@@ -1299,6 +1367,8 @@ void SV_Physics (void)
 	else
 		entity_cap = qcvm->num_edicts;
 
+	SV_PrefetchTossTraces (entity_cap);
+
 	// fill the pushable entities cache
 	if (sv_fastpushmove.value > 0.f)
 	{
@@ -1358,6 +1428,8 @@ void SV_Physics (void)
 		// johnfitz
 	}
 
+	SV_FinishWorldTraces ();
+
 	if (pr_global_struct->force_retouch)
 		pr_global_struct->force_retouch--;
 
@@ -0,0 +1,648 @@
+/*
+Copyright (C) 2026 vkQuake developers
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+// sv_replay.c -- server side session recording and headless replay benchmark
+
+#include "quakedef.h"
+
+#include <time.h>
+
+// A recording covers one level: the header is written when the level spawns, followed by the clients
+// carried over from the previous level, then for every server frame its frame time and the client
+// connects, messages and drops in the order the server processed them. Everything is native endian,
+// the files are meant to be replayed by the same build on the same machine.
+
+#define SVREPLAY_MAGIC	 (('P' << 24) + ('R' << 16) + ('V' << 8) + 'S')
+#define SVREPLAY_VERSION 1
+
+typedef enum
+{
+	SVREPLAY_FRAME = 'F',
+	SVREPLAY_CARRY = 'K',
+	SVREPLAY_CONNECT = 'C',
+	SVREPLAY_MESSAGE = 'M',
+	SVREPLAY_DROP = 'D',
+} svreplay_event_type_t;
+
+typedef struct
+{
+	uint32_t magic;
+	int32_t	 version;
+	uint64_t seed;
+	int32_t	 maxclients;
+	int32_t	 serverflags;
+	float	 skill;
+	float	 coop;
+	float	 deathmatch;
+	float	 teamplay;
+	char	 mapname[MAX_QPATH];
+} svreplay_header_t;
+
+typedef struct
+{
+	uint8_t	 type;
+	uint8_t	 slot;
+	uint16_t pad;
+	uint32_t size; // of the payload that follows
+} svreplay_event_t;
+
+typedef struct
+{
+	double frametime;
+	double realtime;
+} svreplay_frame_t;
+
+typedef struct
+{
+	uint8_t local;
+	uint8_t proquake_angle_hack;
+} svreplay_connect_t;
+
+typedef struct
+{
+	svreplay_connect_t connection;
+	char			   name[32];
+	int32_t			   colors;
+	float			   spawn_parms[NUM_TOTAL_SPAWN_PARMS];
+	int32_t			   pextknown;
+	uint32_t		   protocol_pext1;
+	uint32_t		   protocol_pext2;
+} svreplay_carry_t;
+
+qboolean sv_replaying;
+
+static qboolean record_armed;
+static char		record_name[MAX_OSPATH];
+static FILE	   *record_file;
+static int		record_frames;
+
+static byte			   *replay_data;
+static long				replay_size;
+static long				replay_pos;
+static svreplay_header_t replay_header;
+static float		   *replay_frame_ms;
+static double			replay_saved_realtime;
+
+/*
+====================
+SV_RecordWrite
+====================
+*/
+static void SV_RecordWrite (svreplay_event_type_t type, int slot, const void *payload, size_t size)
+{
+	svreplay_event_t event;
+
+	memset (&event, 0, sizeof (event));
+	event.type = type;
+	event.slot = slot;
+	event.size = size;
+	fwrite (&event, sizeof (event), 1, record_file);
+	if (size)
+		fwrite (payload, size, 1, record_file);
+}
+
+/*
+====================
+SV_RecordConnection
+====================
+*/
+static void SV_RecordConnection (struct qsocket_s *sock, svreplay_connect_t *connection)
+{
+	connection->local = !strcmp (NET_QSocketGetTrueAddressString (sock), "LOCAL");
+	connection->proquake_angle_hack = NET_QSocketGetProQuakeAngleHack (sock);
+}
+
+/*
+====================
+SV_RecordStart
+
+Writes the header and the clients that stay connected through the level change
+====================
+*/
+static void SV_RecordStart (const char *mapname, uint64_t seed)
+{
+	svreplay_header_t header;
+	svreplay_carry_t  carry;
+	client_t		 *client;
+	int				  i;
+
+	record_file = fopen (record_name, "wb");
+	if (!record_file)
+	{
+		Con_Printf ("sv_record: couldn't create %s\n", record_name);
+		return;
+	}
+	record_frames = 0;
+
+	memset (&header, 0, sizeof (header));
+	header.magic = SVREPLAY_MAGIC;
+	header.version = SVREPLAY_VERSION;
+	header.seed = seed;
+	header.maxclients = svs.maxclients;
+	header.serverflags = svs.serverflags;
+	header.skill = skill.value;
+	header.coop = coop.value;
+	header.deathmatch = deathmatch.value;
+	header.teamplay = teamplay.value;
+	q_strlcpy (header.mapname, mapname, sizeof (header.mapname));
+	fwrite (&header, sizeof (header), 1, record_file);
+
+	for (i = 0, client = svs.clients; i < svs.maxclients; i++, client++)
+	{
+		if (!client->active || !client->netconnection)
+			continue; // bots are spawned again by the qc
+		memset (&carry, 0, sizeof (carry));
+		SV_RecordConnection (client->netconnection, &carry.connection);
+		q_strlcpy (carry.name, client->name, sizeof (carry.name));
+		carry.colors = client->colors;
+		memcpy (carry.spawn_parms, client->spawn_parms, sizeof (carry.spawn_parms));
+		carry.pextknown = client->pextknown;
+		carry.protocol_pext1 = client->protocol_pext1;
+		carry.protocol_pext2 = client->protocol_pext2;
+		SV_RecordWrite (SVREPLAY_CARRY, i, &carry, sizeof (carry));
+	}
+
+	Con_Printf ("Recording server session on %s to %s\n", mapname, record_name);
+}
+
+/*
+====================
+SV_RecordStop
+====================
+*/
+static void SV_RecordStop (void)
+{
+	if (!record_file)
+		return;
+	fclose (record_file);
+	record_file = NULL;
+	Con_Printf ("Stopped server recording, %d frames\n", record_frames);
+}
+
+/*
+====================
+SV_RecordFrame
+
+Called at the start of each server frame
+====================
+*/
+void SV_RecordFrame (void)
+{
+	svreplay_frame_t frame;
+
+	if (!record_file)
+		return;
+	frame.frametime = host_frametime;
+	frame.realtime = realtime;
+	SV_RecordWrite (SVREPLAY_FRAME, 0, &frame, sizeof (frame));
+	record_frames++;
+}
+
+/*
+====================
+SV_RecordConnect
+====================
+*/
+void SV_RecordConnect (int clientnum)
+{
+	svreplay_connect_t connection;
+
+	if (!record_file)
+		return;
+	SV_RecordConnection (svs.clients[clientnum].netconnection, &connection);
+	SV_RecordWrite (SVREPLAY_CONNECT, clientnum, &connection, sizeof (connection));
+}
+
+/*
+====================
+SV_RecordMessage
+
+Saves net_message as the server is about to read it for the given client
+====================
+*/
+void SV_RecordMessage (int clientnum)
+{
+	if (record_file)
+		SV_RecordWrite (SVREPLAY_MESSAGE, clientnum, net_message.data, net_message.cursize);
+}
+
+/*
+====================
+SV_RecordDrop
+====================
+*/
+void SV_RecordDrop (int clientnum)
+{
+	if (record_file && svs.clients[clientnum].netconnection)
+		SV_RecordWrite (SVREPLAY_DROP, clientnum, NULL, 0);
+}
+
+/*
+====================
+SV_ReplayPeek
+
+Returns the type of the next event or 0 at the end of the recording
+====================
+*/
+static int SV_ReplayPeek (void)
+{
+	if (replay_pos + (long)sizeof (svreplay_event_t) > replay_size)
+		return 0;
+	return ((const svreplay_event_t *)(replay_data + replay_pos))->type;
+}
+
+/*
+====================
+SV_ReplayNext
+
+Returns the payload of the next event, NULL if the recording is truncated (and ends it)
+====================
+*/
+static const byte *SV_ReplayNext (svreplay_event_t *event)
+{
+	const byte *payload;
+
+	if (replay_pos + (long)sizeof (*event) > replay_size)
+		return NULL;
+	memcpy (event, replay_data + replay_pos, sizeof (*event));
+	if (event->size > (uint32_t)(replay_size - replay_pos - sizeof (*event)))
+	{
+		replay_pos = replay_size;
+		return NULL;
+	}
+	payload = replay_data + replay_pos + sizeof (*event);
+	replay_pos += sizeof (*event) + event->size;
+	return payload;
+}
+
+/*
+====================
+SV_ReplayCarry
+
+Sets up a client that was connected before the recorded level, the spawn will send it the serverinfo
+====================
+*/
+static void SV_ReplayCarry (int clientnum, const svreplay_carry_t *carry)
+{
+	client_t *client = svs.clients + clientnum;
+
+	memset (client, 0, sizeof (*client));
+	client->netconnection = NET_NewReplaySocket (carry->connection.local, carry->connection.proquake_angle_hack);
+	if (!client->netconnection)
+		return;
+	net_activeconnections++;
+
+	client->active = true;
+	client->message.data = client->msgbuf;
+	client->message.maxsize = sizeof (client->msgbuf);
+	client->message.allowoverflow = true;
+	client->datagram.data = client->datagram_buf;
+	client->datagram.maxsize = sizeof (client->datagram_buf);
+	client->datagram.allowoverflow = true;
+
+	q_strlcpy (client->name, carry->name, sizeof (client->name));
+	client->colors = carry->colors;
+	memcpy (client->spawn_parms, carry->spawn_parms, sizeof (client->spawn_parms));
+	client->pextknown = carry->pextknown;
+	client->protocol_pext1 = carry->protocol_pext1;
+	client->protocol_pext2 = carry->protocol_pext2;
+}
+
+/*
+====================
+SV_ReplaySpawn
+
+Called by SV_SpawnServer before the level is loaded. Seeds the random numbers so the level spawns
+the same way as when it was recorded, and starts or stops a recording.
+====================
+*/
+void SV_ReplaySpawn (const char *mapname)
+{
+	svreplay_event_t event;
+	svreplay_carry_t carry;
+	const byte		*payload;
+	uint64_t		 seed;
+
+	if (sv_replaying)
+	{
+		COM_SeedRand (replay_header.seed);
+		while (SV_ReplayPeek () == SVREPLAY_CARRY)
+		{
+			payload = SV_ReplayNext (&event);
+			if (!payload || event.size != sizeof (carry) || event.slot >= svs.maxclients)
+				continue;
+			memcpy (&carry, payload, sizeof (carry)); // payloads aren't aligned
+			SV_ReplayCarry (event.slot, &carry);
+		}
+		return;
+	}
+
+	SV_RecordStop ();
+	if (!record_armed)
+		return;
+
+	record_armed = false;
+	seed = ((uint64_t)time (NULL) << 20) ^ (uint64_t)(Sys_DoubleTime () * 1000000.0);
+	COM_SeedRand (seed);
+	SV_RecordStart (mapname, seed);
+}
+
+/*
+====================
+SV_ReplayEvents
+
+Replaces reading the network in SV_RunClients, feeds the server the connects, messages and drops
+recorded for the current frame
+====================
+*/
+void SV_ReplayEvents (void)
+{
+	svreplay_event_t event;
+	const byte		*payload;
+	client_t		*client;
+	int				 type;
+
+	while ((type = SV_ReplayPeek ()) && type != SVREPLAY_FRAME)
+	{
+		payload = SV_ReplayNext (&event);
+		if (!payload)
+			break;
+		if (event.slot >= svs.maxclients)
+			continue;
+		client = svs.clients + event.slot;
+
+		switch (event.type)
+		{
+		case SVREPLAY_CONNECT:
+			if (client->active || event.size != sizeof (svreplay_connect_t))
+				break;
+			client->netconnection =
+				NET_NewReplaySocket (((const svreplay_connect_t *)payload)->local, ((const svreplay_connect_t *)payload)->proquake_angle_hack);
+			if (client->netconnection)
+				SV_ConnectClient (event.slot);
+			break;
+
+		case SVREPLAY_MESSAGE:
+			if (!client->active || !client->netconnection || event.size > (uint32_t)net_message.maxsize)
+				break;
+			SZ_Clear (&net_message);
+			SZ_Write (&net_message, payload, event.size);
+			host_client = client;
+			sv_player = client->edict;
+			if (!SV_ReadClientMessage ())
+				SV_DropClient (false);
+			break;
+
+		case SVREPLAY_DROP:
+			if (!client->active || !client->netconnection)
+				break;
+			host_client = client;
+			SV_DropClient (false);
+			break;
+
+		default:
+			break;
+		}
+	}
+}
+
+/*
+====================
+SV_ReplayShutdown
+
+Called by Host_ShutdownServer, also when a replay is aborted by a Host_Error
+====================
+*/
+void SV_ReplayShutdown (void)
+{
+	SV_RecordStop ();
+	if (!sv_replaying)
+		return;
+	sv_replaying = false;
+	realtime = replay_saved_realtime;
+	Mem_Free (replay_data);
+	replay_data = NULL;
+	replay_size = replay_pos = 0;
+	VEC_FREE (replay_frame_ms);
+}
+
+static int SV_ReplayCompare (const void *a, const void *b)
+{
+	const float fa = *(const float *)a;
+	const float fb = *(const float *)b;
+	return (fa > fb) - (fa < fb);
+}
+
+/*
+====================
+SV_ReplayPercentile
+
+Nearest-rank percentile of a sorted array
+====================
+*/
+static float SV_ReplayPercentile (const float *sorted, int count, int percentile)
+{
+	const int rank = (count * percentile + 99) / 100;
+	return sorted[CLAMP (0, rank - 1, count - 1)];
+}
+
+/*
+====================
+SV_ReplayReport
+====================
+*/
+static void SV_ReplayReport (double seconds)
+{
+	const int count = VEC_SIZE (replay_frame_ms);
+	double	  sum = 0.0;
+	int		  i;
+
+	if (count == 0)
+	{
+		Con_Printf ("sv_replay: no frames replayed\n");
+		return;
+	}
+
+	for (i = 0; i < count; i++)
+		sum += replay_frame_ms[i];
+	qsort (replay_frame_ms, count, sizeof (float), SV_ReplayCompare);
+
+	Con_Printf ("%i server frames in %.3f seconds (%.1f fps)\n", count, seconds, count / q_max (seconds, 0.001));
+	Con_Printf ("%-13s %8s %8s %8s %8s %8s\n", "ms", "avg", "p50", "p95", "p99", "max");
+	Con_Printf (
+		"%-13s %8.3f %8.3f %8.3f %8.3f %8.3f\n", "frame", sum / count, SV_ReplayPercentile (replay_frame_ms, count, 50),
+		SV_ReplayPercentile (replay_frame_ms, count, 95), SV_ReplayPercentile (replay_frame_ms, count, 99), replay_frame_ms[count - 1]);
+}
+
+/*
+====================
+SV_Record_f
+====================
+*/
+static void SV_Record_f (void)
+{
+	if (cmd_source != src_command)
+		return;
+
+	if (Cmd_Argc () == 1)
+	{
+		if (record_file)
+			SV_RecordStop ();
+		else if (record_armed)
+		{
+			record_armed = false;
+			Con_Printf ("sv_record: cancelled\n");
+		}
+		else
+			Con_Printf ("sv_record <name> : records the server session from the next level load to <name>.svr\n");
+		return;
+	}
+	if (Cmd_Argc () != 2 || strstr (Cmd_Argv (1), ".."))
+	{
+		Con_Printf ("usage: sv_record [name]\n");
+		return;
+	}
+	if (sv_replaying)
+	{
+		Con_Printf ("sv_record: can't record while replaying\n");
+		return;
+	}
+
+	q_snprintf (record_name, sizeof (record_name), "%s/%s", com_gamedir, Cmd_Argv (1));
+	COM_AddExtension (record_name, ".svr", sizeof (record_name));
+	record_armed = true;
+	Con_Printf ("Server recording starts when the next level is loaded\n");
+}
+
+/*
+====================
+SV_Replay_f
+
+Loads the recorded level and runs all its server frames back to back with the recorded
+client input. The server's output goes nowhere, no network clients are accepted meanwhile.
+====================
+*/
+static void SV_Replay_f (void)
+{
+	char			 name[MAX_OSPATH];
+	svreplay_event_t event;
+	const byte		*payload;
+	double			 start, frame_start, seconds;
+	float			 ms;
+
+	if (cmd_source != src_command)
+		return;
+
+	if (Cmd_Argc () != 2 || strstr (Cmd_Argv (1), ".."))
+	{
+		Con_Printf ("sv_replay <name> : replays <name>.svr as fast as possible and prints server frame times\n");
+		return;
+	}
+	if (record_file || record_armed)
+	{
+		Con_Printf ("sv_replay: stop sv_record first\n");
+		return;
+	}
+
+	CL_Disconnect ();
+	Host_ShutdownServer (false);
+
+	q_snprintf (name, sizeof (name), "%s/%s", com_gamedir, Cmd_Argv (1));
+	COM_AddExtension (name, ".svr", sizeof (name));
+	replay_data = COM_LoadMallocFile_OSPath (name, &replay_size);
+	if (!replay_data)
+	{
+		Con_Printf ("sv_replay: couldn't open %s\n", name);
+		return;
+	}
+	if (replay_size < (long)sizeof (replay_header))
+		memset (&replay_header, 0, sizeof (replay_header));
+	else
+		memcpy (&replay_header, replay_data, sizeof (replay_header));
+	if (replay_header.magic != SVREPLAY_MAGIC || replay_header.version != SVREPLAY_VERSION)
+	{
+		Con_Printf ("sv_replay: %s is not a version %d server recording\n", name, SVREPLAY_VERSION);
+		Mem_Free (replay_data);
+		replay_data = NULL;
+		return;
+	}
+	if (replay_header.maxclients < 1 || replay_header.maxclients > svs.maxclientslimit)
+	{
+		Con_Printf ("sv_replay: %s needs %d player slots, only %d available\n", name, replay_header.maxclients, svs.maxclientslimit);
+		Mem_Free (replay_data);
+		replay_data = NULL;
+		return;
+	}
+	replay_header.mapname[sizeof (replay_header.mapname) - 1] = 0;
+	replay_pos = sizeof (replay_header);
+	replay_saved_realtime = realtime;
+	sv_replaying = true;
+
+	svs.maxclients = replay_header.maxclients;
+	svs.serverflags = replay_header.serverflags;
+	Cvar_SetValue ("skill", replay_header.skill);
+	Cvar_SetValue ("coop", replay_header.coop);
+	Cvar_SetValue ("deathmatch", replay_header.deathmatch);
+	Cvar_SetValue ("teamplay", replay_header.teamplay);
+	key_dest = key_game; // single player servers pause otherwise
+
+	PR_SwitchQCVM (&sv.qcvm);
+	SV_SpawnServer (replay_header.mapname);
+	PR_SwitchQCVM (NULL);
+
+	Con_Printf ("Replaying %s on %s\n", name, replay_header.mapname);
+	start = Sys_DoubleTime ();
+	while (sv_replaying && sv.active && SV_ReplayPeek () == SVREPLAY_FRAME)
+	{
+		svreplay_frame_t frame;
+		mem_frame_mark_t mark;
+
+		payload = SV_ReplayNext (&event);
+		if (!payload || event.size != sizeof (frame))
+			break;
+		memcpy (&frame, payload, sizeof (frame));
+		host_frametime = frame.frametime;
+		realtime = frame.realtime;
+
+		mark = Mem_FrameMark ();
+		frame_start = Sys_DoubleTime ();
+		PR_SwitchQCVM (&sv.qcvm);
+		Host_ServerFrame ();
+		PR_SwitchQCVM (NULL);
+		ms = (Sys_DoubleTime () - frame_start) * 1000.0;
+		Mem_FrameRelease (mark);
+		VEC_PUSH (replay_frame_ms, ms);
+	}
+	seconds = Sys_DoubleTime () - start;
+
+	if (sv_replaying)
+		SV_ReplayReport (seconds);
+	Host_ShutdownServer (false); // also ends the replay
+}
+
+/*
+====================
+SV_Replay_Init
+====================
+*/
+void SV_Replay_Init (void)
+{
+	Cmd_AddCommand ("sv_record", SV_Record_f);
+	Cmd_AddCommand ("sv_replay", SV_Replay_f);
+}
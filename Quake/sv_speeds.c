@@ -0,0 +1,305 @@
+/*
+Copyright (C) 2026 vkQuake developers
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+// sv_speeds.c -- server frame profiler
+
+#include "quakedef.h"
+
+#include <time.h>
+
+#define SVSPEEDS_HISTORY	  128
+#define SVSPEEDS_MAX_DEPTH	  8
+#define MAX_SVSPEEDS_EVENTS	  (256 * 1024)
+#define SVSPEEDS_PRINT_PERIOD 1.0
+
+typedef struct
+{
+	uint64_t begin;
+	uint64_t end;
+	uint32_t frame;
+	int		 phase;
+} svspeeds_event_t;
+
+cvar_t sv_speeds = {"sv_speeds", "0", CVAR_NONE}; // print rolling server frame times once a second
+
+qboolean sv_speeds_active;
+
+static const char *phase_names[NUM_SVSPEEDS] = {"net", "clients", "qc", "physics", "snapshots", "send"};
+
+static int		phase_stack[SVSPEEDS_MAX_DEPTH];
+static int		phase_depth;
+static uint64_t phase_begin;
+static uint64_t frame_ticks[NUM_SVSPEEDS];
+static double	history[SVSPEEDS_HISTORY][NUM_SVSPEEDS + 1]; // ms, the last column is the frame total
+static int		history_count;
+static int		history_pos;
+static double	last_print;
+
+static svspeeds_event_t *trace_events;
+static int				 trace_num_events;
+static int				 trace_dropped_events;
+static uint32_t			 trace_frame;
+static int				 trace_remaining_frames;
+static uint64_t			 trace_start_counter;
+
+/*
+====================
+SV_SpeedsAccount
+
+Charges the time since the last phase change to the innermost phase
+====================
+*/
+static void SV_SpeedsAccount (uint64_t now)
+{
+	int phase;
+
+	if (phase_depth <= 0)
+		return;
+	phase = phase_stack[q_min (phase_depth, SVSPEEDS_MAX_DEPTH) - 1];
+	frame_ticks[phase] += now - phase_begin;
+	if (trace_remaining_frames > 0 && now > phase_begin)
+	{
+		if (trace_num_events < MAX_SVSPEEDS_EVENTS)
+		{
+			svspeeds_event_t *event = &trace_events[trace_num_events++];
+			event->begin = phase_begin;
+			event->end = now;
+			event->frame = trace_frame;
+			event->phase = phase;
+		}
+		else
+			trace_dropped_events++;
+	}
+}
+
+/*
+====================
+SV_SpeedsBegin
+
+Phases nest, time spent in an inner phase is not counted for the outer one
+====================
+*/
+void SV_SpeedsBegin (svspeeds_phase_t phase)
+{
+	uint64_t now;
+
+	if (!sv_speeds_active)
+		return;
+	now = SDL_GetPerformanceCounter ();
+	SV_SpeedsAccount (now);
+	if (phase_depth < SVSPEEDS_MAX_DEPTH)
+		phase_stack[phase_depth] = phase;
+	phase_depth++;
+	phase_begin = now;
+}
+
+/*
+====================
+SV_SpeedsEnd
+====================
+*/
+void SV_SpeedsEnd (void)
+{
+	uint64_t now;
+
+	if (!sv_speeds_active || phase_depth <= 0)
+		return;
+	now = SDL_GetPerformanceCounter ();
+	SV_SpeedsAccount (now);
+	phase_depth--;
+	phase_begin = now;
+}
+
+/*
+====================
+SV_SpeedsWriteTrace
+
+Same Chrome trace event format as tasks_trace, so both can be loaded by chrome://tracing or https://ui.perfetto.dev
+====================
+*/
+static void SV_SpeedsWriteTrace (void)
+{
+	const double us_per_tick = 1000000.0 / (double)SDL_GetPerformanceFrequency ();
+	time_t		 now;
+	struct tm	*lt;
+	char		 tracename[MAX_OSPATH];
+	FILE		*f;
+	int			 i;
+
+	time (&now);
+	lt = localtime (&now);
+	q_snprintf (
+		tracename, sizeof (tracename), "%s/sv_trace-%04d%02d%02d-%02d%02d%02d.json", com_gamedir, lt->tm_year + 1900, lt->tm_mon + 1, lt->tm_mday,
+		lt->tm_hour, lt->tm_min, lt->tm_sec);
+
+	f = fopen (tracename, "w");
+	if (!f)
+	{
+		Con_Printf ("SV_SpeedsWriteTrace: Couldn't create %s\n", tracename);
+		return;
+	}
+
+	fprintf (f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	fprintf (f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,\"args\":{\"name\":\"Server_Frame\"}},\n");
+	for (i = 0; i < trace_num_events; ++i)
+	{
+		const svspeeds_event_t *event = &trace_events[i];
+		const double			ts = (double)(event->begin - trace_start_counter) * us_per_tick;
+		const double			dur = (double)(event->end - event->begin) * us_per_tick;
+		fprintf (
+			f, "{\"name\":\"%s\",\"cat\":\"server\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%u}},\n",
+			phase_names[event->phase], ts, dur, event->frame);
+	}
+	// Terminate with a metadata event so the list needs no trailing comma handling
+	fprintf (f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"vkQuake\"}}\n]}\n");
+	fclose (f);
+
+	Con_Printf ("Wrote %s (%d events", tracename, trace_num_events);
+	if (trace_dropped_events)
+		Con_Printf (", %d dropped", trace_dropped_events);
+	Con_Printf (")\n");
+}
+
+/*
+====================
+SV_SpeedsPrint
+====================
+*/
+static void SV_SpeedsPrint (void)
+{
+	double avg[NUM_SVSPEEDS + 1];
+	double worst[NUM_SVSPEEDS + 1];
+	int	   i, j;
+
+	if (!history_count)
+		return;
+	for (j = 0; j <= NUM_SVSPEEDS; j++)
+	{
+		avg[j] = 0.0;
+		worst[j] = 0.0;
+		for (i = 0; i < history_count; i++)
+		{
+			avg[j] += history[i][j];
+			worst[j] = q_max (worst[j], history[i][j]);
+		}
+		avg[j] /= history_count;
+	}
+
+	Con_Printf ("sv_speeds (avg/worst ms over %d frames):", history_count);
+	for (j = 0; j < NUM_SVSPEEDS; j++)
+		Con_Printf (" %s %.2f/%.2f", phase_names[j], avg[j], worst[j]);
+	Con_Printf (" total %.2f/%.2f\n", avg[NUM_SVSPEEDS], worst[NUM_SVSPEEDS]);
+}
+
+/*
+====================
+SV_SpeedsFrame
+
+Called after every server frame, decides whether the next one is measured
+====================
+*/
+void SV_SpeedsFrame (void)
+{
+	const double ms_per_tick = 1000.0 / (double)SDL_GetPerformanceFrequency ();
+	double		*frame;
+	int			 i;
+
+	if (sv_speeds_active)
+	{
+		frame = history[history_pos];
+		frame[NUM_SVSPEEDS] = 0.0;
+		for (i = 0; i < NUM_SVSPEEDS; i++)
+		{
+			frame[i] = (double)frame_ticks[i] * ms_per_tick;
+			frame[NUM_SVSPEEDS] += frame[i];
+		}
+		history_pos = (history_pos + 1) % SVSPEEDS_HISTORY;
+		history_count = q_min (history_count + 1, SVSPEEDS_HISTORY);
+	}
+	memset (frame_ticks, 0, sizeof (frame_ticks));
+	phase_depth = 0; // a Host_Error can leave phases open
+
+	if (trace_remaining_frames > 0)
+	{
+		trace_frame++;
+		if (--trace_remaining_frames == 0)
+		{
+			SV_SpeedsWriteTrace ();
+			Mem_Free (trace_events);
+			trace_events = NULL;
+		}
+	}
+
+	if (sv_speeds.value && realtime - last_print >= SVSPEEDS_PRINT_PERIOD)
+	{
+		SV_SpeedsPrint ();
+		last_print = realtime;
+	}
+
+	if (!sv_speeds.value && !trace_remaining_frames)
+		history_count = history_pos = 0;
+	sv_speeds_active = sv_speeds.value || trace_remaining_frames > 0;
+}
+
+/*
+====================
+SV_SpeedsTrace_f
+====================
+*/
+static void SV_SpeedsTrace_f (void)
+{
+	int frames;
+
+	if (Cmd_Argc () != 2)
+	{
+		Con_Printf ("usage: sv_speeds_trace <frames>\n");
+		return;
+	}
+	if (trace_remaining_frames > 0)
+	{
+		Con_Printf ("sv_speeds_trace: already recording\n");
+		return;
+	}
+	frames = atoi (Cmd_Argv (1));
+	if (frames <= 0)
+	{
+		Con_Printf ("sv_speeds_trace: frame count must be positive\n");
+		return;
+	}
+
+	trace_events = (svspeeds_event_t *)Mem_Alloc (sizeof (svspeeds_event_t) * MAX_SVSPEEDS_EVENTS);
+	trace_num_events = 0;
+	trace_dropped_events = 0;
+	trace_frame = 0;
+	trace_remaining_frames = frames;
+	trace_start_counter = SDL_GetPerformanceCounter ();
+	sv_speeds_active = true;
+	Con_Printf ("Recording server trace for %d frames\n", frames);
+}
+
+/*
+====================
+SV_Speeds_Init
+====================
+*/
+void SV_Speeds_Init (void)
+{
+	Cvar_RegisterVariable (&sv_speeds);
+	Cmd_AddCommand ("sv_speeds_trace", SV_SpeedsTrace_f);
+}
@@ -42,6 +42,19 @@ static usercmd_t cmd;
 
 cvar_t sv_idealpitchscale = {"sv_idealpitchscale", "0.8", CVAR_NONE};
 cvar_t sv_altnoclip = {"sv_altnoclip", "1", CVAR_ARCHIVE}; // johnfitz
+cvar_t sv_batchmessages = {"sv_batchmessages", "0", CVAR_NONE}; // read the network for all clients before parsing their messages
+
+// A client message read from the network by SV_ReceiveClientMessages, parsed later in the frame
+typedef struct
+{
+	int	   clientnum;
+	int	   offset; // into sv_queued_data
+	int	   size;
+	double packetage;
+} sv_queued_message_t;
+
+static sv_queued_message_t *sv_queued_messages;
+static byte				   *sv_queued_data;
 
 /*
 ===============
@@ -456,8 +469,8 @@ void SV_ReadClientMove (usercmd_t *move)
 	else
 		sequence = 0;
 
-	// read ping time
-	host_client->ping_times[host_client->num_pings % NUM_PING_TIMES] = qcvm->time - MSG_ReadFloat ();
+	// read ping time, not counting how long the packet waited for this frame
+	host_client->ping_times[host_client->num_pings % NUM_PING_TIMES] = qcvm->time - MSG_ReadFloat () - NET_PacketAge ();
 	host_client->num_pings++;
 
 	for (i = 0; i < 3; i++)
@@ -570,6 +583,75 @@ qboolean SV_ReadClientMessage (void)
 	return true;
 }
 
+/*
+==================
+SV_ReceiveClientMessages
+
+sv_batchmessages: drains the network first and keeps the messages, then parses them
+client by client in slot order, each client's in the order they arrived. The socket
+reads aren't interleaved with the string commands and QC the messages run anymore.
+The messages still have to be parsed one at a time, they share net_message and
+host_client and can execute QC.
+==================
+*/
+static void SV_ReceiveClientMessages (void)
+{
+	int					 i;
+	size_t				 j;
+	sv_queued_message_t	 message;
+	sv_queued_message_t *queued;
+
+	VEC_CLEAR (sv_queued_messages);
+	VEC_CLEAR (sv_queued_data);
+
+	SV_SpeedsBegin (SVSPEEDS_NET);
+	for (;;)
+	{
+		struct qsocket_s *sock = NET_GetServerMessage ();
+		if (!sock)
+			break; // no more this frame
+
+		for (i = 0; i < svs.maxclients; i++)
+		{
+			if (svs.clients[i].netconnection == sock)
+				break;
+		}
+		if (i == svs.maxclients)
+			continue;
+
+		message.clientnum = i;
+		message.offset = (int)VEC_SIZE (sv_queued_data);
+		message.size = net_message.cursize;
+		message.packetage = NET_PacketAge ();
+		Vec_Append ((void **)&sv_queued_data, 1, net_message.data, net_message.cursize);
+		VEC_PUSH (sv_queued_messages, message);
+	}
+	SV_SpeedsEnd ();
+
+	for (i = 0, host_client = svs.clients; i < svs.maxclients; i++, host_client++)
+	{
+		for (j = 0; j < VEC_SIZE (sv_queued_messages); j++)
+		{
+			queued = &sv_queued_messages[j];
+			if (queued->clientnum != i)
+				continue;
+			if (!host_client->active || !host_client->netconnection)
+				break; // dropped by an earlier message
+
+			SZ_Clear (&net_message);
+			SZ_Write (&net_message, sv_queued_data + queued->offset, queued->size);
+			NET_SetPacketAge (queued->packetage);
+			sv_player = host_client->edict;
+			SV_RecordMessage (i);
+			if (!SV_ReadClientMessage ())
+			{
+				SV_DropClient (false); // client misbehaved...
+				break;
+			}
+		}
+	}
+}
+
 /*
 ==================
 SV_RunClients
@@ -583,9 +665,15 @@ void SV_RunClients (void)
 	// Spike -- reworked this to query the network code for an active connection.
 	// this allows the network code to serve multiple clients with the same listening port.
 	// this solves server-side nats, which is important for coop etc.
-	while (1)
+	if (sv_replaying)
+		SV_ReplayEvents ();
+	else if (sv_batchmessages.value)
+		SV_ReceiveClientMessages ();
+	while (!sv_replaying && !sv_batchmessages.value)
 	{
+		SV_SpeedsBegin (SVSPEEDS_NET);
 		struct qsocket_s *sock = NET_GetServerMessage ();
+		SV_SpeedsEnd ();
 		if (!sock)
 			break; // no more this frame
 
@@ -594,6 +682,7 @@ void SV_RunClients (void)
 			if (host_client->netconnection == sock)
 			{
 				sv_player = host_client->edict;
+				SV_RecordMessage (i);
 				if (!SV_ReadClientMessage ())
 				{
 					SV_DropClient (false); // client misbehaved...
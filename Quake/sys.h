@@ -41,6 +41,19 @@ qfileofs_t Sys_filelength (FILE *f);
 qfileofs_t Sys_FileOpenRead (const char *path, int *hndl);
 
 void Sys_MemFileOpenRead (const byte *memory, int size, int *hndl);
+// Same, but memory was allocated with Mem_Alloc and is freed when the handle is closed
+void Sys_MemFileOpenReadOwned (byte *memory, int size, int *hndl);
+
+// Maps a whole file into memory with copy-on-write pages.
+// Returns NULL if the file is not present or can't be mapped.
+const byte *Sys_FileMap (const char *path, int *size);
+void		Sys_FileUnmap (const byte *memory, int size);
+
+// Reserves address space without backing it with memory. Ranges of it are committed on
+// demand and read as zero until written. Returns NULL if the space can't be reserved.
+byte	*Sys_MemReserve (size_t size);
+qboolean Sys_MemCommit (byte *memory, size_t size);
+void	 Sys_MemRelease (byte *memory, size_t size);
 
 // Returns a file handle
 int Sys_FileOpenWrite (const char *path);
@@ -30,6 +30,7 @@ typedef struct file_handle_s
 {
 	FILE	   *file;
 	const byte *memory;
+	qboolean	owned; // memory is freed on close
 	int			pos;
 	int			size;
 } file_handle_t;
@@ -90,11 +91,18 @@ void Sys_MemFileOpenRead (const byte *memory, int size, int *hndl)
 	int i = findhandle ();
 
 	sys_handles[i].memory = memory;
+	sys_handles[i].owned = false;
 	sys_handles[i].size = size;
 	sys_handles[i].pos = 0;
 	*hndl = i;
 }
 
+void Sys_MemFileOpenReadOwned (byte *memory, int size, int *hndl)
+{
+	Sys_MemFileOpenRead (memory, size, hndl);
+	sys_handles[*hndl].owned = true;
+}
+
 int Sys_FileOpenWrite (const char *path)
 {
 	FILE *f;
@@ -118,7 +126,11 @@ void Sys_FileClose (int handle)
 		sys_handles[handle].file = NULL;
 	}
 	else
+	{
+		if (sys_handles[handle].owned)
+			Mem_Free (sys_handles[handle].memory);
 		sys_handles[handle].memory = NULL;
+	}
 }
 
 void Sys_FileSeek (int handle, int position)
@@ -135,6 +147,7 @@ int Sys_FileRead (int handle, void *dest, int count)
 		return fread (dest, 1, count, sys_handles[handle].file);
 	else
 	{
+		count = CLAMP (0, count, sys_handles[handle].size - sys_handles[handle].pos);
 		memcpy (dest, sys_handles[handle].memory + sys_handles[handle].pos, count);
 		sys_handles[handle].pos += count;
 		return count;
@@ -33,6 +33,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #endif
 #include <sys/stat.h>
 #include <sys/time.h>
+#include <sys/mman.h>
 #include <fcntl.h>
 #ifdef DO_USERDIRS
 #include <pwd.h>
@@ -72,6 +73,52 @@ int Sys_FileType (const char *path)
 	return FS_ENT_NONE;
 }
 
+const byte *Sys_FileMap (const char *path, int *size)
+{
+	struct stat st;
+	void	   *memory;
+	int			fd = open (path, O_RDONLY);
+
+	if (fd == -1)
+		return NULL;
+	if (fstat (fd, &st) != 0 || st.st_size <= 0 || st.st_size > INT_MAX)
+	{
+		close (fd);
+		return NULL;
+	}
+
+	// private mapping: loaders that byte swap in place only touch their own pages
+	memory = mmap (NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close (fd);
+	if (memory == MAP_FAILED)
+		return NULL;
+
+	*size = (int)st.st_size;
+	return (const byte *)memory;
+}
+
+void Sys_FileUnmap (const byte *memory, int size)
+{
+	munmap ((void *)memory, (size_t)size);
+}
+
+byte *Sys_MemReserve (size_t size)
+{
+	void *memory = mmap (NULL, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	return (memory != MAP_FAILED) ? (byte *)memory : NULL;
+}
+
+qboolean Sys_MemCommit (byte *memory, size_t size)
+{
+	// anonymous pages only take memory once they are first touched
+	return mprotect (memory, size, PROT_READ | PROT_WRITE) == 0;
+}
+
+void Sys_MemRelease (byte *memory, size_t size)
+{
+	munmap (memory, size);
+}
+
 static char cwd[MAX_OSPATH];
 #ifdef DO_USERDIRS
 static char userdir[MAX_OSPATH];
@@ -261,6 +308,7 @@ void Sys_Error (const char *error, ...)
 	fputs (text, stderr);
 	fputs ("\n\n", stderr);
 	fflush (stderr);
+	LOG_Flush ();
 
 	/* Host_Shutdown cannot be called from worker threads - it's not thread-safe
 	 * and asserts that it's called from the main thread. If we're in a worker
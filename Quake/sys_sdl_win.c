@@ -51,6 +51,56 @@ int Sys_FileType (const char *path)
 	return FS_ENT_FILE;
 }
 
+const byte *Sys_FileMap (const char *path, int *size)
+{
+	HANDLE		  file, mapping;
+	LARGE_INTEGER file_size;
+	void		 *memory = NULL;
+
+	file = CreateFile (path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return NULL;
+	if (!GetFileSizeEx (file, &file_size) || file_size.QuadPart <= 0 || file_size.QuadPart > INT_MAX)
+	{
+		CloseHandle (file);
+		return NULL;
+	}
+
+	// copy-on-write view: loaders that byte swap in place only touch their own pages
+	mapping = CreateFileMapping (file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+	if (mapping)
+	{
+		memory = MapViewOfFile (mapping, FILE_MAP_COPY, 0, 0, 0);
+		CloseHandle (mapping);
+	}
+	CloseHandle (file);
+	if (!memory)
+		return NULL;
+
+	*size = (int)file_size.QuadPart;
+	return (const byte *)memory;
+}
+
+void Sys_FileUnmap (const byte *memory, int size)
+{
+	UnmapViewOfFile (memory);
+}
+
+byte *Sys_MemReserve (size_t size)
+{
+	return (byte *)VirtualAlloc (NULL, size, MEM_RESERVE, PAGE_NOACCESS);
+}
+
+qboolean Sys_MemCommit (byte *memory, size_t size)
+{
+	return VirtualAlloc (memory, size, MEM_COMMIT, PAGE_READWRITE) != NULL;
+}
+
+void Sys_MemRelease (byte *memory, size_t size)
+{
+	VirtualFree (memory, 0, MEM_RELEASE);
+}
+
 static HANDLE hinput, houtput;
 static char	  cwd[1024];
 static double counter_freq;
@@ -194,6 +244,7 @@ void Sys_Error (const char *error, ...)
 	fputs (errortxt2, stderr);
 	fputs (text, stderr);
 	fputs ("\n\n", stderr);
+	LOG_Flush ();
 	if (!isDedicated)
 		PL_ErrorDialog (text);
 	else
@@ -24,6 +24,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "quakedef.h"
 #include "q_ctype.h"
 
+#include <time.h>
+
 // clang-format off
 #if defined(_WIN32)
   #ifndef WIN32_LEAN_AND_MEAN
@@ -61,6 +63,14 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #define MAX_PAYLOAD_SIZE	 128
 #define WORKER_HUNK_SIZE	 (1 * 1024 * 1024)
 #define WAIT_SPIN_COUNT		 100
+#define MAX_TRACE_EVENTS	 (1u << 18)
+#define NUM_RANGE_COSTS		 64
+#define RANGE_CHUNK_TIME_NS	 50000 // Aim for ~50us of work per range chunk
+#define RANGE_COST_FRAC_BITS 4
+#define MAX_BACKGROUND_WORKERS 4
+#define HELPER_WORKER_INDEX	   (TASKS_MAX_WORKERS - 1) // worker index of a thread helping out while it joins a task
+#define MAX_FRAME_WORKERS	   (TASKS_MAX_WORKERS - MAX_BACKGROUND_WORKERS - 1)
+#define JOIN_HELP_WAIT_MS	   1 // how long a helping thread sleeps when it found nothing to do before it looks again
 
 COMPILE_TIME_ASSERT (tasks, MAX_EXECUTABLE_TASKS >= 256);
 COMPILE_TIME_ASSERT (tasks, MAX_PENDING_TASKS >= MAX_EXECUTABLE_TASKS);
@@ -70,13 +80,16 @@ typedef enum
 	TASK_TYPE_NONE,
 	TASK_TYPE_SCALAR,
 	TASK_TYPE_INDEXED,
+	TASK_TYPE_RANGE,
 } task_type_t;
 
 typedef struct
 {
 	task_type_t		task_type;
+	task_priority_t priority;
 	int				num_dependents;
 	int				indexed_limit;
+	uint32_t		range_chunk_size;
 	atomic_uint32_t remaining_workers;
 	atomic_uint32_t remaining_dependencies;
 	uint64_t		epoch;
@@ -99,16 +112,50 @@ typedef struct
 	atomic_uint32_t task_indices[1];
 } task_queue_t;
 
+// Chase-Lev work-stealing deque, one per worker. Only the owning worker
+// pushes and pops at the bottom, every other worker steals from the top.
+typedef struct
+{
+	atomic_uint32_t top;
+	uint32_t		top_padding[15]; // Pad to 64 byte cache line size
+	atomic_uint32_t bottom;
+	uint32_t		bottom_padding[15];
+	uint32_t		capacity_mask;
+	atomic_uint32_t task_indices[1];
+} task_deque_t;
+
 typedef struct
 {
 	atomic_uint32_t index;
 	uint32_t		limit;
 } task_counter_t;
 
+// Measured cost per item of range functions, in fixed point nanoseconds
+typedef struct
+{
+	void		   *func;
+	atomic_uint32_t cost;
+} task_range_cost_t;
+
+typedef struct
+{
+	void	*func;
+	uint64_t begin;
+	uint64_t end;
+	uint16_t worker_index;
+	uint16_t task_index;
+	uint32_t frame;
+} task_trace_event_t;
+
 static int					 num_workers = 0;
+static int					 num_background_workers = 0;
 static task_t				 tasks[MAX_PENDING_TASKS];
 static task_queue_t			*free_task_queue;
 static task_queue_t			*executable_task_queue;
+static task_queue_t			*background_task_queue;
+static atomic_uint32_t		 join_helper_active;
+static task_deque_t			*worker_deques[TASKS_MAX_WORKERS];
+static SDL_Semaphore		*executable_semaphore;
 static task_counter_t		*indexed_task_counters;
 static uint8_t				 steal_worker_indices[TASKS_MAX_WORKERS * 2];
 static THREAD_LOCAL qboolean is_worker = false;
@@ -116,9 +163,27 @@ static THREAD_LOCAL int		 tl_worker_index;
 
 COMPILE_TIME_ASSERT (steal_worker_indices, TASKS_MAX_WORKERS * 2 < UINT8_MAX);
 
+static task_range_cost_t range_costs[NUM_RANGE_COSTS];
+static double			 ns_per_tick;
+
+static task_trace_event_t *trace_events;
+static atomic_uint32_t	   trace_num_events;
+static atomic_uint32_t	   trace_active;
+static uint64_t			   trace_start_counter;
+static uint32_t			   trace_frame;
+static int				   trace_remaining_frames;
+static qboolean			   trace_write_pending;
+
 static int pinned_workers_core_ids[TASKS_MAX_WORKERS];
 static int num_pinned_workers = 0;
 
+#define MAX_TOPOLOGY_CPUS 64 // logical CPUs beyond this (or beyond the first processor group on Windows) are left to the OS
+
+static uint64_t frame_cpu_mask;		 // logical CPUs of the performance cores, 0 if the CPU isn't hybrid
+static uint64_t background_cpu_mask; // logical CPUs of the efficiency cores, 0 if the CPU isn't hybrid
+static int		num_performance_threads;
+static int		num_efficiency_cores;
+
 /*
 ====================
 IndexedTaskCounterIndex
@@ -275,6 +340,213 @@ static inline uint32_t TaskQueuePop (task_queue_t *queue)
 	return val;
 }
 
+/*
+====================
+TaskQueueTryPop
+====================
+*/
+static inline qboolean TaskQueueTryPop (task_queue_t *queue, uint32_t *task_index)
+{
+	if (!SDL_TryWaitSemaphore (queue->pop_semaphore))
+		return false;
+	uint32_t tail = Atomic_LoadUInt32 (&queue->tail);
+	qboolean cas_successful = false;
+	do
+	{
+		const uint32_t next = (tail + 1u) & queue->capacity_mask;
+		cas_successful = Atomic_CompareExchangeUInt32 (&queue->tail, &tail, next);
+	} while (!cas_successful);
+
+	const uint32_t shuffled_index = ShuffleIndex (tail);
+	while (Atomic_LoadUInt32 (&queue->task_indices[shuffled_index]) == 0u)
+		CPUPause ();
+
+	*task_index = Atomic_LoadUInt32 (&queue->task_indices[shuffled_index]) - 1;
+	Atomic_StoreUInt32 (&queue->task_indices[shuffled_index], 0u);
+	SDL_SignalSemaphore (queue->push_semaphore);
+	ANNOTATE_HAPPENS_AFTER (&queue->task_indices[shuffled_index]);
+
+	return true;
+}
+
+/*
+====================
+CreateTaskDeque
+====================
+*/
+static task_deque_t *CreateTaskDeque (int capacity)
+{
+	assert (capacity > 0);
+	assert ((capacity & (capacity - 1)) == 0); // Needs to be power of 2
+	task_deque_t *deque = Mem_Alloc (sizeof (task_deque_t) + (sizeof (atomic_uint32_t) * (capacity - 1)));
+	deque->capacity_mask = capacity - 1;
+	return deque;
+}
+
+/*
+====================
+TaskDequePush
+
+Only called by the owning worker
+====================
+*/
+static inline void TaskDequePush (task_deque_t *deque, uint32_t task_index)
+{
+	const uint32_t bottom = Atomic_LoadUInt32 (&deque->bottom);
+	assert ((bottom - Atomic_LoadUInt32 (&deque->top)) <= deque->capacity_mask);
+	ANNOTATE_HAPPENS_BEFORE (&deque->task_indices[bottom & deque->capacity_mask]);
+	Atomic_StoreUInt32_Relaxed (&deque->task_indices[bottom & deque->capacity_mask], task_index);
+	Atomic_StoreUInt32 (&deque->bottom, bottom + 1u);
+}
+
+/*
+====================
+TaskDequePop
+
+Only called by the owning worker, takes the most recently pushed task
+====================
+*/
+static inline qboolean TaskDequePop (task_deque_t *deque, uint32_t *task_index)
+{
+	const uint32_t bottom = Atomic_LoadUInt32 (&deque->bottom) - 1u;
+	Atomic_StoreUInt32 (&deque->bottom, bottom);
+	uint32_t top = Atomic_LoadUInt32 (&deque->top);
+	if ((int32_t)(bottom - top) < 0)
+	{
+		Atomic_StoreUInt32 (&deque->bottom, bottom + 1u);
+		return false;
+	}
+
+	*task_index = Atomic_LoadUInt32 (&deque->task_indices[bottom & deque->capacity_mask]);
+	qboolean successful = true;
+	if (bottom == top)
+	{
+		// Last element, race against thieves
+		successful = Atomic_CompareExchangeUInt32 (&deque->top, &top, top + 1u);
+		Atomic_StoreUInt32 (&deque->bottom, bottom + 1u);
+	}
+	if (successful)
+		ANNOTATE_HAPPENS_AFTER (&deque->task_indices[bottom & deque->capacity_mask]);
+	return successful;
+}
+
+/*
+====================
+TaskDequeSteal
+
+Called by any other worker, takes the oldest task
+====================
+*/
+static inline qboolean TaskDequeSteal (task_deque_t *deque, uint32_t *task_index)
+{
+	uint32_t	   top = Atomic_LoadUInt32 (&deque->top);
+	const uint32_t bottom = Atomic_LoadUInt32 (&deque->bottom);
+	if ((int32_t)(bottom - top) <= 0)
+		return false;
+
+	*task_index = Atomic_LoadUInt32 (&deque->task_indices[top & deque->capacity_mask]);
+	if (!Atomic_CompareExchangeUInt32 (&deque->top, &top, top + 1u))
+		return false;
+	ANNOTATE_HAPPENS_AFTER (&deque->task_indices[top & deque->capacity_mask]);
+	return true;
+}
+
+/*
+====================
+Task_FindExecutable
+
+Every executable task is accounted for in executable_semaphore, so once a
+worker acquired it there is guaranteed to be a task left for it somewhere:
+its own deque, the shared queue fed by non-worker threads or a deque of
+another worker.
+====================
+*/
+static uint32_t Task_FindExecutable (int worker_index)
+{
+	SpinWaitSemaphore (executable_semaphore);
+	uint32_t task_index = 0;
+	while (true)
+	{
+		if (TaskDequePop (worker_deques[worker_index], &task_index))
+			return task_index;
+		if (TaskQueueTryPop (executable_task_queue, &task_index))
+			return task_index;
+		for (int i = 1; i < num_workers; ++i)
+		{
+			const int steal_worker_index = steal_worker_indices[worker_index + i];
+			if (TaskDequeSteal (worker_deques[steal_worker_index], &task_index))
+				return task_index;
+		}
+		CPUPause ();
+	}
+}
+
+/*
+====================
+Task_TryFindExecutable
+
+Non-blocking variant for a thread that joins a task, it only ever takes
+tasks from the shared queue or steals them from the workers
+====================
+*/
+static qboolean Task_TryFindExecutable (uint32_t *task_index)
+{
+	if (!SDL_TryWaitSemaphore (executable_semaphore))
+		return false;
+	while (true)
+	{
+		if (TaskQueueTryPop (executable_task_queue, task_index))
+			return true;
+		for (int i = 0; i < num_workers; ++i)
+		{
+			if (TaskDequeSteal (worker_deques[i], task_index))
+				return true;
+		}
+		CPUPause ();
+	}
+}
+
+/*
+====================
+Task_PushExecutable
+====================
+*/
+static void Task_PushExecutable (uint32_t task_index, int count)
+{
+	if (is_worker && (tl_worker_index < num_workers))
+	{
+		task_deque_t *deque = worker_deques[tl_worker_index];
+		for (int i = 0; i < count; ++i)
+			TaskDequePush (deque, task_index);
+	}
+	else
+	{
+		for (int i = 0; i < count; ++i)
+			TaskQueuePush (executable_task_queue, task_index);
+	}
+	for (int i = 0; i < count; ++i)
+		SDL_SignalSemaphore (executable_semaphore);
+}
+
+/*
+====================
+Task_TraceRecord
+====================
+*/
+static inline void Task_TraceRecord (int worker_index, task_t *task, uint32_t task_index, uint64_t begin)
+{
+	const uint32_t event_index = Atomic_IncrementUInt32 (&trace_num_events);
+	if (event_index >= MAX_TRACE_EVENTS)
+		return;
+	task_trace_event_t *event = &trace_events[event_index];
+	event->func = task->func;
+	event->begin = begin;
+	event->end = SDL_GetPerformanceCounter ();
+	event->worker_index = worker_index;
+	event->task_index = task_index;
+	event->frame = trace_frame;
+}
+
 /*
 ====================
 Task_ExecuteIndexed
@@ -282,6 +554,7 @@ Task_ExecuteIndexed
 */
 static inline void Task_ExecuteIndexed (int worker_index, task_t *task, uint32_t task_index)
 {
+	worker_index %= num_workers; // background and helping threads start at the counters of some worker
 	for (int i = 0; i < num_workers; ++i)
 	{
 		const int		steal_worker_index = steal_worker_indices[worker_index + i];
@@ -295,6 +568,56 @@ static inline void Task_ExecuteIndexed (int worker_index, task_t *task, uint32_t
 	}
 }
 
+/*
+====================
+RangeCostForFunc
+====================
+*/
+static inline task_range_cost_t *RangeCostForFunc (void *func)
+{
+	const uintptr_t hash = (uintptr_t)func;
+	return &range_costs[(hash ^ (hash >> 6) ^ (hash >> 12)) % NUM_RANGE_COSTS];
+}
+
+/*
+====================
+Task_ExecuteRange
+====================
+*/
+static inline void Task_ExecuteRange (int worker_index, task_t *task, uint32_t task_index)
+{
+	const uint32_t chunk_size = task->range_chunk_size;
+	const uint64_t begin_time = SDL_GetPerformanceCounter ();
+	uint32_t	   num_items = 0;
+	worker_index %= num_workers;
+	for (int i = 0; i < num_workers; ++i)
+	{
+		const int		steal_worker_index = steal_worker_indices[worker_index + i];
+		int				counter_index = IndexedTaskCounterIndex (task_index, steal_worker_index);
+		task_counter_t *counter = &indexed_task_counters[counter_index];
+		uint32_t		begin = 0;
+		while ((begin = Atomic_AddUInt32 (&counter->index, chunk_size)) < counter->limit)
+		{
+			const uint32_t end = q_min (begin + chunk_size, counter->limit);
+			((task_range_func_t)task->func) (begin, end, task->payload);
+			num_items += end - begin;
+		}
+	}
+
+	if (num_items == 0)
+		return;
+
+	// Exponential moving average of the cost per item, races between workers are benign
+	task_range_cost_t *range_cost = RangeCostForFunc (task->func);
+	if (range_cost->func != task->func)
+		return;
+	const double   elapsed_ns = (double)(SDL_GetPerformanceCounter () - begin_time) * ns_per_tick;
+	const uint32_t measured_cost = (uint32_t)q_min ((elapsed_ns * (1 << RANGE_COST_FRAC_BITS)) / num_items, (double)UINT32_MAX);
+	const uint32_t previous_cost = Atomic_LoadUInt32 (&range_cost->cost);
+	const uint32_t cost = (previous_cost == 0) ? measured_cost : (uint32_t)(((uint64_t)previous_cost * 3 + measured_cost) / 4);
+	Atomic_StoreUInt32_Relaxed (&range_cost->cost, q_max (cost, 1u));
+}
+
 static bool Task_Pin_Current_Worker (int pinned_index)
 {
 #if defined(_WIN32)
@@ -345,6 +668,80 @@ static bool Task_Pin_Current_Worker (int pinned_index)
 	return false;
 }
 
+/*
+====================
+Task_Finish
+
+Called once by every thread that executed a task, the last one submits
+its dependents and releases it
+====================
+*/
+static void Task_Finish (task_t *task, uint32_t task_index)
+{
+	if (Atomic_DecrementUInt32 (&task->remaining_workers) == 1)
+	{
+		SDL_LockMutex (task->epoch_mutex);
+		for (int i = 0; i < task->num_dependents; ++i)
+			Task_Submit (task->dependent_task_handles[i]);
+		task->epoch += 1;
+		SDL_BroadcastCondition (task->epoch_condition);
+		SDL_UnlockMutex (task->epoch_mutex);
+		TaskQueuePush (free_task_queue, task_index);
+	}
+}
+
+/*
+====================
+Task_Execute
+====================
+*/
+static void Task_Execute (int worker_index, uint32_t task_index)
+{
+	task_t *task = &tasks[task_index];
+	ANNOTATE_HAPPENS_AFTER (task);
+
+	const qboolean tracing = Atomic_LoadUInt32 (&trace_active) != 0;
+	const uint64_t trace_begin = tracing ? SDL_GetPerformanceCounter () : 0;
+	if (task->task_type == TASK_TYPE_SCALAR)
+	{
+		((task_func_t)task->func) (task->payload);
+	}
+	else if (task->task_type == TASK_TYPE_INDEXED)
+	{
+		Task_ExecuteIndexed (worker_index, task, task_index);
+	}
+	else if (task->task_type == TASK_TYPE_RANGE)
+	{
+		Task_ExecuteRange (worker_index, task, task_index);
+	}
+	if (tracing)
+		Task_TraceRecord (worker_index, task, task_index, trace_begin);
+
+#if defined(USE_HELGRIND)
+	ANNOTATE_HAPPENS_BEFORE (task);
+	qboolean indexed_task = (task->task_type == TASK_TYPE_INDEXED) || (task->task_type == TASK_TYPE_RANGE);
+	if (indexed_task)
+	{
+		// Helgrind needs to know about all threads
+		// that participated in an indexed execution
+		SDL_LockMutex (task->epoch_mutex);
+		for (int i = 0; i < task->num_dependents; ++i)
+		{
+			const int task_index = IndexFromTaskHandle (task->dependent_task_handles[i]);
+			task_t	 *dep_task = &tasks[task_index];
+			ANNOTATE_HAPPENS_BEFORE (dep_task);
+		}
+	}
+#endif
+
+	Task_Finish (task, task_index);
+
+#if defined(USE_HELGRIND)
+	if (indexed_task)
+		SDL_UnlockMutex (task->epoch_mutex);
+#endif
+}
+
 /*
 ====================
 Task_Worker
@@ -368,56 +765,189 @@ static int Task_Worker (void *data)
 			Con_Printf ("Tasks : Failed to pin worker %d (N/A or no access rights)", worker_index);
 		}
 	}
+	// keep frame work off the efficiency cores of hybrid CPUs
+	else if (frame_cpu_mask)
+		Task_SetCurrentAffinity (frame_cpu_mask);
 
 	while (true)
+		Task_Execute (worker_index, Task_FindExecutable (worker_index));
+	return 0;
+}
+
+/*
+====================
+Task_BackgroundWorker
+
+Executes TASK_PRIORITY_BACKGROUND tasks. These threads run at low priority
+and never take frame tasks, so long running work can't hold up a frame.
+====================
+*/
+static int Task_BackgroundWorker (void *data)
+{
+	is_worker = true;
+
+	const int worker_index = (intptr_t)data;
+	tl_worker_index = worker_index;
+	SDL_SetCurrentThreadPriority (SDL_THREAD_PRIORITY_LOW);
+	if (background_cpu_mask)
+		Task_SetCurrentAffinity (background_cpu_mask);
+
+	while (true)
+		Task_Execute (worker_index, TaskQueuePop (background_task_queue));
+	return 0;
+}
+
+/*
+====================
+Task_SetCurrentAffinity
+====================
+*/
+static qboolean Task_SetCurrentAffinity (uint64_t cpu_mask)
+{
+#if defined(_WIN32)
+	return SetThreadAffinityMask (GetCurrentThread (), (DWORD_PTR)cpu_mask) != 0;
+#elif defined(PLATFORM_UNIX) && !defined(PLATFORM_OSX) && !defined(PLATFORM_BSD) && !defined(TASK_AFFINITY_NOT_AVAILABLE)
+	cpu_set_t cpuset;
+	CPU_ZERO (&cpuset);
+	for (int i = 0; i < MAX_TOPOLOGY_CPUS; ++i)
+		if (cpu_mask & (1ull << i))
+			CPU_SET (i, &cpuset);
+	return pthread_setaffinity_np (pthread_self (), sizeof (cpu_set_t), &cpuset) == 0;
+#else
+	return false;
+#endif
+}
+
+#if defined(PLATFORM_UNIX) && !defined(PLATFORM_OSX) && !defined(PLATFORM_BSD) && !defined(TASK_AFFINITY_NOT_AVAILABLE)
+/*
+====================
+Task_ReadSysfs
+====================
+*/
+static qboolean Task_ReadSysfs (const char *path, char *buf, size_t bufsize)
+{
+	FILE *f = fopen (path, "r");
+	if (!f)
+		return false;
+	const qboolean ok = fgets (buf, bufsize, f) != NULL;
+	fclose (f);
+	return ok;
+}
+
+/*
+====================
+Task_ParseCPUList
+
+Parses a sysfs CPU list like "0-7,16,18-19"
+====================
+*/
+static uint64_t Task_ParseCPUList (const char *list)
+{
+	uint64_t mask = 0;
+	while (q_isdigit ((int)*list))
 	{
-		uint32_t task_index = TaskQueuePop (executable_task_queue);
-		task_t	*task = &tasks[task_index];
-		ANNOTATE_HAPPENS_AFTER (task);
+		char	  *end;
+		const long first = strtol (list, &end, 10);
+		long	   last = first;
+		if (*end == '-')
+			last = strtol (end + 1, &end, 10);
+		for (long i = first; (i <= last) && (i < MAX_TOPOLOGY_CPUS); ++i)
+			mask |= 1ull << i;
+		list = (*end == ',') ? (end + 1) : end;
+	}
+	return mask;
+}
+#endif
 
-		if (task->task_type == TASK_TYPE_SCALAR)
-		{
-			((task_func_t)task->func) (task->payload);
-		}
-		else if (task->task_type == TASK_TYPE_INDEXED)
-		{
-			Task_ExecuteIndexed (worker_index, task, task_index);
-		}
+/*
+====================
+Task_DetectTopology
 
-#if defined(USE_HELGRIND)
-		ANNOTATE_HAPPENS_BEFORE (task);
-		qboolean indexed_task = task->task_type == TASK_TYPE_INDEXED;
-		if (indexed_task)
+Finds the logical CPUs of the performance and efficiency cores of hybrid
+CPUs. cpu_class is higher for faster cores, cpu_core identifies the
+physical core so SMT siblings count once.
+====================
+*/
+static void Task_DetectTopology (void)
+{
+	int cpu_class[MAX_TOPOLOGY_CPUS] = {0};
+	int cpu_core[MAX_TOPOLOGY_CPUS] = {0};
+	int num_cpus = 0;
+
+#if defined(_WIN32)
+	DWORD length = 0;
+	GetLogicalProcessorInformationEx (RelationProcessorCore, NULL, &length);
+	if (GetLastError () != ERROR_INSUFFICIENT_BUFFER)
+		return;
+	byte *buffer = Mem_Alloc (length);
+	if (GetLogicalProcessorInformationEx (RelationProcessorCore, (PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX)buffer, &length))
+	{
+		int num_cores = 0;
+		for (DWORD offset = 0; offset < length;)
 		{
-			// Helgrind needs to know about all threads
-			// that participated in an indexed execution
-			SDL_LockMutex (task->epoch_mutex);
-			for (int i = 0; i < task->num_dependents; ++i)
+			const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX *info = (const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX *)(buffer + offset);
+			offset += info->Size;
+			if (info->Processor.GroupMask[0].Group != 0)
+				continue;
+			for (int i = 0; i < MAX_TOPOLOGY_CPUS && i < (int)(sizeof (KAFFINITY) * 8); ++i)
 			{
-				const int task_index = IndexFromTaskHandle (task->dependent_task_handles[i]);
-				task_t	 *dep_task = &tasks[task_index];
-				ANNOTATE_HAPPENS_BEFORE (dep_task);
+				if (!(info->Processor.GroupMask[0].Mask & ((KAFFINITY)1 << i)))
+					continue;
+				cpu_class[i] = info->Processor.EfficiencyClass;
+				cpu_core[i] = num_cores;
+				num_cpus = q_max (num_cpus, i + 1);
 			}
+			++num_cores;
 		}
+	}
+	Mem_Free (buffer);
+#elif defined(PLATFORM_UNIX) && !defined(PLATFORM_OSX) && !defined(PLATFORM_BSD) && !defined(TASK_AFFINITY_NOT_AVAILABLE)
+	// cpu_capacity is exported on ARM big.LITTLE and recent x86 kernels, older kernels only list the Intel E-cores in cpu_atom
+	char	 buf[1024];
+	uint64_t atom_mask = 0;
+	if (Task_ReadSysfs ("/sys/devices/cpu_atom/cpus", buf, sizeof (buf)))
+		atom_mask = Task_ParseCPUList (buf);
+	num_cpus = q_min (SDL_GetNumLogicalCPUCores (), MAX_TOPOLOGY_CPUS);
+	for (int i = 0; i < num_cpus; ++i)
+	{
+		if (Task_ReadSysfs (va ("/sys/devices/system/cpu/cpu%d/cpu_capacity", i), buf, sizeof (buf)))
+			cpu_class[i] = atoi (buf);
+		else
+			cpu_class[i] = (atom_mask & (1ull << i)) ? 0 : 1;
+		// the first sibling identifies the core
+		if (Task_ReadSysfs (va ("/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list", i), buf, sizeof (buf)))
+			cpu_core[i] = atoi (buf);
+		else
+			cpu_core[i] = i;
+	}
 #endif
 
-		if (Atomic_DecrementUInt32 (&task->remaining_workers) == 1)
+	int max_class = INT_MIN;
+	int min_class = INT_MAX;
+	for (int i = 0; i < num_cpus; ++i)
+	{
+		max_class = q_max (max_class, cpu_class[i]);
+		min_class = q_min (min_class, cpu_class[i]);
+	}
+	if (num_cpus == 0 || max_class == min_class)
+		return;
+
+	uint64_t efficiency_cores = 0;
+	for (int i = 0; i < num_cpus; ++i)
+	{
+		if (cpu_class[i] == max_class)
 		{
-			SDL_LockMutex (task->epoch_mutex);
-			for (int i = 0; i < task->num_dependents; ++i)
-				Task_Submit (task->dependent_task_handles[i]);
-			task->epoch += 1;
-			SDL_BroadcastCondition (task->epoch_condition);
-			SDL_UnlockMutex (task->epoch_mutex);
-			TaskQueuePush (free_task_queue, task_index);
+			frame_cpu_mask |= 1ull << i;
+			++num_performance_threads;
+		}
+		else
+		{
+			background_cpu_mask |= 1ull << i;
+			efficiency_cores |= 1ull << (cpu_core[i] % MAX_TOPOLOGY_CPUS);
 		}
-
-#if defined(USE_HELGRIND)
-		if (indexed_task)
-			SDL_UnlockMutex (task->epoch_mutex);
-#endif
 	}
-	return 0;
+	for (; efficiency_cores; efficiency_cores &= efficiency_cores - 1)
+		++num_efficiency_cores;
 }
 
 static void parse_pinned_workers (void)
@@ -468,6 +998,7 @@ void Tasks_Init (void)
 {
 	free_task_queue = CreateTaskQueue (MAX_PENDING_TASKS);
 	executable_task_queue = CreateTaskQueue (MAX_EXECUTABLE_TASKS);
+	background_task_queue = CreateTaskQueue (MAX_PENDING_TASKS * MAX_BACKGROUND_WORKERS);
 
 	for (uint32_t task_index = 0; task_index < (MAX_PENDING_TASKS - 1); ++task_index)
 	{
@@ -480,10 +1011,23 @@ void Tasks_Init (void)
 		tasks[task_index].epoch_condition = SDL_CreateCondition ();
 	}
 
-	num_workers = CLAMP (1, SDL_GetNumLogicalCPUCores (), TASKS_MAX_WORKERS);
+	num_workers = CLAMP (1, SDL_GetNumLogicalCPUCores (), MAX_FRAME_WORKERS);
+	num_background_workers = CLAMP (1, SDL_GetNumLogicalCPUCores () / 4, MAX_BACKGROUND_WORKERS);
+	ns_per_tick = 1000000000.0 / (double)SDL_GetPerformanceFrequency ();
+
+	// on hybrid CPUs frame workers get one P-core thread each, background workers one E-core each
+	if (!COM_CheckParm ("-nohybridworkers"))
+		Task_DetectTopology ();
+	if (frame_cpu_mask)
+	{
+		num_workers = CLAMP (1, num_performance_threads, MAX_FRAME_WORKERS);
+		num_background_workers = CLAMP (1, num_efficiency_cores, MAX_BACKGROUND_WORKERS);
+	}
 
 	// num_workers is overriden by -pinnedworkers number of fields
 	parse_pinned_workers ();
+	if (num_workers > MAX_FRAME_WORKERS)
+		num_workers = num_pinned_workers = MAX_FRAME_WORKERS;
 
 	// Fill lookup table to avoid modulo in Task_ExecuteIndexed
 	for (int i = 0; i < num_workers; ++i)
@@ -495,11 +1039,24 @@ void Tasks_Init (void)
 		steal_worker_indices[steal_index] = i;
 	}
 
+	// Each pending task is pushed at most num_workers times, so deques can never overflow
+	int deque_capacity = 1;
+	while (deque_capacity < (MAX_PENDING_TASKS * num_workers))
+		deque_capacity <<= 1;
+	for (int i = 0; i < num_workers; ++i)
+		worker_deques[i] = CreateTaskDeque (deque_capacity);
+	executable_semaphore = SDL_CreateSemaphore (0);
+
 	indexed_task_counters = Mem_Alloc (sizeof (task_counter_t) * num_workers * MAX_PENDING_TASKS);
 	for (int i = 0; i < num_workers; ++i)
 	{
 		SDL_DetachThread (SDL_CreateThread (Task_Worker, va ("Task_Worker_%d", i), (void *)(intptr_t)i));
 	}
+	// background workers get the worker indices after the frame workers, so per worker data never overlaps
+	for (int i = 0; i < num_background_workers; ++i)
+	{
+		SDL_DetachThread (SDL_CreateThread (Task_BackgroundWorker, va ("Task_Background_%d", i), (void *)(intptr_t)(num_workers + i)));
+	}
 }
 
 /*
@@ -542,8 +1099,10 @@ task_handle_t Task_Allocate (void)
 	task_t	*task = &tasks[task_index];
 	Atomic_StoreUInt32 (&task->remaining_dependencies, 1);
 	task->task_type = TASK_TYPE_NONE;
+	task->priority = TASK_PRIORITY_FRAME;
 	task->num_dependents = 0;
 	task->indexed_limit = 0;
+	task->range_chunk_size = 0;
 	task->func = NULL;
 	return CreateTaskHandle (task_index, task->epoch);
 }
@@ -565,17 +1124,21 @@ void Task_AssignFunc (task_handle_t handle, task_func_t func, void *payload, siz
 
 /*
 ====================
-Task_AssignIndexedFunc
+Task_SetPriority
 ====================
 */
-void Task_AssignIndexedFunc (task_handle_t handle, task_indexed_func_t func, uint32_t limit, void *payload, size_t payload_size)
+void Task_SetPriority (task_handle_t handle, task_priority_t priority)
+{
+	tasks[IndexFromTaskHandle (handle)].priority = priority;
+}
+
+/*
+====================
+Task_InitCounters
+====================
+*/
+static void Task_InitCounters (uint32_t task_index, uint32_t limit)
 {
-	assert (payload_size <= MAX_PAYLOAD_SIZE);
-	uint32_t task_index = IndexFromTaskHandle (handle);
-	task_t	*task = &tasks[task_index];
-	task->task_type = TASK_TYPE_INDEXED;
-	task->func = (void *)func;
-	task->indexed_limit = limit;
 	uint32_t index = 0;
 	uint32_t count_per_worker = (limit + num_workers - 1) / num_workers;
 	for (int worker_index = 0; worker_index < num_workers; ++worker_index)
@@ -586,6 +1149,62 @@ void Task_AssignIndexedFunc (task_handle_t handle, task_indexed_func_t func, uin
 		counter->limit = q_min (index + count_per_worker, limit);
 		index += count_per_worker;
 	}
+}
+
+/*
+====================
+Task_AssignIndexedFunc
+====================
+*/
+void Task_AssignIndexedFunc (task_handle_t handle, task_indexed_func_t func, uint32_t limit, void *payload, size_t payload_size)
+{
+	assert (payload_size <= MAX_PAYLOAD_SIZE);
+	uint32_t task_index = IndexFromTaskHandle (handle);
+	task_t	*task = &tasks[task_index];
+	task->task_type = TASK_TYPE_INDEXED;
+	task->func = (void *)func;
+	task->indexed_limit = limit;
+	Task_InitCounters (task_index, limit);
+	if (payload)
+		memcpy (&task->payload, payload, payload_size);
+}
+
+/*
+====================
+Task_AssignRangeFunc
+
+Like Task_AssignIndexedFunc, but workers claim contiguous [begin, end) chunks.
+The chunk size is derived from the number of workers and the measured cost
+per item of previous runs of the same function.
+====================
+*/
+void Task_AssignRangeFunc (task_handle_t handle, task_range_func_t func, uint32_t limit, void *payload, size_t payload_size)
+{
+	assert (payload_size <= MAX_PAYLOAD_SIZE);
+	uint32_t task_index = IndexFromTaskHandle (handle);
+	task_t	*task = &tasks[task_index];
+	task->task_type = TASK_TYPE_RANGE;
+	task->func = (void *)func;
+
+	// Keep at least a few chunks per worker so stealing can balance uneven work
+	const uint32_t count_per_worker = (limit + num_workers - 1) / num_workers;
+	const uint32_t max_chunk_size = q_max (count_per_worker / 4, 1u);
+	uint32_t	   chunk_size = q_max (count_per_worker / 8, 1u);
+
+	task_range_cost_t *range_cost = RangeCostForFunc (task->func);
+	if (range_cost->func != task->func)
+	{
+		range_cost->func = task->func;
+		Atomic_StoreUInt32 (&range_cost->cost, 0);
+	}
+	const uint32_t cost = Atomic_LoadUInt32 (&range_cost->cost);
+	if (cost != 0)
+		chunk_size = ((uint64_t)RANGE_CHUNK_TIME_NS << RANGE_COST_FRAC_BITS) / cost;
+	task->range_chunk_size = CLAMP (1u, chunk_size, max_chunk_size);
+
+	// Number of workers that can participate is bounded by the number of chunks
+	task->indexed_limit = (limit + task->range_chunk_size - 1) / task->range_chunk_size;
+	Task_InitCounters (task_index, limit);
 	if (payload)
 		memcpy (&task->payload, payload, payload_size);
 }
@@ -603,12 +1222,18 @@ void Task_Submit (task_handle_t handle)
 	ANNOTATE_HAPPENS_BEFORE (task);
 	if (Atomic_DecrementUInt32 (&task->remaining_dependencies) == 1)
 	{
-		const int num_task_workers = (task->task_type == TASK_TYPE_INDEXED) ? q_min (task->indexed_limit, num_workers) : 1;
-		Atomic_StoreUInt32 (&task->remaining_workers, num_task_workers);
-		for (int i = 0; i < num_task_workers; ++i)
+		const qboolean multi_worker = (task->task_type == TASK_TYPE_INDEXED) || (task->task_type == TASK_TYPE_RANGE);
+		if (task->priority == TASK_PRIORITY_BACKGROUND)
 		{
-			TaskQueuePush (executable_task_queue, task_index);
+			const int num_task_workers = multi_worker ? q_min (task->indexed_limit, num_background_workers) : 1;
+			Atomic_StoreUInt32 (&task->remaining_workers, num_task_workers);
+			for (int i = 0; i < num_task_workers; ++i)
+				TaskQueuePush (background_task_queue, task_index);
+			return;
 		}
+		const int num_task_workers = multi_worker ? q_min (task->indexed_limit, num_workers) : 1;
+		Atomic_StoreUInt32 (&task->remaining_workers, num_task_workers);
+		Task_PushExecutable (task_index, num_task_workers);
 	}
 }
 /*
@@ -651,6 +1276,73 @@ void Task_AddDependency (task_handle_t before, task_handle_t after)
 	SDL_UnlockMutex (before_task->epoch_mutex);
 }
 
+/*
+====================
+Task_HelpJoined
+
+Joins the execution of a running indexed or range task as one more worker.
+The task may have been recycled in the meantime, but only running tasks
+have workers remaining, so this at worst helps with some other task.
+====================
+*/
+static qboolean Task_HelpJoined (uint32_t task_index)
+{
+	task_t	*task = &tasks[task_index];
+	uint32_t remaining = Atomic_LoadUInt32 (&task->remaining_workers);
+	do
+	{
+		if (remaining == 0)
+			return false;
+	} while (!Atomic_CompareExchangeUInt32 (&task->remaining_workers, &remaining, remaining + 1));
+
+	if ((task->task_type == TASK_TYPE_INDEXED) || (task->task_type == TASK_TYPE_RANGE))
+	{
+		Task_Execute (HELPER_WORKER_INDEX, task_index);
+		return true;
+	}
+	Task_Finish (task, task_index); // a scalar task only ever runs once
+	return false;
+}
+
+/*
+====================
+Task_HelpUntilDone
+
+Executes frame tasks while waiting for a task: first the joined task itself
+if it is spread over several workers, then whatever the shared queue and the
+workers have pending, which usually includes the joined task's dependencies.
+Background tasks are never picked up, they could run much longer than the
+joined task.
+====================
+*/
+static void Task_HelpUntilDone (uint32_t task_index, uint64_t handle_task_epoch)
+{
+	task_t	*task = &tasks[task_index];
+	uint32_t other_task_index;
+
+	is_worker = true;
+	tl_worker_index = HELPER_WORKER_INDEX;
+
+	SDL_LockMutex (task->epoch_mutex);
+	while (task->epoch == handle_task_epoch)
+	{
+		SDL_UnlockMutex (task->epoch_mutex);
+		qboolean helped = Task_HelpJoined (task_index);
+		if (Task_TryFindExecutable (&other_task_index))
+		{
+			Task_Execute (HELPER_WORKER_INDEX, other_task_index);
+			helped = true;
+		}
+		SDL_LockMutex (task->epoch_mutex);
+		if (!helped && (task->epoch == handle_task_epoch))
+			SDL_WaitConditionTimeout (task->epoch_condition, task->epoch_mutex, JOIN_HELP_WAIT_MS);
+	}
+	SDL_UnlockMutex (task->epoch_mutex);
+
+	is_worker = false;
+	tl_worker_index = 0;
+}
+
 /*
 ====================
 Task_Join
@@ -660,6 +1352,15 @@ qboolean Task_Join (task_handle_t handle, uint32_t timeout)
 {
 	task_t		  *task = &tasks[IndexFromTaskHandle (handle)];
 	const uint64_t handle_task_epoch = EpochFromTaskHandle (handle);
+
+	// one thread outside the task system at a time may help, it borrows the last worker index
+	uint32_t helper_inactive = 0;
+	if (!is_worker && (timeout == (uint32_t)TASK_TIMEOUT_INFINITE) && Atomic_CompareExchangeUInt32 (&join_helper_active, &helper_inactive, 1))
+	{
+		Task_HelpUntilDone (IndexFromTaskHandle (handle), handle_task_epoch);
+		Atomic_StoreUInt32 (&join_helper_active, 0);
+	}
+
 	SDL_LockMutex (task->epoch_mutex);
 	while (task->epoch == handle_task_epoch)
 	{
@@ -674,6 +1375,132 @@ qboolean Task_Join (task_handle_t handle, uint32_t timeout)
 	return true;
 }
 
+/*
+====================
+Tasks_WriteTrace
+
+Writes the recorded events in the Chrome trace event format, which can
+be loaded by chrome://tracing or https://ui.perfetto.dev
+====================
+*/
+static void Tasks_WriteTrace (void)
+{
+	const uint32_t num_events = q_min (Atomic_LoadUInt32 (&trace_num_events), MAX_TRACE_EVENTS);
+	const double   us_per_tick = 1000000.0 / (double)SDL_GetPerformanceFrequency ();
+
+	time_t now;
+	time (&now);
+	struct tm *lt = localtime (&now);
+	char	   tracename[MAX_OSPATH];
+	q_snprintf (
+		tracename, sizeof (tracename), "%s/tasks_trace-%04d%02d%02d-%02d%02d%02d.json", com_gamedir, lt->tm_year + 1900, lt->tm_mon + 1, lt->tm_mday,
+		lt->tm_hour, lt->tm_min, lt->tm_sec);
+
+	FILE *f = fopen (tracename, "w");
+	if (!f)
+	{
+		Con_Printf ("Tasks_WriteTrace: Couldn't create %s\n", tracename);
+		return;
+	}
+
+	fprintf (f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	for (int i = 0; i < num_workers; ++i)
+		fprintf (f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,\"args\":{\"name\":\"Task_Worker_%d\"}},\n", i, i);
+	for (uint32_t i = 0; i < num_events; ++i)
+	{
+		const task_trace_event_t *event = &trace_events[i];
+		if (!event->func || (event->begin < trace_start_counter))
+			continue;
+		const double ts = (double)(event->begin - trace_start_counter) * us_per_tick;
+		const double dur = (double)(event->end - event->begin) * us_per_tick;
+		fprintf (
+			f,
+			"{\"name\":\"0x%" PRIxPTR "\",\"cat\":\"task\",\"ph\":\"X\",\"pid\":0,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,"
+			"\"args\":{\"frame\":%u,\"task\":%d}},\n",
+			(uintptr_t)event->func, event->worker_index, ts, dur, event->frame, event->task_index);
+	}
+	// Terminate with a metadata event so the list needs no trailing comma handling
+	fprintf (f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"vkQuake\"}}\n]}\n");
+	fclose (f);
+
+	Con_Printf ("Wrote %s (%u events", tracename, num_events);
+	if (Atomic_LoadUInt32 (&trace_num_events) > MAX_TRACE_EVENTS)
+		Con_Printf (", %u dropped", Atomic_LoadUInt32 (&trace_num_events) - MAX_TRACE_EVENTS);
+	Con_Printf (")\n");
+}
+
+/*
+====================
+Tasks_Trace_f
+====================
+*/
+static void Tasks_Trace_f (void)
+{
+	if (Cmd_Argc () != 2)
+	{
+		Con_Printf ("usage: tasks_trace <frames>\n");
+		return;
+	}
+	if (Atomic_LoadUInt32 (&trace_active) || trace_write_pending)
+	{
+		Con_Printf ("tasks_trace: already recording\n");
+		return;
+	}
+	const int frames = atoi (Cmd_Argv (1));
+	if (frames <= 0)
+	{
+		Con_Printf ("tasks_trace: frame count must be positive\n");
+		return;
+	}
+
+	// Never freed, workers might still be recording while the trace is written
+	if (!trace_events)
+		trace_events = Mem_Alloc (sizeof (task_trace_event_t) * MAX_TRACE_EVENTS);
+	memset (trace_events, 0, sizeof (task_trace_event_t) * MAX_TRACE_EVENTS);
+	Atomic_StoreUInt32 (&trace_num_events, 0);
+	trace_frame = 0;
+	trace_remaining_frames = frames;
+	trace_start_counter = SDL_GetPerformanceCounter ();
+	Atomic_StoreUInt32 (&trace_active, 1);
+	Con_Printf ("Recording task trace for %d frames\n", frames);
+}
+
+/*
+====================
+Tasks_TraceFrame
+
+Called once per host frame. The trace is written one frame after recording
+stopped so that all tasks of the last traced frame have finished.
+====================
+*/
+void Tasks_TraceFrame (void)
+{
+	if (trace_write_pending)
+	{
+		trace_write_pending = false;
+		Tasks_WriteTrace ();
+		return;
+	}
+	if (!Atomic_LoadUInt32 (&trace_active))
+		return;
+	++trace_frame;
+	if (--trace_remaining_frames <= 0)
+	{
+		Atomic_StoreUInt32 (&trace_active, 0);
+		trace_write_pending = true;
+	}
+}
+
+/*
+====================
+Tasks_InitCommands
+====================
+*/
+void Tasks_InitCommands (void)
+{
+	Cmd_AddCommand ("tasks_trace", Tasks_Trace_f);
+}
+
 #ifdef _DEBUG
 /*
 =================
@@ -737,6 +1564,33 @@ static void IndexedTasks ()
 	TEMP_FREE (counters);
 }
 
+/*
+=================
+RangeTasks
+=================
+*/
+static void RangeTestTask (int begin, int end, void *counters_ptr)
+{
+	uint32_t *counters = *((uint32_t **)counters_ptr);
+	counters[Tasks_GetWorkerIndex ()] += end - begin;
+}
+static void RangeTasks ()
+{
+	static const int LIMIT = 100000;
+	TEMP_ALLOC_ZEROED (uint32_t, counters, TASKS_MAX_WORKERS);
+	for (int run = 0; run < 4; ++run)
+	{
+		memset (counters, 0, sizeof (uint32_t) * TASKS_MAX_WORKERS);
+		task_handle_t task = Task_AllocateAssignRangeFuncAndSubmit (RangeTestTask, LIMIT, (void *)&counters, sizeof (uint32_t *));
+		Task_Join (task, TASK_TIMEOUT_INFINITE);
+		uint32_t counters_sum = 0;
+		for (int i = 0; i < TASKS_MAX_WORKERS; ++i)
+			counters_sum += counters[i];
+		TASKS_TEST_ASSERT (counters_sum == LIMIT, "Wrong counters_sum");
+	}
+	TEMP_FREE (counters);
+}
+
 /*
 =================
 TestTasks_f
@@ -746,5 +1600,6 @@ void TestTasks_f (void)
 {
 	LotsOfTasks ();
 	IndexedTasks ();
+	RangeTasks ();
 }
 #endif
@@ -32,14 +32,25 @@
 typedef uint64_t task_handle_t;
 typedef void (*task_func_t) (void *);
 typedef void (*task_indexed_func_t) (int, void *);
+typedef void (*task_range_func_t) (int, int, void *);
+
+typedef enum
+{
+	TASK_PRIORITY_FRAME,	  // work the current frame waits for, runs on the task workers
+	TASK_PRIORITY_BACKGROUND, // long running work (file IO, encoding, prefetching), runs on low priority background workers
+} task_priority_t;
 
 void		  Tasks_Init (void);
+void		  Tasks_InitCommands (void);
+void		  Tasks_TraceFrame (void);
 int			  Tasks_NumWorkers (void);
 qboolean	  Tasks_IsWorker (void);
 int			  Tasks_GetWorkerIndex (void);
 task_handle_t Task_Allocate (void);
 void		  Task_AssignFunc (task_handle_t handle, task_func_t func, void *payload, size_t payload_size);
 void		  Task_AssignIndexedFunc (task_handle_t handle, task_indexed_func_t func, uint32_t limit, void *payload, size_t payload_size);
+void		  Task_AssignRangeFunc (task_handle_t handle, task_range_func_t func, uint32_t limit, void *payload, size_t payload_size);
+void		  Task_SetPriority (task_handle_t handle, task_priority_t priority);
 void		  Task_Submit (task_handle_t handle);
 void		  Tasks_Submit (int num_handles, task_handle_t *handles);
 void		  Task_AddDependency (task_handle_t before, task_handle_t after);
@@ -75,6 +86,39 @@ static inline task_handle_t Task_AllocateAssignIndexedFuncAndSubmit (task_indexe
 	return handle;
 }
 
+static inline task_handle_t Task_AllocateAssignBackgroundFuncAndSubmit (task_func_t func, void *payload, size_t payload_size)
+{
+	task_handle_t handle = Task_Allocate ();
+	Task_AssignFunc (handle, func, payload, payload_size);
+	Task_SetPriority (handle, TASK_PRIORITY_BACKGROUND);
+	Task_Submit (handle);
+	return handle;
+}
+
+static inline task_handle_t Task_AllocateAssignBackgroundIndexedFuncAndSubmit (task_indexed_func_t func, uint32_t limit, void *payload, size_t payload_size)
+{
+	task_handle_t handle = Task_Allocate ();
+	Task_AssignIndexedFunc (handle, func, limit, payload, payload_size);
+	Task_SetPriority (handle, TASK_PRIORITY_BACKGROUND);
+	Task_Submit (handle);
+	return handle;
+}
+
+static inline task_handle_t Task_AllocateAndAssignRangeFunc (task_range_func_t func, uint32_t limit, void *payload, size_t payload_size)
+{
+	task_handle_t handle = Task_Allocate ();
+	Task_AssignRangeFunc (handle, func, limit, payload, payload_size);
+	return handle;
+}
+
+static inline task_handle_t Task_AllocateAssignRangeFuncAndSubmit (task_range_func_t func, uint32_t limit, void *payload, size_t payload_size)
+{
+	task_handle_t handle = Task_Allocate ();
+	Task_AssignRangeFunc (handle, func, limit, payload, payload_size);
+	Task_Submit (handle);
+	return handle;
+}
+
 #ifdef _DEBUG
 void TestTasks_f (void);
 #endif
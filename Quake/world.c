@@ -34,6 +34,9 @@ cvar_t sv_fte_recursivehullckeck = {"sv_fte_recursivehullckeck", "1", CVAR_ARCHI
 
 cvar_t sv_fte_createareanode = {"sv_fte_createareanode", "1", CVAR_ARCHIVE};
 
+// split the areanodes where the map entities are once they are spawned, changes the order triggers are touched in
+cvar_t sv_areanodes_balanced = {"sv_areanodes_balanced", "0", CVAR_ARCHIVE};
+
 /*
 
 entities never clip against themselves, or their owner
@@ -261,6 +264,140 @@ void SV_ClearWorld (void)
 	SV_CreateAreaNode (0, qcvm->worldmodel->mins, qcvm->worldmodel->maxs);
 }
 
+#define AREA_LEAF_EDICTS 8 // stop splitting a node below that many edicts
+
+static int SV_CompareEdicts (const void *a, const void *b)
+{
+	const edict_t *ea = *(const edict_t **)a;
+	const edict_t *eb = *(const edict_t **)b;
+	return (ea > eb) - (ea < eb);
+}
+
+static int SV_CompareFloats (const void *a, const void *b)
+{
+	const float fa = *(const float *)a;
+	const float fb = *(const float *)b;
+	return (fa > fb) - (fa < fb);
+}
+
+/*
+================
+SV_CreateBalancedAreaNode
+
+Same as SV_CreateAreaNode, but splits at the median of the edicts that fall in the node instead of
+at its middle, and stops where there is nothing left to split.
+================
+*/
+static areanode_t *SV_CreateBalancedAreaNode (int depth, vec3_t mins, vec3_t maxs, edict_t **ents, int numents)
+{
+	areanode_t *anode;
+	vec3_t		size;
+	vec3_t		mins1, maxs1, mins2, maxs2;
+	edict_t	   *ent;
+	int			i, numfront, numback;
+
+	anode = &qcvm->areanodes[qcvm->numareanodes];
+	qcvm->numareanodes++;
+
+	ClearLink (&anode->trigger_edicts);
+	ClearLink (&anode->solid_edicts);
+
+	VectorSubtract (maxs, mins, size);
+	if (size[0] > size[1])
+		anode->axis = 0;
+	else
+		anode->axis = 1;
+
+	if (depth == MAX_AREA_DEPTH || numents <= AREA_LEAF_EDICTS)
+	{
+		anode->axis = -1;
+		anode->children[0] = anode->children[1] = NULL;
+		return anode;
+	}
+
+	TEMP_ALLOC (float, centers, numents);
+	for (i = 0; i < numents; i++)
+		centers[i] = 0.5f * (ents[i]->v.absmin[anode->axis] + ents[i]->v.absmax[anode->axis]);
+	qsort (centers, numents, sizeof (float), SV_CompareFloats);
+	anode->dist = CLAMP (mins[anode->axis], centers[numents / 2], maxs[anode->axis]);
+	TEMP_FREE (centers);
+
+	// front edicts first, then back ones, the ones crossing the split stay in this node
+	numfront = numback = 0;
+	for (i = 0; i < numents; i++)
+	{
+		ent = ents[i];
+		if (ent->v.absmin[anode->axis] > anode->dist)
+		{
+			ents[i] = ents[numfront];
+			ents[numfront++] = ent;
+		}
+	}
+	for (i = numfront; i < numents; i++)
+	{
+		ent = ents[i];
+		if (ent->v.absmax[anode->axis] < anode->dist)
+		{
+			ents[i] = ents[numfront + numback];
+			ents[numfront + numback++] = ent;
+		}
+	}
+
+	if (!numfront && !numback)
+	{
+		// everything crosses the split
+		anode->axis = -1;
+		anode->children[0] = anode->children[1] = NULL;
+		return anode;
+	}
+
+	VectorCopy (mins, mins1);
+	VectorCopy (mins, mins2);
+	VectorCopy (maxs, maxs1);
+	VectorCopy (maxs, maxs2);
+
+	maxs1[anode->axis] = mins2[anode->axis] = anode->dist;
+
+	anode->children[0] = SV_CreateBalancedAreaNode (depth + 1, mins2, maxs2, ents, numfront);
+	anode->children[1] = SV_CreateBalancedAreaNode (depth + 1, mins1, maxs1, ents + numfront, numback);
+
+	return anode;
+}
+
+/*
+===============
+SV_RebalanceAreaNodes
+
+Rebuilds the areanodes around the edicts linked so far, so that crowded parts of the map
+get more nodes, and relinks them in edict order.
+===============
+*/
+void SV_RebalanceAreaNodes (void)
+{
+	edict_t *ent;
+	int		 i, numents;
+
+	TEMP_ALLOC (edict_t *, ents, qcvm->num_edicts);
+	numents = 0;
+	for (i = 1, ent = NEXT_EDICT (qcvm->edicts); i < qcvm->num_edicts; i++, ent = NEXT_EDICT (ent))
+	{
+		if (ent->free || !ent->area.prev)
+			continue;
+		SV_UnlinkEdict (ent);
+		ents[numents++] = ent;
+	}
+
+	memset (qcvm->areanodes, 0, sizeof (qcvm->areanodes));
+	qcvm->numareanodes = 0;
+	SV_CreateBalancedAreaNode (0, qcvm->worldmodel->mins, qcvm->worldmodel->maxs, ents, numents);
+
+	// the partitioning shuffled the list
+	qsort (ents, numents, sizeof (edict_t *), SV_CompareEdicts);
+	for (i = 0; i < numents; i++)
+		SV_LinkEdict (ents[i], false);
+	TEMP_FREE (ents);
+}
+
 /*
 ===============
 SV_UnlinkEdict
@@ -318,6 +455,145 @@ static void SV_AreaTriggerEdicts (edict_t *ent, areanode_t *node, edict_t **list
 		SV_AreaTriggerEdicts (ent, node->children[1], list, listcount, listspace);
 }
 
+/*
+====================
+SV_AreaNodeEdicts
+====================
+*/
+static void SV_AreaNodeEdicts (const vec3_t mins, const vec3_t maxs, areanode_t *node, edict_t **list, int *listcount, const int listspace)
+{
+	link_t *l;
+
+	for (l = node->solid_edicts.next; l != &node->solid_edicts && *listcount < listspace; l = l->next)
+		list[(*listcount)++] = EDICT_FROM_AREA (l);
+	for (l = node->trigger_edicts.next; l != &node->trigger_edicts && *listcount < listspace; l = l->next)
+		list[(*listcount)++] = EDICT_FROM_AREA (l);
+
+	// recurse down both sides
+	if (node->axis == -1)
+		return;
+
+	if (maxs[node->axis] > node->dist)
+		SV_AreaNodeEdicts (mins, maxs, node->children[0], list, listcount, listspace);
+	if (mins[node->axis] < node->dist)
+		SV_AreaNodeEdicts (mins, maxs, node->children[1], list, listcount, listspace);
+}
+
+/*
+====================
+SV_AreaEdicts
+
+Lists the linked edicts in the areanodes that the box reaches, sorted by edict number.
+The edicts themselves are not tested against the box.
+====================
+*/
+int SV_AreaEdicts (const vec3_t mins, const vec3_t maxs, edict_t **list, const int listspace)
+{
+	int listcount = 0;
+
+	SV_AreaNodeEdicts (mins, maxs, qcvm->areanodes, list, &listcount, listspace);
+	qsort (list, listcount, sizeof (edict_t *), SV_CompareEdicts);
+	return listcount;
+}
+
+typedef struct
+{
+	areanode_t *node;
+	int			depth;
+	int			numsolid, numtrigger;
+	vec3_t		mins, maxs;
+} areastats_t;
+
+static int SV_CompareAreaStats (const void *a, const void *b)
+{
+	const areastats_t *sa = (const areastats_t *)a;
+	const areastats_t *sb = (const areastats_t *)b;
+	return (sb->numsolid + sb->numtrigger) - (sa->numsolid + sa->numtrigger);
+}
+
+static int SV_CountLinks (link_t *list)
+{
+	link_t *l;
+	int		count = 0;
+
+	for (l = list->next; l != list; l = l->next)
+		count++;
+	return count;
+}
+
+static void SV_GatherAreaStats (areanode_t *node, int depth, vec3_t mins, vec3_t maxs, areastats_t *stats, int *numstats)
+{
+	areastats_t *s = &stats[(*numstats)++];
+	vec3_t		 mins1, maxs1, mins2, maxs2;
+
+	s->node = node;
+	s->depth = depth;
+	s->numsolid = SV_CountLinks (&node->solid_edicts);
+	s->numtrigger = SV_CountLinks (&node->trigger_edicts);
+	VectorCopy (mins, s->mins);
+	VectorCopy (maxs, s->maxs);
+
+	if (node->axis == -1)
+		return;
+
+	VectorCopy (mins, mins1);
+	VectorCopy (mins, mins2);
+	VectorCopy (maxs, maxs1);
+	VectorCopy (maxs, maxs2);
+	maxs1[node->axis] = mins2[node->axis] = node->dist;
+
+	SV_GatherAreaStats (node->children[0], depth + 1, mins2, maxs2, stats, numstats);
+	SV_GatherAreaStats (node->children[1], depth + 1, mins1, maxs1, stats, numstats);
+}
+
+/*
+===============
+SV_AreaStats_f
+
+Prints how the linked edicts are spread over the server areanodes, busiest nodes first
+===============
+*/
+void SV_AreaStats_f (void)
+{
+	areastats_t *s;
+	int			 i, numstats, count;
+	int			 numleafs = 0, maxdepth = 0, totalsolid = 0, totaltrigger = 0;
+
+	if (!sv.active)
+	{
+		Con_Printf ("Not running a server.\n");
+		return;
+	}
+
+	count = Cmd_Argc () > 1 ? atoi (Cmd_Argv (1)) : 10;
+
+	TEMP_ALLOC (areastats_t, stats, sv.qcvm.numareanodes);
+	numstats = 0;
+	SV_GatherAreaStats (sv.qcvm.areanodes, 0, sv.qcvm.worldmodel->mins, sv.qcvm.worldmodel->maxs, stats, &numstats);
+
+	for (i = 0, s = stats; i < numstats; i++, s++)
+	{
+		if (s->node->axis == -1)
+			numleafs++;
+		maxdepth = q_max (maxdepth, s->depth);
+		totalsolid += s->numsolid;
+		totaltrigger += s->numtrigger;
+	}
+	Con_Printf ("%i areanodes, %i leafs, depth %i, %i solid and %i trigger edicts linked\n", numstats, numleafs, maxdepth, totalsolid, totaltrigger);
+
+	qsort (stats, numstats, sizeof (areastats_t), SV_CompareAreaStats);
+	Con_Printf ("node depth solid trigger bounds\n");
+	for (i = 0, s = stats; i < q_min (count, numstats); i++, s++)
+	{
+		if (!s->numsolid && !s->numtrigger)
+			break;
+		Con_Printf (
+			"%4i %5i %5i %7i (%.0f %.0f %.0f) - (%.0f %.0f %.0f)%s\n", (int)(s->node - sv.qcvm.areanodes), s->depth, s->numsolid, s->numtrigger, s->mins[0],
+			s->mins[1], s->mins[2], s->maxs[0], s->maxs[1], s->maxs[2], s->node->axis == -1 ? "" : " (split)");
+	}
+	TEMP_FREE (stats);
+}
+
 /*
 ====================
 SV_TouchLinks
@@ -334,7 +610,9 @@ void SV_TouchLinks (edict_t *ent)
 	int		 old_self, old_other;
 	int		 i, listcount;
 
-	TEMP_ALLOC (edict_t *, list, qcvm->num_edicts);
+	// touch functions relink edicts and recurse back in here, the arena keeps every level off the heap
+	const mem_frame_mark_t mark = Mem_FrameMark ();
+	edict_t			   **list = (edict_t **)Mem_FrameAlloc (qcvm->num_edicts * sizeof (edict_t *));
 
 	listcount = 0;
 	SV_AreaTriggerEdicts (ent, qcvm->areanodes, list, &listcount, qcvm->num_edicts);
@@ -363,7 +641,7 @@ void SV_TouchLinks (edict_t *ent)
 		pr_global_struct->other = old_other;
 	}
 
-	TEMP_FREE (list);
+	Mem_FrameRelease (mark);
 }
 
 /*
@@ -372,7 +650,7 @@ SV_FindTouchedLeafs
 
 ===============
 */
-void SV_FindTouchedLeafs (edict_t *ent, mnode_t *node)
+void SV_FindTouchedLeafs (edict_t *ent, edictleafs_t *leafs, mnode_t *node)
 {
 	mplane_t *splitplane;
 	mleaf_t	 *leaf;
@@ -382,7 +660,7 @@ void SV_FindTouchedLeafs (edict_t *ent, mnode_t *node)
 	if (node->contents == CONTENTS_SOLID)
 		return;
 
-	if (ent->num_leafs == MAX_ENT_LEAFS)
+	if (leafs->num_leafs == MAX_ENT_LEAFS)
 		return;
 
 	// add an efrag if the node is a leaf
@@ -392,8 +670,8 @@ void SV_FindTouchedLeafs (edict_t *ent, mnode_t *node)
 		leaf = (mleaf_t *)node;
 		leafnum = leaf - qcvm->worldmodel->leafs - 1;
 
-		ent->leafnums[ent->num_leafs] = leafnum;
-		ent->num_leafs++;
+		leafs->leafnums[leafs->num_leafs] = leafnum;
+		leafs->num_leafs++;
 		return;
 	}
 
@@ -404,30 +682,32 @@ void SV_FindTouchedLeafs (edict_t *ent, mnode_t *node)
 
 	// recurse down the contacted sides
 	if (sides & 1)
-		SV_FindTouchedLeafs (ent, node->children[0]);
+		SV_FindTouchedLeafs (ent, leafs, node->children[0]);
 
 	if (sides & 2)
-		SV_FindTouchedLeafs (ent, node->children[1]);
+		SV_FindTouchedLeafs (ent, leafs, node->children[1]);
 }
 
 /*
 ===============
 SV_LinkEdict
 
+Physics links most edicts several times per frame without moving them. The
+leaf walk is skipped while the abs box didn't change, and an edict that stays
+in the same areanode list isn't unlinked and linked again.
 ===============
 */
 void SV_LinkEdict (edict_t *ent, qboolean touch_triggers)
 {
-	areanode_t *node;
-
-	if (ent->area.prev)
-		SV_UnlinkEdict (ent); // unlink from old position
-
-	if (ent == qcvm->edicts)
-		return; // don't add the world
+	areanode_t	 *node;
+	edictleafs_t *leafs;
+	link_t		 *list;
 
-	if (ent->free)
+	if ((ent == qcvm->edicts) || ent->free)
+	{
+		SV_UnlinkEdict (ent); // don't add the world
 		return;
+	}
 
 	// set the abs box
 	if (ent->v.solid == SOLID_BSP && pr_checkextension.value && IsOriginWithinMinMax (ent->v.origin, ent->v.mins, ent->v.maxs) &&
@@ -479,12 +759,24 @@ void SV_LinkEdict (edict_t *ent, qboolean touch_triggers)
 	}
 
 	// link to PVS leafs
-	ent->num_leafs = 0;
-	if (ent->v.modelindex)
-		SV_FindTouchedLeafs (ent, qcvm->worldmodel->nodes);
+	if (!ent->leafs_valid || (ent->leafs_model != (ent->v.modelindex != 0)) || !VectorCompare (ent->v.absmin, ent->leafmins) ||
+		!VectorCompare (ent->v.absmax, ent->leafmaxs))
+	{
+		leafs = EDICT_LEAFS (ent);
+		leafs->num_leafs = 0;
+		if (ent->v.modelindex)
+			SV_FindTouchedLeafs (ent, leafs, qcvm->worldmodel->nodes);
+		VectorCopy (ent->v.absmin, ent->leafmins);
+		VectorCopy (ent->v.absmax, ent->leafmaxs);
+		ent->leafs_model = ent->v.modelindex != 0;
+		ent->leafs_valid = true;
+	}
 
 	if (ent->v.solid == SOLID_NOT)
+	{
+		SV_UnlinkEdict (ent);
 		return;
+	}
 
 	// find the first node that the ent's box crosses
 	node = qcvm->areanodes;
@@ -500,12 +792,14 @@ void SV_LinkEdict (edict_t *ent, qboolean touch_triggers)
 			break; // crosses the node
 	}
 
-	// link it in
-
-	if (ent->v.solid == SOLID_TRIGGER)
-		InsertLinkBefore (&ent->area, &node->trigger_edicts);
-	else
-		InsertLinkBefore (&ent->area, &node->solid_edicts);
+	// link it in, unless it already is
+	list = (ent->v.solid == SOLID_TRIGGER) ? &node->trigger_edicts : &node->solid_edicts;
+	if (!ent->area.prev || (ent->arealist != list))
+	{
+		SV_UnlinkEdict (ent);
+		InsertLinkBefore (&ent->area, list);
+		ent->arealist = list;
+	}
 
 	// if touch_triggers, touch all entities at this node and decend for more
 	if (touch_triggers)
@@ -615,6 +909,18 @@ LINE TESTING IN HULLS
 #define VectorInterpolate(a, bness, b, c) \
 	FloatInterpolate ((a)[0], bness, (b)[0], (c)[0]), FloatInterpolate ((a)[1], bness, (b)[1], (c)[1]), FloatInterpolate ((a)[2], bness, (b)[2], (c)[2])
 
+#define MAX_RHT_STACK 256 // crossed nodes before recursing with a fresh stack
+
+typedef struct
+{
+	mclipnode_t *node;
+	mplane_t	*plane;
+	int			 side;
+	qboolean	 back; // the near side is done, tracing the far side
+	float		 midf, p2f;
+	vec3_t		 mid, p2;
+} rhtframe_t;
+
 /*
 ==================
 Q1BSP_RecursiveHullTrace
@@ -625,124 +931,165 @@ This is achieved by recursing at the actual decision points instead of vanilla's
 volume. It also uses itself to test solidity on the other side of the node, which ensures consistent precision. The actual collision point is (still) biased by
 an epsilon, so the end point shouldn't be inside walls either way. FTE's version 'should' be more compatible with vanilla than DP's (which doesn't take care
 with allsolid). ezQuake also has a version of this logic, but I trust mine more.
+The recursion runs on an explicit stack of the crossed nodes, the far side of a node being resumed once its near side is done.
 ==================
 */
 int Q1BSP_RecursiveHullTrace (struct rhtctx_s *ctx, int num, float p1f, float p2f, vec3_t p1, vec3_t p2, trace_t *trace)
 {
+	rhtframe_t	 stack[MAX_RHT_STACK];
+	rhtframe_t	*frame;
+	int			 depth = 0;
 	mclipnode_t *node;
 	mplane_t	*plane;
 	float		 t1, t2;
-	vec3_t		 mid;
+	vec3_t		 start, end; // of the segment being traced
 	int			 side;
 	float		 midf;
 	int			 rht;
 
-reenter:
+	VectorCopy (p1, start);
+	VectorCopy (p2, end);
 
-	if (num < 0)
+	for (;;)
 	{
-		/*hit a leaf*/
-		trace->contents = num;
-		if (ctx->hitcontents & CONTENTMASK_FROMQ1 (num))
+		/*walk down to a leaf, stacking the nodes the segment crosses*/
+		while (num >= 0)
 		{
-			if (trace->allsolid)
-				trace->startsolid = true;
-			return rht_solid;
-		}
-		else
-		{
-			trace->allsolid = false;
-			if (num == CONTENTS_EMPTY)
-				trace->inopen = true;
-			else if (num != CONTENTS_SOLID)
-				trace->inwater = true;
-			return rht_empty;
-		}
-	}
-
-	/*its a node*/
+			/*get the node info*/
+			node = ctx->clipnodes + num;
+			plane = ctx->planes + node->planenum;
 
-	/*get the node info*/
-	node = ctx->clipnodes + num;
-	plane = ctx->planes + node->planenum;
+			if (plane->type < 3)
+			{
+				t1 = start[plane->type] - plane->dist;
+				t2 = end[plane->type] - plane->dist;
+			}
+			else
+			{
+				t1 = DoublePrecisionDotProduct (plane->normal, start) - plane->dist;
+				t2 = DoublePrecisionDotProduct (plane->normal, end) - plane->dist;
+			}
 
-	if (plane->type < 3)
-	{
-		t1 = p1[plane->type] - plane->dist;
-		t2 = p2[plane->type] - plane->dist;
-	}
-	else
-	{
-		t1 = DoublePrecisionDotProduct (plane->normal, p1) - plane->dist;
-		t2 = DoublePrecisionDotProduct (plane->normal, p2) - plane->dist;
-	}
+			/*if its completely on one side, resume on that side*/
+			if (t1 >= 0 && t2 >= 0)
+			{
+				num = node->children[0];
+				continue;
+			}
+			if (t1 < 0 && t2 < 0)
+			{
+				num = node->children[1];
+				continue;
+			}
 
-	/*if its completely on one side, resume on that side*/
-	if (t1 >= 0 && t2 >= 0)
-	{
-		// return Q1BSP_RecursiveHullTrace (hull, node->children[0], p1f, p2f, p1, p2, trace);
-		num = node->children[0];
-		goto reenter;
-	}
-	if (t1 < 0 && t2 < 0)
-	{
-		// return Q1BSP_RecursiveHullTrace (hull, node->children[1], p1f, p2f, p1, p2, trace);
-		num = node->children[1];
-		goto reenter;
-	}
+			if (depth == MAX_RHT_STACK)
+				break; /*really deep tree, trace this subtree with a fresh stack*/
 
-	if (plane->type < 3)
-	{
-		t1 = ctx->start[plane->type] - plane->dist;
-		t2 = ctx->end[plane->type] - plane->dist;
-	}
-	else
-	{
-		t1 = DotProduct (plane->normal, ctx->start) - plane->dist;
-		t2 = DotProduct (plane->normal, ctx->end) - plane->dist;
-	}
+			if (plane->type < 3)
+			{
+				t1 = ctx->start[plane->type] - plane->dist;
+				t2 = ctx->end[plane->type] - plane->dist;
+			}
+			else
+			{
+				t1 = DotProduct (plane->normal, ctx->start) - plane->dist;
+				t2 = DotProduct (plane->normal, ctx->end) - plane->dist;
+			}
 
-	side = t1 < 0;
+			side = t1 < 0;
+
+			midf = t1 / (t1 - t2);
+			if (midf < p1f)
+				midf = p1f;
+			if (midf > p2f)
+				midf = p2f;
+
+			/*trace the near side first, the far side is resumed from the stack*/
+			frame = &stack[depth++];
+			frame->node = node;
+			frame->plane = plane;
+			frame->side = side;
+			frame->back = false;
+			frame->midf = midf;
+			frame->p2f = p2f;
+			VectorInterpolate (ctx->start, midf, ctx->end, frame->mid);
+			VectorCopy (end, frame->p2);
+
+			num = node->children[side];
+			p2f = midf;
+			VectorCopy (frame->mid, end);
+		}
 
-	midf = t1 / (t1 - t2);
-	if (midf < p1f)
-		midf = p1f;
-	if (midf > p2f)
-		midf = p2f;
-	VectorInterpolate (ctx->start, midf, ctx->end, mid);
+		if (num >= 0)
+			rht = Q1BSP_RecursiveHullTrace (ctx, num, p1f, p2f, start, end, trace);
+		else
+		{
+			/*hit a leaf*/
+			trace->contents = num;
+			if (ctx->hitcontents & CONTENTMASK_FROMQ1 (num))
+			{
+				if (trace->allsolid)
+					trace->startsolid = true;
+				rht = rht_solid;
+			}
+			else
+			{
+				trace->allsolid = false;
+				if (num == CONTENTS_EMPTY)
+					trace->inopen = true;
+				else if (num != CONTENTS_SOLID)
+					trace->inwater = true;
+				rht = rht_empty;
+			}
+		}
 
-	rht = Q1BSP_RecursiveHullTrace (ctx, node->children[side], p1f, midf, p1, mid, trace);
-	if (rht != rht_empty && !trace->allsolid)
-		return rht;
-	rht = Q1BSP_RecursiveHullTrace (ctx, node->children[side ^ 1], midf, p2f, mid, p2, trace);
-	if (rht != rht_solid)
-		return rht;
+		/*return up until a node still has its far side to trace*/
+		for (; depth > 0; depth--)
+		{
+			frame = &stack[depth - 1];
+			if (!frame->back)
+			{
+				if (rht != rht_empty && !trace->allsolid)
+					continue;
+				break;
+			}
+			if (rht != rht_solid)
+				continue;
 
-	if (side)
-	{
-		/*we impacted the back of the node, so flip the plane*/
-		trace->plane.dist = -plane->dist;
-		VectorNegate (plane->normal, trace->plane.normal);
-		midf = (t1 + DIST_EPSILON) / (t1 - t2);
-	}
-	else
-	{
-		/*we impacted the front of the node*/
-		trace->plane.dist = plane->dist;
-		VectorCopy (plane->normal, trace->plane.normal);
-		midf = (t1 - DIST_EPSILON) / (t1 - t2);
-	}
+			plane = frame->plane;
+			if (frame->side)
+			{
+				/*we impacted the back of the node, so flip the plane*/
+				trace->plane.dist = -plane->dist;
+				VectorNegate (plane->normal, trace->plane.normal);
+			}
+			else
+			{
+				/*we impacted the front of the node*/
+				trace->plane.dist = plane->dist;
+				VectorCopy (plane->normal, trace->plane.normal);
+			}
 
-	t1 = DoublePrecisionDotProduct (trace->plane.normal, ctx->start) - trace->plane.dist;
-	t2 = DoublePrecisionDotProduct (trace->plane.normal, ctx->end) - trace->plane.dist;
-	midf = (t1 - DIST_EPSILON) / (t1 - t2);
+			t1 = DoublePrecisionDotProduct (trace->plane.normal, ctx->start) - trace->plane.dist;
+			t2 = DoublePrecisionDotProduct (trace->plane.normal, ctx->end) - trace->plane.dist;
+			midf = (t1 - DIST_EPSILON) / (t1 - t2);
 
-	midf = CLAMP (0, midf, 1);
-	trace->fraction = midf;
-	VectorCopy (mid, trace->endpos);
-	VectorInterpolate (ctx->start, midf, ctx->end, trace->endpos);
+			midf = CLAMP (0, midf, 1);
+			trace->fraction = midf;
+			VectorInterpolate (ctx->start, midf, ctx->end, trace->endpos);
 
-	return rht_impact;
+			rht = rht_impact;
+		}
+		if (!depth)
+			return rht;
+
+		frame->back = true;
+		num = frame->node->children[frame->side ^ 1];
+		p1f = frame->midf;
+		p2f = frame->p2f;
+		VectorCopy (frame->mid, start);
+		VectorCopy (frame->p2, end);
+	}
 }
 
 static qboolean SV_SlowRecursiveHullCheck (hull_t *hull, int num, float p1f, float p2f, vec3_t p1, vec3_t p2, trace_t *trace)
@@ -1249,6 +1596,210 @@ boxmaxs[0] = boxmaxs[1] = boxmaxs[2] = 9999;
 #endif
 }
 
+/*
+===============================================================================
+
+PREFETCHED WORLD TRACES
+
+===============================================================================
+*/
+
+// world part of a move that is expected to happen this frame, traced by the task workers
+typedef struct
+{
+	int		entnum; // of the moving entity
+	vec3_t	start, mins, maxs, end;
+	trace_t trace;
+} worldtrace_t;
+
+#define MIN_PREFETCH_TRACES 16 // not worth a task below that
+
+// only touched by the main thread, except for the traces while the task is running
+static worldtrace_t *world_traces;
+static int			 num_world_traces;
+static int			 max_world_traces;
+static int			 world_trace_index[MAX_EDICTS]; // trace number + 1 by passedict
+static edict_t		*world_trace_world;
+static hull_t		*world_trace_hulls;
+static float		 world_trace_modelindex;
+static vec3_t		 world_trace_origin;
+static task_handle_t world_trace_task;
+static qboolean		 world_traces_pending; // submitted but not joined
+
+/*
+==================
+SV_QueueWorldTrace
+
+Queues the world trace of a move of ent from its origin to end, for SV_Move to pick up if the
+move really happens. Only the first move of each entity can be queued.
+==================
+*/
+void SV_QueueWorldTrace (edict_t *ent, const vec3_t end)
+{
+	edict_t		 *world = sv.qcvm.edicts;
+	qmodel_t	 *model;
+	worldtrace_t *wt;
+	int			  entnum;
+
+	if (world_traces_pending || qcvm != &sv.qcvm)
+		return;
+
+	// only the plain world hull is replicated by the workers, see SV_ClipMoveToEntity
+	if (world->v.solid != SOLID_BSP || (world->v.movetype != MOVETYPE_PUSH && !pr_checkextension.value))
+		return;
+	model = qcvm->GetModel (world->v.modelindex);
+	if (!model || model->type != mod_brush)
+		return;
+
+	entnum = NUM_FOR_EDICT (ent);
+	if (world_trace_index[entnum])
+		return;
+
+	if (!num_world_traces)
+	{
+		world_trace_world = world;
+		world_trace_hulls = model->hulls;
+		world_trace_modelindex = world->v.modelindex;
+		VectorCopy (world->v.origin, world_trace_origin);
+	}
+	else if (world_trace_hulls != model->hulls)
+		return;
+
+	if (num_world_traces == max_world_traces)
+	{
+		max_world_traces = q_max (64, max_world_traces * 2);
+		world_traces = Mem_Realloc (world_traces, max_world_traces * sizeof (worldtrace_t));
+	}
+	wt = &world_traces[num_world_traces++];
+	wt->entnum = entnum;
+	VectorCopy (ent->v.origin, wt->start);
+	VectorCopy (ent->v.mins, wt->mins);
+	VectorCopy (ent->v.maxs, wt->maxs);
+	VectorCopy (end, wt->end);
+	world_trace_index[entnum] = num_world_traces;
+}
+
+/*
+==================
+SV_WorldTraceTask
+
+Same as SV_ClipMoveToEntity on the world entity, without going through qcvm
+==================
+*/
+static void SV_WorldTraceTask (int index, void *unused)
+{
+	worldtrace_t *wt = &world_traces[index];
+	trace_t		  trace;
+	vec3_t		  size, offset;
+	vec3_t		  start_l, end_l;
+	hull_t		 *hull;
+
+	memset (&trace, 0, sizeof (trace_t));
+	trace.fraction = 1;
+	trace.allsolid = true;
+	VectorCopy (wt->end, trace.endpos);
+
+	VectorSubtract (wt->maxs, wt->mins, size);
+	if (size[0] < 3)
+		hull = &world_trace_hulls[0];
+	else if (size[0] <= 32)
+		hull = &world_trace_hulls[1];
+	else
+		hull = &world_trace_hulls[2];
+
+	VectorSubtract (hull->clip_mins, wt->mins, offset);
+	VectorAdd (offset, world_trace_origin, offset);
+
+	VectorSubtract (wt->start, offset, start_l);
+	VectorSubtract (wt->end, offset, end_l);
+	SV_RecursiveHullCheck (hull, start_l, end_l, &trace, CONTENTMASK_ANYSOLID);
+
+	if (trace.fraction != 1)
+		VectorAdd (trace.endpos, offset, trace.endpos);
+	if (trace.fraction < 1 || trace.startsolid)
+		trace.ent = world_trace_world;
+
+	wt->trace = trace;
+}
+
+/*
+==================
+SV_SubmitWorldTraces
+==================
+*/
+void SV_SubmitWorldTraces (void)
+{
+	if (world_traces_pending)
+		return;
+	if (num_world_traces < MIN_PREFETCH_TRACES)
+	{
+		SV_FinishWorldTraces ();
+		return;
+	}
+	world_trace_task = Task_AllocateAssignIndexedFuncAndSubmit (SV_WorldTraceTask, num_world_traces, NULL, 0);
+	world_traces_pending = true;
+}
+
+/*
+==================
+SV_FinishWorldTraces
+
+Waits for the workers and drops the traces that were not used
+==================
+*/
+void SV_FinishWorldTraces (void)
+{
+	int i;
+
+	if (world_traces_pending)
+	{
+		Task_Join (world_trace_task, TASK_TIMEOUT_INFINITE);
+		world_traces_pending = false;
+	}
+	for (i = 0; i < num_world_traces; i++)
+		world_trace_index[world_traces[i].entnum] = 0;
+	num_world_traces = 0;
+}
+
+/*
+==================
+SV_PrefetchedWorldTrace
+
+Returns the prefetched world trace if it was queued for exactly this move and the world is unchanged
+==================
+*/
+static qboolean SV_PrefetchedWorldTrace (
+	vec3_t start, vec3_t mins, vec3_t maxs, vec3_t end, unsigned int hitcontents, edict_t *passedict, trace_t *trace)
+{
+	edict_t		 *world = sv.qcvm.edicts;
+	worldtrace_t *wt;
+	int			  entnum;
+
+	if (!num_world_traces || !passedict || qcvm != &sv.qcvm || hitcontents != CONTENTMASK_ANYSOLID)
+		return false;
+	entnum = NUM_FOR_EDICT (passedict);
+	if (!world_trace_index[entnum])
+		return false;
+	wt = &world_traces[world_trace_index[entnum] - 1];
+	world_trace_index[entnum] = 0; // only the first move of the entity can match
+
+	// bitwise compares, the trace has to be the one SV_ClipMoveToEntity would make
+	if (memcmp (wt->start, start, sizeof (vec3_t)) || memcmp (wt->mins, mins, sizeof (vec3_t)) || memcmp (wt->maxs, maxs, sizeof (vec3_t)) ||
+		memcmp (wt->end, end, sizeof (vec3_t)))
+		return false;
+	if (world != world_trace_world || world->v.solid != SOLID_BSP || world->v.modelindex != world_trace_modelindex ||
+		memcmp (world->v.origin, world_trace_origin, sizeof (vec3_t)) || (world->v.movetype != MOVETYPE_PUSH && !pr_checkextension.value))
+		return false;
+
+	if (world_traces_pending)
+	{
+		Task_Join (world_trace_task, TASK_TIMEOUT_INFINITE);
+		world_traces_pending = false;
+	}
+	*trace = wt->trace;
+	return true;
+}
+
 /*
 ==================
 SV_Move
@@ -1267,7 +1818,8 @@ trace_t SV_Move (vec3_t start, vec3_t mins, vec3_t maxs, vec3_t end, int type, e
 		clip.hitcontents = CONTENTMASK_ANYSOLID;
 
 	// clip to world
-	clip.trace = SV_ClipMoveToEntity (qcvm->edicts, start, mins, maxs, end, clip.hitcontents);
+	if (!SV_PrefetchedWorldTrace (start, mins, maxs, end, clip.hitcontents, passedict, &clip.trace))
+		clip.trace = SV_ClipMoveToEntity (qcvm->edicts, start, mins, maxs, end, clip.hitcontents);
 
 	clip.start = start;
 	clip.end = end;
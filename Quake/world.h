@@ -51,6 +51,11 @@ typedef struct
 void SV_ClearWorld (void);
 // called after the world model has been loaded, before linking any entities
 
+void SV_RebalanceAreaNodes (void);
+// rebuilds the areanodes around the currently linked entities
+
+void SV_AreaStats_f (void);
+
 void SV_UnlinkEdict (edict_t *ent);
 // call before removing an entity, and before trying to move one,
 // so it doesn't clip against itself
@@ -62,6 +67,9 @@ void SV_LinkEdict (edict_t *ent, qboolean touch_triggers);
 // sets ent->v.absmin and ent->v.absmax
 // if touchtriggers, calls prog functions for the intersected triggers
 
+int SV_AreaEdicts (const vec3_t mins, const vec3_t maxs, edict_t **list, const int listspace);
+// lists the solid and trigger edicts linked in the areanodes the box reaches, in edict order
+
 int SV_PointContentsAllBsps (vec3_t p, edict_t *forent); // check all SOLID_BSP ents
 int SV_PointContents (vec3_t p);
 int SV_TruePointContents (vec3_t p);
@@ -87,6 +95,11 @@ trace_t SV_Move (vec3_t start, vec3_t mins, vec3_t maxs, vec3_t end, int type, e
 
 // passedict is explicitly excluded from clipping checks (normally NULL)
 
+// world traces of predicted moves, run by the task workers and picked up by SV_Move when the move matches
+void SV_QueueWorldTrace (edict_t *ent, const vec3_t end);
+void SV_SubmitWorldTraces (void);
+void SV_FinishWorldTraces (void);
+
 int SV_HullPointContents (hull_t *hull, int num, vec3_t p);
 
 qboolean SV_RecursiveHullCheck (hull_t *hull, vec3_t p1, vec3_t p2, trace_t *trace, unsigned int hitcontents);
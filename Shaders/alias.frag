@@ -29,11 +29,15 @@ layout (location = 0) in vec2 in_texcoord;
 layout (location = 1) in vec4 in_color;
 layout (location = 2) in float in_fog_frag_coord;
 
+layout (constant_id = 0) const bool use_alpha_test = false;
+
 layout (location = 0) out vec4 out_frag_color;
 
 void main ()
 {
 	vec4 result = texture (diffuse_tex, in_texcoord.xy);
+	if (use_alpha_test && result.a < 0.666f)
+		discard;
 
 	float original_diffuse_tex_a = result.a;
 	result.a = 1.0;
@@ -16,11 +16,15 @@ layout (location = 0) in vec4 in_texcoord;
 layout (location = 1) in vec4 in_color;
 layout (location = 2) in float in_fog_frag_coord;
 
+layout (constant_id = 0) const bool use_alpha_test = false;
+
 layout (location = 0) out vec4 out_frag_color;
 
 void main ()
 {
 	out_frag_color = in_color * texture (tex, in_texcoord.xy);
+	if (use_alpha_test && out_frag_color.a < 0.666f)
+		discard;
 
 	float fog = exp (-push_constants.fog_density * push_constants.fog_density * in_fog_frag_coord * in_fog_frag_coord);
 	fog = clamp (fog, 0.0, 1.0);
@@ -0,0 +1,7 @@
+#version 460
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+#extension GL_GOOGLE_include_directive : enable
+
+#define SCREEN_EFFECTS
+#include "postprocess.inc"
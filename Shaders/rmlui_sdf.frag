@@ -0,0 +1,20 @@
+#version 460
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+layout (set = 0, binding = 0) uniform sampler2D tex;
+
+layout (location = 0) in vec4 in_color;
+layout (location = 1) in vec2 in_texcoord;
+
+layout (location = 0) out vec4 out_frag_color;
+
+void main()
+{
+    // Distance to the glyph outline in alpha, 0.5 on the outline and larger inside.
+    // The edge is smoothed over about one screen pixel at whatever size the glyph is drawn.
+    float distance = texture(tex, in_texcoord).a;
+    float width = max(length(vec2(dFdx(distance), dFdy(distance))) * 0.7071, 1.0 / 255.0);
+    float coverage = smoothstep(0.5 - width, 0.5 + width, distance);
+    out_frag_color = in_color * coverage;
+}
@@ -27,13 +27,13 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 DECLARE_SHADER_SPV (basic_vert);
 DECLARE_SHADER_SPV (basic_frag);
-DECLARE_SHADER_SPV (basic_alphatest_frag);
 DECLARE_SHADER_SPV (basic_notex_frag);
 DECLARE_SHADER_SPV (world_vert);
 DECLARE_SHADER_SPV (world_frag);
+DECLARE_SHADER_SPV (world_bindless_frag);
 DECLARE_SHADER_SPV (alias_vert);
+DECLARE_SHADER_SPV (alias_instanced_vert);
 DECLARE_SHADER_SPV (alias_frag);
-DECLARE_SHADER_SPV (alias_alphatest_frag);
 DECLARE_SHADER_SPV (md5_vert);
 DECLARE_SHADER_SPV (sky_layer_vert);
 DECLARE_SHADER_SPV (sky_layer_frag);
@@ -42,6 +42,7 @@ DECLARE_SHADER_SPV (sky_cube_vert);
 DECLARE_SHADER_SPV (sky_cube_frag);
 DECLARE_SHADER_SPV (postprocess_vert);
 DECLARE_SHADER_SPV (postprocess_frag);
+DECLARE_SHADER_SPV (postprocess_fused_frag);
 DECLARE_SHADER_SPV (screen_effects_8bit_comp);
 DECLARE_SHADER_SPV (screen_effects_8bit_scale_comp);
 DECLARE_SHADER_SPV (screen_effects_8bit_scale_sops_comp);
@@ -49,8 +50,14 @@ DECLARE_SHADER_SPV (screen_effects_10bit_comp);
 DECLARE_SHADER_SPV (screen_effects_10bit_scale_comp);
 DECLARE_SHADER_SPV (screen_effects_10bit_scale_sops_comp);
 DECLARE_SHADER_SPV (cs_tex_warp_comp);
+DECLARE_SHADER_SPV (depth_pyramid_comp);
+DECLARE_SHADER_SPV (shading_rate_comp);
+DECLARE_SHADER_SPV (dlight_clusters_comp);
 DECLARE_SHADER_SPV (indirect_comp);
 DECLARE_SHADER_SPV (indirect_clear_comp);
+DECLARE_SHADER_SPV (indirect_occlusion_comp);
+DECLARE_SHADER_SPV (mark_leafs_comp);
+DECLARE_SHADER_SPV (update_particles_comp);
 DECLARE_SHADER_SPV (showtris_vert);
 DECLARE_SHADER_SPV (showtris_frag);
 DECLARE_SHADER_SPV (update_lightmap_8bit_comp);
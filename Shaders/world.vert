@@ -16,6 +16,7 @@ layout (location = 2) in vec2 in_texcoord2;
 
 layout (location = 0) out vec4 out_texcoords;
 layout (location = 1) out float out_fog_frag_coord;
+layout (location = 2) flat out uint out_texture_indices; // only used by world_bindless.frag
 
 out gl_PerVertex
 {
@@ -29,4 +30,5 @@ void main ()
 	gl_Position = push_constants.mvp * vec4 (in_position, 1.0f);
 
 	out_fog_frag_coord = gl_Position.w;
+	out_texture_indices = gl_InstanceIndex;
 }
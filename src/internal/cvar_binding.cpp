@@ -70,6 +70,7 @@ bool														  CvarBindingManager::s_initialized = false;
 ICvarProvider												 *CvarBindingManager::s_provider = nullptr;
 bool														  CvarBindingManager::s_ignore_ui_changes = false;
 int															  CvarBindingManager::s_ignore_ui_changes_frames = 0;
+const CvarBinding											 *CvarBindingManager::s_syncing_binding = nullptr;
 
 namespace
 {
@@ -525,6 +526,11 @@ void CvarBindingManager::Shutdown ()
 	if (!s_initialized)
 		return;
 
+	for (auto &pair : s_bindings)
+	{
+		if (pair.second.subscribed)
+			GetProvider ()->Unsubscribe (pair.second.cvar_name, OnCvarChanged, &pair.second);
+	}
 	s_bindings.clear ();
 	s_float_values.clear ();
 	s_int_values.clear ();
@@ -627,7 +633,7 @@ void CvarBindingManager::RegisterFloat (const char *cvar, const char *ui_name, f
 	binding.max_value = max;
 	binding.step = step;
 
-	s_bindings[ui_name] = binding;
+	StoreBinding (binding);
 
 	BindOrUpdateFloat (ui_name, GetProvider ()->GetFloat (cvar));
 
@@ -644,7 +650,7 @@ void CvarBindingManager::RegisterBool (const char *cvar, const char *ui_name)
 	binding.ui_name = ui_name;
 	binding.type = CvarType::Bool;
 
-	s_bindings[ui_name] = binding;
+	StoreBinding (binding);
 
 	int value = IsInvertMouseBinding (ui_name) ? GetInvertMouseValue (GetProvider ()) : static_cast<int> (GetProvider ()->GetFloat (cvar));
 	BindOrUpdateInt (ui_name, value);
@@ -664,7 +670,7 @@ void CvarBindingManager::RegisterInt (const char *cvar, const char *ui_name, int
 	binding.min_value = static_cast<float> (min);
 	binding.max_value = static_cast<float> (max);
 
-	s_bindings[ui_name] = binding;
+	StoreBinding (binding);
 
 	BindOrUpdateInt (ui_name, static_cast<int> (GetProvider ()->GetFloat (cvar)));
 
@@ -736,7 +742,7 @@ void CvarBindingManager::RegisterEnum (const char *cvar, const char *ui_name, in
 		}
 	}
 
-	s_bindings[ui_name] = binding;
+	StoreBinding (binding);
 
 	BindOrUpdateInt (ui_name, static_cast<int> (GetProvider ()->GetFloat (cvar)));
 	BindEnumLabel (ui_name);
@@ -773,7 +779,7 @@ void CvarBindingManager::RegisterEnumValues (const char *cvar, const char *ui_na
 		}
 	}
 
-	s_bindings[ui_name] = binding;
+	StoreBinding (binding);
 
 	BindOrUpdateInt (ui_name, static_cast<int> (GetProvider ()->GetFloat (cvar)));
 	BindEnumLabel (ui_name);
@@ -791,13 +797,100 @@ void CvarBindingManager::RegisterString (const char *cvar, const char *ui_name)
 	binding.ui_name = ui_name;
 	binding.type = CvarType::String;
 
-	s_bindings[ui_name] = binding;
+	StoreBinding (binding);
 
 	BindOrUpdateString (ui_name, GetProvider ()->GetString (cvar));
 
 	Con_DPrintf ("CvarBindingManager: Registered string '%s' -> '%s'\n", cvar, ui_name);
 }
 
+bool CvarBindingManager::ReadFromCvar (const CvarBinding &binding)
+{
+	const char *cvar_name = binding.cvar_name.c_str ();
+
+	switch (binding.type)
+	{
+	case CvarType::Float:
+		if (auto it = s_float_values.find (binding.ui_name); it != s_float_values.end () && it->second)
+		{
+			const float value = GetProvider ()->GetFloat (cvar_name);
+			if (*(it->second) != value)
+			{
+				*(it->second) = value;
+				return true;
+			}
+		}
+		break;
+	case CvarType::Bool:
+	case CvarType::Int:
+	case CvarType::Enum:
+		if (auto it = s_int_values.find (binding.ui_name); it != s_int_values.end () && it->second)
+		{
+			int value;
+			if (IsInvertMouseBinding (binding.ui_name))
+			{
+				value = GetInvertMouseValue (GetProvider ());
+			}
+			else if (IsPackedColorBinding (binding.ui_name))
+			{
+				int packed = static_cast<int> (GetProvider ()->GetFloat (cvar_name));
+				value = UnpackColorHalf (packed, binding.ui_name);
+			}
+			else
+			{
+				value = static_cast<int> (GetProvider ()->GetFloat (cvar_name));
+			}
+			if (*(it->second) != value)
+			{
+				*(it->second) = value;
+				return true;
+			}
+		}
+		break;
+	case CvarType::String:
+		if (auto it = s_string_values.find (binding.ui_name); it != s_string_values.end () && it->second)
+		{
+			Rml::String value = GetProvider ()->GetString (cvar_name);
+			if (*(it->second) != value)
+			{
+				*(it->second) = std::move (value);
+				return true;
+			}
+		}
+		break;
+	}
+	return false;
+}
+
+void CvarBindingManager::StoreBinding (const CvarBinding &binding)
+{
+	auto it = s_bindings.find (binding.ui_name);
+	if (it != s_bindings.end () && it->second.subscribed)
+		GetProvider ()->Unsubscribe (it->second.cvar_name, OnCvarChanged, &it->second);
+
+	// Map nodes never move, so the binding address is a stable subscription key
+	CvarBinding &stored = s_bindings[binding.ui_name];
+	stored = binding;
+	stored.subscribed = GetProvider ()->Subscribe (stored.cvar_name, OnCvarChanged, &stored);
+}
+
+void CvarBindingManager::OnCvarChanged (void *userdata)
+{
+	const CvarBinding *binding = static_cast<const CvarBinding *> (userdata);
+
+	// The UI already holds the value it is writing back
+	if (!s_initialized || binding == s_syncing_binding || !ReadFromCvar (*binding))
+		return;
+
+	// Only dirty what depends on this cvar, labels follow the <name>_label convention
+	if (s_model_handle)
+	{
+		s_model_handle.DirtyVariable (binding->ui_name);
+		s_model_handle.DirtyVariable (binding->ui_name + "_label");
+		s_model_handle.DirtyVariable (binding->cvar_name + "_label");
+	}
+}
+
 void CvarBindingManager::SyncToUI ()
 {
 	if (!s_initialized)
@@ -811,52 +904,19 @@ void CvarBindingManager::SyncToUI ()
 	s_ignore_ui_changes = true;
 	s_ignore_ui_changes_frames = 2;
 
+	size_t polled = 0;
 	for (auto &pair : s_bindings)
 	{
-		const CvarBinding &binding = pair.second;
-		const char		  *cvar_name = binding.cvar_name.c_str ();
-
-		switch (binding.type)
+		if (!pair.second.subscribed)
 		{
-		case CvarType::Float:
-			if (auto it = s_float_values.find (binding.ui_name); it != s_float_values.end () && it->second)
-			{
-				*(it->second) = GetProvider ()->GetFloat (cvar_name);
-			}
-			break;
-		case CvarType::Bool:
-		case CvarType::Int:
-		case CvarType::Enum:
-			if (auto it = s_int_values.find (binding.ui_name); it != s_int_values.end () && it->second)
-			{
-				if (IsInvertMouseBinding (binding.ui_name))
-				{
-					*(it->second) = GetInvertMouseValue (GetProvider ());
-				}
-				else if (IsPackedColorBinding (binding.ui_name))
-				{
-					int packed = static_cast<int> (GetProvider ()->GetFloat (cvar_name));
-					*(it->second) = UnpackColorHalf (packed, binding.ui_name);
-				}
-				else
-				{
-					*(it->second) = static_cast<int> (GetProvider ()->GetFloat (cvar_name));
-				}
-			}
-			break;
-		case CvarType::String:
-		{
-			if (auto it = s_string_values.find (binding.ui_name); it != s_string_values.end () && it->second)
-			{
-				*(it->second) = GetProvider ()->GetString (cvar_name);
-			}
-			break;
-		}
+			ReadFromCvar (pair.second);
+			polled++;
 		}
 	}
 
+	// Still dirty everything, the label functions read cvars that have no binding of their own
 	MarkDirty ();
-	Con_DPrintf ("CvarBindingManager: Synced %zu cvars to UI\n", s_bindings.size ());
+	Con_DPrintf ("CvarBindingManager: Synced %zu of %zu cvars to UI\n", polled, s_bindings.size ());
 }
 
 bool CvarBindingManager::ShouldIgnoreUIChange ()
@@ -891,6 +951,7 @@ void CvarBindingManager::SyncFromUI (const std::string &ui_name)
 	const CvarBinding &binding = it->second;
 	const char		  *cvar_name = binding.cvar_name.c_str ();
 
+	s_syncing_binding = &binding;
 	switch (binding.type)
 	{
 	case CvarType::Float:
@@ -936,6 +997,7 @@ void CvarBindingManager::SyncFromUI (const std::string &ui_name)
 		break;
 	}
 	}
+	s_syncing_binding = nullptr;
 }
 
 void CvarBindingManager::SyncAllFromUI ()
@@ -62,7 +62,8 @@ class CvarBindingManager
 	// Register a string cvar
 	static void RegisterString (const char *cvar, const char *ui_name);
 
-	// Sync all cvar values to UI (call when opening menu)
+	// Sync cvar values to UI (call when opening menu). Subscribed bindings already follow
+	// their cvar, only the ones the provider cannot notify are re-read.
 	static void SyncToUI ();
 
 	// Sync a specific UI value back to its cvar (call on UI change event)
@@ -126,6 +127,13 @@ class CvarBindingManager
 	static void RegisterAllBindings ();
 	static void BindEnumLabel (const char *ui_name);
 
+	// Stores the binding and subscribes it to cvar changes, replacing an earlier binding of the same UI name
+	static void StoreBinding (const CvarBinding &binding);
+	static void OnCvarChanged (void *userdata);
+
+	// Copies the cvar value into the binding's backing store, returns true if it changed
+	static bool ReadFromCvar (const CvarBinding &binding);
+
 	// Common helpers to create-or-update a value pointer and bind it to the data model
 	static void BindOrUpdateInt (const char *ui_name, int value);
 	static void BindOrUpdateFloat (const char *ui_name, float value);
@@ -141,6 +149,7 @@ class CvarBindingManager
 	static ICvarProvider												*s_provider; // Injected cvar provider
 	static bool															 s_ignore_ui_changes;
 	static int															 s_ignore_ui_changes_frames;
+	static const CvarBinding											*s_syncing_binding; // SyncFromUI() in progress
 };
 
 } // namespace QRmlUI
@@ -118,6 +118,22 @@ extern __thread int file_from_pak;
 	int	   FS_fclose (fshandle_t *fh);
 	long   FS_filelength (fshandle_t *fh);
 
+	/* ── Task system ──────────────────────────────────────────────────── */
+
+	/* Mirrored from tasks.h. Task_Join returns qboolean, which is C99 bool.
+	 * TASK_TIMEOUT_INFINITE is SDL_MUTEX_MAXWAIT (SDL2) or -1 (SDL3), both UINT32_MAX. */
+#include <stdint.h>
+	typedef uint64_t task_handle_t;
+	typedef void (*task_func_t) (void *);
+
+	task_handle_t Task_Allocate (void);
+	void		  Task_AssignFunc (task_handle_t handle, task_func_t func, void *payload, size_t payload_size);
+	void		  Task_Submit (task_handle_t handle);
+	bool		  Task_Join (task_handle_t handle, uint32_t timeout);
+
+#define INVALID_TASK_HANDLE	  UINT64_MAX
+#define TASK_TIMEOUT_INFINITE UINT32_MAX
+
 	/* ── Engine-side UI sync callbacks ────────────────────────────────── */
 	/* These are engine functions (guarded by USE_RMLUI in their source
 	 * files) that push data into the RmlUI layer on demand. */
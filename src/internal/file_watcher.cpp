@@ -0,0 +1,334 @@
+/*
+ * vkQuake RmlUI - File Watcher Implementation
+ */
+
+#include "file_watcher.h"
+
+#include <filesystem>
+#include <system_error>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <unordered_map>
+#elif defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <chrono>
+#include <unordered_map>
+#endif
+
+namespace QRmlUI
+{
+
+namespace fs = std::filesystem;
+
+#if defined(__linux__)
+
+// One watch per directory, inotify doesn't recurse. Directories created later get theirs when reported.
+struct FileWatcher::Impl
+{
+	struct WatchedDir
+	{
+		std::string path;
+		std::string relative;
+	};
+
+	int									fd = -1;
+	std::unordered_map<int, WatchedDir> watches;
+
+	void AddTree (const std::string &path, const std::string &relative)
+	{
+		const int wd = inotify_add_watch (fd, path.c_str (), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR);
+		if (wd < 0)
+			return;
+		watches[wd] = {path, relative};
+
+		std::error_code ec;
+		for (fs::directory_iterator it (path, ec), end; !ec && it != end; it.increment (ec))
+		{
+			if (it->is_directory (ec))
+			{
+				const std::string name = it->path ().filename ().string ();
+				AddTree (path + "/" + name, relative + "/" + name);
+			}
+		}
+	}
+};
+
+bool FileWatcher::Start (const std::vector<std::string> &directories)
+{
+	Stop ();
+	m_impl->fd = inotify_init1 (IN_NONBLOCK | IN_CLOEXEC);
+	if (m_impl->fd < 0)
+		return false;
+	for (const std::string &directory : directories)
+		m_impl->AddTree (directory, fs::path (directory).filename ().string ());
+	if (m_impl->watches.empty ())
+		Stop ();
+	return IsWatching ();
+}
+
+void FileWatcher::Stop ()
+{
+	if (m_impl->fd >= 0)
+		close (m_impl->fd);
+	m_impl->fd = -1;
+	m_impl->watches.clear ();
+}
+
+bool FileWatcher::IsWatching () const
+{
+	return m_impl->fd >= 0;
+}
+
+void FileWatcher::Poll (std::vector<std::string> &changed)
+{
+	if (m_impl->fd < 0)
+		return;
+
+	alignas (struct inotify_event) char buffer[4096];
+	for (;;)
+	{
+		const ssize_t length = read (m_impl->fd, buffer, sizeof (buffer));
+		if (length <= 0)
+			break;
+
+		for (ssize_t offset = 0; offset < length;)
+		{
+			const struct inotify_event *event = reinterpret_cast<const struct inotify_event *> (buffer + offset);
+			offset += sizeof (struct inotify_event) + event->len;
+
+			auto it = m_impl->watches.find (event->wd);
+			if (it == m_impl->watches.end ())
+				continue;
+			if (event->mask & IN_IGNORED)
+			{
+				m_impl->watches.erase (it);
+				continue;
+			}
+			if (!event->len)
+				continue;
+
+			// Copies, AddTree can rehash the watches
+			const std::string path = it->second.path + "/" + event->name;
+			const std::string relative = it->second.relative + "/" + event->name;
+			if (event->mask & IN_ISDIR)
+			{
+				if (event->mask & (IN_CREATE | IN_MOVED_TO))
+					m_impl->AddTree (path, relative);
+			}
+			else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+				changed.push_back (relative);
+		}
+	}
+}
+
+#elif defined(_WIN32)
+
+// One recursive ReadDirectoryChangesW per directory, polled through its OVERLAPPED
+struct FileWatcher::Impl
+{
+	struct WatchedRoot
+	{
+		HANDLE		directory = INVALID_HANDLE_VALUE;
+		OVERLAPPED	overlapped = {};
+		std::string relative;
+		alignas (DWORD) BYTE buffer[16384]; // FILE_NOTIFY_INFORMATION records
+	};
+
+	std::vector<std::unique_ptr<WatchedRoot>> roots;
+
+	static bool Issue (WatchedRoot &root)
+	{
+		const DWORD filter = FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME;
+		return ReadDirectoryChangesW (root.directory, root.buffer, sizeof (root.buffer), TRUE, filter, NULL, &root.overlapped, NULL) != 0;
+	}
+
+	static void Close (WatchedRoot &root)
+	{
+		// The buffer must not be written to after it's freed
+		DWORD bytes;
+		if (CancelIoEx (root.directory, &root.overlapped) || GetLastError () != ERROR_NOT_FOUND)
+			GetOverlappedResult (root.directory, &root.overlapped, &bytes, TRUE);
+		CloseHandle (root.overlapped.hEvent);
+		CloseHandle (root.directory);
+	}
+};
+
+bool FileWatcher::Start (const std::vector<std::string> &directories)
+{
+	Stop ();
+	for (const std::string &directory : directories)
+	{
+		auto root = std::make_unique<Impl::WatchedRoot> ();
+		root->directory = CreateFileA (
+			directory.c_str (), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING,
+			FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+		if (root->directory == INVALID_HANDLE_VALUE)
+			continue;
+		root->overlapped.hEvent = CreateEventA (NULL, TRUE, FALSE, NULL);
+		root->relative = fs::path (directory).filename ().string ();
+		if (!root->overlapped.hEvent || !Impl::Issue (*root))
+		{
+			if (root->overlapped.hEvent)
+				CloseHandle (root->overlapped.hEvent);
+			CloseHandle (root->directory);
+			continue;
+		}
+		m_impl->roots.push_back (std::move (root));
+	}
+	return IsWatching ();
+}
+
+void FileWatcher::Stop ()
+{
+	for (auto &root : m_impl->roots)
+		Impl::Close (*root);
+	m_impl->roots.clear ();
+}
+
+bool FileWatcher::IsWatching () const
+{
+	return !m_impl->roots.empty ();
+}
+
+void FileWatcher::Poll (std::vector<std::string> &changed)
+{
+	for (size_t i = 0; i < m_impl->roots.size ();)
+	{
+		Impl::WatchedRoot &root = *m_impl->roots[i];
+		DWORD			   bytes = 0;
+		if (!GetOverlappedResult (root.directory, &root.overlapped, &bytes, FALSE))
+		{
+			if (GetLastError () == ERROR_IO_INCOMPLETE)
+			{
+				i++;
+				continue;
+			}
+			// The directory went away
+			Impl::Close (root);
+			m_impl->roots.erase (m_impl->roots.begin () + i);
+			continue;
+		}
+
+		// No bytes when the buffer overflowed and the changes were lost
+		for (DWORD offset = 0; bytes > 0;)
+		{
+			const FILE_NOTIFY_INFORMATION *info = reinterpret_cast<const FILE_NOTIFY_INFORMATION *> (root.buffer + offset);
+			if (info->Action == FILE_ACTION_ADDED || info->Action == FILE_ACTION_MODIFIED || info->Action == FILE_ACTION_RENAMED_NEW_NAME)
+			{
+				const int	name_length = static_cast<int> (info->FileNameLength / sizeof (WCHAR));
+				const int	size = WideCharToMultiByte (CP_UTF8, 0, info->FileName, name_length, NULL, 0, NULL, NULL);
+				std::string name (size, '\0');
+				WideCharToMultiByte (CP_UTF8, 0, info->FileName, name_length, &name[0], size, NULL, NULL);
+				for (char &c : name)
+				{
+					if (c == '\\')
+						c = '/';
+				}
+				changed.push_back (root.relative + "/" + name);
+			}
+			if (!info->NextEntryOffset)
+				break;
+			offset += info->NextEntryOffset;
+		}
+
+		ResetEvent (root.overlapped.hEvent);
+		if (!Impl::Issue (root))
+		{
+			Impl::Close (root);
+			m_impl->roots.erase (m_impl->roots.begin () + i);
+			continue;
+		}
+		i++;
+	}
+}
+
+#else
+
+// No change notifications, the modification times of all files are compared every SCAN_INTERVAL
+struct FileWatcher::Impl
+{
+	static constexpr std::chrono::milliseconds SCAN_INTERVAL{500};
+
+	std::vector<std::string>							directories;
+	std::unordered_map<std::string, fs::file_time_type> times; // by reported path
+	std::chrono::steady_clock::time_point				next_scan;
+
+	void Scan (std::vector<std::string> *changed)
+	{
+		for (const std::string &directory : directories)
+		{
+			const std::string relative = fs::path (directory).filename ().string ();
+			std::error_code	  ec;
+			for (fs::recursive_directory_iterator it (directory, ec), end; !ec && it != end; it.increment (ec))
+			{
+				if (!it->is_regular_file (ec))
+					continue;
+				const fs::file_time_type time = it->last_write_time (ec);
+				if (ec)
+					continue;
+				const std::string path = relative + "/" + it->path ().lexically_relative (directory).generic_string ();
+				auto			  known = times.find (path);
+				if (known == times.end () || known->second != time)
+				{
+					times[path] = time;
+					if (changed)
+						changed->push_back (path);
+				}
+			}
+		}
+	}
+};
+
+bool FileWatcher::Start (const std::vector<std::string> &directories)
+{
+	Stop ();
+	for (const std::string &directory : directories)
+	{
+		std::error_code ec;
+		if (fs::is_directory (directory, ec))
+			m_impl->directories.push_back (directory);
+	}
+	m_impl->Scan (nullptr);
+	m_impl->next_scan = std::chrono::steady_clock::now () + Impl::SCAN_INTERVAL;
+	return IsWatching ();
+}
+
+void FileWatcher::Stop ()
+{
+	m_impl->directories.clear ();
+	m_impl->times.clear ();
+}
+
+bool FileWatcher::IsWatching () const
+{
+	return !m_impl->directories.empty ();
+}
+
+void FileWatcher::Poll (std::vector<std::string> &changed)
+{
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now ();
+	if (m_impl->directories.empty () || now < m_impl->next_scan)
+		return;
+	m_impl->Scan (&changed);
+	m_impl->next_scan = now + Impl::SCAN_INTERVAL;
+}
+
+#endif
+
+FileWatcher::FileWatcher () : m_impl (std::make_unique<Impl> ()) {}
+
+FileWatcher::~FileWatcher ()
+{
+	Stop ();
+}
+
+} // namespace QRmlUI
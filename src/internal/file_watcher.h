@@ -0,0 +1,46 @@
+/*
+ * vkQuake RmlUI - File Watcher
+ *
+ * Reports files written below a set of directories, for reloading UI assets
+ * while they are being edited. Uses inotify on Linux and ReadDirectoryChangesW
+ * on Windows, elsewhere the directories are rescanned for modification times.
+ */
+
+#ifndef QRMLUI_FILE_WATCHER_H
+#define QRMLUI_FILE_WATCHER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace QRmlUI
+{
+
+class FileWatcher
+{
+  public:
+	FileWatcher ();
+	~FileWatcher ();
+
+	FileWatcher (const FileWatcher &) = delete;
+	FileWatcher &operator= (const FileWatcher &) = delete;
+
+	// Watches everything below the directories that exist, replacing what was watched before.
+	// Paths are reported relative to the parent of their directory, a file written to
+	// "<gamedir>/ui/rcss/hud.rcss" while watching "<gamedir>/ui" is "ui/rcss/hud.rcss".
+	bool Start (const std::vector<std::string> &directories);
+	void Stop ();
+	bool IsWatching () const;
+
+	// Appends the files written, created or moved into place since the last call, never blocks.
+	// A file can be reported more than once.
+	void Poll (std::vector<std::string> &changed);
+
+  private:
+	struct Impl;
+	std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace QRmlUI
+
+#endif // QRMLUI_FILE_WATCHER_H
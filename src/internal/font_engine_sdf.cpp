@@ -0,0 +1,522 @@
+/*
+ * vkQuake RmlUI - Signed Distance Field Font Engine Implementation
+ *
+ * Glyphs are rendered by FreeType's SDF rasterizer into per-face atlas pages and
+ * drawn by the distance field pipeline of the render interface.
+ */
+
+#include "font_engine_sdf.h"
+#include "render_interface_vk.h"
+#include <RmlUi/Core/Core.h>
+#include <RmlUi/Core/FileInterface.h>
+#include <RmlUi/Core/Log.h>
+#include <RmlUi/Core/Mesh.h>
+#include <RmlUi/Core/RenderManager.h>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_MODULE_H
+#include FT_TRUETYPE_TABLES_H
+
+namespace QRmlUI
+{
+
+// Decodes the UTF-8 sequence at p and advances past it, malformed sequences become U+FFFD
+static uint32_t NextCharacter (const char *&p, const char *end)
+{
+	const unsigned char c = static_cast<unsigned char> (*p++);
+	if (c < 0x80)
+		return c;
+
+	int		 extra = (c >= 0xF0) ? 3 : (c >= 0xE0) ? 2 : (c >= 0xC0) ? 1 : 0;
+	uint32_t character = c & (0x3F >> extra);
+	if (extra == 0)
+		return 0xFFFD;
+	for (; extra > 0 && p < end && (static_cast<unsigned char> (*p) & 0xC0) == 0x80; --extra)
+		character = (character << 6) | (static_cast<unsigned char> (*p++) & 0x3F);
+	return extra ? 0xFFFD : character;
+}
+
+static std::string ToLower (const Rml::String &string)
+{
+	std::string lower = string;
+	std::transform (lower.begin (), lower.end (), lower.begin (), [] (unsigned char c) { return static_cast<char> (std::tolower (c)); });
+	return lower;
+}
+
+FontEngine_SDF::FontEngine_SDF (RenderInterface_VK *render_interface, Rml::FontEngineInterface *fallback)
+	: m_render_interface (render_interface), m_fallback (fallback), m_library (nullptr)
+{
+	if (FT_Init_FreeType (&m_library) != 0)
+	{
+		Rml::Log::Message (Rml::Log::LT_ERROR, "FontEngine_SDF: Failed to initialize FreeType");
+		m_library = nullptr;
+		return;
+	}
+
+	// The same spread for outlines and bitmaps, the shader only knows the edge is at 0.5
+	FT_Int spread = SPREAD;
+	FT_Property_Set (m_library, "sdf", "spread", &spread);
+	FT_Property_Set (m_library, "bsdf", "spread", &spread);
+}
+
+FontEngine_SDF::~FontEngine_SDF ()
+{
+	ReleaseFaces ();
+	if (m_library)
+		FT_Done_FreeType (m_library);
+}
+
+void FontEngine_SDF::Shutdown ()
+{
+	// Called by Rml::Shutdown while the render managers still exist to release the atlas textures
+	ReleaseFaces ();
+	if (m_fallback)
+	{
+		m_fallback->Shutdown ();
+		m_fallback = nullptr;
+	}
+}
+
+void FontEngine_SDF::ReleaseFaces ()
+{
+	m_instances.clear ();
+	for (auto &face : m_faces)
+		FT_Done_Face (face->ft_face);
+	m_faces.clear ();
+}
+
+bool FontEngine_SDF::LoadFontFace (const Rml::String &file_name, bool fallback_face, Rml::Style::FontWeight weight)
+{
+	if (m_fallback)
+		m_fallback->LoadFontFace (file_name, fallback_face, weight);
+
+	Rml::FileInterface *file_interface = Rml::GetFileInterface ();
+	Rml::FileHandle		file = file_interface->Open (file_name);
+	if (!file)
+	{
+		Rml::Log::Message (Rml::Log::LT_ERROR, "FontEngine_SDF: Failed to open font face '%s'", file_name.c_str ());
+		return false;
+	}
+
+	std::vector<Rml::byte> data (file_interface->Length (file));
+	const size_t		   read = file_interface->Read (data.data (), data.size (), file);
+	file_interface->Close (file);
+	if (read != data.size ())
+	{
+		Rml::Log::Message (Rml::Log::LT_ERROR, "FontEngine_SDF: Failed to read font face '%s'", file_name.c_str ());
+		return false;
+	}
+
+	return AddFace (std::move (data), Rml::String (), Rml::Style::FontStyle::Normal, weight, fallback_face);
+}
+
+bool FontEngine_SDF::LoadFontFace (
+	Rml::Span<const Rml::byte> data, const Rml::String &family, Rml::Style::FontStyle style, Rml::Style::FontWeight weight, bool fallback_face)
+{
+	if (m_fallback)
+		m_fallback->LoadFontFace (data, family, style, weight, fallback_face);
+
+	return AddFace (std::vector<Rml::byte> (data.begin (), data.end ()), family, style, weight, fallback_face);
+}
+
+// An empty family takes family and style from the face itself
+bool FontEngine_SDF::AddFace (
+	std::vector<Rml::byte> data, const Rml::String &family, Rml::Style::FontStyle style, Rml::Style::FontWeight weight, bool fallback_face)
+{
+	if (!m_library)
+		return false;
+
+	auto face = std::make_unique<Face> ();
+	face->data = std::move (data);
+	if (FT_New_Memory_Face (m_library, face->data.data (), static_cast<FT_Long> (face->data.size ()), 0, &face->ft_face) != 0)
+	{
+		Rml::Log::Message (Rml::Log::LT_ERROR, "FontEngine_SDF: Failed to load font face from memory");
+		return false;
+	}
+
+	FT_Face ft_face = face->ft_face;
+	if (!FT_IS_SCALABLE (ft_face) || !ft_face->family_name)
+	{
+		Rml::Log::Message (Rml::Log::LT_ERROR, "FontEngine_SDF: Font face '%s' has no outlines", ft_face->family_name ? ft_face->family_name : "");
+		FT_Done_Face (ft_face);
+		return false;
+	}
+	FT_Set_Pixel_Sizes (ft_face, 0, BASE_SIZE);
+
+	if (family.empty ())
+	{
+		face->family = ToLower (ft_face->family_name);
+		face->style = (ft_face->style_flags & FT_STYLE_FLAG_ITALIC) ? Rml::Style::FontStyle::Italic : Rml::Style::FontStyle::Normal;
+	}
+	else
+	{
+		face->family = ToLower (family);
+		face->style = style;
+	}
+
+	face->weight = weight;
+	if (weight == Rml::Style::FontWeight::Auto)
+	{
+		const TT_OS2 *os2 = static_cast<const TT_OS2 *> (FT_Get_Sfnt_Table (ft_face, FT_SFNT_OS2));
+		if (os2 && os2->usWeightClass > 0)
+			face->weight = static_cast<Rml::Style::FontWeight> (os2->usWeightClass);
+		else
+			face->weight = (ft_face->style_flags & FT_STYLE_FLAG_BOLD) ? Rml::Style::FontWeight::Bold : Rml::Style::FontWeight::Normal;
+	}
+	face->fallback_face = fallback_face;
+
+	// Printable ASCII up front, so the common text never grows the atlas at runtime
+	for (uint32_t character = 32; character < 127; ++character)
+	{
+		const FT_UInt glyph_index = FT_Get_Char_Index (ft_face, character);
+		Glyph		  glyph;
+		if (glyph_index && !face->glyphs.count (glyph_index) && RenderGlyph (face.get (), glyph_index, glyph))
+			face->glyphs[glyph_index] = glyph;
+	}
+
+	Rml::Log::Message (
+		Rml::Log::LT_DEBUG, "FontEngine_SDF: Loaded '%s' (%d atlas pages)", ft_face->family_name, static_cast<int> (face->pages.size ()));
+	m_faces.push_back (std::move (face));
+	return true;
+}
+
+bool FontEngine_SDF::RenderGlyph (Face *face, uint32_t glyph_index, Glyph &glyph)
+{
+	FT_Face ft_face = face->ft_face;
+	if (FT_Load_Glyph (ft_face, glyph_index, FT_LOAD_NO_HINTING | FT_LOAD_NO_BITMAP) != 0)
+		return false;
+
+	glyph = Glyph{};
+	glyph.advance = ft_face->glyph->advance.x / 64.0f;
+	glyph.page = -1;
+
+	// Spaces and other glyphs without an outline only advance
+	if (ft_face->glyph->format != FT_GLYPH_FORMAT_OUTLINE || ft_face->glyph->outline.n_points == 0)
+		return true;
+	if (FT_Render_Glyph (ft_face->glyph, FT_RENDER_MODE_SDF) != 0)
+		return true;
+
+	const FT_Bitmap &bitmap = ft_face->glyph->bitmap;
+	const int		 width = static_cast<int> (bitmap.width);
+	const int		 height = static_cast<int> (bitmap.rows);
+	if (width == 0 || height == 0 || width > PAGE_SIZE || height > PAGE_SIZE)
+		return true;
+
+	// Shelf packing with a texel of space between glyphs, a new page once the last one is full
+	AtlasPage *page = face->pages.empty () ? nullptr : &face->pages.back ();
+	if (page && page->shelf_x + width > PAGE_SIZE)
+	{
+		page->shelf_x = 0;
+		page->shelf_y += page->shelf_height + 1;
+		page->shelf_height = 0;
+	}
+	if (!page || page->shelf_y + height > PAGE_SIZE)
+	{
+		face->pages.emplace_back ();
+		page = &face->pages.back ();
+		page->distances.assign (PAGE_SIZE * PAGE_SIZE, 0);
+	}
+
+	const int x = page->shelf_x;
+	const int y = page->shelf_y;
+	for (int row = 0; row < height; ++row)
+		memcpy (&page->distances[(y + row) * PAGE_SIZE + x], bitmap.buffer + row * bitmap.pitch, width);
+	page->shelf_x += width + 1;
+	page->shelf_height = std::max (page->shelf_height, height);
+	page->texture_valid = false;
+
+	glyph.left = ft_face->glyph->bitmap_left;
+	glyph.top = ft_face->glyph->bitmap_top;
+	glyph.width = width;
+	glyph.height = height;
+	glyph.page = static_cast<int> (face->pages.size ()) - 1;
+	glyph.uv[0] = x / static_cast<float> (PAGE_SIZE);
+	glyph.uv[1] = y / static_cast<float> (PAGE_SIZE);
+	glyph.uv[2] = (x + width) / static_cast<float> (PAGE_SIZE);
+	glyph.uv[3] = (y + height) / static_cast<float> (PAGE_SIZE);
+	face->version++;
+	return true;
+}
+
+// Characters missing from the face are looked up in the fallback faces, then drawn as the face's missing glyph
+const FontEngine_SDF::Glyph *FontEngine_SDF::GetGlyph (Face *face, uint32_t character, Face *&glyph_face)
+{
+	glyph_face = face;
+	FT_UInt glyph_index = FT_Get_Char_Index (face->ft_face, character);
+	for (size_t i = 0; glyph_index == 0 && i < m_faces.size (); ++i)
+	{
+		Face *fallback = m_faces[i].get ();
+		if (fallback == face || !fallback->fallback_face)
+			continue;
+		glyph_index = FT_Get_Char_Index (fallback->ft_face, character);
+		if (glyph_index)
+			glyph_face = fallback;
+	}
+
+	auto it = glyph_face->glyphs.find (glyph_index);
+	if (it != glyph_face->glyphs.end ())
+		return &it->second;
+
+	Glyph glyph;
+	if (!RenderGlyph (glyph_face, glyph_index, glyph))
+		return nullptr;
+	return &(glyph_face->glyphs[glyph_index] = glyph);
+}
+
+float FontEngine_SDF::GetKerning (const FaceInstance *instance, const Face *glyph_face, uint32_t prior_character, uint32_t character) const
+{
+	FT_Face ft_face = glyph_face->ft_face;
+	if (!prior_character || glyph_face != instance->face || !FT_HAS_KERNING (ft_face))
+		return 0.0f;
+
+	FT_Vector kerning;
+	if (FT_Get_Kerning (ft_face, FT_Get_Char_Index (ft_face, prior_character), FT_Get_Char_Index (ft_face, character), FT_KERNING_UNSCALED, &kerning) != 0)
+		return 0.0f;
+	return kerning.x * instance->size / static_cast<float> (ft_face->units_per_EM);
+}
+
+Rml::FontFaceHandle FontEngine_SDF::GetFontFaceHandle (const Rml::String &family, Rml::Style::FontStyle style, Rml::Style::FontWeight weight, int size)
+{
+	// Matching style first, then the closest weight
+	const std::string family_lower = ToLower (family);
+	const int		  wanted_weight = static_cast<int> (weight == Rml::Style::FontWeight::Auto ? Rml::Style::FontWeight::Normal : weight);
+	Face			 *best = nullptr;
+	int				  best_score = 0;
+	for (auto &face : m_faces)
+	{
+		if (face->family != family_lower)
+			continue;
+		const int score = (face->style == style ? 0 : 10000) + std::abs (static_cast<int> (face->weight) - wanted_weight);
+		if (!best || score < best_score)
+		{
+			best = face.get ();
+			best_score = score;
+		}
+	}
+	if (!best || size <= 0)
+		return 0;
+
+	for (auto &instance : m_instances)
+	{
+		if (instance->face == best && instance->size == size)
+			return reinterpret_cast<Rml::FontFaceHandle> (instance.get ());
+	}
+
+	auto	*instance = new FaceInstance ();
+	FT_Face	 ft_face = best->ft_face;
+	const float units = size / static_cast<float> (ft_face->units_per_EM);
+	instance->face = best;
+	instance->size = size;
+	instance->scale = size / static_cast<float> (BASE_SIZE);
+	instance->metrics = Rml::FontMetrics ();
+	instance->metrics.size = size;
+	instance->metrics.ascent = ft_face->ascender * units;
+	instance->metrics.descent = -ft_face->descender * units;
+	instance->metrics.line_spacing = ft_face->height * units;
+	instance->metrics.underline_position = -ft_face->underline_position * units;
+	instance->metrics.underline_thickness = std::max (ft_face->underline_thickness * units, 1.0f);
+
+	const TT_OS2 *os2 = static_cast<const TT_OS2 *> (FT_Get_Sfnt_Table (ft_face, FT_SFNT_OS2));
+	if (os2 && os2->version >= 2 && os2->sxHeight > 0)
+		instance->metrics.x_height = os2->sxHeight * units;
+	else
+		instance->metrics.x_height = 0.5f * instance->metrics.ascent;
+
+	m_instances.emplace_back (instance);
+	return reinterpret_cast<Rml::FontFaceHandle> (instance);
+}
+
+Rml::FontEffectsHandle FontEngine_SDF::PrepareFontEffects (Rml::FontFaceHandle handle, const Rml::FontEffectList &font_effects)
+{
+	auto *instance = reinterpret_cast<FaceInstance *> (handle);
+	if (!instance || font_effects.empty () || !m_fallback)
+		return 0;
+
+	// Effects are rasterized per size by the fallback engine, only the layout comes from the distance field metrics
+	const Face *face = instance->face;
+	if (!instance->fallback_face)
+		instance->fallback_face = m_fallback->GetFontFaceHandle (face->family, face->style, face->weight, instance->size);
+	if (!instance->fallback_face)
+		return 0;
+
+	const Rml::FontEffectsHandle fallback_effects = m_fallback->PrepareFontEffects (instance->fallback_face, font_effects);
+	if (!fallback_effects)
+		return 0;
+	for (auto &effects : instance->effects)
+	{
+		if (effects->fallback_effects == fallback_effects)
+			return reinterpret_cast<Rml::FontEffectsHandle> (effects.get ());
+	}
+	instance->effects.push_back (std::make_unique<EffectsInstance> (EffectsInstance{instance->fallback_face, fallback_effects}));
+	return reinterpret_cast<Rml::FontEffectsHandle> (instance->effects.back ().get ());
+}
+
+const Rml::FontMetrics &FontEngine_SDF::GetFontMetrics (Rml::FontFaceHandle handle)
+{
+	return reinterpret_cast<FaceInstance *> (handle)->metrics;
+}
+
+int FontEngine_SDF::GetStringWidth (
+	Rml::FontFaceHandle handle, Rml::StringView string, const Rml::TextShapingContext &text_shaping_context, Rml::Character prior_character)
+{
+	auto *instance = reinterpret_cast<FaceInstance *> (handle);
+	if (!instance)
+		return 0;
+
+	float		width = 0.0f;
+	uint32_t	prior = static_cast<uint32_t> (prior_character);
+	const char *end = string.end ();
+	for (const char *p = string.begin (); p < end;)
+	{
+		const uint32_t character = NextCharacter (p, end);
+		Face		  *glyph_face;
+		const Glyph	  *glyph = GetGlyph (instance->face, character, glyph_face);
+		if (!glyph)
+			continue;
+		width += GetKerning (instance, glyph_face, prior, character) + glyph->advance * instance->scale + text_shaping_context.letter_spacing;
+		prior = character;
+	}
+	return static_cast<int> (std::lround (width));
+}
+
+void FontEngine_SDF::UpdateTextures (Rml::RenderManager &render_manager, Face *face)
+{
+	for (size_t i = 0; i < face->pages.size (); ++i)
+	{
+		AtlasPage &page = face->pages[i];
+		if (page.texture_valid)
+			continue;
+
+		// Replacing the callback texture releases the previous upload of the page
+		page.texture = render_manager.MakeCallbackTexture (
+			[this, face, i] (const Rml::CallbackTextureInterface &texture_interface) -> bool
+			{
+				const std::vector<Rml::byte> &distances = face->pages[i].distances;
+				std::vector<Rml::byte>		  rgba (distances.size () * 4);
+				for (size_t texel = 0; texel < distances.size (); ++texel)
+					memset (&rgba[texel * 4], distances[texel], 4);
+
+				m_render_interface->SetDistanceFieldTextures (true);
+				const bool generated = texture_interface.GenerateTexture ({rgba.data (), rgba.size ()}, {PAGE_SIZE, PAGE_SIZE});
+				m_render_interface->SetDistanceFieldTextures (false);
+				return generated;
+			});
+		page.texture_valid = true;
+	}
+}
+
+int FontEngine_SDF::GenerateString (
+	Rml::RenderManager &render_manager, Rml::FontFaceHandle face_handle, Rml::FontEffectsHandle font_effects_handle, Rml::StringView string,
+	Rml::Vector2f position, Rml::ColourbPremultiplied colour, float opacity, const Rml::TextShapingContext &text_shaping_context,
+	Rml::TexturedMeshList &mesh_list)
+{
+	auto *instance = reinterpret_cast<FaceInstance *> (face_handle);
+	if (!instance)
+		return 0;
+
+	if (font_effects_handle && m_fallback)
+	{
+		const auto *effects = reinterpret_cast<const EffectsInstance *> (font_effects_handle);
+		return m_fallback->GenerateString (
+			render_manager, effects->fallback_face, effects->fallback_effects, string, position, colour, opacity, text_shaping_context, mesh_list);
+	}
+
+	Rml::ColourbPremultiplied vertex_colour = colour;
+	if (opacity < 1.0f)
+	{
+		vertex_colour.red = static_cast<Rml::byte> (colour.red * opacity);
+		vertex_colour.green = static_cast<Rml::byte> (colour.green * opacity);
+		vertex_colour.blue = static_cast<Rml::byte> (colour.blue * opacity);
+		vertex_colour.alpha = static_cast<Rml::byte> (colour.alpha * opacity);
+	}
+
+	// One mesh for every atlas page the string touches, a glyph can come from a fallback face
+	struct PageMesh
+	{
+		Face  *face;
+		int	   page;
+		size_t mesh_index;
+	};
+	std::vector<PageMesh> page_meshes;
+
+	const float scale = instance->scale;
+	float		x = position.x;
+	uint32_t	prior = 0;
+	const char *end = string.end ();
+	for (const char *p = string.begin (); p < end;)
+	{
+		const uint32_t character = NextCharacter (p, end);
+		Face		  *glyph_face;
+		const Glyph	  *glyph = GetGlyph (instance->face, character, glyph_face);
+		if (!glyph)
+			continue;
+
+		x += GetKerning (instance, glyph_face, prior, character);
+		prior = character;
+		if (glyph->page >= 0)
+		{
+			auto it = std::find_if (
+				page_meshes.begin (), page_meshes.end (), [&] (const PageMesh &mesh) { return mesh.face == glyph_face && mesh.page == glyph->page; });
+			if (it == page_meshes.end ())
+			{
+				page_meshes.push_back ({glyph_face, glyph->page, mesh_list.size ()});
+				mesh_list.emplace_back ();
+				it = page_meshes.end () - 1;
+			}
+
+			Rml::Mesh  &mesh = mesh_list[it->mesh_index].mesh;
+			const int	base = static_cast<int> (mesh.vertices.size ());
+			const float x0 = x + glyph->left * scale;
+			const float y0 = position.y - glyph->top * scale;
+			const float x1 = x0 + glyph->width * scale;
+			const float y1 = y0 + glyph->height * scale;
+			mesh.vertices.push_back ({{x0, y0}, vertex_colour, {glyph->uv[0], glyph->uv[1]}});
+			mesh.vertices.push_back ({{x1, y0}, vertex_colour, {glyph->uv[2], glyph->uv[1]}});
+			mesh.vertices.push_back ({{x1, y1}, vertex_colour, {glyph->uv[2], glyph->uv[3]}});
+			mesh.vertices.push_back ({{x0, y1}, vertex_colour, {glyph->uv[0], glyph->uv[3]}});
+			mesh.indices.insert (mesh.indices.end (), {base, base + 1, base + 2, base, base + 2, base + 3});
+		}
+		x += glyph->advance * scale + text_shaping_context.letter_spacing;
+	}
+
+	// Glyphs rasterized above only reach the pages' textures now
+	for (const PageMesh &page_mesh : page_meshes)
+	{
+		UpdateTextures (render_manager, page_mesh.face);
+		mesh_list[page_mesh.mesh_index].texture = page_mesh.face->pages[page_mesh.page].texture;
+	}
+	return static_cast<int> (std::lround (x - position.x));
+}
+
+int FontEngine_SDF::GetVersion (Rml::FontFaceHandle handle)
+{
+	auto *instance = reinterpret_cast<FaceInstance *> (handle);
+	if (!instance)
+		return 0;
+	return instance->face->version + ((instance->fallback_face && m_fallback) ? m_fallback->GetVersion (instance->fallback_face) : 0);
+}
+
+void FontEngine_SDF::ReleaseFontResources ()
+{
+	// The fallback engine drops its sized faces here too, RmlUi asks for new handles afterwards
+	if (m_fallback)
+		m_fallback->ReleaseFontResources ();
+	m_instances.clear ();
+	for (auto &face : m_faces)
+	{
+		for (AtlasPage &page : face->pages)
+		{
+			page.texture.Release ();
+			page.texture_valid = false;
+		}
+		face->version++;
+	}
+}
+
+} // namespace QRmlUI
@@ -0,0 +1,143 @@
+/*
+ * vkQuake RmlUI - Signed Distance Field Font Engine
+ *
+ * Renders every face once into a distance field atlas at a fixed base size and
+ * draws text of any size from it, so changing the UI scale never regenerates glyphs.
+ */
+
+#ifndef QRMLUI_FONT_ENGINE_SDF_H
+#define QRMLUI_FONT_ENGINE_SDF_H
+
+#include <RmlUi/Core/FontEngineInterface.h>
+#include <RmlUi/Core/CallbackTexture.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+typedef struct FT_LibraryRec_ *FT_Library;
+typedef struct FT_FaceRec_	  *FT_Face;
+
+namespace QRmlUI
+{
+
+class RenderInterface_VK;
+
+class FontEngine_SDF : public Rml::FontEngineInterface
+{
+  public:
+	// Text with font effects is handed to the fallback engine, which keeps
+	// rasterizing those per size. It must stay alive until Shutdown.
+	FontEngine_SDF (RenderInterface_VK *render_interface, Rml::FontEngineInterface *fallback);
+	~FontEngine_SDF () override;
+
+	// False when FreeType failed to start, no face can be loaded then
+	bool IsInitialized () const
+	{
+		return m_library != nullptr;
+	}
+
+	// -- Inherited from Rml::FontEngineInterface --
+
+	void Shutdown () override;
+
+	bool LoadFontFace (const Rml::String &file_name, bool fallback_face, Rml::Style::FontWeight weight) override;
+	bool LoadFontFace (
+		Rml::Span<const Rml::byte> data, const Rml::String &family, Rml::Style::FontStyle style, Rml::Style::FontWeight weight, bool fallback_face) override;
+
+	Rml::FontFaceHandle	   GetFontFaceHandle (const Rml::String &family, Rml::Style::FontStyle style, Rml::Style::FontWeight weight, int size) override;
+	Rml::FontEffectsHandle PrepareFontEffects (Rml::FontFaceHandle handle, const Rml::FontEffectList &font_effects) override;
+
+	const Rml::FontMetrics &GetFontMetrics (Rml::FontFaceHandle handle) override;
+
+	int GetStringWidth (
+		Rml::FontFaceHandle handle, Rml::StringView string, const Rml::TextShapingContext &text_shaping_context,
+		Rml::Character prior_character = Rml::Character::Null) override;
+	int GenerateString (
+		Rml::RenderManager &render_manager, Rml::FontFaceHandle face_handle, Rml::FontEffectsHandle font_effects_handle, Rml::StringView string,
+		Rml::Vector2f position, Rml::ColourbPremultiplied colour, float opacity, const Rml::TextShapingContext &text_shaping_context,
+		Rml::TexturedMeshList &mesh_list) override;
+
+	int	 GetVersion (Rml::FontFaceHandle handle) override;
+	void ReleaseFontResources () override;
+
+  private:
+	// Glyphs are rendered at BASE_SIZE pixels with SPREAD pixels of distance around the outline
+	static constexpr int BASE_SIZE = 32;
+	static constexpr int SPREAD = 6;
+	static constexpr int PAGE_SIZE = 512;
+
+	// Placement of a glyph at BASE_SIZE, in pixels
+	struct Glyph
+	{
+		float advance;
+		int	  left;
+		int	  top;
+		int	  width;
+		int	  height;
+		int	  page; // -1 for glyphs without an outline
+		float uv[4];
+	};
+
+	// Distance values of one atlas page, expanded to RGBA when the texture is generated
+	struct AtlasPage
+	{
+		std::vector<Rml::byte> distances;
+		int					   shelf_x = 0;
+		int					   shelf_y = 0;
+		int					   shelf_height = 0;
+		Rml::CallbackTexture   texture;
+		bool				   texture_valid = false;
+	};
+
+	struct Face
+	{
+		FT_Face								ft_face = nullptr;
+		std::vector<Rml::byte>				data;
+		std::string							family; // lower case
+		Rml::Style::FontStyle				style;
+		Rml::Style::FontWeight				weight;
+		bool								fallback_face;
+		std::unordered_map<uint32_t, Glyph> glyphs; // by glyph index
+		std::vector<AtlasPage>				pages;
+		int									version = 1;
+	};
+
+	// Font effects of a face instance, drawn by the fallback engine
+	struct EffectsInstance
+	{
+		Rml::FontFaceHandle	   fallback_face;
+		Rml::FontEffectsHandle fallback_effects;
+	};
+
+	// A face at one size, this is what the font face handles point to
+	struct FaceInstance
+	{
+		Face										 *face;
+		int											  size;
+		float										  scale; // from BASE_SIZE pixels
+		Rml::FontMetrics							  metrics;
+		Rml::FontFaceHandle							  fallback_face = 0;
+		std::vector<std::unique_ptr<EffectsInstance>> effects;
+	};
+
+	bool		 AddFace (
+				std::vector<Rml::byte> data, const Rml::String &family, Rml::Style::FontStyle style, Rml::Style::FontWeight weight, bool fallback_face);
+	void		 ReleaseFaces ();
+	const Glyph *GetGlyph (Face *face, uint32_t character, Face *&glyph_face);
+	bool		 RenderGlyph (Face *face, uint32_t glyph_index, Glyph &glyph);
+	float		 GetKerning (const FaceInstance *instance, const Face *glyph_face, uint32_t prior_character, uint32_t character) const;
+	void		 UpdateTextures (Rml::RenderManager &render_manager, Face *face);
+
+	RenderInterface_VK		 *m_render_interface;
+	Rml::FontEngineInterface *m_fallback;
+	FT_Library				  m_library;
+
+	std::vector<std::unique_ptr<Face>>		   m_faces;
+	std::vector<std::unique_ptr<FaceInstance>> m_instances;
+};
+
+} // namespace QRmlUI
+
+#endif // QRMLUI_FONT_ENGINE_SDF_H
@@ -13,6 +13,8 @@
 
 #include "engine_bridge.h"
 
+#include <cstring>
+
 namespace QRmlUI
 {
 
@@ -70,9 +72,12 @@ Rml::DataModelHandle GameDataModel::s_model_handle;
 bool				 GameDataModel::s_initialized = false;
 GameState			 GameDataModel::s_prev_state;
 bool				 GameDataModel::s_first_update = true;
+bool				 GameDataModel::s_marked_all_dirty = false;
 Rml::String			 GameDataModel::s_prev_gamedir;
 bool				 GameDataModel::s_was_chatting = false;
 
+std::vector<const char *> GameDataModel::s_last_dirtied;
+
 // Transient animation state — reset on disconnect via ResetTransients()
 static double			s_weapon_show_time = 0.0;
 static double			s_fire_flash_time = 0.0;
@@ -82,6 +87,12 @@ static int				s_prev_active_weapon = 0;
 static constexpr double WEAPON_SHOW_DURATION = 0.15;
 static constexpr double FIRE_FLASH_DURATION = 0.30;
 
+// Last cl_stats_generation decoded by SyncFromQuake. While the engine has not bumped it
+// the stats, items and level info are unchanged, so Update can skip their field compares.
+static unsigned int s_synced_generation = 0;
+static bool			s_have_generation = false;
+static bool			s_sync_pending = false;
+
 bool GameDataModel::Initialize (Rml::Context *context)
 {
 	if (s_initialized)
@@ -168,6 +179,10 @@ bool GameDataModel::Initialize (Rml::Context *context)
 			variant = Rml::String (game && game[0] ? game : "QUAKE");
 		});
 
+	// Bind loading screen
+	constructor.Bind ("loading_percent", &g_game_state.loading_percent);
+	constructor.Bind ("loading_phase", &g_game_state.loading_phase);
+
 	// Bind time (seconds zero-padded to 2 digits for display)
 	constructor.Bind ("time_minutes", &g_game_state.time_minutes);
 	constructor.BindFunc (
@@ -289,6 +304,8 @@ bool GameDataModel::Initialize (Rml::Context *context)
 		player_handle.RegisterMember ("bottom_color", &PlayerInfo::bottom_color);
 		player_handle.RegisterMember ("ping", &PlayerInfo::ping);
 		player_handle.RegisterMember ("is_local", &PlayerInfo::is_local);
+		player_handle.RegisterMember ("slot", &PlayerInfo::slot);
+		player_handle.RegisterMember ("rank", &PlayerInfo::rank);
 	}
 	constructor.RegisterArray<std::vector<PlayerInfo>> ();
 
@@ -397,10 +414,16 @@ void GameDataModel::Shutdown ()
 	Con_DPrintf ("GameDataModel: Shutdown\n");
 }
 
-void GameDataModel::Update ()
+void GameDataModel::Dirty (const char *name)
+{
+	s_model_handle.DirtyVariable (name);
+	s_last_dirtied.push_back (name);
+}
+
+bool GameDataModel::Update ()
 {
 	if (!s_initialized || !s_model_handle)
-		return;
+		return false;
 
 	// Compare current state against cached previous state.
 	// Only dirty variables that actually changed to avoid per-frame churn.
@@ -408,19 +431,85 @@ void GameDataModel::Update ()
 	{
 		s_first_update = false;
 		s_model_handle.DirtyAllVariables ();
+		s_last_dirtied.assign (1, "*");
 		s_prev_state = g_game_state;
-		return;
+		s_sync_pending = false;
+		return true;
 	}
 
-	bool any_dirty = false;
+	bool any_dirty = s_marked_all_dirty;
+	s_last_dirtied.clear ();
+	if (s_marked_all_dirty)
+		s_last_dirtied.push_back ("*");
+	s_marked_all_dirty = false;
 
 #define DIRTY_IF_CHANGED(field, name)             \
 	if (g_game_state.field != s_prev_state.field) \
 	{                                             \
-		s_model_handle.DirtyVariable (name);      \
+		Dirty (name);                             \
 		any_dirty = true;                         \
 	}
 
+	// Chat input (dirty every frame while active, plus one frame after close)
+	{
+		bool is_chatting = (key_dest == key_message);
+		if (is_chatting || s_was_chatting)
+		{
+			Dirty ("chat_active");
+			Dirty ("chat_prefix");
+			Dirty ("chat_text");
+			any_dirty = true;
+		}
+		s_was_chatting = is_chatting;
+	}
+
+	// Player list (compare count; full array dirtied on any change)
+	DIRTY_IF_CHANGED (num_players, "num_players")
+	if (g_game_state.num_players != s_prev_state.num_players || g_game_state.players != s_prev_state.players)
+	{
+		Dirty ("players");
+		any_dirty = true;
+	}
+
+	// Game title (gamedir-backed — track changes for mod switch)
+	{
+		const char *g = COM_GetGameNames (0);
+		if (strcmp (g ? g : "", s_prev_gamedir.c_str ()) != 0)
+		{
+			Dirty ("game_title");
+			s_prev_gamedir = g ? g : "";
+			any_dirty = true;
+		}
+	}
+
+	// Expire transient reticle animation flags
+	if (g_game_state.weapon_show && realtime - s_weapon_show_time > WEAPON_SHOW_DURATION)
+		g_game_state.weapon_show = false;
+	if (g_game_state.fire_flash && realtime - s_fire_flash_time > FIRE_FLASH_DURATION)
+		g_game_state.fire_flash = false;
+
+	DIRTY_IF_CHANGED (weapon_show, "weapon_show")
+	DIRTY_IF_CHANGED (fire_flash, "fire_flash")
+	DIRTY_IF_CHANGED (weapon_firing, "weapon_firing")
+
+	// Set by UI_ShowLoading while a map loads, no SyncFromQuake then
+	DIRTY_IF_CHANGED (loading_percent, "loading_percent")
+	DIRTY_IF_CHANGED (loading_phase, "loading_phase")
+
+	// Stats, items, level info, time and reticle only change when SyncFromQuake says so
+	if (!s_sync_pending)
+	{
+		s_prev_state.loading_percent = g_game_state.loading_percent;
+		s_prev_state.loading_phase = g_game_state.loading_phase;
+		s_prev_state.num_players = g_game_state.num_players;
+		s_prev_state.players = g_game_state.players;
+		s_prev_state.weapon_show = g_game_state.weapon_show;
+		s_prev_state.fire_flash = g_game_state.fire_flash;
+		s_prev_state.weapon_firing = g_game_state.weapon_firing;
+		return any_dirty;
+	}
+	s_sync_pending = false;
+
 	// Core stats
 	DIRTY_IF_CHANGED (health, "health")
 	DIRTY_IF_CHANGED (armor, "armor")
@@ -430,13 +519,13 @@ void GameDataModel::Update ()
 	// When active_weapon changes, computed funcs also need re-eval
 	if (g_game_state.active_weapon != s_prev_state.active_weapon)
 	{
-		s_model_handle.DirtyVariable ("weapon_label");
-		s_model_handle.DirtyVariable ("ammo_type_label");
-		s_model_handle.DirtyVariable ("is_axe");
-		s_model_handle.DirtyVariable ("is_shells_weapon");
-		s_model_handle.DirtyVariable ("is_nails_weapon");
-		s_model_handle.DirtyVariable ("is_rockets_weapon");
-		s_model_handle.DirtyVariable ("is_cells_weapon");
+		Dirty ("weapon_label");
+		Dirty ("ammo_type_label");
+		Dirty ("is_axe");
+		Dirty ("is_shells_weapon");
+		Dirty ("is_nails_weapon");
+		Dirty ("is_rockets_weapon");
+		Dirty ("is_cells_weapon");
 	}
 
 	// Ammo counts
@@ -500,53 +589,10 @@ void GameDataModel::Update ()
 	// Reticle (crosshair)
 	DIRTY_IF_CHANGED (reticle_style, "reticle_style")
 
-	// Chat input (dirty every frame while active, plus one frame after close)
-	{
-		bool is_chatting = (key_dest == key_message);
-		if (is_chatting || s_was_chatting)
-		{
-			s_model_handle.DirtyVariable ("chat_active");
-			s_model_handle.DirtyVariable ("chat_prefix");
-			s_model_handle.DirtyVariable ("chat_text");
-			any_dirty = true;
-		}
-		s_was_chatting = is_chatting;
-	}
-
-	// Player list (compare count; full array dirtied on any change)
-	DIRTY_IF_CHANGED (num_players, "num_players")
-	if (g_game_state.num_players != s_prev_state.num_players || g_game_state.players != s_prev_state.players)
-	{
-		s_model_handle.DirtyVariable ("players");
-		any_dirty = true;
-	}
-
-	// Game title (gamedir-backed — track changes for mod switch)
-	{
-		const char *g = COM_GetGameNames (0);
-		Rml::String cur_gamedir (g ? g : "");
-		if (cur_gamedir != s_prev_gamedir)
-		{
-			s_model_handle.DirtyVariable ("game_title");
-			s_prev_gamedir = cur_gamedir;
-			any_dirty = true;
-		}
-	}
-
-	// Expire transient reticle animation flags
-	if (g_game_state.weapon_show && realtime - s_weapon_show_time > WEAPON_SHOW_DURATION)
-		g_game_state.weapon_show = false;
-	if (g_game_state.fire_flash && realtime - s_fire_flash_time > FIRE_FLASH_DURATION)
-		g_game_state.fire_flash = false;
-
-	DIRTY_IF_CHANGED (weapon_show, "weapon_show")
-	DIRTY_IF_CHANGED (fire_flash, "fire_flash")
-	DIRTY_IF_CHANGED (weapon_firing, "weapon_firing")
-
 #undef DIRTY_IF_CHANGED
 
-	(void)any_dirty;
 	s_prev_state = g_game_state;
+	return any_dirty;
 }
 
 void GameDataModel::MarkAllDirty ()
@@ -554,6 +600,7 @@ void GameDataModel::MarkAllDirty ()
 	if (!s_initialized || !s_model_handle)
 		return;
 	s_model_handle.DirtyAllVariables ();
+	s_marked_all_dirty = true;
 }
 
 void GameDataModel::ResetTransients ()
@@ -563,6 +610,7 @@ void GameDataModel::ResetTransients ()
 	s_prev_weaponframe = 0;
 	s_prev_health = 100;
 	s_prev_active_weapon = 0;
+	s_have_generation = false;
 }
 
 bool GameDataModel::IsInitialized ()
@@ -570,6 +618,11 @@ bool GameDataModel::IsInitialized ()
 	return s_initialized;
 }
 
+const std::vector<const char *> &GameDataModel::GetLastDirtied ()
+{
+	return s_last_dirtied;
+}
+
 } // namespace QRmlUI
 
 // C API Implementation
@@ -600,13 +653,43 @@ extern "C"
 
 	void GameDataModel_SyncFromQuake (
 		const int *stats, int stats_count, int items, int intermission, int gametype, int maxclients, const char *level_name, const char *map_name,
-		double game_time)
+		double game_time, unsigned int generation)
 	{
 		using namespace QRmlUI;
 
 		if (!stats || stats_count < STAT_ITEMS + 1)
 			return;
 
+		// Time calculation
+		const int total_seconds = static_cast<int> (game_time);
+		if (total_seconds / 60 != g_game_state.time_minutes || total_seconds % 60 != g_game_state.time_seconds)
+		{
+			g_game_state.time_minutes = total_seconds / 60;
+			g_game_state.time_seconds = total_seconds % 60;
+			s_sync_pending = true;
+		}
+
+		if (s_have_generation && generation == s_synced_generation)
+		{
+			// Health did not change since the last sync, so the pain flash ends
+			if (g_game_state.face_pain)
+			{
+				g_game_state.face_pain = false;
+				s_sync_pending = true;
+			}
+			// The reticle style follows cvars rather than stats
+			const int reticle_style = ResolveReticleStyle (g_game_state.active_weapon, CvarBindingManager::GetProvider ());
+			if (reticle_style != g_game_state.reticle_style)
+			{
+				g_game_state.reticle_style = reticle_style;
+				s_sync_pending = true;
+			}
+			return;
+		}
+		s_synced_generation = generation;
+		s_have_generation = true;
+		s_sync_pending = true;
+
 		// Sync core stats
 		g_game_state.health = stats[STAT_HEALTH];
 		g_game_state.armor = stats[STAT_ARMOR];
@@ -684,11 +767,6 @@ extern "C"
 			g_game_state.map_name = map_name;
 		}
 
-		// Time calculation
-		int total_seconds = static_cast<int> (game_time);
-		g_game_state.time_minutes = total_seconds / 60;
-		g_game_state.time_seconds = total_seconds % 60;
-
 		// Detect damage taken (health decreased since last sync).
 		// Threshold of 2 HP filters out megahealth decay (1 HP/sec tick-down)
 		// while catching real damage (minimum 5 HP in Quake).
@@ -36,7 +36,8 @@ class GameDataModel
 
 	// Update the data model from Quake's game state
 	// Call this each frame (typically from UI_Update)
-	static void Update ();
+	// Returns true if any variable was dirtied
+	static bool Update ();
 
 	// Force a dirty check on all variables (call after level load)
 	static void MarkAllDirty ();
@@ -47,13 +48,21 @@ class GameDataModel
 	// Check if initialized
 	static bool IsInitialized ();
 
+	// Variables dirtied by the last Update(), "*" when all were. For ui_speeds.
+	static const std::vector<const char *> &GetLastDirtied ();
+
   private:
+	static void Dirty (const char *name);
+
 	static Rml::DataModelHandle s_model_handle;
 	static bool					s_initialized;
 	static GameState			s_prev_state;
 	static bool					s_first_update;
+	static bool					s_marked_all_dirty;
 	static Rml::String			s_prev_gamedir;
 	static bool					s_was_chatting;
+
+	static std::vector<const char *> s_last_dirtied;
 };
 
 } // namespace QRmlUI
@@ -81,9 +90,10 @@ extern "C"
 	// items: cl.items bitfield
 	// gametype: cl.gametype (GAME_COOP=0, GAME_DEATHMATCH=1)
 	// maxclients: cl.maxclients (1=SP, >1=multiplayer)
+	// generation: cl_stats_generation, everything but game_time is only decoded when it changed
 	void GameDataModel_SyncFromQuake (
 		const int *stats, int stats_count, int items, int intermission, int gametype, int maxclients, const char *level_name, const char *map_name,
-		double game_time);
+		double game_time, unsigned int generation);
 
 #ifdef __cplusplus
 }
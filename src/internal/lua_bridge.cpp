@@ -2,11 +2,14 @@
  * vkQuake RmlUI - Lua Engine Bridge Implementation
  *
  * Registers two global Lua tables:
- *   game   — read-only proxy over a backing table, refreshed each frame
+ *   game   — read-only proxy reading straight from g_game_state
  *   engine — exec(), cvar_get(), cvar_get_number(), cvar_set(), time()
  *
  * The 'game' table uses a metatable proxy so scripts can read fields
  * (game.health, game.weapon_label) but writes raise a Lua error.
+ * Reads resolve the key through a table of field ids built once at
+ * startup, and string values are cached until they change, so the
+ * per-frame game state costs Lua nothing to allocate.
  */
 
 #ifdef USE_LUA
@@ -31,8 +34,143 @@ namespace LuaBridge
 
 static lua_State *s_lua = nullptr;
 
-// Registry reference to the backing table behind the 'game' proxy.
-static int s_game_backing_ref = LUA_NOREF;
+// Lua heap figures for ui_speeds, refreshed by Update()
+static Stats s_stats;
+
+// Incremental GC work done each frame, in Lua's step units (KB in 5.4).
+// Spreading the collection over frames keeps the reticle plugin's garbage
+// from building up into a full collection on a single frame.
+static constexpr int GC_STEP_SIZE = 0;
+
+// Fields readable through the 'game' proxy
+enum GameField
+{
+	GF_HEALTH,
+	GF_ARMOR,
+	GF_AMMO,
+	GF_ACTIVE_WEAPON,
+	GF_SHELLS,
+	GF_NAILS,
+	GF_ROCKETS,
+	GF_CELLS,
+	GF_MONSTERS,
+	GF_TOTAL_MONSTERS,
+	GF_SECRETS,
+	GF_TOTAL_SECRETS,
+	GF_HAS_SHOTGUN,
+	GF_HAS_SUPER_SHOTGUN,
+	GF_HAS_NAILGUN,
+	GF_HAS_SUPER_NAILGUN,
+	GF_HAS_GRENADE_LAUNCHER,
+	GF_HAS_ROCKET_LAUNCHER,
+	GF_HAS_LIGHTNING_GUN,
+	GF_HAS_KEY1,
+	GF_HAS_KEY2,
+	GF_HAS_INVISIBILITY,
+	GF_HAS_INVULNERABILITY,
+	GF_HAS_SUIT,
+	GF_HAS_QUAD,
+	GF_HAS_SIGIL1,
+	GF_HAS_SIGIL2,
+	GF_HAS_SIGIL3,
+	GF_HAS_SIGIL4,
+	GF_ARMOR_TYPE,
+	GF_WEAPON_LABEL,
+	GF_AMMO_TYPE_LABEL,
+	GF_IS_AXE,
+	GF_IS_SHELLS_WEAPON,
+	GF_IS_NAILS_WEAPON,
+	GF_IS_ROCKETS_WEAPON,
+	GF_IS_CELLS_WEAPON,
+	GF_DEATHMATCH,
+	GF_COOP,
+	GF_INTERMISSION,
+	GF_INTERMISSION_TYPE,
+	GF_LEVEL_NAME,
+	GF_MAP_NAME,
+	GF_GAME_TITLE,
+	GF_TIME_MINUTES,
+	GF_TIME_SECONDS,
+	GF_FACE_INDEX,
+	GF_FACE_PAIN,
+	GF_RETICLE_STYLE,
+	GF_WEAPON_SHOW,
+	GF_FIRE_FLASH,
+	GF_WEAPON_FIRING,
+	GF_CHAT_ACTIVE,
+	GF_CHAT_PREFIX,
+	GF_CHAT_TEXT,
+	GF_NUM_PLAYERS,
+	GF_COUNT
+};
+
+static const struct
+{
+	GameField	field;
+	const char *name;
+} kGameFields[] = {
+	{GF_HEALTH, "health"},
+	{GF_ARMOR, "armor"},
+	{GF_AMMO, "ammo"},
+	{GF_ACTIVE_WEAPON, "active_weapon"},
+	{GF_SHELLS, "shells"},
+	{GF_NAILS, "nails"},
+	{GF_ROCKETS, "rockets"},
+	{GF_CELLS, "cells"},
+	{GF_MONSTERS, "monsters"},
+	{GF_TOTAL_MONSTERS, "total_monsters"},
+	{GF_SECRETS, "secrets"},
+	{GF_TOTAL_SECRETS, "total_secrets"},
+	{GF_HAS_SHOTGUN, "has_shotgun"},
+	{GF_HAS_SUPER_SHOTGUN, "has_super_shotgun"},
+	{GF_HAS_NAILGUN, "has_nailgun"},
+	{GF_HAS_SUPER_NAILGUN, "has_super_nailgun"},
+	{GF_HAS_GRENADE_LAUNCHER, "has_grenade_launcher"},
+	{GF_HAS_ROCKET_LAUNCHER, "has_rocket_launcher"},
+	{GF_HAS_LIGHTNING_GUN, "has_lightning_gun"},
+	{GF_HAS_KEY1, "has_key1"},
+	{GF_HAS_KEY2, "has_key2"},
+	{GF_HAS_INVISIBILITY, "has_invisibility"},
+	{GF_HAS_INVULNERABILITY, "has_invulnerability"},
+	{GF_HAS_SUIT, "has_suit"},
+	{GF_HAS_QUAD, "has_quad"},
+	{GF_HAS_SIGIL1, "has_sigil1"},
+	{GF_HAS_SIGIL2, "has_sigil2"},
+	{GF_HAS_SIGIL3, "has_sigil3"},
+	{GF_HAS_SIGIL4, "has_sigil4"},
+	{GF_ARMOR_TYPE, "armor_type"},
+	{GF_WEAPON_LABEL, "weapon_label"},
+	{GF_AMMO_TYPE_LABEL, "ammo_type_label"},
+	{GF_IS_AXE, "is_axe"},
+	{GF_IS_SHELLS_WEAPON, "is_shells_weapon"},
+	{GF_IS_NAILS_WEAPON, "is_nails_weapon"},
+	{GF_IS_ROCKETS_WEAPON, "is_rockets_weapon"},
+	{GF_IS_CELLS_WEAPON, "is_cells_weapon"},
+	{GF_DEATHMATCH, "deathmatch"},
+	{GF_COOP, "coop"},
+	{GF_INTERMISSION, "intermission"},
+	{GF_INTERMISSION_TYPE, "intermission_type"},
+	{GF_LEVEL_NAME, "level_name"},
+	{GF_MAP_NAME, "map_name"},
+	{GF_GAME_TITLE, "game_title"},
+	{GF_TIME_MINUTES, "time_minutes"},
+	{GF_TIME_SECONDS, "time_seconds"},
+	{GF_FACE_INDEX, "face_index"},
+	{GF_FACE_PAIN, "face_pain"},
+	{GF_RETICLE_STYLE, "reticle_style"},
+	{GF_WEAPON_SHOW, "weapon_show"},
+	{GF_FIRE_FLASH, "fire_flash"},
+	{GF_WEAPON_FIRING, "weapon_firing"},
+	{GF_CHAT_ACTIVE, "chat_active"},
+	{GF_CHAT_PREFIX, "chat_prefix"},
+	{GF_CHAT_TEXT, "chat_text"},
+	{GF_NUM_PLAYERS, "num_players"},
+};
+
+// Last value pushed for each string field. The Lua string itself lives in
+// the proxy's string cache table (upvalue 2 of __index) at the field id.
+static std::string s_cached_strings[GF_COUNT];
+static bool		   s_cached_string_valid[GF_COUNT];
 
 // ── engine.* C functions ────────────────────────────────────────────
 
@@ -139,34 +277,252 @@ static const char *GetAmmoTypeLabel (int active_weapon)
 	}
 }
 
-// ── Table field helpers ─────────────────────────────────────────────
-
-static void SetInt (lua_State *L, const char *key, int val)
-{
-	lua_pushinteger (L, val);
-	lua_setfield (L, -2, key);
-}
-
-static void SetBool (lua_State *L, const char *key, bool val)
-{
-	lua_pushboolean (L, val ? 1 : 0);
-	lua_setfield (L, -2, key);
-}
+// ── String cache ────────────────────────────────────────────────────
 
-static void SetString (lua_State *L, const char *key, const char *val)
+// Pushes the Lua string for a string field, only creating a new one when the value changed
+static void PushCachedString (lua_State *L, int cache_index, GameField field, const char *val)
 {
-	lua_pushstring (L, val ? val : "");
-	lua_setfield (L, -2, key);
+	if (!val)
+		val = "";
+	if (s_cached_string_valid[field] && s_cached_strings[field] == val)
+	{
+		lua_rawgeti (L, cache_index, field);
+		return;
+	}
+	lua_pushstring (L, val);
+	lua_pushvalue (L, -1);
+	lua_rawseti (L, cache_index, field);
+	s_cached_strings[field] = val;
+	s_cached_string_valid[field] = true;
 }
 
 // ── Read-only proxy metatable ───────────────────────────────────────
 
-// __index: delegate reads to the backing table (upvalue 1)
+// __index: map the key to a field id through the key table (upvalue 1)
+// and read the field from g_game_state
 static int l_game_index (lua_State *L)
 {
-	lua_pushvalue (L, lua_upvalueindex (1)); // backing table
-	lua_pushvalue (L, 2);					 // key
-	lua_gettable (L, -2);
+	lua_pushvalue (L, 2); // key
+	lua_rawget (L, lua_upvalueindex (1));
+	if (!lua_isnumber (L, -1))
+		return 1; // nil, unknown field
+	const int field = (int)lua_tointeger (L, -1);
+	lua_pop (L, 1);
+
+	const auto &gs = g_game_state;
+	const int	cache = lua_upvalueindex (2);
+	const int	w = gs.active_weapon;
+	switch (field)
+	{
+	// Core stats
+	case GF_HEALTH:
+		lua_pushinteger (L, gs.health);
+		break;
+	case GF_ARMOR:
+		lua_pushinteger (L, gs.armor);
+		break;
+	case GF_AMMO:
+		lua_pushinteger (L, gs.ammo);
+		break;
+	case GF_ACTIVE_WEAPON:
+		lua_pushinteger (L, gs.active_weapon);
+		break;
+
+	// Ammo counts
+	case GF_SHELLS:
+		lua_pushinteger (L, gs.shells);
+		break;
+	case GF_NAILS:
+		lua_pushinteger (L, gs.nails);
+		break;
+	case GF_ROCKETS:
+		lua_pushinteger (L, gs.rockets);
+		break;
+	case GF_CELLS:
+		lua_pushinteger (L, gs.cells);
+		break;
+
+	// Level statistics
+	case GF_MONSTERS:
+		lua_pushinteger (L, gs.monsters);
+		break;
+	case GF_TOTAL_MONSTERS:
+		lua_pushinteger (L, gs.total_monsters);
+		break;
+	case GF_SECRETS:
+		lua_pushinteger (L, gs.secrets);
+		break;
+	case GF_TOTAL_SECRETS:
+		lua_pushinteger (L, gs.total_secrets);
+		break;
+
+	// Weapons owned
+	case GF_HAS_SHOTGUN:
+		lua_pushboolean (L, gs.has_shotgun);
+		break;
+	case GF_HAS_SUPER_SHOTGUN:
+		lua_pushboolean (L, gs.has_super_shotgun);
+		break;
+	case GF_HAS_NAILGUN:
+		lua_pushboolean (L, gs.has_nailgun);
+		break;
+	case GF_HAS_SUPER_NAILGUN:
+		lua_pushboolean (L, gs.has_super_nailgun);
+		break;
+	case GF_HAS_GRENADE_LAUNCHER:
+		lua_pushboolean (L, gs.has_grenade_launcher);
+		break;
+	case GF_HAS_ROCKET_LAUNCHER:
+		lua_pushboolean (L, gs.has_rocket_launcher);
+		break;
+	case GF_HAS_LIGHTNING_GUN:
+		lua_pushboolean (L, gs.has_lightning_gun);
+		break;
+
+	// Keys
+	case GF_HAS_KEY1:
+		lua_pushboolean (L, gs.has_key1);
+		break;
+	case GF_HAS_KEY2:
+		lua_pushboolean (L, gs.has_key2);
+		break;
+
+	// Powerups
+	case GF_HAS_INVISIBILITY:
+		lua_pushboolean (L, gs.has_invisibility);
+		break;
+	case GF_HAS_INVULNERABILITY:
+		lua_pushboolean (L, gs.has_invulnerability);
+		break;
+	case GF_HAS_SUIT:
+		lua_pushboolean (L, gs.has_suit);
+		break;
+	case GF_HAS_QUAD:
+		lua_pushboolean (L, gs.has_quad);
+		break;
+
+	// Sigils
+	case GF_HAS_SIGIL1:
+		lua_pushboolean (L, gs.has_sigil1);
+		break;
+	case GF_HAS_SIGIL2:
+		lua_pushboolean (L, gs.has_sigil2);
+		break;
+	case GF_HAS_SIGIL3:
+		lua_pushboolean (L, gs.has_sigil3);
+		break;
+	case GF_HAS_SIGIL4:
+		lua_pushboolean (L, gs.has_sigil4);
+		break;
+
+	// Armor type
+	case GF_ARMOR_TYPE:
+		lua_pushinteger (L, gs.armor_type);
+		break;
+
+	// Computed fields (parity with GameDataModel)
+	case GF_WEAPON_LABEL:
+		PushCachedString (L, cache, GF_WEAPON_LABEL, GetWeaponLabel (w));
+		break;
+	case GF_AMMO_TYPE_LABEL:
+		PushCachedString (L, cache, GF_AMMO_TYPE_LABEL, GetAmmoTypeLabel (w));
+		break;
+	case GF_IS_AXE:
+		lua_pushboolean (L, w == IT_AXE);
+		break;
+	case GF_IS_SHELLS_WEAPON:
+		lua_pushboolean (L, w == 1 || w == 2);
+		break;
+	case GF_IS_NAILS_WEAPON:
+		lua_pushboolean (L, w == 4 || w == 8);
+		break;
+	case GF_IS_ROCKETS_WEAPON:
+		lua_pushboolean (L, w == 16 || w == 32);
+		break;
+	case GF_IS_CELLS_WEAPON:
+		lua_pushboolean (L, w == 64);
+		break;
+
+	// Game state flags
+	case GF_DEATHMATCH:
+		lua_pushboolean (L, gs.deathmatch);
+		break;
+	case GF_COOP:
+		lua_pushboolean (L, gs.coop);
+		break;
+	case GF_INTERMISSION:
+		lua_pushboolean (L, gs.intermission);
+		break;
+	case GF_INTERMISSION_TYPE:
+		lua_pushinteger (L, gs.intermission_type);
+		break;
+
+	// Level info
+	case GF_LEVEL_NAME:
+		PushCachedString (L, cache, GF_LEVEL_NAME, gs.level_name.c_str ());
+		break;
+	case GF_MAP_NAME:
+		PushCachedString (L, cache, GF_MAP_NAME, gs.map_name.c_str ());
+		break;
+
+	// Game title (from active game directory)
+	case GF_GAME_TITLE:
+	{
+		const char *game = COM_GetGameNames (0);
+		PushCachedString (L, cache, GF_GAME_TITLE, (game && game[0]) ? game : "QUAKE");
+		break;
+	}
+
+	// Time
+	case GF_TIME_MINUTES:
+		lua_pushinteger (L, gs.time_minutes);
+		break;
+	case GF_TIME_SECONDS:
+		lua_pushinteger (L, gs.time_seconds);
+		break;
+
+	// Face animation state
+	case GF_FACE_INDEX:
+		lua_pushinteger (L, gs.face_index);
+		break;
+	case GF_FACE_PAIN:
+		lua_pushboolean (L, gs.face_pain);
+		break;
+
+	// Reticle state
+	case GF_RETICLE_STYLE:
+		lua_pushinteger (L, gs.reticle_style);
+		break;
+	case GF_WEAPON_SHOW:
+		lua_pushboolean (L, gs.weapon_show);
+		break;
+	case GF_FIRE_FLASH:
+		lua_pushboolean (L, gs.fire_flash);
+		break;
+	case GF_WEAPON_FIRING:
+		lua_pushboolean (L, gs.weapon_firing);
+		break;
+
+	// Chat input overlay
+	case GF_CHAT_ACTIVE:
+		lua_pushboolean (L, key_dest == key_message);
+		break;
+	case GF_CHAT_PREFIX:
+		PushCachedString (L, cache, GF_CHAT_PREFIX, chat_team ? "say_team:" : "say:");
+		break;
+	case GF_CHAT_TEXT:
+		PushCachedString (L, cache, GF_CHAT_TEXT, Key_GetChatBuffer ());
+		break;
+
+	// Player count
+	case GF_NUM_PLAYERS:
+		lua_pushinteger (L, gs.num_players);
+		break;
+
+	default:
+		lua_pushnil (L);
+		break;
+	}
 	return 1;
 }
 
@@ -255,26 +611,29 @@ void Initialize ()
 	lua_setglobal (s_lua, "_frame_callbacks");
 
 	// Create the read-only 'game' proxy:
-	//   backing = {}          (stored in Lua registry)
 	//   proxy   = {}          (exposed as global 'game')
 	//   proxy's metatable:
-	//     __index    = closure over backing
+	//     __index    = closure over the key table and string cache
 	//     __newindex = error
 	//     __metatable = false  (hide metatable)
 
-	// backing table
-	lua_newtable (s_lua);
-	s_game_backing_ref = luaL_ref (s_lua, LUA_REGISTRYINDEX);
-
 	// proxy table
 	lua_newtable (s_lua);
 
 	// metatable
 	lua_newtable (s_lua);
 
-	// __index closure: upvalue is the backing table
-	lua_rawgeti (s_lua, LUA_REGISTRYINDEX, s_game_backing_ref);
-	lua_pushcclosure (s_lua, l_game_index, 1);
+	// __index closure: upvalue 1 maps field names to ids, upvalue 2 caches string values
+	lua_createtable (s_lua, 0, GF_COUNT);
+	for (const auto &f : kGameFields)
+	{
+		lua_pushinteger (s_lua, f.field);
+		lua_setfield (s_lua, -2, f.name);
+	}
+	lua_createtable (s_lua, GF_COUNT, 0);
+	for (int i = 0; i < GF_COUNT; i++)
+		s_cached_string_valid[i] = false;
+	lua_pushcclosure (s_lua, l_game_index, 2);
 	lua_setfield (s_lua, -2, "__index");
 
 	lua_pushcfunction (s_lua, l_game_newindex);
@@ -303,111 +662,6 @@ void Update ()
 	if (!s_lua)
 		return;
 
-	const auto &gs = g_game_state;
-
-	// Push the backing table onto the stack and populate it
-	lua_rawgeti (s_lua, LUA_REGISTRYINDEX, s_game_backing_ref);
-
-	// Core stats
-	SetInt (s_lua, "health", gs.health);
-	SetInt (s_lua, "armor", gs.armor);
-	SetInt (s_lua, "ammo", gs.ammo);
-	SetInt (s_lua, "active_weapon", gs.active_weapon);
-
-	// Ammo counts
-	SetInt (s_lua, "shells", gs.shells);
-	SetInt (s_lua, "nails", gs.nails);
-	SetInt (s_lua, "rockets", gs.rockets);
-	SetInt (s_lua, "cells", gs.cells);
-
-	// Level statistics
-	SetInt (s_lua, "monsters", gs.monsters);
-	SetInt (s_lua, "total_monsters", gs.total_monsters);
-	SetInt (s_lua, "secrets", gs.secrets);
-	SetInt (s_lua, "total_secrets", gs.total_secrets);
-
-	// Weapons owned
-	SetBool (s_lua, "has_shotgun", gs.has_shotgun);
-	SetBool (s_lua, "has_super_shotgun", gs.has_super_shotgun);
-	SetBool (s_lua, "has_nailgun", gs.has_nailgun);
-	SetBool (s_lua, "has_super_nailgun", gs.has_super_nailgun);
-	SetBool (s_lua, "has_grenade_launcher", gs.has_grenade_launcher);
-	SetBool (s_lua, "has_rocket_launcher", gs.has_rocket_launcher);
-	SetBool (s_lua, "has_lightning_gun", gs.has_lightning_gun);
-
-	// Keys
-	SetBool (s_lua, "has_key1", gs.has_key1);
-	SetBool (s_lua, "has_key2", gs.has_key2);
-
-	// Powerups
-	SetBool (s_lua, "has_invisibility", gs.has_invisibility);
-	SetBool (s_lua, "has_invulnerability", gs.has_invulnerability);
-	SetBool (s_lua, "has_suit", gs.has_suit);
-	SetBool (s_lua, "has_quad", gs.has_quad);
-
-	// Sigils
-	SetBool (s_lua, "has_sigil1", gs.has_sigil1);
-	SetBool (s_lua, "has_sigil2", gs.has_sigil2);
-	SetBool (s_lua, "has_sigil3", gs.has_sigil3);
-	SetBool (s_lua, "has_sigil4", gs.has_sigil4);
-
-	// Armor type
-	SetInt (s_lua, "armor_type", gs.armor_type);
-
-	// Computed fields (parity with GameDataModel)
-	SetString (s_lua, "weapon_label", GetWeaponLabel (gs.active_weapon));
-	SetString (s_lua, "ammo_type_label", GetAmmoTypeLabel (gs.active_weapon));
-	SetBool (s_lua, "is_axe", gs.active_weapon == IT_AXE);
-
-	int w = gs.active_weapon;
-	SetBool (s_lua, "is_shells_weapon", w == 1 || w == 2);
-	SetBool (s_lua, "is_nails_weapon", w == 4 || w == 8);
-	SetBool (s_lua, "is_rockets_weapon", w == 16 || w == 32);
-	SetBool (s_lua, "is_cells_weapon", w == 64);
-
-	// Game state flags
-	SetBool (s_lua, "deathmatch", gs.deathmatch);
-	SetBool (s_lua, "coop", gs.coop);
-	SetBool (s_lua, "intermission", gs.intermission);
-	SetInt (s_lua, "intermission_type", gs.intermission_type);
-
-	// Level info
-	SetString (s_lua, "level_name", gs.level_name.c_str ());
-	SetString (s_lua, "map_name", gs.map_name.c_str ());
-
-	// Game title (from active game directory)
-	{
-		const char *game = COM_GetGameNames (0);
-		SetString (s_lua, "game_title", (game && game[0]) ? game : "QUAKE");
-	}
-
-	// Time
-	SetInt (s_lua, "time_minutes", gs.time_minutes);
-	SetInt (s_lua, "time_seconds", gs.time_seconds);
-
-	// Face animation state
-	SetInt (s_lua, "face_index", gs.face_index);
-	SetBool (s_lua, "face_pain", gs.face_pain);
-
-	// Reticle state
-	SetInt (s_lua, "reticle_style", gs.reticle_style);
-	SetBool (s_lua, "weapon_show", gs.weapon_show);
-	SetBool (s_lua, "fire_flash", gs.fire_flash);
-	SetBool (s_lua, "weapon_firing", gs.weapon_firing);
-
-	// Chat input overlay
-	SetBool (s_lua, "chat_active", key_dest == key_message);
-	SetString (s_lua, "chat_prefix", chat_team ? "say_team:" : "say:");
-	{
-		const char *buf = Key_GetChatBuffer ();
-		SetString (s_lua, "chat_text", buf ? buf : "");
-	}
-
-	// Player count
-	SetInt (s_lua, "num_players", gs.num_players);
-
-	lua_pop (s_lua, 1); // pop backing table
-
 	// Dispatch named frame callbacks
 	lua_getglobal (s_lua, "_frame_callbacks");
 	lua_pushnil (s_lua);
@@ -429,6 +683,17 @@ void Update ()
 		// key remains on stack for lua_next
 	}
 	lua_pop (s_lua, 1); // pop _frame_callbacks
+
+	const double gc_start = Sys_DoubleTime ();
+	if (lua_gc (s_lua, LUA_GCSTEP, GC_STEP_SIZE))
+		s_stats.gc_cycles++;
+	s_stats.gc_ms = (Sys_DoubleTime () - gc_start) * 1000.0;
+	s_stats.memory_kb = lua_gc (s_lua, LUA_GCCOUNT, 0);
+}
+
+const Stats &GetStats ()
+{
+	return s_stats;
 }
 
 void RunTests ()
@@ -19,10 +19,20 @@ namespace LuaBridge
 // Call once after Rml::Lua::Initialise().
 void Initialize ();
 
-// Push current game state into the Lua 'game' table.
+// Run the on_frame callbacks and one incremental GC step. The 'game' table
+// reads g_game_state directly, so nothing is copied into Lua here.
 // Call each frame from UI_Update(), after GameDataModel::Update().
 void Update ();
 
+// Lua heap figures for ui_speeds
+struct Stats
+{
+	double gc_ms;	  // time spent in this frame's GC step
+	int	   memory_kb; // Lua heap in use after the step
+	int	   gc_cycles; // collection cycles completed since startup
+};
+const Stats &GetStats ();
+
 // Run Lua test suite from ui/lua/tests/test_runner.lua.
 // Invoked by the 'lua_test' console command.
 void RunTests ();
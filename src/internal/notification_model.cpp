@@ -162,10 +162,12 @@ void NotificationModel::Shutdown ()
 	Con_DPrintf ("NotificationModel: Shutdown\n");
 }
 
-void NotificationModel::Update (double real_time)
+bool NotificationModel::Update (double real_time)
 {
 	if (!s_initialized || !s_model_handle)
-		return;
+		return false;
+
+	bool any_dirty = false;
 
 	// Check centerprint visibility transition
 	// During intermission, centerprint never expires (matches legacy behavior)
@@ -180,6 +182,7 @@ void NotificationModel::Update (double real_time)
 		s_model_handle.DirtyVariable ("centerprint_fading");
 		s_centerprint_was_visible = cp_active;
 		s_centerprint_was_fading = cp_fading;
+		any_dirty = true;
 	}
 
 	// During finale (intermission type 2/3), dirty finale_text every frame
@@ -187,6 +190,7 @@ void NotificationModel::Update (double real_time)
 	if (g_game_state.intermission_type >= 2 && !s_state.centerprint.empty ())
 	{
 		s_model_handle.DirtyVariable ("finale_text");
+		any_dirty = true;
 	}
 
 	// Check notify visibility transitions
@@ -209,8 +213,11 @@ void NotificationModel::Update (double real_time)
 			s_model_handle.DirtyVariable ("notify_" + std::to_string (i) + "_fading");
 			s_notify_was_visible[i] = active;
 			s_notify_was_fading[i] = fading;
+			any_dirty = true;
 		}
 	}
+
+	return any_dirty;
 }
 
 void NotificationModel::CenterPrint (const char *text, double real_time)
@@ -30,7 +30,8 @@ class NotificationModel
 	// Update expiration state. Call each frame from UI_Update.
 	// game_time: cl.time from the engine (for centerprint expiry)
 	// real_time: realtime from the engine (for notify expiry)
-	static void Update (double real_time);
+	// Returns true if any variable was dirtied
+	static bool Update (double real_time);
 
 	// Push a centerprint message
 	static void CenterPrint (const char *text, double real_time);
@@ -18,7 +18,11 @@ extern "C"
 		float		 value;
 	} cvar_t;
 
+	typedef void (*cvarlistener_t) (cvar_t *, void *userdata);
+
 	cvar_t *Cvar_FindVar (const char *var_name);
+	void	Cvar_AddListener (cvar_t *var, cvarlistener_t func, void *userdata);
+	void	Cvar_RemoveListener (cvar_t *var, cvarlistener_t func, void *userdata);
 }
 
 namespace QRmlUI
@@ -56,4 +60,37 @@ bool QuakeCvarProvider::Exists (const std::string &name) const
 	return Cvar_FindVar (name.c_str ()) != nullptr;
 }
 
+static void OnCvarChanged (cvar_t *, void *userdata)
+{
+	auto *subscription = static_cast<const std::pair<ICvarProvider::ChangeCallback, void *> *> (userdata);
+	subscription->first (subscription->second);
+}
+
+bool QuakeCvarProvider::Subscribe (const std::string &name, ChangeCallback callback, void *userdata)
+{
+	cvar_t *var = Cvar_FindVar (name.c_str ());
+	if (!var)
+		return false;
+
+	// std::list keeps the element address stable for the engine listener
+	m_subscriptions.push_back ({callback, userdata});
+	Cvar_AddListener (var, OnCvarChanged, &m_subscriptions.back ());
+	return true;
+}
+
+void QuakeCvarProvider::Unsubscribe (const std::string &name, ChangeCallback callback, void *userdata)
+{
+	cvar_t *var = Cvar_FindVar (name.c_str ());
+	for (auto it = m_subscriptions.begin (); it != m_subscriptions.end (); ++it)
+	{
+		if (it->first == callback && it->second == userdata)
+		{
+			if (var)
+				Cvar_RemoveListener (var, OnCvarChanged, &*it);
+			m_subscriptions.erase (it);
+			return;
+		}
+	}
+}
+
 } // namespace QRmlUI
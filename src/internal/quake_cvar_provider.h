@@ -9,6 +9,9 @@
 
 #include "../types/cvar_provider.h"
 
+#include <list>
+#include <utility>
+
 namespace QRmlUI
 {
 
@@ -16,7 +19,7 @@ namespace QRmlUI
 class QuakeCvarProvider : public ICvarProvider
 {
   public:
-	// Singleton access - the provider is stateless, just wraps engine functions
+	// Singleton access - wraps engine functions, only subscriptions hold state
 	static QuakeCvarProvider &Instance ();
 
 	float		GetFloat (const std::string &name) const override;
@@ -24,9 +27,14 @@ class QuakeCvarProvider : public ICvarProvider
 	void		SetFloat (const std::string &name, float value) override;
 	void		SetString (const std::string &name, const std::string &value) override;
 	bool		Exists (const std::string &name) const override;
+	bool		Subscribe (const std::string &name, ChangeCallback callback, void *userdata) override;
+	void		Unsubscribe (const std::string &name, ChangeCallback callback, void *userdata) override;
 
   private:
 	QuakeCvarProvider () = default;
+
+	// Engine listeners carry a single userdata pointer, this keeps the caller's callback next to it
+	std::list<std::pair<ChangeCallback, void *>> m_subscriptions;
 };
 
 } // namespace QRmlUI
@@ -10,7 +10,9 @@
 #include "quake_file_interface.h"
 #include "engine_bridge.h"
 
+#include <algorithm>
 #include <cstdio>
+#include <cstring>
 #include <string>
 
 namespace QRmlUI
@@ -20,7 +22,9 @@ namespace
 
 struct QFileHandle
 {
-	fshandle_t fh;
+	fshandle_t	fh;
+	bool		in_memory = false; // preloaded, fh.pos indexes data
+	Rml::String data;
 };
 
 /* Helper: open a loose file and populate an fshandle_t for it. */
@@ -42,6 +46,25 @@ static Rml::FileHandle OpenLoose (FILE *f)
 } // anonymous namespace
 
 Rml::FileHandle QuakeFileInterface::Open (const Rml::String &path)
+{
+	auto preloaded = m_preloaded_files.find (path);
+	if (preloaded != m_preloaded_files.end ())
+	{
+		auto *qfh = new QFileHandle;
+		qfh->in_memory = true;
+		qfh->data = std::move (preloaded->second);
+		qfh->fh.file = nullptr;
+		qfh->fh.pak = 0;
+		qfh->fh.start = 0;
+		qfh->fh.pos = 0;
+		qfh->fh.length = static_cast<long> (qfh->data.size ());
+		m_preloaded_files.erase (preloaded);
+		return reinterpret_cast<Rml::FileHandle> (qfh);
+	}
+	return OpenFile (path);
+}
+
+Rml::FileHandle QuakeFileInterface::OpenFile (const Rml::String &path)
 {
 	/* 1. Quake VFS: game dirs + pak files (handles mod overrides,
 	 *    pak-embedded assets, and the full engine search order). */
@@ -74,32 +97,85 @@ Rml::FileHandle QuakeFileInterface::Open (const Rml::String &path)
 void QuakeFileInterface::Close (Rml::FileHandle file)
 {
 	auto *qfh = reinterpret_cast<QFileHandle *> (file);
-	FS_fclose (&qfh->fh);
+	if (!qfh->in_memory)
+		FS_fclose (&qfh->fh);
 	delete qfh;
 }
 
 size_t QuakeFileInterface::Read (void *buffer, size_t size, Rml::FileHandle file)
 {
 	auto *qfh = reinterpret_cast<QFileHandle *> (file);
+	if (qfh->in_memory)
+	{
+		size_t count = std::min (size, static_cast<size_t> (qfh->fh.length - qfh->fh.pos));
+		memcpy (buffer, qfh->data.data () + qfh->fh.pos, count);
+		qfh->fh.pos += static_cast<long> (count);
+		return count;
+	}
 	return FS_fread (buffer, 1, size, &qfh->fh);
 }
 
 bool QuakeFileInterface::Seek (Rml::FileHandle file, long offset, int origin)
 {
 	auto *qfh = reinterpret_cast<QFileHandle *> (file);
+	if (qfh->in_memory)
+	{
+		long pos = offset;
+		if (origin == SEEK_CUR)
+			pos += qfh->fh.pos;
+		else if (origin == SEEK_END)
+			pos += qfh->fh.length;
+		if (pos < 0 || pos > qfh->fh.length)
+			return false;
+		qfh->fh.pos = pos;
+		return true;
+	}
 	return FS_fseek (&qfh->fh, offset, origin) == 0;
 }
 
 size_t QuakeFileInterface::Tell (Rml::FileHandle file)
 {
 	auto *qfh = reinterpret_cast<QFileHandle *> (file);
+	if (qfh->in_memory)
+		return static_cast<size_t> (qfh->fh.pos);
 	return static_cast<size_t> (FS_ftell (&qfh->fh));
 }
 
 size_t QuakeFileInterface::Length (Rml::FileHandle file)
 {
 	auto *qfh = reinterpret_cast<QFileHandle *> (file);
+	if (qfh->in_memory)
+		return static_cast<size_t> (qfh->fh.length);
 	return static_cast<size_t> (FS_filelength (&qfh->fh));
 }
 
+bool QuakeFileInterface::ReadFile (const Rml::String &path, Rml::String &out_data)
+{
+	Rml::FileHandle file = OpenFile (path);
+	if (!file)
+		return false;
+
+	auto *qfh = reinterpret_cast<QFileHandle *> (file);
+	out_data.resize (static_cast<size_t> (FS_filelength (&qfh->fh)));
+	size_t read = out_data.empty () ? 0 : FS_fread (&out_data[0], 1, out_data.size (), &qfh->fh);
+	FS_fclose (&qfh->fh);
+	delete qfh;
+	if (read != out_data.size ())
+	{
+		out_data.clear ();
+		return false;
+	}
+	return true;
+}
+
+void QuakeFileInterface::AddPreloadedFile (const Rml::String &path, Rml::String &&data)
+{
+	m_preloaded_files[path] = std::move (data);
+}
+
+void QuakeFileInterface::ClearPreloadedFiles ()
+{
+	m_preloaded_files.clear ();
+}
+
 } // namespace QRmlUI
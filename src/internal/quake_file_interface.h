@@ -8,6 +8,9 @@
  * Search order:
  *   1. Quake VFS via COM_FOpenFile (game dirs, pak files)
  *   2. Basedir-relative fallback (loose files at project root)
+ *
+ * Files read ahead of time by UI_PreloadDocument are served from
+ * memory before either, once, and then dropped.
  */
 
 #ifndef QRMLUI_QUAKE_FILE_INTERFACE_H
@@ -15,6 +18,8 @@
 
 #include <RmlUi/Core/FileInterface.h>
 
+#include <unordered_map>
+
 namespace QRmlUI
 {
 
@@ -27,6 +32,18 @@ class QuakeFileInterface : public Rml::FileInterface
 	bool			Seek (Rml::FileHandle file, long offset, int origin) override;
 	size_t			Tell (Rml::FileHandle file) override;
 	size_t			Length (Rml::FileHandle file) override;
+
+	// Reads a whole file, bypassing the preload cache. Safe to call from task workers.
+	static bool ReadFile (const Rml::String &path, Rml::String &out_data);
+
+	// Main thread only
+	void AddPreloadedFile (const Rml::String &path, Rml::String &&data);
+	void ClearPreloadedFiles ();
+
+  private:
+	static Rml::FileHandle OpenFile (const Rml::String &path);
+
+	std::unordered_map<Rml::String, Rml::String> m_preloaded_files;
 };
 
 } // namespace QRmlUI
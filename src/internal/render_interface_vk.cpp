@@ -23,18 +23,27 @@ extern "C"
 // Embedded SPIR-V shaders (generated from GLSL)
 #include "rmlui_shaders_embedded.h"
 
+// Distance field text shader, compiled with the engine shaders
+extern "C" const unsigned char rmlui_sdf_frag_spv[];
+extern "C" const int		   rmlui_sdf_frag_spv_size;
+
 namespace QRmlUI
 {
 
 RenderInterface_VK::RenderInterface_VK ()
 	: m_config{}, m_current_cmd (VK_NULL_HANDLE), m_viewport_width (0), m_viewport_height (0), m_scissor_enabled (false), m_scissor_rect{},
-	  m_transform_enabled (false), m_frame_draw_calls (0), m_frame_indices (0), m_pipeline_textured (VK_NULL_HANDLE), m_pipeline_layout (VK_NULL_HANDLE),
-	  m_descriptor_pool (VK_NULL_HANDLE), m_texture_set_layout (VK_NULL_HANDLE), m_sampler (VK_NULL_HANDLE), m_white_texture (nullptr),
+	  m_transform_enabled (false), m_frame_draw_calls (0), m_frame_indices (0), m_frame_upload_bytes (0), m_bound_descriptor_set (VK_NULL_HANDLE),
+	  m_pipeline_textured (VK_NULL_HANDLE), m_pipeline_distance_field (VK_NULL_HANDLE), m_pipeline_layout (VK_NULL_HANDLE), m_descriptor_pool (VK_NULL_HANDLE),
+	  m_texture_set_layout (VK_NULL_HANDLE), m_sampler (VK_NULL_HANDLE), m_distance_field_textures (false), m_white_texture (nullptr),
 	  m_next_geometry_handle (1), m_next_texture_handle (1), m_initialized (false), m_upload_cmd_pool (VK_NULL_HANDLE), m_upload_fence (VK_NULL_HANDLE),
 	  m_upload_fence_pending (false), m_timestamp_query_pool (VK_NULL_HANDLE), m_timestamps_supported (false), m_timestamp_period (0.0f),
-	  m_timestamp_valid_bits (0), m_last_gpu_time_ms (0.0), m_timestamp_frame_index (0), m_garbage_index (0)
+	  m_timestamp_valid_bits (0), m_last_gpu_time_ms (0.0), m_timestamp_frame_index (0), m_garbage_index (0), m_batch_rings{},
+	  m_batch_pipeline (VK_NULL_HANDLE), m_batch_descriptor_set (VK_NULL_HANDLE), m_batch_scissor{}, m_batch_transform_enabled (false),
+	  m_batch_first_vertex (0), m_batch_first_index (0), m_batch_num_indices (0), m_recording (false), m_recording_valid (false), m_recorded_width (0),
+	  m_recorded_height (0)
 {
 	m_transform = Rml::Matrix4f::Identity ();
+	m_batch_transform = Rml::Matrix4f::Identity ();
 }
 
 RenderInterface_VK::~RenderInterface_VK ()
@@ -113,7 +122,7 @@ bool RenderInterface_VK::Initialize (const VulkanConfig &config)
 		VkQueryPoolCreateInfo qp_ci{};
 		qp_ci.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
 		qp_ci.queryType = VK_QUERY_TYPE_TIMESTAMP;
-		qp_ci.queryCount = 4; // 2 per frame * DOUBLE_BUFFERED
+		qp_ci.queryCount = 2 * GARBAGE_SLOTS; // 2 per frame slot
 		if (vkCreateQueryPool (m_config.device, &qp_ci, nullptr, &m_timestamp_query_pool) != VK_SUCCESS)
 		{
 			Rml::Log::Message (Rml::Log::LT_WARNING, "Failed to create timestamp query pool, disabling GPU timing");
@@ -200,6 +209,7 @@ void RenderInterface_VK::Shutdown ()
 	}
 	m_textures.clear ();
 	m_white_texture = nullptr;
+	DiscardRecording ();
 
 	// Clean up any pending garbage (safe since we called vkDeviceWaitIdle)
 	for (int slot = 0; slot < GARBAGE_SLOTS; ++slot)
@@ -221,6 +231,19 @@ void RenderInterface_VK::Shutdown ()
 		m_texture_garbage[slot].clear ();
 	}
 
+	DestroyAtlasPages ();
+
+	// Release the batch rings
+	for (BatchRing &ring : m_batch_rings)
+	{
+		if (ring.vertex_alloc.buffer != VK_NULL_HANDLE)
+			m_buffer_pool.Free (ring.vertex_alloc);
+		if (ring.index_alloc.buffer != VK_NULL_HANDLE)
+			m_buffer_pool.Free (ring.index_alloc);
+		ring = BatchRing{};
+	}
+	m_batch_num_indices = 0;
+
 	// Shutdown pools before destroying pipeline resources
 	m_buffer_pool.Shutdown ();
 	m_image_pool.Shutdown ();
@@ -238,6 +261,11 @@ void RenderInterface_VK::DestroyPipelines ()
 		vkDestroyPipeline (m_config.device, m_pipeline_textured, nullptr);
 		m_pipeline_textured = VK_NULL_HANDLE;
 	}
+	if (m_pipeline_distance_field != VK_NULL_HANDLE)
+	{
+		vkDestroyPipeline (m_config.device, m_pipeline_distance_field, nullptr);
+		m_pipeline_distance_field = VK_NULL_HANDLE;
+	}
 	if (m_pipeline_layout != VK_NULL_HANDLE)
 	{
 		vkDestroyPipelineLayout (m_config.device, m_pipeline_layout, nullptr);
@@ -284,6 +312,11 @@ bool RenderInterface_VK::Reinitialize (const VulkanConfig &config)
 			vkDestroyPipeline (m_config.device, m_pipeline_textured, nullptr);
 			m_pipeline_textured = VK_NULL_HANDLE;
 		}
+		if (m_pipeline_distance_field != VK_NULL_HANDLE)
+		{
+			vkDestroyPipeline (m_config.device, m_pipeline_distance_field, nullptr);
+			m_pipeline_distance_field = VK_NULL_HANDLE;
+		}
 		if (m_pipeline_layout != VK_NULL_HANDLE)
 		{
 			vkDestroyPipelineLayout (m_config.device, m_pipeline_layout, nullptr);
@@ -317,11 +350,13 @@ void RenderInterface_VK::BeginFrame (VkCommandBuffer cmd, int width, int height)
 	m_viewport_height = height;
 	m_frame_draw_calls = 0;
 	m_frame_indices = 0;
+	m_frame_upload_bytes = 0;
+	m_bound_descriptor_set = VK_NULL_HANDLE;
 
 	// Read back previous frame's GPU timestamp results (L4)
 	if (m_timestamps_supported)
 	{
-		int		 prev_slot = 1 - m_timestamp_frame_index;
+		int		 prev_slot = (m_timestamp_frame_index + GARBAGE_SLOTS - 1) % GARBAGE_SLOTS;
 		uint64_t timestamps[2] = {0, 0};
 		VkResult ts_result = vkGetQueryPoolResults (
 			m_config.device, m_timestamp_query_pool, static_cast<uint32_t> (prev_slot * 2), 2, sizeof (timestamps), timestamps, sizeof (uint64_t),
@@ -362,6 +397,8 @@ void RenderInterface_VK::EndFrame ()
 {
 	assert (m_current_cmd != VK_NULL_HANDLE && "EndFrame called without BeginFrame");
 
+	FlushBatch ();
+
 	// Flush any batched texture uploads before the frame's command buffers are submitted (L3)
 	FlushPendingUploads ();
 
@@ -401,6 +438,11 @@ void RenderInterface_VK::CollectGarbage ()
 	m_garbage_index = (m_garbage_index + 1) % GARBAGE_SLOTS;
 	assert (m_garbage_index >= 0 && m_garbage_index < GARBAGE_SLOTS);
 
+	// The batch ring of this slot is no longer read by the GPU either
+	assert (m_batch_num_indices == 0 && "CollectGarbage called with an unflushed batch");
+	m_batch_rings[m_garbage_index].num_vertices = 0;
+	m_batch_rings[m_garbage_index].num_indices = 0;
+
 	// Destroy all geometries in this slot
 	for (GeometryData *geometry : m_geometry_garbage[m_garbage_index])
 	{
@@ -422,6 +464,12 @@ void RenderInterface_VK::CollectGarbage ()
 
 void RenderInterface_VK::SetCommandBuffer (VkCommandBuffer cmd)
 {
+	if (cmd != m_current_cmd)
+	{
+		if (m_current_cmd != VK_NULL_HANDLE)
+			FlushBatch ();
+		m_bound_descriptor_set = VK_NULL_HANDLE;
+	}
 	m_current_cmd = cmd;
 }
 
@@ -455,6 +503,11 @@ Rml::CompiledGeometryHandle RenderInterface_VK::CompileGeometry (Rml::Span<const
 	// Copy index data directly into persistently mapped memory
 	memcpy (geometry->index_alloc.mapped_ptr, indices.data (), index_size);
 
+	// Keep a CPU copy so the geometry can be pre-translated into the batch ring,
+	// and its texture coordinates remapped when it is drawn with an atlas texture
+	geometry->vertices.assign (vertices.begin (), vertices.end ());
+	geometry->indices.assign (indices.begin (), indices.end ());
+
 	Rml::CompiledGeometryHandle handle = m_next_geometry_handle++;
 	m_geometries[handle] = geometry;
 	return handle;
@@ -470,6 +523,9 @@ void RenderInterface_VK::RenderGeometry (Rml::CompiledGeometryHandle geometry_ha
 	if (geom_it == m_geometries.end ())
 		return;
 
+	if (m_recording)
+		m_recorded_draws.push_back ({geometry_handle, translation, texture_handle, m_scissor_enabled, m_scissor_rect, m_transform_enabled, m_transform});
+
 	GeometryData *geometry = geom_it->second;
 	TextureData	 *texture = nullptr;
 
@@ -490,27 +546,164 @@ void RenderInterface_VK::RenderGeometry (Rml::CompiledGeometryHandle geometry_ha
 		texture = m_white_texture;
 	}
 
-	// Bind pipeline (always textured — white texture serves as untextured fallback)
-	auto bind_pipeline = m_config.cmd_bind_pipeline ? m_config.cmd_bind_pipeline : vkCmdBindPipeline;
-	bind_pipeline (m_current_cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline_textured);
+	const VkRect2D scissor = GetScissor ();
+	const bool	   batchable = geometry->vertices.size () <= BATCH_MAX_GEOMETRY_VERTICES || texture->atlas_page >= 0;
+	if (batchable && AppendToBatch (geometry, translation, texture, scissor))
+		return;
 
-	// Set scissor
-	auto set_scissor = m_config.cmd_set_scissor ? m_config.cmd_set_scissor : vkCmdSetScissor;
+	FlushBatch ();
+	if (texture->atlas_page >= 0)
+	{
+		DrawAtlasGeometry (geometry, translation, texture, scissor);
+		return;
+	}
+	DrawIndexed (
+		texture->distance_field ? m_pipeline_distance_field : m_pipeline_textured, texture->descriptor_set, scissor, m_transform_enabled, m_transform,
+		translation, geometry->vertex_alloc.buffer, geometry->vertex_alloc.offset, geometry->index_alloc.buffer, geometry->index_alloc.offset,
+		static_cast<uint32_t> (geometry->num_indices));
+}
+
+VkRect2D RenderInterface_VK::GetScissor () const
+{
 	if (m_scissor_enabled)
+		return m_scissor_rect;
+	return {{0, 0}, {static_cast<uint32_t> (m_viewport_width), static_cast<uint32_t> (m_viewport_height)}};
+}
+
+bool RenderInterface_VK::AppendToBatch (const GeometryData *geometry, Rml::Vector2f translation, const TextureData *texture, const VkRect2D &scissor)
+{
+	BatchRing &ring = m_batch_rings[m_garbage_index];
+	if (ring.vertex_alloc.buffer == VK_NULL_HANDLE)
 	{
-		set_scissor (m_current_cmd, 0, 1, &m_scissor_rect);
+		if (!m_buffer_pool.Allocate (BATCH_RING_VERTICES * sizeof (Rml::Vertex), 16, ring.vertex_alloc))
+			return false;
+		if (!m_buffer_pool.Allocate (BATCH_RING_INDICES * sizeof (int), 4, ring.index_alloc))
+		{
+			m_buffer_pool.Free (ring.vertex_alloc);
+			ring.vertex_alloc = BufferAllocation{};
+			return false;
+		}
 	}
-	else
+
+	const uint32_t num_vertices = static_cast<uint32_t> (geometry->vertices.size ());
+	const uint32_t num_indices = static_cast<uint32_t> (geometry->indices.size ());
+	if (ring.num_vertices + num_vertices > BATCH_RING_VERTICES || ring.num_indices + num_indices > BATCH_RING_INDICES)
+		return false;
+
+	// The translation and atlas placement are applied here, so only the state that ends up in the draw has to match
+	if (m_batch_num_indices > 0)
+	{
+		const bool same_transform =
+			(m_batch_transform_enabled == m_transform_enabled) &&
+			(!m_transform_enabled || memcmp (m_batch_transform.data (), m_transform.data (), sizeof (float) * 16) == 0);
+		if (texture->descriptor_set != m_batch_descriptor_set || memcmp (&scissor, &m_batch_scissor, sizeof (VkRect2D)) != 0 || !same_transform)
+			FlushBatch ();
+	}
+	if (m_batch_num_indices == 0)
+	{
+		m_batch_pipeline = texture->distance_field ? m_pipeline_distance_field : m_pipeline_textured;
+		m_batch_descriptor_set = texture->descriptor_set;
+		m_batch_scissor = scissor;
+		m_batch_transform_enabled = m_transform_enabled;
+		m_batch_transform = m_transform;
+		m_batch_first_vertex = ring.num_vertices;
+		m_batch_first_index = ring.num_indices;
+	}
+
+	Rml::Vertex *vertices = static_cast<Rml::Vertex *> (ring.vertex_alloc.mapped_ptr) + ring.num_vertices;
+	for (uint32_t i = 0; i < num_vertices; ++i)
+	{
+		vertices[i] = geometry->vertices[i];
+		vertices[i].position += translation;
+	}
+	if (texture->atlas_page >= 0)
+	{
+		for (uint32_t i = 0; i < num_vertices; ++i)
+		{
+			vertices[i].tex_coord.x = texture->uv_offset[0] + vertices[i].tex_coord.x * texture->uv_scale[0];
+			vertices[i].tex_coord.y = texture->uv_offset[1] + vertices[i].tex_coord.y * texture->uv_scale[1];
+		}
+	}
+
+	const int base_vertex = static_cast<int> (ring.num_vertices - m_batch_first_vertex);
+	int		 *indices = static_cast<int *> (ring.index_alloc.mapped_ptr) + ring.num_indices;
+	for (uint32_t i = 0; i < num_indices; ++i)
+		indices[i] = geometry->indices[i] + base_vertex;
+
+	ring.num_vertices += num_vertices;
+	ring.num_indices += num_indices;
+	m_batch_num_indices += num_indices;
+	return true;
+}
+
+void RenderInterface_VK::FlushBatch ()
+{
+	if (m_batch_num_indices == 0)
+		return;
+
+	const BatchRing &ring = m_batch_rings[m_garbage_index];
+	if (m_current_cmd != VK_NULL_HANDLE)
 	{
-		VkRect2D full_scissor = {{0, 0}, {static_cast<uint32_t> (m_viewport_width), static_cast<uint32_t> (m_viewport_height)}};
-		set_scissor (m_current_cmd, 0, 1, &full_scissor);
+		DrawIndexed (
+			m_batch_pipeline, m_batch_descriptor_set, m_batch_scissor, m_batch_transform_enabled, m_batch_transform, Rml::Vector2f (0.0f, 0.0f),
+			ring.vertex_alloc.buffer, ring.vertex_alloc.offset + m_batch_first_vertex * sizeof (Rml::Vertex), ring.index_alloc.buffer,
+			ring.index_alloc.offset + m_batch_first_index * sizeof (int), m_batch_num_indices);
 	}
+	m_batch_num_indices = 0;
+}
+
+void RenderInterface_VK::DrawAtlasGeometry (const GeometryData *geometry, Rml::Vector2f translation, const TextureData *texture, const VkRect2D &scissor)
+{
+	// The batch ring is full, remap into a temporary copy that is released with the frame's garbage
+	auto		*remapped = new GeometryData ();
+	VkDeviceSize vertex_size = geometry->vertices.size () * sizeof (Rml::Vertex);
+	VkDeviceSize index_size = geometry->indices.size () * sizeof (int);
+	if (!m_buffer_pool.Allocate (vertex_size, 16, remapped->vertex_alloc))
+	{
+		delete remapped;
+		return;
+	}
+	if (!m_buffer_pool.Allocate (index_size, 4, remapped->index_alloc))
+	{
+		m_buffer_pool.Free (remapped->vertex_alloc);
+		delete remapped;
+		return;
+	}
+	remapped->num_indices = geometry->num_indices;
+
+	Rml::Vertex *vertices = static_cast<Rml::Vertex *> (remapped->vertex_alloc.mapped_ptr);
+	for (size_t i = 0; i < geometry->vertices.size (); ++i)
+	{
+		vertices[i] = geometry->vertices[i];
+		vertices[i].tex_coord.x = texture->uv_offset[0] + vertices[i].tex_coord.x * texture->uv_scale[0];
+		vertices[i].tex_coord.y = texture->uv_offset[1] + vertices[i].tex_coord.y * texture->uv_scale[1];
+	}
+	memcpy (remapped->index_alloc.mapped_ptr, geometry->indices.data (), index_size);
+	m_geometry_garbage[m_garbage_index].push_back (remapped);
+
+	DrawIndexed (
+		m_pipeline_textured, texture->descriptor_set, scissor, m_transform_enabled, m_transform, translation, remapped->vertex_alloc.buffer,
+		remapped->vertex_alloc.offset, remapped->index_alloc.buffer, remapped->index_alloc.offset, static_cast<uint32_t> (remapped->num_indices));
+}
 
-	// Bind texture descriptor set
-	if (texture && texture->descriptor_set)
+void RenderInterface_VK::DrawIndexed (
+	VkPipeline pipeline, VkDescriptorSet descriptor_set, const VkRect2D &scissor, bool transform_enabled, const Rml::Matrix4f &transform,
+	Rml::Vector2f translation, VkBuffer vertex_buffer, VkDeviceSize vertex_offset, VkBuffer index_buffer, VkDeviceSize index_offset, uint32_t num_indices)
+{
+	// Bind pipeline (textured or distance field text — white texture serves as untextured fallback)
+	auto bind_pipeline = m_config.cmd_bind_pipeline ? m_config.cmd_bind_pipeline : vkCmdBindPipeline;
+	bind_pipeline (m_current_cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+
+	// Set scissor
+	auto set_scissor = m_config.cmd_set_scissor ? m_config.cmd_set_scissor : vkCmdSetScissor;
+	set_scissor (m_current_cmd, 0, 1, &scissor);
+
+	// Bind texture descriptor set, atlas textures share the one of their page
+	if (descriptor_set && descriptor_set != m_bound_descriptor_set)
 	{
 		auto bind_desc = m_config.cmd_bind_descriptor_sets ? m_config.cmd_bind_descriptor_sets : vkCmdBindDescriptorSets;
-		bind_desc (m_current_cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline_layout, 0, 1, &texture->descriptor_set, 0, nullptr);
+		bind_desc (m_current_cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline_layout, 0, 1, &descriptor_set, 0, nullptr);
+		m_bound_descriptor_set = descriptor_set;
 	}
 
 	// Push constants with transform and translation
@@ -526,9 +719,9 @@ void RenderInterface_VK::RenderGeometry (Rml::CompiledGeometryHandle geometry_ha
 		{2.0f / (R - L), 0.0f, 0.0f, (R + L) / (L - R)}, {0.0f, 2.0f / (B - T), 0.0f, (T + B) / (T - B)}, {0.0f, 0.0f, -1.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 1.0f});
 
 	Rml::Matrix4f mvp = projection;
-	if (m_transform_enabled)
+	if (transform_enabled)
 	{
-		mvp = projection * m_transform;
+		mvp = projection * transform;
 	}
 
 	memcpy (push_constants.transform, mvp.data (), sizeof (push_constants.transform));
@@ -539,19 +732,18 @@ void RenderInterface_VK::RenderGeometry (Rml::CompiledGeometryHandle geometry_ha
 	push_const (m_current_cmd, m_pipeline_layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof (PushConstants), &push_constants);
 
 	// Bind vertex buffer at suballocation offset
-	VkDeviceSize vertex_offset = geometry->vertex_alloc.offset;
-	auto		 bind_vb = m_config.cmd_bind_vertex_buffers ? m_config.cmd_bind_vertex_buffers : vkCmdBindVertexBuffers;
-	bind_vb (m_current_cmd, 0, 1, &geometry->vertex_alloc.buffer, &vertex_offset);
+	auto bind_vb = m_config.cmd_bind_vertex_buffers ? m_config.cmd_bind_vertex_buffers : vkCmdBindVertexBuffers;
+	bind_vb (m_current_cmd, 0, 1, &vertex_buffer, &vertex_offset);
 
 	// Bind index buffer at suballocation offset
 	auto bind_ib = m_config.cmd_bind_index_buffer ? m_config.cmd_bind_index_buffer : vkCmdBindIndexBuffer;
-	bind_ib (m_current_cmd, geometry->index_alloc.buffer, geometry->index_alloc.offset, VK_INDEX_TYPE_UINT32);
+	bind_ib (m_current_cmd, index_buffer, index_offset, VK_INDEX_TYPE_UINT32);
 
 	// Draw
 	auto draw_indexed = m_config.cmd_draw_indexed ? m_config.cmd_draw_indexed : vkCmdDrawIndexed;
-	draw_indexed (m_current_cmd, geometry->num_indices, 1, 0, 0, 0);
+	draw_indexed (m_current_cmd, num_indices, 1, 0, 0, 0);
 	m_frame_draw_calls++;
-	m_frame_indices += static_cast<uint32_t> (geometry->num_indices);
+	m_frame_indices += num_indices;
 }
 
 void RenderInterface_VK::ReleaseGeometry (Rml::CompiledGeometryHandle geometry_handle)
@@ -565,6 +757,7 @@ void RenderInterface_VK::ReleaseGeometry (Rml::CompiledGeometryHandle geometry_h
 	GeometryData *geometry = it->second;
 	m_geometry_garbage[m_garbage_index].push_back (geometry);
 	m_geometries.erase (it);
+	m_recording_valid = false;
 }
 
 Rml::TextureHandle RenderInterface_VK::LoadTexture (Rml::Vector2i &texture_dimensions, const Rml::String &source)
@@ -612,116 +805,57 @@ Rml::TextureHandle RenderInterface_VK::LoadTexture (Rml::Vector2i &texture_dimen
 
 Rml::TextureHandle RenderInterface_VK::GenerateTexture (Rml::Span<const Rml::byte> source, Rml::Vector2i source_dimensions)
 {
-	auto *texture = new TextureData ();
-	texture->dimensions = source_dimensions;
-
-	VkDeviceSize image_size = source_dimensions.x * source_dimensions.y * 4;
-
-	// Create staging buffer
-	VkBuffer	   staging_buffer;
-	VkDeviceMemory staging_memory;
-	staging_buffer =
-		CreateBuffer (image_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, staging_memory);
-
-	void *data;
-	vkMapMemory (m_config.device, staging_memory, 0, image_size, 0, &data);
-	memcpy (data, source.data (), image_size);
-	vkUnmapMemory (m_config.device, staging_memory);
-
-	// Create image
-	VkImageCreateInfo image_info{};
-	image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-	image_info.imageType = VK_IMAGE_TYPE_2D;
-	image_info.extent.width = source_dimensions.x;
-	image_info.extent.height = source_dimensions.y;
-	image_info.extent.depth = 1;
-	image_info.mipLevels = 1;
-	image_info.arrayLayers = 1;
-	image_info.format = VK_FORMAT_R8G8B8A8_UNORM;
-	image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
-	image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-	image_info.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-	image_info.samples = VK_SAMPLE_COUNT_1_BIT;
-	image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-	if (vkCreateImage (m_config.device, &image_info, nullptr, &texture->image) != VK_SUCCESS)
-	{
-		DestroyBuffer (staging_buffer, staging_memory);
-		delete texture;
-		return 0;
-	}
-
-	// Allocate image memory from pool
-	VkMemoryRequirements mem_reqs;
-	vkGetImageMemoryRequirements (m_config.device, texture->image, &mem_reqs);
-
-	if (!m_image_pool.Allocate (mem_reqs, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, texture->memory_alloc))
+	// Small textures (glyph pages, icons) are packed into a shared atlas page, the white texture stays on its own.
+	// Atlas uploads are always staged, an atlas page is only modified by commands submitted ahead of the frame.
+	if (m_white_texture && !m_distance_field_textures && static_cast<uint32_t> (source_dimensions.x) <= ATLAS_MAX_TEXTURE_SIZE &&
+		static_cast<uint32_t> (source_dimensions.y) <= ATLAS_MAX_TEXTURE_SIZE)
 	{
-		vkDestroyImage (m_config.device, texture->image, nullptr);
-		DestroyBuffer (staging_buffer, staging_memory);
-		delete texture;
-		return 0;
+		TextureData *atlas_texture = GenerateAtlasTexture (source, source_dimensions);
+		if (atlas_texture)
+		{
+			Rml::TextureHandle handle = m_next_texture_handle++;
+			m_textures[handle] = atlas_texture;
+			return handle;
+		}
 	}
 
-	vkBindImageMemory (m_config.device, texture->image, texture->memory_alloc.memory, texture->memory_alloc.offset);
+	auto *texture = new TextureData ();
+	texture->dimensions = source_dimensions;
+	texture->distance_field = m_distance_field_textures;
 
-	// Create image view and descriptor set BEFORE staging the upload.
-	// Both are host-side operations that don't depend on the GPU transfer.
-	// This ensures that if either fails, no staged/pending upload entry
+	// Create image, view and descriptor set BEFORE staging the upload.
+	// These are host-side operations that don't depend on the GPU transfer.
+	// This ensures that if any fails, no staged/pending upload entry
 	// references the texture — avoiding use-after-free in FlushPendingUploads().
-	VkImageViewCreateInfo view_info{};
-	view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-	view_info.image = texture->image;
-	view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
-	view_info.format = VK_FORMAT_R8G8B8A8_UNORM;
-	view_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-	view_info.subresourceRange.baseMipLevel = 0;
-	view_info.subresourceRange.levelCount = 1;
-	view_info.subresourceRange.baseArrayLayer = 0;
-	view_info.subresourceRange.layerCount = 1;
-
-	if (vkCreateImageView (m_config.device, &view_info, nullptr, &texture->view) != VK_SUCCESS)
+	if (!CreateTextureResources (texture, source_dimensions))
 	{
-		m_image_pool.Free (texture->memory_alloc);
-		vkDestroyImage (m_config.device, texture->image, nullptr);
-		DestroyBuffer (staging_buffer, staging_memory);
 		delete texture;
 		return 0;
 	}
 
-	texture->sampler = m_sampler;
-
-	VkDescriptorSetAllocateInfo desc_alloc_info{};
-	desc_alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-	desc_alloc_info.descriptorPool = m_descriptor_pool;
-	desc_alloc_info.descriptorSetCount = 1;
-	desc_alloc_info.pSetLayouts = &m_texture_set_layout;
+	VkDeviceSize image_size = source_dimensions.x * source_dimensions.y * 4;
 
-	if (vkAllocateDescriptorSets (m_config.device, &desc_alloc_info, &texture->descriptor_set) != VK_SUCCESS)
+	// Engine staging ring, works inside a frame or not since the engine submits it either way
+	if (m_config.staging_allocate)
 	{
-		vkDestroyImageView (m_config.device, texture->view, nullptr);
-		m_image_pool.Free (texture->memory_alloc);
-		vkDestroyImage (m_config.device, texture->image, nullptr);
-		DestroyBuffer (staging_buffer, staging_memory);
-		delete texture;
-		return 0;
-	}
+		memcpy (BeginStagedUpload (texture->image, VK_IMAGE_LAYOUT_UNDEFINED, {0, 0}, source_dimensions), source.data (), image_size);
+		EndStagedUpload ();
 
-	VkDescriptorImageInfo image_desc_info{};
-	image_desc_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-	image_desc_info.imageView = texture->view;
-	image_desc_info.sampler = texture->sampler;
+		Rml::TextureHandle handle = m_next_texture_handle++;
+		m_textures[handle] = texture;
+		return handle;
+	}
 
-	VkWriteDescriptorSet write{};
-	write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-	write.dstSet = texture->descriptor_set;
-	write.dstBinding = 0;
-	write.dstArrayElement = 0;
-	write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-	write.descriptorCount = 1;
-	write.pImageInfo = &image_desc_info;
+	// Create staging buffer
+	VkBuffer	   staging_buffer;
+	VkDeviceMemory staging_memory;
+	staging_buffer =
+		CreateBuffer (image_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, staging_memory);
 
-	vkUpdateDescriptorSets (m_config.device, 1, &write, 0, nullptr);
+	void *data;
+	vkMapMemory (m_config.device, staging_memory, 0, image_size, 0, &data);
+	memcpy (data, source.data (), image_size);
+	vkUnmapMemory (m_config.device, staging_memory);
 
 	// Batched path: if inside a frame (BeginFrame was called), defer the upload.
 	// Immediate path: if outside a frame (e.g. during Initialize()), submit now.
@@ -732,7 +866,7 @@ Rml::TextureHandle RenderInterface_VK::GenerateTexture (Rml::Span<const Rml::byt
 	if (inside_frame)
 	{
 		// Stage for batch upload — actual GPU copy happens in FlushPendingUploads()
-		m_staged_uploads.push_back ({texture->image, staging_buffer, staging_memory, source_dimensions});
+		m_staged_uploads.push_back ({texture->image, staging_buffer, staging_memory, source_dimensions, {0, 0}, VK_IMAGE_LAYOUT_UNDEFINED, -1});
 	}
 	else
 	{
@@ -830,6 +964,45 @@ void RenderInterface_VK::ReleaseTexture (Rml::TextureHandle texture_handle)
 	// by in-flight command buffers
 	m_texture_garbage[m_garbage_index].push_back (texture);
 	m_textures.erase (it);
+	m_recording_valid = false;
+}
+
+void RenderInterface_VK::BeginRecording ()
+{
+	m_recorded_draws.clear ();
+	m_recording = true;
+	m_recording_valid = false;
+}
+
+void RenderInterface_VK::EndRecording ()
+{
+	m_recording = false;
+	m_recording_valid = true;
+	m_recorded_width = m_viewport_width;
+	m_recorded_height = m_viewport_height;
+}
+
+void RenderInterface_VK::DiscardRecording ()
+{
+	m_recorded_draws.clear ();
+	m_recording = false;
+	m_recording_valid = false;
+}
+
+bool RenderInterface_VK::ReplayRecording ()
+{
+	if (!m_recording_valid || m_current_cmd == VK_NULL_HANDLE || m_recorded_width != m_viewport_width || m_recorded_height != m_viewport_height)
+		return false;
+
+	for (const RecordedDraw &draw : m_recorded_draws)
+	{
+		m_scissor_enabled = draw.scissor_enabled;
+		m_scissor_rect = draw.scissor_rect;
+		m_transform_enabled = draw.transform_enabled;
+		m_transform = draw.transform;
+		RenderGeometry (draw.geometry, draw.translation, draw.texture);
+	}
+	return true;
 }
 
 void RenderInterface_VK::EnableScissorRegion (bool enable)
@@ -902,14 +1075,24 @@ void RenderInterface_VK::FlushPendingUploads ()
 
 		for (auto &staged : m_staged_uploads)
 		{
-			// Barrier: UNDEFINED → TRANSFER_DST_OPTIMAL
-			ImageBarrier (
-				cmd, staged.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 0, VK_ACCESS_TRANSFER_WRITE_BIT,
-				VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+			// Barrier: UNDEFINED → TRANSFER_DST_OPTIMAL, atlas pages that are already in use keep their contents
+			if (staged.old_layout == VK_IMAGE_LAYOUT_UNDEFINED)
+			{
+				ImageBarrier (
+					cmd, staged.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 0, VK_ACCESS_TRANSFER_WRITE_BIT,
+					VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+			}
+			else
+			{
+				ImageBarrier (
+					cmd, staged.image, staged.old_layout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+					VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+			}
 
 			VkBufferImageCopy region{};
 			region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
 			region.imageSubresource.layerCount = 1;
+			region.imageOffset = {staged.offset.x, staged.offset.y, 0};
 			region.imageExtent = {static_cast<uint32_t> (staged.dimensions.x), static_cast<uint32_t> (staged.dimensions.y), 1};
 			vkCmdCopyBufferToImage (cmd, staged.staging_buffer, staged.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
 
@@ -939,7 +1122,10 @@ void RenderInterface_VK::FlushPendingUploads ()
 
 	// Move staging buffers to prev-batch for deferred cleanup
 	for (auto &staged : m_staged_uploads)
+	{
 		m_prev_batch_staging.emplace_back (staged.staging_buffer, staged.staging_memory);
+		m_frame_upload_bytes += static_cast<uint32_t> (staged.dimensions.x * staged.dimensions.y * 4);
+	}
 	m_staged_uploads.clear ();
 	m_upload_fence_pending = true;
 	return;
@@ -949,9 +1135,14 @@ flush_fail:
 	// and do NOT set m_upload_fence_pending (would deadlock next frame).
 	// The images themselves are valid — they have memory, views, and descriptors
 	// (thanks to GenerateTexture reorder) but will lack pixel data until
-	// RmlUI regenerates them.
+	// RmlUI regenerates them. An atlas page whose first upload was lost is
+	// still in VK_IMAGE_LAYOUT_UNDEFINED.
 	for (auto &staged : m_staged_uploads)
+	{
+		if (staged.atlas_page >= 0 && staged.old_layout == VK_IMAGE_LAYOUT_UNDEFINED)
+			m_atlas_pages[staged.atlas_page].initialized = false;
 		DestroyBuffer (staged.staging_buffer, staged.staging_memory);
+	}
 	m_staged_uploads.clear ();
 }
 
@@ -962,6 +1153,52 @@ void RenderInterface_VK::FreePrevBatchStaging ()
 	m_prev_batch_staging.clear ();
 }
 
+// Same flow as the engine's texture uploads: the copy and both barriers are recorded into the staging command buffer
+// right away, the engine submits it ahead of the frame's command buffers. The caller fills the returned memory and
+// calls EndStagedUpload().
+uint32_t *RenderInterface_VK::BeginStagedUpload (VkImage image, VkImageLayout old_layout, VkOffset2D offset, Rml::Vector2i dimensions)
+{
+	const int		size = dimensions.x * dimensions.y * 4;
+	VkCommandBuffer cmd;
+	VkBuffer		staging_buffer;
+	int				staging_offset;
+	unsigned char  *data = m_config.staging_allocate (size, 4, &cmd, &staging_buffer, &staging_offset);
+
+	if (old_layout == VK_IMAGE_LAYOUT_UNDEFINED)
+	{
+		ImageBarrier (
+			cmd, image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+			VK_PIPELINE_STAGE_TRANSFER_BIT);
+	}
+	else
+	{
+		ImageBarrier (
+			cmd, image, old_layout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+			VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+	}
+
+	VkBufferImageCopy region{};
+	region.bufferOffset = static_cast<VkDeviceSize> (staging_offset);
+	region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	region.imageSubresource.layerCount = 1;
+	region.imageOffset = {offset.x, offset.y, 0};
+	region.imageExtent = {static_cast<uint32_t> (dimensions.x), static_cast<uint32_t> (dimensions.y), 1};
+	vkCmdCopyBufferToImage (cmd, staging_buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+	ImageBarrier (
+		cmd, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+		VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+
+	m_config.staging_begin_copy ();
+	m_frame_upload_bytes += static_cast<uint32_t> (size);
+	return reinterpret_cast<uint32_t *> (data);
+}
+
+void RenderInterface_VK::EndStagedUpload ()
+{
+	m_config.staging_end_copy ();
+}
+
 // ── Sync2-Aware Barrier Helper (H1) ──────────────────────────────────────
 
 void RenderInterface_VK::ImageBarrier (
@@ -1030,7 +1267,7 @@ void RenderInterface_VK::WriteEndTimestamp (VkCommandBuffer primary_cb)
 		return;
 	uint32_t base = static_cast<uint32_t> (m_timestamp_frame_index * 2);
 	vkCmdWriteTimestamp (primary_cb, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_timestamp_query_pool, base + 1);
-	m_timestamp_frame_index = 1 - m_timestamp_frame_index;
+	m_timestamp_frame_index = (m_timestamp_frame_index + 1) % GARBAGE_SLOTS;
 }
 
 double RenderInterface_VK::GetLastFrameGpuTimeMs () const
@@ -1271,7 +1508,7 @@ bool RenderInterface_VK::CreatePipeline ()
 		pipeline_info.subpass = m_config.subpass;
 	}
 
-	if (vkCreateGraphicsPipelines (m_config.device, VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &m_pipeline_textured) != VK_SUCCESS)
+	if (vkCreateGraphicsPipelines (m_config.device, m_config.pipeline_cache, 1, &pipeline_info, nullptr, &m_pipeline_textured) != VK_SUCCESS)
 	{
 		vkDestroyShaderModule (m_config.device, vert_module, nullptr);
 		vkDestroyShaderModule (m_config.device, frag_module, nullptr);
@@ -1279,9 +1516,35 @@ bool RenderInterface_VK::CreatePipeline ()
 		return false;
 	}
 
+	// Distance field text differs only in the fragment shader
+	VkShaderModuleCreateInfo sdf_frag_info{};
+	sdf_frag_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+	sdf_frag_info.codeSize = rmlui_sdf_frag_spv_size;
+	sdf_frag_info.pCode = reinterpret_cast<const uint32_t *> (rmlui_sdf_frag_spv);
+
+	VkShaderModule sdf_frag_module;
+	if (vkCreateShaderModule (m_config.device, &sdf_frag_info, nullptr, &sdf_frag_module) != VK_SUCCESS)
+	{
+		vkDestroyShaderModule (m_config.device, vert_module, nullptr);
+		vkDestroyShaderModule (m_config.device, frag_module, nullptr);
+		Rml::Log::Message (Rml::Log::LT_ERROR, "Failed to create distance field fragment shader module");
+		return false;
+	}
+
+	stages[1].module = sdf_frag_module;
+	const VkResult sdf_result =
+		vkCreateGraphicsPipelines (m_config.device, m_config.pipeline_cache, 1, &pipeline_info, nullptr, &m_pipeline_distance_field);
+
 	// Clean up shader modules (no longer needed after pipeline creation)
 	vkDestroyShaderModule (m_config.device, vert_module, nullptr);
 	vkDestroyShaderModule (m_config.device, frag_module, nullptr);
+	vkDestroyShaderModule (m_config.device, sdf_frag_module, nullptr);
+
+	if (sdf_result != VK_SUCCESS)
+	{
+		Rml::Log::Message (Rml::Log::LT_ERROR, "Failed to create distance field pipeline");
+		return false;
+	}
 
 	return true;
 }
@@ -1342,8 +1605,241 @@ void RenderInterface_VK::DestroyBuffer (VkBuffer buffer, VkDeviceMemory memory)
 	}
 }
 
+bool RenderInterface_VK::CreateTextureResources (TextureData *texture, Rml::Vector2i dimensions)
+{
+	// Create image
+	VkImageCreateInfo image_info{};
+	image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	image_info.imageType = VK_IMAGE_TYPE_2D;
+	image_info.extent.width = dimensions.x;
+	image_info.extent.height = dimensions.y;
+	image_info.extent.depth = 1;
+	image_info.mipLevels = 1;
+	image_info.arrayLayers = 1;
+	image_info.format = VK_FORMAT_R8G8B8A8_UNORM;
+	image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+	image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	image_info.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+	image_info.samples = VK_SAMPLE_COUNT_1_BIT;
+	image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	if (vkCreateImage (m_config.device, &image_info, nullptr, &texture->image) != VK_SUCCESS)
+		return false;
+
+	// Allocate image memory from pool
+	VkMemoryRequirements mem_reqs;
+	vkGetImageMemoryRequirements (m_config.device, texture->image, &mem_reqs);
+
+	if (!m_image_pool.Allocate (mem_reqs, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, texture->memory_alloc))
+	{
+		vkDestroyImage (m_config.device, texture->image, nullptr);
+		return false;
+	}
+
+	vkBindImageMemory (m_config.device, texture->image, texture->memory_alloc.memory, texture->memory_alloc.offset);
+
+	VkImageViewCreateInfo view_info{};
+	view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	view_info.image = texture->image;
+	view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+	view_info.format = VK_FORMAT_R8G8B8A8_UNORM;
+	view_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	view_info.subresourceRange.baseMipLevel = 0;
+	view_info.subresourceRange.levelCount = 1;
+	view_info.subresourceRange.baseArrayLayer = 0;
+	view_info.subresourceRange.layerCount = 1;
+
+	if (vkCreateImageView (m_config.device, &view_info, nullptr, &texture->view) != VK_SUCCESS)
+	{
+		m_image_pool.Free (texture->memory_alloc);
+		vkDestroyImage (m_config.device, texture->image, nullptr);
+		return false;
+	}
+
+	texture->sampler = m_sampler;
+
+	VkDescriptorSetAllocateInfo desc_alloc_info{};
+	desc_alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	desc_alloc_info.descriptorPool = m_descriptor_pool;
+	desc_alloc_info.descriptorSetCount = 1;
+	desc_alloc_info.pSetLayouts = &m_texture_set_layout;
+
+	if (vkAllocateDescriptorSets (m_config.device, &desc_alloc_info, &texture->descriptor_set) != VK_SUCCESS)
+	{
+		vkDestroyImageView (m_config.device, texture->view, nullptr);
+		m_image_pool.Free (texture->memory_alloc);
+		vkDestroyImage (m_config.device, texture->image, nullptr);
+		return false;
+	}
+
+	VkDescriptorImageInfo image_desc_info{};
+	image_desc_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	image_desc_info.imageView = texture->view;
+	image_desc_info.sampler = texture->sampler;
+
+	VkWriteDescriptorSet write{};
+	write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	write.dstSet = texture->descriptor_set;
+	write.dstBinding = 0;
+	write.dstArrayElement = 0;
+	write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	write.descriptorCount = 1;
+	write.pImageInfo = &image_desc_info;
+
+	vkUpdateDescriptorSets (m_config.device, 1, &write, 0, nullptr);
+	return true;
+}
+
+// --- Texture atlas ---
+
+bool RenderInterface_VK::AllocateAtlasRegion (uint32_t width, uint32_t height, int &page_index, VkOffset2D &offset)
+{
+	for (size_t i = 0; i < m_atlas_pages.size (); ++i)
+	{
+		AtlasPage &page = m_atlas_pages[i];
+
+		// Best fitting shelf first, so glyph pages of one font size end up sharing shelves
+		AtlasShelf *best = nullptr;
+		for (AtlasShelf &shelf : page.shelves)
+		{
+			if (shelf.height >= height && shelf.x + width <= ATLAS_PAGE_SIZE && (!best || shelf.height < best->height))
+				best = &shelf;
+		}
+		if (best && best->height <= height + height / 2)
+		{
+			page_index = static_cast<int> (i);
+			offset = {static_cast<int32_t> (best->x), static_cast<int32_t> (best->y)};
+			best->x += width;
+			return true;
+		}
+		if (page.next_y + height <= ATLAS_PAGE_SIZE)
+		{
+			page.shelves.push_back ({page.next_y, height, width});
+			page_index = static_cast<int> (i);
+			offset = {0, static_cast<int32_t> (page.next_y)};
+			page.next_y += height;
+			return true;
+		}
+		if (best)
+		{
+			page_index = static_cast<int> (i);
+			offset = {static_cast<int32_t> (best->x), static_cast<int32_t> (best->y)};
+			best->x += width;
+			return true;
+		}
+	}
+
+	// Every page is full, start a new one
+	AtlasPage page{};
+	page.texture = new TextureData ();
+	page.texture->dimensions = {static_cast<int> (ATLAS_PAGE_SIZE), static_cast<int> (ATLAS_PAGE_SIZE)};
+	if (!CreateTextureResources (page.texture, page.texture->dimensions))
+	{
+		delete page.texture;
+		return false;
+	}
+	page.shelves.push_back ({0, height, width});
+	page.next_y = height;
+	m_atlas_pages.push_back (page);
+
+	page_index = static_cast<int> (m_atlas_pages.size ()) - 1;
+	offset = {0, 0};
+	return true;
+}
+
+static void WritePaddedTexels (uint32_t *dst, const Rml::byte *src, uint32_t width, uint32_t height)
+{
+	for (uint32_t y = 0; y < height + 2; ++y)
+	{
+		const uint32_t sy = (y == 0) ? 0 : ((y > height) ? height - 1 : y - 1);
+		for (uint32_t x = 0; x < width + 2; ++x)
+		{
+			const uint32_t sx = (x == 0) ? 0 : ((x > width) ? width - 1 : x - 1);
+			memcpy (dst++, src + (sy * width + sx) * 4, 4);
+		}
+	}
+}
+
+RenderInterface_VK::TextureData *RenderInterface_VK::GenerateAtlasTexture (Rml::Span<const Rml::byte> source, Rml::Vector2i source_dimensions)
+{
+	const uint32_t width = static_cast<uint32_t> (source_dimensions.x);
+	const uint32_t height = static_cast<uint32_t> (source_dimensions.y);
+	if (width == 0 || height == 0)
+		return nullptr;
+
+	int		   page_index;
+	VkOffset2D offset;
+	if (!AllocateAtlasRegion (width + 2, height + 2, page_index, offset))
+		return nullptr;
+
+	// Staging data includes the border, each border texel repeats the nearest edge texel
+	const Rml::Vector2i padded_dimensions (static_cast<int> (width + 2), static_cast<int> (height + 2));
+	VkDeviceSize		padded_size = static_cast<VkDeviceSize> (padded_dimensions.x) * padded_dimensions.y * 4;
+	AtlasPage		   &page = m_atlas_pages[page_index];
+	const VkImageLayout old_layout = page.initialized ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+
+	if (m_config.staging_allocate)
+	{
+		WritePaddedTexels (BeginStagedUpload (page.texture->image, old_layout, offset, padded_dimensions), source.data (), width, height);
+		EndStagedUpload ();
+	}
+	else
+	{
+		VkBuffer	   staging_buffer;
+		VkDeviceMemory staging_memory;
+		staging_buffer = CreateBuffer (
+			padded_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, staging_memory);
+		if (staging_buffer == VK_NULL_HANDLE)
+			return nullptr;
+
+		void *data;
+		vkMapMemory (m_config.device, staging_memory, 0, padded_size, 0, &data);
+		WritePaddedTexels (static_cast<uint32_t *> (data), source.data (), width, height);
+		vkUnmapMemory (m_config.device, staging_memory);
+
+		m_staged_uploads.push_back ({page.texture->image, staging_buffer, staging_memory, padded_dimensions, offset, old_layout, page_index});
+	}
+	page.initialized = true;
+	page.live_textures++;
+
+	auto *texture = new TextureData ();
+	texture->dimensions = source_dimensions;
+	texture->sampler = m_sampler;
+	texture->descriptor_set = page.texture->descriptor_set;
+	texture->atlas_page = page_index;
+	texture->uv_offset[0] = static_cast<float> (offset.x + 1) / ATLAS_PAGE_SIZE;
+	texture->uv_offset[1] = static_cast<float> (offset.y + 1) / ATLAS_PAGE_SIZE;
+	texture->uv_scale[0] = static_cast<float> (width) / ATLAS_PAGE_SIZE;
+	texture->uv_scale[1] = static_cast<float> (height) / ATLAS_PAGE_SIZE;
+	return texture;
+}
+
+void RenderInterface_VK::DestroyAtlasPages ()
+{
+	for (AtlasPage &page : m_atlas_pages)
+	{
+		DestroyTexture (page.texture);
+		m_image_pool.Free (page.texture->memory_alloc);
+		delete page.texture;
+	}
+	m_atlas_pages.clear ();
+}
+
 void RenderInterface_VK::DestroyTexture (TextureData *texture)
 {
+	if (texture->atlas_page >= 0)
+	{
+		// The page is shared, only give the region back. Regions are reclaimed all at once when the page is empty,
+		// this runs from the garbage collection so the GPU is done with every texture that was on it.
+		AtlasPage &page = m_atlas_pages[texture->atlas_page];
+		assert (page.live_textures > 0);
+		if (--page.live_textures == 0)
+		{
+			page.shelves.clear ();
+			page.next_y = 0;
+		}
+		return;
+	}
 	if (texture->descriptor_set != VK_NULL_HANDLE)
 	{
 		vkFreeDescriptorSets (m_config.device, m_descriptor_pool, 1, &texture->descriptor_set);
@@ -57,6 +57,16 @@ struct VulkanConfig
 	PFN_vkCmdPushConstants		cmd_push_constants;
 	PFN_vkCmdSetScissor			cmd_set_scissor;
 	PFN_vkCmdSetViewport		cmd_set_viewport;
+
+	// Engine pipeline cache, shared so UI pipelines are persisted too
+	VkPipelineCache pipeline_cache;
+
+	// Engine staging ring (R_StagingAllocate), texture uploads are recorded into its command buffer
+	// and submitted with the engine's own uploads ahead of the frame. Optional, null falls back to
+	// a staging buffer per upload.
+	unsigned char *(*staging_allocate) (int size, int alignment, VkCommandBuffer *cb, VkBuffer *buffer, int *buffer_offset);
+	void (*staging_begin_copy) (void);
+	void (*staging_end_copy) (void);
 };
 
 class RenderInterface_VK : public Rml::RenderInterface
@@ -89,6 +99,25 @@ class RenderInterface_VK : public Rml::RenderInterface
 	{
 		return m_frame_indices;
 	}
+	// Texture bytes uploaded this frame, valid after EndFrame
+	uint32_t GetFrameUploadBytes () const
+	{
+		return m_frame_upload_bytes;
+	}
+
+	// Device memory held by the geometry and texture pools
+	VkDeviceSize GetAllocatedBytes () const
+	{
+		return m_buffer_pool.GetAllocatedBytes () + m_image_pool.GetAllocatedBytes ();
+	}
+	PoolStats GetGeometryPoolStats () const
+	{
+		return m_buffer_pool.GetStats ();
+	}
+	PoolStats GetImagePoolStats () const
+	{
+		return m_image_pool.GetStats ();
+	}
 
 	// Garbage collection - call after GPU fence wait to safely destroy resources
 	void CollectGarbage ();
@@ -101,6 +130,23 @@ class RenderInterface_VK : public Rml::RenderInterface
 	// Set the active command buffer (from vkQuake's cb_context_t)
 	void SetCommandBuffer (VkCommandBuffer cmd);
 
+	// Textures generated while set hold a distance field in alpha and are drawn with the distance field pipeline
+	void SetDistanceFieldTextures (bool enable)
+	{
+		m_distance_field_textures = enable;
+	}
+
+	// Retained frames — the draws of a recorded frame can be replayed while the UI is unchanged.
+	// Releasing any geometry or texture invalidates the recording.
+	void BeginRecording ();
+	void EndRecording ();
+	void DiscardRecording ();
+	bool HasRecording () const
+	{
+		return m_recording_valid;
+	}
+	bool ReplayRecording ();
+
 	// -- Inherited from Rml::RenderInterface --
 
 	Rml::CompiledGeometryHandle CompileGeometry (Rml::Span<const Rml::Vertex> vertices, Rml::Span<const int> indices) override;
@@ -119,10 +165,21 @@ class RenderInterface_VK : public Rml::RenderInterface
   private:
 	// Internal geometry data — uses pool-based buffer allocations
 	struct GeometryData
+	{
+		BufferAllocation		 vertex_alloc;
+		BufferAllocation		 index_alloc;
+		int						 num_indices;
+		std::vector<Rml::Vertex> vertices; // CPU copy for batching, only kept for small geometry
+		std::vector<int>		 indices;
+	};
+
+	// Per-frame vertex/index ring that batched geometry is pre-translated into
+	struct BatchRing
 	{
 		BufferAllocation vertex_alloc;
 		BufferAllocation index_alloc;
-		int				 num_indices;
+		uint32_t		 num_vertices;
+		uint32_t		 num_indices;
 	};
 
 	// Internal texture data — uses pool-based image memory allocations
@@ -134,6 +191,26 @@ class RenderInterface_VK : public Rml::RenderInterface
 		ImageMemoryAllocation memory_alloc;
 		VkDescriptorSet		  descriptor_set;
 		Rml::Vector2i		  dimensions;
+		int					  atlas_page = -1; // textures packed into an atlas page have no image of their own
+		float				  uv_offset[2] = {0.0f, 0.0f};
+		float				  uv_scale[2] = {1.0f, 1.0f};
+		bool				  distance_field = false;
+	};
+
+	// Shared page small generated textures are packed into, shelf by shelf
+	struct AtlasShelf
+	{
+		uint32_t y;
+		uint32_t height;
+		uint32_t x;
+	};
+	struct AtlasPage
+	{
+		TextureData			   *texture;
+		std::vector<AtlasShelf> shelves;
+		uint32_t				next_y;
+		uint32_t				live_textures;
+		bool					initialized; // false until the first upload has moved it out of VK_IMAGE_LAYOUT_UNDEFINED
 	};
 
 	// Pending async texture upload — fence tracks GPU completion (legacy immediate path)
@@ -152,6 +229,21 @@ class RenderInterface_VK : public Rml::RenderInterface
 		VkBuffer	   staging_buffer;
 		VkDeviceMemory staging_memory;
 		Rml::Vector2i  dimensions;
+		VkOffset2D	   offset;
+		VkImageLayout  old_layout;
+		int			   atlas_page;
+	};
+
+	// RenderGeometry call with the scissor and transform state it was issued with
+	struct RecordedDraw
+	{
+		Rml::CompiledGeometryHandle geometry;
+		Rml::Vector2f				translation;
+		Rml::TextureHandle			texture;
+		bool						scissor_enabled;
+		VkRect2D					scissor_rect;
+		bool						transform_enabled;
+		Rml::Matrix4f				transform;
 	};
 
 	// Push constant data for vertex shader
@@ -173,6 +265,10 @@ class RenderInterface_VK : public Rml::RenderInterface
 	void FlushPendingUploads ();
 	void FreePrevBatchStaging ();
 
+	// Uploads through the engine staging ring, only when the staging hooks are set
+	uint32_t *BeginStagedUpload (VkImage image, VkImageLayout old_layout, VkOffset2D offset, Rml::Vector2i dimensions);
+	void	  EndStagedUpload ();
+
 	// Sync2-aware barrier helper (H1)
 	void ImageBarrier (
 		VkCommandBuffer cmd, VkImage image, VkImageLayout old_layout, VkImageLayout new_layout, VkAccessFlags src_access, VkAccessFlags dst_access,
@@ -183,6 +279,22 @@ class RenderInterface_VK : public Rml::RenderInterface
 
 	void DestroyBuffer (VkBuffer buffer, VkDeviceMemory memory);
 	void DestroyTexture (TextureData *texture);
+	bool CreateTextureResources (TextureData *texture, Rml::Vector2i dimensions);
+
+	// Texture atlas
+	TextureData *GenerateAtlasTexture (Rml::Span<const Rml::byte> source, Rml::Vector2i source_dimensions);
+	bool		 AllocateAtlasRegion (uint32_t width, uint32_t height, int &page_index, VkOffset2D &offset);
+	void		 DestroyAtlasPages ();
+
+	// Draw batching — consecutive geometry sharing texture, scissor and transform becomes one draw
+	VkRect2D GetScissor () const;
+	bool	 AppendToBatch (const GeometryData *geometry, Rml::Vector2f translation, const TextureData *texture, const VkRect2D &scissor);
+	void	 FlushBatch ();
+	void	 DrawAtlasGeometry (const GeometryData *geometry, Rml::Vector2f translation, const TextureData *texture, const VkRect2D &scissor);
+	void	 DrawIndexed (
+			VkPipeline pipeline, VkDescriptorSet descriptor_set, const VkRect2D &scissor, bool transform_enabled, const Rml::Matrix4f &transform,
+			Rml::Vector2f translation, VkBuffer vertex_buffer, VkDeviceSize vertex_offset, VkBuffer index_buffer, VkDeviceSize index_offset,
+			uint32_t num_indices);
 
 	// Configuration from vkQuake
 	VulkanConfig m_config;
@@ -197,17 +309,28 @@ class RenderInterface_VK : public Rml::RenderInterface
 	bool			m_transform_enabled;
 	uint32_t		m_frame_draw_calls;
 	uint32_t		m_frame_indices;
+	uint32_t		m_frame_upload_bytes;
+	VkDescriptorSet m_bound_descriptor_set;
 
 	// Vulkan resources
 	VkPipeline			  m_pipeline_textured;
+	VkPipeline			  m_pipeline_distance_field;
 	VkPipelineLayout	  m_pipeline_layout;
 	VkDescriptorPool	  m_descriptor_pool;
 	VkDescriptorSetLayout m_texture_set_layout;
 	VkSampler			  m_sampler;
+	bool				  m_distance_field_textures;
 
 	// Default white texture for untextured geometry
 	TextureData *m_white_texture;
 
+	// Generated textures up to ATLAS_MAX_TEXTURE_SIZE share ATLAS_PAGE_SIZE pages and their descriptor set.
+	// Every texture gets a one texel border replicating its edges so clamped, filtered lookups don't bleed.
+	// A page is only repacked once all of its textures have been released and collected.
+	static constexpr uint32_t ATLAS_PAGE_SIZE = 1024;
+	static constexpr uint32_t ATLAS_MAX_TEXTURE_SIZE = 256;
+	std::vector<AtlasPage>	  m_atlas_pages;
+
 	// Resource tracking
 	std::unordered_map<Rml::CompiledGeometryHandle, GeometryData *> m_geometries;
 	std::unordered_map<Rml::TextureHandle, TextureData *>			m_textures;
@@ -239,15 +362,38 @@ class RenderInterface_VK : public Rml::RenderInterface
 	int			m_timestamp_frame_index;
 
 	// Garbage collection for deferred resource destruction.
-	// Uses double-buffering: resources queued in slot N are destroyed when slot N
-	// is revisited (which happens after the GPU fence for that frame has been waited on).
-	// GARBAGE_SLOTS must be >= the engine's DOUBLE_BUFFERED frame count to ensure
-	// resources survive until the GPU is done with them.
-	static constexpr int GARBAGE_SLOTS = 2;
-	static_assert (GARBAGE_SLOTS >= 2, "Need at least 2 garbage slots for double-buffered frame pipelining");
+	// Resources queued in slot N are destroyed when slot N is revisited (which happens
+	// after the GPU fence for that frame has been waited on).
+	// GARBAGE_SLOTS must be >= the engine's MAX_FRAMES_IN_FLIGHT to ensure resources
+	// survive until the GPU is done with them, whatever vid_framesinflight is set to.
+	static constexpr int GARBAGE_SLOTS = 3;
+	static_assert (GARBAGE_SLOTS >= 3, "Need a garbage slot for every frame the engine can have in flight");
 	int							m_garbage_index;
 	std::vector<GeometryData *> m_geometry_garbage[GARBAGE_SLOTS];
 	std::vector<TextureData *>	m_texture_garbage[GARBAGE_SLOTS];
+
+	// Draw batching. The rings follow the garbage slots: a ring is only rewritten once the
+	// frame that last used it has passed its fence. Geometry too large or that doesn't fit
+	// the ring anymore is drawn from its own buffers.
+	static constexpr uint32_t BATCH_MAX_GEOMETRY_VERTICES = 1024;
+	static constexpr uint32_t BATCH_RING_VERTICES = 32768;
+	static constexpr uint32_t BATCH_RING_INDICES = 65536;
+	BatchRing				  m_batch_rings[GARBAGE_SLOTS];
+	VkPipeline				  m_batch_pipeline;
+	VkDescriptorSet			  m_batch_descriptor_set;
+	VkRect2D				  m_batch_scissor;
+	bool					  m_batch_transform_enabled;
+	Rml::Matrix4f			  m_batch_transform;
+	uint32_t				  m_batch_first_vertex;
+	uint32_t				  m_batch_first_index;
+	uint32_t				  m_batch_num_indices;
+
+	// Retained frame recording
+	std::vector<RecordedDraw> m_recorded_draws;
+	bool					  m_recording;
+	bool					  m_recording_valid;
+	int						  m_recorded_width;
+	int						  m_recorded_height;
 };
 
 } // namespace QRmlUI
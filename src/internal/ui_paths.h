@@ -25,6 +25,7 @@ inline constexpr const char *kHudChat = "ui/rml/hud/chat.rml";
 /* ── HUD overlays ─────────────────────────────────────────────────── */
 inline constexpr const char *kScoreboard = "ui/rml/hud/scoreboard.rml";
 inline constexpr const char *kIntermission = "ui/rml/hud/intermission.rml";
+inline constexpr const char *kLoading = "ui/rml/hud/loading.rml";
 
 /* ── Menu prefix (used by ActionNavigate for shorthand names) ─────── */
 inline constexpr const char *kMenuPrefix = "ui/rml/menus/";
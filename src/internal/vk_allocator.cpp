@@ -1,7 +1,7 @@
 /*
  * vkQuake RmlUI - Vulkan Suballocator Implementation
  *
- * FreeListAllocator: pure offset/size bookkeeping with first-fit and coalesce.
+ * TlsfAllocator: pure offset/size bookkeeping with O(1) two-level segregated fit.
  * BufferPool: suballocates HOST_VISIBLE geometry buffers from large chunks.
  * ImageMemoryPool: suballocates DEVICE_LOCAL memory for texture images.
  */
@@ -11,6 +11,9 @@
 #include <algorithm>
 #include <cassert>
 #include <cstring>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 #include "engine_bridge.h"
 
@@ -34,138 +37,291 @@ uint32_t FindVulkanMemoryType (const VkPhysicalDeviceMemoryProperties &mem_props
 }
 
 // ---------------------------------------------------------------------------
-// FreeListAllocator
+// TlsfAllocator
 // ---------------------------------------------------------------------------
 
-void FreeListAllocator::Reset (VkDeviceSize capacity)
+static int FindFirstBit (uint64_t mask)
 {
-	m_capacity = capacity;
-	m_free_blocks.clear ();
-	m_free_blocks.push_back ({0, capacity});
+	assert (mask != 0);
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward64 (&index, mask);
+	return static_cast<int> (index);
+#else
+	return __builtin_ctzll (mask);
+#endif
 }
 
-std::optional<AllocationResult> FreeListAllocator::Allocate (VkDeviceSize size, VkDeviceSize alignment)
+static int FindLastBit (uint64_t mask)
 {
-	if (size == 0 || alignment == 0)
-		return std::nullopt;
+	assert (mask != 0);
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanReverse64 (&index, mask);
+	return static_cast<int> (index);
+#else
+	return 63 - __builtin_clzll (mask);
+#endif
+}
 
-	for (size_t i = 0; i < m_free_blocks.size (); ++i)
+void TlsfAllocator::Mapping (VkDeviceSize size, int &fl, int &sl)
+{
+	if (size < SL_COUNT)
 	{
-		FreeBlock &block = m_free_blocks[i];
+		fl = 0;
+		sl = static_cast<int> (size);
+		return;
+	}
+	const int log2 = FindLastBit (size);
+	fl = log2 - SL_BITS + 1;
+	sl = static_cast<int> (size >> (log2 - SL_BITS)) - SL_COUNT;
+}
 
-		// Align the offset within this block
-		VkDeviceSize aligned_offset = (block.offset + alignment - 1) & ~(alignment - 1);
-		VkDeviceSize padding = aligned_offset - block.offset;
-		VkDeviceSize total_needed = padding + size;
+void TlsfAllocator::Reset (VkDeviceSize capacity)
+{
+	m_blocks.clear ();
+	m_unused_blocks.clear ();
+	for (auto &heads : m_free_heads)
+		for (uint32_t &head : heads)
+			head = NONE;
+	memset (m_sl_bitmaps, 0, sizeof (m_sl_bitmaps));
+	m_fl_bitmap = 0;
+	m_capacity = capacity;
+	m_used_bytes = 0;
+	m_num_allocations = 0;
+	m_num_free_blocks = 0;
+
+	const uint32_t block = NewBlock ();
+	m_blocks[block].offset = 0;
+	m_blocks[block].size = capacity;
+	InsertFreeBlock (block);
+}
 
-		if (total_needed > block.size)
-			continue;
+uint32_t TlsfAllocator::NewBlock ()
+{
+	if (!m_unused_blocks.empty ())
+	{
+		const uint32_t block = m_unused_blocks.back ();
+		m_unused_blocks.pop_back ();
+		m_blocks[block] = Block{};
+		return block;
+	}
+	m_blocks.emplace_back ();
+	return static_cast<uint32_t> (m_blocks.size () - 1);
+}
 
-		AllocationResult result;
-		result.offset = aligned_offset;
-		result.size = size;
+void TlsfAllocator::ReleaseBlock (uint32_t block)
+{
+	m_blocks[block] = Block{};
+	m_unused_blocks.push_back (block);
+}
 
-		// Carve out the allocation
-		if (padding == 0 && total_needed == block.size)
-		{
-			// Exact fit — remove entire block
-			m_free_blocks.erase (m_free_blocks.begin () + static_cast<ptrdiff_t> (i));
-		}
-		else if (padding == 0)
-		{
-			// Allocation at start of block — shrink from front
-			block.offset += size;
-			block.size -= size;
-		}
-		else if (padding + size == block.size)
-		{
-			// Allocation at end of block — shrink from back
-			block.size = padding;
-		}
-		else
-		{
-			// Split: keep front padding as free, insert remainder after allocation
-			VkDeviceSize remainder_offset = aligned_offset + size;
-			VkDeviceSize remainder_size = block.size - total_needed;
-			block.size = padding;
-			m_free_blocks.insert (m_free_blocks.begin () + static_cast<ptrdiff_t> (i) + 1, {remainder_offset, remainder_size});
-		}
+void TlsfAllocator::InsertFreeBlock (uint32_t block)
+{
+	Block &b = m_blocks[block];
+	int	   fl, sl;
+	Mapping (b.size, fl, sl);
+	assert (fl < FL_COUNT);
+
+	b.free = true;
+	b.prev_free = NONE;
+	b.next_free = m_free_heads[fl][sl];
+	if (b.next_free != NONE)
+		m_blocks[b.next_free].prev_free = block;
+	m_free_heads[fl][sl] = block;
+	m_sl_bitmaps[fl] |= 1u << sl;
+	m_fl_bitmap |= 1ull << fl;
+	++m_num_free_blocks;
+}
 
-#ifndef NDEBUG
-		ValidateFreeList ();
-#endif
-		return result;
+void TlsfAllocator::RemoveFreeBlock (uint32_t block)
+{
+	Block &b = m_blocks[block];
+	int	   fl, sl;
+	Mapping (b.size, fl, sl);
+
+	if (b.prev_free != NONE)
+		m_blocks[b.prev_free].next_free = b.next_free;
+	else
+		m_free_heads[fl][sl] = b.next_free;
+	if (b.next_free != NONE)
+		m_blocks[b.next_free].prev_free = b.prev_free;
+	if (m_free_heads[fl][sl] == NONE)
+	{
+		m_sl_bitmaps[fl] &= ~(1u << sl);
+		if (m_sl_bitmaps[fl] == 0)
+			m_fl_bitmap &= ~(1ull << fl);
 	}
+	b.free = false;
+	--m_num_free_blocks;
+}
 
-	return std::nullopt;
+// Returns the head of the first non empty size class whose smallest block is >= size
+uint32_t TlsfAllocator::FindFreeBlock (VkDeviceSize size) const
+{
+	// Round up to the next class boundary so every block of the class found fits
+	if (size >= SL_COUNT)
+		size += (VkDeviceSize (1) << (FindLastBit (size) - SL_BITS)) - 1;
+	int fl, sl;
+	Mapping (size, fl, sl);
+	if (fl >= FL_COUNT)
+		return NONE;
+
+	uint32_t sl_map = m_sl_bitmaps[fl] & (~0u << sl);
+	if (sl_map == 0)
+	{
+		const uint64_t fl_map = (fl + 1 < 64) ? (m_fl_bitmap & (~0ull << (fl + 1))) : 0;
+		if (fl_map == 0)
+			return NONE;
+		fl = FindFirstBit (fl_map);
+		sl_map = m_sl_bitmaps[fl];
+	}
+	return m_free_heads[fl][FindFirstBit (sl_map)];
 }
 
-void FreeListAllocator::Free (VkDeviceSize offset, VkDeviceSize size)
+std::optional<AllocationResult> TlsfAllocator::Allocate (VkDeviceSize size, VkDeviceSize alignment)
 {
-	if (size == 0)
-		return;
+	if (size == 0 || alignment == 0)
+		return std::nullopt;
 
-	// Find insertion point to maintain sorted order by offset
-	auto it =
-		std::lower_bound (m_free_blocks.begin (), m_free_blocks.end (), offset, [] (const FreeBlock &block, VkDeviceSize off) { return block.offset < off; });
+	// Any block that can hold the worst case padding fits. Otherwise the head of the class of the
+	// unpadded size may still fit, e.g. the aligned start of a fresh chunk.
+	uint32_t block = FindFreeBlock (size + alignment - 1);
+	if (block == NONE)
+	{
+		block = FindFreeBlock (size);
+		if (block == NONE)
+			return std::nullopt;
+		const Block &b = m_blocks[block];
+		if (((b.offset + alignment - 1) & ~(alignment - 1)) + size > b.offset + b.size)
+			return std::nullopt;
+	}
+	RemoveFreeBlock (block);
 
-	auto idx = it - m_free_blocks.begin ();
-	m_free_blocks.insert (it, {offset, size});
+	// Padding in front of the aligned offset stays free as its own block
+	const VkDeviceSize aligned_offset = (m_blocks[block].offset + alignment - 1) & ~(alignment - 1);
+	const VkDeviceSize padding = aligned_offset - m_blocks[block].offset;
+	if (padding > 0)
+	{
+		const uint32_t front = NewBlock ();
+		Block		  &b = m_blocks[block];
+		Block		  &f = m_blocks[front];
+		f.offset = b.offset;
+		f.size = padding;
+		f.prev_phys = b.prev_phys;
+		f.next_phys = block;
+		if (f.prev_phys != NONE)
+			m_blocks[f.prev_phys].next_phys = front;
+		b.prev_phys = front;
+		b.offset += padding;
+		b.size -= padding;
+		InsertFreeBlock (front);
+	}
 
-	// Coalesce with next block
-	if (idx + 1 < static_cast<ptrdiff_t> (m_free_blocks.size ()))
+	// Split off the remainder
+	if (m_blocks[block].size > size)
 	{
-		FreeBlock &current = m_free_blocks[static_cast<size_t> (idx)];
-		FreeBlock &next = m_free_blocks[static_cast<size_t> (idx) + 1];
-		if (current.offset + current.size == next.offset)
-		{
-			current.size += next.size;
-			m_free_blocks.erase (m_free_blocks.begin () + idx + 1);
-		}
+		const uint32_t back = NewBlock ();
+		Block		  &b = m_blocks[block];
+		Block		  &r = m_blocks[back];
+		r.offset = b.offset + size;
+		r.size = b.size - size;
+		r.prev_phys = block;
+		r.next_phys = b.next_phys;
+		if (r.next_phys != NONE)
+			m_blocks[r.next_phys].prev_phys = back;
+		b.next_phys = back;
+		b.size = size;
+		InsertFreeBlock (back);
+	}
+
+	m_used_bytes += size;
+	++m_num_allocations;
+
+#ifndef NDEBUG
+	Validate ();
+#endif
+	AllocationResult result;
+	result.offset = aligned_offset;
+	result.size = size;
+	result.block = block;
+	return result;
+}
+
+void TlsfAllocator::Free (uint32_t block)
+{
+	assert (block < m_blocks.size () && !m_blocks[block].free);
+	m_used_bytes -= m_blocks[block].size;
+	--m_num_allocations;
+
+	const uint32_t prev = m_blocks[block].prev_phys;
+	if (prev != NONE && m_blocks[prev].free)
+	{
+		RemoveFreeBlock (prev);
+		Block &p = m_blocks[prev];
+		p.size += m_blocks[block].size;
+		p.next_phys = m_blocks[block].next_phys;
+		if (p.next_phys != NONE)
+			m_blocks[p.next_phys].prev_phys = prev;
+		ReleaseBlock (block);
+		block = prev;
 	}
 
-	// Coalesce with previous block
-	if (idx > 0)
+	const uint32_t next = m_blocks[block].next_phys;
+	if (next != NONE && m_blocks[next].free)
 	{
-		FreeBlock &prev = m_free_blocks[static_cast<size_t> (idx) - 1];
-		FreeBlock &current = m_free_blocks[static_cast<size_t> (idx)];
-		if (prev.offset + prev.size == current.offset)
-		{
-			prev.size += current.size;
-			m_free_blocks.erase (m_free_blocks.begin () + idx);
-		}
+		RemoveFreeBlock (next);
+		Block &b = m_blocks[block];
+		b.size += m_blocks[next].size;
+		b.next_phys = m_blocks[next].next_phys;
+		if (b.next_phys != NONE)
+			m_blocks[b.next_phys].prev_phys = block;
+		ReleaseBlock (next);
 	}
 
+	InsertFreeBlock (block);
+
 #ifndef NDEBUG
-	ValidateFreeList ();
+	Validate ();
 #endif
 }
 
-VkDeviceSize FreeListAllocator::GetFreeSpace () const
+VkDeviceSize TlsfAllocator::GetLargestFreeBlock () const
 {
-	VkDeviceSize total = 0;
-	for (const auto &block : m_free_blocks)
-		total += block.size;
-	return total;
+	if (m_fl_bitmap == 0)
+		return 0;
+	const int	 fl = FindLastBit (m_fl_bitmap);
+	const int	 sl = FindLastBit (m_sl_bitmaps[fl]);
+	VkDeviceSize largest = 0;
+	for (uint32_t block = m_free_heads[fl][sl]; block != NONE; block = m_blocks[block].next_free)
+		largest = std::max (largest, m_blocks[block].size);
+	return largest;
 }
 
 #ifndef NDEBUG
-void FreeListAllocator::ValidateFreeList () const
+void TlsfAllocator::Validate () const
 {
-	for (size_t i = 0; i < m_free_blocks.size (); ++i)
+	// Walk the physical chain from offset 0, the blocks must tile the capacity without two free neighbours
+	uint32_t block = NONE;
+	for (uint32_t i = 0; i < m_blocks.size (); ++i)
+		if (m_blocks[i].size > 0 && m_blocks[i].offset == 0 && m_blocks[i].prev_phys == NONE)
+			block = i;
+	VkDeviceSize offset = 0;
+	uint32_t	 num_free = 0;
+	bool		 prev_free = false;
+	while (block != NONE)
 	{
-		const auto &block = m_free_blocks[i];
-		// Block must be within capacity
-		assert (block.offset + block.size <= m_capacity);
-		// Block must have nonzero size
-		assert (block.size > 0);
-		// Blocks must be sorted and non-overlapping
-		if (i > 0)
-		{
-			const auto &prev = m_free_blocks[i - 1];
-			assert (prev.offset + prev.size <= block.offset);
-		}
+		const Block &b = m_blocks[block];
+		assert (b.offset == offset);
+		assert (b.size > 0);
+		assert (!(prev_free && b.free));
+		offset += b.size;
+		num_free += b.free ? 1 : 0;
+		prev_free = b.free;
+		block = b.next_phys;
 	}
+	assert (offset == m_capacity);
+	assert (num_free == m_num_free_blocks);
 }
 #endif
 
@@ -232,6 +388,7 @@ bool BufferPool::CreateChunk ()
 
 	chunk.allocator.Reset (m_chunk_size);
 	m_chunks.push_back (chunk);
+	m_allocated_bytes += mem_reqs.size;
 
 	Con_DPrintf ("BufferPool: Created chunk %u (%llu bytes)\n", static_cast<unsigned> (m_chunks.size () - 1), static_cast<unsigned long long> (m_chunk_size));
 	return true;
@@ -250,6 +407,7 @@ bool BufferPool::Allocate (VkDeviceSize size, VkDeviceSize alignment, BufferAllo
 			out.size = result->size;
 			out.mapped_ptr = static_cast<char *> (m_chunks[i].mapped) + result->offset;
 			out.chunk_index = i;
+			out.block = result->block;
 			++m_active_allocations;
 			return true;
 		}
@@ -279,6 +437,7 @@ bool BufferPool::Allocate (VkDeviceSize size, VkDeviceSize alignment, BufferAllo
 	out.size = result->size;
 	out.mapped_ptr = static_cast<char *> (m_chunks[new_idx].mapped) + result->offset;
 	out.chunk_index = new_idx;
+	out.block = result->block;
 	++m_active_allocations;
 	return true;
 }
@@ -288,10 +447,25 @@ void BufferPool::Free (const BufferAllocation &alloc)
 	if (alloc.chunk_index >= static_cast<uint32_t> (m_chunks.size ()))
 		return;
 
-	m_chunks[alloc.chunk_index].allocator.Free (alloc.offset, alloc.size);
+	m_chunks[alloc.chunk_index].allocator.Free (alloc.block);
 	--m_active_allocations;
 }
 
+PoolStats BufferPool::GetStats () const
+{
+	PoolStats stats;
+	stats.num_chunks = static_cast<uint32_t> (m_chunks.size ());
+	for (const Chunk &chunk : m_chunks)
+	{
+		stats.num_allocations += chunk.allocator.GetAllocationCount ();
+		stats.num_free_blocks += chunk.allocator.GetFreeBlockCount ();
+		stats.capacity += chunk.allocator.GetCapacity ();
+		stats.used_bytes += chunk.allocator.GetCapacity () - chunk.allocator.GetFreeSpace ();
+		stats.largest_free_block = std::max (stats.largest_free_block, chunk.allocator.GetLargestFreeBlock ());
+	}
+	return stats;
+}
+
 void BufferPool::Shutdown ()
 {
 	if (m_active_allocations > 0)
@@ -316,6 +490,7 @@ void BufferPool::Shutdown ()
 	}
 	m_chunks.clear ();
 	m_active_allocations = 0;
+	m_allocated_bytes = 0;
 }
 
 // ---------------------------------------------------------------------------
@@ -351,6 +526,7 @@ bool ImageMemoryPool::CreatePage (uint32_t memory_type_index)
 
 	page.allocator.Reset (m_page_size);
 	m_pages.push_back (page);
+	m_allocated_bytes += m_page_size;
 
 	Con_DPrintf (
 		"ImageMemoryPool: Created page %u (%llu bytes, mem type %u)\n", static_cast<unsigned> (m_pages.size () - 1),
@@ -393,6 +569,9 @@ bool ImageMemoryPool::Allocate (const VkMemoryRequirements &mem_reqs, VkMemoryPr
 		out.page_index = UINT32_MAX;
 		out.dedicated = true;
 		++m_active_allocations;
+		++m_num_dedicated;
+		m_allocated_bytes += mem_reqs.size;
+		m_dedicated_bytes += mem_reqs.size;
 
 		Con_DPrintf ("ImageMemoryPool: Dedicated allocation (%llu bytes)\n", static_cast<unsigned long long> (mem_reqs.size));
 		return true;
@@ -411,6 +590,7 @@ bool ImageMemoryPool::Allocate (const VkMemoryRequirements &mem_reqs, VkMemoryPr
 			out.offset = result->offset;
 			out.size = result->size;
 			out.page_index = i;
+			out.block = result->block;
 			out.dedicated = false;
 			++m_active_allocations;
 			return true;
@@ -440,6 +620,7 @@ bool ImageMemoryPool::Allocate (const VkMemoryRequirements &mem_reqs, VkMemoryPr
 	out.offset = result->offset;
 	out.size = result->size;
 	out.page_index = new_idx;
+	out.block = result->block;
 	out.dedicated = false;
 	++m_active_allocations;
 	return true;
@@ -454,16 +635,37 @@ void ImageMemoryPool::Free (const ImageMemoryAllocation &alloc)
 			vkFreeMemory (m_device, alloc.memory, nullptr);
 		}
 		--m_active_allocations;
+		--m_num_dedicated;
+		m_allocated_bytes -= alloc.size;
+		m_dedicated_bytes -= alloc.size;
 		return;
 	}
 
 	if (alloc.page_index >= static_cast<uint32_t> (m_pages.size ()))
 		return;
 
-	m_pages[alloc.page_index].allocator.Free (alloc.offset, alloc.size);
+	m_pages[alloc.page_index].allocator.Free (alloc.block);
 	--m_active_allocations;
 }
 
+PoolStats ImageMemoryPool::GetStats () const
+{
+	PoolStats stats;
+	stats.num_chunks = static_cast<uint32_t> (m_pages.size ()) + m_num_dedicated;
+	stats.num_allocations = m_num_dedicated;
+	stats.capacity = m_dedicated_bytes;
+	stats.used_bytes = m_dedicated_bytes;
+	for (const Page &page : m_pages)
+	{
+		stats.num_allocations += page.allocator.GetAllocationCount ();
+		stats.num_free_blocks += page.allocator.GetFreeBlockCount ();
+		stats.capacity += page.allocator.GetCapacity ();
+		stats.used_bytes += page.allocator.GetCapacity () - page.allocator.GetFreeSpace ();
+		stats.largest_free_block = std::max (stats.largest_free_block, page.allocator.GetLargestFreeBlock ());
+	}
+	return stats;
+}
+
 void ImageMemoryPool::Shutdown ()
 {
 	if (m_active_allocations > 0)
@@ -480,6 +682,9 @@ void ImageMemoryPool::Shutdown ()
 	}
 	m_pages.clear ();
 	m_active_allocations = 0;
+	m_num_dedicated = 0;
+	m_allocated_bytes = 0;
+	m_dedicated_bytes = 0;
 }
 
 } // namespace QRmlUI
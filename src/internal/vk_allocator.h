@@ -20,47 +20,99 @@ namespace QRmlUI
 uint32_t FindVulkanMemoryType (const VkPhysicalDeviceMemoryProperties &mem_props, uint32_t type_filter, VkMemoryPropertyFlags properties);
 
 // ---------------------------------------------------------------------------
-// FreeListAllocator - pure data structure, no Vulkan types
+// TlsfAllocator - two-level segregated fit, pure data structure, no Vulkan types
 // ---------------------------------------------------------------------------
 
-struct FreeBlock
+struct AllocationResult
 {
 	VkDeviceSize offset;
-	VkDeviceSize size;
+	VkDeviceSize size;	// requested size, alignment padding stays free
+	uint32_t	 block; // pass to Free
 };
 
-struct AllocationResult
+// Occupancy of a pool, summed over its chunks or pages
+struct PoolStats
 {
-	VkDeviceSize offset;
-	VkDeviceSize size; // actual size including alignment padding
+	uint32_t	 num_chunks = 0;
+	uint32_t	 num_allocations = 0;
+	uint32_t	 num_free_blocks = 0;
+	VkDeviceSize capacity = 0;
+	VkDeviceSize used_bytes = 0;
+	VkDeviceSize largest_free_block = 0;
 };
 
-class FreeListAllocator
+class TlsfAllocator
 {
   public:
-	FreeListAllocator () = default;
+	TlsfAllocator () = default;
 
 	void Reset (VkDeviceSize capacity);
 
-	// First-fit allocation with alignment. Returns nullopt on failure.
+	// Good fit in O(1): takes the first free block of the smallest size class that is guaranteed
+	// to fit. Returns nullopt on failure.
 	std::optional<AllocationResult> Allocate (VkDeviceSize size, VkDeviceSize alignment);
 
-	// Return a region to the free list, coalescing adjacent blocks.
-	void Free (VkDeviceSize offset, VkDeviceSize size);
+	// Returns the block to its size class in O(1), merging it with free physical neighbours.
+	void Free (uint32_t block);
 
 	VkDeviceSize GetCapacity () const
 	{
 		return m_capacity;
 	}
-	VkDeviceSize GetFreeSpace () const;
+	VkDeviceSize GetFreeSpace () const
+	{
+		return m_capacity - m_used_bytes;
+	}
+	uint32_t GetAllocationCount () const
+	{
+		return m_num_allocations;
+	}
+	uint32_t GetFreeBlockCount () const
+	{
+		return m_num_free_blocks;
+	}
+	// Scans the highest non empty size class, meant for stats only
+	VkDeviceSize GetLargestFreeBlock () const;
 
 #ifndef NDEBUG
-	void ValidateFreeList () const;
+	void Validate () const;
 #endif
 
   private:
-	std::vector<FreeBlock> m_free_blocks;
-	VkDeviceSize		   m_capacity = 0;
+	// Sizes below 2^SL_BITS map linearly to the first level 0, every power of two above is
+	// split into 2^SL_BITS second level classes, which bounds the internal waste to 1/32.
+	static constexpr int	  SL_BITS = 5;
+	static constexpr int	  SL_COUNT = 1 << SL_BITS;
+	static constexpr int	  FL_COUNT = 48 - SL_BITS + 1;
+	static constexpr uint32_t NONE = UINT32_MAX;
+
+	struct Block
+	{
+		VkDeviceSize offset = 0;
+		VkDeviceSize size = 0;
+		uint32_t	 prev_phys = NONE;
+		uint32_t	 next_phys = NONE;
+		uint32_t	 prev_free = NONE;
+		uint32_t	 next_free = NONE;
+		bool		 free = false;
+	};
+
+	static void Mapping (VkDeviceSize size, int &fl, int &sl);
+	uint32_t	FindFreeBlock (VkDeviceSize size) const;
+	uint32_t	NewBlock ();
+	void		ReleaseBlock (uint32_t block);
+	void		InsertFreeBlock (uint32_t block);
+	void		RemoveFreeBlock (uint32_t block);
+
+	std::vector<Block>	  m_blocks;
+	std::vector<uint32_t> m_unused_blocks; // recycled entries of m_blocks
+	uint32_t			  m_free_heads[FL_COUNT][SL_COUNT];
+	uint32_t			  m_sl_bitmaps[FL_COUNT] = {};
+	uint64_t			  m_fl_bitmap = 0;
+	VkDeviceSize		  m_capacity = 0;
+	VkDeviceSize		  m_used_bytes = 0;
+	uint32_t			  m_num_allocations = 0;
+	uint32_t			  m_num_free_blocks = 0;
 };
 
 // ---------------------------------------------------------------------------
@@ -74,6 +126,7 @@ struct BufferAllocation
 	VkDeviceSize size = 0;
 	void		*mapped_ptr = nullptr;
 	uint32_t	 chunk_index = UINT32_MAX;
+	uint32_t	 block = UINT32_MAX;
 };
 
 class BufferPool
@@ -97,14 +150,20 @@ class BufferPool
 	{
 		return m_active_allocations;
 	}
+	// Bytes of VkDeviceMemory owned by the pool
+	VkDeviceSize GetAllocatedBytes () const
+	{
+		return m_allocated_bytes;
+	}
+	PoolStats GetStats () const;
 
   private:
 	struct Chunk
 	{
 		VkBuffer		  buffer = VK_NULL_HANDLE;
-		VkDeviceMemory	  memory = VK_NULL_HANDLE;
-		void			 *mapped = nullptr;
-		FreeListAllocator allocator;
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		void		  *mapped = nullptr;
+		TlsfAllocator  allocator;
 	};
 
 	bool CreateChunk ();
@@ -114,6 +173,7 @@ class BufferPool
 	VkDeviceSize					 m_chunk_size = DEFAULT_CHUNK_SIZE;
 	std::vector<Chunk>				 m_chunks;
 	uint32_t						 m_active_allocations = 0;
+	VkDeviceSize					 m_allocated_bytes = 0;
 };
 
 // ---------------------------------------------------------------------------
@@ -126,6 +186,7 @@ struct ImageMemoryAllocation
 	VkDeviceSize   offset = 0;
 	VkDeviceSize   size = 0;
 	uint32_t	   page_index = UINT32_MAX;
+	uint32_t	   block = UINT32_MAX;
 	bool		   dedicated = false; // oversized images get their own allocation
 };
 
@@ -151,13 +212,20 @@ class ImageMemoryPool
 	{
 		return m_active_allocations;
 	}
+	// Bytes of VkDeviceMemory owned by the pool
+	VkDeviceSize GetAllocatedBytes () const
+	{
+		return m_allocated_bytes;
+	}
+	// Dedicated allocations count as chunks that are fully used
+	PoolStats GetStats () const;
 
   private:
 	struct Page
 	{
-		VkDeviceMemory	  memory = VK_NULL_HANDLE;
-		uint32_t		  memory_type_index = UINT32_MAX;
-		FreeListAllocator allocator;
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		uint32_t	   memory_type_index = UINT32_MAX;
+		TlsfAllocator  allocator;
 	};
 
 	bool CreatePage (uint32_t memory_type_index);
@@ -168,6 +236,9 @@ class ImageMemoryPool
 	VkDeviceSize					 m_buffer_image_granularity = 1;
 	std::vector<Page>				 m_pages;
 	uint32_t						 m_active_allocations = 0;
+	uint32_t						 m_num_dedicated = 0;
+	VkDeviceSize					 m_allocated_bytes = 0;
+	VkDeviceSize					 m_dedicated_bytes = 0;
 };
 
 } // namespace QRmlUI
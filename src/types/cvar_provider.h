@@ -34,6 +34,27 @@ class ICvarProvider
 
 	// Check if a cvar exists
 	virtual bool Exists (const std::string &name) const = 0;
+
+	// Called after a subscribed cvar changed value
+	using ChangeCallback = void (*) (void *userdata);
+
+	// Subscribe to changes of a cvar. Returns false if the provider cannot notify
+	// (or the cvar does not exist), the caller has to re-read the value then.
+	virtual bool Subscribe (const std::string &name, ChangeCallback callback, void *userdata)
+	{
+		(void)name;
+		(void)callback;
+		(void)userdata;
+		return false;
+	}
+
+	// Remove a subscription made by Subscribe()
+	virtual void Unsubscribe (const std::string &name, ChangeCallback callback, void *userdata)
+	{
+		(void)name;
+		(void)callback;
+		(void)userdata;
+	}
 };
 
 } // namespace QRmlUI
@@ -36,6 +36,9 @@ struct CvarBinding
 	int						 num_values = 0; // For enum type
 	std::vector<int>		 enum_values;	 // Optional explicit values for enum
 	std::vector<std::string> enum_labels;	 // Optional display labels for enum
+
+	// Provider notifies changes, SyncToUI() does not re-read it
+	bool subscribed = false;
 };
 
 } // namespace QRmlUI
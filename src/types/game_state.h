@@ -59,10 +59,13 @@ struct PlayerInfo
 	int			bottom_color = 0;
 	int			ping = 0;
 	bool		is_local = false;
+	int			slot = 0; // client slot, the row identity
+	int			rank = 0; // position in frag order
 
 	bool operator== (const PlayerInfo &o) const
 	{
-		return name == o.name && frags == o.frags && top_color == o.top_color && bottom_color == o.bottom_color && ping == o.ping && is_local == o.is_local;
+		return name == o.name && frags == o.frags && top_color == o.top_color && bottom_color == o.bottom_color && ping == o.ping && is_local == o.is_local &&
+			   slot == o.slot && rank == o.rank;
 	}
 	bool operator!= (const PlayerInfo &o) const
 	{
@@ -133,6 +136,10 @@ struct GameState
 	int time_minutes = 0;
 	int time_seconds = 0;
 
+	// Map loading screen (UI_ShowLoading)
+	int			loading_percent = -1; // -1 while the phase doesn't report progress
+	std::string loading_phase;
+
 	// Face animation state (0-4 health tier, plus special states)
 	int	 face_index = 0;
 	bool face_pain = false;
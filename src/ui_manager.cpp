@@ -7,6 +7,8 @@
 
 #include "ui_manager.h"
 #include "internal/render_interface_vk.h"
+#include "internal/font_engine_sdf.h"
+#include "internal/file_watcher.h"
 #include "internal/system_interface.h"
 #include "internal/game_data_model.h"
 #include "internal/cvar_binding.h"
@@ -57,6 +59,40 @@ constexpr float	 MAX_MENU_HEIGHT_DP = 850.0f;
 constexpr float	 VIEWPORT_FIT_FRACTION = 0.88f;
 constexpr int	 MENU_ENTER_DELAY_FRAMES = 3;
 constexpr double MENU_ENTER_RESIZE_SETTLE_SECONDS = 0.12;
+// Editors write a file in several steps, ui_autoreload waits until it stopped changing for this long
+constexpr double AUTORELOAD_SETTLE_SECONDS = 0.1;
+// ui_retain only replays the previous frame once nothing has changed for this long,
+// so transitions started by the last change (cascades, hover fades) run to completion.
+constexpr double RETAIN_SETTLE_SECONDS = 1.5;
+// UI_PreloadDocument keeps running steps while a frame has spent less than this on them.
+// A single step (one document parse or first layout) can still take longer.
+constexpr double PRELOAD_FRAME_BUDGET_SECONDS = 0.002;
+// ui_speeds_spike dumps at most one frame per interval, so a run of slow frames doesn't flood the console
+constexpr double SPIKE_DUMP_INTERVAL_SECONDS = 1.0;
+
+// Document read ahead by UI_PreloadDocument, then loaded and laid out a step per frame
+enum preload_step_t
+{
+	PRELOAD_READ,
+	PRELOAD_LOAD,
+	PRELOAD_LAYOUT,
+};
+
+struct PreloadRequest
+{
+	std::string										 path;
+	std::vector<std::pair<std::string, std::string>> files; // written by the read task until it's joined
+	task_handle_t									 task = INVALID_TASK_HANDLE;
+	preload_step_t									 step = PRELOAD_READ;
+};
+
+// Update and layout time of one document, accumulated between UI_GetDocumentPerfStats calls
+struct DocumentPerf
+{
+	double sum_ms = 0.0;
+	double worst_ms = 0.0;
+	int	   frames = 0;
+};
 
 // Consolidated mutable state for the UI manager.
 // Constants (MENU_DEBOUNCE_SECONDS, REFERENCE_*, DP_RATIO_*, kHudDoc*) stay standalone.
@@ -66,6 +102,7 @@ struct UIManagerState
 	std::unique_ptr<QRmlUI::QuakeFileInterface> file_interface;
 	std::unique_ptr<QRmlUI::RenderInterface_VK> render_interface;
 	std::unique_ptr<QRmlUI::SystemInterface>	system_interface;
+	std::unique_ptr<QRmlUI::FontEngine_SDF>		font_engine;
 	Rml::Context							   *context = nullptr;
 	bool										initialized = false;
 	bool										visible = false;
@@ -86,6 +123,7 @@ struct UIManagerState
 	bool		chat_visible = false;
 	bool		scoreboard_visible = false;
 	bool		intermission_visible = false;
+	bool		loading_visible = false;
 	int			last_intermission = 0;
 
 	// Deferred ops
@@ -109,6 +147,30 @@ struct UIManagerState
 
 	// Frame performance stats (CPU-side)
 	ui_perf_stats_t perf_last{};
+
+	// Per-document breakdown, only measured while ui_speeds >= 4 or ui_speeds_spike is set
+	std::vector<std::pair<const std::string *, double>> frame_document_ms; // keys of documents, this frame only
+	std::unordered_map<std::string, DocumentPerf>		 document_perf;
+	double												 last_spike_dump = -1.0;
+
+	// Retained frames (ui_retain)
+	double								last_change_time = 0.0;
+	bool								retain_frame = false;
+	std::vector<Rml::ElementDocument *> retain_visible_documents;
+
+	// Documents being preloaded, processed front to back
+	std::vector<std::unique_ptr<PreloadRequest>> preloads;
+
+	// Files linked by loaded documents and their modification time when RmlUI parsed them
+	std::unordered_map<std::string, std::filesystem::file_time_type> linked_file_times;
+	std::unordered_map<std::string, std::vector<std::string>>		 document_links;
+	std::string														 linked_files_gamedir;
+
+	// Loose UI files changed on disk (ui_autoreload), applied once they settled
+	QRmlUI::FileWatcher	  file_watcher;
+	std::string			  watched_gamedir; // empty while not watching
+	std::set<std::string> watched_changes;
+	double				  watched_change_time = 0.0;
 };
 
 UIManagerState g_state;
@@ -128,6 +190,180 @@ bool IsViewportSettledForMenuEnter ()
 	return (realtime - g_state.last_resize_time) >= MENU_ENTER_RESIZE_SETTLE_SECONDS;
 }
 
+// Anything that can change what the UI draws, outside of the data models and the
+// visible document set which are checked every frame, restarts the ui_retain settle window.
+void MarkUIChanged ()
+{
+	g_state.last_change_time = realtime;
+}
+
+// A frame can be retained when ui_retain is on, every visible document opted in with a
+// "retain" attribute on its body, and nothing changed for RETAIN_SETTLE_SECONDS.
+bool CanRetainFrame ()
+{
+	std::vector<Rml::ElementDocument *> &visible = g_state.retain_visible_documents;
+	bool								 all_retained = true;
+	size_t								 num_visible = 0;
+	bool								 changed = false;
+
+	for (int i = 0; i < g_state.context->GetNumDocuments (); i++)
+	{
+		Rml::ElementDocument *doc = g_state.context->GetDocument (i);
+		if (!doc->IsVisible ())
+			continue;
+		if (!doc->HasAttribute ("retain"))
+			all_retained = false;
+		if (num_visible >= visible.size () || visible[num_visible] != doc)
+		{
+			visible.resize (num_visible);
+			visible.push_back (doc);
+			changed = true;
+		}
+		num_visible++;
+	}
+	if (num_visible != visible.size ())
+	{
+		visible.resize (num_visible);
+		changed = true;
+	}
+	if (changed)
+		MarkUIChanged ();
+
+	if (Cvar_VariableValue ("ui_retain") == 0.0 || !all_retained || !g_state.render_interface || !g_state.render_interface->HasRecording ())
+		return false;
+	if (g_state.pending_menu_enter || g_state.weapon_flicker_frames > 0 || g_state.ammo_detail_frames > 0 || UI_IsCapturingKey ())
+		return false;
+	return (realtime - g_state.last_change_time) >= RETAIN_SETTLE_SECONDS;
+}
+
+// Resolves a path referenced by a document the way RmlUI's default JoinPath does:
+// relative to the document's directory, or to the root when it starts with '/'.
+std::string ResolveDocumentPath (const std::string &document_path, const std::string &path)
+{
+	std::string joined;
+	if (!path.empty () && path[0] == '/')
+		joined = path.substr (1);
+	else
+	{
+		size_t file_start = document_path.rfind ('/');
+		joined = (file_start != std::string::npos ? document_path.substr (0, file_start + 1) : std::string ()) + path;
+	}
+
+	std::vector<std::string> parts;
+	size_t					 start = 0;
+	while (start <= joined.size ())
+	{
+		size_t		end = joined.find ('/', start);
+		std::string part = joined.substr (start, end == std::string::npos ? std::string::npos : end - start);
+		if (part == ".." && !parts.empty () && parts.back () != "..")
+			parts.pop_back ();
+		else if (!part.empty () && part != ".")
+			parts.push_back (part);
+		if (end == std::string::npos)
+			break;
+		start = end + 1;
+	}
+
+	std::string resolved;
+	for (const std::string &part : parts)
+		resolved += (resolved.empty () ? "" : "/") + part;
+	return resolved;
+}
+
+// Stylesheets and templates referenced by the <link> tags of a document, and Lua files by its <script> tags
+std::vector<std::string> FindLinkedFiles (const std::string &document_path, const std::string &rml)
+{
+	std::vector<std::string> links;
+	for (const auto &tag : {std::make_pair ("<link", "href=\""), std::make_pair ("<script", "src=\"")})
+	{
+		for (size_t link = rml.find (tag.first); link != std::string::npos; link = rml.find (tag.first, link + 1))
+		{
+			size_t tag_end = rml.find ('>', link);
+			size_t href = rml.find (tag.second, link);
+			if (href == std::string::npos || href > tag_end)
+				continue;
+			href += strlen (tag.second);
+			size_t href_end = rml.find ('"', href);
+			if (href_end == std::string::npos)
+				break;
+			links.push_back (ResolveDocumentPath (document_path, rml.substr (href, href_end - href)));
+		}
+	}
+	return links;
+}
+
+// Task worker: reads the document and the files its <link> and <script> tags reference
+void PreloadReadTask (void *data)
+{
+	PreloadRequest *request = *static_cast<PreloadRequest **> (data);
+	std::string		rml;
+	if (!QRmlUI::QuakeFileInterface::ReadFile (request->path, rml))
+		return;
+
+	for (std::string &path : FindLinkedFiles (request->path, rml))
+	{
+		std::string contents;
+		if (QRmlUI::QuakeFileInterface::ReadFile (path, contents))
+			request->files.emplace_back (std::move (path), std::move (contents));
+	}
+	request->files.emplace_back (request->path, std::move (rml));
+}
+
+#ifdef QRMLUI_HOT_RELOAD
+// Modification time of the loose file a UI path resolves to, min () when there is
+// none (pak contents, which can't change while running)
+std::filesystem::file_time_type LinkedFileTime (const std::string &path)
+{
+	namespace fs = std::filesystem;
+	for (const char *root : {com_gamedir, com_basedir})
+	{
+		if (!root[0])
+			continue;
+		std::error_code			 ec;
+		const fs::file_time_type time = fs::last_write_time (fs::path (root) / path, ec);
+		if (!ec)
+			return time;
+	}
+	return fs::file_time_type::min ();
+}
+
+// Records the files a loaded document links. RmlUI parses each stylesheet and template once
+// and shares it between documents by path, so the time kept is the one of the first load.
+void TrackDocumentLinks (const std::string &document_path)
+{
+	std::string rml;
+	if (!QRmlUI::QuakeFileInterface::ReadFile (document_path, rml))
+		return;
+	std::vector<std::string> &links = g_state.document_links[document_path];
+	links = FindLinkedFiles (document_path, rml);
+	for (const std::string &link : links)
+	{
+		if (!g_state.linked_file_times.count (link))
+			g_state.linked_file_times[link] = LinkedFileTime (link);
+	}
+}
+
+// Whether RmlUI's stylesheet and template caches are still what's on disk for the current game dir
+bool LinkedFilesUnchanged ()
+{
+	if (g_state.linked_files_gamedir != com_gamedir)
+		return false;
+	for (const auto &pair : g_state.linked_file_times)
+	{
+		if (LinkedFileTime (pair.first) != pair.second)
+			return false;
+	}
+	return true;
+}
+
+void ResetLinkedFiles ()
+{
+	g_state.linked_file_times.clear ();
+	g_state.document_links.clear ();
+	g_state.linked_files_gamedir = com_gamedir;
+}
+#endif
+
 // Update cached DPI scale from the display, with sqrt dampening and defensive clamping.
 // Raw DPI ratio (e.g. 163/96 = 1.7x) is too aggressive as a straight multiplier —
 // sqrt gives a gentle nudge: 1.7 → 1.30, 1.5 → 1.22, 1.0 → 1.0.
@@ -192,6 +428,8 @@ void UpdateDpRatio ()
 	if (dp_ratio > DP_RATIO_MAX)
 		dp_ratio = DP_RATIO_MAX;
 
+	if (dp_ratio != g_state.context->GetDensityIndependentPixelRatio ())
+		MarkUIChanged ();
 	g_state.context->SetDensityIndependentPixelRatio (dp_ratio);
 }
 
@@ -208,6 +446,7 @@ void UpdateFontScale ()
 	if (font_scale == s_last_font_scale)
 		return;
 	s_last_font_scale = font_scale;
+	MarkUIChanged ();
 
 	float body_dp = BASE_BODY_FONT_DP * font_scale;
 	char  prop[32];
@@ -239,6 +478,68 @@ bool HasVisibleMenuDocument ()
 	return false;
 }
 
+bool DocumentProfilingEnabled ()
+{
+	return Cvar_VariableValue ("ui_speeds") >= 4.0f || Cvar_VariableValue ("ui_speeds_spike") > 0.0f;
+}
+
+// Brings each visible document's style and layout up to date on its own so the time can be
+// charged to it. Data binding changes are only applied in Context::Update, so their cost
+// stays in the context phase.
+void UpdateDocumentsTimed ()
+{
+	g_state.frame_document_ms.clear ();
+	for (const auto &pair : g_state.documents)
+	{
+		if (!pair.second || !pair.second->IsVisible ())
+			continue;
+		const double start = Sys_DoubleTime ();
+		pair.second->UpdateDocument ();
+		const double ms = (Sys_DoubleTime () - start) * 1000.0;
+		g_state.frame_document_ms.emplace_back (&pair.first, ms);
+		g_state.perf_last.update_documents_ms += ms;
+
+		DocumentPerf &perf = g_state.document_perf[pair.first];
+		perf.sum_ms += ms;
+		perf.worst_ms = std::max (perf.worst_ms, ms);
+		perf.frames++;
+	}
+}
+
+// ui_speeds_spike: prints what the slow frame spent its time on and what it invalidated
+void DumpPerfSpike ()
+{
+	const ui_perf_stats_t &perf = g_state.perf_last;
+	Con_Printf (
+		"ui spike %.2f ms: update %.2f (dp %.2f model %.2f lua %.2f hud %.2f notify %.2f context %.2f post %.2f) render %.2f, dc %d tri %d upload %d KB\n",
+		perf.total_ms, perf.update_ms, perf.update_dp_ms, perf.update_model_ms, perf.update_lua_ms, perf.update_hud_logic_ms, perf.update_notify_ms,
+		perf.update_context_ms, perf.update_post_ms, perf.render_ms, perf.draw_calls, perf.triangles, perf.upload_bytes / 1024);
+	Con_Printf (
+		"ui spike   menus %d intermission %d scoreboard %d chat %d\n", static_cast<int> (g_state.menu_stack.size ()), g_state.intermission_visible,
+		g_state.scoreboard_visible, key_dest == key_message);
+	for (const auto &entry : g_state.frame_document_ms)
+		Con_Printf ("ui spike   document %s: %.2f ms\n", entry.first->c_str (), entry.second);
+
+	const std::vector<const char *> &dirtied = QRmlUI::GameDataModel::GetLastDirtied ();
+	if (!dirtied.empty ())
+	{
+		std::string names;
+		for (const char *name : dirtied)
+		{
+			names += ' ';
+			names += name;
+		}
+		Con_Printf ("ui spike   game model dirtied:%s\n", names.c_str ());
+	}
+	if (perf.notify_changed)
+		Con_Printf ("ui spike   notification model changed\n");
+
+	Rml::Element *hover = g_state.context ? g_state.context->GetHoverElement () : nullptr;
+	Rml::Element *focus = g_state.context ? g_state.context->GetFocusElement () : nullptr;
+	Con_Printf ("ui spike   hover %s\n", hover ? hover->GetAddress (false, false).c_str () : "none");
+	Con_Printf ("ui spike   focus %s\n", focus ? focus->GetAddress (false, false).c_str () : "none");
+}
+
 } // anonymous namespace
 
 // C API Implementation
@@ -281,6 +582,12 @@ extern "C"
 			return 0;
 		}
 
+		// Text is drawn from distance field atlases, the default font engine created by Rml::Initialise
+		// stays behind it for text with font effects. Fonts are only loaded later, in UI_LoadAssets.
+		g_state.font_engine = std::make_unique<QRmlUI::FontEngine_SDF> (g_state.render_interface.get (), Rml::GetFontEngineInterface ());
+		if (g_state.font_engine->IsInitialized ())
+			Rml::SetFontEngineInterface (g_state.font_engine.get ());
+
 		// Register reticle custom elements (after Rml::Initialise so StyleSheetSpecification is ready)
 		QRmlUI::ReticlePlugin::Initialise ();
 
@@ -415,11 +722,237 @@ extern "C"
 		g_state.assets_loaded = true;
 	}
 
+	// Waits for outstanding read tasks and drops all preloads
+	static void UI_CancelPreloads (void)
+	{
+		for (const auto &request : g_state.preloads)
+		{
+			if (request->step == PRELOAD_READ)
+				Task_Join (request->task, TASK_TIMEOUT_INFINITE);
+		}
+		g_state.preloads.clear ();
+		if (g_state.file_interface)
+			g_state.file_interface->ClearPreloadedFiles ();
+	}
+
+	// Runs preload steps until PRELOAD_FRAME_BUDGET_SECONDS is used up, at least one per frame
+	static void UI_ProcessPreloads (void)
+	{
+		const double start = Sys_DoubleTime ();
+		while (!g_state.preloads.empty () && (Sys_DoubleTime () - start) < PRELOAD_FRAME_BUDGET_SECONDS)
+		{
+			PreloadRequest &request = *g_state.preloads.front ();
+			auto			doc_it = g_state.documents.find (request.path);
+			const bool		loaded = doc_it != g_state.documents.end () && doc_it->second;
+
+			if (request.step == PRELOAD_READ)
+			{
+				if (!Task_Join (request.task, 0))
+					return;
+				for (auto &file : request.files)
+					g_state.file_interface->AddPreloadedFile (file.first, std::move (file.second));
+				request.files.clear ();
+				request.step = PRELOAD_LOAD;
+			}
+			else if (request.step == PRELOAD_LOAD)
+			{
+				// Something already needed the document and loaded it synchronously
+				if (loaded || !UI_LoadDocument (request.path.c_str ()))
+					g_state.preloads.erase (g_state.preloads.begin ());
+				else
+					request.step = PRELOAD_LAYOUT;
+				g_state.file_interface->ClearPreloadedFiles ();
+			}
+			else
+			{
+				// First style and layout pass while still hidden
+				if (loaded && !doc_it->second->IsVisible ())
+					doc_it->second->UpdateDocument ();
+				g_state.preloads.erase (g_state.preloads.begin ());
+			}
+		}
+	}
+
+#ifdef QRMLUI_HOT_RELOAD
+	// Replaces a loaded document by a freshly parsed one, keeping its visibility
+	static void UI_ReloadDocument (std::pair<const std::string, Rml::ElementDocument *> &entry)
+	{
+		if (!entry.second)
+			return;
+
+		const bool was_visible = entry.second->IsVisible ();
+		if (g_state.pending_menu_enter == entry.second)
+			g_state.pending_menu_enter = nullptr;
+		entry.second->Close ();
+		entry.second = g_state.context->LoadDocument (entry.first);
+
+		if (entry.second)
+		{
+			QRmlUI::MenuEventHandler::RegisterWithDocument (entry.second);
+			TrackDocumentLinks (entry.first);
+			if (was_visible)
+				entry.second->Show ();
+		}
+	}
+
+	// Applies the files reported by the watcher to the documents using them. A changed document is
+	// reloaded alone, a changed stylesheet reparses the styles of the documents linking it, and a
+	// changed template or Lua script reloads the documents linking it.
+	static void UI_ApplyFileChanges (const std::set<std::string> &changed)
+	{
+		auto is_style_sheet = [] (const std::string &path)
+		{
+			return std::filesystem::path (path).extension () == ".rcss";
+		};
+
+		// Later loads must not get a cached parse of a changed file
+		bool styles_changed = false;
+		bool templates_changed = false;
+		for (const std::string &path : changed)
+		{
+			auto time = g_state.linked_file_times.find (path);
+			if (time == g_state.linked_file_times.end ())
+				continue;
+			time->second = LinkedFileTime (path);
+			if (is_style_sheet (path))
+				styles_changed = true;
+			else
+				templates_changed = true;
+		}
+		if (styles_changed)
+			Rml::Factory::ClearStyleSheetCache ();
+		if (templates_changed)
+			Rml::Factory::ClearTemplateCache ();
+
+		int reloaded = 0;
+		int restyled = 0;
+		for (auto &pair : g_state.documents)
+		{
+			if (!pair.second)
+				continue;
+
+			bool reload = changed.count (pair.first) != 0;
+			bool restyle = false;
+			auto links = g_state.document_links.find (pair.first);
+			for (size_t i = 0; links != g_state.document_links.end () && i < links->second.size (); i++)
+			{
+				if (!changed.count (links->second[i]))
+					continue;
+				if (is_style_sheet (links->second[i]))
+					restyle = true;
+				else
+					reload = true;
+			}
+
+			if (reload)
+			{
+				// Preloaded file contents may be stale
+				if (!reloaded)
+					UI_CancelPreloads ();
+				UI_ReloadDocument (pair);
+				reloaded++;
+			}
+			else if (restyle)
+			{
+				pair.second->ReloadStyleSheet ();
+				TrackDocumentLinks (pair.first);
+				restyled++;
+			}
+		}
+		if (!reloaded && !restyled)
+			return;
+
+		// Reloaded documents get the font scale applied again
+		if (reloaded)
+			s_last_font_scale = -1.0f;
+		MarkUIChanged ();
+		Con_Printf ("ui_autoreload: %d documents reloaded, %d restyled\n", reloaded, restyled);
+	}
+
+	// ui_autoreload: watches the loose UI files of the base and game dirs
+	static void UI_ProcessFileChanges (void)
+	{
+		if (Cvar_VariableValue ("ui_autoreload") == 0.0)
+		{
+			if (!g_state.watched_gamedir.empty ())
+			{
+				g_state.file_watcher.Stop ();
+				g_state.watched_gamedir.clear ();
+				g_state.watched_changes.clear ();
+			}
+			return;
+		}
+
+		// A game dir change reloads every document anyway
+		if (g_state.watched_gamedir != com_gamedir)
+		{
+			std::vector<std::string> directories = {std::string (com_basedir) + "/ui"};
+			if (strcmp (com_gamedir, com_basedir) != 0)
+				directories.push_back (std::string (com_gamedir) + "/ui");
+			if (!g_state.file_watcher.Start (directories))
+				Con_DPrintf ("ui_autoreload: no UI directory to watch\n");
+			g_state.watched_gamedir = com_gamedir;
+			g_state.watched_changes.clear ();
+		}
+
+		std::vector<std::string> changed;
+		g_state.file_watcher.Poll (changed);
+		if (!changed.empty ())
+		{
+			g_state.watched_changes.insert (changed.begin (), changed.end ());
+			g_state.watched_change_time = realtime;
+		}
+		if (g_state.watched_changes.empty () || realtime - g_state.watched_change_time < AUTORELOAD_SETTLE_SECONDS)
+			return;
+
+		std::set<std::string> settled;
+		settled.swap (g_state.watched_changes);
+		if (g_state.linked_files_gamedir == com_gamedir)
+			UI_ApplyFileChanges (settled);
+	}
+#endif
+
+	int UI_PreloadDocument (const char *path)
+	{
+		if (!path)
+		{
+			Con_Printf ("WARNING: UI_PreloadDocument: null path\n");
+			return 0;
+		}
+		if (!IsRmlUiEnabled () || !g_state.initialized || !g_state.context)
+			return 0;
+
+		auto it = g_state.documents.find (path);
+		if (it != g_state.documents.end () && it->second)
+			return 1;
+		for (const auto &request : g_state.preloads)
+		{
+			if (request->path == path)
+				return 1;
+		}
+
+		auto request = std::make_unique<PreloadRequest> ();
+		request->path = path;
+		PreloadRequest *payload = request.get ();
+		request->task = Task_Allocate ();
+		Task_AssignFunc (request->task, PreloadReadTask, &payload, sizeof (payload));
+		Task_Submit (request->task);
+		g_state.preloads.push_back (std::move (request));
+		return 1;
+	}
+
 	void UI_Shutdown (void)
 	{
 		if (!g_state.initialized)
 			return;
 
+		UI_CancelPreloads ();
+#ifdef QRMLUI_HOT_RELOAD
+		g_state.file_watcher.Stop ();
+		g_state.watched_gamedir.clear ();
+		g_state.watched_changes.clear ();
+#endif
+
 		// Shutdown data models first
 		QRmlUI::MenuEventHandler::Shutdown ();
 		QRmlUI::CvarBindingManager::Shutdown ();
@@ -453,6 +986,7 @@ extern "C"
 		g_state.render_interface.reset ();
 		g_state.system_interface.reset ();
 		g_state.file_interface.reset ();
+		g_state.font_engine.reset ();
 
 		// Reset all mutable state so a reinit starts clean.
 		g_state = UIManagerState{};
@@ -580,6 +1114,11 @@ extern "C"
 		{
 			UI_SetInputMode (UI_INPUT_INACTIVE);
 		}
+
+#ifdef QRMLUI_HOT_RELOAD
+		UI_ProcessFileChanges ();
+#endif
+		UI_ProcessPreloads ();
 	}
 
 	void UI_Update (double dt)
@@ -600,7 +1139,9 @@ extern "C"
 		// which is called from the main thread before rendering tasks start.
 
 		// Update game data model to sync with Quake state
-		QRmlUI::GameDataModel::Update ();
+		if (QRmlUI::GameDataModel::Update ())
+			MarkUIChanged ();
+		g_state.perf_last.model_dirty_vars = static_cast<int> (QRmlUI::GameDataModel::GetLastDirtied ().size ());
 		phase_end = Sys_DoubleTime ();
 		g_state.perf_last.update_model_ms = (phase_end - phase_start) * 1000.0;
 		phase_start = phase_end;
@@ -610,9 +1151,16 @@ extern "C"
 		QRmlUI::LuaBridge::Update ();
 		phase_end = Sys_DoubleTime ();
 		g_state.perf_last.update_lua_ms = (phase_end - phase_start) * 1000.0;
+		{
+			const QRmlUI::LuaBridge::Stats &lua_stats = QRmlUI::LuaBridge::GetStats ();
+			g_state.perf_last.update_lua_gc_ms = lua_stats.gc_ms;
+			g_state.perf_last.lua_memory_kb = lua_stats.memory_kb;
+			g_state.perf_last.lua_gc_cycles = lua_stats.gc_cycles;
+		}
 		phase_start = phase_end;
 #else
 		g_state.perf_last.update_lua_ms = 0.0;
+		g_state.perf_last.update_lua_gc_ms = 0.0;
 #endif
 
 		// Weapon switch flicker — toggle "weapon-switched" class on HUD doc.
@@ -667,12 +1215,24 @@ extern "C"
 		phase_start = phase_end;
 
 		// Update notification expiry state
-		QRmlUI::NotificationModel::Update (realtime);
+		if (QRmlUI::NotificationModel::Update (realtime))
+		{
+			MarkUIChanged ();
+			g_state.perf_last.notify_changed = 1;
+		}
 		phase_end = Sys_DoubleTime ();
 		g_state.perf_last.update_notify_ms = (phase_end - phase_start) * 1000.0;
 		phase_start = phase_end;
 
-		g_state.context->Update ();
+		// An unchanged, opted-in UI replays last frame's draws instead of updating and rendering RmlUI
+		g_state.retain_frame = CanRetainFrame ();
+		g_state.frame_document_ms.clear ();
+		if (!g_state.retain_frame)
+		{
+			if (DocumentProfilingEnabled ())
+				UpdateDocumentsTimed ();
+			g_state.context->Update ();
+		}
 		phase_end = Sys_DoubleTime ();
 		g_state.perf_last.update_context_ms = (phase_end - phase_start) * 1000.0;
 		phase_start = phase_end;
@@ -729,7 +1289,18 @@ extern "C"
 		if (!IsRmlUiEnabled () || !g_state.initialized || !g_state.context || !g_state.visible)
 			return;
 		double render_start = Sys_DoubleTime ();
-		g_state.context->Render ();
+		if (!g_state.retain_frame || !g_state.render_interface || !g_state.render_interface->ReplayRecording ())
+		{
+			const bool record = g_state.render_interface && Cvar_VariableValue ("ui_retain") != 0.0;
+			if (record)
+				g_state.render_interface->BeginRecording ();
+			else if (g_state.render_interface)
+				g_state.render_interface->DiscardRecording ();
+			g_state.context->Render ();
+			if (record)
+				g_state.render_interface->EndRecording ();
+		}
+		g_state.retain_frame = false;
 		g_state.perf_last.render_ms = (Sys_DoubleTime () - render_start) * 1000.0;
 		if (g_state.render_interface)
 		{
@@ -747,6 +1318,7 @@ extern "C"
 		if (g_state.width != width || g_state.height != height)
 		{
 			g_state.last_resize_time = realtime;
+			MarkUIChanged ();
 		}
 
 		g_state.width = width;
@@ -768,6 +1340,7 @@ extern "C"
 			return 0;
 		if (!g_state.visible && g_state.menu_stack.empty ())
 			return 0;
+		MarkUIChanged ();
 
 		Rml::Input::KeyIdentifier rml_key = QRmlUI::TranslateKey (key);
 		int						  modifiers = QRmlUI::GetKeyModifiers ();
@@ -791,6 +1364,7 @@ extern "C"
 			return 0;
 		if (!g_state.visible && g_state.menu_stack.empty ())
 			return 0;
+		MarkUIChanged ();
 
 		bool consumed = g_state.context->ProcessTextInput (static_cast<Rml::Character> (codepoint));
 		return consumed ? 1 : 0;
@@ -806,6 +1380,7 @@ extern "C"
 			return 0;
 		if (!g_state.visible && g_state.menu_stack.empty ())
 			return 0;
+		MarkUIChanged ();
 
 		int	 modifiers = QRmlUI::GetKeyModifiers ();
 		bool consumed = g_state.context->ProcessMouseMove (px, py, modifiers);
@@ -818,6 +1393,7 @@ extern "C"
 			return 0;
 		if (!g_state.visible && g_state.menu_stack.empty ())
 			return 0;
+		MarkUIChanged ();
 
 		int rml_button = 0;
 		switch (button)
@@ -864,6 +1440,7 @@ extern "C"
 			return 0;
 		if (!g_state.visible && g_state.menu_stack.empty ())
 			return 0;
+		MarkUIChanged ();
 
 		int	 modifiers = QRmlUI::GetKeyModifiers ();
 		bool consumed = g_state.context->ProcessMouseWheel (Rml::Vector2f (x, -y), modifiers);
@@ -897,6 +1474,11 @@ extern "C"
 		// Store with original path as key for consistency
 		g_state.documents[path] = doc;
 		QRmlUI::MenuEventHandler::RegisterWithDocument (doc);
+#ifdef QRMLUI_HOT_RELOAD
+		if (g_state.linked_files_gamedir != com_gamedir)
+			ResetLinkedFiles ();
+		TrackDocumentLinks (path);
+#endif
 
 		// Apply current font scale to newly loaded document
 		float font_scale = static_cast<float> (Cvar_VariableValue ("scr_fontscale"));
@@ -1019,9 +1601,18 @@ extern "C"
 
 		Con_DPrintf ("UI_ReloadDocuments: Reloading all documents\n");
 
-		// Clear caches so RmlUI re-reads files from disk
-		Rml::Factory::ClearStyleSheetCache ();
-		Rml::Factory::ClearTemplateCache ();
+		// Preloaded file contents may be stale
+		UI_CancelPreloads ();
+
+		// RmlUI's stylesheet and template caches are shared by all documents, only
+		// drop them if a linked file changed on disk or the game dir is different
+		const bool keep_linked_files = LinkedFilesUnchanged ();
+		if (!keep_linked_files)
+		{
+			Rml::Factory::ClearStyleSheetCache ();
+			Rml::Factory::ClearTemplateCache ();
+			ResetLinkedFiles ();
+		}
 		Rml::ReleaseTextures ();
 
 		// Pick up fonts from the new game directory (e.g. mod-specific fonts).
@@ -1034,27 +1625,9 @@ extern "C"
 
 		// Store visibility state and reload each document
 		for (auto &pair : g_state.documents)
-		{
-			if (pair.second)
-			{
-				bool		was_visible = pair.second->IsVisible ();
-				std::string path = pair.first;
-
-				pair.second->Close ();
-				pair.second = g_state.context->LoadDocument (path);
-
-				if (pair.second)
-				{
-					QRmlUI::MenuEventHandler::RegisterWithDocument (pair.second);
-					if (was_visible)
-					{
-						pair.second->Show ();
-					}
-				}
-			}
-		}
+			UI_ReloadDocument (pair);
 
-		Con_DPrintf ("UI_ReloadDocuments: Done\n");
+		Con_DPrintf ("UI_ReloadDocuments: Done%s\n", keep_linked_files ? " (stylesheets unchanged, kept cached)" : "");
 #else
 		Con_DPrintf ("UI_ReloadDocuments: Hot reload not enabled\n");
 #endif
@@ -1068,15 +1641,45 @@ extern "C"
 
 		Con_DPrintf ("UI_ReloadStyleSheets: Reloading stylesheets\n");
 
+		// Only documents linking a changed file are reloaded, all of them after a game dir change.
+		// Each ReloadStyleSheet () reparses the document's sheets, unchanged documents keep theirs.
+		if (g_state.linked_files_gamedir != com_gamedir)
+			ResetLinkedFiles ();
+		std::set<std::string> changed;
+		for (auto &pair : g_state.linked_file_times)
+		{
+			const std::filesystem::file_time_type time = LinkedFileTime (pair.first);
+			if (time != pair.second)
+			{
+				changed.insert (pair.first);
+				pair.second = time;
+			}
+		}
+
+		// Documents loaded later must not get a cached copy of a changed file either
+		if (!changed.empty ())
+		{
+			Rml::Factory::ClearStyleSheetCache ();
+			Rml::Factory::ClearTemplateCache ();
+		}
+
+		int reloaded = 0;
 		for (auto &pair : g_state.documents)
 		{
-			if (pair.second)
+			auto links = g_state.document_links.find (pair.first);
+			bool stale = links == g_state.document_links.end ();
+			for (size_t i = 0; !stale && i < links->second.size (); i++)
+				stale = changed.count (links->second[i]) != 0;
+			if (pair.second && stale)
 			{
 				pair.second->ReloadStyleSheet ();
+				TrackDocumentLinks (pair.first);
+				reloaded++;
 			}
 		}
+		MarkUIChanged ();
 
-		Con_DPrintf ("UI_ReloadStyleSheets: Done\n");
+		Con_DPrintf ("UI_ReloadStyleSheets: Done, %d of %d documents reloaded\n", reloaded, static_cast<int> (g_state.documents.size ()));
 #else
 		Con_DPrintf ("UI_ReloadStyleSheets: Hot reload not enabled\n");
 #endif
@@ -1126,17 +1729,15 @@ extern "C"
 					}
 					g_state.assets_loaded = true;
 
-					// Pre-warm HUD documents: load + one context update while
-					// hidden so the first-use style/layout spike happens here
-					// instead of on the first live gameplay frame.
-					if (g_state.context && UI_LoadDocument (QRmlUI::Paths::kHud))
-					{
-						UI_LoadDocument (QRmlUI::Paths::kHudNotify);
-						UI_LoadDocument (QRmlUI::Paths::kHudCenterprint);
-						UI_LoadDocument (QRmlUI::Paths::kHudChat);
-						g_state.context->Update ();
-						Con_DPrintf ("UI_InitializeVulkan: HUD pre-warmed\n");
-					}
+					// Pre-warm HUD documents: read on a worker, then parsed and laid
+					// out while hidden a step per frame, so the first-use spike is
+					// spread over frames instead of hitting the first gameplay frame.
+					UI_PreloadDocument (QRmlUI::Paths::kHud);
+					UI_PreloadDocument (QRmlUI::Paths::kHudNotify);
+					UI_PreloadDocument (QRmlUI::Paths::kHudCenterprint);
+					UI_PreloadDocument (QRmlUI::Paths::kHudChat);
+					UI_PreloadDocument (QRmlUI::Paths::kScoreboard);
+					UI_PreloadDocument (QRmlUI::Paths::kIntermission);
 				}
 			}
 			else
@@ -1175,6 +1776,15 @@ extern "C"
 		}
 		g_state.perf_last.end_ms = (Sys_DoubleTime () - end_start) * 1000.0;
 		g_state.perf_last.total_ms = g_state.perf_last.begin_ms + g_state.perf_last.update_ms + g_state.perf_last.render_ms + g_state.perf_last.end_ms;
+		if (g_state.render_interface)
+			g_state.perf_last.upload_bytes = static_cast<int> (g_state.render_interface->GetFrameUploadBytes ());
+
+		const float spike_ms = Cvar_VariableValue ("ui_speeds_spike");
+		if (spike_ms > 0.0f && g_state.perf_last.total_ms > spike_ms && realtime - g_state.last_spike_dump >= SPIKE_DUMP_INTERVAL_SECONDS)
+		{
+			DumpPerfSpike ();
+			g_state.last_spike_dump = realtime;
+		}
 	}
 
 	// GPU timestamp instrumentation — primary CB, around UI render pass
@@ -1221,6 +1831,55 @@ extern "C"
 		}
 	}
 
+	int UI_GetDocumentPerfStats (ui_document_perf_t *out_stats, int max_count)
+	{
+		int count = 0;
+		for (const auto &pair : g_state.document_perf)
+		{
+			if (count >= max_count)
+				break;
+			if (pair.second.frames == 0)
+				continue;
+			ui_document_perf_t &stats = out_stats[count++];
+			snprintf (stats.path, sizeof (stats.path), "%s", pair.first.c_str ());
+			stats.avg_ms = pair.second.sum_ms / pair.second.frames;
+			stats.worst_ms = pair.second.worst_ms;
+		}
+		g_state.document_perf.clear ();
+		return count;
+	}
+
+	unsigned long long UI_GetVulkanMemoryUsage (void)
+	{
+		if (!g_state.render_interface)
+		{
+			return 0;
+		}
+		return static_cast<unsigned long long> (g_state.render_interface->GetAllocatedBytes ());
+	}
+
+	static void CopyPoolStats (const QRmlUI::PoolStats &stats, ui_pool_stats_t *out_stats)
+	{
+		out_stats->num_chunks = stats.num_chunks;
+		out_stats->num_allocations = stats.num_allocations;
+		out_stats->num_free_blocks = stats.num_free_blocks;
+		out_stats->capacity = stats.capacity;
+		out_stats->used_bytes = stats.used_bytes;
+		out_stats->largest_free_block = stats.largest_free_block;
+	}
+
+	void UI_GetPoolStats (ui_pool_stats_t *geometry, ui_pool_stats_t *images)
+	{
+		*geometry = ui_pool_stats_t{};
+		*images = ui_pool_stats_t{};
+		if (!g_state.render_interface)
+		{
+			return;
+		}
+		CopyPoolStats (g_state.render_interface->GetGeometryPoolStats (), geometry);
+		CopyPoolStats (g_state.render_interface->GetImagePoolStats (), images);
+	}
+
 	// Input mode control
 	void UI_SetInputMode (ui_input_mode_t mode)
 	{
@@ -1557,11 +2216,36 @@ extern "C"
 		}
 	}
 
+	void UI_ShowLoading (int percent, const char *phase)
+	{
+		if (!IsRmlUiEnabled ())
+			return;
+		QRmlUI::g_game_state.loading_percent = percent;
+		QRmlUI::g_game_state.loading_phase = phase ? phase : "";
+		if (!g_state.loading_visible && UI_LoadDocument (QRmlUI::Paths::kLoading))
+		{
+			UI_ShowDocument (QRmlUI::Paths::kLoading, 0);
+			g_state.documents[QRmlUI::Paths::kLoading]->PullToFront ();
+			g_state.loading_visible = true;
+		}
+	}
+
+	void UI_HideLoading (void)
+	{
+		if (!IsRmlUiEnabled ())
+			return;
+		if (g_state.loading_visible)
+		{
+			UI_HideDocument (QRmlUI::Paths::kLoading);
+			g_state.loading_visible = false;
+		}
+	}
+
 	// ── Game state synchronization ─────────────────────────────────────
 
 	void UI_SyncGameState (
 		const int *stats, int stats_count, int items, int intermission, int gametype, int maxclients, const char *level_name, const char *map_name,
-		double game_time)
+		double game_time, unsigned int generation)
 	{
 		if (!IsRmlUiEnabled ())
 			return;
@@ -1588,29 +2272,46 @@ extern "C"
 			g_state.last_intermission = intermission;
 		}
 
-		GameDataModel_SyncFromQuake (stats, stats_count, items, intermission, gametype, maxclients, level_name, map_name, game_time);
+		GameDataModel_SyncFromQuake (stats, stats_count, items, intermission, gametype, maxclients, level_name, map_name, game_time, generation);
 	}
 
 	// ── Scoreboard sync ────────────────────────────────────────────────
 
+	// Rows stay in client slot order and carry their frag rank, the scoreboard places them by rank.
+	// A frag then only changes the frags and rank of the rows involved instead of shifting every row's
+	// contents, and RmlUI's data views leave the elements whose values are unchanged alone.
 	void UI_SyncScoreboard (const ui_player_info_t *players, int count)
 	{
 		if (!IsRmlUiEnabled () || !g_state.initialized)
 			return;
 
-		QRmlUI::g_game_state.players.clear ();
-		QRmlUI::g_game_state.players.reserve (count);
+		std::vector<int> by_slot (count);
+		for (int i = 0; i < count; i++)
+			by_slot[i] = i;
+		std::sort (by_slot.begin (), by_slot.end (), [players] (int a, int b) { return players[a].slot < players[b].slot; });
+
+		// Only a player joining or leaving rebuilds the rows
+		std::vector<QRmlUI::PlayerInfo> &rows = QRmlUI::g_game_state.players;
+		bool							 same_players = rows.size () == static_cast<size_t> (count);
+		for (int i = 0; same_players && i < count; i++)
+			same_players = rows[i].slot == players[by_slot[i]].slot;
+		if (!same_players)
+			rows.assign (count, QRmlUI::PlayerInfo ());
 
 		for (int i = 0; i < count; i++)
 		{
-			QRmlUI::PlayerInfo pi;
-			pi.name = players[i].name ? players[i].name : "";
-			pi.frags = players[i].frags;
-			pi.top_color = (players[i].colors >> 4) & 0xf;
-			pi.bottom_color = players[i].colors & 0xf;
-			pi.ping = players[i].ping;
-			pi.is_local = players[i].is_local != 0;
-			QRmlUI::g_game_state.players.push_back (pi);
+			const ui_player_info_t &player = players[by_slot[i]];
+			QRmlUI::PlayerInfo	   &row = rows[i];
+			const char			   *name = player.name ? player.name : "";
+			if (row.name != name)
+				row.name = name;
+			row.frags = player.frags;
+			row.top_color = (player.colors >> 4) & 0xf;
+			row.bottom_color = player.colors & 0xf;
+			row.ping = player.ping;
+			row.is_local = player.is_local != 0;
+			row.slot = player.slot;
+			row.rank = by_slot[i];
 		}
 		QRmlUI::g_game_state.num_players = count;
 	}
@@ -1622,6 +2323,7 @@ extern "C"
 		if (!IsRmlUiEnabled () || !g_state.initialized || !text)
 			return;
 		QRmlUI::NotificationModel::CenterPrint (text, realtime);
+		MarkUIChanged ();
 	}
 
 	void UI_NotifyPrint (const char *text)
@@ -1629,6 +2331,7 @@ extern "C"
 		if (!IsRmlUiEnabled () || !g_state.initialized || !text)
 			return;
 		QRmlUI::NotificationModel::NotifyPrint (text, realtime);
+		MarkUIChanged ();
 	}
 
 	// ── Save slot sync ─────────────────────────────────────────────────
@@ -1682,6 +2385,7 @@ extern "C"
 			return;
 
 		QRmlUI::CvarBindingManager::SyncVideoModes (modes, count);
+		MarkUIChanged ();
 	}
 
 	// ── Key capture ────────────────────────────────────────────────────
@@ -47,6 +47,10 @@ extern "C"
 	void UI_ShowDocument (const char *path, int modal);
 	void UI_HideDocument (const char *path);
 
+	/* Reads the document on a task worker, then loads it hidden and runs its first layout
+	   over the following frames under a time budget. UI_LoadDocument still works meanwhile. */
+	int UI_PreloadDocument (const char *path);
+
 	/* Visibility control */
 	void UI_SetVisible (int visible);
 	int	 UI_IsVisible (void);
@@ -83,13 +87,19 @@ extern "C"
 	void UI_ShowIntermission (void);
 	void UI_HideIntermission (void);
 
+	/* Loading screen, drawn on top of everything while a map loads.
+	 * percent is -1 when the phase doesn't report progress. */
+	void UI_ShowLoading (int percent, const char *phase);
+	void UI_HideLoading (void);
+
 	/* Reset transient animation state (pain flash, weapon switch) on disconnect */
 	void GameDataModel_ResetTransients (void);
 
-	/* Game state synchronization - call each frame from sbar.c */
+	/* Game state synchronization - call each frame from sbar.c
+	 * generation is cl_stats_generation, the stats, items and level info are only re-read when it changed */
 	void UI_SyncGameState (
 		const int *stats, int stats_count, int items, int intermission, int gametype, int maxclients, const char *level_name, const char *map_name,
-		double game_time);
+		double game_time, unsigned int generation);
 
 	/* Scoreboard player data sync - call when scoreboard is visible */
 	typedef struct
@@ -99,6 +109,7 @@ extern "C"
 		int			colors; /* top nibble = shirt, low nibble = pants */
 		int			ping;
 		int			is_local; /* 1 if this is the local player */
+		int			slot;	  /* client slot, stable while the player is connected */
 	} ui_player_info_t;
 	void UI_SyncScoreboard (const ui_player_info_t *players, int count);
 
@@ -160,6 +171,10 @@ extern "C"
 		PFN_vkCmdPushConstants			 cmd_push_constants;
 		PFN_vkCmdSetScissor				 cmd_set_scissor;
 		PFN_vkCmdSetViewport			 cmd_set_viewport;
+		VkPipelineCache					 pipeline_cache;
+		unsigned char *(*staging_allocate) (int size, int alignment, VkCommandBuffer *cb, VkBuffer *buffer, int *buffer_offset);
+		void (*staging_begin_copy) (void);
+		void (*staging_end_copy) (void);
 	} ui_vulkan_config_t;
 	void UI_InitializeVulkan (const void *config); /* Takes ui_vulkan_config_t* */
 
@@ -182,9 +197,11 @@ extern "C"
 		double update_dp_ms;
 		double update_model_ms;
 		double update_lua_ms;
+		double update_lua_gc_ms; /* part of update_lua_ms */
 		double update_hud_logic_ms;
 		double update_notify_ms;
 		double update_context_ms;
+		double update_documents_ms; /* part of update_context_ms, only measured while ui_speeds >= 4 or ui_speeds_spike is set */
 		double update_post_ms;
 		double render_ms;
 		double end_ms;
@@ -193,9 +210,38 @@ extern "C"
 		int	   draw_calls;
 		int	   indices;
 		int	   triangles;
+		int	   lua_memory_kb;
+		int	   lua_gc_cycles;	 /* completed since startup */
+		int	   model_dirty_vars; /* game data model variables dirtied */
+		int	   notify_changed;
+		int	   upload_bytes; /* texture data submitted by the render interface */
 	} ui_perf_stats_t;
 	void UI_GetPerfStats (ui_perf_stats_t *out_stats);
 
+	/* Per-document style and layout time, averaged since the previous call (ui_speeds 4) */
+	typedef struct
+	{
+		char   path[64];
+		double avg_ms;
+		double worst_ms;
+	} ui_document_perf_t;
+	int UI_GetDocumentPerfStats (ui_document_perf_t *out_stats, int max_count);
+
+	/* Bytes of Vulkan memory held by the UI geometry and texture pools */
+	unsigned long long UI_GetVulkanMemoryUsage (void);
+
+	/* Occupancy of a UI memory pool, summed over its chunks */
+	typedef struct
+	{
+		unsigned int	   num_chunks;
+		unsigned int	   num_allocations;
+		unsigned int	   num_free_blocks;
+		unsigned long long capacity;
+		unsigned long long used_bytes;
+		unsigned long long largest_free_block;
+	} ui_pool_stats_t;
+	void UI_GetPoolStats (ui_pool_stats_t *geometry, ui_pool_stats_t *images);
+
 	/* Run Lua test suite (lua_test console command) */
 	void UI_RunLuaTests (void);
 
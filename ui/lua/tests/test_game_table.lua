@@ -99,3 +99,12 @@ assert_error(function() game.new_field = true end, "write to new field should er
 suite("game table: proxy reads work through local")
 local g = game
 assert_type(g.health, "number", "local alias read should work")
+
+suite("game table: unknown fields read as nil")
+assert_true(game.no_such_field == nil, "unknown field should be nil")
+assert_true(game[1] == nil, "non-string key should be nil")
+
+suite("game table: repeated reads agree")
+assert_equal(game.health, game.health, "health read twice")
+assert_equal(game.weapon_label, game.weapon_label, "weapon_label read twice")
+assert_equal(game.level_name, game.level_name, "level_name read twice")